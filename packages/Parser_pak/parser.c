@@ -66,10 +66,11 @@ int check_int(
   char *routine)
 {
 
- if (argv[param].sp_form == ft_short) 
-      return (int)(argv[param].sp_val.sp_short_value);
-   else if (argv[param].sp_form == ft_long) 
-      return (int)long_to_short(SETL_SYSTEM argv[param].sp_val.sp_long_ptr);
+ if (spec_form(&argv[param]) == ft_short) 
+      return (int)(spec_val(&argv[param],sp_short_value));
+   else if (spec_form(&argv[param]) == ft_long) 
+      return (int)long_to_short(SETL_SYSTEM
+                                spec_val(&argv[param],sp_long_ptr));
    else 
       abend(SETL_SYSTEM msg_bad_arg,"integer",param+1,routine,
             abend_opnd_str(SETL_SYSTEM argv+param));
@@ -211,41 +212,7 @@ int i;
 
 string_h_ptr_type setl2_string(SETL_SYSTEM_PROTO char *s,int slen)
 {
-string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
-char *string_char_ptr, *string_char_end;
-
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (slen-->0) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
-   return string_hdr;
+   return new_string_chars(SETL_SYSTEM s,(int32)slen);
 }
 
 struct tuple_h_item *return_subtree(
@@ -271,10 +238,10 @@ specifier s;
    
        TUPLE_CONSTRUCTOR_BEGIN(ca);
 
-            s.sp_form = ft_string;
-            s.sp_val.sp_string_ptr = 
+            spec_set_form(&s,ft_string);
+            spec_set_val(&s,sp_string_ptr,
 							setl2_string(SETL_SYSTEM ast_desc[ast_label],
-			    			 strlen(ast_desc[ast_label]));
+			    			 strlen(ast_desc[ast_label])));
 			    	TUPLE_ADD_CELL(ca,&s);
            
   			TUPLE_CONSTRUCTOR_END(ca);
@@ -307,15 +274,16 @@ specifier s;
    
    if (ast_label>0) {
    		if (ast_label>1024) {
-   				  s.sp_form = ft_string;
-            s.sp_val.sp_string_ptr = setl2_string(SETL_SYSTEM 
-            		nt->nt_name,strlen(nt->nt_name));
+   				  spec_set_form(&s,ft_string);
+            spec_set_val(&s,sp_string_ptr,setl2_string(SETL_SYSTEM 
+            		nt->nt_name,strlen(nt->nt_name)));
             TUPLE_ADD_CELL(ca,&s);
             
    		} else {
-            s.sp_form = ft_string;
-            s.sp_val.sp_string_ptr = 
-								setl2_string(SETL_SYSTEM ast_desc[ast_label],strlen(ast_desc[ast_label]));
+            spec_set_form(&s,ft_string);
+            spec_set_val(&s,sp_string_ptr,
+								setl2_string(SETL_SYSTEM ast_desc[ast_label],
+                     strlen(ast_desc[ast_label])));
 						TUPLE_ADD_CELL(ca,&s);
       }
    }
@@ -326,10 +294,10 @@ specifier s;
 
          case ast_namtab :
 
-            s.sp_form = ft_string;
-            s.sp_val.sp_string_ptr = 
+            spec_set_form(&s,ft_string);
+            spec_set_val(&s,sp_string_ptr,
 							setl2_string(SETL_SYSTEM (ast_ptr->ast_child.ast_namtab_ptr)->nt_name,
-                     strlen((ast_ptr->ast_child.ast_namtab_ptr)->nt_name));
+                     strlen((ast_ptr->ast_child.ast_namtab_ptr)->nt_name)));
             TUPLE_ADD_CELL(ca,&s);
             break;
 
@@ -346,22 +314,22 @@ specifier s;
                else
                   sprintf(print_symbol,"$T%ld",(long)symtab_ptr);
 
-			            s.sp_form = ft_string;
-			            s.sp_val.sp_string_ptr = 
+			            spec_set_form(&s,ft_string);
+			            spec_set_val(&s,sp_string_ptr,
 									setl2_string(SETL_SYSTEM 
 									     print_symbol,
-							                     strlen(print_symbol));
+							                     strlen(print_symbol)));
 			            TUPLE_ADD_CELL(ca,&s);
             
             }
 
             else {
 
-		            s.sp_form = ft_string;
-		            s.sp_val.sp_string_ptr = 
+		            spec_set_form(&s,ft_string);
+		            spec_set_val(&s,sp_string_ptr,
 								setl2_string(SETL_SYSTEM 
 		                     (symtab_ptr->st_namtab_ptr)->nt_name,
-		                     strlen((symtab_ptr->st_namtab_ptr)->nt_name));
+		                     strlen((symtab_ptr->st_namtab_ptr)->nt_name)));
 		            TUPLE_ADD_CELL(ca,&s);
 
             }
@@ -376,8 +344,8 @@ specifier s;
 						
             sub=return_subtree(SETL_SYSTEM ast_ptr->ast_child.ast_child_ast,typ,ast_ptr->ast_extension);
 				    if (sub) {
-			                 s.sp_form = ft_tuple;
-			                 s.sp_val.sp_tuple_ptr = sub;
+			                 spec_set_form(&s,ft_tuple);
+			                 spec_set_val(&s,sp_tuple_ptr,sub);
 			                 TUPLE_ADD_CELL(ca,&s);
 			                 
 				    }
@@ -402,11 +370,9 @@ SETL_API void PARSE(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
 unittab_ptr_type unit_ptr;  
 struct instruction_item *pc_old;      
 char *fragment;                        /* fragment to compile               */
@@ -417,28 +383,18 @@ struct tuple_h_item *ss;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"parse",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)string_hdr->s_chars,
+          (size_t)(string_hdr->s_length + 1));
 
    
    compile_result=compile(SETL_SYSTEM key);  
@@ -454,10 +410,10 @@ struct tuple_h_item *ss;
 
    unmark_specifier(target);
    if (ss) {
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = ss;
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,ss);
    } else {
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
    }
 
@@ -473,11 +429,10 @@ SETL_API void PARSE_EXPR(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
+char *t;                               /* temporary looping variables       */
 unittab_ptr_type unit_ptr;  
 struct instruction_item *pc_old;      
 char *fragment;                        /* fragment to compile               */
@@ -488,28 +443,18 @@ struct tuple_h_item *ss;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"parse_expr",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)string_hdr->s_chars,
+          (size_t)(string_hdr->s_length + 1));
 
    
    fragment = (char *)malloc((size_t)(strlen(key)+200));
@@ -542,10 +487,10 @@ struct tuple_h_item *ss;
 
    unmark_specifier(target);
    if (ss) {
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = ss;
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,ss);
    } else {
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
    }
 
@@ -560,11 +505,9 @@ SETL_API void COMPILE(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
 unittab_ptr_type unit_ptr;  
 struct instruction_item *pc_old;      
 char *fragment;                        /* fragment to compile               */
@@ -575,28 +518,18 @@ struct tuple_h_item *ss;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"compile",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)string_hdr->s_chars,
+          (size_t)(string_hdr->s_length + 1));
 
    
    
@@ -605,13 +538,13 @@ struct tuple_h_item *ss;
    free(key);
    if (compile_result!=SUCCESS_EXIT) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
    
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value = 0;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,0);
    return;
 }
 
@@ -624,8 +557,8 @@ SETL_API void SETL_NUM_ERRORS(
 {
 
   unmark_specifier(target);
-  target->sp_form = ft_short;
-  target->sp_val.sp_short_value = setl_num_errors();
+  spec_set_form(target,ft_short);
+  spec_set_val(target,sp_short_value,setl_num_errors());
   return;
 
 }
@@ -655,8 +588,8 @@ int z;
   } 
   
   unmark_specifier(target);
-  target->sp_form = ft_string;
-  target->sp_val.sp_string_ptr = STRING_HEADER(sa);
+  spec_set_form(target,ft_string);
+  spec_set_val(target,sp_string_ptr,STRING_HEADER(sa));
   return;
 
 }
@@ -94,7 +94,7 @@ void check_arg(
   char *routine)
 {
 
-   if (argv[param].sp_form != type)
+   if (spec_form(&argv[param]) != type)
       abend(SETL_SYSTEM msg_bad_arg,typestr,param+1,routine,
             abend_opnd_str(SETL_SYSTEM argv+param));
 
@@ -109,10 +109,11 @@ int check_int(
   char *routine)
 {
 
- if (argv[param].sp_form == ft_short) 
-      return (int)(argv[param].sp_val.sp_short_value);
-   else if (argv[param].sp_form == ft_long) 
-      return (int)long_to_short(SETL_SYSTEM argv[param].sp_val.sp_long_ptr);
+ if (spec_form(&argv[param]) == ft_short) 
+      return (int)(spec_val(&argv[param],sp_short_value));
+   else if (spec_form(&argv[param]) == ft_long) 
+      return (int)long_to_short(SETL_SYSTEM
+                                spec_val(&argv[param],sp_long_ptr));
    else 
       abend(SETL_SYSTEM msg_bad_arg,"integer",param+1,routine,
             abend_opnd_str(SETL_SYSTEM argv+param));
@@ -149,8 +150,8 @@ int len;
    bzero(A->str,len);
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
 
 }
 
@@ -165,14 +166,14 @@ struct setl_flat *A;
 int len; 
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat clone",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    len=S->len;
    
    A = (struct setl_flat *)(malloc(sizeof(struct setl_flat)));
@@ -193,8 +194,8 @@ int len;
    memcpy(A->str,S->str,len+1);
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -213,8 +214,8 @@ int len;
 int s1,s2; 
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat slice",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
@@ -224,7 +225,7 @@ int s1,s2;
   
 
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    len=S->len;
    
  
@@ -252,8 +253,8 @@ int s1,s2;
    A->str[A->len]=0;
    
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -272,14 +273,14 @@ int len;
 int s1; 
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat_slice_end",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
    s1=check_int(SETL_SYSTEM argv,1,ft_short,"integer","flat_slice_end");
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    len=S->len;
    
   
@@ -305,8 +306,8 @@ int s1;
    memcpy(A->str,S->str+s1-1,len-s1+2);
  
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -326,14 +327,14 @@ int len;
 char *s,*d;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat len",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    len=S->len;
    
    A = (struct setl_flat *)(malloc(sizeof(struct setl_flat)));
@@ -359,8 +360,8 @@ char *s,*d;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -379,23 +380,23 @@ int len;
 char *s,*d,*m;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat reverse translate",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
-   if ((argv[1].sp_form != ft_opaque)||
-       (((argv[1].sp_val.sp_opaque_ptr->type)&65535)!=str_type)||
-       ((struct setl_flat*)(argv[1].sp_val.sp_opaque_ptr))->len!=256)
+   if ((spec_form(&argv[1]) != ft_opaque)||
+       (((spec_val(&argv[1],sp_opaque_ptr)->type)&65535)!=str_type)||
+       ((struct setl_flat*)(spec_val(&argv[1],sp_opaque_ptr)))->len!=256)
        abend(SETL_SYSTEM msg_bad_arg,"flat string(256)",2,"flat reverse translate",
          abend_opnd_str(SETL_SYSTEM argv+1));
 
  
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    len=S->len;
-   m = ((struct setl_flat *)(argv[1].sp_val.sp_opaque_ptr))->str;
+   m = ((struct setl_flat *)(spec_val(&argv[1],sp_opaque_ptr)))->str;
    
    A = (struct setl_flat *)(malloc(sizeof(struct setl_flat)));
    if (A == NULL)
@@ -423,8 +424,8 @@ char *s,*d,*m;
    *d=0;
    
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -443,23 +444,23 @@ int len;
 char *s,*d,*m;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat translate",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
-   if ((argv[1].sp_form != ft_opaque)||
-       (((argv[1].sp_val.sp_opaque_ptr->type)&65535)!=str_type)||
-       ((struct setl_flat*)(argv[1].sp_val.sp_opaque_ptr))->len!=256)
+   if ((spec_form(&argv[1]) != ft_opaque)||
+       (((spec_val(&argv[1],sp_opaque_ptr)->type)&65535)!=str_type)||
+       ((struct setl_flat*)(spec_val(&argv[1],sp_opaque_ptr)))->len!=256)
        abend(SETL_SYSTEM msg_bad_arg,"flat string(256)",2,"flat translate",
          abend_opnd_str(SETL_SYSTEM argv+1));
 
  
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    len=S->len;
-   m = ((struct setl_flat *)(argv[1].sp_val.sp_opaque_ptr))->str;
+   m = ((struct setl_flat *)(spec_val(&argv[1],sp_opaque_ptr)))->str;
    
    A = (struct setl_flat *)(malloc(sizeof(struct setl_flat)));
    if (A == NULL)
@@ -486,8 +487,8 @@ char *s,*d,*m;
    }
    *d=0;
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -501,31 +502,29 @@ SETL_API void FLAT_LEN(
 
 struct setl_flat *A; /* w */ 
 int32 len;
-int32 hi_bits;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat len",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   A = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    len=A->len;
 
    unmark_specifier(target);
 
-   if (!(!(hi_bits = len & INT_HIGH_BITS) ||
-                        hi_bits == INT_HIGH_BITS)) {
+   if (!is_short_value(len)) {
 		
-			target->sp_form = ft_omega;
+			spec_set_form(target,ft_omega);
 			short_to_long(SETL_SYSTEM target,len);
 
    } else { 
 
-	    target->sp_form = ft_short;
-		target->sp_val.sp_short_value = len;
+	    spec_set_form(target,ft_short);
+		spec_set_val(target,sp_short_value,len);
 	
    }
    
@@ -547,14 +546,14 @@ int len;
 int i;
 char *c;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat_to_setl",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   A = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
 
    STRING_CONSTRUCTOR_BEGIN(cs);
 
@@ -567,8 +566,8 @@ char *c;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
    return;
 
 }
@@ -616,8 +615,8 @@ unsigned char *str;
    *str=0;
  
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
  
    return;
    
@@ -637,15 +636,15 @@ struct setl_flat *A; /* w */
 int j;
 char *c;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat_get_char",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
    j=check_int(SETL_SYSTEM argv,1,ft_short,"integer","flat_get_char");
 
    
-   A = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    
  
   
@@ -659,8 +658,8 @@ char *c;
   
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
    return;
 
 }
@@ -695,15 +694,15 @@ specifier s;
 
    /*/flat_translate_all(obj,off,minlen,codestr,rar); -- */
  
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat_translate_all",
          abend_opnd_str(SETL_SYSTEM argv+0));
     
  
-   if ((argv[3].sp_form != ft_opaque)||
-       (((argv[3].sp_val.sp_opaque_ptr->type)&65535)!=str_type)||
-       ((struct setl_flat*)(argv[3].sp_val.sp_opaque_ptr))->len!=65)
+   if ((spec_form(&argv[3]) != ft_opaque)||
+       (((spec_val(&argv[3],sp_opaque_ptr)->type)&65535)!=str_type)||
+       ((struct setl_flat*)(spec_val(&argv[3],sp_opaque_ptr)))->len!=65)
        abend(SETL_SYSTEM msg_bad_arg,"flat string(65)",2,"flat_translate_all",
          abend_opnd_str(SETL_SYSTEM argv+3));
 
@@ -712,8 +711,8 @@ specifier s;
    minlen=check_int(SETL_SYSTEM argv,2,ft_short,"integer","flat_translate_all");
    check_arg(SETL_SYSTEM argv,4,ft_tuple,"tuple","flat_translate_all");
    
-   A = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
-   CODE = (struct setl_flat *)(argv[3].sp_val.sp_opaque_ptr);
+   A = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
+   CODE = (struct setl_flat *)(spec_val(&argv[3],sp_opaque_ptr));
    codestr=CODE->str;
   
   
@@ -724,10 +723,10 @@ specifier s;
    ITERATE_TUPLE_BEGIN(ti,argv[4]) 
    {
 
-       if (ti_element->sp_form!=ft_short) {
+       if (spec_form(ti_element)!=ft_short) {
           abend(SETL_SYSTEM "Tuple in FLAT_TRANSLATE_ALL must have short elements");
        }
-       rarity[tuple_el++]=ti_element->sp_val.sp_short_value;
+       rarity[tuple_el++]=spec_val(ti_element,sp_short_value);
      
      
    }
@@ -785,13 +784,13 @@ specifier s;
 	   		   TUPLE_CONSTRUCTOR_BEGIN(cb);
 	   
 	   		
-	   		   s.sp_form = ft_short;
-		       s.sp_val.sp_short_value = start+1;	   
+	   		   spec_set_form(&s,ft_short);
+		       spec_set_val(&s,sp_short_value,start+1);	   
 	           TUPLE_ADD_CELL(cb,&s);
 	           
 	           
-	   		   s.sp_form = ft_short;
-		       s.sp_val.sp_short_value = j;   
+	   		   spec_set_form(&s,ft_short);
+		       spec_set_val(&s,sp_short_value,j);   
 	           TUPLE_ADD_CELL(cb,&s);
 	           
 	         
@@ -804,19 +803,19 @@ specifier s;
 	 				 z++;
                }
 
-			   s.sp_form=ft_string;
-       		   s.sp_val.sp_string_ptr = STRING_HEADER(sa);
+			   spec_set_form(&s,ft_string);
+       		   spec_set_val(&s,sp_string_ptr,STRING_HEADER(sa));
        		   TUPLE_ADD_CELL(cb,&s);
              
 	           
-	   	       s.sp_form = ft_short;
-	           s.sp_val.sp_short_value=score;
+	   	       spec_set_form(&s,ft_short);
+	           spec_set_val(&s,sp_short_value,score);
 	           TUPLE_ADD_CELL(cb,&s);
 	          
 	           TUPLE_CONSTRUCTOR_END(cb);
 		           
-  	           s.sp_form=ft_tuple;
-		       s.sp_val.sp_tuple_ptr =TUPLE_HEADER(cb);
+  	           spec_set_form(&s,ft_tuple);
+		       spec_set_val(&s,sp_tuple_ptr,TUPLE_HEADER(cb));
 		       TUPLE_ADD_CELL(ca,&s);
 		    
 			}
@@ -841,12 +840,12 @@ specifier s;
            
 	   		   TUPLE_CONSTRUCTOR_BEGIN(cb);
 	   
-	   		   s.sp_form = ft_short;
-	           s.sp_val.sp_short_value=start+1;
+	   		   spec_set_form(&s,ft_short);
+	           spec_set_val(&s,sp_short_value,start+1);
 	           TUPLE_ADD_CELL(cb,&s);
 	        
-	   		   s.sp_form = ft_short;
-	           s.sp_val.sp_short_value=j;
+	   		   spec_set_form(&s,ft_short);
+	           spec_set_val(&s,sp_short_value,j);
 	           TUPLE_ADD_CELL(cb,&s);
 	        
 	           
@@ -858,18 +857,18 @@ specifier s;
 	 				 z++;
                }
 
-			   s.sp_form=ft_string;
-       		   s.sp_val.sp_string_ptr = STRING_HEADER(sa);
+			   spec_set_form(&s,ft_string);
+       		   spec_set_val(&s,sp_string_ptr,STRING_HEADER(sa));
                TUPLE_ADD_CELL(cb,&s);
                
-	   		   s.sp_form = ft_short;
-	           s.sp_val.sp_short_value=score;
+	   		   spec_set_form(&s,ft_short);
+	           spec_set_val(&s,sp_short_value,score);
 	           TUPLE_ADD_CELL(cb,&s);
 	          
 	           TUPLE_CONSTRUCTOR_END(cb);
 		           
-  	           s.sp_form=ft_tuple;
-		       s.sp_val.sp_tuple_ptr =TUPLE_HEADER(cb);
+  	           spec_set_form(&s,ft_tuple);
+		       spec_set_val(&s,sp_tuple_ptr,TUPLE_HEADER(cb));
 		       TUPLE_ADD_CELL(cb,&s);
 		    
 			}
@@ -881,8 +880,8 @@ specifier s;
    
 
    TUPLE_CONSTRUCTOR_END(ca);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
    return;
 
 
@@ -905,15 +904,15 @@ struct setl_flat *A; /* w */
 int j,len;
 char *c;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat_set_char",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
    j=check_int(SETL_SYSTEM argv,1,ft_short,"integer","flat_set_char");
    check_arg(SETL_SYSTEM argv,2,ft_string,"char","flat_set_char");
    
-   A = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
   
 
    if ((j<1)||(j>A->len))
@@ -931,7 +930,7 @@ char *c;
   
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -950,21 +949,21 @@ struct setl_flat *A;
 char *s,*d;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat add",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
-   if ((argv[1].sp_form != ft_opaque)||
-       (((argv[1].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[1]) != ft_opaque)||
+       (((spec_val(&argv[1],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",2,"flat add",
          abend_opnd_str(SETL_SYSTEM argv+1));
 
  
 
-   S1 = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
-   S2 = (struct setl_flat *)(argv[1].sp_val.sp_opaque_ptr);
+   S1 = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
+   S2 = (struct setl_flat *)(spec_val(&argv[1],sp_opaque_ptr));
    
    A = (struct setl_flat *)(malloc(sizeof(struct setl_flat)));
    if (A == NULL)
@@ -985,8 +984,8 @@ char *s,*d;
    memcpy(A->str+S1->len,S2->str,S2->len+1);
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -1007,14 +1006,14 @@ char *s1,*s2;
 specifier s;
 int i;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat add",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
-   if ((argv[1].sp_form != ft_opaque)||
-       (((argv[1].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[1]) != ft_opaque)||
+       (((spec_val(&argv[1],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",2,"flat add",
          abend_opnd_str(SETL_SYSTEM argv+1));
 
@@ -1022,8 +1021,8 @@ int i;
    repeats=check_int(SETL_SYSTEM argv,3,ft_short,"integer","FLAT_MATCH_SCORES");
  
    
-   S1 = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
-   S2 = (struct setl_flat *)(argv[1].sp_val.sp_opaque_ptr);
+   S1 = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
+   S2 = (struct setl_flat *)(spec_val(&argv[1],sp_opaque_ptr));
   
    if ((S1->len-(repeats+offset-1))<(S2->len))
    		giveup(SETL_SYSTEM "Repeats in FLAT_MATCH_SCORES out of range");
@@ -1042,16 +1041,16 @@ int i;
    	}
    
 
-	s.sp_form = ft_short;
-	s.sp_val.sp_short_value = m;
+	spec_set_form(&s,ft_short);
+	spec_set_val(&s,sp_short_value,m);
 	TUPLE_ADD_CELL(ca,&s);
 
      offset++;
    }
  
    TUPLE_CONSTRUCTOR_END(ca);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
    return;
 
 }
@@ -1071,21 +1070,21 @@ int i;
 char *s,*d;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat_set_slice",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
-   if ((argv[2].sp_form != ft_opaque)||
-       (((argv[2].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[2]) != ft_opaque)||
+       (((spec_val(&argv[2],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",3,"flat_set_slice",
          abend_opnd_str(SETL_SYSTEM argv+2));
 
    i=check_int(SETL_SYSTEM argv,1,ft_short,"integer","flat_set_slice");
 
-   S1 = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
-   S2 = (struct setl_flat *)(argv[2].sp_val.sp_opaque_ptr);
+   S1 = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
+   S2 = (struct setl_flat *)(spec_val(&argv[2],sp_opaque_ptr));
  
      
   
@@ -1098,7 +1097,7 @@ char *s,*d;
    memcpy(S1->str+i-1,S2->str,S2->len);
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    
    return;
@@ -1153,14 +1152,14 @@ long retsize;
    free(filename);
    if (fp==NULL) {
  		unmark_specifier(target);
-   		target->sp_form=ft_omega;
+   		spec_set_form(target,ft_omega);
    		return;
    }
   
    if (fseek(fp,s1-1,0)==-1) {
    		fclose(fp);
    		unmark_specifier(target);
-   		target->sp_form=ft_omega;
+   		spec_set_form(target,ft_omega);
    		return;
    }
    len=s2-s1+1;
@@ -1188,8 +1187,8 @@ long retsize;
    }
    fclose(fp);
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -1215,12 +1214,12 @@ long retsize;
  
    s2=check_int(SETL_SYSTEM argv,1,ft_short,"integer","flat_file_put");
  
-   if ((argv[2].sp_form != ft_opaque)||
-       (((argv[2].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[2]) != ft_opaque)||
+       (((spec_val(&argv[2],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",3,"flat_file_put",
          abend_opnd_str(SETL_SYSTEM argv+2));
     
-   A = (struct setl_flat *)(argv[2].sp_val.sp_opaque_ptr);    
+   A = (struct setl_flat *)(spec_val(&argv[2],sp_opaque_ptr));    
     
    ITERATE_STRING_BEGIN(sc,argv[0]);
    
@@ -1250,7 +1249,7 @@ long retsize;
    free(filename);
    if (fp==NULL) {
    		unmark_specifier(target);
-   		target->sp_form=ft_omega;
+   		spec_set_form(target,ft_omega);
    		return;
    }
   
@@ -1259,7 +1258,7 @@ long retsize;
    fclose(fp);
   
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    
    
    return;
@@ -1287,7 +1286,7 @@ STRING_CONSTRUCTOR(cs)
 
 int i,j;
 
-   if (string[0].sp_form==ft_tuple) {
+   if (spec_form(&string[0])==ft_tuple) {
       TUPLE_CONSTRUCTOR_BEGIN(ca);
 
       ITERATE_TUPLE_BEGIN(ti,string[0]) 
@@ -1297,19 +1296,19 @@ int i,j;
              
              BREAKUP_IN(SETL_SYSTEM ti_element,&tgt,breakup);
 
-             s.sp_form = tgt.sp_form;
-             s.sp_val.sp_biggest = tgt.sp_val.sp_biggest;
+             spec_set_form(&s,spec_form(&tgt));
+             spec_set_val(&s,sp_biggest,spec_val(&tgt,sp_biggest));
 			 TUPLE_ADD_CELL(ca,&s);
             
       }
       ITERATE_TUPLE_END(ti)
 
       TUPLE_CONSTRUCTOR_END(ca);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
       return;
 
-   } else if (string[0].sp_form==ft_set) {
+   } else if (spec_form(&string[0])==ft_set) {
 
       SET_CONSTRUCTOR_BEGIN(cb);
 
@@ -1323,8 +1322,8 @@ int i,j;
       ITERATE_SET_END(si)
 
       SET_CONSTRUCTOR_END(cb);
-      target->sp_form = ft_set;
-      target->sp_val.sp_set_ptr = SET_HEADER(cb);
+      spec_set_form(target,ft_set);
+      spec_set_val(target,sp_set_ptr,SET_HEADER(cb));
       return;
 	
    }
@@ -1348,8 +1347,8 @@ int i,j;
         if (j>1) {
              STRING_CONSTRUCTOR_BEGIN(cs);
 
-             s.sp_form = ft_string;
-             s.sp_val.sp_string_ptr =  STRING_HEADER(cs);
+             spec_set_form(&s,ft_string);
+             spec_set_val(&s,sp_string_ptr,STRING_HEADER(cs));
              TUPLE_ADD_CELL(ca,&s);
              
         }
@@ -1368,16 +1367,16 @@ int i,j;
              ITERATE_STRING_NEXT(ci);
              
         }
-	    s.sp_form = ft_string;
-        s.sp_val.sp_string_ptr = STRING_HEADER(cs);
+	    spec_set_form(&s,ft_string);
+        spec_set_val(&s,sp_string_ptr,STRING_HEADER(cs));
         TUPLE_ADD_CELL(ca,&s);
        
      }
    }
 
    TUPLE_CONSTRUCTOR_END(ca);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
    return;
 
 }
@@ -1430,7 +1429,7 @@ STRING_CONSTRUCTOR(cs)
 
 int i;
 
-   if (string[0].sp_form==ft_tuple) {
+   if (spec_form(&string[0])==ft_tuple) {
       TUPLE_CONSTRUCTOR_BEGIN(ca);
 
       ITERATE_TUPLE_BEGIN(ti,string[0]) 
@@ -1440,8 +1439,8 @@ int i;
              
              SINGLE_OUT_IN(SETL_SYSTEM ti_element,&tgt,breakup);
 
-             s.sp_form = tgt.sp_form;
-             s.sp_val.sp_biggest = tgt.sp_val.sp_biggest;
+             spec_set_form(&s,spec_form(&tgt));
+             spec_set_val(&s,sp_biggest,spec_val(&tgt,sp_biggest));
 			 TUPLE_ADD_CELL(ca,&s);
             
 
@@ -1449,11 +1448,11 @@ int i;
       ITERATE_TUPLE_END(ti)
 
       TUPLE_CONSTRUCTOR_END(ca);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
       return;
 
-   } else if (string[0].sp_form==ft_set) {
+   } else if (spec_form(&string[0])==ft_set) {
 
       SET_CONSTRUCTOR_BEGIN(cb);
 
@@ -1467,8 +1466,8 @@ int i;
       ITERATE_SET_END(si)
 
       SET_CONSTRUCTOR_END(cb);
-      target->sp_form = ft_set;
-      target->sp_val.sp_set_ptr = SET_HEADER(cb);
+      spec_set_form(target,ft_set);
+      spec_set_val(target,sp_set_ptr,SET_HEADER(cb));
       return;
 	
    }
@@ -1491,8 +1490,8 @@ int i;
            i++;
            ITERATE_STRING_NEXT(ci);
 
-		   s.sp_form = ft_string;
-           s.sp_val.sp_string_ptr = STRING_HEADER(cs);
+		   spec_set_form(&s,ft_string);
+           spec_set_val(&s,sp_string_ptr,STRING_HEADER(cs));
            TUPLE_ADD_CELL(ca,&s);
          
              
@@ -1507,8 +1506,8 @@ int i;
              ITERATE_STRING_NEXT(ci);
              
         }
-		s.sp_form = ft_string;
-        s.sp_val.sp_string_ptr = STRING_HEADER(cs);
+		spec_set_form(&s,ft_string);
+        spec_set_val(&s,sp_string_ptr,STRING_HEADER(cs));
         TUPLE_ADD_CELL(ca,&s);
        
 
@@ -1516,8 +1515,8 @@ int i;
    }
 
    TUPLE_CONSTRUCTOR_END(ca);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
    return;
 
 }
@@ -1571,7 +1570,7 @@ specifier s;
 
 int i;
 
-   if (string[0].sp_form==ft_tuple) {
+   if (spec_form(&string[0])==ft_tuple) {
       TUPLE_CONSTRUCTOR_BEGIN(ca);
 
       ITERATE_TUPLE_BEGIN(ti,string[0]) 
@@ -1581,8 +1580,8 @@ int i;
              
              SEGREGATE_IN(SETL_SYSTEM ti_element,&tgt,breakup);
 
-             s.sp_form = tgt.sp_form;
-             s.sp_val.sp_biggest = tgt.sp_val.sp_biggest;
+             spec_set_form(&s,spec_form(&tgt));
+             spec_set_val(&s,sp_biggest,spec_val(&tgt,sp_biggest));
 			 TUPLE_ADD_CELL(ca,&s);
 			 
 
@@ -1590,11 +1589,11 @@ int i;
       ITERATE_TUPLE_END(ti)
 
       TUPLE_CONSTRUCTOR_END(ca);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
       return;
 
-   } else if (string[0].sp_form==ft_set) {
+   } else if (spec_form(&string[0])==ft_set) {
 
       SET_CONSTRUCTOR_BEGIN(cb);
 
@@ -1608,8 +1607,8 @@ int i;
       ITERATE_SET_END(si)
 
       SET_CONSTRUCTOR_END(cb);
-      target->sp_form = ft_set;
-      target->sp_val.sp_set_ptr = SET_HEADER(cb);
+      spec_set_form(target,ft_set);
+      spec_set_val(target,sp_set_ptr,SET_HEADER(cb));
       return;
 	
    }
@@ -1631,8 +1630,8 @@ int i;
               i++;
               ITERATE_STRING_NEXT(ci);
            }
-		   s.sp_form = ft_string;
-           s.sp_val.sp_string_ptr = STRING_HEADER(cs);
+		   spec_set_form(&s,ft_string);
+           spec_set_val(&s,sp_string_ptr,STRING_HEADER(cs));
            TUPLE_ADD_CELL(ca,&s);
              
         }
@@ -1646,8 +1645,8 @@ int i;
              ITERATE_STRING_NEXT(ci);
              
         }
-		s.sp_form = ft_string;
-        s.sp_val.sp_string_ptr = STRING_HEADER(cs);
+		spec_set_form(&s,ft_string);
+        spec_set_val(&s,sp_string_ptr,STRING_HEADER(cs));
         TUPLE_ADD_CELL(ca,&s);
         
  
@@ -1655,8 +1654,8 @@ int i;
    }
 
    TUPLE_CONSTRUCTOR_END(ca);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
    return;
 
 }
@@ -1731,8 +1730,8 @@ int i;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
    return;
 
 }
@@ -1776,8 +1775,8 @@ int i;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
    return;
 
 }
@@ -1791,23 +1790,21 @@ SETL_API void ASCII_VAL(
 
 {
 string_h_ptr_type string_hdr;          /* string header pointer             */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 
    check_arg(SETL_SYSTEM argv,0,ft_string,"string","ascii_val");
 
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    if (string_hdr->s_length != 1)
        abend(SETL_SYSTEM msg_abs_too_long,abend_opnd_str(SETL_SYSTEM argv));
 
-   string_cell = string_hdr->s_head;
 
 
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value =
-      (unsigned char)(string_cell->s_cell_value[0]);
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,
+      (unsigned char)(string_hdr->s_chars[0]));
 
    return;
 
@@ -1846,8 +1843,8 @@ int i;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
    return;
 
 }
@@ -1922,8 +1919,8 @@ int i;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
 
    return;
 
@@ -1952,7 +1949,7 @@ int tuple_el;
    {
    int i;
 
-       if (ti_element->sp_form!=ft_string) {
+       if (spec_form(ti_element)!=ft_string) {
           abend(SETL_SYSTEM "Tuple in JOIN must have string elements");
        }
        ITERATE_STRING_BEGIN(sb,(*ti_element));
@@ -1974,8 +1971,8 @@ int tuple_el;
    ITERATE_TUPLE_END(ti)
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
 
 }
 
@@ -2001,14 +1998,14 @@ char cset[256];
    cset['t']=1;
    cset['g']=1;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat toto prepare",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    len=S->len;
    
    A = (struct setl_flat *)(malloc(sizeof(struct setl_flat)));
@@ -2051,7 +2048,7 @@ char cset[256];
 			printf("Error in position %d char %c previous %d \n",
 				i,c,tp[c]);
    			unmark_specifier(target);
-			target->sp_form = ft_omega;
+			spec_set_form(target,ft_omega);
 			return;
 		}		
 		*dp=(i-tp[c]);
@@ -2069,8 +2066,8 @@ char cset[256];
    *dp=0; /* Set cache as clear */
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
    
    return;
 
@@ -2092,14 +2089,14 @@ unsigned char *sp,*dp;
 int32 *tp;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat toto prepare",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
    tp=(int32 *)S->str;
 
    printf("The table is : \n");
@@ -2151,21 +2148,21 @@ int i;
 	printf("Staring match...\n");
 	*/
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat add",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
-   if ((argv[1].sp_form != ft_opaque)||
-       (((argv[1].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[1]) != ft_opaque)||
+       (((spec_val(&argv[1],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",2,"flat add",
          abend_opnd_str(SETL_SYSTEM argv+1));
 
    number=check_int(SETL_SYSTEM argv,2,ft_short,"integer","FLAT_TOTO_MATCH");
 
-   S1 = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
-   S2 = (struct setl_flat *)(argv[1].sp_val.sp_opaque_ptr);
+   S1 = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
+   S2 = (struct setl_flat *)(spec_val(&argv[1],sp_opaque_ptr));
   
    if ((S2->len)>250)
    		giveup(SETL_SYSTEM "Length of search string in FLAT_TOTO_MATCH >250");
@@ -2260,8 +2257,8 @@ int i;
    match_counters=S1->str+256*sizeof(int32)+S1->len+256; 
    for (i=0;i<S1->len;i++) {
 
-	s.sp_form = ft_short;
-	s.sp_val.sp_short_value = *match_counters++;
+	spec_set_form(&s,ft_short);
+	spec_set_val(&s,sp_short_value,*match_counters++);
 	TUPLE_ADD_CELL(ca,&s);
 
    }
@@ -2320,19 +2317,19 @@ int i;
 
    	TUPLE_CONSTRUCTOR_BEGIN(cb);
 	
-	s.sp_form = ft_short;
-	s.sp_val.sp_short_value = tempscores[i*2];
+	spec_set_form(&s,ft_short);
+	spec_set_val(&s,sp_short_value,tempscores[i*2]);
 	TUPLE_ADD_CELL(cb,&s);
 	
 	
-	s.sp_form = ft_short;
-	s.sp_val.sp_short_value = tempscores[i*2+1]+1;
+	spec_set_form(&s,ft_short);
+	spec_set_val(&s,sp_short_value,tempscores[i*2+1]+1);
 	TUPLE_ADD_CELL(cb,&s);
 
    	TUPLE_CONSTRUCTOR_END(cb);
 
-	s.sp_form = ft_tuple;
-	s.sp_val.sp_tuple_ptr = TUPLE_HEADER(cb);
+	spec_set_form(&s,ft_tuple);
+	spec_set_val(&s,sp_tuple_ptr,TUPLE_HEADER(cb));
 	TUPLE_ADD_CELL(ca,&s);
 	
 	}
@@ -2344,8 +2341,8 @@ int i;
 
 
 
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
    return;
 
 }
@@ -2364,14 +2361,14 @@ unsigned char *sp,*dp;
 int32 *tp;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat toto clear",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   S = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
+   S = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
 
    dp=S->str+256*sizeof(int32)+S->len+256; /* Point to match counters */
    for (i=0;i<S->len;i++) {
@@ -2382,7 +2379,7 @@ int32 *tp;
    *(dp+256)=0; /* Clear Cache */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
    
@@ -2419,41 +2416,40 @@ unsigned char *flat,*template;
 specifier sd,s,ss,si,s256;
 int number;
 int i,j,len,conv;
-int32 result,hi_bits;
+int32 result;
 long lresult;
 char sign;
 int d,m,y;
 unsigned char b;
 int islong;
 char datebuffer[128];
-i_real_ptr_type real_ptr;     
 double fresult;
 char tmpstring[100];
   
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat_slices_to_setl",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
    number=check_int(SETL_SYSTEM argv,1,ft_short,"integer","FLAT_SLICES_TO_SETL");
  
-   if ((argv[2].sp_form != ft_opaque)||
-       (((argv[2].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[2]) != ft_opaque)||
+       (((spec_val(&argv[2],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",3,"flat_slices_to_setl",
          abend_opnd_str(SETL_SYSTEM argv+2));
 
 
-   S1 = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
-   S2 = (struct setl_flat *)(argv[2].sp_val.sp_opaque_ptr);
+   S1 = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
+   S2 = (struct setl_flat *)(spec_val(&argv[2],sp_opaque_ptr));
   
    flat=S1->str+number;
    template=S2->str;
-   si.sp_form=ft_short;
-   sd.sp_form=ft_real;
-   s256.sp_form=ft_short;
-   s256.sp_val.sp_short_value=256;
+   spec_set_form(&si,ft_short);
+   spec_set_form(&sd,ft_real);
+   spec_set_form(&s256,ft_short);
+   spec_set_val(&s256,sp_short_value,256);
 
    TUPLE_CONSTRUCTOR_BEGIN(ca);
 
@@ -2469,8 +2465,8 @@ char tmpstring[100];
         	  STRING_CONSTRUCTOR_ADD(cs,*(flat+i));
        		   i++;
   		}
-	        ss.sp_form=ft_string;
-       		ss.sp_val.sp_string_ptr = STRING_HEADER(cs);
+	        spec_set_form(&ss,ft_string);
+       		spec_set_val(&ss,sp_string_ptr,STRING_HEADER(cs));
                 TUPLE_ADD_CELL(ca,&ss);
 		break;
 	  case 9: /* DATE */
@@ -2491,8 +2487,8 @@ char tmpstring[100];
         	  STRING_CONSTRUCTOR_ADD(cs,datebuffer[i]);
        		   i++;
   		}
-	        ss.sp_form=ft_string;
-       		ss.sp_val.sp_string_ptr = STRING_HEADER(cs);
+	        spec_set_form(&ss,ft_string);
+       		spec_set_val(&ss,sp_string_ptr,STRING_HEADER(cs));
                 TUPLE_ADD_CELL(ca,&ss);
 		break;
 	  case 0:
@@ -2514,26 +2510,25 @@ char tmpstring[100];
 		     
 		   if (islong==0) {
 		     result=result*256+sign*b;
-  		     if (!(!(hi_bits = result & INT_HIGH_BITS) ||
-                        hi_bits == INT_HIGH_BITS)) {
+  		     if (!is_short_value(result)) {
 			islong=1;
-			s.sp_form=ft_omega;
+			spec_set_form(&s,ft_omega);
 			short_to_long(SETL_SYSTEM &s,result);
 		       } 
 		     } else {
 			integer_multiply(SETL_SYSTEM &s,&s,&s256);
-			si.sp_val.sp_short_value=sign*b;
+			spec_set_val(&si,sp_short_value,sign*b);
 			integer_add(SETL_SYSTEM &s,&s,&si);
 		     }		
 		     i++;
 		}
                 if (islong==0) {
-	  	   si.sp_val.sp_short_value = result;
+	  	   spec_set_val(&si,sp_short_value,result);
 		   if ((conv==2)||(conv==4)) {
 		      TUPLE_ADD_CELL(ca,&si);
 		   } else {
 			/* convert to string */
-   		      ss.sp_form=ft_omega;
+   		      spec_set_form(&ss,ft_omega);
 		      setl2_str(SETL_SYSTEM 1,&si,&ss);
 		      TUPLE_ADD_CELL(ca,&ss);
 		   }
@@ -2542,7 +2537,7 @@ char tmpstring[100];
 		      TUPLE_ADD_CELL(ca,&s);
 		   } else {
 			/* convert to string */
-   		      ss.sp_form=ft_omega;
+   		      spec_set_form(&ss,ft_omega);
 		      setl2_str(SETL_SYSTEM 1,&s,&ss);
 		      TUPLE_ADD_CELL(ca,&ss);
 		   }
@@ -2567,15 +2562,14 @@ char tmpstring[100];
 		     
 		   if (islong==0) {
 		     result=result*256+sign*b;
-  		     if (!(!(hi_bits = result & INT_HIGH_BITS) ||
-                        hi_bits == INT_HIGH_BITS)) {
+  		     if (!is_short_value(result)) {
 			islong=1;
-			s.sp_form=ft_omega;
+			spec_set_form(&s,ft_omega);
 			short_to_long(SETL_SYSTEM &s,result);
 		       } 
 		     } else {
 			integer_multiply(SETL_SYSTEM &s,&s,&s256);
-			si.sp_val.sp_short_value=sign*b;
+			spec_set_val(&si,sp_short_value,sign*b);
 			integer_add(SETL_SYSTEM &s,&s,&si);
 		     }		
 		     i++;
@@ -2585,11 +2579,8 @@ char tmpstring[100];
 		} else {
 		   fresult=(double)(result)/100;
 		}
-	           i_get_real(real_ptr);
-            	   sd.sp_form = ft_real;
-            	   sd.sp_val.sp_real_ptr = real_ptr;
-            	   real_ptr->r_use_count = 1;
-                   real_ptr->r_value = fresult;
+            	   spec_set_form(&sd,ft_real);
+            	   spec_set_val(&sd,sp_real_value,fresult);
 
 		   if ((conv==6)||(conv==8)) {
 		      TUPLE_ADD_CELL(ca,&sd);
@@ -2604,8 +2595,8 @@ char tmpstring[100];
         	  STRING_CONSTRUCTOR_ADD(cs,tmpstring[i]);
        		   i++;
   		}
-	        ss.sp_form=ft_string;
-       		ss.sp_val.sp_string_ptr = STRING_HEADER(cs);
+	        spec_set_form(&ss,ft_string);
+       		spec_set_val(&ss,sp_string_ptr,STRING_HEADER(cs));
                 TUPLE_ADD_CELL(ca,&ss);
 		}
   
@@ -2620,8 +2611,8 @@ char tmpstring[100];
  
    TUPLE_CONSTRUCTOR_END(ca);
  
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
    return;
 
 }
@@ -2643,7 +2634,7 @@ unsigned char *flat,*template;
 specifier sd,s,ss,si,s256;
 int number;
 int i,j,len,conv;
-int32 result,hi_bits;
+int32 result;
 long lresult;
 char sign;
 int d,m,y;
@@ -2651,35 +2642,34 @@ int number_of_tuples,kk;
 unsigned char b;
 int islong;
 char datebuffer[128];
-i_real_ptr_type real_ptr;     
 double fresult;
 char tmpstring[100];
   
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",1,"flat_slices_to_setl_tup",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
    number=check_int(SETL_SYSTEM argv,1,ft_short,"integer","FLAT_SLICES_TO_SETL_TUP");
  
-   if ((argv[2].sp_form != ft_opaque)||
-       (((argv[2].sp_val.sp_opaque_ptr->type)&65535)!=str_type))
+   if ((spec_form(&argv[2]) != ft_opaque)||
+       (((spec_val(&argv[2],sp_opaque_ptr)->type)&65535)!=str_type))
        abend(SETL_SYSTEM msg_bad_arg,"flat string",3,"flat_slices_to_setl_tup",
          abend_opnd_str(SETL_SYSTEM argv+2));
 
     number_of_tuples=check_int(SETL_SYSTEM argv,3,ft_short,"integer","FLAT_SLICES_TO_SETL_TUP");
   
-   S1 = (struct setl_flat *)(argv[0].sp_val.sp_opaque_ptr);
-   S2 = (struct setl_flat *)(argv[2].sp_val.sp_opaque_ptr);
+   S1 = (struct setl_flat *)(spec_val(&argv[0],sp_opaque_ptr));
+   S2 = (struct setl_flat *)(spec_val(&argv[2],sp_opaque_ptr));
   
    flat=S1->str+number;
 
-   si.sp_form=ft_short;
-   sd.sp_form=ft_real;
-   s256.sp_form=ft_short;
-   s256.sp_val.sp_short_value=256;
+   spec_set_form(&si,ft_short);
+   spec_set_form(&sd,ft_real);
+   spec_set_form(&s256,ft_short);
+   spec_set_val(&s256,sp_short_value,256);
    
    TUPLE_CONSTRUCTOR_BEGIN(cb);
    
@@ -2701,8 +2691,8 @@ char tmpstring[100];
         	  STRING_CONSTRUCTOR_ADD(cs,*(flat+i));
        		   i++;
   		}
-	        ss.sp_form=ft_string;
-       		ss.sp_val.sp_string_ptr = STRING_HEADER(cs);
+	        spec_set_form(&ss,ft_string);
+       		spec_set_val(&ss,sp_string_ptr,STRING_HEADER(cs));
                 TUPLE_ADD_CELL(ca,&ss);
 		break;
 	  case 9: /* DATE */
@@ -2723,8 +2713,8 @@ char tmpstring[100];
         	  STRING_CONSTRUCTOR_ADD(cs,datebuffer[i]);
        		   i++;
   		}
-	        ss.sp_form=ft_string;
-       		ss.sp_val.sp_string_ptr = STRING_HEADER(cs);
+	        spec_set_form(&ss,ft_string);
+       		spec_set_val(&ss,sp_string_ptr,STRING_HEADER(cs));
                 TUPLE_ADD_CELL(ca,&ss);
 		break;
 	  case 0:
@@ -2746,26 +2736,25 @@ char tmpstring[100];
 		     
 		   if (islong==0) {
 		     result=result*256+sign*b;
-  		     if (!(!(hi_bits = result & INT_HIGH_BITS) ||
-                        hi_bits == INT_HIGH_BITS)) {
+  		     if (!is_short_value(result)) {
 			islong=1;
-			s.sp_form=ft_omega;
+			spec_set_form(&s,ft_omega);
 			short_to_long(SETL_SYSTEM &s,result);
 		       } 
 		     } else {
 			integer_multiply(SETL_SYSTEM &s,&s,&s256);
-			si.sp_val.sp_short_value=sign*b;
+			spec_set_val(&si,sp_short_value,sign*b);
 			integer_add(SETL_SYSTEM &s,&s,&si);
 		     }		
 		     i++;
 		}
                 if (islong==0) {
-	  	   si.sp_val.sp_short_value = result;
+	  	   spec_set_val(&si,sp_short_value,result);
 		   if ((conv==2)||(conv==4)) {
 		      TUPLE_ADD_CELL(ca,&si);
 		   } else {
 			/* convert to string */
-   		      ss.sp_form=ft_omega;
+   		      spec_set_form(&ss,ft_omega);
 		      setl2_str(SETL_SYSTEM 1,&si,&ss);
 		      TUPLE_ADD_CELL(ca,&ss);
 		   }
@@ -2774,7 +2763,7 @@ char tmpstring[100];
 		      TUPLE_ADD_CELL(ca,&s);
 		   } else {
 			/* convert to string */
-   		      ss.sp_form=ft_omega;
+   		      spec_set_form(&ss,ft_omega);
 		      setl2_str(SETL_SYSTEM 1,&s,&ss);
 		      TUPLE_ADD_CELL(ca,&ss);
 		   }
@@ -2799,15 +2788,14 @@ char tmpstring[100];
 		     
 		   if (islong==0) {
 		     result=result*256+sign*b;
-  		     if (!(!(hi_bits = result & INT_HIGH_BITS) ||
-                        hi_bits == INT_HIGH_BITS)) {
+  		     if (!is_short_value(result)) {
 			islong=1;
-			s.sp_form=ft_omega;
+			spec_set_form(&s,ft_omega);
 			short_to_long(SETL_SYSTEM &s,result);
 		       } 
 		     } else {
 			integer_multiply(SETL_SYSTEM &s,&s,&s256);
-			si.sp_val.sp_short_value=sign*b;
+			spec_set_val(&si,sp_short_value,sign*b);
 			integer_add(SETL_SYSTEM &s,&s,&si);
 		     }		
 		     i++;
@@ -2817,11 +2805,8 @@ char tmpstring[100];
 		} else {
 		   fresult=(double)(result)/100;
 		}
-	           i_get_real(real_ptr);
-            	   sd.sp_form = ft_real;
-            	   sd.sp_val.sp_real_ptr = real_ptr;
-            	   real_ptr->r_use_count = 1;
-                   real_ptr->r_value = fresult;
+            	   spec_set_form(&sd,ft_real);
+            	   spec_set_val(&sd,sp_real_value,fresult);
 
 		   if ((conv==6)||(conv==8)) {
 		      TUPLE_ADD_CELL(ca,&sd);
@@ -2836,8 +2821,8 @@ char tmpstring[100];
         	  STRING_CONSTRUCTOR_ADD(cs,tmpstring[i]);
        		   i++;
   		}
-	        ss.sp_form=ft_string;
-       		ss.sp_val.sp_string_ptr = STRING_HEADER(cs);
+	        spec_set_form(&ss,ft_string);
+       		spec_set_val(&ss,sp_string_ptr,STRING_HEADER(cs));
                 TUPLE_ADD_CELL(ca,&ss);
 		}
   
@@ -2851,15 +2836,15 @@ char tmpstring[100];
    }
  
    TUPLE_CONSTRUCTOR_END(ca);
-   ss.sp_form = ft_tuple;
-   ss.sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(&ss,ft_tuple);
+   spec_set_val(&ss,sp_tuple_ptr,TUPLE_HEADER(ca));
    TUPLE_ADD_CELL(cb,&ss);
    
    }
    TUPLE_CONSTRUCTOR_END(cb);
    
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(cb);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(cb));
    return;
 
 }
@@ -93,7 +93,7 @@ void check_arg(
   char *routine)
 {
 
-   if (argv[param].sp_form != type)
+   if (spec_form(&argv[param]) != type)
       abend(SETL_SYSTEM msg_bad_arg,typestr,param+1,routine,
             abend_opnd_str(SETL_SYSTEM argv+param));
 
@@ -184,8 +184,8 @@ int head,la,lb;
               head = 1;
            }
    
-           s.sp_form = ft_short;
-           s.sp_val.sp_short_value = (i+1);
+           spec_set_form(&s,ft_short);
+           spec_set_val(&s,sp_short_value,(i+1));
           
            TUPLE_ADD_CELL(ca,&s);
 
@@ -201,13 +201,13 @@ int head,la,lb;
    if (head) {
       TUPLE_CONSTRUCTOR_END(ca);
       unmark_specifier(target);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
       return;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
 }
 
@@ -279,8 +279,8 @@ int m;
 
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
 
 }
 
@@ -310,8 +310,8 @@ int head;
               head = 1;
            }
    
-           s.sp_form = ft_short;
-           s.sp_val.sp_short_value = (i-j+1);
+           spec_set_form(&s,ft_short);
+           spec_set_val(&s,sp_short_value,(i-j+1));
           
            TUPLE_ADD_CELL(ca,&s);
 
@@ -329,13 +329,13 @@ int head;
    if (head) {
       TUPLE_CONSTRUCTOR_END(ca);
       unmark_specifier(target);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
       return;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
 }
 
@@ -361,12 +361,12 @@ int n;
 
    STRING_CONVERT(sa,key);
 
-   if ((argv[1].sp_form != ft_opaque)||
-       (((argv[1].sp_val.sp_opaque_ptr->type)&65535)!=pat_type))
+   if ((spec_form(&argv[1]) != ft_opaque)||
+       (((spec_val(&argv[1],sp_opaque_ptr)->type)&65535)!=pat_type))
       abend(SETL_SYSTEM msg_bad_arg,"string matching",2,"kmp_exec",
          abend_opnd_str(SETL_SYSTEM argv+1));
 
-   A = (struct setl_pat *)(argv[1].sp_val.sp_opaque_ptr);
+   A = (struct setl_pat *)(spec_val(&argv[1],sp_opaque_ptr));
 
    KMP_EXEC_IN(SETL_SYSTEM key,n,A->pattern,A->len,(int32*)A->ptr,
 	target,NO);
@@ -510,8 +510,8 @@ int m;
    BM_COMPILE_IN(SETL_SYSTEM pattern,m,bm_gs,bm_bc);
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
 
 }
 
@@ -543,8 +543,8 @@ int head;
               head = 1;
            }
    
-           s.sp_form = ft_short;
-           s.sp_val.sp_short_value = (i+1);
+           spec_set_form(&s,ft_short);
+           spec_set_val(&s,sp_short_value,(i+1));
           
            TUPLE_ADD_CELL(ca,&s);
 
@@ -567,13 +567,13 @@ int head;
    if (head) {
       TUPLE_CONSTRUCTOR_END(ca);
       unmark_specifier(target);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
       return;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
 }
 
@@ -599,12 +599,12 @@ int n;
 
    STRING_CONVERT(sa,key);
 
-   if ((argv[1].sp_form != ft_opaque)||
-       (((argv[1].sp_val.sp_opaque_ptr->type)&65535)!=pat_type))
+   if ((spec_form(&argv[1]) != ft_opaque)||
+       (((spec_val(&argv[1],sp_opaque_ptr)->type)&65535)!=pat_type))
       abend(SETL_SYSTEM msg_bad_arg,"string matching",2,"bm_exec",
          abend_opnd_str(SETL_SYSTEM argv+1));
 
-   A = (struct setl_pat *)(argv[1].sp_val.sp_opaque_ptr);
+   A = (struct setl_pat *)(spec_val(&argv[1],sp_opaque_ptr));
 
    BM_EXEC_IN(SETL_SYSTEM key,n,A->pattern,A->len,(int32*)A->ptr,
 	(int32*)A->ptr2,target,NO);
@@ -747,8 +747,8 @@ int32 *p,*q;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value =*(p-1);
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,*(p-1));
 
    s1++;s2++; /* Fix the pointers before freeing */
 
@@ -898,21 +898,21 @@ specifier s;
 
    TUPLE_CONSTRUCTOR_BEGIN(tc);
 
-   s.sp_form = ft_string;
-   s.sp_val.sp_string_ptr = STRING_HEADER(sc);
+   spec_set_form(&s,ft_string);
+   spec_set_val(&s,sp_string_ptr,STRING_HEADER(sc));
 
    TUPLE_ADD_CELL(tc,&s);
 
-   s.sp_form = ft_short;
-   s.sp_val.sp_short_value = minval;
+   spec_set_form(&s,ft_short);
+   spec_set_val(&s,sp_short_value,minval);
 
    TUPLE_ADD_CELL(tc,&s);
 
    TUPLE_CONSTRUCTOR_END(tc);
 
    unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(tc);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(tc));
 
    s1++;s2++; /* Fix the pointers before freeing */
 
@@ -957,21 +957,21 @@ int tl;
    ITERATE_TUPLE_BEGIN(ti,argv[2]) 
    {
       tl++;
-      if ((tl>4)||(ti_element->sp_form!=ft_short)) {
+      if ((tl>4)||(spec_form(ti_element)!=ft_short)) {
          abend(SETL_SYSTEM "Score Tuple in EDIST must have integer elements");
       }
       switch (tl) {
 	case 1:
-	   ins = ti_element->sp_val.sp_short_value;
+	   ins = spec_val(ti_element,sp_short_value);
            break;
 	case 2:
-	   del = ti_element->sp_val.sp_short_value;
+	   del = spec_val(ti_element,sp_short_value);
            break;
 	case 3:
-	   re = ti_element->sp_val.sp_short_value;
+	   re = spec_val(ti_element,sp_short_value);
            break;
 	case 4:
-	   e = ti_element->sp_val.sp_short_value;
+	   e = spec_val(ti_element,sp_short_value);
            break;
       }
 
@@ -1019,21 +1019,21 @@ int tl;
    ITERATE_TUPLE_BEGIN(ti,argv[2]) 
    {
       tl++;
-      if ((tl>4)||(ti_element->sp_form!=ft_short)) {
+      if ((tl>4)||(spec_form(ti_element)!=ft_short)) {
          abend(SETL_SYSTEM "Score Tuple in EXETRANS must have integer elements");
       }
       switch (tl) {
 	case 1:
-	   ins = ti_element->sp_val.sp_short_value;
+	   ins = spec_val(ti_element,sp_short_value);
            break;
 	case 2:
-	   del = ti_element->sp_val.sp_short_value;
+	   del = spec_val(ti_element,sp_short_value);
            break;
 	case 3:
-	   re = ti_element->sp_val.sp_short_value;
+	   re = spec_val(ti_element,sp_short_value);
            break;
 	case 4:
-	   e = ti_element->sp_val.sp_short_value;
+	   e = spec_val(ti_element,sp_short_value);
            break;
       }
 
@@ -1079,7 +1079,7 @@ char *buffer;
    int i,lb;
    char *p;
 
-       if (ti_element->sp_form!=ft_string) {
+       if (spec_form(ti_element)!=ft_string) {
           abend(SETL_SYSTEM "Tuple in AC_COMPILE must have string elements");
        }
        lb = STRING_LEN((*ti_element));
@@ -1118,8 +1118,8 @@ char *buffer;
    A->ptr2 = NULL;
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
 
 }
 
@@ -1135,12 +1135,12 @@ char *key;                             /* system key                        */
 int n;
 AC_STRUCT *ac;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=pat_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=pat_type))
       abend(SETL_SYSTEM msg_bad_arg,"string matching",1,"ac_init",
          abend_opnd_str(SETL_SYSTEM argv));
 
-   A = (struct setl_pat *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_pat *)(spec_val(&argv[0],sp_opaque_ptr));
 
    ac = (AC_STRUCT*)(A->ptr);
 
@@ -1158,14 +1158,14 @@ AC_STRUCT *ac;
    if (ac_search_init(ac,key,n)>0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 1;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,1);
       return;
 
    } else {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
 
    }
@@ -1187,12 +1187,12 @@ AC_STRUCT *ac;
 int length_out,id_out;
 specifier s;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=pat_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=pat_type))
       abend(SETL_SYSTEM msg_bad_arg,"string matching",1,"ac_next_match",
          abend_opnd_str(SETL_SYSTEM argv));
 
-   A = (struct setl_pat *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_pat *)(spec_val(&argv[0],sp_opaque_ptr));
 
    ac = (AC_STRUCT*)(A->ptr);
 
@@ -1201,32 +1201,32 @@ specifier s;
    if (key==NULL) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
 
    }
 
    TUPLE_CONSTRUCTOR_BEGIN(tc);
    
-   s.sp_form = ft_short;
-   s.sp_val.sp_short_value = id_out;
+   spec_set_form(&s,ft_short);
+   spec_set_val(&s,sp_short_value,id_out);
   
    TUPLE_ADD_CELL(tc,&s);
 
-   s.sp_form = ft_short;
-   s.sp_val.sp_short_value = (int)(key-ac->T);
+   spec_set_form(&s,ft_short);
+   spec_set_val(&s,sp_short_value,(int)(key-ac->T));
 
    TUPLE_ADD_CELL(tc,&s);
 
-   s.sp_form = ft_short;
-   s.sp_val.sp_short_value = length_out;
+   spec_set_form(&s,ft_short);
+   spec_set_val(&s,sp_short_value,length_out);
 
    TUPLE_ADD_CELL(tc,&s);
 
    TUPLE_CONSTRUCTOR_END(tc);
 
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(tc);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(tc));
    return;
 
 }
@@ -1265,8 +1265,8 @@ SUFFIX_TREE st;
    A->ptr2 = NULL;
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
 
 }
 
@@ -1284,8 +1284,8 @@ int n;
 char *key;
 SUFFIX_TREE st;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=pat_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=pat_type))
       abend(SETL_SYSTEM msg_bad_arg,"suffix tree",1,"st_add_string",
          abend_opnd_str(SETL_SYSTEM argv));
 
@@ -1301,7 +1301,7 @@ SUFFIX_TREE st;
    STRING_CONVERT(sa,key);
 
 
-   A = (struct setl_pat *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_pat *)(spec_val(&argv[0],sp_opaque_ptr));
 
    st = (SUFFIX_TREE)(A->ptr);
 
@@ -1311,14 +1311,14 @@ SUFFIX_TREE st;
    
    if (i==0) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
        
    } 
     A->len++;
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value =A->len;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,A->len);
 
 
 
@@ -1381,8 +1381,8 @@ char *seq;
 specifier s;
 MATCHES ptr;
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=pat_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=pat_type))
       abend(SETL_SYSTEM msg_bad_arg,"string matching",1,"st_match",
          abend_opnd_str(SETL_SYSTEM argv));
 
@@ -1398,7 +1398,7 @@ MATCHES ptr;
    STRING_CONVERT(sa,key);
 
 
-   A = (struct setl_pat *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_pat *)(spec_val(&argv[0],sp_opaque_ptr));
 
    st = (SUFFIX_TREE)(A->ptr);
 
@@ -1408,7 +1408,7 @@ MATCHES ptr;
    if (length_out < n) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
 
    }
@@ -1425,7 +1425,7 @@ MATCHES ptr;
   stree_traverse_subtree(st, node, add_match, (int (*)()) NULL);
   if (matcherror) {
 	  unmark_specifier(target);
-	  target->sp_form = ft_omega;
+	  spec_set_form(target,ft_omega);
 	  return;
   }
     
@@ -1474,25 +1474,25 @@ MATCHES ptr;
 	   
 	       TUPLE_CONSTRUCTOR_BEGIN(tc);
 	        
-	   	   s.sp_form = ft_short;
-		   s.sp_val.sp_short_value = ptr->textid;
+	   	   spec_set_form(&s,ft_short);
+		   spec_set_val(&s,sp_short_value,ptr->textid);
 		  
 		   TUPLE_ADD_CELL(tc,&s);
 
-		   s.sp_form = ft_short;
-		   s.sp_val.sp_short_value = (int)(ptr->lend);
+		   spec_set_form(&s,ft_short);
+		   spec_set_val(&s,sp_short_value,(int)(ptr->lend));
 
 		   TUPLE_ADD_CELL(tc,&s);
 
-		   s.sp_form = ft_short;
-		   s.sp_val.sp_short_value = (int)(ptr->rend);
+		   spec_set_form(&s,ft_short);
+		   spec_set_val(&s,sp_short_value,(int)(ptr->rend));
 
 		   TUPLE_ADD_CELL(tc,&s);
 		   
 		   TUPLE_CONSTRUCTOR_END(tc);
 				   
-		   s.sp_form = ft_tuple;
-		   s.sp_val.sp_tuple_ptr = TUPLE_HEADER(tc);
+		   spec_set_form(&s,ft_tuple);
+		   spec_set_val(&s,sp_tuple_ptr,TUPLE_HEADER(tc));
 		   TUPLE_ADD_CELL(ta,&s);
 		   
 		   ptr=ptr->next;
@@ -1503,8 +1503,8 @@ MATCHES ptr;
 
    free_matches(matchlist);
     
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ta);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ta));
    return;
 
 }
@@ -1539,7 +1539,7 @@ char *buffer;
    int i;
    char a,b;
 
-       if (ti_element->sp_form!=ft_tuple) {
+       if (spec_form(ti_element)!=ft_tuple) {
           abend(SETL_SYSTEM "Tuple in PWSCORES must have tuple elements");
        }
        tuple_el = 0;
@@ -1548,8 +1548,8 @@ char *buffer;
           switch (tuple_el) 
           {
               case 0:
-                 if (t2_element->sp_form==ft_short) {
-                   if (t2_element->sp_val.sp_short_value!=0) 
+                 if (spec_form(t2_element)==ft_short) {
+                   if (spec_val(t2_element,sp_short_value)!=0) 
                       abend(SETL_SYSTEM "The first component in tuple "
                            "elements in PWSCORES must be a character or 0");
                    else {
@@ -1557,7 +1557,7 @@ char *buffer;
                       break;
                    }
                  }
-                 if (t2_element->sp_form!=ft_string) {
+                 if (spec_form(t2_element)!=ft_string) {
                       abend(SETL_SYSTEM "The first component in tuple "
                            "elements in PWSCORES must be a character or 0");
                  }
@@ -1565,8 +1565,8 @@ char *buffer;
                  a = ITERATE_STRING_CHAR(sa);
                  break;
               case 1:
-                 if (t2_element->sp_form==ft_short) {
-                   if (t2_element->sp_val.sp_short_value!=0) 
+                 if (spec_form(t2_element)==ft_short) {
+                   if (spec_val(t2_element,sp_short_value)!=0) 
                       abend(SETL_SYSTEM "The second component in tuple "
                            "elements in PWSCORES must be a character or 0");
                    else {
@@ -1574,7 +1574,7 @@ char *buffer;
                       break;
                    }
                  }
-                 if (t2_element->sp_form!=ft_string) {
+                 if (spec_form(t2_element)!=ft_string) {
                       abend(SETL_SYSTEM "The second component in tuple "
                            "elements in PWSCORES must be a character or 0");
                  }
@@ -1582,17 +1582,17 @@ char *buffer;
                  b = ITERATE_STRING_CHAR(sa);
                  break;
               case 2:
-                 if (t2_element->sp_form!=ft_short) {
+                 if (spec_form(t2_element)!=ft_short) {
                       abend(SETL_SYSTEM "The third component in tuple "
                            "elements in PWSCORES must be an integer");
                  }
-                 if ((t2_element->sp_val.sp_short_value>127)||
-                     (t2_element->sp_val.sp_short_value<-127)) {
+                 if ((spec_val(t2_element,sp_short_value)>127)||
+                     (spec_val(t2_element,sp_short_value)<-127)) {
                       abend(SETL_SYSTEM 
                            "The weights in PWSCORES must be in [-127,127]");
                  }
-                 buffer[a*256+b]=t2_element->sp_val.sp_short_value;
-                 buffer[b*256+a]=t2_element->sp_val.sp_short_value;
+                 buffer[a*256+b]=spec_val(t2_element,sp_short_value);
+                 buffer[b*256+a]=spec_val(t2_element,sp_short_value);
                  break;
           }
  
@@ -1622,8 +1622,8 @@ char *buffer;
    A->ptr2 = NULL;
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
 
 }
 
@@ -1764,21 +1764,21 @@ specifier s;
 
    TUPLE_CONSTRUCTOR_BEGIN(tc);
 
-   s.sp_form = ft_string;
-   s.sp_val.sp_string_ptr = STRING_HEADER(sc);
+   spec_set_form(&s,ft_string);
+   spec_set_val(&s,sp_string_ptr,STRING_HEADER(sc));
 
    TUPLE_ADD_CELL(tc,&s);
 
-   s.sp_form = ft_short;
-   s.sp_val.sp_short_value = maxval;
+   spec_set_form(&s,ft_short);
+   spec_set_val(&s,sp_short_value,maxval);
 
    TUPLE_ADD_CELL(tc,&s);
 
    TUPLE_CONSTRUCTOR_END(tc);
 
    unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(tc);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(tc));
 
    s1++;s2++; /* Fix the pointers before freeing */
 
@@ -1827,12 +1827,12 @@ int sum;
 
    STRING_CONVERT(sb,s2);
 
-   if ((argv[2].sp_form != ft_opaque)||
-       (((argv[2].sp_val.sp_opaque_ptr->type)&65535)!=pat_type))
+   if ((spec_form(&argv[2]) != ft_opaque)||
+       (((spec_val(&argv[2],sp_opaque_ptr)->type)&65535)!=pat_type))
       abend(SETL_SYSTEM msg_bad_arg,"string matching",3,"simil",
          abend_opnd_str(SETL_SYSTEM argv+2));
 
-   A = (struct setl_pat *)(argv[2].sp_val.sp_opaque_ptr);
+   A = (struct setl_pat *)(spec_val(&argv[2],sp_opaque_ptr));
   
    pwscores=A->ptr;
  
@@ -1888,8 +1888,8 @@ int sum;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value =*(p-1);
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,*(p-1));
 
    s1++;s2++; /* Fix the pointers before freeing */
 
@@ -1940,12 +1940,12 @@ specifier s;
 
    STRING_CONVERT(sb,s2);
 
-   if ((argv[2].sp_form != ft_opaque)||
-       (((argv[2].sp_val.sp_opaque_ptr->type)&65535)!=pat_type))
+   if ((spec_form(&argv[2]) != ft_opaque)||
+       (((spec_val(&argv[2],sp_opaque_ptr)->type)&65535)!=pat_type))
       abend(SETL_SYSTEM msg_bad_arg,"string matching",3,"simil",
          abend_opnd_str(SETL_SYSTEM argv+2));
 
-   A = (struct setl_pat *)(argv[2].sp_val.sp_opaque_ptr);
+   A = (struct setl_pat *)(spec_val(&argv[2],sp_opaque_ptr));
   
    pwscores=A->ptr;
  
@@ -2044,21 +2044,21 @@ specifier s;
 
    TUPLE_CONSTRUCTOR_BEGIN(tc);
 
-   s.sp_form = ft_string;
-   s.sp_val.sp_string_ptr = STRING_HEADER(sc);
+   spec_set_form(&s,ft_string);
+   spec_set_val(&s,sp_string_ptr,STRING_HEADER(sc));
 
    TUPLE_ADD_CELL(tc,&s);
 
-   s.sp_form = ft_short;
-   s.sp_val.sp_short_value = maxval;
+   spec_set_form(&s,ft_short);
+   spec_set_val(&s,sp_short_value,maxval);
 
    TUPLE_ADD_CELL(tc,&s);
 
    TUPLE_CONSTRUCTOR_END(tc);
 
    unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(tc);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(tc));
 
    s1++;s2++; /* Fix the pointers before freeing */
 
@@ -92,7 +92,7 @@ void check_arg(
   char *routine)
 {
 
-   if (argv[param].sp_form != type)
+   if (spec_form(&argv[param]) != type)
       abend(SETL_SYSTEM msg_bad_arg,typestr,param+1,routine,
             abend_opnd_str(SETL_SYSTEM argv+param));
 
@@ -107,10 +107,11 @@ int check_int(
   char *routine)
 {
 
- if (argv[param].sp_form == ft_short) 
-      return (int)(argv[param].sp_val.sp_short_value);
-   else if (argv[param].sp_form == ft_long) 
-      return (int)long_to_short(SETL_SYSTEM argv[param].sp_val.sp_long_ptr);
+ if (spec_form(&argv[param]) == ft_short) 
+      return (int)(spec_val(&argv[param],sp_short_value));
+   else if (spec_form(&argv[param]) == ft_long) 
+      return (int)long_to_short(SETL_SYSTEM
+                                spec_val(&argv[param],sp_long_ptr));
    else 
       abend(SETL_SYSTEM msg_bad_arg,"integer",param+1,routine,
             abend_opnd_str(SETL_SYSTEM argv+param));
@@ -177,8 +178,8 @@ long retsize;
    free(compr);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
    return;
 
   }
@@ -242,8 +243,8 @@ long retsize;
    free(compr);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
    return;
 
   }
@@ -284,7 +285,7 @@ char *str,*filename;
    free(filename);
    if (uf==NULL) {
 		unmark_specifier(target);
-		target->sp_form = ft_omega;
+		spec_set_form(target,ft_omega);
 		return;
    }
    
@@ -298,8 +299,8 @@ char *str,*filename;
    
 
    unmark_specifier(target);
-   target->sp_form = ft_opaque;
-   target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
 
 }
 
@@ -314,19 +315,19 @@ struct setl_zip *A; /* w */
 int len;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=zip_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=zip_type))
        abend(SETL_SYSTEM msg_bad_arg,"zip object",1,"close_zip",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   A = (struct setl_zip *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_zip *)(spec_val(&argv[0],sp_opaque_ptr));
 	
    unzCloseCurrentFile(A->ptr);
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 
 }
@@ -347,14 +348,14 @@ unz_global_info gi;
 int err;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=zip_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=zip_type))
        abend(SETL_SYSTEM msg_bad_arg,"zip object",1,"debug_zip",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   A = (struct setl_zip *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_zip *)(spec_val(&argv[0],sp_opaque_ptr));
    uf = A->ptr;	
   unzGoToFirstFile((unzFile)uf);	
 
@@ -415,7 +416,7 @@ int err;
 
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 
 }
@@ -440,14 +441,14 @@ unz_global_info gi;
 int err;
 
 
-   if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=zip_type))
+   if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=zip_type))
        abend(SETL_SYSTEM msg_bad_arg,"zip object",1,"list_zip",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   A = (struct setl_zip *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_zip *)(spec_val(&argv[0],sp_opaque_ptr));
    uf = A->ptr;	
   
     unzGoToFirstFile((unzFile)uf);	
@@ -506,13 +507,13 @@ int err;
 			 z++;
 		}
 
-		s.sp_form=ft_string;
-		s.sp_val.sp_string_ptr = STRING_HEADER(sa);
+		spec_set_form(&s,ft_string);
+		spec_set_val(&s,sp_string_ptr,STRING_HEADER(sa));
 		TUPLE_ADD_CELL(cb,&s);
 
 
-		s.sp_form = ft_short;
-		s.sp_val.sp_short_value=file_info.uncompressed_size;
+		spec_set_form(&s,ft_short);
+		spec_set_val(&s,sp_short_value,file_info.uncompressed_size);
 		TUPLE_ADD_CELL(cb,&s);
 
 		TUPLE_CONSTRUCTOR_END(cb);
@@ -529,8 +530,8 @@ int err;
 		*/		
 				
 			           
-       s.sp_form=ft_tuple;
-       s.sp_val.sp_tuple_ptr =TUPLE_HEADER(cb);
+       spec_set_form(&s,ft_tuple);
+       spec_set_val(&s,sp_tuple_ptr,TUPLE_HEADER(cb));
        TUPLE_ADD_CELL(ca,&s);
 	
 				
@@ -548,8 +549,8 @@ int err;
    TUPLE_CONSTRUCTOR_END(ca);
    
    unmark_specifier(target); 
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = TUPLE_HEADER(ca);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,TUPLE_HEADER(ca));
    return;
 
 
@@ -868,14 +869,14 @@ char *str,*filename;
 
    check_arg(SETL_SYSTEM argv,1,ft_string,"string","extract_from_zip");
  
- if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=zip_type))
+ if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=zip_type))
        abend(SETL_SYSTEM msg_bad_arg,"zip object",1,"list_zip",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   A = (struct setl_zip *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_zip *)(spec_val(&argv[0],sp_opaque_ptr));
    uf = A->ptr;	
    
    ITERATE_STRING_BEGIN(sc,argv[1]);
@@ -897,7 +898,7 @@ char *str,*filename;
     {
       free(filename);	
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return; 
      
     }
@@ -913,8 +914,8 @@ char *str,*filename;
 
   
 	unmark_specifier(target);
-	target->sp_form = ft_short;
-	target->sp_val.sp_short_value = i;
+	spec_set_form(target,ft_short);
+	spec_set_val(target,sp_short_value,i);
     return;
 
 
@@ -948,14 +949,14 @@ char *buff;
 
    check_arg(SETL_SYSTEM argv,1,ft_string,"string","get_from_zip");
  
- if ((argv[0].sp_form != ft_opaque)||
-       (((argv[0].sp_val.sp_opaque_ptr->type)&65535)!=zip_type))
+ if ((spec_form(&argv[0]) != ft_opaque)||
+       (((spec_val(&argv[0],sp_opaque_ptr)->type)&65535)!=zip_type))
        abend(SETL_SYSTEM msg_bad_arg,"zip object",1,"list_zip",
          abend_opnd_str(SETL_SYSTEM argv+0));
 
  
 
-   A = (struct setl_zip *)(argv[0].sp_val.sp_opaque_ptr);
+   A = (struct setl_zip *)(spec_val(&argv[0],sp_opaque_ptr));
    uf = A->ptr;	
    
    ITERATE_STRING_BEGIN(sc,argv[1]);
@@ -977,7 +978,7 @@ char *buff;
     {
       free(filename);	
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return; 
      
     }
@@ -993,7 +994,7 @@ char *buff;
     if (do_extract_currentfile(uf,1,1,buff,0) != UNZ_OK) {
     	free(buff);
     	unmark_specifier(target);
-        target->sp_form = ft_omega;
+        spec_set_form(target,ft_omega);
         return; 
     
     }
@@ -1010,8 +1011,8 @@ char *buff;
    free(buff);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = STRING_HEADER(cs);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,STRING_HEADER(cs));
    return;
 
 
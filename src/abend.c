@@ -98,26 +98,25 @@ char *abend_opnd_str(
 char *return_ptr;                      /* returned string                   */
 specifier spare;                       /* spare specifier for str call      */
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 int chars_to_print;                    /* characters left in string         */
 int print_dots;                        /* YES if we truncated the string    */
 char *s, *t;                           /* temporary looping variables       */
 
    /* find the printable string form of the specifier */
 
-   spare.sp_form = ft_omega;
+   spec_set_form(&spare,ft_omega);
    setl2_str(SETL_SYSTEM 1, spec, &spare);
 
    /* allocate a return string */
 
-   string_hdr = spare.sp_val.sp_string_ptr;
+   string_hdr = spec_val(&spare,sp_string_ptr);
    return_ptr = (char *)malloc((size_t)71);
    if (return_ptr == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
    /* the first part of the string is its form */
 
-   strcpy(return_ptr,form_desc[spec->sp_form]);
+   strcpy(return_ptr,form_desc[spec_form(spec)]);
    t = return_ptr + strlen(return_ptr);
    *t++ = ':';
    *t++ = ' ';
@@ -135,15 +134,10 @@ char *s, *t;                           /* temporary looping variables       */
 
    /* copy the string (or a prefix) */
 
-   for (string_cell = string_hdr->s_head;
+   for (s = string_hdr->s_chars;
         chars_to_print;
-        string_cell = string_cell->s_next) {
+        *t++ = *s++, chars_to_print--);
 
-      for (s = string_cell->s_cell_value;
-           chars_to_print && (s < string_cell->s_cell_value + STR_CELL_WIDTH);
-           *t++ = *s++, chars_to_print--);
-
-   }
 
    /* print dots if we truncated the string */
 
@@ -484,7 +478,7 @@ static int abend_nested_calls=0;
 
    /* make sure our callback is a procedure */
 	 
-   if (spec_abendtrap->sp_form != ft_proc) {
+   if (spec_form(spec_abendtrap) != ft_proc) {
 #ifdef PLUGIN
 			 hard_stop=1;
 	 		 if (abend_initialized) {
@@ -497,7 +491,7 @@ static int abend_nested_calls=0;
    }
    /* call the abend trap */
 
-   spare.sp_form = ft_omega;
+   spec_set_form(&spare,ft_omega);
    call_procedure(SETL_SYSTEM &spare,
                   spec_abendtrap,
                   NULL,
@@ -39,7 +39,7 @@ void access_property(
 	 specifier *right)                    /* The property name    */
 
 {
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 }
 
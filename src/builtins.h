@@ -53,6 +53,8 @@ typedef struct {
    int bi_formal_count;                /* minimum formal parameters         */
    unsigned bi_var_args : 1;           /* YES if variable number of         */
                                        /* arguments are allowed             */
+   unsigned bi_side_effects : 1;       /* YES if it may change more than    */
+                                       /* its result                        */
    char *bi_arg_mode;                  /* parameter passing modes           */
 } c_built_in_sym;
 
@@ -108,6 +110,8 @@ typedef struct {
    int bi_formal_count;                /* minimum formal parameters         */
    unsigned bi_var_args : 1;           /* YES if variable number of         */
                                        /* arguments are allowed             */
+   unsigned bi_side_effects : 1;       /* YES if it may change more than    */
+                                       /* its result                        */
 } i_built_in_sym;
 
 /* built-in functions */
@@ -231,6 +235,45 @@ void setl2_sqrt(SETL_SYSTEM_PROTO
 void setl2_sign(SETL_SYSTEM_PROTO
                  int, struct specifier_item *, struct specifier_item *);
                                        /* SETL2 sign procedure              */
+void setl2_tuple_sum(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 tuple_sum procedure         */
+void setl2_tuple_product(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 tuple_product procedure     */
+void setl2_tuple_min(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 tuple_min procedure         */
+void setl2_tuple_max(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 tuple_max procedure         */
+void setl2_tuple_dot(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 tuple_dot procedure         */
+void setl2_memory_stats(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 memory_stats procedure      */
+void setl2_worker_start(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 worker_start procedure      */
+void setl2_worker_result(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 worker_result procedure     */
+void setl2_worker_forall(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 worker_forall procedure     */
+void setl2_sleep(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 proc_sleep procedure        */
+void setl2_priority(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 proc_priority procedure     */
+void setl2_usage(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 proc_usage procedure        */
+void setl2_drain(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 proc_drain procedure        */
 /*
  *  String scanning primitives
  */
@@ -425,6 +468,12 @@ void setl2_eval(SETL_SYSTEM_PROTO
 void setl2_popen(SETL_SYSTEM_PROTO
                  int, struct specifier_item *, struct specifier_item *);
                                        /* SETL2 popen procedure             */
+void setl2_socket_accept(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 socket_accept procedure     */
+void setl2_socket_accept_all(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 socket_accept_all procedure */
 void setl2_getchar(SETL_SYSTEM_PROTO
                  int, struct specifier_item *, struct specifier_item *);
                                        /* SETL2 getchar procedure           */
@@ -494,6 +543,20 @@ void setl2_create_activexobject(SETL_SYSTEM_PROTO
                  int, struct specifier_item *, struct specifier_item *);
                                        /* Give a JAVASCRIPT command         */
 
+/*
+ *  String builders
+ */
+
+void setl2_string_builder(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 string_builder procedure    */
+void setl2_builder_add(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 builder_add procedure       */
+void setl2_builder_string(SETL_SYSTEM_PROTO
+                 int, struct specifier_item *, struct specifier_item *);
+                                       /* SETL2 builder_string procedure    */
+
 
 /* interpreter symbols to be initialized */
 
@@ -30,80 +30,80 @@
 \*/
 
 #ifdef COMPILER
-{  ft_omega,   "OM",                &sym_omega,          0,    0,    ""    },
+{  ft_omega,   "OM",                &sym_omega,     0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_omega,   &spec_omega,      0, NULL,                0,    0     },
+{  ft_omega,   &spec_omega,      0, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_atom,    "FALSE",             &sym_false,          0,    0,    ""    },
+{  ft_atom,    "FALSE",             &sym_false,     0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_atom,    &spec_false,      0, NULL,                0,    0     },
+{  ft_atom,    &spec_false,      0, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_atom,    "TRUE",              &sym_true,           0,    0,    ""    },
+{  ft_atom,    "TRUE",              &sym_true,      0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_atom,    &spec_true,       0, NULL,                0,    0     },
+{  ft_atom,    &spec_true,       0, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_long,    "0",                 &sym_zero,           0,    0,    ""    },
+{  ft_long,    "0",                 &sym_zero,      0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_short,   &spec_zero,       0, NULL,                0,    0     },
+{  ft_short,   &spec_zero,       0, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_long,    "1",                 &sym_one,            0,    0,    ""    },
+{  ft_long,    "1",                 &sym_one,       0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_short,   &spec_one,        1, NULL,                0,    0     },
+{  ft_short,   &spec_one,        1, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_long,    "2",                 &sym_two,            0,    0,    ""    },
+{  ft_long,    "2",                 &sym_two,       0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_short,   &spec_two,        2, NULL,                0,    0     },
+{  ft_short,   &spec_two,        2, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_omega,   "COMMAND_LINE",      NULL,                0,    0,    ""    },
+{  ft_omega,   "COMMAND_LINE",      NULL,           0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_omega,   &spec_cline,      0, NULL,                0,    0     },
+{  ft_omega,   &spec_cline,      0, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_omega,   "_nullset",          &sym_nullset,        0,    0,    ""    },
+{  ft_omega,   "_nullset",          &sym_nullset,   0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_omega,   &spec_nullset,    0, NULL,                0,    0     },
+{  ft_omega,   &spec_nullset,    0, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_omega,   "_nulltup",          &sym_nulltup,        0,    0,    ""    },
+{  ft_omega,   "_nulltup",          &sym_nulltup,   0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_omega,   &spec_nulltup,    0, NULL,                0,    0     },
+{  ft_omega,   &spec_nulltup,    0, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_omega,   "_memory",           &sym_memory,         0,    0,    ""    },
+{  ft_omega,   "_memory",           &sym_memory,    0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_omega,   &spec_memory,     0, NULL,                0,    0     },
+{  ft_omega,   &spec_memory,     0, NULL,                0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_omega,   "ABEND_TRAP",        &sym_abendtrap,      0,    0,    ""    },
+{  ft_omega,   "ABEND_TRAP",        &sym_abendtrap, 0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_omega,   &spec_abendtrap,  0, NULL,                0,    0     },
+{  ft_omega,   &spec_abendtrap,  0, NULL,                0,    0,    0     },
 #endif
 
 /*
@@ -111,24 +111,24 @@
  */
 
 #ifdef COMPILER
-{  ft_proc,    "NEWAT",             NULL,                0,    0,    ""    },
+{  ft_proc,    "NEWAT",             NULL,           0,    0,    1,    ""    },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_newat,         0,    0     },
+{  ft_proc,    NULL,             0, setl2_newat,         0,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "DATE",              NULL,                0,    0,    ""    },
+{  ft_proc,    "DATE",              NULL,           0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_date,          0,    0     },
+{  ft_proc,    NULL,             0, setl2_date,          0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "TIME",              NULL,                0,    0,    ""    },
+{  ft_proc,    "TIME",              NULL,           0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_time,          0,    0     },
+{  ft_proc,    NULL,             0, setl2_time,          0,    0,    0     },
 #endif
 
 /*
@@ -136,73 +136,73 @@
  */
 
 #ifdef COMPILER
-{  ft_proc,    "TYPE",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "TYPE",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_type,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_type,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_ATOM",           NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_ATOM",           NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_atom,       1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_atom,       1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_BOOLEAN",        NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_BOOLEAN",        NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_boolean,    1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_boolean,    1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_INTEGER",        NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_INTEGER",        NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_integer,    1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_integer,    1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_REAL",           NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_REAL",           NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_real,       1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_real,       1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_STRING",         NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_STRING",         NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_string,     1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_string,     1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_SET",            NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_SET",            NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_set,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_set,        1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_MAP",            NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_MAP",            NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_map,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_map,        1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_TUPLE",          NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_TUPLE",          NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_tuple,      1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_tuple,      1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IS_PROCEDURE",      NULL,                1,    0,    "1"   },
+{  ft_proc,    "IS_PROCEDURE",      NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_is_procedure,  1,    0     },
+{  ft_proc,    NULL,             0, setl2_is_procedure,  1,    0,    0     },
 #endif
 
 /*
@@ -210,136 +210,136 @@
  */
 
 #ifdef COMPILER
-{  ft_proc,    "ABS",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "ABS",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_abs,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_abs,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "EVEN",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "EVEN",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_even,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_even,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "ODD",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "ODD",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_odd,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_odd,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "FLOAT",             NULL,                1,    0,    "1"   },
+{  ft_proc,    "FLOAT",             NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_float,         1,    0     },
+{  ft_proc,    NULL,             0, setl2_float,         1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "ATAN2",             NULL,                2,    0,    "11"  },
+{  ft_proc,    "ATAN2",             NULL,           2,    0,    0,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_atan2,         2,    0     },
+{  ft_proc,    NULL,             0, setl2_atan2,         2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "FIX",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "FIX",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_fix,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_fix,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "FLOOR",             NULL,                1,    0,    "1"   },
+{  ft_proc,    "FLOOR",             NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_floor,         1,    0     },
+{  ft_proc,    NULL,             0, setl2_floor,         1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "CEIL",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "CEIL",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_ceil,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_ceil,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "EXP",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "EXP",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_exp,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_exp,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "LOG",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "LOG",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_log,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_log,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "COS",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "COS",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_cos,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_cos,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SIN",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "SIN",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_sin,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_sin,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "TAN",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "TAN",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_tan,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_tan,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "ACOS",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "ACOS",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_acos,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_acos,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "ASIN",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "ASIN",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_asin,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_asin,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "ATAN",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "ATAN",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_atan,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_atan,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "TANH",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "TANH",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_tanh,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_tanh,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SQRT",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "SQRT",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_sqrt,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_sqrt,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SIGN",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "SIGN",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_sign,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_sign,          1,    0,    0     },
 #endif
 
 /*
@@ -347,115 +347,115 @@
  */
 
 #ifdef COMPILER
-{  ft_proc,    "CHAR",              NULL,                1,    0,    "1"   },
+{  ft_proc,    "CHAR",              NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_char,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_char,          1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "STR",               NULL,                1,    0,    "1"   },
+{  ft_proc,    "STR",               NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_str,           1,    0     },
+{  ft_proc,    NULL,             0, setl2_str,           1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "ANY",               NULL,                2,    0,    "31"  },
+{  ft_proc,    "ANY",               NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_any,           2,    0     },
+{  ft_proc,    NULL,             0, setl2_any,           2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "BREAK",             NULL,                2,    0,    "31"  },
+{  ft_proc,    "BREAK",             NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_break,         2,    0     },
+{  ft_proc,    NULL,             0, setl2_break,         2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "LEN",               NULL,                2,    0,    "31"  },
+{  ft_proc,    "LEN",               NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_len,           2,    0     },
+{  ft_proc,    NULL,             0, setl2_len,           2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "MATCH",             NULL,                2,    0,    "31"  },
+{  ft_proc,    "MATCH",             NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_match,         2,    0     },
+{  ft_proc,    NULL,             0, setl2_match,         2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "NOTANY",            NULL,                2,    0,    "31"  },
+{  ft_proc,    "NOTANY",            NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_notany,        2,    0     },
+{  ft_proc,    NULL,             0, setl2_notany,        2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SPAN",              NULL,                2,    0,    "31"  },
+{  ft_proc,    "SPAN",              NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_span,          2,    0     },
+{  ft_proc,    NULL,             0, setl2_span,          2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "LPAD",              NULL,                2,    0,    "11"  },
+{  ft_proc,    "LPAD",              NULL,           2,    0,    0,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_lpad,          2,    0     },
+{  ft_proc,    NULL,             0, setl2_lpad,          2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "RANY",              NULL,                2,    0,    "31"  },
+{  ft_proc,    "RANY",              NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_rany,          2,    0     },
+{  ft_proc,    NULL,             0, setl2_rany,          2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "RBREAK",            NULL,                2,    0,    "31"  },
+{  ft_proc,    "RBREAK",            NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_rbreak,        2,    0     },
+{  ft_proc,    NULL,             0, setl2_rbreak,        2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "RLEN",              NULL,                2,    0,    "31"  },
+{  ft_proc,    "RLEN",              NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_rlen,          2,    0     },
+{  ft_proc,    NULL,             0, setl2_rlen,          2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "RMATCH",            NULL,                2,    0,    "31"  },
+{  ft_proc,    "RMATCH",            NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_rmatch,        2,    0     },
+{  ft_proc,    NULL,             0, setl2_rmatch,        2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "RNOTANY",           NULL,                2,    0,    "31"  },
+{  ft_proc,    "RNOTANY",           NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_rnotany,       2,    0     },
+{  ft_proc,    NULL,             0, setl2_rnotany,       2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "RSPAN",             NULL,                2,    0,    "31"  },
+{  ft_proc,    "RSPAN",             NULL,           2,    0,    0,    "31"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_rspan,         2,    0     },
+{  ft_proc,    NULL,             0, setl2_rspan,         2,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "RPAD",              NULL,                2,    0,    "11"  },
+{  ft_proc,    "RPAD",              NULL,           2,    0,    0,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_rpad,          2,    0     },
+{  ft_proc,    NULL,             0, setl2_rpad,          2,    0,    0     },
 #endif
 
 /*
@@ -463,143 +463,143 @@
  */
 
 #ifdef COMPILER
-{  ft_proc,    "OPEN",              NULL,                1,    1,    "11"  },
+{  ft_proc,    "OPEN",              NULL,           1,    1,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_open,          1,    1     },
+{  ft_proc,    NULL,             0, setl2_open,          1,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "CLOSE",             NULL,                1,    0,    "11"  },
+{  ft_proc,    "CLOSE",             NULL,           1,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_close,         1,    0     },
+{  ft_proc,    NULL,             0, setl2_close,         1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "GET",               NULL,                1,    1,    "22"  },
+{  ft_proc,    "GET",               NULL,           1,    1,    1,    "22"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_get,           1,    1     },
+{  ft_proc,    NULL,             0, setl2_get,           1,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "GETA",              NULL,                2,    1,    "122" },
+{  ft_proc,    "GETA",              NULL,           2,    1,    1,    "122" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_geta,          2,    1     },
+{  ft_proc,    NULL,             0, setl2_geta,          2,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "READ",              NULL,                1,    1,    "22"  },
+{  ft_proc,    "READ",              NULL,           1,    1,    1,    "22"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_read,          1,    1     },
+{  ft_proc,    NULL,             0, setl2_read,          1,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "READA",             NULL,                2,    1,    "122" },
+{  ft_proc,    "READA",             NULL,           2,    1,    1,    "122" },
 #endif
 #ifdef INTERP
-{  ft_proc,    &spec_reada,      0, setl2_reada,         2,    1     },
+{  ft_proc,    &spec_reada,      0, setl2_reada,         2,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "READS",             NULL,                2,    1,    "322" },
+{  ft_proc,    "READS",             NULL,           2,    1,    0,    "322" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_reads,         2,    1     },
+{  ft_proc,    NULL,             0, setl2_reads,         2,    1,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "UNSTR",             NULL,                1,    0,    "1"   },
+{  ft_proc,    "UNSTR",             NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_unstr,         1,    0     },
+{  ft_proc,    NULL,             0, setl2_unstr,         1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "BINSTR",            NULL,                1,    0,    "1"   },
+{  ft_proc,    "BINSTR",            NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_binstr,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_binstr,        1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "UNBINSTR",          NULL,                1,    0,    "1"   },
+{  ft_proc,    "UNBINSTR",          NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_unbinstr,      1,    0     },
+{  ft_proc,    NULL,             0, setl2_unbinstr,      1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PRINT",             NULL,                0,    1,    "1"   },
+{  ft_proc,    "PRINT",             NULL,           0,    1,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_print,         0,    1     },
+{  ft_proc,    NULL,             0, setl2_print,         0,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "NPRINT",            NULL,                0,    1,    "1"   },
+{  ft_proc,    "NPRINT",            NULL,           0,    1,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_nprint,        0,    1     },
+{  ft_proc,    NULL,             0, setl2_nprint,        0,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PRINTA",            NULL,                1,    1,    "11"  },
+{  ft_proc,    "PRINTA",            NULL,           1,    1,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    &spec_printa,        0, setl2_printa,        1,    1     },
+{  ft_proc,    &spec_printa,        0, setl2_printa,     1,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "NPRINTA",           NULL,                1,    1,    "11"  },
+{  ft_proc,    "NPRINTA",           NULL,           1,    1,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    &spec_nprinta,       0, setl2_nprinta,       1,    1     },
+{  ft_proc,    &spec_nprinta,       0, setl2_nprinta,    1,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "GETB",              NULL,                2,    1,    "122" },
+{  ft_proc,    "GETB",              NULL,           2,    1,    1,    "122" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_getb,          2,    1     },
+{  ft_proc,    NULL,             0, setl2_getb,          2,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PUTB",              NULL,                1,    1,    "11"  },
+{  ft_proc,    "PUTB",              NULL,           1,    1,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_putb,          1,    1     },
+{  ft_proc,    NULL,             0, setl2_putb,          1,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "GETS",              NULL,                4,    0,    "1112"},
+{  ft_proc,    "GETS",              NULL,           4,    0,    1,    "1112"},
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_gets,          4,    0     },
+{  ft_proc,    NULL,             0, setl2_gets,          4,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PUTS",              NULL,                3,    0,    "111" },
+{  ft_proc,    "PUTS",              NULL,           3,    0,    1,    "111" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_puts,          1,    1     },
+{  ft_proc,    NULL,             0, setl2_puts,          1,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "FSIZE",             NULL,                1,    0,    "1"   },
+{  ft_proc,    "FSIZE",             NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    &spec_fsize,      0, setl2_fsize,         1,    0     },
+{  ft_proc,    &spec_fsize,      0, setl2_fsize,         1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "EOF",               NULL,                0,    0,    ""    },
+{  ft_proc,    "EOF",               NULL,           0,    0,    1,    ""    },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_eof,           0,    0     },
+{  ft_proc,    NULL,             0, setl2_eof,           0,    0,    1     },
 #endif
 
 /*
@@ -607,108 +607,108 @@
  */
 
 #ifdef COMPILER
-{  ft_proc,    "FEXISTS",           NULL,                1,    0,    "1"   },
+{  ft_proc,    "FEXISTS",           NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_fexists,       1,    0     },
+{  ft_proc,    NULL,             0, setl2_fexists,       1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SYSTEM",            NULL,                1,    0,    "1"   },
+{  ft_proc,    "SYSTEM",            NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_system,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_system,        1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "ABORT",             NULL,                1,    0,    "1"   },
+{  ft_proc,    "ABORT",             NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_abort,         1,    0     },
+{  ft_proc,    NULL,             0, setl2_abort,         1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "CALLOUT",           NULL,                3,    0,    "111" },
+{  ft_proc,    "CALLOUT",           NULL,           3,    0,    1,    "111" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_Ccallout,      3,    0     },
+{  ft_proc,    NULL,             0, setl2_Ccallout,      3,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "OPCODE_COUNT",      NULL,                0,    0,    ""    },
+{  ft_proc,    "OPCODE_COUNT",      NULL,           0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_opcode_count,  0,    0     },
+{  ft_proc,    NULL,             0, setl2_opcode_count,  0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "CALLOUT2",          NULL,                3,    0,    "111" },
+{  ft_proc,    "CALLOUT2",          NULL,           3,    0,    1,    "111" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_Ccallout2,     3,    0     },
+{  ft_proc,    NULL,             0, setl2_Ccallout2,     3,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "GETENV",            NULL,                1,    0,    "1"   },
+{  ft_proc,    "GETENV",            NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_getenv,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_getenv,        1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "POPEN",             NULL,                1,    0,    "1"   },
+{  ft_proc,    "POPEN",             NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_popen,         1,    0     },
+{  ft_proc,    NULL,             0, setl2_popen,         1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "GETCHAR",           NULL,                1,    0,    "1"   },
+{  ft_proc,    "GETCHAR",           NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_getchar,       1,    0     },
+{  ft_proc,    NULL,             0, setl2_getchar,       1,    0,    1     },
 #endif
  
 #ifdef COMPILER
-{  ft_proc,    "FFLUSH",            NULL,                1,    0,    "1"   },
+{  ft_proc,    "FFLUSH",            NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_fflush,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_fflush,        1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "USER_TIME",         NULL,                0,    0,    ""    },
+{  ft_proc,    "USER_TIME",         NULL,           0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_user_time,     0,    0     },
+{  ft_proc,    NULL,             0, setl2_user_time,     0,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SETL2_TRACE",             NULL,          1,    0,    "1"   },
+{  ft_proc,    "SETL2_TRACE",       NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_trace,         1,    0     },
+{  ft_proc,    NULL,             0, setl2_trace,         1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SETL2_REF_COUNT",             NULL,      1,    0,    "1"   },
+{  ft_proc,    "SETL2_REF_COUNT",   NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_ref_count,     1,    0     },
+{  ft_proc,    NULL,             0, setl2_ref_count,     1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "LIBRARY_FILE",      NULL,                1,    0,    "1" },
+{  ft_proc,    "LIBRARY_FILE",      NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_library_file,  1,    0     },
+{  ft_proc,    NULL,             0, setl2_library_file,  1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "LIBRARY_PACKAGE",   NULL,                1,    0,    "1" },
+{  ft_proc,    "LIBRARY_PACKAGE",   NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_library_package,  1,    0     },
+{  ft_proc,    NULL,             0, setl2_library_package, 1,    0,    1 },
 #endif
 
 /*
@@ -717,243 +717,390 @@
 
 
 #ifdef COMPILER
-{  ft_proc,    "PROC_SUSPEND",           NULL,           1,    0,    "1"   },
+{  ft_proc,    "PROC_SUSPEND",      NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_suspend,       1,    0     },
+{  ft_proc,    NULL,             0, setl2_suspend,       1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PROC_RESUME",            NULL,           1,    0,    "1"   },
+{  ft_proc,    "PROC_RESUME",       NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_resume,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_resume,        1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PROC_KILL",              NULL,           1,    0,    "1"   },
+{  ft_proc,    "PROC_KILL",         NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_kill,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_kill,          1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PROC_NEWMBOX",           NULL,           0,    0,    ""    },
+{  ft_proc,    "PROC_NEWMBOX",      NULL,           0,    1,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_newmbox,       0,    0     },
+{  ft_proc,    NULL,             0, setl2_newmbox,       0,    1,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PROC_AWAIT",             NULL,           1,    0,    "1"   },
+{  ft_proc,    "PROC_AWAIT",        NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_await,         1,    0     },
+{  ft_proc,    NULL,             0, setl2_await,         1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PROC_ACHECK",            NULL,           1,    0,    "1"   },
+{  ft_proc,    "PROC_ACHECK",       NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_acheck,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_acheck,        1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "PROC_PASS",              NULL,           0,    0,    ""    },
+{  ft_proc,    "PROC_PASS",         NULL,           0,    0,    1,    ""    },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_pass,          0,    0     },
+{  ft_proc,    NULL,             0, setl2_pass,          0,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "JAVASCRIPT",       NULL,                 1,    0,    "1"   },
+{  ft_proc,    "JAVASCRIPT",        NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_javascript,    1,    0     },
+{  ft_proc,    NULL,             0, setl2_javascript,    1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "YIELD",            NULL,                 1,    0,    "1"   },
+{  ft_proc,    "YIELD",             NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_wait,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_wait,          1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "$PASS_SYMTAB",       NULL,               1,    0,    "1"   },
+{  ft_proc,    "$PASS_SYMTAB",      NULL,           1,    0,    0,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_pass_symtab,   1,    0     },
+{  ft_proc,    NULL,             0, setl2_pass_symtab,   1,    0,    0     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "EVAL",            NULL,                  1,    0,    "1"   },
+{  ft_proc,    "EVAL",              NULL,           1,    0,    1,    "1"   },
 #endif
 
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_eval,          1,    0     },
+{  ft_proc,    NULL,             0, setl2_eval,          1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "MALLOC",            NULL,                1,    0,    "1"   },
+{  ft_proc,    "MALLOC",            NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_malloc,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_malloc,        1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "FREE",            NULL,                  1,    0,    "1"   },
+{  ft_proc,    "FREE",              NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_dispose,       1,    0     },
+{  ft_proc,    NULL,             0, setl2_dispose,       1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "DLL_OPEN",            NULL,              1,    0,    "1"
-},
+{  ft_proc,    "DLL_OPEN",          NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_open_lib,      1,    0     },
+{  ft_proc,    NULL,             0, setl2_open_lib,      1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "DLL_CLOSE",            NULL,             1,    0,    "1"   },
+{  ft_proc,    "DLL_CLOSE",         NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_close_lib,     1,    0     },
+{  ft_proc,    NULL,             0, setl2_close_lib,     1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "DLL_NUMSYMBOLS",            NULL,        1,    0,    "1"  },
+{  ft_proc,    "DLL_NUMSYMBOLS",    NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_num_symbols,   1,    0     },
+{  ft_proc,    NULL,             0, setl2_num_symbols,   1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "DLL_GETSYMBOLNAME",        NULL,         2,    0,    "11"  },
+{  ft_proc,    "DLL_GETSYMBOLNAME", NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_get_symbol_name, 2,    0     },
+{  ft_proc,    NULL,             0, setl2_get_symbol_name, 2,    0,    1 },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "DLL_GETSYMBOL",            NULL,         2,    0,    "11"  },
+{  ft_proc,    "DLL_GETSYMBOL",     NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_get_symbol,    2,    0     },
+{  ft_proc,    NULL,             0, setl2_get_symbol,    2,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "DLL_FINDSYMBOL",            NULL,        2,    0,    "11"  },
+{  ft_proc,    "DLL_FINDSYMBOL",    NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_find_symbol,   2,    0     },
+{  ft_proc,    NULL,             0, setl2_find_symbol,   2,    0,    1     },
 #endif
 
 
 #ifdef COMPILER
-{  ft_proc,    "CALLFUNCTION",            NULL,          3,    0,    "111"
-},
+{  ft_proc,    "CALLFUNCTION",      NULL,           3,    0,    1,    "111" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_call_function, 3,    0     },
+{  ft_proc,    NULL,             0, setl2_call_function, 3,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "BPEEK",                   NULL,          2,    0,    "11"
-},
+{  ft_proc,    "BPEEK",             NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_bpeek,         2,    0     },
+{  ft_proc,    NULL,             0, setl2_bpeek,         2,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SPEEK",                   NULL,          2,    0,    "11"
-},
+{  ft_proc,    "SPEEK",             NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_speek,         2,    0     },
+{  ft_proc,    NULL,             0, setl2_speek,         2,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IPEEK",                   NULL,          2,    0,    "11"
-},
+{  ft_proc,    "IPEEK",             NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_ipeek,         2,    0     },
+{  ft_proc,    NULL,             0, setl2_ipeek,         2,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "BPOKE",            NULL,                 3,    0,    "111"
-},
+{  ft_proc,    "BPOKE",             NULL,           3,    0,    1,    "111" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_bpoke,         3,    0     },
+{  ft_proc,    NULL,             0, setl2_bpoke,         3,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "SPOKE",            NULL,                 3,    0,    "111"
-},
+{  ft_proc,    "SPOKE",             NULL,           3,    0,    1,    "111" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_spoke,         3,    0     },
+{  ft_proc,    NULL,             0, setl2_spoke,         3,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "IPOKE",            NULL,                 3,    0,    "111"
-},
+{  ft_proc,    "IPOKE",             NULL,           3,    0,    1,    "111" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_ipoke,         3,    0     },
+{  ft_proc,    NULL,             0, setl2_ipoke,         3,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "HOST_GET",          NULL,                1,    0,    "1"  },
+{  ft_proc,    "HOST_GET",          NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_host_get,      1,    0     },
+{  ft_proc,    NULL,             0, setl2_host_get,      1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "HOST_PUT",          NULL,                2,    0,    "11"  },
+{  ft_proc,    "HOST_PUT",          NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_host_put,      2,    0     },
+{  ft_proc,    NULL,             0, setl2_host_put,      2,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "HOST_CALL",         NULL,                2,    0,    "11"  },
+{  ft_proc,    "HOST_CALL",         NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_host_put,      2,    0     },
+{  ft_proc,    NULL,             0, setl2_host_put,      2,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "GETURL",         NULL,                   1,    0,    "1"  },
+{  ft_proc,    "GETURL",            NULL,           1,    0,    1,    "1"   },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_geturl,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_geturl,        1,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "POSTURL",         NULL,                   2,    0,    "11"  },
+{  ft_proc,    "POSTURL",           NULL,           2,    0,    1,    "11"  },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_posturl,        2,    0     },
+{  ft_proc,    NULL,             0, setl2_posturl,       2,    0,    1     },
 #endif
 
 #ifdef COMPILER
-{  ft_proc,    "CREATEACTIVEXOBJECT",         NULL,        1,    0,    "1"  },
+{  ft_proc,    "CREATEACTIVEXOBJECT", NULL,           1,    0,    1,    "1" },
 #endif
 #ifdef INTERP
-{  ft_proc,    NULL,             0, setl2_create_activexobject,        1,    0     },
+{  ft_proc,    NULL,             0, setl2_create_activexobject, 1,    0,    1 },
+#endif
+
+/*
+ *  String builders (kept at the end, so existing libraries still find
+ *  the built-in symbols above at the same offsets)
+ */
+
+#ifdef COMPILER
+{  ft_proc,    "STRING_BUILDER",    NULL,           0,    0,    0,    ""    },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_string_builder, 0,    0,    0     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "BUILDER_ADD",       NULL,           1,    1,    1,    "11"  },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_builder_add,   1,    1,    1     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "BUILDER_STRING",    NULL,           1,    0,    0,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_builder_string, 1,    0,    0     },
+#endif
+
+/*
+ *  Reductions over tuples of numbers
+ */
+
+#ifdef COMPILER
+{  ft_proc,    "TUPLE_SUM",         NULL,           1,    0,    0,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_tuple_sum,     1,    0,    0     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "TUPLE_PRODUCT",     NULL,           1,    0,    0,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_tuple_product, 1,    0,    0     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "TUPLE_MIN",         NULL,           1,    0,    0,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_tuple_min,     1,    0,    0     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "TUPLE_MAX",         NULL,           1,    0,    0,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_tuple_max,     1,    0,    0     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "TUPLE_DOT",         NULL,           2,    0,    0,    "11"  },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_tuple_dot,     2,    0,    0     },
+#endif
+
+/*
+ *  Allocation statistics
+ */
+
+#ifdef COMPILER
+{  ft_proc,    "MEMORY_STATS",      NULL,           0,    0,    0,    ""    },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_memory_stats,  0,    0,    0     },
+#endif
+
+/*
+ *  Workers
+ */
+
+#ifdef COMPILER
+{  ft_proc,    "WORKER_START",      NULL,           2,    0,    1,    "11"  },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_worker_start,  2,    0,    1     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "WORKER_RESULT",     NULL,           1,    0,    1,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_worker_result, 1,    0,    1     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "WORKER_FORALL",     NULL,           2,    1,    1,    "111" },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_worker_forall, 2,    1,    1     },
+#endif
+
+/*
+ *  Timers and scheduling
+ */
+
+#ifdef COMPILER
+{  ft_proc,    "PROC_SLEEP",        NULL,           1,    0,    1,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_sleep,         1,    0,    1     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "PROC_PRIORITY",     NULL,           2,    0,    1,    "11"  },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_priority,      2,    0,    1     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "PROC_USAGE",        NULL,           1,    0,    1,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_usage,         1,    0,    1     },
+#endif
+
+/*
+ *  Mailboxes
+ */
+
+#ifdef COMPILER
+{  ft_proc,    "PROC_DRAIN",        NULL,           2,    0,    1,    "11"  },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_drain,         2,    0,    1     },
+#endif
+
+/*
+ *  Server sockets
+ */
+
+#ifdef COMPILER
+{  ft_proc,    "SOCKET_ACCEPT",     NULL,           1,    0,    1,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_socket_accept, 1,    0,    1     },
+#endif
+
+#ifdef COMPILER
+{  ft_proc,    "SOCKET_ACCEPT_ALL", NULL,           1,    0,    1,    "1"   },
+#endif
+#ifdef INTERP
+{  ft_proc,    NULL,             0, setl2_socket_accept_all, 1,    0,    1 },
 #endif
 
 
 #ifdef COMPILER
-{  -1,         NULL,                NULL,                0,    0,    ""    },
+{  -1,         NULL,                NULL,           0,    0,    0,    ""    },
 #endif
 #ifdef INTERP
-{  -1,         NULL,             0, NULL,                0,    0     },
+{  -1,         NULL,             0, NULL,                0,    0,    0     },
 #endif
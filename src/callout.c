@@ -130,31 +130,28 @@ int total_length;                      /* total string length               */
 struct comm_block *save_comm_block;    /* block used by this instance       */
 char *arg_string;                      /* argument storage string           */
 char **arg_vector;                     /* callout argument vector           */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* root of tuple                     */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
 int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* tuple element                     */
 string_h_ptr_type string_hdr;
                                        /* source and target strings         */
-string_c_ptr_type string_cell;
-                                       /* source and target string cells    */
 int32 string_length;                   /* source string length              */
-char *string_char_ptr, *string_char_end;
+char *string_char_ptr;
                                        /* source string pointers            */
 char *p;                               /* temporary looping variable        */
 
    /* the first argument must be an integer */
 
-   if (argv[0].sp_form == ft_short) {
+   if (spec_form(&argv[0]) == ft_short) {
 
-      function_type = (int)(argv[0].sp_val.sp_short_value);
+      function_type = (int)(spec_val(&argv[0],sp_short_value));
 
    }
-   else if (argv[0].sp_form == ft_long) {
+   else if (spec_form(&argv[0]) == ft_long) {
 
-      function_type = (int)long_to_short(SETL_SYSTEM argv[0].sp_val.sp_long_ptr);
+      function_type =
+         (int)long_to_short(SETL_SYSTEM spec_val(&argv[0],sp_long_ptr));
 
    }
    else {
@@ -166,13 +163,13 @@ char *p;                               /* temporary looping variable        */
 
    /* the second must be the callback handler (don't check now) */
 
-   callback.sp_form = argv[1].sp_form;
-   callback.sp_val.sp_biggest = argv[1].sp_val.sp_biggest;
+   spec_set_form(&callback,spec_form(&argv[1]));
+   spec_set_val(&callback,sp_biggest,spec_val(&argv[1],sp_biggest));
    mark_specifier(&callback);
 
    /* the last must be a tuple of strings */
 
-   if (argv[2].sp_form != ft_tuple)
+   if (spec_form(&argv[2]) != ft_tuple)
       abend(SETL_SYSTEM msg_bad_arg,"tuple",3,"callout",
             abend_opnd_str(SETL_SYSTEM argv+2));
 
@@ -180,85 +177,19 @@ char *p;                               /* temporary looping variable        */
 
    count = 0;
    total_length = 0;
-   source_root = argv[2].sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+   source_root = spec_val(&argv[2],sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* loop over the elements of source */
 
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
+   for (source_number = 0;
+        source_number < source_root->t_length;
+        source_number++) {
 
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      if (source_element == NULL)
-         break;
+      source_cell = source_root->t_cells + source_number;
+      source_element = &(source_cell->t_spec);
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
       /* we expect each element of the tuple to be a string */
 
@@ -266,12 +197,12 @@ char *p;                               /* temporary looping variable        */
          abend(SETL_SYSTEM msg_bad_arg,"tuple of strings",3,"callout",
                abend_opnd_str(SETL_SYSTEM argv+2));
 
-      if (source_element->sp_form != ft_string)
+      if (spec_form(source_element) != ft_string)
          abend(SETL_SYSTEM msg_bad_arg,"tuple of strings",3,"callout",
                abend_opnd_str(SETL_SYSTEM argv+2));
 
       count++;
-      total_length += (source_element->sp_val.sp_string_ptr)->s_length + 1;
+      total_length += spec_val(source_element,sp_string_ptr)->s_length + 1;
 
    }
 
@@ -327,85 +258,18 @@ char *p;                               /* temporary looping variable        */
    p = arg_string;
    count = 0;
 
-   source_root = argv[2].sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+   source_root = spec_val(&argv[2],sp_tuple_ptr);
 
    /* loop over the elements of source */
 
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
+   for (source_number = 0;
+        source_number < source_root->t_length;
+        source_number++) {
 
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      if (source_element == NULL)
-         break;
+      source_cell = source_root->t_cells + source_number;
+      source_element = &(source_cell->t_spec);
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
       /* we have an element, copy the string into our buffer */
 
@@ -414,32 +278,14 @@ char *p;                               /* temporary looping variable        */
 
       /* initialize the source string */
 
-      string_hdr = source_element->sp_val.sp_string_ptr;
+      string_hdr = spec_val(source_element,sp_string_ptr);
       string_length = string_hdr->s_length;
-      string_cell = string_hdr->s_head;
-      if (string_cell == NULL) {
-         string_char_ptr = string_char_end = NULL;
-      }
-      else {
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-      }
+      string_char_ptr = string_hdr->s_chars;
 
       /* copy the string into the buffer */
 
-      while (string_length--) {
-
-         if (string_char_ptr == string_char_end) {
-
-            string_cell = string_cell->s_next;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *p++ = *string_char_ptr++;
-
-      }
+      memcpy((void *)p,(void *)string_char_ptr,(size_t)string_length);
+      p += string_length;
 
       *p++ = '\0';
 
@@ -451,12 +297,7 @@ char *p;                               /* temporary looping variable        */
 
    /* we have to create a return value for SETL2 */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
+   string_hdr = new_string_buffer(SETL_SYSTEM 0);
 
    /* copy the return string */
 
@@ -464,23 +305,7 @@ char *p;                               /* temporary looping variable        */
 
       while (*p) {
 
-         if (string_char_ptr == string_char_end) {
-
-            get_string_cell(string_cell);
-            if (string_hdr->s_tail != NULL)
-               (string_hdr->s_tail)->s_next = string_cell;
-            string_cell->s_prev = string_hdr->s_tail;
-            string_cell->s_next = NULL;
-            string_hdr->s_tail = string_cell;
-            if (string_hdr->s_head == NULL)
-               string_hdr->s_head = string_cell;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *string_char_ptr++ = *p++;
-         string_hdr->s_length++;
+         append_string_char(string_hdr,*p++);
 
       }
    }
@@ -488,8 +313,8 @@ char *p;                               /* temporary looping variable        */
    /* set the return value */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    /* free our string buffers */
 
@@ -520,46 +345,33 @@ char *setl2_callback(
 {
 va_list argp;                          /* current argument pointer          */
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
+char *string_char_ptr;
                                        /* source string pointers            */
 int32 string_length;                   /* source string length              */
-tuple_h_ptr_type tuple_root, tuple_work_hdr, new_tuple_hdr;
-                                       /* tuple header pointers             */
+tuple_h_ptr_type tuple_root;           /* tuple header pointer              */
 tuple_c_ptr_type tuple_cell;           /* tuple cell pointer                */
-int32 tuple_length,tuple_height,tuple_index;
-                                       /* used to create return tuple       */
+int32 tuple_length;                    /* used to create return tuple       */
 static char *return_string = NULL;     /* static return buffer              */
-int32 expansion_trigger,work_hash_code;
-                                       /* used to build tuple               */
+int32 work_hash_code;                  /* used to build tuple               */
 int first_arg;                         /* YES if first argument             */
 specifier spare;                       /* spare specifier                   */
 specifier save_callback;               /* saved callback handler            */
 char *p;                               /* temporary looping varible         */
-int i;                                 /* temporary looping variable        */
 
    /* make sure our callback is on */
 
-   if (callback.sp_form == ft_void)
+   if (spec_form(&callback) == ft_void)
 		return ""; 
 		
    /* make sure our callback is a procedure */
 
-   if (callback.sp_form != ft_proc)
+   if (spec_form(&callback) != ft_proc)
       abend(SETL_SYSTEM "Expected procedure in callout, but found:\n %s",
             abend_opnd_str(SETL_SYSTEM &callback));
 
    /* create an empty tuple */
 
-   get_tuple_header(tuple_root);
-   tuple_root->t_use_count = 1;
-   tuple_root->t_hash_code = 0;
-   tuple_root->t_ntype.t_root.t_length = 0;
-   tuple_root->t_ntype.t_root.t_height = 0;
-
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        tuple_root->t_child[i++].t_cell = NULL);
+   tuple_root = new_tuple(SETL_SYSTEM_VOID);
 
    /* insert each element in the tuple */
 
@@ -576,36 +388,7 @@ int i;                                 /* temporary looping variable        */
 
       /* first we make a SETL2 string out of the C string */
 
-      get_string_header(string_hdr);
-      string_hdr->s_use_count = 1;
-      string_hdr->s_hash_code = -1;
-      string_hdr->s_length = 0;
-      string_hdr->s_head = string_hdr->s_tail = NULL;
-      string_char_ptr = string_char_end = NULL;
-
-      /* copy the source string */
-
-      while (*p) {
-
-         if (string_char_ptr == string_char_end) {
-
-            get_string_cell(string_cell);
-            if (string_hdr->s_tail != NULL)
-               (string_hdr->s_tail)->s_next = string_cell;
-            string_cell->s_prev = string_hdr->s_tail;
-            string_cell->s_next = NULL;
-            string_hdr->s_tail = string_cell;
-            if (string_hdr->s_head == NULL)
-               string_hdr->s_head = string_cell;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *string_char_ptr++ = *p++;
-         string_hdr->s_length++;
-
-      }
+      string_hdr = new_string(SETL_SYSTEM p);
 
       /*
        *  We've converted one of the C arguments into a SETL2 string.
@@ -615,8 +398,8 @@ int i;                                 /* temporary looping variable        */
       if (first_arg) {
 
          first_arg = NO;
-         spare.sp_form = ft_string;
-         spare.sp_val.sp_string_ptr = string_hdr;
+         spec_set_form(&spare,ft_string);
+         spec_set_val(&spare,sp_string_ptr,string_hdr);
          push_pstack(&spare);
          string_hdr->s_use_count--;
 
@@ -627,81 +410,11 @@ int i;                                 /* temporary looping variable        */
 
       /* add it to the tuple */
 
-      expansion_trigger = 1 << ((tuple_root->t_ntype.t_root.t_height + 1)
-                                 * TUP_SHIFT_DIST);
-
-      if (tuple_length >= expansion_trigger) {
-
-         tuple_work_hdr = tuple_root;
-         get_tuple_header(tuple_root);
-
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code =
-            tuple_work_hdr->t_hash_code;
-         tuple_root->t_ntype.t_root.t_length =
-            tuple_work_hdr->t_ntype.t_root.t_length;
-         tuple_root->t_ntype.t_root.t_height =
-            tuple_work_hdr->t_ntype.t_root.t_height + 1;
-
-         for (i = 1;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_header = NULL);
-
-         tuple_root->t_child[0].t_header = tuple_work_hdr;
-
-         tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-         tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-      }
-
-      tuple_root->t_ntype.t_root.t_length = tuple_length + 1;
-
-      /* find the tuple component */
-
-      tuple_work_hdr = tuple_root;
-      for (tuple_height = tuple_root->t_ntype.t_root.t_height;
-           tuple_height;
-           tuple_height--) {
-
-         /* extract the element's index at this level */
-
-         tuple_index = (tuple_length >>
-                              (tuple_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (tuple_work_hdr->t_child[tuple_index].t_header == NULL) {
-
-            get_tuple_header(new_tuple_hdr);
-            new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-            new_tuple_hdr->t_ntype.t_intern.t_child_index = (int)tuple_index;
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_tuple_hdr->t_child[i++].t_cell = NULL);
-            tuple_work_hdr->t_child[tuple_index].t_header =
-                  new_tuple_hdr;
-            tuple_work_hdr = new_tuple_hdr;
-
-         }
-         else {
-
-            tuple_work_hdr =
-               tuple_work_hdr->t_child[tuple_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, tuple_work_hdr points to the lowest level header
-       *  record.  We insert the new element.
-       */
-
-      tuple_index = tuple_length & TUP_SHIFT_MASK;
-      get_tuple_cell(tuple_cell);
-      tuple_work_hdr->t_child[tuple_index].t_cell = tuple_cell;
-      tuple_cell->t_spec.sp_form = ft_string;
-      tuple_cell->t_spec.sp_val.sp_string_ptr = string_hdr;
+      reserve_tuple(tuple_root,tuple_length + 1);
+      tuple_root->t_length = tuple_length + 1;
+      tuple_cell = tuple_root->t_cells + tuple_length;
+      spec_set_form(&tuple_cell->t_spec,ft_string);
+      spec_set_val(&tuple_cell->t_spec,sp_string_ptr,string_hdr);
       spec_hash_code(work_hash_code,&(tuple_cell->t_spec));
       tuple_root->t_hash_code ^= work_hash_code;
       tuple_cell->t_hash_code = work_hash_code;
@@ -717,29 +430,29 @@ int i;                                 /* temporary looping variable        */
 
    if (first_arg) {
 
-      spare.sp_form = ft_omega;
+      spec_set_form(&spare,ft_omega);
       push_pstack(&spare);
 
    }
 
    /* push our tuple */
 
-   spare.sp_form = ft_tuple;
-   spare.sp_val.sp_tuple_ptr = tuple_root;
+   spec_set_form(&spare,ft_tuple);
+   spec_set_val(&spare,sp_tuple_ptr,tuple_root);
    push_pstack(&spare);
    tuple_root->t_use_count--;
 
    /* call the callback handler */
 
-   save_callback.sp_form = callback.sp_form;
-   save_callback.sp_val.sp_biggest = callback.sp_val.sp_biggest;
-   spare.sp_form = ft_omega;
+   spec_set_form(&save_callback,spec_form(&callback));
+   spec_set_val(&save_callback,sp_biggest,spec_val(&callback,sp_biggest));
+   spec_set_form(&spare,ft_omega);
    call_procedure(SETL_SYSTEM &spare,
                   &save_callback,
                   NULL,
                   2L,YES,NO,0);
-   callback.sp_form = save_callback.sp_form;
-   callback.sp_val.sp_biggest = save_callback.sp_val.sp_biggest;
+   spec_set_form(&callback,spec_form(&save_callback));
+   spec_set_val(&callback,sp_biggest,spec_val(&save_callback,sp_biggest));
 
    /* release any old return string */
 
@@ -750,20 +463,13 @@ int i;                                 /* temporary looping variable        */
 
    /* build up the C string */
 
-   if (spare.sp_form == ft_string) {
+   if (spec_form(&spare) == ft_string) {
 
       /* initialize the source string */
 
-      string_hdr = spare.sp_val.sp_string_ptr;
+      string_hdr = spec_val(&spare,sp_string_ptr);
       string_length = string_hdr->s_length;
-      string_cell = string_hdr->s_head;
-      if (string_cell == NULL) {
-         string_char_ptr = string_char_end = NULL;
-      }
-      else {
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-      }
+      string_char_ptr = string_hdr->s_chars;
 
       /* allocate a C buffer */
 
@@ -774,24 +480,13 @@ int i;                                 /* temporary looping variable        */
 
       /* copy the string into the buffer */
 
-      while (string_length--) {
-
-         if (string_char_ptr == string_char_end) {
-
-            string_cell = string_cell->s_next;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *p++ = *string_char_ptr++;
-
-      }
+      memcpy((void *)p,(void *)string_char_ptr,(size_t)string_length);
+      p += string_length;
 
       *p = '\0';
 
    }
-   else if (spare.sp_form != ft_omega) {
+   else if (spec_form(&spare) != ft_omega) {
 
       abend(SETL_SYSTEM "Expected string or om return from callback, but found:\n %s",
             abend_opnd_str(SETL_SYSTEM &spare));
@@ -826,32 +521,29 @@ int total_length;                      /* total string length               */
 struct comm_block *save_comm_block;    /* block used by this instance       */
 char *arg_string;                      /* argument storage string           */
 char **arg_vector;                     /* callout argument vector           */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* root of tuple                     */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
 int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* tuple element                     */
 string_h_ptr_type string_hdr;
                                        /* source and target strings         */
-string_c_ptr_type string_cell;
-                                       /* source and target string cells    */
 int32 string_length;                   /* source string length              */
-char *string_char_ptr, *string_char_end;
+char *string_char_ptr;
                                        /* source string pointers            */
 struct return_struct *rs;              /* returned structure                */
 char *p;                               /* temporary looping variable        */
 
    /* the first argument must be an integer */
 
-   if (argv[0].sp_form == ft_short) {
+   if (spec_form(&argv[0]) == ft_short) {
 
-      function_type = (int)(argv[0].sp_val.sp_short_value);
+      function_type = (int)(spec_val(&argv[0],sp_short_value));
 
    }
-   else if (argv[0].sp_form == ft_long) {
+   else if (spec_form(&argv[0]) == ft_long) {
 
-      function_type = (int)long_to_short(SETL_SYSTEM argv[0].sp_val.sp_long_ptr);
+      function_type =
+         (int)long_to_short(SETL_SYSTEM spec_val(&argv[0],sp_long_ptr));
 
    }
    else {
@@ -863,13 +555,13 @@ char *p;                               /* temporary looping variable        */
 
    /* the second must be the callback handler (don't check now) */
 
-   callback2.sp_form = argv[1].sp_form;
-   callback2.sp_val.sp_biggest = argv[1].sp_val.sp_biggest;
+   spec_set_form(&callback2,spec_form(&argv[1]));
+   spec_set_val(&callback2,sp_biggest,spec_val(&argv[1],sp_biggest));
    mark_specifier(&callback2);
 
    /* the last must be a tuple of strings */
 
-   if (argv[2].sp_form != ft_tuple)
+   if (spec_form(&argv[2]) != ft_tuple)
       abend(SETL_SYSTEM msg_bad_arg,"tuple",3,"callout",
             abend_opnd_str(SETL_SYSTEM argv+2));
 
@@ -877,85 +569,19 @@ char *p;                               /* temporary looping variable        */
 
    count = 0;
    total_length = 0;
-   source_root = argv[2].sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+   source_root = spec_val(&argv[2],sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* loop over the elements of source */
 
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+   for (source_number = 0;
+        source_number < source_root->t_length;
+        source_number++) {
 
-      }
-
-      if (source_element == NULL)
-         break;
+      source_cell = source_root->t_cells + source_number;
+      source_element = &(source_cell->t_spec);
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
       /* we expect each element of the tuple to be a string */
 
@@ -963,12 +589,12 @@ char *p;                               /* temporary looping variable        */
          abend(SETL_SYSTEM msg_bad_arg,"tuple of strings",3,"callout",
                abend_opnd_str(SETL_SYSTEM argv+2));
 
-      if (source_element->sp_form != ft_string)
+      if (spec_form(source_element) != ft_string)
          abend(SETL_SYSTEM msg_bad_arg,"tuple of strings",3,"callout",
                abend_opnd_str(SETL_SYSTEM argv+2));
 
       count++;
-      total_length += (source_element->sp_val.sp_string_ptr)->s_length + 1;
+      total_length += spec_val(source_element,sp_string_ptr)->s_length + 1;
 
    }
 
@@ -1024,85 +650,18 @@ char *p;                               /* temporary looping variable        */
    p = arg_string;
    count = 0;
 
-   source_root = argv[2].sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+   source_root = spec_val(&argv[2],sp_tuple_ptr);
 
    /* loop over the elements of source */
 
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
+   for (source_number = 0;
+        source_number < source_root->t_length;
+        source_number++) {
 
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      if (source_element == NULL)
-         break;
+      source_cell = source_root->t_cells + source_number;
+      source_element = &(source_cell->t_spec);
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
       /* we have an element, copy the string into our buffer */
 
@@ -1111,32 +670,14 @@ char *p;                               /* temporary looping variable        */
 
       /* initialize the source string */
 
-      string_hdr = source_element->sp_val.sp_string_ptr;
+      string_hdr = spec_val(source_element,sp_string_ptr);
       string_length = string_hdr->s_length;
-      string_cell = string_hdr->s_head;
-      if (string_cell == NULL) {
-         string_char_ptr = string_char_end = NULL;
-      }
-      else {
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-      }
+      string_char_ptr = string_hdr->s_chars;
 
       /* copy the string into the buffer */
 
-      while (string_length--) {
-
-         if (string_char_ptr == string_char_end) {
-
-            string_cell = string_cell->s_next;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *p++ = *string_char_ptr++;
-
-      }
+      memcpy((void *)p,(void *)string_char_ptr,(size_t)string_length);
+      p += string_length;
 
       *p++ = '\0';
 
@@ -1148,12 +689,7 @@ char *p;                               /* temporary looping variable        */
 
    /* we have to create a return value for SETL2 */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
+   string_hdr = new_string_buffer(SETL_SYSTEM 0);
 
    /* copy the return string */
 
@@ -1162,23 +698,7 @@ char *p;                               /* temporary looping variable        */
       p = rs->rs_data;
       while (rs->rs_length--) {
 
-         if (string_char_ptr == string_char_end) {
-
-            get_string_cell(string_cell);
-            if (string_hdr->s_tail != NULL)
-               (string_hdr->s_tail)->s_next = string_cell;
-            string_cell->s_prev = string_hdr->s_tail;
-            string_cell->s_next = NULL;
-            string_hdr->s_tail = string_cell;
-            if (string_hdr->s_head == NULL)
-               string_hdr->s_head = string_cell;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *string_char_ptr++ = *p++;
-         string_hdr->s_length++;
+         append_string_char(string_hdr,*p++);
 
       }
    }
@@ -1186,8 +706,8 @@ char *p;                               /* temporary looping variable        */
    /* set the return value */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    /* free our string buffers */
 
@@ -1218,42 +738,29 @@ char *setl2_callback2(
 {
 va_list argp;                          /* current argument pointer          */
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
+char *string_char_ptr;
                                        /* source string pointers            */
 int32 string_length;                   /* source string length              */
-tuple_h_ptr_type tuple_root, tuple_work_hdr, new_tuple_hdr;
-                                       /* tuple header pointers             */
+tuple_h_ptr_type tuple_root;           /* tuple header pointer              */
 tuple_c_ptr_type tuple_cell;           /* tuple cell pointer                */
-int32 tuple_length,tuple_height,tuple_index;
-                                       /* used to create return tuple       */
+int32 tuple_length;                    /* used to create return tuple       */
 static char *return_string = NULL;     /* static return buffer              */
-int32 expansion_trigger,work_hash_code;
-                                       /* used to build tuple               */
+int32 work_hash_code;                  /* used to build tuple               */
 int first_arg;                         /* YES if first argument             */
 specifier spare;                       /* spare specifier                   */
 specifier save_callback;               /* saved callback handler            */
 struct return_struct *rs;              /* return structure                  */
 char *p;                               /* temporary looping varible         */
-int i;                                 /* temporary looping variable        */
 
    /* make sure our callback is a procedure */
 
-   if (callback2.sp_form != ft_proc)
+   if (spec_form(&callback2) != ft_proc)
       abend(SETL_SYSTEM "Expected procedure in callout2, but found:\n %s",
             abend_opnd_str(SETL_SYSTEM &callback2));
 
    /* create an empty tuple */
 
-   get_tuple_header(tuple_root);
-   tuple_root->t_use_count = 1;
-   tuple_root->t_hash_code = 0;
-   tuple_root->t_ntype.t_root.t_length = 0;
-   tuple_root->t_ntype.t_root.t_height = 0;
-
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        tuple_root->t_child[i++].t_cell = NULL);
+   tuple_root = new_tuple(SETL_SYSTEM_VOID);
 
    /* insert each element in the tuple */
 
@@ -1270,35 +777,14 @@ int i;                                 /* temporary looping variable        */
 
       /* first we make a SETL2 string out of the C string */
 
-      get_string_header(string_hdr);
-      string_hdr->s_use_count = 1;
-      string_hdr->s_hash_code = -1;
-      string_hdr->s_length = 0;
-      string_hdr->s_head = string_hdr->s_tail = NULL;
-      string_char_ptr = string_char_end = NULL;
+      string_hdr = new_string_buffer(SETL_SYSTEM 0);
 
       /* copy the source string */
 
       p = rs->rs_data;
       while (rs->rs_length--) {
 
-         if (string_char_ptr == string_char_end) {
-
-            get_string_cell(string_cell);
-            if (string_hdr->s_tail != NULL)
-               (string_hdr->s_tail)->s_next = string_cell;
-            string_cell->s_prev = string_hdr->s_tail;
-            string_cell->s_next = NULL;
-            string_hdr->s_tail = string_cell;
-            if (string_hdr->s_head == NULL)
-               string_hdr->s_head = string_cell;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *string_char_ptr++ = *p++;
-         string_hdr->s_length++;
+         append_string_char(string_hdr,*p++);
 
       }
 
@@ -1310,8 +796,8 @@ int i;                                 /* temporary looping variable        */
       if (first_arg) {
 
          first_arg = NO;
-         spare.sp_form = ft_string;
-         spare.sp_val.sp_string_ptr = string_hdr;
+         spec_set_form(&spare,ft_string);
+         spec_set_val(&spare,sp_string_ptr,string_hdr);
          push_pstack(&spare);
          string_hdr->s_use_count--;
 
@@ -1322,81 +808,11 @@ int i;                                 /* temporary looping variable        */
 
       /* add it to the tuple */
 
-      expansion_trigger = 1 << ((tuple_root->t_ntype.t_root.t_height + 1)
-                                 * TUP_SHIFT_DIST);
-
-      if (tuple_length >= expansion_trigger) {
-
-         tuple_work_hdr = tuple_root;
-         get_tuple_header(tuple_root);
-
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code =
-            tuple_work_hdr->t_hash_code;
-         tuple_root->t_ntype.t_root.t_length =
-            tuple_work_hdr->t_ntype.t_root.t_length;
-         tuple_root->t_ntype.t_root.t_height =
-            tuple_work_hdr->t_ntype.t_root.t_height + 1;
-
-         for (i = 1;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_header = NULL);
-
-         tuple_root->t_child[0].t_header = tuple_work_hdr;
-
-         tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-         tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-      }
-
-      tuple_root->t_ntype.t_root.t_length = tuple_length + 1;
-
-      /* find the tuple component */
-
-      tuple_work_hdr = tuple_root;
-      for (tuple_height = tuple_root->t_ntype.t_root.t_height;
-           tuple_height;
-           tuple_height--) {
-
-         /* extract the element's index at this level */
-
-         tuple_index = (tuple_length >>
-                              (tuple_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (tuple_work_hdr->t_child[tuple_index].t_header == NULL) {
-
-            get_tuple_header(new_tuple_hdr);
-            new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-            new_tuple_hdr->t_ntype.t_intern.t_child_index = (int)tuple_index;
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_tuple_hdr->t_child[i++].t_cell = NULL);
-            tuple_work_hdr->t_child[tuple_index].t_header =
-                  new_tuple_hdr;
-            tuple_work_hdr = new_tuple_hdr;
-
-         }
-         else {
-
-            tuple_work_hdr =
-               tuple_work_hdr->t_child[tuple_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, tuple_work_hdr points to the lowest level header
-       *  record.  We insert the new element.
-       */
-
-      tuple_index = tuple_length & TUP_SHIFT_MASK;
-      get_tuple_cell(tuple_cell);
-      tuple_work_hdr->t_child[tuple_index].t_cell = tuple_cell;
-      tuple_cell->t_spec.sp_form = ft_string;
-      tuple_cell->t_spec.sp_val.sp_string_ptr = string_hdr;
+      reserve_tuple(tuple_root,tuple_length + 1);
+      tuple_root->t_length = tuple_length + 1;
+      tuple_cell = tuple_root->t_cells + tuple_length;
+      spec_set_form(&tuple_cell->t_spec,ft_string);
+      spec_set_val(&tuple_cell->t_spec,sp_string_ptr,string_hdr);
       spec_hash_code(work_hash_code,&(tuple_cell->t_spec));
       tuple_root->t_hash_code ^= work_hash_code;
       tuple_cell->t_hash_code = work_hash_code;
@@ -1412,29 +828,29 @@ int i;                                 /* temporary looping variable        */
 
    if (first_arg) {
 
-      spare.sp_form = ft_omega;
+      spec_set_form(&spare,ft_omega);
       push_pstack(&spare);
 
    }
 
    /* push our tuple */
 
-   spare.sp_form = ft_tuple;
-   spare.sp_val.sp_tuple_ptr = tuple_root;
+   spec_set_form(&spare,ft_tuple);
+   spec_set_val(&spare,sp_tuple_ptr,tuple_root);
    push_pstack(&spare);
    tuple_root->t_use_count--;
 
    /* call the callback handler */
 
-   save_callback.sp_form = callback2.sp_form;
-   save_callback.sp_val.sp_biggest = callback2.sp_val.sp_biggest;
-   spare.sp_form = ft_omega;
+   spec_set_form(&save_callback,spec_form(&callback2));
+   spec_set_val(&save_callback,sp_biggest,spec_val(&callback2,sp_biggest));
+   spec_set_form(&spare,ft_omega);
    call_procedure(SETL_SYSTEM &spare,
                   &save_callback,
                   NULL,
                   2L,YES,NO,0);
-   callback2.sp_form = save_callback.sp_form;
-   callback2.sp_val.sp_biggest = save_callback.sp_val.sp_biggest;
+   spec_set_form(&callback2,spec_form(&save_callback));
+   spec_set_val(&callback2,sp_biggest,spec_val(&save_callback,sp_biggest));
 
    /* release any old return string */
 
@@ -1445,20 +861,13 @@ int i;                                 /* temporary looping variable        */
 
    /* build up the C string */
 
-   if (spare.sp_form == ft_string) {
+   if (spec_form(&spare) == ft_string) {
 
       /* initialize the source string */
 
-      string_hdr = spare.sp_val.sp_string_ptr;
+      string_hdr = spec_val(&spare,sp_string_ptr);
       string_length = string_hdr->s_length;
-      string_cell = string_hdr->s_head;
-      if (string_cell == NULL) {
-         string_char_ptr = string_char_end = NULL;
-      }
-      else {
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-      }
+      string_char_ptr = string_hdr->s_chars;
 
       /* allocate a C buffer */
 
@@ -1469,24 +878,13 @@ int i;                                 /* temporary looping variable        */
 
       /* copy the string into the buffer */
 
-      while (string_length--) {
-
-         if (string_char_ptr == string_char_end) {
-
-            string_cell = string_cell->s_next;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *p++ = *string_char_ptr++;
-
-      }
+      memcpy((void *)p,(void *)string_char_ptr,(size_t)string_length);
+      p += string_length;
 
       *p = '\0';
 
    }
-   else if (spare.sp_form != ft_omega) {
+   else if (spec_form(&spare) != ft_omega) {
 
       abend(SETL_SYSTEM "Expected string or om return from callback, but found:\n %s",
             abend_opnd_str(SETL_SYSTEM &spare));
@@ -1507,9 +905,6 @@ void setl2_malloc(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
 char *s, *t;                           /* temporary looping variables       */
 int amount;
 void *area;
@@ -1517,14 +912,14 @@ char load_result[16];
 
  /* the first argument must be an integer */
 
-   if (argv[0].sp_form == ft_short) {
+   if (spec_form(&argv[0]) == ft_short) {
 
-      amount = (int)(argv[0].sp_val.sp_short_value);
+      amount = (int)(spec_val(&argv[0],sp_short_value));
 
    }
-   else if (argv[0].sp_form == ft_long) {
+   else if (spec_form(&argv[0]) == ft_long) {
 
-      amount = (int)long_to_short(SETL_SYSTEM argv[0].sp_val.sp_long_ptr);
+      amount = (int)long_to_short(SETL_SYSTEM spec_val(&argv[0],sp_long_ptr));
 
    }
    else {
@@ -1538,7 +933,7 @@ char load_result[16];
     
    if (area==NULL) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -1553,40 +948,11 @@ char load_result[16];
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (*s) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string(SETL_SYSTEM s);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -1601,36 +967,24 @@ void setl2_dispose(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
 int close_result;
 void *area;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"free",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
 #ifdef MACINTOSH
    sscanf(key,"%ld",&area);
@@ -1644,7 +998,7 @@ void *area;
    free(area);
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 
 }
@@ -1657,11 +1011,8 @@ void setl2_open_lib(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
+char *s;                               /* temporary looping variable        */
 char load_result[16];
 
 #ifdef MACINTOSH
@@ -1679,28 +1030,18 @@ void *handle;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"dll_open",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    strcpy(load_result,"");
 	
@@ -1725,7 +1066,7 @@ void *handle;
 
    if (strcmp(load_result,"")==0) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -1733,40 +1074,11 @@ void *handle;
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (*s) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string(SETL_SYSTEM s);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -1781,11 +1093,9 @@ void setl2_close_lib(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
 int close_result;
 
 #ifdef MACINTOSH  
@@ -1798,28 +1108,18 @@ void *handle;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"dll_close",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    
    close_result=-1;
@@ -1838,13 +1138,13 @@ void *handle;
 
    if (close_result!=0) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value = 0;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,0);
 
 }
 
@@ -1856,10 +1156,7 @@ void setl2_find_symbol(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
+char *s;                               /* temporary looping variable        */
 char *handle;                          /* system key                        */
 char *symbol;                          /* system key                        */
 char symbol_pointer[16];
@@ -1885,51 +1182,31 @@ Ptr myAddr;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"dll_findsymbol",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    handle = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (handle == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = handle;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < handle + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)handle,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"dll_findsymbol",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[1].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[1],sp_string_ptr);
 
    symbol = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (symbol == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = symbol;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < symbol + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)symbol,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
    
    strcpy(symbol_pointer,"");
 
@@ -1956,7 +1233,7 @@ Ptr myAddr;
 
    if (strcmp(symbol_pointer,"")==0) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -1964,40 +1241,11 @@ Ptr myAddr;
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (*s) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string(SETL_SYSTEM s);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -2015,26 +1263,19 @@ char function_type[16];                /*                                   */
 int typelen;
 int count;                             /* number of arguments               */
 int total_length;                      /* total string length               */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* root of tuple                     */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
 int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* tuple element                     */
 string_h_ptr_type string_hdr;
                                        /* source and target strings         */
-string_c_ptr_type string_cell;
-                                       /* source and target string cells    */
 int32 string_length;                   /* source string length              */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
 char *p;                               /* temporary looping variable        */
 char *s, *t, *t2;                      /* temporary looping variables       */
 char *key;
 int rint;
 float rfloat;
 double rdouble;
-i_real_ptr_type real_ptr;              /* real pointer                      */
 
 
 int arg_vector_int[10];
@@ -2062,11 +1303,11 @@ Ptr vp;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"callfunction",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    typelen= string_hdr->s_length;
 
@@ -2074,18 +1315,8 @@ Ptr vp;
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"callfunction",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   t = function_type;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < function_type + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)function_type,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    ftype=0;
    foundint=0;
@@ -2125,28 +1356,18 @@ Ptr vp;
 
 
    /* the second argument must be a string */
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"callfunction",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   string_hdr = argv[1].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[1],sp_string_ptr);
 
    if (string_hdr->s_length >10 )
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"callfunction",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   t = symbol_pointer;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < symbol_pointer + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)symbol_pointer,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
 #ifdef MACINTOSH  
    sscanf(symbol_pointer,"%ld",&Fp);
@@ -2157,7 +1378,7 @@ Ptr vp;
 
    /* the last must be a tuple of strings */
 
-   if (argv[2].sp_form != ft_tuple)
+   if (spec_form(&argv[2]) != ft_tuple)
       abend(SETL_SYSTEM msg_bad_arg,"tuple",3,"callfunction",
             abend_opnd_str(SETL_SYSTEM argv+2));
 
@@ -2165,87 +1386,21 @@ Ptr vp;
 
    count = 0;
    total_length = 0;
-   source_root = argv[2].sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+   source_root = spec_val(&argv[2],sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* loop over the elements of source */
 
    t=function_type+1; /* Points to the type of the parameters */
 
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
+   for (source_number = 0;
+        source_number < source_root->t_length;
+        source_number++) {
 
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      if (source_element == NULL)
-         break;
+      source_cell = source_root->t_cells + source_number;
+      source_element = &(source_cell->t_spec);
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
       /* we expect each element of the tuple to be a string */
 
@@ -2256,49 +1411,29 @@ Ptr vp;
       switch (*t) {
          case 'S':  /* String */
                  /* the argument must be a string */
-            if (source_element->sp_form != ft_string)
+            if (spec_form(source_element) != ft_string)
                abend(SETL_SYSTEM msg_bad_arg,"string",3,"callfunction",
                      abend_opnd_str(SETL_SYSTEM source_element));
 
-            string_hdr = source_element->sp_val.sp_string_ptr;
+            string_hdr = spec_val(source_element,sp_string_ptr);
             key = (char *)malloc((size_t)(string_hdr->s_length + 1));
             if (key == NULL)
                giveup(SETL_SYSTEM msg_malloc_error);
 
-            t2 = key;
-            for (string_cell = string_hdr->s_head;
-                 string_cell != NULL;
-                 string_cell = string_cell->s_next) {
-
-               for (s = string_cell->s_cell_value;
-                    t2 < key + string_hdr->s_length &&
-                       s < string_cell->s_cell_value + STR_CELL_WIDTH;
-                    *t2++ = *s++);
-
-            }
-            *t2 = '\0';
+            memcpy((void *)key,(void *)(string_hdr->s_chars),
+                   (size_t)(string_hdr->s_length + 1));
             arg_vector_int[count]=(int32)(key);
             break;
          case 'P':  /* Pointer */
                  /* the argument must be a string */
-            if (source_element->sp_form != ft_string)
+            if (spec_form(source_element) != ft_string)
                abend(SETL_SYSTEM msg_bad_arg,"string",3,"callfunction",
                      abend_opnd_str(SETL_SYSTEM source_element));
 
-            string_hdr = source_element->sp_val.sp_string_ptr;
+            string_hdr = spec_val(source_element,sp_string_ptr);
 
-            t2 = void_pointer;
-            for (string_cell = string_hdr->s_head;
-                 string_cell != NULL;
-                 string_cell = string_cell->s_next) {
-
-               for (s = string_cell->s_cell_value;
-                    t2 < void_pointer + string_hdr->s_length &&
-                       s < string_cell->s_cell_value + STR_CELL_WIDTH;
-                    *t2++ = *s++);
-
-            }
-            *t2 = '\0';
+            memcpy((void *)void_pointer,(void *)(string_hdr->s_chars),
+                   (size_t)(string_hdr->s_length + 1));
 #ifdef MACINTOSH  
             sscanf(void_pointer,"%ld",&vp);
             arg_vector_int[count]=(int)(vp);
@@ -2309,14 +1444,15 @@ Ptr vp;
 #endif
             break;
          case 'I':
-            if (source_element->sp_form == ft_short) {
+            if (spec_form(source_element) == ft_short) {
                arg_vector_int[count] = 
-                      (int)(source_element->sp_val.sp_short_value);
+                      (int)(spec_val(source_element,sp_short_value));
 
             }
-            else if (source_element->sp_form == ft_long) {
+            else if (spec_form(source_element) == ft_long) {
                arg_vector_int[count] = 
-                      (int)long_to_short(SETL_SYSTEM source_element->sp_val.sp_long_ptr);
+                      (int)long_to_short(SETL_SYSTEM
+                                 spec_val(source_element,sp_long_ptr));
             }
             else {
                abend(SETL_SYSTEM msg_bad_arg,"integer",3,"callfunction",
@@ -2324,12 +1460,12 @@ Ptr vp;
             }
             break;
          case 'F':
-            switch (source_element->sp_form) {
+            switch (spec_form(source_element)) {
 
                   case ft_short :
 
                      arg_vector_float[count] = 
-                            (float)(source_element->sp_val.sp_short_value);
+                            (float)(spec_val(source_element,sp_short_value));
                      break;
 
                   case ft_long :
@@ -2340,7 +1476,7 @@ Ptr vp;
 
                   case ft_real :
                      arg_vector_float[count] = 
-                            (float)((source_element->sp_val.sp_real_ptr)->r_value);
+                            (float)(spec_val(source_element,sp_real_value));
                      break;
                      
 
@@ -2350,12 +1486,12 @@ Ptr vp;
 
             }
          case 'D':
-            switch (source_element->sp_form) {
+            switch (spec_form(source_element)) {
 
                   case ft_short :
 
                      arg_vector_double[count] = 
-                            (double)(source_element->sp_val.sp_short_value);
+                            (double)(spec_val(source_element,sp_short_value));
                      break;
 
                   case ft_long :
@@ -2366,7 +1502,7 @@ Ptr vp;
 
                   case ft_real :
                      arg_vector_double[count] = 
-                            (double)((source_element->sp_val.sp_real_ptr)->r_value);
+                            (double)(spec_val(source_element,sp_real_value));
                      break;
                      
 
@@ -2406,7 +1542,7 @@ Ptr vp;
    
    if (rtype==1) { /* Void return type */
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -2416,24 +1552,18 @@ Ptr vp;
          break;
       case 2:
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = rint;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,rint);
          return;
       case 3:
          unmark_specifier(target);
-         i_get_real(real_ptr);
-         target->sp_form = ft_real;
-         target->sp_val.sp_real_ptr = real_ptr;
-         real_ptr->r_use_count = 1;
-         real_ptr->r_value = (double)rfloat;
+         spec_set_form(target,ft_real);
+         spec_set_val(target,sp_real_value,(double)rfloat);
          return;
       case 4:
          unmark_specifier(target);
-         i_get_real(real_ptr);
-         target->sp_form = ft_real;
-         target->sp_val.sp_real_ptr = real_ptr;
-         real_ptr->r_use_count = 1;
-         real_ptr->r_value = rdouble;
+         spec_set_form(target,ft_real);
+         spec_set_val(target,sp_real_value,rdouble);
          return;
    }
 
@@ -2447,12 +1577,7 @@ Ptr vp;
 #endif
 
    p=void_pointer;
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
+   string_hdr = new_string_buffer(SETL_SYSTEM 0);
 
    /* copy the return string */
 
@@ -2460,23 +1585,7 @@ Ptr vp;
 
       while (*p) {
 
-         if (string_char_ptr == string_char_end) {
-
-            get_string_cell(string_cell);
-            if (string_hdr->s_tail != NULL)
-               (string_hdr->s_tail)->s_next = string_cell;
-            string_cell->s_prev = string_hdr->s_tail;
-            string_cell->s_next = NULL;
-            string_hdr->s_tail = string_cell;
-            if (string_hdr->s_head == NULL)
-               string_hdr->s_head = string_cell;
-            string_char_ptr = string_cell->s_cell_value;
-            string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *string_char_ptr++ = *p++;
-         string_hdr->s_length++;
+         append_string_char(string_hdr,*p++);
 
       }
    }
@@ -2484,8 +1593,8 @@ Ptr vp;
    /* set the return value */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -2499,11 +1608,9 @@ void setl2_num_symbols(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
 int num_symbs;
 
 #ifdef MACINTOSH
@@ -2518,28 +1625,18 @@ void *handle;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"dll_numsymbols",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    
    num_symbs=-1;
@@ -2554,13 +1651,13 @@ void *handle;
 
    if (num_symbs==-1) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value = num_symbs;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,num_symbs);
 
 }
 
@@ -2573,10 +1670,7 @@ void setl2_get_symbol(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
+char *s;                               /* temporary looping variable        */
 char *handle;                          /* system key                        */
 int symbol;                            /* system key                        */
 char symbol_pointer[16];
@@ -2602,35 +1696,25 @@ Ptr myAddr;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"dll_getsymbol",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    handle = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (handle == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = handle;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < handle + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)handle,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-   if (argv[1].sp_form == ft_short) {
-      symbol = (int)(argv[1].sp_val.sp_short_value);
+   if (spec_form(&argv[1]) == ft_short) {
+      symbol = (int)(spec_val(&argv[1],sp_short_value));
 
    }
-   else if (argv[1].sp_form == ft_long) {
-      symbol = (int)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[1]) == ft_long) {
+      symbol = (int)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",2,"dll_getsymbol",
@@ -2652,7 +1736,7 @@ Ptr myAddr;
 
    if (strcmp(symbol_pointer,"")==0) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -2660,40 +1744,11 @@ Ptr myAddr;
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (*s) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string(SETL_SYSTEM s);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -2709,10 +1764,7 @@ void setl2_get_symbol_name(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
+char *s;                               /* temporary looping variable        */
 char *handle;                          /* system key                        */
 int symbol;                            /* system key                        */
 char symbol_pointer[16];
@@ -2741,35 +1793,25 @@ char *stg_copy;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"dll_getsymbolname",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    handle = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (handle == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = handle;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < handle + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)handle,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-   if (argv[1].sp_form == ft_short) {
-      symbol = (int)(argv[1].sp_val.sp_short_value);
+   if (spec_form(&argv[1]) == ft_short) {
+      symbol = (int)(spec_val(&argv[1],sp_short_value));
 
    }
-   else if (argv[1].sp_form == ft_long) {
-      symbol = (int)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[1]) == ft_long) {
+      symbol = (int)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",2,"dll_getsymbolname",
@@ -2794,7 +1836,7 @@ char *stg_copy;
 
    if (strcmp(c_stg,"")==0) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -2802,40 +1844,11 @@ char *stg_copy;
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (*s) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string(SETL_SYSTEM s);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -2849,10 +1862,8 @@ void setl2_bpeek(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
 char *location;  
 void *plocation;
 int offset;  
@@ -2860,35 +1871,25 @@ char b;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"peek",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    location = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (location == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = location;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
+   memcpy((void *)location,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-      for (s = string_cell->s_cell_value;
-           t < location + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
+   if (spec_form(&argv[1]) == ft_short) {
+      offset = (int)(spec_val(&argv[1],sp_short_value));
 
    }
-   *t = '\0';
-
-   if (argv[1].sp_form == ft_short) {
-      offset = (int)(argv[1].sp_val.sp_short_value);
-
-   }
-   else if (argv[1].sp_form == ft_long) {
-      offset = (int)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[1]) == ft_long) {
+      offset = (int)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",2,"peek",
@@ -2908,8 +1909,8 @@ char b;
 
    b=*(char *)((char *)(plocation)+offset);
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value = (int)b;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,(int)b);
    return;
 
 }
@@ -2922,10 +1923,8 @@ void setl2_speek(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
 char *location;  
 void *plocation;
 int offset;  
@@ -2933,35 +1932,25 @@ short b;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"peek",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    location = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (location == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = location;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < location + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
+   memcpy((void *)location,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-   }
-   *t = '\0';
-
-   if (argv[1].sp_form == ft_short) {
-      offset = (int)(argv[1].sp_val.sp_short_value);
+   if (spec_form(&argv[1]) == ft_short) {
+      offset = (int)(spec_val(&argv[1],sp_short_value));
 
    }
-   else if (argv[1].sp_form == ft_long) {
-      offset = (int)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[1]) == ft_long) {
+      offset = (int)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",2,"peek",
@@ -2982,8 +1971,8 @@ short b;
 
    b=*(short *)((char *)(plocation)+offset);
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value = (int)b;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,(int)b);
    return;
 
 }
@@ -2996,10 +1985,8 @@ void setl2_ipeek(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
 char *location;  
 void *plocation;
 int offset;  
@@ -3007,35 +1994,25 @@ int32 b;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"peek",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    location = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (location == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = location;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
+   memcpy((void *)location,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-      for (s = string_cell->s_cell_value;
-           t < location + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
+   if (spec_form(&argv[1]) == ft_short) {
+      offset = (int)(spec_val(&argv[1],sp_short_value));
 
    }
-   *t = '\0';
-
-   if (argv[1].sp_form == ft_short) {
-      offset = (int)(argv[1].sp_val.sp_short_value);
-
-   }
-   else if (argv[1].sp_form == ft_long) {
-      offset = (int)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[1]) == ft_long) {
+      offset = (int)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",2,"peek",
@@ -3055,8 +2032,8 @@ int32 b;
 
    b=*(int32 *)((char *)(plocation)+offset);
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value = (int)b;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,(int)b);
    return;
 
 }
@@ -3069,10 +2046,8 @@ void setl2_bpoke(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
 char *location;  
 void *plocation;
 int offset;  
@@ -3080,47 +2055,37 @@ char b;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"poke",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    location = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (location == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = location;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < location + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)location,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-   if (argv[1].sp_form == ft_short) {
-      offset = (int)(argv[1].sp_val.sp_short_value);
+   if (spec_form(&argv[1]) == ft_short) {
+      offset = (int)(spec_val(&argv[1],sp_short_value));
 
    }
-   else if (argv[1].sp_form == ft_long) {
-      offset = (int)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[1]) == ft_long) {
+      offset = (int)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",2,"poke",
          abend_opnd_str(SETL_SYSTEM &argv[1]));
    }
 
-   if (argv[2].sp_form == ft_short) {
-      b = (char)(argv[2].sp_val.sp_short_value);
+   if (spec_form(&argv[2]) == ft_short) {
+      b = (char)(spec_val(&argv[2],sp_short_value));
 
    }
-   else if (argv[2].sp_form == ft_long) {
-      b = (char)long_to_short(SETL_SYSTEM argv[2].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[2]) == ft_long) {
+      b = (char)long_to_short(SETL_SYSTEM spec_val(&argv[2],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",3,"poke",
@@ -3152,10 +2117,8 @@ void setl2_spoke(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
 char *location;  
 void *plocation;
 int offset;  
@@ -3163,47 +2126,37 @@ short b;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"poke",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    location = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (location == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = location;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < location + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
+   memcpy((void *)location,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-   }
-   *t = '\0';
-
-   if (argv[1].sp_form == ft_short) {
-      offset = (int)(argv[1].sp_val.sp_short_value);
+   if (spec_form(&argv[1]) == ft_short) {
+      offset = (int)(spec_val(&argv[1],sp_short_value));
 
    }
-   else if (argv[1].sp_form == ft_long) {
-      offset = (int)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[1]) == ft_long) {
+      offset = (int)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",2,"poke",
          abend_opnd_str(SETL_SYSTEM &argv[1]));
    }
 
-   if (argv[2].sp_form == ft_short) {
-      b = (short)(argv[2].sp_val.sp_short_value);
+   if (spec_form(&argv[2]) == ft_short) {
+      b = (short)(spec_val(&argv[2],sp_short_value));
 
    }
-   else if (argv[2].sp_form == ft_long) {
-      b = (short)long_to_short(SETL_SYSTEM argv[2].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[2]) == ft_long) {
+      b = (short)long_to_short(SETL_SYSTEM spec_val(&argv[2],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",3,"poke",
@@ -3234,10 +2187,8 @@ void setl2_ipoke(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
-char *s, *t;                           /* temporary looping variables       */
 char *location;  
 void *plocation;
 int offset;  
@@ -3245,47 +2196,37 @@ int32 b;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"poke",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    location = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (location == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = location;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
+   memcpy((void *)location,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
-      for (s = string_cell->s_cell_value;
-           t < location + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
+   if (spec_form(&argv[1]) == ft_short) {
+      offset = (int)(spec_val(&argv[1],sp_short_value));
 
    }
-   *t = '\0';
-
-   if (argv[1].sp_form == ft_short) {
-      offset = (int)(argv[1].sp_val.sp_short_value);
-
-   }
-   else if (argv[1].sp_form == ft_long) {
-      offset = (int)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[1]) == ft_long) {
+      offset = (int)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",2,"poke",
          abend_opnd_str(SETL_SYSTEM &argv[1]));
    }
 
-   if (argv[2].sp_form == ft_short) {
-      b = (int32)(argv[2].sp_val.sp_short_value);
+   if (spec_form(&argv[2]) == ft_short) {
+      b = (int32)(spec_val(&argv[2],sp_short_value));
 
    }
-   else if (argv[2].sp_form == ft_long) {
-      b = (int32)long_to_short(SETL_SYSTEM argv[2].sp_val.sp_long_ptr);
+   else if (spec_form(&argv[2]) == ft_long) {
+      b = (int32)long_to_short(SETL_SYSTEM spec_val(&argv[2],sp_long_ptr));
    }
    else {
       abend(SETL_SYSTEM msg_bad_arg,"integer",3,"poke",
@@ -3318,7 +2259,6 @@ void setl2_host_get(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *s, *t;                           /* temporary looping variables       */
@@ -3331,28 +2271,18 @@ int32 b;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"host_get",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    property = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (property == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = property;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < location + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)property,(void *)string_hdr->s_chars,
+          (size_t)(string_hdr->s_length + 1));
 
 
 
@@ -3360,7 +2290,7 @@ int32 b;
    return;
 
 #else
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 #endif
 
@@ -3374,7 +2304,7 @@ void setl2_host_put(
    specifier *target)                  /* return value                      */
 
 {
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 }
 
@@ -3386,11 +2316,11 @@ void setl2_host_call(
    specifier *target)                  /* return value                      */
 
 {
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 }
 
 void setl2_reset_callback(SETL_SYSTEM_PROTO_VOID)
 {
-	callback.sp_form = ft_void;
+	spec_set_form(&callback,ft_void);
 }
@@ -77,6 +77,7 @@
 #include "objects.h"                   /* objects                           */
 #include "process.h"                   /* objects                           */
 #include "mailbox.h"                   /* objects                           */
+#include "reactor.h"                   /* blocked processes                 */
 #include "slots.h"                     /* procedures                        */
 #include "iters.h"                     /* iterators                         */
 #include "axobj.h"
@@ -207,46 +208,29 @@ PCLASS specifier *target_element;      /* target specifier                  */
 
 PCLASS integer_h_ptr_type integer_hdr; /* integer header pointer            */
 PCLASS int32 short_value;              /* short integer value               */
-PCLASS int32 short_hi_bits;            /* high order bits of short          */
-PCLASS i_real_ptr_type real_ptr;       /* real pointer                      */
 PCLASS double real_number;             /* real value                        */
 PCLASS string_h_ptr_type target_string_hdr, left_string_hdr, right_string_hdr;
                                        /* string header pointers            */
-PCLASS string_c_ptr_type target_string_cell, left_string_cell,
-                         right_string_cell;
-                                       /* string cell pointers              */
 PCLASS char *target_char_ptr, *left_char_ptr, *right_char_ptr;
                                        /* character pointers                */
-PCLASS char *target_char_end, *left_char_end, *right_char_end;
-                                       /* character pointers                */
+PCLASS char *right_char_end;           /* end of right string search        */
 PCLASS int32 target_string_length, left_string_length, right_string_length;
                                        /* string lengths                    */
-PCLASS set_h_ptr_type set_root, set_work_hdr, new_set_hdr;
-                                       /* set header pointers               */
-PCLASS set_c_ptr_type set_cell, *set_cell_tail, new_set_cell;
-                                       /* set cell pointer                  */
-PCLASS map_h_ptr_type map_root, map_work_hdr, new_map_hdr;
-                                       /* map header pointers               */
-PCLASS map_c_ptr_type map_cell, *map_cell_tail, new_map_cell;
-                                       /* map cell pointer                  */
-PCLASS tuple_h_ptr_type tuple_root, tuple_work_hdr, new_tuple_hdr;
-                                       /* tuple header pointers             */
+PCLASS set_h_ptr_type set_root;        /* set header pointer                */
+PCLASS set_c_ptr_type set_cell;        /* set cell pointer                  */
+PCLASS struct set_cursor_item set_cursor;
+                                       /* set iteration cursor              */
+PCLASS map_h_ptr_type map_root;        /* map header pointer                */
+PCLASS map_c_ptr_type map_cell;        /* map cell pointer                  */
+PCLASS tuple_h_ptr_type tuple_root;   /* tuple header pointer              */
 PCLASS tuple_c_ptr_type tuple_cell;    /* tuple cell pointer                */
-PCLASS int source_index, source_height;
-                                       /* used to descend header trees      */
-PCLASS int32 source_number;            /* tuple element number              */
 PCLASS int target_index, target_height;
                                        /* used to descend header trees      */
-PCLASS int32 work_length;              /* working length (destroyed)        */
 PCLASS int32 source_hash_code, work_hash_code;
                                        /* work hash codes                   */
 PCLASS int32 domain_hash_code, range_hash_code;
                                        /* work hash codes                   */
 PCLASS int32 target_number;            /* tuple element number              */
-PCLASS int32 expansion_trigger;        /* size which triggers header        */
-                                       /* expansion                         */
-PCLASS int32 contraction_trigger;      /* size which triggers header        */
-                                       /* contraction                       */
 PCLASS int32 slice_start, slice_end;   /* slice limits                      */
 PCLASS proc_ptr_type proc_ptr;         /* procedure pointer                 */
 PCLASS proc_ptr_type new_proc_ptr;     /* created procedure pointer         */
@@ -285,6 +269,7 @@ PCLASS specifier *arg_ptr;             /* work argument pointer             */
 PCLASS int condition_true;             /* YES if tested condition is true   */
 PCLASS int is_equal;                   /* YES if tested specifiers are      */
                                        /* equal                             */
+PCLASS int is_new;                     /* YES if a map cell was added       */
 PCLASS int32 i;                        /* temporary looping variable        */
 
 /* Profiler */
@@ -293,6 +278,13 @@ PCLASS int32 i;                        /* temporary looping variable        */
 struct timeval prf_time;
 #endif
 
+#ifdef DEBUG
+PCLASS instruction *prof_last_ip = NULL;
+                                       /* last instruction profiled         */
+PCLASS int prof_last_op, prof_prev_op = -1;
+                                       /* last two opcodes in sequence      */
+#endif
+
 /* forward declarations */
 
 PRTYPE void call_binop_method(SETL_SYSTEM_PROTO
@@ -355,11 +347,12 @@ PRTYPE void iter_ops2(SETL_SYSTEM_PROTO_VOID);
                                        /* set formers and iterators         */
 PRTYPE void object_ops(SETL_SYSTEM_PROTO_VOID);          
                                        /* object operations                 */
-PRTYPE void switch_process(SETL_SYSTEM_PROTO_VOID);      
-                                       /* change processes                  */
 
 #endif
 
+PRTYPE void switch_process(SETL_SYSTEM_PROTO_VOID);      
+                                       /* change processes                  */
+
 PRTYPE void alloc_cstack(SETL_SYSTEM_PROTO_VOID);
                                        /* enlarge the call stack            */
 
@@ -375,6 +368,69 @@ PRTYPE void alloc_cstack(SETL_SYSTEM_PROTO_VOID);
 
 #endif
 
+/*
+ *  With threaded code we do not come back to the top of the loop after
+ *  each instruction, so we only poll for a stop or a process switch on
+ *  backward branches and on procedure calls and returns.  Every loop and
+ *  every recursion passes through one of those.
+ */
+
+/*
+ *  \verb"replace_target(t,s)" copies \verb"s", whose use count the
+ *  caller has already raised, into the target \verb"t", and then
+ *  releases the old value of the target.  That may be the structure
+ *  \verb"s" came from, as in \verb"x := x(1)", so we can not release
+ *  it first.  The old value is held in a local rather than
+ *  \verb"spare1", which may be the return target of a pending call.
+ */
+
+#define replace_target(t,s) { \
+   specifier old_target; \
+   spec_set_form(&old_target,spec_form(t)); \
+   spec_set_val(&old_target,sp_biggest,spec_val(t,sp_biggest)); \
+   spec_set_form(t,spec_form(s)); \
+   spec_set_val(t,sp_biggest,spec_val(s,sp_biggest)); \
+   unmark_specifier(&old_target); \
+}
+
+#if THREADED_CODE
+
+#define opcode_label(op)   op##_label:
+#define branch_to(t)       {pc = (t); if (pc <= ip) goto execute_start;}
+#define call_poll          goto execute_start
+#define super_next(op)     {OPCODE_COUNT++; ip = pc++; goto op##_label;}
+
+#else
+
+#define opcode_label(op)
+#define branch_to(t)       {pc = (t);}
+#define call_poll
+
+#endif
+
+/*
+ *  \verb"result_assigned_to(v,t)" is true if the next instruction
+ *  overwrites the variable \verb"v" with \verb"t", or with
+ *  \verb"t" plus something other than \verb"v".  The compiler generates
+ *  that for \verb"s := s + f(x) + y", for instance, so the first addition
+ *  may take over the string in \verb"s".  Another process must not see
+ *  \verb"v" in between, so without threaded code we also make sure we
+ *  will not switch processes first.
+ */
+
+#if !THREADED_CODE && defined(PROCESSES)
+#define switch_pending     (opcodes_until_switch <= 1)
+#else
+#define switch_pending     0
+#endif
+
+#define result_assigned_to(v,t) \
+   (!switch_pending && \
+    PC->i_operand[0].i_spec_ptr == (v) && \
+    PC->i_operand[1].i_spec_ptr == (t) && \
+    (PC->i_opcode == p_assign || \
+     (PC->i_opcode == p_add && PC->i_operand[2].i_spec_ptr != (v))))
+
 int hard_stop;
 int abend_initialized;
 
@@ -406,10 +462,10 @@ void execute_setup(
 
    /* initialize spare specifiers */
 
-   spare.sp_form = ft_omega;
-   spare1.sp_form = ft_omega;
+   spec_set_form(&spare,ft_omega);
+   spec_set_form(&spare1,ft_omega);
 
-   SYMBOL_MAP.sp_form = ft_omega; /* Global error extension map */
+   spec_set_form(&SYMBOL_MAP,ft_omega); /* Global error extension map */
 
    /* push something on the program stack, to avoid NULL problems */
 
@@ -433,6 +489,20 @@ void execute_setup(
       process_head->pc_idle = NO;
       process_head->pc_waiting = NO;
       process_head->pc_checking = NO;
+      process_head->pc_sending = NO;
+      process_head->pc_passing = NO;
+      process_head->pc_wait_limit = 0;
+      process_head->pc_blocked = NO;
+      process_head->pc_ready = NO;
+      process_head->pc_wait_fd = -1;
+      process_head->pc_wake_time = -1;
+      process_head->pc_priority = 0;
+      process_head->pc_level = 0;
+      process_head->pc_run_usecs = 0;
+      process_head->pc_run_opcodes = 0;
+      process_head->pc_redo_args = NULL;
+      SCHED_START = SCHED_BOOST = process_clock();
+      SCHED_OPCODES = OPCODE_COUNT;
    }
    hard_stop=0;
    abend_initialized=0;
@@ -444,47 +514,16 @@ void get_setl_string(
    specifier *target) 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
 
 
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (*s) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string(SETL_SYSTEM s);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -498,69 +537,19 @@ void get_from_symmap(
    specifier *left, 
    specifier *target)
 {
-         spec_hash_code(work_hash_code,right);
-         source_hash_code = work_hash_code;
-
          /* look up the map component */
 
-         map_work_hdr = left->sp_val.sp_map_ptr;
-
-         for (source_height = map_work_hdr->m_ntype.m_root.m_height;
-              source_height && map_work_hdr != NULL;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-            map_work_hdr = map_work_hdr->m_child[source_index].m_header;
-
-         }
-
-         /* if we can't get to a leaf, there is no matching element */
-
-         if (map_work_hdr == NULL) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_omega;
-
-            return;
-
-         }
-
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
-
-         source_index = work_hash_code & MAP_HASH_MASK;
-         for (map_cell = map_work_hdr->m_child[source_index].m_cell;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < source_hash_code;
-              map_cell = map_cell->m_next);
-
-         /* try to find the domain element */
-
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == source_hash_code) {
-
-            spec_equal(is_equal,&(map_cell->m_domain_spec),right);
-
-            if (is_equal)
-               break;
-
-            map_cell = map_cell->m_next;
-
-         }
+         spec_hash_code(source_hash_code,right);
+         map_cell = map_lookup(spec_val(left,sp_map_ptr)->m_trie,
+                               right,
+                               source_hash_code);
 
          /* if we did't find the domain element, return omega */
 
-         if (!is_equal) {
+         if (map_cell == NULL) {
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
 
             return;
 
@@ -571,7 +560,7 @@ void get_from_symmap(
          if (map_cell->m_is_multi_val) {
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
 
             return;
 
@@ -581,9 +570,9 @@ void get_from_symmap(
 
          mark_specifier(&(map_cell->m_range_spec));
          unmark_specifier(target);
-         target->sp_form = map_cell->m_range_spec.sp_form;
-         target->sp_val.sp_biggest =
-            map_cell->m_range_spec.sp_val.sp_biggest;
+         spec_set_form(target,spec_form(&map_cell->m_range_spec));
+         spec_set_val(target,sp_biggest,
+            spec_val(&map_cell->m_range_spec,sp_biggest));
 
 }
 
@@ -614,7 +603,7 @@ char function[64];
   get_from_symmap(SETL_SYSTEM &spare,
                   cstack[cstack_top].cs_unittab_ptr->ut_err_ext_map,
                   &spare1);
-  if (spare1.sp_form==ft_omega)  {
+  if (spec_form(&spare1)==ft_omega)  {
         abend(SETL_SYSTEM message,s,l,r);
   }
 
@@ -653,7 +642,7 @@ char function[64];
   get_from_symmap(SETL_SYSTEM &spare,
                   cstack[cstack_top].cs_unittab_ptr->ut_err_ext_map,
                   &spare1);
-  if (spare1.sp_form==ft_omega)  {
+  if (spec_form(&spare1)==ft_omega)  {
         abend(SETL_SYSTEM message,s,l,r);
   }
 
@@ -691,7 +680,7 @@ char function[64];
   get_from_symmap(SETL_SYSTEM &spare,
                   cstack[cstack_top].cs_unittab_ptr->ut_err_ext_map,
                   &spare1);
-  if (spare1.sp_form==ft_omega)  {
+  if (spec_form(&spare1)==ft_omega)  {
         abend(SETL_SYSTEM message,s,l);
   }
 
@@ -712,6 +701,132 @@ int execute_go(
 #ifdef HAVE_GETRUSAGE
 struct timeval tvspam;
 struct timezone tzspam;
+#endif
+
+#if THREADED_CODE
+
+   /*
+    *  The loader calls us once in this mode to find the address of each
+    *  case, which it stores in the instructions it loads.  Anything we
+    *  don't handle drops through to the bottom of the loop, just like
+    *  an unmatched switch.
+    */
+
+   if (forever == EX_HANDLERS) {
+
+      static void *handler_table[pcode_handler_length + 1];
+
+      for (i = 0; i <= pcode_handler_length; i++)
+         handler_table[i] = &&execute_next;
+
+      handler_table[p_noop] = &&p_noop_label;
+      handler_table[p_push1] = &&p_push1_label;
+      handler_table[p_push2] = &&p_push2_label;
+      handler_table[p_push3] = &&p_push3_label;
+      handler_table[p_pop1] = &&p_pop1_label;
+      handler_table[p_pop2] = &&p_pop2_label;
+      handler_table[p_pop3] = &&p_pop3_label;
+      handler_table[p_add] = &&p_add_label;
+      handler_table[p_sub] = &&p_sub_label;
+      handler_table[p_mult] = &&p_mult_label;
+      handler_table[p_div] = &&p_div_label;
+      handler_table[p_exp] = &&p_exp_label;
+      handler_table[p_mod] = &&p_mod_label;
+      handler_table[p_min] = &&p_min_label;
+      handler_table[p_max] = &&p_max_label;
+      handler_table[p_with] = &&p_with_label;
+      handler_table[p_less] = &&p_less_label;
+      handler_table[p_lessf] = &&p_lessf_label;
+      handler_table[p_from] = &&p_from_label;
+      handler_table[p_fromb] = &&p_fromb_label;
+      handler_table[p_frome] = &&p_frome_label;
+      handler_table[p_npow] = &&p_npow_label;
+      handler_table[p_uminus] = &&p_uminus_label;
+      handler_table[p_domain] = &&p_domain_label;
+      handler_table[p_range] = &&p_range_label;
+      handler_table[p_pow] = &&p_pow_label;
+      handler_table[p_arb] = &&p_arb_label;
+      handler_table[p_nelt] = &&p_nelt_label;
+      handler_table[p_not] = &&p_not_label;
+      handler_table[p_smap] = &&p_smap_label;
+      handler_table[p_tupof] = &&p_tupof_label;
+      handler_table[p_of1] = &&p_of1_label;
+      handler_table[p_of] = &&p_of_label;
+      handler_table[p_ofa] = &&p_ofa_label;
+      handler_table[p_kof1] = &&p_kof1_label;
+      handler_table[p_kofa] = &&p_kofa_label;
+      handler_table[p_erase] = &&p_erase_label;
+      handler_table[p_slice] = &&p_slice_label;
+      handler_table[p_end] = &&p_end_label;
+      handler_table[p_assign] = &&p_assign_label;
+      handler_table[p_penviron] = &&p_penviron_label;
+      handler_table[p_sof] = &&p_sof_label;
+      handler_table[p_sofa] = &&p_sofa_label;
+      handler_table[p_sslice] = &&p_sslice_label;
+      handler_table[p_send] = &&p_send_label;
+      handler_table[p_eq] = &&p_eq_label;
+      handler_table[p_ne] = &&p_ne_label;
+      handler_table[p_lt] = &&p_lt_label;
+      handler_table[p_nlt] = &&p_nlt_label;
+      handler_table[p_le] = &&p_le_label;
+      handler_table[p_nle] = &&p_nle_label;
+      handler_table[p_in] = &&p_in_label;
+      handler_table[p_notin] = &&p_notin_label;
+      handler_table[p_incs] = &&p_incs_label;
+      handler_table[p_and] = &&p_and_label;
+      handler_table[p_or] = &&p_or_label;
+      handler_table[p_go] = &&p_go_label;
+      handler_table[p_goind] = &&p_goind_label;
+      handler_table[p_gotrue] = &&p_gotrue_label;
+      handler_table[p_gofalse] = &&p_gofalse_label;
+      handler_table[p_goeq] = &&p_goeq_label;
+      handler_table[p_gone] = &&p_gone_label;
+      handler_table[p_golt] = &&p_golt_label;
+      handler_table[p_gonlt] = &&p_gonlt_label;
+      handler_table[p_gole] = &&p_gole_label;
+      handler_table[p_gonle] = &&p_gonle_label;
+      handler_table[p_goin] = &&p_goin_label;
+      handler_table[p_gonotin] = &&p_gonotin_label;
+      handler_table[p_goincs] = &&p_goincs_label;
+      handler_table[p_gonincs] = &&p_gonincs_label;
+      handler_table[p_set] = &&p_set_label;
+      handler_table[p_tuple] = &&p_tuple_label;
+      handler_table[p_iter] = &&p_iter_label;
+      handler_table[p_inext] = &&p_inext_label;
+      handler_table[p_lcall] = &&p_lcall_label;
+      handler_table[p_call] = &&p_call_label;
+      handler_table[p_return] = &&p_return_label;
+      handler_table[p_stop] = &&p_stop_label;
+      handler_table[p_stopall] = &&p_stopall_label;
+      handler_table[p_assert] = &&p_assert_label;
+      handler_table[p_initobj] = &&p_initobj_label;
+      handler_table[p_initend] = &&p_initend_label;
+      handler_table[p_slot] = &&p_slot_label;
+      handler_table[p_sslot] = &&p_sslot_label;
+      handler_table[p_slotof] = &&p_slotof_label;
+      handler_table[p_menviron] = &&p_menviron_label;
+      handler_table[p_self] = &&p_self_label;
+      handler_table[p_intcheck] = &&p_intcheck_label;
+#ifdef DEBUG
+      handler_table[p_filepos] = &&p_filepos_label;
+#endif
+      handler_table[p_ufrom] = &&p_ufrom_label;
+      handler_table[p_add_add] = &&p_add_add_label;
+      handler_table[p_add_go] = &&p_add_go_label;
+      handler_table[p_add_golt] = &&p_add_golt_label;
+      handler_table[p_add_return] = &&p_add_return_label;
+      handler_table[p_sub_push1] = &&p_sub_push1_label;
+      handler_table[p_assign_of1] = &&p_assign_of1_label;
+      handler_table[p_push1_lcall] = &&p_push1_lcall_label;
+      handler_table[p_push2_lcall] = &&p_push2_lcall_label;
+      handler_table[p_push3_lcall] = &&p_push3_lcall_label;
+
+      pcode_handlers = handler_table;
+
+      return CONTINUE;
+
+   }
+
 #endif
 
    WAIT_FLAG=0;
@@ -743,11 +858,13 @@ struct timezone tzspam;
 
    execute_start:
 
-      OPCODE_COUNT++;
-       
       if (hard_stop>0) {
       	 return NO;
       }
+
+      /* release a little of any data whose freeing was deferred */
+
+      free_step();
 #ifdef PROCESSES
 
       if ((--opcodes_until_switch) <= 0)
@@ -755,6 +872,32 @@ struct timezone tzspam;
 
 #endif
 
+#if THREADED_CODE
+
+   execute_next:
+
+#endif
+
+      OPCODE_COUNT++;
+
+#if THREADED_CODE
+
+      /*
+       *  Unless we are tracing or profiling, jump straight to the case
+       *  for the next instruction.  Otherwise we fall into the switch
+       *  below, which does the bookkeeping.
+       */
+
+#ifdef DEBUG
+      if (!TRACING_ON && !PROF_DEBUG)
+#endif
+      {
+         ip = pc++;
+         goto *(ip->i_handler);
+      }
+
+#endif
+
 #ifdef DEBUG
 
       ip = pc++;
@@ -763,6 +906,34 @@ struct timezone tzspam;
          OPCODE_EXECUTED=ip->i_opcode;
          pcode_operations[OPCODE_EXECUTED]++;
 
+         /*
+          *  Count opcode pairs and triples which execute in sequence
+          *  without a branch in between.  These are the candidates for
+          *  superinstructions.
+          */
+
+         if (ip->i_opcode != p_filepos) {
+
+            if (prof_last_ip != NULL && ip == prof_last_ip + 1 + EX_DEBUG) {
+
+               pcode_pairs[prof_last_op][ip->i_opcode]++;
+               if (prof_prev_op >= 0 && pcode_triples != NULL)
+                  pcode_triples[(prof_prev_op * PCODE_NGRAM_SIZE +
+                                 prof_last_op) * PCODE_NGRAM_SIZE +
+                                ip->i_opcode]++;
+               prof_prev_op = prof_last_op;
+
+            }
+            else {
+
+               prof_prev_op = -1;
+
+            }
+
+            prof_last_op = ip->i_opcode;
+            prof_last_ip = ip;
+
+         }
       }
 
       if ((TRACING_ON) && ip->i_opcode != p_filepos) {
@@ -831,6 +1002,7 @@ struct timezone tzspam;
 \*/
 
 case p_noop :
+opcode_label(p_noop)
 
 #ifdef TRAPS
 
@@ -856,6 +1028,7 @@ case p_noop :
 #ifdef DEBUG
 
 case p_filepos :
+opcode_label(p_filepos)
 
    if ((!EX_DEBUG)&&(!PROF_DEBUG))
       break;
@@ -890,6 +1063,7 @@ case p_filepos :
 \*/
 
 case p_erase :
+opcode_label(p_erase)
 
 {
 
@@ -901,7 +1075,7 @@ case p_erase :
 
    /* the action we take depends on the form of the target operand */
 
-   switch (target->sp_form) {
+   switch (spec_form(target)) {
 
       /*
        *  We modify strings in-line, since this should be very fast.
@@ -917,95 +1091,31 @@ case p_erase :
             abend(SETL_SYSTEM msg_invalid_set_map,abend_opnd_str(SETL_SYSTEM target));
 
       case ft_map :
-      	 if (left->sp_form==ft_omega)
+      	 if (spec_form(left)==ft_omega)
       	 	abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
          /* we would like to use the target destructively */
 
-         map_root = target->sp_val.sp_map_ptr;
+         map_root = spec_val(target,sp_map_ptr);
          if (map_root->m_use_count != 1) {
 
             map_root->m_use_count--;
             map_root = copy_map(SETL_SYSTEM map_root);
-            target->sp_val.sp_map_ptr = map_root;
+            spec_set_val(target,sp_map_ptr,map_root);
 
          }
 
          /* look up the domain element in the map */
 
-         map_work_hdr = map_root;
-         spec_hash_code(work_hash_code,right);
-         range_hash_code = work_hash_code;
-         spec_hash_code(work_hash_code,left);
-         domain_hash_code = work_hash_code;
-
-         for (source_height = map_work_hdr->m_ntype.m_root.m_height;
-              source_height;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-            /* if we're missing a header record, insert it */
-
-            if (map_work_hdr->m_child[source_index].m_header == NULL) {
-
-               get_map_header(new_map_hdr);
-               new_map_hdr->m_ntype.m_intern.m_parent = map_work_hdr;
-               new_map_hdr->m_ntype.m_intern.m_child_index = source_index;
-               for (i = 0;
-                    i < MAP_HASH_SIZE;
-                    new_map_hdr->m_child[i++].m_cell = NULL);
-               map_work_hdr->m_child[source_index].m_header = new_map_hdr;
-               map_work_hdr = new_map_hdr;
-
-            }
-            else {
-
-               map_work_hdr = map_work_hdr->m_child[source_index].m_header;
-
-            }
-         }
-
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
-
-         source_index = work_hash_code & MAP_HASH_MASK;
-         map_cell_tail = &(map_work_hdr->m_child[source_index].m_cell);
-         for (map_cell = map_work_hdr->m_child[source_index].m_cell;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < domain_hash_code;
-              map_cell = map_cell->m_next) {
-
-            map_cell_tail = &(map_cell->m_next);
-
-         }
-
-         /* try to find the domain element */
-
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == domain_hash_code) {
-
-            spec_equal(is_equal,&(map_cell->m_domain_spec),left);
-
-            if (is_equal)
-               break;
-
-            map_cell_tail = &(map_cell->m_next);
-            map_cell = map_cell->m_next;
-
-         }
+         spec_hash_code(range_hash_code,right);
+         spec_hash_code(domain_hash_code,left);
 
          /* if the source operand is omega, remove the cell */
 
-         if (right->sp_form == ft_omega) {
+         if (spec_form(right) == ft_omega) {
 
-            if (!is_equal)
+            map_cell = map_unlink(&(map_root->m_trie),left,domain_hash_code);
+            if (map_cell == NULL)
                break;
 
             spec_hash_code(work_hash_code,&(map_cell->m_range_spec));
@@ -1013,46 +1123,26 @@ case p_erase :
 
             if (map_cell->m_is_multi_val) {
 
-               set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-               map_root->m_ntype.m_root.m_cardinality -=
-                     set_root->s_ntype.s_root.s_cardinality;
+               set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+               map_root->m_cardinality -=
+                     set_root->s_cardinality;
 
-               if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+               if ((set_root->s_cardinality%2)==0) 
                   map_root->m_hash_code ^= map_cell->m_hash_code;
 
             }
             else {
 
-               map_root->m_ntype.m_root.m_cardinality--;
+               map_root->m_cardinality--;
 
             }
 
             map_root->m_hash_code ^= map_cell->m_hash_code;
-            *map_cell_tail = map_cell->m_next;
             unmark_specifier(&(map_cell->m_domain_spec));
             unmark_specifier(&(map_cell->m_range_spec));
-            map_root->m_ntype.m_root.m_cell_count--;
+            map_root->m_cell_count--;
             free_map_cell(map_cell);
 
-            /*
-             *  We've reduced the number of cells, so we may have to
-             *  contract the map header.
-             */
-
-            contraction_trigger =
-                  (1 << ((map_root->m_ntype.m_root.m_height)
-                          * MAP_SHIFT_DIST));
-            if (contraction_trigger == 1)
-               contraction_trigger = 0;
-
-            if (map_root->m_ntype.m_root.m_cell_count <
-                contraction_trigger) {
-
-               map_root = map_contract_header(SETL_SYSTEM map_root);
-               target->sp_val.sp_map_ptr = map_root;
-
-            }
-
             break;
 
          }
@@ -1061,41 +1151,27 @@ case p_erase :
           *  The source is not omega, so we add or change a cell.
           */
 
+         map_cell = map_locate(&(map_root->m_trie),left,domain_hash_code,
+                               &is_new);
+
          /* if we don't find the domain element, add a cell */
 
-         if (!is_equal) {
+         if (is_new) {
 
-            get_map_cell(new_map_cell);
             mark_specifier(left);
             mark_specifier(right);
-            new_map_cell->m_domain_spec.sp_form = left->sp_form;
-            new_map_cell->m_domain_spec.sp_val.sp_biggest =
-                  left->sp_val.sp_biggest;
-            new_map_cell->m_range_spec.sp_form = right->sp_form;
-            new_map_cell->m_range_spec.sp_val.sp_biggest =
-                  right->sp_val.sp_biggest;
-            new_map_cell->m_is_multi_val = NO;
-            new_map_cell->m_hash_code = domain_hash_code;
-            new_map_cell->m_next = *map_cell_tail;
-            *map_cell_tail = new_map_cell;
-            map_root->m_ntype.m_root.m_cardinality++;
-            map_root->m_ntype.m_root.m_cell_count++;
+            spec_set_form(&map_cell->m_domain_spec,spec_form(left));
+            spec_set_val(&map_cell->m_domain_spec,sp_biggest,
+                  spec_val(left,sp_biggest));
+            spec_set_form(&map_cell->m_range_spec,spec_form(right));
+            spec_set_val(&map_cell->m_range_spec,sp_biggest,
+                  spec_val(right,sp_biggest));
+            map_cell->m_is_multi_val = NO;
+            map_root->m_cardinality++;
+            map_root->m_cell_count++;
             map_root->m_hash_code ^= domain_hash_code;
             map_root->m_hash_code ^= range_hash_code;
 
-            /* expand the map header if necessary */
-
-            expansion_trigger =
-                  (1 << ((map_root->m_ntype.m_root.m_height + 1)
-                         * MAP_SHIFT_DIST)) * 2;
-            if (map_root->m_ntype.m_root.m_cardinality >
-                expansion_trigger) {
-
-               map_root = map_expand_header(SETL_SYSTEM map_root);
-               target->sp_val.sp_map_ptr = map_root;
-
-            }
-
             break;
 
          }
@@ -1104,11 +1180,11 @@ case p_erase :
 
          if (map_cell->m_is_multi_val) {
 
-            set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-            map_root->m_ntype.m_root.m_cardinality -=
-                  (set_root->s_ntype.s_root.s_cardinality - 1);
+            set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+            map_root->m_cardinality -=
+                  (set_root->s_cardinality - 1);
 
-            if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+            if ((set_root->s_cardinality%2)==0) 
                map_root->m_hash_code ^= map_cell->m_hash_code;
          }
 
@@ -1120,9 +1196,9 @@ case p_erase :
 
          mark_specifier(right);
          unmark_specifier(&(map_cell->m_range_spec));
-         map_cell->m_range_spec.sp_form = right->sp_form;
-         map_cell->m_range_spec.sp_val.sp_biggest =
-               right->sp_val.sp_biggest;
+         spec_set_form(&map_cell->m_range_spec,spec_form(right));
+         spec_set_val(&map_cell->m_range_spec,sp_biggest,
+               spec_val(right,sp_biggest));
          map_cell->m_is_multi_val = NO;
          map_root->m_hash_code ^= range_hash_code;
 
@@ -1137,23 +1213,24 @@ case p_erase :
 
          /* we convert the tuple index to a C long */
 
-         if (left->sp_form == ft_short) {
+         if (spec_form(left) == ft_short) {
 
-            short_value = left->sp_val.sp_short_value;
+            short_value = spec_val(left,sp_short_value);
             if (short_value < 0)
                short_value =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
          }
-         else if (left->sp_form == ft_long) {
+         else if (spec_form(left) == ft_long) {
 
-            short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
             if (short_value < 0)
                short_value =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
@@ -1165,7 +1242,7 @@ case p_erase :
 
          }
 
-         tuple_root = target->sp_val.sp_tuple_ptr;
+         tuple_root = spec_val(target,sp_tuple_ptr);
 
          /* we would like to use the target destructively */
 
@@ -1173,7 +1250,7 @@ case p_erase :
 
             tuple_root->t_use_count--;
             tuple_root = copy_tuple(SETL_SYSTEM tuple_root);
-            target->sp_val.sp_tuple_ptr = tuple_root;
+            spec_set_val(target,sp_tuple_ptr,tuple_root);
 
          }
 
@@ -1181,338 +1258,135 @@ case p_erase :
 
          short_value--;
 
-         /* if the item is past the end of the tuple, extend the tuple */
-
-         if (short_value >= tuple_root->t_ntype.t_root.t_length) {
-
-            expansion_trigger =
-                  1 << ((tuple_root->t_ntype.t_root.t_height + 1)
-                        * TUP_SHIFT_DIST);
+         /* packed tuples take numbers of the same form in place */
 
-            /* expand the target tree if necessary */
+         if (tuple_root->t_packing != TUP_CELLS &&
+             store_packed(SETL_SYSTEM tuple_root,short_value,right))
+            break;
 
-            while (short_value >= expansion_trigger) {
+         /* if the item is past the end of the tuple, extend the tuple */
 
-               tuple_work_hdr = tuple_root;
+         if (short_value >= tuple_root->t_length) {
 
-               get_tuple_header(tuple_root);
+            if (spec_form(right) == ft_omega)
+               break;
 
-               tuple_root->t_use_count = 1;
-               tuple_root->t_hash_code =
-                  tuple_work_hdr->t_hash_code;
-               tuple_root->t_ntype.t_root.t_length =
-                  tuple_work_hdr->t_ntype.t_root.t_length;
-               tuple_root->t_ntype.t_root.t_height =
-                  tuple_work_hdr->t_ntype.t_root.t_height + 1;
+            extend_tuple(tuple_root,short_value + 1);
 
-               for (i = 1;
-                    i < TUP_HEADER_SIZE;
-                    tuple_root->t_child[i++].t_header = NULL);
+         }
 
-               tuple_root->t_child[0].t_header = tuple_work_hdr;
+         /* replace the element (omega cells have a zero hash code) */
 
-               tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-               tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
+         tuple_cell = tuple_root->t_cells + short_value;
+         mark_specifier(right);
+         unmark_specifier(&(tuple_cell->t_spec));
+         tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
+         spec_set_form(&tuple_cell->t_spec,spec_form(right));
+         spec_set_val(&tuple_cell->t_spec,sp_biggest,
+                      spec_val(right,sp_biggest));
+         spec_hash_code(work_hash_code,right);
+         tuple_root->t_hash_code ^= work_hash_code;
+         tuple_cell->t_hash_code = work_hash_code;
 
-               expansion_trigger *= TUP_HEADER_SIZE;
+         /* if we assign omega to the last cell of a tuple, we shorten it */
 
-            }
+         if (spec_form(right) == ft_omega)
+            trim_tuple(tuple_root);
 
-            tuple_root->t_ntype.t_root.t_length = short_value + 1;
-            target->sp_val.sp_tuple_ptr = tuple_root;
+         break;
 
-         }
+      /*
+       *  We can't do much with objects, since the user is allowed to
+       *  define his own operation.  We look for such a user-defined
+       *  operation and call it.
+       */
 
-         /* look up the tuple component */
+      case ft_object :
 
-         tuple_work_hdr = tuple_root;
+         break;
 
-         for (source_height = tuple_work_hdr->t_ntype.t_root.t_height;
-              source_height;
-              source_height--) {
+      /*
+       *  Anything else is a run-time error.
+       */
 
-            /* extract the element's index at this level */
+      default :
 
-            source_index = (short_value >>
-                                 (source_height * TUP_SHIFT_DIST)) &
-                              TUP_SHIFT_MASK;
+         break;
 
-            /* if we're missing a header record, allocate one */
+   }
 
-            if (tuple_work_hdr->t_child[source_index].t_header == NULL) {
+   break;
 
-               get_tuple_header(new_tuple_hdr);
-               new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-               new_tuple_hdr->t_ntype.t_intern.t_child_index = source_index;
-               for (i = 0;
-                    i < TUP_HEADER_SIZE;
-                    new_tuple_hdr->t_child[i++].t_cell = NULL);
-               tuple_work_hdr->t_child[source_index].t_header =
-                     new_tuple_hdr;
-               tuple_work_hdr = new_tuple_hdr;
+}
 
-            }
-            else {
+/*\
+ *  \pcode{p\_smap}{convert set to single-valued map}
+ *        {specifier}{set}
+ *        {}{unused}
+ *        {}{unused}
+ *
+ *  This opcode converts a set to a single-valued map.  It is used for
+ *  run-time prevention of duplicate case labels.
+\*/
 
-               tuple_work_hdr =
-                  tuple_work_hdr->t_child[source_index].t_header;
+case p_smap :
+opcode_label(p_smap)
 
-            }
-         }
+   set_to_smap(SETL_SYSTEM ip->i_operand[0].i_spec_ptr,
+               ip->i_operand[0].i_spec_ptr);
 
-         /*
-          *  At this point, tuple_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
+   break;
 
-         source_index = short_value & TUP_SHIFT_MASK;
-         tuple_cell = tuple_work_hdr->t_child[source_index].t_cell;
+/*\
+ *  \pcode{p\_push1}{push one operand}
+ *        {specifier}{value to be pushed}
+ *        {}{unused}
+ *        {}{unused}
+ *
+ *  This case pushes one operand on the program stack.  We have three
+ *  simple push operands, which push one, two, or three operands on the
+ *  stack.  This is just an attempt to make better use of the pseudo-code
+ *  instruction width -- we cut the number of instructions necessary to
+ *  push a set of operands on the stack.
+\*/
 
-         /* if we assign omega to the last cell of a tuple, we shorten it */
+case p_push1 :
+opcode_label(p_push1)
 
-         if (right->sp_form == ft_omega &&
-             short_value == (tuple_root->t_ntype.t_root.t_length - 1)) {
+   push_pstack(ip->i_operand[0].i_spec_ptr);
 
-            /* first free the tuple cell */
+   break;
 
-            if (tuple_cell != NULL) {
+/*\
+ *  \pcode{p\_push2}{push two operands}
+ *        {specifier}{first value to be pushed}
+ *        {specifier}{second value to be pushed}
+ *        {}{unused}
+\*/
 
-               tuple_root->t_hash_code ^=
-                     tuple_cell->t_hash_code;
-               unmark_specifier(&(tuple_cell->t_spec));
-               free_tuple_cell(tuple_cell);
-               tuple_work_hdr->t_child[source_index].t_cell = NULL;
+case p_push2 :
+opcode_label(p_push2)
 
-            }
+   push_pstack(ip->i_operand[0].i_spec_ptr);
+   push_pstack(ip->i_operand[1].i_spec_ptr);
 
-            /* now shorten the tuple while the rightmost element is omega */
+   break;
 
-            for (;;) {
+/*\
+ *  \pcode{p\_push3}{push three operands}
+ *        {specifier}{first value to be pushed}
+ *        {specifier}{second value to be pushed}
+ *        {specifier}{third value to be pushed}
+\*/
 
-               if (!source_height && source_index >= 0) {
+case p_push3 :
+opcode_label(p_push3)
 
-                  if (tuple_work_hdr->t_child[source_index].t_cell != NULL)
-                     break;
+   push_pstack(ip->i_operand[0].i_spec_ptr);
+   push_pstack(ip->i_operand[1].i_spec_ptr);
+   push_pstack(ip->i_operand[2].i_spec_ptr);
 
-                  tuple_root->t_ntype.t_root.t_length--;
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* move up if we're at the end of a node */
-
-               if (source_index < 0) {
-
-                  if (tuple_work_hdr == tuple_root)
-                     break;
-
-                  source_height++;
-                  source_index =
-                     tuple_work_hdr->t_ntype.t_intern.t_child_index;
-                  tuple_work_hdr =
-                     tuple_work_hdr->t_ntype.t_intern.t_parent;
-                  free_tuple_header(
-                     tuple_work_hdr->t_child[source_index].t_header);
-                  tuple_work_hdr->t_child[source_index].t_header = NULL;
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* skip over null nodes */
-
-               if (tuple_work_hdr->t_child[source_index].t_header == NULL) {
-
-                  tuple_root->t_ntype.t_root.t_length -=
-                        1 << (source_height * TUP_SHIFT_DIST);
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* otherwise drop down a level */
-
-               tuple_work_hdr =
-                  tuple_work_hdr->t_child[source_index].t_header;
-               source_index = TUP_HEADER_SIZE - 1;
-
-               source_height--;
-
-            }
-
-            /* we've shortened the tuple -- now reduce the height */
-
-            while (tuple_root->t_ntype.t_root.t_height > 0 &&
-                   tuple_root->t_ntype.t_root.t_length <=
-                      (int32)(1L << (tuple_root->t_ntype.t_root.t_height *
-                                    TUP_SHIFT_DIST))) {
-
-               tuple_work_hdr = tuple_root->t_child[0].t_header;
-
-               /* it's possible that we deleted internal headers */
-
-               if (tuple_work_hdr == NULL) {
-
-                  tuple_root->t_ntype.t_root.t_height--;
-                  continue;
-
-               }
-
-               /* delete the root node */
-
-               tuple_work_hdr->t_use_count = tuple_root->t_use_count;
-               tuple_work_hdr->t_hash_code =
-                     tuple_root->t_hash_code;
-               tuple_work_hdr->t_ntype.t_root.t_length =
-                     tuple_root->t_ntype.t_root.t_length;
-               tuple_work_hdr->t_ntype.t_root.t_height =
-                     tuple_root->t_ntype.t_root.t_height - 1;
-
-               free_tuple_header(tuple_root);
-               tuple_root = tuple_work_hdr;
-               target->sp_val.sp_tuple_ptr = tuple_root;
-
-            }
-
-            break;
-
-         }
-
-         /* we aren't assigning omega, or we're not at the end of a tuple */
-
-         if (tuple_cell == NULL) {
-
-            if (right->sp_form == ft_omega)
-               break;
-
-            get_tuple_cell(tuple_cell);
-            tuple_work_hdr->t_child[source_index].t_cell = tuple_cell;
-            mark_specifier(right);
-            tuple_cell->t_spec.sp_form = right->sp_form;
-            tuple_cell->t_spec.sp_val.sp_biggest = right->sp_val.sp_biggest;
-            spec_hash_code(work_hash_code,right);
-            tuple_root->t_hash_code ^= work_hash_code;
-            tuple_cell->t_hash_code = work_hash_code;
-
-            break;
-
-         }
-
-         if (right->sp_form == ft_omega) {
-
-            unmark_specifier(&(tuple_cell->t_spec));
-            tuple_root->t_hash_code ^=
-                  tuple_cell->t_hash_code;
-            free_tuple_cell(tuple_cell);
-            tuple_work_hdr->t_child[source_index].t_cell = NULL;
-
-            break;
-
-         }
-
-         mark_specifier(right);
-         unmark_specifier(&(tuple_cell->t_spec));
-         tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
-         tuple_cell->t_spec.sp_form = right->sp_form;
-         tuple_cell->t_spec.sp_val.sp_biggest = right->sp_val.sp_biggest;
-         spec_hash_code(work_hash_code,right);
-         tuple_root->t_hash_code ^= work_hash_code;
-         tuple_cell->t_hash_code = work_hash_code;
-
-         break;
-
-      /*
-       *  We can't do much with objects, since the user is allowed to
-       *  define his own operation.  We look for such a user-defined
-       *  operation and call it.
-       */
-
-      case ft_object :
-
-         break;
-
-      /*
-       *  Anything else is a run-time error.
-       */
-
-      default :
-
-         break;
-
-   }
-
-   break;
-
-}
-
-/*\
- *  \pcode{p\_smap}{convert set to single-valued map}
- *        {specifier}{set}
- *        {}{unused}
- *        {}{unused}
- *
- *  This opcode converts a set to a single-valued map.  It is used for
- *  run-time prevention of duplicate case labels.
-\*/
-
-case p_smap :
-
-   set_to_smap(SETL_SYSTEM ip->i_operand[0].i_spec_ptr,
-               ip->i_operand[0].i_spec_ptr);
-
-   break;
-
-/*\
- *  \pcode{p\_push1}{push one operand}
- *        {specifier}{value to be pushed}
- *        {}{unused}
- *        {}{unused}
- *
- *  This case pushes one operand on the program stack.  We have three
- *  simple push operands, which push one, two, or three operands on the
- *  stack.  This is just an attempt to make better use of the pseudo-code
- *  instruction width -- we cut the number of instructions necessary to
- *  push a set of operands on the stack.
-\*/
-
-case p_push1 :
-
-   push_pstack(ip->i_operand[0].i_spec_ptr);
-
-   break;
-
-/*\
- *  \pcode{p\_push2}{push two operands}
- *        {specifier}{first value to be pushed}
- *        {specifier}{second value to be pushed}
- *        {}{unused}
-\*/
-
-case p_push2 :
-
-   push_pstack(ip->i_operand[0].i_spec_ptr);
-   push_pstack(ip->i_operand[1].i_spec_ptr);
-
-   break;
-
-/*\
- *  \pcode{p\_push3}{push three operands}
- *        {specifier}{first value to be pushed}
- *        {specifier}{second value to be pushed}
- *        {specifier}{third value to be pushed}
-\*/
-
-case p_push3 :
-
-   push_pstack(ip->i_operand[0].i_spec_ptr);
-   push_pstack(ip->i_operand[1].i_spec_ptr);
-   push_pstack(ip->i_operand[2].i_spec_ptr);
-
-   break;
+   break;
 
 /*\
  *  \pcode{p\_pop1}{pop one operand}
@@ -1528,11 +1402,12 @@ case p_push3 :
 \*/
 
 case p_pop1 :
+opcode_label(p_pop1)
 
    target = ip->i_operand[0].i_spec_ptr;
    unmark_specifier(target);
-   target->sp_form = pstack[pstack_top].sp_form;
-   target->sp_val.sp_biggest = pstack[pstack_top].sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&pstack[pstack_top]));
+   spec_set_val(target,sp_biggest,spec_val(&pstack[pstack_top],sp_biggest));
    pstack_top--;
 
    break;
@@ -1545,17 +1420,18 @@ case p_pop1 :
 \*/
 
 case p_pop2 :
+opcode_label(p_pop2)
 
    target = ip->i_operand[0].i_spec_ptr;
    unmark_specifier(target);
-   target->sp_form = pstack[pstack_top].sp_form;
-   target->sp_val.sp_biggest = pstack[pstack_top].sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&pstack[pstack_top]));
+   spec_set_val(target,sp_biggest,spec_val(&pstack[pstack_top],sp_biggest));
    pstack_top--;
 
    target = ip->i_operand[1].i_spec_ptr;
    unmark_specifier(target);
-   target->sp_form = pstack[pstack_top].sp_form;
-   target->sp_val.sp_biggest = pstack[pstack_top].sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&pstack[pstack_top]));
+   spec_set_val(target,sp_biggest,spec_val(&pstack[pstack_top],sp_biggest));
    pstack_top--;
 
    break;
@@ -1568,23 +1444,24 @@ case p_pop2 :
 \*/
 
 case p_pop3 :
+opcode_label(p_pop3)
 
    target = ip->i_operand[0].i_spec_ptr;
    unmark_specifier(target);
-   target->sp_form = pstack[pstack_top].sp_form;
-   target->sp_val.sp_biggest = pstack[pstack_top].sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&pstack[pstack_top]));
+   spec_set_val(target,sp_biggest,spec_val(&pstack[pstack_top],sp_biggest));
    pstack_top--;
 
    target = ip->i_operand[1].i_spec_ptr;
    unmark_specifier(target);
-   target->sp_form = pstack[pstack_top].sp_form;
-   target->sp_val.sp_biggest = pstack[pstack_top].sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&pstack[pstack_top]));
+   spec_set_val(target,sp_biggest,spec_val(&pstack[pstack_top],sp_biggest));
    pstack_top--;
 
    target = ip->i_operand[2].i_spec_ptr;
    unmark_specifier(target);
-   target->sp_form = pstack[pstack_top].sp_form;
-   target->sp_val.sp_biggest = pstack[pstack_top].sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&pstack[pstack_top]));
+   spec_set_val(target,sp_biggest,spec_val(&pstack[pstack_top],sp_biggest));
    pstack_top--;
 
    break;
@@ -1601,6 +1478,7 @@ case p_pop3 :
 \*/
 
 case p_lcall :
+opcode_label(p_lcall)
 
 {
 
@@ -1610,18 +1488,21 @@ case p_lcall :
 
    /* at this point we expect to find a procedure */
 
-   if (left->sp_form != ft_proc)
+   if (spec_form(left) != ft_proc)
       abend(SETL_SYSTEM msg_expected_proc,
             abend_opnd_str(SETL_SYSTEM left));
 
+   ex_can_wait = YES;
    call_procedure(SETL_SYSTEM ip->i_operand[0].i_spec_ptr,
                   left,
                   NULL,
                   ip->i_operand[2].i_integer,NO,YES,0);
+   ex_can_wait = NO;
 
    if ((WAIT_FLAG<0)&&(forever == NO))
       return WAIT_FLAG;
 
+   call_poll;
    break;
 
 }
@@ -1638,6 +1519,7 @@ case p_lcall :
 \*/
 
 case p_call :
+opcode_label(p_call)
 
 {
 
@@ -1647,16 +1529,19 @@ case p_call :
 
    /* at this point we expect to find a procedure */
 
-   if (left->sp_form != ft_proc) {
+   if (spec_form(left) != ft_proc) {
       abend(SETL_SYSTEM msg_expected_proc,
             abend_opnd_str(SETL_SYSTEM left));
    }
 
+   ex_can_wait = YES;
    call_procedure(SETL_SYSTEM ip->i_operand[0].i_spec_ptr,
                   left,
                   NULL,
                   ip->i_operand[2].i_integer,NO,NO,0);
+   ex_can_wait = NO;
 
+   call_poll;
    break;
 
 }
@@ -1677,6 +1562,7 @@ case p_call :
 \*/
 
 case p_return :
+opcode_label(p_return)
 
 {
 
@@ -1686,8 +1572,8 @@ case p_return :
 
    /* save the result in spare */
 
-   spare.sp_form = target->sp_form;
-   spare.sp_val.sp_biggest = target->sp_val.sp_biggest;
+   spec_set_form(&spare,spec_form(target));
+   spec_set_val(&spare,sp_biggest,spec_val(target,sp_biggest));
    mark_specifier(&spare);
 
    /* save the new pstack pointer */
@@ -1788,9 +1674,9 @@ case p_return :
             object_work_hdr->o_child[target_index].o_cell = object_cell;
          }
          target_element = slot_info->si_spec;
-         object_cell->o_spec.sp_form = target_element->sp_form;
-         object_cell->o_spec.sp_val.sp_biggest =
-            target_element->sp_val.sp_biggest;
+         spec_set_form(&object_cell->o_spec,spec_form(target_element));
+         spec_set_val(&object_cell->o_spec,sp_biggest,
+            spec_val(target_element,sp_biggest));
 
          /*
           *  We move back up the header tree at this point, if it is
@@ -1897,9 +1783,9 @@ case p_return :
                object_work_hdr->o_child[target_index].o_cell = object_cell;
             }
             target_element = slot_info->si_spec;
-            object_cell->o_spec.sp_form = target_element->sp_form;
-            object_cell->o_spec.sp_val.sp_biggest =
-               target_element->sp_val.sp_biggest;
+            spec_set_form(&object_cell->o_spec,spec_form(target_element));
+            spec_set_val(&object_cell->o_spec,sp_biggest,
+               spec_val(target_element,sp_biggest));
             if (self_target != NULL) {
                spec_hash_code(object_cell->o_hash_code,target_element);
                object_root->o_hash_code ^= object_cell->o_hash_code;
@@ -1965,9 +1851,9 @@ case p_return :
             target_index = target_number & OBJ_SHIFT_MASK;
             object_cell = object_work_hdr->o_child[target_index].o_cell;
             target_element = slot_info->si_spec;
-            target_element->sp_form = object_cell->o_spec.sp_form;
-            target_element->sp_val.sp_biggest =
-               object_cell->o_spec.sp_val.sp_biggest;
+            spec_set_form(target_element,spec_form(&object_cell->o_spec));
+            spec_set_val(target_element,sp_biggest,
+               spec_val(&object_cell->o_spec,sp_biggest));
 
             /*
              *  We move back up the header tree at this point, if it is
@@ -2012,8 +1898,8 @@ case p_return :
               arg_ptr < proc_ptr->p_spec_ptr + proc_ptr->p_spec_count;
               arg_ptr++, stack_ptr++) {
 
-            stack_ptr->sp_form = arg_ptr->sp_form;
-            stack_ptr->sp_val.sp_biggest = arg_ptr->sp_val.sp_biggest;
+            spec_set_form(stack_ptr,spec_form(arg_ptr));
+            spec_set_val(stack_ptr,sp_biggest,spec_val(arg_ptr,sp_biggest));
             mark_specifier(stack_ptr);
 
          }
@@ -2040,8 +1926,8 @@ case p_return :
            arg_ptr++, stack_pos++) {
 
          unmark_specifier(arg_ptr);
-         arg_ptr->sp_form = stack_pos->sp_form;
-         arg_ptr->sp_val.sp_biggest = stack_pos->sp_val.sp_biggest;
+         spec_set_form(arg_ptr,spec_form(stack_pos));
+         spec_set_val(arg_ptr,sp_biggest,spec_val(stack_pos,sp_biggest));
 
       }
 
@@ -2056,8 +1942,8 @@ case p_return :
       if (self_target != NULL) {
 
          unmark_specifier(self_target);
-         self_target->sp_form = ft_object;
-         self_target->sp_val.sp_object_ptr = self_root;
+         spec_set_form(self_target,ft_object);
+         spec_set_val(self_target,sp_object_ptr,self_root);
 
       }
       else if (self_root != NULL) {
@@ -2092,7 +1978,7 @@ case p_return :
            arg_ptr++) {
 
          unmark_specifier(arg_ptr);
-         arg_ptr->sp_form = ft_omega;
+         spec_set_form(arg_ptr,ft_omega);
 
       }
    }
@@ -2130,7 +2016,7 @@ case p_return :
                    (void *)&spare1,
                    sizeof(struct specifier_item));
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
 
          }
 
@@ -2146,16 +2032,16 @@ case p_return :
       if (cstack[cstack_top].cs_return_value != NULL) {
 
          unmark_specifier(cstack[cstack_top].cs_return_value);
-         cstack[cstack_top].cs_return_value->sp_form = spare.sp_form;
-         cstack[cstack_top].cs_return_value->sp_val.sp_biggest =
-            spare.sp_val.sp_biggest;
+         spec_set_form(cstack[cstack_top].cs_return_value,spec_form(&spare));
+         spec_set_val(cstack[cstack_top].cs_return_value,sp_biggest,
+            spec_val(&spare,sp_biggest));
 
       }
       else {
          unmark_specifier(&spare);
       }
 
-      spare.sp_form = ft_omega;
+      spec_set_form(&spare,ft_omega);
 
    }
    else {
@@ -2175,14 +2061,15 @@ case p_return :
          mailbox_ptr->mb_cell_count++;
 
          mailbox_cell->mb_next = NULL;
-         mailbox_cell->mb_spec.sp_form = spare.sp_form;
-         mailbox_cell->mb_spec.sp_val.sp_biggest = spare.sp_val.sp_biggest;
+         spec_set_form(&mailbox_cell->mb_spec,spec_form(&spare));
+         spec_set_val(&mailbox_cell->mb_spec,sp_biggest,
+                      spec_val(&spare,sp_biggest));
  
       }
       else {
          unmark_specifier(&spare);
       }
-      spare.sp_form = ft_omega;
+      spec_set_form(&spare,ft_omega);
 
       /* remove the request record */
 
@@ -2217,8 +2104,10 @@ case p_return :
 
    /* if we should return from C, do it */
 
-   if (cstack[cstack_top + 1].cs_C_return==0)
+   if (cstack[cstack_top + 1].cs_C_return==0) {
+      call_poll;
       break;
+   }
 
    if (cstack[cstack_top + 1].cs_C_return==1)
       return 0; /* End the execution of the current program */
@@ -2239,8 +2128,8 @@ case p_return :
 
                mark_specifier(left);
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
 
@@ -2252,13 +2141,13 @@ case p_return :
 
                /* now we have the real base set */
 
-               switch (spare1.sp_form) {
+               switch (spec_form(&spare1)) {
 
                   case ft_set :
 
                      start_set_iterator(SETL_SYSTEM target,&spare1);
                      unmark_specifier(&spare1);
-                     spare1.sp_form = ft_omega;
+                     spec_set_form(&spare1,ft_omega);
 
                      break;
 
@@ -2266,7 +2155,7 @@ case p_return :
 
                      start_map_iterator(SETL_SYSTEM target,&spare1);
                      unmark_specifier(&spare1);
-                     spare1.sp_form = ft_omega;
+                     spec_set_form(&spare1,ft_omega);
 
                      break;
 
@@ -2274,7 +2163,7 @@ case p_return :
 
                      start_tuple_iterator(SETL_SYSTEM target,&spare1);
                      unmark_specifier(&spare1);
-                     spare1.sp_form = ft_omega;
+                     spec_set_form(&spare1,ft_omega);
 
                      break;
 
@@ -2282,7 +2171,7 @@ case p_return :
 
                      start_string_iterator(SETL_SYSTEM target,&spare1);
                      unmark_specifier(&spare1);
-                     spare1.sp_form = ft_omega;
+                     spec_set_form(&spare1,ft_omega);
 
                      break;
 
@@ -2290,7 +2179,7 @@ case p_return :
 
                      start_object_iterator(SETL_SYSTEM target,&spare1);
                      unmark_specifier(&spare1);
-                     spare1.sp_form = ft_omega;
+                     spec_set_form(&spare1,ft_omega);
 
                      break;
 
@@ -2311,18 +2200,19 @@ case p_return :
          case 3:
                /* set the condition based on the return value */
 
-               if (spare1.sp_form != ft_atom)
+               if (spec_form(&spare1) != ft_atom)
                   abend(SETL_SYSTEM "Return value from < method must be true or false");
 
-               if (spare1.sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num)
+               if (spec_val(&spare1,sp_atom_num) ==
+                   spec_val(spec_true,sp_atom_num))
                   condition_true = YES;
-               else if (spare1.sp_val.sp_atom_num ==
-                        spec_false->sp_val.sp_atom_num)
+               else if (spec_val(&spare1,sp_atom_num) ==
+                        spec_val(spec_false,sp_atom_num))
                   condition_true = NO;
                else
                   abend(SETL_SYSTEM "Return value from < method must be true or false");
 
-               spare1.sp_form = ft_omega;
+               spec_set_form(&spare1,ft_omega);
 
                switch (ip->i_opcode) {
 
@@ -2347,15 +2237,17 @@ case p_return :
                   if (condition_true) {
 
                      unmark_specifier(target);
-                     target->sp_form = spec_true->sp_form;
-                     target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+                     spec_set_form(target,spec_form(spec_true));
+                     spec_set_val(target,sp_biggest,
+                                  spec_val(spec_true,sp_biggest));
 
                   }
                   else {
 
                      unmark_specifier(target);
-                     target->sp_form = spec_false->sp_form;
-                     target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+                     spec_set_form(target,spec_form(spec_false));
+                     spec_set_val(target,sp_biggest,
+                                  spec_val(spec_false,sp_biggest));
 
                   }
 
@@ -2368,15 +2260,17 @@ case p_return :
                   if (!condition_true) {
 
                      unmark_specifier(target);
-                     target->sp_form = spec_true->sp_form;
-                     target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+                     spec_set_form(target,spec_form(spec_true));
+                     spec_set_val(target,sp_biggest,
+                                  spec_val(spec_true,sp_biggest));
 
                   }
                   else {
 
                      unmark_specifier(target);
-                     target->sp_form = spec_false->sp_form;
-                     target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+                     spec_set_form(target,spec_form(spec_false));
+                     spec_set_val(target,sp_biggest,
+                                  spec_val(spec_false,sp_biggest));
 
                   }
 
@@ -2402,15 +2296,17 @@ case p_return :
                   if (condition_true) {
 
                      unmark_specifier(target);
-                     target->sp_form = spec_true->sp_form;
-                     target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+                     spec_set_form(target,spec_form(spec_true));
+                     spec_set_val(target,sp_biggest,
+                                  spec_val(spec_true,sp_biggest));
 
                   }
                   else {
 
                      unmark_specifier(target);
-                     target->sp_form = spec_false->sp_form;
-                     target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+                     spec_set_form(target,spec_form(spec_false));
+                     spec_set_val(target,sp_biggest,
+                                  spec_val(spec_false,sp_biggest));
 
                   }
 
@@ -2423,15 +2319,17 @@ case p_return :
                   if (!condition_true) {
 
                      unmark_specifier(target);
-                     target->sp_form = spec_true->sp_form;
-                     target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+                     spec_set_form(target,spec_form(spec_true));
+                     spec_set_val(target,sp_biggest,
+                                  spec_val(spec_true,sp_biggest));
 
                   }
                   else {
 
                      unmark_specifier(target);
-                     target->sp_form = spec_false->sp_form;
-                     target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+                     spec_set_form(target,spec_form(spec_false));
+                     spec_set_val(target,sp_biggest,
+                                  spec_val(spec_false,sp_biggest));
 
                   }
 
@@ -2444,17 +2342,19 @@ case p_return :
          case 4:
                /* set the condition based on the return value */
 
-               if (spare1.sp_form != ft_atom)
+               if (spec_form(&spare1) != ft_atom)
                   abend(SETL_SYSTEM "Return value from IN method must be true or false");
       
-               if (spare1.sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num)
+               if (spec_val(&spare1,sp_atom_num) ==
+                   spec_val(spec_true,sp_atom_num))
                   condition_true = YES;
-               else if (spare1.sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num)
+               else if (spec_val(&spare1,sp_atom_num) ==
+                        spec_val(spec_false,sp_atom_num))
                   condition_true = NO;
                else
                   abend(SETL_SYSTEM "Return value from IN method must be true or false");
 
-               spare1.sp_form = ft_omega;
+               spec_set_form(&spare1,ft_omega);
 
                switch (ip->i_opcode) {
 
@@ -2479,15 +2379,17 @@ case p_return :
                      if (condition_true) {
 
                         unmark_specifier(target);
-                        target->sp_form = spec_true->sp_form;
-                        target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+                        spec_set_form(target,spec_form(spec_true));
+                        spec_set_val(target,sp_biggest,
+                                     spec_val(spec_true,sp_biggest));
 
                      }
                      else {
 
                         unmark_specifier(target);
-                        target->sp_form = spec_false->sp_form;
-                        target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+                        spec_set_form(target,spec_form(spec_false));
+                        spec_set_val(target,sp_biggest,
+                                     spec_val(spec_false,sp_biggest));
 
                      }
 
@@ -2500,15 +2402,17 @@ case p_return :
                      if (!condition_true) {
 
                         unmark_specifier(target);
-                        target->sp_form = spec_true->sp_form;
-                        target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+                        spec_set_form(target,spec_form(spec_true));
+                        spec_set_val(target,sp_biggest,
+                                     spec_val(spec_true,sp_biggest));
 
                      }
                      else {
 
                         unmark_specifier(target);
-                        target->sp_form = spec_false->sp_form;
-                        target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+                        spec_set_form(target,spec_form(spec_false));
+                        spec_set_val(target,sp_biggest,
+                                     spec_val(spec_false,sp_biggest));
 
                      }
 
@@ -2525,6 +2429,7 @@ case p_return :
       }
    }
 
+   call_poll;
    break;
 
 }
@@ -2540,6 +2445,7 @@ case p_return :
 \*/
 
 case p_penviron :
+opcode_label(p_penviron)
 
 {
 
@@ -2550,7 +2456,7 @@ case p_penviron :
 
    /* we copy the procedure */
 
-   proc_ptr = left->sp_val.sp_proc_ptr;
+   proc_ptr = spec_val(left,sp_proc_ptr);
    get_proc(new_proc_ptr);
    memcpy((void *)new_proc_ptr,
           (void *)proc_ptr,
@@ -2565,8 +2471,8 @@ case p_penviron :
    /* set the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_proc;
-   target->sp_val.sp_proc_ptr = new_proc_ptr;
+   spec_set_form(target,ft_proc);
+   spec_set_val(target,sp_proc_ptr,new_proc_ptr);
 
    /* copy enclosing procedures */
 
@@ -2641,6 +2547,7 @@ case p_penviron :
 \*/
 
 case p_stop :
+opcode_label(p_stop)
 
    /* decrement the call stack until we find a null program counter */
 
@@ -2653,6 +2560,8 @@ case p_stop :
    if (cstack_top < -1)
       cstack_top = -1;
 
+   free_drain(SETL_SYSTEM YES);
+
    abend_initialized=0;
    return NO;
 
@@ -2667,6 +2576,7 @@ case p_stop :
 \*/
 
 case p_stopall :
+opcode_label(p_stopall)
    hard_stop=1;
    if (abend_initialized)
           longjmp(abend_env,1);
@@ -2688,6 +2598,7 @@ case p_stopall :
 \*/
 
 case p_assert :
+opcode_label(p_assert)
 
 {
 
@@ -2700,33 +2611,25 @@ case p_assert :
 
    if (ASSERT_MODE == ASSERT_FAIL) {
 
-      if (target->sp_form != ft_atom)
+      if (spec_form(target) != ft_atom)
          abend(SETL_SYSTEM msg_bad_assert_arg,
                abend_opnd_str(SETL_SYSTEM target));
 
-      if (target->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num)
+      if (spec_val(target,sp_atom_num) == spec_val(spec_true,sp_atom_num))
          break;
 
-      if (target->sp_val.sp_atom_num != spec_false->sp_val.sp_atom_num)
+      if (spec_val(target,sp_atom_num) != spec_val(spec_false,sp_atom_num))
          abend(SETL_SYSTEM msg_bad_assert_arg,
                abend_opnd_str(SETL_SYSTEM target));
 
       /* at this point an assertion has failed */
 
       fputs("Assert failed in ",stderr);
-      left_string_hdr = left->sp_val.sp_string_ptr;
-      left_string_length = left_string_hdr->s_length;
-      for (left_string_cell = left_string_hdr->s_head;
-           left_string_cell != NULL;
-           left_string_cell = left_string_cell->s_next) {
-
-         for (left_char_ptr = left_string_cell->s_cell_value;
-              left_string_length-- &&
-                    left_char_ptr <
-                       left_string_cell->s_cell_value + STR_CELL_WIDTH;
-              fputc(*left_char_ptr++,stderr));
-
-      }
+      left_string_hdr = spec_val(left,sp_string_ptr);
+      fwrite((void *)left_string_hdr->s_chars,
+             (size_t)1,
+             (size_t)left_string_hdr->s_length,
+             stderr);
 
       fprintf(stderr," line %ld\n",ip->i_operand[2].i_integer);
 
@@ -2738,33 +2641,25 @@ case p_assert :
 
    else if (ASSERT_MODE == ASSERT_LOG) {
 
-      if (target->sp_form != ft_atom)
+      if (spec_form(target) != ft_atom)
          abend(SETL_SYSTEM msg_bad_assert_arg,
                abend_opnd_str(SETL_SYSTEM target));
 
-      if (target->sp_val.sp_atom_num != spec_false->sp_val.sp_atom_num &&
-          target->sp_val.sp_atom_num != spec_true->sp_val.sp_atom_num)
+      if (spec_val(target,sp_atom_num) != spec_val(spec_false,sp_atom_num) &&
+          spec_val(target,sp_atom_num) != spec_val(spec_true,sp_atom_num))
          abend(SETL_SYSTEM msg_bad_assert_arg,
                abend_opnd_str(SETL_SYSTEM target));
 
-      if (target->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num)
+      if (spec_val(target,sp_atom_num) == spec_val(spec_true,sp_atom_num))
          fputs(msg_assert_passed,stderr);
       else
          fputs("Assert failed in ",stderr);
 
-      left_string_hdr = left->sp_val.sp_string_ptr;
-      left_string_length = left_string_hdr->s_length;
-      for (left_string_cell = left_string_hdr->s_head;
-           left_string_cell != NULL;
-           left_string_cell = left_string_cell->s_next) {
-
-         for (left_char_ptr = left_string_cell->s_cell_value;
-              left_string_length-- &&
-                    left_char_ptr <
-                       left_string_cell->s_cell_value + STR_CELL_WIDTH;
-              fputc(*left_char_ptr++,stderr));
-
-      }
+      left_string_hdr = spec_val(left,sp_string_ptr);
+      fwrite((void *)left_string_hdr->s_chars,
+             (size_t)1,
+             (size_t)left_string_hdr->s_length,
+             stderr);
 
       fprintf(stderr," line %ld\n",ip->i_operand[2].i_integer);
 
@@ -2785,12 +2680,13 @@ case p_assert :
 \*/
 
 case p_intcheck :
+opcode_label(p_intcheck)
 
    for (i = 0;
         i < 3 && (left = ip->i_operand[i].i_spec_ptr) != NULL;
         i++) {
 
-      if (left->sp_form != ft_short && left->sp_form != ft_long)
+      if (spec_form(left) != ft_short && spec_form(left) != ft_long)
          abend(SETL_SYSTEM msg_expected_integer,
                abend_opnd_str(SETL_SYSTEM left));
 
@@ -3107,6 +3003,7 @@ PRTYPE void arith_ops1(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_add :
+opcode_label(p_add)
 
 {
 specifier spareplus;                       /* spare specifier                   */
@@ -3121,7 +3018,7 @@ specifier spareplus;                       /* spare specifier
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can add short integers to other short integers or to long
@@ -3136,27 +3033,23 @@ specifier spareplus;                       /* spare specifier
           *  value of a short, convert the result to a long integer.
           */
 
-         if (right->sp_form == ft_short) {
-
-            short_value = left->sp_val.sp_short_value +
-                          right->sp_val.sp_short_value;
-
-            /* check whether the sum remains short */
+         if (spec_form(right) == ft_short) {
 
-            if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-                short_hi_bits == INT_HIGH_BITS) {
+            if (short_add(short_value,
+                          spec_val(left,sp_short_value),
+                          spec_val(right,sp_short_value))) {
 
                unmark_specifier(target);
-               target->sp_form = ft_short;
-               target->sp_val.sp_short_value = short_value;
+               spec_set_form(target,ft_short);
+               spec_set_val(target,sp_short_value,short_value);
 
                break;
 
             }
 
-            /* if we exceed the maximum short, convert to long */
+            /* if we exceed the maximum short, use long integers */
 
-            short_to_long(SETL_SYSTEM target,short_value);
+            integer_add(SETL_SYSTEM target,left,right);
 
             break;
 
@@ -3167,16 +3060,16 @@ specifier spareplus;                       /* spare specifier
           *  case in which the right operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             integer_add(SETL_SYSTEM target,left,right);
 
             break;
 
-         } else if (right->sp_form == ft_real) {
+         } else if (spec_form(right) == ft_real) {
          
-         	real_number = left->sp_val.sp_short_value +
-         	              (right->sp_val.sp_real_ptr)->r_value;
+         	real_number = spec_val(left,sp_short_value) +
+         	              spec_val(right,sp_real_value);
          	
          	goto real_add;
 
@@ -3187,7 +3080,7 @@ specifier spareplus;                       /* spare specifier
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3223,7 +3116,7 @@ specifier spareplus;                       /* spare specifier
           *  general function which adds any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             integer_add(SETL_SYSTEM target,left,right);
 
@@ -3236,7 +3129,7 @@ specifier spareplus;                       /* spare specifier
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3270,7 +3163,7 @@ specifier spareplus;                       /* spare specifier
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3282,10 +3175,10 @@ specifier spareplus;                       /* spare specifier
 
          }
        
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
-            real_number = (left->sp_val.sp_real_ptr)->r_value +
-                          (right->sp_val.sp_real_ptr)->r_value;
+            real_number = spec_val(left,sp_real_value) +
+                          spec_val(right,sp_real_value);
 real_add:
 #if INFNAN
 
@@ -3294,25 +3187,22 @@ real_add:
 
 #endif
 
-            /* allocate a real */
+            /* set the target */
 
             unmark_specifier(target);
-            i_get_real(real_ptr);
-            target->sp_form = ft_real;
-            target->sp_val.sp_real_ptr = real_ptr;
-            real_ptr->r_use_count = 1;
-            real_ptr->r_value = real_number;
+            spec_set_form(target,ft_real);
+            spec_set_val(target,sp_real_value,real_number);
 
             break;
 
          }
- 		 if (right->sp_form == ft_short) {
-				real_number = (left->sp_val.sp_real_ptr)->r_value+
-						(double)(right->sp_val.sp_short_value);
+ 		 if (spec_form(right) == ft_short) {
+				real_number = spec_val(left,sp_real_value)+
+						(double)(spec_val(right,sp_short_value));
 				goto real_add;
 		 }
-		  if (right->sp_form == ft_long) {
-				real_number = (left->sp_val.sp_real_ptr)->r_value+
+		  if (spec_form(right) == ft_long) {
+				real_number = spec_val(left,sp_real_value)+
 						(double)(long_to_double(SETL_SYSTEM right));
 				goto real_add;
 		 }
@@ -3336,7 +3226,7 @@ real_add:
           *  objects on the right.
           */
 
-        if (right->sp_form == ft_object) {
+        if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3349,7 +3239,7 @@ real_add:
          }
 
 
-         if (right->sp_form == ft_omega) {
+         if (spec_form(right) == ft_omega) {
 
             binop_abend(SETL_SYSTEM msg_bad_binop_forms,"+",
                   abend_opnd_str(SETL_SYSTEM left),
@@ -3359,9 +3249,9 @@ real_add:
 
          }
          
-         spareplus.sp_form = ft_omega;
+         spec_set_form(&spareplus,ft_omega);
          
-         if (right->sp_form != ft_string) {
+         if (spec_form(right) != ft_string) {
          		/* convert to string */
 		
 				setl2_str(SETL_SYSTEM 1L,right,&spareplus);
@@ -3369,105 +3259,63 @@ real_add:
 
 		 }
 
-         if (right->sp_form == ft_string) {
-
-            /* we would like to use the left operand destructively */
-
-            if (target == left && target != right &&
-                (target->sp_val.sp_string_ptr)->s_use_count == 1) {
-
-               target_string_hdr = target->sp_val.sp_string_ptr;
-               target->sp_form = ft_omega;
-
-            }
-            else {
-
-               target_string_hdr = copy_string(SETL_SYSTEM left->sp_val.sp_string_ptr);
-
-            }
-
-            right_string_hdr = right->sp_val.sp_string_ptr;
-
-            /* we just attach the right string to the target */
-
-            target_string_cell = target_string_hdr->s_tail;
-            right_string_cell = right_string_hdr->s_head;
+         if (spec_form(right) == ft_string) {
 
-            /* set up cell limit pointers */
-
-            if (target_string_cell == NULL) {
-
-               target_char_ptr = target_char_end = NULL;
-
-            }
-            else {
+            right_string_hdr = spec_val(right,sp_string_ptr);
+            right_string_length = right_string_hdr->s_length;
 
-               target_char_ptr = target_string_cell->s_cell_value +
-                              (target_string_hdr->s_length % STR_CELL_WIDTH);
-               target_char_end = target_string_cell->s_cell_value +
-                                 STR_CELL_WIDTH;
-               if (target_char_ptr == target_string_cell->s_cell_value)
-                  target_char_ptr = target_char_end;
+            /*
+             *  We would like to use the left operand destructively.  We
+             *  can if nothing else refers to it, and it is either the
+             *  target or about to be overwritten with our result.  In
+             *  that case we append in place, and the string's capacity
+             *  doubles as it grows.
+             */
 
-            }
+            left_string_hdr = spec_val(left,sp_string_ptr);
 
-            if (right_string_cell == NULL) {
+            if (left_string_hdr->s_use_count == 1 &&
+                left != ip->i_operand[2].i_spec_ptr &&
+                (target == left || result_assigned_to(left,target))) {
 
-               right_char_ptr = right_char_end = NULL;
+               target_string_hdr = left_string_hdr;
+               spec_set_form(left,ft_omega);
+               reserve_string(target_string_hdr,
+                              target_string_hdr->s_length +
+                                 right_string_length);
 
             }
             else {
 
-               right_char_ptr = right_string_cell->s_cell_value;
-               right_char_end = right_char_ptr + STR_CELL_WIDTH;
+               target_string_hdr = new_string_buffer(SETL_SYSTEM
+                     left_string_hdr->s_length + right_string_length);
+               memcpy((void *)(target_string_hdr->s_chars),
+                      (void *)(left_string_hdr->s_chars),
+                      (size_t)(left_string_hdr->s_length));
+               target_string_hdr->s_length = left_string_hdr->s_length;
 
             }
 
-            /* loop over the right string attaching it to the target */
-
-            right_string_length = right_string_hdr->s_length;
-
-            while (right_string_length--) {
-
-               if (right_char_ptr == right_char_end) {
-
-                  right_string_cell = right_string_cell->s_next;
-                  right_char_ptr = right_string_cell->s_cell_value;
-                  right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-               }
-
-               if (target_char_ptr == target_char_end) {
-
-                  get_string_cell(target_string_cell);
-                  if (target_string_hdr->s_tail != NULL)
-                     (target_string_hdr->s_tail)->s_next = target_string_cell;
-                  target_string_cell->s_prev = target_string_hdr->s_tail;
-                  target_string_cell->s_next = NULL;
-                  target_string_hdr->s_tail = target_string_cell;
-                  if (target_string_hdr->s_head == NULL)
-                     target_string_hdr->s_head = target_string_cell;
-                  target_char_ptr = target_string_cell->s_cell_value;
-                  target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-               }
-
-               *target_char_ptr++ = *right_char_ptr++;
+            /* we just attach the right string to the target */
 
-            }
+            memcpy((void *)(target_string_hdr->s_chars +
+                            target_string_hdr->s_length),
+                   (void *)(right_string_hdr->s_chars),
+                   (size_t)right_string_length);
 
             /* note that we've killed the string's hash code */
 
-            target_string_hdr->s_length += right_string_hdr->s_length;
+            target_string_hdr->s_length += right_string_length;
+            target_string_hdr->s_chars[target_string_hdr->s_length] = '\0';
             target_string_hdr->s_hash_code = -1;
 
             /* assign our result to the target */
 
             unmark_specifier(target);
-            target->sp_form = ft_string;
-            target->sp_val.sp_string_ptr = target_string_hdr;
+            spec_set_form(target,ft_string);
+            spec_set_val(target,sp_string_ptr,target_string_hdr);
             
-            if (spareplus.sp_form!=ft_omega) /* implicit conversion done */
+            if (spec_form(&spareplus)!=ft_omega) /* implicit conversion done */
             
             	unmark_specifier(&spareplus);
 
@@ -3496,10 +3344,10 @@ real_add:
 
          /* if the right operand is a map, convert it */
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
-         if (right->sp_form == ft_set) {
+         if (spec_form(right) == ft_set) {
 
             set_union(SETL_SYSTEM target,left,right);
 
@@ -3512,7 +3360,7 @@ real_add:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3542,7 +3390,7 @@ real_add:
 
       case ft_tuple :
 
-         if (right->sp_form == ft_tuple) {
+         if (spec_form(right) == ft_tuple) {
 
             tuple_concat(SETL_SYSTEM target,left,right);
 
@@ -3555,7 +3403,7 @@ real_add:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3617,7 +3465,7 @@ real_add:
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3659,6 +3507,7 @@ real_add:
 \*/
 
 case p_sub :
+opcode_label(p_sub)
 
 {
 
@@ -3670,7 +3519,7 @@ case p_sub :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can subtract short integers with other short integers or
@@ -3685,27 +3534,23 @@ case p_sub :
           *  of a short, convert the result to a long integer.
           */
 
-         if (right->sp_form == ft_short) {
-
-            short_value = left->sp_val.sp_short_value -
-                          right->sp_val.sp_short_value;
+         if (spec_form(right) == ft_short) {
 
-            /* check whether the sum remains short */
-
-            if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-                short_hi_bits == INT_HIGH_BITS) {
+            if (short_subtract(short_value,
+                               spec_val(left,sp_short_value),
+                               spec_val(right,sp_short_value))) {
 
                unmark_specifier(target);
-               target->sp_form = ft_short;
-               target->sp_val.sp_short_value = short_value;
+               spec_set_form(target,ft_short);
+               spec_set_val(target,sp_short_value,short_value);
 
                break;
 
             }
 
-            /* if we exceed the maximum short, convert to long */
+            /* if we exceed the maximum short, use long integers */
 
-            short_to_long(SETL_SYSTEM target,short_value);
+            integer_subtract(SETL_SYSTEM target,left,right);
 
             break;
 
@@ -3716,16 +3561,16 @@ case p_sub :
           *  the case in which the right operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             integer_subtract(SETL_SYSTEM target,left,right);
 
             break;
 
-         } else if (right->sp_form == ft_real) {
+         } else if (spec_form(right) == ft_real) {
          
-         	real_number = left->sp_val.sp_short_value -
-         	              (right->sp_val.sp_real_ptr)->r_value;
+         	real_number = spec_val(left,sp_short_value) -
+         	              spec_val(right,sp_real_value);
          	
          	goto real_sub;
 
@@ -3736,7 +3581,7 @@ case p_sub :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3772,7 +3617,7 @@ case p_sub :
           *  general function which subtracts any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             integer_subtract(SETL_SYSTEM target,left,right);
 
@@ -3785,7 +3630,7 @@ case p_sub :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3818,10 +3663,10 @@ case p_sub :
 		
 
 
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
-            real_number = (left->sp_val.sp_real_ptr)->r_value -
-                          (right->sp_val.sp_real_ptr)->r_value;
+            real_number = spec_val(left,sp_real_value) -
+                          spec_val(right,sp_real_value);
                    
 real_sub:               
 
@@ -3832,25 +3677,22 @@ real_sub:
 
 #endif
 
-            /* allocate a real */
+            /* set the target */
 
             unmark_specifier(target);
-            i_get_real(real_ptr);
-            target->sp_form = ft_real;
-            target->sp_val.sp_real_ptr = real_ptr;
-            real_ptr->r_use_count = 1;
-            real_ptr->r_value = real_number;
+            spec_set_form(target,ft_real);
+            spec_set_val(target,sp_real_value,real_number);
 
             break;
 
          }
-		 else if (right->sp_form == ft_short) {
-			real_number = (left->sp_val.sp_real_ptr)->r_value-
-					(double)(right->sp_val.sp_short_value);
+		 else if (spec_form(right) == ft_short) {
+			real_number = spec_val(left,sp_real_value)-
+					(double)(spec_val(right,sp_short_value));
 			goto real_sub;
 		 } 
-		 else if (right->sp_form == ft_long) {
-			real_number = (left->sp_val.sp_real_ptr)->r_value-
+		 else if (spec_form(right) == ft_long) {
+			real_number = spec_val(left,sp_real_value)-
 					(double)(long_to_double(SETL_SYSTEM right));
 			goto real_sub;
 		 }
@@ -3859,7 +3701,7 @@ real_sub:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3895,12 +3737,12 @@ real_sub:
 
          /* if the right operand is a map, convert it */
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
          /* make sure the right hand side is another set */
 
-         if (right->sp_form == ft_set) {
+         if (spec_form(right) == ft_set) {
 
             set_difference(SETL_SYSTEM target,left,right);
 
@@ -3913,7 +3755,7 @@ real_sub:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -3964,7 +3806,7 @@ real_sub:
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4031,6 +3873,7 @@ PRTYPE void arith_ops2(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_mult :
+opcode_label(p_mult)
 
 {
 
@@ -4042,7 +3885,7 @@ case p_mult :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can multiply short integers with other short integers or
@@ -4057,27 +3900,23 @@ case p_mult :
           *  of a short, convert the result to a long integer.
           */
 
-         if (right->sp_form == ft_short) {
-
-            short_value = left->sp_val.sp_short_value *
-                          right->sp_val.sp_short_value;
-
-            /* check whether the sum remains short */
+         if (spec_form(right) == ft_short) {
 
-            if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-                short_hi_bits == INT_HIGH_BITS) {
+            if (short_multiply(short_value,
+                               spec_val(left,sp_short_value),
+                               spec_val(right,sp_short_value))) {
 
                unmark_specifier(target);
-               target->sp_form = ft_short;
-               target->sp_val.sp_short_value = short_value;
+               spec_set_form(target,ft_short);
+               spec_set_val(target,sp_short_value,short_value);
 
                break;
 
             }
 
-            /* if we exceed the maximum short, convert to long */
+            /* if we exceed the maximum short, use long integers */
 
-            short_to_long(SETL_SYSTEM target,short_value);
+            integer_multiply(SETL_SYSTEM target,left,right);
 
             break;
 
@@ -4088,16 +3927,16 @@ case p_mult :
           *  the case in which the right operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             integer_multiply(SETL_SYSTEM target,left,right);
 
             break;
 
-         }  else if (right->sp_form == ft_real) {
+         }  else if (spec_form(right) == ft_real) {
          
-         	real_number = left->sp_val.sp_short_value *
-         	              (right->sp_val.sp_real_ptr)->r_value;
+         	real_number = spec_val(left,sp_short_value) *
+         	              spec_val(right,sp_real_value);
          	
          	goto real_mul;
 
@@ -4108,16 +3947,17 @@ case p_mult :
           *  string.
           */
 
-         else if (right->sp_form == ft_string) {
+         else if (spec_form(right) == ft_string) {
 
-            if (left->sp_val.sp_short_value < 0) {
+            if (spec_val(left,sp_short_value) < 0) {
                binop_abend(SETL_SYSTEM msg_bad_binop_forms,"*",
                      abend_opnd_str(SETL_SYSTEM left),
                      abend_opnd_str(SETL_SYSTEM right));
                break;
             }
 
-            string_multiply(SETL_SYSTEM target,right,left->sp_val.sp_short_value);
+            string_multiply(SETL_SYSTEM target,right,
+                            spec_val(left,sp_short_value));
 
             break;
 
@@ -4128,16 +3968,17 @@ case p_mult :
           *  tuple.
           */
 
-         else if (right->sp_form == ft_tuple) {
+         else if (spec_form(right) == ft_tuple) {
 
-            if (left->sp_val.sp_short_value < 0) {
+            if (spec_val(left,sp_short_value) < 0) {
                binop_abend(SETL_SYSTEM msg_bad_binop_forms,"*",
                      abend_opnd_str(SETL_SYSTEM left),
                      abend_opnd_str(SETL_SYSTEM right));
                break;
             }
 
-            tuple_multiply(SETL_SYSTEM target,right,left->sp_val.sp_short_value);
+            tuple_multiply(SETL_SYSTEM target,right,
+                           spec_val(left,sp_short_value));
 
             break;
 
@@ -4148,7 +3989,7 @@ case p_mult :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4184,7 +4025,7 @@ case p_mult :
           *  general function which multiplies any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             integer_multiply(SETL_SYSTEM target,left,right);
 
@@ -4197,16 +4038,17 @@ case p_mult :
           *  string.
           */
 
-         else if (right->sp_form == ft_string) {
+         else if (spec_form(right) == ft_string) {
 
-            if ((left->sp_val.sp_long_ptr)->i_is_negative < 0) {
+            if (spec_val(left,sp_long_ptr)->i_is_negative < 0) {
                binop_abend(SETL_SYSTEM msg_bad_binop_forms,"*",
                      abend_opnd_str(SETL_SYSTEM left),
                      abend_opnd_str(SETL_SYSTEM right));
                break;
             }
 
-            short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
 
             string_multiply(SETL_SYSTEM target,right,short_value);
 
@@ -4219,16 +4061,17 @@ case p_mult :
           *  tuple.
           */
 
-         else if (right->sp_form == ft_tuple) {
+         else if (spec_form(right) == ft_tuple) {
 
-            if ((left->sp_val.sp_long_ptr)->i_is_negative < 0) {
+            if (spec_val(left,sp_long_ptr)->i_is_negative < 0) {
                binop_abend(SETL_SYSTEM msg_bad_binop_forms,"*",
                      abend_opnd_str(SETL_SYSTEM left),
                      abend_opnd_str(SETL_SYSTEM right));
                break;
             }
 
-            short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
 
             tuple_multiply(SETL_SYSTEM target,right,short_value);
 
@@ -4241,7 +4084,7 @@ case p_mult :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4271,10 +4114,10 @@ case p_mult :
 
       case ft_real :
 
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
-            real_number = (left->sp_val.sp_real_ptr)->r_value *
-                          (right->sp_val.sp_real_ptr)->r_value;
+            real_number = spec_val(left,sp_real_value) *
+                          spec_val(right,sp_real_value);
                           
 real_mul:
 
@@ -4285,25 +4128,22 @@ real_mul:
 
 #endif
 
-            /* allocate a real */
+            /* set the target */
 
             unmark_specifier(target);
-            i_get_real(real_ptr);
-            target->sp_form = ft_real;
-            target->sp_val.sp_real_ptr = real_ptr;
-            real_ptr->r_use_count = 1;
-            real_ptr->r_value = real_number;
+            spec_set_form(target,ft_real);
+            spec_set_val(target,sp_real_value,real_number);
 
             break;
 
          }
- 		 else if (right->sp_form == ft_short) {
-			real_number = (left->sp_val.sp_real_ptr)->r_value*
-					(double)(right->sp_val.sp_short_value);
+ 		 else if (spec_form(right) == ft_short) {
+			real_number = spec_val(left,sp_real_value)*
+					(double)(spec_val(right,sp_short_value));
 			goto real_mul;
 		 } 
-		 else if (right->sp_form == ft_long) {
-			real_number = (left->sp_val.sp_real_ptr)->r_value*
+		 else if (spec_form(right) == ft_long) {
+			real_number = spec_val(left,sp_real_value)*
 					(double)(long_to_double(SETL_SYSTEM right));
 			goto real_mul;
 		 }
@@ -4312,7 +4152,7 @@ real_mul:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4346,17 +4186,18 @@ real_mul:
           *  We have to convert the right operand to a C long.
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            short_value = right->sp_val.sp_short_value;
+            short_value = spec_val(right,sp_short_value);
             string_multiply(SETL_SYSTEM target,left,short_value);
 
             break;
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            short_value = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
             string_multiply(SETL_SYSTEM target,left,short_value);
 
             break;
@@ -4368,7 +4209,7 @@ real_mul:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4404,12 +4245,12 @@ real_mul:
 
          /* if the right operand is a map, convert it */
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
          /* make sure the right hand side is another set */
 
-         if (right->sp_form == ft_set) {
+         if (spec_form(right) == ft_set) {
 
             set_intersection(SETL_SYSTEM target,left,right);
 
@@ -4422,7 +4263,7 @@ real_mul:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4456,16 +4297,18 @@ real_mul:
           *  We have to convert the right operand to a C long.
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            tuple_multiply(SETL_SYSTEM target,left,right->sp_val.sp_short_value);
+            tuple_multiply(SETL_SYSTEM target,left,
+                           spec_val(right,sp_short_value));
 
             break;
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            short_value = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
 
             tuple_multiply(SETL_SYSTEM target,left,short_value);
 
@@ -4478,7 +4321,7 @@ real_mul:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4529,7 +4372,7 @@ real_mul:
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4570,6 +4413,7 @@ real_mul:
 \*/
 
 case p_div :
+opcode_label(p_div)
 
 {
 
@@ -4581,7 +4425,7 @@ case p_div :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can divide short integers with other short integers or
@@ -4596,22 +4440,21 @@ case p_div :
           *  of a short, convert the result to a long integer.
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            if (right->sp_val.sp_short_value == 0)
+            if (spec_val(right,sp_short_value) == 0)
                abend(SETL_SYSTEM msg_zero_divide);
 
-            short_value = left->sp_val.sp_short_value /
-                          right->sp_val.sp_short_value;
+            short_value = spec_val(left,sp_short_value) /
+                          spec_val(right,sp_short_value);
 
             /* check whether the sum remains short */
 
-            if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-                short_hi_bits == INT_HIGH_BITS) {
+            if (is_short_value(short_value)) {
 
                unmark_specifier(target);
-               target->sp_form = ft_short;
-               target->sp_val.sp_short_value = short_value;
+               spec_set_form(target,ft_short);
+               spec_set_val(target,sp_short_value,short_value);
 
                break;
 
@@ -4630,16 +4473,16 @@ case p_div :
           *  the case in which the right operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             integer_divide(SETL_SYSTEM target,left,right);
 
             break;
 
-         } else if (right->sp_form == ft_real) {
+         } else if (spec_form(right) == ft_real) {
          
-         	real_number = (double)(left->sp_val.sp_short_value) /
-         	              (right->sp_val.sp_real_ptr)->r_value;
+         	real_number = (double)(spec_val(left,sp_short_value)) /
+         	              spec_val(right,sp_real_value);
          	
          	goto real_div;
 
@@ -4650,7 +4493,7 @@ case p_div :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4686,7 +4529,7 @@ case p_div :
           *  general function which divides any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             integer_divide(SETL_SYSTEM target,left,right);
 
@@ -4699,7 +4542,7 @@ case p_div :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4729,10 +4572,10 @@ case p_div :
 
       case ft_real :
 
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
-            real_number = (left->sp_val.sp_real_ptr)->r_value /
-                          (right->sp_val.sp_real_ptr)->r_value;
+            real_number = spec_val(left,sp_real_value) /
+                          spec_val(right,sp_real_value);
 
 real_div:
 
@@ -4743,25 +4586,22 @@ real_div:
 
 #endif
 
-            /* allocate a real */
+            /* set the target */
 
             unmark_specifier(target);
-            i_get_real(real_ptr);
-            target->sp_form = ft_real;
-            target->sp_val.sp_real_ptr = real_ptr;
-            real_ptr->r_use_count = 1;
-            real_ptr->r_value = real_number;
+            spec_set_form(target,ft_real);
+            spec_set_val(target,sp_real_value,real_number);
 
             break;
 
          }
-         else if (right->sp_form == ft_short) {
-			real_number = (left->sp_val.sp_real_ptr)->r_value /
-					(double)(right->sp_val.sp_short_value);
+         else if (spec_form(right) == ft_short) {
+			real_number = spec_val(left,sp_real_value) /
+					(double)(spec_val(right,sp_short_value));
 			goto real_div;
 		 } 
-		 else if (right->sp_form == ft_long) {
-			real_number = (left->sp_val.sp_real_ptr)->r_value /
+		 else if (spec_form(right) == ft_long) {
+			real_number = spec_val(left,sp_real_value) /
 					(double)(long_to_double(SETL_SYSTEM right));
 			goto real_div;
 		 }
@@ -4771,7 +4611,7 @@ real_div:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4822,7 +4662,7 @@ real_div:
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4889,6 +4729,7 @@ PRTYPE void arith_ops3(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_exp :
+opcode_label(p_exp)
 
 {
 
@@ -4900,7 +4741,7 @@ case p_exp :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can produce powers of short integers with other short
@@ -4914,7 +4755,7 @@ case p_exp :
           *  general function which finds powers of any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             integer_power(SETL_SYSTEM target,left,right);
 
@@ -4927,7 +4768,7 @@ case p_exp :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -4937,9 +4778,9 @@ case p_exp :
 
             break;
 
-         } else if (right->sp_form == ft_real) {
-			real_number = pow((double)(left->sp_val.sp_short_value),
-							  (right->sp_val.sp_real_ptr)->r_value);
+         } else if (spec_form(right) == ft_real) {
+			real_number = pow((double)(spec_val(left,sp_short_value)),
+							  spec_val(right,sp_real_value));
 							  
 			goto real_pow;
 		 } 
@@ -4962,10 +4803,10 @@ case p_exp :
 
       case ft_real :
 
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
-            real_number = pow((left->sp_val.sp_real_ptr)->r_value,
-                              (right->sp_val.sp_real_ptr)->r_value);
+            real_number = pow(spec_val(left,sp_real_value),
+                              spec_val(right,sp_real_value));
 
 real_pow:
 #if INFNAN
@@ -4975,25 +4816,22 @@ real_pow:
 
 #endif
 
-            /* allocate a real */
+            /* set the target */
 
             unmark_specifier(target);
-            i_get_real(real_ptr);
-            target->sp_form = ft_real;
-            target->sp_val.sp_real_ptr = real_ptr;
-            real_ptr->r_use_count = 1;
-            real_ptr->r_value = real_number;
+            spec_set_form(target,ft_real);
+            spec_set_val(target,sp_real_value,real_number);
 
             break;
 
          }
-         else if (right->sp_form == ft_short) {
-			real_number = pow((left->sp_val.sp_real_ptr)->r_value,
-					(double)(right->sp_val.sp_short_value));
+         else if (spec_form(right) == ft_short) {
+			real_number = pow(spec_val(left,sp_real_value),
+					(double)(spec_val(right,sp_short_value)));
 			goto real_pow;
 		 } 
-		 else if (right->sp_form == ft_long) {
-			real_number = pow((left->sp_val.sp_real_ptr)->r_value,
+		 else if (spec_form(right) == ft_long) {
+			real_number = pow(spec_val(left,sp_real_value),
 					(double)(long_to_double(SETL_SYSTEM right)));
 			goto real_pow;
 		 }
@@ -5003,7 +4841,7 @@ real_pow:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5054,7 +4892,7 @@ real_pow:
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5095,6 +4933,7 @@ real_pow:
 \*/
 
 case p_mod :
+opcode_label(p_mod)
 
 {
 
@@ -5106,7 +4945,7 @@ case p_mod :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can find remainders of short integers divided by short
@@ -5120,31 +4959,31 @@ case p_mod :
           *  remainder and return (we can not overflow).
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            if (right->sp_val.sp_short_value == 0)
+            if (spec_val(right,sp_short_value) == 0)
                abend(SETL_SYSTEM msg_zero_divide);
 
-            short_value = labs(left->sp_val.sp_short_value) %
-                          labs(right->sp_val.sp_short_value);
+            short_value = labs(spec_val(left,sp_short_value)) %
+                          labs(spec_val(right,sp_short_value));
 
             /* make sure mod is positive */
 
             if (short_value != 0) {
 
-               if (left->sp_val.sp_short_value < 0 &&
-                   right->sp_val.sp_short_value > 0)
-                  short_value = right->sp_val.sp_short_value - short_value;
+               if (spec_val(left,sp_short_value) < 0 &&
+                   spec_val(right,sp_short_value) > 0)
+                  short_value = spec_val(right,sp_short_value) - short_value;
 
-               if (left->sp_val.sp_short_value >= 0 &&
-                   right->sp_val.sp_short_value < 0)
-                  short_value = -right->sp_val.sp_short_value - short_value;
+               if (spec_val(left,sp_short_value) >= 0 &&
+                   spec_val(right,sp_short_value) < 0)
+                  short_value = -spec_val(right,sp_short_value) - short_value;
 
             }
 
             unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_value;
+            spec_set_form(target,ft_short);
+            spec_set_val(target,sp_short_value,short_value);
 
             break;
 
@@ -5155,7 +4994,7 @@ case p_mod :
           *  the case in which the right operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             integer_mod(SETL_SYSTEM target,left,right);
 
@@ -5168,7 +5007,7 @@ case p_mod :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5204,7 +5043,7 @@ case p_mod :
           *  general function which divides any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             integer_mod(SETL_SYSTEM target,left,right);
 
@@ -5217,7 +5056,7 @@ case p_mod :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5253,12 +5092,12 @@ case p_mod :
 
          /* if the right operand is a map, convert it */
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
          /* make sure the right hand side is another set */
 
-         if (right->sp_form == ft_set) {
+         if (spec_form(right) == ft_set) {
 
             set_symdiff(SETL_SYSTEM target,left,right);
 
@@ -5271,7 +5110,7 @@ case p_mod :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5322,7 +5161,7 @@ case p_mod :
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5394,6 +5233,7 @@ PRTYPE void arith_ops4(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_min :
+opcode_label(p_min)
 
 {
   double real1,real2;
@@ -5405,7 +5245,7 @@ case p_min :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can compare short integers with other short integers and long
@@ -5418,20 +5258,21 @@ case p_min :
           *  If both operands are short we just compare the values.
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            if (right->sp_val.sp_short_value < left->sp_val.sp_short_value) {
+            if (spec_val(right,sp_short_value) <
+                spec_val(left,sp_short_value)) {
 
                unmark_specifier(target);
-               target->sp_form = right->sp_form;
-               target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(right));
+               spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
             }
             else {
 
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
 
@@ -5444,29 +5285,29 @@ case p_min :
           *  the case in which the second operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             if (integer_lt(SETL_SYSTEM right,left)) {
 
                mark_specifier(right);
                unmark_specifier(target);
-               target->sp_form = right->sp_form;
-               target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(right));
+               spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
             }
             else {
 
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
 
             break;
 
-         } else if (right->sp_form == ft_real) {
-			real2 = (double)(left->sp_val.sp_short_value);
-			real1 = (right->sp_val.sp_real_ptr)->r_value;	
+         } else if (spec_form(right) == ft_real) {
+			real2 = (double)(spec_val(left,sp_short_value));
+			real1 = spec_val(right,sp_real_value);	
 			
 			goto real_min2;
 		 } 
@@ -5476,7 +5317,7 @@ case p_min :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5512,22 +5353,22 @@ case p_min :
           *  general function which adds any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             if (integer_lt(SETL_SYSTEM right,left)) {
 
                mark_specifier(right);
                unmark_specifier(target);
-               target->sp_form = right->sp_form;
-               target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(right));
+               spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
             }
             else {
 
                mark_specifier(left);
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
 
@@ -5540,7 +5381,7 @@ case p_min :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5570,35 +5411,35 @@ case p_min :
 
       case ft_real :
 
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
-			real1 = (right->sp_val.sp_real_ptr)->r_value;	
+			real1 = spec_val(right,sp_real_value);	
 			
 real_min:	
-			real2 = (left->sp_val.sp_real_ptr)->r_value;	
+			real2 = spec_val(left,sp_real_value);	
 real_min2:
             if (real1<real2) {
             
                mark_specifier(right);
                unmark_specifier(target);
-               target->sp_form = right->sp_form;
-               target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(right));
+               spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
             }
             else {
 
                mark_specifier(left);
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
          }
-		 else if (right->sp_form == ft_short) {
-			real1 = (double)(right->sp_val.sp_short_value);
+		 else if (spec_form(right) == ft_short) {
+			real1 = (double)(spec_val(right,sp_short_value));
 			goto real_min;
 		 } 
-		 else if (right->sp_form == ft_long) {
+		 else if (spec_form(right) == ft_long) {
 			real1 = (double)(long_to_double(SETL_SYSTEM right));
 			goto real_min;
 		 }
@@ -5607,7 +5448,7 @@ real_min2:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5639,43 +5480,17 @@ real_min2:
 
          /* make sure the right operand is a string */
 
-         if (right->sp_form == ft_string) {
+         if (spec_form(right) == ft_string) {
 
             /* pick out the string headers */
 
-            left_string_hdr = left->sp_val.sp_string_ptr;
-            right_string_hdr = right->sp_val.sp_string_ptr;
+            left_string_hdr = spec_val(left,sp_string_ptr);
+            right_string_hdr = spec_val(right,sp_string_ptr);
 
             /* we just traverse the two strings until we find a mismatch */
 
-            left_string_cell = left_string_hdr->s_head;
-            right_string_cell = right_string_hdr->s_head;
-
-            /* set up cell limit pointers */
-
-            if (right_string_cell == NULL) {
-
-               right_char_ptr = right_char_end = NULL;
-
-            }
-            else {
-
-               right_char_ptr = right_string_cell->s_cell_value;
-               right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (left_string_cell == NULL) {
-
-               left_char_ptr = left_char_end = NULL;
-
-            }
-            else {
-
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
+            left_char_ptr = left_string_hdr->s_chars;
+            right_char_ptr = right_string_hdr->s_chars;
 
             /* loop over the strings in parallel */
 
@@ -5684,22 +5499,6 @@ real_min2:
 
             while (target_string_length--) {
 
-               if (left_char_ptr == left_char_end) {
-
-                  left_string_cell = left_string_cell->s_next;
-                  left_char_ptr = left_string_cell->s_cell_value;
-                  left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-               }
-
-               if (right_char_ptr == right_char_end) {
-
-                  right_string_cell = right_string_cell->s_next;
-                  right_char_ptr = right_string_cell->s_cell_value;
-                  right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-               }
-
                /* if we find a mismatch, break */
 
                if (*left_char_ptr != *right_char_ptr)
@@ -5718,16 +5517,16 @@ real_min2:
 
                   mark_specifier(right);
                   unmark_specifier(target);
-                  target->sp_form = right->sp_form;
-                  target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+                  spec_set_form(target,spec_form(right));
+                  spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
                }
                else {
 
                   mark_specifier(left);
                   unmark_specifier(target);
-                  target->sp_form = left->sp_form;
-                  target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+                  spec_set_form(target,spec_form(left));
+                  spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
                }
             }
@@ -5740,16 +5539,16 @@ real_min2:
 
                   mark_specifier(right);
                   unmark_specifier(target);
-                  target->sp_form = right->sp_form;
-                  target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+                  spec_set_form(target,spec_form(right));
+                  spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
                }
                else {
 
                   mark_specifier(left);
                   unmark_specifier(target);
-                  target->sp_form = left->sp_form;
-                  target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+                  spec_set_form(target,spec_form(left));
+                  spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
                }
             }
@@ -5763,7 +5562,7 @@ real_min2:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5814,7 +5613,7 @@ real_min2:
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5855,6 +5654,7 @@ real_min2:
 \*/
 
 case p_max :
+opcode_label(p_max)
 
 {
   double real1,real2;
@@ -5867,7 +5667,7 @@ case p_max :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can compare short integers with other short integers and long
@@ -5880,20 +5680,21 @@ case p_max :
           *  If both operands are short we just compare the values.
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            if (left->sp_val.sp_short_value < right->sp_val.sp_short_value) {
+            if (spec_val(left,sp_short_value) <
+                spec_val(right,sp_short_value)) {
 
                unmark_specifier(target);
-               target->sp_form = right->sp_form;
-               target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(right));
+               spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
             }
             else {
 
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
 
@@ -5906,29 +5707,29 @@ case p_max :
           *  the case in which the second operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             if (integer_lt(SETL_SYSTEM left,right)) {
 
                mark_specifier(right);
                unmark_specifier(target);
-               target->sp_form = right->sp_form;
-               target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(right));
+               spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
             }
             else {
 
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
 
             break;
 
-         }  else if (right->sp_form == ft_real) {
-			real2 = (double)(left->sp_val.sp_short_value);
-			real1 = (right->sp_val.sp_real_ptr)->r_value;	
+         }  else if (spec_form(right) == ft_real) {
+			real2 = (double)(spec_val(left,sp_short_value));
+			real1 = spec_val(right,sp_real_value);	
 			
 			goto real_max2;
 		 } 
@@ -5938,7 +5739,7 @@ case p_max :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -5974,22 +5775,22 @@ case p_max :
           *  general function which adds any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             if (integer_lt(SETL_SYSTEM left,right)) {
 
                mark_specifier(right);
                unmark_specifier(target);
-               target->sp_form = right->sp_form;
-               target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(right));
+               spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
             }
             else {
 
                mark_specifier(left);
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
 
@@ -6002,7 +5803,7 @@ case p_max :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -6032,37 +5833,37 @@ case p_max :
 
       case ft_real :
 
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
 
-			real1 = (right->sp_val.sp_real_ptr)->r_value;			
+			real1 = spec_val(right,sp_real_value);			
 			
 real_max:	
-			real2 = (left->sp_val.sp_real_ptr)->r_value;	
+			real2 = spec_val(left,sp_real_value);	
 real_max2:
             if (real2<real1) {
             
 
                mark_specifier(right);
                unmark_specifier(target);
-               target->sp_form = right->sp_form;
-               target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(right));
+               spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
             }
             else {
 
                mark_specifier(left);
                unmark_specifier(target);
-               target->sp_form = left->sp_form;
-               target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+               spec_set_form(target,spec_form(left));
+               spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             }
          }
-         else if (right->sp_form == ft_short) {
-			real1 = (double)(right->sp_val.sp_short_value);
+         else if (spec_form(right) == ft_short) {
+			real1 = (double)(spec_val(right,sp_short_value));
 			goto real_max;
 		 } 
-		 else if (right->sp_form == ft_long) {
+		 else if (spec_form(right) == ft_long) {
 			real1 = (double)(long_to_double(SETL_SYSTEM right));
 			goto real_max;
 		 }
@@ -6072,7 +5873,7 @@ real_max2:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -6104,78 +5905,36 @@ real_max2:
 
          /* make sure the right operand is a string */
 
-         if (right->sp_form == ft_string) {
+         if (spec_form(right) == ft_string) {
 
             /* pick out the string headers */
 
-            left_string_hdr = left->sp_val.sp_string_ptr;
-            right_string_hdr = right->sp_val.sp_string_ptr;
+            left_string_hdr = spec_val(left,sp_string_ptr);
+            right_string_hdr = spec_val(right,sp_string_ptr);
 
             /* we just traverse the two strings until we find a mismatch */
 
-            left_string_cell = left_string_hdr->s_head;
-            right_string_cell = right_string_hdr->s_head;
+            left_char_ptr = left_string_hdr->s_chars;
+            right_char_ptr = right_string_hdr->s_chars;
 
-            /* set up cell limit pointers */
-
-            if (right_string_cell == NULL) {
-
-               right_char_ptr = right_char_end = NULL;
+            /* loop over the strings in parallel */
 
-            }
-            else {
+            target_string_length = min(left_string_hdr->s_length,
+                                       right_string_hdr->s_length);
 
-               right_char_ptr = right_string_cell->s_cell_value;
-               right_char_end = right_char_ptr + STR_CELL_WIDTH;
+            while (target_string_length--) {
 
-            }
+               /* if we find a mismatch, break */
 
-            if (left_string_cell == NULL) {
+               if (*left_char_ptr != *right_char_ptr)
+                  break;
 
-               left_char_ptr = left_char_end = NULL;
+               left_char_ptr++;
+               right_char_ptr++;
 
             }
-            else {
 
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            /* loop over the strings in parallel */
-
-            target_string_length = min(left_string_hdr->s_length,
-                                       right_string_hdr->s_length);
-
-            while (target_string_length--) {
-
-               if (left_char_ptr == left_char_end) {
-
-                  left_string_cell = left_string_cell->s_next;
-                  left_char_ptr = left_string_cell->s_cell_value;
-                  left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-               }
-
-               if (right_char_ptr == right_char_end) {
-
-                  right_string_cell = right_string_cell->s_next;
-                  right_char_ptr = right_string_cell->s_cell_value;
-                  right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-               }
-
-               /* if we find a mismatch, break */
-
-               if (*left_char_ptr != *right_char_ptr)
-                  break;
-
-               left_char_ptr++;
-               right_char_ptr++;
-
-            }
-
-            /* if we found a mismatch, compare characters */
+            /* if we found a mismatch, compare characters */
 
             if (target_string_length >= 0) {
 
@@ -6183,16 +5942,16 @@ real_max2:
 
                   mark_specifier(right);
                   unmark_specifier(target);
-                  target->sp_form = right->sp_form;
-                  target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+                  spec_set_form(target,spec_form(right));
+                  spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
                }
                else {
 
                   mark_specifier(left);
                   unmark_specifier(target);
-                  target->sp_form = left->sp_form;
-                  target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+                  spec_set_form(target,spec_form(left));
+                  spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
                }
             }
@@ -6205,16 +5964,16 @@ real_max2:
 
                   mark_specifier(right);
                   unmark_specifier(target);
-                  target->sp_form = right->sp_form;
-                  target->sp_val.sp_biggest = right->sp_val.sp_biggest;
+                  spec_set_form(target,spec_form(right));
+                  spec_set_val(target,sp_biggest,spec_val(right,sp_biggest));
 
                }
                else {
 
                   mark_specifier(left);
                   unmark_specifier(target);
-                  target->sp_form = left->sp_form;
-                  target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+                  spec_set_form(target,spec_form(left));
+                  spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
                }
             }
@@ -6228,7 +5987,7 @@ real_max2:
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -6279,7 +6038,7 @@ real_max2:
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -6346,6 +6105,7 @@ PRTYPE void set_ops1(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_with :
+opcode_label(p_with)
 
 {
 
@@ -6357,7 +6117,7 @@ case p_with :
 
    /* the action we take depends on the form of the first operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  Maps can have items inserted.
@@ -6370,42 +6130,23 @@ case p_with :
           *  through to the set routine.
           */
 
-         if (right->sp_form == ft_tuple &&
-             (right->sp_val.sp_tuple_ptr)->t_ntype.t_root.t_length == 2) {
+         if (spec_form(right) == ft_tuple &&
+             spec_val(right,sp_tuple_ptr)->t_length == 2) {
 
             /* pick out the domain and range elements */
 
-            tuple_root = right->sp_val.sp_tuple_ptr;
-
-            /* we need the left-most child */
-
-            source_height = tuple_root->t_ntype.t_root.t_height;
-            while (source_height--) {
-
-               tuple_root = tuple_root->t_child[0].t_header;
+            tuple_root = spec_val(right,sp_tuple_ptr);
+            unpack_tuple(tuple_root);
 
-#ifdef TRAPS
-
-               if (tuple_root == NULL)
-                  giveup(SETL_SYSTEM msg_corrupted_tuple);
-
-#endif
+            /* if the domain element is omega, convert to set */
 
-            }
+            domain_element = &(tuple_root->t_cells[0].t_spec);
 
-            /* if the domain element is omega, convert to set */
+            if (spec_form(domain_element) != ft_omega) {
 
-			if ((tuple_root->t_child[0].t_cell)==NULL)
-				domain_element=NULL;
-			else
-            domain_element = &((tuple_root->t_child[0].t_cell)->t_spec);
-            
-            
-            if ((domain_element!=NULL)&&(domain_element->sp_form != ft_omega)) {
-            
-				domain_hash_code = (tuple_root->t_child[0].t_cell)->t_hash_code;
-	            range_element = &((tuple_root->t_child[1].t_cell)->t_spec);
-	            range_hash_code = (tuple_root->t_child[1].t_cell)->t_hash_code;
+               domain_hash_code = tuple_root->t_cells[0].t_hash_code;
+               range_element = &(tuple_root->t_cells[1].t_spec);
+               range_hash_code = tuple_root->t_cells[1].t_hash_code;
 
                /*
                 *  Now we know we have an acceptable tuple, so we can
@@ -6415,16 +6156,16 @@ case p_with :
                 */
 
                if (target == left && target != right &&
-                   (target->sp_val.sp_map_ptr)->m_use_count == 1) {
+                   spec_val(target,sp_map_ptr)->m_use_count == 1) {
 
-                  map_root = target->sp_val.sp_map_ptr;
-                  target->sp_form = ft_omega;
+                  map_root = spec_val(target,sp_map_ptr);
+                  spec_set_form(target,ft_omega);
 
                }
                else {
 
-                  map_root = copy_map(SETL_SYSTEM left->sp_val.sp_map_ptr);
-				  target->sp_form = ft_omega;
+                  map_root = copy_map(SETL_SYSTEM spec_val(left,sp_map_ptr));
+				  spec_set_form(target,ft_omega);
 
                }
 
@@ -6433,103 +6174,35 @@ case p_with :
                 *  map.
                 */
 
-               map_work_hdr = map_root;
-               work_hash_code = domain_hash_code;
-               target_height = map_root->m_ntype.m_root.m_height;
-               while (target_height--) {
-
-                  /* extract the element's index at this level */
-
-                  target_index = work_hash_code & MAP_HASH_MASK;
-                  work_hash_code >>= MAP_SHIFT_DIST;
-
-                  /* if we're missing a header record, insert it */
-
-                  if (map_work_hdr->m_child[target_index].m_header == NULL) {
-
-                     get_map_header(new_map_hdr);
-                     new_map_hdr->m_ntype.m_intern.m_parent = map_work_hdr;
-                     new_map_hdr->m_ntype.m_intern.m_child_index =
-                        target_index;
-                     for (i = 0;
-                          i < MAP_HASH_SIZE;
-                          new_map_hdr->m_child[i++].m_cell = NULL);
-                     map_work_hdr->m_child[target_index].m_header =
-                        new_map_hdr;
-                     map_work_hdr = new_map_hdr;
-
-                  }
-                  else {
-
-                     map_work_hdr =
-                        map_work_hdr->m_child[target_index].m_header;
-
-                  }
-               }
-
-               /*
-                *  At this point, map_work_hdr points to the lowest level
-                *  header record.  The next problem is to determine if the
-                *  domain element is already in the map.  We compare the
-                *  element with the clash list.
-                */
-
-               target_index = work_hash_code & MAP_HASH_MASK;
-               map_cell_tail = &(map_work_hdr->m_child[target_index].m_cell);
-               for (map_cell = *map_cell_tail;
-                    map_cell != NULL &&
-                       map_cell->m_hash_code < domain_hash_code;
-                    map_cell = map_cell->m_next) {
-
-                  map_cell_tail = &(map_cell->m_next);
-
-               }
-
-               /* try to find the domain element */
-
-               is_equal = NO;
-               while (map_cell != NULL &&
-                      map_cell->m_hash_code == domain_hash_code) {
-
-                  spec_equal(is_equal,
-                             &(map_cell->m_domain_spec),domain_element);
-
-                  if (is_equal)
-                     break;
-
-                  map_cell_tail = &(map_cell->m_next);
-                  map_cell = map_cell->m_next;
-
-               }
+               map_cell = map_locate(&(map_root->m_trie),
+                                     domain_element,
+                                     domain_hash_code,
+                                     &is_new);
 
                /* if we don't find the domain element, add a cell */
 
-               if (!is_equal) {
+               if (is_new) {
 
-                  get_map_cell(new_map_cell);
                   mark_specifier(domain_element);
                   mark_specifier(range_element);
-                  new_map_cell->m_domain_spec.sp_form =
-                     domain_element->sp_form;
-                  new_map_cell->m_domain_spec.sp_val.sp_biggest =
-                     domain_element->sp_val.sp_biggest;
-                  new_map_cell->m_range_spec.sp_form =
-                     range_element->sp_form;
-                  new_map_cell->m_range_spec.sp_val.sp_biggest =
-                     range_element->sp_val.sp_biggest;
-                  new_map_cell->m_is_multi_val = NO;
-                  new_map_cell->m_hash_code = domain_hash_code;
-                  new_map_cell->m_next = *map_cell_tail;
-                  *map_cell_tail = new_map_cell;
-                  map_root->m_ntype.m_root.m_cardinality++;
-                  map_root->m_ntype.m_root.m_cell_count++;
+                  spec_set_form(&map_cell->m_domain_spec,
+                     spec_form(domain_element));
+                  spec_set_val(&map_cell->m_domain_spec,sp_biggest,
+                     spec_val(domain_element,sp_biggest));
+                  spec_set_form(&map_cell->m_range_spec,
+                     spec_form(range_element));
+                  spec_set_val(&map_cell->m_range_spec,sp_biggest,
+                     spec_val(range_element,sp_biggest));
+                  map_cell->m_is_multi_val = NO;
+                  map_root->m_cardinality++;
+                  map_root->m_cell_count++;
 
                   map_root->m_hash_code ^= domain_hash_code;
                   map_root->m_hash_code ^= range_hash_code;
 
                   unmark_specifier(target);
-                  target->sp_form = ft_map;
-                  target->sp_val.sp_map_ptr = map_root;
+                  spec_set_form(target,ft_map);
+                  spec_set_val(target,sp_map_ptr,map_root);
 
                   break;
 
@@ -6552,8 +6225,8 @@ case p_with :
                   if (is_equal) {
 
                      unmark_specifier(target);
-                     target->sp_form = ft_map;
-                     target->sp_val.sp_map_ptr = map_root;
+                     spec_set_form(target,ft_map);
+                     spec_set_val(target,sp_map_ptr,map_root);
 
                      break;
 
@@ -6561,28 +6234,15 @@ case p_with :
 
                   /* create a new singleton set for values */
 
-                  get_set_header(set_root);
-                  set_root->s_use_count = 1;
-                  set_root->s_ntype.s_root.s_cardinality = 1;
-                  set_root->s_ntype.s_root.s_height = 0;
-                  for (i = 0;
-                       i < SET_HASH_SIZE;
-                       set_root->s_child[i++].s_cell = NULL);
-
+                  set_root = null_set(SETL_SYSTEM_VOID);
                   spec_hash_code(source_hash_code,&map_cell->m_range_spec);
-                  set_root->s_hash_code = source_hash_code;
-                  get_set_cell(new_set_cell);
-                  new_set_cell->s_spec.sp_form =
-                     map_cell->m_range_spec.sp_form;
-                  new_set_cell->s_spec.sp_val.sp_biggest =
-                        map_cell->m_range_spec.sp_val.sp_biggest;
-                  new_set_cell->s_hash_code = source_hash_code;
-                  new_set_cell->s_next = NULL;
-                  set_root->s_child[source_hash_code &
-                                      SET_HASH_MASK].s_cell = new_set_cell;
+                  set_insert(SETL_SYSTEM set_root,
+                             &(map_cell->m_range_spec),
+                             source_hash_code);
+                  unmark_specifier(&(map_cell->m_range_spec));
 
                   map_cell->m_is_multi_val = YES;
-                  map_cell->m_range_spec.sp_form = ft_omega;
+                  spec_set_form(&map_cell->m_range_spec,ft_omega);
 
                }
                else {
@@ -6592,9 +6252,9 @@ case p_with :
                    *  so we can use it destructively.
                    */
 
-                  set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
+                  set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
                   if (set_root->s_use_count == 1) 
-                     map_cell->m_range_spec.sp_form = ft_omega;
+                     spec_set_form(&map_cell->m_range_spec,ft_omega);
                   else
                      set_root = copy_set(SETL_SYSTEM set_root);
 
@@ -6602,96 +6262,21 @@ case p_with :
 
                /*
                 *  Now we have a value set, and we must insert our range
-                *  element into that set.
-                */
-
-               set_work_hdr = set_root;
-
-               /* get the element's hash code */
-
-               work_hash_code = source_hash_code = range_hash_code;
-
-               /* descend the header tree until we get to a leaf */
-
-               source_height = set_root->s_ntype.s_root.s_height;
-               while (source_height--) {
-
-                  /* extract the element's index at this level */
-
-                  source_index = work_hash_code & SET_HASH_MASK;
-                  work_hash_code >>= SET_SHIFT_DIST;
-
-                  /* if we're missing a header record, insert it */
-
-                  if (set_work_hdr->s_child[source_index].s_header ==
-                      NULL) {
-
-                     get_set_header(new_set_hdr);
-                     new_set_hdr->s_ntype.s_intern.s_parent =
-                        set_work_hdr;
-                     new_set_hdr->s_ntype.s_intern.s_child_index =
-                        source_index;
-                     for (i = 0;
-                          i < SET_HASH_SIZE;
-                          new_set_hdr->s_child[i++].s_cell = NULL);
-                     set_work_hdr->s_child[source_index].s_header =
-                        new_set_hdr;
-                     set_work_hdr = new_set_hdr;
-
-                  }
-                  else {
-
-                     set_work_hdr =
-                        set_work_hdr->s_child[source_index].s_header;
-
-                  }
-               }
-
-               /*
-                *  At this point, set_work_hdr points to the lowest
-                *  level header record.  The next problem is to determine
-                *  if the element is already in the set.  We compare the
-                *  element with the clash list.
+                *  element into that set.  If it's already there we're
+                *  done.
                 */
 
-               source_index = work_hash_code & SET_HASH_MASK;
-               set_cell_tail = &(set_work_hdr->s_child[source_index].s_cell);
-               for (set_cell = *set_cell_tail;
-                    set_cell != NULL &&
-                       set_cell->s_hash_code < source_hash_code;
-                    set_cell = set_cell->s_next) {
-
-                  set_cell_tail = &(set_cell->s_next);
-
-               }
-
-               /* check for a duplicate element */
-
-               is_equal = NO;
-               while (set_cell != NULL &&
-                      set_cell->s_hash_code == source_hash_code) {
-
-                  spec_equal(is_equal,&(set_cell->s_spec),range_element);
-
-                  if (is_equal)
-                     break;
-
-                  set_cell_tail = &(set_cell->s_next);
-                  set_cell = set_cell->s_next;
-
-               }
-
-               /* if we reach this point we didn't find the element */
-
-               if (is_equal) {
+               if (!set_insert(SETL_SYSTEM set_root,
+                               range_element,
+                               range_hash_code)) {
 
                   unmark_specifier(&(map_cell->m_range_spec));
-                  map_cell->m_range_spec.sp_form = ft_set;
-                  map_cell->m_range_spec.sp_val.sp_set_ptr = set_root;
+                  spec_set_form(&map_cell->m_range_spec,ft_set);
+                  spec_set_val(&map_cell->m_range_spec,sp_set_ptr,set_root);
 
                   unmark_specifier(target);
-                  target->sp_form = ft_map;
-                  target->sp_val.sp_map_ptr = map_root;
+                  spec_set_form(target,ft_map);
+                  spec_set_val(target,sp_map_ptr,map_root);
 
                   break;
 
@@ -6699,59 +6284,17 @@ case p_with :
 
                map_root->m_hash_code ^= domain_hash_code;
                map_root->m_hash_code ^= range_hash_code;
-
-               get_set_cell(new_set_cell);
-               mark_specifier(range_element);
-               new_set_cell->s_spec.sp_form = range_element->sp_form;
-               new_set_cell->s_spec.sp_val.sp_biggest =
-                  range_element->sp_val.sp_biggest;
-               new_set_cell->s_hash_code = source_hash_code;
-               new_set_cell->s_next = *set_cell_tail;
-               *set_cell_tail = new_set_cell;
-               set_root->s_ntype.s_root.s_cardinality++;
-               map_root->m_ntype.m_root.m_cardinality++;
-               set_root->s_hash_code ^= source_hash_code;
-
-               /* we may have to expand the header, so find the trigger */
-
-               expansion_trigger =
-                     (1 << ((set_root->s_ntype.s_root.s_height + 1)
-                             * SET_SHIFT_DIST)) * SET_CLASH_SIZE;
-
-               /* expand the set header if necessary */
-
-               if (set_root->s_ntype.s_root.s_cardinality >
-                   expansion_trigger) {
-
-                  set_root = set_expand_header(SETL_SYSTEM set_root);
-				  // What is this line doing here??
-                  //map_cell->m_range_spec.sp_val.sp_set_ptr = set_root;
-
-               }
-
-               /* expand the map header if necessary */
-
-               expansion_trigger =
-                     (1 << ((map_root->m_ntype.m_root.m_height + 1)
-                            * MAP_SHIFT_DIST)) * 2;
-               if (map_root->m_ntype.m_root.m_cardinality >
-                   expansion_trigger) {
-
-                  map_root = map_expand_header(SETL_SYSTEM map_root);
-				  // What is this line doing here??
-                  //target->sp_val.sp_map_ptr = map_root;
-
-               }
+               map_root->m_cardinality++;
 
                /* finally, set the target and return */
 
                unmark_specifier(&(map_cell->m_range_spec));
-               map_cell->m_range_spec.sp_form = ft_set;
-               map_cell->m_range_spec.sp_val.sp_set_ptr = set_root;
+               spec_set_form(&map_cell->m_range_spec,ft_set);
+               spec_set_val(&map_cell->m_range_spec,sp_set_ptr,set_root);
 
                unmark_specifier(target);
-               target->sp_form = ft_map;
-               target->sp_val.sp_map_ptr = map_root;
+               spec_set_form(target,ft_map);
+               spec_set_val(target,sp_map_ptr,map_root);
 
                break;
 
@@ -6768,12 +6311,12 @@ case p_with :
 
          /* we never insert omegas */
 
-         if (right->sp_form == ft_omega) {
+         if (spec_form(right) == ft_omega) {
 
             mark_specifier(left);
             unmark_specifier(target);
-            target->sp_form = left->sp_form;
-            target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(left));
+            spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             break;
 
@@ -6785,126 +6328,28 @@ case p_with :
           */
                   
          if (target == left && target != right &&
-             (target->sp_val.sp_set_ptr)->s_use_count == 1) {
+             spec_val(target,sp_set_ptr)->s_use_count == 1) {
 
-            set_root = target->sp_val.sp_set_ptr;
-            target->sp_form = ft_omega;
+            set_root = spec_val(target,sp_set_ptr);
+            spec_set_form(target,ft_omega);
 
          }
          else {
 
-            set_root = copy_set(SETL_SYSTEM left->sp_val.sp_set_ptr);
-
-         }
-
-         set_work_hdr = set_root;
-
-         /* get the element's hash code */
-
-         spec_hash_code(work_hash_code,right);
-         source_hash_code = work_hash_code;
-
-         /* descend the header tree until we get to a leaf */
-
-         target_height = set_root->s_ntype.s_root.s_height;
-         while (target_height--) {
-
-            /* extract the element's index at this level */
-
-            target_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-            /* if we're missing a header record, insert it */
-
-            if (set_work_hdr->s_child[target_index].s_header == NULL) {
-
-               get_set_header(new_set_hdr);
-               new_set_hdr->s_ntype.s_intern.s_parent = set_work_hdr;
-               new_set_hdr->s_ntype.s_intern.s_child_index = target_index;
-               for (i = 0;
-                    i < SET_HASH_SIZE;
-                    new_set_hdr->s_child[i++].s_cell = NULL);
-               set_work_hdr->s_child[target_index].s_header = new_set_hdr;
-               set_work_hdr = new_set_hdr;
-
-            }
-            else {
-
-               set_work_hdr =
-                  set_work_hdr->s_child[target_index].s_header;
-
-            }
-         }
-
-         /*
-          *  At this point, set_work_hdr points to the lowest level header
-          *  record.  The next problem is to determine if the element is
-          *  already in the set.  We compare the element with the clash
-          *  list.
-          */
-
-         target_index = work_hash_code & SET_HASH_MASK;
-         set_cell_tail = &(set_work_hdr->s_child[target_index].s_cell);
-         for (set_cell = *set_cell_tail;
-              set_cell != NULL &&
-                 set_cell->s_hash_code < source_hash_code;
-              set_cell = set_cell->s_next) {
-
-            set_cell_tail = &(set_cell->s_next);
-
-         }
-
-         /* check for a duplicate element */
-
-         is_equal = NO;
-         while (set_cell != NULL &&
-                set_cell->s_hash_code == source_hash_code) {
-
-            spec_equal(is_equal,&(set_cell->s_spec),right);
-
-            if (is_equal)
-               break;
-
-            set_cell_tail = &(set_cell->s_next);
-            set_cell = set_cell->s_next;
+            set_root = copy_set(SETL_SYSTEM spec_val(left,sp_set_ptr));
 
          }
 
-         /* if we reach this point we didn't find the element */
-
-         if (!is_equal) {
-
-            get_set_cell(new_set_cell);
-            mark_specifier(right);
-            new_set_cell->s_spec.sp_form = right->sp_form;
-            new_set_cell->s_spec.sp_val.sp_biggest =
-               right->sp_val.sp_biggest;
-            new_set_cell->s_hash_code = source_hash_code;
-            new_set_cell->s_next = *set_cell_tail;
-            *set_cell_tail = new_set_cell;
-            set_root->s_ntype.s_root.s_cardinality++;
-            set_root->s_hash_code ^= source_hash_code;
-
-            /* we may have to expand the size of the header */
-
-            expansion_trigger =
-                 (1 << ((set_root->s_ntype.s_root.s_height + 1)
-                  * SET_SHIFT_DIST)) * SET_CLASH_SIZE;
+         /* insert the element, unless it's already there */
 
-            /* expand the set header if necessary */
-
-            if (set_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
-
-               set_root = set_expand_header(SETL_SYSTEM set_root);
-
-            }
-         }
+         spec_hash_code(source_hash_code,right);
+         set_insert(SETL_SYSTEM set_root,right,source_hash_code);
 
          /* finally, set the target value */
 
          unmark_specifier(target);
-         target->sp_form = ft_set;
-         target->sp_val.sp_set_ptr = set_root;
+         spec_set_form(target,ft_set);
+         spec_set_val(target,sp_set_ptr,set_root);
 
          break;
 
@@ -6916,12 +6361,12 @@ case p_with :
 
          /* we don't append omega's */
 
-         if (right->sp_form == ft_omega) {
+         if (spec_form(right) == ft_omega) {
 
             mark_specifier(left);
             unmark_specifier(target);
-            target->sp_form = left->sp_form;
-            target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(left));
+            spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             break;
 
@@ -6930,112 +6375,53 @@ case p_with :
          /* we would like to use the left operand destructively */
 
          if (target == left && target != right &&
-             (target->sp_val.sp_tuple_ptr)->t_use_count == 1) {
+             spec_val(target,sp_tuple_ptr)->t_use_count == 1) {
 
-            tuple_root = target->sp_val.sp_tuple_ptr;
-            target->sp_form = ft_omega;
+            tuple_root = spec_val(target,sp_tuple_ptr);
+            spec_set_form(target,ft_omega);
 
          }
          else {
 
-            tuple_root = copy_tuple(SETL_SYSTEM left->sp_val.sp_tuple_ptr);
+            tuple_root = copy_tuple(SETL_SYSTEM spec_val(left,sp_tuple_ptr));
 
          }
 
          /* we insert at the end of the tuple */
 
-         short_value = tuple_root->t_ntype.t_root.t_length;
-
-         /* expand the target tree if necessary */
-
-         expansion_trigger = 1 << ((tuple_root->t_ntype.t_root.t_height + 1)
-                                    * TUP_SHIFT_DIST);
-
-         if (short_value >= expansion_trigger) {
-
-            tuple_work_hdr = tuple_root;
-
-            get_tuple_header(tuple_root);
-
-            tuple_root->t_use_count = 1;
-            tuple_root->t_hash_code =
-               tuple_work_hdr->t_hash_code;
-            tuple_root->t_ntype.t_root.t_length =
-               tuple_work_hdr->t_ntype.t_root.t_length;
-            tuple_root->t_ntype.t_root.t_height =
-               tuple_work_hdr->t_ntype.t_root.t_height + 1;
-
-            for (i = 1;
-                 i < TUP_HEADER_SIZE;
-                 tuple_root->t_child[i++].t_header = NULL);
-
-            tuple_root->t_child[0].t_header = tuple_work_hdr;
-
-            tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-            tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-         }
-
-         tuple_root->t_ntype.t_root.t_length = short_value + 1;
-
-         /* look up the tuple component */
-
-         tuple_work_hdr = tuple_root;
-
-         for (source_height = tuple_root->t_ntype.t_root.t_height;
-              source_height;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = (short_value >>
-                                 (source_height * TUP_SHIFT_DIST)) &
-                              TUP_SHIFT_MASK;
+         short_value = tuple_root->t_length;
+         if (tuple_root->t_packing != TUP_CELLS &&
+             store_packed(SETL_SYSTEM tuple_root,short_value,right)) {
 
-            /* if we're missing a header record, allocate one */
-
-            if (tuple_work_hdr->t_child[source_index].t_header == NULL) {
-
-               get_tuple_header(new_tuple_hdr);
-               new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-               new_tuple_hdr->t_ntype.t_intern.t_child_index = source_index;
-               for (i = 0;
-                    i < TUP_HEADER_SIZE;
-                    new_tuple_hdr->t_child[i++].t_cell = NULL);
-               tuple_work_hdr->t_child[source_index].t_header =
-                     new_tuple_hdr;
-               tuple_work_hdr = new_tuple_hdr;
-
-            }
-            else {
+            unmark_specifier(target);
+            spec_set_form(target,ft_tuple);
+            spec_set_val(target,sp_tuple_ptr,tuple_root);
 
-               tuple_work_hdr =
-                  tuple_work_hdr->t_child[source_index].t_header;
+            break;
 
-            }
          }
 
-         /*
-          *  At this point, tuple_work_hdr points to the lowest level header
-          *  record.  We insert the new element.
-          */
-
-         source_index = short_value & TUP_SHIFT_MASK;
-
-         get_tuple_cell(tuple_cell);
-         tuple_work_hdr->t_child[source_index].t_cell = tuple_cell;
+         reserve_tuple(tuple_root,short_value + 1);
+         tuple_root->t_length = short_value + 1;
+         tuple_cell = tuple_root->t_cells + short_value;
          mark_specifier(right);
-         tuple_cell->t_spec.sp_form = right->sp_form;
-         tuple_cell->t_spec.sp_val.sp_biggest = right->sp_val.sp_biggest;
+         spec_set_form(&tuple_cell->t_spec,spec_form(right));
+         spec_set_val(&tuple_cell->t_spec,sp_biggest,
+                      spec_val(right,sp_biggest));
          spec_hash_code(work_hash_code,right);
          tuple_root->t_hash_code ^= work_hash_code;
          tuple_cell->t_hash_code = work_hash_code;
 
+         /* a tuple built by appending numbers is packed once it's long */
+
+         if (short_value + 1 == TUP_PACK_MIN)
+            pack_tuple(SETL_SYSTEM tuple_root);
+
          /* finally, assign our result to the target */
 
          unmark_specifier(target);
-         target->sp_form = ft_tuple;
-         target->sp_val.sp_tuple_ptr = tuple_root;
+         spec_set_form(target,ft_tuple);
+         spec_set_val(target,sp_tuple_ptr,tuple_root);
 
          break;
 
@@ -7046,23 +6432,55 @@ case p_with :
 
       case ft_mailbox :
 
-         mailbox_ptr = left->sp_val.sp_mailbox_ptr;
+         mailbox_ptr = spec_val(left,sp_mailbox_ptr);
+         mark_specifier(right);
 
-         get_mailbox_cell(mailbox_cell);
-         *(mailbox_ptr->mb_tail) = mailbox_cell;
-         mailbox_ptr->mb_tail = &(mailbox_cell->mb_next);
-         mailbox_cell->mb_next = NULL;
+         /*
+          *  A full mailbox holds the sender back until the receiver
+          *  takes something.  We can't switch in a critical section, so
+          *  there the mailbox overflows its bound.
+          */
 
-         mailbox_ptr->mb_cell_count++;
+         if (mailbox_ptr->mb_capacity > 0 &&
+             mailbox_ptr->mb_cell_count >= mailbox_ptr->mb_capacity &&
+             !critical_section) {
 
-         mark_specifier(right);
-         mailbox_cell->mb_spec.sp_form = right->sp_form;
-         mailbox_cell->mb_spec.sp_val.sp_biggest = right->sp_val.sp_biggest;
+            spec_set_form(&process_head->pc_wait_return,spec_form(right));
+            spec_set_val(&process_head->pc_wait_return,sp_biggest,
+                         spec_val(right,sp_biggest));
+            spec_set_form(&process_head->pc_wait_key,ft_mailbox);
+            spec_set_val(&process_head->pc_wait_key,sp_mailbox_ptr,
+                         mailbox_ptr);
+            mailbox_ptr->mb_use_count++;
+
+            process_head->pc_sending = YES;
+            opcodes_until_switch = 0;
+
+         }
+         else {
+
+            get_mailbox_cell(mailbox_cell);
+            *(mailbox_ptr->mb_tail) = mailbox_cell;
+            mailbox_ptr->mb_tail = &(mailbox_cell->mb_next);
+            mailbox_cell->mb_next = NULL;
+
+            mailbox_ptr->mb_cell_count++;
+
+            spec_set_form(&mailbox_cell->mb_spec,spec_form(right));
+            spec_set_val(&mailbox_cell->mb_spec,sp_biggest,
+                         spec_val(right,sp_biggest));
+
+         }
  
          mailbox_ptr->mb_use_count++;
          unmark_specifier(target);
-         target->sp_form = ft_mailbox;
-         target->sp_val.sp_mailbox_ptr = mailbox_ptr;
+         spec_set_form(target,ft_mailbox);
+         spec_set_val(target,sp_mailbox_ptr,mailbox_ptr);
+
+         /* a held sender must switch before its next send */
+
+         if (process_head->pc_sending)
+            call_poll;
 
          break;
 
@@ -7104,7 +6522,7 @@ case p_with :
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -7173,6 +6591,7 @@ PRTYPE void set_ops2(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_less :
+opcode_label(p_less)
 
 {
 
@@ -7186,18 +6605,18 @@ case p_less :
     *  Sets can have items deleted.
     */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_set :
 
          /* we never delete omegas */
 
-         if (right->sp_form == ft_omega) {
+         if (spec_form(right) == ft_omega) {
 
             mark_specifier(left);
             unmark_specifier(target);
-            target->sp_form = left->sp_form;
-            target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(left));
+            spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             break;
 
@@ -7209,235 +6628,102 @@ case p_less :
           */
 
          if (target == left && target != right &&
-             (target->sp_val.sp_set_ptr)->s_use_count == 1) {
+             spec_val(target,sp_set_ptr)->s_use_count == 1) {
 
-            set_root = target->sp_val.sp_set_ptr;
-            target->sp_form = ft_omega;
+            set_root = spec_val(target,sp_set_ptr);
+            spec_set_form(target,ft_omega);
 
          }
          else {
 
-            set_root = copy_set(SETL_SYSTEM left->sp_val.sp_set_ptr);
+            set_root = copy_set(SETL_SYSTEM spec_val(left,sp_set_ptr));
 
          }
 
-         set_work_hdr = set_root;
-
-         /* get the element's hash code */
+         /* remove the element, if it's there */
 
-         spec_hash_code(work_hash_code,right);
-         source_hash_code = work_hash_code;
+         spec_hash_code(source_hash_code,right);
+         set_remove(SETL_SYSTEM set_root,right,source_hash_code);
 
-         /* descend the header tree until we get to a leaf */
+         /* finally, set the target value */
 
-         target_height = set_root->s_ntype.s_root.s_height;
-         while (set_work_hdr != NULL && target_height--) {
+         unmark_specifier(target);
+         spec_set_form(target,ft_set);
+         spec_set_val(target,sp_set_ptr,set_root);
 
-            /* extract the element's index at this level */
+         break;
 
-            target_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code = work_hash_code >> SET_SHIFT_DIST;
+      /*
+       *  Maps can have items deleted.
+       */
 
-            set_work_hdr =
-               set_work_hdr->s_child[target_index].s_header;
+      case ft_map :
 
-         }
+         /*
+          *  If the value being removed is not a tuple of length 2, it
+          *  can't be in a map.
+          */
 
-         if (set_work_hdr == NULL) {
+         if (spec_form(right) != ft_tuple) {
 
+            mark_specifier(left);
             unmark_specifier(target);
-            target->sp_form = ft_set;
-            target->sp_val.sp_set_ptr = set_root;
+            spec_set_form(target,spec_form(left));
+            spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
             break;
 
          }
 
-         /*
-          *  At this point, set_work_hdr points to the lowest level header
-          *  record.  The next problem is to determine if the element is in
-          *  the set.  We compare the element with the clash list.
-          */
+         /* pick out the domain and range elements */
 
-         target_index = work_hash_code & SET_HASH_MASK;
-         set_cell_tail = &(set_work_hdr->s_child[target_index].s_cell);
-         for (set_cell = *set_cell_tail;
-              set_cell != NULL &&
-                 set_cell->s_hash_code < source_hash_code;
-              set_cell = set_cell->s_next) {
+         tuple_root = spec_val(right,sp_tuple_ptr);
+         if (tuple_root->t_length != 2) {
+
+            mark_specifier(left);
+            unmark_specifier(target);
+            spec_set_form(target,spec_form(left));
+            spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
-            set_cell_tail = &(set_cell->s_next);
+            break;
 
          }
 
-         /* search the list of elements with the same hash code */
+         /* if the domain or range is omega, break */
 
-         is_equal = NO;
-         while (set_cell != NULL &&
-                set_cell->s_hash_code == source_hash_code) {
+         unpack_tuple(tuple_root);
+         domain_element = &(tuple_root->t_cells[0].t_spec);
+         domain_hash_code = tuple_root->t_cells[0].t_hash_code;
+         range_element = &(tuple_root->t_cells[1].t_spec);
+         range_hash_code = tuple_root->t_cells[1].t_hash_code;
 
-            spec_equal(is_equal,&(set_cell->s_spec),right);
+         if (spec_form(domain_element) == ft_omega) {
 
-            if (is_equal)
-               break;
+            mark_specifier(left);
+            unmark_specifier(target);
+            spec_set_form(target,spec_form(left));
+            spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
-            set_cell_tail = &(set_cell->s_next);
-            set_cell = set_cell->s_next;
+            break;
 
          }
 
-         /* if we found the element, delete it */
+         /*
+          *  Now we know we have an acceptable tuple, so we can perform the
+          *  deletion as a map.  First we set up a target map.  We would
+          *  like to use the left operand destructively if possible.
+          */
 
-         if (is_equal) {
+         if (target == left && target != right &&
+             spec_val(target,sp_map_ptr)->m_use_count == 1) {
 
-            unmark_specifier(&(set_cell->s_spec));
-            *set_cell_tail = set_cell->s_next;
-            set_root->s_ntype.s_root.s_cardinality--;
-            set_root->s_hash_code ^= source_hash_code;
-            free_set_cell(set_cell);
+            map_root = spec_val(target,sp_map_ptr);
+            spec_set_form(target,ft_omega);
 
-            /* delete any null headers on this subtree */
+         }
+         else {
 
-            for (;;) {
-
-               if (set_work_hdr == set_root)
-                  break;
-
-               for (i = 0;
-                    i < SET_HASH_SIZE &&
-                       set_work_hdr->s_child[i].s_header == NULL;
-                    i++);
-
-               if (i < SET_HASH_SIZE)
-                  break;
-
-               target_index =
-                  set_work_hdr->s_ntype.s_intern.s_child_index + 1;
-               set_work_hdr =
-                  set_work_hdr->s_ntype.s_intern.s_parent;
-
-            }
-
-            /* we may have to reduce the height of the set */
-
-            contraction_trigger = (1 << ((set_root->s_ntype.s_root.s_height)
-                                          * SET_SHIFT_DIST));
-            if (contraction_trigger == 1)
-               contraction_trigger = 0;
-
-            if (set_root->s_ntype.s_root.s_cardinality <
-                contraction_trigger) {
-
-               set_root = set_contract_header(SETL_SYSTEM set_root);
-
-            }
-         }
-
-         /* finally, set the target value */
-
-         unmark_specifier(target);
-         target->sp_form = ft_set;
-         target->sp_val.sp_set_ptr = set_root;
-
-         break;
-
-      /*
-       *  Maps can have items deleted.
-       */
-
-      case ft_map :
-
-         /*
-          *  If the value being removed is not a tuple of length 2, it
-          *  can't be in a map.
-          */
-
-         if (right->sp_form != ft_tuple) {
-
-            mark_specifier(left);
-            unmark_specifier(target);
-            target->sp_form = left->sp_form;
-            target->sp_val.sp_biggest = left->sp_val.sp_biggest;
-
-            break;
-
-         }
-
-         /* pick out the domain and range elements */
-
-         tuple_root = right->sp_val.sp_tuple_ptr;
-         if (tuple_root->t_ntype.t_root.t_length != 2) {
-
-            mark_specifier(left);
-            unmark_specifier(target);
-            target->sp_form = left->sp_form;
-            target->sp_val.sp_biggest = left->sp_val.sp_biggest;
-
-            break;
-
-         }
-
-         /* we need the left-most child */
-
-         source_height = tuple_root->t_ntype.t_root.t_height;
-         while (source_height--) {
-
-            tuple_root = tuple_root->t_child[0].t_header;
-
-#ifdef TRAPS
-
-            if (tuple_root == NULL)
-               giveup(SETL_SYSTEM msg_corrupted_tuple);
-
-#endif
-
-         }
-
-         /* if the domain or range is omega, break */
-
-         if (tuple_root->t_child[0].t_cell == NULL) {
-
-            mark_specifier(left);
-            unmark_specifier(target);
-            target->sp_form = left->sp_form;
-            target->sp_val.sp_biggest = left->sp_val.sp_biggest;
-
-            break;
-
-         }
-
-         domain_element = &((tuple_root->t_child[0].t_cell)->t_spec);
-         domain_hash_code = (tuple_root->t_child[0].t_cell)->t_hash_code;
-         range_element = &((tuple_root->t_child[1].t_cell)->t_spec);
-         range_hash_code = (tuple_root->t_child[1].t_cell)->t_hash_code;
-
-         if (domain_element->sp_form == ft_omega) {
-
-            mark_specifier(left);
-            unmark_specifier(target);
-            target->sp_form = left->sp_form;
-            target->sp_val.sp_biggest = left->sp_val.sp_biggest;
-
-            break;
-
-         }
-
-         /*
-          *  Now we know we have an acceptable tuple, so we can perform the
-          *  deletion as a map.  First we set up a target map.  We would
-          *  like to use the left operand destructively if possible.
-          */
-
-         if (target == left && target != right &&
-             (target->sp_val.sp_map_ptr)->m_use_count == 1) {
-
-            map_root = target->sp_val.sp_map_ptr;
-            target->sp_form = ft_omega;
-
-         }
-         else {
-
-            map_root = copy_map(SETL_SYSTEM left->sp_val.sp_map_ptr);
+            map_root = copy_map(SETL_SYSTEM spec_val(left,sp_map_ptr));
 
          }
 
@@ -7446,69 +6732,15 @@ case p_less :
           *  map.
           */
 
-         map_work_hdr = map_root;
-         work_hash_code = domain_hash_code;
-         target_height = map_root->m_ntype.m_root.m_height;
-         while (target_height-- && map_work_hdr != NULL) {
-
-            /* extract the element's index at this level */
-
-            target_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code >>= MAP_SHIFT_DIST;
-
-            map_work_hdr =
-               map_work_hdr->m_child[target_index].m_header;
-
-         }
-
-         if (map_work_hdr == NULL) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_map;
-            target->sp_val.sp_map_ptr = map_root;
-
-            break;
-
-         }
-
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  The next problem is to determine if the domain element
-          *  is in the map.  We compare the element with the clash list.
-          */
-
-         target_index = work_hash_code & MAP_HASH_MASK;
-         map_cell_tail = &(map_work_hdr->m_child[target_index].m_cell);
-         for (map_cell = *map_cell_tail;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < domain_hash_code;
-              map_cell = map_cell->m_next) {
-
-            map_cell_tail = &(map_cell->m_next);
-
-         }
-
-         /* try to find the domain element */
-
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == domain_hash_code) {
-
-            spec_equal(is_equal,&(map_cell->m_domain_spec),domain_element);
-
-            if (is_equal)
-               break;
-
-            map_cell_tail = &(map_cell->m_next);
-            map_cell = map_cell->m_next;
-
-         }
+         map_cell = map_update(&(map_root->m_trie),
+                               domain_element,
+                               domain_hash_code);
 
-         if (!is_equal) {
+         if (map_cell == NULL) {
 
             unmark_specifier(target);
-            target->sp_form = ft_map;
-            target->sp_val.sp_map_ptr = map_root;
+            spec_set_form(target,ft_map);
+            spec_set_val(target,sp_map_ptr,map_root);
 
             break;
 
@@ -7524,11 +6756,13 @@ case p_less :
 
             if (is_equal) {
 
-               map_root->m_ntype.m_root.m_cardinality--;
-               map_root->m_ntype.m_root.m_cell_count--;
+               map_cell = map_unlink(&(map_root->m_trie),
+                                     domain_element,
+                                     domain_hash_code);
+               map_root->m_cardinality--;
+               map_root->m_cell_count--;
                map_root->m_hash_code ^= map_cell->m_hash_code;
                map_root->m_hash_code ^= range_hash_code;
-               *map_cell_tail = map_cell->m_next;
                unmark_specifier(&(map_cell->m_domain_spec));
                unmark_specifier(&(map_cell->m_range_spec));
                free_map_cell(map_cell);
@@ -7536,8 +6770,8 @@ case p_less :
             }
 
             unmark_specifier(target);
-            target->sp_form = ft_map;
-            target->sp_val.sp_map_ptr = map_root;
+            spec_set_form(target,ft_map);
+            spec_set_val(target,sp_map_ptr,map_root);
 
             break;
 
@@ -7548,151 +6782,47 @@ case p_less :
           *  use it destructively.
           */
 
-         set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
+         set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
          if (set_root->s_use_count == 1)
-            map_cell->m_range_spec.sp_form = ft_omega;
+            spec_set_form(&map_cell->m_range_spec,ft_omega);
          else
             set_root = copy_set(SETL_SYSTEM set_root);
 
-         set_work_hdr = set_root;
-
-         /* get the element's hash code */
-
-         work_hash_code = range_hash_code;
-
-         /* descend the header tree until we get to a leaf */
-
-         source_height = set_root->s_ntype.s_root.s_height;
-         while (source_height-- && set_work_hdr != NULL) {
-
-            /* extract the element's index at this level */
-
-            source_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code >>= SET_SHIFT_DIST;
+         /* remove the range element from the value set */
 
-            set_work_hdr =
-               set_work_hdr->s_child[source_index].s_header;
-
-         }
-
-         if (set_work_hdr == NULL) {
+         if (!set_remove(SETL_SYSTEM set_root,
+                         range_element,
+                         range_hash_code)) {
 
             unmark_specifier(&(map_cell->m_range_spec));
-            map_cell->m_range_spec.sp_form = ft_set;
-            map_cell->m_range_spec.sp_val.sp_set_ptr = set_root;
+            spec_set_form(&map_cell->m_range_spec,ft_set);
+            spec_set_val(&map_cell->m_range_spec,sp_set_ptr,set_root);
 
             unmark_specifier(target);
-            target->sp_form = ft_map;
-            target->sp_val.sp_map_ptr = map_root;
+            spec_set_form(target,ft_map);
+            spec_set_val(target,sp_map_ptr,map_root);
 
             break;
 
          }
 
-         /*
-          *  At this point, set_work_hdr points to the lowest level header
-          *  record.  The next problem is to determine if the element is in
-          *  the set.  We compare the element with the clash list.
-          */
-
-         source_index = work_hash_code & SET_HASH_MASK;
-         set_cell_tail = &(set_work_hdr->s_child[source_index].s_cell);
-         for (set_cell = *set_cell_tail;
-              set_cell != NULL &&
-                 set_cell->s_hash_code < range_hash_code;
-              set_cell = set_cell->s_next) {
-
-            set_cell_tail = &(set_cell->s_next);
-
-         }
-
-         /* find the range element in the clash list */
-
-         is_equal = NO;
-         while (set_cell != NULL &&
-                set_cell->s_hash_code == range_hash_code) {
-
-            spec_equal(is_equal,&(set_cell->s_spec),range_element);
-
-            if (is_equal)
-               break;
-
-            set_cell_tail = &(set_cell->s_next);
-            set_cell = set_cell->s_next;
-
-         }
-
-         if (!is_equal) {
-
-            unmark_specifier(&(map_cell->m_range_spec));
-            map_cell->m_range_spec.sp_form = ft_set;
-            map_cell->m_range_spec.sp_val.sp_set_ptr = set_root;
-
-            unmark_specifier(target);
-            target->sp_form = ft_map;
-            target->sp_val.sp_map_ptr = map_root;
-
-            break;
-
-         }
+         map_root->m_cardinality--;
+         map_root->m_hash_code ^= range_hash_code;
 
          /*
-          *  If the value set has more than two elements, we remove the
-          *  element from the cell.
+          *  If the value set still has more than one element, we leave it
+          *  in the cell.
           */
 
-         map_root->m_hash_code ^= range_hash_code;
-         unmark_specifier(&(set_cell->s_spec));
-         *set_cell_tail = set_cell->s_next;
-         set_root->s_ntype.s_root.s_cardinality--;
-         set_root->s_hash_code ^= range_hash_code;
-         free_set_cell(set_cell);
-
-         /* delete any null headers on this subtree */
-
-         for (;;) {
-
-            if (set_work_hdr == set_root)
-               break;
-
-            for (i = 0;
-                 i < SET_HASH_SIZE &&
-                    set_work_hdr->s_child[i].s_header == NULL;
-                 i++);
-
-            if (i < SET_HASH_SIZE)
-               break;
-
-            target_index =
-               set_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            set_work_hdr =
-               set_work_hdr->s_ntype.s_intern.s_parent;
-
-         }
-
-         /* we may have to reduce the height of the set */
-
-         contraction_trigger = (1 << ((set_root->s_ntype.s_root.s_height)
-                                       * SET_SHIFT_DIST));
-         if (contraction_trigger == 1)
-            contraction_trigger = 0;
-
-         if (set_root->s_ntype.s_root.s_cardinality <
-             contraction_trigger) {
-
-            set_root = set_contract_header(SETL_SYSTEM set_root);
-
-         }
-
-         if (set_root->s_ntype.s_root.s_cardinality > 1) {
+         if (set_root->s_cardinality > 1) {
 
             unmark_specifier(&(map_cell->m_range_spec));
-            map_cell->m_range_spec.sp_form = ft_set;
-            map_cell->m_range_spec.sp_val.sp_set_ptr = set_root;
+            spec_set_form(&map_cell->m_range_spec,ft_set);
+            spec_set_val(&map_cell->m_range_spec,sp_set_ptr,set_root);
 
             unmark_specifier(target);
-            target->sp_form = ft_map;
-            target->sp_val.sp_map_ptr = map_root;
+            spec_set_form(target,ft_map);
+            spec_set_val(target,sp_map_ptr,map_root);
 
             break;
 
@@ -7702,83 +6832,30 @@ case p_less :
           *  We have to convert the value set to a single element.
           */
 
-         set_work_hdr = set_root;
-         source_height = set_root->s_ntype.s_root.s_height;
-         source_index = 0;
-         set_cell = NULL;
-
-         for (;;) {
-
-            /* if we're at a leaf, look for the cell */
-
-            if (!source_height) {
-
-               for (source_index = 0;
-                    source_index < SET_HASH_SIZE && set_cell == NULL;
-                    source_index++) {
-
-                  set_cell = set_work_hdr->s_child[source_index].s_cell;
-
-               }
-
-               if (set_cell != NULL)
-                  break;
-
-            }
-
-            /* move up if we're at the end of a node */
-
-            if (source_index >= SET_HASH_SIZE) {
-
-               /* if we return to the root the set is exhausted */
+         set_cursor_start(&set_cursor,set_root->s_trie);
+         set_cell = set_cursor_next(&set_cursor);
 
 #ifdef TRAPS
 
-               if (set_work_hdr == set_root)
-                  trap(__FILE__,__LINE__,msg_missing_set_element);
+         if (set_cell == NULL)
+            trap(__FILE__,__LINE__,msg_missing_set_element);
 
 #endif
 
-               source_height++;
-               source_index =
-                   set_work_hdr->s_ntype.s_intern.s_child_index + 1;
-               set_work_hdr = set_work_hdr->s_ntype.s_intern.s_parent;
-
-               continue;
-
-            }
-
-            /* skip over null nodes */
-
-            if (set_work_hdr->s_child[source_index].s_header == NULL) {
-
-               source_index++;
-               continue;
-
-            }
-
-            /* otherwise drop down a level */
-
-            set_work_hdr = set_work_hdr->s_child[source_index].s_header;
-            source_index = 0;
-            source_height--;
-
-         }
-
          /* now we have the set element in set_cell */
 
          mark_specifier(&(set_cell->s_spec));
-         map_cell->m_range_spec.sp_form = set_cell->s_spec.sp_form;
-         map_cell->m_range_spec.sp_val.sp_biggest =
-            set_cell->s_spec.sp_val.sp_biggest;
+         spec_set_form(&map_cell->m_range_spec,spec_form(&set_cell->s_spec));
+         spec_set_val(&map_cell->m_range_spec,sp_biggest,
+            spec_val(&set_cell->s_spec,sp_biggest));
          map_cell->m_is_multi_val = NO;
          free_set(SETL_SYSTEM set_root);
 
          /* set the target */
 
          unmark_specifier(target);
-         target->sp_form = ft_map;
-         target->sp_val.sp_map_ptr = map_root;
+         spec_set_form(target,ft_map);
+         spec_set_val(target,sp_map_ptr,map_root);
 
          break;
 
@@ -7809,7 +6886,7 @@ case p_less :
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -7876,6 +6953,7 @@ PRTYPE void set_ops3(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_lessf :
+opcode_label(p_lessf)
 
 {
 
@@ -7885,7 +6963,7 @@ case p_lessf :
    left = ip->i_operand[1].i_spec_ptr;
    right = ip->i_operand[2].i_spec_ptr;
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_set :
 
@@ -7926,7 +7004,7 @@ case p_lessf :
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -7967,6 +7045,7 @@ case p_lessf :
 \*/
 
 case p_ufrom : 
+opcode_label(p_ufrom)
 
 {
 
@@ -7978,7 +7057,7 @@ case p_ufrom :
 
    /* the action depends on the form of the right operand */
 
-   switch (right->sp_form) {
+   switch (spec_form(right)) {
 
       case ft_map :
 
@@ -8009,7 +7088,7 @@ case p_ufrom :
        */
 
       case ft_object :
-         object_root = right->sp_val.sp_object_ptr;
+         object_root = spec_val(right,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -8040,8 +7119,9 @@ case p_ufrom :
                         2,NO,YES,0);
          target = ip->i_operand[0].i_spec_ptr;
          unmark_specifier(target);
-         target->sp_form = pstack[pstack_top].sp_form;
-         target->sp_val.sp_biggest = pstack[pstack_top].sp_val.sp_biggest;
+         spec_set_form(target,spec_form(&pstack[pstack_top]));
+         spec_set_val(target,sp_biggest,
+                      spec_val(&pstack[pstack_top],sp_biggest));
          pstack_top--;
 
          break;
@@ -8073,6 +7153,7 @@ case p_ufrom :
 \*/
 
 case p_from : 
+opcode_label(p_from)
 
 {
 
@@ -8084,7 +7165,7 @@ case p_from :
 
    /* the action depends on the form of the right operand */
 
-   switch (right->sp_form) {
+   switch (spec_form(right)) {
 
       case ft_map :
 
@@ -8116,7 +7197,7 @@ case p_from :
 
       case ft_object :
 
-         object_root = right->sp_val.sp_object_ptr;
+         object_root = spec_val(right,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -8164,6 +7245,7 @@ case p_from :
 \*/
 
 case p_fromb :
+opcode_label(p_fromb)
 
 {
 
@@ -8175,7 +7257,7 @@ case p_fromb :
 
    /* the action depends on the form of the right operand */
 
-   switch (right->sp_form) {
+   switch (spec_form(right)) {
 
       case ft_tuple :
 
@@ -8197,7 +7279,7 @@ case p_fromb :
 
       case ft_object :
 
-         object_root = right->sp_val.sp_object_ptr;
+         object_root = spec_val(right,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -8246,6 +7328,7 @@ case p_fromb :
 \*/
 
 case p_frome :
+opcode_label(p_frome)
 
 {
 
@@ -8257,7 +7340,7 @@ case p_frome :
 
    /* the action depends on the form of the right operand */
 
-   switch (right->sp_form) {
+   switch (spec_form(right)) {
 
       case ft_tuple :
 
@@ -8279,7 +7362,7 @@ case p_frome :
 
       case ft_object :
 
-         object_root = right->sp_val.sp_object_ptr;
+         object_root = spec_val(right,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -8328,6 +7411,7 @@ case p_frome :
 \*/
 
 case p_npow :
+opcode_label(p_npow)
 
 {
 
@@ -8339,7 +7423,7 @@ case p_npow :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  If we have an integer on the left we look for a set on the
@@ -8348,16 +7432,16 @@ case p_npow :
 
       case ft_short :
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
-         if (right->sp_form == ft_set) {
+         if (spec_form(right) == ft_set) {
 
-            if (left->sp_val.sp_short_value < 0)
+            if (spec_val(left,sp_short_value) < 0)
                abend(SETL_SYSTEM msg_negative_npow,
                      abend_opnd_str(SETL_SYSTEM left));
 
-            set_npow(SETL_SYSTEM target,right,left->sp_val.sp_short_value);
+            set_npow(SETL_SYSTEM target,right,spec_val(left,sp_short_value));
 
             break;
 
@@ -8368,7 +7452,7 @@ case p_npow :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -8394,12 +7478,13 @@ case p_npow :
 
       case ft_long :
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
-         if (right->sp_form == ft_set) {
+         if (spec_form(right) == ft_set) {
 
-            short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
             if (short_value < 0)
                abend(SETL_SYSTEM msg_negative_npow,
                      abend_opnd_str(SETL_SYSTEM left));
@@ -8415,7 +7500,7 @@ case p_npow :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -8453,20 +7538,21 @@ case p_npow :
           *  We have to convert the right operand to a C long.
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            if (right->sp_val.sp_short_value < 0)
+            if (spec_val(right,sp_short_value) < 0)
                abend(SETL_SYSTEM msg_negative_npow,
                      abend_opnd_str(SETL_SYSTEM right));
 
-            set_npow(SETL_SYSTEM target,left,right->sp_val.sp_short_value);
+            set_npow(SETL_SYSTEM target,left,spec_val(right,sp_short_value));
 
             break;
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            short_value = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
 
             if (short_value < 0)
                abend(SETL_SYSTEM msg_negative_npow,
@@ -8483,7 +7569,7 @@ case p_npow :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -8534,7 +7620,7 @@ case p_npow :
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
             call_binop_method(SETL_SYSTEM target,
                               right,
@@ -8602,6 +7688,7 @@ PRTYPE void unary_ops(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_uminus :
+opcode_label(p_uminus)
 
 {
 
@@ -8612,7 +7699,7 @@ case p_uminus :
 
    /* the action we take depends on the form of the first operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  If the source is short, we reverse the sign and make sure the
@@ -8621,16 +7708,15 @@ case p_uminus :
 
       case ft_short :
 
-         short_value = -(left->sp_val.sp_short_value);
+         short_value = -(spec_val(left,sp_short_value));
 
          /* check whether the sum remains short */
 
-         if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-             short_hi_bits == INT_HIGH_BITS) {
+         if (is_short_value(short_value)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_value;
+            spec_set_form(target,ft_short);
+            spec_set_val(target,sp_short_value,short_value);
 
             break;
 
@@ -8643,34 +7729,13 @@ case p_uminus :
          break;
 
       /*
-       *  If the source is long, we reverse the sign and try to make it
-       *  into a short.  This is necessary since the acceptable
-       *  magnitudes of positive and negative shorts are not the same.
+       *  If the source is long, we reverse the sign.  Shorts range as
+       *  far below zero as above, so the result must be long.
        */
 
       case ft_long :
 
-         integer_hdr = left->sp_val.sp_long_ptr;
-
-         /* try to convert to short */
-
-         if (integer_hdr->i_cell_count < 3) {
-
-            short_value = -long_to_short(SETL_SYSTEM integer_hdr);
-
-            /* check whether it will fit in a short */
-
-            if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-                short_hi_bits == INT_HIGH_BITS) {
-
-               unmark_specifier(target);
-               target->sp_form = ft_short;
-               target->sp_val.sp_short_value = short_value;
-
-               break;
-
-            }
-         }
+         integer_hdr = spec_val(left,sp_long_ptr);
 
          /* we just flip the sign of the long */
 
@@ -8679,8 +7744,8 @@ case p_uminus :
             integer_hdr = copy_integer(SETL_SYSTEM integer_hdr);
             integer_hdr->i_is_negative = !(integer_hdr->i_is_negative);
             unmark_specifier(target);
-            target->sp_form = ft_long;
-            target->sp_val.sp_long_ptr = integer_hdr;
+            spec_set_form(target,ft_long);
+            spec_set_val(target,sp_long_ptr,integer_hdr);
 
             break;
 
@@ -8696,7 +7761,7 @@ case p_uminus :
 
       case ft_real :
 
-         real_number = -((left->sp_val.sp_real_ptr)->r_value);
+         real_number = -(spec_val(left,sp_real_value));
 
 #if INFNAN
 
@@ -8705,14 +7770,11 @@ case p_uminus :
 
 #endif
 
-         /* allocate a real */
+         /* set the target */
 
          unmark_specifier(target);
-         i_get_real(real_ptr);
-         target->sp_form = ft_real;
-         target->sp_val.sp_real_ptr = real_ptr;
-         real_ptr->r_use_count = 1;
-         real_ptr->r_value = real_number;
+         spec_set_form(target,ft_real);
+         spec_set_val(target,sp_real_value,real_number);
 
          break;
 
@@ -8724,7 +7786,7 @@ case p_uminus :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -8771,6 +7833,7 @@ case p_uminus :
 \*/
 
 case p_domain :
+opcode_label(p_domain)
 
 {
 
@@ -8781,7 +7844,7 @@ case p_domain :
 
    /* the action we take depends on the form of the first operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_set :
 
@@ -8803,7 +7866,7 @@ case p_domain :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -8850,6 +7913,7 @@ case p_domain :
 \*/
 
 case p_range :
+opcode_label(p_range)
 
 {
 
@@ -8860,7 +7924,7 @@ case p_range :
 
    /* the action we take depends on the form of the first operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_set :
 
@@ -8882,7 +7946,7 @@ case p_range :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -8929,6 +7993,7 @@ case p_range :
 \*/
 
 case p_pow :
+opcode_label(p_pow)
 
 {
 
@@ -8939,7 +8004,7 @@ case p_pow :
 
    /* the action we take depends on the form of the first operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_map :
 
@@ -8959,7 +8024,7 @@ case p_pow :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -9006,6 +8071,7 @@ case p_pow :
 \*/
 
 case p_arb :
+opcode_label(p_arb)
 
 {
 
@@ -9016,7 +8082,7 @@ case p_arb :
 
    /* the action we take depends on the form of the first operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_map :
 
@@ -9042,7 +8108,7 @@ case p_arb :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -9090,6 +8156,7 @@ case p_arb :
 \*/
 
 case p_nelt :
+opcode_label(p_nelt)
 
 {
 
@@ -9100,20 +8167,19 @@ case p_nelt :
 
    /* the action we take depends on the form of the first operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_string :
 
-         short_value = (left->sp_val.sp_string_ptr)->s_length;
+         short_value = spec_val(left,sp_string_ptr)->s_length;
 
          /* check whether the length is short */
 
-         if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-             short_hi_bits == INT_HIGH_BITS) {
+         if (is_short_value(short_value)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_value;
+            spec_set_form(target,ft_short);
+            spec_set_val(target,sp_short_value,short_value);
 
             break;
 
@@ -9128,16 +8194,15 @@ case p_nelt :
       case ft_set :
 
          short_value =
-               (left->sp_val.sp_set_ptr)->s_ntype.s_root.s_cardinality;
+               spec_val(left,sp_set_ptr)->s_cardinality;
 
          /* check whether the length is short */
 
-         if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-             short_hi_bits == INT_HIGH_BITS) {
+         if (is_short_value(short_value)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_value;
+            spec_set_form(target,ft_short);
+            spec_set_val(target,sp_short_value,short_value);
 
             break;
 
@@ -9152,16 +8217,15 @@ case p_nelt :
       case ft_map :
 
          short_value =
-               (left->sp_val.sp_map_ptr)->m_ntype.m_root.m_cardinality;
+               spec_val(left,sp_map_ptr)->m_cardinality;
 
          /* check whether the length is short */
 
-         if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-             short_hi_bits == INT_HIGH_BITS) {
+         if (is_short_value(short_value)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_value;
+            spec_set_form(target,ft_short);
+            spec_set_val(target,sp_short_value,short_value);
 
             break;
 
@@ -9176,16 +8240,15 @@ case p_nelt :
       case ft_tuple :
 
          short_value =
-               (left->sp_val.sp_tuple_ptr)->t_ntype.t_root.t_length;
+               spec_val(left,sp_tuple_ptr)->t_length;
 
          /* check whether the length is short */
 
-         if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-             short_hi_bits == INT_HIGH_BITS) {
+         if (is_short_value(short_value)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_value;
+            spec_set_form(target,ft_short);
+            spec_set_val(target,sp_short_value,short_value);
 
             break;
 
@@ -9200,16 +8263,15 @@ case p_nelt :
       case ft_mailbox :
 
          short_value =
-               (left->sp_val.sp_mailbox_ptr)->mb_cell_count;
+               spec_val(left,sp_mailbox_ptr)->mb_cell_count;
 
          /* check whether the length is short */
 
-         if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-             short_hi_bits == INT_HIGH_BITS) {
+         if (is_short_value(short_value)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_value;
+            spec_set_form(target,ft_short);
+            spec_set_val(target,sp_short_value,short_value);
 
             break;
 
@@ -9229,7 +8291,7 @@ case p_nelt :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -9285,6 +8347,7 @@ case p_nelt :
 \*/
 
 case p_not :
+opcode_label(p_not)
 
 {
 
@@ -9295,7 +8358,7 @@ case p_not :
 
    /* make sure the source is an atom */
 
-   if (left->sp_form != ft_atom) {
+   if (spec_form(left) != ft_atom) {
 
       abend(SETL_SYSTEM msg_bad_unop_form,"NOT",
             abend_opnd_str(SETL_SYSTEM left));
@@ -9304,18 +8367,18 @@ case p_not :
 
    /* reverse the logical value */
 
-   if (left->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num) {
+   if (spec_val(left,sp_atom_num) == spec_val(spec_true,sp_atom_num)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
    }
-   else if (left->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
+   else if (spec_val(left,sp_atom_num) == spec_val(spec_false,sp_atom_num)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
    }
    else {
@@ -9370,6 +8433,7 @@ PRTYPE void extract_ops1(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_tupof :
+opcode_label(p_tupof)
 
 {
 
@@ -9381,7 +8445,7 @@ case p_tupof :
 
    /* the left operand must be a tuple */
 
-   if (left->sp_form != ft_tuple) {
+   if (spec_form(left) != ft_tuple) {
 
       abend(SETL_SYSTEM msg_expected_tuple,
             abend_opnd_str(SETL_SYSTEM left));
@@ -9395,58 +8459,40 @@ case p_tupof :
 
    /* we convert the tuple index to a C long */
 
-   if (right->sp_form == ft_short) {
+   if (spec_form(right) == ft_short) {
 
-      short_value = right->sp_val.sp_short_value;
+      short_value = spec_val(right,sp_short_value);
 
    }
-   else if (right->sp_form == ft_long) {
+   else if (spec_form(right) == ft_long) {
 
-      short_value = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+      short_value = long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
 
    }
 
    /* look up the tuple component */
 
    short_value--;
-   tuple_work_hdr = left->sp_val.sp_tuple_ptr;
-
-   for (source_height = tuple_work_hdr->t_ntype.t_root.t_height;
-        source_height && tuple_work_hdr != NULL;
-        source_height--) {
-
-      /* extract the element's index at this level */
+   tuple_root = spec_val(left,sp_tuple_ptr);
 
-      source_index = (short_value >>
-                           (source_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
+   if (short_value >= 0 && short_value < tuple_root->t_length &&
+       is_packed(tuple_root)) {
 
-      tuple_work_hdr = tuple_work_hdr->t_child[source_index].t_header;
+      get_packed_element(tuple_root,short_value,&spare);
+      replace_target(target,&spare);
 
    }
+   else if (short_value >= 0 && short_value < tuple_root->t_length) {
 
-   /*
-    *  At this point, tuple_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   source_index = short_value & TUP_SHIFT_MASK;
-
-   if (tuple_work_hdr != NULL &&
-       (tuple_cell =
-           tuple_work_hdr->t_child[source_index].t_cell) != NULL) {
-
+      tuple_cell = tuple_cell_at(tuple_root,short_value);
       mark_specifier(&(tuple_cell->t_spec));
-      unmark_specifier(target);
-      target->sp_form = tuple_cell->t_spec.sp_form;
-      target->sp_val.sp_biggest =
-            tuple_cell->t_spec.sp_val.sp_biggest;
+      replace_target(target,&(tuple_cell->t_spec));
 
    }
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
    }
 
@@ -9466,6 +8512,7 @@ case p_tupof :
 \*/
 
 case p_of1 :   case p_kof1 :           
+opcode_label(p_of1) opcode_label(p_kof1)
 
 {
 
@@ -9477,7 +8524,7 @@ case p_of1 :   case p_kof1 :
 
    /* the action we take depends on the form of the left operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We reference strings in-line, since this should be very fast.
@@ -9486,22 +8533,23 @@ case p_of1 :   case p_kof1 :
       case ft_string :
 
          /* we convert the string index to a C long */
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            short_value = right->sp_val.sp_short_value;
+            short_value = spec_val(right,sp_short_value);
             if (short_value < 0)
-               short_value = left->sp_val.sp_string_ptr->s_length +
+               short_value = spec_val(left,sp_string_ptr)->s_length +
                              short_value + 1;
 
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            short_value = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
             if (short_value < 0)
-               short_value = left->sp_val.sp_string_ptr->s_length +
+               short_value = spec_val(left,sp_string_ptr)->s_length +
                              short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
@@ -9515,48 +8563,27 @@ case p_of1 :   case p_kof1 :
 
          /* if we reference past the end of the string, return omega */
 
-         left_string_hdr = left->sp_val.sp_string_ptr;
+         left_string_hdr = spec_val(left,sp_string_ptr);
          if (left_string_hdr->s_length < short_value) {
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
 
             break;
 
          }
 
-         /* traverse the cells until we find the character we want */
-
-         short_value--;
-         left_string_cell = left_string_hdr->s_head;
-         while (short_value >= STR_CELL_WIDTH) {
-
-            left_string_cell = left_string_cell->s_next;
-            short_value -= STR_CELL_WIDTH;
-
-         }
-
-         /* we found the cell, pull the character */
+         /* pull the character */
 
-         get_string_header(right_string_hdr);
-
-         right_string_hdr->s_use_count = 1;
-         right_string_hdr->s_hash_code = -1;
-         right_string_hdr->s_length = 1;
-
-         get_string_cell(right_string_cell);
-         right_string_hdr->s_head = right_string_hdr->s_tail =
-            right_string_cell;
-         right_string_cell->s_next = NULL;
-         right_string_cell->s_prev = NULL;
-         right_string_cell->s_cell_value[0] =
-            left_string_cell->s_cell_value[short_value];
+         right_string_hdr = new_string_buffer(SETL_SYSTEM 1);
+         right_string_hdr->s_chars[0] =
+            left_string_hdr->s_chars[short_value - 1];
 
          /* assign it to the target */
 
          unmark_specifier(target);
-         target->sp_form = ft_string;
-         target->sp_val.sp_string_ptr = right_string_hdr;
+         spec_set_form(target,ft_string);
+         spec_set_val(target,sp_string_ptr,right_string_hdr);
 
          break;
 
@@ -9571,158 +8598,84 @@ case p_of1 :   case p_kof1 :
 
       case ft_map :
 
-         spec_hash_code(work_hash_code,right);
-         source_hash_code = work_hash_code;
+         spec_hash_code(source_hash_code,right);
 
-         /* look up the map component */
+         /* look up the map component, removing it if we're killing it */
 
-         map_root = left->sp_val.sp_map_ptr;
+         map_root = spec_val(left,sp_map_ptr);
          if (ip->i_opcode==p_kof1) { 
             if (map_root->m_use_count != 1) {
 
               map_root->m_use_count--;
               map_root = copy_map(SETL_SYSTEM map_root);
-              left->sp_val.sp_map_ptr = map_root;
+              spec_set_val(left,sp_map_ptr,map_root);
 
             }
+            map_cell = map_unlink(&(map_root->m_trie),
+                                  right,
+                                  source_hash_code);
          }
-         map_work_hdr = map_root;
-
-         for (source_height = map_work_hdr->m_ntype.m_root.m_height;
-              source_height && map_work_hdr != NULL;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-            map_work_hdr = map_work_hdr->m_child[source_index].m_header;
-
+         else {
+            map_cell = map_lookup(map_root->m_trie,
+                                  right,
+                                  source_hash_code);
          }
 
-         /* if we can't get to a leaf, there is no matching element */
+         /* if we did't find the domain element, return omega */
 
-         if (map_work_hdr == NULL) {
+         if (map_cell == NULL) {
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
 
             break;
 
          }
 
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
+         /* if the map has multiple values here, return omega */
 
-         source_index = work_hash_code & MAP_HASH_MASK;
-         map_cell_tail = &(map_work_hdr->m_child[source_index].m_cell);
+         if (map_cell->m_is_multi_val) {
 
-         for (map_cell = map_work_hdr->m_child[source_index].m_cell;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < source_hash_code;
-              map_cell = map_cell->m_next) {
+            unmark_specifier(target);
+            spec_set_form(target,ft_omega);
 
-              map_cell_tail = &(map_cell->m_next);
 
-         }
+         } else {
 
-         /* try to find the domain element */
+         /* otherwise, we found it */
 
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == source_hash_code) {
+         mark_specifier(&(map_cell->m_range_spec));
+         replace_target(target,&(map_cell->m_range_spec));
 
-            spec_equal(is_equal,&(map_cell->m_domain_spec),right);
+         }
 
-            if (is_equal)
-               break;
-
-            map_cell_tail = &(map_cell->m_next);
-            map_cell = map_cell->m_next;
-
-         }
-
-         /* if we did't find the domain element, return omega */
-
-         if (!is_equal) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_omega;
-
-            break;
-
-         }
-
-         /* if the map has multiple values here, return omega */
-
-         if (map_cell->m_is_multi_val) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_omega;
-
-
-         } else {
-
-         /* otherwise, we found it */
-
-         mark_specifier(&(map_cell->m_range_spec));
-         unmark_specifier(target);
-         target->sp_form = map_cell->m_range_spec.sp_form;
-         target->sp_val.sp_biggest =
-            map_cell->m_range_spec.sp_val.sp_biggest;
-
-         }
-
-         if (ip->i_opcode==p_kof1) { /* Kill this value...*/
+         if (ip->i_opcode==p_kof1) { /* Kill this value...*/
 
             spec_hash_code(work_hash_code,&(map_cell->m_range_spec));
             map_root->m_hash_code ^= work_hash_code;
 
             if (map_cell->m_is_multi_val) {
 
-               set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-               map_root->m_ntype.m_root.m_cardinality -=
-                     set_root->s_ntype.s_root.s_cardinality;
+               set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+               map_root->m_cardinality -=
+                     set_root->s_cardinality;
 
-               if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+               if ((set_root->s_cardinality%2)==0) 
                   map_root->m_hash_code ^= map_cell->m_hash_code;
 
             }
             else {
 
-               map_root->m_ntype.m_root.m_cardinality--;
+               map_root->m_cardinality--;
 
             }
 
             map_root->m_hash_code ^= map_cell->m_hash_code;
-            *map_cell_tail = map_cell->m_next;
             unmark_specifier(&(map_cell->m_domain_spec));
             unmark_specifier(&(map_cell->m_range_spec));
-            map_root->m_ntype.m_root.m_cell_count--;
+            map_root->m_cell_count--;
             free_map_cell(map_cell);
 
-            /*
-             *  We've reduced the number of cells, so we may have to
-             *  contract the map header.
-             */
-
-            contraction_trigger =
-                  (1 << ((map_root->m_ntype.m_root.m_height)
-                          * MAP_SHIFT_DIST));
-            if (contraction_trigger == 1)
-               contraction_trigger = 0;
-
-            if (map_root->m_ntype.m_root.m_cell_count <
-                contraction_trigger) {
-
-               map_root = map_contract_header(SETL_SYSTEM map_root);
-               left->sp_val.sp_map_ptr = map_root;
-
-            }
-
          }
 
          break;
@@ -9736,23 +8689,24 @@ case p_of1 :   case p_kof1 :
 
          /* we convert the tuple index to a C long */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            short_value = right->sp_val.sp_short_value;
+            short_value = spec_val(right,sp_short_value);
             if (short_value < 0)
                short_value =
-                  left->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(left,sp_tuple_ptr)->t_length +
                   short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            short_value = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
             if (short_value < 0)
                short_value =
-                  left->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(left,sp_tuple_ptr)->t_length +
                   short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
@@ -9768,197 +8722,53 @@ case p_of1 :   case p_kof1 :
 
          short_value--;
 
-         tuple_root = left->sp_val.sp_tuple_ptr;
+         tuple_root = spec_val(left,sp_tuple_ptr);
          if (ip->i_opcode==p_kof1) { 
             if (tuple_root->t_use_count != 1) {
 
               tuple_root->t_use_count--;
               tuple_root = copy_tuple(SETL_SYSTEM tuple_root);
-              left->sp_val.sp_tuple_ptr = tuple_root;
+              spec_set_val(left,sp_tuple_ptr,tuple_root);
 
             }
+            unpack_tuple(tuple_root);
          }
-         tuple_work_hdr = tuple_root;
 
          /* if we reference past the end of the tuple, return omega */
 
-         if (tuple_work_hdr->t_ntype.t_root.t_length <= short_value) {
+         if (tuple_root->t_length <= short_value) {
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
 
             break;
 
          }
 
-         for (source_height = tuple_work_hdr->t_ntype.t_root.t_height;
-              source_height && tuple_work_hdr != NULL;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = (short_value >>
-                                 (source_height * TUP_SHIFT_DIST)) &
-                              TUP_SHIFT_MASK;
-
-            tuple_work_hdr = tuple_work_hdr->t_child[source_index].t_header;
-
-         }
-
-         /*
-          *  At this point, tuple_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
-
-         source_index = short_value & TUP_SHIFT_MASK;
-
-         if (tuple_work_hdr != NULL &&
-             (tuple_cell =
-                 tuple_work_hdr->t_child[source_index].t_cell) != NULL) {
-
-            mark_specifier(&(tuple_cell->t_spec));
-            unmark_specifier(target);
-            target->sp_form = tuple_cell->t_spec.sp_form;
-            target->sp_val.sp_biggest =
-               tuple_cell->t_spec.sp_val.sp_biggest;
-
-         }
-         else {
-
-            unmark_specifier(target);
-            target->sp_form = ft_omega;
-
-         }
-         if (ip->i_opcode==p_kof1) {
-
-
-         if  (short_value == (tuple_root->t_ntype.t_root.t_length - 1)) {
-
-            /* first free the tuple cell */
-
-            if (tuple_cell != NULL) {
-
-               tuple_root->t_hash_code ^=
-                     tuple_cell->t_hash_code;
-               unmark_specifier(&(tuple_cell->t_spec));
-               free_tuple_cell(tuple_cell);
-               tuple_work_hdr->t_child[source_index].t_cell = NULL;
+         /* packed elements need no hold */
 
-            }
-
-            /* now shorten the tuple while the rightmost element is omega */
-
-            for (;;) {
-
-               if (!source_height && source_index >= 0) {
-
-                  if (tuple_work_hdr->t_child[source_index].t_cell != NULL)
-                     break;
-
-                  tuple_root->t_ntype.t_root.t_length--;
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* move up if we're at the end of a node */
-
-               if (source_index < 0) {
-
-                  if (tuple_work_hdr == tuple_root)
-                     break;
-
-                  source_height++;
-                  source_index =
-                     tuple_work_hdr->t_ntype.t_intern.t_child_index;
-                  tuple_work_hdr =
-                     tuple_work_hdr->t_ntype.t_intern.t_parent;
-                  free_tuple_header(
-                     tuple_work_hdr->t_child[source_index].t_header);
-                  tuple_work_hdr->t_child[source_index].t_header = NULL;
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* skip over null nodes */
-
-               if (tuple_work_hdr->t_child[source_index].t_header == NULL) {
-
-                  tuple_root->t_ntype.t_root.t_length -=
-                        1 << (source_height * TUP_SHIFT_DIST);
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* otherwise drop down a level */
-
-               tuple_work_hdr =
-                  tuple_work_hdr->t_child[source_index].t_header;
-               source_index = TUP_HEADER_SIZE - 1;
-
-               source_height--;
-
-            }
-
-            /* we've shortened the tuple -- now reduce the height */
-
-            while (tuple_root->t_ntype.t_root.t_height > 0 &&
-                   tuple_root->t_ntype.t_root.t_length <=
-                      (int32)(1L << (tuple_root->t_ntype.t_root.t_height *
-                                    TUP_SHIFT_DIST))) {
-
-               tuple_work_hdr = tuple_root->t_child[0].t_header;
+         if (is_packed(tuple_root)) {
 
-               /* it's possible that we deleted internal headers */
-
-               if (tuple_work_hdr == NULL) {
-
-                  tuple_root->t_ntype.t_root.t_height--;
-                  continue;
-
-               }
-
-               /* delete the root node */
-
-               tuple_work_hdr->t_use_count = tuple_root->t_use_count;
-               tuple_work_hdr->t_hash_code =
-                     tuple_root->t_hash_code;
-               tuple_work_hdr->t_ntype.t_root.t_length =
-                     tuple_root->t_ntype.t_root.t_length;
-               tuple_work_hdr->t_ntype.t_root.t_height =
-                     tuple_root->t_ntype.t_root.t_height - 1;
-
-               free_tuple_header(tuple_root);
-               tuple_root = tuple_work_hdr;
-               left->sp_val.sp_tuple_ptr = tuple_root;
-
-            }
+            get_packed_element(tuple_root,short_value,&spare);
+            replace_target(target,&spare);
 
             break;
 
          }
 
-         /* we aren't assigning omega, or we're not at the end of a tuple */
-
-         if (tuple_cell == NULL) {
+         tuple_cell = tuple_cell_at(tuple_root,short_value);
+         mark_specifier(&(tuple_cell->t_spec));
+         replace_target(target,&(tuple_cell->t_spec));
 
-	    break;
+         /* a kill reference leaves omega behind in the tuple */
 
-         } else {
+         if (ip->i_opcode==p_kof1) {
 
             unmark_specifier(&(tuple_cell->t_spec));
-            tuple_root->t_hash_code ^=
-                  tuple_cell->t_hash_code;
-            free_tuple_cell(tuple_cell);
-            tuple_work_hdr->t_child[source_index].t_cell = NULL;
-            break;
-
-         }
+            tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
+            spec_set_form(&tuple_cell->t_spec,ft_omega);
+            tuple_cell->t_hash_code = 0;
+            trim_tuple(tuple_root);
 
          }
 
@@ -9989,7 +8799,7 @@ case p_of1 :   case p_kof1 :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -10017,11 +8827,11 @@ case p_of1 :   case p_kof1 :
 #ifdef WIN32
       case ft_opaque :
 		
-		 if (left->sp_val.sp_opaque_ptr->type!=ax_type) 
+		 if (spec_val(left,sp_opaque_ptr)->type!=ax_type) 
             abend(SETL_SYSTEM "Invalid opaque object");
                   
 	
-		 if (right->sp_form!=ft_string)
+		 if (spec_form(right)!=ft_string)
 			 abend(SETL_SYSTEM "Invalid property of method");
 
 
@@ -10089,6 +8899,7 @@ PRTYPE void extract_ops2(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_of :             
+opcode_label(p_of)
 
 {
 
@@ -10099,7 +8910,7 @@ case p_of :
 
    /* the action we take depends on the form of the left operand */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  Strings and tuples are special errors.
@@ -10135,97 +8946,31 @@ case p_of :
          /* skip trailing omegas */
 
          for (;
-              short_value > 0 && pstack[pstack_top].sp_form == ft_omega;
+              short_value > 0 && spec_form(&pstack[pstack_top]) == ft_omega;
               short_value--) {
 
             pop_pstack;
 
          }
 
-         /* first we calculate the height of the new header tree */
+         /* allocate and initialize the tuple */
 
-         target_height = 0;
-         work_length = short_value;
-         while (work_length = work_length >> TUP_SHIFT_DIST)
-            target_height++;
-
-         /* allocate and initialize the root header item */
-
-         get_tuple_header(tuple_root);
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code = 0;
-         tuple_root->t_ntype.t_root.t_length = short_value;
-         tuple_root->t_ntype.t_root.t_height = target_height;
-
-         for (i = 0;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_cell = NULL);
+         tuple_root = new_tuple(SETL_SYSTEM_VOID);
+         reserve_tuple(tuple_root,short_value);
+         tuple_root->t_length = short_value;
 
-         /* insert each element in the tuple */
+         /* insert each element in the tuple (omegas have a zero hash code) */
 
-         target_number = 0;
+         tuple_cell = tuple_root->t_cells;
          for (target_element = pstack + (pstack_top + 1 - short_value);
-              target_number < short_value;
-              target_element++, target_number++) {
-
-            /* don't insert omegas */
-
-            if (target_element->sp_form == ft_omega)
-               continue;
-
-            /* descend the header tree until we get to a leaf */
-
-            tuple_work_hdr = tuple_root;
-            for (target_height = tuple_root->t_ntype.t_root.t_height;
-                 target_height;
-                 target_height--) {
-
-               /* extract the element's index at this level */
-
-               target_index = (target_number >>
-                                    (target_height * TUP_SHIFT_DIST)) &
-                                 TUP_SHIFT_MASK;
-
-               /* if we're missing a header record, allocate one */
-
-               if (tuple_work_hdr->t_child[target_index].t_header == NULL) {
-
-                  get_tuple_header(new_tuple_hdr);
-                  new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-                  new_tuple_hdr->t_ntype.t_intern.t_child_index =
-                     target_index;
-
-                  for (i = 0;
-                       i < TUP_HEADER_SIZE;
-                       new_tuple_hdr->t_child[i++].t_cell = NULL);
-
-                  tuple_work_hdr->t_child[target_index].t_header =
-                     new_tuple_hdr;
-                  tuple_work_hdr = new_tuple_hdr;
-
-               }
-               else {
-
-                  tuple_work_hdr =
-                     tuple_work_hdr->t_child[target_index].t_header;
-
-               }
-            }
-
-            /*
-             *  At this point, tuple_work_hdr points to the lowest level
-             *  header record.  We insert the new element in the
-             *  appropriate slot.
-             */
+              target_element <= pstack + pstack_top;
+              target_element++, tuple_cell++) {
 
             mark_specifier(target_element);
-            get_tuple_cell(tuple_cell);
-            tuple_cell->t_spec.sp_form = target_element->sp_form;
-            tuple_cell->t_spec.sp_val.sp_biggest =
-               target_element->sp_val.sp_biggest;
+            spec_set_form(&tuple_cell->t_spec,spec_form(target_element));
+            spec_set_val(&tuple_cell->t_spec,sp_biggest,
+               spec_val(target_element,sp_biggest));
             spec_hash_code(tuple_cell->t_hash_code,target_element);
-            target_index = target_number & TUP_SHIFT_MASK;
-            tuple_work_hdr->t_child[target_index].t_cell = tuple_cell;
             tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
 
          }
@@ -10238,78 +8983,27 @@ case p_of :
 
          /* set the target value */
 
-         spare.sp_form = ft_tuple;
-         spare.sp_val.sp_tuple_ptr = tuple_root;
+         spec_set_form(&spare,ft_tuple);
+         spec_set_val(&spare,sp_tuple_ptr,tuple_root);
 
          /* spare is now our key */
 
-         spec_hash_code(work_hash_code,&spare);
-         source_hash_code = work_hash_code;
+         spec_hash_code(source_hash_code,&spare);
 
          /* look up the map component */
 
-         map_work_hdr = left->sp_val.sp_map_ptr;
-
-         for (source_height = map_work_hdr->m_ntype.m_root.m_height;
-              source_height && map_work_hdr != NULL;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code >>= MAP_SHIFT_DIST;
-
-            map_work_hdr = map_work_hdr->m_child[source_index].m_header;
-
-         }
-
-         /* if we can't get to a leaf, there is no matching element */
-
-         if (map_work_hdr == NULL) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_omega;
-            unmark_specifier(&spare);
-            spare.sp_form = ft_omega;
-
-            break;
-
-         }
-
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
-
-         source_index = work_hash_code & MAP_HASH_MASK;
-         for (map_cell = map_work_hdr->m_child[source_index].m_cell;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < source_hash_code;
-              map_cell = map_cell->m_next);
-
-         /* try to find the domain element */
-
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == source_hash_code) {
-
-            spec_equal(is_equal,&(map_cell->m_domain_spec),&spare);
-
-            if (is_equal)
-               break;
-
-            map_cell = map_cell->m_next;
-
-         }
+         map_cell = map_lookup(spec_val(left,sp_map_ptr)->m_trie,
+                               &spare,
+                               source_hash_code);
 
          /* if we did't find the domain element, return omega */
 
-         if (!is_equal) {
+         if (map_cell == NULL) {
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
             unmark_specifier(&spare);
-            spare.sp_form = ft_omega;
+            spec_set_form(&spare,ft_omega);
 
             break;
 
@@ -10320,9 +9014,9 @@ case p_of :
          if (map_cell->m_is_multi_val) {
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
             unmark_specifier(&spare);
-            spare.sp_form = ft_omega;
+            spec_set_form(&spare,ft_omega);
 
             break;
 
@@ -10331,12 +9025,9 @@ case p_of :
          /* otherwise, we found it */
 
          mark_specifier(&(map_cell->m_range_spec));
-         unmark_specifier(target);
-         target->sp_form = map_cell->m_range_spec.sp_form;
-         target->sp_val.sp_biggest =
-            map_cell->m_range_spec.sp_val.sp_biggest;
+         replace_target(target,&(map_cell->m_range_spec));
          unmark_specifier(&spare);
-         spare.sp_form = ft_omega;
+         spec_set_form(&spare,ft_omega);
 
          break;
 
@@ -10369,97 +9060,31 @@ case p_of :
          /* skip trailing omegas */
 
          for (;
-              short_value > 0 && pstack[pstack_top].sp_form == ft_omega;
+              short_value > 0 && spec_form(&pstack[pstack_top]) == ft_omega;
               short_value--) {
 
             pop_pstack;
 
          }
 
-         /* first we calculate the height of the new header tree */
-
-         target_height = 0;
-         work_length = short_value;
-         while (work_length = work_length >> TUP_SHIFT_DIST)
-            target_height++;
-
-         /* allocate and initialize the root header item */
+         /* allocate and initialize the tuple */
 
-         get_tuple_header(tuple_root);
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code = 0;
-         tuple_root->t_ntype.t_root.t_length = short_value;
-         tuple_root->t_ntype.t_root.t_height = target_height;
+         tuple_root = new_tuple(SETL_SYSTEM_VOID);
+         reserve_tuple(tuple_root,short_value);
+         tuple_root->t_length = short_value;
 
-         for (i = 0;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_cell = NULL);
-
-         /* insert each element in the tuple */
+         /* insert each element in the tuple (omegas have a zero hash code) */
 
-         target_number = 0;
+         tuple_cell = tuple_root->t_cells;
          for (target_element = pstack + (pstack_top + 1 - short_value);
-              target_number < short_value;
-              target_element++, target_number++) {
-
-            /* don't insert omegas */
-
-            if (target_element->sp_form == ft_omega)
-               continue;
-
-            /* descend the header tree until we get to a leaf */
-
-            tuple_work_hdr = tuple_root;
-            for (target_height = tuple_root->t_ntype.t_root.t_height;
-                 target_height;
-                 target_height--) {
-
-               /* extract the element's index at this level */
-
-               target_index = (target_number >>
-                                    (target_height * TUP_SHIFT_DIST)) &
-                                 TUP_SHIFT_MASK;
-
-               /* if we're missing a header record, allocate one */
-
-               if (tuple_work_hdr->t_child[target_index].t_header == NULL) {
-
-                  get_tuple_header(new_tuple_hdr);
-                  new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-                  new_tuple_hdr->t_ntype.t_intern.t_child_index =
-                     target_index;
-
-                  for (i = 0;
-                       i < TUP_HEADER_SIZE;
-                       new_tuple_hdr->t_child[i++].t_cell = NULL);
-
-                  tuple_work_hdr->t_child[target_index].t_header =
-                     new_tuple_hdr;
-                  tuple_work_hdr = new_tuple_hdr;
-
-               }
-               else {
-
-                  tuple_work_hdr =
-                     tuple_work_hdr->t_child[target_index].t_header;
-
-               }
-            }
-
-            /*
-             *  At this point, tuple_work_hdr points to the lowest level
-             *  header record.  We insert the new element in the
-             *  appropriate slot.
-             */
+              target_element <= pstack + pstack_top;
+              target_element++, tuple_cell++) {
 
             mark_specifier(target_element);
-            get_tuple_cell(tuple_cell);
-            tuple_cell->t_spec.sp_form = target_element->sp_form;
-            tuple_cell->t_spec.sp_val.sp_biggest =
-               target_element->sp_val.sp_biggest;
+            spec_set_form(&tuple_cell->t_spec,spec_form(target_element));
+            spec_set_val(&tuple_cell->t_spec,sp_biggest,
+               spec_val(target_element,sp_biggest));
             spec_hash_code(tuple_cell->t_hash_code,target_element);
-            target_index = target_number & TUP_SHIFT_MASK;
-            tuple_work_hdr->t_child[target_index].t_cell = tuple_cell;
             tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
 
          }
@@ -10472,18 +9097,18 @@ case p_of :
 
          /* set spare to the tuple */
 
-         spare.sp_form = ft_tuple;
-         spare.sp_val.sp_tuple_ptr = tuple_root;
+         spec_set_form(&spare,ft_tuple);
+         spec_set_val(&spare,sp_tuple_ptr,tuple_root);
 
          /* we push our argument on to the stack */
 
          push_pstack(&spare);
          unmark_specifier(&spare);
-         spare.sp_form = ft_omega;
+         spec_set_form(&spare,ft_omega);
 
          /* pick out the class pointer */
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -10532,6 +9157,7 @@ case p_of :
 \*/
 
 case p_ofa :          case p_kofa : 
+opcode_label(p_ofa) opcode_label(p_kofa)
 
 {
 
@@ -10541,7 +9167,7 @@ case p_ofa :          case p_kofa :
    left = ip->i_operand[1].i_spec_ptr;
    right = ip->i_operand[2].i_spec_ptr;
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_set :
 
@@ -10550,90 +9176,37 @@ case p_ofa :          case p_kofa :
 
       case ft_map :
 
-         spec_hash_code(work_hash_code,right);
-         source_hash_code = work_hash_code;
+         spec_hash_code(source_hash_code,right);
 
-         /* look up the map component */
+         /* look up the map component, removing it if we're killing it */
 
-         map_root = left->sp_val.sp_map_ptr;
+         map_root = spec_val(left,sp_map_ptr);
          if (ip->i_opcode==p_kofa) { 
             if (map_root->m_use_count != 1) {
 
                map_root->m_use_count--;
                map_root = copy_map(SETL_SYSTEM map_root);
-               left->sp_val.sp_map_ptr = map_root;
+               spec_set_val(left,sp_map_ptr,map_root);
 
             }
+            map_cell = map_unlink(&(map_root->m_trie),
+                                  right,
+                                  source_hash_code);
          }
-
-         map_work_hdr = map_root;
-
-         for (source_height = map_work_hdr->m_ntype.m_root.m_height;
-              source_height && map_work_hdr != NULL;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-            map_work_hdr = map_work_hdr->m_child[source_index].m_header;
-
-         }
-
-         /* if we can't get to a leaf, there is no matching element */
-
-         if (map_work_hdr == NULL) {
-
-            mark_specifier(spec_nullset);
-            unmark_specifier(target);
-            target->sp_form = ft_set;
-            target->sp_val.sp_set_ptr = spec_nullset->sp_val.sp_set_ptr;
-
-            break;
-
-         }
-
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
-
-
-         source_index = work_hash_code & MAP_HASH_MASK;
-         map_cell_tail = &(map_work_hdr->m_child[source_index].m_cell);
-         for (map_cell = map_work_hdr->m_child[source_index].m_cell;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < source_hash_code;
-              map_cell = map_cell->m_next) {
-
-              map_cell_tail = &(map_cell->m_next);
-         }
-
-         /* try to find the domain element */
-
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == source_hash_code) {
-
-            spec_equal(is_equal,&(map_cell->m_domain_spec),right);
-
-            if (is_equal)
-               break;
-
-            map_cell_tail = &(map_cell->m_next);
-            map_cell = map_cell->m_next;
-
+         else {
+            map_cell = map_lookup(map_root->m_trie,
+                                  right,
+                                  source_hash_code);
          }
 
          /* if we did't find the domain element, return an empty set */
 
-         if (!is_equal) {
+         if (map_cell == NULL) {
 
             mark_specifier(spec_nullset);
             unmark_specifier(target);
-            target->sp_form = ft_set;
-            target->sp_val.sp_set_ptr = spec_nullset->sp_val.sp_set_ptr;
+            spec_set_form(target,ft_set);
+            spec_set_val(target,sp_set_ptr,spec_val(spec_nullset,sp_set_ptr));
 
             break;
 
@@ -10644,40 +9217,24 @@ case p_ofa :          case p_kofa :
          if (map_cell->m_is_multi_val) {
 
             mark_specifier(&(map_cell->m_range_spec));
-            unmark_specifier(target);
-            target->sp_form = ft_set;
-            target->sp_val.sp_set_ptr =
-               map_cell->m_range_spec.sp_val.sp_set_ptr;
+            replace_target(target,&(map_cell->m_range_spec));
 
 
          } else {
 
          /* otherwise, we must make a singleton set */
 
-         get_set_header(set_root);
-         set_root->s_use_count = 1;
-         set_root->s_ntype.s_root.s_cardinality = 1;
-         set_root->s_ntype.s_root.s_height = 0;
-         for (i = 0;
-              i < SET_HASH_SIZE;
-              set_root->s_child[i++].s_cell = NULL);
-
+         set_root = null_set(SETL_SYSTEM_VOID);
          spec_hash_code(work_hash_code,&(map_cell->m_range_spec));
-         set_root->s_hash_code = work_hash_code;
-         get_set_cell(set_cell);
-         set_cell->s_spec.sp_form = map_cell->m_range_spec.sp_form;
-         set_cell->s_spec.sp_val.sp_biggest =
-               map_cell->m_range_spec.sp_val.sp_biggest;
-         mark_specifier(&(set_cell->s_spec));
-         set_cell->s_hash_code = work_hash_code;
-         set_cell->s_next = NULL;
-         set_root->s_child[work_hash_code & SET_HASH_MASK].s_cell = set_cell;
+         set_insert(SETL_SYSTEM set_root,
+                    &(map_cell->m_range_spec),
+                    work_hash_code);
 
          /* assign the singleton set to the target */
 
          unmark_specifier(target);
-         target->sp_form = ft_set;
-         target->sp_val.sp_set_ptr = set_root;
+         spec_set_form(target,ft_set);
+         spec_set_val(target,sp_set_ptr,set_root);
 
          }
 
@@ -10688,46 +9245,26 @@ case p_ofa :          case p_kofa :
 
             if (map_cell->m_is_multi_val) {
 
-               set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-               map_root->m_ntype.m_root.m_cardinality -=
-                     set_root->s_ntype.s_root.s_cardinality;
+               set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+               map_root->m_cardinality -=
+                     set_root->s_cardinality;
 
-               if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+               if ((set_root->s_cardinality%2)==0) 
                   map_root->m_hash_code ^= map_cell->m_hash_code;
 
             }
             else {
 
-               map_root->m_ntype.m_root.m_cardinality--;
+               map_root->m_cardinality--;
 
             }
 
             map_root->m_hash_code ^= map_cell->m_hash_code;
-            *map_cell_tail = map_cell->m_next;
             unmark_specifier(&(map_cell->m_domain_spec));
             unmark_specifier(&(map_cell->m_range_spec));
-            map_root->m_ntype.m_root.m_cell_count--;
+            map_root->m_cell_count--;
             free_map_cell(map_cell);
 
-            /*
-             *  We've reduced the number of cells, so we may have to
-             *  contract the map header.
-             */
-
-            contraction_trigger =
-                  (1 << ((map_root->m_ntype.m_root.m_height)
-                          * MAP_SHIFT_DIST));
-            if (contraction_trigger == 1)
-               contraction_trigger = 0;
-
-            if (map_root->m_ntype.m_root.m_cell_count <
-                contraction_trigger) {
-
-               map_root = map_contract_header(SETL_SYSTEM map_root);
-               left->sp_val.sp_map_ptr = map_root;
-
-            }
-
          }
 
          break;
@@ -10740,7 +9277,7 @@ case p_ofa :          case p_kofa :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -10820,6 +9357,7 @@ PRTYPE void extract_ops3(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_slice :
+opcode_label(p_slice)
 
 {
 
@@ -10831,27 +9369,28 @@ case p_slice :
    end = PC->i_operand[0].i_spec_ptr;
    BUMPPC(1);
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_string :
 
          /* we convert the slice front to a C long */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            slice_start = right->sp_val.sp_short_value;
+            slice_start = spec_val(right,sp_short_value);
             if (slice_start <= 0)
-               slice_start = left->sp_val.sp_string_ptr->s_length +
+               slice_start = spec_val(left,sp_string_ptr)->s_length +
                              slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            slice_start = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            slice_start =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
             if (slice_start <= 0)
-               slice_start = left->sp_val.sp_string_ptr->s_length +
+               slice_start = spec_val(left,sp_string_ptr)->s_length +
                              slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
@@ -10865,21 +9404,21 @@ case p_slice :
 
          /* we convert the slice end to a C long */
 
-         if (end->sp_form == ft_short) {
+         if (spec_form(end) == ft_short) {
 
-            slice_end = end->sp_val.sp_short_value;
+            slice_end = spec_val(end,sp_short_value);
             if (slice_end < 0)
-               slice_end = left->sp_val.sp_string_ptr->s_length +
+               slice_end = spec_val(left,sp_string_ptr)->s_length +
                            slice_end + 1;
             if (slice_end < 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM end));
 
          }
-         else if (end->sp_form == ft_long) {
+         else if (spec_form(end) == ft_long) {
 
-            slice_end = long_to_short(SETL_SYSTEM end->sp_val.sp_long_ptr);
+            slice_end = long_to_short(SETL_SYSTEM spec_val(end,sp_long_ptr));
             if (slice_end < 0)
-               slice_end = left->sp_val.sp_string_ptr->s_length +
+               slice_end = spec_val(left,sp_string_ptr)->s_length +
                            slice_end + 1;
             if (slice_end < 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM end));
@@ -10901,91 +9440,26 @@ case p_slice :
 
          /* if we reference past the end of the string, abend */
 
-         left_string_hdr = left->sp_val.sp_string_ptr;
+         left_string_hdr = spec_val(left,sp_string_ptr);
          if (left_string_hdr->s_length < slice_end)
             abend(SETL_SYSTEM msg_invalid_slice_limits,
                   abend_opnd_str(SETL_SYSTEM left),
                   abend_opnd_str(SETL_SYSTEM right),
                   abend_opnd_str(SETL_SYSTEM end));
 
-         /* we start with a null string */
+         /* copy the slice, which is null if start = end + 1 */
 
-         get_string_header(target_string_hdr);
-         target_string_hdr->s_use_count = 1;
-         target_string_hdr->s_hash_code = -1;
-         target_string_hdr->s_length = 0;
-         target_string_hdr->s_head = target_string_hdr->s_tail = NULL;
+         target_string_hdr = new_string_chars(SETL_SYSTEM
+               left_string_hdr->s_chars + slice_start - 1,
+               slice_end - slice_start + 1);
 
-         /* if start = end + 1, return NULL */
+         /* assign our result to the target */
 
-         if (slice_start == slice_end + 1) {
+         unmark_specifier(target);
+         spec_set_form(target,ft_string);
+         spec_set_val(target,sp_string_ptr,target_string_hdr);
 
-            unmark_specifier(target);
-            target->sp_form = ft_string;
-            target->sp_val.sp_string_ptr = target_string_hdr;
-
-            break;
-
-         }
-
-         /* otherwise copy the slice */
-
-         target_string_length = slice_end - slice_start + 1;
-         target_string_hdr->s_length = target_string_length;
-
-         /* traverse the cells until we find the character we want */
-
-         slice_start--;
-         left_string_cell = left_string_hdr->s_head;
-         while (slice_start >= STR_CELL_WIDTH) {
-
-            left_string_cell = left_string_cell->s_next;
-            slice_start -= STR_CELL_WIDTH;
-
-         }
-
-         /* we just attach the left string to the target */
-
-         left_char_ptr = left_string_cell->s_cell_value + slice_start;
-         left_char_end = left_string_cell->s_cell_value + STR_CELL_WIDTH;
-         target_char_ptr = target_char_end = NULL;
-
-         while (target_string_length--) {
-
-            if (left_char_ptr == left_char_end) {
-
-               left_string_cell = left_string_cell->s_next;
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_string_cell);
-               if (target_string_hdr->s_tail != NULL)
-                  (target_string_hdr->s_tail)->s_next = target_string_cell;
-               target_string_cell->s_prev = target_string_hdr->s_tail;
-               target_string_cell->s_next = NULL;
-               target_string_hdr->s_tail = target_string_cell;
-               if (target_string_hdr->s_head == NULL)
-                  target_string_hdr->s_head = target_string_cell;
-               target_char_ptr = target_string_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *left_char_ptr++;
-
-         }
-
-         /* assign our result to the target */
-
-         unmark_specifier(target);
-         target->sp_form = ft_string;
-         target->sp_val.sp_string_ptr = target_string_hdr;
-
-         break;
+         break;
 
       /*
        *  We produce tuple slices in the tuple package, and hope that it
@@ -10996,23 +9470,24 @@ case p_slice :
 
          /* we convert the slice front to a C long */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            slice_start = right->sp_val.sp_short_value;
+            slice_start = spec_val(right,sp_short_value);
             if (slice_start <= 0)
                slice_start = 
-                  left->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(left,sp_tuple_ptr)->t_length +
                   slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            slice_start = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            slice_start =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
             if (slice_start <= 0)
                slice_start = 
-                  left->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(left,sp_tuple_ptr)->t_length +
                   slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
@@ -11026,23 +9501,23 @@ case p_slice :
 
          /* we convert the slice end to a C long */
 
-         if (end->sp_form == ft_short) {
+         if (spec_form(end) == ft_short) {
 
-            slice_end = end->sp_val.sp_short_value;
+            slice_end = spec_val(end,sp_short_value);
             if (slice_end < 0)
                slice_end = 
-                  left->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(left,sp_tuple_ptr)->t_length +
                   slice_end + 1;
             if (slice_end < 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
 
          }
-         else if (end->sp_form == ft_long) {
+         else if (spec_form(end) == ft_long) {
 
-            slice_end = long_to_short(SETL_SYSTEM end->sp_val.sp_long_ptr);
+            slice_end = long_to_short(SETL_SYSTEM spec_val(end,sp_long_ptr));
             if (slice_end < 0)
                slice_end = 
-                  left->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(left,sp_tuple_ptr)->t_length +
                   slice_end + 1;
             if (slice_end < 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
@@ -11064,8 +9539,8 @@ case p_slice :
 
          /* if we reference past the end of the tuple, abend */
 
-         tuple_root = left->sp_val.sp_tuple_ptr;
-         if (tuple_root->t_ntype.t_root.t_length < slice_end)
+         tuple_root = spec_val(left,sp_tuple_ptr);
+         if (tuple_root->t_length < slice_end)
             abend(SETL_SYSTEM msg_invalid_slice_limits,
                   abend_opnd_str(SETL_SYSTEM left),
                   abend_opnd_str(SETL_SYSTEM right),
@@ -11083,7 +9558,7 @@ case p_slice :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -11163,6 +9638,7 @@ PRTYPE void extract_ops4(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_end :
+opcode_label(p_end)
 
 {
 
@@ -11172,27 +9648,28 @@ case p_end :
    left = ip->i_operand[1].i_spec_ptr;
    right = ip->i_operand[2].i_spec_ptr;
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       case ft_string :
 
          /* we convert the slice front to a C long */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            slice_start = right->sp_val.sp_short_value;
+            slice_start = spec_val(right,sp_short_value);
             if (slice_start <= 0)
-               slice_start = left->sp_val.sp_string_ptr->s_length +
+               slice_start = spec_val(left,sp_string_ptr)->s_length +
                              slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            slice_start = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            slice_start =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
             if (slice_start <= 0)
-               slice_start = left->sp_val.sp_string_ptr->s_length +
+               slice_start = spec_val(left,sp_string_ptr)->s_length +
                              slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
@@ -11204,7 +9681,7 @@ case p_end :
 
          }
 
-         left_string_hdr = left->sp_val.sp_string_ptr;
+         left_string_hdr = spec_val(left,sp_string_ptr);
          slice_end = left_string_hdr->s_length;
 
          /* make sure start <= end + 1 */
@@ -11214,82 +9691,17 @@ case p_end :
                   abend_opnd_str(SETL_SYSTEM left),
                   abend_opnd_str(SETL_SYSTEM right));
 
-         /* we start with a null string */
-
-         get_string_header(target_string_hdr);
-         target_string_hdr->s_use_count = 1;
-         target_string_hdr->s_hash_code = -1;
-         target_string_hdr->s_length = 0;
-         target_string_hdr->s_head = target_string_hdr->s_tail = NULL;
+         /* copy the slice, which is null if start = end + 1 */
 
-         /* if start = end + 1, return NULL */
-
-         if (slice_start == slice_end + 1) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_string;
-            target->sp_val.sp_string_ptr = target_string_hdr;
-
-            break;
-
-         }
-
-         /* otherwise copy the slice */
-
-         target_string_length = slice_end - slice_start + 1;
-         target_string_hdr->s_length = target_string_length;
-
-         /* traverse the cells until we find the character we want */
-
-         slice_start--;
-         left_string_cell = left_string_hdr->s_head;
-         while (slice_start >= STR_CELL_WIDTH) {
-
-            left_string_cell = left_string_cell->s_next;
-            slice_start -= STR_CELL_WIDTH;
-
-         }
-
-         /* we just attach the left string to the target */
-
-         left_char_ptr = left_string_cell->s_cell_value + slice_start;
-         left_char_end = left_string_cell->s_cell_value + STR_CELL_WIDTH;
-         target_char_ptr = target_char_end = NULL;
-
-         while (target_string_length--) {
-
-            if (left_char_ptr == left_char_end) {
-
-               left_string_cell = left_string_cell->s_next;
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_string_cell);
-               if (target_string_hdr->s_tail != NULL)
-                  (target_string_hdr->s_tail)->s_next = target_string_cell;
-               target_string_cell->s_prev = target_string_hdr->s_tail;
-               target_string_cell->s_next = NULL;
-               target_string_hdr->s_tail = target_string_cell;
-               if (target_string_hdr->s_head == NULL)
-                  target_string_hdr->s_head = target_string_cell;
-               target_char_ptr = target_string_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *left_char_ptr++;
-
-         }
+         target_string_hdr = new_string_chars(SETL_SYSTEM
+               left_string_hdr->s_chars + slice_start - 1,
+               slice_end - slice_start + 1);
 
          /* assign our result to the target */
 
          unmark_specifier(target);
-         target->sp_form = ft_string;
-         target->sp_val.sp_string_ptr = target_string_hdr;
+         spec_set_form(target,ft_string);
+         spec_set_val(target,sp_string_ptr,target_string_hdr);
 
          break;
 
@@ -11302,23 +9714,24 @@ case p_end :
 
          /* we convert the slice front to a C long */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
-            slice_start = right->sp_val.sp_short_value;
+            slice_start = spec_val(right,sp_short_value);
             if (slice_start <= 0)
                slice_start = 
-                  left->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(left,sp_tuple_ptr)->t_length +
                   slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
 
          }
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
-            slice_start = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+            slice_start =
+               long_to_short(SETL_SYSTEM spec_val(right,sp_long_ptr));
             if (slice_start <= 0)
                slice_start = 
-                  left->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(left,sp_tuple_ptr)->t_length +
                   slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM right));
@@ -11330,8 +9743,7 @@ case p_end :
 
          }
 
-         tuple_work_hdr = left->sp_val.sp_tuple_ptr;
-         slice_end = tuple_work_hdr->t_ntype.t_root.t_length;
+         slice_end = spec_val(left,sp_tuple_ptr)->t_length;
 
          /* make sure start <= end + 1 */
 
@@ -11352,7 +9764,7 @@ case p_end :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -11433,6 +9845,7 @@ PRTYPE void assign_ops1(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_assign :
+opcode_label(p_assign)
 
 {
 
@@ -11448,8 +9861,8 @@ case p_assign :
 
    /* copy the specifier */
 
-   target->sp_form = left->sp_form;
-   target->sp_val.sp_biggest = left->sp_val.sp_biggest;
+   spec_set_form(target,spec_form(left));
+   spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
 
    break;
 
@@ -11466,6 +9879,7 @@ case p_assign :
 \*/
 
 case p_sof :  
+opcode_label(p_sof)
 
 {
 
@@ -11477,7 +9891,7 @@ case p_sof :
 
    /* the action we take depends on the form of the target operand */
 
-   switch (target->sp_form) {
+   switch (spec_form(target)) {
 
       /*
        *  We modify strings in-line, since this should be very fast.
@@ -11487,21 +9901,22 @@ case p_sof :
          
          /* we convert the string index to a C long */
 
-         if (left->sp_form == ft_short) {
+         if (spec_form(left) == ft_short) {
 
-            short_value = left->sp_val.sp_short_value;
+            short_value = spec_val(left,sp_short_value);
             if (short_value < 0)
-               short_value = target->sp_val.sp_string_ptr->s_length +
+               short_value = spec_val(target,sp_string_ptr)->s_length +
                              short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
          }
-         else if (left->sp_form == ft_long) {
+         else if (spec_form(left) == ft_long) {
 
-            short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
             if (short_value < 0)
-               short_value = target->sp_val.sp_string_ptr->s_length +
+               short_value = spec_val(target,sp_string_ptr)->s_length +
                              short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
@@ -11513,7 +9928,7 @@ case p_sof :
 
          }
 
-         left_string_hdr = target->sp_val.sp_string_ptr;
+         left_string_hdr = spec_val(target,sp_string_ptr);
 
          /* if we reference past the end of the string, abend */
 
@@ -11522,10 +9937,10 @@ case p_sof :
 
          /* the source must be a single character */
 
-         if (right->sp_form != ft_string)
+         if (spec_form(right) != ft_string)
             abend(SETL_SYSTEM msg_source_too_long);
 
-         right_string_hdr = right->sp_val.sp_string_ptr;
+         right_string_hdr = spec_val(right,sp_string_ptr);
          if (right_string_hdr->s_length != 1)
             abend(SETL_SYSTEM msg_source_too_long);
 
@@ -11535,26 +9950,15 @@ case p_sof :
 
             left_string_hdr->s_use_count--;
             left_string_hdr = copy_string(SETL_SYSTEM left_string_hdr);
-            target->sp_val.sp_string_ptr = left_string_hdr;
-
-         }
-
-         /* traverse the cells until we find the character we want */
-
-         short_value--;
-         left_string_cell = left_string_hdr->s_head;
-         while (short_value >= STR_CELL_WIDTH) {
-
-            left_string_cell = left_string_cell->s_next;
-            short_value -= STR_CELL_WIDTH;
+            spec_set_val(target,sp_string_ptr,left_string_hdr);
 
          }
 
          /* set the target character */
 
-         right_string_cell = right_string_hdr->s_head;
-         left_string_cell->s_cell_value[short_value] =
-            right_string_cell->s_cell_value[0];
+         left_string_hdr->s_chars[short_value - 1] =
+            right_string_hdr->s_chars[0];
+         left_string_hdr->s_hash_code = -1;
 
          break;
 
@@ -11570,94 +9974,30 @@ case p_sof :
       case ft_map :
 
          /* we would like to use the target destructively */
-		 if (left->sp_form==ft_omega)
+		 if (spec_form(left)==ft_omega)
 		 	abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
 
-         map_root = target->sp_val.sp_map_ptr;
+         map_root = spec_val(target,sp_map_ptr);
          if (map_root->m_use_count != 1) {
 
             map_root->m_use_count--;
             map_root = copy_map(SETL_SYSTEM map_root);
-            target->sp_val.sp_map_ptr = map_root;
+            spec_set_val(target,sp_map_ptr,map_root);
 
          }
 
          /* look up the domain element in the map */
 
-         map_work_hdr = map_root;
-         spec_hash_code(work_hash_code,right);
-         range_hash_code = work_hash_code;
-         spec_hash_code(work_hash_code,left);
-         domain_hash_code = work_hash_code;
-
-         for (source_height = map_work_hdr->m_ntype.m_root.m_height;
-              source_height;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-            /* if we're missing a header record, insert it */
-
-            if (map_work_hdr->m_child[source_index].m_header == NULL) {
-
-               get_map_header(new_map_hdr);
-               new_map_hdr->m_ntype.m_intern.m_parent = map_work_hdr;
-               new_map_hdr->m_ntype.m_intern.m_child_index = source_index;
-               for (i = 0;
-                    i < MAP_HASH_SIZE;
-                    new_map_hdr->m_child[i++].m_cell = NULL);
-               map_work_hdr->m_child[source_index].m_header = new_map_hdr;
-               map_work_hdr = new_map_hdr;
-
-            }
-            else {
-
-               map_work_hdr = map_work_hdr->m_child[source_index].m_header;
-
-            }
-         }
-
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
-
-         source_index = work_hash_code & MAP_HASH_MASK;
-         map_cell_tail = &(map_work_hdr->m_child[source_index].m_cell);
-         for (map_cell = map_work_hdr->m_child[source_index].m_cell;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < domain_hash_code;
-              map_cell = map_cell->m_next) {
-
-            map_cell_tail = &(map_cell->m_next);
-
-         }
-
-         /* try to find the domain element */
-
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == domain_hash_code) {
-
-            spec_equal(is_equal,&(map_cell->m_domain_spec),left);
-
-            if (is_equal)
-               break;
-
-            map_cell_tail = &(map_cell->m_next);
-            map_cell = map_cell->m_next;
-
-         }
+         spec_hash_code(range_hash_code,right);
+         spec_hash_code(domain_hash_code,left);
 
          /* if the source operand is omega, remove the cell */
 
-         if (right->sp_form == ft_omega) {
+         if (spec_form(right) == ft_omega) {
 
-            if (!is_equal)
+            map_cell = map_unlink(&(map_root->m_trie),left,domain_hash_code);
+            if (map_cell == NULL)
                break;
 
             spec_hash_code(work_hash_code,&(map_cell->m_range_spec));
@@ -11665,46 +10005,26 @@ case p_sof :
 
             if (map_cell->m_is_multi_val) {
 
-               set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-               map_root->m_ntype.m_root.m_cardinality -=
-                     set_root->s_ntype.s_root.s_cardinality;
+               set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+               map_root->m_cardinality -=
+                     set_root->s_cardinality;
 
-               if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+               if ((set_root->s_cardinality%2)==0) 
                   map_root->m_hash_code ^= map_cell->m_hash_code;
 
             }
             else {
 
-               map_root->m_ntype.m_root.m_cardinality--;
+               map_root->m_cardinality--;
 
             }
 
             map_root->m_hash_code ^= map_cell->m_hash_code;
-            *map_cell_tail = map_cell->m_next;
             unmark_specifier(&(map_cell->m_domain_spec));
             unmark_specifier(&(map_cell->m_range_spec));
-            map_root->m_ntype.m_root.m_cell_count--;
+            map_root->m_cell_count--;
             free_map_cell(map_cell);
 
-            /*
-             *  We've reduced the number of cells, so we may have to
-             *  contract the map header.
-             */
-
-            contraction_trigger =
-                  (1 << ((map_root->m_ntype.m_root.m_height)
-                          * MAP_SHIFT_DIST));
-            if (contraction_trigger == 1)
-               contraction_trigger = 0;
-
-            if (map_root->m_ntype.m_root.m_cell_count <
-                contraction_trigger) {
-
-               map_root = map_contract_header(SETL_SYSTEM map_root);
-               target->sp_val.sp_map_ptr = map_root;
-
-            }
-
             break;
 
          }
@@ -11713,41 +10033,27 @@ case p_sof :
           *  The source is not omega, so we add or change a cell.
           */
 
+         map_cell = map_locate(&(map_root->m_trie),left,domain_hash_code,
+                               &is_new);
+
          /* if we don't find the domain element, add a cell */
 
-         if (!is_equal) {
+         if (is_new) {
 
-            get_map_cell(new_map_cell);
             mark_specifier(left);
             mark_specifier(right);
-            new_map_cell->m_domain_spec.sp_form = left->sp_form;
-            new_map_cell->m_domain_spec.sp_val.sp_biggest =
-                  left->sp_val.sp_biggest;
-            new_map_cell->m_range_spec.sp_form = right->sp_form;
-            new_map_cell->m_range_spec.sp_val.sp_biggest =
-                  right->sp_val.sp_biggest;
-            new_map_cell->m_is_multi_val = NO;
-            new_map_cell->m_hash_code = domain_hash_code;
-            new_map_cell->m_next = *map_cell_tail;
-            *map_cell_tail = new_map_cell;
-            map_root->m_ntype.m_root.m_cardinality++;
-            map_root->m_ntype.m_root.m_cell_count++;
+            spec_set_form(&map_cell->m_domain_spec,spec_form(left));
+            spec_set_val(&map_cell->m_domain_spec,sp_biggest,
+                  spec_val(left,sp_biggest));
+            spec_set_form(&map_cell->m_range_spec,spec_form(right));
+            spec_set_val(&map_cell->m_range_spec,sp_biggest,
+                  spec_val(right,sp_biggest));
+            map_cell->m_is_multi_val = NO;
+            map_root->m_cardinality++;
+            map_root->m_cell_count++;
             map_root->m_hash_code ^= domain_hash_code;
             map_root->m_hash_code ^= range_hash_code;
 
-            /* expand the map header if necessary */
-
-            expansion_trigger =
-                  (1 << ((map_root->m_ntype.m_root.m_height + 1)
-                         * MAP_SHIFT_DIST)) * 2;
-            if (map_root->m_ntype.m_root.m_cardinality >
-                expansion_trigger) {
-
-               map_root = map_expand_header(SETL_SYSTEM map_root);
-               target->sp_val.sp_map_ptr = map_root;
-
-            }
-
             break;
 
          }
@@ -11756,11 +10062,11 @@ case p_sof :
 
          if (map_cell->m_is_multi_val) {
 
-            set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-            map_root->m_ntype.m_root.m_cardinality -=
-                  (set_root->s_ntype.s_root.s_cardinality - 1);
+            set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+            map_root->m_cardinality -=
+                  (set_root->s_cardinality - 1);
 
-            if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+            if ((set_root->s_cardinality%2)==0) 
                map_root->m_hash_code ^= map_cell->m_hash_code;
          }
 
@@ -11772,9 +10078,9 @@ case p_sof :
 
          mark_specifier(right);
          unmark_specifier(&(map_cell->m_range_spec));
-         map_cell->m_range_spec.sp_form = right->sp_form;
-         map_cell->m_range_spec.sp_val.sp_biggest =
-               right->sp_val.sp_biggest;
+         spec_set_form(&map_cell->m_range_spec,spec_form(right));
+         spec_set_val(&map_cell->m_range_spec,sp_biggest,
+               spec_val(right,sp_biggest));
          map_cell->m_is_multi_val = NO;
          map_root->m_hash_code ^= range_hash_code;
 
@@ -11789,23 +10095,24 @@ case p_sof :
 
          /* we convert the tuple index to a C long */
 
-         if (left->sp_form == ft_short) {
+         if (spec_form(left) == ft_short) {
 
-            short_value = left->sp_val.sp_short_value;
+            short_value = spec_val(left,sp_short_value);
             if (short_value < 0)
                short_value =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
          }
-         else if (left->sp_form == ft_long) {
+         else if (spec_form(left) == ft_long) {
 
-            short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            short_value =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
             if (short_value < 0)
                short_value =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   short_value + 1;
             if (short_value <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
@@ -11817,7 +10124,7 @@ case p_sof :
 
          }
 
-         tuple_root = target->sp_val.sp_tuple_ptr;
+         tuple_root = spec_val(target,sp_tuple_ptr);
 
          /* we would like to use the target destructively */
 
@@ -11825,7 +10132,7 @@ case p_sof :
 
             tuple_root->t_use_count--;
             tuple_root = copy_tuple(SETL_SYSTEM tuple_root);
-            target->sp_val.sp_tuple_ptr = tuple_root;
+            spec_set_val(target,sp_tuple_ptr,tuple_root);
 
          }
 
@@ -11833,248 +10140,41 @@ case p_sof :
 
          short_value--;
 
-         /* if the item is past the end of the tuple, extend the tuple */
-
-         if (short_value >= tuple_root->t_ntype.t_root.t_length) {
-
-            expansion_trigger =
-                  1 << ((tuple_root->t_ntype.t_root.t_height + 1)
-                        * TUP_SHIFT_DIST);
-
-            /* expand the target tree if necessary */
-
-            while (short_value >= expansion_trigger) {
-
-               tuple_work_hdr = tuple_root;
-
-               get_tuple_header(tuple_root);
-
-               tuple_root->t_use_count = 1;
-               tuple_root->t_hash_code =
-                  tuple_work_hdr->t_hash_code;
-               tuple_root->t_ntype.t_root.t_length =
-                  tuple_work_hdr->t_ntype.t_root.t_length;
-               tuple_root->t_ntype.t_root.t_height =
-                  tuple_work_hdr->t_ntype.t_root.t_height + 1;
-
-               for (i = 1;
-                    i < TUP_HEADER_SIZE;
-                    tuple_root->t_child[i++].t_header = NULL);
-
-               tuple_root->t_child[0].t_header = tuple_work_hdr;
-
-               tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-               tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-               expansion_trigger *= TUP_HEADER_SIZE;
-
-            }
-
-            tuple_root->t_ntype.t_root.t_length = short_value + 1;
-            target->sp_val.sp_tuple_ptr = tuple_root;
-
-         }
-
-         /* look up the tuple component */
-
-         tuple_work_hdr = tuple_root;
-
-         for (source_height = tuple_work_hdr->t_ntype.t_root.t_height;
-              source_height;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = (short_value >>
-                                 (source_height * TUP_SHIFT_DIST)) &
-                              TUP_SHIFT_MASK;
-
-            /* if we're missing a header record, allocate one */
-
-            if (tuple_work_hdr->t_child[source_index].t_header == NULL) {
-
-               get_tuple_header(new_tuple_hdr);
-               new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-               new_tuple_hdr->t_ntype.t_intern.t_child_index = source_index;
-               for (i = 0;
-                    i < TUP_HEADER_SIZE;
-                    new_tuple_hdr->t_child[i++].t_cell = NULL);
-               tuple_work_hdr->t_child[source_index].t_header =
-                     new_tuple_hdr;
-               tuple_work_hdr = new_tuple_hdr;
-
-            }
-            else {
-
-               tuple_work_hdr =
-                  tuple_work_hdr->t_child[source_index].t_header;
-
-            }
-         }
-
-         /*
-          *  At this point, tuple_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
-
-         source_index = short_value & TUP_SHIFT_MASK;
-         tuple_cell = tuple_work_hdr->t_child[source_index].t_cell;
-
-         /* if we assign omega to the last cell of a tuple, we shorten it */
-
-         if (right->sp_form == ft_omega &&
-             short_value == (tuple_root->t_ntype.t_root.t_length - 1)) {
-
-            /* first free the tuple cell */
-
-            if (tuple_cell != NULL) {
-
-               tuple_root->t_hash_code ^=
-                     tuple_cell->t_hash_code;
-               unmark_specifier(&(tuple_cell->t_spec));
-               free_tuple_cell(tuple_cell);
-               tuple_work_hdr->t_child[source_index].t_cell = NULL;
-
-            }
-
-            /* now shorten the tuple while the rightmost element is omega */
-
-            for (;;) {
-
-               if (!source_height && source_index >= 0) {
-
-                  if (tuple_work_hdr->t_child[source_index].t_cell != NULL)
-                     break;
-
-                  tuple_root->t_ntype.t_root.t_length--;
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* move up if we're at the end of a node */
-
-               if (source_index < 0) {
-
-                  if (tuple_work_hdr == tuple_root)
-                     break;
-
-                  source_height++;
-                  source_index =
-                     tuple_work_hdr->t_ntype.t_intern.t_child_index;
-                  tuple_work_hdr =
-                     tuple_work_hdr->t_ntype.t_intern.t_parent;
-                  free_tuple_header(
-                     tuple_work_hdr->t_child[source_index].t_header);
-                  tuple_work_hdr->t_child[source_index].t_header = NULL;
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* skip over null nodes */
-
-               if (tuple_work_hdr->t_child[source_index].t_header == NULL) {
-
-                  tuple_root->t_ntype.t_root.t_length -=
-                        1 << (source_height * TUP_SHIFT_DIST);
-                  source_index--;
-
-                  continue;
-
-               }
-
-               /* otherwise drop down a level */
-
-               tuple_work_hdr =
-                  tuple_work_hdr->t_child[source_index].t_header;
-               source_index = TUP_HEADER_SIZE - 1;
-
-               source_height--;
-
-            }
-
-            /* we've shortened the tuple -- now reduce the height */
-
-            while (tuple_root->t_ntype.t_root.t_height > 0 &&
-                   tuple_root->t_ntype.t_root.t_length <=
-                      (int32)(1L << (tuple_root->t_ntype.t_root.t_height *
-                                    TUP_SHIFT_DIST))) {
-
-               tuple_work_hdr = tuple_root->t_child[0].t_header;
-
-               /* it's possible that we deleted internal headers */
-
-               if (tuple_work_hdr == NULL) {
-
-                  tuple_root->t_ntype.t_root.t_height--;
-                  continue;
-
-               }
-
-               /* delete the root node */
-
-               tuple_work_hdr->t_use_count = tuple_root->t_use_count;
-               tuple_work_hdr->t_hash_code =
-                     tuple_root->t_hash_code;
-               tuple_work_hdr->t_ntype.t_root.t_length =
-                     tuple_root->t_ntype.t_root.t_length;
-               tuple_work_hdr->t_ntype.t_root.t_height =
-                     tuple_root->t_ntype.t_root.t_height - 1;
-
-               free_tuple_header(tuple_root);
-               tuple_root = tuple_work_hdr;
-               target->sp_val.sp_tuple_ptr = tuple_root;
-
-            }
+         /* packed tuples take numbers of the same form in place */
 
+         if (tuple_root->t_packing != TUP_CELLS &&
+             store_packed(SETL_SYSTEM tuple_root,short_value,right))
             break;
 
-         }
-
-         /* we aren't assigning omega, or we're not at the end of a tuple */
+         /* if the item is past the end of the tuple, extend the tuple */
 
-         if (tuple_cell == NULL) {
+         if (short_value >= tuple_root->t_length) {
 
-            if (right->sp_form == ft_omega)
+            if (spec_form(right) == ft_omega)
                break;
 
-            get_tuple_cell(tuple_cell);
-            tuple_work_hdr->t_child[source_index].t_cell = tuple_cell;
-            mark_specifier(right);
-            tuple_cell->t_spec.sp_form = right->sp_form;
-            tuple_cell->t_spec.sp_val.sp_biggest = right->sp_val.sp_biggest;
-            spec_hash_code(work_hash_code,right);
-            tuple_root->t_hash_code ^= work_hash_code;
-            tuple_cell->t_hash_code = work_hash_code;
-
-            break;
+            extend_tuple(tuple_root,short_value + 1);
 
          }
 
-         if (right->sp_form == ft_omega) {
-
-            unmark_specifier(&(tuple_cell->t_spec));
-            tuple_root->t_hash_code ^=
-                  tuple_cell->t_hash_code;
-            free_tuple_cell(tuple_cell);
-            tuple_work_hdr->t_child[source_index].t_cell = NULL;
-
-            break;
-
-         }
+         /* replace the element (omega cells have a zero hash code) */
 
+         tuple_cell = tuple_root->t_cells + short_value;
          mark_specifier(right);
          unmark_specifier(&(tuple_cell->t_spec));
          tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
-         tuple_cell->t_spec.sp_form = right->sp_form;
-         tuple_cell->t_spec.sp_val.sp_biggest = right->sp_val.sp_biggest;
+         spec_set_form(&tuple_cell->t_spec,spec_form(right));
+         spec_set_val(&tuple_cell->t_spec,sp_biggest,
+                      spec_val(right,sp_biggest));
          spec_hash_code(work_hash_code,right);
          tuple_root->t_hash_code ^= work_hash_code;
          tuple_cell->t_hash_code = work_hash_code;
 
+         /* if we assign omega to the last cell of a tuple, we shorten it */
+
+         if (spec_form(right) == ft_omega)
+            trim_tuple(tuple_root);
+
          break;
 
       /*
@@ -12085,7 +10185,7 @@ case p_sof :
 
       case ft_object :
 
-         object_root = target->sp_val.sp_object_ptr;
+         object_root = spec_val(target,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -12163,6 +10263,7 @@ PRTYPE void assign_ops2(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_sofa :  
+opcode_label(p_sofa)
 
 {
 
@@ -12172,7 +10273,7 @@ case p_sofa :
    left = ip->i_operand[1].i_spec_ptr;
    right = ip->i_operand[2].i_spec_ptr;
 
-   switch (target->sp_form) {
+   switch (spec_form(target)) {
 
       case ft_set :
 
@@ -12183,103 +10284,39 @@ case p_sofa :
 
          /* we would like to use the target destructively */
 
-		 if (left->sp_form==ft_omega)
+		 if (spec_form(left)==ft_omega)
 		 	abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
-         map_root = target->sp_val.sp_map_ptr;
+         map_root = spec_val(target,sp_map_ptr);
          if (map_root->m_use_count != 1) {
 
             map_root->m_use_count--;
             map_root = copy_map(SETL_SYSTEM map_root);
-            target->sp_val.sp_map_ptr = map_root;
+            spec_set_val(target,sp_map_ptr,map_root);
 
          }
 
          /* look up the domain element in the map */
 
-         map_work_hdr = map_root;
-         spec_hash_code(work_hash_code,right);
-         range_hash_code = work_hash_code;
-         spec_hash_code(work_hash_code,left);
-         source_hash_code = work_hash_code;
-
-         for (source_height = map_work_hdr->m_ntype.m_root.m_height;
-              source_height;
-              source_height--) {
-
-            /* extract the element's index at this level */
-
-            source_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-            /* if we're missing a header record, insert it */
-
-            if (map_work_hdr->m_child[source_index].m_header == NULL) {
-
-               get_map_header(new_map_hdr);
-               new_map_hdr->m_ntype.m_intern.m_parent = map_work_hdr;
-               new_map_hdr->m_ntype.m_intern.m_child_index = source_index;
-               for (i = 0;
-                    i < MAP_HASH_SIZE;
-                    new_map_hdr->m_child[i++].m_cell = NULL);
-               map_work_hdr->m_child[source_index].m_header = new_map_hdr;
-               map_work_hdr = new_map_hdr;
-
-            }
-            else {
-
-               map_work_hdr = map_work_hdr->m_child[source_index].m_header;
-
-            }
-         }
-
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  We look for an element.
-          */
-
-         source_index = work_hash_code & MAP_HASH_MASK;
-         map_cell_tail = &(map_work_hdr->m_child[source_index].m_cell);
-         for (map_cell = *map_cell_tail;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < source_hash_code;
-              map_cell = map_cell->m_next) {
-
-            map_cell_tail = &(map_cell->m_next);
-
-         }
-
-         /* try to find the domain element */
-
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == source_hash_code) {
-
-            spec_equal(is_equal,&(map_cell->m_domain_spec),left);
-
-            if (is_equal)
-               break;
-
-            map_cell_tail = &(map_cell->m_next);
-            map_cell = map_cell->m_next;
-
-         }
+         spec_hash_code(range_hash_code,right);
+         spec_hash_code(source_hash_code,left);
 
          /* make sure we have a set to insert */
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
-         if (right->sp_form != ft_set)
+         if (spec_form(right) != ft_set)
             abend(SETL_SYSTEM msg_expected_set,
                   abend_opnd_str(SETL_SYSTEM right));
 
          /* if we have an empty set, remove the domain element */
 
-         set_root = right->sp_val.sp_set_ptr;
-         if (set_root->s_ntype.s_root.s_cardinality == 0) {
+         set_root = spec_val(right,sp_set_ptr);
+         if (set_root->s_cardinality == 0) {
 
-            if (!is_equal)
+            map_cell = map_unlink(&(map_root->m_trie),left,source_hash_code);
+            if (map_cell == NULL)
                break;
 
             spec_hash_code(work_hash_code,&(map_cell->m_range_spec));
@@ -12287,43 +10324,25 @@ case p_sofa :
 
             if (map_cell->m_is_multi_val) {
 
-               set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-               map_root->m_ntype.m_root.m_cardinality -=
-                     set_root->s_ntype.s_root.s_cardinality;
-               if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+               set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+               map_root->m_cardinality -=
+                     set_root->s_cardinality;
+               if ((set_root->s_cardinality%2)==0) 
                   map_root->m_hash_code ^= map_cell->m_hash_code;
 
             }
             else {
 
-               map_root->m_ntype.m_root.m_cardinality--;
+               map_root->m_cardinality--;
 
             }
 
-            map_root->m_ntype.m_root.m_cell_count--;
+            map_root->m_cell_count--;
             map_root->m_hash_code ^= map_cell->m_hash_code;
-            *map_cell_tail = map_cell->m_next;
             unmark_specifier(&(map_cell->m_domain_spec));
             unmark_specifier(&(map_cell->m_range_spec));
             free_map_cell(map_cell);
 
-            /*
-             *  We've reduced the number of cells, so we may have to
-             *  contract the map header.
-             */
-
-            contraction_trigger = (1 << ((map_root->m_ntype.m_root.m_height)
-                                         * MAP_SHIFT_DIST));
-            if (contraction_trigger == 1)
-               contraction_trigger = 0;
-
-            if (map_root->m_ntype.m_root.m_cell_count < contraction_trigger) {
-
-               map_root = map_contract_header(SETL_SYSTEM map_root);
-               target->sp_val.sp_map_ptr = map_root;
-
-            }
-
             break;
 
          }
@@ -12332,34 +10351,21 @@ case p_sofa :
           *  The source is not empty, so we add or change a cell.
           */
 
+         map_cell = map_locate(&(map_root->m_trie),left,source_hash_code,
+                               &is_new);
+
          /* if we don't find the domain element, add a cell */
 
-         if (!is_equal) {
+         if (is_new) {
 
-            get_map_cell(new_map_cell);
             mark_specifier(left);
-            new_map_cell->m_domain_spec.sp_form = left->sp_form;
-            new_map_cell->m_domain_spec.sp_val.sp_biggest =
-                  left->sp_val.sp_biggest;
-            new_map_cell->m_range_spec.sp_form = ft_omega;
-            new_map_cell->m_hash_code = source_hash_code;
-            new_map_cell->m_next = map_cell;
-            *map_cell_tail = new_map_cell;
-            map_root->m_ntype.m_root.m_cell_count++;
+            spec_set_form(&map_cell->m_domain_spec,spec_form(left));
+            spec_set_val(&map_cell->m_domain_spec,sp_biggest,
+                  spec_val(left,sp_biggest));
+            spec_set_form(&map_cell->m_range_spec,ft_omega);
+            map_root->m_cell_count++;
             map_root->m_hash_code ^= source_hash_code;
-            map_cell = new_map_cell;
-
-            /* expand the map header if necessary */
-
-            expansion_trigger = (1 << ((map_root->m_ntype.m_root.m_height + 1)
-                                       * MAP_SHIFT_DIST)) * 2;
-            if (map_root->m_ntype.m_root.m_cell_count >
-                expansion_trigger) {
 
-               map_root = map_expand_header(SETL_SYSTEM map_root);
-               target->sp_val.sp_map_ptr = map_root;
-
-            }
          }
 
          /* if we had a multi-value cell, decrease the cardinality */
@@ -12371,17 +10377,17 @@ case p_sofa :
 
             if (map_cell->m_is_multi_val) {
 
-               set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-               map_root->m_ntype.m_root.m_cardinality -=
-                     set_root->s_ntype.s_root.s_cardinality;
+               set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+               map_root->m_cardinality -=
+                     set_root->s_cardinality;
 
-               if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+               if ((set_root->s_cardinality%2)==0) 
                   map_root->m_hash_code ^= map_cell->m_hash_code;
 
             }
             else {
 
-               map_root->m_ntype.m_root.m_cardinality--;
+               map_root->m_cardinality--;
 
             }
          }
@@ -12391,80 +10397,21 @@ case p_sofa :
           *  singleton set, we pick out the element.
           */
 
-         set_root = right->sp_val.sp_set_ptr;
-         if (set_root->s_ntype.s_root.s_cardinality == 1) {
-
-            set_work_hdr = set_root;
-            source_height = set_root->s_ntype.s_root.s_height;
-            source_index = 0;
-            set_cell = NULL;
-
-            for (;;) {
-
-               /* if we're at a leaf, look for the cell */
-
-               if (!source_height) {
-
-                  for (source_index = 0;
-                       source_index < SET_HASH_SIZE && set_cell == NULL;
-                       source_index++) {
-
-                     set_cell = set_work_hdr->s_child[source_index].s_cell;
-
-                  }
-
-                  if (set_cell != NULL)
-                     break;
-
-               }
-
-               /* move up if we're at the end of a node */
-
-               if (source_index >= SET_HASH_SIZE) {
-
-                  /* if we return to the root the set is exhausted */
-
-#ifdef TRAPS
+         set_root = spec_val(right,sp_set_ptr);
+         if (set_root->s_cardinality == 1) {
 
-                  if (set_work_hdr == set_root)
-                     trap(__FILE__,__LINE__,msg_missing_set_element);
-
-#endif
-
-                  source_height++;
-                  source_index =
-                      set_work_hdr->s_ntype.s_intern.s_child_index + 1;
-                  set_work_hdr = set_work_hdr->s_ntype.s_intern.s_parent;
-
-                  continue;
-
-               }
-
-               /* skip over null nodes */
-
-               if (set_work_hdr->s_child[source_index].s_header == NULL) {
-
-                  source_index++;
-                  continue;
-
-               }
-
-               /* otherwise drop down a level */
-
-               set_work_hdr = set_work_hdr->s_child[source_index].s_header;
-               source_index = 0;
-               source_height--;
-
-            }
+            set_cursor_start(&set_cursor,set_root->s_trie);
+            set_cell = set_cursor_next(&set_cursor);
 
             /* now we have the set element in set_cell */
 
             mark_specifier(&(set_cell->s_spec));
             unmark_specifier(&(map_cell->m_range_spec));
-            map_cell->m_range_spec.sp_form = set_cell->s_spec.sp_form;
-            map_cell->m_range_spec.sp_val.sp_biggest =
-               set_cell->s_spec.sp_val.sp_biggest;
-            map_root->m_ntype.m_root.m_cardinality++;
+            spec_set_form(&map_cell->m_range_spec,
+                          spec_form(&set_cell->s_spec));
+            spec_set_val(&map_cell->m_range_spec,sp_biggest,
+               spec_val(&set_cell->s_spec,sp_biggest));
+            map_root->m_cardinality++;
             map_cell->m_is_multi_val = NO;
 
             map_root->m_hash_code ^= range_hash_code;
@@ -12475,13 +10422,13 @@ case p_sofa :
 
          set_root->s_use_count++;
          unmark_specifier(&(map_cell->m_range_spec));
-         map_cell->m_range_spec.sp_form = right->sp_form;
-         map_cell->m_range_spec.sp_val.sp_set_ptr = set_root;
+         spec_set_form(&map_cell->m_range_spec,spec_form(right));
+         spec_set_val(&map_cell->m_range_spec,sp_set_ptr,set_root);
          map_cell->m_is_multi_val = YES;
-         map_root->m_ntype.m_root.m_cardinality +=
-               set_root->s_ntype.s_root.s_cardinality;
+         map_root->m_cardinality +=
+               set_root->s_cardinality;
 
-         if ((set_root->s_ntype.s_root.s_cardinality%2)==0) 
+         if ((set_root->s_cardinality%2)==0) 
             map_root->m_hash_code ^= map_cell->m_hash_code;
 
          map_root->m_hash_code ^= range_hash_code;
@@ -12496,7 +10443,7 @@ case p_sofa :
 
       case ft_object :
 
-         object_root = target->sp_val.sp_object_ptr;
+         object_root = spec_val(target,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -12576,6 +10523,7 @@ PRTYPE void assign_ops3(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_sslice :
+opcode_label(p_sslice)
 
 {
 
@@ -12587,27 +10535,28 @@ case p_sslice :
    right = PC->i_operand[0].i_spec_ptr;
    BUMPPC(1);
 
-   switch (target->sp_form) {
+   switch (spec_form(target)) {
 
       case ft_string :
 
          /* we convert the slice front to a C long */
 
-         if (left->sp_form == ft_short) {
+         if (spec_form(left) == ft_short) {
 
-            slice_start = left->sp_val.sp_short_value;
+            slice_start = spec_val(left,sp_short_value);
             if (slice_start <= 0)
-               slice_start = target->sp_val.sp_string_ptr->s_length +
+               slice_start = spec_val(target,sp_string_ptr)->s_length +
                              slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
          }
-         else if (left->sp_form == ft_long) {
+         else if (spec_form(left) == ft_long) {
 
-            slice_start = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            slice_start =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
             if (slice_start <= 0)
-               slice_start = target->sp_val.sp_string_ptr->s_length +
+               slice_start = spec_val(target,sp_string_ptr)->s_length +
                              slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
@@ -12621,21 +10570,21 @@ case p_sslice :
 
          /* we convert the slice end to a C long */
 
-         if (end->sp_form == ft_short) {
+         if (spec_form(end) == ft_short) {
 
-            slice_end = end->sp_val.sp_short_value;
+            slice_end = spec_val(end,sp_short_value);
             if (slice_end < 0)
-               slice_end = target->sp_val.sp_string_ptr->s_length +
+               slice_end = spec_val(target,sp_string_ptr)->s_length +
                            slice_end + 1;
             if (slice_end < 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM end));
 
          }
-         else if (end->sp_form == ft_long) {
+         else if (spec_form(end) == ft_long) {
 
-            slice_end = long_to_short(SETL_SYSTEM end->sp_val.sp_long_ptr);
+            slice_end = long_to_short(SETL_SYSTEM spec_val(end,sp_long_ptr));
             if (slice_end < 0)
-               slice_end = target->sp_val.sp_string_ptr->s_length +
+               slice_end = spec_val(target,sp_string_ptr)->s_length +
                            slice_end + 1;
             if (slice_end < 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM end));
@@ -12657,13 +10606,13 @@ case p_sslice :
 
          /* the source must also be a string */
 
-         if (right->sp_form != ft_string)
+         if (spec_form(right) != ft_string)
             abend(SETL_SYSTEM "Expected string, but found %s",
                   abend_opnd_str(SETL_SYSTEM right));
 
          /* if we reference past the end of the string, abend */
 
-         left_string_hdr = target->sp_val.sp_string_ptr;
+         left_string_hdr = spec_val(target,sp_string_ptr);
          if (left_string_hdr->s_length < slice_end)
             abend(SETL_SYSTEM msg_invalid_slice_limits,
                   abend_opnd_str(SETL_SYSTEM left),
@@ -12672,172 +10621,40 @@ case p_sslice :
 
          /* make a target string */
 
-         get_string_header(target_string_hdr);
-         target_string_hdr->s_use_count = 1;
-         target_string_hdr->s_hash_code = -1;
-         target_string_hdr->s_length = 0;
-         target_string_hdr->s_head = target_string_hdr->s_tail = NULL;
-         target_char_ptr = target_char_end = NULL;
-
-         /* copy the target operand up to the beginning of the slice */
-
+         right_string_hdr = spec_val(right,sp_string_ptr);
+         right_string_length = right_string_hdr->s_length;
          left_string_length = left_string_hdr->s_length - slice_end;
-         left_string_cell = left_string_hdr->s_head;
-
-         if (left_string_cell == NULL) {
-
-            left_char_ptr = left_char_end = NULL;
-
-         }
-         else {
-
-            left_char_ptr = left_string_cell->s_cell_value;
-            left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-         }
-
          slice_start--;
-         target_string_hdr->s_length = slice_start;
-         slice_end -= slice_start;
 
-         while (slice_start--) {
+         target_string_hdr = new_string_buffer(SETL_SYSTEM
+               slice_start + right_string_length + left_string_length);
+         target_char_ptr = target_string_hdr->s_chars;
 
-            if (left_char_ptr == left_char_end) {
-
-               left_string_cell = left_string_cell->s_next;
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_string_cell);
-               if (target_string_hdr->s_tail != NULL)
-                  (target_string_hdr->s_tail)->s_next = target_string_cell;
-               target_string_cell->s_prev = target_string_hdr->s_tail;
-               target_string_cell->s_next = NULL;
-               target_string_hdr->s_tail = target_string_cell;
-               if (target_string_hdr->s_head == NULL)
-                  target_string_hdr->s_head = target_string_cell;
-               target_char_ptr = target_string_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
+         /* copy the target operand up to the beginning of the slice */
 
-            *target_char_ptr++ = *left_char_ptr++;
-
-         }
+         memcpy((void *)target_char_ptr,
+                (void *)(left_string_hdr->s_chars),
+                (size_t)slice_start);
+         target_char_ptr += slice_start;
 
          /* next copy the source operand */
 
-         right_string_hdr = right->sp_val.sp_string_ptr;
-         right_string_cell = right_string_hdr->s_head;
-
-         if (right_string_cell == NULL) {
-
-            right_char_ptr = right_char_end = NULL;
-
-         }
-         else {
-
-            right_char_ptr = right_string_cell->s_cell_value;
-            right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         right_string_length = right_string_hdr->s_length;
-         target_string_hdr->s_length += right_string_length;
-
-         while (right_string_length--) {
-
-            if (right_char_ptr == right_char_end) {
-
-               right_string_cell = right_string_cell->s_next;
-               right_char_ptr = right_string_cell->s_cell_value;
-               right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_string_cell);
-               if (target_string_hdr->s_tail != NULL)
-                  (target_string_hdr->s_tail)->s_next = target_string_cell;
-               target_string_cell->s_prev = target_string_hdr->s_tail;
-               target_string_cell->s_next = NULL;
-               target_string_hdr->s_tail = target_string_cell;
-               if (target_string_hdr->s_head == NULL)
-                  target_string_hdr->s_head = target_string_cell;
-               target_char_ptr = target_string_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *right_char_ptr++;
-
-         }
-
-         /* position the left operand past the slice */
-
-         slice_end += (left_char_ptr - left_string_cell->s_cell_value);
-         while (slice_end >= STR_CELL_WIDTH) {
-
-            left_string_cell = left_string_cell->s_next;
-            slice_end -= STR_CELL_WIDTH;
-
-         }
+         memcpy((void *)target_char_ptr,
+                (void *)(right_string_hdr->s_chars),
+                (size_t)right_string_length);
+         target_char_ptr += right_string_length;
 
          /* copy the rest of the left string */
 
-         target_string_hdr->s_length += left_string_length;
-
-         if (left_string_cell == NULL) {
-
-            left_char_ptr = left_char_end = NULL;
-
-         }
-         else {
-
-            left_char_ptr = left_string_cell->s_cell_value + slice_end;
-            left_char_end = left_string_cell->s_cell_value + STR_CELL_WIDTH;
-
-         }
-
-         while (left_string_length--) {
-
-            if (left_char_ptr == left_char_end) {
-
-               left_string_cell = left_string_cell->s_next;
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_string_cell);
-               if (target_string_hdr->s_tail != NULL)
-                  (target_string_hdr->s_tail)->s_next = target_string_cell;
-               target_string_cell->s_prev = target_string_hdr->s_tail;
-               target_string_cell->s_next = NULL;
-               target_string_hdr->s_tail = target_string_cell;
-               if (target_string_hdr->s_head == NULL)
-                  target_string_hdr->s_head = target_string_cell;
-               target_char_ptr = target_string_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *left_char_ptr++;
-
-         }
+         memcpy((void *)target_char_ptr,
+                (void *)(left_string_hdr->s_chars + slice_end),
+                (size_t)left_string_length);
 
          /* assign our result to the target */
 
          unmark_specifier(target);
-         target->sp_form = ft_string;
-         target->sp_val.sp_string_ptr = target_string_hdr;
+         spec_set_form(target,ft_string);
+         spec_set_val(target,sp_string_ptr,target_string_hdr);
 
          break;
 
@@ -12850,23 +10667,24 @@ case p_sslice :
 
          /* we convert the slice front to a C long */
 
-         if (left->sp_form == ft_short) {
+         if (spec_form(left) == ft_short) {
 
-            slice_start = left->sp_val.sp_short_value;
+            slice_start = spec_val(left,sp_short_value);
             if (slice_start <= 0)
                slice_start =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
          }
-         else if (left->sp_form == ft_long) {
+         else if (spec_form(left) == ft_long) {
 
-            slice_start = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            slice_start =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
             if (slice_start <= 0)
                slice_start =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
@@ -12880,23 +10698,23 @@ case p_sslice :
 
          /* we convert the slice end to a C long */
 
-         if (end->sp_form == ft_short) {
+         if (spec_form(end) == ft_short) {
 
-            slice_end = end->sp_val.sp_short_value;
+            slice_end = spec_val(end,sp_short_value);
             if (slice_end < 0)
                slice_end =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   slice_end + 1;
             if (slice_end < 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM end));
 
          }
-         else if (end->sp_form == ft_long) {
+         else if (spec_form(end) == ft_long) {
 
-            slice_end = long_to_short(SETL_SYSTEM end->sp_val.sp_long_ptr);
+            slice_end = long_to_short(SETL_SYSTEM spec_val(end,sp_long_ptr));
             if (slice_end < 0)
                slice_end =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   slice_end + 1;
             if (slice_end < 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM end));
@@ -12918,15 +10736,13 @@ case p_sslice :
 
          /* the source must also be a tuple */
 
-         if (right->sp_form != ft_tuple)
+         if (spec_form(right) != ft_tuple)
             abend(SETL_SYSTEM "Expected tuple, but found %s",
                   abend_opnd_str(SETL_SYSTEM right));
 
-         tuple_work_hdr = target->sp_val.sp_tuple_ptr;
-
          /* make sure end <= length */
 
-         if (slice_end > tuple_work_hdr->t_ntype.t_root.t_length)
+         if (slice_end > spec_val(target,sp_tuple_ptr)->t_length)
             abend(SETL_SYSTEM msg_invalid_slice_limits,
                   abend_opnd_str(SETL_SYSTEM left),
                   abend_opnd_str(SETL_SYSTEM right),
@@ -12944,7 +10760,7 @@ case p_sslice :
 
       case ft_object :
 
-         object_root = target->sp_val.sp_object_ptr;
+         object_root = spec_val(target,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -13023,6 +10839,7 @@ PRTYPE void assign_ops4(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_send :
+opcode_label(p_send)
 
 {
 
@@ -13032,27 +10849,28 @@ case p_send :
    left = ip->i_operand[1].i_spec_ptr;
    right = ip->i_operand[2].i_spec_ptr;
 
-   switch (target->sp_form) {
+   switch (spec_form(target)) {
 
       case ft_string :
 
          /* we convert the slice front to a C long */
 
-         if (left->sp_form == ft_short) {
+         if (spec_form(left) == ft_short) {
 
-            slice_start = left->sp_val.sp_short_value;
+            slice_start = spec_val(left,sp_short_value);
             if (slice_start <= 0)
-               slice_start = target->sp_val.sp_string_ptr->s_length +
+               slice_start = spec_val(target,sp_string_ptr)->s_length +
                              slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
          }
-         else if (left->sp_form == ft_long) {
+         else if (spec_form(left) == ft_long) {
 
-            slice_start = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            slice_start =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
             if (slice_start <= 0)
-               slice_start = target->sp_val.sp_string_ptr->s_length +
+               slice_start = spec_val(target,sp_string_ptr)->s_length +
                              slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
@@ -13064,7 +10882,7 @@ case p_send :
 
          }
 
-         left_string_hdr = target->sp_val.sp_string_ptr;
+         left_string_hdr = spec_val(target,sp_string_ptr);
          slice_end = left_string_hdr->s_length;
 
          /* make sure start <= end + 1 */
@@ -13076,118 +10894,30 @@ case p_send :
 
          /* make a target string */
 
-         get_string_header(target_string_hdr);
-         target_string_hdr->s_use_count = 1;
-         target_string_hdr->s_hash_code = -1;
-         target_string_hdr->s_length = 0;
-         target_string_hdr->s_head = target_string_hdr->s_tail = NULL;
-         target_char_ptr = target_char_end = NULL;
-
-         /* copy the target operand up to the beginning of the slice */
-
-         left_string_hdr = target->sp_val.sp_string_ptr;
-         left_string_length = left_string_hdr->s_length - slice_end;
-         left_string_cell = left_string_hdr->s_head;
-
-         if (left_string_cell == NULL) {
-
-            left_char_ptr = left_char_end = NULL;
-
-         }
-         else {
-
-            left_char_ptr = left_string_cell->s_cell_value;
-            left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-         }
-
+         right_string_hdr = spec_val(right,sp_string_ptr);
+         right_string_length = right_string_hdr->s_length;
          slice_start--;
-         target_string_hdr->s_length = slice_start;
-         slice_end -= slice_start;
 
-         while (slice_start--) {
+         target_string_hdr = new_string_buffer(SETL_SYSTEM
+               slice_start + right_string_length);
 
-            if (left_char_ptr == left_char_end) {
-
-               left_string_cell = left_string_cell->s_next;
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_string_cell);
-               if (target_string_hdr->s_tail != NULL)
-                  (target_string_hdr->s_tail)->s_next = target_string_cell;
-               target_string_cell->s_prev = target_string_hdr->s_tail;
-               target_string_cell->s_next = NULL;
-               target_string_hdr->s_tail = target_string_cell;
-               if (target_string_hdr->s_head == NULL)
-                  target_string_hdr->s_head = target_string_cell;
-               target_char_ptr = target_string_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *left_char_ptr++;
+         /* copy the target operand up to the beginning of the slice */
 
-         }
+         memcpy((void *)(target_string_hdr->s_chars),
+                (void *)(left_string_hdr->s_chars),
+                (size_t)slice_start);
 
          /* next copy the source operand */
 
-         right_string_hdr = right->sp_val.sp_string_ptr;
-         right_string_cell = right_string_hdr->s_head;
-
-         if (right_string_cell == NULL) {
-
-            right_char_ptr = right_char_end = NULL;
-
-         }
-         else {
-
-            right_char_ptr = right_string_cell->s_cell_value;
-            right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         right_string_length = right_string_hdr->s_length;
-         target_string_hdr->s_length += right_string_length;
-
-         while (right_string_length--) {
-
-            if (right_char_ptr == right_char_end) {
-
-               right_string_cell = right_string_cell->s_next;
-               right_char_ptr = right_string_cell->s_cell_value;
-               right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_string_cell);
-               if (target_string_hdr->s_tail != NULL)
-                  (target_string_hdr->s_tail)->s_next = target_string_cell;
-               target_string_cell->s_prev = target_string_hdr->s_tail;
-               target_string_cell->s_next = NULL;
-               target_string_hdr->s_tail = target_string_cell;
-               if (target_string_hdr->s_head == NULL)
-                  target_string_hdr->s_head = target_string_cell;
-               target_char_ptr = target_string_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *right_char_ptr++;
-
-         }
+         memcpy((void *)(target_string_hdr->s_chars + slice_start),
+                (void *)(right_string_hdr->s_chars),
+                (size_t)right_string_length);
 
          /* assign our result to the target */
 
          unmark_specifier(target);
-         target->sp_form = ft_string;
-         target->sp_val.sp_string_ptr = target_string_hdr;
+         spec_set_form(target,ft_string);
+         spec_set_val(target,sp_string_ptr,target_string_hdr);
 
          break;
 
@@ -13200,23 +10930,24 @@ case p_send :
 
          /* we convert the slice front to a C long */
 
-         if (left->sp_form == ft_short) {
+         if (spec_form(left) == ft_short) {
 
-            slice_start = left->sp_val.sp_short_value;
+            slice_start = spec_val(left,sp_short_value);
             if (slice_start <= 0)
                slice_start =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
 
          }
-         else if (left->sp_form == ft_long) {
+         else if (spec_form(left) == ft_long) {
 
-            slice_start = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+            slice_start =
+               long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
             if (slice_start <= 0)
                slice_start =
-                  target->sp_val.sp_tuple_ptr->t_ntype.t_root.t_length +
+                  spec_val(target,sp_tuple_ptr)->t_length +
                   slice_start + 1;
             if (slice_start <= 0)
                abend(SETL_SYSTEM msg_invalid_index,abend_opnd_str(SETL_SYSTEM left));
@@ -13228,8 +10959,7 @@ case p_send :
 
          }
 
-         tuple_work_hdr = target->sp_val.sp_tuple_ptr;
-         slice_end = tuple_work_hdr->t_ntype.t_root.t_length;
+         slice_end = spec_val(target,sp_tuple_ptr)->t_length;
 
          /* make sure start <= end + 1 */
 
@@ -13250,7 +10980,7 @@ case p_send :
 
       case ft_object :
 
-         object_root = target->sp_val.sp_object_ptr;
+         object_root = spec_val(target,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -13331,6 +11061,8 @@ PRTYPE void cond_ops1(SETL_SYSTEM_PROTO_VOID)
 
 case p_goeq :           case p_gone :           case p_eq :
 case p_ne :
+opcode_label(p_goeq) opcode_label(p_gone) opcode_label(p_eq)
+opcode_label(p_ne)
 
 {
 
@@ -13352,14 +11084,14 @@ case p_ne :
       case p_goeq :
 
          if (condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
       case p_gone :
 
          if (!condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
@@ -13370,15 +11102,15 @@ case p_ne :
          if (condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -13391,15 +11123,15 @@ case p_ne :
          if (!condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -13453,6 +11185,8 @@ PRTYPE void cond_ops2(SETL_SYSTEM_PROTO_VOID)
 
 case p_lt :             case p_nlt :            case p_golt :
 case p_gonlt :
+opcode_label(p_lt) opcode_label(p_nlt) opcode_label(p_golt)
+opcode_label(p_gonlt)
 
 {
 
@@ -13470,7 +11204,7 @@ case p_gonlt :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can compare short integers with other short integers and long
@@ -13483,17 +11217,18 @@ case p_gonlt :
           *  If both operands are short we just compare the values.
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
             condition_true =
-               (left->sp_val.sp_short_value < right->sp_val.sp_short_value);
+               (spec_val(left,sp_short_value) <
+                spec_val(right,sp_short_value));
 
             break;
 
-         } else if (right->sp_form == ft_real) {
+         } else if (spec_form(right) == ft_real) {
 			
 			condition_true = 
-               (left->sp_val.sp_short_value < (right->sp_val.sp_real_ptr)->r_value);
+               (spec_val(left,sp_short_value) < spec_val(right,sp_real_value));
 
             break;
 
@@ -13504,7 +11239,7 @@ case p_gonlt :
           *  the case in which the second operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             condition_true = integer_lt(SETL_SYSTEM left,right);
 
@@ -13517,9 +11252,9 @@ case p_gonlt :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_binop_method(SETL_SYSTEM &spare1,
                               right,
                               left,
@@ -13554,17 +11289,17 @@ case p_gonlt :
           *  general function which adds any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             condition_true = integer_lt(SETL_SYSTEM left,right);
 
             break;
 
          
-         } else if (right->sp_form == ft_real) {
+         } else if (spec_form(right) == ft_real) {
 			
             condition_true = ((double)(long_to_double(SETL_SYSTEM left)) <
-            			 (right->sp_val.sp_real_ptr)->r_value);
+            			 spec_val(right,sp_real_value));
 
             break;
 
@@ -13575,9 +11310,9 @@ case p_gonlt :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_binop_method(SETL_SYSTEM &spare1,
                               right,
                               left,
@@ -13606,19 +11341,19 @@ case p_gonlt :
 
       case ft_real :
 
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
-            condition_true = ((left->sp_val.sp_real_ptr)->r_value <
-                              (right->sp_val.sp_real_ptr)->r_value);
+            condition_true = (spec_val(left,sp_real_value) <
+                              spec_val(right,sp_real_value));
 
-         } else if (right->sp_form == ft_short) {
+         } else if (spec_form(right) == ft_short) {
          
-            condition_true = ((left->sp_val.sp_real_ptr)->r_value <
-                              (double)(right->sp_val.sp_short_value));
+            condition_true = (spec_val(left,sp_real_value) <
+                              (double)(spec_val(right,sp_short_value)));
 		 } 
-		 else if (right->sp_form == ft_long) {
+		 else if (spec_form(right) == ft_long) {
 		 
-		    condition_true = ((left->sp_val.sp_real_ptr)->r_value <
+		    condition_true = (spec_val(left,sp_real_value) <
                                (double)(long_to_double(SETL_SYSTEM right)));
                                
 		 }
@@ -13629,9 +11364,9 @@ case p_gonlt :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_binop_method(SETL_SYSTEM &spare1,
                               right,
                               left,
@@ -13662,43 +11397,17 @@ case p_gonlt :
 
          /* make sure the right operand is a string */
 
-         if (right->sp_form == ft_string) {
+         if (spec_form(right) == ft_string) {
 
             /* pick out the string headers */
 
-            left_string_hdr = left->sp_val.sp_string_ptr;
-            right_string_hdr = right->sp_val.sp_string_ptr;
+            left_string_hdr = spec_val(left,sp_string_ptr);
+            right_string_hdr = spec_val(right,sp_string_ptr);
 
             /* we just traverse the two strings until we find a mismatch */
 
-            left_string_cell = left_string_hdr->s_head;
-            right_string_cell = right_string_hdr->s_head;
-
-            /* set up cell limit pointers */
-
-            if (right_string_cell == NULL) {
-
-               right_char_ptr = right_char_end = NULL;
-
-            }
-            else {
-
-               right_char_ptr = right_string_cell->s_cell_value;
-               right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (left_string_cell == NULL) {
-
-               left_char_ptr = left_char_end = NULL;
-
-            }
-            else {
-
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
+            left_char_ptr = left_string_hdr->s_chars;
+            right_char_ptr = right_string_hdr->s_chars;
 
             /* loop over the strings in parallel */
 
@@ -13707,22 +11416,6 @@ case p_gonlt :
 
             while (target_string_length--) {
 
-               if (left_char_ptr == left_char_end) {
-
-                  left_string_cell = left_string_cell->s_next;
-                  left_char_ptr = left_string_cell->s_cell_value;
-                  left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-               }
-
-               if (right_char_ptr == right_char_end) {
-
-                  right_string_cell = right_string_cell->s_next;
-                  right_char_ptr = right_string_cell->s_cell_value;
-                  right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-               }
-
                /* if we find a mismatch, break */
 
                if (*left_char_ptr != *right_char_ptr)
@@ -13759,9 +11452,9 @@ case p_gonlt :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_binop_method(SETL_SYSTEM &spare1,
                               right,
                               left,
@@ -13794,14 +11487,14 @@ case p_gonlt :
 
       case ft_set :
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
-         if (right->sp_form == ft_set) {
+         if (spec_form(right) == ft_set) {
 
             condition_true = (set_subset(SETL_SYSTEM left,right) &&
-                  ((left->sp_val.sp_set_ptr)->s_ntype.s_root.s_cardinality <
-                   (right->sp_val.sp_set_ptr)->s_ntype.s_root.s_cardinality));
+                  (spec_val(left,sp_set_ptr)->s_cardinality <
+                   spec_val(right,sp_set_ptr)->s_cardinality));
 
             break;
 
@@ -13812,9 +11505,9 @@ case p_gonlt :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_binop_method(SETL_SYSTEM &spare1,
                               right,
                               left,
@@ -13845,7 +11538,7 @@ case p_gonlt :
 
       case ft_object :
 
-         spare1.sp_form = ft_omega;
+         spec_set_form(&spare1,ft_omega);
          call_binop_method(SETL_SYSTEM &spare1,
                            left,
                            right,
@@ -13865,9 +11558,9 @@ case p_gonlt :
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_binop_method(SETL_SYSTEM &spare1,
                               right,
                               left,
@@ -13902,14 +11595,14 @@ case p_gonlt :
       case p_golt :
 
          if (condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
       case p_gonlt :
 
          if (!condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
@@ -13920,15 +11613,15 @@ case p_gonlt :
          if (condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -13941,15 +11634,15 @@ case p_gonlt :
          if (!condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -14002,6 +11695,8 @@ PRTYPE void cond_ops3(SETL_SYSTEM_PROTO_VOID)
 
 case p_le :             case p_nle :            case p_gole :
 case p_gonle :
+opcode_label(p_le) opcode_label(p_nle) opcode_label(p_gole)
+opcode_label(p_gonle)
 
 {
 
@@ -14019,7 +11714,7 @@ case p_gonle :
 
    /* the action we take depends on the form of the operands */
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
       /*
        *  We can compare short integers with other short integers and long
@@ -14032,17 +11727,19 @@ case p_gonle :
           *  If both operands are short we just compare the values.
           */
 
-         if (right->sp_form == ft_short) {
+         if (spec_form(right) == ft_short) {
 
             condition_true =
-               (left->sp_val.sp_short_value <= right->sp_val.sp_short_value);
+               (spec_val(left,sp_short_value) <=
+                spec_val(right,sp_short_value));
 
             break;
 
-         } else if (right->sp_form == ft_real) {
+         } else if (spec_form(right) == ft_real) {
 			
 			condition_true = 
-               (left->sp_val.sp_short_value <= (right->sp_val.sp_real_ptr)->r_value);
+               (spec_val(left,sp_short_value) <=
+                spec_val(right,sp_real_value));
 
             break;
 
@@ -14053,7 +11750,7 @@ case p_gonle :
           *  the case in which the second operand is long.
           */
 
-         else if (right->sp_form == ft_long) {
+         else if (spec_form(right) == ft_long) {
 
             condition_true = integer_le(SETL_SYSTEM left,right);
 
@@ -14066,9 +11763,9 @@ case p_gonle :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            object_root = right->sp_val.sp_object_ptr;
+            object_root = spec_val(right,sp_object_ptr);
             class_ptr = object_root->o_ntype.o_root.o_class;
 
             /* get information about this slot in the object */
@@ -14093,7 +11790,7 @@ case p_gonle :
 
             /* call the procedure */
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_procedure(SETL_SYSTEM &spare1,
                            slot_info->si_spec,
                            right,
@@ -14127,16 +11824,16 @@ case p_gonle :
           *  general function which adds any type of integers.
           */
 
-         if (right->sp_form == ft_short || right->sp_form == ft_long) {
+         if (spec_form(right) == ft_short || spec_form(right) == ft_long) {
 
             condition_true = integer_le(SETL_SYSTEM left,right);
 
             break;
 
-         } else if (right->sp_form == ft_real) {
+         } else if (spec_form(right) == ft_real) {
 			
             condition_true = ((double)(long_to_double(SETL_SYSTEM left)) <=
-            			 (right->sp_val.sp_real_ptr)->r_value);
+            			 spec_val(right,sp_real_value));
 
             break;
 
@@ -14147,9 +11844,9 @@ case p_gonle :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            object_root = right->sp_val.sp_object_ptr;
+            object_root = spec_val(right,sp_object_ptr);
             class_ptr = object_root->o_ntype.o_root.o_class;
 
             /* get information about this slot in the object */
@@ -14174,7 +11871,7 @@ case p_gonle :
 
             /* call the procedure */
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_procedure(SETL_SYSTEM &spare1,
                            slot_info->si_spec,
                            right,
@@ -14202,19 +11899,19 @@ case p_gonle :
 
       case ft_real :
 
-         if (right->sp_form == ft_real) {
+         if (spec_form(right) == ft_real) {
 
-            condition_true = ((left->sp_val.sp_real_ptr)->r_value <=
-                              (right->sp_val.sp_real_ptr)->r_value);
+            condition_true = (spec_val(left,sp_real_value) <=
+                              spec_val(right,sp_real_value));
 
-         } else if (right->sp_form == ft_short) {
+         } else if (spec_form(right) == ft_short) {
          
-            condition_true = ((left->sp_val.sp_real_ptr)->r_value <=
-                              (double)(right->sp_val.sp_short_value));
+            condition_true = (spec_val(left,sp_real_value) <=
+                              (double)(spec_val(right,sp_short_value)));
 		 } 
-		 else if (right->sp_form == ft_long) {
+		 else if (spec_form(right) == ft_long) {
 		 
-		    condition_true = ((left->sp_val.sp_real_ptr)->r_value <=
+		    condition_true = (spec_val(left,sp_real_value) <=
                                (double)(long_to_double(SETL_SYSTEM right)));
                                
 		 }
@@ -14224,9 +11921,9 @@ case p_gonle :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            object_root = right->sp_val.sp_object_ptr;
+            object_root = spec_val(right,sp_object_ptr);
             class_ptr = object_root->o_ntype.o_root.o_class;
 
             /* get information about this slot in the object */
@@ -14251,7 +11948,7 @@ case p_gonle :
 
             /* call the procedure */
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_procedure(SETL_SYSTEM &spare1,
                            slot_info->si_spec,
                            right,
@@ -14281,43 +11978,17 @@ case p_gonle :
 
          /* make sure the right operand is a string */
 
-         if (right->sp_form == ft_string) {
+         if (spec_form(right) == ft_string) {
 
             /* pick out the string headers */
 
-            left_string_hdr = left->sp_val.sp_string_ptr;
-            right_string_hdr = right->sp_val.sp_string_ptr;
+            left_string_hdr = spec_val(left,sp_string_ptr);
+            right_string_hdr = spec_val(right,sp_string_ptr);
 
             /* we just traverse the two strings until we find a mismatch */
 
-            left_string_cell = left_string_hdr->s_head;
-            right_string_cell = right_string_hdr->s_head;
-
-            /* set up cell limit pointers */
-
-            if (right_string_cell == NULL) {
-
-               right_char_ptr = right_char_end = NULL;
-
-            }
-            else {
-
-               right_char_ptr = right_string_cell->s_cell_value;
-               right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (left_string_cell == NULL) {
-
-               left_char_ptr = left_char_end = NULL;
-
-            }
-            else {
-
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
+            left_char_ptr = left_string_hdr->s_chars;
+            right_char_ptr = right_string_hdr->s_chars;
 
             /* loop over the strings in parallel */
 
@@ -14326,22 +11997,6 @@ case p_gonle :
 
             while (target_string_length--) {
 
-               if (left_char_ptr == left_char_end) {
-
-                  left_string_cell = left_string_cell->s_next;
-                  left_char_ptr = left_string_cell->s_cell_value;
-                  left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-               }
-
-               if (right_char_ptr == right_char_end) {
-
-                  right_string_cell = right_string_cell->s_next;
-                  right_char_ptr = right_string_cell->s_cell_value;
-                  right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-               }
-
                /* if we find a mismatch, break */
 
                if (*left_char_ptr != *right_char_ptr)
@@ -14378,9 +12033,9 @@ case p_gonle :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            object_root = right->sp_val.sp_object_ptr;
+            object_root = spec_val(right,sp_object_ptr);
             class_ptr = object_root->o_ntype.o_root.o_class;
 
             /* get information about this slot in the object */
@@ -14405,7 +12060,7 @@ case p_gonle :
 
             /* call the procedure */
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_procedure(SETL_SYSTEM &spare1,
                            slot_info->si_spec,
                            right,
@@ -14437,10 +12092,10 @@ case p_gonle :
 
       case ft_set :
 
-         if (right->sp_form == ft_map)
+         if (spec_form(right) == ft_map)
             map_to_set(SETL_SYSTEM right,right);
 
-         if (right->sp_form == ft_set) {
+         if (spec_form(right) == ft_set) {
 
             condition_true = set_subset(SETL_SYSTEM left,right);
 
@@ -14453,9 +12108,9 @@ case p_gonle :
           *  objects on the right.
           */
 
-         else if (right->sp_form == ft_object) {
+         else if (spec_form(right) == ft_object) {
 
-            object_root = right->sp_val.sp_object_ptr;
+            object_root = spec_val(right,sp_object_ptr);
             class_ptr = object_root->o_ntype.o_root.o_class;
 
             /* get information about this slot in the object */
@@ -14480,7 +12135,7 @@ case p_gonle :
 
             /* call the procedure */
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_procedure(SETL_SYSTEM &spare1,
                            slot_info->si_spec,
                            right,
@@ -14510,7 +12165,7 @@ case p_gonle :
 
       case ft_object :
 
-         object_root = left->sp_val.sp_object_ptr;
+         object_root = spec_val(left,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -14535,7 +12190,7 @@ case p_gonle :
 
          /* call the procedure */
 
-         spare1.sp_form = ft_omega;
+         spec_set_form(&spare1,ft_omega);
          call_procedure(SETL_SYSTEM &spare1,
                         slot_info->si_spec,
                         left,
@@ -14554,9 +12209,9 @@ case p_gonle :
           *  objects on the right.
           */
 
-         if (right->sp_form == ft_object) {
+         if (spec_form(right) == ft_object) {
 
-            object_root = right->sp_val.sp_object_ptr;
+            object_root = spec_val(right,sp_object_ptr);
             class_ptr = object_root->o_ntype.o_root.o_class;
 
             /* get information about this slot in the object */
@@ -14581,7 +12236,7 @@ case p_gonle :
 
             /* call the procedure */
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_procedure(SETL_SYSTEM &spare1,
                            slot_info->si_spec,
                            right,
@@ -14614,14 +12269,14 @@ case p_gonle :
       case p_gole :
 
          if (condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
       case p_gonle :
 
          if (!condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
@@ -14632,15 +12287,15 @@ case p_gonle :
          if (condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -14653,15 +12308,15 @@ case p_gonle :
          if (!condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -14714,6 +12369,8 @@ PRTYPE void cond_ops4(SETL_SYSTEM_PROTO_VOID)
 
 case p_goin :           case p_gonotin :        case p_in :
 case p_notin :
+opcode_label(p_goin) opcode_label(p_gonotin) opcode_label(p_in)
+opcode_label(p_notin)
 
 {
 
@@ -14724,7 +12381,7 @@ case p_notin :
 
    /* the action we take depends on the form of the operands */
 
-   switch (right->sp_form) {
+   switch (spec_form(right)) {
 
       /*
        *  This is a completely simple, stupid substring test.  It needs to
@@ -14735,12 +12392,12 @@ case p_notin :
 
          /* make sure the right operand is a string */
 
-         if (left->sp_form == ft_string) {
+         if (spec_form(left) == ft_string) {
 
             /* pick out the string headers */
 
-            left_string_hdr = left->sp_val.sp_string_ptr;
-            right_string_hdr = right->sp_val.sp_string_ptr;
+            left_string_hdr = spec_val(left,sp_string_ptr);
+            right_string_hdr = spec_val(right,sp_string_ptr);
 
             /* if the left string is null, return TRUE */
 
@@ -14760,378 +12417,149 @@ case p_notin :
 
             }
 
-            /* we traverse the right string searching for the left */
-
-            right_string_cell = right_string_hdr->s_head;
-            left_string_cell = left_string_hdr->s_head;
-
-            /* set up cell limit pointers */
-
-            if (right_string_cell == NULL) {
-
-               right_char_ptr = right_char_end = NULL;
-
-            }
-            else {
-
-               right_char_ptr = right_string_cell->s_cell_value;
-               right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            left_char_ptr = left_string_cell->s_cell_value;
-            left_char_end = left_char_ptr + STR_CELL_WIDTH;
+            /*
+             *  We traverse the right string searching for the first
+             *  character of the left, and compare the strings wherever we
+             *  find it.
+             */
 
             condition_true = NO;
-            right_string_length = right_string_hdr->s_length -
-                                  left_string_hdr->s_length + 1;
-
-            while (right_string_length--) {
-
-               if (right_char_ptr == right_char_end) {
-
-                  right_string_cell = right_string_cell->s_next;
-                  right_char_ptr = right_string_cell->s_cell_value;
-                  right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-               }
-
-               if (*left_char_ptr != *right_char_ptr) {
-
-                  right_char_ptr++;
-                  continue;
-
-               }
-
-               /*
-                *  We found the first character of the target string.  We
-                *  compare the right string with the left.
-                */
-
-               left_string_length = left_string_hdr->s_length;
-               target_string_cell = right_string_cell;
-               target_char_ptr = right_char_ptr;
-               target_char_end = right_char_end;
-               right_char_ptr++;
-
-               while (left_string_length--) {
-
-                  if (left_char_ptr == left_char_end) {
-
-                     left_string_cell = left_string_cell->s_next;
-                     left_char_ptr = left_string_cell->s_cell_value;
-                     left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-                  }
-
-                  if (target_char_ptr == target_char_end) {
-
-                     target_string_cell = target_string_cell->s_next;
-                     target_char_ptr = target_string_cell->s_cell_value;
-                     target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-                  }
-
-                  if (*target_char_ptr != *left_char_ptr)
-                     break;
-
-                  left_char_ptr++;
-                  target_char_ptr++;
-
-               }
-
-               /* if we fell off the end of left string we found the target */
-
-               if (left_string_length < 0) {
-
-                  condition_true = YES;
+            left_string_length = left_string_hdr->s_length;
+            left_char_ptr = left_string_hdr->s_chars;
+            right_char_ptr = right_string_hdr->s_chars;
+            right_char_end = right_char_ptr +
+                             (right_string_hdr->s_length -
+                              left_string_length + 1);
+
+            while (right_char_ptr < right_char_end) {
+
+               right_char_ptr = (char *)memchr((void *)right_char_ptr,
+                                               *left_char_ptr,
+                                               (size_t)(right_char_end -
+                                                        right_char_ptr));
+               if (right_char_ptr == NULL)
                   break;
 
-               }
-
-               /* we didn't match -- reset the left string */
-
-               left_string_cell = left_string_hdr->s_head;
-
-               /* set up cell limit pointers */
-
-               left_char_ptr = left_string_cell->s_cell_value;
-               left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            break;
-
-         }
-
-         /* that's all we accept */
-
-         else {
-
-            binop_abend(SETL_SYSTEM msg_bad_binop_forms,"IN",
-                  abend_opnd_str(SETL_SYSTEM left),
-                  abend_opnd_str(SETL_SYSTEM right));
-
-         }
-
-         break;
-
-      /*
-       *  Test whether an element is a member of a set.
-       */
-
-      case ft_map :
-
-         /*
-          *  If the value being checked is not a tuple of length 2, it
-          *  can't be in a map.
-          */
-
-         if (left->sp_form != ft_tuple) {
-
-            condition_true = NO;
-            break;
-
-         }
-
-         /* pick out the domain and range elements */
-
-         tuple_root = left->sp_val.sp_tuple_ptr;
-         if (tuple_root->t_ntype.t_root.t_length != 2) {
-
-            condition_true = NO;
-            break;
-
-         }
-
-         /* we need the left-most child */
-
-         source_height = tuple_root->t_ntype.t_root.t_height;
-         while (source_height--) {
-
-            tuple_root = tuple_root->t_child[0].t_header;
-
-#ifdef TRAPS
-
-            if (tuple_root == NULL)
-               giveup(SETL_SYSTEM msg_corrupted_tuple);
-
-#endif
-
-         }
-
-         /* if the domain or range is omega, break */
-
-         domain_element = &((tuple_root->t_child[0].t_cell)->t_spec);
-         domain_hash_code = (tuple_root->t_child[0].t_cell)->t_hash_code;
-         range_element = &((tuple_root->t_child[1].t_cell)->t_spec);
-         range_hash_code = (tuple_root->t_child[1].t_cell)->t_hash_code;
-
-         if (domain_element->sp_form == ft_omega) {
-
-            condition_true = NO;
-            break;
-
-         }
-
-         /*
-          *  We now have a valid pair, so we search for it in the
-          *  map.
-          */
-
-         map_root = right->sp_val.sp_map_ptr;
-         map_work_hdr = map_root;
-         work_hash_code = domain_hash_code;
-         target_height = map_root->m_ntype.m_root.m_height;
-         while (target_height-- && map_work_hdr != NULL) {
-
-            /* extract the element's index at this level */
-
-            target_index = work_hash_code & MAP_HASH_MASK;
-            work_hash_code >>= MAP_SHIFT_DIST;
-
-            map_work_hdr =
-               map_work_hdr->m_child[target_index].m_header;
-
-         }
-
-         if (map_work_hdr == NULL) {
-
-            condition_true = NO;
-            break;
-
-         }
-
-         /*
-          *  At this point, map_work_hdr points to the lowest level header
-          *  record.  The next problem is to determine if the domain element
-          *  is in the map.  We compare the element with the clash list.
-          */
-
-         target_index = work_hash_code & MAP_HASH_MASK;
-         for (map_cell = map_work_hdr->m_child[target_index].m_cell;
-              map_cell != NULL &&
-                 map_cell->m_hash_code < domain_hash_code;
-              map_cell = map_cell->m_next);
-
-         /* try to find the domain element */
-
-         is_equal = NO;
-         while (map_cell != NULL &&
-                map_cell->m_hash_code == domain_hash_code) {
-
-            spec_equal(is_equal,&(map_cell->m_domain_spec),domain_element);
-
-            if (is_equal)
-               break;
-
-            map_cell = map_cell->m_next;
-
-         }
-
-         if (!is_equal) {
-
-            condition_true = NO;
-            break;
-
-         }
-
-         /* if we don't have a multi-value cell, just check the range */
-
-         if (!(map_cell->m_is_multi_val)) {
-
-            spec_equal(condition_true,
-                       &(map_cell->m_range_spec),range_element);
-            break;
-
-         }
+               if (memcmp((void *)right_char_ptr,
+                          (void *)left_char_ptr,
+                          (size_t)left_string_length) == 0) {
 
-         /*
-          *  We have to check the value set.
-          */
+                  condition_true = YES;
+                  break;
 
-         set_root = map_cell->m_range_spec.sp_val.sp_set_ptr;
-         set_work_hdr = set_root;
+               }
 
-         /* get the element's hash code */
+               right_char_ptr++;
 
-         work_hash_code = range_hash_code;
+            }
 
-         /* descend the header tree until we get to a leaf */
+            break;
 
-         source_height = set_root->s_ntype.s_root.s_height;
-         while (source_height-- && set_work_hdr != NULL) {
+         }
 
-            /* extract the element's index at this level */
+         /* that's all we accept */
 
-            source_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code >>= SET_SHIFT_DIST;
+         else {
 
-            set_work_hdr =
-               set_work_hdr->s_child[source_index].s_header;
+            binop_abend(SETL_SYSTEM msg_bad_binop_forms,"IN",
+                  abend_opnd_str(SETL_SYSTEM left),
+                  abend_opnd_str(SETL_SYSTEM right));
 
          }
 
-         if (set_work_hdr == NULL) {
+         break;
 
-            condition_true = NO;
-            break;
+      /*
+       *  Test whether an element is a member of a set.
+       */
 
-         }
+      case ft_map :
 
          /*
-          *  At this point, set_work_hdr points to the lowest level header
-          *  record.  The next problem is to determine if the element is in
-          *  the set.  We compare the element with the clash list.
+          *  If the value being checked is not a tuple of length 2, it
+          *  can't be in a map.
           */
 
-         source_index = work_hash_code & SET_HASH_MASK;
-         for (set_cell = set_work_hdr->s_child[source_index].s_cell;
-              set_cell != NULL &&
-                 set_cell->s_hash_code < range_hash_code;
-              set_cell = set_cell->s_next);
+         if (spec_form(left) != ft_tuple) {
 
-         /* check for a duplicate element */
+            condition_true = NO;
+            break;
 
-         condition_true = NO;
-         while (set_cell != NULL &&
-                set_cell->s_hash_code == range_hash_code) {
+         }
 
-            spec_equal(condition_true,&(set_cell->s_spec),range_element);
+         /* pick out the domain and range elements */
 
-            if (condition_true)
-               break;
+         tuple_root = spec_val(left,sp_tuple_ptr);
+         if (tuple_root->t_length != 2) {
 
-            set_cell = set_cell->s_next;
+            condition_true = NO;
+            break;
 
          }
 
-         break;
-
-      case ft_set :
-
-         set_root = right->sp_val.sp_set_ptr;
+         /* if the domain or range is omega, break */
 
-         /* get the test element's hash code */
+         unpack_tuple(tuple_root);
+         domain_element = &(tuple_root->t_cells[0].t_spec);
+         domain_hash_code = tuple_root->t_cells[0].t_hash_code;
+         range_element = &(tuple_root->t_cells[1].t_spec);
+         range_hash_code = tuple_root->t_cells[1].t_hash_code;
 
-         spec_hash_code(work_hash_code,left);
-         source_hash_code = work_hash_code;
+         if (spec_form(domain_element) == ft_omega) {
 
-         /* descend the header tree until we get to a leaf */
+            condition_true = NO;
+            break;
 
-         source_height = set_root->s_ntype.s_root.s_height;
-         set_work_hdr = set_root;
-         condition_true = YES;
+         }
 
-         while (source_height-- && condition_true) {
+         /*
+          *  We now have a valid pair, so we search for it in the
+          *  map.
+          */
 
-            /* extract the element's index at this level */
+         map_root = spec_val(right,sp_map_ptr);
+         map_cell = map_lookup(map_root->m_trie,
+                               domain_element,
+                               domain_hash_code);
 
-            source_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code = work_hash_code >> SET_SHIFT_DIST;
+         if (map_cell == NULL) {
 
-            /* if we're missing a header record, we can quit */
+            condition_true = NO;
+            break;
 
-            if (set_work_hdr->s_child[source_index].s_header == NULL) {
+         }
 
-               condition_true = NO;
-               break;
+         /* if we don't have a multi-value cell, just check the range */
 
-            }
+         if (!(map_cell->m_is_multi_val)) {
 
-            set_work_hdr = set_work_hdr->s_child[source_index].s_header;
+            spec_equal(condition_true,
+                       &(map_cell->m_range_spec),range_element);
+            break;
 
          }
 
          /*
-          *  At this point, set_work_hdr points to the lowest level header
-          *  record.  The next problem is to determine if the element is
-          *  in the clash list.
+          *  We have to check the value set.
           */
 
-         if (condition_true) {
-
-            source_index = work_hash_code & SET_HASH_MASK;
-            for (set_cell = set_work_hdr->s_child[source_index].s_cell;
-                 set_cell != NULL &&
-                    set_cell->s_hash_code < source_hash_code;
-                 set_cell = set_cell->s_next);
+         set_root = spec_val(&map_cell->m_range_spec,sp_set_ptr);
+         condition_true = (set_lookup(SETL_SYSTEM set_root->s_trie,
+                                      range_element,
+                                      range_hash_code) != NULL);
 
-            /* check for a duplicate element */
-
-            condition_true = NO;
-            while (set_cell != NULL &&
-                   set_cell->s_hash_code == source_hash_code) {
+         break;
 
-               spec_equal(condition_true,&(set_cell->s_spec),left);
+      case ft_set :
 
-               if (condition_true)
-                  break;
+         set_root = spec_val(right,sp_set_ptr);
 
-               set_cell = set_cell->s_next;
+         /* look up the test element */
 
-            }
-         }
+         spec_hash_code(source_hash_code,left);
+         condition_true = (set_lookup(SETL_SYSTEM set_root->s_trie,
+                                      left,
+                                      source_hash_code) != NULL);
 
          break;
 
@@ -15141,105 +12569,66 @@ case p_notin :
 
       case ft_tuple :
 
-         /* set up to iterate over the source */
+         /* loop over the source looking for the element */
 
-         tuple_root = right->sp_val.sp_tuple_ptr;
-         tuple_work_hdr = tuple_root;
-         source_height = tuple_root->t_ntype.t_root.t_height;
-         target_number = 0;
-         source_index = 0;
+         tuple_root = spec_val(right,sp_tuple_ptr);
          condition_true = NO;
 
-         while (target_number < tuple_root->t_ntype.t_root.t_length) {
-
-            /* if we have an element already, check it it */
-
-            if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-               if (tuple_work_hdr->t_child[source_index].t_cell == NULL) {
+         /* packed tuples hold only numbers of one form */
 
-                  if (target_number < tuple_root->t_ntype.t_root.t_length &&
-                      left->sp_form == ft_omega) {
+         if (is_packed(tuple_root)) {
 
-                     condition_true = YES;
-
-                     break;
-
-                  }
-
-                  target_number++;
-                  source_index++;
-
-                  continue;
+#ifndef COERCE_EQUALITY
+            if (!packs_into(tuple_root,left))
+               break;
+#endif
 
-               }
+            for (short_value = 0;
+                 short_value < tuple_root->t_length;
+                 short_value++) {
 
-               tuple_cell = tuple_work_hdr->t_child[source_index].t_cell;
-               spec_equal(is_equal,&(tuple_cell->t_spec),left);
+               get_packed_element(tuple_root,short_value,&spare1);
+               spec_equal(is_equal,&spare1,left);
                if (is_equal) {
 
                   condition_true = YES;
-
                   break;
 
                }
-
-               target_number++;
-               source_index++;
-
-               continue;
-
             }
 
-            /* the current header node is exhausted -- find the next one */
-
-            if (source_index >= TUP_HEADER_SIZE) {
-
-               /* break if we've exhausted the source */
-
-               if (tuple_work_hdr == tuple_root) {
-
-                  condition_true = left->sp_form == ft_omega;
-                  break;
-
-               }
+            break;
 
-               source_height++;
-               source_index =
-                  tuple_work_hdr->t_ntype.t_intern.t_child_index + 1;
-               tuple_work_hdr =
-                  tuple_work_hdr->t_ntype.t_intern.t_parent;
+         }
 
-               continue;
+         for (short_value = 0;
+              short_value < tuple_root->t_length;
+              short_value++) {
 
-            }
+            tuple_cell = tuple_cell_at(tuple_root,short_value);
 
-            /* skip over null nodes */
+            /* omega is a component of any tuple with holes */
 
-            if (tuple_work_hdr->t_child[source_index].t_header == NULL) {
+            if (spec_form(&tuple_cell->t_spec) == ft_omega) {
 
-               if (target_number < tuple_root->t_ntype.t_root.t_length &&
-                   left->sp_form == ft_omega) {
+               if (spec_form(left) == ft_omega) {
 
                   condition_true = YES;
                   break;
 
                }
 
-               target_number += 1L << (source_height * TUP_SHIFT_DIST);
-               source_index++;
-
                continue;
 
             }
 
-            /* otherwise drop down a level */
+            spec_equal(is_equal,&(tuple_cell->t_spec),left);
+            if (is_equal) {
 
-            tuple_work_hdr =
-               tuple_work_hdr->t_child[source_index].t_header;
-            source_index = 0;
-            source_height--;
+               condition_true = YES;
+               break;
 
+            }
          }
 
          break;
@@ -15252,7 +12641,7 @@ case p_notin :
 
       case ft_object :
 
-         object_root = right->sp_val.sp_object_ptr;
+         object_root = spec_val(right,sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
          /* get information about this slot in the object */
@@ -15271,7 +12660,7 @@ case p_notin :
 
          /* call the procedure */
 
-         spare1.sp_form = ft_omega;
+         spec_set_form(&spare1,ft_omega);
          call_procedure(SETL_SYSTEM &spare1,
                         slot_info->si_spec,
                         right,
@@ -15290,9 +12679,9 @@ case p_notin :
           *  objects on the left.
           */
 
-         if (left->sp_form == ft_object) {
+         if (spec_form(left) == ft_object) {
 
-            object_root = left->sp_val.sp_object_ptr;
+            object_root = spec_val(left,sp_object_ptr);
             class_ptr = object_root->o_ntype.o_root.o_class;
 
             /* get information about this slot in the object */
@@ -15311,7 +12700,7 @@ case p_notin :
 
             /* call the procedure */
 
-            spare1.sp_form = ft_omega;
+            spec_set_form(&spare1,ft_omega);
             call_procedure(SETL_SYSTEM &spare1,
                            slot_info->si_spec,
                            left,
@@ -15345,14 +12734,14 @@ case p_notin :
       case p_goin :
 
          if (condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
       case p_gonotin :
 
          if (!condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
@@ -15363,15 +12752,15 @@ case p_notin :
          if (condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -15384,15 +12773,15 @@ case p_notin :
          if (!condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -15442,6 +12831,7 @@ PRTYPE void cond_ops5(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_incs :           case p_goincs :        case p_gonincs :
+opcode_label(p_incs) opcode_label(p_goincs) opcode_label(p_gonincs)
 
 {
 
@@ -15450,13 +12840,13 @@ case p_incs :           case p_goincs :        case p_gonincs :
    left = ip->i_operand[1].i_spec_ptr;
    right = ip->i_operand[2].i_spec_ptr;
 
-   if (left->sp_form == ft_map)
+   if (spec_form(left) == ft_map)
       map_to_set(SETL_SYSTEM left,left);
 
-   if (right->sp_form == ft_map)
+   if (spec_form(right) == ft_map)
       map_to_set(SETL_SYSTEM right,right);
 
-   if (left->sp_form != ft_set || right->sp_form != ft_set) {
+   if (spec_form(left) != ft_set || spec_form(right) != ft_set) {
 
       abend(SETL_SYSTEM msg_incompatible_opnds,
             abend_opnd_str(SETL_SYSTEM left),
@@ -15476,14 +12866,14 @@ case p_incs :           case p_goincs :        case p_gonincs :
       case p_goincs :
 
          if (condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
       case p_gonincs :
 
          if (!condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
@@ -15494,15 +12884,15 @@ case p_incs :           case p_goincs :        case p_gonincs :
          if (condition_true) {
 
             unmark_specifier(target);
-            target->sp_form = spec_true->sp_form;
-            target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_true));
+            spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
          }
          else {
 
             unmark_specifier(target);
-            target->sp_form = spec_false->sp_form;
-            target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+            spec_set_form(target,spec_form(spec_false));
+            spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
          }
 
@@ -15524,6 +12914,7 @@ case p_incs :           case p_goincs :        case p_gonincs :
 \*/
 
 case p_gotrue :         case p_gofalse :
+opcode_label(p_gotrue) opcode_label(p_gofalse)
 
 {
 
@@ -15531,17 +12922,17 @@ case p_gotrue :         case p_gofalse :
 
    left = ip->i_operand[1].i_spec_ptr;
 
-   if (left->sp_form != ft_atom) {
+   if (spec_form(left) != ft_atom) {
 
       abend(SETL_SYSTEM "Expected TRUE or FALSE");
 
    }
-   else if (left->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num) {
+   else if (spec_val(left,sp_atom_num) == spec_val(spec_true,sp_atom_num)) {
 
       condition_true = YES;
 
    }
-   else if (left->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
+   else if (spec_val(left,sp_atom_num) == spec_val(spec_false,sp_atom_num)) {
 
       condition_true = NO;
 
@@ -15562,14 +12953,14 @@ case p_gotrue :         case p_gofalse :
       case p_gotrue :
 
          if (condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
       case p_gofalse :
 
          if (!condition_true)
-            pc = ip->i_operand[0].i_inst_ptr;
+            branch_to(ip->i_operand[0].i_inst_ptr);
 
          break;
 
@@ -15589,8 +12980,9 @@ case p_gotrue :         case p_gofalse :
 \*/
 
 case p_go :
+opcode_label(p_go)
 
-   pc = ip->i_operand[0].i_inst_ptr;
+   branch_to(ip->i_operand[0].i_inst_ptr);
 
    break;
 
@@ -15604,17 +12996,18 @@ case p_go :
 \*/
 
 case p_goind :
+opcode_label(p_goind)
 
    left = ip->i_operand[0].i_spec_ptr;
 
 #ifdef TRAPS
 
-   if (left->sp_form != ft_label)
+   if (spec_form(left) != ft_label)
       trap(__FILE__,__LINE__,msg_bad_indirect_goto);
 
 #endif
 
-   pc = left->sp_val.sp_label_ptr;
+   branch_to(spec_val(left,sp_label_ptr));
 
    break;
 
@@ -15628,6 +13021,7 @@ case p_goind :
 \*/
 
 case p_and :
+opcode_label(p_and)
 
 {
 
@@ -15637,24 +13031,25 @@ case p_and :
    left = ip->i_operand[1].i_spec_ptr;
    right = ip->i_operand[2].i_spec_ptr;
 
-   if (left->sp_form != ft_atom || right->sp_form != ft_atom) {
+   if (spec_form(left) != ft_atom || spec_form(right) != ft_atom) {
 
       abend(SETL_SYSTEM "Expected TRUE or FALSE");
 
    }
-   else if (left->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num) {
-      if (right->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num) {
+   else if (spec_val(left,sp_atom_num) == spec_val(spec_true,sp_atom_num)) {
+      if (spec_val(right,sp_atom_num) == spec_val(spec_true,sp_atom_num)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_atom;
-         target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+         spec_set_form(target,ft_atom);
+         spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       }
-      else if (right->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
+      else if (spec_val(right,sp_atom_num) ==
+               spec_val(spec_false,sp_atom_num)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_atom;
-         target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+         spec_set_form(target,ft_atom);
+         spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       }
       else {
@@ -15663,13 +13058,13 @@ case p_and :
 
       }
    }
-   else if (left->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
-      if (right->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num ||
-          right->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
+   else if (spec_val(left,sp_atom_num) == spec_val(spec_false,sp_atom_num)) {
+      if (spec_val(right,sp_atom_num) == spec_val(spec_true,sp_atom_num) ||
+          spec_val(right,sp_atom_num) == spec_val(spec_false,sp_atom_num)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_atom;
-         target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+         spec_set_form(target,ft_atom);
+         spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       }
       else {
@@ -15698,6 +13093,7 @@ case p_and :
 \*/
 
 case p_or :
+opcode_label(p_or)
 
 {
 
@@ -15707,24 +13103,25 @@ case p_or :
    left = ip->i_operand[1].i_spec_ptr;
    right = ip->i_operand[2].i_spec_ptr;
 
-   if (left->sp_form != ft_atom || right->sp_form != ft_atom) {
+   if (spec_form(left) != ft_atom || spec_form(right) != ft_atom) {
 
       abend(SETL_SYSTEM "Expected TRUE or FALSE");
 
    }
-   else if (left->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
-      if (right->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num) {
+   else if (spec_val(left,sp_atom_num) == spec_val(spec_false,sp_atom_num)) {
+      if (spec_val(right,sp_atom_num) == spec_val(spec_true,sp_atom_num)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_atom;
-         target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+         spec_set_form(target,ft_atom);
+         spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       }
-      else if (right->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
+      else if (spec_val(right,sp_atom_num) ==
+               spec_val(spec_false,sp_atom_num)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_atom;
-         target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+         spec_set_form(target,ft_atom);
+         spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       }
       else {
@@ -15733,13 +13130,13 @@ case p_or :
 
       }
    }
-   else if (left->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num) {
-      if (right->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num ||
-          right->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
+   else if (spec_val(left,sp_atom_num) == spec_val(spec_true,sp_atom_num)) {
+      if (spec_val(right,sp_atom_num) == spec_val(spec_true,sp_atom_num) ||
+          spec_val(right,sp_atom_num) == spec_val(spec_false,sp_atom_num)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_atom;
-         target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+         spec_set_form(target,ft_atom);
+         spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       }
       else {
@@ -15798,6 +13195,7 @@ PRTYPE void iter_ops1(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_iter :
+opcode_label(p_iter)
 
 {
 
@@ -15816,15 +13214,15 @@ case p_iter :
 
       case it_pow :
 
-         switch (left->sp_form) {
+         switch (spec_form(left)) {
 
             case ft_map :
 
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
                map_to_set(SETL_SYSTEM &spare,left);
                start_pow_iterator(SETL_SYSTEM target,&spare);
                unmark_specifier(&spare);
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
                break;
 
             case ft_set :
@@ -15839,7 +13237,7 @@ case p_iter :
 
             case ft_object :
 
-               object_root = left->sp_val.sp_object_ptr;
+               object_root = spec_val(left,sp_object_ptr);
                class_ptr = object_root->o_ntype.o_root.o_class;
 
                /* get information about this slot in the object */
@@ -15854,7 +13252,7 @@ case p_iter :
 
                /* call the procedure */
 
-               spare1.sp_form = ft_omega;
+               spec_set_form(&spare1,ft_omega);
                call_procedure(SETL_SYSTEM &spare1,
                               slot_info->si_spec,
                               left,
@@ -15883,7 +13281,7 @@ case p_iter :
          right = PC->i_operand[0].i_spec_ptr;
          BUMPPC(1);
 
-         switch (left->sp_form) {
+         switch (spec_form(left)) {
 
             /*
              *  If we have an integer on the left we look for a set on
@@ -15892,21 +13290,21 @@ case p_iter :
 
             case ft_short :
 
-               short_value = left->sp_val.sp_short_value;
+               short_value = spec_val(left,sp_short_value);
 
                if (short_value < 0)
                   abend(SETL_SYSTEM msg_negative_npow);
 
-               switch (right->sp_form) {
+               switch (spec_form(right)) {
 
                   case ft_map :
 
-                     spare.sp_form = ft_omega;
+                     spec_set_form(&spare,ft_omega);
                      map_to_set(SETL_SYSTEM &spare,right);
 
                      start_npow_iterator(SETL_SYSTEM target,&spare,short_value);
                      unmark_specifier(&spare);
-                     spare.sp_form = ft_omega;
+                     spec_set_form(&spare,ft_omega);
 
                      break;
 
@@ -15923,7 +13321,7 @@ case p_iter :
 
                   case ft_object :
 
-                     object_root = right->sp_val.sp_object_ptr;
+                     object_root = spec_val(right,sp_object_ptr);
                      class_ptr = object_root->o_ntype.o_root.o_class;
 
                      /* get information about this slot in the object */
@@ -15942,7 +13340,7 @@ case p_iter :
 
                      /* call the procedure */
 
-                     spare1.sp_form = ft_omega;
+                     spec_set_form(&spare1,ft_omega);
                      call_procedure(SETL_SYSTEM &spare1,
                                     slot_info->si_spec,
                                     left,
@@ -15966,21 +13364,22 @@ case p_iter :
 
             case ft_long :
 
-               short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+               short_value =
+                  long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
 
                if (short_value < 0)
                   abend(SETL_SYSTEM msg_negative_npow);
 
-               switch (right->sp_form) {
+               switch (spec_form(right)) {
 
                   case ft_map :
 
-                     spare.sp_form = ft_omega;
+                     spec_set_form(&spare,ft_omega);
                      map_to_set(SETL_SYSTEM &spare,right);
 
                      start_npow_iterator(SETL_SYSTEM target,&spare,short_value);
                      unmark_specifier(&spare);
-                     spare.sp_form = ft_omega;
+                     spec_set_form(&spare,ft_omega);
 
                      break;
 
@@ -15997,7 +13396,7 @@ case p_iter :
 
                   case ft_object :
 
-                     object_root = right->sp_val.sp_object_ptr;
+                     object_root = spec_val(right,sp_object_ptr);
                      class_ptr = object_root->o_ntype.o_root.o_class;
 
                      /* get information about this slot in the object */
@@ -16016,7 +13415,7 @@ case p_iter :
 
                      /* call the procedure */
 
-                     spare1.sp_form = ft_omega;
+                     spec_set_form(&spare1,ft_omega);
                      call_procedure(SETL_SYSTEM &spare1,
                                     slot_info->si_spec,
                                     left,
@@ -16049,18 +13448,19 @@ case p_iter :
 
             case ft_set :
 
-               switch (right->sp_form) {
+               switch (spec_form(right)) {
 
                   case ft_short :
 
-                     short_value = right->sp_val.sp_short_value;
+                     short_value = spec_val(right,sp_short_value);
                      start_npow_iterator(SETL_SYSTEM target,left,short_value);
 
                      break;
 
                   case ft_long :
 
-                     short_value = long_to_short(SETL_SYSTEM right->sp_val.sp_long_ptr);
+                     short_value = long_to_short(SETL_SYSTEM
+                                       spec_val(right,sp_long_ptr));
                      start_npow_iterator(SETL_SYSTEM target,left,short_value);
 
                      break;
@@ -16072,7 +13472,7 @@ case p_iter :
 
                   case ft_object :
 
-                     object_root = right->sp_val.sp_object_ptr;
+                     object_root = spec_val(right,sp_object_ptr);
                      class_ptr = object_root->o_ntype.o_root.o_class;
 
                      /* get information about this slot in the object */
@@ -16091,7 +13491,7 @@ case p_iter :
 
                      /* call the procedure */
 
-                     spare1.sp_form = ft_omega;
+                     spec_set_form(&spare1,ft_omega);
                      call_procedure(SETL_SYSTEM &spare1,
                                     slot_info->si_spec,
                                     left,
@@ -16119,7 +13519,7 @@ case p_iter :
 
             case ft_object :
 
-               object_root = left->sp_val.sp_object_ptr;
+               object_root = spec_val(left,sp_object_ptr);
                class_ptr = object_root->o_ntype.o_root.o_class;
 
                /* get information about this slot in the object */
@@ -16138,7 +13538,7 @@ case p_iter :
 
                /* call the procedure */
 
-               spare1.sp_form = ft_omega;
+               spec_set_form(&spare1,ft_omega);
                call_procedure(SETL_SYSTEM &spare1,
                               slot_info->si_spec,
                               left,
@@ -16165,17 +13565,17 @@ case p_iter :
 
       case it_domain :
 
-         switch (left->sp_form) {
+         switch (spec_form(left)) {
 
             case ft_set :
 
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
                if (!set_to_map(SETL_SYSTEM &spare,left,NO))
                   abend(SETL_SYSTEM msg_invalid_set_map,abend_opnd_str(SETL_SYSTEM left));
 
                start_domain_iterator(SETL_SYSTEM target,&spare);
                unmark_specifier(&spare);
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
 
                break;
 
@@ -16192,7 +13592,7 @@ case p_iter :
 
             case ft_object :
 
-               object_root = left->sp_val.sp_object_ptr;
+               object_root = spec_val(left,sp_object_ptr);
                class_ptr = object_root->o_ntype.o_root.o_class;
 
                /* get information about this slot in the object */
@@ -16207,7 +13607,7 @@ case p_iter :
 
                /* call the procedure */
 
-               spare1.sp_form = ft_omega;
+               spec_set_form(&spare1,ft_omega);
                call_procedure(SETL_SYSTEM &spare1,
                               slot_info->si_spec,
                               left,
@@ -16235,7 +13635,7 @@ case p_iter :
 
       case it_single :
 
-         switch (left->sp_form) {
+         switch (spec_form(left)) {
 
             case ft_set :
 
@@ -16289,17 +13689,17 @@ case p_iter :
 
       case it_pair :
 
-         switch (left->sp_form) {
+         switch (spec_form(left)) {
 
             case ft_set :
 
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
                if (!set_to_map(SETL_SYSTEM &spare,left,YES))
                   abend(SETL_SYSTEM msg_invalid_set_map,abend_opnd_str(SETL_SYSTEM left));
 
                start_map_pair_iterator(SETL_SYSTEM target,&spare);
                unmark_specifier(&spare);
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
 
                break;
 
@@ -16343,17 +13743,17 @@ case p_iter :
 
       case it_map_pair :
 
-         switch (left->sp_form) {
+         switch (spec_form(left)) {
 
             case ft_set :
 
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
                if (!set_to_map(SETL_SYSTEM &spare,left,NO))
                   abend(SETL_SYSTEM msg_invalid_set_map,abend_opnd_str(SETL_SYSTEM left));
 
                start_map_pair_iterator(SETL_SYSTEM target,&spare);
                unmark_specifier(&spare);
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
 
                break;
 
@@ -16403,17 +13803,17 @@ case p_iter :
 
       case it_multi :
 
-         switch (left->sp_form) {
+         switch (spec_form(left)) {
 
             case ft_set :
 
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
                if (!set_to_map(SETL_SYSTEM &spare,left,NO))
                   abend(SETL_SYSTEM msg_invalid_set_map,abend_opnd_str(SETL_SYSTEM left));
 
                start_map_multi_iterator(SETL_SYSTEM target,&spare);
                unmark_specifier(&spare);
-               spare.sp_form = ft_omega;
+               spec_set_form(&spare,ft_omega);
 
                break;
 
@@ -16486,6 +13886,7 @@ PRTYPE void iter_ops2(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_inext :
+opcode_label(p_inext)
 
 {
 
@@ -16493,7 +13894,7 @@ case p_inext :
 
    target = ip->i_operand[0].i_spec_ptr;
    left = ip->i_operand[1].i_spec_ptr;
-   iter_ptr = left->sp_val.sp_iter_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
 
    switch(iter_ptr->it_type) {
 
@@ -16642,6 +14043,7 @@ case p_inext :
 \*/
 
 case p_set :
+opcode_label(p_set)
 
 {
 
@@ -16658,152 +14060,33 @@ case p_set :
 
 #ifdef TRAPS
 
-   if (left->sp_form != ft_long &&
-       left->sp_form != ft_short)
+   if (spec_form(left) != ft_long &&
+       spec_form(left) != ft_short)
       trap(__FILE__,__LINE__,msg_non_int_card);
 
 #endif
 
    /* short's have the cardinality directly */
 
-   if (left->sp_form == ft_short) {
-      short_value = left->sp_val.sp_short_value;
+   if (spec_form(left) == ft_short) {
+      short_value = spec_val(left,sp_short_value);
    }
    else {
-      short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+      short_value = long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
    }
 
-   /* first we calculate the height of the new header tree */
-
-   target_height = 0;
-   work_length = (short_value / 2) / SET_CLASH_SIZE + 1;
-   while (work_length = work_length >> SET_SHIFT_DIST)
-      target_height++;
-
-   /* allocate and initialize the root header item */
-
-   get_set_header(set_root);
-   set_root->s_use_count = 1;
-   set_root->s_hash_code = 0;
-   set_root->s_ntype.s_root.s_cardinality = 0;
-   set_root->s_ntype.s_root.s_height = target_height;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        set_root->s_child[i++].s_cell = NULL);
-
-   /* insert each element in the set */
+   /* insert each element in a new set */
 
+   set_root = null_set(SETL_SYSTEM_VOID);
    for (target_element = pstack + (pstack_top + 1 - short_value);
         target_element < pstack + (pstack_top + 1);
         target_element++) {
 
-      if (target_element->sp_form == ft_omega)
-         continue;
-
-      set_work_hdr = set_root;
-
-      /* get the element's hash code */
-
-      spec_hash_code(work_hash_code,target_element);
-      source_hash_code = work_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_height = set_root->s_ntype.s_root.s_height;
-      while (target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (set_work_hdr->s_child[target_index].s_header == NULL) {
-
-            get_set_header(new_set_hdr);
-            new_set_hdr->s_ntype.s_intern.s_parent = set_work_hdr;
-            new_set_hdr->s_ntype.s_intern.s_child_index = target_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_set_hdr->s_child[i++].s_cell = NULL);
-            set_work_hdr->s_child[target_index].s_header = new_set_hdr;
-            set_work_hdr = new_set_hdr;
-
-         }
-         else {
-
-            set_work_hdr =
-               set_work_hdr->s_child[target_index].s_header;
-
-         }
-      }
-
-      /*
-       *  At this point, set_work_hdr points to the lowest level header
-       *  record.  The next problem is to determine if the element is
-       *  already in the set.  We compare the element with the clash
-       *  list.
-       */
-
-      target_index = work_hash_code & SET_HASH_MASK;
-      set_cell_tail = &(set_work_hdr->s_child[target_index].s_cell);
-      for (set_cell = *set_cell_tail;
-           set_cell != NULL &&
-              set_cell->s_hash_code < source_hash_code;
-           set_cell = set_cell->s_next) {
-
-         set_cell_tail = &(set_cell->s_next);
-
-      }
-
-      /* check for a duplicate element */
-
-      is_equal = NO;
-      while (set_cell != NULL &&
-             set_cell->s_hash_code == source_hash_code) {
-
-         spec_equal(is_equal,&(set_cell->s_spec),target_element);
-
-         if (is_equal)
-            break;
-
-         set_cell_tail = &(set_cell->s_next);
-         set_cell = set_cell->s_next;
-
-      }
-
-      /* if we found the element, continue */
-
-      if (is_equal)
+      if (spec_form(target_element) == ft_omega)
          continue;
 
-      /* if we reach this point we didn't find the element, so we insert it */
-
-      get_set_cell(new_set_cell);
-      mark_specifier(target_element);
-      new_set_cell->s_spec.sp_form = target_element->sp_form;
-      new_set_cell->s_spec.sp_val.sp_biggest =
-         target_element->sp_val.sp_biggest;
-      new_set_cell->s_hash_code = source_hash_code;
-      new_set_cell->s_next = *set_cell_tail;
-      *set_cell_tail = new_set_cell;
-      set_root->s_ntype.s_root.s_cardinality++;
-      set_root->s_hash_code ^= source_hash_code;
-
-   }
-
-   /* if our estimate of the header height was too large, compress it */
-
-   contraction_trigger = (1 << ((set_root->s_ntype.s_root.s_height)
-                                 * SET_SHIFT_DIST));
-   if (contraction_trigger == 1)
-      contraction_trigger = 0;
-
-   while (set_root->s_ntype.s_root.s_cardinality < contraction_trigger) {
-
-      set_root = set_contract_header(SETL_SYSTEM set_root);
-      contraction_trigger /= SET_HASH_SIZE;
+      spec_hash_code(source_hash_code,target_element);
+      set_insert(SETL_SYSTEM set_root,target_element,source_hash_code);
 
    }
 
@@ -16816,8 +14099,8 @@ case p_set :
    /* finally, we set our result */
 
    unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = set_root;
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,set_root);
 
    break;
 
@@ -16836,8 +14119,10 @@ case p_set :
 \*/
 
 case p_tuple :
+opcode_label(p_tuple)
 
 {
+int packing;                           /* packed element form               */
 
    /* pick out the operand pointers, to save some expression evaluations */
 
@@ -16852,114 +14137,84 @@ case p_tuple :
 
 #ifdef TRAPS
 
-   if (left->sp_form != ft_long &&
-       left->sp_form != ft_short)
+   if (spec_form(left) != ft_long &&
+       spec_form(left) != ft_short)
       trap(__FILE__,__LINE__,msg_non_int_length);
 
 #endif
 
    /* short's have the length directly */
 
-   if (left->sp_form == ft_short) {
-      short_value = left->sp_val.sp_short_value;
+   if (spec_form(left) == ft_short) {
+      short_value = spec_val(left,sp_short_value);
    }
    else {
-      short_value = long_to_short(SETL_SYSTEM left->sp_val.sp_long_ptr);
+      short_value = long_to_short(SETL_SYSTEM spec_val(left,sp_long_ptr));
    }
 
    /* skip trailing omegas */
 
    for (;
-        short_value > 0 && pstack[pstack_top].sp_form == ft_omega;
+        short_value > 0 && spec_form(&pstack[pstack_top]) == ft_omega;
         short_value--) {
 
       pop_pstack;
 
    }
 
-   /* first we calculate the height of the new header tree */
-
-   target_height = 0;
-   work_length = short_value;
-   while (work_length = (work_length >> TUP_SHIFT_DIST))
-      target_height++;
-
-   /* allocate and initialize the root header item */
-
-   get_tuple_header(tuple_root);
-   tuple_root->t_use_count = 1;
-   tuple_root->t_hash_code = 0;
-   tuple_root->t_ntype.t_root.t_length = short_value;
-   tuple_root->t_ntype.t_root.t_height = target_height;
-
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        tuple_root->t_child[i++].t_cell = NULL);
-
-   /* insert each element in the tuple */
-
-   target_number = 0;
-   for (target_element = pstack + (pstack_top + 1 - short_value);
-        target_number < short_value;
-        target_element++, target_number++) {
-
-      /* don't insert omegas */
+   /* long tuples of numbers of one form are packed */
 
-      if (target_element->sp_form == ft_omega)
-         continue;
+   packing = TUP_CELLS;
+   if (short_value >= TUP_PACK_MIN)
+      packing = uniform_packing(pstack + (pstack_top + 1 - short_value),
+                                (int32)sizeof(specifier),
+                                short_value);
 
-      /* descend the header tree until we get to a leaf */
+   /* allocate and initialize the tuple */
 
-      tuple_work_hdr = tuple_root;
-      for (target_height = tuple_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
+   tuple_root = new_tuple(SETL_SYSTEM_VOID);
 
-         /* extract the element's index at this level */
+   if (packing != TUP_CELLS) {
 
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
+      start_packed(SETL_SYSTEM tuple_root,packing,short_value);
+      tuple_root->t_length = short_value;
 
-         /* if we're missing a header record, allocate one */
+      target_number = 0;
+      for (target_element = pstack + (pstack_top + 1 - short_value);
+           target_element <= pstack + pstack_top;
+           target_element++, target_number++) {
 
-         if (tuple_work_hdr->t_child[target_index].t_header == NULL) {
+         if (packing == TUP_SHORTS)
+            tuple_root->t_packed.t_shorts[target_number] =
+               spec_val(target_element,sp_short_value);
+         else
+            tuple_root->t_packed.t_reals[target_number] =
+               spec_val(target_element,sp_real_value);
+         spec_hash_code(work_hash_code,target_element);
+         tuple_root->t_hash_code ^= work_hash_code;
 
-            get_tuple_header(new_tuple_hdr);
-            new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-            new_tuple_hdr->t_ntype.t_intern.t_child_index = target_index;
+      }
+   }
+   else {
 
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_tuple_hdr->t_child[i++].t_cell = NULL);
+      reserve_tuple(tuple_root,short_value);
+      tuple_root->t_length = short_value;
 
-            tuple_work_hdr->t_child[target_index].t_header = new_tuple_hdr;
-            tuple_work_hdr = new_tuple_hdr;
+      /* insert each element (omegas have a zero hash code) */
 
-         }
-         else {
+      tuple_cell = tuple_root->t_cells;
+      for (target_element = pstack + (pstack_top + 1 - short_value);
+           target_element <= pstack + pstack_top;
+           target_element++, tuple_cell++) {
 
-            tuple_work_hdr =
-               tuple_work_hdr->t_child[target_index].t_header;
+         mark_specifier(target_element);
+         spec_set_form(&tuple_cell->t_spec,spec_form(target_element));
+         spec_set_val(&tuple_cell->t_spec,sp_biggest,
+            spec_val(target_element,sp_biggest));
+         spec_hash_code(tuple_cell->t_hash_code,target_element);
+         tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
 
-         }
       }
-
-      /*
-       *  At this point, tuple_work_hdr points to the lowest level header
-       *  record.  We insert the new element in the appropriate slot.
-       */
-
-      mark_specifier(target_element);
-      get_tuple_cell(tuple_cell);
-      tuple_cell->t_spec.sp_form = target_element->sp_form;
-      tuple_cell->t_spec.sp_val.sp_biggest =
-         target_element->sp_val.sp_biggest;
-      spec_hash_code(tuple_cell->t_hash_code,target_element);
-      target_index = target_number & TUP_SHIFT_MASK;
-      tuple_work_hdr->t_child[target_index].t_cell = tuple_cell;
-      tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
-
    }
 
    /* we pop the tuple elements from the stack */
@@ -16971,8 +14226,8 @@ case p_tuple :
    /* set the target value */
 
    unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = tuple_root;
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,tuple_root);
 
    break;
 
@@ -17033,6 +14288,7 @@ PRTYPE void object_ops(SETL_SYSTEM_PROTO_VOID)
 \*/
 
 case p_initobj :
+opcode_label(p_initobj)
 
 {
 
@@ -17120,9 +14376,9 @@ case p_initobj :
             object_work_hdr->o_child[target_index].o_cell = object_cell;
          }
          target_element = slot_info->si_spec;
-         object_cell->o_spec.sp_form = target_element->sp_form;
-         object_cell->o_spec.sp_val.sp_biggest =
-            target_element->sp_val.sp_biggest;
+         spec_set_form(&object_cell->o_spec,spec_form(target_element));
+         spec_set_val(&object_cell->o_spec,sp_biggest,
+            spec_val(target_element,sp_biggest));
 
          /*
           *  We move back up the header tree at this point, if it is
@@ -17150,7 +14406,7 @@ case p_initobj :
         slot_info != NULL;
         slot_info = slot_info->si_next_var) {
 
-      (slot_info->si_spec)->sp_form = ft_omega;
+      spec_set_form((slot_info->si_spec),ft_omega);
 
    }
 
@@ -17193,6 +14449,7 @@ case p_initobj :
 \*/
 
 case p_initend :
+opcode_label(p_initend)
 
 {
 
@@ -17276,9 +14533,9 @@ case p_initend :
          get_object_cell(object_cell);
          object_work_hdr->o_child[target_index].o_cell = object_cell;
       }
-      object_cell->o_spec.sp_form = target_element->sp_form;
-      object_cell->o_spec.sp_val.sp_biggest =
-         target_element->sp_val.sp_biggest;
+      spec_set_form(&object_cell->o_spec,spec_form(target_element));
+      spec_set_val(&object_cell->o_spec,sp_biggest,
+         spec_val(target_element,sp_biggest));
       spec_hash_code(object_cell->o_hash_code,target_element);
       object_root->o_hash_code ^= object_cell->o_hash_code;
 
@@ -17301,8 +14558,8 @@ case p_initend :
    /* set the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_object;
-   target->sp_val.sp_object_ptr = object_root;
+   spec_set_form(target,ft_object);
+   spec_set_val(target,sp_object_ptr,object_root);
 
    /* pop the 'self' stack */
 
@@ -17354,9 +14611,9 @@ case p_initend :
          target_index = target_number & OBJ_SHIFT_MASK;
          object_cell = object_work_hdr->o_child[target_index].o_cell;
          target_element = slot_info->si_spec;
-         target_element->sp_form = object_cell->o_spec.sp_form;
-         target_element->sp_val.sp_biggest =
-            object_cell->o_spec.sp_val.sp_biggest;
+         spec_set_form(target_element,spec_form(&object_cell->o_spec));
+         spec_set_val(target_element,sp_biggest,
+            spec_val(&object_cell->o_spec,sp_biggest));
 
          /*
           *  We move back up the header tree at this point, if it is
@@ -17382,7 +14639,7 @@ case p_initend :
 
    if (class_ptr->ut_type == PROCESS_UNIT) {
       
-      target->sp_form = ft_process;
+      spec_set_form(target,ft_process);
       get_process(process_ptr);
       process_ptr->pc_next = process_head->pc_next;
       process_ptr->pc_next->pc_prev = process_ptr;
@@ -17394,8 +14651,20 @@ case p_initend :
       process_ptr->pc_suspended = NO;
       process_ptr->pc_waiting = NO;
       process_ptr->pc_checking = NO;
-
-      process_ptr->pc_object_ptr = target->sp_val.sp_object_ptr;
+      process_ptr->pc_sending = NO;
+      process_ptr->pc_passing = NO;
+      process_ptr->pc_wait_limit = 0;
+      process_ptr->pc_blocked = NO;
+      process_ptr->pc_ready = NO;
+      process_ptr->pc_wait_fd = -1;
+      process_ptr->pc_wake_time = -1;
+      process_ptr->pc_priority = 0;
+      process_ptr->pc_level = 0;
+      process_ptr->pc_run_usecs = 0;
+      process_ptr->pc_run_opcodes = 0;
+      process_ptr->pc_redo_args = NULL;
+
+      process_ptr->pc_object_ptr = spec_val(target,sp_object_ptr);
       process_ptr->pc_object_ptr->o_process_ptr = process_ptr;
 
       process_ptr->pc_request_head = NULL;
@@ -17408,7 +14677,7 @@ case p_initend :
       process_ptr->pc_pstack_max = PSTACK_BLOCK_SIZE;
       process_ptr->pc_pstack_top = 0;
       process_ptr->pc_pstack_base = 0;
-      process_ptr->pc_pstack[0].sp_form = ft_omega;
+      spec_set_form(&process_ptr->pc_pstack[0],ft_omega);
       
       process_ptr->pc_cstack = (struct call_stack_item *)malloc((size_t)(
                    CSTACK_BLOCK_SIZE * sizeof(struct call_stack_item)));
@@ -17453,6 +14722,7 @@ case p_initend :
 \*/
 
 case p_slot :
+opcode_label(p_slot)
 
 {
 
@@ -17463,11 +14733,11 @@ case p_slot :
 
    /* left must be an object */
 
-   if (left->sp_form != ft_object &&
-       left->sp_form != ft_process)
+   if (spec_form(left) != ft_object &&
+       spec_form(left) != ft_process)
       abend(SETL_SYSTEM "Expected class instance");
 
-   object_root = left->sp_val.sp_object_ptr;
+   object_root = spec_val(left,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
    slot_number = ip->i_operand[2].i_slot;
 
@@ -17509,8 +14779,8 @@ case p_slot :
          target_element = slot_info->si_spec;
          mark_specifier(target_element);
          unmark_specifier(target);
-         target->sp_form = target_element->sp_form;
-         target->sp_val.sp_biggest = target_element->sp_val.sp_biggest;
+         spec_set_form(target,spec_form(target_element));
+         spec_set_val(target,sp_biggest,spec_val(target_element,sp_biggest));
          
          break;
 
@@ -17550,8 +14820,8 @@ case p_slot :
 
       mark_specifier(target_element);
       unmark_specifier(target);
-      target->sp_form = target_element->sp_form;
-      target->sp_val.sp_biggest = target_element->sp_val.sp_biggest;
+      spec_set_form(target,spec_form(target_element));
+      spec_set_val(target,sp_biggest,spec_val(target_element,sp_biggest));
 
       break;
 
@@ -17572,7 +14842,7 @@ case p_slot :
 
    /* we copy the procedure */
 
-   proc_ptr = (slot_info->si_spec)->sp_val.sp_proc_ptr;
+   proc_ptr = spec_val((slot_info->si_spec),sp_proc_ptr);
    get_proc(new_proc_ptr);
    memcpy((void *)new_proc_ptr,
           (void *)proc_ptr,
@@ -17582,14 +14852,14 @@ case p_slot :
    new_proc_ptr->p_use_count = 1;
    new_proc_ptr->p_active_use_count = 0;
    new_proc_ptr->p_is_const = NO;
-   new_proc_ptr->p_self_ptr = left->sp_val.sp_object_ptr;
-   (left->sp_val.sp_object_ptr)->o_use_count++;
+   new_proc_ptr->p_self_ptr = spec_val(left,sp_object_ptr);
+   spec_val(left,sp_object_ptr)->o_use_count++;
 
    /* set the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_proc;
-   target->sp_val.sp_proc_ptr = new_proc_ptr;
+   spec_set_form(target,ft_proc);
+   spec_set_val(target,sp_proc_ptr,new_proc_ptr);
 
    /* copy enclosing procedures */
 
@@ -17675,6 +14945,7 @@ case p_slot :
 \*/
 
 case p_sslot :
+opcode_label(p_sslot)
 
 {
 
@@ -17685,11 +14956,11 @@ case p_sslot :
 
    /* target must be an object */
 
-   if (target->sp_form != ft_object &&
-       target->sp_form != ft_process)
+   if (spec_form(target) != ft_object &&
+       spec_form(target) != ft_process)
       abend(SETL_SYSTEM "Expected class instance");
 
-   class_ptr = (target->sp_val.sp_object_ptr)->o_ntype.o_root.o_class;
+   class_ptr = spec_val(target,sp_object_ptr)->o_ntype.o_root.o_class;
    slot_number = ip->i_operand[1].i_slot;
 
    /* make sure the slot we're given is valid for the object */
@@ -17733,8 +15004,8 @@ case p_sslot :
       target_element = slot_info->si_spec;
       mark_specifier(right);
       unmark_specifier(target_element);
-      target_element->sp_form = right->sp_form;
-      target_element->sp_val.sp_biggest = right->sp_val.sp_biggest;
+      spec_set_form(target_element,spec_form(right));
+      spec_set_val(target_element,sp_biggest,spec_val(right,sp_biggest));
       
       break;
 
@@ -17742,13 +15013,13 @@ case p_sslot :
 
    /* we would like to use the target destructively */
 
-   object_root = target->sp_val.sp_object_ptr;
+   object_root = spec_val(target,sp_object_ptr);
    if (class_ptr->ut_type != PROCESS_UNIT && 
        object_root->o_use_count != 1) {
 
       object_root->o_use_count--;
       object_root = copy_object(SETL_SYSTEM object_root);
-      target->sp_val.sp_object_ptr = object_root;
+      spec_set_val(target,sp_object_ptr,object_root);
 
    }
 
@@ -17790,8 +15061,8 @@ case p_sslot :
    object_root->o_hash_code ^= object_cell->o_hash_code;
    mark_specifier(right);
    unmark_specifier(target_element);
-   target_element->sp_form = right->sp_form;
-   target_element->sp_val.sp_biggest = right->sp_val.sp_biggest;
+   spec_set_form(target_element,spec_form(right));
+   spec_set_val(target_element,sp_biggest,spec_val(right,sp_biggest));
    spec_hash_code(object_cell->o_hash_code,right);
    object_root->o_hash_code ^= object_cell->o_hash_code;
 
@@ -17831,16 +15102,17 @@ case p_sslot :
 \*/
 
 case p_slotof :
+opcode_label(p_slotof)
 
 {
 
    /* pick out the object */
 
    left = PC->i_operand[0].i_spec_ptr;
-   if (left->sp_form != ft_object &&
-       left->sp_form != ft_process)
+   if (spec_form(left) != ft_object &&
+       spec_form(left) != ft_process)
       abend(SETL_SYSTEM "Expected class instance");
-   object_root = left->sp_val.sp_object_ptr;
+   object_root = spec_val(left,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* make sure the slot we're given is valid for the object */
@@ -17908,8 +15180,8 @@ case p_slotof :
       target_element = slot_info->si_spec;
       mark_specifier(target_element);
       unmark_specifier(target);
-      target->sp_form = target_element->sp_form;
-      target->sp_val.sp_biggest = target_element->sp_val.sp_biggest;
+      spec_set_form(target,spec_form(target_element));
+      spec_set_val(target,sp_biggest,spec_val(target_element,sp_biggest));
       
       break;
 
@@ -17949,8 +15221,8 @@ case p_slotof :
 
    mark_specifier(target_element);
    unmark_specifier(target);
-   target->sp_form = target_element->sp_form;
-   target->sp_val.sp_biggest = target_element->sp_val.sp_biggest;
+   spec_set_form(target,spec_form(target_element));
+   spec_set_val(target,sp_biggest,spec_val(target_element,sp_biggest));
 
    /* bump the program counter past the noop */
 
@@ -17971,6 +15243,7 @@ case p_slotof :
 \*/
 
 case p_menviron :
+opcode_label(p_menviron)
 
 {
 
@@ -17982,7 +15255,7 @@ case p_menviron :
 
    /* we copy the procedure */
 
-   proc_ptr = left->sp_val.sp_proc_ptr;
+   proc_ptr = spec_val(left,sp_proc_ptr);
    get_proc(new_proc_ptr);
    memcpy((void *)new_proc_ptr,
           (void *)proc_ptr,
@@ -17998,8 +15271,8 @@ case p_menviron :
    /* set the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_proc;
-   target->sp_val.sp_proc_ptr = new_proc_ptr;
+   spec_set_form(target,ft_proc);
+   spec_set_val(target,sp_proc_ptr,new_proc_ptr);
 
    /* copy enclosing procedures */
 
@@ -18074,6 +15347,7 @@ case p_menviron :
 \*/
 
 case p_self :
+opcode_label(p_self)
 
 {
 
@@ -18092,8 +15366,8 @@ case p_self :
 
       process_head->pc_object_ptr->o_use_count++;
       unmark_specifier(target);
-      target->sp_form = ft_process;
-      target->sp_val.sp_object_ptr = process_head->pc_object_ptr;
+      spec_set_form(target,ft_process);
+      spec_set_val(target,sp_object_ptr,process_head->pc_object_ptr);
       
       break;
    }
@@ -18174,9 +15448,9 @@ case p_self :
       get_object_cell(object_cell);
       object_work_hdr->o_child[target_index].o_cell = object_cell;
       mark_specifier(target_element);
-      object_cell->o_spec.sp_form = target_element->sp_form;
-      object_cell->o_spec.sp_val.sp_biggest =
-         target_element->sp_val.sp_biggest;
+      spec_set_form(&object_cell->o_spec,spec_form(target_element));
+      spec_set_val(&object_cell->o_spec,sp_biggest,
+         spec_val(target_element,sp_biggest));
       spec_hash_code(object_cell->o_hash_code,target_element);
       object_root->o_hash_code ^= object_cell->o_hash_code;
 
@@ -18199,8 +15473,8 @@ case p_self :
    /* set the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_object;
-   target->sp_val.sp_object_ptr = object_root;
+   spec_set_form(target,ft_object);
+   spec_set_val(target,sp_object_ptr,object_root);
 
    break;
 
@@ -18222,6 +15496,91 @@ case p_self :
  *  encountered an invalid op code.
 \*/
 
+#if THREADED_CODE
+
+/*\
+ *  \case{superinstructions}
+ *
+ *  The loader gives some instructions one of these handlers, when the
+ *  instruction which follows is one it usually precedes (see
+ *  \verb"pcode.h").  We perform the common case of the first
+ *  instruction in-line, or fall back on its ordinary case if we can't.
+ *  Then we go directly to the case for the second instruction, saving
+ *  a dispatch.
+\*/
+
+#define short_arith(op,fallback) { \
+   target = ip->i_operand[0].i_spec_ptr; \
+   left = ip->i_operand[1].i_spec_ptr; \
+   right = ip->i_operand[2].i_spec_ptr; \
+   if (spec_form(left) != ft_short || spec_form(right) != ft_short) \
+      goto fallback; \
+   if (!op(short_value, \
+           spec_val(left,sp_short_value), \
+           spec_val(right,sp_short_value))) \
+      goto fallback; \
+   unmark_specifier(target); \
+   spec_set_form(target,ft_short); \
+   spec_set_val(target,sp_short_value,short_value); \
+}
+
+p_add_add_label :
+
+   short_arith(short_add,p_add_label);
+   super_next(p_add);
+
+p_add_go_label :
+
+   short_arith(short_add,p_add_label);
+   super_next(p_go);
+
+p_add_golt_label :
+
+   short_arith(short_add,p_add_label);
+   super_next(p_golt);
+
+p_add_return_label :
+
+   short_arith(short_add,p_add_label);
+   super_next(p_return);
+
+p_sub_push1_label :
+
+   short_arith(short_subtract,p_sub_label);
+   super_next(p_push1);
+
+p_assign_of1_label :
+
+   target = ip->i_operand[0].i_spec_ptr;
+   left = ip->i_operand[1].i_spec_ptr;
+   mark_specifier(left);
+   unmark_specifier(target);
+   spec_set_form(target,spec_form(left));
+   spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
+   super_next(p_of1);
+
+p_push3_lcall_label :
+
+   push_pstack(ip->i_operand[0].i_spec_ptr);
+   push_pstack(ip->i_operand[1].i_spec_ptr);
+   push_pstack(ip->i_operand[2].i_spec_ptr);
+   super_next(p_lcall);
+
+p_push2_lcall_label :
+
+   push_pstack(ip->i_operand[0].i_spec_ptr);
+   push_pstack(ip->i_operand[1].i_spec_ptr);
+   super_next(p_lcall);
+
+p_push1_lcall_label :
+
+   push_pstack(ip->i_operand[0].i_spec_ptr);
+   super_next(p_lcall);
+
+#undef short_arith
+
+#endif
+
 #ifndef SHORT_FUNCS
 
 #ifdef TRAPS
@@ -18237,7 +15596,11 @@ default :
       }
 
    if (forever)
+#if THREADED_CODE
+      goto execute_next;
+#else
       goto execute_start;
+#endif
    else
       return CONTINUE;
 
@@ -18284,7 +15647,7 @@ instruction *save_ip;                  /* saved instruction pointer         */
 
    /* pick out the procedure pointer */
 
-   proc_ptr = left->sp_val.sp_proc_ptr;
+   proc_ptr = spec_val(left,sp_proc_ptr);
 
    /*
     *  Built-in procedures are relatively easy.  We just check the
@@ -18315,7 +15678,7 @@ instruction *save_ip;                  /* saved instruction pointer         */
        *  to the argument array, and a pointer to a return location.
        */
 
-      return_value.sp_form = ft_omega;
+      spec_set_form(&return_value,ft_omega);
       save_pstack_top = pstack_top;
 
       ex_wait_target = target;
@@ -18327,8 +15690,8 @@ instruction *save_ip;                  /* saved instruction pointer         */
       if (target != NULL) {
 
          unmark_specifier(target);
-         target->sp_form = return_value.sp_form;
-         target->sp_val.sp_biggest = return_value.sp_val.sp_biggest;
+         spec_set_form(target,spec_form(&return_value));
+         spec_set_val(target,sp_biggest,spec_val(&return_value,sp_biggest));
 
       }
       else {
@@ -18336,7 +15699,7 @@ instruction *save_ip;                  /* saved instruction pointer         */
          unmark_specifier(&return_value);
 
       }
-      return_value.sp_form = ft_omega;
+      spec_set_form(&return_value,ft_omega);
 
       /* pop the arguments from the program stack */
 
@@ -18385,7 +15748,7 @@ instruction *save_ip;                  /* saved instruction pointer         */
    /* save the root of 'self' if we have one */
 
    if (self != NULL)
-      self_root = self->sp_val.sp_object_ptr;
+      self_root = spec_val(self,sp_object_ptr);
    else
       self_root = proc_ptr->p_self_ptr;
 
@@ -18414,12 +15777,13 @@ instruction *save_ip;                  /* saved instruction pointer         */
          request_ptr->rq_mailbox_ptr = mailbox_ptr;
          mailbox_ptr->mb_use_count = 1;
          mailbox_ptr->mb_cell_count = 0;
+         mailbox_ptr->mb_capacity = 0;
          mailbox_ptr->mb_head = NULL;
          mailbox_ptr->mb_tail = &(mailbox_ptr->mb_head);
 
          unmark_specifier(target);
-         target->sp_form = ft_mailbox;
-         target->sp_val.sp_mailbox_ptr = mailbox_ptr;
+         spec_set_form(target,ft_mailbox);
+         spec_set_val(target,sp_mailbox_ptr,mailbox_ptr);
 
       }
       else {
@@ -18433,8 +15797,8 @@ instruction *save_ip;                  /* saved instruction pointer         */
            arg_ptr < request_ptr->rq_args + arg_count;
            arg_ptr++, stack_pos++) {
 
-         arg_ptr->sp_form = stack_pos->sp_form;
-         arg_ptr->sp_val.sp_biggest = stack_pos->sp_val.sp_biggest;
+         spec_set_form(arg_ptr,spec_form(stack_pos));
+         spec_set_val(arg_ptr,sp_biggest,spec_val(stack_pos,sp_biggest));
 
       }
 
@@ -18456,10 +15820,11 @@ instruction *save_ip;                  /* saved instruction pointer         */
 
       if (++pstack_top == pstack_max)
          alloc_pstack(SETL_SYSTEM_VOID);
-      pstack[pstack_top].sp_form = arg_ptr->sp_form;
-      pstack[pstack_top].sp_val.sp_biggest = arg_ptr->sp_val.sp_biggest;
+      spec_set_form(&pstack[pstack_top],spec_form(arg_ptr));
+      spec_set_val(&pstack[pstack_top],sp_biggest,
+                   spec_val(arg_ptr,sp_biggest));
 
-      arg_ptr->sp_form = ft_omega;
+      spec_set_form(arg_ptr,ft_omega);
 
    }
 
@@ -18470,8 +15835,8 @@ instruction *save_ip;                  /* saved instruction pointer         */
         arg_ptr < proc_ptr->p_spec_ptr + arg_count;
         arg_ptr++, stack_pos++) {
 
-      arg_ptr->sp_form = stack_pos->sp_form;
-      arg_ptr->sp_val.sp_biggest = stack_pos->sp_val.sp_biggest;
+      spec_set_form(arg_ptr,spec_form(stack_pos));
+      spec_set_val(arg_ptr,sp_biggest,spec_val(stack_pos,sp_biggest));
 
    }
 
@@ -18526,7 +15891,7 @@ instruction *save_ip;                  /* saved instruction pointer         */
                    (void *)&spare,
                    sizeof(struct specifier_item));
 
-            spare.sp_form = ft_omega;
+            spec_set_form(&spare,ft_omega);
 
          }
 
@@ -18627,9 +15992,9 @@ instruction *save_ip;                  /* saved instruction pointer         */
                object_work_hdr->o_child[target_index].o_cell = object_cell;
             }
             target_element = slot_info->si_spec;
-            object_cell->o_spec.sp_form = target_element->sp_form;
-            object_cell->o_spec.sp_val.sp_biggest =
-               target_element->sp_val.sp_biggest;
+            spec_set_form(&object_cell->o_spec,spec_form(target_element));
+            spec_set_val(&object_cell->o_spec,sp_biggest,
+               spec_val(target_element,sp_biggest));
 
             /*
              *  We move back up the header tree at this point, if it is
@@ -18691,9 +16056,9 @@ instruction *save_ip;                  /* saved instruction pointer         */
             target_index = target_number & OBJ_SHIFT_MASK;
             object_cell = object_work_hdr->o_child[target_index].o_cell;
             target_element = slot_info->si_spec;
-            target_element->sp_form = object_cell->o_spec.sp_form;
-            target_element->sp_val.sp_biggest =
-               object_cell->o_spec.sp_val.sp_biggest;
+            spec_set_form(target_element,spec_form(&object_cell->o_spec));
+            spec_set_val(target_element,sp_biggest,
+               spec_val(&object_cell->o_spec,sp_biggest));
             if (self != NULL) {
                mark_specifier(target_element);
             }
@@ -18769,6 +16134,8 @@ PRTYPE void switch_process(SETL_SYSTEM_PROTO_VOID)
 
 {
 int32 arg_count;                       /* number of arguments in request    */
+int level;                             /* scheduling level searched         */
+int found;                             /* YES if a process can run          */
 
    /* first make sure we're not in a critical section */
 
@@ -18777,52 +16144,64 @@ int32 arg_count;                       /* number of arguments in request    */
       return;
    }
 
-   /* find an unblocked process */
+   /* charge the current process for its slice */
 
-   for (process_ptr = process_head->pc_next;
-        process_ptr != process_head;
-        process_ptr = process_ptr->pc_next) {
+   process_charge(SETL_SYSTEM_VOID);
 
-      if (process_ptr->pc_suspended)
-         continue;
-      
-      if (process_ptr->pc_waiting ||
-          process_ptr->pc_checking) {
-      
-         if (process_unblock(SETL_SYSTEM process_ptr)) 
-            break;
-         else
-            continue;
+switch_start:
 
-      }
+   /* note any descriptors and timers ready for blocked processes */
 
-      if (process_ptr->pc_idle) {
-    
-         if (process_ptr->pc_request_head != NULL)
-            break;
-         else
-            continue;
+   if (REACTOR_BLOCKED)
+      reactor_poll(SETL_SYSTEM NO);
 
-      }
+   /*
+    *  Find a process which can run, at the best level we can.  Within a
+    *  level we go round the pool from the current process, so it comes
+    *  last.
+    */
 
-      break;
+   found = NO;
+   for (level = 0; !found && level < MLFQ_LEVELS; level++) {
+
+      process_ptr = process_head;
+      do {
+
+         process_ptr = process_ptr->pc_next;
+
+         if (process_ptr->pc_level != level ||
+             process_ptr->pc_suspended)
+            continue;
       
+         if (process_ptr->pc_blocked)
+            found = reactor_unblock(SETL_SYSTEM process_ptr);
+         else if (process_ptr->pc_waiting ||
+                  process_ptr->pc_checking)
+            found = process_unblock(SETL_SYSTEM process_ptr);
+         else if (process_ptr->pc_sending)
+            found = process_send(SETL_SYSTEM process_ptr);
+         else if (process_ptr->pc_idle)
+            found = (process_ptr->pc_request_head != NULL);
+         else
+            found = YES;
+
+      } while (!found && process_ptr != process_head);
    }
 
-   /* if the only unblocked process is the current one, reactivate it */
+   if (!found) {
 
-   if (process_ptr == process_head) {
+      /*
+       *  Processes waiting for input or a timer may still wake up, so
+       *  we sleep until one can.
+       */
 
-      if (process_ptr->pc_suspended ||
-          ((process_ptr->pc_waiting ||
-                process_ptr->pc_checking) &&
-            !process_unblock(SETL_SYSTEM process_ptr)) ||
-          (process_ptr->pc_idle &&
-             process_ptr->pc_request_head == NULL)) {
+      if (REACTOR_BLOCKED && reactor_poll(SETL_SYSTEM YES)) {
+         SCHED_START = process_clock();
+         goto switch_start;
+      }
 
-         abend(SETL_SYSTEM "Deadlock!  No processes can proceed");
+      abend(SETL_SYSTEM "Deadlock!  No processes can proceed");
 
-      }
    }
 
    if (process_ptr != process_head) {
@@ -18865,11 +16244,11 @@ int32 arg_count;                       /* number of arguments in request    */
 
                if (++pstack_top == pstack_max)
                   alloc_pstack(SETL_SYSTEM_VOID);
-               pstack[pstack_top].sp_form = arg_ptr->sp_form;
-               pstack[pstack_top].sp_val.sp_biggest =
-                   arg_ptr->sp_val.sp_biggest;
+               spec_set_form(&pstack[pstack_top],spec_form(arg_ptr));
+               spec_set_val(&pstack[pstack_top],sp_biggest,
+                   spec_val(arg_ptr,sp_biggest));
 
-               arg_ptr->sp_form = ft_omega;
+               spec_set_form(arg_ptr,ft_omega);
 
             }
          }
@@ -18890,8 +16269,8 @@ int32 arg_count;                       /* number of arguments in request    */
 
             if (++pstack_top == pstack_max)
                alloc_pstack(SETL_SYSTEM_VOID);
-            pstack[pstack_top].sp_val.sp_object_ptr =
-               class_ptr->ut_self->ss_object;
+            spec_set_val(&pstack[pstack_top],sp_object_ptr,
+               class_ptr->ut_self->ss_object);
             class_ptr->ut_self = NULL;
 
             /* loop over the instance variables */
@@ -18902,12 +16281,12 @@ int32 arg_count;                       /* number of arguments in request    */
 
                if (++pstack_top == pstack_max)
                   alloc_pstack(SETL_SYSTEM_VOID);
-               pstack[pstack_top].sp_form =
-                  slot_info->si_spec->sp_form;
-               pstack[pstack_top].sp_val.sp_biggest =
-                  slot_info->si_spec->sp_val.sp_biggest;
+               spec_set_form(&pstack[pstack_top],
+                  spec_form(slot_info->si_spec));
+               spec_set_val(&pstack[pstack_top],sp_biggest,
+                  spec_val(slot_info->si_spec,sp_biggest));
 
-               (slot_info->si_spec)->sp_form = ft_omega;
+               spec_set_form((slot_info->si_spec),ft_omega);
 
             }
          }
@@ -18987,9 +16366,9 @@ int32 arg_count;                       /* number of arguments in request    */
                object_work_hdr->o_child[target_index].o_cell = object_cell;
             }
             target_element = slot_info->si_spec;
-            object_cell->o_spec.sp_form = target_element->sp_form;
-            object_cell->o_spec.sp_val.sp_biggest =
-               target_element->sp_val.sp_biggest;
+            spec_set_form(&object_cell->o_spec,spec_form(target_element));
+            spec_set_val(&object_cell->o_spec,sp_biggest,
+               spec_val(target_element,sp_biggest));
 
             /*
              *  We move back up the header tree at this point, if it is
@@ -19084,9 +16463,9 @@ int32 arg_count;                       /* number of arguments in request    */
             target_index = target_number & OBJ_SHIFT_MASK;
             object_cell = object_work_hdr->o_child[target_index].o_cell;
             target_element = slot_info->si_spec;
-            target_element->sp_form = object_cell->o_spec.sp_form;
-            target_element->sp_val.sp_biggest =
-               object_cell->o_spec.sp_val.sp_biggest;
+            spec_set_form(target_element,spec_form(&object_cell->o_spec));
+            spec_set_val(target_element,sp_biggest,
+               spec_val(&object_cell->o_spec,sp_biggest));
 
             /*
              *  We move back up the header tree at this point, if it is
@@ -19143,9 +16522,9 @@ int32 arg_count;                       /* number of arguments in request    */
                  arg_ptr++) {
 
                pstack_top++;
-               arg_ptr->sp_form = pstack[pstack_top].sp_form;
-               arg_ptr->sp_val.sp_biggest =
-                  pstack[pstack_top].sp_val.sp_biggest;
+               spec_set_form(arg_ptr,spec_form(&pstack[pstack_top]));
+               spec_set_val(arg_ptr,sp_biggest,
+                  spec_val(&pstack[pstack_top],sp_biggest));
 
             }
          }
@@ -19166,7 +16545,7 @@ int32 arg_count;                       /* number of arguments in request    */
 
             pstack_top++;
             class_ptr->ut_self->ss_object =
-               pstack[pstack_top].sp_val.sp_object_ptr;
+               spec_val(&pstack[pstack_top],sp_object_ptr);
 
             /* loop over the instance variables */
 
@@ -19175,9 +16554,10 @@ int32 arg_count;                       /* number of arguments in request    */
                  slot_info = slot_info->si_next_var) {
 
                pstack_top++;
-               (slot_info->si_spec)->sp_form = pstack[pstack_top].sp_form;
-               (slot_info->si_spec)->sp_val.sp_biggest =
-                  pstack[pstack_top].sp_val.sp_biggest;
+               spec_set_form((slot_info->si_spec),
+                             spec_form(&pstack[pstack_top]));
+               spec_set_val((slot_info->si_spec),sp_biggest,
+                  spec_val(&pstack[pstack_top],sp_biggest));
 
             }
          }
@@ -19205,10 +16585,10 @@ int32 arg_count;                       /* number of arguments in request    */
            i < arg_count;
            arg_ptr++, i++) {
 
-         arg_ptr->sp_form = (request_ptr->rq_args)[i].sp_form;
-         arg_ptr->sp_val.sp_biggest = 
-            (request_ptr->rq_args)[i].sp_val.sp_biggest;
-         (request_ptr->rq_args)[i].sp_form = ft_omega;
+         spec_set_form(arg_ptr,spec_form(&(request_ptr->rq_args)[i]));
+         spec_set_val(arg_ptr,sp_biggest,
+            spec_val(&(request_ptr->rq_args)[i],sp_biggest));
+         spec_set_form(&(request_ptr->rq_args)[i],ft_omega);
 
       }
 
@@ -19218,7 +16598,7 @@ int32 arg_count;                       /* number of arguments in request    */
            arg_ptr < proc_ptr->p_spec_ptr + proc_ptr->p_spec_count;
            arg_ptr++) {
 
-         arg_ptr->sp_form = ft_omega;
+         spec_set_form(arg_ptr,ft_omega);
 
       }
 
@@ -19250,9 +16630,9 @@ int32 arg_count;                       /* number of arguments in request    */
       target = process_ptr->pc_wait_target;
       if (target != NULL) {
          unmark_specifier(target);
-         target->sp_form = process_ptr->pc_wait_return.sp_form;
-         target->sp_val.sp_biggest =
-            process_ptr->pc_wait_return.sp_val.sp_biggest;
+         spec_set_form(target,spec_form(&process_ptr->pc_wait_return));
+         spec_set_val(target,sp_biggest,
+            spec_val(&process_ptr->pc_wait_return,sp_biggest));
       }
 
       process_ptr->pc_waiting = process_ptr->pc_checking = NO;
@@ -19260,27 +16640,43 @@ int32 arg_count;                       /* number of arguments in request    */
    }
 
    process_head = process_ptr;
-   opcodes_until_switch = PROCESS_SLICE;
-   
+   opcodes_until_switch = process_slice_length(SETL_SYSTEM process_ptr);
+
+   /*
+    *  A process leaving the reactor repeats the built-in procedure which
+    *  blocked.  That may block again, if it was woken too early.
+    */
+
+   if (process_ptr->pc_blocked) {
+
+      reactor_resume(SETL_SYSTEM process_ptr);
+      if (process_ptr->pc_blocked)
+         goto switch_start;
+
+   }
 
 }
 
 /*\
  *  \function{alloc\_pstack()}
  *
- *  This function expands the program stack.
+ *  This function expands the program stack.  We at least double it, since
+ *  set and tuple formers push every element before they build the
+ *  result.
 \*/
 
 void alloc_pstack(SETL_SYSTEM_PROTO_VOID)
 
 {
 specifier *old_pstack;                 /* temporary program stack           */
+int32 new_max;                         /* size of expanded stack            */
 
    /* expand the table */
 
+   new_max = pstack_max + (pstack_max > PSTACK_BLOCK_SIZE ?
+                           pstack_max : PSTACK_BLOCK_SIZE);
    old_pstack = pstack;
-   pstack = (specifier *)malloc((size_t)(
-                   (pstack_max + PSTACK_BLOCK_SIZE) * sizeof(specifier)));
+   pstack = (specifier *)malloc((size_t)(new_max * sizeof(specifier)));
    if (pstack == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
@@ -19296,7 +16692,7 @@ specifier *old_pstack;                 /* temporary program stack           */
 
    }
 
-   pstack_max += PSTACK_BLOCK_SIZE;
+   pstack_max = new_max;
 
 }
 
@@ -19354,7 +16750,7 @@ PRTYPE void call_binop_method(
 
 {
 
-   object_root = self->sp_val.sp_object_ptr;
+   object_root = spec_val(self,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* get information about this slot in the object */
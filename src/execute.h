@@ -33,6 +33,10 @@
 #define EX_INIT_CODE 0                 /* initialization code               */
 #define EX_BODY_CODE 1                 /* body code                         */
 
+/* execute_go() mode which only publishes the threaded code handlers */
+
+#define EX_HANDLERS  2                 /* fill in pcode_handlers            */
+
 /* procedure call stack */
 
 struct call_stack_item {
@@ -61,9 +65,13 @@ int32 critical_section = 0;
 int32 opcodes_until_switch = 2000;
 struct process_item *process_head = NULL;
 struct specifier_item *ex_wait_target;
+int ex_can_wait = NO;                  /* YES if a built-in may block       */
 
 struct instruction_item *ip;           /* executing instruction             */
 struct instruction_item *pc;           /* next instruction                  */
+#if THREADED_CODE
+void **pcode_handlers = NULL;          /* interpreter case by opcode        */
+#endif
 int32 pstack_top = -1;                 /* top of program stack              */
 int32 pstack_max = 0;                  /* size of program stack             */
 struct specifier_item *pstack = NULL;  /* program stack                     */
@@ -89,9 +97,13 @@ extern int32 critical_section;
 extern int32 opcodes_until_switch;
 extern struct process_item *process_head;
 extern struct specifier_item *ex_wait_target;
+extern int ex_can_wait;                /* YES if a built-in may block       */
 
 extern struct instruction_item *ip;    /* executing instruction             */
 extern struct instruction_item *pc;    /* next instruction                  */
+#if THREADED_CODE
+extern void **pcode_handlers;          /* interpreter case by opcode        */
+#endif
 EXTERNAL int32 pstack_top;               /* top of program stack              */
 EXTERNAL int32 pstack_max;               /* size of program stack             */
 EXTERNAL struct specifier_item *pstack;  /* program stack                     */
@@ -127,8 +139,8 @@ extern struct unittab_item *last_unittab;
    mark_specifier(s); \
    if (++pstack_top == pstack_max) \
       alloc_pstack(SETL_SYSTEM_VOID); \
-   pstack[pstack_top].sp_form = (s)->sp_form; \
-   pstack[pstack_top].sp_val.sp_biggest = (s)->sp_val.sp_biggest; \
+   spec_set_form(&pstack[pstack_top],spec_form(s)); \
+   spec_set_val(&pstack[pstack_top],sp_biggest,spec_val(s,sp_biggest)); \
 }
 
 #define pop_pstack {\
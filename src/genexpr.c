@@ -198,6 +198,12 @@ symtab_ptr_type gen_expr_symtab(
  *
  *  For binary operators we simply evaluate each operand and emit an
  *  instruction to calculate the result.
+ *
+ *  Chains of additions like \verb"s := s + a + b", where \verb"s" is the
+ *  target and each addend is a simple operand other than \verb"s", are
+ *  the exception.  There we add into the target as we go, rather than
+ *  into temporaries, so the interpreter can append to a string in
+ *  place.  Evaluating the addends can't see the difference.
 \*/
 
 symtab_ptr_type gen_expr_binop(
@@ -208,6 +214,9 @@ symtab_ptr_type gen_expr_binop(
 {
 ast_ptr_type left_ptr;                 /* left child node                   */
 ast_ptr_type right_ptr;                /* right child node                  */
+ast_ptr_type chain_ptr;                /* used to loop over an addition     */
+                                       /* chain                             */
+symtab_ptr_type chain_target;          /* target for left operand           */
 symtab_ptr_type operand[3];            /* array of operands                 */
 
 #ifdef DEBUG
@@ -225,6 +234,31 @@ symtab_ptr_type operand[3];            /* array of operands                 */
    left_ptr = root->ast_child.ast_child_ast;
    right_ptr = left_ptr->ast_next;
 
+   /* check for a chain of additions onto the target */
+
+   chain_target = NULL;
+   if (root->ast_type == ast_add && left_ptr->ast_type == ast_add &&
+       target != NULL && !target->st_is_temp) {
+
+      for (chain_ptr = root;
+           chain_ptr->ast_type == ast_add;
+           chain_ptr = chain_ptr->ast_child.ast_child_ast) {
+
+         right_ptr = chain_ptr->ast_child.ast_child_ast->ast_next;
+         if (right_ptr->ast_type != ast_symtab ||
+             right_ptr->ast_child.ast_symtab_ptr == target)
+            break;
+
+      }
+
+      if (chain_ptr->ast_type == ast_symtab &&
+          chain_ptr->ast_child.ast_symtab_ptr == target)
+         chain_target = target;
+
+      right_ptr = left_ptr->ast_next;
+
+   }
+
    /* allocate a temporary if we did't get a target */
 
    if (target == NULL) {
@@ -244,7 +278,7 @@ symtab_ptr_type operand[3];            /* array of operands                 */
    }
    else {
 
-      operand[1] = gen_expression(SETL_SYSTEM left_ptr,NULL);
+      operand[1] = gen_expression(SETL_SYSTEM left_ptr,chain_target);
       operand[2] = gen_expression(SETL_SYSTEM right_ptr,NULL);
 
    }
@@ -862,6 +862,8 @@ static label_record label;             /* procedure address record          */
                   proc.pr_spec_offset = 0;
                proc.pr_formal_count =
                   (symtab_ptr->st_aux.st_proctab_ptr)->pr_formal_count;
+               proc.pr_side_effects =
+                  (symtab_ptr->st_aux.st_proctab_ptr)->pr_side_effects;
                proc.pr_spec_count =
                   (symtab_ptr->st_aux.st_proctab_ptr)->pr_symtab_count;
 
@@ -891,6 +893,8 @@ static label_record label;             /* procedure address record          */
                   proc.pr_spec_offset = 0;
                proc.pr_formal_count =
                   (symtab_ptr->st_aux.st_proctab_ptr)->pr_formal_count;
+               proc.pr_side_effects =
+                  (symtab_ptr->st_aux.st_proctab_ptr)->pr_side_effects;
                proc.pr_spec_count =
                   (symtab_ptr->st_aux.st_proctab_ptr)->pr_symtab_count;
 
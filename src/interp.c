@@ -26,6 +26,10 @@
  *
 \*/
 
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
+
 /* SETL2 system header files */
 
 #include "system.h"                    /* SETL2 system constants            */
@@ -80,27 +84,6 @@ struct plugin_item *plugin_instance;
    if (plugin_instance==NULL) return NULL;
    bzero(plugin_instance, sizeof(struct plugin_item));
 			       
-   plugin_instance->file_next_free=NULL;
-   plugin_instance->integer_h_next_free=NULL;
-   plugin_instance->integer_c_next_free=NULL;
-   plugin_instance->mailbox_h_next_free=NULL;
-   plugin_instance->mailbox_c_next_free=NULL;
-   plugin_instance->process_next_free=NULL;
-   plugin_instance->request_next_free=NULL;
-   plugin_instance->string_h_next_free=NULL;
-   plugin_instance->string_c_next_free=NULL;
-   plugin_instance->iter_next_free=NULL;
-   plugin_instance->set_h_next_free=NULL;
-   plugin_instance->set_c_next_free=NULL;
-   plugin_instance->map_h_next_free=NULL;
-   plugin_instance->map_c_next_free=NULL;
-   plugin_instance->tuple_h_next_free=NULL;
-   plugin_instance->tuple_c_next_free=NULL;
-   plugin_instance->real_next_free=NULL;
-   plugin_instance->proc_next_free=NULL;
-   plugin_instance->object_h_next_free=NULL;
-   plugin_instance->object_c_next_free=NULL;
-   plugin_instance->self_stack_next_free=NULL;
    plugin_instance->debug_file=stdout;
    plugin_instance->assert_mode=0;
    plugin_instance->ex_debug=0;
@@ -120,6 +103,7 @@ struct plugin_item *plugin_instance;
    plugin_instance->eval_package=0;
    plugin_instance->verbose_mode=0;
    plugin_instance->wait_flag=0;
+   plugin_instance->reactor_fd=-1;
    plugin_instance->total_slot_count=0;
 
    plugin_instance->already_called = NO;
@@ -186,11 +170,26 @@ int i;
           pcode_operations[i]=0;
           copy_operations[i]=0;
        }
+       memset((void *)pcode_pairs,0,sizeof(pcode_pairs));
+       if (pcode_triples == NULL) {
+          pcode_triples = (long *)calloc((size_t)(PCODE_NGRAM_SIZE *
+                                                  PCODE_NGRAM_SIZE *
+                                                  PCODE_NGRAM_SIZE),
+                                         sizeof(long));
+          if (pcode_triples == NULL)
+             giveup(SETL_SYSTEM msg_malloc_error);
+       }
+       else {
+          memset((void *)pcode_triples,0,
+                 sizeof(long) * PCODE_NGRAM_SIZE * PCODE_NGRAM_SIZE *
+                                PCODE_NGRAM_SIZE);
+       }
        head_unittab=NULL; 
        last_unittab=NULL; 
    }
 #endif
 
+   init_hash_seed(SETL_SYSTEM_VOID);
    init_interp_reals(SETL_SYSTEM_VOID);
    init_unittab(SETL_SYSTEM_VOID);
    init_slots(SETL_SYSTEM_VOID);
@@ -58,6 +58,9 @@ typedef struct destructor_item setl_destructor;
 
 struct instruction_item {
    int i_opcode;
+#if THREADED_CODE
+   void *i_handler;                    /* interpreter case for opcode       */
+#endif
    union {
       struct specifier_item *i_spec_ptr;
       void (*i_func_ptr)(int, struct specifier_item *);
@@ -106,6 +109,7 @@ plugin_item_ptr_type Setl_Initialize();
 #define LIBRARY_PATH 	plugin_instance->library_path
 #define OPCODE_COUNT 	plugin_instance->opcode_count
 #define PROCESS_SLICE 	plugin_instance->process_slice
+#define SLICE_MSECS 	plugin_instance->slice_msecs
 #define NESTED_CALLS 	plugin_instance->nested_calls
 #define ABEND_MESSAGE  	plugin_instance->abend_message
 #define EVAL_PACKAGE   	plugin_instance->eval_package
@@ -141,6 +145,7 @@ void Setl_Initialize();
 #define LIBRARY_PATH 	library_path
 #define OPCODE_COUNT 	opcode_count
 #define PROCESS_SLICE 	process_slice
+#define SLICE_MSECS 	slice_msecs
 #define NESTED_CALLS 	nested_calls
 #define ABEND_MESSAGE   abend_message
 #define EVAL_PACKAGE    eval_package
@@ -174,6 +179,7 @@ char *default_library = "setl2.lib";   /* default library name              */
 char *library_path = "";               /* library search path               */
 int32 opcode_count = 0;                /* number of opcodes executed        */
 int32 process_slice = 2000;            /* number of opcodes in one slice    */
+int32 slice_msecs = 0;                 /* milliseconds in one slice, or 0   */
 int nested_calls = 0;                  /* forbid recursive calls            */
 char abend_message[8000];              /* error message                     */
 int eval_package = 0;                  /* dummy package compiled?           */
@@ -201,6 +207,7 @@ extern char *default_library;          /* default library name              */
 extern char *library_path;             /* library search path               */
 extern int32 opcode_count;             /* number of opcodes executed        */
 extern int32 process_slice;            /* number of opcodes in one slice    */
+extern int32 slice_msecs;              /* milliseconds in one slice, or 0   */
 extern int eval_package;               /* dummy package compiled?           */
 extern char abend_message[8000];       /* error message                     */
 extern int nested_calls;
@@ -46,6 +46,7 @@
 #include <sys/types.h>                 /* file types                        */
 #include <sys/stat.h>                  /* file status                       */
 #endif
+#include <stdlib.h>                    /* memory allocation and atoi        */
 #include <math.h>                      /* math function headers             */
 #include <ctype.h>                     /* character macros                  */
 
@@ -75,6 +76,7 @@
 #include "objects.h"                   /* objects                           */
 #include "process.h"                   /* objects                           */
 #include "mailbox.h"                   /* objects                           */
+#include "reactor.h"                   /* blocked processes                 */
 #include "slots.h"                     /* procedures                        */
 #include "x_files.h"                   /* files                             */
 
@@ -94,12 +96,19 @@ extern char *javascript_buffer;
 #endif
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <arpa/inet.h>
 #include <netdb.h>
+#include <fcntl.h>
 #ifndef INADDR_NONE
 #define INADDR_NONE 0xffffffff
 #endif
 #endif
 
+#if UNIX
+#include <unistd.h>                    /* read, close and pipe              */
+#include <poll.h>                      /* poll                              */
+#endif
+
 /*
  *  Some compilers, notably Lattice, can not handle a very long text
  *  segment.  This stuff is used to break up this file, so we can run
@@ -110,6 +119,11 @@ extern char *javascript_buffer;
 
 #define BINFLAG     "setl2bin"         /* binary file flag                  */
 #define SKIP_CODE   -1                 /* skip code for sparse tuples       */
+#define DIGIT_BUFFER_SIZE 256          /* initial digit buffer for long     */
+                                       /* numbers we read                   */
+#define PRINT_CHUNK 256                /* chunk size printing strings with  */
+                                       /* embedded nulls                    */
+#define ACCEPT_BATCH 64                /* most connections accepted at once */
 
 /* file modes */
 
@@ -122,6 +136,7 @@ extern char *javascript_buffer;
 #define RANDOM      5                  /* random string file                */
 
 #define TCP         6                  /* TCP client sockets                */
+#define TCP_SERVER  7                  /* listening TCP sockets             */
 
 /* read_spec return codes */
 
@@ -144,19 +159,14 @@ static unsigned char *eof_ptr;         /* pointer to end of file character  */
 static file_ptr_type stdin_ptr;        /* standard input pointer            */
 static file_ptr_type reads_ptr;        /* dummy file for reads              */
 static file_ptr_type file_ptr;         /* current file pointer              */
-static string_c_ptr_type reads_cell;   /* current cell for reads            */
-static char *reads_char_ptr, *reads_char_end;
-                                       /* character pointers for reads      */
+static char *reads_char_ptr;           /* character pointer for reads       */
 static int32 reads_length;             /* length of input string            */
 static int eof_flag;                   /* YES if last read yielded eof      */
 static time_t runtime;                 /* current run time                  */
 static int process_id;                 /* process identifier                */
 static string_h_ptr_type binstr_curr_hdr;
                                        /* binstr return string              */
-static string_c_ptr_type binstr_curr_cell;
-                                       /* current cell in above             */
-static char *binstr_char_ptr, *binstr_char_end;
-                                       /* character pointers in above       */
+static int32 unbinstr_skip;            /* tuple index after a skip code     */
 
 /* advance lookahead macro */
 
@@ -178,6 +188,19 @@ static void binstr_cat_string(SETL_SYSTEM_PROTO char *, size_t);
                                        /* return value                      */
 static void unbinstr_spec(SETL_SYSTEM_PROTO specifier *);
                                        /* unbinstring one specifier         */
+#if defined(PROCESSES) && defined(HAVE_SYS_SOCKET_H)
+static int socket_lines_ready(SETL_SYSTEM_PROTO file_ptr_type, int);
+                                       /* YES if lines are buffered         */
+#endif
+#ifdef HAVE_SYS_SOCKET_H
+static int open_server(SETL_SYSTEM_PROTO char *);
+                                       /* open a listening socket           */
+static int accept_sockets(SETL_SYSTEM_PROTO int, specifier *,
+                          reactor_redo_type, int, int *, char **);
+                                       /* accept pending connections        */
+static void enter_socket(SETL_SYSTEM_PROTO int, char *, specifier *);
+                                       /* make a connection a file          */
+#endif
 
 #ifdef HAVE_SYS_SOCKET_H
 
@@ -258,19 +281,10 @@ void open_io(
    SETL_SYSTEM_PROTO_VOID)
 
 {
-int i;                                 /* temporary looping variable        */
 
    /* create a file map */
 
-   get_map_header(file_map);
-   file_map->m_use_count = 1;
-   file_map->m_hash_code = 0;
-   file_map->m_ntype.m_root.m_cardinality = 0;
-   file_map->m_ntype.m_root.m_cell_count = 0;
-   file_map->m_ntype.m_root.m_height = 0;
-   for (i = 0;
-        i < MAP_HASH_SIZE;
-        file_map->m_child[i++].m_cell = NULL);
+   file_map = null_map(SETL_SYSTEM_VOID);
 
    /* set up a node for standard input */
 
@@ -312,9 +326,8 @@ void close_io(
    SETL_SYSTEM_PROTO_VOID)
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
+struct set_cursor_item map_cursor;     /* position in map                   */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
 
    /* if the file map is null, we never opened the package */
 
@@ -323,72 +336,11 @@ int map_height, map_index;             /* current height and index          */
 
    /* set up to loop over the map */
 
-   map_work_hdr = file_map;
-   map_height = file_map->m_ntype.m_root.m_height;
-   map_cell = NULL;
-   map_index = 0;
+   set_cursor_start(&map_cursor,file_map->m_trie);
 
    /* loop over the elements of source */
 
-   for (;;) {
-
-      /* find the next cell in the map */
-
-      while (map_cell == NULL) {
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!map_height && map_index < MAP_HASH_SIZE) {
-
-            map_cell = map_work_hdr->m_child[map_index].m_cell;
-            map_index++;
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (map_index >= MAP_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (map_work_hdr == file_map)
-               break;
-
-            /* otherwise move up */
-
-            map_height++;
-            map_index =
-               map_work_hdr->m_ntype.m_intern.m_child_index + 1;
-            map_work_hdr =
-               map_work_hdr->m_ntype.m_intern.m_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (map_work_hdr->m_child[map_index].m_header == NULL) {
-
-            map_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         map_work_hdr =
-            map_work_hdr->m_child[map_index].m_header;
-         map_index = 0;
-         map_height--;
-
-      }
-
-      /* if there are no more cells, break */
-
-      if (map_cell == NULL)
-         break;
+   while ((map_cell = map_cursor_next(&map_cursor)) != NULL) {
 
       /*
        *  At this point we have a map cell.  Because of the way this map
@@ -396,8 +348,7 @@ int map_height, map_index;             /* current height and index          */
        *  single range value.  All we do is close the open file.
        */
 
-      file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
-      map_cell = map_cell->m_next;
+      file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
 
       switch (file_ptr->f_mode) {
 
@@ -431,6 +382,11 @@ int map_height, map_index;             /* current height and index          */
             close(file_ptr->f_file_fd);
             break;
 
+         case TCP_SERVER :
+
+            close(file_ptr->f_file_fd);
+            break;
+
       }
 
    }
@@ -454,19 +410,11 @@ void setl2_internal_open(
 
 {
 specifier file_atom;                   /* file handle atom                  */
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
-map_c_ptr_type map_cell;               /* current cell pointer              */
-map_c_ptr_type *map_tail;              /* attach new cells here             */
-int map_height, map_index;             /* current height and index          */
-map_h_ptr_type new_hdr;                /* created header node               */
+int is_new;                            /* YES if a cell was added           */
 map_c_ptr_type new_cell;               /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 int pid;                               /* process identifier                */
 char flag_string[20];                  /* binary flag?                      */
 time_t create_time;                    /* file creation time                */
-int i;                                 /* temporary looping variable        */
 
    /*
     *  For text input files we use level 0 I/O and manage our own buffer.
@@ -482,7 +430,7 @@ int i;                                 /* temporary looping variable        */
             /* return om */
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
 
             return;
 
@@ -513,7 +461,7 @@ int i;                                 /* temporary looping variable        */
          /* return om */
 
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
          free_file(file_ptr);
 
          return;
@@ -556,7 +504,7 @@ int i;                                 /* temporary looping variable        */
          /* return om */
 
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
          free_file(file_ptr);
 
          return;
@@ -592,7 +540,7 @@ int i;                                 /* temporary looping variable        */
          /* return om */
 
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
          free_file(file_ptr);
 
          return;
@@ -617,7 +565,7 @@ int i;                                 /* temporary looping variable        */
          file_ptr->f_file_fd = -1;
 
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
 
          return;
 
@@ -634,7 +582,7 @@ int i;                                 /* temporary looping variable        */
          /* return om */
 
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
          free_file(file_ptr);
 
          return;
@@ -698,7 +646,7 @@ int i;                                 /* temporary looping variable        */
          /* return om */
 
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
          free_file(file_ptr);
 
          return;
@@ -754,7 +702,7 @@ int i;                                 /* temporary looping variable        */
             /* return om */
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
             free_file(file_ptr);
 
             return;
@@ -820,7 +768,7 @@ int i;                                 /* temporary looping variable        */
             /* return om */
 
             unmark_specifier(target);
-            target->sp_form = ft_omega;
+            spec_set_form(target,ft_omega);
             free_file(file_ptr);
 
             return;
@@ -834,103 +782,79 @@ int i;                                 /* temporary looping variable        */
 
       file_ptr->f_start = file_ptr->f_endofbuffer = file_ptr->f_file_buffer;
       file_ptr->f_eof_ptr = NULL;
-#endif
-   }
-
-   else {
-
-      abend(SETL_SYSTEM msg_bad_file_mode,mode_string);
 
    }
 
    /*
-    *     At this point the file is opened successfully.  We get an atom
-    *     to represent it and insert that atom in the file map.
+    *  A server socket listens for connections, which we accept as
+    *  separate files.
     */
 
-   file_atom.sp_form = ft_omega;
-   setl2_newat(SETL_SYSTEM 0,NULL,&file_atom);
-
-   map_work_hdr = file_map;
-   work_hash_code = file_atom.sp_val.sp_atom_num;
-   for (map_height = file_map->m_ntype.m_root.m_height;
-        map_height;
-        map_height--) {
+   else if ((strcmp(mode_string,"socket-server") == 0)&&(SAFE_MODE==0)) {
 
-      /* extract the element's index at this level */
+      int fd;
 
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code >>= MAP_SHIFT_DIST;
+      fd = open_server(SETL_SYSTEM file_name);
+      if (fd == -1) {
 
-      /* if we're missing a header record, insert it */
+         /* return om */
 
-      if (map_work_hdr->m_child[map_index].m_header == NULL) {
+         unmark_specifier(target);
+         spec_set_form(target,ft_omega);
 
-         get_map_header(new_hdr);
-         new_hdr->m_ntype.m_intern.m_parent = map_work_hdr;
-         new_hdr->m_ntype.m_intern.m_child_index = map_index;
-         for (i = 0;
-              i < MAP_HASH_SIZE;
-              new_hdr->m_child[i++].m_cell = NULL);
-         map_work_hdr->m_child[map_index].m_header = new_hdr;
-         map_work_hdr = new_hdr;
+         return;
 
       }
-      else {
 
-         map_work_hdr = map_work_hdr->m_child[map_index].m_header;
+      get_file(file_ptr);
 
-      }
-   }
+      file_ptr->f_type = new_flag;
+      file_ptr->f_flag = 0;
+      file_ptr->f_mode = TCP_SERVER;
+      strcpy(file_ptr->f_file_name,file_name);
+      file_ptr->f_file_fd = fd;
+      file_ptr->f_file_stream = NULL;
+      file_ptr->f_file_buffer = NULL;
 
-   /*
-    *  At this point, map_work_hdr points to the lowest level
-    *  header record.
-    */
+#endif
+   }
 
-   map_index = work_hash_code & MAP_HASH_MASK;
-   map_tail = &(map_work_hdr->m_child[map_index].m_cell);
-   for (map_cell = *map_tail;
-        map_cell != NULL &&
-           map_cell->m_hash_code < file_atom.sp_val.sp_atom_num;
-        map_cell = map_cell->m_next) {
+   else {
 
-      map_tail = &(map_cell->m_next);
+      abend(SETL_SYSTEM msg_bad_file_mode,mode_string);
 
    }
 
-   /* we don't have to worry about duplicates -- add a cell */
-
-   get_map_cell(new_cell);
-   new_cell->m_domain_spec.sp_form = ft_atom;
-   new_cell->m_domain_spec.sp_val.sp_atom_num = file_atom.sp_val.sp_atom_num;
-   new_cell->m_range_spec.sp_form = ft_file;
-   new_cell->m_range_spec.sp_val.sp_file_ptr = file_ptr;
-   new_cell->m_is_multi_val = NO;
-   new_cell->m_hash_code = file_atom.sp_val.sp_atom_num;
-   new_cell->m_next = *map_tail;
-   *map_tail = new_cell;
-   file_map->m_ntype.m_root.m_cardinality++;
-   file_map->m_ntype.m_root.m_cell_count++;
-   file_map->m_hash_code ^= file_atom.sp_val.sp_atom_num;
-
-   expansion_trigger =
-         (1 << ((file_map->m_ntype.m_root.m_height + 1)
-                    * MAP_SHIFT_DIST)) * MAP_CLASH_SIZE;
+   /*
+    *     At this point the file is opened successfully.  We get an atom
+    *     to represent it and insert that atom in the file map.
+    */
 
-   /* expand the map header if necessary */
+   spec_set_form(&file_atom,ft_omega);
+   setl2_newat(SETL_SYSTEM 0,NULL,&file_atom);
 
-   if (file_map->m_ntype.m_root.m_cardinality > expansion_trigger) {
+   new_cell = map_locate(&(file_map->m_trie),
+                         &file_atom,
+                         spec_val(&file_atom,sp_atom_num),
+                         &is_new);
 
-      file_map = map_expand_header(SETL_SYSTEM file_map);
+   /* atoms are unique, so we don't have to worry about duplicates */
 
-   }
+   spec_set_form(&new_cell->m_domain_spec,ft_atom);
+   spec_set_val(&new_cell->m_domain_spec,sp_atom_num,
+                spec_val(&file_atom,sp_atom_num));
+   spec_set_form(&new_cell->m_range_spec,ft_file);
+   spec_set_val(&new_cell->m_range_spec,sp_file_ptr,file_ptr);
+   new_cell->m_is_multi_val = NO;
+   file_map->m_cardinality++;
+   file_map->m_cell_count++;
+   file_map->m_hash_code ^= spec_val(&file_atom,sp_atom_num);
 
    /* return the atom */
 
    unmark_specifier(target);
-   target->sp_form = ft_atom;
-   target->sp_val.sp_atom_num = file_atom.sp_val.sp_atom_num;
+   spec_set_form(target,ft_atom);
+   spec_set_val(target,sp_atom_num,spec_val(&file_atom,sp_atom_num));
 
    return;
 
@@ -951,35 +875,23 @@ void setl2_newopen(
 
 {
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 char mode_string[30];                  /* mode (character string)           */
 char file_name_buf[PATH_LENGTH + 1];   /* file name                         */
-char *s, *t;                           /* temporary looping variables       */
 int i;                                 /* temporary looping variable        */
 char *file_name;
 
    /* convert the file name to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    if (string_hdr->s_length > PATH_LENGTH)
       abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
 
-   t = file_name_buf;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < file_name_buf + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)file_name_buf,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
    file_name=file_name_buf;
 
 #ifdef HAVE_SYS_SOCKET_H
@@ -1003,6 +915,18 @@ char *file_name;
       return;
    }
 
+   else if (strncmp(file_name,"tcp_server:",11)==0) {
+
+      file_name += 11;
+      if ((*file_name!='/')||((*(file_name+1)!='/')))
+          abend(SETL_SYSTEM msg_bad_file_mode,
+                abend_opnd_str(SETL_SYSTEM argv));
+
+      file_name += 2;
+      setl2_internal_open(SETL_SYSTEM 1,target,"socket-server",file_name);
+      return;
+   }
+
    else 
 #endif
    if ((strncmp(file_name,"file:",5)==0)||
@@ -1021,263 +945,580 @@ char *file_name;
 }
 
 
+#ifdef HAVE_SYS_SOCKET_H
+
 /*\
- *  \function{setl2\_open()}
+ *  \function{open\_server()}
  *
- *  This function opens a file and returns a file handle.  The handle is
- *  an atom which must be used in other procedure calls to identify the
- *  file being accessed.
+ *  This function opens a listening socket, and returns its descriptor or
+ *  -1.  The address has the form \verb"host:port?options", where an
+ *  empty host or \verb"*" means any interface.  The options are separated
+ *  by \verb"&":
+ *
+ *  \begin{description}
+ *  \item[backlog=n] allows $n$ connections to wait for \verb"accept".
+ *  \item[reuseport] sets \verb"SO_REUSEPORT", so several listeners, in
+ *  this process or others, can share the port.
+ *  \end{description}
+ *
+ *  The socket doesn't block, so a process waiting for a connection waits
+ *  in the reactor.
 \*/
 
-void setl2_open(
-   SETL_SYSTEM_PROTO 
-   int argc,                           /* number of arguments passed        */
-   specifier *argv,                    /* argument vector (two here)        */
-   specifier *target)                  /* return value                      */
+static int open_server(
+   SETL_SYSTEM_PROTO
+   char *address)                      /* host, port and options            */
 
 {
-string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
-char mode_string[30];                  /* mode (character string)           */
-char file_name[PATH_LENGTH*2 + 1];     /* file name                         */
-char *s, *t, *q;                       /* temporary looping variables       */
-int i;                                 /* temporary looping variable        */
+char host[PATH_LENGTH + 1];            /* address, broken into pieces       */
+char *port, *options, *option;         /* pieces of address                 */
+struct sockaddr_in server;             /* bound address                     */
+struct hostent *hp;                    /* host entry                        */
+int backlog;                           /* pending connection limit          */
+int reuse_port;                        /* YES if we share the port          */
+int one;                               /* socket option value               */
+int fd;                                /* listening socket                  */
+
+   strcpy(host,address);
+   backlog = SOMAXCONN;
+   reuse_port = NO;
+
+   /* pick out the options */
+
+   if ((options = strchr(host,'?')) != NULL) {
+
+      *options++ = '\0';
+      for (option = strtok(options,"&");
+           option != NULL;
+           option = strtok(NULL,"&")) {
+
+         if (strncmp(option,"backlog=",8) == 0) {
+            backlog = atoi(option + 8);
+            if (backlog <= 0)
+               abend(SETL_SYSTEM
+                     "Socket backlog must be a positive integer => %s",
+                     option);
+            continue;
+         }
+         if (strcmp(option,"reuseport") == 0) {
+            reuse_port = YES;
+            continue;
+         }
 
-   
-   /* convert the file name to a C character string */
-   if ((argc==1)&&(SAFE_MODE==0))  {
-      setl2_newopen(SETL_SYSTEM argc,argv,target);
-      return;
+         abend(SETL_SYSTEM "Invalid socket option => %s",option);
+
+      }
    }
-   if (argc!=2)
-      abend(SETL_SYSTEM msg_wrong_parms);
 
-   if (argv[0].sp_form != ft_string)
-      abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
+   /* the port follows the last colon, if there is a host */
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   if ((port = strrchr(host,':')) != NULL)
+      *port++ = '\0';
+   else
+      port = host;
 
-   if (((SAFE_MODE==1)&&(string_hdr->s_length!=5))||
-       (string_hdr->s_length > PATH_LENGTH))
-      abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
+   memset((void *)&server,0,sizeof(server));
+   server.sin_family = AF_INET;
+   server.sin_port = htons(to_portnum(SETL_SYSTEM port));
 
-   q = t = file_name;
-   *file_name=0;
-   if (SAFE_MODE==1) {
-	if (SAFE_PREFIX!=NULL) {
-		strcpy(file_name,SAFE_PREFIX);
-	 	t+=strlen(file_name);
-		*t='/';t++;
-		q=t;
-	}
+   if (port == host || host[0] == '\0' || strcmp(host,"*") == 0) {
+      server.sin_addr.s_addr = htonl(INADDR_ANY);
    }
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
+   else if ((server.sin_addr.s_addr = inet_addr(host)) == INADDR_NONE) {
 
-      for (s = string_cell->s_cell_value;
-           t < q + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
+      hp = os_findhostbyname(host);
+      if (hp == NULL || hp->h_addr_list[0] == NULL)
+         return -1;
+      memcpy((void *)&server.sin_addr,(void *)hp->h_addr_list[0],
+             (size_t)hp->h_length);
 
    }
-   *t = '\0';
-
-   if ((SAFE_MODE==1)&&
-	((strncmp(q,"File",4)!=0)||(*(q+4)<'1')||(*(q+4)>'5')))
-      abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
-
-   /* convert the file mode to a C character string */
 
-   if (argv[1].sp_form != ft_string)
-      abend(SETL_SYSTEM msg_bad_file_mode,abend_opnd_str(SETL_SYSTEM argv+1));
+   fd = socket(AF_INET,SOCK_STREAM,0);
+   if (fd == -1)
+      abend(SETL_SYSTEM "Error in socket()");
 
-   string_hdr = argv[1].sp_val.sp_string_ptr;
+   /* let a restarted server have its port back at once */
 
-   if (string_hdr->s_length > 30)
-      abend(SETL_SYSTEM msg_bad_file_mode,abend_opnd_str(SETL_SYSTEM argv+1));
+   one = 1;
+   setsockopt(fd,SOL_SOCKET,SO_REUSEADDR,(void *)&one,sizeof(one));
 
-   t = mode_string;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
+   if (reuse_port) {
+#ifdef SO_REUSEPORT
+      setsockopt(fd,SOL_SOCKET,SO_REUSEPORT,(void *)&one,sizeof(one));
+#else
+      close(fd);
+      abend(SETL_SYSTEM "Socket option reuseport is not supported");
+#endif
+   }
 
-      for (s = string_cell->s_cell_value;
-           t < mode_string + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           s++, t++) {
+   if (bind(fd,(struct sockaddr *)&server,sizeof(server)) == -1 ||
+       listen(fd,backlog) == -1 ||
+       fcntl(fd,F_SETFL,fcntl(fd,F_GETFL) | O_NONBLOCK) == -1) {
 
-         if (isupper(*s))
-            *t = tolower(*s);
-         else
-            *t = *s;
+      close(fd);
+      return -1;
 
-      }
    }
-   *t = '\0';
 
-   setl2_internal_open(SETL_SYSTEM 0,target,mode_string,file_name);
+   return fd;
 
 }
 
 /*\
- *  \function{setl2\_close()}
+ *  \function{accept\_sockets()}
  *
- *  This function closes a file opened with the \verb"open()" function
- *  above.
+ *  This function accepts up to \verb"limit" pending connections on the
+ *  server socket passed to \verb"socket_accept" or
+ *  \verb"socket_accept_all", and returns how many it took.  If none are
+ *  pending, the current process waits in the reactor and we return -1,
+ *  without a result.  Called from C we can't switch processes, so we
+ *  wait here.
+ *
+ *  The connections block, like client sockets.  We return their
+ *  descriptors and peer names, which the caller must free.
 \*/
 
-void setl2_close(
-   SETL_SYSTEM_PROTO 
+static int accept_sockets(
+   SETL_SYSTEM_PROTO
    int argc,                           /* number of arguments passed        */
    specifier *argv,                    /* argument vector (one here)        */
-   specifier *target)                  /* return value                      */
+   reactor_redo_type redo,             /* built-in procedure called         */
+   int limit,                          /* most connections to accept        */
+   int *fds,                           /* accepted descriptors              */
+   char **names)                       /* peer names                        */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-map_c_ptr_type *map_tail;              /* attach new cells here             */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
+struct sockaddr_in client;             /* peer address                      */
+socklen_t length;                      /* length of peer address            */
+struct pollfd server_poll;             /* wait for connections              */
+int count;                             /* connections accepted              */
+int fd;                                /* accepted connection               */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
+      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
+   if (file_ptr->f_mode != TCP_SERVER)
+      abend(SETL_SYSTEM
+            "Attempt to accept on file not opened for SOCKET-SERVER:\nFile => %s",
+            file_ptr->f_file_name);
 
-   }
+   count = 0;
+   while (count < limit) {
 
-   /* if we can't get to a leaf, there is no matching element */
+      length = sizeof(client);
+      fd = accept(file_ptr->f_file_fd,(struct sockaddr *)&client,&length);
 
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
+      if (fd >= 0) {
 
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
+         fcntl(fd,F_SETFL,fcntl(fd,F_GETFL) & ~O_NONBLOCK);
 
-   map_index = work_hash_code & MAP_HASH_MASK;
-   map_tail = &(map_work_hdr->m_child[map_index].m_cell);
-   for (map_cell = *map_tail;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next) {
+         names[count] = (char *)malloc((size_t)(INET_ADDRSTRLEN + 8));
+         if (names[count] == NULL)
+            giveup(SETL_SYSTEM msg_malloc_error);
+         sprintf(names[count],"%s:%d",
+                 inet_ntoa(client.sin_addr),(int)ntohs(client.sin_port));
+         fds[count++] = fd;
+         continue;
 
-      map_tail = &(map_cell->m_next);
+      }
 
-   }
+      /* a connection may be reset before we accept it */
 
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
+      if (errno == EINTR || errno == ECONNABORTED)
+         continue;
 
-   /* save file pointer then remove cell */
+      if ((errno != EAGAIN && errno != EWOULDBLOCK) || count > 0)
+         break;
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
-   file_map->m_ntype.m_root.m_cardinality--;
-   file_map->m_ntype.m_root.m_cell_count--;
-   file_map->m_hash_code ^= argv[0].sp_val.sp_atom_num;
-   *map_tail = map_cell->m_next;
-   free_map_cell(map_cell);
+      /* nothing pending, so we wait */
 
-   /* close the file */
+#ifdef PROCESSES
+      if (reactor_park(SETL_SYSTEM file_ptr->f_file_fd,-1L,redo,argc,argv))
+         return -1;
+#endif
 
-   switch (file_ptr->f_mode) {
+      server_poll.fd = file_ptr->f_file_fd;
+      server_poll.events = POLLIN;
+      poll(&server_poll,(nfds_t)1,-1);
 
-      case TEXT_IN :
+   }
 
-         free(file_ptr->f_file_buffer);
-         fclose(file_ptr->f_file_stream);
-         break;
+   return count;
 
-      case TEXT_OUT :
+}
 
-         fclose(file_ptr->f_file_stream);
-         break;
+/*\
+ *  \function{enter\_socket()}
+ *
+ *  This function makes an accepted connection a TCP file, like a client
+ *  socket, and returns its handle.
+\*/
 
-      case BYTE_IN :
+static void enter_socket(
+   SETL_SYSTEM_PROTO
+   int fd,                             /* connection descriptor             */
+   char *name,                         /* peer name                         */
+   specifier *target)                  /* returned handle                   */
 
-         fclose(file_ptr->f_file_stream);
-         break;
+{
+specifier file_atom;                   /* file handle atom                  */
+int is_new;                            /* YES if a cell was added           */
+map_c_ptr_type new_cell;               /* created cell node                 */
 
-      case BINARY_IN :
+   get_file(file_ptr);
 
-         fclose(file_ptr->f_file_stream);
-         break;
+   file_ptr->f_type = 1;
+   file_ptr->f_flag = 0;
+   file_ptr->f_mode = TCP;
+   strcpy(file_ptr->f_file_name,name);
+   file_ptr->f_file_fd = fd;
+   file_ptr->f_file_stream = NULL;
 
-      case BINARY_OUT :
+   file_ptr->f_file_buffer = (unsigned char *)malloc(
+                            (size_t)(FILE_BUFF_SIZE + MAX_LOOKAHEAD + 1));
+   if (file_ptr->f_file_buffer == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-         fclose(file_ptr->f_file_stream);
-         break;
+   file_ptr->f_start = file_ptr->f_endofbuffer = file_ptr->f_file_buffer;
+   file_ptr->f_eof_ptr = NULL;
 
-      case RANDOM :
+   /* enter the file in the file map */
 
-         fclose(file_ptr->f_file_stream);
-         break;
+   spec_set_form(&file_atom,ft_omega);
+   setl2_newat(SETL_SYSTEM 0,NULL,&file_atom);
 
-      case TCP :
+   new_cell = map_locate(&(file_map->m_trie),
+                         &file_atom,
+                         spec_val(&file_atom,sp_atom_num),
+                         &is_new);
 
-         close(file_ptr->f_file_fd);
-	 break;
+   spec_set_form(&new_cell->m_domain_spec,ft_atom);
+   spec_set_val(&new_cell->m_domain_spec,sp_atom_num,
+                spec_val(&file_atom,sp_atom_num));
+   spec_set_form(&new_cell->m_range_spec,ft_file);
+   spec_set_val(&new_cell->m_range_spec,sp_file_ptr,file_ptr);
+   new_cell->m_is_multi_val = NO;
+   file_map->m_cardinality++;
+   file_map->m_cell_count++;
+   file_map->m_hash_code ^= spec_val(&file_atom,sp_atom_num);
 
-#ifdef TRAPS
+   spec_set_form(target,ft_atom);
+   spec_set_val(target,sp_atom_num,spec_val(&file_atom,sp_atom_num));
 
-      default :
+   return;
 
-         trap(__FILE__,__LINE__,"Invalid file mode => %d",file_ptr->f_mode);
+}
 
 #endif
 
-   }
+/*\
+ *  \function{setl2\_socket\_accept()}
+ *
+ *  This function accepts one connection on a server socket, and returns
+ *  its file handle, or OM if the accept fails.  If no connection is
+ *  pending the process waits for one, and other processes keep running.
+\*/
 
-   /* we're done with the file pointer */
+void setl2_socket_accept(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (one here)        */
+   specifier *target)                  /* return value                      */
 
-   free_file(file_ptr);
+{
+#ifdef HAVE_SYS_SOCKET_H
+int fd;                                /* accepted connection               */
+char *name;                            /* peer name                         */
 
-   /* return omega */
+   name = NULL;
+   if (accept_sockets(SETL_SYSTEM argc,argv,setl2_socket_accept,1,
+                      &fd,&name) < 0)
+      return;
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
+
+   if (name != NULL) {
+      enter_socket(SETL_SYSTEM fd,name,target);
+      free(name);
+   }
 
    return;
 
+#endif
 }
 
 /*\
- *  \function{setl2\_get()}
+ *  \function{setl2\_socket\_accept\_all()}
  *
- *  This function reads one line from standard input.  It uses the same
- *  mechanism as the read procedures, but simply reads entire lines into
- *  character strings.
+ *  This function accepts every pending connection on a server socket, up
+ *  to a batch limit, and returns a tuple of file handles.  If none are
+ *  pending the process waits for at least one.  A server under load
+ *  takes a whole batch per wake-up, rather than one.
 \*/
 
-void setl2_get(
-   SETL_SYSTEM_PROTO 
+void setl2_socket_accept_all(
+   SETL_SYSTEM_PROTO
    int argc,                           /* number of arguments passed        */
-   specifier *argv,                    /* argument vector (none here)       */
+   specifier *argv,                    /* argument vector (one here)        */
    specifier *target)                  /* return value                      */
 
 {
-string_h_ptr_type string_hdr;          /* created string header             */
-string_c_ptr_type string_cell;         /* current string cell               */
-char *string_char, *string_end;        /* string character pointers         */
+#ifdef HAVE_SYS_SOCKET_H
+int fds[ACCEPT_BATCH];                 /* accepted connections              */
+char *names[ACCEPT_BATCH];             /* peer names                        */
+tuple_h_ptr_type target_root;          /* root of returned tuple            */
+tuple_c_ptr_type tuple_cell;           /* created cell node                 */
+int count;                             /* connections accepted              */
+int i;                                 /* temporary looping variable        */
+
+   count = accept_sockets(SETL_SYSTEM argc,argv,setl2_socket_accept_all,
+                          ACCEPT_BATCH,fds,names);
+   if (count < 0)
+      return;
+
+   target_root = new_tuple(SETL_SYSTEM_VOID);
+   reserve_tuple(target_root,count);
+   target_root->t_length = count;
+
+   for (i = 0; i < count; i++) {
+
+      tuple_cell = target_root->t_cells + i;
+      enter_socket(SETL_SYSTEM fds[i],names[i],&tuple_cell->t_spec);
+      free(names[i]);
+      spec_hash_code(tuple_cell->t_hash_code,&tuple_cell->t_spec);
+      target_root->t_hash_code ^= tuple_cell->t_hash_code;
+
+   }
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,target_root);
+
+   return;
+
+#endif
+}
+
+/*\
+ *  \function{setl2\_open()}
+ *
+ *  This function opens a file and returns a file handle.  The handle is
+ *  an atom which must be used in other procedure calls to identify the
+ *  file being accessed.
+\*/
+
+void setl2_open(
+   SETL_SYSTEM_PROTO 
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (two here)        */
+   specifier *target)                  /* return value                      */
+
+{
+string_h_ptr_type string_hdr;          /* string root                       */
+char mode_string[30];                  /* mode (character string)           */
+char file_name[PATH_LENGTH*2 + 1];     /* file name                         */
+char *s, *t, *q;                       /* temporary looping variables       */
+int i;                                 /* temporary looping variable        */
+
+   
+   /* convert the file name to a C character string */
+   if ((argc==1)&&(SAFE_MODE==0))  {
+      setl2_newopen(SETL_SYSTEM argc,argv,target);
+      return;
+   }
+   if (argc!=2)
+      abend(SETL_SYSTEM msg_wrong_parms);
+
+   if (spec_form(&argv[0]) != ft_string)
+      abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
+
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
+
+   if (((SAFE_MODE==1)&&(string_hdr->s_length!=5))||
+       (string_hdr->s_length > PATH_LENGTH))
+      abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
+
+   q = t = file_name;
+   *file_name=0;
+   if (SAFE_MODE==1) {
+	if (SAFE_PREFIX!=NULL) {
+		strcpy(file_name,SAFE_PREFIX);
+	 	t+=strlen(file_name);
+		*t='/';t++;
+		q=t;
+	}
+   }
+   memcpy((void *)t,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
+
+   if ((SAFE_MODE==1)&&
+	((strncmp(q,"File",4)!=0)||(*(q+4)<'1')||(*(q+4)>'5')))
+      abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
+
+   /* convert the file mode to a C character string */
+
+   if (spec_form(&argv[1]) != ft_string)
+      abend(SETL_SYSTEM msg_bad_file_mode,abend_opnd_str(SETL_SYSTEM argv+1));
+
+   string_hdr = spec_val(&argv[1],sp_string_ptr);
+
+   if (string_hdr->s_length > 30)
+      abend(SETL_SYSTEM msg_bad_file_mode,abend_opnd_str(SETL_SYSTEM argv+1));
+
+   for (s = string_hdr->s_chars, t = mode_string;
+        t < mode_string + string_hdr->s_length;
+        s++, t++) {
+
+      if (isupper(*s))
+         *t = tolower(*s);
+      else
+         *t = *s;
+
+   }
+   *t = '\0';
+
+
+   setl2_internal_open(SETL_SYSTEM 0,target,mode_string,file_name);
+
+}
+
+/*\
+ *  \function{setl2\_close()}
+ *
+ *  This function closes a file opened with the \verb"open()" function
+ *  above.
+\*/
+
+void setl2_close(
+   SETL_SYSTEM_PROTO 
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (one here)        */
+   specifier *target)                  /* return value                      */
+
+{
+map_c_ptr_type map_cell;               /* current cell pointer              */
+
+   /* file handles must be atoms */
+
+   if (spec_form(&argv[0]) != ft_atom)
+      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
+
+   /* look up the map component, and remove it */
+
+   map_cell = map_unlink(&(file_map->m_trie),
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
+      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
+
+   /* save file pointer then release cell */
+
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
+   file_map->m_cardinality--;
+   file_map->m_cell_count--;
+   file_map->m_hash_code ^= spec_val(&argv[0],sp_atom_num);
+   free_map_cell(map_cell);
+
+   /* close the file */
+
+   switch (file_ptr->f_mode) {
+
+      case TEXT_IN :
+
+         free(file_ptr->f_file_buffer);
+         fclose(file_ptr->f_file_stream);
+         break;
+
+      case TEXT_OUT :
+
+         fclose(file_ptr->f_file_stream);
+         break;
+
+      case BYTE_IN :
+
+         free(file_ptr->f_file_buffer);
+         fclose(file_ptr->f_file_stream);
+         break;
+
+      case BINARY_IN :
+
+         fclose(file_ptr->f_file_stream);
+         break;
+
+      case BINARY_OUT :
+
+         fclose(file_ptr->f_file_stream);
+         break;
+
+      case RANDOM :
+
+         fclose(file_ptr->f_file_stream);
+         break;
+
+      case TCP :
+
+         free(file_ptr->f_file_buffer);
+         close(file_ptr->f_file_fd);
+	 break;
+
+      case TCP_SERVER :
+
+         close(file_ptr->f_file_fd);
+         break;
+
+#ifdef TRAPS
+
+      default :
+
+         trap(__FILE__,__LINE__,"Invalid file mode => %d",file_ptr->f_mode);
+
+#endif
+
+   }
+
+   /* we're done with the file pointer */
+
+   free_file(file_ptr);
+
+   /* return omega */
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_omega);
+
+   return;
+
+}
+
+/*\
+ *  \function{setl2\_get()}
+ *
+ *  This function reads one line from standard input.  It uses the same
+ *  mechanism as the read procedures, but simply reads entire lines into
+ *  character strings.
+\*/
+
+void setl2_get(
+   SETL_SYSTEM_PROTO 
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (none here)       */
+   specifier *target)                  /* return value                      */
+
+{
+string_h_ptr_type string_hdr;          /* created string header             */
 
    /* load file stuff from standard input node */
 
@@ -1303,7 +1544,7 @@ char *string_char, *string_end;        /* string character pointers         */
          eof_flag = YES;
          lookahead = start;
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
 
          push_pstack(target);
          continue;
@@ -1312,12 +1553,7 @@ char *string_char, *string_end;        /* string character pointers         */
 
       /* initialize the return string */
 
-      get_string_header(string_hdr);
-      string_hdr->s_use_count = 1;
-      string_hdr->s_hash_code = -1;
-      string_hdr->s_length = 0;
-      string_hdr->s_head = string_hdr->s_tail = string_cell = NULL;
-      string_char = string_end = NULL;
+      string_hdr = new_string_buffer(SETL_SYSTEM 0);
 
       /* copy each character of the string */
 
@@ -1326,23 +1562,7 @@ char *string_char, *string_end;        /* string character pointers         */
 
          start = lookahead;
 
-         if (string_char == string_end) {
-
-            get_string_cell(string_cell);
-            if (string_hdr->s_tail != NULL)
-               (string_hdr->s_tail)->s_next = string_cell;
-            string_cell->s_prev = string_hdr->s_tail;
-            string_cell->s_next = NULL;
-            string_hdr->s_tail = string_cell;
-            if (string_hdr->s_head == NULL)
-               string_hdr->s_head = string_cell;
-            string_char = string_cell->s_cell_value;
-            string_end = string_char + STR_CELL_WIDTH;
-
-         }
-
-         *string_char++ = *lookahead;
-         string_hdr->s_length++;
+         append_string_char(string_hdr,*lookahead);
 
          advance_la;
 
@@ -1367,8 +1587,8 @@ char *string_char, *string_end;        /* string character pointers         */
       /* set and push the target */
 
       unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = string_hdr;
+      spec_set_form(target,ft_string);
+      spec_set_val(target,sp_string_ptr,string_hdr);
 
       push_pstack(target);
 
@@ -1377,7 +1597,7 @@ char *string_char, *string_end;        /* string character pointers         */
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -1397,62 +1617,40 @@ void setl2_geta(
    specifier *target)                  /* return value                      */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 string_h_ptr_type string_hdr;          /* created string header             */
-string_c_ptr_type string_cell;         /* current string cell               */
-char *string_char, *string_end;        /* string character pointers         */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
+      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
-   /* if we can't get to a leaf, there is no matching element */
+   /* load file stuff from file node */
 
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
+   if ((file_ptr->f_mode != TEXT_IN)&&(file_ptr->f_mode != TCP))
+      abend(SETL_SYSTEM msg_get_not_text,file_ptr->f_file_name);
 
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
+#if defined(PROCESSES) && defined(HAVE_SYS_SOCKET_H)
 
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
+   /* if the lines haven't arrived, let other processes run meanwhile */
 
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
+   if (file_ptr->f_mode == TCP && argc > 1 &&
+       !socket_lines_ready(SETL_SYSTEM file_ptr,argc - 1) &&
+       reactor_park(SETL_SYSTEM file_ptr->f_file_fd,-1L,setl2_geta,
+                    argc,argv))
+      return;
 
-   /* load file stuff from file node */
+#endif
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
-   if ((file_ptr->f_mode != TEXT_IN)&&(file_ptr->f_mode != TCP))
-      abend(SETL_SYSTEM msg_get_not_text,file_ptr->f_file_name);
    file_name = file_ptr->f_file_name;
    file_stream = file_ptr->f_file_stream;
    file_fd = file_ptr->f_file_fd;
@@ -1474,7 +1672,7 @@ char *string_char, *string_end;        /* string character pointers         */
          eof_flag = YES;
          lookahead = start;
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
 
          push_pstack(target);
          continue;
@@ -1483,12 +1681,7 @@ char *string_char, *string_end;        /* string character pointers         */
 
       /* initialize the return string */
 
-      get_string_header(string_hdr);
-      string_hdr->s_use_count = 1;
-      string_hdr->s_hash_code = -1;
-      string_hdr->s_length = 0;
-      string_hdr->s_head = string_hdr->s_tail = string_cell = NULL;
-      string_char = string_end = NULL;
+      string_hdr = new_string_buffer(SETL_SYSTEM 0);
 
       /* copy each character of the string */
 
@@ -1497,23 +1690,7 @@ char *string_char, *string_end;        /* string character pointers         */
 
          start = lookahead;
 
-         if (string_char == string_end) {
-
-            get_string_cell(string_cell);
-            if (string_hdr->s_tail != NULL)
-               (string_hdr->s_tail)->s_next = string_cell;
-            string_cell->s_prev = string_hdr->s_tail;
-            string_cell->s_next = NULL;
-            string_hdr->s_tail = string_cell;
-            if (string_hdr->s_head == NULL)
-               string_hdr->s_head = string_cell;
-            string_char = string_cell->s_cell_value;
-            string_end = string_char + STR_CELL_WIDTH;
-
-         }
-
-         *string_char++ = *lookahead;
-         string_hdr->s_length++;
+         append_string_char(string_hdr,*lookahead);
 
          advance_la;
 
@@ -1538,8 +1715,8 @@ char *string_char, *string_end;        /* string character pointers         */
       /* set and push the target */
 
       unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = string_hdr;
+      spec_set_form(target,ft_string);
+      spec_set_val(target,sp_string_ptr,string_hdr);
 
       push_pstack(target);
 
@@ -1548,7 +1725,7 @@ char *string_char, *string_end;        /* string character pointers         */
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -1604,7 +1781,7 @@ int return_code;                       /* read_spec return code             */
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -1625,59 +1802,42 @@ void setl2_reada(
 
 {
 int return_code;                       /* read_spec return code             */
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
+      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
-   }
+   /* load file stuff from file node */
 
-   /* if we can't get to a leaf, there is no matching element */
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
+   if ((file_ptr->f_mode != TEXT_IN)&&(file_ptr->f_mode != TCP))
+      abend(SETL_SYSTEM msg_read_not_text,file_ptr->f_file_name);
 
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
+#if defined(PROCESSES) && defined(HAVE_SYS_SOCKET_H)
 
    /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
+    *  We can't tell where a value ends without reading it, so we wait
+    *  for a line per value.
     */
 
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
+   if (file_ptr->f_mode == TCP && argc > 1 &&
+       !socket_lines_ready(SETL_SYSTEM file_ptr,argc - 1) &&
+       reactor_park(SETL_SYSTEM file_ptr->f_file_fd,-1L,setl2_reada,
+                    argc,argv))
+      return;
 
-   /* load file stuff from file node */
+#endif
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
-   if ((file_ptr->f_mode != TEXT_IN)&&(file_ptr->f_mode != TCP))
-      abend(SETL_SYSTEM msg_read_not_text,file_ptr->f_file_name);
    file_name = file_ptr->f_file_name;
    file_stream = file_ptr->f_file_stream;
    file_fd = file_ptr->f_file_fd;
@@ -1709,7 +1869,7 @@ int32 work_hash_code;                  /* working hash code (destroyed)     */
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -1731,15 +1891,12 @@ void setl2_reads(
 {
 int return_code;                       /* read_spec return code             */
 string_h_ptr_type target_hdr;          /* tail string                       */
-string_c_ptr_type target_cell;         /* tail cell                         */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
 int32 tail_pstack_top;                 /* stack position of string tail     */
 int save_eof_flag;                     /* reads destroys eof_flag           */
 
    /* make sure the argument is a string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"reads",
             abend_opnd_str(SETL_SYSTEM argv));
 
@@ -1756,20 +1913,13 @@ int save_eof_flag;                     /* reads destroys eof_flag           */
 
    /* load input string */
 
-   reads_length = argv[0].sp_val.sp_string_ptr->s_length;
-   reads_cell = argv[0].sp_val.sp_string_ptr->s_head;
-   if (reads_cell == NULL) {
-      reads_char_ptr = reads_char_end = NULL;
-   }
-   else {
-      reads_char_ptr = reads_cell->s_cell_value;
-      reads_char_end = reads_char_ptr + STR_CELL_WIDTH;
-   }
+   reads_length = spec_val(&argv[0],sp_string_ptr)->s_length;
+   reads_char_ptr = spec_val(&argv[0],sp_string_ptr)->s_chars;
 
    /* save a position for the string tail */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    push_pstack(target);
    tail_pstack_top = pstack_top;
 
@@ -1788,12 +1938,7 @@ int save_eof_flag;                     /* reads destroys eof_flag           */
 
    /* make a target string */
 
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = 0;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
+   target_hdr = new_string_buffer(SETL_SYSTEM 0);
 
    /* copy the rest of the input string */
 
@@ -1801,35 +1946,19 @@ int save_eof_flag;                     /* reads destroys eof_flag           */
    advance_la;
    while (lookahead != eof_ptr) {
 
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *lookahead;
-      target_hdr->s_length++;
+      append_string_char(target_hdr,*lookahead);
       start = lookahead;
       advance_la;
 
    }
 
-   pstack[tail_pstack_top].sp_form = ft_string;
-   pstack[tail_pstack_top].sp_val.sp_string_ptr = target_hdr;
+   spec_set_form(&pstack[tail_pstack_top],ft_string);
+   spec_set_val(&pstack[tail_pstack_top],sp_string_ptr,target_hdr);
 
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    eof_flag = save_eof_flag;
 
    return;
@@ -1854,7 +1983,7 @@ int return_code;                       /* read_spec return code             */
 
    /* make sure the argument is a string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"unstr",
             abend_opnd_str(SETL_SYSTEM argv));
 
@@ -1867,15 +1996,8 @@ int return_code;                       /* read_spec return code             */
 
    /* load input string */
 
-   reads_length = argv[0].sp_val.sp_string_ptr->s_length;
-   reads_cell = argv[0].sp_val.sp_string_ptr->s_head;
-   if (reads_cell == NULL) {
-      reads_char_ptr = reads_char_end = NULL;
-   }
-   else {
-      reads_char_ptr = reads_cell->s_cell_value;
-      reads_char_end = reads_char_ptr + STR_CELL_WIDTH;
-   }
+   reads_length = spec_val(&argv[0],sp_string_ptr)->s_length;
+   reads_char_ptr = spec_val(&argv[0],sp_string_ptr)->s_chars;
 
    /* read the value */
 
@@ -1939,7 +2061,7 @@ int found_comma = NO;                  /* YES if we've already seen a comma */
          /* we return omega on end of file */
 
          unmark_specifier(spec);
-         spec->sp_form = ft_omega;
+         spec_set_form(spec,ft_omega);
 
          return ENDOFFILE;
 
@@ -1984,17 +2106,11 @@ case 'V': case 'W': case 'X': case 'Y': case 'Z':
 
 {
 string_h_ptr_type string_hdr;          /* created string header             */
-string_c_ptr_type string_cell;         /* current string cell               */
 char *string_char, *string_end;        /* string character pointers         */
 
    /* initialize the return string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = string_cell = NULL;
-   string_char = string_end = NULL;
+   string_hdr = new_string_buffer(SETL_SYSTEM 0);
 
    /* copy each character of the string */
 
@@ -2002,23 +2118,7 @@ char *string_char, *string_end;        /* string character pointers         */
 
       start = lookahead;
 
-      if (string_char == string_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char = string_cell->s_cell_value;
-         string_end = string_char + STR_CELL_WIDTH;
-
-      }
-
-      *string_char++ = *lookahead;
-      string_hdr->s_length++;
+      append_string_char(string_hdr,*lookahead);
 
       advance_la;
 
@@ -2028,7 +2128,7 @@ char *string_char, *string_end;        /* string character pointers         */
 
    if (string_hdr->s_length == 2) {
 
-      for (string_char = (string_hdr->s_head)->s_cell_value,
+      for (string_char = string_hdr->s_chars,
               string_end = "om";
            *string_end;
            string_char++, string_end++) {
@@ -2047,7 +2147,7 @@ char *string_char, *string_end;        /* string character pointers         */
 
          free_string(SETL_SYSTEM string_hdr);
          unmark_specifier(spec);
-         spec->sp_form = ft_omega;
+         spec_set_form(spec,ft_omega);
 
          return SPEC;
 
@@ -2055,7 +2155,7 @@ char *string_char, *string_end;        /* string character pointers         */
    }
    if (string_hdr->s_length == 4) {
 
-      for (string_char = (string_hdr->s_head)->s_cell_value,
+      for (string_char = string_hdr->s_chars,
               string_end = "true";
            *string_end;
            string_char++, string_end++) {
@@ -2074,8 +2174,8 @@ char *string_char, *string_end;        /* string character pointers         */
 
          free_string(SETL_SYSTEM string_hdr);
          unmark_specifier(spec);
-         spec->sp_form = ft_atom;
-         spec->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+         spec_set_form(spec,ft_atom);
+         spec_set_val(spec,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
          return SPEC;
 
@@ -2083,7 +2183,7 @@ char *string_char, *string_end;        /* string character pointers         */
    }
    else if (string_hdr->s_length == 5) {
 
-      for (string_char = (string_hdr->s_head)->s_cell_value,
+      for (string_char = string_hdr->s_chars,
               string_end = "false";
            *string_end;
            string_char++, string_end++) {
@@ -2102,8 +2202,8 @@ char *string_char, *string_end;        /* string character pointers         */
 
          free_string(SETL_SYSTEM string_hdr);
          unmark_specifier(spec);
-         spec->sp_form = ft_atom;
-         spec->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+         spec_set_form(spec,ft_atom);
+         spec_set_val(spec,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
          return SPEC;
 
@@ -2113,8 +2213,8 @@ char *string_char, *string_end;        /* string character pointers         */
    /* set the target and return */
 
    unmark_specifier(spec);
-   spec->sp_form = ft_string;
-   spec->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(spec,ft_string);
+   spec_set_val(spec,sp_string_ptr,string_hdr);
 
    return SPEC;
 
@@ -2133,17 +2233,10 @@ case '\"' :
 
 {
 string_h_ptr_type string_hdr;          /* created string header             */
-string_c_ptr_type string_cell;         /* current string cell               */
-char *string_char, *string_end;        /* string character pointers         */
 
    /* initialize the return string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = string_cell = NULL;
-   string_char = string_end = NULL;
+   string_hdr = new_string_buffer(SETL_SYSTEM 0);
 
    /* advance past the opening quote */
 
@@ -2170,23 +2263,6 @@ char *string_char, *string_end;        /* string character pointers         */
 
       }
 
-      /* expand the string structure if necessary */
-
-      if (string_char == string_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char = string_cell->s_cell_value;
-         string_end = string_char + STR_CELL_WIDTH;
-
-      }
-
       /* check escape sequences */
 
       if (*lookahead == '\\') {
@@ -2198,50 +2274,43 @@ char *string_char, *string_end;        /* string character pointers         */
 
             case '\\' :
 
-               *string_char++ = '\\';
-               string_hdr->s_length++;
+               append_string_char(string_hdr,'\\');
 
                break;
 
             case '0' :
 
-               *string_char++ = '\0';
-               string_hdr->s_length++;
+               append_string_char(string_hdr,'\0');
 
                break;
 
             case 'n' :
 
-               *string_char++ = '\n';
-               string_hdr->s_length++;
+               append_string_char(string_hdr,'\n');
 
                break;
 
             case 'r' :
 
-               *string_char++ = '\r';
-               string_hdr->s_length++;
+               append_string_char(string_hdr,'\r');
 
                break;
 
             case 'f' :
 
-               *string_char++ = '\f';
-               string_hdr->s_length++;
+               append_string_char(string_hdr,'\f');
 
                break;
 
             case 't' :
 
-               *string_char++ = '\t';
-               string_hdr->s_length++;
+               append_string_char(string_hdr,'\t');
 
                break;
 
             case '\"' :
 
-               *string_char++ = '\"';
-               string_hdr->s_length++;
+               append_string_char(string_hdr,'\"');
 
                break;
 
@@ -2259,9 +2328,9 @@ char *string_char, *string_end;        /* string character pointers         */
 
                }
 
-               *string_char++ = numeric_val(*(lookahead-1)) * 16 +
-                                numeric_val(*lookahead);
-               string_hdr->s_length++;
+               append_string_char(string_hdr,
+                                 numeric_val(*(lookahead-1)) * 16 +
+                                 numeric_val(*lookahead));
 
                break;
 
@@ -2278,8 +2347,7 @@ char *string_char, *string_end;        /* string character pointers         */
 
       }
 
-      *string_char++ = *lookahead;
-      string_hdr->s_length++;
+      append_string_char(string_hdr,*lookahead);
 
       advance_la;
 
@@ -2288,8 +2356,8 @@ char *string_char, *string_end;        /* string character pointers         */
    /* set the target and return */
 
    unmark_specifier(spec);
-   spec->sp_form = ft_string;
-   spec->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(spec,ft_string);
+   spec_set_val(spec,sp_string_ptr,string_hdr);
 
    return SPEC;
 
@@ -2318,15 +2386,18 @@ int32 max_multiplier;                  /* maximum value we can multiply     */
                                        /* by cell                           */
 int32 multiplier;                      /* actual value we multiply by cell  */
 int32 addend;                          /* amount to add to next cell        */
-int32 hi_bits;                         /* high order bits of short integer  */
+char *digit_values;                    /* digits of a long whole part       */
+int32 digit_count;                     /* number of digits in digit_values  */
+int32 digit_max;                       /* size of digit_values              */
+int32 i;                               /* temporary looping variable        */
 integer_h_ptr_type integer_hdr;        /* root integer pointer              */
-integer_c_ptr_type integer_cell;       /* integer cell pointer              */
+specifier integer_spec;                /* long integer, as a specifier      */
 double whole_part;                     /* whole part of real                */
 double decimal_part;                   /* fraction part of real             */
 double decimal_divisor;                /* decimal divisor                   */
 int exponent_sign;                     /* 1 => positive exponent, -1 o/w    */
 int exponent;                          /* exponent value                    */
-i_real_ptr_type real_ptr;              /* real node pointer                 */
+double real_number;                    /* value of real                     */
 
    /* take care of the sign if we have one */
 
@@ -2404,92 +2475,82 @@ i_real_ptr_type real_ptr;              /* real node pointer                 */
 
    max_multiplier = MAX_INT_CELL / base;
 
-   /* loop over the whole part */
-
-   integer_hdr = NULL;
-   for (;;) {
-
-      /* pick out as many digits as we can handle */
+   /* pick out as many digits of the whole part as fit in a short */
 
-      while ((is_digit(*lookahead,base) || *lookahead == '_') &&
-             multiplier < max_multiplier) {
+   while ((is_digit(*lookahead,base) || *lookahead == '_') &&
+          multiplier < max_multiplier) {
 
-         start = lookahead;
-
-         if (*lookahead == '_') {
+      start = lookahead;
 
-            advance_la;
+      if (*lookahead == '_') {
 
-            continue;
+         advance_la;
 
-         }
+         continue;
 
-         addend = addend * base + numeric_val(*lookahead);
-         multiplier = multiplier * base;
+      }
 
-         advance_la;
+      addend = addend * base + numeric_val(*lookahead);
+      multiplier = multiplier * base;
 
-      }
+      advance_la;
 
-      /* if we've reached the end of the whole part, break */
+   }
 
-      if (!is_digit(*lookahead,base) && *lookahead != '_' &&
-          integer_hdr == NULL)
-         break;
+   /*
+    *  If there are more digits we have a long integer.  We collect the
+    *  digit values, starting with those of the value so far, and convert
+    *  them all at once.  That is much faster for very long numbers than
+    *  shifting a few digits at a time into the integer.
+    */
 
-      if (integer_hdr == NULL) {
+   integer_hdr = NULL;
+   if (is_digit(*lookahead,base) || *lookahead == '_') {
 
-         get_integer_header(integer_hdr);
-         integer_hdr->i_use_count = 1;
-         integer_hdr->i_hash_code = -1;
-         integer_hdr->i_cell_count = 1;
-         integer_hdr->i_is_negative = NO;
+      digit_max = DIGIT_BUFFER_SIZE;
+      digit_values = (char *)malloc((size_t)digit_max);
+      if (digit_values == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-         get_integer_cell(integer_cell);
-         integer_cell->i_cell_value = addend;
-         integer_cell->i_next = integer_cell->i_prev = NULL;
-         integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
+      digit_count = 0;
+      for (i = addend; i > 0; i /= base)
+         digit_count++;
+      for (i = digit_count - 1; i >= 0; i--) {
+         digit_values[i] = (char)(addend % base);
+         addend /= base;
+      }
 
-         addend = 0;
-         multiplier = 1;
+      while (is_digit(*lookahead,base) || *lookahead == '_') {
 
-         continue;
+         start = lookahead;
 
-      }
+         if (*lookahead == '_') {
 
-      /* traverse the list, updating each cell */
+            advance_la;
 
-      for (integer_cell = integer_hdr->i_head;
-           integer_cell != NULL || addend != 0;
-           integer_cell = integer_cell->i_next) {
+            continue;
 
-         /* if the next pointer is null, extend the list */
+         }
 
-         if (integer_cell == NULL) {
+         if (digit_count == digit_max) {
 
-            get_integer_cell(integer_cell);
-            (integer_hdr->i_tail)->i_next = integer_cell;
-            integer_cell->i_prev = integer_hdr->i_tail;
-            integer_hdr->i_tail = integer_cell;
-            integer_cell->i_next = NULL;
-            integer_hdr->i_cell_count++;
-            integer_cell->i_cell_value = 0;
+            digit_max *= 2;
+            digit_values = (char *)realloc((void *)digit_values,
+                                           (size_t)digit_max);
+            if (digit_values == NULL)
+               giveup(SETL_SYSTEM msg_malloc_error);
 
          }
 
-         /* update the cell */
+         digit_values[digit_count++] = (char)numeric_val(*lookahead);
 
-         addend = integer_cell->i_cell_value * multiplier + addend;
-         integer_cell->i_cell_value = addend & MAX_INT_CELL;
-         addend >>= INT_CELL_WIDTH;
+         advance_la;
 
       }
 
-      if (!is_digit(*lookahead,base) && *lookahead != '_')
-         break;
-
-      addend = 0;
-      multiplier = 1;
+      integer_hdr = integer_from_digits(SETL_SYSTEM digit_values,
+                                        digit_count,base);
+      free((void *)digit_values);
 
    }
 
@@ -2516,16 +2577,10 @@ i_real_ptr_type real_ptr;              /* real node pointer                 */
          }
          else {
 
-            whole_part = 0.0;
-
-            for (integer_cell = integer_hdr->i_tail;
-                 integer_cell != NULL;
-                 integer_cell = integer_cell->i_prev) {
-
-               whole_part = whole_part * (double)(MAX_INT_CELL + 1) +
-                            (double)integer_cell->i_cell_value;
+            spec_set_form(&integer_spec,ft_long);
+            spec_set_val(&integer_spec,sp_long_ptr,integer_hdr);
+            whole_part = long_to_double(SETL_SYSTEM &integer_spec);
 
-            }
 	    /* Free the integer */
 
 
@@ -2601,23 +2656,21 @@ i_real_ptr_type real_ptr;              /* real node pointer                 */
             }
          }
 
-         /* allocate and set a real node */
+         /* find the value of the real */
 
-         i_get_real(real_ptr);
-         real_ptr->r_use_count = 1;
-         real_ptr->r_value = (whole_part +
-                             (decimal_part / decimal_divisor)) *
-                             pow((double)base,
-                                 (double)(exponent * exponent_sign));
+         real_number = (whole_part +
+                        (decimal_part / decimal_divisor)) *
+                        pow((double)base,
+                            (double)(exponent * exponent_sign));
 
          if (is_negative)
-            real_ptr->r_value = -real_ptr->r_value;
+            real_number = -real_number;
 
          /* set the target and return */
 
          unmark_specifier(spec);
-         spec->sp_form = ft_real;
-         spec->sp_val.sp_real_ptr = real_ptr;
+         spec_set_form(spec,ft_real);
+         spec_set_val(spec,sp_real_value,real_number);
 
          return SPEC;
 
@@ -2649,12 +2702,11 @@ i_real_ptr_type real_ptr;              /* real node pointer                 */
 
       /* check whether the result remains short */
 
-      if (!(hi_bits = addend & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(addend)) {
 
          unmark_specifier(spec);
-         spec->sp_form = ft_short;
-         spec->sp_val.sp_short_value = addend;
+         spec_set_form(spec,ft_short);
+         spec_set_val(spec,sp_short_value,addend);
 
          return SPEC;
 
@@ -2677,41 +2729,7 @@ i_real_ptr_type real_ptr;              /* real node pointer                 */
     *  a short.  If so, we convert it.
     */
 
-   if (integer_hdr->i_cell_count < 3) {
-
-      /* build up a long value */
-
-      addend = (integer_hdr->i_head)->i_cell_value;
-      if (integer_hdr->i_cell_count == 2) {
-
-         addend += (((integer_hdr->i_head)->i_next)->i_cell_value) <<
-                    INT_CELL_WIDTH;
-
-      }
-
-      if (integer_hdr->i_is_negative)
-         addend = -addend;
-
-      /* check whether it will fit in a short */
-
-      if (!(hi_bits = addend & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
-
-         free_interp_integer(SETL_SYSTEM integer_hdr);
-         unmark_specifier(spec);
-         spec->sp_form = ft_short;
-         spec->sp_val.sp_short_value = addend;
-
-         return SPEC;
-
-      }
-   }
-
-   /* we couldn't convert to short, so return the long */
-
-   unmark_specifier(spec);
-   spec->sp_form = ft_long;
-   spec->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM spec,integer_hdr);
 
    return SPEC;
 
@@ -2727,20 +2745,11 @@ i_real_ptr_type real_ptr;              /* real node pointer                 */
 case '{' :
 
 {
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int target_height, target_index;       /* current height and index          */
+set_h_ptr_type target_root;            /* root of set                       */
+int is_new;                            /* YES if a cell was added           */
 specifier target_element;              /* set element                       */
 int32 target_hash_code;                /* hash code of target element       */
-set_h_ptr_type new_hdr;                /* created header node               */
 set_c_ptr_type new_cell;               /* created cell node                 */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int is_equal;                          /* YES if two specifiers are equal   */
-int i;                                 /* temporary looping variable        */
 
    /* advance past the opening bracket */
 
@@ -2748,15 +2757,7 @@ int i;                                 /* temporary looping variable        */
 
    /* create a new set for the target */
 
-   get_set_header(target_root);
-   target_root->s_use_count = 1;
-   target_root->s_hash_code = 0;
-   target_root->s_ntype.s_root.s_cardinality = 0;
-   target_root->s_ntype.s_root.s_height = 0;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        target_root->s_child[i++].s_cell = NULL);
-   expansion_trigger = SET_HASH_SIZE * SET_CLASH_SIZE;
+   target_root = null_set(SETL_SYSTEM_VOID);
 
    /* insert elements until we find a right brace */
 
@@ -2764,7 +2765,7 @@ int i;                                 /* temporary looping variable        */
 
       /* get the next spec from the input stream */
 
-      target_element.sp_form = ft_omega;
+      spec_set_form(&target_element,ft_omega);
 
       switch (read_spec(SETL_SYSTEM &target_element)) {
 
@@ -2775,8 +2776,8 @@ int i;                                 /* temporary looping variable        */
          case RBRACE :
 
             unmark_specifier(spec);
-            spec->sp_form = ft_set;
-            spec->sp_val.sp_set_ptr = target_root;
+            spec_set_form(spec,ft_set);
+            spec_set_val(spec,sp_set_ptr,target_root);
 
             return SPEC;
 
@@ -2791,82 +2792,16 @@ int i;                                 /* temporary looping variable        */
        *  the target.
        */
 
-      target_work_hdr = target_root;
-
-      /* get the element's hash code */
-
-      spec_hash_code(work_hash_code,&target_element);
-      target_hash_code = work_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_height = target_root->s_ntype.s_root.s_height;
-      while (target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (target_work_hdr->s_child[target_index].s_header == NULL) {
-
-            get_set_header(new_hdr);
-            new_hdr->s_ntype.s_intern.s_parent = target_work_hdr;
-            new_hdr->s_ntype.s_intern.s_child_index = target_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_hdr->s_child[i++].s_cell = NULL);
-            target_work_hdr->s_child[target_index].s_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->s_child[target_index].s_header;
-
-         }
-      }
-
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  The next problem is to determine if the element is
-       *  already in the set.  We compare the element with the clash
-       *  list.
-       */
-
-      target_index = work_hash_code & SET_HASH_MASK;
-      target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-      for (target_cell = *target_tail;
-           target_cell != NULL &&
-              target_cell->s_hash_code < target_hash_code;
-           target_cell = target_cell->s_next) {
-
-         target_tail = &(target_cell->s_next);
-
-      }
-
-      /* check for a duplicate element */
-
-      is_equal = NO;
-      while (target_cell != NULL &&
-             target_cell->s_hash_code == target_hash_code) {
-
-         spec_equal(is_equal,&(target_cell->s_spec),&target_element);
-
-         if (is_equal)
-            break;
-
-         target_tail = &(target_cell->s_next);
-         target_cell = target_cell->s_next;
-
-      }
+      spec_hash_code(target_hash_code,&target_element);
+      new_cell = set_locate(SETL_SYSTEM &(target_root->s_trie),
+                            &target_element,
+                            target_hash_code,
+                            sizeof(struct set_c_item),
+                            &is_new);
 
       /* if we have a duplicate, unmark it and get the next one */
 
-      if (is_equal) {
+      if (!is_new) {
 
          unmark_specifier(&target_element);
          continue;
@@ -2875,24 +2810,11 @@ int i;                                 /* temporary looping variable        */
 
       /* if we reach this point we didn't find the element, so we insert it */
 
-      get_set_cell(new_cell);
-      new_cell->s_spec.sp_form = target_element.sp_form;
-      new_cell->s_spec.sp_val.sp_biggest =
-         target_element.sp_val.sp_biggest;
-      new_cell->s_hash_code = target_hash_code;
-      new_cell->s_next = *target_tail;
-      *target_tail = new_cell;
-      target_root->s_ntype.s_root.s_cardinality++;
+      spec_set_form(&new_cell->s_spec,spec_form(&target_element));
+      spec_set_val(&new_cell->s_spec,sp_biggest,
+         spec_val(&target_element,sp_biggest));
+      target_root->s_cardinality++;
       target_root->s_hash_code ^= target_hash_code;
-
-      /* expand the set header if necessary */
-
-      if (target_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
-
-         target_root = set_expand_header(SETL_SYSTEM target_root);
-         expansion_trigger *= SET_HASH_SIZE;
-
-      }
    }
 }
 
@@ -2916,15 +2838,9 @@ case '}' :
 case '[' :
 
 {
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-int target_height, target_index;       /* current height and index          */
+tuple_h_ptr_type target_root;          /* root of created tuple             */
+tuple_c_ptr_type target_cell;          /* created cell                      */
 specifier target_element;              /* tuple element                     */
-int32 target_number;                   /* target element number             */
-tuple_h_ptr_type new_hdr;              /* created header node               */
-tuple_c_ptr_type new_cell;             /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
 int i;                                 /* temporary looping variable        */
 
    /* advance past the opening bracket */
@@ -2933,15 +2849,7 @@ int i;                                 /* temporary looping variable        */
 
    /* create a new tuple for the target */
 
-   get_tuple_header(target_root);
-   target_root->t_use_count = 1;
-   target_root->t_hash_code = 0;
-   target_root->t_ntype.t_root.t_length = 0;
-   target_root->t_ntype.t_root.t_height = 0;
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        target_root->t_child[i++].t_cell = NULL);
-   expansion_trigger = TUP_HEADER_SIZE;
+   target_root = new_tuple(SETL_SYSTEM_VOID);
 
    /* insert elements until we find a right brace */
 
@@ -2949,7 +2857,7 @@ int i;                                 /* temporary looping variable        */
 
       /* get the next item from the input stream */
 
-      target_element.sp_form = ft_omega;
+      spec_set_form(&target_element,ft_omega);
 
       i = read_spec(SETL_SYSTEM &target_element);
       if (i == RBRACKET) 
@@ -2957,250 +2865,31 @@ int i;                                 /* temporary looping variable        */
       if (i != SPEC)
          abend(SETL_SYSTEM msg_not_setl_value);
 
-      /*
-       *  At this point we have an element we would like to insert into
-       *  the target.
-       */
-
-      target_number = target_root->t_ntype.t_root.t_length++;
-
-      /* expand the target header if necessary */
-
-      if (target_root->t_ntype.t_root.t_length >= expansion_trigger) {
-
-         target_work_hdr = target_root;
-
-         get_tuple_header(target_root);
-
-         target_root->t_use_count = 1;
-         target_root->t_hash_code =
-               target_work_hdr->t_hash_code;
-         target_root->t_ntype.t_root.t_length =
-               target_work_hdr->t_ntype.t_root.t_length;
-         target_root->t_ntype.t_root.t_height =
-               target_work_hdr->t_ntype.t_root.t_height + 1;
-
-         for (i = 1;
-              i < TUP_HEADER_SIZE;
-              target_root->t_child[i++].t_header = NULL);
-
-         target_root->t_child[0].t_header = target_work_hdr;
-
-         target_work_hdr->t_ntype.t_intern.t_parent = target_root;
-         target_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-         expansion_trigger *= TUP_HEADER_SIZE;
-
-      }
-
-      /* descend the header tree until we get to a leaf */
-
-      target_work_hdr = target_root;
-      for (target_height = target_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
+      /* append the element to the end of the tuple */
 
-            get_tuple_header(new_hdr);
-            new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-            new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_hdr->t_child[i++].t_cell = NULL);
-
-            target_work_hdr->t_child[target_index].t_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->t_child[target_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We insert the new element in the appropriate slot.
-       */
-
-      if (target_element.sp_form == ft_omega)
-         continue;
-      get_tuple_cell(new_cell);
-      new_cell->t_spec.sp_form = target_element.sp_form;
-      new_cell->t_spec.sp_val.sp_biggest =
-         target_element.sp_val.sp_biggest;
-      spec_hash_code(new_cell->t_hash_code,&target_element);
-      target_index = target_number & TUP_SHIFT_MASK;
-      target_work_hdr->t_child[target_index].t_cell = new_cell;
-      target_root->t_hash_code ^= new_cell->t_hash_code;
+      reserve_tuple(target_root,target_root->t_length + 1);
+      target_cell = target_root->t_cells + target_root->t_length++;
+      spec_set_form(&target_cell->t_spec,spec_form(&target_element));
+      spec_set_val(&target_cell->t_spec,sp_biggest,
+         spec_val(&target_element,sp_biggest));
+      spec_hash_code(target_cell->t_hash_code,&target_element);
+      target_root->t_hash_code ^= target_cell->t_hash_code;
 
    }
 
-   /*
-    *  I don't really know why, but someone might just type a bunch of
-    *  OM's at the end of a tuple.  I have to get rid of them.
-    */
-
-   /* if the length is zero, don't try this */
-
-   if (target_root->t_ntype.t_root.t_length == 0) {
-
-      unmark_specifier(spec);
-      spec->sp_form = ft_tuple;
-      spec->sp_val.sp_tuple_ptr = target_root;
-
-      return SPEC;
-
-   }
-
-   /* drop to a leaf at the rightmost position */
-
-   target_number = target_root->t_ntype.t_root.t_length - 1;
-   target_work_hdr = target_root;
-   for (target_height = target_root->t_ntype.t_root.t_height;
-        target_height;
-        target_height--) {
-
-      /* extract the element's index at this level */
-
-      target_index = (target_number >>
-                           (target_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
-
-      /* if we're missing a header record, allocate one */
-
-      if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-         get_tuple_header(new_hdr);
-         new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-         new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-         for (i = 0;
-              i < TUP_HEADER_SIZE;
-              new_hdr->t_child[i++].t_cell = NULL);
-
-         target_work_hdr->t_child[target_index].t_header = new_hdr;
-         target_work_hdr = new_hdr;
-
-      }
-      else {
-
-         target_work_hdr =
-            target_work_hdr->t_child[target_index].t_header;
-
-      }
-   }
-
-   /* set the target index to the last element */
-
-   target_index = target_number & TUP_SHIFT_MASK;
-
-   /* keep stripping omegas */
-
-   for (;;) {
-
-      if (!target_height && target_index >= 0) {
-
-         if (target_work_hdr->t_child[target_index].t_cell != NULL)
-            break;
-
-         target_root->t_ntype.t_root.t_length--;
-         target_index--;
-
-         continue;
-
-      }
-
-      /* move up if we're at the end of a node */
-
-      if (target_index < 0) {
-
-         if (target_work_hdr == target_root)
-            break;
-
-         target_height++;
-         target_index = target_work_hdr->t_ntype.t_intern.t_child_index;
-         target_work_hdr = target_work_hdr->t_ntype.t_intern.t_parent;
-         free_tuple_header(target_work_hdr->t_child[target_index].t_header);
-         target_work_hdr->t_child[target_index].t_header = NULL;
-         target_index--;
-
-         continue;
-
-      }
-
-      /* skip over null nodes */
-
-      if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-         target_root->t_ntype.t_root.t_length -=
-               1L << (target_height * TUP_SHIFT_DIST);
-         target_index--;
-
-         continue;
-
-      }
-
-      /* otherwise drop down a level */
-
-      target_work_hdr =
-         target_work_hdr->t_child[target_index].t_header;
-      target_index = TUP_HEADER_SIZE - 1;
-
-      target_height--;
-
-   }
-
-   /* we've shortened the tuple -- now reduce the height */
-
-   while (target_root->t_ntype.t_root.t_height > 0 &&
-          target_root->t_ntype.t_root.t_length <=
-             (int32)(1L << (target_root->t_ntype.t_root.t_height *
-                           TUP_SHIFT_DIST))) {
-
-      target_work_hdr = target_root->t_child[0].t_header;
-
-      /* it's possible that we deleted internal headers */
-
-      if (target_work_hdr == NULL) {
-
-         target_root->t_ntype.t_root.t_height--;
-         continue;
-
-      }
-
-      /* delete the root node */
-
-      target_work_hdr->t_use_count = target_root->t_use_count;
-      target_work_hdr->t_hash_code =
-            target_root->t_hash_code;
-      target_work_hdr->t_ntype.t_root.t_length =
-            target_root->t_ntype.t_root.t_length;
-      target_work_hdr->t_ntype.t_root.t_height =
-            target_root->t_ntype.t_root.t_height - 1;
-
-      free_tuple_header(target_root);
-      target_root = target_work_hdr;
+   /*
+    *  I don't really know why, but someone might just type a bunch of
+    *  OM's at the end of a tuple.  I have to get rid of them.
+    */
 
-   }
+   trim_tuple(target_root);
+   pack_tuple(SETL_SYSTEM target_root);
 
    /* finally, we set the target value */
 
    unmark_specifier(spec);
-   spec->sp_form = ft_tuple;
-   spec->sp_val.sp_tuple_ptr = target_root;
+   spec_set_form(spec,ft_tuple);
+   spec_set_val(spec,sp_tuple_ptr,target_root);
 
    return SPEC;
 
@@ -3304,14 +2993,6 @@ unsigned char *s,*t;                   /* temporary looping variables       */
       while (reads_length &&
              t < lookahead + FILE_BUFF_SIZE) {
 
-         if (reads_char_ptr == reads_char_end) {
-
-            reads_cell = reads_cell->s_next;
-            reads_char_ptr = reads_cell->s_cell_value;
-            reads_char_end = reads_char_ptr + STR_CELL_WIDTH;
-
-         }
-
          *t++ = *reads_char_ptr++;
          reads_length--;
 
@@ -3425,6 +3106,80 @@ unsigned char *s,*t;                   /* temporary looping variables       */
 
 }
 
+#if defined(PROCESSES) && defined(HAVE_SYS_SOCKET_H)
+
+/*\
+ *  \function{socket\_lines\_ready()}
+ *
+ *  This function returns \verb"YES" if a socket's buffer holds at least
+ *  \verb"lines" complete lines, or the end of file.  Otherwise we read
+ *  whatever has arrived without blocking, and check again.  A line
+ *  longer than the buffer counts as ready, so the caller reads it the
+ *  old way.  Errors count as ready too, so that the read reports them.
+\*/
+
+static int socket_lines_ready(
+   SETL_SYSTEM_PROTO
+   file_ptr_type file_ptr,             /* socket file                       */
+   int lines)                          /* complete lines needed             */
+
+{
+unsigned char *s,*t;                   /* temporary looping variables       */
+int found;                             /* complete lines in buffer          */
+int32 length;                          /* characters in buffer              */
+ssize_t readcount;                     /* number of characters read         */
+
+   for (;;) {
+
+      if (file_ptr->f_eof_ptr != NULL)
+         return YES;
+
+      /* count the line ends after the last character used */
+
+      found = 0;
+      for (s = file_ptr->f_start + 1; s <= file_ptr->f_endofbuffer; s++) {
+         if (*s == '\n' && ++found >= lines)
+            return YES;
+      }
+
+      /* shift the unused characters to the start of the buffer */
+
+      length = file_ptr->f_endofbuffer - file_ptr->f_start + 1;
+      if (file_ptr->f_start != file_ptr->f_file_buffer) {
+
+         for (t = file_ptr->f_file_buffer, s = file_ptr->f_start;
+              s <= file_ptr->f_endofbuffer;
+              *t++ = *s++);
+         file_ptr->f_start = file_ptr->f_file_buffer;
+         file_ptr->f_endofbuffer = file_ptr->f_file_buffer + length - 1;
+
+      }
+
+      if (length >= FILE_BUFF_SIZE)
+         return YES;
+
+      /* read whatever has arrived */
+
+      readcount = recv(file_ptr->f_file_fd,
+                       (void *)(file_ptr->f_endofbuffer + 1),
+                       (size_t)(FILE_BUFF_SIZE - length),
+                       MSG_DONTWAIT);
+
+      if (readcount > 0) {
+         file_ptr->f_endofbuffer += readcount;
+      }
+      else if (readcount == 0) {
+         file_ptr->f_eof_ptr = ++file_ptr->f_endofbuffer;
+         *(file_ptr->f_eof_ptr) = EOFCHAR;
+      }
+      else if (errno != EINTR) {
+         return (errno != EAGAIN && errno != EWOULDBLOCK);
+      }
+   }
+}
+
+#endif
+
 /*\
  *  \function{setl2\_print()}
  *
@@ -3469,7 +3224,7 @@ specifier *arg;                        /* used to loop over arguments       */
 #endif
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -3514,7 +3269,7 @@ specifier *arg;                        /* used to loop over arguments       */
 #endif
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -3534,58 +3289,25 @@ void setl2_printa(
    specifier *target)                  /* return value                      */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 specifier *arg;                        /* used to loop over arguments       */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
 
    if ((file_ptr->f_type == 1)&&(file_ptr->f_mode == TEXT_IN))
       file_ptr->f_mode = TEXT_OUT;
@@ -3619,7 +3341,7 @@ specifier *arg;                        /* used to loop over arguments       */
 #endif
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -3639,58 +3361,25 @@ void setl2_nprinta(
    specifier *target)                  /* return value                      */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 specifier *arg;                        /* used to loop over arguments       */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
 
    if ((file_ptr->f_type == 1)&&(file_ptr->f_mode == TEXT_IN))
       file_ptr->f_mode = TEXT_OUT;
@@ -3719,7 +3408,7 @@ specifier *arg;                        /* used to loop over arguments       */
 #endif
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -3753,7 +3442,7 @@ static void print_spec(
 {
 char string_buffer[64];
    
-   switch (spec->sp_form) {
+   switch (spec_form(spec)) {
 
 /*\
  *  \case{unprintable types}
@@ -3778,12 +3467,12 @@ case ft_atom :
 
 {
 
-   if (spec->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num)
+   if (spec_val(spec,sp_atom_num) == spec_val(spec_true,sp_atom_num))
       print_to_stream_or_fd("TRUE");
-   else if (spec->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num)
+   else if (spec_val(spec,sp_atom_num) == spec_val(spec_false,sp_atom_num))
       print_to_stream_or_fd("FALSE");
    else {
-      sprintf(string_buffer,"<atom %ld>",spec->sp_val.sp_atom_num);
+      sprintf(string_buffer,"<atom %ld>",spec_val(spec,sp_atom_num));
       print_to_stream_or_fd(string_buffer);
    }
    return;
@@ -3796,11 +3485,11 @@ case ft_opaque :
 
 #if WATCOM
 
-	sprintf(string_buffer,"<opaque %p>",spec->sp_val.sp_opaque_ptr);
+	sprintf(string_buffer,"<opaque %p>",spec_val(spec,sp_opaque_ptr));
 
 #else
 
-	sprintf(string_buffer,"<opaque %ld>",(int32)(spec->sp_val.sp_opaque_ptr));
+	sprintf(string_buffer,"<opaque %ld>",(int32)(spec_val(spec,sp_opaque_ptr)));
 
 #endif
    print_to_stream_or_fd(string_buffer);
@@ -3815,11 +3504,11 @@ case ft_label :
 
 #if WATCOM
 
-   sprintf(string_buffer,"<label %p>",spec->sp_val.sp_label_ptr);
+   sprintf(string_buffer,"<label %p>",spec_val(spec,sp_label_ptr));
 
 #else
 
-   sprintf(string_buffer,"<label %ld>",(int32)(spec->sp_val.sp_label_ptr));
+   sprintf(string_buffer,"<label %ld>",(int32)(spec_val(spec,sp_label_ptr)));
 
 #endif
    print_to_stream_or_fd(string_buffer);
@@ -3834,11 +3523,11 @@ case ft_file :
 
 #if WATCOM
 
-   sprintf(string_buffer,"<file %p>",spec->sp_val.sp_file_ptr);
+   sprintf(string_buffer,"<file %p>",spec_val(spec,sp_file_ptr));
 
 #else
 
-   sprintf(string_buffer,"<file %ld>",(int32)(spec->sp_val.sp_file_ptr));
+   sprintf(string_buffer,"<file %ld>",(int32)(spec_val(spec,sp_file_ptr)));
 
 #endif
    print_to_stream_or_fd(string_buffer);
@@ -3853,11 +3542,12 @@ case ft_proc :
 
 #if WATCOM
 
-   sprintf(string_buffer,"<procedure %p>",spec->sp_val.sp_proc_ptr);
+   sprintf(string_buffer,"<procedure %p>",spec_val(spec,sp_proc_ptr));
 
 #else
 
-   sprintf(string_buffer,"<procedure %ld>",(int32)(spec->sp_val.sp_proc_ptr));
+   sprintf(string_buffer,"<procedure %ld>",
+           (int32)(spec_val(spec,sp_proc_ptr)));
 
 #endif
    print_to_stream_or_fd(string_buffer);
@@ -3874,17 +3564,18 @@ int first_element;                     /* first entry switch                */
 
 #if WATCOM
 
-   sprintf(string_buffer,"<mailbox %p",spec->sp_val.sp_mailbox_ptr);
+   sprintf(string_buffer,"<mailbox %p",spec_val(spec,sp_mailbox_ptr));
 
 #else
 
-   sprintf(string_buffer,"<mailbox %ld",(int32)(spec->sp_val.sp_mailbox_ptr));
+   sprintf(string_buffer,"<mailbox %ld",
+           (int32)(spec_val(spec,sp_mailbox_ptr)));
 
 #endif
    print_to_stream_or_fd(string_buffer);
 
    first_element = YES;
-   for (cell_ptr = spec->sp_val.sp_mailbox_ptr->mb_head;
+   for (cell_ptr = spec_val(spec,sp_mailbox_ptr)->mb_head;
         cell_ptr != NULL;
         cell_ptr = cell_ptr->mb_next) {
 
@@ -3910,11 +3601,11 @@ case ft_iter :
 
 #if WATCOM
 
-   sprintf(string_buffer,"<iterator %p>",spec->sp_val.sp_iter_ptr);
+   sprintf(string_buffer,"<iterator %p>",spec_val(spec,sp_iter_ptr));
 
 #else
 
-   sprintf(string_buffer,"<iterator %ld>",(int32)(spec->sp_val.sp_iter_ptr));
+   sprintf(string_buffer,"<iterator %ld>",(int32)(spec_val(spec,sp_iter_ptr)));
 
 #endif
    print_to_stream_or_fd(string_buffer);
@@ -3934,7 +3625,7 @@ case ft_short :
 
 {
 
-   sprintf(string_buffer,"%ld",spec->sp_val.sp_short_value);
+   sprintf(string_buffer,"%ld",spec_val(spec,sp_short_value));
    print_to_stream_or_fd(string_buffer);
    return;
 
@@ -3964,7 +3655,7 @@ case ft_real :
 
 {
 
-   sprintf(string_buffer,"%#.11g",(spec->sp_val.sp_real_ptr)->r_value);
+   sprintf(string_buffer,"%#.11g",spec_val(spec,sp_real_value));
    print_to_stream_or_fd(string_buffer);
 
    return;
@@ -3974,56 +3665,53 @@ case ft_real :
 /*\
  *  \case{strings}
  *
- *  Strings are complex structures, because we allow infinite length.  We
- *  have to print each cell individually, and translate nulls to blanks.
+ *  Strings are held contiguously with a terminating null, so we can
+ *  usually print the character array as it stands.  Strings containing
+ *  nulls are copied in chunks, translating the nulls to blanks.
 \*/
 
 case ft_string :
 
 {
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 int32 chars_to_print;                  /* characters left in string         */
-char cell_string[STR_CELL_WIDTH + 1];  /* printable cell string             */
+int32 chunk_length;                    /* characters in current chunk       */
+char chunk_string[PRINT_CHUNK + 1];    /* printable chunk                   */
 char *s, *t;                           /* temporary looping variables       */
 
-   /* loop over the cells ... */
-
-   string_hdr = spec->sp_val.sp_string_ptr;
+   string_hdr = spec_val(spec,sp_string_ptr);
    chars_to_print = string_hdr->s_length;
-   for (string_cell = string_hdr->s_head;
-        chars_to_print && string_cell != NULL;
-        string_cell = string_cell->s_next) {
+   s = string_hdr->s_chars;
 
-      /* translate nulls to spaces */
+   if (memchr(s,'\0',(size_t)chars_to_print) == NULL) {
 
-      for (s = string_cell->s_cell_value, t = cell_string;
-           s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           s++, t++) {
+      print_to_stream_or_fd(s);
 
-         if (*s == '\0')
-            *t = ' ';
-         else
-            *t = *s;
+      return;
 
-      }
+   }
 
-      /* print the cell (or as much as necessary) */
+   /* loop over the chunks ... */
 
-      if (chars_to_print < STR_CELL_WIDTH) {
+   while (chars_to_print) {
 
-         cell_string[chars_to_print] = '\0';
-         chars_to_print = 0;
+      chunk_length = min(chars_to_print,PRINT_CHUNK);
 
-      }
-      else {
+      /* translate nulls to spaces */
+
+      for (t = chunk_string; t < chunk_string + chunk_length; s++, t++) {
 
-         cell_string[STR_CELL_WIDTH] = '\0';
-         chars_to_print -= STR_CELL_WIDTH;
+         if (*s == '\0')
+            *t = ' ';
+         else
+            *t = *s;
 
       }
 
-      print_to_stream_or_fd(cell_string);
+      *t = '\0';
+      chars_to_print -= chunk_length;
+
+      print_to_stream_or_fd(chunk_string);
 
    }
 
@@ -4042,10 +3730,9 @@ case ft_set :
 
 {
 int first_element;                     /* YES for the first element         */
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+set_h_ptr_type source_root;            /* root of set                       */
+struct set_cursor_item source_cursor;  /* position in set                   */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* set element                       */
 
    /* print the opening brace, and start looping over the set */
@@ -4053,11 +3740,8 @@ specifier *source_element;             /* set element                       */
    print_to_stream_or_fd("{");
    first_element = YES;
 
-   source_root = spec->sp_val.sp_set_ptr;
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
+   source_root = spec_val(spec,sp_set_ptr);
+   set_cursor_start(&source_cursor,source_root->s_trie);
 
    /* loop over the elements of source */
 
@@ -4065,71 +3749,9 @@ specifier *source_element;             /* set element                       */
 
       /* find the next element in the set */
 
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, break */
-
-         if (source_cell != NULL) {
-
-            source_element = &(source_cell->s_spec);
-            source_cell = source_cell->s_next;
-            break;
-
-         }
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < SET_HASH_SIZE) {
-
-            source_cell = source_work_hdr->s_child[source_index].s_cell;
-            source_index++;
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= SET_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->s_child[source_index].s_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if we've exhausted the set break again */
-
-      if (source_element == NULL)
+      if ((source_cell = set_cursor_next(&source_cursor)) == NULL)
          break;
+      source_element = &(source_cell->s_spec);
 
       /*
        *  At this point we have an element in source_element which must
@@ -4145,7 +3767,7 @@ specifier *source_element;             /* set element                       */
 
       /* print enclosing quotes around strings */
 
-      if (source_element->sp_form == ft_string) {
+      if (spec_form(source_element) == ft_string) {
 
          print_to_stream_or_fd("\"");
          print_spec(SETL_SYSTEM source_element);
@@ -4181,14 +3803,9 @@ case ft_map :
 
 {
 int first_element;                     /* YES for the first element         */
-map_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+map_h_ptr_type source_root;            /* root of map                       */
+struct map_cursor_item source_cursor;  /* position in map                   */
 map_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type valset_root, valset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type valset_cell;            /* current cell pointer              */
-int valset_height, valset_index;       /* current height and index          */
 specifier *domain_element, *range_element;
                                        /* pair from map                     */
 
@@ -4197,169 +3814,15 @@ specifier *domain_element, *range_element;
    print_to_stream_or_fd("{");
    first_element = YES;
 
-   source_root = spec->sp_val.sp_map_ptr;
-   source_work_hdr = source_root;
-   source_height = source_root->m_ntype.m_root.m_height;
-   source_cell = NULL;
-   source_index = 0;
-   valset_root = NULL;
-
-   /* loop over the elements of source */
-
-   for (;;) {
-
-      /* find the next cell in the map */
-
-      while (source_cell == NULL) {
+   source_root = spec_val(spec,sp_map_ptr);
+   map_pair_start(&source_cursor,source_root);
 
-         /* start on the next clash list, if we're at a leaf */
+   /* loop over the pairs of source */
 
-         if (!source_height && source_index < MAP_HASH_SIZE) {
+   while ((source_cell = map_pair_next(&source_cursor,
+                                       &range_element)) != NULL) {
 
-            source_cell = source_work_hdr->m_child[source_index].m_cell;
-            source_index++;
-            continue;
-
-         }
-
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= MAP_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->m_ntype.m_intern.m_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->m_ntype.m_intern.m_parent;
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->m_child[source_index].m_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->m_child[source_index].m_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if there are no more cells, break */
-
-      if (source_cell == NULL)
-         break;
-
-      /* if the cell is not multi-value, use the pair directly */
-
-      if (!(source_cell->m_is_multi_val)) {
-
-         domain_element = &(source_cell->m_domain_spec);
-         range_element = &(source_cell->m_range_spec);
-         source_cell = source_cell->m_next;
-
-      }
-
-      /* otherwise find the next element in the value set */
-
-      else {
-
-         domain_element = &(source_cell->m_domain_spec);
-         if (valset_root == NULL) {
-
-            valset_root = source_cell->m_range_spec.sp_val.sp_set_ptr;
-            valset_work_hdr = valset_root;
-            valset_height = valset_root->s_ntype.s_root.s_height;
-            valset_cell = NULL;
-            valset_index = 0;
-
-         }
-
-         range_element = NULL;
-         for (;;) {
-
-            /* if we have an element already, break */
-
-            if (valset_cell != NULL) {
-
-               range_element = &(valset_cell->s_spec);
-               valset_cell = valset_cell->s_next;
-               break;
-
-            }
-
-            /* start on the next clash list, if we're at a leaf */
-
-            if (!valset_height && valset_index < SET_HASH_SIZE) {
-
-               valset_cell = valset_work_hdr->s_child[valset_index].s_cell;
-               valset_index++;
-               continue;
-
-            }
-
-            /* the current header node is exhausted -- find the next one */
-
-            if (valset_index >= SET_HASH_SIZE) {
-
-               /* there are no more elements, so break */
-
-               if (valset_work_hdr == valset_root)
-                  break;
-
-               /* otherwise move up */
-
-               valset_height++;
-               valset_index =
-                  valset_work_hdr->s_ntype.s_intern.s_child_index + 1;
-               valset_work_hdr =
-                  valset_work_hdr->s_ntype.s_intern.s_parent;
-               continue;
-
-            }
-
-            /* skip over null nodes */
-
-            if (valset_work_hdr->s_child[valset_index].s_header == NULL) {
-
-               valset_index++;
-               continue;
-
-            }
-
-            /* otherwise drop down a level */
-
-            valset_work_hdr =
-               valset_work_hdr->s_child[valset_index].s_header;
-            valset_index = 0;
-            valset_height--;
-
-         }
-
-         if (range_element == NULL) {
-
-            source_cell = source_cell->m_next;
-            valset_root = NULL;
-            continue;
-
-         }
-      }
+      domain_element = &(source_cell->m_domain_spec);
 
       /*
        *  At this point we have a pair from the map which we would like to
@@ -4377,7 +3840,7 @@ specifier *domain_element, *range_element;
 
        print_to_stream_or_fd("[");
 
-      if (domain_element->sp_form == ft_string) {
+      if (spec_form(domain_element) == ft_string) {
 
          print_to_stream_or_fd("\"");
          print_spec(SETL_SYSTEM domain_element);
@@ -4397,7 +3860,7 @@ specifier *domain_element, *range_element;
 
        print_to_stream_or_fd(", ");
 
-      if (range_element->sp_form == ft_string) {
+      if (spec_form(range_element) == ft_string) {
 
          print_to_stream_or_fd("\"");
          print_spec(SETL_SYSTEM range_element);
@@ -4417,116 +3880,54 @@ specifier *domain_element, *range_element;
 
    }
 
-   /* that's it */
-
-   fputs("}",file_stream);
-
-   return;
-
-}
-
-/*\
- *  \case{tuples}
- *
- *  We loop over the elements of a tuple printing each. When we encounter
- *  a string we print enclosing quotes.
-\*/
-
-case ft_tuple :
-
-{
-int32 printed_number;                  /* number of elements printed        */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
-
-   /* print the opening bracket, and start looping over the tuple */
-
-   print_to_stream_or_fd("[");
-   printed_number = 0;
-
-   source_root = spec->sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
-
-   /* loop over the elements of source */
-
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
+   /* that's it */
 
-            if (source_work_hdr == source_root)
-               break;
+   fputs("}",file_stream);
 
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
+   return;
 
-            continue;
+}
 
-         }
+/*\
+ *  \case{tuples}
+ *
+ *  We loop over the elements of a tuple printing each. When we encounter
+ *  a string we print enclosing quotes.
+\*/
 
-         /* skip over null nodes */
+case ft_tuple :
 
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
+{
+int32 printed_number;                  /* number of elements printed        */
+tuple_h_ptr_type source_root;          /* root of tuple                     */
+tuple_c_ptr_type source_cell;          /* current cell pointer              */
+int32 source_number;                   /* current cell number               */
+specifier *source_element;             /* set element                       */
+specifier packed_element;              /* element of a packed tuple         */
 
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
+   /* print the opening bracket, and start looping over the tuple */
 
-            continue;
+   print_to_stream_or_fd("[");
+   printed_number = 0;
 
-         }
+   source_root = spec_val(spec,sp_tuple_ptr);
 
-         /* otherwise drop down a level */
+   /* loop over the elements of source */
 
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+   for (source_number = 0;
+        source_number < source_root->t_length;
+        source_number++) {
 
+      if (is_packed(source_root)) {
+         get_packed_element(source_root,source_number,&packed_element);
+         source_element = &packed_element;
       }
-
-      if (source_element == NULL)
-         break;
+      else {
+         source_cell = tuple_cell_at(source_root,source_number);
+         source_element = &(source_cell->t_spec);
+      }
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
       /*
        *  At this point we have an element in source_element which must
@@ -4547,7 +3948,7 @@ specifier *source_element;             /* set element                       */
 
       /* print enclosing quotes around strings */
 
-      if (source_element->sp_form == ft_string) {
+      if (spec_form(source_element) == ft_string) {
 
          print_to_stream_or_fd("\"");
          print_spec(SETL_SYSTEM source_element);
@@ -4586,7 +3987,7 @@ case ft_process :
 {
 specifier spare;                       /* spare specifier                   */
 
-   spare.sp_form = ft_omega;
+   spec_set_form(&spare,ft_omega);
    setl2_str(SETL_SYSTEM 1L,spec,&spare);
    print_spec(SETL_SYSTEM &spare);
    unmark_specifier(&spare);
@@ -4616,62 +4017,27 @@ void setl2_getb(
    specifier *target)                  /* return value                      */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 int32 string_length;                   /* characters left in string         */
-int cell_length;                       /* characters in cell to be printed  */
 specifier spare1, spare2;              /* spares for unbinstr               */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
    if (file_ptr->f_mode != BINARY_IN)
       abend(SETL_SYSTEM "Attempt to getb from file not opened for BINARY-IN:\nFile => %s",
             file_ptr->f_file_name);
@@ -4685,7 +4051,7 @@ specifier spare1, spare2;              /* spares for unbinstr               */
    while (argc-- > 1) {
 
       if (eof_flag) {
-         spare1.sp_form = ft_omega;
+         spec_set_form(&spare1,ft_omega);
          push_pstack(&spare1);
          continue;
       }
@@ -4701,7 +4067,7 @@ specifier spare1, spare2;              /* spares for unbinstr               */
             abend(SETL_SYSTEM "Error reading file => %s",file_name);
 
          eof_flag = YES;
-         spare1.sp_form = ft_omega;
+         spec_set_form(&spare1,ft_omega);
          push_pstack(&spare1);
          continue;
 
@@ -4709,41 +4075,21 @@ specifier spare1, spare2;              /* spares for unbinstr               */
 
       /* initialize a string structure */
 
-      get_string_header(string_hdr);
-      string_hdr->s_use_count = 1;
-      string_hdr->s_hash_code = -1;
-      string_hdr->s_length = string_length;
-      string_hdr->s_head = string_hdr->s_tail = string_cell = NULL;
-
-      /* read each cell */
-
-      while (string_length) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-
-         cell_length = min(STR_CELL_WIDTH,string_length);
-         if (fread((void *)string_cell->s_cell_value,
-                   sizeof(char),
-                   (size_t)cell_length,
-                   file_stream) != (size_t)cell_length)
-            abend(SETL_SYSTEM "Error reading file => %s",file_name);
+      string_hdr = new_string_buffer(SETL_SYSTEM string_length);
 
-         string_length -= cell_length;
+      /* read the characters */
 
-      }
+      if (fread((void *)string_hdr->s_chars,
+                sizeof(char),
+                (size_t)string_length,
+                file_stream) != (size_t)string_length)
+         abend(SETL_SYSTEM "Error reading file => %s",file_name);
 
       /* use unbinstr to convert to internal form */
 
-      spare1.sp_form = ft_string;
-      spare1.sp_val.sp_string_ptr = string_hdr;
-      spare2.sp_form = ft_omega;
+      spec_set_form(&spare1,ft_string);
+      spec_set_val(&spare1,sp_string_ptr,string_hdr);
+      spec_set_form(&spare2,ft_omega);
       setl2_unbinstr(SETL_SYSTEM 1L,&spare1,&spare2);
       push_pstack(&spare2);
       unmark_specifier(&spare1);
@@ -4754,7 +4100,7 @@ specifier spare1, spare2;              /* spares for unbinstr               */
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -4773,63 +4119,28 @@ void setl2_putb(
    specifier *target)                  /* return value                      */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 int32 string_length;                   /* characters left in string         */
-int cell_length;                       /* characters in cell to be printed  */
 specifier *arg;                        /* used to loop over arguments       */
 specifier spare;                       /* conversion to string              */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
    if (file_ptr->f_mode != BINARY_OUT)
       abend(SETL_SYSTEM "Attempt to putb to file not opened for BINARY-OUT:\nFile: => %s",
             file_ptr->f_file_name);
@@ -4843,12 +4154,12 @@ specifier spare;                       /* conversion to string              */
 
       /* convert the specifier to a string */
 
-      spare.sp_form = ft_omega;
+      spec_set_form(&spare,ft_omega);
       setl2_binstr(SETL_SYSTEM 1L,arg,&spare);
 
       /* write it to the file */
 
-      string_hdr = spare.sp_val.sp_string_ptr;
+      string_hdr = spec_val(&spare,sp_string_ptr);
       string_length = string_hdr->s_length;
 
       /* save the length of string */
@@ -4859,22 +4170,13 @@ specifier spare;                       /* conversion to string              */
                  file_stream) != (size_t)1)
             abend(SETL_SYSTEM "Error writing file => %s",file_name);
 
-      /* loop over the cells ... */
-
-      for (string_cell = string_hdr->s_head;
-           string_length && string_cell != NULL;
-           string_cell = string_cell->s_next) {
-
-         cell_length = min(STR_CELL_WIDTH,string_length);
-         if (fwrite((void *)string_cell->s_cell_value,
-                    sizeof(char),
-                    (size_t)cell_length,
-                    file_stream) != (size_t)cell_length)
-            abend(SETL_SYSTEM "Error writing file => %s",file_name);
-
-         string_length -= cell_length;
+      /* write the characters */
 
-      }
+      if (fwrite((void *)string_hdr->s_chars,
+                 sizeof(char),
+                 (size_t)string_length,
+                 file_stream) != (size_t)string_length)
+         abend(SETL_SYSTEM "Error writing file => %s",file_name);
 
       /* we're done with spare */
 
@@ -4883,7 +4185,7 @@ specifier spare;                       /* conversion to string              */
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -4902,64 +4204,28 @@ void setl2_gets(
    specifier *target)                  /* return value                      */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 int32 start_position;
 int32 string_length;
-int32 cell_size;
 string_h_ptr_type string_hdr;
                                        /* source and target strings         */
-string_c_ptr_type string_cell;
-                                       /* source and target string cells    */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
    if (file_ptr->f_mode != RANDOM)
       abend(SETL_SYSTEM "Attempt to gets from file not opened for RANDOM:\nFile => %s",
             file_ptr->f_file_name);
@@ -4969,14 +4235,15 @@ string_c_ptr_type string_cell;
 
    /* the second and third arguments must be integers */
 
-   if (argv[1].sp_form == ft_short) {
+   if (spec_form(&argv[1]) == ft_short) {
 
-      start_position = (int32)(argv[1].sp_val.sp_short_value);
+      start_position = (int32)(spec_val(&argv[1],sp_short_value));
 
    }
-   else if (argv[1].sp_form == ft_long) {
+   else if (spec_form(&argv[1]) == ft_long) {
 
-      start_position = (int32)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+      start_position =
+         (int32)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
 
    }
    else {
@@ -4990,14 +4257,15 @@ string_c_ptr_type string_cell;
 
    start_position--;
 
-   if (argv[2].sp_form == ft_short) {
+   if (spec_form(&argv[2]) == ft_short) {
 
-      string_length = (int32)(argv[2].sp_val.sp_short_value);
+      string_length = (int32)(spec_val(&argv[2],sp_short_value));
 
    }
-   else if (argv[2].sp_form == ft_long) {
+   else if (spec_form(&argv[2]) == ft_long) {
 
-      string_length = (int32)long_to_short(SETL_SYSTEM argv[2].sp_val.sp_long_ptr);
+      string_length =
+         (int32)long_to_short(SETL_SYSTEM spec_val(&argv[2],sp_long_ptr));
 
    }
    else {
@@ -5013,47 +4281,28 @@ string_c_ptr_type string_cell;
    if (fseek(file_stream,start_position,SEEK_SET) != 0)
       abend(SETL_SYSTEM "Seek failed on file => %s", file_name);
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = string_length;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-
-   /* build up the string */
-
-   while (string_length) {
-
-      cell_size = min(string_length,STR_CELL_WIDTH);
-      string_length -= cell_size;
+   string_hdr = new_string_buffer(SETL_SYSTEM string_length);
 
-      get_string_cell(string_cell);
-      if (string_hdr->s_tail != NULL)
-         (string_hdr->s_tail)->s_next = string_cell;
-      string_cell->s_prev = string_hdr->s_tail;
-      string_cell->s_next = NULL;
-      string_hdr->s_tail = string_cell;
-      if (string_hdr->s_head == NULL)
-         string_hdr->s_head = string_cell;
+   /* read the string */
 
-      if (fread((void *)string_cell->s_cell_value,
-                (size_t)cell_size,
-                (size_t)1,
-                file_stream) != (size_t)1)
-         abend(SETL_SYSTEM "Read error on file => %s",file_name);
-
-   }
+   if (string_length > 0 &&
+       fread((void *)string_hdr->s_chars,
+             (size_t)string_length,
+             (size_t)1,
+             file_stream) != (size_t)1)
+      abend(SETL_SYSTEM "Read error on file => %s",file_name);
 
    /* push the output string and return OM */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
    string_hdr->s_use_count--;
    push_pstack(target);
 
    /* return om */
 
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -5072,64 +4321,28 @@ void setl2_puts(
    specifier *target)                  /* return value                      */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 int32 start_position;
 int32 string_length;
-int32 cell_size;
 string_h_ptr_type string_hdr;
                                        /* source and target strings         */
-string_c_ptr_type string_cell;
-                                       /* source and target string cells    */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
    if (file_ptr->f_mode != RANDOM)
       abend(SETL_SYSTEM "Attempt to puts to file not opened for RANDOM:\nFile => %s",
             file_ptr->f_file_name);
@@ -5139,14 +4352,15 @@ string_c_ptr_type string_cell;
 
    /* the second argument must be an integer */
 
-   if (argv[1].sp_form == ft_short) {
+   if (spec_form(&argv[1]) == ft_short) {
 
-      start_position = (int32)(argv[1].sp_val.sp_short_value);
+      start_position = (int32)(spec_val(&argv[1],sp_short_value));
 
    }
-   else if (argv[1].sp_form == ft_long) {
+   else if (spec_form(&argv[1]) == ft_long) {
 
-      start_position = (int32)long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+      start_position =
+         (int32)long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
 
    }
    else {
@@ -5170,7 +4384,7 @@ string_c_ptr_type string_cell;
 #if MACINTOSH
 
 {
-char junk_str[STR_CELL_WIDTH];
+char junk_str[32];
 int32 eof_position;
 
    if (fseek(file_stream,0L,SEEK_END) != 0)
@@ -5182,12 +4396,12 @@ int32 eof_position;
    while (eof_position < start_position) {
 
       if (fwrite((void *)(junk_str),
-                 (size_t)STR_CELL_WIDTH,
+                 sizeof(junk_str),
                  (size_t)1,
                  file_stream) != (size_t)1)
          abend(SETL_SYSTEM "Write error on file => %s",file_name);
 
-      eof_position += STR_CELL_WIDTH;
+      eof_position += sizeof(junk_str);
 
    }
 }
@@ -5199,39 +4413,30 @@ int32 eof_position;
 
    /* initialize the source string */
 
-   if (argv[2].sp_form != ft_string)
+   if (spec_form(&argv[2]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",3,"puts",
             abend_opnd_str(SETL_SYSTEM argv+2));
 
-   string_hdr = argv[2].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[2],sp_string_ptr);
    string_length = string_hdr->s_length;
-   string_cell = string_hdr->s_head;
 
    if (string_length+start_position>1024*1024)
       abend(SETL_SYSTEM msg_bad_arg,"string",3,"puts",
             abend_opnd_str(SETL_SYSTEM argv+2));
 
-   /* copy the source until we find something not in the span set */
-
-   while (string_length) {
-
-      cell_size = min(string_length,STR_CELL_WIDTH);
-      string_length -= cell_size;
+   /* write the source string */
 
-      if (fwrite((void *)string_cell->s_cell_value,
-                 (size_t)cell_size,
-                 (size_t)1,
-                 file_stream) != (size_t)1)
-         abend(SETL_SYSTEM "Write error on file => %s",file_name);
-
-      string_cell = string_cell->s_next;
-
-   }
+   if (string_length > 0 &&
+       fwrite((void *)string_hdr->s_chars,
+              (size_t)string_length,
+              (size_t)1,
+              file_stream) != (size_t)1)
+      abend(SETL_SYSTEM "Write error on file => %s",file_name);
 
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -5250,64 +4455,30 @@ void setl2_fsize(
    specifier *target)                  /* return value                      */
 
 {
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 int32 eof_position;
-int32 short_hi_bits;                   /* high order bits of short          */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
 
    if ((file_ptr->f_type == 1) && (file_ptr->f_flag == 1)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
       return;
 
@@ -5325,12 +4496,11 @@ int32 short_hi_bits;                   /* high order bits of short          */
 
    /* check whether the result remains short */
 
-   if (!(short_hi_bits = eof_position & INT_HIGH_BITS) ||
-       short_hi_bits == INT_HIGH_BITS) {
+   if (is_short_value(eof_position)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = eof_position;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,eof_position);
 
       return;
 
@@ -5362,15 +4532,15 @@ void setl2_eof(
    if (eof_flag) {
 
       unmark_specifier(target);
-      target->sp_form = spec_true->sp_form;
-      target->sp_val.sp_biggest = spec_true->sp_val.sp_biggest;
+      spec_set_form(target,spec_form(spec_true));
+      spec_set_val(target,sp_biggest,spec_val(spec_true,sp_biggest));
 
    }
    else {
 
       unmark_specifier(target);
-      target->sp_form = spec_false->sp_form;
-      target->sp_val.sp_biggest = spec_false->sp_val.sp_biggest;
+      spec_set_form(target,spec_form(spec_false));
+      spec_set_val(target,sp_biggest,spec_val(spec_false,sp_biggest));
 
    }
 
@@ -5396,13 +4566,7 @@ void setl2_binstr(
 
    /* initialize the return string */
 
-   get_string_header(binstr_curr_hdr);
-   binstr_curr_hdr->s_use_count = 1;
-   binstr_curr_hdr->s_hash_code = -1;
-   binstr_curr_hdr->s_length = 0;
-   binstr_curr_hdr->s_head = binstr_curr_hdr->s_tail =
-                             binstr_curr_cell = NULL;
-   binstr_char_ptr = binstr_char_end = NULL;
+   binstr_curr_hdr = new_string_buffer(SETL_SYSTEM 0);
 
    /* call a recursive function to make the string */
 
@@ -5411,8 +4575,8 @@ void setl2_binstr(
    /* set the return value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = binstr_curr_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,binstr_curr_hdr);
 
    return;
 
@@ -5429,8 +4593,11 @@ static void binstr_cat_spec(
    specifier *spec)                    /* specifier to be appended          */
 
 {
+int spec_form_code;                    /* form code of specifier            */
 
-   switch (spec->sp_form) {
+   spec_form_code = spec_form(spec);
+
+   switch (spec_form_code) {
 
 /*\
  *  \case{omegas}
@@ -5442,7 +4609,7 @@ case ft_omega :
 
 {
 
-   binstr_cat_string(SETL_SYSTEM (char *)&(spec->sp_form),sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
 
    return;
 
@@ -5461,6 +4628,7 @@ case ft_file :          case ft_proc :          case ft_iter :
 case ft_mailbox :
 
 {
+void *spec_value;                      /* pointer or atom number            */
 
    /*
     *  Make sure we can't release the memory for these values, since
@@ -5468,8 +4636,10 @@ case ft_mailbox :
     */
 
    mark_specifier(spec);
+   spec_value = spec_ptr(spec);
 
-   binstr_cat_string(SETL_SYSTEM (char *)spec,sizeof(specifier));
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_value,sizeof(void *));
    binstr_cat_string(SETL_SYSTEM (char *)&(runtime),sizeof(time_t));
 
    return;
@@ -5486,8 +4656,13 @@ case ft_mailbox :
 case ft_short :
 
 {
+int32 short_value;                     /* integer value                     */
+
+   /* write the fields separately, since the specifier may be padded */
 
-   binstr_cat_string(SETL_SYSTEM (char *)spec,sizeof(specifier));
+   short_value = spec_val(spec,sp_short_value);
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&short_value,sizeof(int32));
 
    return;
 
@@ -5497,26 +4672,26 @@ case ft_long :
 
 {
 integer_h_ptr_type integer_hdr;        /* root of long structure            */
-integer_c_ptr_type integer_cell;       /* long cell                         */
+int32 cell_value;                      /* long cell                         */
 int32 cell_count;                      /* number of cells in integer        */
+int32 i;                               /* temporary looping variable        */
 
    /* we write the form code and number of cells */
 
-   integer_hdr = spec->sp_val.sp_long_ptr;
-   cell_count = integer_hdr->i_cell_count;
+   integer_hdr = spec_val(spec,sp_long_ptr);
+   cell_count = integer_cell_count(integer_hdr);
    if (integer_hdr->i_is_negative)
       cell_count = -cell_count;
 
-   binstr_cat_string(SETL_SYSTEM (char *)&(spec->sp_form),sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
    binstr_cat_string(SETL_SYSTEM (char *)&cell_count,sizeof(int32));
 
    /* write each cell value */
 
-   for (integer_cell = integer_hdr->i_head;
-        integer_cell != NULL;
-        integer_cell = integer_cell->i_next) {
+   for (i = 0; i < labs(cell_count); i++) {
 
-      binstr_cat_string(SETL_SYSTEM (char *)&(integer_cell->i_cell_value),sizeof(int32));
+      cell_value = integer_cell_value(integer_hdr,i);
+      binstr_cat_string(SETL_SYSTEM (char *)&cell_value,sizeof(int32));
 
    }
 
@@ -5533,10 +4708,11 @@ int32 cell_count;                      /* number of cells in integer        */
 case ft_real :
 
 {
+double real_value;                     /* real value                        */
 
-   binstr_cat_string(SETL_SYSTEM (char *)&(spec->sp_form),sizeof(int));
-   binstr_cat_string(SETL_SYSTEM (char *)&((spec->sp_val.sp_real_ptr)->r_value),
-                  sizeof(double));
+   real_value = spec_val(spec,sp_real_value);
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&real_value,sizeof(double));
 
    return;
 
@@ -5545,38 +4721,26 @@ case ft_real :
 /*\
  *  \case{strings}
  *
- *  Strings are complex structures, because we allow infinite length.  We
- *  have to save each cell individually.
+ *  We save the length of a string followed by its characters.
 \*/
 
 case ft_string :
 
 {
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
-int32 string_length;                   /* characters left in string         */
-int cell_length;                       /* characters in cell to be printed  */
+int32 string_length;                   /* characters in string              */
 
-   string_hdr = spec->sp_val.sp_string_ptr;
+   string_hdr = spec_val(spec,sp_string_ptr);
    string_length = string_hdr->s_length;
 
    /* save the form and length of string */
 
-   binstr_cat_string(SETL_SYSTEM (char *)&(spec->sp_form),sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
    binstr_cat_string(SETL_SYSTEM (char *)&string_length,sizeof(int32));
 
-   /* loop over the cells ... */
-
-   for (string_cell = string_hdr->s_head;
-        string_length && string_cell != NULL;
-        string_cell = string_cell->s_next) {
+   /* and the characters */
 
-      cell_length = min(STR_CELL_WIDTH,string_length);
-      binstr_cat_string(SETL_SYSTEM string_cell->s_cell_value,(size_t)cell_length);
-
-      string_length -= cell_length;
-
-   }
+   binstr_cat_string(SETL_SYSTEM string_hdr->s_chars,(size_t)string_length);
 
    return;
 
@@ -5591,24 +4755,20 @@ int cell_length;                       /* characters in cell to be printed  */
 case ft_set :
 
 {
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+set_h_ptr_type source_root;            /* root of set                       */
+struct set_cursor_item source_cursor;  /* position in set                   */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* set element                       */
 
-   source_root = spec->sp_val.sp_set_ptr;
+   source_root = spec_val(spec,sp_set_ptr);
 
    /* save the form and cardinality of set */
 
-   binstr_cat_string(SETL_SYSTEM (char *)&(spec->sp_form),sizeof(int));
-   binstr_cat_string(SETL_SYSTEM (char *)&(source_root->s_ntype.s_root.s_cardinality),
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&(source_root->s_cardinality),
                      sizeof(int32));
 
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
+   set_cursor_start(&source_cursor,source_root->s_trie);
 
    /* loop over the elements of source */
 
@@ -5616,71 +4776,9 @@ specifier *source_element;             /* set element                       */
 
       /* find the next element in the set */
 
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, break */
-
-         if (source_cell != NULL) {
-
-            source_element = &(source_cell->s_spec);
-            source_cell = source_cell->s_next;
-            break;
-
-         }
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < SET_HASH_SIZE) {
-
-            source_cell = source_work_hdr->s_child[source_index].s_cell;
-            source_index++;
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= SET_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->s_child[source_index].s_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if we've exhausted the set break again */
-
-      if (source_element == NULL)
+      if ((source_cell = set_cursor_next(&source_cursor)) == NULL)
          break;
+      source_element = &(source_cell->s_spec);
 
       /*
        *  At this point we have an element in source_element which must
@@ -5698,197 +4796,38 @@ specifier *source_element;             /* set element                       */
 /*\
  *  \case{maps}
  *
- *  We loop over the elements of a map storing each pair.
-\*/
-
-case ft_map :
-
-{
-int form_code;                         /* specifier form code               */
-int32 map_cardinality;                 /* specifier cardinality             */
-map_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-map_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type valset_root, valset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type valset_cell;            /* current cell pointer              */
-int valset_height, valset_index;       /* current height and index          */
-specifier *domain_element, *range_element;
-                                       /* pair from map                     */
-
-   source_root = spec->sp_val.sp_map_ptr;
-
-   /* save the form and cardinality of set */
-
-   form_code = ft_set;
-   binstr_cat_string(SETL_SYSTEM (char *)&(form_code),sizeof(int));
-   binstr_cat_string(SETL_SYSTEM (char *)&(source_root->m_ntype.m_root.m_cardinality),
-                  sizeof(int32));
-
-   source_root = spec->sp_val.sp_map_ptr;
-   source_work_hdr = source_root;
-   source_height = source_root->m_ntype.m_root.m_height;
-   source_cell = NULL;
-   source_index = 0;
-   valset_root = NULL;
-
-   /* loop over the elements of source */
-
-   for (;;) {
-
-      /* find the next cell in the map */
-
-      while (source_cell == NULL) {
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < MAP_HASH_SIZE) {
-
-            source_cell = source_work_hdr->m_child[source_index].m_cell;
-            source_index++;
-            continue;
-
-         }
-
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= MAP_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->m_ntype.m_intern.m_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->m_ntype.m_intern.m_parent;
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->m_child[source_index].m_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->m_child[source_index].m_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if there are no more cells, break */
-
-      if (source_cell == NULL)
-         break;
-
-      /* if the cell is not multi-value, use the pair directly */
-
-      if (!(source_cell->m_is_multi_val)) {
-
-         domain_element = &(source_cell->m_domain_spec);
-         range_element = &(source_cell->m_range_spec);
-         source_cell = source_cell->m_next;
-
-      }
-
-      /* otherwise find the next element in the value set */
-
-      else {
-
-         domain_element = &(source_cell->m_domain_spec);
-         if (valset_root == NULL) {
-
-            valset_root = source_cell->m_range_spec.sp_val.sp_set_ptr;
-            valset_work_hdr = valset_root;
-            valset_height = valset_root->s_ntype.s_root.s_height;
-            valset_cell = NULL;
-            valset_index = 0;
-
-         }
-
-         range_element = NULL;
-         for (;;) {
-
-            /* if we have an element already, break */
-
-            if (valset_cell != NULL) {
-
-               range_element = &(valset_cell->s_spec);
-               valset_cell = valset_cell->s_next;
-               break;
-
-            }
-
-            /* start on the next clash list, if we're at a leaf */
-
-            if (!valset_height && valset_index < SET_HASH_SIZE) {
-
-               valset_cell = valset_work_hdr->s_child[valset_index].s_cell;
-               valset_index++;
-               continue;
-
-            }
-
-            /* the current header node is exhausted -- find the next one */
-
-            if (valset_index >= SET_HASH_SIZE) {
-
-               /* there are no more elements, so break */
-
-               if (valset_work_hdr == valset_root)
-                  break;
-
-               /* otherwise move up */
-
-               valset_height++;
-               valset_index =
-                  valset_work_hdr->s_ntype.s_intern.s_child_index + 1;
-               valset_work_hdr =
-                  valset_work_hdr->s_ntype.s_intern.s_parent;
-               continue;
-
-            }
-
-            /* skip over null nodes */
+ *  We loop over the elements of a map storing each pair.
+\*/
 
-            if (valset_work_hdr->s_child[valset_index].s_header == NULL) {
+case ft_map :
 
-               valset_index++;
-               continue;
+{
+int form_code;                         /* specifier form code               */
+int32 map_cardinality;                 /* specifier cardinality             */
+map_h_ptr_type source_root;            /* root of map                       */
+struct map_cursor_item source_cursor;  /* position in map                   */
+map_c_ptr_type source_cell;            /* current cell pointer              */
+specifier *domain_element, *range_element;
+                                       /* pair from map                     */
 
-            }
+   source_root = spec_val(spec,sp_map_ptr);
 
-            /* otherwise drop down a level */
+   /* save the form and cardinality of set */
 
-            valset_work_hdr =
-               valset_work_hdr->s_child[valset_index].s_header;
-            valset_index = 0;
-            valset_height--;
+   form_code = ft_set;
+   binstr_cat_string(SETL_SYSTEM (char *)&(form_code),sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&(source_root->m_cardinality),
+                  sizeof(int32));
 
-         }
+   source_root = spec_val(spec,sp_map_ptr);
+   map_pair_start(&source_cursor,source_root);
 
-         if (range_element == NULL) {
+   /* loop over the pairs of source */
 
-            source_cell = source_cell->m_next;
-            valset_root = NULL;
-            continue;
+   while ((source_cell = map_pair_next(&source_cursor,
+                                       &range_element)) != NULL) {
 
-         }
-      }
+      domain_element = &(source_cell->m_domain_spec);
 
       /*
        *  At this point we have a pair from the map which we would like to
@@ -5920,100 +4859,38 @@ case ft_tuple :
 {
 int form_code;                         /* specifier form code               */
 int32 saved_number;                    /* number of elements saved          */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* root of tuple                     */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
 int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* set element                       */
+specifier packed_element;              /* element of a packed tuple         */
 
-   source_root = spec->sp_val.sp_tuple_ptr;
+   source_root = spec_val(spec,sp_tuple_ptr);
 
    /* save the form and cardinality of tuple */
 
-   binstr_cat_string(SETL_SYSTEM (char *)&(spec->sp_form),sizeof(int));
-   binstr_cat_string(SETL_SYSTEM (char *)&(source_root->t_ntype.t_root.t_length),
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&(source_root->t_length),
                   sizeof(int32));
 
-   source_root = spec->sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   saved_number = source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+   saved_number = -1;
 
    /* loop over the elements of source */
 
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+   for (source_number = 0;
+        source_number < source_root->t_length;
+        source_number++) {
 
+      if (is_packed(source_root)) {
+         get_packed_element(source_root,source_number,&packed_element);
+         source_element = &packed_element;
       }
-
-      if (source_element == NULL)
-         break;
+      else {
+         source_cell = tuple_cell_at(source_root,source_number);
+         source_element = &(source_cell->t_spec);
+      }
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
       /*
        *  At this point we have an element in source_element which must
@@ -6063,12 +4940,12 @@ int name_length;                       /* length of object name             */
 
    /* pick out the object root and class */
 
-   object_root = spec->sp_val.sp_object_ptr;
+   object_root = spec_val(spec,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* store the code, the name length, and the name */
 
-   binstr_cat_string(SETL_SYSTEM (char *)&(spec->sp_form),sizeof(int));
+   binstr_cat_string(SETL_SYSTEM (char *)&spec_form_code,sizeof(int));
    name_length = strlen(class_ptr->ut_name);
    binstr_cat_string(SETL_SYSTEM (char *)&name_length,sizeof(int));
    binstr_cat_string(SETL_SYSTEM class_ptr->ut_name,(size_t)name_length);
@@ -6152,30 +5029,18 @@ static void binstr_cat_string(
    size_t length)                      /* length of string                  */
 
 {
-char *p;                               /* temporary looping variable        */
+int32 new_length;                      /* length after concatenation        */
 
-   p = charstring;
-   while (length--) {
-
-      if (binstr_char_ptr == binstr_char_end) {
-
-         get_string_cell(binstr_curr_cell);
-         if (binstr_curr_hdr->s_tail != NULL)
-            (binstr_curr_hdr->s_tail)->s_next = binstr_curr_cell;
-         binstr_curr_cell->s_prev = binstr_curr_hdr->s_tail;
-         binstr_curr_cell->s_next = NULL;
-         binstr_curr_hdr->s_tail = binstr_curr_cell;
-         if (binstr_curr_hdr->s_head == NULL)
-            binstr_curr_hdr->s_head = binstr_curr_cell;
-         binstr_char_ptr = binstr_curr_cell->s_cell_value;
-         binstr_char_end = binstr_char_ptr + STR_CELL_WIDTH;
-
-      }
+   new_length = binstr_curr_hdr->s_length + (int32)length;
+   reserve_string(binstr_curr_hdr,new_length);
+   memcpy((void *)(binstr_curr_hdr->s_chars + binstr_curr_hdr->s_length),
+          (void *)charstring,
+          length);
+   binstr_curr_hdr->s_length = new_length;
+   binstr_curr_hdr->s_chars[new_length] = '\0';
 
-      *binstr_char_ptr++ = *p++;
-      binstr_curr_hdr->s_length++;
+   return;
 
-   }
 }
 
 /*\
@@ -6195,7 +5060,7 @@ void setl2_unbinstr(
 
    /* make sure the argument is a string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"unbinstr",
             abend_opnd_str(SETL_SYSTEM argv));
 
@@ -6207,15 +5072,8 @@ void setl2_unbinstr(
 
    /* load input string */
 
-   reads_length = argv[0].sp_val.sp_string_ptr->s_length;
-   reads_cell = argv[0].sp_val.sp_string_ptr->s_head;
-   if (reads_cell == NULL) {
-      reads_char_ptr = reads_char_end = NULL;
-   }
-   else {
-      reads_char_ptr = reads_cell->s_cell_value;
-      reads_char_end = reads_char_ptr + STR_CELL_WIDTH;
-   }
+   reads_length = spec_val(&argv[0],sp_string_ptr)->s_length;
+   reads_char_ptr = spec_val(&argv[0],sp_string_ptr)->s_chars;
 
    /* read the value */
 
@@ -6265,7 +5123,7 @@ case ft_omega :
 {
 
    unmark_specifier(spec);
-   spec->sp_form = ft_omega;
+   spec_set_form(spec,ft_omega);
 
    return;
 
@@ -6285,17 +5143,19 @@ case ft_mailbox :
 
 {
 time_t storetime;                      /* time specifier was stored         */
+void *spec_value;                      /* pointer or atom number            */
 
    unmark_specifier(spec);
-   spec->sp_form = form_code;
+   spec_set_form(spec,form_code);
 
-   unbinstr_get_string((char *)&(spec->sp_val.sp_biggest),sizeof(void *));
+   unbinstr_get_string((char *)&spec_value,sizeof(void *));
    unbinstr_get_string((char *)&storetime,sizeof(time_t));
+   spec_set_ptr(spec,spec_value);
 
    if (storetime != runtime &&
-       (spec->sp_form != ft_atom ||
-        (spec->sp_val.sp_atom_num != spec_true->sp_val.sp_atom_num &&
-         spec->sp_val.sp_atom_num != spec_false->sp_val.sp_atom_num)))
+       (spec_form(spec) != ft_atom ||
+        (spec_val(spec,sp_atom_num) != spec_val(spec_true,sp_atom_num) &&
+         spec_val(spec,sp_atom_num) != spec_val(spec_false,sp_atom_num))))
       abend(SETL_SYSTEM "Internal values are not preserved across program executions");
 
    return;
@@ -6309,14 +5169,16 @@ time_t storetime;                      /* time specifier was stored         */
  *  we can normally handle quite easily, but longs are more work.
 \*/
 
-case ft_short :         case SKIP_CODE :
+case ft_short :
 
 {
+int32 short_value;                     /* integer value                     */
 
    unmark_specifier(spec);
-   spec->sp_form = form_code;
+   spec_set_form(spec,form_code);
 
-   unbinstr_get_string((char *)&(spec->sp_val.sp_biggest),sizeof(void *));
+   unbinstr_get_string((char *)&short_value,sizeof(int32));
+   spec_set_val(spec,sp_short_value,short_value);
 
    return;
 
@@ -6326,8 +5188,9 @@ case ft_long :
 
 {
 integer_h_ptr_type integer_hdr;        /* root of long structure            */
-integer_c_ptr_type integer_cell;       /* long cell                         */
+int32 cell_value;                      /* long cell                         */
 int32 cell_count;                      /* number of cells in integer        */
+int32 i;                               /* temporary looping variable        */
 
    /* get the number of cells */
 
@@ -6335,35 +5198,41 @@ int32 cell_count;                      /* number of cells in integer        */
 
    /* create a new integer pointer */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
+   integer_hdr = new_integer(SETL_SYSTEM 0);
    integer_hdr->i_is_negative = (cell_count < 0);
    cell_count = labs(cell_count);
-   integer_hdr->i_cell_count = cell_count;
-   integer_hdr->i_head = integer_hdr->i_tail = NULL;
 
-   while (cell_count--) {
+   for (i = 0; i < cell_count; i++) {
 
-      get_integer_cell(integer_cell);
-      if (integer_hdr->i_tail != NULL)
-         (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_hdr->i_tail = integer_cell;
-      if (integer_hdr->i_head == NULL)
-         integer_hdr->i_head = integer_cell;
-      integer_cell->i_next = NULL;
-
-      unbinstr_get_string((char *)&(integer_cell->i_cell_value),
-                          sizeof(int32));
+      unbinstr_get_string((char *)&cell_value,sizeof(int32));
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cell_value);
 
    }
 
-   /* set the result and return */
+   /*
+    *  Set the result and return.  Files written with narrower short
+    *  integers may hold longs which are now short.
+    */
+
+   normalize_long(SETL_SYSTEM spec,integer_hdr);
 
-   unmark_specifier(spec);
-   spec->sp_form = form_code;
-   spec->sp_val.sp_long_ptr = integer_hdr;
+   return;
+
+}
+
+/*\
+ *  \case{skip codes}
+ *
+ *  Sparse tuples are written with a skip code and the index of the next
+ *  element in place of runs of omegas.  We leave the index for the tuple
+ *  case, since it is not a value.
+\*/
+
+case SKIP_CODE :
+
+{
+
+   unbinstr_get_string((char *)&unbinstr_skip,sizeof(int32));
 
    return;
 
@@ -6378,14 +5247,13 @@ int32 cell_count;                      /* number of cells in integer        */
 case ft_real :
 
 {
+double real_value;                     /* real value                        */
 
    unmark_specifier(spec);
-   spec->sp_form = form_code;
+   spec_set_form(spec,form_code);
 
-   i_get_real(spec->sp_val.sp_real_ptr);
-   (spec->sp_val.sp_real_ptr)->r_use_count = 1;
-   unbinstr_get_string((char *)&((spec->sp_val.sp_real_ptr)->r_value),
-                       sizeof(double));
+   unbinstr_get_string((char *)&real_value,sizeof(double));
+   spec_set_val(spec,sp_real_value,real_value);
 
    return;
 
@@ -6394,56 +5262,29 @@ case ft_real :
 /*\
  *  \case{strings}
  *
- *  Strings are complex structures, because we allow infinite length.  We
- *  have to load each cell individually.
+ *  A string is saved as its length followed by its characters.
 \*/
 
 case ft_string :
 
 {
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
-int32 string_length;                   /* characters left in string         */
-int cell_length;                       /* characters in cell to be printed  */
+int32 string_length;                   /* characters in string              */
 
    /* get the string length */
 
    unbinstr_get_string((char *)&string_length,sizeof(int32));
 
-   /* initialize a string structure */
-
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = string_length;
-   string_hdr->s_head = string_hdr->s_tail = string_cell = NULL;
+   /* load the characters */
 
-   /* read each cell */
-
-   while (string_length) {
-
-      get_string_cell(string_cell);
-      if (string_hdr->s_tail != NULL)
-         (string_hdr->s_tail)->s_next = string_cell;
-      string_cell->s_prev = string_hdr->s_tail;
-      string_cell->s_next = NULL;
-      string_hdr->s_tail = string_cell;
-      if (string_hdr->s_head == NULL)
-         string_hdr->s_head = string_cell;
-
-      cell_length = min(STR_CELL_WIDTH,string_length);
-      unbinstr_get_string((char *)string_cell->s_cell_value,
-                          (size_t)cell_length);
-
-      string_length -= cell_length;
-
-   }
+   string_hdr = new_string_buffer(SETL_SYSTEM string_length);
+   unbinstr_get_string(string_hdr->s_chars,(size_t)string_length);
 
    /* set the target and return */
 
    unmark_specifier(spec);
-   spec->sp_form = form_code;
-   spec->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(spec,form_code);
+   spec_set_val(spec,sp_string_ptr,string_hdr);
 
    return;
 
@@ -6460,20 +5301,11 @@ case ft_set :
 
 {
 int32 set_cardinality;                 /* length of set                     */
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int target_height, target_index;       /* current height and index          */
+set_h_ptr_type target_root;            /* root of set                       */
+int is_new;                            /* YES if a cell was added           */
 specifier target_element;              /* set element                       */
 int32 target_hash_code;                /* hash code of target element       */
-set_h_ptr_type new_hdr;                /* created header node               */
 set_c_ptr_type new_cell;               /* created cell node                 */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int is_equal;                          /* YES if two specifiers are equal   */
-int i;                                 /* temporary looping variable        */
 
    /* get the set cardinality */
 
@@ -6481,15 +5313,7 @@ int i;                                 /* temporary looping variable        */
 
    /* create a new set for the target */
 
-   get_set_header(target_root);
-   target_root->s_use_count = 1;
-   target_root->s_hash_code = 0;
-   target_root->s_ntype.s_root.s_cardinality = 0;
-   target_root->s_ntype.s_root.s_height = 0;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        target_root->s_child[i++].s_cell = NULL);
-   expansion_trigger = SET_HASH_SIZE * SET_CLASH_SIZE;
+   target_root = null_set(SETL_SYSTEM_VOID);
 
    /* insert elements until we find a right brace */
 
@@ -6497,7 +5321,7 @@ int i;                                 /* temporary looping variable        */
 
       /* get the next spec from the input stream */
 
-      target_element.sp_form = ft_omega;
+      spec_set_form(&target_element,ft_omega);
       unbinstr_spec(SETL_SYSTEM &target_element);
 
       /*
@@ -6505,82 +5329,16 @@ int i;                                 /* temporary looping variable        */
        *  the target.
        */
 
-      target_work_hdr = target_root;
-
-      /* get the element's hash code */
-
-      spec_hash_code(work_hash_code,&target_element);
-      target_hash_code = work_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_height = target_root->s_ntype.s_root.s_height;
-      while (target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (target_work_hdr->s_child[target_index].s_header == NULL) {
-
-            get_set_header(new_hdr);
-            new_hdr->s_ntype.s_intern.s_parent = target_work_hdr;
-            new_hdr->s_ntype.s_intern.s_child_index = target_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_hdr->s_child[i++].s_cell = NULL);
-            target_work_hdr->s_child[target_index].s_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->s_child[target_index].s_header;
-
-         }
-      }
-
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  The next problem is to determine if the element is
-       *  already in the set.  We compare the element with the clash
-       *  list.
-       */
-
-      target_index = work_hash_code & SET_HASH_MASK;
-      target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-      for (target_cell = *target_tail;
-           target_cell != NULL &&
-              target_cell->s_hash_code < target_hash_code;
-           target_cell = target_cell->s_next) {
-
-         target_tail = &(target_cell->s_next);
-
-      }
-
-      /* check for a duplicate element */
-
-      is_equal = NO;
-      while (target_cell != NULL &&
-             target_cell->s_hash_code == target_hash_code) {
-
-         spec_equal(is_equal,&(target_cell->s_spec),&target_element);
-
-         if (is_equal)
-            break;
-
-         target_tail = &(target_cell->s_next);
-         target_cell = target_cell->s_next;
-
-      }
+      spec_hash_code(target_hash_code,&target_element);
+      new_cell = set_locate(SETL_SYSTEM &(target_root->s_trie),
+                            &target_element,
+                            target_hash_code,
+                            sizeof(struct set_c_item),
+                            &is_new);
 
       /* if we have a duplicate, unmark it and get the next one */
 
-      if (is_equal) {
+      if (!is_new) {
 
          unmark_specifier(&target_element);
          continue;
@@ -6589,31 +5347,18 @@ int i;                                 /* temporary looping variable        */
 
       /* if we reach this point we didn't find the element, so we insert it */
 
-      get_set_cell(new_cell);
-      new_cell->s_spec.sp_form = target_element.sp_form;
-      new_cell->s_spec.sp_val.sp_biggest =
-         target_element.sp_val.sp_biggest;
-      new_cell->s_hash_code = target_hash_code;
-      new_cell->s_next = *target_tail;
-      *target_tail = new_cell;
-      target_root->s_ntype.s_root.s_cardinality++;
+      spec_set_form(&new_cell->s_spec,spec_form(&target_element));
+      spec_set_val(&new_cell->s_spec,sp_biggest,
+         spec_val(&target_element,sp_biggest));
+      target_root->s_cardinality++;
       target_root->s_hash_code ^= target_hash_code;
-
-      /* expand the set header if necessary */
-
-      if (target_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
-
-         target_root = set_expand_header(SETL_SYSTEM target_root);
-         expansion_trigger *= SET_HASH_SIZE;
-
-      }
    }
 
    /* set the target and return */
 
    unmark_specifier(spec);
-   spec->sp_form = form_code;
-   spec->sp_val.sp_set_ptr = target_root;
+   spec_set_form(spec,form_code);
+   spec_set_val(spec,sp_set_ptr,target_root);
 
    return;
 
@@ -6630,16 +5375,9 @@ case ft_tuple :
 
 {
 int32 tuple_length;                    /* length of tuple                   */
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-int target_height, target_index;       /* current height and index          */
+tuple_h_ptr_type target_root;          /* root of created tuple             */
+tuple_c_ptr_type target_cell;          /* created cell                      */
 specifier target_element;              /* tuple element                     */
-int32 target_number;                   /* target element number             */
-tuple_h_ptr_type new_hdr;              /* created header node               */
-tuple_c_ptr_type new_cell;             /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int i;                                 /* temporary looping variable        */
 
    /* get the tuple_length */
 
@@ -6647,15 +5385,8 @@ int i;                                 /* temporary looping variable        */
 
    /* create a new tuple for the target */
 
-   get_tuple_header(target_root);
-   target_root->t_use_count = 1;
-   target_root->t_hash_code = 0;
-   target_root->t_ntype.t_root.t_length = 0;
-   target_root->t_ntype.t_root.t_height = 0;
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        target_root->t_child[i++].t_cell = NULL);
-   expansion_trigger = TUP_HEADER_SIZE;
+   target_root = new_tuple(SETL_SYSTEM_VOID);
+   reserve_tuple(target_root,tuple_length);
 
    /* insert elements until we find a right brace */
 
@@ -6663,118 +5394,45 @@ int i;                                 /* temporary looping variable        */
 
       for (;;) {
 
-         target_element.sp_form = ft_omega;
+         spec_set_form(&target_element,ft_omega);
+         unbinstr_skip = -1;
          unbinstr_spec(SETL_SYSTEM &target_element);
 
-         if (target_element.sp_form == SKIP_CODE) {
+         if (unbinstr_skip >= 0) {
 
-            target_root->t_ntype.t_root.t_length =
-               target_element.sp_val.sp_short_value;
+            extend_tuple(target_root,unbinstr_skip);
 
             continue;
 
          }
 
-         /*
-          *  At this point we have an element we would like to insert into
-          *  the target.
-          */
-
-         target_number = target_root->t_ntype.t_root.t_length++;
-
-         /* expand the target header if necessary */
-
-         while (target_root->t_ntype.t_root.t_length >= expansion_trigger) {
-
-            target_work_hdr = target_root;
-
-            get_tuple_header(target_root);
-
-            target_root->t_use_count = 1;
-            target_root->t_hash_code =
-                  target_work_hdr->t_hash_code;
-            target_root->t_ntype.t_root.t_length =
-                  target_work_hdr->t_ntype.t_root.t_length;
-            target_root->t_ntype.t_root.t_height =
-                  target_work_hdr->t_ntype.t_root.t_height + 1;
-
-            for (i = 1;
-                 i < TUP_HEADER_SIZE;
-                 target_root->t_child[i++].t_header = NULL);
-
-            target_root->t_child[0].t_header = target_work_hdr;
-
-            target_work_hdr->t_ntype.t_intern.t_parent = target_root;
-            target_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-            expansion_trigger *= TUP_HEADER_SIZE;
-
-         }
-
-         /* descend the header tree until we get to a leaf */
-
-         target_work_hdr = target_root;
-         for (target_height = target_root->t_ntype.t_root.t_height;
-              target_height;
-              target_height--) {
-
-            /* extract the element's index at this level */
-
-            target_index = (target_number >>
-                                 (target_height * TUP_SHIFT_DIST)) &
-                              TUP_SHIFT_MASK;
-
-            /* if we're missing a header record, allocate one */
-
-            if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-               get_tuple_header(new_hdr);
-               new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-               new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-               for (i = 0;
-                    i < TUP_HEADER_SIZE;
-                    new_hdr->t_child[i++].t_cell = NULL);
-
-               target_work_hdr->t_child[target_index].t_header = new_hdr;
-               target_work_hdr = new_hdr;
-
-            }
-            else {
-
-               target_work_hdr =
-                  target_work_hdr->t_child[target_index].t_header;
-
-            }
-         }
-
-         /*
-          *  At this point, target_work_hdr points to the lowest level header
-          *  record.  We insert the new element in the appropriate slot.
-          */
+         /* append the element to the end of the tuple */
 
-         get_tuple_cell(new_cell);
-         new_cell->t_spec.sp_form = target_element.sp_form;
-         new_cell->t_spec.sp_val.sp_biggest =
-            target_element.sp_val.sp_biggest;
-         spec_hash_code(new_cell->t_hash_code,&target_element);
-         target_index = target_number & TUP_SHIFT_MASK;
-         target_work_hdr->t_child[target_index].t_cell = new_cell;
-         target_root->t_hash_code ^= new_cell->t_hash_code;
+         reserve_tuple(target_root,target_root->t_length + 1);
+         target_cell = target_root->t_cells + target_root->t_length++;
+         spec_set_form(&target_cell->t_spec,spec_form(&target_element));
+         spec_set_val(&target_cell->t_spec,sp_biggest,
+            spec_val(&target_element,sp_biggest));
+         spec_hash_code(target_cell->t_hash_code,&target_element);
+         target_root->t_hash_code ^= target_cell->t_hash_code;
 
          /* break when we've loaded the entire tuple */
 
-         if (target_number == tuple_length - 1)
+         if (target_root->t_length >= tuple_length)
             break;
 
       }
    }
 
+   /* tuples of numbers are packed, as they were when saved */
+
+   pack_tuple(SETL_SYSTEM target_root);
+
    /* set the target and return */
 
    unmark_specifier(spec);
-   spec->sp_form = form_code;
-   spec->sp_val.sp_tuple_ptr = target_root;
+   spec_set_form(spec,form_code);
+   spec_set_val(spec,sp_tuple_ptr,target_root);
 
    return;
 
@@ -6883,7 +5541,7 @@ int i;                                 /* temporary looping variable        */
       target_index = target_number & OBJ_SHIFT_MASK;
       get_object_cell(object_cell);
       object_work_hdr->o_child[target_index].o_cell = object_cell;
-      object_cell->o_spec.sp_form = ft_omega;
+      spec_set_form(&object_cell->o_spec,ft_omega);
       unbinstr_spec(SETL_SYSTEM &(object_cell->o_spec));
       spec_hash_code(object_cell->o_hash_code,&(object_cell->o_spec));
       object_root->o_hash_code ^= object_cell->o_hash_code;
@@ -6907,8 +5565,8 @@ int i;                                 /* temporary looping variable        */
    /* set the target and return */
 
    unmark_specifier(spec);
-   spec->sp_form = ft_object;
-   spec->sp_val.sp_object_ptr = object_root;
+   spec_set_form(spec,ft_object);
+   spec_set_val(spec,sp_object_ptr,object_root);
 
    return;
 
@@ -6942,7 +5600,6 @@ void setl2_popen(
 {
 #if UNIX
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 char *command;                         /* system command                    */
 int to_parent[2];                      /* file descriptors to parent        */
 int to_child[2];                       /* file descriptors to child         */
@@ -6950,53 +5607,30 @@ FILE *pipe_handle[2];                  /* file pointer versions             */
 tuple_h_ptr_type target_root;          /* root of returned tuple            */
 tuple_c_ptr_type new_tuple_cell;       /* created cell node                 */
 specifier file_atom;                   /* file handle atom                  */
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
-map_c_ptr_type map_cell;               /* current cell pointer              */
-map_c_ptr_type *map_tail;              /* attach new cells here             */
-int map_height, map_index;             /* current height and index          */
-map_h_ptr_type new_hdr;                /* created header node               */
+int is_new;                            /* YES if a cell was added           */
 map_c_ptr_type new_map_cell;           /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-char *s, *t;                           /* temporary looping variables       */
-int i,j;                               /* temporary looping variables       */
+int j;                                 /* temporary looping variable        */
 
    /* convert the command to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"popen",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    command = (char *)malloc(string_hdr->s_length + 1);
    if (command == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = command;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < command + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)command,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    /* create a new tuple for the target */
 
-   get_tuple_header(target_root);
-   target_root->t_use_count = 1;
-   target_root->t_hash_code = 0;
-   target_root->t_ntype.t_root.t_length = 2;
-   target_root->t_ntype.t_root.t_height = 0;
-   for (i = 2;
-        i < TUP_HEADER_SIZE;
-        target_root->t_child[i++].t_cell = NULL);
+   target_root = new_tuple(SETL_SYSTEM_VOID);
+   reserve_tuple(target_root,2);
+   target_root->t_length = 2;
 
    /* create the pipes */
 
@@ -7022,98 +5656,54 @@ int i,j;                               /* temporary looping variables       */
          file_ptr->f_mode = TEXT_OUT;
       }
       else {
-         file_ptr->f_mode = BYTE_IN;
-      }
-
-      /* now enter the file in the file map */
-
-      file_atom.sp_form = ft_omega;
-      setl2_newat(SETL_SYSTEM 0,NULL,&file_atom);
-
-      map_work_hdr = file_map;
-      work_hash_code = file_atom.sp_val.sp_atom_num;
-      for (map_height = file_map->m_ntype.m_root.m_height;
-           map_height;
-           map_height--) {
 
-         /* extract the element's index at this level */
-
-         map_index = work_hash_code & MAP_HASH_MASK;
-         work_hash_code >>= MAP_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (map_work_hdr->m_child[map_index].m_header == NULL) {
-
-            get_map_header(new_hdr);
-            new_hdr->m_ntype.m_intern.m_parent = map_work_hdr;
-            new_hdr->m_ntype.m_intern.m_child_index = map_index;
-            for (i = 0;
-                 i < MAP_HASH_SIZE;
-                 new_hdr->m_child[i++].m_cell = NULL);
-            map_work_hdr->m_child[map_index].m_header = new_hdr;
-            map_work_hdr = new_hdr;
+         /*
+          *  We read the command's output through our own buffer, not
+          *  the stream's, so getchar knows whether anything is waiting.
+          */
 
-         }
-         else {
+         file_ptr->f_mode = BYTE_IN;
+         file_ptr->f_file_fd = to_parent[0];
+         file_ptr->f_file_buffer =
+            (unsigned char *)malloc((size_t)FILE_BUFF_SIZE);
+         if (file_ptr->f_file_buffer == NULL)
+            giveup(SETL_SYSTEM msg_malloc_error);
 
-            map_work_hdr = map_work_hdr->m_child[map_index].m_header;
+         file_ptr->f_start = file_ptr->f_endofbuffer =
+            file_ptr->f_file_buffer;
+         file_ptr->f_eof_ptr = NULL;
 
-         }
       }
 
-      /*
-       *  At this point, map_work_hdr points to the lowest level
-       *  header record.
-       */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      map_tail = &(map_work_hdr->m_child[map_index].m_cell);
-      for (map_cell = *map_tail;
-           map_cell != NULL &&
-              map_cell->m_hash_code < file_atom.sp_val.sp_atom_num;
-           map_cell = map_cell->m_next) {
+      /* now enter the file in the file map */
 
-         map_tail = &(map_cell->m_next);
+      spec_set_form(&file_atom,ft_omega);
+      setl2_newat(SETL_SYSTEM 0,NULL,&file_atom);
 
-      }
+      new_map_cell = map_locate(&(file_map->m_trie),
+                                &file_atom,
+                                spec_val(&file_atom,sp_atom_num),
+                                &is_new);
 
-      /* we don't have to worry about duplicates -- add a cell */
+      /* atoms are unique, so we don't have to worry about duplicates */
 
-      get_map_cell(new_map_cell);
-      new_map_cell->m_domain_spec.sp_form = ft_atom;
-      new_map_cell->m_domain_spec.sp_val.sp_atom_num =
-           file_atom.sp_val.sp_atom_num;
-      new_map_cell->m_range_spec.sp_form = ft_file;
-      new_map_cell->m_range_spec.sp_val.sp_file_ptr = file_ptr;
+      spec_set_form(&new_map_cell->m_domain_spec,ft_atom);
+      spec_set_val(&new_map_cell->m_domain_spec,sp_atom_num,
+           spec_val(&file_atom,sp_atom_num));
+      spec_set_form(&new_map_cell->m_range_spec,ft_file);
+      spec_set_val(&new_map_cell->m_range_spec,sp_file_ptr,file_ptr);
       new_map_cell->m_is_multi_val = NO;
-      new_map_cell->m_hash_code = file_atom.sp_val.sp_atom_num;
-      new_map_cell->m_next = *map_tail;
-      *map_tail = new_map_cell;
-      file_map->m_ntype.m_root.m_cardinality++;
-      file_map->m_ntype.m_root.m_cell_count++;
-      file_map->m_hash_code ^= file_atom.sp_val.sp_atom_num;
-
-      expansion_trigger =
-            (1 << ((file_map->m_ntype.m_root.m_height + 1)
-                       * MAP_SHIFT_DIST)) * MAP_CLASH_SIZE;
-
-      /* expand the map header if necessary */
-
-      if (file_map->m_ntype.m_root.m_cardinality > expansion_trigger) {
-
-         file_map = map_expand_header(SETL_SYSTEM file_map);
-
-      }
+      file_map->m_cardinality++;
+      file_map->m_cell_count++;
+      file_map->m_hash_code ^= spec_val(&file_atom,sp_atom_num);
 
       /* finally, stick it in the tuple to be returned */
 
-      get_tuple_cell(new_tuple_cell);
-      new_tuple_cell->t_spec.sp_form = file_atom.sp_form;
-      new_tuple_cell->t_spec.sp_val.sp_biggest =
-         file_atom.sp_val.sp_biggest;
+      new_tuple_cell = target_root->t_cells + j;
+      spec_set_form(&new_tuple_cell->t_spec,spec_form(&file_atom));
+      spec_set_val(&new_tuple_cell->t_spec,sp_biggest,
+         spec_val(&file_atom,sp_biggest));
       spec_hash_code(new_tuple_cell->t_hash_code,&file_atom);
-      target_root->t_child[j].t_cell = new_tuple_cell;
       target_root->t_hash_code ^= new_tuple_cell->t_hash_code;
 
    }
@@ -7131,8 +5721,8 @@ int i,j;                               /* temporary looping variables       */
       /* return the tuple we created */
 
       unmark_specifier(target);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = target_root;
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,target_root);
 
       return;
 
@@ -7172,107 +5762,91 @@ void setl2_getchar(
 
 {
 #ifdef UNIX
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 string_h_ptr_type string_hdr;          /* created string header             */
-string_c_ptr_type string_cell;         /* current string cell               */
+ssize_t count;                         /* characters read                   */
 char c;                                /* character from file               */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
    if (file_ptr->f_mode != BYTE_IN)
       abend(SETL_SYSTEM msg_get_not_text,file_ptr->f_file_name);
    file_name = file_ptr->f_file_name;
    file_stream = file_ptr->f_file_stream;
    file_fd = file_ptr->f_file_fd;
 
-   /* read one character */
+   /* refill the buffer when it is empty */
 
-   if (fread((void *)(&c),
-             sizeof(char),
-             (size_t)1,
-             file_ptr->f_file_stream) != (size_t)1) {
+   if (file_ptr->f_start >= file_ptr->f_endofbuffer) {
+
+#ifdef PROCESSES
 
-      /* if we didn't get one, check for errors */
+      /*
+       *  If the pipe is empty too, we let other processes run until the
+       *  command writes something.
+       */
+
+      struct pollfd pipe_poll;         /* pipe readiness                    */
+
+      pipe_poll.fd = file_fd;
+      pipe_poll.events = POLLIN;
+      if (poll(&pipe_poll,(nfds_t)1,0) == 0 &&
+          reactor_park(SETL_SYSTEM file_fd,-1L,setl2_getchar,argc,argv))
+         return;
+
+#endif
+
+      while ((count = read(file_fd,(void *)file_ptr->f_file_buffer,
+                           (size_t)FILE_BUFF_SIZE)) < 0 &&
+             errno == EINTR);
 
-      if (ferror(file_ptr->f_file_stream) != 0)
+      if (count < 0)
          giveup(SETL_SYSTEM "Disk error reading %s",file_ptr->f_file_name);
 
-      /* no error means end of file */
+      /* nothing read means end of file */
 
-      eof_flag = YES;
-      unmark_specifier(target);
-      target->sp_form = ft_omega;
+      if (count == 0) {
 
-      return;
+         eof_flag = YES;
+         unmark_specifier(target);
+         spec_set_form(target,ft_omega);
+
+         return;
+
+      }
+
+      file_ptr->f_start = file_ptr->f_file_buffer;
+      file_ptr->f_endofbuffer = file_ptr->f_file_buffer + count;
 
    }
 
+   c = (char)*(file_ptr->f_start++);
+
    /* set the return string */
 
    eof_flag = NO;
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 1;
-   get_string_cell(string_cell);
-   string_cell->s_prev = NULL;
-   string_cell->s_next = NULL;
-   string_hdr->s_tail = string_cell;
-   string_hdr->s_head = string_cell;
-   string_cell->s_cell_value[0] = c;
+   string_hdr = new_string_buffer(SETL_SYSTEM 1);
+   string_hdr->s_chars[0] = c;
 
    /* set the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 #endif
@@ -7294,60 +5868,26 @@ void setl2_fflush(
 
 {
 #if UNIX
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
 map_c_ptr_type map_cell;               /* current cell pointer              */
-int map_height, map_index;             /* current height and index          */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
 string_h_ptr_type string_hdr;          /* created string header             */
-string_c_ptr_type string_cell;         /* current string cell               */
 char c;                                /* character from file               */
 
    /* file handles must be atoms */
 
-   if (argv[0].sp_form != ft_atom)
+   if (spec_form(&argv[0]) != ft_atom)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* look up the map component */
 
-   map_work_hdr = file_map;
-   work_hash_code = argv[0].sp_val.sp_atom_num;
-
-   for (map_height = map_work_hdr->m_ntype.m_root.m_height;
-        map_height && map_work_hdr != NULL;
-        map_height--) {
-
-      /* extract the element's index at this level */
-
-      map_index = work_hash_code & MAP_HASH_MASK;
-      work_hash_code = work_hash_code >> MAP_SHIFT_DIST;
-
-      map_work_hdr = map_work_hdr->m_child[map_index].m_header;
-
-   }
-
-   /* if we can't get to a leaf, there is no matching element */
-
-   if (map_work_hdr == NULL)
-      abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
-
-   /*
-    *  At this point, map_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   map_index = work_hash_code & MAP_HASH_MASK;
-   for (map_cell = map_work_hdr->m_child[map_index].m_cell;
-        map_cell != NULL &&
-           map_cell->m_hash_code < argv[0].sp_val.sp_atom_num;
-        map_cell = map_cell->m_next);
-
-   if (map_cell->m_domain_spec.sp_val.sp_atom_num !=
-       argv[0].sp_val.sp_atom_num)
+   map_cell = map_lookup(file_map->m_trie,
+                         &(argv[0]),
+                         spec_val(&argv[0],sp_atom_num));
+   if (map_cell == NULL)
       abend(SETL_SYSTEM msg_bad_file_handle,abend_opnd_str(SETL_SYSTEM argv));
 
    /* load file stuff from file node */
 
-   file_ptr = map_cell->m_range_spec.sp_val.sp_file_ptr;
+   file_ptr = spec_val(&map_cell->m_range_spec,sp_file_ptr);
    file_stream = file_ptr->f_file_stream;
    file_fd = file_ptr->f_file_fd;
 
@@ -7356,7 +5896,7 @@ char c;                                /* character from file               */
    /* set the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 #endif
@@ -39,6 +39,10 @@
  *  \packagebody{Iterators}
 \*/
 
+/* standard C header files */
+
+#include <string.h>                    /* memmove                           */
+
 /* SETL2 system header files */
 
 #include "system.h"                    /* SETL2 system constants            */
@@ -62,57 +66,6 @@
 #include "iters.h"                     /* iterators                         */
 
 
-/* performance tuning constants */
-
-#define ITER_BLOCK_SIZE        50      /* iterator block size               */
-
-/*\
- *  \function{alloc\_iterators()}
- *
- *  This function allocates a block of iterators and links them together
- *  into a free list.  Note carefully the castes used here: we caste
- *  iterator items to pointers to iterator items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the iterator
- *  node.  It will work provided a iterator item is larger than a
- *  pointer, which is the case.
-\*/
-
-void alloc_iterators(
-   SETL_SYSTEM_PROTO_VOID)
-
-{
-iter_ptr_type new_block;               /* first iterator in allocated block */
-
-   /* allocate a new block */
-
-   new_block = (iter_ptr_type)malloc((size_t)
-         (ITER_BLOCK_SIZE * sizeof(struct iter_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (ITER_NEXT_FREE = new_block;
-        ITER_NEXT_FREE < new_block + ITER_BLOCK_SIZE - 1;
-        ITER_NEXT_FREE++) {
-
-      *((iter_ptr_type *)ITER_NEXT_FREE) = ITER_NEXT_FREE + 1;
-
-   }
-
-   *((iter_ptr_type *)ITER_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   ITER_NEXT_FREE = new_block;
-
-   return;
-
-}
-
 /*\
  *  \function{start\_set\_iterator()}
  *
@@ -136,22 +89,18 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_setiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_setiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_setiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_setiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
-   iter_ptr->it_itype.it_setiter.it_source_work_hdr =
-         left->sp_val.sp_set_ptr;
-   iter_ptr->it_itype.it_setiter.it_source_cell = NULL;
-   iter_ptr->it_itype.it_setiter.it_source_height =
-         (left->sp_val.sp_set_ptr)->s_ntype.s_root.s_height;
-   iter_ptr->it_itype.it_setiter.it_source_index = 0;
+   set_cursor_start(&(iter_ptr->it_itype.it_setiter.it_cursor),
+                    spec_val(left,sp_set_ptr)->s_trie);
 
    /* set the target value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    return;
 
@@ -161,8 +110,7 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
  *  \function{set\_iterator\_next()}
  *
  *  This function picks out the next item in an iteration over a set.
- *  The algorithm is the same as those in the set package, except that we
- *  use the iterator record to keep track of the position in the set.
+ *  The set package's cursor keeps track of our position in the set.
 \*/
 
 int set_iterator_next(
@@ -172,98 +120,28 @@ int set_iterator_next(
 
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-
-   /* reload the iteration variables */
-
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   source_root =
-         iter_ptr->it_itype.it_setiter.it_spec.sp_val.sp_set_ptr;
-   source_work_hdr = iter_ptr->it_itype.it_setiter.it_source_work_hdr;
-   source_cell = iter_ptr->it_itype.it_setiter.it_source_cell;
-   source_height = iter_ptr->it_itype.it_setiter.it_source_height;
-   source_index = iter_ptr->it_itype.it_setiter.it_source_index;
-
-   /* loop until we explicitly return */
-
-   for (;;) {
-
-      /* if we have an element already, return it */
-
-      if (source_cell != NULL) {
-
-         mark_specifier(&(source_cell->s_spec));
-         unmark_specifier(target);
-         target->sp_form = source_cell->s_spec.sp_form;
-         target->sp_val.sp_biggest =
-               source_cell->s_spec.sp_val.sp_biggest;
-
-         source_cell = source_cell->s_next;
-
-         iter_ptr->it_itype.it_setiter.it_source_work_hdr =
-               source_work_hdr;
-         iter_ptr->it_itype.it_setiter.it_source_cell = source_cell;
-         iter_ptr->it_itype.it_setiter.it_source_height = source_height;
-         iter_ptr->it_itype.it_setiter.it_source_index = source_index;
-
-         return YES;
 
-      }
-
-      /* start on the next clash list, if we're at a leaf */
-
-      if (!source_height && source_index < SET_HASH_SIZE) {
-
-         source_cell = source_work_hdr->s_child[source_index].s_cell;
-         source_index++;
-         continue;
-
-      }
-
-      /* move up if we're at the end of a node */
-
-      if (source_index >= SET_HASH_SIZE) {
-
-         /* if we return to the root the set is exhausted */
-
-         if (source_work_hdr == source_root) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_omega;
-            return NO;
-
-         }
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   source_cell = set_cursor_next(&(iter_ptr->it_itype.it_setiter.it_cursor));
 
-         source_height++;
-         source_index =
-            source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         source_work_hdr =
-            source_work_hdr->s_ntype.s_intern.s_parent;
-
-         continue;
-
-      }
+   /* if the set is exhausted, return NO */
 
-      /* skip over null nodes */
-
-      if (source_work_hdr->s_child[source_index].s_header == NULL) {
+   if (source_cell == NULL) {
 
-         source_index++;
-         continue;
+      unmark_specifier(target);
+      spec_set_form(target,ft_omega);
+      return NO;
 
-      }
+   }
 
-      /* otherwise drop down a level */
+   mark_specifier(&(source_cell->s_spec));
+   unmark_specifier(target);
+   spec_set_form(target,spec_form(&source_cell->s_spec));
+   spec_set_val(target,sp_biggest,spec_val(&source_cell->s_spec,sp_biggest));
 
-      source_work_hdr =
-         source_work_hdr->s_child[source_index].s_header;
-      source_index = 0;
-      source_height--;
+   return YES;
 
-   }
 }
 
 /*\
@@ -289,327 +167,163 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_mapiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_mapiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_mapiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_mapiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
-   iter_ptr->it_itype.it_mapiter.it_source_work_hdr =
-         left->sp_val.sp_map_ptr;
+   set_cursor_start(&(iter_ptr->it_itype.it_mapiter.it_cursor),
+                    spec_val(left,sp_map_ptr)->m_trie);
    iter_ptr->it_itype.it_mapiter.it_source_cell = NULL;
-   iter_ptr->it_itype.it_mapiter.it_source_height =
-         (left->sp_val.sp_map_ptr)->m_ntype.m_root.m_height;
-   iter_ptr->it_itype.it_mapiter.it_source_index = 0;
-   iter_ptr->it_itype.it_mapiter.it_valset_root = NULL;
 
    /* set the target value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    return;
 
 }
 
 /*\
- *  \function{map\_iterator\_next()}
+ *  \function{map\_pair\_tuple()}
  *
- *  This function picks out the next item in an iteration over a map.
- *  We produce the next pair, using the same algorithm we use to convert
- *  maps to sets.
+ *  This function forms a pair from a domain and range element, for the
+ *  iterators which produce the elements of a map as tuples.
 \*/
 
-int map_iterator_next(
+static tuple_h_ptr_type map_pair_tuple(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* next element in set               */
-   specifier *source)                  /* iterator item                     */
+   specifier *domain_element,          /* domain element                    */
+   int32 domain_hash_code,             /* hash code of domain element       */
+   specifier *range_element,           /* range element                     */
+   int32 range_hash_code)              /* hash code of range element        */
 
 {
-iter_ptr_type iter_ptr;                /* iterator pointer                  */
-map_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-map_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
 tuple_h_ptr_type tuple_root;           /* tuple header                      */
 tuple_c_ptr_type tuple_cell;           /* tuple cell node                   */
-set_h_ptr_type valset_root, valset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type valset_cell;            /* current cell pointer              */
-int valset_height, valset_index;       /* current height and index          */
-int i;                                 /* temporary looping variable        */
-
-   /* reload the iteration variables */
 
-   iter_ptr = source->sp_val.sp_iter_ptr;
-   source_root = iter_ptr->it_itype.it_mapiter.it_spec.sp_val.sp_map_ptr;
-   source_work_hdr = iter_ptr->it_itype.it_mapiter.it_source_work_hdr;
-   source_cell = iter_ptr->it_itype.it_mapiter.it_source_cell;
-   source_height = iter_ptr->it_itype.it_mapiter.it_source_height;
-   source_index = iter_ptr->it_itype.it_mapiter.it_source_index;
-   valset_root = iter_ptr->it_itype.it_mapiter.it_valset_root;
-   valset_work_hdr = iter_ptr->it_itype.it_mapiter.it_valset_work_hdr;
-   valset_cell = iter_ptr->it_itype.it_mapiter.it_valset_cell;
-   valset_height = iter_ptr->it_itype.it_mapiter.it_valset_height;
-   valset_index = iter_ptr->it_itype.it_mapiter.it_valset_index;
-
-   /* loop until we explicitly return */
+   tuple_root = new_tuple(SETL_SYSTEM_VOID);
+   tuple_root->t_length = 2;
 
-   for (;;) {
+   /* insert domain element */
 
-      /* find the next element in the map */
+   tuple_cell = tuple_root->t_cells;
+   mark_specifier(domain_element);
+   spec_set_form(&tuple_cell->t_spec,spec_form(domain_element));
+   spec_set_val(&tuple_cell->t_spec,sp_biggest,
+         spec_val(domain_element,sp_biggest));
+   tuple_cell->t_hash_code = domain_hash_code;
+   tuple_root->t_hash_code ^= domain_hash_code;
 
-      while (source_cell == NULL) {
+   /* insert range element */
 
-         /* start on the next clash list, if we're at a leaf */
+   tuple_cell++;
+   mark_specifier(range_element);
+   spec_set_form(&tuple_cell->t_spec,spec_form(range_element));
+   spec_set_val(&tuple_cell->t_spec,sp_biggest,
+         spec_val(range_element,sp_biggest));
+   tuple_cell->t_hash_code = range_hash_code;
+   tuple_root->t_hash_code ^= range_hash_code;
 
-         if (!source_height && source_index < MAP_HASH_SIZE) {
+   return tuple_root;
 
-            source_cell = source_work_hdr->m_child[source_index].m_cell;
-            source_index++;
+}
 
-            continue;
+/*\
+ *  \function{map\_iterator\_next()}
+ *
+ *  This function picks out the next item in an iteration over a map.
+ *  We produce the next pair, in the same order we use to convert maps
+ *  to sets.
+\*/
 
-         }
+int map_iterator_next(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* next element in set               */
+   specifier *source)                  /* iterator item                     */
 
-         /* move up if we're at the end of a node */
+{
+iter_ptr_type iter_ptr;                /* iterator pointer                  */
+map_c_ptr_type source_cell;            /* current cell pointer              */
+set_c_ptr_type valset_cell;            /* current cell pointer              */
+tuple_h_ptr_type tuple_root;           /* returned pair                     */
+int32 range_hash_code;                 /* hash code of range element        */
 
-         if (source_index >= MAP_HASH_SIZE) {
+   iter_ptr = spec_val(source,sp_iter_ptr);
 
-            /* there are no more elements, so break */
+   /* loop until we explicitly return */
 
-            if (source_work_hdr == source_root)
-               break;
+   for (;;) {
 
-            /* otherwise move up */
+      /* if we're in a multi-value set, return its next element */
 
-            source_height++;
-            source_index =
-               source_work_hdr->m_ntype.m_intern.m_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->m_ntype.m_intern.m_parent;
+      source_cell = iter_ptr->it_itype.it_mapiter.it_source_cell;
+      if (source_cell != NULL) {
 
-            continue;
+         valset_cell = set_cursor_next(
+               &(iter_ptr->it_itype.it_mapiter.it_valset_cursor));
 
-         }
+         if (valset_cell != NULL) {
 
-         /* skip over null nodes */
+            tuple_root = map_pair_tuple(SETL_SYSTEM
+                                        &(source_cell->m_domain_spec),
+                                        source_cell->m_hash_code,
+                                        &(valset_cell->s_spec),
+                                        valset_cell->s_hash_code);
 
-         if (source_work_hdr->m_child[source_index].m_header == NULL) {
+            unmark_specifier(target);
+            spec_set_form(target,ft_tuple);
+            spec_set_val(target,sp_tuple_ptr,tuple_root);
 
-            source_index++;
-            continue;
+            return YES;
 
          }
 
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->m_child[source_index].m_header;
-         source_index = 0;
-         source_height--;
+         iter_ptr->it_itype.it_mapiter.it_source_cell = NULL;
 
       }
 
-      /* if the map is empty, return NO */
+      /* find the next cell in the map */
+
+      source_cell = map_cursor_next(
+            &(iter_ptr->it_itype.it_mapiter.it_cursor));
+
+      /* if the map is exhausted, return NO */
 
       if (source_cell == NULL) {
 
          unmark_specifier(target);
-         target->sp_form = ft_omega;
+         spec_set_form(target,ft_omega);
 
          return NO;
 
       }
 
-      /* save our location in the map */
-
-      iter_ptr->it_itype.it_mapiter.it_source_work_hdr = source_work_hdr;
-      iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell;
-      iter_ptr->it_itype.it_mapiter.it_source_height = source_height;
-      iter_ptr->it_itype.it_mapiter.it_source_index = source_index;
-      iter_ptr->it_itype.it_mapiter.it_valset_root = valset_root;
-
       /* if we're not at a multi-value cell, return the pair */
 
       if (!(source_cell->m_is_multi_val)) {
 
-         /*
-          *  At this point we have a pair from the map, and the hash code
-          *  of the domain element.  We have to form a tuple from this
-          *  pair.
-          */
-
-         get_tuple_header(tuple_root);
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code = 0;
-         tuple_root->t_ntype.t_root.t_length = 2;
-         tuple_root->t_ntype.t_root.t_height = 0;
-         for (i = 2;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_cell = NULL);
-
-         /* insert domain element */
-
-         get_tuple_cell(tuple_cell);
-         mark_specifier(&(source_cell->m_domain_spec));
-         tuple_cell->t_spec.sp_form = source_cell->m_domain_spec.sp_form;
-         tuple_cell->t_spec.sp_val.sp_biggest =
-               source_cell->m_domain_spec.sp_val.sp_biggest;
-
-         tuple_cell->t_hash_code = source_cell->m_hash_code;
-         tuple_root->t_hash_code ^= source_cell->m_hash_code;
-         tuple_root->t_child[0].t_cell = tuple_cell;
-
-         /* insert range element */
-
-         get_tuple_cell(tuple_cell);
-         mark_specifier(&(source_cell->m_range_spec));
-         tuple_cell->t_spec.sp_form = source_cell->m_range_spec.sp_form;
-         tuple_cell->t_spec.sp_val.sp_biggest =
-               source_cell->m_range_spec.sp_val.sp_biggest;
-
-         spec_hash_code(tuple_cell->t_hash_code,&(source_cell->m_range_spec));
-         tuple_root->t_hash_code ^=
-               tuple_cell->t_hash_code;
-         tuple_root->t_child[1].t_cell = tuple_cell;
+         spec_hash_code(range_hash_code,&(source_cell->m_range_spec));
+         tuple_root = map_pair_tuple(SETL_SYSTEM
+                                     &(source_cell->m_domain_spec),
+                                     source_cell->m_hash_code,
+                                     &(source_cell->m_range_spec),
+                                     range_hash_code);
 
          unmark_specifier(target);
-         target->sp_form = ft_tuple;
-         target->sp_val.sp_tuple_ptr = tuple_root;
-
-         iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell->m_next;
+         spec_set_form(target,ft_tuple);
+         spec_set_val(target,sp_tuple_ptr,tuple_root);
 
          return YES;
 
       }
 
-      /* otherwise we find the next item in the multi-value set */
-
-      if (valset_root == NULL) {
-
-         valset_root = source_cell->m_range_spec.sp_val.sp_set_ptr;
-         valset_work_hdr = valset_root;
-         valset_height = valset_root->s_ntype.s_root.s_height;
-         valset_cell = NULL;
-         valset_index = 0;
-
-      }
-
-      for (;;) {
-
-         /* if we have an element, return it */
-
-         if (valset_cell != NULL) {
-
-            /*
-             *  At this point we have a pair from the map, and the hash
-             *  code of the domain element.  We have to form a tuple from
-             *  this pair.
-             */
-
-            get_tuple_header(tuple_root);
-            tuple_root->t_use_count = 1;
-            tuple_root->t_hash_code = 0;
-            tuple_root->t_ntype.t_root.t_length = 2;
-            tuple_root->t_ntype.t_root.t_height = 0;
-            for (i = 2;
-                 i < TUP_HEADER_SIZE;
-                 tuple_root->t_child[i++].t_cell = NULL);
-
-            /* insert domain element */
-
-            get_tuple_cell(tuple_cell);
-            mark_specifier(&(source_cell->m_domain_spec));
-            tuple_cell->t_spec.sp_form = source_cell->m_domain_spec.sp_form;
-            tuple_cell->t_spec.sp_val.sp_biggest =
-                  source_cell->m_domain_spec.sp_val.sp_biggest;
-
-            tuple_cell->t_hash_code = source_cell->m_hash_code;
-            tuple_root->t_hash_code ^=
-                  source_cell->m_hash_code;
-            tuple_root->t_child[0].t_cell = tuple_cell;
-
-            /* insert range element */
-
-            get_tuple_cell(tuple_cell);
-            mark_specifier(&(valset_cell->s_spec));
-            tuple_cell->t_spec.sp_form = valset_cell->s_spec.sp_form;
-            tuple_cell->t_spec.sp_val.sp_biggest =
-                  valset_cell->s_spec.sp_val.sp_biggest;
-
-            tuple_cell->t_hash_code = valset_cell->s_hash_code;
-            tuple_root->t_hash_code ^=
-                  tuple_cell->t_hash_code;
-            tuple_root->t_child[1].t_cell = tuple_cell;
-
-            unmark_specifier(target);
-            target->sp_form = ft_tuple;
-            target->sp_val.sp_tuple_ptr = tuple_root;
-
-            iter_ptr->it_itype.it_mapiter.it_valset_root = valset_root;
-            iter_ptr->it_itype.it_mapiter.it_valset_work_hdr =
-                  valset_work_hdr;
-            iter_ptr->it_itype.it_mapiter.it_valset_cell =
-                  valset_cell->s_next;
-            iter_ptr->it_itype.it_mapiter.it_valset_height = valset_height;
-            iter_ptr->it_itype.it_mapiter.it_valset_index = valset_index;
-
-            return YES;
+      /* otherwise we start on the multi-value set */
 
-         }
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!valset_height && valset_index < SET_HASH_SIZE) {
-
-            valset_cell = valset_work_hdr->s_child[valset_index].s_cell;
-            valset_index++;
-
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (valset_index >= SET_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (valset_work_hdr == valset_root)
-               break;
-
-            /* otherwise move up */
-
-            valset_height++;
-            valset_index =
-               valset_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            valset_work_hdr =
-               valset_work_hdr->s_ntype.s_intern.s_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (valset_work_hdr->s_child[valset_index].s_header == NULL) {
-
-            valset_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         valset_work_hdr =
-            valset_work_hdr->s_child[valset_index].s_header;
-         valset_index = 0;
-         valset_height--;
-
-      }
-
-      source_cell = source_cell->m_next;
-      valset_root = NULL;
+      iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell;
+      set_cursor_start(&(iter_ptr->it_itype.it_mapiter.it_valset_cursor),
+            (spec_val(&source_cell->m_range_spec,sp_set_ptr))->s_trie);
 
    }
 }
@@ -637,15 +351,15 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_tupiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_tupiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_tupiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_tupiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
    iter_ptr->it_itype.it_tupiter.it_source_number = 0;
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
 }
 
@@ -663,24 +377,22 @@ int tuple_iterator_next(
 
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* tuple we are iterating over       */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
 int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   source_root = iter_ptr->it_itype.it_tupiter.it_spec.sp_val.sp_tuple_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   source_root = spec_val(&iter_ptr->it_itype.it_tupiter.it_spec,sp_tuple_ptr);
    source_number = iter_ptr->it_itype.it_tupiter.it_source_number;
 
    /* check whether the tuple is finished */
 
-   if (source_number >= source_root->t_ntype.t_root.t_length) {
+   if (source_number >= source_root->t_length) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
       return NO;
 
@@ -688,59 +400,25 @@ int source_height, source_index;       /* current height and index          */
 
    iter_ptr->it_itype.it_tupiter.it_source_number++;
 
-   /* descend the header tree until we get to a leaf */
-
-   source_work_hdr = source_root;
-   for (source_height = source_root->t_ntype.t_root.t_height;
-        source_height;
-        source_height--) {
-
-      /* extract the element's index at this level */
-
-      source_index = (source_number >>
-                           (source_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
-
-      /* if we're missing a header record, the element is om */
-
-      if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-         unmark_specifier(target);
-         target->sp_form = ft_omega;
-
-         return YES;
-
-      }
+   /* packed elements need no hold */
 
-      /* otherwise drop down a level */
-
-      source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-
-   }
-
-   /*
-    *  At this point, source_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   source_index = source_number & TUP_SHIFT_MASK;
-   if (source_work_hdr->t_child[source_index].t_cell == NULL) {
+   if (is_packed(source_root)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      get_packed_element(source_root,source_number,target);
 
       return YES;
 
    }
 
-   /* we do have an item to return */
+   /* return the element, which may be omega */
 
-   source_cell = source_work_hdr->t_child[source_index].t_cell;
+   source_cell = tuple_cell_at(source_root,source_number);
 
    mark_specifier(&(source_cell->t_spec));
    unmark_specifier(target);
-   target->sp_form = source_cell->t_spec.sp_form;
-   target->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&source_cell->t_spec));
+   spec_set_val(target,sp_biggest,spec_val(&source_cell->t_spec,sp_biggest));
 
    return YES;
 
@@ -769,18 +447,15 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_striter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_striter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_striter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_striter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
-   iter_ptr->it_itype.it_striter.it_string_cell =
-         (left->sp_val.sp_string_ptr)->s_head;
-   iter_ptr->it_itype.it_striter.it_string_index = 0;
    iter_ptr->it_itype.it_striter.it_char_number = 0;
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
 }
 
@@ -799,15 +474,12 @@ int string_iterator_next(
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
 string_h_ptr_type string_hdr;          /* string header node                */
-string_c_ptr_type string_cell;         /* current cell pointer              */
-int string_index;                      /* current index                     */
 string_h_ptr_type new_hdr;             /* created string header             */
-string_c_ptr_type new_cell;            /* created string cell               */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   string_hdr = iter_ptr->it_itype.it_striter.it_spec.sp_val.sp_string_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   string_hdr = spec_val(&iter_ptr->it_itype.it_striter.it_spec,sp_string_ptr);
 
    /* if there are no characters left we're done */
 
@@ -815,48 +487,27 @@ string_c_ptr_type new_cell;            /* created string cell               */
        string_hdr->s_length) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
       return NO;
 
    }
 
-   /* set up for the next character */
-
-   iter_ptr->it_itype.it_striter.it_char_number++;
-
-   string_cell = iter_ptr->it_itype.it_striter.it_string_cell;
-   string_index = iter_ptr->it_itype.it_striter.it_string_index;
-
-   if (string_index == STR_CELL_WIDTH) {
-
-      iter_ptr->it_itype.it_striter.it_string_cell =
-         string_cell = string_cell->s_next;
-      iter_ptr->it_itype.it_striter.it_string_index = string_index = 0;
-
-   }
-
-   iter_ptr->it_itype.it_striter.it_string_index++;
+   /* create a one character string, and move to the next character */
 
-   /* create a one character string */
+   new_hdr = new_string_chars(SETL_SYSTEM
+                              string_hdr->s_chars +
+                                 iter_ptr->it_itype.it_striter.it_char_number,
+                              1);
 
-   get_string_header(new_hdr);
-   new_hdr->s_use_count = 1;
-   new_hdr->s_hash_code = -1;
-   new_hdr->s_length = 1;
+   iter_ptr->it_itype.it_striter.it_char_number++;
 
-   get_string_cell(new_cell);
-   new_hdr->s_head = new_hdr->s_tail = new_cell;
-   new_cell->s_next = NULL;
-   new_cell->s_prev = NULL;
-   new_cell->s_cell_value[0] =
-      string_cell->s_cell_value[string_index];
 
    /* assign it to the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = new_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,new_hdr);
 
    return YES;
 
@@ -885,22 +536,19 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_mapiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_mapiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_mapiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_mapiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
-   iter_ptr->it_itype.it_mapiter.it_source_work_hdr =
-         left->sp_val.sp_map_ptr;
+   set_cursor_start(&(iter_ptr->it_itype.it_mapiter.it_cursor),
+                    spec_val(left,sp_map_ptr)->m_trie);
    iter_ptr->it_itype.it_mapiter.it_source_cell = NULL;
-   iter_ptr->it_itype.it_mapiter.it_source_height =
-         (left->sp_val.sp_map_ptr)->m_ntype.m_root.m_height;
-   iter_ptr->it_itype.it_mapiter.it_source_index = 0;
 
    /* set the target value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    return;
 
@@ -920,264 +568,144 @@ int domain_iterator_next(
 
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
-map_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
 map_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-
-   /* reload the iteration variables */
-
-   iter_ptr = source->sp_val.sp_iter_ptr;
-   source_root = iter_ptr->it_itype.it_mapiter.it_spec.sp_val.sp_map_ptr;
-   source_work_hdr = iter_ptr->it_itype.it_mapiter.it_source_work_hdr;
-   source_cell = iter_ptr->it_itype.it_mapiter.it_source_cell;
-   source_height = iter_ptr->it_itype.it_mapiter.it_source_height;
-   source_index = iter_ptr->it_itype.it_mapiter.it_source_index;
-
-   /* find the next element in the map */
-
-   while (source_cell == NULL) {
-
-      /* start on the next clash list, if we're at a leaf */
 
-      if (!source_height && source_index < MAP_HASH_SIZE) {
+   iter_ptr = spec_val(source,sp_iter_ptr);
+   source_cell = map_cursor_next(&(iter_ptr->it_itype.it_mapiter.it_cursor));
 
-         source_cell = source_work_hdr->m_child[source_index].m_cell;
-         source_index++;
-
-         continue;
-
-      }
-
-      /* move up if we're at the end of a node */
-
-      if (source_index >= MAP_HASH_SIZE) {
-
-         /* there are no more elements, so break */
-
-         if (source_work_hdr == source_root)
-            break;
-
-         /* otherwise move up */
-
-         source_height++;
-         source_index =
-            source_work_hdr->m_ntype.m_intern.m_child_index + 1;
-         source_work_hdr =
-            source_work_hdr->m_ntype.m_intern.m_parent;
-
-         continue;
-
-      }
-
-      /* skip over null nodes */
-
-      if (source_work_hdr->m_child[source_index].m_header == NULL) {
-
-         source_index++;
-         continue;
-
-      }
-
-      /* otherwise drop down a level */
-
-      source_work_hdr =
-         source_work_hdr->m_child[source_index].m_header;
-      source_index = 0;
-      source_height--;
-
-   }
-
-   /* if the map is empty, return NO */
+   /* if the map is exhausted, return NO */
 
    if (source_cell == NULL) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
       return NO;
 
    }
 
-   /* save our location in the map */
-
-   iter_ptr->it_itype.it_mapiter.it_source_work_hdr = source_work_hdr;
-   iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell;
-   iter_ptr->it_itype.it_mapiter.it_source_height = source_height;
-   iter_ptr->it_itype.it_mapiter.it_source_index = source_index;
-
    /* we return the domain element */
 
    mark_specifier(&(source_cell->m_domain_spec));
    unmark_specifier(target);
-   target->sp_form = source_cell->m_domain_spec.sp_form;
-   target->sp_val.sp_biggest =
-         source_cell->m_domain_spec.sp_val.sp_biggest;
-
-   iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell->m_next;
+   spec_set_form(target,spec_form(&source_cell->m_domain_spec));
+   spec_set_val(target,sp_biggest,
+         spec_val(&source_cell->m_domain_spec,sp_biggest));
 
    return YES;
 
 }
 
 /*\
- *  \function{start\_pow\_iterator()}
+ *  \function{pow\_elements()}
  *
- *  This function starts iteration over a power set.  We prefer to
- *  iterate over a power set rather than forming it.
+ *  This function creates the array of source set cells used by the
+ *  power set iterators.  Each element is initially out of the subset.
 \*/
 
-void start_pow_iterator(
+static struct source_elem_item *pow_elements(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* power set                         */
-   specifier *left)                    /* source set                        */
+   set_h_ptr_type source_root)         /* source set                        */
 
 {
-iter_ptr_type iter_ptr;                /* created iterator pointer          */
 struct source_elem_item *se_array;     /* array of source elements          */
-int se_array_length;                   /* length of above array             */
 int se_index;                          /* index into above array            */
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+struct set_cursor_item source_cursor;  /* source iteration cursor           */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-
-   /* allocate and initialize an iterator */
-
-   get_iterator(iter_ptr);
-   iter_ptr->it_use_count = 1;
-   iter_ptr->it_type = it_pow;
-
-   mark_specifier(left);
-
-   iter_ptr->it_itype.it_powiter.it_spec.sp_form = ft_set;
-   iter_ptr->it_itype.it_powiter.it_spec.sp_val.sp_set_ptr =
-         left->sp_val.sp_set_ptr;
-
-   source_root = left->sp_val.sp_set_ptr;
-
-   /* create an array of set elements in the source set */
-
-   se_array_length = (int)(source_root->s_ntype.s_root.s_cardinality);
 
    se_array = (struct source_elem_item *)malloc((size_t)
-                    (se_array_length * sizeof(struct source_elem_item)));
+                    ((source_root->s_cardinality + 1) *
+                     sizeof(struct source_elem_item)));
    if (se_array == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
-   se_index = 0;
-
-   /*
-    *  Set up to loop over the source set, producing one leaf node at a
-    *  time.
-    */
-
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_index = 0;
-
-   /* loop over the nodes of source */
 
-   for (;;) {
-
-      /* descend to a leaf */
-
-      while (source_height) {
-
-         /* move down if possible */
-
-         if (source_index < SET_HASH_SIZE) {
-
-            /* skip over null nodes */
-
-            if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-               source_index++;
-               continue;
-
-            }
+   se_index = 0;
+   set_cursor_start(&source_cursor,source_root->s_trie);
+   while ((source_cell = set_cursor_next(&source_cursor)) != NULL) {
 
-            /* we can move down, so do so */
+      se_array[se_index].se_element = source_cell;
+      se_array[se_index].se_in_set = NO;
+      se_index++;
 
-            source_work_hdr =
-               source_work_hdr->s_child[source_index].s_header;
-            source_index = 0;
-            source_height--;
+   }
 
-            continue;
+   return se_array;
 
-         }
+}
 
-         /* if there are no more elements, break */
+/*\
+ *  \function{pow\_subset()}
+ *
+ *  This function builds the subset of the source elements currently
+ *  marked as in the subset.
+\*/
 
-         if (source_work_hdr == source_root) {
+static set_h_ptr_type pow_subset(
+   SETL_SYSTEM_PROTO
+   struct source_elem_item *se_array,  /* array of source elements          */
+   int se_array_length)                /* length of above array             */
 
-            source_work_hdr = NULL;
-            break;
+{
+set_h_ptr_type subset_root;            /* subset being built                */
+int se_index;                          /* index into above array            */
 
-         }
+   subset_root = null_set(SETL_SYSTEM_VOID);
 
-         /* move up if we're at the end of a node */
+   for (se_index = 0; se_index < se_array_length; se_index++) {
 
-         source_height++;
-         source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         source_work_hdr =
-            source_work_hdr->s_ntype.s_intern.s_parent;
+      if (se_array[se_index].se_in_set) {
 
-         continue;
+         set_insert(SETL_SYSTEM subset_root,
+                    &(se_array[se_index].se_element->s_spec),
+                    se_array[se_index].se_element->s_hash_code);
 
       }
+   }
 
-      /* break if we can't find a leaf */
-
-      if (source_work_hdr == NULL)
-         break;
-
-      /*
-       *  At this point we have a leaf in the header tree.  We loop over
-       *  the elements in this leaf inserting each in the specifier
-       *  array.
-       */
-
-      for (source_index = 0; source_index < SET_HASH_SIZE; source_index++) {
+   return subset_root;
 
-         for (source_cell = source_work_hdr->s_child[source_index].s_cell;
-              source_cell != NULL;
-              source_cell = source_cell->s_next) {
+}
 
-            se_array[se_index].se_element = source_cell;
-            se_array[se_index].se_in_set = NO;
-            se_index++;
+/*\
+ *  \function{start\_pow\_iterator()}
+ *
+ *  This function starts iteration over a power set.  We prefer to
+ *  iterate over a power set rather than forming it.
+\*/
 
-         }
-      }
+void start_pow_iterator(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* power set                         */
+   specifier *left)                    /* source set                        */
 
-      /* if the leaf is the root, we're done */
+{
+iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
-      if (source_work_hdr == source_root)
-         break;
+   /* allocate and initialize an iterator */
 
-      /* set up to find the next leaf, by moving to the parent */
+   get_iterator(iter_ptr);
+   iter_ptr->it_use_count = 1;
+   iter_ptr->it_type = it_pow;
 
-      source_height++;
-      source_index =
-            source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-      source_work_hdr =
-         source_work_hdr->s_ntype.s_intern.s_parent;
+   mark_specifier(left);
 
-   }
+   spec_set_form(&iter_ptr->it_itype.it_powiter.it_spec,ft_set);
+   spec_set_val(&iter_ptr->it_itype.it_powiter.it_spec,sp_set_ptr,
+         spec_val(left,sp_set_ptr));
 
-   /* we've built up the array, set the iterator data */
+   /* create an array of set elements in the source set */
 
-   iter_ptr->it_itype.it_powiter.it_se_array = se_array;
-   iter_ptr->it_itype.it_powiter.it_se_array_length = se_array_length;
+   iter_ptr->it_itype.it_powiter.it_se_array =
+         pow_elements(SETL_SYSTEM spec_val(left,sp_set_ptr));
+   iter_ptr->it_itype.it_powiter.it_se_array_length =
+         (int)(spec_val(left,sp_set_ptr)->s_cardinality);
    iter_ptr->it_itype.it_powiter.it_done = NO;
 
    /* set the target value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    return;
 
@@ -1199,142 +727,28 @@ iter_ptr_type iter_ptr;                /* iterator pointer                  */
 struct source_elem_item *se_array;     /* array of source elements          */
 int se_array_length;                   /* length of above array             */
 int se_index;                          /* index into above array            */
-set_h_ptr_type subset_root, subset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type subset_cell;            /* current cell pointer              */
-set_c_ptr_type *subset_tail;           /* attach new cells here             */
-int subset_height, subset_index;       /* current height and index          */
-specifier *subset_element;             /* set element                       */
-int32 subset_hash_code;                /* hash code of subset element       */
-set_h_ptr_type new_hdr;                /* created header node               */
-set_c_ptr_type new_cell;               /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int i;                                 /* temporary looping variable        */
-
-   /* reload the iteration variables */
-
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   se_array = iter_ptr->it_itype.it_powiter.it_se_array;
-   se_array_length = iter_ptr->it_itype.it_powiter.it_se_array_length;
-
-   /* if we've finished return NO */
-
-   if (iter_ptr->it_itype.it_powiter.it_done) {
-
-      unmark_specifier(target);
-      target->sp_form = ft_omega;
-
-      return NO;
-
-   }
-
-   /* create a new set for the subset */
-
-   get_set_header(subset_root);
-   subset_root->s_use_count = 1;
-   subset_root->s_hash_code = 0;
-   subset_root->s_ntype.s_root.s_cardinality = 0;
-   subset_root->s_ntype.s_root.s_height = 0;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        subset_root->s_child[i++].s_cell = NULL);
-   expansion_trigger = SET_HASH_SIZE * 2;
-
-   /* loop over the array of cells, building up a subset */
-
-   for (se_index = 0; se_index < se_array_length; se_index++) {
-
-      if (!se_array[se_index].se_in_set)
-         continue;
-
-      subset_element = &(se_array[se_index].se_element->s_spec);
-      subset_hash_code = se_array[se_index].se_element->s_hash_code;
-
-      /*
-       *  At this point we have an element we would like to insert into
-       *  the subset.
-       */
-
-      subset_work_hdr = subset_root;
-
-      /* get the element's hash code */
-
-      work_hash_code = subset_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      subset_height = subset_root->s_ntype.s_root.s_height;
-      while (subset_height--) {
-
-         /* extract the element's index at this level */
-
-         subset_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (subset_work_hdr->s_child[subset_index].s_header == NULL) {
-
-            get_set_header(new_hdr);
-            new_hdr->s_ntype.s_intern.s_parent = subset_work_hdr;
-            new_hdr->s_ntype.s_intern.s_child_index = subset_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_hdr->s_child[i++].s_cell = NULL);
-            subset_work_hdr->s_child[subset_index].s_header = new_hdr;
-            subset_work_hdr = new_hdr;
-
-         }
-         else {
-
-            subset_work_hdr =
-               subset_work_hdr->s_child[subset_index].s_header;
-
-         }
-      }
-
-      /*
-       *  Now subset_work_hdr points to the lowest level header node
-       *  in the set.  We don't have to worry about duplicates, but we
-       *  must find the position in the clash list where we would like
-       *  to insert this element.
-       */
+set_h_ptr_type subset_root;            /* returned subset                   */
 
-      subset_index = work_hash_code & SET_HASH_MASK;
-      subset_tail = &(subset_work_hdr->s_child[subset_index].s_cell);
-      for (subset_cell = *subset_tail;
-           subset_cell != NULL &&
-              subset_cell->s_hash_code < subset_hash_code;
-           subset_cell = subset_cell->s_next) {
+   /* reload the iteration variables */
 
-         subset_tail = &(subset_cell->s_next);
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   se_array = iter_ptr->it_itype.it_powiter.it_se_array;
+   se_array_length = iter_ptr->it_itype.it_powiter.it_se_array_length;
 
-      }
+   /* if we've finished return NO */
 
-      /* we insert it */
+   if (iter_ptr->it_itype.it_powiter.it_done) {
 
-      get_set_cell(new_cell);
-      mark_specifier(subset_element);
-      new_cell->s_spec.sp_form = subset_element->sp_form;
-      new_cell->s_spec.sp_val.sp_biggest =
-         subset_element->sp_val.sp_biggest;
-      new_cell->s_hash_code = subset_hash_code;
-      new_cell->s_next = *subset_tail;
-      *subset_tail = new_cell;
-      subset_root->s_ntype.s_root.s_cardinality++;
-      subset_root->s_hash_code ^= subset_hash_code;
+      unmark_specifier(target);
+      spec_set_form(target,ft_omega);
 
-      /* expand the set header if necessary */
+      return NO;
 
-      if (subset_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
+   }
 
-         subset_root = set_expand_header(SETL_SYSTEM subset_root);
-         expansion_trigger *= SET_HASH_SIZE;
+   /* build up the current subset */
 
-      }
-   }
+   subset_root = pow_subset(SETL_SYSTEM se_array,se_array_length);
 
    /*
     *  We treat the field se_in_set as a single bit in a binary number
@@ -1360,8 +774,8 @@ int i;                                 /* temporary looping variable        */
    /* finally, set the target value */
 
    unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = subset_root;
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,subset_root);
 
    return YES;
 
@@ -1385,10 +799,6 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 struct source_elem_item *se_array;     /* array of source elements          */
 int se_array_length;                   /* length of above array             */
 int se_index;                          /* index into above array            */
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
 
    /* allocate and initialize an iterator */
 
@@ -1398,122 +808,14 @@ int source_height, source_index;       /* current height and index          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_powiter.it_spec.sp_form = ft_set;
-   iter_ptr->it_itype.it_powiter.it_spec.sp_val.sp_set_ptr =
-         left->sp_val.sp_set_ptr;
-
-   source_root = left->sp_val.sp_set_ptr;
+   spec_set_form(&iter_ptr->it_itype.it_powiter.it_spec,ft_set);
+   spec_set_val(&iter_ptr->it_itype.it_powiter.it_spec,sp_set_ptr,
+         spec_val(left,sp_set_ptr));
 
    /* create an array of set elements in the source set */
 
-   se_array_length = (int)(source_root->s_ntype.s_root.s_cardinality);
-
-   se_array = (struct source_elem_item *)malloc((size_t)
-                    (se_array_length * sizeof(struct source_elem_item)));
-   if (se_array == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-   se_index = 0;
-
-   /*
-    *  Set up to loop over the source set, producing one leaf node at a
-    *  time.
-    */
-
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_index = 0;
-
-   /* loop over the nodes of source */
-
-   for (;;) {
-
-      /* descend to a leaf */
-
-      while (source_height) {
-
-         /* move down if possible */
-
-         if (source_index < SET_HASH_SIZE) {
-
-            /* skip over null nodes */
-
-            if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-               source_index++;
-               continue;
-
-            }
-
-            /* we can move down, so do so */
-
-            source_work_hdr =
-               source_work_hdr->s_child[source_index].s_header;
-            source_index = 0;
-            source_height--;
-
-            continue;
-
-         }
-
-         /* if there are no more elements, break */
-
-         if (source_work_hdr == source_root) {
-
-            source_work_hdr = NULL;
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         source_height++;
-         source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         source_work_hdr =
-            source_work_hdr->s_ntype.s_intern.s_parent;
-
-         continue;
-
-      }
-
-      /* break if we can't find a leaf */
-
-      if (source_work_hdr == NULL)
-         break;
-
-      /*
-       *  At this point we have a leaf in the header tree.  We loop over
-       *  the elements in this leaf inserting each in the specifier
-       *  array.
-       */
-
-      for (source_index = 0; source_index < SET_HASH_SIZE; source_index++) {
-
-         for (source_cell = source_work_hdr->s_child[source_index].s_cell;
-              source_cell != NULL;
-              source_cell = source_cell->s_next) {
-
-            se_array[se_index].se_element = source_cell;
-            se_array[se_index].se_in_set = NO;
-            se_index++;
-
-         }
-      }
-
-      /* if the leaf is the root, we're done */
-
-      if (source_work_hdr == source_root)
-         break;
-
-      /* set up to find the next leaf, by moving to the parent */
-
-      source_height++;
-      source_index =
-            source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-      source_work_hdr =
-         source_work_hdr->s_ntype.s_intern.s_parent;
-
-   }
+   se_array_length = (int)(spec_val(left,sp_set_ptr)->s_cardinality);
+   se_array = pow_elements(SETL_SYSTEM spec_val(left,sp_set_ptr));
 
    /* initially the first n elements are in the set */
 
@@ -1534,8 +836,8 @@ int source_height, source_index;       /* current height and index          */
    /* set the target value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    return;
 
@@ -1559,23 +861,11 @@ int se_array_length;                   /* length of above array             */
 int32 n;                               /* size of each subset               */
 int se_index;                          /* index into above array            */
 int se_right_no;                       /* rightmost no                      */
-set_h_ptr_type subset_root, subset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type subset_cell;            /* current cell pointer              */
-set_c_ptr_type *subset_tail;           /* attach new cells here             */
-int subset_height, subset_index;       /* current height and index          */
-specifier *subset_element;             /* set element                       */
-int32 subset_hash_code;                /* hash code of subset element       */
-set_h_ptr_type new_hdr;                /* created header node               */
-set_c_ptr_type new_cell;               /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int i;                                 /* temporary looping variable        */
+set_h_ptr_type subset_root;            /* returned subset                   */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
    se_array = iter_ptr->it_itype.it_powiter.it_se_array;
    se_array_length = iter_ptr->it_itype.it_powiter.it_se_array_length;
    n = iter_ptr->it_itype.it_powiter.it_n;
@@ -1585,117 +875,15 @@ int i;                                 /* temporary looping variable        */
    if (iter_ptr->it_itype.it_powiter.it_done) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
       return NO;
 
    }
 
-   /* create a new set for the subset */
-
-   get_set_header(subset_root);
-   subset_root->s_use_count = 1;
-   subset_root->s_hash_code = 0;
-   subset_root->s_ntype.s_root.s_cardinality = 0;
-   subset_root->s_ntype.s_root.s_height = 0;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        subset_root->s_child[i++].s_cell = NULL);
-   expansion_trigger = SET_HASH_SIZE * 2;
-
-   /* loop over the array of cells, building up a subset */
-
-   for (se_index = 0; se_index < se_array_length; se_index++) {
-
-      if (!se_array[se_index].se_in_set)
-         continue;
-
-      subset_element = &(se_array[se_index].se_element->s_spec);
-      subset_hash_code = se_array[se_index].se_element->s_hash_code;
-
-      /*
-       *  At this point we have an element we would like to insert into
-       *  the subset.
-       */
-
-      subset_work_hdr = subset_root;
-
-      /* get the element's hash code */
-
-      work_hash_code = subset_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      subset_height = subset_root->s_ntype.s_root.s_height;
-      while (subset_height--) {
-
-         /* extract the element's index at this level */
-
-         subset_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (subset_work_hdr->s_child[subset_index].s_header == NULL) {
-
-            get_set_header(new_hdr);
-            new_hdr->s_ntype.s_intern.s_parent = subset_work_hdr;
-            new_hdr->s_ntype.s_intern.s_child_index = subset_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_hdr->s_child[i++].s_cell = NULL);
-            subset_work_hdr->s_child[subset_index].s_header = new_hdr;
-            subset_work_hdr = new_hdr;
-
-         }
-         else {
-
-            subset_work_hdr =
-               subset_work_hdr->s_child[subset_index].s_header;
-
-         }
-      }
-
-      /*
-       *  Now subset_work_hdr points to the lowest level header node
-       *  in the set.  We don't have to worry about duplicates, but we
-       *  must find the position in the clash list where we would like
-       *  to insert this element.
-       */
-
-      subset_index = work_hash_code & SET_HASH_MASK;
-      subset_tail = &(subset_work_hdr->s_child[subset_index].s_cell);
-      for (subset_cell = *subset_tail;
-           subset_cell != NULL &&
-              subset_cell->s_hash_code < subset_hash_code;
-           subset_cell = subset_cell->s_next) {
-
-         subset_tail = &(subset_cell->s_next);
-
-      }
-
-      /* we insert it */
-
-      get_set_cell(new_cell);
-      mark_specifier(subset_element);
-      new_cell->s_spec.sp_form = subset_element->sp_form;
-      new_cell->s_spec.sp_val.sp_biggest =
-         subset_element->sp_val.sp_biggest;
-      new_cell->s_hash_code = subset_hash_code;
-      new_cell->s_next = *subset_tail;
-      *subset_tail = new_cell;
-      subset_root->s_ntype.s_root.s_cardinality++;
-      subset_root->s_hash_code ^= subset_hash_code;
-
-      /* expand the set header if necessary */
-
-      if (subset_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
+   /* build up the current subset */
 
-         subset_root = set_expand_header(SETL_SYSTEM subset_root);
-         expansion_trigger *= SET_HASH_SIZE;
-
-      }
-   }
+   subset_root = pow_subset(SETL_SYSTEM se_array,se_array_length);
 
    /*
     *  We treat the field se_in_set as a single bit in a binary number
@@ -1738,8 +926,8 @@ int i;                                 /* temporary looping variable        */
    /* finally, set the target value */
 
    unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = subset_root;
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,subset_root);
 
    return YES;
 
@@ -1769,18 +957,15 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_striter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_striter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_striter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_striter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
-   iter_ptr->it_itype.it_striter.it_string_cell =
-         (left->sp_val.sp_string_ptr)->s_head;
-   iter_ptr->it_itype.it_striter.it_string_index = 0;
    iter_ptr->it_itype.it_striter.it_char_number = 0;
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
 }
 
@@ -1800,16 +985,12 @@ int string_pair_iterator_next(
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
 string_h_ptr_type string_hdr;          /* string header node                */
-string_c_ptr_type string_cell;         /* current cell pointer              */
-int string_index;                      /* current index                     */
 string_h_ptr_type new_hdr;             /* created string header             */
-string_c_ptr_type new_cell;            /* created string cell               */
-int32 short_hi_bits;                   /* high order bits of short          */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   string_hdr = iter_ptr->it_itype.it_striter.it_spec.sp_val.sp_string_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   string_hdr = spec_val(&iter_ptr->it_itype.it_striter.it_spec,sp_string_ptr);
 
    /* if there are no characters left we're done */
 
@@ -1817,60 +998,37 @@ int32 short_hi_bits;                   /* high order bits of short          */
        string_hdr->s_length) {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
 
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
       return NO;
 
    }
 
-   /* set up for the next character */
-
-   iter_ptr->it_itype.it_striter.it_char_number++;
-
-   string_cell = iter_ptr->it_itype.it_striter.it_string_cell;
-   string_index = iter_ptr->it_itype.it_striter.it_string_index;
-
-   if (string_index == STR_CELL_WIDTH) {
-
-      iter_ptr->it_itype.it_striter.it_string_cell =
-         string_cell = string_cell->s_next;
-      iter_ptr->it_itype.it_striter.it_string_index = string_index = 0;
-
-   }
-
-   iter_ptr->it_itype.it_striter.it_string_index++;
+   /* create a one character string, and move to the next character */
 
-   /* create a one character string */
+   new_hdr = new_string_chars(SETL_SYSTEM
+                              string_hdr->s_chars +
+                                 iter_ptr->it_itype.it_striter.it_char_number,
+                              1);
 
-   get_string_header(new_hdr);
-   new_hdr->s_use_count = 1;
-   new_hdr->s_hash_code = -1;
-   new_hdr->s_length = 1;
+   iter_ptr->it_itype.it_striter.it_char_number++;
 
-   get_string_cell(new_cell);
-   new_hdr->s_head = new_hdr->s_tail = new_cell;
-   new_cell->s_next = NULL;
-   new_cell->s_prev = NULL;
-   new_cell->s_cell_value[0] =
-      string_cell->s_cell_value[string_index];
 
    /* assign it to the target */
 
    unmark_specifier(rtarget);
-   rtarget->sp_form = ft_string;
-   rtarget->sp_val.sp_string_ptr = new_hdr;
+   spec_set_form(rtarget,ft_string);
+   spec_set_val(rtarget,sp_string_ptr,new_hdr);
 
-   if (!(short_hi_bits =
-         iter_ptr->it_itype.it_striter.it_char_number & INT_HIGH_BITS) ||
-        short_hi_bits == INT_HIGH_BITS) {
+   if (is_short_value(iter_ptr->it_itype.it_striter.it_char_number)) {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_short;
-      dtarget->sp_val.sp_short_value =
-            iter_ptr->it_itype.it_striter.it_char_number;
+      spec_set_form(dtarget,ft_short);
+      spec_set_val(dtarget,sp_short_value,
+            iter_ptr->it_itype.it_striter.it_char_number);
 
    }
    else {
@@ -1909,15 +1067,15 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_tupiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_tupiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_tupiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_tupiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
    iter_ptr->it_itype.it_tupiter.it_source_number = 0;
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
 }
 
@@ -1936,28 +1094,25 @@ int tuple_pair_iterator_next(
 
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* tuple we are iterating over       */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
 int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-int32 short_hi_bits;                   /* high order bits of short          */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   source_root = iter_ptr->it_itype.it_tupiter.it_spec.sp_val.sp_tuple_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   source_root = spec_val(&iter_ptr->it_itype.it_tupiter.it_spec,sp_tuple_ptr);
    source_number = iter_ptr->it_itype.it_tupiter.it_source_number;
 
    /* check whether the tuple is finished */
 
-   if (source_number >= source_root->t_ntype.t_root.t_length) {
+   if (source_number >= source_root->t_length) {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
 
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
       return NO;
 
@@ -1965,101 +1120,32 @@ int32 short_hi_bits;                   /* high order bits of short          */
 
    iter_ptr->it_itype.it_tupiter.it_source_number++;
 
-   /* descend the header tree until we get to a leaf */
-
-   source_work_hdr = source_root;
-   for (source_height = source_root->t_ntype.t_root.t_height;
-        source_height;
-        source_height--) {
-
-      /* extract the element's index at this level */
-
-      source_index = (source_number >>
-                           (source_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
-
-      /* if we're missing a header record, the element is om */
-
-      if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-         source_number++;
-         if (!(short_hi_bits = source_number & INT_HIGH_BITS) ||
-              short_hi_bits == INT_HIGH_BITS) {
-
-            unmark_specifier(dtarget);
-            dtarget->sp_form = ft_short;
-            dtarget->sp_val.sp_short_value = source_number;
-
-         }
-         else {
-
-            /* if we exceed the maximum short, convert to long */
-
-            short_to_long(SETL_SYSTEM dtarget,source_number);
-
-         }
-
-         unmark_specifier(rtarget);
-         rtarget->sp_form = ft_omega;
-
-         return YES;
-
-      }
+   /* return the element, which may be omega */
 
-      /* otherwise drop down a level */
+   if (is_packed(source_root)) {
 
-      source_work_hdr = source_work_hdr->t_child[source_index].t_header;
+      unmark_specifier(rtarget);
+      get_packed_element(source_root,source_number,rtarget);
 
    }
+   else {
 
-   /*
-    *  At this point, source_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   source_index = source_number & TUP_SHIFT_MASK;
-   if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-      source_number++;
-      if (!(short_hi_bits = source_number & INT_HIGH_BITS) ||
-           short_hi_bits == INT_HIGH_BITS) {
-
-         unmark_specifier(dtarget);
-         dtarget->sp_form = ft_short;
-         dtarget->sp_val.sp_short_value = source_number;
-
-      }
-      else {
-
-         /* if we exceed the maximum short, convert to long */
-
-         short_to_long(SETL_SYSTEM dtarget,source_number);
-
-      }
+      source_cell = tuple_cell_at(source_root,source_number);
 
+      mark_specifier(&(source_cell->t_spec));
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
-
-      return YES;
+      spec_set_form(rtarget,spec_form(&source_cell->t_spec));
+      spec_set_val(rtarget,sp_biggest,
+                   spec_val(&source_cell->t_spec,sp_biggest));
 
    }
 
-   /* we do have an item to return */
-
-   source_cell = source_work_hdr->t_child[source_index].t_cell;
-
-   mark_specifier(&(source_cell->t_spec));
-   unmark_specifier(rtarget);
-   rtarget->sp_form = source_cell->t_spec.sp_form;
-   rtarget->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
-
    source_number++;
-   if (!(short_hi_bits = source_number & INT_HIGH_BITS) ||
-        short_hi_bits == INT_HIGH_BITS) {
+   if (is_short_value(source_number)) {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_short;
-      dtarget->sp_val.sp_short_value = source_number;
+      spec_set_form(dtarget,ft_short);
+      spec_set_val(dtarget,sp_short_value,source_number);
 
    }
    else {
@@ -2101,15 +1187,15 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_tupiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_tupiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_tupiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_tupiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
    iter_ptr->it_itype.it_tupiter.it_source_number = 0;
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
 }
 
@@ -2131,27 +1217,25 @@ int alt_tuple_pair_iterator_next(
 
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* tuple we are iterating over       */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
 int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   source_root = iter_ptr->it_itype.it_tupiter.it_spec.sp_val.sp_tuple_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   source_root = spec_val(&iter_ptr->it_itype.it_tupiter.it_spec,sp_tuple_ptr);
    source_number = iter_ptr->it_itype.it_tupiter.it_source_number;
 
    /* check whether the tuple is finished */
 
-   if (source_number >= source_root->t_ntype.t_root.t_length) {
+   if (source_number >= source_root->t_length) {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
 
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
       return NO;
 
@@ -2159,102 +1243,50 @@ int source_height, source_index;       /* current height and index          */
 
    iter_ptr->it_itype.it_tupiter.it_source_number++;
 
-   /* descend the header tree until we get to a leaf */
-
-   source_work_hdr = source_root;
-   for (source_height = source_root->t_ntype.t_root.t_height;
-        source_height;
-        source_height--) {
-
-      /* extract the element's index at this level */
-
-      source_index = (source_number >>
-                           (source_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
-
-      /* if we're missing a header record, abend */
-
-      if (source_work_hdr->t_child[source_index].t_header == NULL)
-         abend(SETL_SYSTEM msg_invalid_tup_assign);
-
-      /* otherwise drop down a level */
-
-      source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-
-   }
-
-   /*
-    *  At this point, source_work_hdr points to the lowest level header
-    *  record.  We look for an element.
-    */
-
-   source_index = source_number & TUP_SHIFT_MASK;
-   if (source_work_hdr->t_child[source_index].t_cell == NULL)
-      abend(SETL_SYSTEM msg_invalid_tup_assign);
-
-   /* we do have an item to return */
-
-   source_cell = source_work_hdr->t_child[source_index].t_cell;
+   unpack_tuple(source_root);
+   source_cell = source_root->t_cells + source_number;
 
    /* we insist that the tuple element be a tuple */
 
-   if (source_cell->t_spec.sp_form != ft_tuple)
+   if (spec_form(&source_cell->t_spec) != ft_tuple)
       abend(SETL_SYSTEM msg_invalid_tup_assign);
 
-   source_root = source_cell->t_spec.sp_val.sp_tuple_ptr;
-
-   /* we need the left-most child */
-
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_work_hdr = source_root;
-   while (source_height-- && source_work_hdr != NULL)
-      source_work_hdr = source_work_hdr->t_child[0].t_header;
-
-   /* if we couldn't make it to a leaf, both elements are om */
-
-   if (source_work_hdr == NULL) {
-
-      unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
-
-      unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
-
-      return YES;
-
-   }
+   source_root = spec_val(&source_cell->t_spec,sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* set the targets */
 
-   if (source_root->t_ntype.t_root.t_length > 0 &&
-       (source_cell = source_work_hdr->t_child[0].t_cell) != NULL) {
+   if (source_root->t_length > 0) {
 
+      source_cell = source_root->t_cells;
       mark_specifier(&(source_cell->t_spec));
       unmark_specifier(dtarget);
-      dtarget->sp_form = source_cell->t_spec.sp_form;
-      dtarget->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+      spec_set_form(dtarget,spec_form(&source_cell->t_spec));
+      spec_set_val(dtarget,sp_biggest,
+                   spec_val(&source_cell->t_spec,sp_biggest));
 
    }
    else {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
 
    }
 
-   if (source_root->t_ntype.t_root.t_length > 1 &&
-       (source_cell = source_work_hdr->t_child[1].t_cell) != NULL) {
+   if (source_root->t_length > 1) {
 
+      source_cell = source_root->t_cells + 1;
       mark_specifier(&(source_cell->t_spec));
       unmark_specifier(rtarget);
-      rtarget->sp_form = source_cell->t_spec.sp_form;
-      rtarget->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+      spec_set_form(rtarget,spec_form(&source_cell->t_spec));
+      spec_set_val(rtarget,sp_biggest,
+                   spec_val(&source_cell->t_spec,sp_biggest));
 
    }
    else {
 
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
    }
 
@@ -2285,264 +1317,117 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_mapiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_mapiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_mapiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_mapiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
-   iter_ptr->it_itype.it_mapiter.it_source_work_hdr =
-         left->sp_val.sp_map_ptr;
+   set_cursor_start(&(iter_ptr->it_itype.it_mapiter.it_cursor),
+                    spec_val(left,sp_map_ptr)->m_trie);
    iter_ptr->it_itype.it_mapiter.it_source_cell = NULL;
-   iter_ptr->it_itype.it_mapiter.it_source_height =
-         (left->sp_val.sp_map_ptr)->m_ntype.m_root.m_height;
-   iter_ptr->it_itype.it_mapiter.it_source_index = 0;
-   iter_ptr->it_itype.it_mapiter.it_valset_root = NULL;
 
    /* set the target value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
-
-   return;
-
-}
-
-/*\
- *  \function{map\_pair\_iterator\_next()}
- *
- *  This function picks out the next item in an iteration over a map.
- *  We produce the next pair, using the same algorithm we use to convert
- *  maps to sets.
-\*/
-
-int map_pair_iterator_next(
-   SETL_SYSTEM_PROTO
-   specifier *dtarget,                 /* domain target                     */
-   specifier *rtarget,                 /* range target                      */
-   specifier *source)                  /* iterator item                     */
-
-{
-iter_ptr_type iter_ptr;                /* iterator pointer                  */
-map_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-map_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type valset_root, valset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type valset_cell;            /* current cell pointer              */
-int valset_height, valset_index;       /* current height and index          */
-
-   /* reload the iteration variables */
-
-   iter_ptr = source->sp_val.sp_iter_ptr;
-   source_root = iter_ptr->it_itype.it_mapiter.it_spec.sp_val.sp_map_ptr;
-   source_work_hdr = iter_ptr->it_itype.it_mapiter.it_source_work_hdr;
-   source_cell = iter_ptr->it_itype.it_mapiter.it_source_cell;
-   source_height = iter_ptr->it_itype.it_mapiter.it_source_height;
-   source_index = iter_ptr->it_itype.it_mapiter.it_source_index;
-   valset_root = iter_ptr->it_itype.it_mapiter.it_valset_root;
-   valset_work_hdr = iter_ptr->it_itype.it_mapiter.it_valset_work_hdr;
-   valset_cell = iter_ptr->it_itype.it_mapiter.it_valset_cell;
-   valset_height = iter_ptr->it_itype.it_mapiter.it_valset_height;
-   valset_index = iter_ptr->it_itype.it_mapiter.it_valset_index;
-
-   /* loop until we explicitly return */
-
-   for (;;) {
-
-      /* find the next element in the map */
-
-      while (source_cell == NULL) {
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < MAP_HASH_SIZE) {
-
-            source_cell = source_work_hdr->m_child[source_index].m_cell;
-            source_index++;
-
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= MAP_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->m_ntype.m_intern.m_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->m_ntype.m_intern.m_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->m_child[source_index].m_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->m_child[source_index].m_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if the map is empty, return NO */
-
-      if (source_cell == NULL) {
-
-         unmark_specifier(dtarget);
-         dtarget->sp_form = ft_omega;
-         unmark_specifier(rtarget);
-         rtarget->sp_form = ft_omega;
-
-         return NO;
-
-      }
-
-      /* save our location in the map */
-
-      iter_ptr->it_itype.it_mapiter.it_source_work_hdr = source_work_hdr;
-      iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell;
-      iter_ptr->it_itype.it_mapiter.it_source_height = source_height;
-      iter_ptr->it_itype.it_mapiter.it_source_index = source_index;
-      iter_ptr->it_itype.it_mapiter.it_valset_root = valset_root;
-
-      /* if we're not at a multi-value cell, return the pair */
-
-      if (!(source_cell->m_is_multi_val)) {
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
-         mark_specifier(&(source_cell->m_domain_spec));
-         unmark_specifier(dtarget);
-         dtarget->sp_form = source_cell->m_domain_spec.sp_form;
-         dtarget->sp_val.sp_biggest =
-               source_cell->m_domain_spec.sp_val.sp_biggest;
+   return;
 
-         mark_specifier(&(source_cell->m_range_spec));
-         unmark_specifier(rtarget);
-         rtarget->sp_form = source_cell->m_range_spec.sp_form;
-         rtarget->sp_val.sp_biggest =
-               source_cell->m_range_spec.sp_val.sp_biggest;
+}
 
-         iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell->m_next;
+/*\
+ *  \function{map\_pair\_iterator\_next()}
+ *
+ *  This function picks out the next item in an iteration over a map.
+ *  We produce the next pair, in the same order we use to convert maps
+ *  to sets.
+\*/
 
-         return YES;
+int map_pair_iterator_next(
+   SETL_SYSTEM_PROTO
+   specifier *dtarget,                 /* domain target                     */
+   specifier *rtarget,                 /* range target                      */
+   specifier *source)                  /* iterator item                     */
 
-      }
+{
+iter_ptr_type iter_ptr;                /* iterator pointer                  */
+map_c_ptr_type source_cell;            /* current cell pointer              */
+set_c_ptr_type valset_cell;            /* current cell pointer              */
+specifier *range_element;              /* returned range element            */
 
-      /* otherwise we find the next item in the multi-value set */
+   iter_ptr = spec_val(source,sp_iter_ptr);
 
-      if (valset_root == NULL) {
+   /* loop until we explicitly return */
 
-         valset_root = source_cell->m_range_spec.sp_val.sp_set_ptr;
-         valset_work_hdr = valset_root;
-         valset_height = valset_root->s_ntype.s_root.s_height;
-         valset_cell = NULL;
-         valset_index = 0;
+   for (;;) {
 
-      }
+      /* if we're in a multi-value set, return its next element */
 
-      for (;;) {
+      source_cell = iter_ptr->it_itype.it_mapiter.it_source_cell;
+      if (source_cell != NULL) {
 
-         /* if we have an element, return it */
+         valset_cell = set_cursor_next(
+               &(iter_ptr->it_itype.it_mapiter.it_valset_cursor));
 
          if (valset_cell != NULL) {
 
-            mark_specifier(&(source_cell->m_domain_spec));
-            unmark_specifier(dtarget);
-            dtarget->sp_form = source_cell->m_domain_spec.sp_form;
-            dtarget->sp_val.sp_biggest =
-                  source_cell->m_domain_spec.sp_val.sp_biggest;
-
-            mark_specifier(&(valset_cell->s_spec));
-            unmark_specifier(rtarget);
-            rtarget->sp_form = valset_cell->s_spec.sp_form;
-            rtarget->sp_val.sp_biggest =
-                  valset_cell->s_spec.sp_val.sp_biggest;
-
-            iter_ptr->it_itype.it_mapiter.it_valset_root = valset_root;
-            iter_ptr->it_itype.it_mapiter.it_valset_work_hdr =
-                  valset_work_hdr;
-            iter_ptr->it_itype.it_mapiter.it_valset_cell =
-                  valset_cell->s_next;
-            iter_ptr->it_itype.it_mapiter.it_valset_height = valset_height;
-            iter_ptr->it_itype.it_mapiter.it_valset_index = valset_index;
-
-            return YES;
+            range_element = &(valset_cell->s_spec);
+            break;
 
          }
 
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!valset_height && valset_index < SET_HASH_SIZE) {
+         iter_ptr->it_itype.it_mapiter.it_source_cell = NULL;
 
-            valset_cell = valset_work_hdr->s_child[valset_index].s_cell;
-            valset_index++;
-
-            continue;
+      }
 
-         }
+      /* find the next cell in the map */
 
-         /* move up if we're at the end of a node */
+      source_cell = map_cursor_next(
+            &(iter_ptr->it_itype.it_mapiter.it_cursor));
 
-         if (valset_index >= SET_HASH_SIZE) {
+      /* if the map is exhausted, return NO */
 
-            /* there are no more elements, so break */
+      if (source_cell == NULL) {
 
-            if (valset_work_hdr == valset_root)
-               break;
+         unmark_specifier(dtarget);
+         spec_set_form(dtarget,ft_omega);
+         unmark_specifier(rtarget);
+         spec_set_form(rtarget,ft_omega);
 
-            /* otherwise move up */
+         return NO;
 
-            valset_height++;
-            valset_index =
-               valset_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            valset_work_hdr =
-               valset_work_hdr->s_ntype.s_intern.s_parent;
+      }
 
-            continue;
+      /* if we're not at a multi-value cell, return the pair */
 
-         }
+      if (!(source_cell->m_is_multi_val)) {
 
-         /* skip over null nodes */
+         range_element = &(source_cell->m_range_spec);
+         break;
 
-         if (valset_work_hdr->s_child[valset_index].s_header == NULL) {
+      }
 
-            valset_index++;
-            continue;
+      /* otherwise we start on the multi-value set */
 
-         }
+      iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell;
+      set_cursor_start(&(iter_ptr->it_itype.it_mapiter.it_valset_cursor),
+            (spec_val(&source_cell->m_range_spec,sp_set_ptr))->s_trie);
 
-         /* otherwise drop down a level */
+   }
 
-         valset_work_hdr =
-            valset_work_hdr->s_child[valset_index].s_header;
-         valset_index = 0;
-         valset_height--;
+   mark_specifier(&(source_cell->m_domain_spec));
+   unmark_specifier(dtarget);
+   spec_set_form(dtarget,spec_form(&source_cell->m_domain_spec));
+   spec_set_val(dtarget,sp_biggest,
+         spec_val(&source_cell->m_domain_spec,sp_biggest));
 
-      }
+   mark_specifier(range_element);
+   unmark_specifier(rtarget);
+   spec_set_form(rtarget,spec_form(range_element));
+   spec_set_val(rtarget,sp_biggest,spec_val(range_element,sp_biggest));
 
-      source_cell = source_cell->m_next;
-      valset_root = NULL;
+   return YES;
 
-   }
 }
 
 /*\
@@ -2568,22 +1453,19 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_mapiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_mapiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_mapiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_mapiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
-   iter_ptr->it_itype.it_mapiter.it_source_work_hdr =
-         left->sp_val.sp_map_ptr;
+   set_cursor_start(&(iter_ptr->it_itype.it_mapiter.it_cursor),
+                    spec_val(left,sp_map_ptr)->m_trie);
    iter_ptr->it_itype.it_mapiter.it_source_cell = NULL;
-   iter_ptr->it_itype.it_mapiter.it_source_height =
-         (left->sp_val.sp_map_ptr)->m_ntype.m_root.m_height;
-   iter_ptr->it_itype.it_mapiter.it_source_index = 0;
 
    /* set the target value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    return;
 
@@ -2593,8 +1475,8 @@ iter_ptr_type iter_ptr;                /* created iterator pointer          */
  *  \function{map\_multi\_iterator\_next()}
  *
  *  This function picks out the next item in an iteration over a
- *  multi-valued map.  We produce the next pair, using the same algorithm
- *  we use to convert maps to sets.
+ *  multi-valued map.  We produce each domain element with the set of
+ *  its range elements.
 \*/
 
 int map_multi_iterator_next(
@@ -2605,153 +1487,57 @@ int map_multi_iterator_next(
 
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
-map_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
 map_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type valset_root;            /* root and internal node pointers   */
-set_c_ptr_type valset_cell;            /* current cell pointer              */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int i;                                 /* temporary looping variable        */
-
-   /* reload the iteration variables */
-
-   iter_ptr = source->sp_val.sp_iter_ptr;
-   source_root = iter_ptr->it_itype.it_mapiter.it_spec.sp_val.sp_map_ptr;
-   source_work_hdr = iter_ptr->it_itype.it_mapiter.it_source_work_hdr;
-   source_cell = iter_ptr->it_itype.it_mapiter.it_source_cell;
-   source_height = iter_ptr->it_itype.it_mapiter.it_source_height;
-   source_index = iter_ptr->it_itype.it_mapiter.it_source_index;
-
-   /* find the next element in the map */
-
-   while (source_cell == NULL) {
-
-      /* start on the next clash list, if we're at a leaf */
-
-      if (!source_height && source_index < MAP_HASH_SIZE) {
-
-         source_cell = source_work_hdr->m_child[source_index].m_cell;
-         source_index++;
-
-         continue;
+set_h_ptr_type valset_root;            /* created singleton value set       */
+int32 work_hash_code;                  /* hash code of range element        */
 
-      }
-
-      /* move up if we're at the end of a node */
-
-      if (source_index >= MAP_HASH_SIZE) {
-
-         /* there are no more elements, so break */
-
-         if (source_work_hdr == source_root)
-            break;
-
-         /* otherwise move up */
-
-         source_height++;
-         source_index =
-            source_work_hdr->m_ntype.m_intern.m_child_index + 1;
-         source_work_hdr =
-            source_work_hdr->m_ntype.m_intern.m_parent;
-
-         continue;
-
-      }
-
-      /* skip over null nodes */
-
-      if (source_work_hdr->m_child[source_index].m_header == NULL) {
-
-         source_index++;
-         continue;
-
-      }
+   iter_ptr = spec_val(source,sp_iter_ptr);
+   source_cell = map_cursor_next(&(iter_ptr->it_itype.it_mapiter.it_cursor));
 
-      /* otherwise drop down a level */
-
-      source_work_hdr =
-         source_work_hdr->m_child[source_index].m_header;
-      source_index = 0;
-      source_height--;
-
-   }
-
-   /* if the map is empty, return NO */
+   /* if the map is exhausted, return NO */
 
    if (source_cell == NULL) {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
       return NO;
 
    }
 
-   /* save our location in the map */
-
-   iter_ptr->it_itype.it_mapiter.it_source_work_hdr = source_work_hdr;
-   iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell;
-   iter_ptr->it_itype.it_mapiter.it_source_height = source_height;
-   iter_ptr->it_itype.it_mapiter.it_source_index = source_index;
-   iter_ptr->it_itype.it_mapiter.it_source_cell = source_cell->m_next;
+   mark_specifier(&(source_cell->m_domain_spec));
+   unmark_specifier(dtarget);
+   spec_set_form(dtarget,spec_form(&source_cell->m_domain_spec));
+   spec_set_val(dtarget,sp_biggest,
+         spec_val(&source_cell->m_domain_spec,sp_biggest));
 
-   /* if we're at a multi-value cell, return the pair */
+   /* a multi-value cell already has a value set */
 
    if (source_cell->m_is_multi_val) {
 
-      mark_specifier(&(source_cell->m_domain_spec));
-      unmark_specifier(dtarget);
-      dtarget->sp_form = source_cell->m_domain_spec.sp_form;
-      dtarget->sp_val.sp_biggest =
-            source_cell->m_domain_spec.sp_val.sp_biggest;
-
       mark_specifier(&(source_cell->m_range_spec));
       unmark_specifier(rtarget);
-      rtarget->sp_form = source_cell->m_range_spec.sp_form;
-      rtarget->sp_val.sp_biggest =
-            source_cell->m_range_spec.sp_val.sp_biggest;
+      spec_set_form(rtarget,spec_form(&source_cell->m_range_spec));
+      spec_set_val(rtarget,sp_biggest,
+            spec_val(&source_cell->m_range_spec,sp_biggest));
 
       return YES;
 
    }
 
-   /* otherwise, we must make a singleton set */
-
-   get_set_header(valset_root);
-   valset_root->s_use_count = 1;
-   valset_root->s_ntype.s_root.s_cardinality = 1;
-   valset_root->s_ntype.s_root.s_height = 0;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        valset_root->s_child[i++].s_cell = NULL);
+   /* otherwise we make a singleton set */
 
+   valset_root = null_set(SETL_SYSTEM_VOID);
    spec_hash_code(work_hash_code,&(source_cell->m_range_spec));
-   valset_root->s_hash_code = work_hash_code;
-   get_set_cell(valset_cell);
-   valset_cell->s_spec.sp_form = source_cell->m_range_spec.sp_form;
-   valset_cell->s_spec.sp_val.sp_biggest =
-         source_cell->m_range_spec.sp_val.sp_biggest;
-   mark_specifier(&(valset_cell->s_spec));
-   valset_cell->s_hash_code = work_hash_code;
-   valset_cell->s_next = NULL;
-   valset_root->s_child[work_hash_code & SET_HASH_MASK].s_cell = valset_cell;
-
-   /* set the domain element */
-
-   mark_specifier(&(source_cell->m_domain_spec));
-   unmark_specifier(dtarget);
-   dtarget->sp_form = source_cell->m_domain_spec.sp_form;
-   dtarget->sp_val.sp_biggest =
-         source_cell->m_domain_spec.sp_val.sp_biggest;
-
-   /* set the value set */
+   set_insert(SETL_SYSTEM valset_root,
+              &(source_cell->m_range_spec),
+              work_hash_code);
 
    unmark_specifier(rtarget);
-   rtarget->sp_form = ft_set;
-   rtarget->sp_val.sp_set_ptr = valset_root;
+   spec_set_form(rtarget,ft_set);
+   spec_set_val(rtarget,sp_set_ptr,valset_root);
 
    return YES;
 
@@ -2784,17 +1570,17 @@ struct slot_info_item *slot_info;      /* slot information record           */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_objiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_objiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_objiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_objiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    /* now let the object know we're going to iterate */
 
-   object_root = left->sp_val.sp_object_ptr;
+   object_root = spec_val(left,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* get information about this slot in the object */
@@ -2835,16 +1621,15 @@ iter_ptr_type iter_ptr;                /* iterator pointer                  */
 unittab_ptr_type class_ptr;            /* class pointer                     */
 object_h_ptr_type object_root;         /* object header pointer             */
 struct slot_info_item *slot_info;      /* slot information record           */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* returned tuple                    */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int source_height;                     /* current height and index          */
 specifier spare;                       /* spare specifier                   */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   object_root = iter_ptr->it_itype.it_objiter.it_spec.sp_val.sp_object_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   object_root =
+      spec_val(&iter_ptr->it_itype.it_objiter.it_spec,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* get information about this slot in the object */
@@ -2859,7 +1644,7 @@ specifier spare;                       /* spare specifier                   */
 
    /* call the procedure */
 
-   spare.sp_form = ft_omega;
+   spec_set_form(&spare,ft_omega);
    call_procedure(SETL_SYSTEM &spare,
                   slot_info->si_spec,
                   &(iter_ptr->it_itype.it_objiter.it_spec),
@@ -2867,17 +1652,17 @@ specifier spare;                       /* spare specifier                   */
 
    /* we must get a tuple or omega */
 
-   if (spare.sp_form != ft_omega &&
-       spare.sp_form != ft_tuple)
+   if (spec_form(&spare) != ft_omega &&
+       spec_form(&spare) != ft_tuple)
       abend(SETL_SYSTEM "Return from Iterator_Next must be tuple or omega:\nValue => %s",
             abend_opnd_str(SETL_SYSTEM &spare));
 
    /* if the method returns omega we quit */
 
-   if (spare.sp_form == ft_omega) {
+   if (spec_form(&spare) == ft_omega) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
       return NO;
 
@@ -2885,43 +1670,26 @@ specifier spare;                       /* spare specifier                   */
 
    /* if the method returns a tuple we pick out the return value */
 
-   source_root = spare.sp_val.sp_tuple_ptr;
-
-   /* we need the left-most child */
-
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_work_hdr = source_root;
-   while (source_height-- && source_work_hdr != NULL)
-      source_work_hdr = source_work_hdr->t_child[0].t_header;
-
-   /* if we couldn't make it to a leaf, return om */
-
-   if (source_work_hdr == NULL) {
-
-      unmark_specifier(&spare);
-      unmark_specifier(target);
-      target->sp_form = ft_omega;
-
-      return YES;
-
-   }
+   source_root = spec_val(&spare,sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* set the target */
 
-   if (source_root->t_ntype.t_root.t_length > 0 &&
-       (source_cell = source_work_hdr->t_child[0].t_cell) != NULL) {
+   if (source_root->t_length > 0) {
 
+      source_cell = source_root->t_cells;
       mark_specifier(&(source_cell->t_spec));
       unmark_specifier(target);
-      target->sp_form = source_cell->t_spec.sp_form;
-      target->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+      spec_set_form(target,spec_form(&source_cell->t_spec));
+      spec_set_val(target,sp_biggest,
+                   spec_val(&source_cell->t_spec,sp_biggest));
       unmark_specifier(&spare);
 
    }
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       unmark_specifier(&spare);
 
    }
@@ -2957,17 +1725,17 @@ struct slot_info_item *slot_info;      /* slot information record           */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_objiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_objiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_objiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_objiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    /* now let the object know we're going to iterate */
 
-   object_root = left->sp_val.sp_object_ptr;
+   object_root = spec_val(left,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* get information about this slot in the object */
@@ -3010,15 +1778,14 @@ unittab_ptr_type class_ptr;            /* class pointer                     */
 object_h_ptr_type object_root;         /* object header pointer             */
 struct slot_info_item *slot_info;      /* slot information record           */
 specifier spare;                       /* spare specifier                   */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* returned tuple                    */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int source_height;                     /* current height and index          */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   object_root = iter_ptr->it_itype.it_objiter.it_spec.sp_val.sp_object_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   object_root =
+      spec_val(&iter_ptr->it_itype.it_objiter.it_spec,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* get information about this slot in the object */
@@ -3033,7 +1800,7 @@ int source_height;                     /* current height and index          */
 
    /* call the procedure */
 
-   spare.sp_form = ft_omega;
+   spec_set_form(&spare,ft_omega);
    call_procedure(SETL_SYSTEM &spare,
                   slot_info->si_spec,
                   &(iter_ptr->it_itype.it_objiter.it_spec),
@@ -3041,20 +1808,20 @@ int source_height;                     /* current height and index          */
 
    /* we must get a tuple or omega */
 
-   if (spare.sp_form != ft_omega &&
-       spare.sp_form != ft_tuple)
+   if (spec_form(&spare) != ft_omega &&
+       spec_form(&spare) != ft_tuple)
       abend(SETL_SYSTEM "Return from Iterator_Next must be tuple or omega:\nValue => %s",
             abend_opnd_str(SETL_SYSTEM &spare));
 
    /* if the method returns omega we quit */
 
-   if (spare.sp_form == ft_omega) {
+   if (spec_form(&spare) == ft_omega) {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
 
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
       return NO;
 
@@ -3062,93 +1829,60 @@ int source_height;                     /* current height and index          */
 
    /* if the method returns a tuple we pick out the return value */
 
-   source_root = spare.sp_val.sp_tuple_ptr;
-
-   /* we need the left-most child */
-
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_work_hdr = source_root;
-   while (source_height-- && source_work_hdr != NULL)
-      source_work_hdr = source_work_hdr->t_child[0].t_header;
-
-   /* if we couldn't make it to a leaf, abend */
-
-   if (source_work_hdr == NULL)
-      abend(SETL_SYSTEM "Return from Iterator_Next must be a nested tuple:\nValue => %s",
-            abend_opnd_str(SETL_SYSTEM &spare));
+   source_root = spec_val(&spare,sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* make sure we find something */
 
-   source_cell = source_work_hdr->t_child[0].t_cell;
-   if (source_root->t_ntype.t_root.t_length == 0 ||
-       source_cell == NULL)
+   if (source_root->t_length == 0)
       abend(SETL_SYSTEM "Return from Iterator_Next must be a nested tuple:\nValue => %s",
             abend_opnd_str(SETL_SYSTEM &spare));
 
    /* it must be a tuple */
 
-   if (source_cell->t_spec.sp_form != ft_tuple)
+   source_cell = source_root->t_cells;
+   if (spec_form(&source_cell->t_spec) != ft_tuple)
       abend(SETL_SYSTEM "Return from Iterator_Next must be a nested tuple:\nValue => %s",
             abend_opnd_str(SETL_SYSTEM &spare));
 
    /* now pick apart the tuple */
 
-   source_root = source_cell->t_spec.sp_val.sp_tuple_ptr;
-
-   /* we need the left-most child */
-
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_work_hdr = source_root;
-   while (source_height-- && source_work_hdr != NULL)
-      source_work_hdr = source_work_hdr->t_child[0].t_header;
-
-   /* if we couldn't make it to a leaf, both elements are om */
-
-   if (source_work_hdr == NULL) {
-
-      unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
-
-      unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
-
-      unmark_specifier(&spare);
-
-      return YES;
-
-   }
+   source_root = spec_val(&source_cell->t_spec,sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* set the targets */
 
-   if (source_root->t_ntype.t_root.t_length > 0 &&
-       (source_cell = source_work_hdr->t_child[0].t_cell) != NULL) {
+   if (source_root->t_length > 0) {
 
+      source_cell = source_root->t_cells;
       mark_specifier(&(source_cell->t_spec));
       unmark_specifier(dtarget);
-      dtarget->sp_form = source_cell->t_spec.sp_form;
-      dtarget->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+      spec_set_form(dtarget,spec_form(&source_cell->t_spec));
+      spec_set_val(dtarget,sp_biggest,
+                   spec_val(&source_cell->t_spec,sp_biggest));
 
    }
    else {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
 
    }
 
-   if (source_root->t_ntype.t_root.t_length > 1 &&
-       (source_cell = source_work_hdr->t_child[1].t_cell) != NULL) {
+   if (source_root->t_length > 1) {
 
+      source_cell = source_root->t_cells + 1;
       mark_specifier(&(source_cell->t_spec));
       unmark_specifier(rtarget);
-      rtarget->sp_form = source_cell->t_spec.sp_form;
-      rtarget->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+      spec_set_form(rtarget,spec_form(&source_cell->t_spec));
+      spec_set_val(rtarget,sp_biggest,
+                   spec_val(&source_cell->t_spec,sp_biggest));
 
    }
    else {
 
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
    }
 
@@ -3186,17 +1920,17 @@ struct slot_info_item *slot_info;      /* slot information record           */
 
    mark_specifier(left);
 
-   iter_ptr->it_itype.it_objiter.it_spec.sp_form = left->sp_form;
-   iter_ptr->it_itype.it_objiter.it_spec.sp_val.sp_biggest =
-         left->sp_val.sp_biggest;
+   spec_set_form(&iter_ptr->it_itype.it_objiter.it_spec,spec_form(left));
+   spec_set_val(&iter_ptr->it_itype.it_objiter.it_spec,sp_biggest,
+         spec_val(left,sp_biggest));
 
    unmark_specifier(target);
-   target->sp_form = ft_iter;
-   target->sp_val.sp_iter_ptr = iter_ptr;
+   spec_set_form(target,ft_iter);
+   spec_set_val(target,sp_iter_ptr,iter_ptr);
 
    /* now let the object know we're going to iterate */
 
-   object_root = left->sp_val.sp_object_ptr;
+   object_root = spec_val(left,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* get information about this slot in the object */
@@ -3239,15 +1973,14 @@ unittab_ptr_type class_ptr;            /* class pointer                     */
 object_h_ptr_type object_root;         /* object header pointer             */
 struct slot_info_item *slot_info;      /* slot information record           */
 specifier spare;                       /* spare specifier                   */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* returned tuple                    */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int source_height;                     /* current height and index          */
 
    /* reload the iteration variables */
 
-   iter_ptr = left->sp_val.sp_iter_ptr;
-   object_root = iter_ptr->it_itype.it_objiter.it_spec.sp_val.sp_object_ptr;
+   iter_ptr = spec_val(left,sp_iter_ptr);
+   object_root =
+      spec_val(&iter_ptr->it_itype.it_objiter.it_spec,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* get information about this slot in the object */
@@ -3262,7 +1995,7 @@ int source_height;                     /* current height and index          */
 
    /* call the procedure */
 
-   spare.sp_form = ft_omega;
+   spec_set_form(&spare,ft_omega);
    call_procedure(SETL_SYSTEM &spare,
                   slot_info->si_spec,
                   &(iter_ptr->it_itype.it_objiter.it_spec),
@@ -3270,21 +2003,21 @@ int source_height;                     /* current height and index          */
 
    /* we must get a tuple or omega */
 
-   if (spare.sp_form != ft_omega &&
-       spare.sp_form != ft_tuple)
+   if (spec_form(&spare) != ft_omega &&
+       spec_form(&spare) != ft_tuple)
       abend(SETL_SYSTEM 
          "Return from Set_Iterator_Next must be tuple or omega:\nValue => %s",
          abend_opnd_str(SETL_SYSTEM &spare));
 
    /* if the method returns omega we quit */
 
-   if (spare.sp_form == ft_omega) {
+   if (spec_form(&spare) == ft_omega) {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
 
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
       return NO;
 
@@ -3292,96 +2025,62 @@ int source_height;                     /* current height and index          */
 
    /* if the method returns a tuple we pick out the return value */
 
-   source_root = spare.sp_val.sp_tuple_ptr;
-
-   /* we need the left-most child */
-
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_work_hdr = source_root;
-   while (source_height-- && source_work_hdr != NULL)
-      source_work_hdr = source_work_hdr->t_child[0].t_header;
-
-   /* if we couldn't make it to a leaf, abend */
-
-   if (source_work_hdr == NULL)
-      abend(SETL_SYSTEM 
-         "Return from Set_Iterator_Next must be a nested tuple:\nValue => %s",
-         abend_opnd_str(SETL_SYSTEM &spare));
+   source_root = spec_val(&spare,sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* make sure we find something */
 
-   source_cell = source_work_hdr->t_child[0].t_cell;
-   if (source_root->t_ntype.t_root.t_length == 0 ||
-       source_cell == NULL)
+   if (source_root->t_length == 0)
       abend(SETL_SYSTEM 
          "Return from Set_Iterator_Next must be a nested tuple:\nValue => %s",
          abend_opnd_str(SETL_SYSTEM &spare));
 
    /* it must be a tuple */
 
-   if (source_cell->t_spec.sp_form != ft_tuple)
+   source_cell = source_root->t_cells;
+   if (spec_form(&source_cell->t_spec) != ft_tuple)
       abend(SETL_SYSTEM 
          "Return from Set_Iterator_Next must be a nested tuple:\nValue => %s",
          abend_opnd_str(SETL_SYSTEM &spare));
 
    /* now pick apart the tuple */
 
-   source_root = source_cell->t_spec.sp_val.sp_tuple_ptr;
-
-   /* we need the left-most child */
-
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_work_hdr = source_root;
-   while (source_height-- && source_work_hdr != NULL)
-      source_work_hdr = source_work_hdr->t_child[0].t_header;
-
-   /* if we couldn't make it to a leaf, both elements are om */
-
-   if (source_work_hdr == NULL) {
-
-      unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
-
-      unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
-
-      unmark_specifier(&spare);
-
-      return YES;
-
-   }
+   source_root = spec_val(&source_cell->t_spec,sp_tuple_ptr);
+   unpack_tuple(source_root);
 
    /* set the targets */
 
-   if (source_root->t_ntype.t_root.t_length > 0 &&
-       (source_cell = source_work_hdr->t_child[0].t_cell) != NULL) {
+   if (source_root->t_length > 0) {
 
+      source_cell = source_root->t_cells;
       mark_specifier(&(source_cell->t_spec));
       unmark_specifier(dtarget);
-      dtarget->sp_form = source_cell->t_spec.sp_form;
-      dtarget->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+      spec_set_form(dtarget,spec_form(&source_cell->t_spec));
+      spec_set_val(dtarget,sp_biggest,
+                   spec_val(&source_cell->t_spec,sp_biggest));
 
    }
    else {
 
       unmark_specifier(dtarget);
-      dtarget->sp_form = ft_omega;
+      spec_set_form(dtarget,ft_omega);
 
    }
 
-   if (source_root->t_ntype.t_root.t_length > 1 &&
-       (source_cell = source_work_hdr->t_child[1].t_cell) != NULL) {
+   if (source_root->t_length > 1) {
 
+      source_cell = source_root->t_cells + 1;
       mark_specifier(&(source_cell->t_spec));
       unmark_specifier(rtarget);
-      rtarget->sp_form = source_cell->t_spec.sp_form;
-      rtarget->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+      spec_set_form(rtarget,spec_form(&source_cell->t_spec));
+      spec_set_val(rtarget,sp_biggest,
+                   spec_val(&source_cell->t_spec,sp_biggest));
 
    }
    else {
 
       unmark_specifier(rtarget);
-      rtarget->sp_form = ft_omega;
+      spec_set_form(rtarget,ft_omega);
 
    }
 
@@ -3391,3 +2090,257 @@ int source_height;                     /* current height and index          */
 
 }
 
+
+/*\
+ *  \function{split\_iteration()}
+ *
+ *  This function splits a set, map or tuple into parts, so that workers
+ *  can iterate over the parts separately.  A tuple is cut into ranges
+ *  of nearly equal length.  A set or map starts as one part, its whole
+ *  hash trie, and we replace subtries by their entries, level by level,
+ *  until we have the parts we want or there is nothing left to split.
+ *  Hash codes spread elements evenly over a trie, so the parts are of
+ *  similar size.  The caller must leave room for \verb"SET_HASH_SIZE"
+ *  more parts than it wants, since splitting a node may add that many.
+ *  We return the number of parts, which is zero for an empty source.
+\*/
+
+int32 split_iteration(
+   SETL_SYSTEM_PROTO
+   specifier *source,                  /* set, map or tuple to be split     */
+   struct iter_part_item *parts,       /* returned parts                    */
+   int32 want)                         /* number of parts wanted            */
+
+{
+set_n_ptr_type trie;                   /* root of hash trie                 */
+set_n_ptr_type node;                   /* node being split                  */
+int32 length;                          /* tuple length                      */
+int32 count;                           /* number of parts                   */
+int data_count;                        /* cell lists in node                */
+int entry_count;                       /* entries in node                   */
+int type;                              /* iteration type                    */
+int split;                             /* YES if we split a node            */
+int32 i;                               /* temporary looping variable        */
+int j;                                 /* temporary looping variable        */
+
+   if (spec_form(source) == ft_tuple) {
+
+      length = spec_val(source,sp_tuple_ptr)->t_length;
+      if (want > length)
+         want = length;
+
+      for (i = 0; i < want; i++) {
+
+         parts[i].ip_type = it_tuple;
+         parts[i].ip_next = i * (length / want) +
+                            (i < length % want ? i : length % want);
+         parts[i].ip_last = parts[i].ip_next + length / want +
+                            (i < length % want ? 1 : 0);
+
+      }
+
+      return want;
+
+   }
+
+   if (spec_form(source) == ft_map) {
+      type = it_map;
+      trie = spec_val(source,sp_map_ptr)->m_trie;
+   }
+   else {
+      type = it_set;
+      trie = spec_val(source,sp_set_ptr)->s_trie;
+   }
+
+   if (trie == NULL)
+      return 0;
+
+   parts[0].ip_type = type;
+   parts[0].ip_source_cell = NULL;
+   set_cursor_start(&(parts[0].ip_cursor),trie);
+   count = 1;
+
+   for (split = YES; split && count < want;) {
+
+      split = NO;
+
+      for (i = 0; i < count && count < want; i++) {
+
+         /* cell lists and small tables are not split */
+
+         if (parts[i].ip_cursor.sc_depth < 0)
+            continue;
+
+         node = parts[i].ip_cursor.sc_node[0];
+         if (set_is_table(node))
+            continue;
+
+         /* the node's entries take its place */
+
+         data_count = set_bit_count(node->s_datamap);
+         entry_count = data_count + set_bit_count(node->s_nodemap);
+
+         memmove((void *)(parts + i + entry_count),
+                 (void *)(parts + i + 1),
+                 (size_t)(count - i - 1) * sizeof(struct iter_part_item));
+
+         for (j = 0; j < entry_count; j++) {
+
+            parts[i + j].ip_type = type;
+            parts[i + j].ip_source_cell = NULL;
+
+            if (j < data_count) {
+               parts[i + j].ip_cursor.sc_depth = -1;
+               parts[i + j].ip_cursor.sc_cell = node->s_entry[j].s_cell;
+            }
+            else {
+               set_cursor_start(&(parts[i + j].ip_cursor),
+                                node->s_entry[j].s_node);
+            }
+         }
+
+         count += entry_count - 1;
+         i += entry_count - 1;
+         split = YES;
+
+      }
+   }
+
+   return count;
+
+}
+
+/*\
+ *  \function{part\_iterator\_next()}
+ *
+ *  This function picks out the next item in an iteration over one part
+ *  of a set, map or tuple, made by \verb"split_iteration()".  We return
+ *  the same items as the iterators over the whole source.
+\*/
+
+int part_iterator_next(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* next item in part                 */
+   specifier *source,                  /* set, map or tuple split           */
+   struct iter_part_item *part)        /* part being iterated over          */
+
+{
+tuple_h_ptr_type source_root;          /* tuple we are iterating over       */
+tuple_c_ptr_type tuple_cell;           /* tuple element                     */
+set_c_ptr_type source_cell;            /* set cell                          */
+map_c_ptr_type map_cell;               /* map cell                          */
+set_c_ptr_type valset_cell;            /* value set cell                    */
+tuple_h_ptr_type tuple_root;           /* returned pair                     */
+int32 range_hash_code;                 /* hash code of range element        */
+
+   switch (part->ip_type) {
+
+      case it_tuple :
+
+         if (part->ip_next >= part->ip_last)
+            break;
+
+         source_root = spec_val(source,sp_tuple_ptr);
+         unmark_specifier(target);
+
+         if (is_packed(source_root)) {
+
+            get_packed_element(source_root,part->ip_next,target);
+            part->ip_next++;
+
+            return YES;
+
+         }
+
+         tuple_cell = tuple_cell_at(source_root,part->ip_next);
+         part->ip_next++;
+
+         mark_specifier(&(tuple_cell->t_spec));
+         spec_set_form(target,spec_form(&tuple_cell->t_spec));
+         spec_set_val(target,sp_biggest,
+                      spec_val(&tuple_cell->t_spec,sp_biggest));
+
+         return YES;
+
+      case it_set :
+
+         source_cell = set_cursor_next(&(part->ip_cursor));
+         if (source_cell == NULL)
+            break;
+
+         mark_specifier(&(source_cell->s_spec));
+         unmark_specifier(target);
+         spec_set_form(target,spec_form(&source_cell->s_spec));
+         spec_set_val(target,sp_biggest,
+                      spec_val(&source_cell->s_spec,sp_biggest));
+
+         return YES;
+
+      case it_map :
+
+         for (;;) {
+
+            /* if we're in a multi-value set, return its next element */
+
+            map_cell = part->ip_source_cell;
+            if (map_cell != NULL) {
+
+               valset_cell = set_cursor_next(&(part->ip_valset_cursor));
+               if (valset_cell != NULL) {
+
+                  tuple_root = map_pair_tuple(SETL_SYSTEM
+                                              &(map_cell->m_domain_spec),
+                                              map_cell->m_hash_code,
+                                              &(valset_cell->s_spec),
+                                              valset_cell->s_hash_code);
+                  break;
+
+               }
+
+               part->ip_source_cell = NULL;
+
+            }
+
+            map_cell = map_cursor_next(&(part->ip_cursor));
+            if (map_cell == NULL) {
+               tuple_root = NULL;
+               break;
+            }
+
+            if (!(map_cell->m_is_multi_val)) {
+
+               spec_hash_code(range_hash_code,&(map_cell->m_range_spec));
+               tuple_root = map_pair_tuple(SETL_SYSTEM
+                                           &(map_cell->m_domain_spec),
+                                           map_cell->m_hash_code,
+                                           &(map_cell->m_range_spec),
+                                           range_hash_code);
+               break;
+
+            }
+
+            part->ip_source_cell = map_cell;
+            set_cursor_start(&(part->ip_valset_cursor),
+                  (spec_val(&map_cell->m_range_spec,sp_set_ptr))->s_trie);
+
+         }
+
+         if (tuple_root == NULL)
+            break;
+
+         unmark_specifier(target);
+         spec_set_form(target,ft_tuple);
+         spec_set_val(target,sp_tuple_ptr,tuple_root);
+
+         return YES;
+
+   }
+
+   /* the part is exhausted */
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_omega);
+
+   return NO;
+
+}
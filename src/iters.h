@@ -28,6 +28,12 @@
 
 #ifndef ITERS_LOADED
 
+/* SETL2 system header files */
+
+#include "specs.h"                     /* specifiers                        */
+#include "sets.h"                      /* sets                              */
+#include "slabs.h"                     /* slabs                             */
+
 /* iterator table node structure */
 
 struct iter_item {
@@ -37,30 +43,18 @@ struct iter_item {
       struct {                         /* set iteration information         */
          struct specifier_item it_spec;
                                        /* set specifier                     */
-         struct set_h_item *it_source_work_hdr;
-                                       /* current internal node             */
-         struct set_c_item *it_source_cell;
-                                       /* clash list pointer                */
-         int it_source_height;         /* current source height             */
-         int it_source_index;          /* current source index              */
+         struct set_cursor_item it_cursor;
+                                       /* position in set                   */
       } it_setiter;
       struct {                         /* map iteration information         */
          struct specifier_item it_spec;
                                        /* map specifier                     */
-         struct map_h_item *it_source_work_hdr;
-                                       /* current internal node             */
+         struct set_cursor_item it_cursor;
+                                       /* position in map                   */
          struct map_c_item *it_source_cell;
-                                       /* clash list pointer                */
-         int it_source_height;         /* current source height             */
-         int it_source_index;          /* current source index              */
-         struct set_h_item *it_valset_root;
-                                       /* current root node                 */
-         struct set_h_item *it_valset_work_hdr;
-                                       /* current internal node             */
-         struct set_c_item *it_valset_cell;
-                                       /* clash list pointer                */
-         int it_valset_height;         /* current source height             */
-         int it_valset_index;          /* current source index              */
+                                       /* multi-valued cell in progress     */
+         struct set_cursor_item it_valset_cursor;
+                                       /* position in its value set         */
       } it_mapiter;
       struct {                         /* tuple iteration information       */
          struct specifier_item it_spec;
@@ -70,10 +64,8 @@ struct iter_item {
       struct {                         /* string iteration information      */
          struct specifier_item it_spec;
                                        /* string specifier                  */
-         struct string_c_item *it_string_cell;
-                                       /* string cell pointer               */
-         int it_string_index;          /* current character in cell         */
          int32 it_char_number;         /* next character number             */
+
       } it_striter;
       struct {                         /* power set iterator information    */
          struct specifier_item it_spec;
@@ -126,20 +118,37 @@ struct source_elem_item {              /* source set element structure      */
                                        /* subset                            */
 };
 
+/*
+ *  A part of a set, map or tuple, for loops split among workers.  A part
+ *  of a set or map is a subtrie or a single cell list, which we walk
+ *  with a cursor.  A part of a tuple is a range of elements.
+ */
+
+struct iter_part_item {
+   int ip_type;                        /* it_set, it_map or it_tuple        */
+   struct set_cursor_item ip_cursor;   /* position in set or map            */
+   struct map_c_item *ip_source_cell;  /* multi-valued cell in progress     */
+   struct set_cursor_item ip_valset_cursor;
+                                       /* position in its value set         */
+   int32 ip_next;                      /* next tuple element                */
+   int32 ip_last;                      /* tuple element after the part      */
+};
+
 /* global data */
 
 #ifdef TSAFE
-#define ITER_NEXT_FREE plugin_instance->iter_next_free 
+#define ITER_SLAB plugin_instance->iter_slab
 #else
-#define ITER_NEXT_FREE iter_next_free 
+#define ITER_SLAB iter_slab
 
 #ifdef SHARED
 
-iter_ptr_type iter_next_free = NULL;   /* next free node                    */
+struct slab_class_item iter_slab;      /* iterator slabs                    */
 
 #else
 
-extern iter_ptr_type iter_next_free;   /* next free node                    */
+extern struct slab_class_item iter_slab;
+                                       /* iterator slabs                    */
 
 #endif
 #endif
@@ -158,23 +167,15 @@ extern iter_ptr_type iter_next_free;   /* next free node                    */
 
 #else
 
-#define get_iterator(i) {\
-   if (ITER_NEXT_FREE == NULL) alloc_iterators(SETL_SYSTEM_VOID); \
-   i = ITER_NEXT_FREE; \
-   ITER_NEXT_FREE = *((iter_ptr_type *)(ITER_NEXT_FREE)); \
-}
+#define get_iterator(i) \
+   slab_get(ITER_SLAB,"iterator",iter_ptr_type,i,\
+            sizeof(struct iter_item))
 
-#define free_iterator(i) {\
-   *((iter_ptr_type *)(i)) = ITER_NEXT_FREE; \
-   ITER_NEXT_FREE = i; \
-}
+#define free_iterator(i) slab_put(i)
 #endif
 
 /* public function declarations */
 
-void alloc_iterators(SETL_SYSTEM_PROTO_VOID);            
-                                       /* allocate a block of node nodes    */
-
 void start_set_iterator(SETL_SYSTEM_PROTO
                         struct specifier_item *, struct specifier_item *);
                                        /* start iteration over set          */
@@ -301,6 +302,15 @@ int object_multi_iterator_next(SETL_SYSTEM_PROTO
                                struct specifier_item *);
                                        /* next pair in object               */
 
+int32 split_iteration(SETL_SYSTEM_PROTO
+                      struct specifier_item *, struct iter_part_item *,
+                      int32);
+                                       /* split a source into parts         */
+int part_iterator_next(SETL_SYSTEM_PROTO
+                       struct specifier_item *, struct specifier_item *,
+                       struct iter_part_item *);
+                                       /* next item in a part               */
+
 #define ITERS_LOADED 1
 #endif
 
@@ -185,6 +185,8 @@ struct proc_record_item {
    int32 pr_spec_offset;               /* procedure data in unit            */
    int32 pr_parent_offset;             /* parent's specifier                */
    int pr_formal_count;                /* number of formal paramenters      */
+   int pr_side_effects;                /* YES if procedure may change       */
+                                       /* anything it does not own          */
    int32 pr_spec_count;                /* number of specifiers in proc      */
 };
 
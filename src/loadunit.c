@@ -113,6 +113,28 @@ typedef struct connection connection_record;
 static connection_record libraries[128];
 static libraries_loaded=0;
 
+#if THREADED_CODE
+
+/* instruction pairs handled by superinstructions */
+
+static struct {
+   int si_first;                       /* first opcode of pair              */
+   int si_second;                      /* second opcode of pair             */
+   int si_super;                       /* combined handler                  */
+} superinstructions[] = {
+   {p_add,      p_add,      p_add_add},
+   {p_add,      p_go,       p_add_go},
+   {p_add,      p_golt,     p_add_golt},
+   {p_add,      p_return,   p_add_return},
+   {p_sub,      p_push1,    p_sub_push1},
+   {p_assign,   p_of1,      p_assign_of1},
+   {p_push1,    p_lcall,    p_push1_lcall},
+   {p_push2,    p_lcall,    p_push2_lcall},
+   {p_push3,    p_lcall,    p_push3_lcall},
+   {-1,         -1,         -1}};
+
+#endif
+
 /*\
  *  \function{load\_unit()}
  *
@@ -614,7 +636,7 @@ int mpw_bug_workaround;
       giveup(SETL_SYSTEM msg_malloc_error);
 
    memcpy(unittab_ptr->ut_err_ext_map,&SYMBOL_MAP,sizeof(specifier));
-   SYMBOL_MAP.sp_form = ft_omega;
+   spec_set_form(&SYMBOL_MAP,ft_omega);
 
    /* we're finished with the library */
 
@@ -650,10 +672,11 @@ real_record real;                      /* real literal record               */
 string_record string;                  /* string literal record             */
 proc_record proc;                      /* procedure record                  */
 integer_h_ptr_type i_hdr;              /* integer header record             */
-integer_c_ptr_type i1,i2;              /* integer cell pointers             */
+int32 cell_value;                      /* integer literal cell              */
+proc_ptr_type proc_ptr;                /* procedure literal                 */
 string_h_ptr_type s_hdr;               /* string header record              */
-string_c_ptr_type s1,s2;               /* string cell pointers              */
 int i;                                 /* temporary looping variable        */
+int32 j;                               /* temporary looping variable        */
 public_record pub;                     /* public symbol record              */
 char *symbol;
 void *symbol_ptr;
@@ -695,42 +718,32 @@ Ptr myAddr;
 
       if (integer.ir_cell_count == 1) {
 
-         s->sp_form = ft_short;
          read_libstr(SETL_SYSTEM libstr_ptr,
-                     (char *)&(s->sp_val.sp_short_value),
+                     (char *)&cell_value,
                      sizeof(int32));
+         spec_set_form(s,ft_short);
+         spec_set_val(s,sp_short_value,cell_value);
 
       }
       else {
 
-         s->sp_form = ft_long;
-         get_integer_header(i_hdr);
-         i_hdr->i_use_count = 1;
-         i_hdr->i_hash_code = -1;
-         i_hdr->i_cell_count = integer.ir_cell_count;
-         i_hdr->i_is_negative = NO;
+         i_hdr = new_integer(SETL_SYSTEM 0);
 
-         /* build up the cell list */
+         /* the library holds cells, low order first */
 
-         i2 = NULL;
-         while (integer.ir_cell_count--) {
+         for (j = 0; j < integer.ir_cell_count; j++) {
 
-            get_integer_cell(i1);
             read_libstr(SETL_SYSTEM libstr_ptr,
-                        (char *)&(i1->i_cell_value),
+                        (char *)&cell_value,
                         sizeof(int32));
-            if (i2 == NULL)
-               i_hdr->i_head = i1;
-            else
-               i2->i_next = i1;
-            i1->i_prev = i2;
-            i2 = i1;
+            set_integer_cell(SETL_SYSTEM i_hdr,j,cell_value);
 
          }
 
-         i1->i_next = NULL;
-         i_hdr->i_tail = i1;
-         s->sp_val.sp_long_ptr = i_hdr;
+         /* the compiler only makes one cell literals short */
+
+         spec_set_form(s,ft_omega);
+         normalize_long(SETL_SYSTEM s,i_hdr);
 
       }
    }
@@ -745,10 +758,8 @@ Ptr myAddr;
 
       read_libstr(SETL_SYSTEM libstr_ptr,(char *)&real,sizeof(real_record));
       s = unittab_ptr->ut_data_ptr + real.rr_offset;
-      s->sp_form = ft_real;
-      i_get_real(s->sp_val.sp_real_ptr);
-      (s->sp_val.sp_real_ptr)->r_value = real.rr_value;
-      (s->sp_val.sp_real_ptr)->r_use_count = 1;
+      spec_set_form(s,ft_real);
+      spec_set_val(s,sp_real_value,real.rr_value);
 
    }
 
@@ -764,45 +775,17 @@ Ptr myAddr;
 
       read_libstr(SETL_SYSTEM libstr_ptr,(char *)&string,sizeof(string_record));
       s = unittab_ptr->ut_data_ptr + string.sr_offset;
-      s->sp_form = ft_string;
-      get_string_header(s_hdr);
-      s_hdr->s_use_count = 1;
-      s_hdr->s_hash_code = -1;
-      s_hdr->s_length = string.sr_length;
-
-      /* build up the cell list */
-
-      if (string.sr_length == 0) {
-
-         s_hdr->s_head = s_hdr->s_tail = NULL;
-
-      }
-      else {
-
-         s2 = NULL;
-         while (string.sr_length > 0) {
-
-            get_string_cell(s1);
-            read_libstr(SETL_SYSTEM libstr_ptr,
-                        s1->s_cell_value,
-                        min(string.sr_length,STR_CELL_WIDTH));
-            if (s2 == NULL)
-               s_hdr->s_head = s1;
-            else
-               s2->s_next = s1;
-            s1->s_prev = s2;
-            s2 = s1;
-
-            string.sr_length -= STR_CELL_WIDTH;
-
-         }
+      spec_set_form(s,ft_string);
+      s_hdr = new_string_buffer(SETL_SYSTEM string.sr_length);
 
-         s1->s_next = NULL;
-         s_hdr->s_tail = s1;
+      /* read the characters */
 
-      }
+      if (string.sr_length > 0)
+         read_libstr(SETL_SYSTEM libstr_ptr,
+                     s_hdr->s_chars,
+                     string.sr_length);
 
-      s->sp_val.sp_string_ptr = s_hdr;
+      spec_set_val(s,sp_string_ptr,s_hdr);
 
    }
 
@@ -824,38 +807,40 @@ Ptr myAddr;
 #endif
 
       s = unittab_ptr->ut_data_ptr + proc.pr_symtab_offset;
-      (s)->sp_form = ft_proc;
-      get_proc(s->sp_val.sp_proc_ptr);
+      spec_set_form(s,ft_proc);
+      get_proc(proc_ptr);
+      spec_set_val(s,sp_proc_ptr,proc_ptr);
       if (unit_control->uc_type==NATIVE_UNIT) {
-         (s->sp_val.sp_proc_ptr)->p_func_ptr = NULL;
-         (s->sp_val.sp_proc_ptr)->p_type = NATIVE_PROC;
+         spec_val(s,sp_proc_ptr)->p_func_ptr = NULL;
+         spec_val(s,sp_proc_ptr)->p_type = NATIVE_PROC;
       } else
-         (s->sp_val.sp_proc_ptr)->p_type = USERDEF_PROC;
-
-      (s->sp_val.sp_proc_ptr)->p_signature = s->sp_val.sp_proc_ptr;
-      (s->sp_val.sp_proc_ptr)->p_unittab_ptr = unittab_ptr;
-      (s->sp_val.sp_proc_ptr)->p_offset = proc.pr_proc_offset;
-      (s->sp_val.sp_proc_ptr)->p_formal_count = proc.pr_formal_count;
-      (s->sp_val.sp_proc_ptr)->p_spec_count = proc.pr_spec_count;
-      (s->sp_val.sp_proc_ptr)->p_spec_ptr =
+         spec_val(s,sp_proc_ptr)->p_type = USERDEF_PROC;
+
+      spec_val(s,sp_proc_ptr)->p_signature = spec_val(s,sp_proc_ptr);
+      spec_val(s,sp_proc_ptr)->p_unittab_ptr = unittab_ptr;
+      spec_val(s,sp_proc_ptr)->p_offset = proc.pr_proc_offset;
+      spec_val(s,sp_proc_ptr)->p_formal_count = proc.pr_formal_count;
+      spec_val(s,sp_proc_ptr)->p_side_effects = proc.pr_side_effects;
+      spec_val(s,sp_proc_ptr)->p_spec_count = proc.pr_spec_count;
+      spec_val(s,sp_proc_ptr)->p_spec_ptr =
          unittab_ptr->ut_data_ptr+proc.pr_spec_offset;
-      (s->sp_val.sp_proc_ptr)->p_use_count = 1;
-      (s->sp_val.sp_proc_ptr)->p_is_const = YES;
-      (s->sp_val.sp_proc_ptr)->p_active_use_count = 0;
-      (s->sp_val.sp_proc_ptr)->p_copy = NULL;
-      (s->sp_val.sp_proc_ptr)->p_save_specs = NULL;
-      (s->sp_val.sp_proc_ptr)->p_self_ptr = NULL;
+      spec_val(s,sp_proc_ptr)->p_use_count = 1;
+      spec_val(s,sp_proc_ptr)->p_is_const = YES;
+      spec_val(s,sp_proc_ptr)->p_active_use_count = 0;
+      spec_val(s,sp_proc_ptr)->p_copy = NULL;
+      spec_val(s,sp_proc_ptr)->p_save_specs = NULL;
+      spec_val(s,sp_proc_ptr)->p_self_ptr = NULL;
       if (proc.pr_parent_offset != -1) {
 
-         (s->sp_val.sp_proc_ptr)->p_parent =
-            (unittab_ptr->ut_data_ptr+proc.pr_parent_offset)->
-               sp_val.sp_proc_ptr;
-         ((s->sp_val.sp_proc_ptr)->p_parent)->p_use_count++;
+         spec_val(s,sp_proc_ptr)->p_parent =
+            spec_val(unittab_ptr->ut_data_ptr+proc.pr_parent_offset,
+                     sp_proc_ptr);
+         (spec_val(s,sp_proc_ptr)->p_parent)->p_use_count++;
 
       }
       else {
 
-         (s->sp_val.sp_proc_ptr)->p_parent = NULL;
+         spec_val(s,sp_proc_ptr)->p_parent = NULL;
 
       }
    }
@@ -877,7 +862,7 @@ Ptr myAddr;
             break;
 
          s = unittab_ptr->ut_data_ptr + pub.pu_offset;
-         assert((s->sp_val.sp_proc_ptr)->p_type == NATIVE_PROC);
+         assert(spec_val(s,sp_proc_ptr)->p_type == NATIVE_PROC);
 
          if (pub.pu_name_length>i) {
             i = pub.pu_name_length;
@@ -917,7 +902,7 @@ Ptr myAddr;
          if (symbol_ptr == NULL)
             giveup(SETL_SYSTEM msg_symbol_not_resolved,symbol);
          else 
-            (s->sp_val.sp_proc_ptr)->p_func_ptr = symbol_ptr;
+            spec_val(s,sp_proc_ptr)->p_func_ptr = symbol_ptr;
 
       } 
 
@@ -934,7 +919,7 @@ Ptr myAddr;
       read_libstr(SETL_SYSTEM libstr_ptr,(char *)&LABEL,sizeof(label_record));
 
       s = unittab_ptr->ut_data_ptr + LABEL.lr_symtab_offset;
-      s->sp_form = ft_label;
+      spec_set_form(s,ft_label);
 
 #ifdef DEBUG
 
@@ -949,14 +934,14 @@ Ptr myAddr;
       if (LABEL.lr_label_offset < 0) {
 
          LABEL.lr_label_offset = -LABEL.lr_label_offset - 1;
-         s->sp_val.sp_label_ptr = unittab_ptr->ut_init_code +
-                                  LABEL.lr_label_offset;
+         spec_set_val(s,sp_label_ptr,unittab_ptr->ut_init_code +
+                                  LABEL.lr_label_offset);
 
       }
       else {
 
-         s->sp_val.sp_label_ptr = unittab_ptr->ut_body_code +
-                                  LABEL.lr_label_offset;
+         spec_set_val(s,sp_label_ptr,unittab_ptr->ut_body_code +
+                                  LABEL.lr_label_offset);
 
       }
    }
@@ -984,31 +969,15 @@ libstr_ptr_type libstr_ptr;            /* work library stream               */
 public_record pub;                     /* public symbol record              */
 struct specifier_item key_spec;        /* specifier for map key             */
 string_h_ptr_type target_hdr;          /* target string                     */
-string_c_ptr_type target_cell;         /* target string cell                */
-map_h_ptr_type map_work_hdr;           /* internal node pointer             */
-map_c_ptr_type map_cell;               /* current cell pointer              */
-map_c_ptr_type *map_tail;              /* attach new cells here             */
-int map_height, map_index;             /* current height and index          */
-map_h_ptr_type new_hdr;                /* created header node               */
+int is_new;                            /* YES if a cell was added           */
 map_c_ptr_type new_cell;               /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int32 i, j;
+int32 work_hash_code;                  /* hash code of symbol name          */
 
    /*
     *  Create an empty map from symbol to procedure pointer.
     */
 
-   get_map_header(symbol_map);
-   symbol_map->m_use_count = 1;
-   symbol_map->m_hash_code = 0;
-   symbol_map->m_ntype.m_root.m_cardinality = 0;
-   symbol_map->m_ntype.m_root.m_cell_count = 0;
-   symbol_map->m_ntype.m_root.m_height = 0;
-   for (i = 0;
-        i < MAP_HASH_SIZE;
-        symbol_map->m_child[i++].m_cell = NULL);
+   symbol_map = null_map(SETL_SYSTEM_VOID);
 
    /*
     *  Read through the list of public symbols.
@@ -1024,113 +993,47 @@ int32 i, j;
        *  Make a setl2 string out of the procedure name.
        */
 
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = pub.pu_name_length;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-
-      /* copy the argument to the string */
+      target_hdr = new_string_buffer(SETL_SYSTEM pub.pu_name_length);
 
-      while (pub.pu_name_length > 0) {
+      /* copy the name to the string */
 
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
+      if (pub.pu_name_length > 0)
+         read_libstr(SETL_SYSTEM libstr_ptr, target_hdr->s_chars,
+                     pub.pu_name_length);
 
-         j = min(pub.pu_name_length, STR_CELL_WIDTH);
-         read_libstr(SETL_SYSTEM libstr_ptr, target_cell->s_cell_value, j);
-         pub.pu_name_length -= j;
 
-      }
-
-      key_spec.sp_form = ft_string;
-      key_spec.sp_val.sp_string_ptr = target_hdr;
+      spec_set_form(&key_spec,ft_string);
+      spec_set_val(&key_spec,sp_string_ptr,target_hdr);
 
       /*
        *  The string is the key into the map.
        */
 
-      map_work_hdr = symbol_map;
       spec_hash_code(work_hash_code, &key_spec);
-      for (map_height = symbol_map->m_ntype.m_root.m_height;
-           map_height;
-           map_height--) {
-
-         /* extract the element's index at this level */
-
-         map_index = work_hash_code & MAP_HASH_MASK;
-         work_hash_code >>= MAP_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (map_work_hdr->m_child[map_index].m_header == NULL) {
-
-            get_map_header(new_hdr);
-            new_hdr->m_ntype.m_intern.m_parent = map_work_hdr;
-            new_hdr->m_ntype.m_intern.m_child_index = map_index;
-            for (i = 0;
-                 i < MAP_HASH_SIZE;
-                 new_hdr->m_child[i++].m_cell = NULL);
-            map_work_hdr->m_child[map_index].m_header = new_hdr;
-            map_work_hdr = new_hdr;
-
-         }
-         else {
-
-            map_work_hdr = map_work_hdr->m_child[map_index].m_header;
+      new_cell = map_locate(&(symbol_map->m_trie),
+                            &key_spec,
+                            work_hash_code,
+                            &is_new);
 
-         }
-      }
-
-      /*
-       *  At this point, map_work_hdr points to the lowest level
-       *  header record.
-       */
+      /* symbol names are unique, but don't lose a cell if they're not */
 
-      map_index = work_hash_code & MAP_HASH_MASK;
-      map_tail = &(map_work_hdr->m_child[map_index].m_cell);
-      spec_hash_code(work_hash_code, &key_spec);
-      for (map_cell = *map_tail;
-           map_cell != NULL &&
-              map_cell->m_hash_code < work_hash_code;
-           map_cell = map_cell->m_next) {
+      if (!is_new) {
 
-         map_tail = &(map_cell->m_next);
+         free_string(SETL_SYSTEM target_hdr);
+         continue;
 
       }
 
-      /* we don't have to worry about duplicates -- add a cell */
-
-      get_map_cell(new_cell);
-      new_cell->m_domain_spec.sp_form = ft_string;
-      new_cell->m_domain_spec.sp_val.sp_string_ptr = target_hdr;
+      spec_set_form(&new_cell->m_domain_spec,ft_string);
+      spec_set_val(&new_cell->m_domain_spec,sp_string_ptr,target_hdr);
       memcpy(&(new_cell->m_range_spec),
              unittab_ptr->ut_data_ptr + pub.pu_offset,
              sizeof(struct specifier_item));
       mark_specifier(&(new_cell->m_range_spec));
       new_cell->m_is_multi_val = NO;
-      spec_hash_code(new_cell->m_hash_code, &(new_cell->m_domain_spec));
-      new_cell->m_next = *map_tail;
-      *map_tail = new_cell;
-      symbol_map->m_ntype.m_root.m_cardinality++;
-      symbol_map->m_ntype.m_root.m_cell_count++;
-      symbol_map->m_hash_code ^= new_cell->m_hash_code;
-
-      expansion_trigger =
-            (1 << ((symbol_map->m_ntype.m_root.m_height + 1)
-                       * MAP_SHIFT_DIST)) * MAP_CLASH_SIZE;
-
-      /* expand the map header if necessary */
-
-      if (symbol_map->m_ntype.m_root.m_cardinality > expansion_trigger) {
-         symbol_map = map_expand_header(SETL_SYSTEM symbol_map);
-      }
+      symbol_map->m_cardinality++;
+      symbol_map->m_cell_count++;
+      symbol_map->m_hash_code ^= work_hash_code;
 
    }
 
@@ -1160,7 +1063,7 @@ instruction *return_ptr;               /* returned instruction list         */
 instruction *p;                        /* next instruction pointer          */
 pcode_record pcode;                    /* pseudo code record                */
 int operand;                           /* used to loop over operands        */
-int i;                                 /* temporary looping variable        */
+int i,j;                               /* temporary looping variables       */
 long nlines;                           /* number of lines                   */
 
    /* allocate space for the pseudo code instructions */
@@ -1283,6 +1186,39 @@ long nlines;                           /* number of lines                   */
    p->i_operand[1].i_func_ptr = NULL;
    p->i_operand[2].i_func_ptr = NULL;
 
+#if THREADED_CODE
+
+   /* thread the code, replacing each opcode by its interpreter case */
+
+   if (pcode_handlers == NULL)
+      execute_go(SETL_SYSTEM EX_HANDLERS);
+
+   for (i = 0; return_ptr + i <= p; i++)
+      return_ptr[i].i_handler = pcode_handlers[return_ptr[i].i_opcode];
+
+   /*
+    *  Now look for pairs of instructions we can handle with a single
+    *  superinstruction.  The second instruction keeps its own handler,
+    *  since it may be the target of a branch.
+    */
+
+   for (i = 0; return_ptr + i < p; i++) {
+
+      for (j = 0; superinstructions[j].si_first != -1; j++) {
+
+         if (return_ptr[i].i_opcode == superinstructions[j].si_first &&
+             return_ptr[i + 1].i_opcode == superinstructions[j].si_second) {
+
+            return_ptr[i].i_handler =
+               pcode_handlers[superinstructions[j].si_super];
+            break;
+
+         }
+      }
+   }
+
+#endif
+
 #ifdef DEBUG
    if ((EX_DEBUG)&&(unittab_ptr->ut_nlines<nlines))
      unittab_ptr->ut_nlines=nlines;
@@ -1648,7 +1584,7 @@ int mpw_bug_workaround;
       giveup(SETL_SYSTEM msg_malloc_error);
 
    memcpy(unittab_ptr->ut_err_ext_map,&SYMBOL_MAP,sizeof(specifier));
-   SYMBOL_MAP.sp_form = ft_omega;
+   spec_set_form(&SYMBOL_MAP,ft_omega);
 
    /* we're finished with the library */
 
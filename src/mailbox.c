@@ -50,105 +50,6 @@
 #include "specs.h"                     /* specifiers                        */
 #include "mailbox.h"                   /* mailboxes                         */
 
-/* performance tuning constants */
-
-#define MBOX_HEADER_BLOCK_SIZE  50     /* mailbox header block size         */
-#define MBOX_CELL_BLOCK_SIZE   200     /* mailbox cell block size           */
-
-/*\
- *  \function{alloc\_mailbox\_headers()}
- *
- *  This function allocates a block of mailbox headers and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste header items to pointers to header items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the header node.
- *  It will work provided a header item is larger than a pointer, which
- *  is the case.
-\*/
-
-void alloc_mailbox_headers(
-   SETL_SYSTEM_PROTO_VOID)
-
-{      
-mailbox_h_ptr_type new_block;          /* first header in allocated block   */
-
-   /* allocate a new block */
-
-   new_block = (mailbox_h_ptr_type)malloc((size_t)
-         (MBOX_HEADER_BLOCK_SIZE * sizeof(struct mailbox_h_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (MAILBOX_H_NEXT_FREE = new_block;
-        MAILBOX_H_NEXT_FREE < new_block + MBOX_HEADER_BLOCK_SIZE - 1;
-        MAILBOX_H_NEXT_FREE++) {
-
-      *((mailbox_h_ptr_type *)MAILBOX_H_NEXT_FREE) = MAILBOX_H_NEXT_FREE + 1;
-
-   }
-
-   *((mailbox_h_ptr_type *)MAILBOX_H_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   MAILBOX_H_NEXT_FREE = new_block;
-
-   return;
-
-}
-
-/*\
- *  \function{alloc\_mailbox\_cells()}
- *
- *  This function allocates a block of mailbox cells and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste cell items to pointers to cell items in order to form the free
- *  list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently, while
- *  at the same time avoiding an extra pointer on the cell node.  It
- *  will work provided a cell item is larger than a pointer, which is
- *  the case.
-\*/
-
-void alloc_mailbox_cells(
-   SETL_SYSTEM_PROTO_VOID)
-
-{      
-mailbox_c_ptr_type new_block;          /* first cell in allocated block     */
-
-   /* allocate a new block */
-
-   new_block = (mailbox_c_ptr_type)malloc((size_t)
-         (MBOX_CELL_BLOCK_SIZE * sizeof(struct mailbox_c_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (MAILBOX_C_NEXT_FREE = new_block;
-        MAILBOX_C_NEXT_FREE < new_block + MBOX_CELL_BLOCK_SIZE - 1;
-        MAILBOX_C_NEXT_FREE++) {
-
-      *((mailbox_c_ptr_type *)MAILBOX_C_NEXT_FREE) = MAILBOX_C_NEXT_FREE + 1;
-
-   }
-
-   *((mailbox_c_ptr_type *)MAILBOX_C_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   MAILBOX_C_NEXT_FREE = new_block;
-
-   return;
-
-}
-
 /*\
  *  \function{free\_mailbox()}
  *
@@ -28,11 +28,16 @@
 
 #ifndef MAILBOX_LOADED
 
+/* SETL2 system header files */
+
+#include "slabs.h"                     /* slabs                             */
+
 /* mailbox header node structure */
 
 struct mailbox_h_item {
    int32 mb_use_count;                 /* usage count                       */
    int32 mb_cell_count;                /* number of cells                   */
+   int32 mb_capacity;                  /* most cells, or 0 for no bound     */
    struct mailbox_c_item *mb_head;     /* first cell in list                */
    struct mailbox_c_item **mb_tail;    /* last cell in list                 */
 };
@@ -53,61 +58,45 @@ typedef struct mailbox_c_item *mailbox_c_ptr_type;
 /* global data */
 
 #ifdef TSAFE
-#define MAILBOX_H_NEXT_FREE plugin_instance->mailbox_h_next_free 
-#define MAILBOX_C_NEXT_FREE plugin_instance->mailbox_c_next_free 
+#define MAILBOX_H_SLAB plugin_instance->mailbox_h_slab
+#define MAILBOX_C_SLAB plugin_instance->mailbox_c_slab
 #else
-#define MAILBOX_H_NEXT_FREE mailbox_h_next_free 
-#define MAILBOX_C_NEXT_FREE mailbox_c_next_free 
+#define MAILBOX_H_SLAB mailbox_h_slab
+#define MAILBOX_C_SLAB mailbox_c_slab
 
 #ifdef SHARED
        
-mailbox_h_ptr_type mailbox_h_next_free = NULL;
-                                       /* next free header                  */
-mailbox_c_ptr_type mailbox_c_next_free = NULL;
-                                       /* next free cell                    */
+struct slab_class_item mailbox_h_slab; /* header slabs                      */
+struct slab_class_item mailbox_c_slab; /* cell slabs                        */
 
 #else
 
-extern mailbox_h_ptr_type mailbox_h_next_free;
-                                       /* next free header                  */
-extern mailbox_c_ptr_type mailbox_c_next_free;
-                                       /* next free cell                    */
+extern struct slab_class_item mailbox_h_slab;
+                                       /* header slabs                      */
+extern struct slab_class_item mailbox_c_slab;
+                                       /* cell slabs                        */
 
 #endif
 #endif
 
 /* allocate and free header nodes */
 
-#define get_mailbox_header(t) {\
-   if (MAILBOX_H_NEXT_FREE == NULL) alloc_mailbox_headers(SETL_SYSTEM_VOID); \
-   (t) = MAILBOX_H_NEXT_FREE; \
-   MAILBOX_H_NEXT_FREE = *((mailbox_h_ptr_type *)(MAILBOX_H_NEXT_FREE)); \
-}
+#define get_mailbox_header(t) \
+   slab_get(MAILBOX_H_SLAB,"mailbox header",mailbox_h_ptr_type,t,\
+            sizeof(struct mailbox_h_item))
 
-#define free_mailbox_header(s) {\
-   *((mailbox_h_ptr_type *)(s)) = MAILBOX_H_NEXT_FREE; \
-   MAILBOX_H_NEXT_FREE = s; \
-}
+#define free_mailbox_header(s) slab_put(s)
 
 /* allocate and free cell nodes */
 
-#define get_mailbox_cell(t) {\
-   if (MAILBOX_C_NEXT_FREE == NULL) alloc_mailbox_cells(SETL_SYSTEM_VOID); \
-   (t) = MAILBOX_C_NEXT_FREE; \
-   MAILBOX_C_NEXT_FREE = *((mailbox_c_ptr_type *)(MAILBOX_C_NEXT_FREE)); \
-}
+#define get_mailbox_cell(t) \
+   slab_get(MAILBOX_C_SLAB,"mailbox cell",mailbox_c_ptr_type,t,\
+            sizeof(struct mailbox_c_item))
 
-#define free_mailbox_cell(s) {\
-   *((mailbox_c_ptr_type *)(s)) = MAILBOX_C_NEXT_FREE; \
-   MAILBOX_C_NEXT_FREE = s; \
-}
+#define free_mailbox_cell(s) slab_put(s)
 
 /* public function declarations */
 
-void alloc_mailbox_headers(SETL_SYSTEM_PROTO_VOID);      
-                                       /* allocate a block of header nodes  */
-void alloc_mailbox_cells(SETL_SYSTEM_PROTO_VOID);        
-                                       /* allocate a block of cell nodes    */
 void free_mailbox(SETL_SYSTEM_PROTO mailbox_h_ptr_type); 
                                        /* release memory used by mailbox    */
 
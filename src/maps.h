@@ -31,35 +31,16 @@
 /* SETL2 system header files */
 
 #include "specs.h"                     /* specifiers                        */
-
-/* constants */
-
-#define MAP_HASH_SIZE      4           /* map hash table size (each header) */
-#define MAP_SHIFT_DIST     2           /* log (base 2) of MAP_HASH_SIZE     */
-#define MAP_CLASH_SIZE     3           /* average clash length which        */
-                                       /* triggers header expansion         */
-#define MAP_HASH_MASK   0x03           /* pick out one level of header tree */
+#include "sets.h"                      /* sets                              */
 
 /* map header node structure */
 
 struct map_h_item {
    int32 m_use_count;                  /* usage count                       */
    int32 m_hash_code;                  /* hash code                         */
-   union {
-      struct {                         /* root header info                  */
-         int32 m_cardinality;          /* number of elements in map         */
-         int32 m_cell_count;           /* number of cells in map            */
-         int m_height;                 /* height of header tree             */
-      } m_root;
-      struct {                         /* internal node info                */
-         struct map_h_item *m_parent;  /* parent in header tree             */
-         int m_child_index;            /* index in parent's hash table      */
-      } m_intern;
-   } m_ntype;
-   union {
-      struct map_c_item *m_cell;       /* cell child pointer                */
-      struct map_h_item *m_header;     /* internal header node pointer      */
-   } m_child[MAP_HASH_SIZE];
+   int32 m_cardinality;                /* number of elements in map         */
+   int32 m_cell_count;                 /* number of cells in map            */
+   struct set_n_item *m_trie;          /* root of hash trie, NULL if empty  */
 };
 
 typedef struct map_h_item *map_h_ptr_type;
@@ -67,8 +48,14 @@ typedef struct map_h_item *map_h_ptr_type;
 
 /* map cell node structure */
 
+/*
+ *  Map cells are kept in the same hash tries as set cells, keyed on the
+ *  domain element.  The first three fields must match those of a set
+ *  cell, so the set trie functions can find and move map cells.
+ */
+
 struct map_c_item {
-   struct map_c_item *m_next;          /* next cell on clash list           */
+   struct map_c_item *m_next;          /* next cell with same hash code     */
    int32 m_hash_code;                  /* element's full hash code          */
    struct specifier_item m_domain_spec; /* element specifier                */
    struct specifier_item m_range_spec; /* element specifier                 */
@@ -78,24 +65,49 @@ struct map_c_item {
 typedef struct map_c_item *map_c_ptr_type;
                                        /* cell node pointer                 */
 
+/* map pair iteration cursor */
+
+struct map_cursor_item {
+   struct set_cursor_item mc_cursor;   /* position in map                   */
+   map_c_ptr_type mc_cell;             /* multi-valued cell in progress     */
+   struct set_cursor_item mc_valset_cursor;
+                                       /* position in its value set         */
+};
+
+/* map cells in set tries */
+
+#define map_lookup(t,d,h) \
+   ((map_c_ptr_type)set_lookup(SETL_SYSTEM (t),(d),(h)))
+#define map_locate(t,d,h,n) \
+   ((map_c_ptr_type)set_locate(SETL_SYSTEM (t),(d),(h), \
+                               sizeof(struct map_c_item),(n)))
+#define map_unlink(t,d,h) \
+   ((map_c_ptr_type)set_unlink(SETL_SYSTEM (t),(d),(h)))
+#define map_update(t,d,h) \
+   ((map_c_ptr_type)set_update(SETL_SYSTEM (t),(d),(h)))
+#define map_cursor_next(c) \
+   ((map_c_ptr_type)set_cursor_next(c))
+
 /* global data */
 
 #ifdef TSAFE
-#define MAP_H_NEXT_FREE plugin_instance->map_h_next_free 
-#define MAP_C_NEXT_FREE plugin_instance->map_c_next_free 
+#define MAP_H_SLAB plugin_instance->map_h_slab
+#define MAP_C_SLAB plugin_instance->map_c_slab
 #else
-#define MAP_H_NEXT_FREE map_h_next_free 
-#define MAP_C_NEXT_FREE map_c_next_free 
+#define MAP_H_SLAB map_h_slab
+#define MAP_C_SLAB map_c_slab
 
 #ifdef SHARED
 
-map_h_ptr_type map_h_next_free = NULL; /* next free header                  */
-map_c_ptr_type map_c_next_free = NULL; /* next free cell                    */
+struct slab_class_item map_h_slab;     /* header slabs                      */
+struct slab_class_item map_c_slab;     /* cell slabs                        */
 
 #else
 
-extern map_h_ptr_type map_h_next_free; /* next free header                  */
-extern map_c_ptr_type map_c_next_free; /* next free cell                    */
+extern struct slab_class_item map_h_slab;
+                                       /* header slabs                      */
+extern struct slab_class_item map_c_slab;
+                                       /* cell slabs                        */
 
 #endif
 #endif
@@ -122,46 +134,37 @@ extern map_c_ptr_type map_c_next_free; /* next free cell                    */
 
 #else
 
-#define get_map_header(t) {\
-   if (MAP_H_NEXT_FREE == NULL) alloc_map_headers(SETL_SYSTEM_VOID); \
-   t = MAP_H_NEXT_FREE; \
-   MAP_H_NEXT_FREE = *((map_h_ptr_type *)(MAP_H_NEXT_FREE)); \
-}
+#define get_map_header(t) \
+   slab_get(MAP_H_SLAB,"map header",map_h_ptr_type,t,\
+            sizeof(struct map_h_item))
 
-#define free_map_header(s) {\
-   *((map_h_ptr_type *)(s)) = MAP_H_NEXT_FREE; \
-   MAP_H_NEXT_FREE = s; \
-}
+#define free_map_header(s) slab_put(s)
 
 /* allocate and free cell nodes */
 
-#define get_map_cell(t) {\
-   if (MAP_C_NEXT_FREE == NULL) alloc_map_cells(SETL_SYSTEM_VOID); \
-   t = MAP_C_NEXT_FREE; \
-   MAP_C_NEXT_FREE = *((map_c_ptr_type *)(MAP_C_NEXT_FREE)); \
-}
+#define get_map_cell(t) \
+   slab_get(MAP_C_SLAB,"map cell",map_c_ptr_type,t,\
+            sizeof(struct map_c_item))
 
-#define free_map_cell(s) {\
-   *((map_c_ptr_type *)(s)) = MAP_C_NEXT_FREE; \
-   MAP_C_NEXT_FREE = s; \
-}
+#define free_map_cell(s) slab_put(s)
 #endif
 
 /* public function declarations */
 
-void alloc_map_headers(SETL_SYSTEM_PROTO_VOID);          
-                                       /* allocate a block of header nodes  */
-void alloc_map_cells(SETL_SYSTEM_PROTO_VOID);            
-                                       /* allocate a block of cell nodes    */
+void free_map(SETL_SYSTEM_PROTO map_h_ptr_type);
+                                       /* free memory used by map           */
+void release_map_trie(SETL_SYSTEM_PROTO set_n_ptr_type, int32 *);
+                                       /* free an unused trie node          */
+map_h_ptr_type null_map(SETL_SYSTEM_PROTO_VOID);
+                                       /* return an empty map               */
 map_h_ptr_type copy_map(SETL_SYSTEM_PROTO
                         map_h_ptr_type);
                                        /* copy a map structure              */
-map_h_ptr_type map_expand_header(SETL_SYSTEM_PROTO
-                                 map_h_ptr_type);
-                                       /* enlarge a map header tree         */
-map_h_ptr_type map_contract_header(SETL_SYSTEM_PROTO
-                                   map_h_ptr_type);
-                                       /* shrink a map header tree          */
+void map_pair_start(struct map_cursor_item *, map_h_ptr_type);
+                                       /* start iterating over map pairs    */
+map_c_ptr_type map_pair_next(struct map_cursor_item *,
+                             struct specifier_item **);
+                                       /* next pair in a map                */
 int set_to_map(SETL_SYSTEM_PROTO
                struct specifier_item *, struct specifier_item *,
                int domain_omega_allowed);
@@ -28,10 +28,16 @@
  *  This package contains the math built-in functions.  For the most
  *  complicated of these we simply call the standard C functions which do
  *  the same thing.
+ *
+ *  The functions of one number also accept a tuple, and return the tuple
+ *  of results.  At the end of the package are reductions which find the
+ *  sum, product, minimum, maximum or dot product of tuples of numbers.
 \*/
 
 /* standard C header files */
 
+#include <stdlib.h>                    /* labs                              */
+#include <string.h>                    /* memcpy                            */
 #include <math.h>                      /* C math functions                  */
 #if UNIX | MACINTOSH | WATCOM
 #include <errno.h>                     /* error symbols                     */
@@ -53,11 +59,65 @@
 #include "x_integers.h"                /* integers                          */
 #include "x_reals.h"                   /* real numbers                      */
 #include "x_strngs.h"                  /* strings                           */
+#include "tuples.h"                    /* tuples                            */
+
+/*
+ *  We build integers converted from reals from cells, but we give up on
+ *  reals with more than 53 integer bits.  Leave room for a carry.
+ */
+
+#define FIX_CELL_COUNT (53 / INT_CELL_WIDTH + 2)
 
 #if !(WATCOM)
 extern int errno;                      /* error flag                        */
 #endif
 
+/*
+ *  The math functions also map over tuples, and packed tuples of numbers
+ *  take a path of their own through loops over the bare arrays.  These
+ *  codes tell those loops which function to apply.
+ */
+
+#define VEC_ABS            0           /* abs                               */
+#define VEC_FLOAT          1           /* float                             */
+#define VEC_SIGN           2           /* sign                              */
+#define VEC_FIX            3           /* fix                               */
+#define VEC_FLOOR          4           /* floor                             */
+#define VEC_CEIL           5           /* ceil                              */
+#define VEC_EXP            6           /* exp                               */
+#define VEC_LOG            7           /* log                               */
+#define VEC_COS            8           /* cos                               */
+#define VEC_SIN            9           /* sin                               */
+#define VEC_TAN            10          /* tan                               */
+#define VEC_ACOS           11          /* acos                              */
+#define VEC_ASIN           12          /* asin                              */
+#define VEC_ATAN           13          /* atan                              */
+#define VEC_TANH           14          /* tanh                              */
+#define VEC_SQRT           15          /* sqrt                              */
+
+/* rounded reals this large are left to the scalar functions */
+
+#define PACKED_FIX_LIMIT   4503599627370496.0
+                                       /* 2 ** 52                           */
+
+/* reductions over tuples */
+
+#define RED_SUM            0           /* tuple_sum                         */
+#define RED_PRODUCT        1           /* tuple_product                     */
+#define RED_MIN            2           /* tuple_min                         */
+#define RED_MAX            3           /* tuple_max                         */
+
+/* forward function declarations */
+
+static void map_tuple(SETL_SYSTEM_PROTO int,
+                      void (*)(SETL_SYSTEM_PROTO int, specifier *,
+                               specifier *),
+                      specifier *, specifier *);
+                                       /* apply a function to each element  */
+static tuple_h_ptr_type map_packed(SETL_SYSTEM_PROTO int,
+                                   tuple_h_ptr_type);
+                                       /* map over a packed tuple           */
+
 /*\
  *  \function{setl2\_abs()}
  *
@@ -76,15 +136,22 @@ void setl2_abs(
 {
 integer_h_ptr_type integer_hdr;        /* integer header pointer            */
 int32 short_value;                     /* short integer value               */
-int32 short_hi_bits;                   /* high order bits of short          */
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 string_h_ptr_type string_hdr;          /* string header pointer             */
-string_c_ptr_type string_cell;         /* string cell pointer               */
+
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_ABS,setl2_abs,argv,target);
+
+      return;
+
+   }
 
    /* abs is valid for integers and reals */
 
-   switch (argv[0].sp_form) {
+   switch (spec_form(&argv[0])) {
 
       /*
        *  If the source is short, we find the absolute value and test
@@ -93,16 +160,15 @@ string_c_ptr_type string_cell;         /* string cell pointer               */
 
       case ft_short :
 
-         short_value = labs(argv[0].sp_val.sp_short_value);
+         short_value = labs(spec_val(&argv[0],sp_short_value));
 
          /* check whether the result remains short */
 
-         if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-             short_hi_bits == INT_HIGH_BITS) {
+         if (is_short_value(short_value)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_value;
+            spec_set_form(target,ft_short);
+            spec_set_val(target,sp_short_value,short_value);
 
             return;
 
@@ -115,34 +181,13 @@ string_c_ptr_type string_cell;         /* string cell pointer               */
          return;
 
       /*
-       *  If the source is long, we find the absolute value and try to
-       *  make it into a short.  This is necessary since the acceptable
-       *  magnitudes of positive and negative shorts are not the same.
+       *  If the source is long, we find the absolute value.  Shorts
+       *  range as far below zero as above, so the result must be long.
        */
 
       case ft_long :
 
-         integer_hdr = argv[0].sp_val.sp_long_ptr;
-
-         /* try to convert to short */
-
-         if (integer_hdr->i_cell_count < 3) {
-
-            short_value = labs(long_to_short(SETL_SYSTEM integer_hdr));
-
-            /* check whether it will fit in a short */
-
-            if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-                short_hi_bits == INT_HIGH_BITS) {
-
-               unmark_specifier(target);
-               target->sp_form = ft_short;
-               target->sp_val.sp_short_value = short_value;
-
-               return;
-
-            }
-         }
+         integer_hdr = spec_val(&argv[0],sp_long_ptr);
 
          /*
           *  We just make the sign of the long integer positive.  Notice
@@ -152,8 +197,8 @@ string_c_ptr_type string_cell;         /* string cell pointer               */
          integer_hdr = copy_integer(SETL_SYSTEM integer_hdr);
          integer_hdr->i_is_negative = NO;
          unmark_specifier(target);
-         target->sp_form = ft_long;
-         target->sp_val.sp_long_ptr = integer_hdr;
+         spec_set_form(target,ft_long);
+         spec_set_val(target,sp_long_ptr,integer_hdr);
 
          return;
 
@@ -164,16 +209,13 @@ string_c_ptr_type string_cell;         /* string cell pointer               */
 
       case ft_real :
 
-         real_number = fabs((argv[0].sp_val.sp_real_ptr)->r_value);
+         real_number = fabs(spec_val(&argv[0],sp_real_value));
 
-         /* allocate a real */
+         /* set the target */
 
          unmark_specifier(target);
-         i_get_real(real_ptr);
-         target->sp_form = ft_real;
-         target->sp_val.sp_real_ptr = real_ptr;
-         real_ptr->r_use_count = 1;
-         real_ptr->r_value = real_number;
+         spec_set_form(target,ft_real);
+         spec_set_val(target,sp_real_value,real_number);
 
          return;
 
@@ -186,17 +228,16 @@ string_c_ptr_type string_cell;         /* string cell pointer               */
 
       case ft_string :
 
-         string_hdr = argv[0].sp_val.sp_string_ptr;
+         string_hdr = spec_val(&argv[0],sp_string_ptr);
 
          if (string_hdr->s_length != 1)
             abend(SETL_SYSTEM msg_abs_too_long,abend_opnd_str(SETL_SYSTEM argv));
 
-         string_cell = string_hdr->s_head;
-
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value =
-            (unsigned char)(string_cell->s_cell_value[0]);
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,
+            (unsigned char)(string_hdr->s_chars[0]));
+
 
          return;
 
@@ -230,7 +271,7 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
 
    /* even is only valid for integers */
 
-   switch (argv[0].sp_form) {
+   switch (spec_form(&argv[0])) {
 
       /*
        *  If the source is short, we find the absolute value and check
@@ -239,11 +280,11 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
 
       case ft_short :
 
-         if (!(labs(argv[0].sp_val.sp_short_value) & 0x01)) {
+         if (!(labs(spec_val(&argv[0],sp_short_value)) & 0x01)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_atom;
-            target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+            spec_set_form(target,ft_atom);
+            spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
             return;
 
@@ -251,8 +292,8 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
          else {
 
             unmark_specifier(target);
-            target->sp_form = ft_atom;
-            target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+            spec_set_form(target,ft_atom);
+            spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
             return;
 
@@ -260,18 +301,18 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
 
       /*
        *  If the source is long we check the low order bit of the low
-       *  order cell.
+       *  order limb.
        */
 
       case ft_long :
 
-         integer_hdr = argv[0].sp_val.sp_long_ptr;
+         integer_hdr = spec_val(&argv[0],sp_long_ptr);
 
-         if (!((integer_hdr->i_head)->i_cell_value & 0x01)) {
+         if (!(integer_hdr->i_limbs[0] & 0x01)) {
 
             unmark_specifier(target);
-            target->sp_form = ft_atom;
-            target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+            spec_set_form(target,ft_atom);
+            spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
             return;
 
@@ -279,8 +320,8 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
          else {
 
             unmark_specifier(target);
-            target->sp_form = ft_atom;
-            target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+            spec_set_form(target,ft_atom);
+            spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
             return;
 
@@ -316,7 +357,7 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
 
    /* odd is only valid for integers */
 
-   switch (argv[0].sp_form) {
+   switch (spec_form(&argv[0])) {
 
       /*
        *  If the source is short, we find the absolute value and check
@@ -325,11 +366,11 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
 
       case ft_short :
 
-         if (labs(argv[0].sp_val.sp_short_value) & 0x01) {
+         if (labs(spec_val(&argv[0],sp_short_value)) & 0x01) {
 
             unmark_specifier(target);
-            target->sp_form = ft_atom;
-            target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+            spec_set_form(target,ft_atom);
+            spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
             return;
 
@@ -337,8 +378,8 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
          else {
 
             unmark_specifier(target);
-            target->sp_form = ft_atom;
-            target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+            spec_set_form(target,ft_atom);
+            spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
             return;
 
@@ -346,18 +387,18 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
 
       /*
        *  If the source is long we check the low order bit of the low
-       *  order cell.
+       *  order limb.
        */
 
       case ft_long :
 
-         integer_hdr = argv[0].sp_val.sp_long_ptr;
+         integer_hdr = spec_val(&argv[0],sp_long_ptr);
 
-         if ((integer_hdr->i_head)->i_cell_value & 0x01) {
+         if (integer_hdr->i_limbs[0] & 0x01) {
 
             unmark_specifier(target);
-            target->sp_form = ft_atom;
-            target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+            spec_set_form(target,ft_atom);
+            spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
             return;
 
@@ -365,8 +406,8 @@ integer_h_ptr_type integer_hdr;        /* integer header pointer            */
          else {
 
             unmark_specifier(target);
-            target->sp_form = ft_atom;
-            target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+            spec_set_form(target,ft_atom);
+            spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
             return;
 
@@ -397,12 +438,21 @@ void setl2_float(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FLOAT,setl2_float,argv,target);
+
+      return;
+
+   }
+
    /* float is only valid for integers */
 
-   switch (argv[0].sp_form) {
+   switch (spec_form(&argv[0])) {
 
       /*
        *  If the source is short, we use a C typecast to perform the
@@ -411,16 +461,13 @@ double real_number;                    /* real value                        */
 
       case ft_short :
 
-         real_number = (double)(argv[0].sp_val.sp_short_value);
+         real_number = (double)(spec_val(&argv[0],sp_short_value));
 
-         /* allocate a real */
+         /* set the target */
 
          unmark_specifier(target);
-         i_get_real(real_ptr);
-         target->sp_form = ft_real;
-         target->sp_val.sp_real_ptr = real_ptr;
-         real_ptr->r_use_count = 1;
-         real_ptr->r_value = real_number;
+         spec_set_form(target,ft_real);
+         spec_set_val(target,sp_real_value,real_number);
 
          return;
 
@@ -433,14 +480,11 @@ double real_number;                    /* real value                        */
 
          real_number = long_to_double(SETL_SYSTEM argv);
 
-         /* allocate a real */
+         /* set the target */
 
          unmark_specifier(target);
-         i_get_real(real_ptr);
-         target->sp_form = ft_real;
-         target->sp_val.sp_real_ptr = real_ptr;
-         real_ptr->r_use_count = 1;
-         real_ptr->r_value = real_number;
+         spec_set_form(target,ft_real);
+         spec_set_val(target,sp_real_value,real_number);
 
          return;
 
@@ -470,20 +514,19 @@ void setl2_atan2(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 double real_input2;
 
-   if (argv[0].sp_form == ft_real) {
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -495,15 +538,15 @@ double real_input2;
    }
 
 
-   if (argv[1].sp_form == ft_real) {
+   if (spec_form(&argv[1]) == ft_real) {
    
-   		real_input2 = (argv[1].sp_val.sp_real_ptr)->r_value;
+   		real_input2 = spec_val(&argv[1],sp_real_value);
 
-   } else if (argv[1].sp_form == ft_short) {
+   } else if (spec_form(&argv[1]) == ft_short) {
    		
-   		real_input2 = (double)(argv[1].sp_val.sp_short_value);
+   		real_input2 = (double)(spec_val(&argv[1],sp_short_value));
    	
-   } else if (argv[1].sp_form == ft_long) {
+   } else if (spec_form(&argv[1]) == ft_long) {
    
    		real_input2 = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -536,14 +579,11 @@ double real_input2;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -593,22 +633,35 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FIX,setl2_fix,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"fix",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 7;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 7;
 
    /* pick out the sign */
 
@@ -625,8 +678,8 @@ unsigned char *p;                      /* temporary looping variable        */
    if ((!sign && exponent == -((1 << 10) - 2)) || exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -637,7 +690,7 @@ unsigned char *p;                      /* temporary looping variable        */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value));
+   p = ((unsigned char *)&real_value);
    curr_byte = *p++;
    curr_bits_left = 8;
    bits_left = 45;
@@ -754,12 +807,11 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -778,16 +830,8 @@ unsigned char *p;                      /* temporary looping variable        */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -820,7 +864,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -829,7 +873,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -858,9 +902,9 @@ unsigned char *p;                      /* temporary looping variable        */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -873,35 +917,25 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -938,22 +972,35 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FIX,setl2_fix,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"fix",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value));
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value);
 
    /* pick out the sign */
 
@@ -970,8 +1017,8 @@ unsigned char *p;                      /* temporary looping variable        */
    if ((!sign && exponent == -((1 << 10) - 2)) || exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -982,7 +1029,7 @@ unsigned char *p;                      /* temporary looping variable        */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 7;
+   p = ((unsigned char *)&real_value) + 7;
    curr_byte = *p--;
    curr_bits_left = 8;
    bits_left = 45;
@@ -1099,12 +1146,11 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -1123,16 +1169,8 @@ unsigned char *p;                      /* temporary looping variable        */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -1165,7 +1203,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -1174,7 +1212,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -1203,9 +1241,9 @@ unsigned char *p;                      /* temporary looping variable        */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -1218,35 +1256,25 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -1283,23 +1311,36 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 int odd;                               /* iteration odd or even             */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FIX,setl2_fix,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"fix",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 1;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 1;
 
    /* pick out the sign */
 
@@ -1316,8 +1357,8 @@ int odd;                               /* iteration odd or even             */
    if ((!sign && exponent == -(1 << 10)) || exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -1328,7 +1369,7 @@ int odd;                               /* iteration odd or even             */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 6;
+   p = ((unsigned char *)&real_value) + 6;
    curr_byte = *p++;
    odd = YES;
    curr_bits_left = 8;
@@ -1456,12 +1497,11 @@ int odd;                               /* iteration odd or even             */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -1480,16 +1520,8 @@ int odd;                               /* iteration odd or even             */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -1522,7 +1554,7 @@ int odd;                               /* iteration odd or even             */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -1531,7 +1563,7 @@ int odd;                               /* iteration odd or even             */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -1565,9 +1597,9 @@ int odd;                               /* iteration odd or even             */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -1580,35 +1612,25 @@ int odd;                               /* iteration odd or even             */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -1645,23 +1667,36 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 int odd;                               /* iteration odd or even             */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FIX,setl2_fix,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"fix",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 1;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 1;
 
    /* pick out the sign */
 
@@ -1678,8 +1713,8 @@ int odd;                               /* iteration odd or even             */
    if ((!sign && exponent == -(1 << 7)) || exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -1690,7 +1725,7 @@ int odd;                               /* iteration odd or even             */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 6;
+   p = ((unsigned char *)&real_value) + 6;
    curr_byte = *p++;
    odd = YES;
    curr_bits_left = 8;
@@ -1818,12 +1853,11 @@ int odd;                               /* iteration odd or even             */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -1842,16 +1876,8 @@ int odd;                               /* iteration odd or even             */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -1884,7 +1910,7 @@ int odd;                               /* iteration odd or even             */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -1893,7 +1919,7 @@ int odd;                               /* iteration odd or even             */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -1927,9 +1953,9 @@ int odd;                               /* iteration odd or even             */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -1942,35 +1968,25 @@ int odd;                               /* iteration odd or even             */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -2009,22 +2025,35 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FLOOR,setl2_floor,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"floor",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 7;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 7;
 
    /* pick out the sign */
 
@@ -2041,8 +2070,8 @@ unsigned char *p;                      /* temporary looping variable        */
    if ((!sign && exponent == -((1 << 10) - 2)) || exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0 - sign;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0 - sign);
 
       return;
 
@@ -2053,7 +2082,7 @@ unsigned char *p;                      /* temporary looping variable        */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value));
+   p = ((unsigned char *)&real_value);
    curr_byte = *p++;
    curr_bits_left = 8;
    bits_left = 45;
@@ -2182,12 +2211,11 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -2206,16 +2234,8 @@ unsigned char *p;                      /* temporary looping variable        */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -2248,7 +2268,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -2257,7 +2277,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -2286,9 +2306,9 @@ unsigned char *p;                      /* temporary looping variable        */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -2301,35 +2321,25 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -2366,22 +2376,35 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FLOOR,setl2_floor,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"floor",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value));
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value);
 
    /* pick out the sign */
 
@@ -2396,8 +2419,8 @@ unsigned char *p;                      /* temporary looping variable        */
    if ((!sign && exponent == -((1 << 10) - 2)) || exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0 - sign;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0 - sign);
 
       return;
 
@@ -2408,7 +2431,7 @@ unsigned char *p;                      /* temporary looping variable        */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 7;
+   p = ((unsigned char *)&real_value) + 7;
    curr_byte = *p--;
    curr_bits_left = 8;
    bits_left = 45;
@@ -2537,12 +2560,11 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -2561,16 +2583,8 @@ unsigned char *p;                      /* temporary looping variable        */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -2603,7 +2617,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -2612,7 +2626,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -2641,9 +2655,9 @@ unsigned char *p;                      /* temporary looping variable        */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -2656,35 +2670,25 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -2720,23 +2724,36 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 int odd;                               /* iteration odd or even             */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FLOOR,setl2_floor,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"floor",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 1;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 1;
 
    /* pick out the sign */
 
@@ -2753,8 +2770,8 @@ int odd;                               /* iteration odd or even             */
    if (!sign && exponent == -(1 << 10)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -2765,8 +2782,8 @@ int odd;                               /* iteration odd or even             */
    if (exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0 - sign;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0 - sign);
 
       return;
 
@@ -2777,7 +2794,7 @@ int odd;                               /* iteration odd or even             */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 6;
+   p = ((unsigned char *)&real_value) + 6;
    curr_byte = *p++;
    odd = YES;
    curr_bits_left = 8;
@@ -2917,12 +2934,11 @@ int odd;                               /* iteration odd or even             */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -2941,16 +2957,8 @@ int odd;                               /* iteration odd or even             */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -2983,7 +2991,7 @@ int odd;                               /* iteration odd or even             */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -2992,7 +3000,7 @@ int odd;                               /* iteration odd or even             */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -3026,9 +3034,9 @@ int odd;                               /* iteration odd or even             */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -3041,35 +3049,25 @@ int odd;                               /* iteration odd or even             */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -3105,23 +3103,36 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 int odd;                               /* iteration odd or even             */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_FLOOR,setl2_floor,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"floor",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 1;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 1;
 
    /* pick out the sign */
 
@@ -3138,8 +3149,8 @@ int odd;                               /* iteration odd or even             */
    if (!sign && exponent == -(1 << 7)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -3150,8 +3161,8 @@ int odd;                               /* iteration odd or even             */
    if (exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0 - sign;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0 - sign);
 
       return;
 
@@ -3162,7 +3173,7 @@ int odd;                               /* iteration odd or even             */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 6;
+   p = ((unsigned char *)&real_value) + 6;
    curr_byte = *p++;
    odd = YES;
    curr_bits_left = 8;
@@ -3302,12 +3313,11 @@ int odd;                               /* iteration odd or even             */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -3326,16 +3336,8 @@ int odd;                               /* iteration odd or even             */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -3368,7 +3370,7 @@ int odd;                               /* iteration odd or even             */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -3377,7 +3379,7 @@ int odd;                               /* iteration odd or even             */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -3411,9 +3413,9 @@ int odd;                               /* iteration odd or even             */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -3426,35 +3428,25 @@ int odd;                               /* iteration odd or even             */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -3493,22 +3485,35 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_CEIL,setl2_ceil,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"ceil",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 7;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 7;
 
    /* pick out the sign */
 
@@ -3525,8 +3530,8 @@ unsigned char *p;                      /* temporary looping variable        */
    if (!sign && exponent == -((1 << 10) - 2)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -3537,8 +3542,8 @@ unsigned char *p;                      /* temporary looping variable        */
    if (exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 1 - sign;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,1 - sign);
 
       return;
 
@@ -3549,7 +3554,7 @@ unsigned char *p;                      /* temporary looping variable        */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value));
+   p = ((unsigned char *)&real_value);
    curr_byte = *p++;
    curr_bits_left = 8;
    bits_left = 45;
@@ -3678,12 +3683,11 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -3702,16 +3706,8 @@ unsigned char *p;                      /* temporary looping variable        */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -3744,7 +3740,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -3753,7 +3749,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -3782,9 +3778,9 @@ unsigned char *p;                      /* temporary looping variable        */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -3797,35 +3793,25 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -3862,22 +3848,35 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_CEIL,setl2_ceil,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"ceil",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value));
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value);
 
    /* pick out the sign */
 
@@ -3894,8 +3893,8 @@ unsigned char *p;                      /* temporary looping variable        */
    if (!sign && exponent == -((1 << 10) - 2)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -3906,8 +3905,8 @@ unsigned char *p;                      /* temporary looping variable        */
    if (exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 1 - sign;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,1 - sign);
 
       return;
 
@@ -3918,7 +3917,7 @@ unsigned char *p;                      /* temporary looping variable        */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 7;
+   p = ((unsigned char *)&real_value) + 7;
    curr_byte = *p--;
    curr_bits_left = 8;
    bits_left = 45;
@@ -4047,12 +4046,11 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -4071,16 +4069,8 @@ unsigned char *p;                      /* temporary looping variable        */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -4113,7 +4103,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -4122,7 +4112,7 @@ unsigned char *p;                      /* temporary looping variable        */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -4151,9 +4141,9 @@ unsigned char *p;                      /* temporary looping variable        */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -4166,35 +4156,25 @@ unsigned char *p;                      /* temporary looping variable        */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -4231,23 +4211,36 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 int odd;                               /* iteration odd or even             */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_CEIL,setl2_ceil,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"ceil",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 1;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 1;
 
    /* pick out the sign */
 
@@ -4264,8 +4257,8 @@ int odd;                               /* iteration odd or even             */
    if (!sign && exponent == -(1 << 10)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -4276,8 +4269,8 @@ int odd;                               /* iteration odd or even             */
    if (exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 1 - sign;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,1 - sign);
 
       return;
 
@@ -4288,7 +4281,7 @@ int odd;                               /* iteration odd or even             */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 6;
+   p = ((unsigned char *)&real_value) + 6;
    curr_byte = *p++;
    odd = YES;
    curr_bits_left = 8;
@@ -4428,12 +4421,11 @@ int odd;                               /* iteration odd or even             */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -4452,16 +4444,8 @@ int odd;                               /* iteration odd or even             */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -4494,7 +4478,7 @@ int odd;                               /* iteration odd or even             */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -4503,7 +4487,7 @@ int odd;                               /* iteration odd or even             */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -4537,9 +4521,9 @@ int odd;                               /* iteration odd or even             */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -4552,35 +4536,25 @@ int odd;                               /* iteration odd or even             */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -4617,23 +4591,36 @@ int bits_to_get;                       /* bits to be extracted into a cell  */
 int shift_dist;                        /* temporary (shift distance)        */
 int32 carry;                           /* carry bit                         */
 integer_h_ptr_type integer_hdr;        /* header of created integer         */
-integer_c_ptr_type integer_cell;       /* cell in created integer           */
-int32 short_hi_bits;                   /* high order bits of short          */
+int32 cells[FIX_CELL_COUNT];           /* cells of created integer          */
+int32 *integer_cell;                   /* cell being built                  */
+int32 i;                               /* temporary looping variable        */
+double real_value;                     /* copy of real argument             */
 unsigned char *p;                      /* temporary looping variable        */
 int odd;                               /* iteration odd or even             */
 
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_CEIL,setl2_ceil,argv,target);
+
+      return;
+
+   }
+
    /* this function is only valid for reals */
 
-   if (argv[0].sp_form != ft_real) {
+   if (spec_form(&argv[0]) != ft_real) {
 
       abend(SETL_SYSTEM msg_bad_arg,"real",1,"ceil",
             abend_opnd_str(SETL_SYSTEM argv));
 
    }
 
-   /* set a character pointer to the start of the real value */
+   /* set a character pointer to a copy of the real value */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 1;
+   real_value = spec_val(&argv[0],sp_real_value);
+   p = ((unsigned char *)&real_value) + 1;
 
    /* pick out the sign */
 
@@ -4650,8 +4637,8 @@ int odd;                               /* iteration odd or even             */
    if (!sign && exponent == -(1 << 7)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 0;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
       return;
 
@@ -4662,8 +4649,8 @@ int odd;                               /* iteration odd or even             */
    if (exponent < 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = 1 - sign;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,1 - sign);
 
       return;
 
@@ -4674,7 +4661,7 @@ int odd;                               /* iteration odd or even             */
     *  there is a non-zero fraction though.
     */
 
-   p = ((unsigned char *)&(argv[0].sp_val.sp_real_ptr->r_value)) + 6;
+   p = ((unsigned char *)&real_value) + 6;
    curr_byte = *p++;
    odd = YES;
    curr_bits_left = 8;
@@ -4814,12 +4801,11 @@ int odd;                               /* iteration odd or even             */
 
       /* check whether the result remains short */
 
-      if (!(short_hi_bits = short_value & INT_HIGH_BITS) ||
-          short_hi_bits == INT_HIGH_BITS) {
+      if (is_short_value(short_value)) {
 
          unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_value;
+         spec_set_form(target,ft_short);
+         spec_set_val(target,sp_short_value,short_value);
 
          return;
 
@@ -4838,16 +4824,8 @@ int odd;                               /* iteration odd or even             */
     *  certain we must build a long integer.
     */
 
-   get_integer_header(integer_hdr);
-   integer_hdr->i_use_count = 1;
-   integer_hdr->i_hash_code = -1;
-   integer_hdr->i_cell_count = 1;
-   integer_hdr->i_is_negative = sign;
-
-   get_integer_cell(integer_cell)
-   integer_cell->i_next = integer_cell->i_prev = NULL;
-   integer_hdr->i_head = integer_hdr->i_tail = integer_cell;
-   integer_cell->i_cell_value = 0;
+   integer_cell = cells;
+   *integer_cell = 0;
 
    /* if we lost significance, abend */
 
@@ -4880,7 +4858,7 @@ int odd;                               /* iteration odd or even             */
 
          if (bits_to_get < curr_bits_left) {
 
-            integer_cell->i_cell_value |=
+            *integer_cell |=
                (curr_byte & ((1 << bits_to_get) - 1)) << shift_dist;
             curr_byte >>= bits_to_get;
             curr_bits_left -= bits_to_get;
@@ -4889,7 +4867,7 @@ int odd;                               /* iteration odd or even             */
 
          }
 
-         integer_cell->i_cell_value |= (curr_byte << shift_dist);
+         *integer_cell |= (curr_byte << shift_dist);
          shift_dist += curr_bits_left;
          bits_to_get -= curr_bits_left;
 
@@ -4923,9 +4901,9 @@ int odd;                               /* iteration odd or even             */
 
          /* add in the carry */
 
-         integer_cell->i_cell_value += carry;
-         carry = integer_cell->i_cell_value >> INT_CELL_WIDTH;
-         integer_cell->i_cell_value &= MAX_INT_CELL;
+         *integer_cell += carry;
+         carry = *integer_cell >> INT_CELL_WIDTH;
+         *integer_cell &= MAX_INT_CELL;
 
       }
 
@@ -4938,35 +4916,25 @@ int odd;                               /* iteration odd or even             */
 
       /* add another cell */
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = 0;
+      *++integer_cell = 0;
 
    }
 
    /* we may have a carry left */
 
-   if (carry) {
+   if (carry)
+      *++integer_cell = carry;
 
-      get_integer_cell(integer_cell);
-      (integer_hdr->i_tail)->i_next = integer_cell;
-      integer_cell->i_prev = integer_hdr->i_tail;
-      integer_cell->i_next = NULL;
-      integer_hdr->i_tail = integer_cell;
-      integer_hdr->i_cell_count++;
-      integer_cell->i_cell_value = carry;
+   /* build the integer from the cells */
 
-   }
+   integer_hdr = new_integer(SETL_SYSTEM 0);
+   integer_hdr->i_is_negative = sign;
+   for (i = 0; cells + i <= integer_cell; i++)
+      set_integer_cell(SETL_SYSTEM integer_hdr,i,cells[i]);
 
-   /* set the target and return */
+   /* set the target, as a short if it fits, and return */
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = integer_hdr;
+   normalize_long(SETL_SYSTEM target,integer_hdr);
 
    return;
 
@@ -4988,19 +4956,28 @@ void setl2_exp(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_EXP,setl2_exp,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5029,14 +5006,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5056,19 +5030,28 @@ void setl2_log(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_LOG,setl2_log,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5098,14 +5081,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5125,19 +5105,28 @@ void setl2_cos(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_COS,setl2_cos,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5167,14 +5156,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5194,19 +5180,28 @@ void setl2_sin(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_SIN,setl2_sin,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5236,14 +5231,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5263,19 +5255,28 @@ void setl2_tan(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_TAN,setl2_tan,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5304,14 +5305,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5331,19 +5329,28 @@ void setl2_acos(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_ACOS,setl2_acos,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5372,14 +5379,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5399,19 +5403,28 @@ void setl2_asin(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_ASIN,setl2_asin,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5440,14 +5453,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5467,19 +5477,28 @@ void setl2_atan(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_ATAN,setl2_atan,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5508,14 +5527,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5535,19 +5551,28 @@ void setl2_tanh(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_TANH,setl2_tanh,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5577,14 +5602,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5604,19 +5626,28 @@ void setl2_sqrt(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 double real_input;
 
-   if (argv[0].sp_form == ft_real) {
+   /* tuples are mapped element by element */
+
+   if (spec_form(&argv[0]) == ft_tuple) {
+
+      map_tuple(SETL_SYSTEM VEC_SQRT,setl2_sqrt,argv,target);
+
+      return;
+
+   }
+
+   if (spec_form(&argv[0]) == ft_real) {
    
-   		real_input = (argv[0].sp_val.sp_real_ptr)->r_value;
+   		real_input = spec_val(&argv[0],sp_real_value);
 
-   } else if (argv[0].sp_form == ft_short) {
+   } else if (spec_form(&argv[0]) == ft_short) {
    		
-   		real_input = (double)(argv[0].sp_val.sp_short_value);
+   		real_input = (double)(spec_val(&argv[0],sp_short_value));
    	
-   } else if (argv[0].sp_form == ft_long) {
+   } else if (spec_form(&argv[0]) == ft_long) {
    
    		real_input = (double) (long_to_double(SETL_SYSTEM argv));
    
@@ -5645,14 +5676,11 @@ double real_input;
 
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -5674,13 +5702,23 @@ void setl2_sign(
 {
 int32 short_value;                     /* short integer value               */
 
-   switch (argv[0].sp_form) {
+   /* tuples are mapped element by element */
 
-      case ft_short :
+   if (spec_form(&argv[0]) == ft_tuple) {
 
-         if (argv[0].sp_val.sp_short_value < 0)
+      map_tuple(SETL_SYSTEM VEC_SIGN,setl2_sign,argv,target);
+
+      return;
+
+   }
+
+   switch (spec_form(&argv[0])) {
+
+      case ft_short :
+
+         if (spec_val(&argv[0],sp_short_value) < 0)
             short_value = -1;
-         else if (argv[0].sp_val.sp_short_value > 0)
+         else if (spec_val(&argv[0],sp_short_value) > 0)
             short_value = 1;
          else
             short_value = 0;
@@ -5689,7 +5727,7 @@ int32 short_value;                     /* short integer value               */
 
       case ft_long :
 
-         if (argv[0].sp_val.sp_long_ptr->i_is_negative)
+         if (spec_val(&argv[0],sp_long_ptr)->i_is_negative)
             short_value = -1;
          else
             short_value = 1;
@@ -5698,9 +5736,9 @@ int32 short_value;                     /* short integer value               */
 
       case ft_real :
 
-         if ((argv[0].sp_val.sp_real_ptr)->r_value < 0)
+         if (spec_val(&argv[0],sp_real_value) < 0)
             short_value = -1;
-         else if ((argv[0].sp_val.sp_real_ptr)->r_value > 0)
+         else if (spec_val(&argv[0],sp_real_value) > 0)
             short_value = 1;
          else
             short_value = 0;
@@ -5717,10 +5755,1065 @@ int32 short_value;                     /* short integer value               */
    /* set the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value = short_value;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,short_value);
+
+   return;
+
+}
+
+/*\
+ *  \function{map\_tuple()}
+ *
+ *  This function applies one of the math functions to each element of a
+ *  tuple, giving a tuple of the results.  Omega elements stay omega.
+ *  Packed tuples go through \verb"map_packed()" if they can.  Otherwise
+ *  we call the scalar function on each element, so nested tuples are
+ *  mapped too and any error is the one the scalar function reports.
+\*/
+
+static void map_tuple(
+   SETL_SYSTEM_PROTO
+   int op,                             /* packed operation code             */
+   void (*func_ptr)(SETL_SYSTEM_PROTO int, specifier *, specifier *),
+                                       /* scalar function                   */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
+
+{
+tuple_h_ptr_type source_root;          /* tuple being mapped                */
+tuple_h_ptr_type target_root;          /* tuple of results                  */
+tuple_c_ptr_type target_cell;          /* result cell                       */
+specifier element;                     /* element of a packed tuple         */
+specifier *element_ptr;                /* element being mapped              */
+int32 i;                               /* temporary looping variable        */
+
+   source_root = spec_val(&argv[0],sp_tuple_ptr);
+
+   target_root = NULL;
+   if (is_packed(source_root))
+      target_root = map_packed(SETL_SYSTEM op,source_root);
+
+   if (target_root == NULL) {
+
+      target_root = new_tuple(SETL_SYSTEM_VOID);
+      reserve_tuple(target_root,source_root->t_length);
+
+      for (i = 0; i < source_root->t_length; i++) {
+
+         if (is_packed(source_root)) {
+            get_packed_element(source_root,i,&element);
+            element_ptr = &element;
+         }
+         else {
+            element_ptr = &(tuple_cell_at(source_root,i)->t_spec);
+         }
+
+         target_cell = target_root->t_cells + i;
+         spec_set_form(&target_cell->t_spec,ft_omega);
+         target_cell->t_hash_code = 0;
+         target_root->t_length = i + 1;
+
+         if (spec_form(element_ptr) == ft_omega)
+            continue;
+
+         (*func_ptr)(SETL_SYSTEM 1,element_ptr,&target_cell->t_spec);
+
+         spec_hash_code(target_cell->t_hash_code,&target_cell->t_spec);
+         target_root->t_hash_code ^= target_cell->t_hash_code;
+
+      }
+
+      pack_tuple(SETL_SYSTEM target_root);
+
+   }
+
+   /* set the target */
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,target_root);
+
+   return;
+
+}
+
+/*\
+ *  \function{map\_packed()}
+ *
+ *  This function applies a math function to a packed tuple, working on
+ *  the bare arrays of numbers.  The loops are kept simple so that the
+ *  compiler can vectorize the ones it knows how to, and we check the
+ *  whole result for floating point errors at the end.  We return NULL,
+ *  having built nothing, when we would rather the scalar function dealt
+ *  with each element, which is when the function rejects the argument
+ *  form or a result will not fit in a short integer.
+\*/
+
+static tuple_h_ptr_type map_packed(
+   SETL_SYSTEM_PROTO
+   int op,                             /* packed operation code             */
+   tuple_h_ptr_type source_root)       /* tuple being mapped                */
+
+{
+tuple_h_ptr_type target_root;          /* tuple of results                  */
+int packing;                           /* form of the results               */
+int32 length;                          /* number of elements                */
+int32 *source_shorts;                  /* packed short source               */
+double *source_reals;                  /* packed real source                */
+int32 *target_shorts;                  /* packed short result               */
+double *target_reals;                  /* packed real result                */
+double real_number;                    /* real value                        */
+int32 i;                               /* temporary looping variable        */
+
+   /* find the form of the result */
+
+   switch (op) {
+
+      case VEC_ABS :
+
+         packing = source_root->t_packing;
+         break;
+
+      case VEC_SIGN :
+
+         packing = TUP_SHORTS;
+         break;
+
+      case VEC_FLOAT :
+
+         if (source_root->t_packing != TUP_SHORTS)
+            return NULL;
+         packing = TUP_REALS;
+         break;
+
+      case VEC_FIX :
+      case VEC_FLOOR :
+      case VEC_CEIL :
+
+         if (source_root->t_packing != TUP_REALS)
+            return NULL;
+         packing = TUP_SHORTS;
+         break;
+
+      default :
+
+         packing = TUP_REALS;
+         break;
+
+   }
+
+   length = source_root->t_length;
+   source_shorts = source_root->t_packed.t_shorts;
+   source_reals = source_root->t_packed.t_reals;
+
+   target_root = new_tuple(SETL_SYSTEM_VOID);
+   start_packed(SETL_SYSTEM target_root,packing,length);
+   target_root->t_length = length;
+
+   /*
+    *  Real results start as a copy of the source, converted if need be,
+    *  and each function is a loop over that copy.
+    */
+
+   if (packing == TUP_REALS) {
+
+      target_reals = target_root->t_packed.t_reals;
+
+      if (source_root->t_packing == TUP_SHORTS) {
+         for (i = 0; i < length; i++)
+            target_reals[i] = (double)source_shorts[i];
+      }
+      else {
+         memcpy((void *)target_reals,(void *)source_reals,
+                (size_t)length * sizeof(double));
+      }
+
+#if !INFNAN
+
+      errno = 0;
+
+#endif
+
+      switch (op) {
+
+         case VEC_ABS :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = fabs(target_reals[i]);
+            break;
+
+         case VEC_EXP :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = exp(target_reals[i]);
+            break;
+
+         case VEC_LOG :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = log(target_reals[i]);
+            break;
+
+         case VEC_COS :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = cos(target_reals[i]);
+            break;
+
+         case VEC_SIN :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = sin(target_reals[i]);
+            break;
+
+         case VEC_TAN :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = tan(target_reals[i]);
+            break;
+
+         case VEC_ACOS :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = acos(target_reals[i]);
+            break;
+
+         case VEC_ASIN :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = asin(target_reals[i]);
+            break;
+
+         case VEC_ATAN :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = atan(target_reals[i]);
+            break;
+
+         case VEC_TANH :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = tanh(target_reals[i]);
+            break;
+
+         case VEC_SQRT :
+
+            for (i = 0; i < length; i++)
+               target_reals[i] = sqrt(target_reals[i]);
+            break;
+
+      }
+
+      /* check for floating point errors */
+
+#if INFNAN
+
+      for (i = 0; i < length; i++) {
+         real_number = target_reals[i];
+         if (NANorINF(real_number))
+            break;
+      }
+
+      if (i < length) {
+         free_tuple(SETL_SYSTEM target_root);
+         abend(SETL_SYSTEM "Floating point error -- Not a number");
+      }
+
+#else
+
+      if (errno == EDOM || errno == ERANGE)
+         free_tuple(SETL_SYSTEM target_root);
+      if (errno == EDOM)
+         abend(SETL_SYSTEM msg_domain_error);
+      if (errno == ERANGE)
+         abend(SETL_SYSTEM msg_range_error);
+
+#endif
+
+   }
+
+   /*
+    *  Short results come from absolute values or signs, or from rounding
+    *  reals.  If a rounded real is too big for a short we give up.
+    */
+
+   else {
+
+      target_shorts = target_root->t_packed.t_shorts;
+
+      switch (op) {
+
+         case VEC_ABS :
+
+            for (i = 0; i < length; i++)
+               target_shorts[i] = labs(source_shorts[i]);
+            break;
+
+         case VEC_SIGN :
+
+            if (source_root->t_packing == TUP_SHORTS) {
+               for (i = 0; i < length; i++)
+                  target_shorts[i] = (source_shorts[i] > 0) -
+                                     (source_shorts[i] < 0);
+            }
+            else {
+               for (i = 0; i < length; i++)
+                  target_shorts[i] = (source_reals[i] > 0.0) -
+                                     (source_reals[i] < 0.0);
+            }
+            break;
+
+         default :
+
+            for (i = 0; i < length; i++) {
+
+               real_number = source_reals[i];
+               if (op == VEC_FLOOR ||
+                   (op == VEC_FIX && real_number >= 0.0))
+                  real_number = floor(real_number);
+               else
+                  real_number = ceil(real_number);
+
+               if (!(real_number > -PACKED_FIX_LIMIT &&
+                     real_number < PACKED_FIX_LIMIT) ||
+                   !is_short_value((int32)real_number))
+                  break;
+
+               target_shorts[i] = (int32)real_number;
+
+            }
+
+            if (i < length) {
+               free_tuple(SETL_SYSTEM target_root);
+               return NULL;
+            }
+
+            break;
+
+      }
+   }
+
+   for (i = 0; i < length; i++)
+      target_root->t_hash_code ^= packed_hash_code(target_root,i);
+
+   return target_root;
+
+}
+
+/*\
+ *  \function{number\_value()}
+ *
+ *  This function converts any number to a real, for the reductions.
+ *  The caller makes sure it is given a number.
+\*/
+
+static double number_value(
+   SETL_SYSTEM_PROTO
+   specifier *spec)                    /* number to convert                 */
+
+{
+
+   if (spec_form(spec) == ft_short)
+      return (double)spec_val(spec,sp_short_value);
+   if (spec_form(spec) == ft_long)
+      return long_to_double(SETL_SYSTEM spec);
+
+   return spec_val(spec,sp_real_value);
+
+}
+
+/*\
+ *  \function{set\_total()}
+ *
+ *  This function finishes a sum or product, which we keep as an integer
+ *  part and a real part.  If there were no reals the integer part is the
+ *  result.  Otherwise the result is real, and we check it as the real
+ *  operators do.
+\*/
+
+static void set_total(
+   SETL_SYSTEM_PROTO
+   int op,                             /* reduction code                    */
+   specifier *int_total,               /* integer part                      */
+   double real_total,                  /* real part                         */
+   int saw_real,                       /* YES if there were reals           */
+   specifier *target)                  /* return value                      */
+
+{
+double real_number;                    /* real result                       */
+
+   if (!saw_real) {
+
+      unmark_specifier(target);
+      spec_set_form(target,spec_form(int_total));
+      spec_set_val(target,sp_biggest,spec_val(int_total,sp_biggest));
+
+      return;
+
+   }
+
+   if (op == RED_PRODUCT)
+      real_number = real_total * number_value(SETL_SYSTEM int_total);
+   else
+      real_number = real_total + number_value(SETL_SYSTEM int_total);
+   unmark_specifier(int_total);
+
+#if INFNAN
+
+   if (NANorINF(real_number))
+      abend(SETL_SYSTEM "Floating point error -- Not a number");
+
+#endif
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
 }
 
+/*\
+ *  \function{packed\_total()}
+ *
+ *  This function finds the sum or product of a packed tuple.  Reals go
+ *  through four running totals, which lets the compiler use vector
+ *  instructions, but means the rounding is not quite that of adding the
+ *  elements left to right.  Short integers must be exact, so there we
+ *  check each step, and return NO on overflow to let the caller start
+ *  again with long integers.
+\*/
+
+static int packed_total(
+   SETL_SYSTEM_PROTO
+   int op,                             /* reduction code                    */
+   tuple_h_ptr_type source_root,       /* packed tuple                      */
+   specifier *target)                  /* return value                      */
+
+{
+int32 length;                          /* number of elements                */
+int32 *shorts;                         /* packed short integers             */
+double *reals;                         /* packed reals                      */
+double total[4];                       /* running real totals               */
+int32 short_total;                     /* running short total               */
+specifier int_total;                   /* short total as a specifier        */
+int32 i;                               /* temporary looping variable        */
+
+   length = source_root->t_length;
+
+   if (source_root->t_packing == TUP_REALS) {
+
+      reals = source_root->t_packed.t_reals;
+
+      if (op == RED_PRODUCT) {
+
+         total[0] = total[1] = total[2] = total[3] = 1.0;
+         for (i = 0; i + 4 <= length; i += 4) {
+            total[0] *= reals[i];
+            total[1] *= reals[i + 1];
+            total[2] *= reals[i + 2];
+            total[3] *= reals[i + 3];
+         }
+         for (; i < length; i++)
+            total[0] *= reals[i];
+         total[0] = (total[0] * total[1]) * (total[2] * total[3]);
+
+      }
+      else {
+
+         total[0] = total[1] = total[2] = total[3] = 0.0;
+         for (i = 0; i + 4 <= length; i += 4) {
+            total[0] += reals[i];
+            total[1] += reals[i + 1];
+            total[2] += reals[i + 2];
+            total[3] += reals[i + 3];
+         }
+         for (; i < length; i++)
+            total[0] += reals[i];
+         total[0] = (total[0] + total[1]) + (total[2] + total[3]);
+
+      }
+
+      spec_set_form(&int_total,ft_short);
+      spec_set_val(&int_total,sp_short_value,(op == RED_PRODUCT));
+      set_total(SETL_SYSTEM op,&int_total,total[0],YES,target);
+
+      return YES;
+
+   }
+
+   shorts = source_root->t_packed.t_shorts;
+   short_total = (op == RED_PRODUCT);
+
+   for (i = 0; i < length; i++) {
+
+      if (op == RED_PRODUCT) {
+         if (!short_multiply(short_total,short_total,shorts[i]))
+            return NO;
+      }
+      else {
+         if (!short_add(short_total,short_total,shorts[i]))
+            return NO;
+      }
+   }
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,short_total);
+
+   return YES;
+
+}
+
+/*\
+ *  \function{total\_tuple()}
+ *
+ *  This function is the body of \verb"tuple_sum" and
+ *  \verb"tuple_product".  Omega elements are skipped, as the reduction
+ *  operators skip them.  Integers are combined exactly, reals as reals,
+ *  and a tuple with any reals in it gives a real.
+\*/
+
+static void total_tuple(
+   SETL_SYSTEM_PROTO
+   int op,                             /* reduction code                    */
+   char *name,                         /* built-in name, for errors         */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
+
+{
+tuple_h_ptr_type source_root;          /* tuple being reduced               */
+specifier element;                     /* element of a packed tuple         */
+specifier *element_ptr;                /* element being added               */
+specifier int_total;                   /* integer part of the total         */
+double real_total;                     /* real part of the total            */
+int saw_real;                          /* YES if there were reals           */
+int32 i;                               /* temporary looping variable        */
+
+   if (spec_form(&argv[0]) != ft_tuple) {
+
+      abend(SETL_SYSTEM msg_bad_arg,"tuple",1,name,
+            abend_opnd_str(SETL_SYSTEM argv));
+
+   }
+
+   source_root = spec_val(&argv[0],sp_tuple_ptr);
+
+   if (is_packed(source_root) &&
+       packed_total(SETL_SYSTEM op,source_root,target))
+      return;
+
+   spec_set_form(&int_total,ft_short);
+   spec_set_val(&int_total,sp_short_value,(op == RED_PRODUCT));
+   real_total = (op == RED_PRODUCT ? 1.0 : 0.0);
+   saw_real = NO;
+
+   for (i = 0; i < source_root->t_length; i++) {
+
+      if (is_packed(source_root)) {
+         get_packed_element(source_root,i,&element);
+         element_ptr = &element;
+      }
+      else {
+         element_ptr = &(tuple_cell_at(source_root,i)->t_spec);
+      }
+
+      switch (spec_form(element_ptr)) {
+
+         case ft_omega :
+
+            break;
+
+         case ft_short :
+         case ft_long :
+
+            if (op == RED_PRODUCT)
+               integer_multiply(SETL_SYSTEM &int_total,&int_total,
+                                element_ptr);
+            else
+               integer_add(SETL_SYSTEM &int_total,&int_total,element_ptr);
+
+            break;
+
+         case ft_real :
+
+            if (op == RED_PRODUCT)
+               real_total *= spec_val(element_ptr,sp_real_value);
+            else
+               real_total += spec_val(element_ptr,sp_real_value);
+            saw_real = YES;
+
+            break;
+
+         default :
+
+            unmark_specifier(&int_total);
+            abend(SETL_SYSTEM msg_bad_arg,"tuple of numbers",1,name,
+                  abend_opnd_str(SETL_SYSTEM argv));
+
+      }
+   }
+
+   set_total(SETL_SYSTEM op,&int_total,real_total,saw_real,target);
+
+   return;
+
+}
+
+/*\
+ *  \function{setl2\_tuple\_sum()}
+ *
+ *  This function is the \verb"tuple_sum" built-in function, which adds
+ *  up the numbers in a tuple.  The sum of an empty tuple is zero.
+\*/
+
+void setl2_tuple_sum(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
+
+{
+
+   total_tuple(SETL_SYSTEM RED_SUM,"tuple_sum",argv,target);
+
+   return;
+
+}
+
+/*\
+ *  \function{setl2\_tuple\_product()}
+ *
+ *  This function is the \verb"tuple_product" built-in function, which
+ *  multiplies together the numbers in a tuple.  The product of an empty
+ *  tuple is one.
+\*/
+
+void setl2_tuple_product(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
+
+{
+
+   total_tuple(SETL_SYSTEM RED_PRODUCT,"tuple_product",argv,target);
+
+   return;
+
+}
+
+/*\
+ *  \function{extreme\_tuple()}
+ *
+ *  This function is the body of \verb"tuple_min" and \verb"tuple_max".
+ *  We return the extreme element itself, so the form of the result is
+ *  that of the element.  Integers are compared exactly; an integer and
+ *  a real are compared as reals.  An empty tuple gives omega.
+\*/
+
+static void extreme_tuple(
+   SETL_SYSTEM_PROTO
+   int op,                             /* reduction code                    */
+   char *name,                         /* built-in name, for errors         */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
+
+{
+tuple_h_ptr_type source_root;          /* tuple being reduced               */
+specifier *element_ptr;                /* element being compared            */
+specifier *best_ptr;                   /* extreme element so far            */
+int32 length;                          /* number of elements                */
+int32 *shorts;                         /* packed short integers             */
+double *reals;                         /* packed reals                      */
+int32 short_value;                     /* extreme short                     */
+double real_number;                    /* extreme real                      */
+int less;                              /* YES if element < best             */
+int32 i;                               /* temporary looping variable        */
+
+   if (spec_form(&argv[0]) != ft_tuple) {
+
+      abend(SETL_SYSTEM msg_bad_arg,"tuple",1,name,
+            abend_opnd_str(SETL_SYSTEM argv));
+
+   }
+
+   source_root = spec_val(&argv[0],sp_tuple_ptr);
+   length = source_root->t_length;
+
+   /* packed tuples are a simple loop */
+
+   if (source_root->t_packing == TUP_SHORTS && length > 0) {
+
+      shorts = source_root->t_packed.t_shorts;
+      short_value = shorts[0];
+
+      if (op == RED_MIN) {
+         for (i = 1; i < length; i++)
+            short_value = (shorts[i] < short_value ? shorts[i] : short_value);
+      }
+      else {
+         for (i = 1; i < length; i++)
+            short_value = (shorts[i] > short_value ? shorts[i] : short_value);
+      }
+
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,short_value);
+
+      return;
+
+   }
+
+   if (source_root->t_packing == TUP_REALS && length > 0) {
+
+      reals = source_root->t_packed.t_reals;
+      real_number = reals[0];
+
+      if (op == RED_MIN) {
+         for (i = 1; i < length; i++)
+            real_number = (reals[i] < real_number ? reals[i] : real_number);
+      }
+      else {
+         for (i = 1; i < length; i++)
+            real_number = (reals[i] > real_number ? reals[i] : real_number);
+      }
+
+      unmark_specifier(target);
+      spec_set_form(target,ft_real);
+      spec_set_val(target,sp_real_value,real_number);
+
+      return;
+
+   }
+
+   /* otherwise we compare elements one at a time */
+
+   unpack_tuple(source_root);
+   best_ptr = NULL;
+   for (i = 0; i < length; i++) {
+
+      element_ptr = &(source_root->t_cells[i].t_spec);
+
+      if (spec_form(element_ptr) == ft_omega)
+         continue;
+
+      if (spec_form(element_ptr) != ft_short &&
+          spec_form(element_ptr) != ft_long &&
+          spec_form(element_ptr) != ft_real) {
+
+         abend(SETL_SYSTEM msg_bad_arg,"tuple of numbers",1,name,
+               abend_opnd_str(SETL_SYSTEM argv));
+
+      }
+
+      if (best_ptr == NULL) {
+         best_ptr = element_ptr;
+         continue;
+      }
+
+      if (spec_form(element_ptr) != ft_real &&
+          spec_form(best_ptr) != ft_real) {
+
+         if (op == RED_MIN)
+            less = integer_lt(SETL_SYSTEM element_ptr,best_ptr);
+         else
+            less = integer_lt(SETL_SYSTEM best_ptr,element_ptr);
+
+      }
+      else {
+
+         if (op == RED_MIN)
+            less = number_value(SETL_SYSTEM element_ptr) <
+                   number_value(SETL_SYSTEM best_ptr);
+         else
+            less = number_value(SETL_SYSTEM best_ptr) <
+                   number_value(SETL_SYSTEM element_ptr);
+
+      }
+
+      if (less)
+         best_ptr = element_ptr;
+
+   }
+
+   /* set the target, which is omega if there were no numbers */
+
+   if (best_ptr == NULL) {
+
+      unmark_specifier(target);
+      spec_set_form(target,ft_omega);
+
+      return;
+
+   }
+
+   mark_specifier(best_ptr);
+   unmark_specifier(target);
+   spec_set_form(target,spec_form(best_ptr));
+   spec_set_val(target,sp_biggest,spec_val(best_ptr,sp_biggest));
+
+   return;
+
+}
+
+/*\
+ *  \function{setl2\_tuple\_min()}
+ *
+ *  This function is the \verb"tuple_min" built-in function, which finds
+ *  the smallest number in a tuple.
+\*/
+
+void setl2_tuple_min(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
+
+{
+
+   extreme_tuple(SETL_SYSTEM RED_MIN,"tuple_min",argv,target);
+
+   return;
+
+}
+
+/*\
+ *  \function{setl2\_tuple\_max()}
+ *
+ *  This function is the \verb"tuple_max" built-in function, which finds
+ *  the largest number in a tuple.
+\*/
+
+void setl2_tuple_max(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
+
+{
+
+   extreme_tuple(SETL_SYSTEM RED_MAX,"tuple_max",argv,target);
+
+   return;
+
+}
+
+/*\
+ *  \function{packed\_dot()}
+ *
+ *  This function finds the dot product of two packed tuples of the same
+ *  length.  As with sums, reals use four running totals and short
+ *  integers are checked at each step, returning NO on overflow.
+\*/
+
+static int packed_dot(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type left_root,         /* left tuple                        */
+   tuple_h_ptr_type right_root,        /* right tuple                       */
+   specifier *target)                  /* return value                      */
+
+{
+int32 length;                          /* number of elements                */
+int32 *left_shorts, *right_shorts;     /* packed short integers             */
+double *left_reals, *right_reals;      /* packed reals                      */
+double total[4];                       /* running real totals               */
+int32 short_total;                     /* running short total               */
+int32 short_value;                     /* product of two shorts             */
+specifier int_total;                   /* zero, as a specifier              */
+int32 i;                               /* temporary looping variable        */
+
+   length = left_root->t_length;
+   left_shorts = left_root->t_packed.t_shorts;
+   left_reals = left_root->t_packed.t_reals;
+   right_shorts = right_root->t_packed.t_shorts;
+   right_reals = right_root->t_packed.t_reals;
+
+   /* two tuples of shorts give an exact integer */
+
+   if (left_root->t_packing == TUP_SHORTS &&
+       right_root->t_packing == TUP_SHORTS) {
+
+      short_total = 0;
+      for (i = 0; i < length; i++) {
+
+         if (!short_multiply(short_value,left_shorts[i],right_shorts[i]) ||
+             !short_add(short_total,short_total,short_value))
+            return NO;
+
+      }
+
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,short_total);
+
+      return YES;
+
+   }
+
+   /* anything else is real */
+
+   total[0] = total[1] = total[2] = total[3] = 0.0;
+
+   if (left_root->t_packing == TUP_REALS &&
+       right_root->t_packing == TUP_REALS) {
+
+      for (i = 0; i + 4 <= length; i += 4) {
+         total[0] += left_reals[i] * right_reals[i];
+         total[1] += left_reals[i + 1] * right_reals[i + 1];
+         total[2] += left_reals[i + 2] * right_reals[i + 2];
+         total[3] += left_reals[i + 3] * right_reals[i + 3];
+      }
+      for (; i < length; i++)
+         total[0] += left_reals[i] * right_reals[i];
+
+   }
+   else {
+
+      /* one of each, so make the reals the right */
+
+      if (left_root->t_packing == TUP_REALS) {
+         left_shorts = right_shorts;
+         right_reals = left_reals;
+      }
+
+      for (i = 0; i + 4 <= length; i += 4) {
+         total[0] += (double)left_shorts[i] * right_reals[i];
+         total[1] += (double)left_shorts[i + 1] * right_reals[i + 1];
+         total[2] += (double)left_shorts[i + 2] * right_reals[i + 2];
+         total[3] += (double)left_shorts[i + 3] * right_reals[i + 3];
+      }
+      for (; i < length; i++)
+         total[0] += (double)left_shorts[i] * right_reals[i];
+
+   }
+
+   spec_set_form(&int_total,ft_short);
+   spec_set_val(&int_total,sp_short_value,0);
+   set_total(SETL_SYSTEM RED_SUM,&int_total,
+             (total[0] + total[1]) + (total[2] + total[3]),YES,target);
+
+   return YES;
+
+}
+
+/*\
+ *  \function{setl2\_tuple\_dot()}
+ *
+ *  This function is the \verb"tuple_dot" built-in function, which finds
+ *  the dot product of two tuples of numbers.  The tuples must be the
+ *  same length, and unlike the sum omega elements are errors, since
+ *  skipping one would pair up the wrong elements.  Products of integers
+ *  are exact, and any real makes the result real.
+\*/
+
+void setl2_tuple_dot(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (only 2 here)     */
+   specifier *target)                  /* return value                      */
+
+{
+tuple_h_ptr_type left_root;            /* left tuple                        */
+tuple_h_ptr_type right_root;           /* right tuple                       */
+specifier left_element;                /* element of a packed tuple         */
+specifier right_element;               /* element of a packed tuple         */
+specifier *left_ptr, *right_ptr;       /* elements being multiplied         */
+specifier int_total;                   /* integer part of the total         */
+specifier product;                     /* product of two integers           */
+double real_total;                     /* real part of the total            */
+int saw_real;                          /* YES if there were reals           */
+int arg;                               /* argument number, for errors       */
+int32 i;                               /* temporary looping variable        */
+
+   for (arg = 0; arg < 2; arg++) {
+
+      if (spec_form(&argv[arg]) != ft_tuple) {
+
+         abend(SETL_SYSTEM msg_bad_arg,"tuple",arg + 1,"tuple_dot",
+               abend_opnd_str(SETL_SYSTEM argv + arg));
+
+      }
+   }
+
+   left_root = spec_val(&argv[0],sp_tuple_ptr);
+   right_root = spec_val(&argv[1],sp_tuple_ptr);
+
+   if (left_root->t_length != right_root->t_length) {
+
+      abend(SETL_SYSTEM msg_bad_arg,"tuple of the same length",2,
+            "tuple_dot",abend_opnd_str(SETL_SYSTEM argv + 1));
+
+   }
+
+   if (is_packed(left_root) &&
+       is_packed(right_root) &&
+       packed_dot(SETL_SYSTEM left_root,right_root,target))
+      return;
+
+   spec_set_form(&int_total,ft_short);
+   spec_set_val(&int_total,sp_short_value,0);
+   spec_set_form(&product,ft_omega);
+   real_total = 0.0;
+   saw_real = NO;
+
+   for (i = 0; i < left_root->t_length; i++) {
+
+      if (is_packed(left_root)) {
+         get_packed_element(left_root,i,&left_element);
+         left_ptr = &left_element;
+      }
+      else {
+         left_ptr = &(tuple_cell_at(left_root,i)->t_spec);
+      }
+
+      if (is_packed(right_root)) {
+         get_packed_element(right_root,i,&right_element);
+         right_ptr = &right_element;
+      }
+      else {
+         right_ptr = &(tuple_cell_at(right_root,i)->t_spec);
+      }
+
+      for (arg = 0; arg < 2; arg++) {
+
+         switch (spec_form(arg == 0 ? left_ptr : right_ptr)) {
+
+            case ft_short :
+            case ft_long :
+            case ft_real :
+
+               break;
+
+            default :
+
+               unmark_specifier(&int_total);
+               unmark_specifier(&product);
+               abend(SETL_SYSTEM msg_bad_arg,"tuple of numbers",arg + 1,
+                     "tuple_dot",abend_opnd_str(SETL_SYSTEM argv + arg));
+
+         }
+      }
+
+      if (spec_form(left_ptr) == ft_real || spec_form(right_ptr) == ft_real) {
+
+         real_total += number_value(SETL_SYSTEM left_ptr) *
+                       number_value(SETL_SYSTEM right_ptr);
+         saw_real = YES;
+
+      }
+      else {
+
+         integer_multiply(SETL_SYSTEM &product,left_ptr,right_ptr);
+         integer_add(SETL_SYSTEM &int_total,&int_total,&product);
+
+      }
+   }
+
+   unmark_specifier(&product);
+   set_total(SETL_SYSTEM RED_SUM,&int_total,real_total,saw_real,target);
+
+   return;
+
+}
@@ -60,8 +60,8 @@ void setl2_newat(
 static int32 atom_number = 0;          /* next atom to be allocated         */
 
    unmark_specifier(target);
-   target->sp_form = ft_atom;
-   target->sp_val.sp_atom_num = atom_number++;
+   spec_set_form(target,ft_atom);
+   spec_set_val(target,sp_atom_num,atom_number++);
 
    return;
 
@@ -84,7 +84,7 @@ void setl2_date(
 time_t bintime;                        /* time in seconds                   */
 struct tm *localt;                      /* local time                        */
 string_h_ptr_type string_hdr;          /* string header pointer             */
-string_c_ptr_type string_cell;         /* string cell pointer               */
+char buffer[32];                       /* formatted date                    */
 char *p;                               /* temporary looping variable        */
 
    /* get the time from the operating system */
@@ -93,31 +93,25 @@ char *p;                               /* temporary looping variable        */
 
    /* create a character string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   get_string_cell(string_cell);
-   string_cell->s_next = string_cell->s_prev = NULL;
-   string_hdr->s_head = string_hdr->s_tail = string_cell;
    localt = localtime(&bintime);
-   sprintf(string_cell->s_cell_value,
+   sprintf(buffer,
            "%2d/%2d/%2d",
            localt->tm_mon + 1,
            localt->tm_mday,
            localt->tm_year);
 
-   for (p = string_cell->s_cell_value; *p; p++) {
+   for (p = buffer; *p; p++) {
       if (*p == ' ')
          *p = '0';
    }
 
-   string_hdr->s_length = strlen(string_cell->s_cell_value);
+   string_hdr = new_string(SETL_SYSTEM buffer);
 
    /* set the target and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -140,7 +134,7 @@ void setl2_time(
 time_t bintime;                        /* time in seconds                   */
 struct tm *localt;                      /* local time                        */
 string_h_ptr_type string_hdr;          /* string header pointer             */
-string_c_ptr_type string_cell;         /* string cell pointer               */
+char buffer[32];                       /* formatted time                    */
 char *p;                               /* temporary looping variable        */
 
    /* get the time from the operating system */
@@ -149,31 +143,25 @@ char *p;                               /* temporary looping variable        */
 
    /* create a character string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   get_string_cell(string_cell);
-   string_cell->s_next = string_cell->s_prev = NULL;
-   string_hdr->s_head = string_hdr->s_tail = string_cell;
    localt = localtime(&bintime);
-   sprintf(string_cell->s_cell_value,
+   sprintf(buffer,
            "%2d:%2d:%2d",
            localt->tm_hour,
            localt->tm_min,
            localt->tm_sec);
 
-   for (p = string_cell->s_cell_value; *p; p++) {
+   for (p = buffer; *p; p++) {
       if (*p == ' ')
          *p = '0';
    }
 
-   string_hdr->s_length = strlen(string_cell->s_cell_value);
+   string_hdr = new_string(SETL_SYSTEM buffer);
 
    /* set the target and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
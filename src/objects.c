@@ -54,106 +54,6 @@
 #include "process.h"                   /* objects                           */
 #include "mailbox.h"                   /* objects                           */
 
-/* performance tuning constants */
-
-#define OBJECT_HEADER_BLOCK_SIZE 100   /* object header block size          */
-#define OBJECT_CELL_BLOCK_SIZE  400    /* object cell block size            */
-#define SELF_STACK_BLOCK_SIZE   50     /* self block size                   */
-
-/*\
- *  \function{alloc\_object\_headers()}
- *
- *  This function allocates a block of object headers and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste header items to pointers to header items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the header node.
- *  It will work provided a header item is larger than a pointer, which
- *  is the case.
-\*/
-
-void alloc_object_headers(
-SETL_SYSTEM_PROTO_VOID)
-
-{
-object_h_ptr_type new_block;           /* first header in allocated block   */
-
-   /* allocate a new block */
-
-   new_block = (object_h_ptr_type)malloc((size_t)
-         (OBJECT_HEADER_BLOCK_SIZE * sizeof(struct object_h_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (OBJECT_H_NEXT_FREE = new_block;
-        OBJECT_H_NEXT_FREE < new_block + OBJECT_HEADER_BLOCK_SIZE - 1;
-        OBJECT_H_NEXT_FREE++) {
-
-      *((object_h_ptr_type *)OBJECT_H_NEXT_FREE) = OBJECT_H_NEXT_FREE + 1;
-
-   }
-
-   *((object_h_ptr_type *)OBJECT_H_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   OBJECT_H_NEXT_FREE = new_block;
-
-   return;
-
-}
-
-/*\
- *  \function{alloc\_object\_cells()}
- *
- *  This function allocates a block of object cells and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste cell items to pointers to cell items in order to form the free
- *  list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently, while
- *  at the same time avoiding an extra pointer on the cell node.  It
- *  will work provided a cell item is larger than a pointer, which is
- *  the case.
-\*/
-
-void alloc_object_cells(
-   SETL_SYSTEM_PROTO_VOID)
-
-{
-object_c_ptr_type new_block;           /* first cell in allocated block     */
-
-   /* allocate a new block */
-
-   new_block = (object_c_ptr_type)malloc((size_t)
-         (OBJECT_CELL_BLOCK_SIZE * sizeof(struct object_c_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (OBJECT_C_NEXT_FREE = new_block;
-        OBJECT_C_NEXT_FREE < new_block + OBJECT_CELL_BLOCK_SIZE - 1;
-        OBJECT_C_NEXT_FREE++) {
-
-      *((object_c_ptr_type *)OBJECT_C_NEXT_FREE) = OBJECT_C_NEXT_FREE + 1;
-
-   }
-
-   *((object_c_ptr_type *)OBJECT_C_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   OBJECT_C_NEXT_FREE = new_block;
-
-   return;
-
-}
-
 /*\
  *  \function{free\_object()}
  *
@@ -311,9 +211,10 @@ int i;                                 /* temporary looping variable        */
             if (source_cell != NULL) {
 
                get_object_cell(target_cell);
-               target_cell->o_spec.sp_form = source_cell->o_spec.sp_form;
-               target_cell->o_spec.sp_val.sp_biggest =
-                     source_cell->o_spec.sp_val.sp_biggest;
+               spec_set_form(&target_cell->o_spec,
+                             spec_form(&source_cell->o_spec));
+               spec_set_val(&target_cell->o_spec,sp_biggest,
+                     spec_val(&source_cell->o_spec,sp_biggest));
                target_cell->o_hash_code = source_cell->o_hash_code;
                mark_specifier(&(target_cell->o_spec));
                target_work_hdr->o_child[source_index].o_cell = target_cell;
@@ -381,51 +282,3 @@ int i;                                 /* temporary looping variable        */
 
 }
 
-/*\
- *  \function{alloc\_self\_stack()}
- *
- *  This function allocates a block of self records and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste header items to pointers to records in order to form the free
- *  list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the header node.
- *  It will work provided a header item is larger than a pointer, which
- *  is the case.
-\*/
-
-void alloc_self_stack(
-   SETL_SYSTEM_PROTO_VOID)
-
-{
-self_stack_ptr_type new_block;         /* first header in allocated block   */
-
-   /* allocate a new block */
-
-   new_block = (self_stack_ptr_type)malloc((size_t)
-         (SELF_STACK_BLOCK_SIZE * sizeof(struct self_stack_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (SELF_STACK_NEXT_FREE = new_block;
-        SELF_STACK_NEXT_FREE < new_block + SELF_STACK_BLOCK_SIZE - 1;
-        SELF_STACK_NEXT_FREE++) {
-
-      *((self_stack_ptr_type *)SELF_STACK_NEXT_FREE) =
-         SELF_STACK_NEXT_FREE + 1;
-
-   }
-
-   *((self_stack_ptr_type *)SELF_STACK_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   SELF_STACK_NEXT_FREE = new_block;
-
-   return;
-
-}
-
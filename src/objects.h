@@ -28,6 +28,10 @@
 
 #ifndef OBJECTS_LOADED
 
+/* SETL2 system header files */
+
+#include "slabs.h"                     /* slabs                             */
+
 /* performance tuning constants */
 
 #define OBJ_HEADER_SIZE    4           /* object header size (table)        */
@@ -82,31 +86,29 @@ typedef struct self_stack_item *self_stack_ptr_type;
 /* global data */
 
 #ifdef TSAFE
-#define OBJECT_H_NEXT_FREE plugin_instance->object_h_next_free 
-#define OBJECT_C_NEXT_FREE plugin_instance->object_c_next_free 
-#define SELF_STACK_NEXT_FREE plugin_instance->self_stack_next_free
+#define OBJECT_H_SLAB plugin_instance->object_h_slab
+#define OBJECT_C_SLAB plugin_instance->object_c_slab
+#define SELF_STACK_SLAB plugin_instance->self_stack_slab
 #else
-#define OBJECT_H_NEXT_FREE object_h_next_free 
-#define OBJECT_C_NEXT_FREE object_c_next_free 
-#define SELF_STACK_NEXT_FREE self_stack_next_free
+#define OBJECT_H_SLAB object_h_slab
+#define OBJECT_C_SLAB object_c_slab
+#define SELF_STACK_SLAB self_stack_slab
 
 #ifdef SHARED
 
-object_h_ptr_type object_h_next_free = NULL;
-                                       /* next free header                  */
-object_c_ptr_type object_c_next_free = NULL;
-                                       /* next free cell                    */
-self_stack_ptr_type self_stack_next_free = NULL;
-                                       /* next free self item               */
+struct slab_class_item object_h_slab;  /* header slabs                      */
+struct slab_class_item object_c_slab;  /* cell slabs                        */
+struct slab_class_item self_stack_slab;
+                                       /* self stack slabs                  */
 
 #else
 
-extern object_h_ptr_type object_h_next_free;
-                                       /* next free header                  */
-extern object_c_ptr_type object_c_next_free;
-                                       /* next free cell                    */
-extern self_stack_ptr_type self_stack_next_free;
-                                       /* next free self item               */
+extern struct slab_class_item object_h_slab;
+                                       /* header slabs                      */
+extern struct slab_class_item object_c_slab;
+                                       /* cell slabs                        */
+extern struct slab_class_item self_stack_slab;
+                                       /* self stack slabs                  */
 
 #endif
 #endif
@@ -133,57 +135,36 @@ extern self_stack_ptr_type self_stack_next_free;
 
 #else
 
-#define get_object_header(t) {\
-   if (OBJECT_H_NEXT_FREE == NULL) alloc_object_headers(SETL_SYSTEM_VOID); \
-   t = OBJECT_H_NEXT_FREE; \
-   OBJECT_H_NEXT_FREE = *((object_h_ptr_type *)(OBJECT_H_NEXT_FREE)); \
-}
+#define get_object_header(t) \
+   slab_get(OBJECT_H_SLAB,"object header",object_h_ptr_type,t,\
+            sizeof(struct object_h_item))
 
-#define free_object_header(s) {\
-   *((object_h_ptr_type *)(s)) = OBJECT_H_NEXT_FREE; \
-   OBJECT_H_NEXT_FREE = s; \
-}
+#define free_object_header(s) slab_put(s)
 
 /* allocate and free cell nodes */
 
-#define get_object_cell(t) {\
-   if (OBJECT_C_NEXT_FREE == NULL) alloc_object_cells(SETL_SYSTEM_VOID); \
-   t = OBJECT_C_NEXT_FREE; \
-   OBJECT_C_NEXT_FREE = *((object_c_ptr_type *)(OBJECT_C_NEXT_FREE)); \
-}
+#define get_object_cell(t) \
+   slab_get(OBJECT_C_SLAB,"object cell",object_c_ptr_type,t,\
+            sizeof(struct object_c_item))
 
-#define free_object_cell(s) {\
-   *((object_c_ptr_type *)(s)) = OBJECT_C_NEXT_FREE; \
-   OBJECT_C_NEXT_FREE = s; \
-}
+#define free_object_cell(s) slab_put(s)
 #endif
 
 /* allocate and free header nodes */
 
-#define get_self_stack(t) {\
-   if (SELF_STACK_NEXT_FREE == NULL) alloc_self_stack(SETL_SYSTEM_VOID); \
-   t = SELF_STACK_NEXT_FREE; \
-   SELF_STACK_NEXT_FREE = *((self_stack_ptr_type *)(SELF_STACK_NEXT_FREE)); \
-}
+#define get_self_stack(t) \
+   slab_get(SELF_STACK_SLAB,"self stack",self_stack_ptr_type,t,\
+            sizeof(struct self_stack_item))
 
-#define free_self_stack(s) {\
-   *((self_stack_ptr_type *)(s)) = SELF_STACK_NEXT_FREE; \
-   SELF_STACK_NEXT_FREE = s; \
-}
+#define free_self_stack(s) slab_put(s)
 
 /* public function declarations */
 
-void alloc_object_headers(SETL_SYSTEM_PROTO_VOID);       
-                                       /* allocate a block of header nodes  */
-void alloc_object_cells(SETL_SYSTEM_PROTO_VOID);         
-                                       /* allocate a block of cell nodes    */
 object_h_ptr_type copy_object(SETL_SYSTEM_PROTO object_h_ptr_type);
                                        /* copy a object structure           */
 void free_object(SETL_SYSTEM_PROTO object_h_ptr_type);   
                                        /* free an object structure          */
-void alloc_self_stack(SETL_SYSTEM_PROTO_VOID);           
-                                       /* allocate a block of self stack    */
-                                       /* items                             */
+
 #define OBJECTS_LOADED 1
 #endif
 
@@ -38,6 +38,10 @@
  *  \item
  *  We find addresses (segment offsets) for all labels.  Clearly this
  *  must be done after optimization.
+ *  \item
+ *  We look for procedures with side effects, which must not be run in
+ *  parallel workers.  We need the whole unit for this, since calls to
+ *  procedures with side effects have side effects too.
  *  \end{itemize}
  *
  *  \texify{optimize.h}
@@ -46,6 +50,10 @@
 \*/
 
 
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
+
 /* SETL2 system header files */
 
 #include "system.h"                    /* SETL2 system constants            */
@@ -65,6 +73,13 @@
 
 static void opt_procedure(SETL_SYSTEM_PROTO struct proctab_item *);
                                        /* get next program argument         */
+static void find_side_effects(SETL_SYSTEM_PROTO struct proctab_item *,
+                              struct quad_item *);
+                                       /* check a quadruple for effects     */
+static int spread_side_effects(struct proctab_item *);
+                                       /* pass effects on to callers        */
+static void free_callees(struct proctab_item *);
+                                       /* release lists of calls            */
 
 /*\
  *  \function{optimize()}
@@ -78,10 +93,13 @@ void optimize(
    proctab_ptr_type proctab_ptr)       /* procedure / unit to optimize      */
 
 {
+proctab_ptr_type unit_ptr;             /* procedure or unit we were passed  */
 
    if (proctab_ptr == NULL)
       return;
 
+   unit_ptr = proctab_ptr;
+
 #ifdef DEBUG
 
    if (SYM_DEBUG || QUADS_DEBUG) {
@@ -118,6 +136,19 @@ void optimize(
          proctab_ptr = NULL;
 
    }
+
+   /*
+    *  Once the whole unit is done we know every call, so we can pass side
+    *  effects on from the procedures called to their callers.
+    */
+
+   if (unit_ptr->pr_type != pr_procedure &&
+       unit_ptr->pr_type != pr_method) {
+
+      while (spread_side_effects(unit_ptr->pr_child));
+      free_callees(unit_ptr->pr_child);
+
+   }
 }
 
 /*\
@@ -266,6 +297,20 @@ int32 i;                               /* temporary looping variable        */
       }
    }
 
+   /* look for side effects */
+
+   if (proctab_ptr->pr_type == pr_procedure ||
+       proctab_ptr->pr_type == pr_method) {
+
+      for (quad_ptr = body_head;
+           quad_ptr != NULL && !proctab_ptr->pr_side_effects;
+           quad_ptr = quad_ptr->q_next) {
+
+         find_side_effects(SETL_SYSTEM proctab_ptr,quad_ptr);
+
+      }
+   }
+
    /*
     *  We collapse chains of goto's
     */
@@ -863,3 +908,217 @@ int32 i;                               /* temporary looping variable        */
    free(offset);
 
 }
+
+/*\
+ *  \function{find\_side\_effects()}
+ *
+ *  This function checks one quadruple of a procedure for side effects,
+ *  that is anything which might change a variable the procedure does
+ *  not own, or run code we can not see.  A procedure run by a worker
+ *  changes only the worker's copy of the interpreter, so
+ *  \verb"worker_forall" runs procedures with side effects serially.
+ *
+ *  Built-in procedures change nothing but their write parameters, which
+ *  we check when they are popped.  Calls to procedures in this unit are
+ *  only recorded here, since they may not have been checked yet.  Calls
+ *  to anything else have side effects, as far as we know.
+\*/
+
+static void find_side_effects(
+   SETL_SYSTEM_PROTO
+   proctab_ptr_type proctab_ptr,       /* procedure being checked           */
+   quad_ptr_type quad_ptr)             /* quadruple to be checked           */
+
+{
+symtab_ptr_type symtab_ptr;            /* changed operand or procedure      */
+proctab_ptr_type callee_ptr;           /* procedure called                  */
+proctab_ptr_type owner_ptr;            /* used to find callee's unit        */
+int last;                              /* last operand which may change     */
+int operand;                           /* used to loop over operands        */
+int i;                                 /* temporary looping variable        */
+
+   /* most quadruples change only their first operand */
+
+   last = 0;
+
+   switch (quad_ptr->q_opcode) {
+
+      /* these change nothing */
+
+      case q_noop :      case q_push1 :     case q_push2 :
+      case q_push3 :     case q_go :        case q_goind :
+      case q_gotrue :    case q_gofalse :   case q_goeq :
+      case q_gone :      case q_golt :      case q_gonlt :
+      case q_gole :      case q_gonle :     case q_goin :
+      case q_gonotin :   case q_goincs :    case q_gonincs :
+      case q_return :    case q_assert :    case q_intcheck :
+      case q_label :     case q_stop :
+
+         return;
+
+      /*
+       *  These stop the program, or change objects and processes.  The
+       *  stop statement is a q_stopall; q_stop only ends each body.
+       */
+
+      case q_stopall :   case q_initobj :   case q_initproc :
+      case q_sslot :     case q_slotof :
+
+         proctab_ptr->pr_side_effects = YES;
+         return;
+
+      /*
+       *  Pops, iterators and from change more than one operand.  From
+       *  changes the element and the source, and the result if it is
+       *  an expression.
+       */
+
+      case q_pop2 :      case q_inext :     case q_ufrom :
+
+         last = 1;
+         break;
+
+      case q_pop3 :      case q_from :      case q_fromb :
+      case q_frome :
+
+         last = 2;
+         break;
+
+      /* a call depends on the procedure called */
+
+      case q_lcall :     case q_call :
+
+         symtab_ptr = quad_ptr->q_operand[1].q_symtab_ptr;
+         if (symtab_ptr == NULL || symtab_ptr->st_type != sym_procedure) {
+            proctab_ptr->pr_side_effects = YES;
+            return;
+         }
+
+         callee_ptr = symtab_ptr->st_aux.st_proctab_ptr;
+
+         /* the built-in table tells us which built-ins have effects */
+
+         if (symtab_ptr->st_owner_proc == predef_proctab_ptr) {
+            if (callee_ptr->pr_side_effects)
+               proctab_ptr->pr_side_effects = YES;
+            break;
+         }
+         for (owner_ptr = callee_ptr;
+              owner_ptr != NULL && owner_ptr != unit_proctab_ptr;
+              owner_ptr = owner_ptr->pr_parent);
+
+         if (owner_ptr == NULL) {
+            proctab_ptr->pr_side_effects = YES;
+            return;
+         }
+
+         if (callee_ptr == proctab_ptr)
+            break;
+
+         for (i = 0; i < proctab_ptr->pr_callee_count; i++) {
+            if (proctab_ptr->pr_callees[i] == callee_ptr)
+               break;
+         }
+
+         if (i == proctab_ptr->pr_callee_count) {
+
+            proctab_ptr->pr_callees = (proctab_ptr_type *)realloc(
+                  (void *)proctab_ptr->pr_callees,
+                  (size_t)(i + 1) * sizeof(proctab_ptr_type));
+            if (proctab_ptr->pr_callees == NULL)
+               giveup(SETL_SYSTEM msg_malloc_error);
+
+            proctab_ptr->pr_callees[i] = callee_ptr;
+            proctab_ptr->pr_callee_count++;
+
+         }
+
+         break;
+
+   }
+
+   /* check the operands which may change */
+
+   for (operand = 0; operand <= last; operand++) {
+
+      if (quad_optype[quad_ptr->q_opcode][operand] != QUAD_SPEC_OP)
+         continue;
+
+      symtab_ptr = quad_ptr->q_operand[operand].q_symtab_ptr;
+      if (symtab_ptr != NULL &&
+          !symtab_ptr->st_is_temp &&
+          symtab_ptr->st_owner_proc != proctab_ptr) {
+
+         proctab_ptr->pr_side_effects = YES;
+         return;
+
+      }
+   }
+}
+
+/*\
+ *  \function{spread\_side\_effects()}
+ *
+ *  This function marks procedures which call procedures with side
+ *  effects, over a list of procedures and their children.  It returns
+ *  \verb"YES" if it marked any, in which case we call it again.
+\*/
+
+static int spread_side_effects(
+   proctab_ptr_type proctab_ptr)       /* first procedure in list           */
+
+{
+int changed;                           /* YES if we marked a procedure      */
+int i;                                 /* temporary looping variable        */
+
+   changed = NO;
+
+   for (;
+        proctab_ptr != NULL;
+        proctab_ptr = proctab_ptr->pr_next) {
+
+      for (i = 0;
+           i < proctab_ptr->pr_callee_count &&
+              !proctab_ptr->pr_side_effects;
+           i++) {
+
+         if ((proctab_ptr->pr_callees[i])->pr_side_effects) {
+            proctab_ptr->pr_side_effects = YES;
+            changed = YES;
+         }
+      }
+
+      if (spread_side_effects(proctab_ptr->pr_child))
+         changed = YES;
+
+   }
+
+   return changed;
+
+}
+
+/*\
+ *  \function{free\_callees()}
+ *
+ *  This function releases the lists of procedures called, once we are
+ *  finished with them.
+\*/
+
+static void free_callees(
+   proctab_ptr_type proctab_ptr)       /* first procedure in list           */
+
+{
+
+   for (;
+        proctab_ptr != NULL;
+        proctab_ptr = proctab_ptr->pr_next) {
+
+      if (proctab_ptr->pr_callees != NULL)
+         free((void *)proctab_ptr->pr_callees);
+
+      proctab_ptr->pr_callees = NULL;
+      proctab_ptr->pr_callee_count = 0;
+      free_callees(proctab_ptr->pr_child);
+
+   }
+}
@@ -134,6 +134,29 @@
 /* ## end pcode_types */
 
 #define pcode_length          92       /* Number of operands used           */
+#define PCODE_NGRAM_SIZE  (pcode_length + 1)
+                                       /* dimension of n-gram tables        */
+
+/*
+ *  Superinstructions.  These are never stored in an instruction's
+ *  opcode, only used to find an interpreter case for its handler when
+ *  we load threaded code.  Each one performs the first instruction of
+ *  a pair which occurs frequently in straight-line code, then goes
+ *  directly to the second.
+ */
+
+#define p_add_add             93       /* add, then add                     */
+#define p_add_go              94       /* add, then unconditional branch    */
+#define p_add_golt            95       /* add, then less than branch        */
+#define p_add_return          96       /* add, then return                  */
+#define p_sub_push1           97       /* subtract, then push               */
+#define p_assign_of1          98       /* assign, then map or tuple fetch   */
+#define p_push1_lcall         99       /* push, then literal call           */
+#define p_push2_lcall        100       /* push two, then literal call       */
+#define p_push3_lcall        101       /* push three, then literal call     */
+
+#define pcode_handler_length 101       /* last handler index                */
+
 /*\
  *  \table{operand type table}
  *
@@ -375,6 +398,9 @@ char *pcode_desc[] = {                 /* print string for opcodes          */
 #ifdef DEBUG
 long pcode_operations[128];
 long copy_operations[128];
+long pcode_pairs[PCODE_NGRAM_SIZE][PCODE_NGRAM_SIZE];
+                                       /* straight-line opcode pairs        */
+long *pcode_triples = NULL;            /* and triples, when profiling       */
 #endif
 
 #else
@@ -383,6 +409,9 @@ extern char *pcode_desc[];             /* print string for opcodes          */
 #ifdef DEBUG
 extern long pcode_operations[128];
 extern long copy_operations[128];
+extern long pcode_pairs[PCODE_NGRAM_SIZE][PCODE_NGRAM_SIZE];
+                                       /* straight-line opcode pairs        */
+extern long *pcode_triples;            /* and triples, when profiling       */
 #endif
 
 #endif
@@ -58,105 +58,12 @@
 #include "objects.h"                   /* objects                           */
 #include "process.h"                   /* processes                         */
 #include "mailbox.h"                   /* mailboxes                         */
+#include "execute.h"                   /* core interpreter                  */
+#include "reactor.h"                   /* blocked processes                 */
 
-/* performance tuning constants */
-
-#define PROCESS_BLOCK_SIZE 100         /* process block size                */
-#define REQUEST_BLOCK_SIZE 100         /* request block size                */
-
-/*\
- *  \function{alloc\_processes()}
- *
- *  This function allocates a block of processes and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste process items to pointers to process items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the process node.
- *  It will work provided a process item is larger than a pointer, which
- *  is the case.
-\*/
-
-void alloc_processes(
-   SETL_SYSTEM_PROTO_VOID)
-
-{       
-process_ptr_type new_block;            /* first process in allocated block  */
-
-   /* allocate a new block */
-
-   new_block = (process_ptr_type)malloc((size_t)
-         (PROCESS_BLOCK_SIZE * sizeof(struct process_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (PROCESS_NEXT_FREE = new_block;
-        PROCESS_NEXT_FREE < new_block + PROCESS_BLOCK_SIZE - 1;
-        PROCESS_NEXT_FREE++) {
-
-      *((process_ptr_type *)PROCESS_NEXT_FREE) = PROCESS_NEXT_FREE + 1;
-
-   }
-
-   *((process_ptr_type *)PROCESS_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   PROCESS_NEXT_FREE = new_block;
-
-   return;
-
-}
-
-/*\
- *  \function{alloc\_requests()}
- *
- *  This function allocates a block of requests and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste request items to pointers to request items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the request node.
- *  It will work provided a request item is larger than a pointer, which
- *  is the case.
-\*/
-
-void alloc_requests(
-   SETL_SYSTEM_PROTO_VOID)
-
-{      
-request_ptr_type new_block;            /* first request in allocated block  */
-
-   /* allocate a new block */
-
-   new_block = (request_ptr_type)malloc((size_t)
-         (REQUEST_BLOCK_SIZE * sizeof(struct request_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (REQUEST_NEXT_FREE = new_block;
-        REQUEST_NEXT_FREE < new_block + REQUEST_BLOCK_SIZE - 1;
-        REQUEST_NEXT_FREE++) {
-
-      *((request_ptr_type *)REQUEST_NEXT_FREE) = REQUEST_NEXT_FREE + 1;
-
-   }
-
-   *((request_ptr_type *)REQUEST_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   REQUEST_NEXT_FREE = new_block;
-
-   return;
-
-}
+#if UNIX
+#include <time.h>                      /* monotonic clock                   */
+#endif
 
 /*\
  *  \function{unblock\_process}
@@ -174,7 +81,7 @@ int process_unblock(
 
 {
 
-   switch (process_ptr->pc_wait_key.sp_form) {
+   switch (spec_form(&process_ptr->pc_wait_key)) {
 
 /*\
  *  \case{mailboxes}
@@ -189,14 +96,75 @@ case ft_mailbox :
 mailbox_h_ptr_type mailbox_ptr;        /* mailbox pointer                   */
 mailbox_c_ptr_type mailbox_cell;       /* a mailbox value                   */
 struct specifier_item *target;         /* return target                     */
+tuple_h_ptr_type tuple_root;           /* drained values                    */
+tuple_c_ptr_type tuple_cell;           /* created cell node                 */
+int32 tuple_length;                    /* number of values drained          */
 
-   mailbox_ptr = process_ptr->pc_wait_key.sp_val.sp_mailbox_ptr;
+   mailbox_ptr = spec_val(&process_ptr->pc_wait_key,sp_mailbox_ptr);
    
    /* if the mailbox is empty we can't unblock */
 
    if (mailbox_ptr->mb_cell_count == 0)
       return NO;
 
+   /*
+    *  A drain takes as many values as it may in one tuple.  The values
+    *  move from the mailbox cells to the tuple, so we needn't touch
+    *  their use counts.
+    */
+
+   if (process_ptr->pc_wait_limit > 0) {
+
+      tuple_length = mailbox_ptr->mb_cell_count;
+      if (tuple_length > process_ptr->pc_wait_limit)
+         tuple_length = process_ptr->pc_wait_limit;
+      process_ptr->pc_wait_limit = 0;
+
+      tuple_root = new_tuple(SETL_SYSTEM_VOID);
+      reserve_tuple(tuple_root,tuple_length);
+
+      for (tuple_cell = tuple_root->t_cells;
+           tuple_cell < tuple_root->t_cells + tuple_length;
+           tuple_cell++) {
+
+         mailbox_cell = mailbox_ptr->mb_head;
+         spec_set_form(&tuple_cell->t_spec,
+            spec_form(&mailbox_cell->mb_spec));
+         spec_set_val(&tuple_cell->t_spec,sp_biggest,
+            spec_val(&mailbox_cell->mb_spec,sp_biggest));
+         spec_hash_code(tuple_cell->t_hash_code,
+                        &(tuple_cell->t_spec));
+         tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
+
+         mailbox_ptr->mb_head = mailbox_cell->mb_next;
+         free_mailbox_cell(mailbox_cell);
+
+      }
+
+      if (mailbox_ptr->mb_head == NULL)
+         mailbox_ptr->mb_tail = &(mailbox_ptr->mb_head);
+      mailbox_ptr->mb_cell_count -= tuple_length;
+
+      /* trailing omegas aren't part of a tuple */
+
+      while (tuple_length > 0 &&
+             spec_form(&tuple_root->t_cells[tuple_length - 1].t_spec) ==
+                ft_omega)
+         tuple_length--;
+      tuple_root->t_length = tuple_length;
+
+      spec_set_form(&process_ptr->pc_wait_return,ft_tuple);
+      spec_set_val(&process_ptr->pc_wait_return,sp_tuple_ptr,tuple_root);
+      if (process_ptr->pc_wait_target == NULL) {
+         unmark_specifier(&(process_ptr->pc_wait_return));
+         spec_set_form(&process_ptr->pc_wait_return,ft_omega);
+      }
+
+      unmark_specifier(&(process_ptr->pc_wait_key));
+      return YES;
+
+   }
+
    /* we'll pop the first value */
 
    mailbox_cell = mailbox_ptr->mb_head;
@@ -205,8 +173,9 @@ struct specifier_item *target;         /* return target                     */
 
    if (process_ptr->pc_wait_target != NULL) {
       target = &(process_ptr->pc_wait_return);
-      target->sp_form = mailbox_cell->mb_spec.sp_form;     
-      target->sp_val.sp_biggest = mailbox_cell->mb_spec.sp_val.sp_biggest;     
+      spec_set_form(target,spec_form(&mailbox_cell->mb_spec));     
+      spec_set_val(target,sp_biggest,
+                   spec_val(&mailbox_cell->mb_spec,sp_biggest));
       mark_specifier(target);
    }
 
@@ -238,22 +207,17 @@ case ft_set :
 {
 mailbox_h_ptr_type mailbox_ptr;        /* mailbox pointer                   */
 mailbox_c_ptr_type mailbox_cell;       /* a mailbox value                   */
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+set_h_ptr_type source_root;            /* root of set                       */
+struct set_cursor_item source_cursor;  /* position in set                   */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* set element                       */
 tuple_h_ptr_type tuple_root;           /* root of returned tuple            */
 tuple_c_ptr_type tuple_cell;           /* created cell node                 */
-int32 i;                               /* temporary looping variable        */
 
    /* set up to loop over the set */
 
-   source_root = process_ptr->pc_wait_key.sp_val.sp_set_ptr;
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
+   source_root = spec_val(&process_ptr->pc_wait_key,sp_set_ptr);
+   set_cursor_start(&source_cursor,source_root->s_trie);
 
    /* loop over the elements of source */
 
@@ -261,75 +225,13 @@ int32 i;                               /* temporary looping variable        */
 
       /* find the next element in the set */
 
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, break */
-
-         if (source_cell != NULL) {
-
-            source_element = &(source_cell->s_spec);
-            source_cell = source_cell->s_next;
-            break;
-
-         }
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < SET_HASH_SIZE) {
-
-            source_cell = source_work_hdr->s_child[source_index].s_cell;
-            source_index++;
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= SET_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->s_child[source_index].s_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if we've exhausted the set break again */
-
-      if (source_element == NULL)
+      if ((source_cell = set_cursor_next(&source_cursor)) == NULL)
          break;
+      source_element = &(source_cell->s_spec);
 
       /* otherwise check the mailbox */
 
-      mailbox_ptr = source_element->sp_val.sp_mailbox_ptr;
+      mailbox_ptr = spec_val(source_element,sp_mailbox_ptr);
    
       /* if the mailbox is empty we can't unblock */
 
@@ -346,43 +248,35 @@ int32 i;                               /* temporary looping variable        */
 
          /* create a new tuple for the target */
 
-         get_tuple_header(tuple_root);
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code = 0;
-         tuple_root->t_ntype.t_root.t_length = 2;
-         tuple_root->t_ntype.t_root.t_height = 0;
-         for (i = 2;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_cell = NULL);
+         tuple_root = new_tuple(SETL_SYSTEM_VOID);
+         tuple_root->t_length = 2;
 
          /* the first element is the mailbox key */
 
-         get_tuple_cell(tuple_cell);
-         tuple_cell->t_spec.sp_form = ft_mailbox;
-         tuple_cell->t_spec.sp_val.sp_mailbox_ptr = mailbox_ptr;
+         tuple_cell = tuple_root->t_cells;
+         spec_set_form(&tuple_cell->t_spec,ft_mailbox);
+         spec_set_val(&tuple_cell->t_spec,sp_mailbox_ptr,mailbox_ptr);
          mailbox_ptr->mb_use_count++;
          spec_hash_code(tuple_cell->t_hash_code,
                         &(tuple_cell->t_spec));
-         tuple_root->t_child[0].t_cell = tuple_cell;
          tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
 
          /* the second element is the value of the mailbox */
 
-         get_tuple_cell(tuple_cell);
-         tuple_cell->t_spec.sp_form = 
-            mailbox_cell->mb_spec.sp_form;     
-         tuple_cell->t_spec.sp_val.sp_biggest =
-            mailbox_cell->mb_spec.sp_val.sp_biggest;     
+         tuple_cell++;
+         spec_set_form(&tuple_cell->t_spec,
+            spec_form(&mailbox_cell->mb_spec));     
+         spec_set_val(&tuple_cell->t_spec,sp_biggest,
+            spec_val(&mailbox_cell->mb_spec,sp_biggest));     
          mark_specifier(&(tuple_cell->t_spec));
          spec_hash_code(tuple_cell->t_hash_code,
                         &(tuple_cell->t_spec));
-         tuple_root->t_child[1].t_cell = tuple_cell;
          tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
 
          /* stick the result on the process record */
 
-         process_ptr->pc_wait_return.sp_form = ft_tuple;
-         process_ptr->pc_wait_return.sp_val.sp_tuple_ptr = tuple_root;
+         spec_set_form(&process_ptr->pc_wait_return,ft_tuple);
+         spec_set_val(&process_ptr->pc_wait_return,sp_tuple_ptr,tuple_root);
 
       }
 
@@ -417,113 +311,34 @@ case ft_tuple :
 {
 mailbox_h_ptr_type mailbox_ptr;        /* mailbox pointer                   */
 mailbox_c_ptr_type mailbox_cell;       /* a mailbox value                   */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+tuple_h_ptr_type source_root;          /* tuple of mailboxes                */
 tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
-tuple_h_ptr_type tuple_root, tuple_work_hdr, new_tuple_hdr;
-                                       /* tuple header pointers             */
-int tuple_index, tuple_height;         /* used to descend header trees      */
+tuple_c_ptr_type source_end;           /* end of element array              */
+specifier *source_element;             /* tuple element                     */
+tuple_h_ptr_type tuple_root;           /* returned tuple                    */
 int32 tuple_length;                    /* current tuple length              */
-int32 expansion_trigger;               /* size which triggers header        */
-                                       /* expansion                         */
 tuple_c_ptr_type tuple_cell;           /* created cell node                 */
-int32 i;                               /* temporary looping variable        */
 
    /*
     *  We'll have to loop over the tuple twice, the first time just
-    *  checking each mailbox.
+    *  checking each mailbox.  We skip omegas both times.
     */
 
-   /* set up to loop over the tuple */
-
-   source_root = process_ptr->pc_wait_key.sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
-
-   /* loop over the elements of source */
-
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
+   source_root = spec_val(&process_ptr->pc_wait_key,sp_tuple_ptr);
+   unpack_tuple(source_root);
+   source_end = source_root->t_cells + source_root->t_length;
 
-         }
+   for (source_cell = source_root->t_cells;
+        source_cell < source_end;
+        source_cell++) {
 
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if we've exhausted the tuple, success */
-
-      if (source_element == NULL)
-         break;
+      source_element = &(source_cell->t_spec);
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
       /* otherwise check the mailbox */
 
-      mailbox_ptr = source_element->sp_val.sp_mailbox_ptr;
+      mailbox_ptr = spec_val(source_element,sp_mailbox_ptr);
    
       /* if the mailbox is empty we can't unblock */
 
@@ -539,225 +354,243 @@ int32 i;                               /* temporary looping variable        */
 
    /* initialize a tuple to be returned */
 
-   get_tuple_header(tuple_root);
-   tuple_root->t_use_count = 1;
-   tuple_root->t_hash_code = 0;
-   tuple_root->t_ntype.t_root.t_length = 0;
-   tuple_root->t_ntype.t_root.t_height = 0;
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        tuple_root->t_child[i++].t_cell = NULL);
+   tuple_root = new_tuple(SETL_SYSTEM_VOID);
+   reserve_tuple(tuple_root,source_root->t_length);
    tuple_length = 0;
-   expansion_trigger = TUP_HEADER_SIZE;
-
-   /* set up to loop over the tuple */
 
-   source_root = process_ptr->pc_wait_key.sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+   for (source_cell = source_root->t_cells;
+        source_cell < source_end;
+        source_cell++) {
 
-   /* loop over the elements of source */
-
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
+      source_element = &(source_cell->t_spec);
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
-               source_number++;
-               source_index++;
+      /* get the mailbox value */
 
-               continue;
+      mailbox_ptr = spec_val(source_element,sp_mailbox_ptr);
+      mailbox_cell = mailbox_ptr->mb_head;
+   
+      /*
+       *  Now we have to insert the value into the return tuple.
+       */
 
-            }
+      tuple_cell = tuple_root->t_cells + tuple_length;
+      spec_set_form(&tuple_cell->t_spec,
+         spec_form(&mailbox_cell->mb_spec));     
+      spec_set_val(&tuple_cell->t_spec,sp_biggest,
+         spec_val(&mailbox_cell->mb_spec,sp_biggest));     
+      mark_specifier(&(tuple_cell->t_spec));
+      spec_hash_code(tuple_cell->t_hash_code,
+                     &(tuple_cell->t_spec));
+      tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
 
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
+      /* increment the tuple size */
 
-            source_number++;
-            source_index++;
+      tuple_length++;
 
-            break;
+      /* pop the value from the mailbox */
 
-         }
+      if (process_ptr->pc_waiting) {
+         unmark_specifier(&(mailbox_cell->mb_spec));
+         mailbox_ptr->mb_head = mailbox_cell->mb_next;
+         if (mailbox_ptr->mb_head == NULL)
+            mailbox_ptr->mb_tail = &(mailbox_ptr->mb_head);
+         mailbox_ptr->mb_cell_count--;
+         free_mailbox_cell(mailbox_cell);
+      }
+   }
 
-         /* move up if we're at the end of a node */
+   /* stick the result on the process record */
 
-         if (source_index >= TUP_HEADER_SIZE) {
+   tuple_root->t_length = tuple_length;
+   spec_set_form(&process_ptr->pc_wait_return,ft_tuple);
+   spec_set_val(&process_ptr->pc_wait_return,sp_tuple_ptr,tuple_root);
 
-            /* break if we've exhausted the source */
+   unmark_specifier(&(process_ptr->pc_wait_key));
+   return YES;
 
-            if (source_work_hdr == source_root)
-               break;
+}
 
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
+/* back to normal indentation */
 
-            continue;
+   }
 
-         }
+   return NO;
 
-         /* skip over null nodes */
+}
 
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
+/*\
+ *  \function{process\_send}
+ *
+ *  This function checks whether a process held back by a full mailbox
+ *  can deliver its message.  The message waits on the process record,
+ *  and the mailbox is the wait key.
+\*/
 
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
+int process_send(
+   SETL_SYSTEM_PROTO
+   struct process_item *process_ptr)   /* process to be checked             */
 
-            continue;
+{
+mailbox_h_ptr_type mailbox_ptr;        /* mailbox pointer                   */
+mailbox_c_ptr_type mailbox_cell;       /* created mailbox cell              */
 
-         }
+   mailbox_ptr = spec_val(&process_ptr->pc_wait_key,sp_mailbox_ptr);
 
-         /* otherwise drop down a level */
+   /* if the mailbox is still full we can't unblock */
 
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+   if (mailbox_ptr->mb_cell_count >= mailbox_ptr->mb_capacity)
+      return NO;
 
-      }
+   /* move the message into the mailbox */
 
-      /* if we've exhausted the tuple, we're done */
+   get_mailbox_cell(mailbox_cell);
+   *(mailbox_ptr->mb_tail) = mailbox_cell;
+   mailbox_ptr->mb_tail = &(mailbox_cell->mb_next);
+   mailbox_cell->mb_next = NULL;
 
-      if (source_element == NULL)
-         break;
+   mailbox_ptr->mb_cell_count++;
 
-      /* get the mailbox value */
+   spec_set_form(&mailbox_cell->mb_spec,
+      spec_form(&process_ptr->pc_wait_return));
+   spec_set_val(&mailbox_cell->mb_spec,sp_biggest,
+      spec_val(&process_ptr->pc_wait_return,sp_biggest));
+   spec_set_form(&process_ptr->pc_wait_return,ft_omega);
 
-      mailbox_ptr = source_element->sp_val.sp_mailbox_ptr;
-      mailbox_cell = mailbox_ptr->mb_head;
-   
-      /*
-       *  Now we have to insert the value into the return tuple.
-       */
-
-      /* expand the tuple tree if necessary */
-
-      if (tuple_length >= expansion_trigger) {
-
-         tuple_work_hdr = tuple_root;
+   process_ptr->pc_sending = NO;
+   unmark_specifier(&(process_ptr->pc_wait_key));
+   return YES;
 
-         get_tuple_header(tuple_root);
+}
 
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code =
-            tuple_work_hdr->t_hash_code;
-         tuple_root->t_ntype.t_root.t_length =
-            tuple_work_hdr->t_ntype.t_root.t_length;
-         tuple_root->t_ntype.t_root.t_height =
-            tuple_work_hdr->t_ntype.t_root.t_height + 1;
+/*\
+ *  \function{process\_clock}
+ *
+ *  This function returns a monotonic clock in microseconds, for slices
+ *  and accounting.  We read it at every switch, so where there's a
+ *  coarse clock we use that.  It ticks every few milliseconds, but a
+ *  slice which crosses a tick is charged the whole tick, so over many
+ *  slices each process is charged its share, as the kernel does.
+\*/
 
-         for (i = 1;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_header = NULL);
+long process_clock(void)
 
-         tuple_root->t_child[0].t_header = tuple_work_hdr;
+{
+#if UNIX
+struct timespec now;                   /* current time                      */
 
-         tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-         tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
+#ifdef CLOCK_MONOTONIC_COARSE
+   clock_gettime(CLOCK_MONOTONIC_COARSE,&now);
+#else
+   clock_gettime(CLOCK_MONOTONIC,&now);
+#endif
 
-         expansion_trigger *= TUP_HEADER_SIZE;
+   return (long)now.tv_sec * 1000000L + (long)(now.tv_nsec / 1000L);
 
-      }
+#else
 
-      tuple_root->t_ntype.t_root.t_length++;
+   return (long)((double)clock() * 1000000.0 / (double)CLOCKS_PER_SEC);
 
-      /* descend the tree to a leaf */
+#endif
+}
 
-      tuple_work_hdr = tuple_root;
-      for (tuple_height = tuple_work_hdr->t_ntype.t_root.t_height;
-           tuple_height;
-           tuple_height--) {
+/*\
+ *  \function{process\_charge}
+ *
+ *  This function is called when the current process's slice ends.  We
+ *  charge the process with the time and opcodes it used, and move it
+ *  between levels.  A slice which ran out leaves the counter at exactly
+ *  zero.  A process which gives up the processor sets it to zero, and
+ *  the interpreter takes one more off before it switches.
+ *
+ *  The next slice starts now, whichever process gets it.
+\*/
 
-         /* extract the element's index at this level */
+void process_charge(SETL_SYSTEM_PROTO_VOID)
 
-         tuple_index = (tuple_length >>
-                              (tuple_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
+{
+struct process_item *process_ptr;      /* work process pointer              */
+long now;                              /* clock at end of slice             */
+int32 opcodes;                         /* opcodes in slice                  */
+
+   now = process_clock();
+   opcodes = OPCODE_COUNT - SCHED_OPCODES;
+   process_head->pc_run_usecs += now - SCHED_START;
+   process_head->pc_run_opcodes += opcodes;
+   SCHED_RUN_USECS += now - SCHED_START;
+   SCHED_RUN_OPCODES += opcodes;
+   SCHED_START = now;
+   SCHED_OPCODES = OPCODE_COUNT;
 
-         /* if we're missing a header record, allocate one */
+   /*
+    *  Sink if we used the whole slice, otherwise rise.  A process which
+    *  passes goes to the bottom, behind everything else which can run.
+    */
 
-         if (tuple_work_hdr->t_child[tuple_index].t_header == NULL) {
+   if (process_head->pc_passing) {
+      process_head->pc_level = MLFQ_LEVELS - 1;
+      process_head->pc_passing = NO;
+   }
+   else if (opcodes_until_switch == 0) {
+      if (process_head->pc_level < MLFQ_LEVELS - 1)
+         process_head->pc_level++;
+   }
+   else {
+      process_head->pc_level = process_head->pc_priority;
+   }
 
-            get_tuple_header(new_tuple_hdr);
-            new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-            new_tuple_hdr->t_ntype.t_intern.t_child_index = tuple_index;
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_tuple_hdr->t_child[i++].t_cell = NULL);
-            tuple_work_hdr->t_child[tuple_index].t_header =
-                  new_tuple_hdr;
-            tuple_work_hdr = new_tuple_hdr;
+   /*
+    *  Now and then everything rises.  We also learn how many opcodes we
+    *  run in a millisecond, over the slices since the last time.
+    */
 
-         }
-         else {
+   if (now - SCHED_BOOST >= MLFQ_BOOST * 1000L) {
 
-            tuple_work_hdr =
-               tuple_work_hdr->t_child[tuple_index].t_header;
+      process_ptr = process_head;
+      do {
+         process_ptr->pc_level = process_ptr->pc_priority;
+         process_ptr = process_ptr->pc_next;
+      } while (process_ptr != process_head);
 
-         }
+      if (SCHED_RUN_USECS >= MLFQ_BOOST * 500L) {
+         SCHED_RATE = (double)SCHED_RUN_OPCODES * 1000.0 /
+                      (double)SCHED_RUN_USECS;
+         SCHED_RUN_USECS = 0;
+         SCHED_RUN_OPCODES = 0;
       }
 
-      /*
-       *  At this point, tuple_work_hdr points to the lowest level header
-       *  record.  We insert the new element.
-       */
-
-      tuple_index = tuple_length & TUP_SHIFT_MASK;
-      get_tuple_cell(tuple_cell);
-      tuple_cell->t_spec.sp_form = 
-         mailbox_cell->mb_spec.sp_form;     
-      tuple_cell->t_spec.sp_val.sp_biggest =
-         mailbox_cell->mb_spec.sp_val.sp_biggest;     
-      mark_specifier(&(tuple_cell->t_spec));
-      spec_hash_code(tuple_cell->t_hash_code,
-                     &(tuple_cell->t_spec));
-      tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
-      tuple_work_hdr->t_child[tuple_index].t_cell = tuple_cell;
-
-      /* increment the tuple size */
-
-      tuple_length++;
-
-      /* pop the value from the mailbox */
+      SCHED_BOOST = now;
 
-      if (process_ptr->pc_waiting) {
-         unmark_specifier(&(mailbox_cell->mb_spec));
-         mailbox_ptr->mb_head = mailbox_cell->mb_next;
-         if (mailbox_ptr->mb_head == NULL)
-            mailbox_ptr->mb_tail = &(mailbox_ptr->mb_head);
-         mailbox_ptr->mb_cell_count--;
-         free_mailbox_cell(mailbox_cell);
-      }
    }
+}
 
-   /* stick the result on the process record */
-
-   tuple_root->t_ntype.t_root.t_length = tuple_length;
-   process_ptr->pc_wait_return.sp_form = ft_tuple;
-   process_ptr->pc_wait_return.sp_val.sp_tuple_ptr = tuple_root;
+/*\
+ *  \function{process\_slice\_length}
+ *
+ *  This function returns the length of a process's next slice, in
+ *  opcodes.  Each level down doubles the slice.  Slices are normally
+ *  counted in opcodes, but if we're given a slice in milliseconds we
+ *  convert it with the rate we've seen, since reading the clock for each
+ *  opcode would cost too much.
+\*/
 
-   unmark_specifier(&(process_ptr->pc_wait_key));
-   return YES;
+int32 process_slice_length(
+   SETL_SYSTEM_PROTO
+   struct process_item *process_ptr)   /* process to run                    */
 
-}
+{
+double slice;                          /* opcodes in slice                  */
 
-/* back to normal indentation */
+   if (SLICE_MSECS <= 0 || SCHED_RATE <= 0.0)
+      return PROCESS_SLICE << process_ptr->pc_level;
 
-   }
+   slice = SCHED_RATE * (double)SLICE_MSECS;
+   if (slice < (double)MLFQ_SAMPLE)
+      slice = (double)MLFQ_SAMPLE;
+   if (slice > (double)(SHORT_INT_MAX >> MLFQ_LEVELS))
+      slice = (double)(SHORT_INT_MAX >> MLFQ_LEVELS);
 
-   return NO;
+   return (int32)slice << process_ptr->pc_level;
 
 }
@@ -28,11 +28,35 @@
 
 #ifndef PROCESS_LOADED
 
+/* SETL2 system header files */
+
+#include "slabs.h"                     /* slabs                             */
+
 /* process node structure */
 
 #define ROOT_PROCESS    0              /* main program                      */
 #define CHILD_PROCESS   1              /* generated processes               */
 
+/*
+ *  A process blocked in the reactor repeats the built-in procedure which
+ *  would have blocked once it can proceed.
+ */
+
+typedef void (*reactor_redo_type)(SETL_SYSTEM_PROTO int,
+                                  struct specifier_item *,
+                                  struct specifier_item *);
+
+/*
+ *  The scheduler keeps processes in a multilevel feedback queue.  A
+ *  process which uses its whole slice sinks a level, and gets a longer
+ *  slice next time.  A process which gives up the processor rises to its
+ *  priority.  Every so often everything rises, so no process starves.
+ */
+
+#define MLFQ_LEVELS        4           /* scheduling levels                 */
+#define MLFQ_BOOST       100           /* milliseconds between rises        */
+#define MLFQ_SAMPLE      100           /* fewest opcodes in a timed slice   */
+
 /* process node structure */
 
 struct process_item {
@@ -41,11 +65,26 @@ struct process_item {
    unsigned pc_suspended : 1;          /* YES if manually suspended         */
    unsigned pc_waiting : 1;            /* YES if waiting for mailbox        */
    unsigned pc_checking : 1;           /* YES if checking mailbox           */
+   unsigned pc_sending : 1;            /* YES if waiting for mailbox room   */
+   unsigned pc_passing : 1;            /* YES if passing the processor on   */
+   unsigned pc_blocked : 1;            /* YES if waiting in the reactor     */
+   unsigned pc_ready : 1;              /* YES if its descriptor is ready    */
    struct specifier_item pc_wait_key;  /* key to await or acheck            */
    struct specifier_item pc_wait_return; 
                                        /* return value from wait            */
    struct specifier_item *pc_wait_target; 
                                        /* target for return from wait       */
+   int32 pc_wait_limit;                /* most values to drain, or 0        */
+   int pc_wait_fd;                     /* descriptor awaited, or -1         */
+   long pc_wake_time;                  /* wake-up time in ms, or -1         */
+   int pc_priority;                    /* best level, 0 is highest          */
+   int pc_level;                       /* current level                     */
+   long pc_run_usecs;                  /* time running, in microseconds     */
+   int32 pc_run_opcodes;               /* opcodes executed                  */
+   reactor_redo_type pc_redo;          /* built-in to repeat on wake-up     */
+   int pc_redo_argc;                   /* number of saved arguments         */
+   struct specifier_item *pc_redo_args;
+                                       /* saved arguments                   */
    struct process_item *pc_prev;       /* previous process in pool          */
    struct process_item *pc_next;       /* next value in process pool        */
    struct object_h_item *pc_object_ptr;
@@ -86,63 +125,78 @@ struct request_item {
 typedef struct request_item *request_ptr_type;
                                        /* request item type                 */
 #ifdef TSAFE
-#define PROCESS_NEXT_FREE plugin_instance->process_next_free 
-#define REQUEST_NEXT_FREE plugin_instance->request_next_free 
+#define PROCESS_SLAB plugin_instance->process_slab
+#define REQUEST_SLAB plugin_instance->request_slab
+#define SCHED_START plugin_instance->sched_start
+#define SCHED_OPCODES plugin_instance->sched_opcodes
+#define SCHED_BOOST plugin_instance->sched_boost
+#define SCHED_RATE plugin_instance->sched_rate
+#define SCHED_RUN_USECS plugin_instance->sched_run_usecs
+#define SCHED_RUN_OPCODES plugin_instance->sched_run_opcodes
 #else
-#define PROCESS_NEXT_FREE process_next_free 
-#define REQUEST_NEXT_FREE request_next_free 
+#define PROCESS_SLAB process_slab
+#define REQUEST_SLAB request_slab
+#define SCHED_START sched_start
+#define SCHED_OPCODES sched_opcodes
+#define SCHED_BOOST sched_boost
+#define SCHED_RATE sched_rate
+#define SCHED_RUN_USECS sched_run_usecs
+#define SCHED_RUN_OPCODES sched_run_opcodes
 
 #ifdef SHARED
         
-process_ptr_type process_next_free = NULL;
-                                       /* next free process                 */
-request_ptr_type request_next_free = NULL;
-                                       /* next free request                 */
+struct slab_class_item process_slab;   /* process slabs                     */
+struct slab_class_item request_slab;   /* request slabs                     */
+long sched_start = 0;                  /* clock at start of slice, in us    */
+int32 sched_opcodes = 0;               /* opcode count at start of slice    */
+long sched_boost = 0;                  /* clock at last rise, in us         */
+double sched_rate = 0.0;               /* opcodes per millisecond           */
+long sched_run_usecs = 0;              /* time run since rate was set       */
+int32 sched_run_opcodes = 0;           /* opcodes run since rate was set    */
 
 #else
 
-extern process_ptr_type process_next_free;
-                                       /* next free process                 */
-extern request_ptr_type request_next_free;
-                                       /* next free request                 */
+extern struct slab_class_item process_slab;
+                                       /* process slabs                     */
+extern struct slab_class_item request_slab;
+                                       /* request slabs                     */
+extern long sched_start;               /* clock at start of slice, in us    */
+extern int32 sched_opcodes;            /* opcode count at start of slice    */
+extern long sched_boost;               /* clock at last rise, in us         */
+extern double sched_rate;              /* opcodes per millisecond           */
+extern long sched_run_usecs;           /* time run since rate was set       */
+extern int32 sched_run_opcodes;        /* opcodes run since rate was set    */
 
 #endif
 #endif
 
 /* allocate and free process nodes */
 
-#define get_process(t) {\
-   if (PROCESS_NEXT_FREE == NULL) alloc_processes(SETL_SYSTEM_VOID); \
-   t = PROCESS_NEXT_FREE; \
-   PROCESS_NEXT_FREE = *((process_ptr_type *)(PROCESS_NEXT_FREE)); \
-}
+#define get_process(t) \
+   slab_get(PROCESS_SLAB,"process",process_ptr_type,t,\
+            sizeof(struct process_item))
 
-#define free_process(s) {\
-   *((process_ptr_type *)(s)) = PROCESS_NEXT_FREE; \
-   PROCESS_NEXT_FREE = s; \
-}
+#define free_process(s) slab_put(s)
 
 /* allocate and free request nodes */
 
-#define get_request(t) {\
-   if (REQUEST_NEXT_FREE == NULL) alloc_requests(SETL_SYSTEM_VOID); \
-   t = REQUEST_NEXT_FREE; \
-   REQUEST_NEXT_FREE = *((request_ptr_type *)(REQUEST_NEXT_FREE)); \
-}
+#define get_request(t) \
+   slab_get(REQUEST_SLAB,"request",request_ptr_type,t,\
+            sizeof(struct request_item))
 
-#define free_request(s) {\
-   *((request_ptr_type *)(s)) = REQUEST_NEXT_FREE; \
-   REQUEST_NEXT_FREE = s; \
-}
+#define free_request(s) slab_put(s)
 
 /* public function declarations */
 
-void alloc_processes(SETL_SYSTEM_PROTO_VOID);            
-                                       /* allocate a block of process nodes */
 int process_unblock(SETL_SYSTEM_PROTO struct process_item *);
                                        /* try to unblock a waiting process  */
-void alloc_requests(SETL_SYSTEM_PROTO_VOID); 
-                                       /* allocate a block of request nodes */
+int process_send(SETL_SYSTEM_PROTO struct process_item *);
+                                       /* try to deliver a held message     */
+long process_clock(void);              /* monotonic clock in microseconds   */
+void process_charge(SETL_SYSTEM_PROTO_VOID);
+                                       /* account for the ended slice       */
+int32 process_slice_length(SETL_SYSTEM_PROTO struct process_item *);
+                                       /* opcodes in a process's slice      */
 
 #define PROCESS_LOADED 1
 #endif
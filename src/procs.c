@@ -51,56 +51,6 @@
 #include "procs.h"                     /* procedures                        */
 #include "objects.h"                   /* objects                           */
 
-/* performance tuning constants */
-
-#define PROC_BLOCK_SIZE        100     /* procedure block size              */
-
-/*\
- *  \function{alloc\_procs()}
- *
- *  This function allocates a block of procedures and links them together
- *  into a free list.  Note carefully the castes used here: we caste
- *  procedure items to pointers to procedure items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the procedure
- *  node.  It will work provided a procedure item is larger than a
- *  pointer, which is the case.
-\*/
-
-void alloc_procs(SETL_SYSTEM_PROTO_VOID)
-
-{
-proc_ptr_type new_block;               /* first procedure in allocated      */
-                                       /* block                             */
-
-   /* allocate a new block */
-
-   new_block = (proc_ptr_type)malloc((size_t)
-         (PROC_BLOCK_SIZE * sizeof(struct proc_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (PROC_NEXT_FREE = new_block;
-        PROC_NEXT_FREE < new_block + PROC_BLOCK_SIZE - 1;
-        PROC_NEXT_FREE++) {
-
-      *((proc_ptr_type *)PROC_NEXT_FREE) = PROC_NEXT_FREE + 1;
-
-   }
-   *((proc_ptr_type *)PROC_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   PROC_NEXT_FREE = new_block;
-
-   return;
-
-}
-
 /*\
  *  \function{free\_procedure()}
  *
@@ -28,6 +28,10 @@
 
 #ifndef PROCS_LOADED
 
+/* SETL2 system header files */
+
+#include "slabs.h"                     /* slabs                             */
+
 /* procedure types */
 
 #define BUILTIN_PROC 0                 /* built-in procedure                */
@@ -54,6 +58,8 @@ struct proc_item {
    struct proc_item *p_copy;           /* copy of procedure                 */
    unsigned p_var_args : 1;            /* YES if procedure accepts a        */
                                        /* variable number of arguments      */
+   unsigned p_side_effects : 1;        /* YES if procedure may change       */
+                                       /* anything it does not own          */
    struct specifier_item *p_save_specs;
                                        /* saved local data                  */
    int p_active_use_count;             /* active procedures using proc      */
@@ -68,40 +74,31 @@ typedef struct proc_item *proc_ptr_type;
 /* global data */
 
 #ifdef TSAFE
-#define PROC_NEXT_FREE plugin_instance->proc_next_free 
+#define PROC_SLAB plugin_instance->proc_slab
 #else
-#define PROC_NEXT_FREE proc_next_free 
+#define PROC_SLAB proc_slab
 #ifdef SHARED
 
-proc_ptr_type proc_next_free = NULL;
-                                       /* next free procedure               */
+struct slab_class_item proc_slab;      /* procedure slabs                   */
 
 #else
 
-extern proc_ptr_type proc_next_free;
-                                       /* next free procedure               */
+extern struct slab_class_item proc_slab;
+                                       /* procedure slabs                   */
 
 #endif
 #endif
 
 /* allocate and free procedure nodes */
 
-#define get_proc(t) {\
-   if (PROC_NEXT_FREE == NULL) alloc_procs(SETL_SYSTEM_VOID); \
-   t = PROC_NEXT_FREE; \
-   PROC_NEXT_FREE = *((proc_ptr_type *)(PROC_NEXT_FREE)); \
-}
+#define get_proc(t) \
+   slab_get(PROC_SLAB,"procedure",proc_ptr_type,t,\
+            sizeof(struct proc_item))
 
-#define free_proc(s) {\
-   *((proc_ptr_type *)(s)) = PROC_NEXT_FREE; \
-   PROC_NEXT_FREE = s; \
-}
+#define free_proc(s) slab_put(s)
 
 /* public function declarations */
 
-void alloc_procs(SETL_SYSTEM_PROTO_VOID);               
-                                       /* allocate a block of procedure     */
-                                       /* nodes                             */
 void free_procedure(SETL_SYSTEM_PROTO proc_ptr_type);  
                                        /* recursively free a procedure      */
 
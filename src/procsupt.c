@@ -29,6 +29,9 @@
  *  processes.  They control suspension, killing, waiting, and mailboxes.
 \*/
 
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
 
 /* SETL2 system header files */
 
@@ -51,12 +54,23 @@
 #include "objects.h"                   /* objects                           */
 #include "process.h"                   /* objects                           */
 #include "mailbox.h"                   /* objects                           */
+#include "reactor.h"                   /* blocked processes                 */
+
+#if UNIX
+#include <errno.h>                     /* system error codes                */
+#include <time.h>                      /* nanosleep                         */
+#endif
 
 /* local procedures */
 
 #ifdef PROCESSES
-static void aload(int, specifier *, specifier *);
+static void aload(SETL_SYSTEM_PROTO int, specifier *, specifier *);
                                        /* common to wait and check          */
+static void sleep_done(SETL_SYSTEM_PROTO int, specifier *, specifier *);
+                                       /* end of a sleep                    */
+static struct process_item *named_process(SETL_SYSTEM_PROTO specifier *,
+                                          char *);
+                                       /* process argument, or current      */
 #endif
 
 /*\
@@ -78,8 +92,8 @@ process_ptr_type process_ptr;          /* process to be suspended           */
 
    /* make sure we were passed a process */
 
-   if (argv->sp_form != ft_process ||
-       argv->sp_val.sp_object_ptr->o_process_ptr == NULL) {
+   if (spec_form(argv) != ft_process ||
+       spec_val(argv,sp_object_ptr)->o_process_ptr == NULL) {
 
       abend(SETL_SYSTEM "Invalid argument to suspend\nArg => %s",
             abend_opnd_str(SETL_SYSTEM argv));
@@ -88,7 +102,7 @@ process_ptr_type process_ptr;          /* process to be suspended           */
 
    /* flag it suspended */
 
-   process_ptr = argv->sp_val.sp_object_ptr->o_process_ptr;
+   process_ptr = spec_val(argv,sp_object_ptr)->o_process_ptr;
    process_ptr->pc_suspended = YES;
 
    /* force a switch if argument is current process */
@@ -99,7 +113,7 @@ process_ptr_type process_ptr;          /* process to be suspended           */
    /* always return OM */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 #endif
@@ -125,8 +139,8 @@ process_ptr_type process_ptr;          /* process to be resumed             */
 
    /* make sure we were passed a process */
 
-   if (argv->sp_form != ft_process ||
-       argv->sp_val.sp_object_ptr->o_process_ptr == NULL) {
+   if (spec_form(argv) != ft_process ||
+       spec_val(argv,sp_object_ptr)->o_process_ptr == NULL) {
 
       abend(SETL_SYSTEM "Invalid argument to resume\nArg => %s",
             abend_opnd_str(SETL_SYSTEM argv));
@@ -135,13 +149,13 @@ process_ptr_type process_ptr;          /* process to be resumed             */
 
    /* clear the suspend flag */
 
-   process_ptr = argv->sp_val.sp_object_ptr->o_process_ptr;
+   process_ptr = spec_val(argv,sp_object_ptr)->o_process_ptr;
    process_ptr->pc_suspended = NO;
 
    /* always return OM */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -175,15 +189,19 @@ int32 i;                               /* temporary looping variable        */
 
    /* make sure we were passed a process */
 
-   if (argv->sp_form != ft_process ||
-       argv->sp_val.sp_object_ptr->o_process_ptr == NULL) {
+   if (spec_form(argv) != ft_process ||
+       spec_val(argv,sp_object_ptr)->o_process_ptr == NULL) {
 
       abend(SETL_SYSTEM "Invalid argument to kill\nArg => %s",
             abend_opnd_str(SETL_SYSTEM argv));
    
    }
 
-   process_ptr = argv->sp_val.sp_object_ptr->o_process_ptr;
+   process_ptr = spec_val(argv,sp_object_ptr)->o_process_ptr;
+
+   /* if the process is waiting for input or a timer, forget it */
+
+   reactor_release(SETL_SYSTEM process_ptr);
 
    /* if the process is waiting, clear the wait key */
 
@@ -193,6 +211,18 @@ int32 i;                               /* temporary looping variable        */
       unmark_specifier(&(process_ptr->pc_wait_key));
       process_ptr->pc_waiting = NO;
       process_ptr->pc_checking = NO;
+      process_ptr->pc_wait_limit = 0;
+
+   }
+
+   /* if the process is waiting to send, drop the message */
+
+   if (process_ptr->pc_sending) {
+
+      unmark_specifier(&(process_ptr->pc_wait_key));
+      unmark_specifier(&(process_ptr->pc_wait_return));
+      spec_set_form(&process_ptr->pc_wait_return,ft_omega);
+      process_ptr->pc_sending = NO;
 
    }
 
@@ -211,7 +241,7 @@ int32 i;                               /* temporary looping variable        */
       mailbox_cell->mb_next = NULL;
 
       mailbox_ptr->mb_cell_count++;
-      mailbox_cell->mb_spec.sp_form = ft_omega;
+      spec_set_form(&mailbox_cell->mb_spec,ft_omega);
       mailbox_ptr->mb_use_count++;
    
       /* if we haven't started on the request, free the arguments */
@@ -223,7 +253,7 @@ int32 i;                               /* temporary looping variable        */
 
          for (i = 0; i < arg_count; i++) {
             unmark_specifier(&((request_ptr->rq_args)[i]));
-            (request_ptr->rq_args)[i].sp_form = ft_omega;
+            spec_set_form(&(request_ptr->rq_args)[i],ft_omega);
          }
       }
       else {
@@ -235,7 +265,7 @@ int32 i;                               /* temporary looping variable        */
               arg_ptr++) {
 
             unmark_specifier(arg_ptr);
-            arg_ptr->sp_form = ft_omega;
+            spec_set_form(arg_ptr,ft_omega);
 
          }
       }
@@ -276,7 +306,7 @@ int32 i;                               /* temporary looping variable        */
    /* always return OM */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -287,7 +317,9 @@ int32 i;                               /* temporary looping variable        */
  *  \function{setl2\_newmbox()}
  *
  *  This function is the \verb"newmbox" built-in function.  It just
- *  creates and returns an empty mailbox.
+ *  creates and returns an empty mailbox.  An optional argument bounds
+ *  the mailbox, and a process sending to a full mailbox waits until the
+ *  receiver takes something.
 \*/
 
 void setl2_newmbox(
@@ -300,15 +332,23 @@ void setl2_newmbox(
 #ifdef PROCESSES
 mailbox_h_ptr_type mailbox_ptr;        /* returned mailbox header           */
 
+   if (argc > 0 &&
+       (spec_form(argv) != ft_short ||
+        spec_val(argv,sp_short_value) <= 0))
+      abend(SETL_SYSTEM msg_bad_arg,"positive integer",1,"proc_newmbox",
+            abend_opnd_str(SETL_SYSTEM argv));
+
    get_mailbox_header(mailbox_ptr);
    mailbox_ptr->mb_use_count = 1;
    mailbox_ptr->mb_cell_count = 0;
+   mailbox_ptr->mb_capacity =
+      argc > 0 ? (int32)spec_val(argv,sp_short_value) : 0;
    mailbox_ptr->mb_head = NULL;
    mailbox_ptr->mb_tail = &(mailbox_ptr->mb_head);
    
    unmark_specifier(target);
-   target->sp_form = ft_mailbox;
-   target->sp_val.sp_mailbox_ptr = mailbox_ptr;
+   spec_set_form(target,ft_mailbox);
+   spec_set_val(target,sp_mailbox_ptr,mailbox_ptr);
 
    return;
 
@@ -339,17 +379,19 @@ void setl2_await(
 
    /* check the argument types */
 
-   aload(argc,argv,target);
+   aload(SETL_SYSTEM argc,argv,target);
 
    /* save the key on the process record */
 
    mark_specifier(argv);
-   process_head->pc_wait_key.sp_form = argv->sp_form;
-   process_head->pc_wait_key.sp_val.sp_biggest = argv->sp_val.sp_biggest;
+   spec_set_form(&process_head->pc_wait_key,spec_form(argv));
+   spec_set_val(&process_head->pc_wait_key,sp_biggest,
+                spec_val(argv,sp_biggest));
 
    /* flag the process as waiting and save the real target */
 
    process_head->pc_waiting = YES;
+   process_head->pc_wait_limit = 0;
    process_head->pc_wait_target = ex_wait_target;
 
    opcodes_until_switch = 0;
@@ -357,7 +399,7 @@ void setl2_await(
    /* this is a dummy return of OM */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -388,13 +430,14 @@ void setl2_acheck(
 
    /* check the argument types */
 
-   aload(argc,argv,target);
+   aload(SETL_SYSTEM argc,argv,target);
 
    /* save the key on the process record */
 
    mark_specifier(argv);
-   process_head->pc_wait_key.sp_form = argv->sp_form;
-   process_head->pc_wait_key.sp_val.sp_biggest = argv->sp_val.sp_biggest;
+   spec_set_form(&process_head->pc_wait_key,spec_form(argv));
+   spec_set_val(&process_head->pc_wait_key,sp_biggest,
+                spec_val(argv,sp_biggest));
 
    /* flag the process as waiting and save the real target */
 
@@ -406,7 +449,61 @@ void setl2_acheck(
    /* this is a dummy return of OM */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
+
+   return;
+
+#endif
+}
+
+/*\
+ *  \function{setl2\_drain}
+ *
+ *  The \verb"drain" procedure waits for a mailbox like \verb"await", but
+ *  then takes up to $n$ values at once and returns them in a tuple.  A
+ *  consumer of a busy mailbox switches processes once per batch, rather
+ *  than once per value.
+\*/
+
+void setl2_drain(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (two here)        */
+   specifier *target)                  /* return value                      */
+
+{
+#ifdef PROCESSES
+
+   /* check the argument types */
+
+   if (spec_form(&argv[0]) != ft_mailbox)
+      abend(SETL_SYSTEM msg_bad_arg,"mailbox",1,"proc_drain",
+            abend_opnd_str(SETL_SYSTEM argv));
+
+   if (spec_form(&argv[1]) != ft_short ||
+       spec_val(&argv[1],sp_short_value) <= 0)
+      abend(SETL_SYSTEM msg_bad_arg,"positive integer",2,"proc_drain",
+            abend_opnd_str(SETL_SYSTEM argv + 1));
+
+   /* save the key on the process record */
+
+   mark_specifier(argv);
+   spec_set_form(&process_head->pc_wait_key,spec_form(argv));
+   spec_set_val(&process_head->pc_wait_key,sp_biggest,
+                spec_val(argv,sp_biggest));
+
+   /* flag the process as waiting and save the real target */
+
+   process_head->pc_waiting = YES;
+   process_head->pc_wait_limit = (int32)spec_val(&argv[1],sp_short_value);
+   process_head->pc_wait_target = ex_wait_target;
+
+   opcodes_until_switch = 0;
+
+   /* this is a dummy return of OM */
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_omega);
 
    return;
 
@@ -429,7 +526,7 @@ static void aload(
 
 {
 
-   switch (argv->sp_form) {
+   switch (spec_form(argv)) {
 
 /*\
  *  \case{mailboxes}
@@ -455,17 +552,13 @@ case ft_mailbox :
 case ft_set :
 
 {
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+set_h_ptr_type source_root;            /* root of set                       */
+struct set_cursor_item source_cursor;  /* position in set                   */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* set element                       */
 
-   source_root = argv->sp_val.sp_set_ptr;
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
+   source_root = spec_val(argv,sp_set_ptr);
+   set_cursor_start(&source_cursor,source_root->s_trie);
 
    /* loop over the elements of source */
 
@@ -473,241 +566,339 @@ specifier *source_element;             /* set element                       */
 
       /* find the next element in the set */
 
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, break */
-
-         if (source_cell != NULL) {
-
-            source_element = &(source_cell->s_spec);
-            source_cell = source_cell->s_next;
-            break;
+      if ((source_cell = set_cursor_next(&source_cursor)) == NULL)
+         break;
+      source_element = &(source_cell->s_spec);
 
-         }
+      if (spec_form(source_element) != ft_mailbox) {
 
-         /* start on the next clash list, if we're at a leaf */
+         abend(SETL_SYSTEM "Invalid argument to wait\nArg => %s",
+               abend_opnd_str(SETL_SYSTEM argv));
 
-         if (!source_height && source_index < SET_HASH_SIZE) {
+      }
+   }
 
-            source_cell = source_work_hdr->s_child[source_index].s_cell;
-            source_index++;
-            continue;
+   return;
 
-         }
+}
 
-         /* move up if we're at the end of a node */
+/*\
+ *  \case{tuples}
+ *
+ *  We loop over the elements of a tuple printing each. When we encounter
+ *  a string we print enclosing quotes.
+\*/
 
-         if (source_index >= SET_HASH_SIZE) {
+case ft_tuple :
 
-            /* there are no more elements, so break */
+{
+tuple_h_ptr_type source_root;          /* tuple of mailboxes                */
+tuple_c_ptr_type source_cell;          /* current cell pointer              */
+tuple_c_ptr_type source_end;           /* end of element array              */
+specifier *source_element;             /* tuple element                     */
 
-            if (source_work_hdr == source_root)
-               break;
+   source_root = spec_val(argv,sp_tuple_ptr);
+   unpack_tuple(source_root);
+   source_end = source_root->t_cells + source_root->t_length;
 
-            /* otherwise move up */
+   /* loop over the elements of source, skipping omegas */
 
-            source_height++;
-            source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
+   for (source_cell = source_root->t_cells;
+        source_cell < source_end;
+        source_cell++) {
 
-         }
+      source_element = &(source_cell->t_spec);
+      if (spec_form(source_element) == ft_omega)
+         continue;
 
-         /* skip over null nodes */
+      if (spec_form(source_element) != ft_mailbox) {
 
-         if (source_work_hdr->s_child[source_index].s_header == NULL) {
+         abend(SETL_SYSTEM "Invalid argument to wait\nArg => %s",
+               abend_opnd_str(SETL_SYSTEM argv));
 
-            source_index++;
-            continue;
+      }
+   }
 
-         }
+   return;
 
-         /* otherwise drop down a level */
+}
 
-         source_work_hdr =
-            source_work_hdr->s_child[source_index].s_header;
-         source_index = 0;
-         source_height--;
+/*\
+ *  \case{errors}
+ *
+ *  Oops. That's all we can wait on.
+\*/
 
-      }
+default :
 
-      /* if we've exhausted the set break again */
+{
 
-      if (source_element == NULL)
-         break;
+   abend(SETL_SYSTEM "Invalid argument to wait\nArg => %s",
+         abend_opnd_str(SETL_SYSTEM argv));
 
-      if (source_element->sp_form != ft_mailbox) {
+}
 
-         abend(SETL_SYSTEM "Invalid argument to wait\nArg => %s",
-               abend_opnd_str(SETL_SYSTEM argv));
+/* back to normal indentation */
 
-      }
    }
 
    return;
 
 }
+#endif
 
 /*\
- *  \case{tuples}
+ *  \function{setl2\_pass()}
  *
- *  We loop over the elements of a tuple printing each. When we encounter
- *  a string we print enclosing quotes.
+ *  This function is the \verb"pass" built-in function.  It abandons a
+ *  time slice, and drops the caller behind everything else which can
+ *  run until it next gives up the processor.
 \*/
 
-case ft_tuple :
+void setl2_pass(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
 
 {
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
+#ifdef PROCESSES
 
-   source_root = argv->sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+   process_head->pc_passing = YES;
+   opcodes_until_switch = 0;
 
-   /* loop over the elements of source */
+   unmark_specifier(target);
+   spec_set_form(target,ft_omega);
 
-   while (source_number < source_root->t_ntype.t_root.t_length) {
+   return;
+#endif
 
-      /* find the next element in the tuple */
+}
 
-      source_element = NULL;
-      for (;;) {
+/*\
+ *  \function{setl2\_sleep()}
+ *
+ *  This function is the \verb"proc_sleep" built-in function.  It blocks
+ *  the current process for the given number of milliseconds, and lets
+ *  the others run meanwhile.  If nothing else can run we sleep in the
+ *  reactor rather than spin.  Called from C we can not switch processes,
+ *  so we just sleep.
+\*/
 
-         /* if we have an element already, return it */
+void setl2_sleep(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
 
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
+{
+#ifdef PROCESSES
+long msecs;                            /* time to sleep                     */
+#if UNIX
+struct timespec delay;                 /* nanosleep interval                */
+#endif
 
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
+   if (spec_form(argv) != ft_short ||
+       spec_val(argv,sp_short_value) < 0)
+      abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",1,"proc_sleep",
+            abend_opnd_str(SETL_SYSTEM argv));
 
-               source_number++;
-               source_index++;
+   msecs = (long)spec_val(argv,sp_short_value);
 
-               continue;
+   /* a zero sleep just passes the processor on */
 
-            }
+   if (msecs == 0) {
+      process_head->pc_passing = YES;
+      opcodes_until_switch = 0;
+   }
 
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
+   else if (!reactor_park(SETL_SYSTEM -1,msecs,sleep_done,0,NULL)) {
 
-            source_number++;
-            source_index++;
+#if UNIX
 
-            break;
+      delay.tv_sec = msecs / 1000L;
+      delay.tv_nsec = (msecs % 1000L) * 1000000L;
+      while (nanosleep(&delay,&delay) < 0 && errno == EINTR);
 
-         }
+#endif
 
-         /* move up if we're at the end of a node */
+   }
 
-         if (source_index >= TUP_HEADER_SIZE) {
+   unmark_specifier(target);
+   spec_set_form(target,ft_omega);
 
-            /* break if we've exhausted the source */
+   return;
 
-            if (source_work_hdr == source_root)
-               break;
+#endif
+}
 
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
+/*\
+ *  \function{sleep\_done()}
+ *
+ *  The reactor calls this function when a sleeping process wakes up.
+ *  There is nothing left to do but return OM.
+\*/
 
-            continue;
+#ifdef PROCESSES
 
-         }
+static void sleep_done(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (none here)       */
+   specifier *target)                  /* return value                      */
 
-         /* skip over null nodes */
+{
 
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
+   unmark_specifier(target);
+   spec_set_form(target,ft_omega);
 
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
+   return;
 
-            continue;
+}
 
-         }
+#endif
+
+/*\
+ *  \function{setl2\_priority()}
+ *
+ *  This function is the \verb"proc_priority" built-in function.  It sets
+ *  the best level a process may run at, from 0, the highest, down to
+ *  \verb"MLFQ_LEVELS" - 1, and returns the old one.  OM names the
+ *  current process.  A process serving requests keeps a high priority,
+ *  while a batch process given a low one only runs when the others
+ *  can't.
+\*/
+
+void setl2_priority(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (two here)        */
+   specifier *target)                  /* return value                      */
 
-         /* otherwise drop down a level */
+{
+#ifdef PROCESSES
+struct process_item *process_ptr;      /* process to change                 */
+int priority;                          /* old priority                      */
 
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+   process_ptr = named_process(SETL_SYSTEM argv,"proc_priority");
 
-      }
+   if (spec_form(&argv[1]) != ft_short ||
+       spec_val(&argv[1],sp_short_value) < 0 ||
+       spec_val(&argv[1],sp_short_value) >= MLFQ_LEVELS)
+      abend(SETL_SYSTEM msg_bad_arg,"scheduling level",2,"proc_priority",
+            abend_opnd_str(SETL_SYSTEM argv + 1));
 
-      if (source_element == NULL)
-         break;
+   priority = process_ptr->pc_priority;
+   process_ptr->pc_priority = process_ptr->pc_level =
+      (int)spec_val(&argv[1],sp_short_value);
 
-      if (source_element->sp_form != ft_mailbox) {
+   /* a process which loses priority lets the others run */
 
-         abend(SETL_SYSTEM "Invalid argument to wait\nArg => %s",
-               abend_opnd_str(SETL_SYSTEM argv));
+   if (process_ptr == process_head &&
+       process_ptr->pc_priority > priority)
+      opcodes_until_switch = 0;
 
-      }
-   }
+   unmark_specifier(target);
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,priority);
 
    return;
 
+#endif
 }
 
-/*\
- *  \case{errors}
+/*\
+ *  \function{setl2\_usage()}
  *
- *  Oops. That's all we can wait on.
+ *  This function is the \verb"proc_usage" built-in function.  It returns
+ *  a tuple of the seconds a process has run, the opcodes it has
+ *  executed, and the level it's at now.  OM names the current process,
+ *  whose slice so far counts too.
 \*/
 
-default :
+void setl2_usage(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (one here)        */
+   specifier *target)                  /* return value                      */
 
 {
+#ifdef PROCESSES
+struct process_item *process_ptr;      /* process to report                 */
+tuple_h_ptr_type tuple_root;           /* returned tuple                    */
+tuple_c_ptr_type tuple_cell;           /* created cell node                 */
+long usecs;                            /* time run                          */
+int32 opcodes;                         /* opcodes executed                  */
+
+   process_ptr = named_process(SETL_SYSTEM argv,"proc_usage");
+
+   usecs = process_ptr->pc_run_usecs;
+   opcodes = process_ptr->pc_run_opcodes;
+   if (process_ptr == process_head) {
+      usecs += process_clock() - SCHED_START;
+      opcodes += OPCODE_COUNT - SCHED_OPCODES;
+   }
 
-   abend(SETL_SYSTEM "Invalid argument to wait\nArg => %s",
-         abend_opnd_str(SETL_SYSTEM argv));
+   tuple_root = new_tuple(SETL_SYSTEM_VOID);
+   reserve_tuple(tuple_root,3);
+   tuple_root->t_length = 3;
 
-}
+   tuple_cell = tuple_root->t_cells;
+   spec_set_form(&tuple_cell->t_spec,ft_real);
+   spec_set_val(&tuple_cell->t_spec,sp_real_value,(double)usecs / 1000000.0);
 
-/* back to normal indentation */
+   tuple_cell++;
+   spec_set_form(&tuple_cell->t_spec,ft_omega);
+   short_to_long(SETL_SYSTEM &tuple_cell->t_spec,opcodes);
+
+   tuple_cell++;
+   spec_set_form(&tuple_cell->t_spec,ft_short);
+   spec_set_val(&tuple_cell->t_spec,sp_short_value,process_ptr->pc_level);
+
+   for (tuple_cell = tuple_root->t_cells;
+        tuple_cell < tuple_root->t_cells + 3;
+        tuple_cell++) {
+
+      spec_hash_code(tuple_cell->t_hash_code,&(tuple_cell->t_spec));
+      tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
 
    }
 
+   unmark_specifier(target);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,tuple_root);
+
    return;
 
-}
 #endif
+}
 
-/*\
- *  \function{setl2\_pass()}
+/*\
+ *  \function{named\_process()}
  *
- *  This function is the \verb"pass" built-in function.  It just
- *  abandons a time slice.
+ *  This function returns the process named by an argument to the
+ *  scheduling built-ins.  OM names the current process.
 \*/
 
-void setl2_pass(
+#ifdef PROCESSES
+
+static struct process_item *named_process(
    SETL_SYSTEM_PROTO
-   int argc,                           /* number of arguments passed        */
-   specifier *argv,                    /* argument vector (only 1 here)     */
-   specifier *target)                  /* return value                      */
+   specifier *argument,                /* process or OM                     */
+   char *name)                         /* built-in name, for errors         */
 
 {
-#ifdef PROCESSES
 
-   opcodes_until_switch = 0;
+   if (spec_form(argument) == ft_omega)
+      return process_head;
 
-   unmark_specifier(target);
-   target->sp_form = ft_omega;
+   if (spec_form(argument) != ft_process ||
+       spec_val(argument,sp_object_ptr)->o_process_ptr == NULL)
+      abend(SETL_SYSTEM msg_bad_arg,"process",1,name,
+            abend_opnd_str(SETL_SYSTEM argument));
 
-   return;
-#endif
+   return spec_val(argument,sp_object_ptr)->o_process_ptr;
 
 }
 
-
+#endif
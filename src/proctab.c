@@ -181,6 +181,8 @@ char *p;                               /* temporary looping variable        */
             proctab_ptr->pr_namtab_ptr = namtab_ptr;
             proctab_ptr->pr_formal_count = c_built_in_tab[i].bi_formal_count;
             proctab_ptr->pr_var_args = c_built_in_tab[i].bi_var_args;
+            proctab_ptr->pr_side_effects =
+               c_built_in_tab[i].bi_side_effects;
             symtab_ptr->st_aux.st_proctab_ptr = proctab_ptr;
 
             /* create dummy formal parameters */
@@ -313,6 +315,9 @@ void clear_proctab(
    (p)->pr_file_pos.fp_line = -1;
    (p)->pr_file_pos.fp_line = -1;
    (p)->pr_var_args = 0;
+   (p)->pr_side_effects = 0;
+   (p)->pr_callees = NULL;
+   (p)->pr_callee_count = 0;
    (p)->pr_label_count = 0;
    (p)->pr_method_code = -1;
 
@@ -64,7 +64,11 @@ struct proctab_item {
    unsigned pr_method_code : 8;        /* method code                       */
    unsigned pr_var_args : 1;           /* YES if procedure accepts          */
                                        /* variable number of arguments      */
+   unsigned pr_side_effects : 1;       /* YES if procedure may change       */
+                                       /* anything it does not own          */
    int pr_formal_count;                /* number of formal parameters       */
+   struct proctab_item **pr_callees;   /* procedures called in this unit    */
+   int pr_callee_count;                /* number of procedures called       */
 };
 
 typedef struct proctab_item *proctab_ptr_type;
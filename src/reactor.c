@@ -0,0 +1,495 @@
+/*\
+ *
+ *  % MIT License
+ *  %
+ *  % Copyright (c) 1990 W. Kirk Snyder
+ *  %
+ *  % Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  % of this software and associated documentation files (the "Software"), to deal
+ *  % in the Software without restriction, including without limitation the rights
+ *  % to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  % copies of the Software, and to permit persons to whom the Software is
+ *  % furnished to do so, subject to the following conditions:
+ *  % 
+ *  % The above copyright notice and this permission notice shall be included in all
+ *  % copies or substantial portions of the Software.
+ *  %
+ *  % THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  % IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  % FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  % AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  % LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  % OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  % SOFTWARE.
+ *  %
+ *
+ *  \package{Reactor}
+ *
+ *  This package lets a process wait for input or for a timer without
+ *  stopping the whole interpreter.  A built-in procedure which would
+ *  block parks the current process here instead, and the scheduler
+ *  switches to another process.  Between slices the scheduler polls for
+ *  ready descriptors and expired timers, and when nothing else can run
+ *  it sleeps until one is ready.  A process leaving the reactor repeats
+ *  the built-in procedure which blocked, which can then proceed.
+ *
+ *  Under Linux we watch descriptors with \verb"epoll", so the cost of a
+ *  poll does not grow with the number of processes.  Elsewhere we
+ *  collect the descriptors from the process pool and call
+ *  \verb"poll()".
+ *
+ *  \texify{reactor.h}
+ *
+ *  \packagebody{Reactor}
+\*/
+
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
+
+/* SETL2 system header files */
+
+#include "system.h"                    /* SETL2 system constants            */
+#include "interp.h"                    /* SETL2 interpreter constants       */
+#include "giveup.h"                    /* severe error handler              */
+#include "messages.h"                  /* error messages                    */
+#include "form.h"                      /* form codes                        */
+#include "specs.h"                     /* specifiers                        */
+#include "execute.h"                   /* core interpreter                  */
+#include "process.h"                   /* processes                         */
+#include "reactor.h"                   /* blocked processes                 */
+
+#if UNIX
+#include <errno.h>                     /* system error codes                */
+#include <time.h>                      /* monotonic clock                   */
+#include <poll.h>                      /* poll                              */
+#ifdef __linux__
+#include <sys/epoll.h>                 /* epoll                             */
+#define USE_EPOLL 1
+#endif
+#endif
+
+/* performance tuning constants */
+
+#define REACTOR_EVENTS     64          /* events collected per poll         */
+
+#if defined(PROCESSES) && UNIX
+
+/*\
+ *  \function{reactor\_clock()}
+ *
+ *  This function returns a monotonic clock in milliseconds.
+\*/
+
+static long reactor_clock(void)
+
+{
+struct timespec now;                   /* current time                      */
+
+   clock_gettime(CLOCK_MONOTONIC,&now);
+
+   return (long)now.tv_sec * 1000L + (long)(now.tv_nsec / 1000000L);
+
+}
+
+/*\
+ *  \function{reactor\_forget()}
+ *
+ *  This function takes a process out of the reactor, leaving its saved
+ *  arguments alone.
+\*/
+
+static void reactor_forget(
+   SETL_SYSTEM_PROTO
+   process_ptr_type process_ptr)       /* process leaving the reactor       */
+
+{
+
+   if (process_ptr->pc_wait_fd >= 0) {
+
+#if USE_EPOLL
+
+      /* the descriptor may be closed already, which removes it */
+
+      epoll_ctl(REACTOR_FD,EPOLL_CTL_DEL,process_ptr->pc_wait_fd,NULL);
+
+#endif
+
+      REACTOR_WATCHED--;
+
+   }
+
+   process_ptr->pc_wait_fd = -1;
+   process_ptr->pc_wake_time = -1;
+   process_ptr->pc_blocked = NO;
+   process_ptr->pc_ready = NO;
+   REACTOR_BLOCKED--;
+
+}
+
+#endif
+
+/*\
+ *  \function{reactor\_park()}
+ *
+ *  This function blocks the current process until \verb"fd" is ready for
+ *  reading, or \verb"msecs" milliseconds have passed.  Either may be
+ *  $-1$.  We save the arguments, so the scheduler can repeat the
+ *  built-in procedure \verb"redo" when the process wakes up, and return
+ *  \verb"YES".
+ *
+ *  We can only switch processes after a call from the interpreter loop,
+ *  not from C.  Otherwise we return \verb"NO", and the caller should
+ *  block as it always has.
+\*/
+
+int reactor_park(
+   SETL_SYSTEM_PROTO
+   int fd,                             /* descriptor to wait for            */
+   long msecs,                         /* time to wait                      */
+   reactor_redo_type redo,             /* built-in to repeat                */
+   int argc,                           /* number of arguments passed        */
+   specifier *argv)                    /* argument vector                   */
+
+{
+#if defined(PROCESSES) && UNIX
+process_ptr_type process_ptr;          /* process to be blocked             */
+int i;                                 /* temporary looping variable        */
+#if USE_EPOLL
+struct epoll_event event;              /* descriptor registration           */
+#endif
+
+   if (!ex_can_wait || critical_section || process_head == NULL)
+      return NO;
+
+   process_ptr = process_head;
+
+#if USE_EPOLL
+
+   if (fd >= 0) {
+
+      if (REACTOR_FD < 0) {
+
+         REACTOR_FD = epoll_create1(EPOLL_CLOEXEC);
+         if (REACTOR_FD < 0)
+            return NO;
+
+      }
+
+      /* another process may be waiting for the same descriptor */
+
+      event.events = EPOLLIN;
+      event.data.ptr = (void *)process_ptr;
+      if (epoll_ctl(REACTOR_FD,EPOLL_CTL_ADD,fd,&event) < 0)
+         return NO;
+
+   }
+
+#endif
+
+   /* save the arguments for the repeated call */
+
+   process_ptr->pc_redo_args = NULL;
+   if (argc > 0) {
+
+      process_ptr->pc_redo_args =
+         (specifier *)malloc((size_t)(argc * sizeof(specifier)));
+      if (process_ptr->pc_redo_args == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
+
+      for (i = 0; i < argc; i++) {
+
+         mark_specifier(&argv[i]);
+         spec_set_form(&(process_ptr->pc_redo_args)[i],
+                       spec_form(&argv[i]));
+         spec_set_val(&(process_ptr->pc_redo_args)[i],sp_biggest,
+                      spec_val(&argv[i],sp_biggest));
+
+      }
+   }
+
+   process_ptr->pc_redo = redo;
+   process_ptr->pc_redo_argc = argc;
+   process_ptr->pc_wait_target = ex_wait_target;
+
+   process_ptr->pc_wait_fd = fd;
+   if (fd >= 0)
+      REACTOR_WATCHED++;
+   process_ptr->pc_wake_time = -1;
+   if (msecs >= 0)
+      process_ptr->pc_wake_time = reactor_clock() + msecs;
+
+   process_ptr->pc_blocked = YES;
+   process_ptr->pc_ready = NO;
+   REACTOR_BLOCKED++;
+
+   /* make sure we switch before the next instruction */
+
+   opcodes_until_switch = 0;
+
+   return YES;
+
+#else
+
+   return NO;
+
+#endif
+}
+
+/*\
+ *  \function{reactor\_unblock()}
+ *
+ *  This function returns \verb"YES" if a blocked process is ready to
+ *  proceed, as of the last poll.
+\*/
+
+int reactor_unblock(
+   SETL_SYSTEM_PROTO
+   process_ptr_type process_ptr)       /* blocked process                   */
+
+{
+
+   if (process_ptr->pc_ready)
+      return YES;
+
+   if (process_ptr->pc_wake_time >= 0 &&
+       REACTOR_NOW >= process_ptr->pc_wake_time)
+      return YES;
+
+   return NO;
+
+}
+
+/*\
+ *  \function{reactor\_poll()}
+ *
+ *  This function marks blocked processes whose descriptors are ready.
+ *  If \verb"wait" is \verb"NO" it just looks.  Otherwise nothing else can
+ *  run, so we sleep until a descriptor is ready or the nearest timer
+ *  expires.  We return \verb"NO" if no process could ever wake up, which
+ *  is a deadlock.
+\*/
+
+int reactor_poll(
+   SETL_SYSTEM_PROTO
+   int wait)                           /* YES if we should sleep            */
+
+{
+#if defined(PROCESSES) && UNIX
+process_ptr_type process_ptr;          /* used to loop over process pool    */
+int timeout;                           /* poll timeout in ms                */
+int waiting;                           /* YES if a process could wake up    */
+long delay;                            /* time to the next timer            */
+int count;                             /* number of ready descriptors       */
+int i;                                 /* temporary looping variable        */
+#if USE_EPOLL
+struct epoll_event events[REACTOR_EVENTS];
+                                       /* ready descriptors                 */
+#else
+struct pollfd *poll_fds;               /* descriptors to watch              */
+process_ptr_type *poll_procs;          /* process for each descriptor       */
+#endif
+
+   /* find the nearest timer */
+
+   timeout = 0;
+   if (wait) {
+
+      timeout = -1;
+      waiting = NO;
+      REACTOR_NOW = reactor_clock();
+      process_ptr = process_head;
+      do {
+
+         if (process_ptr->pc_blocked &&
+             !process_ptr->pc_suspended &&
+             process_ptr->pc_wait_fd >= 0)
+            waiting = YES;
+
+         if (process_ptr->pc_blocked &&
+             !process_ptr->pc_suspended &&
+             process_ptr->pc_wake_time >= 0) {
+
+            waiting = YES;
+            delay = process_ptr->pc_wake_time - REACTOR_NOW;
+            if (delay < 0)
+               delay = 0;
+            if (timeout < 0 || delay < (long)timeout)
+               timeout = (int)delay;
+
+         }
+
+         process_ptr = process_ptr->pc_next;
+
+      } while (process_ptr != process_head);
+
+      if (!waiting)
+         return NO;
+
+   }
+
+#if USE_EPOLL
+
+   if (REACTOR_WATCHED > 0) {
+
+      do {
+         count = epoll_wait(REACTOR_FD,events,REACTOR_EVENTS,timeout);
+      } while (count < 0 && errno == EINTR);
+
+      for (i = 0; i < count; i++)
+         ((process_ptr_type)events[i].data.ptr)->pc_ready = YES;
+
+   }
+   else if (timeout > 0) {
+
+      poll(NULL,0,timeout);
+
+   }
+
+#else
+
+   /* collect the descriptors of blocked processes */
+
+   poll_fds = NULL;
+   poll_procs = NULL;
+   if (REACTOR_WATCHED > 0) {
+
+      poll_fds = (struct pollfd *)malloc(
+                    (size_t)(REACTOR_WATCHED * sizeof(struct pollfd)));
+      poll_procs = (process_ptr_type *)malloc(
+                    (size_t)(REACTOR_WATCHED * sizeof(process_ptr_type)));
+      if (poll_fds == NULL || poll_procs == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
+
+   }
+
+   count = 0;
+   process_ptr = process_head;
+   do {
+
+      if (process_ptr->pc_blocked && process_ptr->pc_wait_fd >= 0) {
+
+         poll_fds[count].fd = process_ptr->pc_wait_fd;
+         poll_fds[count].events = POLLIN;
+         poll_fds[count].revents = 0;
+         poll_procs[count++] = process_ptr;
+
+      }
+
+      process_ptr = process_ptr->pc_next;
+
+   } while (process_ptr != process_head);
+
+   if (count > 0 || timeout > 0) {
+
+      while (poll(poll_fds,(nfds_t)count,timeout) < 0 && errno == EINTR);
+
+      for (i = 0; i < count; i++) {
+         if (poll_fds[i].revents)
+            poll_procs[i]->pc_ready = YES;
+      }
+   }
+
+   free((void *)poll_fds);
+   free((void *)poll_procs);
+
+#endif
+
+   REACTOR_NOW = reactor_clock();
+
+   return YES;
+
+#else
+
+   return NO;
+
+#endif
+}
+
+/*\
+ *  \function{reactor\_resume()}
+ *
+ *  This function takes a ready process out of the reactor and repeats
+ *  the built-in procedure which blocked it.  The scheduler calls it
+ *  after installing the process, so the result goes to the target the
+ *  process saw, and anything the built-in procedure pushes on the stack
+ *  is popped by the process's next instructions.  If the built-in
+ *  procedure parks the process again, we leave its target alone.
+\*/
+
+void reactor_resume(
+   SETL_SYSTEM_PROTO
+   process_ptr_type process_ptr)       /* process leaving the reactor       */
+
+{
+#if defined(PROCESSES) && UNIX
+specifier return_value;                /* return value specifier            */
+specifier *args;                       /* saved arguments                   */
+specifier *target;                     /* return target                     */
+int argc;                              /* number of saved arguments         */
+int i;                                 /* temporary looping variable        */
+
+   reactor_forget(SETL_SYSTEM process_ptr);
+
+   args = process_ptr->pc_redo_args;
+   argc = process_ptr->pc_redo_argc;
+   process_ptr->pc_redo_args = NULL;
+
+   /* repeat the call */
+
+   spec_set_form(&return_value,ft_omega);
+   ex_wait_target = process_ptr->pc_wait_target;
+   ex_can_wait = YES;
+   (*(process_ptr->pc_redo))(SETL_SYSTEM argc,args,&return_value);
+   ex_can_wait = NO;
+
+   if (!process_ptr->pc_blocked &&
+       (target = process_ptr->pc_wait_target) != NULL) {
+
+      unmark_specifier(target);
+      spec_set_form(target,spec_form(&return_value));
+      spec_set_val(target,sp_biggest,spec_val(&return_value,sp_biggest));
+
+   }
+   else {
+
+      unmark_specifier(&return_value);
+
+   }
+
+   /* release the saved arguments */
+
+   for (i = 0; i < argc; i++)
+      unmark_specifier(&args[i]);
+   free((void *)args);
+
+#endif
+}
+
+/*\
+ *  \function{reactor\_release()}
+ *
+ *  This function takes a process which is killed or destroyed out of the
+ *  reactor, without repeating its call.
+\*/
+
+void reactor_release(
+   SETL_SYSTEM_PROTO
+   process_ptr_type process_ptr)       /* process leaving the reactor       */
+
+{
+#if defined(PROCESSES) && UNIX
+int i;                                 /* temporary looping variable        */
+
+   if (!process_ptr->pc_blocked)
+      return;
+
+   reactor_forget(SETL_SYSTEM process_ptr);
+
+   for (i = 0; i < process_ptr->pc_redo_argc; i++)
+      unmark_specifier(&(process_ptr->pc_redo_args)[i]);
+   free((void *)process_ptr->pc_redo_args);
+   process_ptr->pc_redo_args = NULL;
+
+#endif
+}
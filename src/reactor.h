@@ -0,0 +1,76 @@
+/*\
+ *
+ *  % MIT License
+ *  %
+ *  % Copyright (c) 1990 W. Kirk Snyder
+ *  %
+ *  % Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  % of this software and associated documentation files (the "Software"), to deal
+ *  % in the Software without restriction, including without limitation the rights
+ *  % to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  % copies of the Software, and to permit persons to whom the Software is
+ *  % furnished to do so, subject to the following conditions:
+ *  % 
+ *  % The above copyright notice and this permission notice shall be included in all
+ *  % copies or substantial portions of the Software.
+ *  %
+ *  % THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  % IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  % FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  % AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  % LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  % OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  % SOFTWARE.
+ *  %
+ *
+ *  \packagespec{Reactor}
+\*/
+
+#ifndef REACTOR_LOADED
+
+/* global data */
+
+#ifdef TSAFE
+#define REACTOR_FD plugin_instance->reactor_fd
+#define REACTOR_WATCHED plugin_instance->reactor_watched
+#define REACTOR_BLOCKED plugin_instance->reactor_blocked
+#define REACTOR_NOW plugin_instance->reactor_now
+#else
+#define REACTOR_FD reactor_fd
+#define REACTOR_WATCHED reactor_watched
+#define REACTOR_BLOCKED reactor_blocked
+#define REACTOR_NOW reactor_now
+
+#ifdef SHARED
+
+int reactor_fd = -1;                   /* epoll descriptor, once opened     */
+int reactor_watched = 0;               /* processes waiting for input       */
+int reactor_blocked = 0;               /* processes waiting in the reactor  */
+long reactor_now = 0;                  /* clock at the last poll, in ms     */
+
+#else
+
+extern int reactor_fd;                 /* epoll descriptor, once opened     */
+extern int reactor_watched;            /* processes waiting for input       */
+extern int reactor_blocked;            /* processes waiting in the reactor  */
+extern long reactor_now;               /* clock at the last poll, in ms     */
+
+#endif
+#endif
+
+/* public function declarations */
+
+int reactor_park(SETL_SYSTEM_PROTO int, long, reactor_redo_type, int,
+                 struct specifier_item *);
+                                       /* block the current process         */
+int reactor_unblock(SETL_SYSTEM_PROTO struct process_item *);
+                                       /* YES if a blocked process is ready */
+int reactor_poll(SETL_SYSTEM_PROTO int);
+                                       /* collect ready descriptors         */
+void reactor_resume(SETL_SYSTEM_PROTO struct process_item *);
+                                       /* finish a blocked built-in         */
+void reactor_release(SETL_SYSTEM_PROTO struct process_item *);
+                                       /* forget a blocked process          */
+
+#define REACTOR_LOADED 1
+#endif
@@ -21,6 +21,9 @@
 #include "abend.h"                     /* abnormal end handler              */
 #include "specs.h"                     /* specifiers                        */
 #include "x_strngs.h"                  /* strings                           */
+#include "x_integers.h"                /* integers                          */
+#include "slabs.h"                     /* slabs                             */
+#include "workers.h"                   /* workers                           */
 
 #include <setjmp.h>
 #include <stdarg.h>
@@ -307,6 +310,51 @@ int set_compiler_options(SETL_SYSTEM_PROTO char *option,void *flag)
    		PROCESS_SLICE=(int)(flag);
    		return 0;
    }
+   if (strcmp(option,"slice_msecs")==0) {
+   		SLICE_MSECS=(int32)(flag);
+   		return 0;
+   }
+   if (strcmp(option,"karatsuba_cutoff")==0) {
+   		karatsuba_cutoff=(int32)(flag) > 0 ? (int32)(flag) : SHORT_INT_MAX;
+   		return 0;
+   }
+   if (strcmp(option,"toom3_cutoff")==0) {
+   		toom3_cutoff=(int32)(flag) > 0 ? (int32)(flag) : SHORT_INT_MAX;
+   		return 0;
+   }
+   if (strcmp(option,"fft_cutoff")==0) {
+   		fft_cutoff=(int32)(flag) > 0 ? (int32)(flag) : SHORT_INT_MAX;
+   		return 0;
+   }
+   if (strcmp(option,"hash_seed")==0) {
+   		hash_seed=(unsigned long)(flag);
+   		hash_seed_fixed=YES;
+   		return 0;
+   }
+   if (strcmp(option,"hash_stats")==0) {
+   		hash_statistics(SETL_SYSTEM_VOID);
+   		return 0;
+   }
+   if (strcmp(option,"defer_free")==0) {
+   		DEFER_FREE=(flag!=NULL);
+   		return 0;
+   }
+   if (strcmp(option,"workers")==0) {
+   		WORKER_LIMIT=(int)(long)(flag);
+   		return 0;
+   }
+   if (strcmp(option,"alloc_stats")==0) {
+   		slab_statistics(SETL_SYSTEM_VOID);
+   		return 0;
+   }
+   if (strcmp(option,"calibrate_multiply")==0) {
+   		calibrate_multiply(SETL_SYSTEM_VOID);
+   		setl_printf("-k %ld,%ld,%ld\n",
+   		            karatsuba_cutoff < SHORT_INT_MAX ? karatsuba_cutoff : 0L,
+   		            toom3_cutoff < SHORT_INT_MAX ? toom3_cutoff : 0L,
+   		            fft_cutoff < SHORT_INT_MAX ? fft_cutoff : 0L);
+   		return 0;
+   }
    if (strcmp(option,"parser")==0) {
    		PRS_DEBUG=(int)(flag);
    		return 0;
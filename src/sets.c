@@ -54,1251 +54,1313 @@
 #include "form.h"                      /* form codes                        */
 #include "specs.h"                     /* specifiers                        */
 #include "sets.h"                      /* sets                              */
+#include "maps.h"                      /* maps                              */
 #include "iters.h"                     /* iterators                         */
 #include "pcode.h"                     /* pseudo code                       */
 #include "execute.h"                   /* core interpreter                  */
 
-/* performance tuning constants */
+/* position of a slot's entry in a trie node */
 
-#define SET_HEADER_BLOCK_SIZE  100     /* set header block size             */
-#define SET_CELL_BLOCK_SIZE    400     /* set cell block size               */
+#define data_position(n,b) \
+   set_bit_count((n)->s_datamap & ((b) - 1))
+#define node_position(n,b) \
+   (set_bit_count((n)->s_datamap) + set_bit_count((n)->s_nodemap & ((b) - 1)))
 
 /*\
- *  \function{alloc\_set\_headers()}
+ *  \function{set\_count\_bits()}
  *
- *  This function allocates a block of set headers and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste header items to pointers to header items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the header node.
- *  It will work provided a header item is larger than a pointer, which
- *  is the case.
+ *  This function counts the bits in a trie node bit map.  We only use
+ *  it when the compiler has no population count builtin.
 \*/
 
-void alloc_set_headers(
-   SETL_SYSTEM_PROTO_VOID)
+int set_count_bits(
+   unsigned int bit_map)               /* map to be counted                 */
 
 {
-set_h_ptr_type new_block;              /* first header in allocated block   */
-
-   /* allocate a new block */
-
-   new_block = (set_h_ptr_type)malloc((size_t)
-         (SET_HEADER_BLOCK_SIZE * sizeof(struct set_h_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-
-   /* link items on the free list */
-
-   for (SET_H_NEXT_FREE = new_block;
-        SET_H_NEXT_FREE < new_block + SET_HEADER_BLOCK_SIZE - 1;
-        SET_H_NEXT_FREE++) {
-
-      *((set_h_ptr_type *)SET_H_NEXT_FREE) = SET_H_NEXT_FREE + 1;
-
-   }
-
-   *((set_h_ptr_type *)SET_H_NEXT_FREE) = NULL;
+int count;                             /* bits found so far                 */
 
-   /* set next free node to new block */
+   for (count = 0; bit_map; count++)
+      bit_map &= bit_map - 1;
 
-   SET_H_NEXT_FREE = new_block;
-
-   return;
+   return count;
 
 }
 
 /*\
- *  \function{alloc\_set\_cells()}
+ *  \function{set\_lookup()}
  *
- *  This function allocates a block of set cells and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste cell items to pointers to cell items in order to form the free
- *  list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently, while
- *  at the same time avoiding an extra pointer on the cell node.  It
- *  will work provided a cell item is larger than a pointer, which is
- *  the case.
+ *  This function finds an element in a hash trie, returning the cell
+ *  which holds it, or \verb"NULL" if the element is not in the trie.
+ *  Map cells begin with the same fields as set cells, so we also use
+ *  this function to find domain elements in maps.  A small table is
+ *  searched from the start.
 \*/
 
-void alloc_set_cells(
-   SETL_SYSTEM_PROTO_VOID)
+set_c_ptr_type set_lookup(
+   SETL_SYSTEM_PROTO
+   set_n_ptr_type node,                /* root of trie                      */
+   specifier *element,                 /* element to be found               */
+   int32 hash_code)                    /* hash code of element              */
 
 {
-set_c_ptr_type new_block;              /* first cell in allocated block     */
+set_c_ptr_type cell;                   /* current cell pointer              */
+unsigned int bit;                      /* element's slot in current node    */
+int depth;                             /* depth of current node             */
+int is_equal;                          /* YES if two specifiers are equal   */
+int i;                                 /* temporary looping variable        */
 
-   /* allocate a new block */
+   /* search a small table from the start */
 
-   new_block = (set_c_ptr_type)malloc((size_t)
-         (SET_CELL_BLOCK_SIZE * sizeof(struct set_c_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
+   if (node != NULL && set_is_table(node)) {
 
-   /* link items on the free list */
+      for (i = 0; i < ((set_t_ptr_type)node)->s_count; i++) {
 
-   for (SET_C_NEXT_FREE = new_block;
-        SET_C_NEXT_FREE < new_block + SET_CELL_BLOCK_SIZE - 1;
-        SET_C_NEXT_FREE++) {
+         cell = set_table_cell((set_t_ptr_type)node,i);
+         if (cell->s_hash_code != hash_code)
+            continue;
 
-      *((set_c_ptr_type *)SET_C_NEXT_FREE) = SET_C_NEXT_FREE + 1;
+         spec_equal(is_equal,&(cell->s_spec),element);
+         if (is_equal)
+            return cell;
 
-   }
+      }
 
-   *((set_c_ptr_type *)SET_C_NEXT_FREE) = NULL;
+      return NULL;
 
-   /* set next free node to new block */
+   }
 
-   SET_C_NEXT_FREE = new_block;
+   for (depth = 0; node != NULL; depth++) {
 
-   return;
+      bit = set_hash_bit(hash_code,depth);
 
-}
+      /* if the slot holds a subtrie, move down */
 
-/*\
- *  \function{free\_set()}
- *
- *  This function frees the memory used by an entire set structure.
-\*/
+      if (node->s_nodemap & bit) {
 
-void free_set(
-   SETL_SYSTEM_PROTO
-   set_h_ptr_type root)                /* set to be deleted                 */
+         node = node->s_entry[node_position(node,bit)].s_node;
+         continue;
 
-{
-set_h_ptr_type work_hdr;               /* used to traverse header tree      */
-set_h_ptr_type old_hdr;                /* deleted header record pointer     */
-set_c_ptr_type t1,t2;                  /* used to loop over cell list       */
-                                       /* deleting cells                    */
-int height;                            /* working height of header tree     */
-int index;                             /* index within header hash table    */
+      }
 
-   /* we start iterating from the root, at the left of the hash table */
+      /* if the slot is empty, the element is not in the trie */
 
-   height = root->s_ntype.s_root.s_height;
-   work_hdr = root;
-   index = 0;
+      if (!(node->s_datamap & bit))
+         return NULL;
 
-   /* delete nodes until we finish the tree */
+      /* otherwise search the cells with the same hash code */
 
-   for (;;) {
+      cell = node->s_entry[data_position(node,bit)].s_cell;
+      if (cell->s_hash_code != hash_code)
+         return NULL;
 
-      /* if we're at a leaf, delete all the set elements */
+      for (; cell != NULL; cell = cell->s_next) {
 
-      if (!height) {
+         spec_equal(is_equal,&(cell->s_spec),element);
+         if (is_equal)
+            return cell;
 
-         for (index = 0; index < SET_HASH_SIZE; index++) {
+      }
 
-            t1 = work_hdr->s_child[index].s_cell;
-            while (t1 != NULL) {
+      return NULL;
 
-               t2 = t1;
-               t1 = t1->s_next;
-               unmark_specifier(&(t2->s_spec));
-               free_set_cell(t2);
+   }
 
-            }
-         }
-      }
+   return NULL;
 
-      /* if we've finished a header node, move up */
+}
 
-      if (index >= SET_HASH_SIZE) {
+/*\
+ *  \function{get\_trie\_cell()}
+ *
+ *  This function allocates a cell to be linked into a trie.  The cell
+ *  size tells us whether we want a set or a map cell.
+\*/
 
-         /* when we return to the root we're done */
+static set_c_ptr_type get_trie_cell(
+   SETL_SYSTEM_PROTO
+   int cell_size)                      /* size of set or map cell           */
 
-         if (work_hdr == root)
-            break;
+{
+set_c_ptr_type set_cell;               /* created set cell                  */
+map_c_ptr_type map_cell;               /* created map cell                  */
 
-         height++;
-         index = work_hdr->s_ntype.s_intern.s_child_index + 1;
-         old_hdr = work_hdr;
-         work_hdr = work_hdr->s_ntype.s_intern.s_parent;
-         free_set_header(old_hdr);
-         continue;
+   if (cell_size == sizeof(struct map_c_item)) {
 
-      }
+      get_map_cell(map_cell);
+      return (set_c_ptr_type)map_cell;
 
-      /* if we can't move down, continue */
+   }
 
-      if (work_hdr->s_child[index].s_header == NULL) {
+   get_set_cell(set_cell);
+   return set_cell;
 
-         index++;
-         continue;
+}
 
-      }
+/*\
+ *  \function{get\_set\_table()}
+ *
+ *  This function allocates a small table with room for a given number
+ *  of cells.  We take tables from the trie node free lists.
+\*/
 
-      /* we can move down, so do so */
+static set_t_ptr_type get_set_table(
+   SETL_SYSTEM_PROTO
+   int count,                          /* number of cells in table          */
+   int cell_size)                      /* size of set or map cell           */
 
-      work_hdr = work_hdr->s_child[index].s_header;
-      index = 0;
-      height--;
+{
+set_n_ptr_type node;                   /* allocated node                    */
 
-   }
+   get_set_node(node,set_table_entries(count,cell_size));
+   node->s_datamap = 0;
+   node->s_nodemap = 0;
+   node->s_use_count = 1;
+   node->s_cell_size = (short)cell_size;
+   ((set_t_ptr_type)node)->s_count = (short)count;
 
-   free_set_header(root);
+   return (set_t_ptr_type)node;
 
 }
 
-set_h_ptr_type null_set(
-   SETL_SYSTEM_PROTO_VOID)
+/*\
+ *  \function{get\_trie\_node()}
+ *
+ *  This function allocates a trie node with a given number of entries,
+ *  used only by the caller.  The caller fills in the bit maps and
+ *  entries.
+\*/
+
+static set_n_ptr_type get_trie_node(
+   SETL_SYSTEM_PROTO
+   int entries,                        /* number of entries in node         */
+   int cell_size)                      /* size of set or map cell           */
 
 {
-set_h_ptr_type target_root;           /* root and internal node pointers   */
-int i;
+set_n_ptr_type node;                   /* allocated node                    */
 
-   get_set_header(target_root);
-   target_root->s_use_count = 1;
-   target_root->s_hash_code = 0 ;
-   target_root->s_ntype.s_root.s_height = 0;
-   target_root->s_ntype.s_root.s_cardinality = 0;
-   for (i = 0;
-        i< SET_HASH_SIZE;
-        target_root->s_child[i++].s_cell=NULL);
+   get_set_node(node,entries);
+   node->s_use_count = 1;
+   node->s_cell_size = (short)cell_size;
+
+   return node;
 
-   return target_root;
 }
 
 /*\
- *  \function{copy\_set()}
+ *  \function{unshare\_trie\_node()}
  *
- *  This function copies an entire set structure.
+ *  This function must be called before we change a trie node or small
+ *  table.  If anyone else uses the node we replace it with a copy of
+ *  our own, which shares the subtries of the original and holds copies
+ *  of its cells.  It returns the node we may change.
 \*/
 
-set_h_ptr_type copy_set(
+static set_n_ptr_type unshare_trie_node(
    SETL_SYSTEM_PROTO
-   set_h_ptr_type source_root)         /* set to be copied                  */
+   set_n_ptr_type *node_ptr)           /* link to node to be changed        */
 
 {
-set_h_ptr_type source_work_hdr;        /* root and internal node pointers   */
+set_n_ptr_type node, new_node;         /* shared and created trie nodes     */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
 set_c_ptr_type *target_tail;           /* attach new cells here             */
-set_h_ptr_type new_hdr;                /* created header node               */
 set_c_ptr_type new_cell;               /* created cell node                 */
+int cell_size;                         /* size of set or map cell           */
+int data_count;                        /* number of cell lists in node      */
+int entries;                           /* number of entries in node         */
+int i;                                 /* temporary looping variable        */
 
-#ifdef DEBUG
-#ifdef HAVE_GETRUSAGE
-struct timeval start;                   /* structure to fill                 */
-struct timeval stop;                    /* structure to fill                 */
-struct timezone tz;
-#endif
-
-   if (PROF_DEBUG) {
-#ifdef HAVE_GETRUSAGE
-   gettimeofday(&start,&tz);
-#endif
-      if (profi!=NULL) profi->copies++;
-      copy_operations[OPCODE_EXECUTED]++;
-   }
-   if ((TRACING_ON)&&(TRACE_COPIES))
-      fprintf(DEBUG_FILE,"*COPY_SET*\n");
-#endif
-
-   /* allocate a new root header node */
-
-   get_set_header(target_root);
-   target_root->s_use_count = 1;
-   target_root->s_ntype.s_root.s_height =
-         source_root->s_ntype.s_root.s_height;
-   target_root->s_hash_code =
-         source_root->s_hash_code;
-   target_root->s_ntype.s_root.s_cardinality =
-         source_root->s_ntype.s_root.s_cardinality;
-
-   /* we start iterating from the root, at the left of the hash table */
-
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_work_hdr = source_root;
-   target_work_hdr = target_root;
-   source_index = 0;
+   node = *node_ptr;
+   if (node->s_use_count == 1)
+      return node;
 
-   /* copy nodes until we finish the tree */
+   node->s_use_count--;
+   cell_size = node->s_cell_size;
 
-   for (;;) {
+   /* a small table is copied in one piece */
 
-      /* if we're at a leaf, copy all the set elements */
+   if (set_is_table(node)) {
 
-      if (!source_height) {
+      entries = set_table_entries(((set_t_ptr_type)node)->s_count,cell_size);
+      get_set_node(new_node,entries);
+      memcpy((void *)new_node,
+             (void *)node,
+             set_node_size(entries));
+      new_node->s_use_count = 1;
 
-         for (source_index = 0;
-              source_index < SET_HASH_SIZE;
-              source_index++) {
+      for (i = 0; i < ((set_t_ptr_type)new_node)->s_count; i++) {
 
-            /* loop over the clash list */
+         new_cell = set_table_cell((set_t_ptr_type)new_node,i);
+         mark_specifier(&(new_cell->s_spec));
+         if (cell_size == sizeof(struct map_c_item))
+            mark_specifier(&(((map_c_ptr_type)new_cell)->m_range_spec));
 
-            target_tail = &(target_work_hdr->s_child[source_index].s_cell);
+      }
 
-            for (source_cell = source_work_hdr->s_child[source_index].s_cell;
-                 source_cell != NULL;
-                 source_cell = source_cell->s_next) {
+      *node_ptr = new_node;
 
-               get_set_cell(new_cell);
-               memcpy((void *)new_cell,
-                      (void *)source_cell,
-                      sizeof(struct set_c_item));
-               *target_tail = new_cell;
-               target_tail = &(new_cell->s_next);
-               mark_specifier(&(new_cell->s_spec));
+      return new_node;
 
-            }
+   }
 
-            *target_tail = NULL;
+   data_count = set_bit_count(node->s_datamap);
+   entries = set_node_entries(node);
 
-         }
-      }
+   new_node = get_trie_node(SETL_SYSTEM entries,cell_size);
+   new_node->s_datamap = node->s_datamap;
+   new_node->s_nodemap = node->s_nodemap;
 
-      /* if we've finished an internal node, move up */
+   /* copy the cell lists */
 
-      if (source_index >= SET_HASH_SIZE) {
+   for (i = 0; i < data_count; i++) {
 
-         if (source_work_hdr == source_root)
-            break;
+      target_tail = &(new_node->s_entry[i].s_cell);
 
-         source_height++;
-         source_index = source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         source_work_hdr = source_work_hdr->s_ntype.s_intern.s_parent;
-         target_work_hdr = target_work_hdr->s_ntype.s_intern.s_parent;
+      for (source_cell = node->s_entry[i].s_cell;
+           source_cell != NULL;
+           source_cell = source_cell->s_next) {
 
-         continue;
+         new_cell = get_trie_cell(SETL_SYSTEM cell_size);
+         memcpy((void *)new_cell,
+                (void *)source_cell,
+                (size_t)cell_size);
+         *target_tail = new_cell;
+         target_tail = &(new_cell->s_next);
+         mark_specifier(&(new_cell->s_spec));
+         if (cell_size == sizeof(struct map_c_item))
+            mark_specifier(&(((map_c_ptr_type)new_cell)->m_range_spec));
 
       }
 
-      /* if we can't move down, continue */
+      *target_tail = NULL;
 
-      if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-         target_work_hdr->s_child[source_index].s_header = NULL;
-         source_index++;
-         continue;
-
-      }
+   }
 
-      /* we can move down, so do so */
+   /* share the subtries */
 
-      source_work_hdr = source_work_hdr->s_child[source_index].s_header;
-      get_set_header(new_hdr);
-      target_work_hdr->s_child[source_index].s_header = new_hdr;
-      new_hdr->s_ntype.s_intern.s_parent = target_work_hdr;
-      new_hdr->s_ntype.s_intern.s_child_index = source_index;
-      target_work_hdr = new_hdr;
+   for (; i < entries; i++) {
 
-      source_index = 0;
-      source_height--;
+      new_node->s_entry[i].s_node = node->s_entry[i].s_node;
+      new_node->s_entry[i].s_node->s_use_count++;
 
    }
 
-#ifdef DEBUG
-#ifdef HAVE_GETRUSAGE
-   if (profi!=NULL) {
-      gettimeofday(&stop,&tz);
-      profi->timec.tv_sec +=(stop.tv_sec-start.tv_sec);
-      profi->timec.tv_usec+=(stop.tv_usec-start.tv_usec);
-      while (profi->timec.tv_usec<0) {
-         profi->timec.tv_sec--;
-         profi->timec.tv_usec+=1000000;
-      }
-      while (profi->timec.tv_usec>=1000000) {
-         profi->timec.tv_sec++;
-         profi->timec.tv_usec-=1000000;
-      }
-   } 
-#endif
-#endif
-   return target_root;
+   *node_ptr = new_node;
+
+   return new_node;
 
 }
 
 /*\
- *  \function{expand\_set\_header()}
+ *  \function{trie\_locate()}
+ *
+ *  This function finds the place for an element in a hash trie, which
+ *  must not be a small table.  It returns a pointer to the link which
+ *  points to the element's cell.  If the element is not in the trie
+ *  that link will be \verb"NULL", and the caller {\em must} store a new
+ *  cell there, with the given hash code and a null next pointer, before
+ *  the trie is used again.  The link remains valid only until the trie
+ *  is next changed.
  *
- *  This function adds one level to the height of a set header tree.
- *  It should be called when the average length of the clash lists is at
- *  least two.  We loop over the leaves of the header tree, splitting
- *  each one into a tree.
+ *  If the element's slot is taken by cells with a different hash code
+ *  we push those cells down into a new subtrie, repeating until the two
+ *  hash codes fall into different slots.  Every node on the path is
+ *  unshared on the way down, since the caller may change the cell.
 \*/
 
-set_h_ptr_type set_expand_header(
+static set_c_ptr_type *trie_locate(
    SETL_SYSTEM_PROTO
-   set_h_ptr_type source_root)         /* set to be enlarged                */
+   set_n_ptr_type *node_ptr,           /* pointer to root of trie           */
+   specifier *element,                 /* element to be found               */
+   int32 hash_code,                    /* hash code of element              */
+   int cell_size)                      /* size of set or map cell           */
 
 {
-set_h_ptr_type source_leaf;            /* internal node pointer             */
-set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type target_subtree, target_work_hdr;
-                                       /* root and internal node pointers   */
-int target_index;                      /* current index                     */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
+set_n_ptr_type node, new_node;         /* current and created trie nodes    */
+set_c_ptr_type *tail;                  /* link to element's cell            */
+unsigned int bit;                      /* element's slot in current node    */
+int depth;                             /* depth of current node             */
+int entries;                           /* entries in current node           */
+int position;                          /* position of slot's entry          */
+int is_equal;                          /* YES if two specifiers are equal   */
 int i;                                 /* temporary looping variable        */
-int shift_distance;                    /* distance leaf hash codes must     */
-                                       /* be shifted, a function of depth   */
 
-   /*
-    *  Set up to loop over the source set, producing one leaf node at a
-    *  time.
-    */
+   /* an empty trie gets a node with a single empty slot */
 
-   source_leaf = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_root->s_ntype.s_root.s_height++;
-   source_index = 0;
-   shift_distance = source_height * SET_SHIFT_DIST;
+   if (*node_ptr == NULL) {
 
-   /* loop over the nodes of source */
+      new_node = get_trie_node(SETL_SYSTEM 1,cell_size);
+      new_node->s_datamap = set_hash_bit(hash_code,0);
+      new_node->s_nodemap = 0;
+      new_node->s_entry[0].s_cell = NULL;
+      *node_ptr = new_node;
 
-   for (;;) {
+      return &(new_node->s_entry[0].s_cell);
 
-      /* descend to a leaf */
+   }
 
-      while (source_height) {
+   for (depth = 0;; depth++) {
 
-         /* move down if possible */
+      node = *node_ptr;
+      if (node->s_use_count != 1)
+         node = unshare_trie_node(SETL_SYSTEM node_ptr);
+      bit = set_hash_bit(hash_code,depth);
 
-         if (source_index < SET_HASH_SIZE) {
+      /* if the slot holds a subtrie, move down */
 
-            /* skip over null nodes */
+      if (node->s_nodemap & bit) {
 
-            if (source_leaf->s_child[source_index].s_header == NULL) {
+         node_ptr = &(node->s_entry[node_position(node,bit)].s_node);
+         continue;
 
-               source_index++;
-               continue;
+      }
 
-            }
+      /* if the slot is empty, copy the node adding an entry for it */
 
-            /* we can move down, so do so */
+      if (!(node->s_datamap & bit)) {
 
-            source_leaf =
-               source_leaf->s_child[source_index].s_header;
-            source_index = 0;
-            source_height--;
+         entries = set_node_entries(node);
+         position = data_position(node,bit);
+         new_node = get_trie_node(SETL_SYSTEM entries + 1,cell_size);
+         new_node->s_datamap = node->s_datamap | bit;
+         new_node->s_nodemap = node->s_nodemap;
 
-            continue;
+         for (i = 0; i < position; i++)
+            new_node->s_entry[i] = node->s_entry[i];
+         new_node->s_entry[position].s_cell = NULL;
+         for (; i < entries; i++)
+            new_node->s_entry[i + 1] = node->s_entry[i];
 
-         }
+         free_set_node(node,entries);
+         *node_ptr = new_node;
 
-         /* if there are no more elements, break */
+         return &(new_node->s_entry[position].s_cell);
 
-         if (source_leaf == source_root) {
+      }
 
-            source_leaf = NULL;
-            break;
+      /* if the slot holds our hash code, search its cells */
 
-         }
+      position = data_position(node,bit);
+      tail = &(node->s_entry[position].s_cell);
 
-         /* move up if we're at the end of a node */
+      if ((*tail)->s_hash_code == hash_code) {
 
-         source_height++;
-         source_index =
-               source_leaf->s_ntype.s_intern.s_child_index + 1;
-         source_leaf =
-            source_leaf->s_ntype.s_intern.s_parent;
+         for (; *tail != NULL; tail = &((*tail)->s_next)) {
 
-         continue;
+            spec_equal(is_equal,&((*tail)->s_spec),element);
+            if (is_equal)
+               break;
 
-      }
+         }
 
-      /* break if we can't find a leaf */
+         return tail;
 
-      if (source_leaf == NULL)
-         break;
+      }
 
       /*
-       *  At this point we have a leaf which must be split.  We create a
-       *  new header node, then loop over the source copying the clash
-       *  lists.
+       *  The slot holds cells with some other hash code.  We push them
+       *  down into a new subtrie, converting the slot's data entry into
+       *  a subtrie entry in place, and continue the search there.
        */
 
-      get_set_header(target_subtree);
-      memcpy((void *)target_subtree,
-             (void *)source_leaf,
-             sizeof(struct set_h_item));
+      new_node = get_trie_node(SETL_SYSTEM 1,cell_size);
+      new_node->s_datamap = set_hash_bit((*tail)->s_hash_code,depth + 1);
+      new_node->s_nodemap = 0;
+      new_node->s_entry[0].s_cell = *tail;
+
+      entries = set_node_entries(node);
+      for (i = position; i < entries - 1; i++)
+         node->s_entry[i] = node->s_entry[i + 1];
+      node->s_datamap ^= bit;
+
+      position = node_position(node,bit);
+      for (i = entries - 1; i > position; i--)
+         node->s_entry[i] = node->s_entry[i - 1];
+      node->s_entry[position].s_node = new_node;
+      node->s_nodemap |= bit;
+
+      node_ptr = &(node->s_entry[position].s_node);
+
+   }
+}
+
+/*\
+ *  \function{table\_to\_trie()}
+ *
+ *  This function replaces a full small table by a hash trie, moving
+ *  each table cell into a cell of its own.
+\*/
+
+static void table_to_trie(
+   SETL_SYSTEM_PROTO
+   set_n_ptr_type *node_ptr)           /* pointer to root of trie           */
+
+{
+set_t_ptr_type table;                  /* table to be replaced              */
+set_c_ptr_type new_cell;               /* created cell node                 */
+int i;                                 /* temporary looping variable        */
 
-      for (i = 0;
-           i < SET_HASH_SIZE;
-           target_subtree->s_child[i++].s_header = NULL);
+   table = (set_t_ptr_type)*node_ptr;
+   *node_ptr = NULL;
 
-      for (source_index = 0; source_index < SET_HASH_SIZE; source_index++) {
+   for (i = 0; i < table->s_count; i++) {
 
-         source_cell = source_leaf->s_child[source_index].s_cell;
-         while (source_cell != NULL) {
+      new_cell = get_trie_cell(SETL_SYSTEM table->s_cell_size);
+      memcpy((void *)((char *)new_cell + SET_CELL_OFFSET),
+             (void *)((char *)set_table_cell(table,i) + SET_CELL_OFFSET),
+             (size_t)(table->s_cell_size - SET_CELL_OFFSET));
+      new_cell->s_next = NULL;
+      *trie_locate(SETL_SYSTEM node_ptr,
+                   &(new_cell->s_spec),
+                   new_cell->s_hash_code,
+                   table->s_cell_size) = new_cell;
 
-            work_hash_code = (source_cell->s_hash_code >> shift_distance);
+   }
 
-            target_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code = work_hash_code >> SET_SHIFT_DIST;
+   free_set_table(table);
 
-            /* if we're missing a header record, insert it */
+}
 
-            if (target_subtree->s_child[target_index].s_header == NULL) {
+/*\
+ *  \function{set\_locate()}
+ *
+ *  This function finds an element in a hash trie, adding a cell for it
+ *  if it is not there, and tells the caller which happened.  A new cell
+ *  has only the given hash code, and the caller {\em must} fill in the
+ *  rest before the trie is used again.  The cell remains valid only
+ *  until the trie is next changed.  Map cells begin with the same fields
+ *  as set cells, so we also use this function to add domain elements to
+ *  maps.  The cell size tells us which kind of cell to create.
+ *
+ *  A small table which grows is copied into a table one cell larger,
+ *  until it is full, and then replaced by a trie.
+\*/
 
-               get_set_header(target_work_hdr);
-               target_work_hdr->s_ntype.s_intern.s_parent =
-                     target_subtree;
-               target_work_hdr->s_ntype.s_intern.s_child_index =
-                     target_index;
-               for (i = 0;
-                    i < SET_HASH_SIZE;
-                    target_work_hdr->s_child[i++].s_cell = NULL);
-               target_subtree->s_child[target_index].s_header =
-                     target_work_hdr;
+set_c_ptr_type set_locate(
+   SETL_SYSTEM_PROTO
+   set_n_ptr_type *node_ptr,           /* pointer to root of trie           */
+   specifier *element,                 /* element to be found               */
+   int32 hash_code,                    /* hash code of element              */
+   int cell_size,                      /* size of set or map cell           */
+   int *is_new)                        /* set to YES if we added a cell     */
 
-            }
-            else {
+{
+set_t_ptr_type table, new_table;       /* old and new small tables          */
+set_c_ptr_type cell;                   /* element's cell                    */
+set_c_ptr_type *tail;                  /* link to element's cell            */
+int count;                             /* cells in old table                */
 
-               target_work_hdr =
-                  target_subtree->s_child[target_index].s_header;
+   /* an empty trie starts as a table */
 
-            }
+   if (*node_ptr == NULL) {
 
-            /* search the clash list for the correct position */
+      new_table = get_set_table(SETL_SYSTEM 1,cell_size);
+      *node_ptr = (set_n_ptr_type)new_table;
+      cell = set_table_cell(new_table,0);
+      cell->s_hash_code = hash_code;
+      *is_new = YES;
 
-            target_index = work_hash_code & SET_HASH_MASK;
-            target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-            for (target_cell = *target_tail;
-                 target_cell != NULL &&
-                    target_cell->s_hash_code < source_cell->s_hash_code;
-                 target_cell = target_cell->s_next) {
+      return cell;
 
-               target_tail = &(target_cell->s_next);
+   }
 
-            }
+   if (set_is_table(*node_ptr)) {
 
-            /* shift the source cell to the new subtree */
+      table = (set_t_ptr_type)unshare_trie_node(SETL_SYSTEM node_ptr);
+      cell = set_lookup(SETL_SYSTEM *node_ptr,element,hash_code);
+      if (cell != NULL) {
 
-            target_cell = source_cell;
-            source_cell = source_cell->s_next;
-            target_cell->s_next = *target_tail;
-            *target_tail = target_cell;
+         *is_new = NO;
+         return cell;
 
-         }
       }
 
-      /* if the leaf is the root, we're done */
+      count = table->s_count;
+
+      /* if there is room, copy the table adding the element at the end */
+
+      if (count < SET_TABLE_SIZE) {
 
-      if (source_leaf == source_root) {
+         new_table = get_set_table(SETL_SYSTEM count + 1,cell_size);
+         memcpy((void *)(new_table + 1),
+                (void *)(table + 1),
+                (size_t)count * (cell_size - SET_CELL_OFFSET));
+         free_set_table(table);
+         *node_ptr = (set_n_ptr_type)new_table;
+         cell = set_table_cell(new_table,count);
+         cell->s_hash_code = hash_code;
+         *is_new = YES;
 
-         free_set_header(source_root);
-         return target_subtree;
+         return cell;
 
       }
 
-      /* set up to find the next leaf, by moving to the parent */
+      table_to_trie(SETL_SYSTEM node_ptr);
 
-      source_height++;
-      source_index =
-            source_leaf->s_ntype.s_intern.s_child_index;
-      source_leaf =
-         source_leaf->s_ntype.s_intern.s_parent;
-      free_set_header(source_leaf->s_child[source_index].s_header);
-      source_leaf->s_child[source_index].s_header = target_subtree;
-      source_index++;
+   }
+
+   tail = trie_locate(SETL_SYSTEM node_ptr,element,hash_code,cell_size);
+   if (*tail != NULL) {
+
+      *is_new = NO;
+      return *tail;
 
    }
 
-   /* if we break without returning, return the original root */
+   cell = get_trie_cell(SETL_SYSTEM cell_size);
+   cell->s_next = NULL;
+   cell->s_hash_code = hash_code;
+   *tail = cell;
+   *is_new = YES;
 
-   return source_root;
+   return cell;
 
 }
 
 /*\
- *  \function{contract\_set\_header()}
+ *  \function{table\_unlink()}
  *
- *  This function subtracts one level from the height of a set header
- *  tree.  It should be called when the average length of the clash
- *  lists for a tree with smaller height is no more than one.  We loop
- *  over the lowest level internal nodes of the source tree, collapsing
- *  each such node.
+ *  This function removes an element from a small table, which is copied
+ *  into a table one cell smaller.  The caller will release the cell it
+ *  gets back, so we move the element into a cell of its own.
 \*/
 
-set_h_ptr_type set_contract_header(
+static set_c_ptr_type table_unlink(
    SETL_SYSTEM_PROTO
-   set_h_ptr_type source_root)         /* set to be contracted              */
+   set_n_ptr_type *node_ptr,           /* pointer to table                  */
+   specifier *element,                 /* element to be removed             */
+   int32 hash_code)                    /* hash code of element              */
 
 {
-set_h_ptr_type source_subtree;         /* internal node pointer             */
-set_h_ptr_type source_leaf;            /* leaf node                         */
-set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type target_leaf;            /* target leaf node                  */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int i;                                 /* temporary looping variable        */
-
-   /*
-    *  Set up to loop over the source set, producing one bottom level node
-    *  at a time.
-    */
-
-   /* TOTO */
-   
-   
-   if (source_root->s_ntype.s_root.s_height==0) 
-   		return source_root;
+set_t_ptr_type table, new_table;       /* old and new small tables          */
+set_c_ptr_type cell;                   /* removed cell                      */
+size_t width;                          /* size of each table entry          */
+int count;                             /* cells in old table                */
+int i;                                 /* position of element in table      */
 
-   source_subtree = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_root->s_ntype.s_root.s_height--;
-   
-   source_index = 0;
+   table = (set_t_ptr_type)*node_ptr;
+   count = table->s_count;
 
-   /* loop over the nodes of source */
+   cell = set_lookup(SETL_SYSTEM *node_ptr,element,hash_code);
+   if (cell == NULL)
+      return NULL;
 
-   for (;;) {
+   width = (size_t)(table->s_cell_size - SET_CELL_OFFSET);
+   i = (int)(((char *)cell - (char *)set_table_cell(table,0)) / width);
+   table = (set_t_ptr_type)unshare_trie_node(SETL_SYSTEM node_ptr);
 
-      /* descend to a leaf */
+   cell = get_trie_cell(SETL_SYSTEM table->s_cell_size);
+   memcpy((void *)((char *)cell + SET_CELL_OFFSET),
+          (void *)((char *)set_table_cell(table,i) + SET_CELL_OFFSET),
+          width);
+   cell->s_next = NULL;
 
-      while (source_height > 1) {
+   if (count == 1) {
 
-         /* move down if possible */
+      *node_ptr = NULL;
 
-         if (source_index < SET_HASH_SIZE) {
+   }
+   else {
 
-            /* skip over null nodes */
+      new_table = get_set_table(SETL_SYSTEM count - 1,table->s_cell_size);
+      memcpy((void *)(new_table + 1),
+             (void *)(table + 1),
+             (size_t)i * width);
+      memcpy((void *)((char *)(new_table + 1) + (size_t)i * width),
+             (void *)((char *)(table + 1) + (size_t)(i + 1) * width),
+             (size_t)(count - i - 1) * width);
+      *node_ptr = (set_n_ptr_type)new_table;
 
-            if (source_subtree->s_child[source_index].s_header == NULL) {
+   }
 
-               source_index++;
-               continue;
+   free_set_table(table);
 
-            }
+   return cell;
 
-            /* we can move down, so do so */
+}
 
-            source_subtree =
-               source_subtree->s_child[source_index].s_header;
-            source_index = 0;
-            source_height--;
+/*\
+ *  \function{set\_unlink()}
+ *
+ *  This function removes an element from a hash trie, returning the
+ *  cell which held it, or \verb"NULL" if the element is not in the trie.
+ *  The caller is responsible for the cell and its specifiers.  Nodes
+ *  on the path are unshared on the way down.
+ *
+ *  We keep the trie compact: a node which is left empty is released,
+ *  and a subtrie which is left holding a single cell list is pulled up
+ *  into its parent.  We do not turn a trie back into a small table.
+\*/
 
-            continue;
+set_c_ptr_type set_unlink(
+   SETL_SYSTEM_PROTO
+   set_n_ptr_type *node_ptr,           /* pointer to root of trie           */
+   specifier *element,                 /* element to be removed             */
+   int32 hash_code)                    /* hash code of element              */
 
-         }
+{
+set_n_ptr_type *path[SET_MAX_DEPTH];   /* links to nodes on search path     */
+set_n_ptr_type node, new_node;         /* current and created trie nodes    */
+set_n_ptr_type parent;                 /* parent of current node            */
+set_c_ptr_type cell;                   /* removed cell                      */
+set_c_ptr_type *tail;                  /* link to element's cell            */
+unsigned int bit;                      /* element's slot in current node    */
+int depth;                             /* depth of current node             */
+int entries;                           /* entries in current node           */
+int position;                          /* position of slot's entry          */
+int data_pos;                          /* position of pulled up cell list   */
+int is_equal;                          /* YES if two specifiers are equal   */
+int i;                                 /* temporary looping variable        */
 
-         /* if there are no more elements, break */
+   if (*node_ptr != NULL && set_is_table(*node_ptr))
+      return table_unlink(SETL_SYSTEM node_ptr,element,hash_code);
 
-         if (source_subtree == source_root) {
+   /* find the element's slot, remembering the path */
 
-            source_subtree = NULL;
-            break;
+   for (depth = 0;; depth++) {
 
-         }
+      node = *node_ptr;
+      if (node == NULL)
+         return NULL;
 
-         /* move up if we're at the end of a node */
+      if (node->s_use_count != 1)
+         node = unshare_trie_node(SETL_SYSTEM node_ptr);
+      path[depth] = node_ptr;
+      bit = set_hash_bit(hash_code,depth);
 
-         source_height++;
-         source_index =
-               source_subtree->s_ntype.s_intern.s_child_index + 1;
-         source_subtree =
-            source_subtree->s_ntype.s_intern.s_parent;
+      if (node->s_nodemap & bit) {
 
+         node_ptr = &(node->s_entry[node_position(node,bit)].s_node);
          continue;
 
       }
 
-      /* break if we can't find a leaf */
+      if (!(node->s_datamap & bit))
+         return NULL;
+
+      break;
+
+   }
+
+   /* search the cells in the slot */
+
+   position = data_position(node,bit);
+   tail = &(node->s_entry[position].s_cell);
+   if ((*tail)->s_hash_code != hash_code)
+      return NULL;
+
+   for (; *tail != NULL; tail = &((*tail)->s_next)) {
 
-      if (source_subtree == NULL)
+      spec_equal(is_equal,&((*tail)->s_spec),element);
+      if (is_equal)
          break;
 
-      /*
-       *  At this point we have a leaf which must be collapsed.  We
-       *  create a new header node, then merge clash lists from the
-       *  source node into the target node.
-       */
+   }
 
-      get_set_header(target_leaf);
-      memcpy((void *)target_leaf,
-             (void *)source_subtree,
-             sizeof(struct set_h_item));
+   if (*tail == NULL)
+      return NULL;
 
-      for (i = 0;
-           i < SET_HASH_SIZE;
-           target_leaf->s_child[i++].s_header = NULL);
+   cell = *tail;
+   *tail = cell->s_next;
 
-      /* merge the clash lists of each leaf node */
+   /* if other cells share the slot, we're done */
 
-      for (source_index = 0; source_index < SET_HASH_SIZE; source_index++) {
+   if (node->s_entry[position].s_cell != NULL)
+      return cell;
 
-         source_leaf = source_subtree->s_child[source_index].s_header;
-         if (source_leaf == NULL)
-            continue;
+   /* otherwise we remove the slot's entry */
 
-         /* merge the clash lists of the current leaf into one target list */
+   entries = set_node_entries(node);
+   if (entries == 1) {
 
-         for (i = 0; i < SET_HASH_SIZE; i++) {
+      free_set_node(node,1);
+      *node_ptr = NULL;
 
-            target_tail = &(target_leaf->s_child[source_index].s_cell);
-            target_cell = *target_tail;
+   }
+   else {
 
-            source_cell = source_leaf->s_child[i].s_cell;
-            while (source_cell != NULL) {
+      new_node = get_trie_node(SETL_SYSTEM entries - 1,node->s_cell_size);
+      new_node->s_datamap = node->s_datamap ^ bit;
+      new_node->s_nodemap = node->s_nodemap;
+      for (i = 0; i < position; i++)
+         new_node->s_entry[i] = node->s_entry[i];
+      for (i++; i < entries; i++)
+         new_node->s_entry[i - 1] = node->s_entry[i];
 
-               /* search the clash list for the correct position */
+      free_set_node(node,entries);
+      *node_ptr = new_node;
 
-               while (target_cell != NULL &&
-                      target_cell->s_hash_code < source_cell->s_hash_code) {
+   }
 
-                  target_tail = &(target_cell->s_next);
-                  target_cell = target_cell->s_next;
+   /*
+    *  Now we move back up the path.  An empty subtrie is removed from
+    *  its parent, and a subtrie holding a single cell list is replaced
+    *  by that list.
+    */
 
-               }
+   for (; depth > 0; depth--) {
 
-               /* shift the source cell to the new subtree */
+      node = *path[depth];
+      parent = *path[depth - 1];
+      bit = set_hash_bit(hash_code,depth - 1);
+      position = node_position(parent,bit);
+      entries = set_node_entries(parent);
 
-               target_cell = source_cell;
-               source_cell = source_cell->s_next;
-               target_cell->s_next = *target_tail;
-               *target_tail = target_cell;
-               target_tail = &(target_cell->s_next);
+      if (node == NULL) {
 
-            }
-         }
+         if (entries == 1) {
 
-         free_set_header(source_leaf);
+            free_set_node(parent,1);
+            *path[depth - 1] = NULL;
+            continue;
 
-      }
+         }
 
-      /* if the subtree is the root, we're done */
+         new_node = get_trie_node(SETL_SYSTEM entries - 1,
+                                  parent->s_cell_size);
+         new_node->s_datamap = parent->s_datamap;
+         new_node->s_nodemap = parent->s_nodemap ^ bit;
+         for (i = 0; i < position; i++)
+            new_node->s_entry[i] = parent->s_entry[i];
+         for (i++; i < entries; i++)
+            new_node->s_entry[i - 1] = parent->s_entry[i];
 
-      if (source_subtree == source_root) {
+         free_set_node(parent,entries);
+         *path[depth - 1] = new_node;
 
-         free_set_header(source_root);
-         return target_leaf;
+         continue;
 
       }
 
-      /* set up to find the next leaf, by moving to the parent */
+      if (node->s_nodemap != 0 || set_bit_count(node->s_datamap) != 1)
+         break;
+
+      /* pull the cell list up, converting the entry in place */
 
-      source_height++;
-      source_index =
-            source_subtree->s_ntype.s_intern.s_child_index;
-      source_subtree =
-         source_subtree->s_ntype.s_intern.s_parent;
-      free_set_header(source_subtree->s_child[source_index].s_header);
-      source_subtree->s_child[source_index].s_header = target_leaf;
-      source_index++;
+      data_pos = data_position(parent,bit);
+      for (i = position; i > data_pos; i--)
+         parent->s_entry[i] = parent->s_entry[i - 1];
+      parent->s_entry[data_pos].s_cell = node->s_entry[0].s_cell;
+      parent->s_nodemap ^= bit;
+      parent->s_datamap |= bit;
 
-   }
+      free_set_node(node,1);
 
-   /* if we break without returning, return the original root */
+   }
 
-   return source_root;
+   return cell;
 
 }
 
 /*\
- *  \function{set\_union()}
+ *  \function{set\_update()}
  *
- *  This function forms the union of two sets.
+ *  This function finds an element which the caller intends to change in
+ *  place, returning \verb"NULL" if the element is not in the trie.  We
+ *  look first, so a trie which does not hold the element is not copied,
+ *  then unshare the path to the element's cell.
 \*/
 
-void set_union(
+set_c_ptr_type set_update(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* target of union operation         */
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
+   set_n_ptr_type *node_ptr,           /* pointer to root of trie           */
+   specifier *element,                 /* element to be found               */
+   int32 hash_code)                    /* hash code of element              */
 
 {
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int target_height, target_index;       /* current height and index          */
-specifier *target_element;             /* set element                       */
-int32 target_hash_code;                /* hash code of target element       */
-set_h_ptr_type new_hdr;                /* created header node               */
-set_c_ptr_type new_cell;               /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int is_equal;                          /* YES if two specifiers are equal   */
-int i;                                 /* temporary looping variable        */
+int is_new;                            /* YES if we added a cell            */
 
-   /*
-    *  First we set up source and target sets.  We would like to
-    *  destructively use one of the sets if possible.
-    */
+   if (set_lookup(SETL_SYSTEM *node_ptr,element,hash_code) == NULL)
+      return NULL;
 
+   return set_locate(SETL_SYSTEM node_ptr,element,hash_code,
+                     (*node_ptr)->s_cell_size,&is_new);
 
-   if (target == left && target != right &&
-       ((target->sp_val.sp_set_ptr)->s_use_count == 1)) {
-         
-      target_root = target->sp_val.sp_set_ptr;
-      target->sp_form = ft_omega;
-      source_root = right->sp_val.sp_set_ptr;
+}
 
-   }
-   else if (target == right && target != left &&
-            ((target->sp_val.sp_set_ptr)->s_use_count == 1)) {
+/*\
+ *  \function{set\_cursor\_start()}
+ *
+ *  This function starts an iteration over the cells of a hash trie.  We
+ *  keep an explicit stack of the nodes on the path to the current cell,
+ *  so nodes need no parent pointers.
+\*/
 
-      target_root = target->sp_val.sp_set_ptr;
-      target->sp_form = ft_omega;
-      source_root = left->sp_val.sp_set_ptr;
+void set_cursor_start(
+   struct set_cursor_item *cursor,     /* cursor to be initialized          */
+   set_n_ptr_type trie)                /* root of trie                      */
 
-   }
-   else {
+{
 
-      /* we can not use a set destructively, so pick the biggest */
-
-      if ((right->sp_val.sp_set_ptr)->s_ntype.s_root.s_cardinality >
-          (left->sp_val.sp_set_ptr)->s_ntype.s_root.s_cardinality) {
+   cursor->sc_cell = NULL;
 
-         target_root = copy_set(SETL_SYSTEM right->sp_val.sp_set_ptr);
-         source_root = left->sp_val.sp_set_ptr;
-
-      }
-      else {
+   if (trie == NULL) {
 
-         target_root = copy_set(SETL_SYSTEM left->sp_val.sp_set_ptr);
-         source_root = right->sp_val.sp_set_ptr;
+      cursor->sc_depth = -1;
+      return;
 
-      }
    }
 
-   /* we may have to expand the size of the header, so find the trigger */
-
-   expansion_trigger = (1 << ((target_root->s_ntype.s_root.s_height + 1)
-                              * SET_SHIFT_DIST)) * SET_CLASH_SIZE;
-
-   /*
-    *  We loop over the source set producing one element at a time.
-    */
-
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
-
-   /* loop over the elements of source */
-
-   for (;;) {
-
-      /* find the next element in the set */
+   cursor->sc_depth = 0;
+   cursor->sc_node[0] = trie;
+   cursor->sc_index[0] = 0;
 
-      target_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, break */
-
-         if (source_cell != NULL) {
-
-            target_element = &(source_cell->s_spec);
-            target_hash_code = source_cell->s_hash_code;
-            source_cell = source_cell->s_next;
-            break;
-
-         }
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < SET_HASH_SIZE) {
-
-            source_cell = source_work_hdr->s_child[source_index].s_cell;
-            source_index++;
-            continue;
-
-         }
+   return;
 
-         /* the current header node is exhausted -- find the next one */
+}
 
-         /* move up if we're at the end of a node */
+/*\
+ *  \function{set\_cursor\_next()}
+ *
+ *  This function returns the next cell in an iteration over a hash
+ *  trie, or \verb"NULL" when the iteration is finished.  We visit the
+ *  cell lists of each node before its subtries.  The cell returned may
+ *  be shared with other sets, so the caller must not change it.
+\*/
 
-         if (source_index >= SET_HASH_SIZE) {
+set_c_ptr_type set_cursor_next(
+   struct set_cursor_item *cursor)     /* iteration cursor                  */
 
-            /* there are not more elements, so break */
+{
+set_n_ptr_type node;                   /* current trie node                 */
+set_c_ptr_type cell;                   /* returned cell                     */
+int depth;                             /* depth of current node             */
+int index;                             /* next entry in current node        */
+int data_count;                        /* number of cell lists in node      */
 
-            if (source_work_hdr == source_root)
-               break;
+   /* continue any cell list in progress */
 
-            /* otherwise move up */
+   if ((cell = cursor->sc_cell) != NULL) {
 
-            source_height++;
-            source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
+      cursor->sc_cell = cell->s_next;
+      return cell;
 
-         }
+   }
 
-         /* skip over null nodes */
+   for (depth = cursor->sc_depth; depth >= 0;) {
 
-         if (source_work_hdr->s_child[source_index].s_header == NULL) {
+      node = cursor->sc_node[depth];
+      index = cursor->sc_index[depth]++;
 
-            source_index++;
-            continue;
+      /* a small table can only be the root */
 
-         }
+      if (set_is_table(node)) {
 
-         /* otherwise drop down a level */
+         if (index < ((set_t_ptr_type)node)->s_count)
+            return set_table_cell((set_t_ptr_type)node,index);
 
-         source_work_hdr =
-            source_work_hdr->s_child[source_index].s_header;
-         source_index = 0;
-         source_height--;
+         break;
 
       }
 
-      /* if we've exhausted a set break again */
+      data_count = set_bit_count(node->s_datamap);
 
-      if (target_element == NULL)
-         break;
-
-      /*
-       *  At this point we have an element we would like to insert into
-       *  the target.
-       */
+      /* start the next cell list */
 
-      target_work_hdr = target_root;
+      if (index < data_count) {
 
-      /* get the element's hash code */
+         cell = node->s_entry[index].s_cell;
+         cursor->sc_cell = cell->s_next;
+         cursor->sc_depth = depth;
+         return cell;
 
-      work_hash_code = target_hash_code;
+      }
 
-      /* descend the header tree until we get to a leaf */
+      /* move down into the next subtrie */
 
-      target_height = target_root->s_ntype.s_root.s_height;
-      while (target_height--) {
+      if (index < data_count + set_bit_count(node->s_nodemap)) {
 
-         /* extract the element's index at this level */
+         depth++;
+         cursor->sc_node[depth] = node->s_entry[index].s_node;
+         cursor->sc_index[depth] = 0;
+         continue;
 
-         target_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
+      }
 
-         /* if we're missing a header record, insert it */
+      /* this node is finished, so move up */
 
-         if (target_work_hdr->s_child[target_index].s_header == NULL) {
+      depth--;
 
-            get_set_header(new_hdr);
-            new_hdr->s_ntype.s_intern.s_parent = target_work_hdr;
-            new_hdr->s_ntype.s_intern.s_child_index = target_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_hdr->s_child[i++].s_cell = NULL);
-            target_work_hdr->s_child[target_index].s_header = new_hdr;
-            target_work_hdr = new_hdr;
+   }
 
-         }
-         else {
+   cursor->sc_depth = -1;
+   return NULL;
 
-            target_work_hdr =
-               target_work_hdr->s_child[target_index].s_header;
+}
 
-         }
-      }
+/*\
+ *  \function{free\_set\_trie()}
+ *
+ *  This function releases one use of a hash trie.  When the last use
+ *  is gone we leave the trie on the release stack, which frees it.
+\*/
 
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  The next problem is to determine if the element is
-       *  already in the set.  We compare the element with the clash
-       *  list.
-       */
+static void free_set_trie(
+   SETL_SYSTEM_PROTO
+   set_n_ptr_type node)                /* trie to be deleted                */
 
-      target_index = work_hash_code & SET_HASH_MASK;
-      target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-      for (target_cell = *target_tail;
-           target_cell != NULL &&
-              target_cell->s_hash_code < target_hash_code;
-           target_cell = target_cell->s_next) {
+{
 
-         target_tail = &(target_cell->s_next);
+   if (--node->s_use_count > 0)
+      return;
 
-      }
+   free_later(SETL_SYSTEM FREE_SET_TRIE,(void *)node);
 
-      /* check for a duplicate element */
+}
 
-      is_equal = NO;
-      while (target_cell != NULL &&
-             target_cell->s_hash_code == target_hash_code) {
+/*\
+ *  \function{release\_set\_trie()}
+ *
+ *  This function is called from the release stack to free a trie node
+ *  nothing else uses, with the cells and elements it holds.  It
+ *  releases the subtries it points to, which leaves them on the stack
+ *  rather than recursing, and charges the elements against
+ *  \verb"*budget".
+\*/
 
-         spec_equal(is_equal,&(target_cell->s_spec),target_element);
+void release_set_trie(
+   SETL_SYSTEM_PROTO
+   set_n_ptr_type node,                /* trie to be deleted                */
+   int32 *budget)                      /* elements we may release           */
 
-         if (is_equal)
-            break;
+{
+set_c_ptr_type t1,t2;                  /* used to loop over cell list       */
+                                       /* deleting cells                    */
+int data_count;                        /* number of cell lists in node      */
+int entries;                           /* number of entries in node         */
+int i;                                 /* temporary looping variable        */
 
-         target_tail = &(target_cell->s_next);
-         target_cell = target_cell->s_next;
+   if (set_is_table(node)) {
 
-      }
+      for (i = 0; i < ((set_t_ptr_type)node)->s_count; i++)
+         unmark_specifier(&(set_table_cell((set_t_ptr_type)node,i)->s_spec));
 
-      /* if we found the element, continue */
+      *budget -= i;
+      free_set_table((set_t_ptr_type)node);
 
-      if (is_equal)
-         continue;
+      return;
 
-      /* if we reach this point we didn't find the element, so we insert it */
+   }
 
-      get_set_cell(new_cell);
-      mark_specifier(target_element);
-      new_cell->s_spec.sp_form = target_element->sp_form;
-      new_cell->s_spec.sp_val.sp_biggest =
-         target_element->sp_val.sp_biggest;
-      new_cell->s_hash_code = target_hash_code;
-      new_cell->s_next = *target_tail;
-      *target_tail = new_cell;
-      target_root->s_ntype.s_root.s_cardinality++;
-      target_root->s_hash_code ^= target_hash_code;
+   data_count = set_bit_count(node->s_datamap);
+   entries = set_node_entries(node);
 
-      /* expand the set header if necessary */
+   for (i = 0; i < data_count; i++) {
 
-      if (target_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
+      t1 = node->s_entry[i].s_cell;
+      while (t1 != NULL) {
 
-         target_root = set_expand_header(SETL_SYSTEM target_root);
-         expansion_trigger *= SET_HASH_SIZE;
+         t2 = t1;
+         t1 = t1->s_next;
+         unmark_specifier(&(t2->s_spec));
+         free_set_cell(t2);
+         (*budget)--;
 
       }
    }
 
-   /* finally, set the target value */
-
-   unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = target_root;
+   for (; i < entries; i++)
+      free_set_trie(SETL_SYSTEM node->s_entry[i].s_node);
 
-   return;
+   free_set_node(node,entries);
+   (*budget)--;
 
 }
 
 /*\
- *  \function{set\_difference()}
+ *  \function{free\_set()}
  *
- *  This function forms the set difference for two sets.
+ *  This function frees the memory used by an entire set structure.
 \*/
 
-void set_difference(
+void free_set(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* target of union operation         */
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
+   set_h_ptr_type root)                /* set to be deleted                 */
 
 {
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int target_height, target_index;       /* current height and index          */
-specifier *target_element;             /* set element                       */
-int32 target_hash_code;                /* hash code of target element       */
-int32 contraction_trigger;             /* cardinality which triggers        */
-                                       /* header contraction                */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int is_equal;                          /* YES if two specifiers are equal   */
 
-   /*
-    *  First we set up a target set.  We would like to use the left
-    *  operand destructively if possible.
-    */
+   if (root->s_trie != NULL)
+      free_set_trie(SETL_SYSTEM root->s_trie);
 
-   if (target == left && target != right &&
-       (target->sp_val.sp_set_ptr)->s_use_count == 1) {
+   free_set_header(root);
 
-      target_root = target->sp_val.sp_set_ptr;
-      target->sp_form = ft_omega;
+}
 
-   }
-   else {
+set_h_ptr_type null_set(
+   SETL_SYSTEM_PROTO_VOID)
 
-      target_root = copy_set(SETL_SYSTEM left->sp_val.sp_set_ptr);
+{
+set_h_ptr_type target_root;            /* root of new set                   */
 
-   }
+   get_set_header(target_root);
+   target_root->s_use_count = 1;
+   target_root->s_hash_code = 0;
+   target_root->s_cardinality = 0;
+   target_root->s_trie = NULL;
 
-   source_root = right->sp_val.sp_set_ptr;
+   return target_root;
+}
 
-   /*
-    *  We loop over the source set producing one element at a time.
-    */
+/*\
+ *  \function{copy\_set()}
+ *
+ *  This function copies an entire set structure.  The copy shares the
+ *  trie of the original, which is unshared a path at a time as either
+ *  set changes.
+\*/
 
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
+set_h_ptr_type copy_set(
+   SETL_SYSTEM_PROTO
+   set_h_ptr_type source_root)         /* set to be copied                  */
 
-   /* we may have to compress the header, so find the trigger */
+{
+set_h_ptr_type target_root;            /* root of new set                   */
 
-   contraction_trigger = (1 << ((target_root->s_ntype.s_root.s_height)
-                                 * SET_SHIFT_DIST));
-   if (contraction_trigger == 1)
-      contraction_trigger = 0;
+#ifdef DEBUG
+#ifdef HAVE_GETRUSAGE
+struct timeval start;                   /* structure to fill                 */
+struct timeval stop;                    /* structure to fill                 */
+struct timezone tz;
+#endif
 
-   /* loop over the elements of source */
+   if (PROF_DEBUG) {
+#ifdef HAVE_GETRUSAGE
+   gettimeofday(&start,&tz);
+#endif
+      if (profi!=NULL) profi->copies++;
+      copy_operations[OPCODE_EXECUTED]++;
+   }
+   if ((TRACING_ON)&&(TRACE_COPIES))
+      fprintf(DEBUG_FILE,"*COPY_SET*\n");
+#endif
 
-   for (;;) {
+   /* allocate a new root header node */
 
-      /* find the next element in the set */
+   get_set_header(target_root);
+   target_root->s_use_count = 1;
+   target_root->s_hash_code = source_root->s_hash_code;
+   target_root->s_cardinality = source_root->s_cardinality;
 
-      target_element = NULL;
-      for (;;) {
+   target_root->s_trie = source_root->s_trie;
+   if (target_root->s_trie != NULL)
+      target_root->s_trie->s_use_count++;
 
-         /* if we have an element already, break */
+#ifdef DEBUG
+#ifdef HAVE_GETRUSAGE
+   if (profi!=NULL) {
+      gettimeofday(&stop,&tz);
+      profi->timec.tv_sec +=(stop.tv_sec-start.tv_sec);
+      profi->timec.tv_usec+=(stop.tv_usec-start.tv_usec);
+      while (profi->timec.tv_usec<0) {
+         profi->timec.tv_sec--;
+         profi->timec.tv_usec+=1000000;
+      }
+      while (profi->timec.tv_usec>=1000000) {
+         profi->timec.tv_sec++;
+         profi->timec.tv_usec-=1000000;
+      }
+   }
+#endif
+#endif
+   return target_root;
 
-         if (source_cell != NULL) {
+}
 
-            target_element = &(source_cell->s_spec);
-            target_hash_code = source_cell->s_hash_code;
-            source_cell = source_cell->s_next;
-            break;
+/*\
+ *  \function{set\_insert()}
+ *
+ *  This function adds an element to a set, if it is not already there.
+ *  It returns \verb"YES" if the element was added, in which case we
+ *  have marked it.
+\*/
 
-         }
+int set_insert(
+   SETL_SYSTEM_PROTO
+   set_h_ptr_type root,                /* set to be changed                 */
+   specifier *element,                 /* element to be added               */
+   int32 hash_code)                    /* hash code of element              */
 
-         /* start on the next clash list, if we're at a leaf */
+{
+set_c_ptr_type target_cell;            /* element's cell                    */
+int is_new;                            /* YES if element was added          */
 
-         if (!source_height && source_index < SET_HASH_SIZE) {
+   target_cell = set_locate(SETL_SYSTEM &(root->s_trie),element,hash_code,
+                            sizeof(struct set_c_item),&is_new);
+   if (!is_new)
+      return NO;
 
-            source_cell = source_work_hdr->s_child[source_index].s_cell;
-            source_index++;
-            continue;
+   mark_specifier(element);
+   spec_set_form(&target_cell->s_spec,spec_form(element));
+   spec_set_val(&target_cell->s_spec,sp_biggest,spec_val(element,sp_biggest));
+   root->s_cardinality++;
+   root->s_hash_code ^= hash_code;
 
-         }
+   return YES;
 
-         /* the current header node is exhausted -- find the next one */
+}
 
-         /* move up if we're at the end of a node */
+/*\
+ *  \function{set\_remove()}
+ *
+ *  This function removes an element from a set, if it is there.  It
+ *  returns \verb"YES" if the element was removed.
+\*/
 
-         if (source_index >= SET_HASH_SIZE) {
+int set_remove(
+   SETL_SYSTEM_PROTO
+   set_h_ptr_type root,                /* set to be changed                 */
+   specifier *element,                 /* element to be removed             */
+   int32 hash_code)                    /* hash code of element              */
 
-            /* there are not more elements, so break */
+{
+set_c_ptr_type target_cell;            /* removed cell                      */
 
-            if (source_work_hdr == source_root)
-               break;
+   target_cell = set_unlink(SETL_SYSTEM &(root->s_trie),element,hash_code);
+   if (target_cell == NULL)
+      return NO;
 
-            /* otherwise move up */
+   unmark_specifier(&(target_cell->s_spec));
+   free_set_cell(target_cell);
+   root->s_cardinality--;
+   root->s_hash_code ^= hash_code;
 
-            source_height++;
-            source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
+   return YES;
 
-         }
+}
 
-         /* skip over null nodes */
+/*\
+ *  \function{set\_union()}
+ *
+ *  This function forms the union of two sets.
+\*/
 
-         if (source_work_hdr->s_child[source_index].s_header == NULL) {
+void set_union(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* target of union operation         */
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-            source_index++;
-            continue;
+{
+set_h_ptr_type source_root;            /* source set root                   */
+struct set_cursor_item source_cursor;  /* source iteration cursor           */
+set_c_ptr_type source_cell;            /* current cell pointer              */
+set_h_ptr_type target_root;            /* target set root                   */
 
-         }
+   /*
+    *  First we set up source and target sets.  We would like to
+    *  destructively use one of the sets if possible.
+    */
 
-         /* otherwise drop down a level */
+   if (target == left && target != right &&
+       (spec_val(target,sp_set_ptr)->s_use_count == 1)) {
 
-         source_work_hdr =
-            source_work_hdr->s_child[source_index].s_header;
-         source_index = 0;
-         source_height--;
+      target_root = spec_val(target,sp_set_ptr);
+      spec_set_form(target,ft_omega);
+      source_root = spec_val(right,sp_set_ptr);
 
-      }
+   }
+   else if (target == right && target != left &&
+            (spec_val(target,sp_set_ptr)->s_use_count == 1)) {
 
-      /* if we've exhausted a set break again */
+      target_root = spec_val(target,sp_set_ptr);
+      spec_set_form(target,ft_omega);
+      source_root = spec_val(left,sp_set_ptr);
 
-      if (target_element == NULL)
-         break;
+   }
+   else {
 
-      /*
-       *  At this point we have an element we would like to remove from
-       *  the target.
-       */
+      /* we can not use a set destructively, so pick the biggest */
 
-      target_work_hdr = target_root;
+      if (spec_val(right,sp_set_ptr)->s_cardinality >
+          spec_val(left,sp_set_ptr)->s_cardinality) {
 
-      /* get the element's hash code */
+         target_root = copy_set(SETL_SYSTEM spec_val(right,sp_set_ptr));
+         source_root = spec_val(left,sp_set_ptr);
 
-      work_hash_code = target_hash_code;
+      }
+      else {
 
-      /* descend the header tree until we get to a leaf */
+         target_root = copy_set(SETL_SYSTEM spec_val(left,sp_set_ptr));
+         source_root = spec_val(right,sp_set_ptr);
 
-      target_height = target_root->s_ntype.s_root.s_height;
-      while (target_work_hdr != NULL && target_height--) {
+      }
+   }
 
-         /* extract the element's index at this level */
+   /* insert each source element in the target */
 
-         target_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
+   set_cursor_start(&source_cursor,source_root->s_trie);
+   while ((source_cell = set_cursor_next(&source_cursor)) != NULL) {
 
-         target_work_hdr =
-            target_work_hdr->s_child[target_index].s_header;
+      set_insert(SETL_SYSTEM target_root,
+                 &(source_cell->s_spec),
+                 source_cell->s_hash_code);
 
-      }
+   }
 
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  The next problem is to determine if the element is in the
-       *  set.  We compare the element with the clash list.
-       */
+   /* finally, set the target value */
 
-      if (target_work_hdr != NULL) {
+   unmark_specifier(target);
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,target_root);
 
-         target_index = work_hash_code & SET_HASH_MASK;
-         target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-         for (target_cell = *target_tail;
-              target_cell != NULL &&
-                 target_cell->s_hash_code < target_hash_code;
-              target_cell = target_cell->s_next) {
+   return;
 
-            target_tail = &(target_cell->s_next);
+}
 
-         }
+/*\
+ *  \function{set\_difference()}
+ *
+ *  This function forms the set difference for two sets.
+\*/
 
-         /* search the list of elements with the same hash code */
+void set_difference(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* target of union operation         */
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-         is_equal = NO;
-         while (target_cell != NULL &&
-                target_cell->s_hash_code == target_hash_code) {
+{
+set_h_ptr_type source_root;            /* source set root                   */
+struct set_cursor_item source_cursor;  /* source iteration cursor           */
+set_c_ptr_type source_cell;            /* current cell pointer              */
+set_h_ptr_type target_root;            /* target set root                   */
 
-            spec_equal(is_equal,&(target_cell->s_spec),target_element);
+   /*
+    *  First we set up a target set.  We would like to use the left
+    *  operand destructively if possible.
+    */
 
-            if (is_equal)
-               break;
+   if (target == left && target != right &&
+       spec_val(target,sp_set_ptr)->s_use_count == 1) {
 
-            target_tail = &(target_cell->s_next);
-            target_cell = target_cell->s_next;
+      target_root = spec_val(target,sp_set_ptr);
+      spec_set_form(target,ft_omega);
 
-         }
+   }
+   else {
 
-         /* if we found the element, delete it */
+      target_root = copy_set(SETL_SYSTEM spec_val(left,sp_set_ptr));
 
-         if (is_equal) {
+   }
 
-            unmark_specifier(&(target_cell->s_spec));
-            *target_tail = target_cell->s_next;
-            target_root->s_ntype.s_root.s_cardinality--;
-            target_root->s_hash_code ^= target_hash_code;
-            free_set_cell(target_cell);
+   source_root = spec_val(right,sp_set_ptr);
 
-            /* we may have to reduce the height of the set */
+   /* remove each source element from the target */
 
-            if (target_root->s_ntype.s_root.s_cardinality <
-                contraction_trigger) {
+   set_cursor_start(&source_cursor,source_root->s_trie);
+   while (target_root->s_cardinality > 0 &&
+          (source_cell = set_cursor_next(&source_cursor)) != NULL) {
 
-               target_root = set_contract_header(SETL_SYSTEM target_root);
-               contraction_trigger /= SET_HASH_SIZE;
+      set_remove(SETL_SYSTEM target_root,
+                 &(source_cell->s_spec),
+                 source_cell->s_hash_code);
 
-            }
-         }
-      }
    }
 
    /* finally, set the target value */
 
    unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = target_root;
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,target_root);
 
    return;
 
@@ -1307,7 +1369,8 @@ int is_equal;                          /* YES if two specifiers are equal   */
 /*\
  *  \function{set\_intersection()}
  *
- *  This function forms the intersection of two sets.
+ *  This function forms the intersection of two sets.  We loop over the
+ *  smaller set, looking for each element in the larger.
 \*/
 
 void set_intersection(
@@ -1317,323 +1380,55 @@ void set_intersection(
    specifier *right)                   /* right operand                     */
 
 {
-set_h_ptr_type lsource_root, lsource_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type lsource_list;           /* clash list                        */
-set_c_ptr_type lsource_cell;           /* cell pointer                      */
-int lsource_height, lsource_index;     /* current height and index          */
-set_h_ptr_type rsource_root, rsource_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type rsource_list;           /* clash list                        */
-set_c_ptr_type rsource_cell, rsource_work_cell;
-                                       /* cell pointers                     */
-int rsource_height;                    /* current height                    */
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int target_height, target_index;       /* current height and index          */
-specifier *target_element;             /* set element                       */
-int32 target_hash_code;                /* hash code of target element       */
-set_h_ptr_type new_hdr;                /* created header node               */
-set_c_ptr_type new_cell;               /* created cell node                 */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int32 contraction_trigger;             /* cardinality which triggers        */
-                                       /* header contraction                */
-int is_equal;                          /* YES if two specifiers are equal   */
-int i;                                 /* temporary looping variable        */
+set_h_ptr_type lsource_root;           /* smaller source set                */
+set_h_ptr_type rsource_root;           /* larger source set                 */
+struct set_cursor_item lsource_cursor; /* smaller set iteration cursor      */
+set_c_ptr_type lsource_cell;           /* current cell pointer              */
+set_h_ptr_type target_root;            /* target set root                   */
 
-   /* we want the set with the greater height on the left */
+   /* we want the smaller set on the left */
 
-   if ((left->sp_val.sp_set_ptr)->s_ntype.s_root.s_height >=
-       (right->sp_val.sp_set_ptr)->s_ntype.s_root.s_height) {
+   if (spec_val(left,sp_set_ptr)->s_cardinality <=
+       spec_val(right,sp_set_ptr)->s_cardinality) {
 
-      lsource_root = left->sp_val.sp_set_ptr;
-      rsource_root = right->sp_val.sp_set_ptr;
+      lsource_root = spec_val(left,sp_set_ptr);
+      rsource_root = spec_val(right,sp_set_ptr);
 
    }
    else {
 
-      lsource_root = right->sp_val.sp_set_ptr;
-      rsource_root = left->sp_val.sp_set_ptr;
+      lsource_root = spec_val(right,sp_set_ptr);
+      rsource_root = spec_val(left,sp_set_ptr);
 
    }
 
    /* create a new set for the target */
 
-   get_set_header(target_root);
-   target_root->s_use_count = 1;
-   target_root->s_hash_code = 0;
-   target_root->s_ntype.s_root.s_cardinality = 0;
-   target_root->s_ntype.s_root.s_height =
-      rsource_root->s_ntype.s_root.s_height;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        target_root->s_child[i++].s_cell = NULL);
-
-   /* set up to loop over the left and right sets in parallel */
+   target_root = null_set(SETL_SYSTEM_VOID);
 
-   lsource_work_hdr = lsource_root;
-   lsource_height = lsource_root->s_ntype.s_root.s_height;
-   lsource_index = 0;
+   /* insert the elements common to both sets */
 
-   rsource_work_hdr = rsource_root;
-   rsource_height = rsource_root->s_ntype.s_root.s_height;
-   rsource_list = NULL;
+   set_cursor_start(&lsource_cursor,lsource_root->s_trie);
+   while ((lsource_cell = set_cursor_next(&lsource_cursor)) != NULL) {
 
-   /* find successive clash lists, where the right should contain the left */
+      if (set_lookup(SETL_SYSTEM rsource_root->s_trie,
+                     &(lsource_cell->s_spec),
+                     lsource_cell->s_hash_code) != NULL) {
 
-   for (;;) {
-
-      /* find the next clash list */
-
-      lsource_list = NULL;
-      while (lsource_list == NULL) {
-
-         /* return the clash list if we're at a leaf */
-
-         if (!lsource_height && lsource_index < SET_HASH_SIZE) {
-
-            lsource_list =
-               lsource_work_hdr->s_child[lsource_index].s_cell;
-
-            /* if the right is also at a leaf, we set the right list */
-
-            if (!rsource_height) {
-
-               rsource_list =
-                  rsource_work_hdr->s_child[lsource_index].s_cell;
-
-            }
-
-            lsource_index++;
-
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (lsource_index >= SET_HASH_SIZE) {
-
-            if (lsource_work_hdr == lsource_root)
-               break;
-
-            lsource_height++;
-            lsource_index =
-               lsource_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            lsource_work_hdr =
-               lsource_work_hdr->s_ntype.s_intern.s_parent;
-
-            /* move up on the right also */
-
-            if (rsource_height >= 0) {
-
-               rsource_work_hdr =
-                  rsource_work_hdr->s_ntype.s_intern.s_parent;
-               rsource_list = NULL;
-
-            }
-
-            rsource_height++;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (lsource_work_hdr->s_child[lsource_index].s_header == NULL) {
-
-            lsource_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         lsource_work_hdr =
-            lsource_work_hdr->s_child[lsource_index].s_header;
-         lsource_height--;
-
-         /* drop down on the right, or return a right list */
-
-         if (rsource_height > 0) {
-
-            if (rsource_work_hdr->s_child[lsource_index].s_header == NULL) {
-
-               get_set_header(new_hdr);
-               new_hdr->s_ntype.s_intern.s_parent = rsource_work_hdr;
-               new_hdr->s_ntype.s_intern.s_child_index = lsource_index;
-               for (i = 0;
-                    i < SET_HASH_SIZE;
-                    new_hdr->s_child[i++].s_cell = NULL);
-               rsource_work_hdr->s_child[lsource_index].s_header = new_hdr;
-               rsource_work_hdr = new_hdr;
-
-            }
-            else {
-
-               rsource_work_hdr =
-                  rsource_work_hdr->s_child[lsource_index].s_header;
-
-            }
-         }
-         else if (!rsource_height) {
-
-            rsource_list =
-               rsource_work_hdr->s_child[lsource_index].s_cell;
-
-         }
-
-         rsource_height--;
-         lsource_index = 0;
-
-      }
-
-      /* break if we didn't find a list */
-
-      if (lsource_list == NULL)
-         break;
-
-      /*
-       *  At this point we have a clash list from each set.  The left
-       *  lists will be unique for each iteration, but the right lists
-       *  may repeat.  The right list will always contain those elements
-       *  on the left which are in the right set, and perhaps some
-       *  others.
-       */
-
-      /* loop over the left list */
-
-      rsource_cell = rsource_list;
-      for (lsource_cell = lsource_list;
-           lsource_cell != NULL;
-           lsource_cell = lsource_cell->s_next) {
-
-         /* search for the element in the right list */
-
-         while (rsource_cell != NULL &&
-                rsource_cell->s_hash_code < lsource_cell->s_hash_code)
-            rsource_cell = rsource_cell->s_next;
-
-         /* search through elements with identical hash codes */
-
-         is_equal = NO;
-         for (rsource_work_cell = rsource_cell;
-              rsource_work_cell != NULL &&
-                 rsource_work_cell->s_hash_code ==
-                    lsource_cell->s_hash_code &&
-                 !is_equal;
-              rsource_work_cell = rsource_work_cell->s_next) {
-
-            spec_equal(is_equal,
-                       &(lsource_cell->s_spec),
-                       &(rsource_work_cell->s_spec));
-
-         }
-
-         /* if we didn't find the element in both lists, continue */
-
-         if (!is_equal)
-            continue;
-
-         target_element = &(lsource_cell->s_spec);
-         target_hash_code = lsource_cell->s_hash_code;
-
-         /*
-          *  At this point we have an element we would like to insert into
-          *  the target.
-          */
-
-         target_work_hdr = target_root;
-         work_hash_code = target_hash_code;
-
-         /* descend the header tree until we get to a leaf */
-
-         target_height = target_root->s_ntype.s_root.s_height;
-         while (target_height--) {
-
-            /* extract the element's index at this level */
-
-            target_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-            /* if we're missing a header record, insert it */
-
-            if (target_work_hdr->s_child[target_index].s_header == NULL) {
-
-               get_set_header(new_hdr);
-               new_hdr->s_ntype.s_intern.s_parent = target_work_hdr;
-               new_hdr->s_ntype.s_intern.s_child_index = target_index;
-               for (i = 0;
-                    i < SET_HASH_SIZE;
-                    new_hdr->s_child[i++].s_cell = NULL);
-               target_work_hdr->s_child[target_index].s_header = new_hdr;
-               target_work_hdr = new_hdr;
-
-            }
-            else {
-
-               target_work_hdr =
-                  target_work_hdr->s_child[target_index].s_header;
-
-            }
-         }
-
-         /*
-          *  At this point, target_work_hdr points to the lowest level header
-          *  record.  Now we must find the position within the clash list
-          *  where we would like to insert the element.  Remember that we
-          *  keep the clash lists sorted by hash code.
-          */
-
-         target_index = work_hash_code & SET_HASH_MASK;
-         target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-         for (target_cell = *target_tail;
-              target_cell != NULL &&
-                 target_cell->s_hash_code < target_hash_code;
-              target_cell = target_cell->s_next) {
-
-            target_tail = &(target_cell->s_next);
-
-         }
-
-         /* we insert the element */
-
-         get_set_cell(new_cell);
-         mark_specifier(target_element);
-         new_cell->s_spec.sp_form = target_element->sp_form;
-         new_cell->s_spec.sp_val.sp_biggest =
-            target_element->sp_val.sp_biggest;
-         new_cell->s_hash_code = target_hash_code;
-         new_cell->s_next = *target_tail;
-         *target_tail = new_cell;
-         target_root->s_ntype.s_root.s_cardinality++;
-         target_root->s_hash_code ^= target_hash_code;
+         set_insert(SETL_SYSTEM target_root,
+                    &(lsource_cell->s_spec),
+                    lsource_cell->s_hash_code);
 
       }
    }
 
-   /* if our estimate of the header height was too large, compress it */
-
-   contraction_trigger = (1 << ((target_root->s_ntype.s_root.s_height)
-                              * SET_SHIFT_DIST));
-   if (contraction_trigger == 1)
-      contraction_trigger = 0;
-
-   while (target_root->s_ntype.s_root.s_cardinality < contraction_trigger) {
-
-      target_root = set_contract_header(SETL_SYSTEM target_root);
-      contraction_trigger /= SET_HASH_SIZE;
-
-   }
-
    /* finally, set the target value */
 
    unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = target_root;
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,target_root);
+
+   return;
 
 }
 
@@ -1650,26 +1445,10 @@ void set_symdiff(
    specifier *right)                   /* right operand                     */
 
 {
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+set_h_ptr_type source_root;            /* source set root                   */
+struct set_cursor_item source_cursor;  /* source iteration cursor           */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int target_height, target_index;       /* current height and index          */
-specifier *target_element;             /* set element                       */
-int32 target_hash_code;                /* hash code of target element       */
-set_h_ptr_type new_hdr;                /* created header node               */
-set_c_ptr_type new_cell;               /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 contraction_trigger;             /* cardinality which triggers        */
-                                       /* header contraction                */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int is_equal;                          /* YES if two specifiers are equal   */
-int i;                                 /* temporary looping variable        */
+set_h_ptr_type target_root;            /* target set root                   */
 
    /*
     *  First we set up source and target sets.  We would like to
@@ -1677,1209 +1456,294 @@ int i;                                 /* temporary looping variable        */
     */
 
    if (target == left && target != right &&
-       (target->sp_val.sp_set_ptr)->s_use_count == 1) {
+       spec_val(target,sp_set_ptr)->s_use_count == 1) {
 
-      target_root = target->sp_val.sp_set_ptr;
-      target->sp_form = ft_omega;
-      source_root = right->sp_val.sp_set_ptr;
+      target_root = spec_val(target,sp_set_ptr);
+      spec_set_form(target,ft_omega);
+      source_root = spec_val(right,sp_set_ptr);
 
    }
    else if (target == right && target != left &&
-            (target->sp_val.sp_set_ptr)->s_use_count == 1) {
-
-      target_root = target->sp_val.sp_set_ptr;
-      target->sp_form = ft_omega;
-      source_root = left->sp_val.sp_set_ptr;
-
-   }
-   else {
-
-      /* we can not use a set destructively, so pick the biggest */
-
-      if ((right->sp_val.sp_set_ptr)->s_ntype.s_root.s_cardinality >
-          (left->sp_val.sp_set_ptr)->s_ntype.s_root.s_cardinality) {
-
-         target_root = copy_set(SETL_SYSTEM right->sp_val.sp_set_ptr);
-         source_root = left->sp_val.sp_set_ptr;
-
-      }
-      else {
-
-         target_root = copy_set(SETL_SYSTEM left->sp_val.sp_set_ptr);
-         source_root = right->sp_val.sp_set_ptr;
-
-      }
-   }
-
-   /* we may have to expand the size of the header, so find the trigger */
-
-   expansion_trigger = (1 << ((target_root->s_ntype.s_root.s_height + 1)
-                              * SET_SHIFT_DIST)) * SET_CLASH_SIZE;
-
-   /* we may have to compress the header, so find the trigger */
-
-   contraction_trigger = (1 << ((target_root->s_ntype.s_root.s_height)
-                                 * SET_SHIFT_DIST));
-   if (contraction_trigger == 1)
-      contraction_trigger = 0;
-
-   /*
-    *  We loop over the source set producing one element at a time.
-    */
-
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
-
-   /* loop over the elements of source */
-
-   for (;;) {
+            spec_val(target,sp_set_ptr)->s_use_count == 1) {
 
-      /* find the next element in the set */
-
-      target_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, break */
-
-         if (source_cell != NULL) {
-
-            target_element = &(source_cell->s_spec);
-            target_hash_code = source_cell->s_hash_code;
-            source_cell = source_cell->s_next;
-            break;
-
-         }
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < SET_HASH_SIZE) {
-
-            source_cell = source_work_hdr->s_child[source_index].s_cell;
-            source_index++;
-            continue;
-
-         }
-
-         /* the current header node is exhausted -- find the next one */
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= SET_HASH_SIZE) {
-
-            /* there are not more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->s_child[source_index].s_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if we've exhausted a set break again */
-
-      if (target_element == NULL)
-         break;
-
-      /*
-       *  At this point we have an element from the source set.
-       */
-
-      target_work_hdr = target_root;
-
-      /* get the element's hash code */
-
-      work_hash_code = target_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_height = target_root->s_ntype.s_root.s_height;
-      while (target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (target_work_hdr->s_child[target_index].s_header == NULL) {
-
-            get_set_header(new_hdr);
-            new_hdr->s_ntype.s_intern.s_parent = target_work_hdr;
-            new_hdr->s_ntype.s_intern.s_child_index = target_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_hdr->s_child[i++].s_cell = NULL);
-            target_work_hdr->s_child[target_index].s_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->s_child[target_index].s_header;
-
-         }
-      }
-
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  The next problem is to determine if the element is
-       *  already in the set.  We compare the element with the clash
-       *  list.
-       */
-
-      target_index = work_hash_code & SET_HASH_MASK;
-      target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-      for (target_cell = *target_tail;
-           target_cell != NULL &&
-              target_cell->s_hash_code < target_hash_code;
-           target_cell = target_cell->s_next) {
-
-         target_tail = &(target_cell->s_next);
-
-      }
-
-      /* check for a duplicate element */
-
-      is_equal = NO;
-      while (target_cell != NULL &&
-             target_cell->s_hash_code == target_hash_code) {
-
-         spec_equal(is_equal,&(target_cell->s_spec),target_element);
-
-         if (is_equal)
-            break;
-
-         target_tail = &(target_cell->s_next);
-         target_cell = target_cell->s_next;
-
-      }
-
-      /* if we found the element, delete it */
-
-      if (is_equal) {
-
-         unmark_specifier(&(target_cell->s_spec));
-         *target_tail = target_cell->s_next;
-         target_root->s_ntype.s_root.s_cardinality--;
-         target_root->s_hash_code ^= target_hash_code;
-         free_set_cell(target_cell);
-
-         /* we may have to reduce the height of the set */
-
-         if (target_root->s_ntype.s_root.s_cardinality <
-             contraction_trigger) {
-
-            target_root = set_contract_header(SETL_SYSTEM target_root);
-            contraction_trigger /= SET_HASH_SIZE;
-            expansion_trigger /= SET_HASH_SIZE;
-
-         }
-      }
-
-      /* if we didn't find it, insert it */
-
-      else {
-
-         get_set_cell(new_cell);
-         mark_specifier(target_element);
-         new_cell->s_spec.sp_form = target_element->sp_form;
-         new_cell->s_spec.sp_val.sp_biggest =
-            target_element->sp_val.sp_biggest;
-         new_cell->s_hash_code = target_hash_code;
-         new_cell->s_next = *target_tail;
-         *target_tail = new_cell;
-         target_root->s_ntype.s_root.s_cardinality++;
-         target_root->s_hash_code ^= target_hash_code;
-
-         /* expand the set header if necessary */
-
-         if (target_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
-
-            target_root = set_expand_header(SETL_SYSTEM target_root);
-            expansion_trigger *= SET_HASH_SIZE;
-            contraction_trigger *= SET_HASH_SIZE;
-
-         }
-      }
-   }
-
-   /* finally, set the target value */
-
-   unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = target_root;
-
-   return;
-
-}
-
-/*\
- *  \function{set\_subset()}
- *
- *  This is a simple and stupid subset test.  We generate elements from
- *  the left and check whether each is in the right.
-\*/
-
-int set_subset(
-   SETL_SYSTEM_PROTO
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
-
-{
-set_h_ptr_type left_root, left_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type left_cell;              /* current cell pointer              */
-int left_height, left_index;           /* current height and index          */
-set_h_ptr_type right_root, right_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type right_cell;             /* current cell pointer              */
-int right_height, right_index;         /* current height and index          */
-specifier *right_element;              /* set element                       */
-int32 right_hash_code;                 /* hash code of target element       */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int is_equal;                          /* YES if two specifiers are equal   */
-
-   left_root = left->sp_val.sp_set_ptr;
-   right_root = right->sp_val.sp_set_ptr;
-
-   /*
-    *  We loop over the source set producing one element at a time.
-    */
-
-   left_work_hdr = left_root;
-   left_height = left_root->s_ntype.s_root.s_height;
-   left_cell = NULL;
-   left_index = 0;
-
-   /* loop over the elements of source */
-
-   for (;;) {
-
-      /* find the next element in the set */
-
-      right_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, break */
-
-         if (left_cell != NULL) {
-
-            right_element = &(left_cell->s_spec);
-            right_hash_code = left_cell->s_hash_code;
-            left_cell = left_cell->s_next;
-            break;
-
-         }
+      target_root = spec_val(target,sp_set_ptr);
+      spec_set_form(target,ft_omega);
+      source_root = spec_val(left,sp_set_ptr);
 
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!left_height && left_index < SET_HASH_SIZE) {
-
-            left_cell = left_work_hdr->s_child[left_index].s_cell;
-            left_index++;
-            continue;
-
-         }
-
-         /* the current header node is exhausted -- find the next one */
-
-         /* move up if we're at the end of a node */
-
-         if (left_index >= SET_HASH_SIZE) {
-
-            /* there are not more elements, so break */
-
-            if (left_work_hdr == left_root)
-               break;
-
-            /* otherwise move up */
-
-            left_height++;
-            left_index =
-               left_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            left_work_hdr =
-               left_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (left_work_hdr->s_child[left_index].s_header == NULL) {
-
-            left_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         left_work_hdr =
-            left_work_hdr->s_child[left_index].s_header;
-         left_index = 0;
-         left_height--;
-
-      }
-
-      /* if we've exhausted a set break again */
-
-      if (right_element == NULL)
-         break;
-
-      /*
-       *  At this point we have an element we would like to find in
-       *  the target.
-       */
-
-      right_work_hdr = right_root;
-
-      /* get the element's hash code */
-
-      work_hash_code = right_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      for (right_height = right_root->s_ntype.s_root.s_height;
-           right_height;
-           right_height--) {
-
-         /* extract the element's index at this level */
-
-         right_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-         /* if we're missing a header record, we're done */
-
-         if (right_work_hdr->s_child[right_index].s_header == NULL) {
-
-            return NO;
-
-         }
-         else {
-
-            right_work_hdr =
-               right_work_hdr->s_child[right_index].s_header;
-
-         }
-      }
-
-      /*
-       *  At this point, right_work_hdr points to the lowest level
-       *  header record.  The next problem is to determine if the element
-       *  is in the set.  We compare the element with the clash list.
-       */
-
-      right_index = work_hash_code & SET_HASH_MASK;
-      for (right_cell = right_work_hdr->s_child[right_index].s_cell;
-           right_cell != NULL &&
-              right_cell->s_hash_code < right_hash_code;
-           right_cell = right_cell->s_next);
-
-      /* check for a target element */
-
-      is_equal = NO;
-      for (;
-           right_cell != NULL &&
-              right_cell->s_hash_code == right_hash_code &&
-              !is_equal;
-           right_cell = right_cell->s_next) {
-
-         spec_equal(is_equal,&(right_cell->s_spec),right_element);
-
-      }
-
-      /* if we found the element, continue */
-
-      if (!is_equal)
-         return NO;
-
-   }
-
-   return YES;
-
-}
-
-/*\
- *  \function{set\_pow()}
- *
- *  This function finds the power set of a source set.  It used as a last
- *  resort -- we much prefer to iterate over a power set, rather than
- *  forming the power set.  When we are forced to form a power set, the
- *  source set had better be very small, or we will run out of memory
- *  forming the power set.
-\*/
-
-void set_pow(
-   SETL_SYSTEM_PROTO
-   specifier *target,                  /* power set                         */
-   specifier *source)                  /* source set                        */
-
-{
-struct source_elem_item *se_array;     /* array of source elements          */
-int se_array_length;                   /* length of above array             */
-int se_index;                          /* index into above array            */
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type subset_root, subset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type subset_cell;            /* current cell pointer              */
-set_c_ptr_type *subset_tail;           /* attach new cells here             */
-int subset_height, subset_index;       /* current height and index          */
-specifier *subset_element;             /* set element                       */
-int32 subset_hash_code;                /* hash code of subset element       */
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int target_height, target_index;       /* current height and index          */
-int32 target_hash_code;                /* hash code of target element       */
-set_h_ptr_type new_hdr;                /* created header node               */
-set_c_ptr_type new_cell;               /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int i;                                 /* temporary looping variable        */
-
-   source_root = source->sp_val.sp_set_ptr;
-
-   /* create an array of set elements in the source set */
-
-   se_array_length = (int)(source_root->s_ntype.s_root.s_cardinality);
-
-   se_array = (struct source_elem_item *)malloc((size_t)
-                    (se_array_length * sizeof(struct source_elem_item)));
-   if (se_array == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-   se_index = 0;
-
-   /*
-    *  Set up to loop over the source set, producing one leaf node at a
-    *  time.
-    */
-
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_index = 0;
-
-   /* loop over the nodes of source */
-
-   for (;;) {
-
-      /* descend to a leaf */
-
-      while (source_height) {
-
-         /* move down if possible */
-
-         if (source_index < SET_HASH_SIZE) {
-
-            /* skip over null nodes */
-
-            if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-               source_index++;
-               continue;
-
-            }
-
-            /* we can move down, so do so */
-
-            source_work_hdr =
-               source_work_hdr->s_child[source_index].s_header;
-            source_index = 0;
-            source_height--;
-
-            continue;
-
-         }
-
-         /* if there are no more elements, break */
-
-         if (source_work_hdr == source_root) {
-
-            source_work_hdr = NULL;
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         source_height++;
-         source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         source_work_hdr =
-            source_work_hdr->s_ntype.s_intern.s_parent;
-
-         continue;
-
-      }
-
-      /* break if we can't find a leaf */
-
-      if (source_work_hdr == NULL)
-         break;
-
-      /*
-       *  At this point we have a leaf in the header tree.  We loop over
-       *  the elements in this leaf inserting each in the specifier
-       *  array.
-       */
-
-      for (source_index = 0; source_index < SET_HASH_SIZE; source_index++) {
-
-         for (source_cell = source_work_hdr->s_child[source_index].s_cell;
-              source_cell != NULL;
-              source_cell = source_cell->s_next) {
-
-            se_array[se_index].se_element = source_cell;
-            se_array[se_index].se_in_set = NO;
-            se_index++;
-
-         }
-      }
-
-      /* if the leaf is the root, we're done */
-
-      if (source_work_hdr == source_root)
-         break;
-
-      /* set up to find the next leaf, by moving to the parent */
-
-      source_height++;
-      source_index =
-            source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-      source_work_hdr =
-         source_work_hdr->s_ntype.s_intern.s_parent;
-
-   }
-
-   /*
-    *  Now we're done with the source set.  We have all its elements in
-    *  an array, so it's easy to loop over this array forming subsets.
-    */
-
-   /* create a new set for the target */
-
-   get_set_header(target_root);
-   target_root->s_use_count = 1;
-   target_root->s_hash_code = 0;
-   target_root->s_ntype.s_root.s_cardinality = 0;
-   target_root->s_ntype.s_root.s_height =
-         max(0,se_array_length - SET_HASH_SIZE);
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        target_root->s_child[i++].s_cell = NULL);
-
-   /* keep looping until we've produced all subsets */
-
-   for (;;) {
-
-      /* create a new set for the subset */
-
-      get_set_header(subset_root);
-      subset_root->s_use_count = 1;
-      subset_root->s_hash_code = 0;
-      subset_root->s_ntype.s_root.s_cardinality = 0;
-      subset_root->s_ntype.s_root.s_height = 0;
-      for (i = 0;
-           i < SET_HASH_SIZE;
-           subset_root->s_child[i++].s_cell = NULL);
-      expansion_trigger = SET_HASH_SIZE * SET_CLASH_SIZE;
-
-      /* loop over the array of cells, building up a subset */
-
-      for (se_index = 0; se_index < se_array_length; se_index++) {
-
-         if (!se_array[se_index].se_in_set)
-            continue;
-
-         subset_element = &(se_array[se_index].se_element->s_spec);
-         subset_hash_code = se_array[se_index].se_element->s_hash_code;
-
-         /*
-          *  At this point we have an element we would like to insert into
-          *  the subset.
-          */
-
-         subset_work_hdr = subset_root;
-
-         /* get the element's hash code */
-
-         work_hash_code = subset_hash_code;
-
-         /* descend the header tree until we get to a leaf */
-
-         subset_height = subset_root->s_ntype.s_root.s_height;
-         while (subset_height--) {
-
-            /* extract the element's index at this level */
-
-            subset_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-            /* if we're missing a header record, insert it */
-
-            if (subset_work_hdr->s_child[subset_index].s_header == NULL) {
-
-               get_set_header(new_hdr);
-               new_hdr->s_ntype.s_intern.s_parent = subset_work_hdr;
-               new_hdr->s_ntype.s_intern.s_child_index = subset_index;
-               for (i = 0;
-                    i < SET_HASH_SIZE;
-                    new_hdr->s_child[i++].s_cell = NULL);
-               subset_work_hdr->s_child[subset_index].s_header = new_hdr;
-               subset_work_hdr = new_hdr;
-
-            }
-            else {
-
-               subset_work_hdr =
-                  subset_work_hdr->s_child[subset_index].s_header;
-
-            }
-         }
-
-         /*
-          *  Now subset_work_hdr points to the lowest level header node
-          *  in the set.  We don't have to worry about duplicates, but we
-          *  must find the position in the clash list where we would like
-          *  to insert this element.
-          */
-
-         subset_index = work_hash_code & SET_HASH_MASK;
-         subset_tail = &(subset_work_hdr->s_child[subset_index].s_cell);
-         for (subset_cell = *subset_tail;
-              subset_cell != NULL &&
-                 subset_cell->s_hash_code < subset_hash_code;
-              subset_cell = subset_cell->s_next) {
-
-            subset_tail = &(subset_cell->s_next);
-
-         }
-
-         /* we insert it */
-
-         get_set_cell(new_cell);
-         mark_specifier(subset_element);
-         new_cell->s_spec.sp_form = subset_element->sp_form;
-         new_cell->s_spec.sp_val.sp_biggest =
-            subset_element->sp_val.sp_biggest;
-         new_cell->s_hash_code = subset_hash_code;
-         new_cell->s_next = *subset_tail;
-         *subset_tail = new_cell;
-         subset_root->s_ntype.s_root.s_cardinality++;
-         subset_root->s_hash_code ^= subset_hash_code;
-
-         /* expand the set header if necessary */
-
-         if (subset_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
-
-            subset_root = set_expand_header(SETL_SYSTEM subset_root);
-            expansion_trigger *= SET_HASH_SIZE;
-
-         }
-      }
-
-      /*
-       *  At this point we've finished building a subset, and must insert
-       *  it into the target set.
-       */
-
-      target_hash_code = subset_root->s_hash_code;
-      target_work_hdr = target_root;
-
-      /* get the element's hash code */
-
-      work_hash_code = target_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_height = target_root->s_ntype.s_root.s_height;
-      while (target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
-
-         /* if we're missing a header record, insert it */
-
-         if (target_work_hdr->s_child[target_index].s_header == NULL) {
-
-            get_set_header(new_hdr);
-            new_hdr->s_ntype.s_intern.s_parent = target_work_hdr;
-            new_hdr->s_ntype.s_intern.s_child_index = target_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_hdr->s_child[i++].s_cell = NULL);
-            target_work_hdr->s_child[target_index].s_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->s_child[target_index].s_header;
-
-         }
-      }
-
-     /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We find the position in the clash list in which we
-       *  would like to insert the subset.
-       */
-
-      target_index = work_hash_code & SET_HASH_MASK;
-      target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-      for (target_cell = *target_tail;
-           target_cell != NULL &&
-              target_cell->s_hash_code < target_hash_code;
-           target_cell = target_cell->s_next) {
-
-         target_tail = &(target_cell->s_next);
-
-      }
-
-      /* we insert it */
-
-      get_set_cell(new_cell);
-      new_cell->s_spec.sp_form = ft_set;
-      new_cell->s_spec.sp_val.sp_set_ptr = subset_root;
-      new_cell->s_hash_code = target_hash_code;
-      new_cell->s_next = *target_tail;
-      *target_tail = new_cell;
-      target_root->s_ntype.s_root.s_cardinality++;
-      target_root->s_hash_code ^= target_hash_code;
-
-      /*
-       *  We treat the field se_in_set as a single bit in a binary number
-       *  representing a subset.  We effectively add one to this binary
-       *  number.
-       */
-
-      for (se_index = 0;
-           se_index < se_array_length && se_array[se_index].se_in_set;
-           se_array[se_index++].se_in_set = NO);
-
-      if (se_index >= se_array_length)
-         break;
-
-      se_array[se_index].se_in_set = YES;
-
-   }
-
-   /* finally, set the target value */
-
-   free(se_array);
-   unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = target_root;
-
-   return;
-
-}
-
-/*\
- *  \function{set\_npow()}
- *
- *  This function finds the power set of a source set.  It used as a last
- *  resort -- we much prefer to iterate over a power set, rather than
- *  forming the power set.  When we are forced to form a power set, the
- *  source set had better be very small, or we will run out of memory
- *  forming the power set.
-\*/
-
-void set_npow(
-   SETL_SYSTEM_PROTO
-   specifier *target,                  /* power set                         */
-   specifier *source,                  /* source set                        */
-   int32 n)                            /* size of each subset               */
-
-{
-struct source_elem_item *se_array;     /* array of source elements          */
-int32 se_array_length;                 /* length of above array             */
-int32 se_index;                        /* index into above array            */
-int32 se_right_no;                     /* position of rightmost zero        */
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type subset_root, subset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type subset_cell;            /* current cell pointer              */
-set_c_ptr_type *subset_tail;           /* attach new cells here             */
-int subset_height, subset_index;       /* current height and index          */
-specifier *subset_element;             /* set element                       */
-int32 subset_hash_code;                /* hash code of subset element       */
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-set_c_ptr_type *target_tail;           /* attach new cells here             */
-int target_height, target_index;       /* current height and index          */
-int32 target_hash_code;                /* hash code of target element       */
-set_h_ptr_type new_hdr;                /* created header node               */
-set_c_ptr_type new_cell;               /* created cell node                 */
-int32 expansion_trigger;               /* cardinality which triggers        */
-                                       /* header expansion                  */
-int32 work_hash_code;                  /* working hash code (destroyed)     */
-int i;                                 /* temporary looping variable        */
-
-   source_root = source->sp_val.sp_set_ptr;
-
-   /* create an array of set elements in the source set */
-
-   se_array_length = source_root->s_ntype.s_root.s_cardinality;
-   se_array = (struct source_elem_item *)malloc((size_t)
-                    (se_array_length * sizeof(struct source_elem_item)));
-   if (se_array == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
-   se_index = 0;
-
-   /*
-    *  Set up to loop over the source set, producing one leaf node at a
-    *  time.
-    */
-
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_index = 0;
-
-   /* loop over the nodes of source */
-
-   for (;;) {
-
-      /* descend to a leaf */
-
-      while (source_height) {
-
-         /* move down if possible */
-
-         if (source_index < SET_HASH_SIZE) {
-
-            /* skip over null nodes */
-
-            if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-               source_index++;
-               continue;
-
-            }
-
-            /* we can move down, so do so */
-
-            source_work_hdr =
-               source_work_hdr->s_child[source_index].s_header;
-            source_index = 0;
-            source_height--;
-
-            continue;
-
-         }
-
-         /* if there are no more elements, break */
-
-         if (source_work_hdr == source_root) {
-
-            source_work_hdr = NULL;
-            break;
-
-         }
+   }
+   else {
 
-         /* move up if we're at the end of a node */
+      /* we can not use a set destructively, so pick the biggest */
 
-         source_height++;
-         source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         source_work_hdr =
-            source_work_hdr->s_ntype.s_intern.s_parent;
+      if (spec_val(right,sp_set_ptr)->s_cardinality >
+          spec_val(left,sp_set_ptr)->s_cardinality) {
 
-         continue;
+         target_root = copy_set(SETL_SYSTEM spec_val(right,sp_set_ptr));
+         source_root = spec_val(left,sp_set_ptr);
 
       }
+      else {
 
-      /* break if we can't find a leaf */
+         target_root = copy_set(SETL_SYSTEM spec_val(left,sp_set_ptr));
+         source_root = spec_val(right,sp_set_ptr);
 
-      if (source_work_hdr == NULL)
-         break;
+      }
+   }
 
-      /*
-       *  At this point we have a leaf in the header tree.  We loop over
-       *  the elements in this leaf inserting each in the specifier
-       *  array.
-       */
+   /* remove the source elements in the target, and insert the others */
 
-      for (source_index = 0; source_index < SET_HASH_SIZE; source_index++) {
+   set_cursor_start(&source_cursor,source_root->s_trie);
+   while ((source_cell = set_cursor_next(&source_cursor)) != NULL) {
 
-         for (source_cell = source_work_hdr->s_child[source_index].s_cell;
-              source_cell != NULL;
-              source_cell = source_cell->s_next) {
+      if (!set_remove(SETL_SYSTEM target_root,
+                      &(source_cell->s_spec),
+                      source_cell->s_hash_code)) {
 
-            se_array[se_index].se_element = source_cell;
-            se_array[se_index].se_in_set = NO;
-            se_index++;
+         set_insert(SETL_SYSTEM target_root,
+                    &(source_cell->s_spec),
+                    source_cell->s_hash_code);
 
-         }
       }
+   }
 
-      /* if the leaf is the root, we're done */
+   /* finally, set the target value */
 
-      if (source_work_hdr == source_root)
-         break;
+   unmark_specifier(target);
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,target_root);
 
-      /* set up to find the next leaf, by moving to the parent */
+   return;
 
-      source_height++;
-      source_index =
-            source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-      source_work_hdr =
-         source_work_hdr->s_ntype.s_intern.s_parent;
+}
 
-   }
+/*\
+ *  \function{set\_subset()}
+ *
+ *  This function tests whether the left set is a subset of the right.
+\*/
 
-   /* initially the first n elements are in the set */
+int set_subset(
+   SETL_SYSTEM_PROTO
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-   for (se_index = 0;
-        se_index < se_array_length && se_index < n;
-        se_array[se_index++].se_in_set = YES);
+{
+set_h_ptr_type left_root, right_root;  /* operand set roots                 */
+struct set_cursor_item left_cursor;    /* left iteration cursor             */
+set_c_ptr_type left_cell;              /* current cell pointer              */
 
-   /*
-    *  Now we're done with the source set.  We have all its elements in
-    *  an array, so it's easy to loop over this array forming subsets.
-    */
+   left_root = spec_val(left,sp_set_ptr);
+   right_root = spec_val(right,sp_set_ptr);
 
-   /* create a new set for the target */
+   if (left_root->s_cardinality > right_root->s_cardinality)
+      return NO;
 
-   get_set_header(target_root);
-   target_root->s_use_count = 1;
-   target_root->s_hash_code = 0;
-   target_root->s_ntype.s_root.s_cardinality = 0;
-   target_root->s_ntype.s_root.s_height =
-         max(0,se_array_length - SET_HASH_SIZE);
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        target_root->s_child[i++].s_cell = NULL);
+   /* look for each left element in the right */
 
-   /* keep looping until we've produced all subsets */
+   set_cursor_start(&left_cursor,left_root->s_trie);
+   while ((left_cell = set_cursor_next(&left_cursor)) != NULL) {
 
-   for (;;) {
+      if (set_lookup(SETL_SYSTEM right_root->s_trie,
+                     &(left_cell->s_spec),
+                     left_cell->s_hash_code) == NULL)
+         return NO;
 
-      /*
-       *  if we are asked to produce sets larger than the base, return an
-       *  empty set
-       */
+   }
 
-      if (n > se_array_length)
-         break;
+   return YES;
+
+}
 
-      /* create a new set for the subset */
+/*\
+ *  \function{set\_elements()}
+ *
+ *  This function creates an array of the cells in a source set, for the
+ *  power set functions.  Each element is initially out of the subset.
+\*/
 
-      get_set_header(subset_root);
-      subset_root->s_use_count = 1;
-      subset_root->s_hash_code = 0;
-      subset_root->s_ntype.s_root.s_cardinality = 0;
-      subset_root->s_ntype.s_root.s_height = 0;
-      for (i = 0;
-           i < SET_HASH_SIZE;
-           subset_root->s_child[i++].s_cell = NULL);
-      expansion_trigger = SET_HASH_SIZE * SET_CLASH_SIZE;
+static struct source_elem_item *set_elements(
+   SETL_SYSTEM_PROTO
+   set_h_ptr_type source_root)         /* source set                        */
 
-      /* loop over the array of cells, building up a subset */
+{
+struct source_elem_item *se_array;     /* array of source elements          */
+int32 se_index;                        /* index into above array            */
+struct set_cursor_item source_cursor;  /* source iteration cursor           */
+set_c_ptr_type source_cell;            /* current cell pointer              */
 
-      for (se_index = 0; se_index < se_array_length; se_index++) {
+   se_array = (struct source_elem_item *)malloc((size_t)
+                    ((source_root->s_cardinality + 1) *
+                     sizeof(struct source_elem_item)));
+   if (se_array == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-         if (!se_array[se_index].se_in_set)
-            continue;
+   se_index = 0;
+   set_cursor_start(&source_cursor,source_root->s_trie);
+   while ((source_cell = set_cursor_next(&source_cursor)) != NULL) {
 
-         subset_element = &(se_array[se_index].se_element->s_spec);
-         subset_hash_code = se_array[se_index].se_element->s_hash_code;
+      se_array[se_index].se_element = source_cell;
+      se_array[se_index].se_in_set = NO;
+      se_index++;
 
-         /*
-          *  At this point we have an element we would like to insert into
-          *  the subset.
-          */
+   }
 
-         subset_work_hdr = subset_root;
+   return se_array;
 
-         /* get the element's hash code */
+}
 
-         work_hash_code = subset_hash_code;
+/*\
+ *  \function{set\_add\_subset()}
+ *
+ *  This function builds the subset of the source elements marked as in
+ *  the subset, and adds it to a power set.
+\*/
 
-         /* descend the header tree until we get to a leaf */
+static void set_add_subset(
+   SETL_SYSTEM_PROTO
+   set_h_ptr_type target_root,         /* power set                         */
+   struct source_elem_item *se_array,  /* array of source elements          */
+   int32 se_array_length)              /* length of above array             */
 
-         subset_height = subset_root->s_ntype.s_root.s_height;
-         while (subset_height--) {
+{
+set_h_ptr_type subset_root;            /* subset being built                */
+specifier subset;                      /* subset specifier                  */
+int32 se_index;                        /* index into above array            */
 
-            /* extract the element's index at this level */
+   subset_root = null_set(SETL_SYSTEM_VOID);
 
-            subset_index = work_hash_code & SET_HASH_MASK;
-            work_hash_code = work_hash_code >> SET_SHIFT_DIST;
+   for (se_index = 0; se_index < se_array_length; se_index++) {
 
-            /* if we're missing a header record, insert it */
+      if (se_array[se_index].se_in_set) {
 
-            if (subset_work_hdr->s_child[subset_index].s_header == NULL) {
+         set_insert(SETL_SYSTEM subset_root,
+                    &(se_array[se_index].se_element->s_spec),
+                    se_array[se_index].se_element->s_hash_code);
 
-               get_set_header(new_hdr);
-               new_hdr->s_ntype.s_intern.s_parent = subset_work_hdr;
-               new_hdr->s_ntype.s_intern.s_child_index = subset_index;
-               for (i = 0;
-                    i < SET_HASH_SIZE;
-                    new_hdr->s_child[i++].s_cell = NULL);
-               subset_work_hdr->s_child[subset_index].s_header = new_hdr;
-               subset_work_hdr = new_hdr;
+      }
+   }
 
-            }
-            else {
+   /* the target takes our reference to the subset */
 
-               subset_work_hdr =
-                  subset_work_hdr->s_child[subset_index].s_header;
+   spec_set_form(&subset,ft_set);
+   spec_set_val(&subset,sp_set_ptr,subset_root);
+   set_insert(SETL_SYSTEM target_root,&subset,subset_root->s_hash_code);
+   subset_root->s_use_count--;
 
-            }
-         }
+}
 
-         /*
-          *  Now subset_work_hdr points to the lowest level header node
-          *  in the set.  We don't have to worry about duplicates, but we
-          *  must find the position in the clash list where we would like
-          *  to insert this element.
-          */
+/*\
+ *  \function{set\_pow()}
+ *
+ *  This function finds the power set of a source set.  It used as a last
+ *  resort -- we much prefer to iterate over a power set, rather than
+ *  forming the power set.  When we are forced to form a power set, the
+ *  source set had better be very small, or we will run out of memory
+ *  forming the power set.
+\*/
 
-         subset_index = work_hash_code & SET_HASH_MASK;
-         subset_tail = &(subset_work_hdr->s_child[subset_index].s_cell);
-         for (subset_cell = *subset_tail;
-              subset_cell != NULL &&
-                 subset_cell->s_hash_code < subset_hash_code;
-              subset_cell = subset_cell->s_next) {
+void set_pow(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* power set                         */
+   specifier *source)                  /* source set                        */
 
-            subset_tail = &(subset_cell->s_next);
+{
+struct source_elem_item *se_array;     /* array of source elements          */
+int se_array_length;                   /* length of above array             */
+int se_index;                          /* index into above array            */
+set_h_ptr_type target_root;            /* power set root                    */
 
-         }
+   /* create an array of set elements in the source set */
 
-         /* we insert it */
+   se_array_length = (int)(spec_val(source,sp_set_ptr)->s_cardinality);
+   se_array = set_elements(SETL_SYSTEM spec_val(source,sp_set_ptr));
 
-         get_set_cell(new_cell);
-         mark_specifier(subset_element);
-         new_cell->s_spec.sp_form = subset_element->sp_form;
-         new_cell->s_spec.sp_val.sp_biggest =
-            subset_element->sp_val.sp_biggest;
-         new_cell->s_hash_code = subset_hash_code;
-         new_cell->s_next = *subset_tail;
-         *subset_tail = new_cell;
-         subset_root->s_ntype.s_root.s_cardinality++;
-         subset_root->s_hash_code ^= subset_hash_code;
+   /*
+    *  Now we're done with the source set.  We have all its elements in
+    *  an array, so it's easy to loop over this array forming subsets.
+    */
 
-         /* expand the set header if necessary */
+   target_root = null_set(SETL_SYSTEM_VOID);
 
-         if (subset_root->s_ntype.s_root.s_cardinality > expansion_trigger) {
+   /* keep looping until we've produced all subsets */
 
-            subset_root = set_expand_header(SETL_SYSTEM subset_root);
-            expansion_trigger *= SET_HASH_SIZE;
+   for (;;) {
 
-         }
-      }
+      set_add_subset(SETL_SYSTEM target_root,se_array,se_array_length);
 
       /*
-       *  At this point we've finished building a subset, and must insert
-       *  it into the target set.
+       *  We treat the field se_in_set as a single bit in a binary number
+       *  representing a subset.  We effectively add one to this binary
+       *  number.
        */
 
-      target_hash_code = subset_root->s_hash_code;
-      target_work_hdr = target_root;
+      for (se_index = 0;
+           se_index < se_array_length && se_array[se_index].se_in_set;
+           se_array[se_index++].se_in_set = NO);
+
+      if (se_index >= se_array_length)
+         break;
+
+      se_array[se_index].se_in_set = YES;
 
-      /* get the element's hash code */
+   }
 
-      work_hash_code = target_hash_code;
+   /* finally, set the target value */
 
-      /* descend the header tree until we get to a leaf */
+   free(se_array);
+   unmark_specifier(target);
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,target_root);
 
-      target_height = target_root->s_ntype.s_root.s_height;
-      while (target_height--) {
+   return;
 
-         /* extract the element's index at this level */
+}
 
-         target_index = work_hash_code & SET_HASH_MASK;
-         work_hash_code = work_hash_code >> SET_SHIFT_DIST;
+/*\
+ *  \function{set\_npow()}
+ *
+ *  This function finds the set of subsets of a source set with a given
+ *  number of elements.  Like \verb"pow", it is a last resort.
+\*/
 
-         /* if we're missing a header record, insert it */
+void set_npow(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* power set                         */
+   specifier *source,                  /* source set                        */
+   int32 n)                            /* size of each subset               */
 
-         if (target_work_hdr->s_child[target_index].s_header == NULL) {
+{
+struct source_elem_item *se_array;     /* array of source elements          */
+int32 se_array_length;                 /* length of above array             */
+int32 se_index;                        /* index into above array            */
+int32 se_right_no;                     /* position of rightmost zero        */
+set_h_ptr_type target_root;            /* power set root                    */
 
-            get_set_header(new_hdr);
-            new_hdr->s_ntype.s_intern.s_parent = target_work_hdr;
-            new_hdr->s_ntype.s_intern.s_child_index = target_index;
-            for (i = 0;
-                 i < SET_HASH_SIZE;
-                 new_hdr->s_child[i++].s_cell = NULL);
-            target_work_hdr->s_child[target_index].s_header = new_hdr;
-            target_work_hdr = new_hdr;
+   /* create an array of set elements in the source set */
 
-         }
-         else {
+   se_array_length = spec_val(source,sp_set_ptr)->s_cardinality;
+   se_array = set_elements(SETL_SYSTEM spec_val(source,sp_set_ptr));
 
-            target_work_hdr =
-               target_work_hdr->s_child[target_index].s_header;
+   /* initially the first n elements are in the set */
 
-         }
-      }
+   for (se_index = 0;
+        se_index < se_array_length && se_index < n;
+        se_array[se_index++].se_in_set = YES);
 
-     /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We find the position in the clash list in which we
-       *  would like to insert the subset.
-       */
+   target_root = null_set(SETL_SYSTEM_VOID);
 
-      target_index = work_hash_code & SET_HASH_MASK;
-      target_tail = &(target_work_hdr->s_child[target_index].s_cell);
-      for (target_cell = *target_tail;
-           target_cell != NULL &&
-              target_cell->s_hash_code < target_hash_code;
-           target_cell = target_cell->s_next) {
+   /* keep looping until we've produced all subsets */
 
-         target_tail = &(target_cell->s_next);
+   for (;;) {
 
-      }
+      /*
+       *  If n is greater than the source cardinality, we return the
+       *  empty set
+       */
 
-      /* we insert it */
+      if (n > se_array_length)
+         break;
 
-      get_set_cell(new_cell);
-      new_cell->s_spec.sp_form = ft_set;
-      new_cell->s_spec.sp_val.sp_set_ptr = subset_root;
-      new_cell->s_hash_code = target_hash_code;
-      new_cell->s_next = *target_tail;
-      *target_tail = new_cell;
-      target_root->s_ntype.s_root.s_cardinality++;
-      target_root->s_hash_code ^= target_hash_code;
+      set_add_subset(SETL_SYSTEM target_root,se_array,se_array_length);
 
       /*
        *  We treat the field se_in_set as a single bit in a binary number
@@ -2906,12 +1770,9 @@ int i;                                 /* temporary looping variable        */
 
       se_array[se_index++].se_in_set = NO;
       se_array[se_index++].se_in_set = YES;
-
       while (se_right_no < se_array_length) {
-
          se_array[se_right_no++].se_in_set = NO;
          se_array[se_index++].se_in_set = YES;
-
       }
    }
 
@@ -2919,8 +1780,8 @@ int i;                                 /* temporary looping variable        */
 
    free(se_array);
    unmark_specifier(target);
-   target->sp_form = ft_set;
-   target->sp_val.sp_set_ptr = target_root;
+   spec_set_form(target,ft_set);
+   spec_set_val(target,sp_set_ptr,target_root);
 
    return;
 
@@ -2929,11 +1790,8 @@ int i;                                 /* temporary looping variable        */
 /*\
  *  \function{set\_arb()}
  *
- *  This function finds the power set of a source set.  It used as a last
- *  resort -- we much prefer to iterate over a power set, rather than
- *  forming the power set.  When we are forced to form a power set, the
- *  source set had better be very small, or we will run out of memory
- *  forming the power set.
+ *  This function returns an arbitrary element of a set, or omega if the
+ *  set is empty.
 \*/
 
 void set_arb(
@@ -2942,95 +1800,27 @@ void set_arb(
    specifier *source)                  /* source set                        */
 
 {
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-
-   source_root = source->sp_val.sp_set_ptr;
-
-   /*
-    *  We loop over the source set looking for an element.
-    */
-
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
-
-   /* find the next element in the set */
-
-   for (;;) {
-
-      /* if we have an element already, break */
-
-      if (source_cell != NULL) {
-
-         mark_specifier(&(source_cell->s_spec));
-         unmark_specifier(target);
-         target->sp_form = source_cell->s_spec.sp_form;
-         target->sp_val.sp_biggest =
-            source_cell->s_spec.sp_val.sp_biggest;
-
-         return;
-
-      }
-
-      /* start on the next clash list, if we're at a leaf */
-
-      if (!source_height && source_index < SET_HASH_SIZE) {
-
-         source_cell = source_work_hdr->s_child[source_index].s_cell;
-         source_index++;
-         continue;
-
-      }
-
-      /* the current header node is exhausted -- find the next one */
-
-      /* move up if we're at the end of a node */
-
-      if (source_index >= SET_HASH_SIZE) {
-
-         /* there are no more elements, so return omega */
-
-         if (source_work_hdr == source_root) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_omega;
-
-            return;
-
-         }
-
-         /* otherwise move up */
+struct set_cursor_item source_cursor;  /* source iteration cursor           */
+set_c_ptr_type source_cell;            /* first cell in set                 */
 
-         source_height++;
-         source_index =
-            source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         source_work_hdr =
-            source_work_hdr->s_ntype.s_intern.s_parent;
-         continue;
-
-      }
-
-      /* skip over null nodes */
+   set_cursor_start(&source_cursor,spec_val(source,sp_set_ptr)->s_trie);
+   source_cell = set_cursor_next(&source_cursor);
 
-      if (source_work_hdr->s_child[source_index].s_header == NULL) {
+   if (source_cell == NULL) {
 
-         source_index++;
-         continue;
+      unmark_specifier(target);
+      spec_set_form(target,ft_omega);
+      return;
 
-      }
+   }
 
-      /* otherwise drop down a level */
+   mark_specifier(&(source_cell->s_spec));
+   unmark_specifier(target);
+   spec_set_form(target,spec_form(&source_cell->s_spec));
+   spec_set_val(target,sp_biggest,spec_val(&source_cell->s_spec,sp_biggest));
 
-      source_work_hdr =
-         source_work_hdr->s_child[source_index].s_header;
-      source_index = 0;
-      source_height--;
+   return;
 
-   }
 }
 
 /*\
@@ -3047,27 +1837,21 @@ void set_from(
    specifier *right)                   /* right operand                     */
 
 {
-set_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type target_cell;            /* current cell pointer              */
-int target_height, target_index;       /* current height and index          */
-int32 contraction_trigger;             /* cardinality which triggers        */
-                                       /* header contraction                */
-int i;                                 /* temporary looping variable        */
+set_h_ptr_type target_root;            /* root of source set                */
+struct set_cursor_item target_cursor;  /* source iteration cursor           */
+set_c_ptr_type target_cell;            /* removed cell                      */
 
    /* if the source set is empty, return omega */
 
-   target_root = right->sp_val.sp_set_ptr;
-   if (target_root->s_ntype.s_root.s_cardinality == 0) {
+   target_root = spec_val(right,sp_set_ptr);
+   if (target_root->s_cardinality == 0) {
 
       unmark_specifier(left);
-      left->sp_form = ft_omega;
+      spec_set_form(left,ft_omega);
 
       if (target != NULL) {
-
          unmark_specifier(target);
-         target->sp_form = ft_omega;
-
+         spec_set_form(target,ft_omega);
       }
 
       return;
@@ -3079,153 +1863,61 @@ int i;                                 /* temporary looping variable        */
     */
 
    if (right == target || right == left ||
-       (right->sp_val.sp_set_ptr)->s_use_count != 1) {
+       spec_val(right,sp_set_ptr)->s_use_count != 1) {
 
-      target_root = copy_set(SETL_SYSTEM right->sp_val.sp_set_ptr);
+      target_root = copy_set(SETL_SYSTEM spec_val(right,sp_set_ptr));
 
    }
    else {
 
-      right->sp_form = ft_omega;
+      spec_set_form(right,ft_omega);
 
    }
 
-   /*
-    *  We loop over the target set looking for an element.
-    */
-
-   target_work_hdr = target_root;
-   target_height = target_root->s_ntype.s_root.s_height;
-   target_cell = NULL;
-   target_index = 0;
-
-   /* find the next element in the set */
-
-   while (target_cell == NULL) {
-
-      /* start on the next clash list, if we're at a leaf */
-
-      if (!target_height && target_index < SET_HASH_SIZE) {
-
-         target_cell = target_work_hdr->s_child[target_index].s_cell;
-         target_index++;
-
-         continue;
-
-      }
-
-      /* move up if we're at the end of a node */
+   /* take the first element, and unlink its cell */
 
-      if (target_index >= SET_HASH_SIZE) {
+   set_cursor_start(&target_cursor,target_root->s_trie);
+   target_cell = set_cursor_next(&target_cursor);
 
 #ifdef TRAPS
 
-         /* there are must be elements in the set */
+   /* there must be elements in the set */
 
-         if (target_work_hdr == target_root)
-            trap(__FILE__,__LINE__,msg_corrupted_set);
+   if (target_cell == NULL)
+      trap(__FILE__,__LINE__,msg_corrupted_set);
 
 #endif
 
-         /* otherwise move up */
-
-         target_height++;
-         target_index =
-            target_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         target_work_hdr =
-            target_work_hdr->s_ntype.s_intern.s_parent;
-
-         continue;
-
-      }
-
-      /* skip over null nodes */
-
-      if (target_work_hdr->s_child[target_index].s_header == NULL) {
-
-         target_index++;
-         continue;
-
-      }
-
-      /* otherwise drop down a level */
-
-      target_work_hdr =
-         target_work_hdr->s_child[target_index].s_header;
-      target_index = 0;
-      target_height--;
-
-   }
+   target_cell = set_unlink(SETL_SYSTEM &(target_root->s_trie),
+                            &(target_cell->s_spec),
+                            target_cell->s_hash_code);
 
    /*
     *  At this point we have an element we must delete from the source.
-    *  Note two things: we've already handled the case in which the
-    *  source is empty, and since we remove an element from the set and
-    *  set a target to that element, we can skip the unmarking and
-    *  remarking of that element.
+    *  Since we remove an element from the set and set a target to that
+    *  element, we can skip the unmarking and remarking of that element.
     */
 
    unmark_specifier(left);
-   left->sp_form = target_cell->s_spec.sp_form;
-   left->sp_val.sp_biggest = target_cell->s_spec.sp_val.sp_biggest;
-
-   target_work_hdr->s_child[target_index - 1].s_cell = target_cell->s_next;
-   target_root->s_ntype.s_root.s_cardinality--;
+   spec_set_form(left,spec_form(&target_cell->s_spec));
+   spec_set_val(left,sp_biggest,spec_val(&target_cell->s_spec,sp_biggest));
+   target_root->s_cardinality--;
    target_root->s_hash_code ^= target_cell->s_hash_code;
    free_set_cell(target_cell);
 
-   /* delete any null headers on this subtree */
-
-   for (;;) {
-
-      if (target_work_hdr == target_root)
-         break;
-
-      for (i = 0;
-           i < SET_HASH_SIZE &&
-              target_work_hdr->s_child[i].s_header == NULL;
-           i++);
-
-      if (i < SET_HASH_SIZE)
-         break;
-
-      target_index =
-         target_work_hdr->s_ntype.s_intern.s_child_index + 1;
-      target_work_hdr =
-         target_work_hdr->s_ntype.s_intern.s_parent;
-
-   }
-
-   /* we may have to reduce the height of the set */
-
-   contraction_trigger = (1 << ((target_root->s_ntype.s_root.s_height)
-                                 * SET_SHIFT_DIST));
-   if (contraction_trigger == 1)
-      contraction_trigger = 0;
-
-   if (target_root->s_ntype.s_root.s_cardinality <
-       contraction_trigger) {
-
-      target_root = set_contract_header(SETL_SYSTEM target_root);
-
-   }
-
    /* set the other target values */
 
    unmark_specifier(right);
-   right->sp_form = ft_set;
-   right->sp_val.sp_set_ptr = target_root;
+   spec_set_form(right,ft_set);
+   spec_set_val(right,sp_set_ptr,target_root);
 
    if (target != NULL) {
-
       mark_specifier(left);
       unmark_specifier(target);
-      target->sp_form = left->sp_form;
-      target->sp_val.sp_biggest = left->sp_val.sp_biggest;
-
+      spec_set_form(target,spec_form(left));
+      spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
    }
 
    return;
 
 }
-
@@ -28,42 +28,75 @@
 
 #ifndef SETS_LOADED
 
+/* standard C header files */
+
+#include <stddef.h>                    /* standard definitions              */
+
+/* SETL2 system header files */
+
+#include "slabs.h"                     /* slabs                             */
+
 /* constants */
 
-#define SET_HASH_SIZE    4             /* set hash table size (each header) */
-#define SET_SHIFT_DIST   2             /* log (base 2) of SET_HASH_SIZE     */
-#define SET_CLASH_SIZE   3             /* average clash length which        */
-                                       /* triggers header expansion         */
-#define SET_HASH_MASK 0x03             /* pick out one level of header tree */
+#define SET_HASH_SIZE   32             /* children of each trie node        */
+#define SET_SHIFT_DIST   5             /* log (base 2) of SET_HASH_SIZE     */
+#define SET_HASH_MASK 0x1f             /* pick out one level of trie        */
+#define SET_MAX_DEPTH  ((int)(sizeof(int32) * 8 + SET_SHIFT_DIST - 1) / \
+                        SET_SHIFT_DIST)
+                                       /* levels needed to use every bit    */
+                                       /* of a hash code                    */
+#define SET_TABLE_SIZE   8             /* most cells kept in a small table  */
 
 /* set header node structure */
 
 struct set_h_item {
    int32 s_use_count;                  /* usage count                       */
    int32 s_hash_code;                  /* hash code                         */
-   union {
-      struct {                         /* root header info                  */
-         int32 s_cardinality;          /* number of elements in set         */
-         int s_height;                 /* height of header tree             */
-      } s_root;
-      struct {                         /* internal node info                */
-         struct set_h_item *s_parent;  /* parent in header tree             */
-         int s_child_index;            /* index in parent's hash table      */
-      } s_intern;
-   } s_ntype;
-   union {
-      struct set_c_item *s_cell;       /* cell child pointer                */
-      struct set_h_item *s_header;     /* internal header node pointer      */
-   } s_child[SET_HASH_SIZE];
+   int32 s_cardinality;                /* number of elements in set         */
+   struct set_n_item *s_trie;          /* root of hash trie, NULL if empty  */
 };
 
 typedef struct set_h_item *set_h_ptr_type;
                                        /* header node pointer               */
 
+/*
+ *  Set elements are stored in a hash array mapped trie.  Each trie node
+ *  uses SET_SHIFT_DIST bits of an element's hash code, starting with the
+ *  low order bits at the root, to select one of SET_HASH_SIZE slots.  A
+ *  slot may hold a list of cells whose elements have exactly the same
+ *  hash code, or a subtrie.  We only allocate space for the slots in
+ *  use: the two bit maps tell us which slots are occupied, and the
+ *  entry array holds the cell lists, in slot order, followed by the
+ *  subtries, in slot order.  The position of a slot's entry is found by
+ *  counting the bits below it in the appropriate map.
+ *
+ *  Copying a set does not copy its trie.  The copy shares the root,
+ *  and each node and small table counts the parents and headers which
+ *  point to it.  Before we change a node with more than one of those we
+ *  give the changing set a private copy, which shares the subtries of
+ *  the original, so an update copies only the path from the root to the
+ *  changed slot.  Cells are never shared: a copied node copies the cell
+ *  lists it holds.
+ */
+
+struct set_n_item {
+   unsigned int s_datamap;             /* slots holding cell lists          */
+   unsigned int s_nodemap;             /* slots holding subtries            */
+   int32 s_use_count;                  /* usage count                       */
+   short s_cell_size;                  /* size of a set or map cell         */
+   union {
+      struct set_c_item *s_cell;       /* cell list pointer                 */
+      struct set_n_item *s_node;       /* subtrie pointer                   */
+   } s_entry[1];                       /* occupied slots (variable length)  */
+};
+
+typedef struct set_n_item *set_n_ptr_type;
+                                       /* trie node pointer                 */
+
 /* set cell node structure */
 
 struct set_c_item {
-   struct set_c_item *s_next;          /* next cell on clash list           */
+   struct set_c_item *s_next;          /* next cell with same hash code     */
    int32 s_hash_code;                  /* element's full hash code          */
    struct specifier_item s_spec;       /* element specifier                 */
 };
@@ -71,24 +104,116 @@ struct set_c_item {
 typedef struct set_c_item *set_c_ptr_type;
                                        /* cell node pointer                 */
 
+/*
+ *  Small sets and maps do not need a trie.  Until it holds more than
+ *  SET_TABLE_SIZE elements the root of a trie is a small table instead,
+ *  which holds the cells themselves, packed in one block.  The table
+ *  begins with two zero bit maps, which no trie node has, so we can
+ *  tell the two apart.  A table cell has no next pointer, and we store
+ *  only the rest of the cell, so the cell pointer we give out for a
+ *  table entry points that far in front of it.  Nobody may use the next
+ *  pointer of such a cell.  Tables are sized exactly and searched from
+ *  the start, comparing hash codes first.
+ */
+
+struct set_t_item {
+   unsigned int s_datamap;             /* always zero in a table            */
+   unsigned int s_nodemap;             /* always zero in a table            */
+   int32 s_use_count;                  /* usage count                       */
+   short s_cell_size;                  /* size of a set or map cell         */
+   short s_count;                      /* number of cells in table          */
+};
+
+typedef struct set_t_item *set_t_ptr_type;
+                                       /* small table pointer               */
+
+/* set iteration cursor */
+
+struct set_cursor_item {
+   set_n_ptr_type sc_node[SET_MAX_DEPTH];
+                                       /* trie nodes from root down         */
+   int sc_index[SET_MAX_DEPTH];        /* next entry in each node           */
+   int sc_depth;                       /* current depth, -1 when done       */
+   set_c_ptr_type sc_cell;             /* rest of the current cell list     */
+};
+
+/* trie node bit manipulation */
+
+#if (defined(__GNUC__) && __GNUC__ >= 4) || defined(__clang__)
+#define set_bit_count(m) __builtin_popcount(m)
+#else
+#define set_bit_count(m) set_count_bits(m)
+#endif
+
+#define set_hash_bit(h,d) \
+   (1U << (int)(((unsigned long)(h) >> ((d) * SET_SHIFT_DIST)) & \
+                SET_HASH_MASK))
+
+#define set_node_size(n) \
+   (sizeof(struct set_n_item) + \
+    ((n) - 1) * sizeof(set_c_ptr_type))
+
+#define set_node_entries(n) \
+   (set_bit_count((n)->s_datamap) + set_bit_count((n)->s_nodemap))
+
+/* small table layout */
+
+#define SET_CELL_OFFSET offsetof(struct set_c_item,s_hash_code)
+                                       /* part of a cell left out of tables */
+
+#define set_is_table(n) \
+   (((n)->s_datamap | (n)->s_nodemap) == 0)
+
+#define set_table_cell(t,i) \
+   ((set_c_ptr_type)((char *)(t) + sizeof(struct set_t_item) - \
+                     SET_CELL_OFFSET + \
+                     (size_t)(i) * ((t)->s_cell_size - SET_CELL_OFFSET)))
+
+#define set_table_entries(n,c) \
+   ((int)((sizeof(struct set_t_item) + (size_t)(n) * \
+           ((c) - SET_CELL_OFFSET) - sizeof(struct set_n_item) + \
+           sizeof(set_c_ptr_type) - 1) / sizeof(set_c_ptr_type)) + 1)
+
+#define free_set_table(t) \
+   free_set_node((set_n_ptr_type)(t), \
+                 set_table_entries((t)->s_count,(t)->s_cell_size))
+
+/*
+ *  Tables are allocated from the trie node slab classes, so we need a
+ *  class for each table size, in node entries.  Map cells are the
+ *  largest, with two specifiers.
+ */
+
+#define SET_NODE_LISTS \
+   (SET_HASH_SIZE + 2 + SET_TABLE_SIZE * \
+    (3 * sizeof(struct specifier_item) / sizeof(set_c_ptr_type)))
+
 /* global data */
 
 #ifdef TSAFE
-#define SET_H_NEXT_FREE plugin_instance->set_h_next_free 
-#define SET_C_NEXT_FREE plugin_instance->set_c_next_free 
+#define SET_H_SLAB plugin_instance->set_h_slab
+#define SET_N_SLAB plugin_instance->set_n_slab
+#define SET_C_SLAB plugin_instance->set_c_slab
 #else
-#define SET_H_NEXT_FREE set_h_next_free 
-#define SET_C_NEXT_FREE set_c_next_free 
+#define SET_H_SLAB set_h_slab
+#define SET_N_SLAB set_n_slab
+#define SET_C_SLAB set_c_slab
 
 #ifdef SHARED
 
-set_h_ptr_type set_h_next_free = NULL; /* next free header                  */
-set_c_ptr_type set_c_next_free = NULL; /* next free cell                    */
+struct slab_class_item set_h_slab;     /* header slabs                      */
+struct slab_class_item set_n_slab[SET_NODE_LISTS];
+                                       /* node slabs, by entry count        */
+struct slab_class_item set_c_slab;     /* cell slabs                        */
 
 #else
 
-extern set_h_ptr_type set_h_next_free; /* next free header                  */
-extern set_c_ptr_type set_c_next_free; /* next free cell                    */
+extern struct slab_class_item set_h_slab;
+                                       /* header slabs                      */
+extern struct slab_class_item set_n_slab[SET_NODE_LISTS];
+                                       /* node slabs, by entry count        */
+extern struct slab_class_item set_c_slab;
+                                       /* cell slabs                        */
 
 #endif
 #endif
@@ -105,6 +230,14 @@ extern set_c_ptr_type set_c_next_free; /* next free cell                    */
 
 #define free_set_header(s) free(s)
 
+#define get_set_node(t,n) {\
+   t = (set_n_ptr_type)malloc(set_node_size(n));\
+   if (t == NULL)\
+      giveup(SETL_SYSTEM msg_malloc_error);\
+}
+
+#define free_set_node(s,n) free(s)
+
 #define get_set_cell(t) {\
    t = (set_c_ptr_type)malloc(sizeof(struct set_c_item));\
    if (t == NULL)\
@@ -115,47 +248,62 @@ extern set_c_ptr_type set_c_next_free; /* next free cell                    */
 
 #else
 
-#define get_set_header(t) {\
-   if (SET_H_NEXT_FREE == NULL) alloc_set_headers(SETL_SYSTEM_VOID); \
-   t = SET_H_NEXT_FREE; \
-   SET_H_NEXT_FREE = *((set_h_ptr_type *)(SET_H_NEXT_FREE)); \
-}
+#define get_set_header(t) \
+   slab_get(SET_H_SLAB,"set header",set_h_ptr_type,t,\
+            sizeof(struct set_h_item))
 
-#define free_set_header(s) {\
-   *((set_h_ptr_type *)(s)) = SET_H_NEXT_FREE; \
-   SET_H_NEXT_FREE = s; \
-}
+#define free_set_header(s) slab_put(s)
+
+/* allocate and free trie nodes with n entries */
+
+#define get_set_node(t,n) \
+   slab_get(SET_N_SLAB[n],"set node",set_n_ptr_type,t,set_node_size(n))
+
+#define free_set_node(s,n) slab_put(s)
 
 /* allocate and free cell nodes */
 
-#define get_set_cell(t) {\
-   if (SET_C_NEXT_FREE == NULL) alloc_set_cells(SETL_SYSTEM_VOID); \
-   t = SET_C_NEXT_FREE; \
-   SET_C_NEXT_FREE = *((set_c_ptr_type *)(SET_C_NEXT_FREE)); \
-}
+#define get_set_cell(t) \
+   slab_get(SET_C_SLAB,"set cell",set_c_ptr_type,t,\
+            sizeof(struct set_c_item))
 
-#define free_set_cell(s) {\
-   *((set_c_ptr_type *)(s)) = SET_C_NEXT_FREE; \
-   SET_C_NEXT_FREE = s; \
-}
+#define free_set_cell(s) slab_put(s)
 #endif
 
 /* public function declarations */
 
-void alloc_set_headers(SETL_SYSTEM_PROTO_VOID);         
-                                       /* allocate a block of header nodes  */
-void alloc_set_cells(SETL_SYSTEM_PROTO_VOID); 
-                                       /* allocate a block of cell nodes    */
+int set_count_bits(unsigned int);      /* count bits in a trie bit map      */
+set_c_ptr_type set_lookup(SETL_SYSTEM_PROTO
+                          set_n_ptr_type, struct specifier_item *, int32);
+                                       /* find an element in a trie         */
+set_c_ptr_type set_locate(SETL_SYSTEM_PROTO
+                          set_n_ptr_type *, struct specifier_item *, int32,
+                          int, int *);
+                                       /* find or add an element            */
+set_c_ptr_type set_unlink(SETL_SYSTEM_PROTO
+                          set_n_ptr_type *, struct specifier_item *, int32);
+                                       /* remove an element from a trie     */
+set_c_ptr_type set_update(SETL_SYSTEM_PROTO
+                          set_n_ptr_type *, struct specifier_item *, int32);
+                                       /* find an element to be changed     */
+void set_cursor_start(struct set_cursor_item *, set_n_ptr_type);
+                                       /* start iterating over a trie       */
+set_c_ptr_type set_cursor_next(struct set_cursor_item *);
+                                       /* next cell in a trie               */
 void free_set(SETL_SYSTEM_PROTO set_h_ptr_type);   
                                        /* free memory used by set           */
+void release_set_trie(SETL_SYSTEM_PROTO set_n_ptr_type, int32 *);
+                                       /* free an unused trie node          */
 set_h_ptr_type null_set(SETL_SYSTEM_PROTO_VOID);
                                        /* return an empty set               */
 set_h_ptr_type copy_set(SETL_SYSTEM_PROTO set_h_ptr_type);
                                        /* copy a set structure              */
-set_h_ptr_type set_expand_header(SETL_SYSTEM_PROTO set_h_ptr_type);
-                                       /* expand the header size            */
-set_h_ptr_type set_contract_header(SETL_SYSTEM_PROTO set_h_ptr_type);
-                                       /* reduce the header size            */
+int set_insert(SETL_SYSTEM_PROTO
+               set_h_ptr_type, struct specifier_item *, int32);
+                                       /* add an element to a set           */
+int set_remove(SETL_SYSTEM_PROTO
+               set_h_ptr_type, struct specifier_item *, int32);
+                                       /* remove an element from a set      */
 void set_union(SETL_SYSTEM_PROTO 
                struct specifier_item *, struct specifier_item *,
                struct specifier_item *);
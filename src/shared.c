@@ -76,6 +76,9 @@
 #include "slots.h"                     /* procedures                        */
 #include "x_files.h"                   /* files                             */
 #include "iters.h"                     /* iterators                         */
+#include "slabs.h"                     /* slabs                             */
+#include "workers.h"                   /* workers                           */
+#include "reactor.h"                   /* blocked processes                 */
 #include "axobj.h"
 
 /* Pull in the header files defined both in the compiler and the 
@@ -32,6 +32,8 @@ typedef struct plugin_item *plugin_item_ptr_type;
 #include "x_reals.h"
 #include "x_strngs.h"
 #include "libman.h"
+#include "workers.h"
+#include "reactor.h"
 #endif
 
 struct plugin_item {
@@ -61,34 +63,55 @@ struct plugin_item {
    int opcode_executed;
    int32 opcode_count;
    int32 process_slice;
+   int32 slice_msecs;
    int eval_package;
    char abend_message[8000];
    int nested_calls;
    int32 wait_flag;
    specifier symbol_map;
 
-   file_ptr_type file_next_free;
-   integer_h_ptr_type integer_h_next_free;
-   integer_c_ptr_type integer_c_next_free;
-   string_h_ptr_type string_h_next_free;
-   string_c_ptr_type string_c_next_free;
-   mailbox_h_ptr_type mailbox_h_next_free;
-   mailbox_c_ptr_type mailbox_c_next_free;
-   process_ptr_type process_next_free;
-   request_ptr_type request_next_free;
+   struct free_item *free_stack;
+   int32 free_stack_top;
+   int32 free_stack_max;
+   int free_draining;
+   int defer_free;
+
+   struct worker_item *worker_head;
+   int worker_running;
+   int worker_limit;
+
+   int reactor_fd;
+   int reactor_watched;
+   int reactor_blocked;
+   long reactor_now;
+
+   long sched_start;
+   int32 sched_opcodes;
+   long sched_boost;
+   double sched_rate;
+   long sched_run_usecs;
+   int32 sched_run_opcodes;
+
+   slab_class_ptr_type slab_classes;
+   struct slab_class_item file_slab;
+   struct slab_class_item integer_h_slab;
+   struct slab_class_item string_h_slab;
+   struct slab_class_item mailbox_h_slab;
+   struct slab_class_item mailbox_c_slab;
+   struct slab_class_item process_slab;
+   struct slab_class_item request_slab;
    int32 total_slot_count;
-   iter_ptr_type iter_next_free;
-   set_h_ptr_type set_h_next_free;
-   set_c_ptr_type set_c_next_free;
-   map_h_ptr_type map_h_next_free;
-   map_c_ptr_type map_c_next_free;
-   tuple_h_ptr_type tuple_h_next_free;
-   tuple_c_ptr_type tuple_c_next_free;
-   i_real_ptr_type real_next_free;
-   proc_ptr_type proc_next_free;
-   object_h_ptr_type object_h_next_free;
-   object_c_ptr_type object_c_next_free;
-   self_stack_ptr_type self_stack_next_free;
+   struct slab_class_item iter_slab;
+   struct slab_class_item set_h_slab;
+   struct slab_class_item set_n_slab[SET_NODE_LISTS];
+   struct slab_class_item set_c_slab;
+   struct slab_class_item map_h_slab;
+   struct slab_class_item map_c_slab;
+   struct slab_class_item tuple_h_slab;
+   struct slab_class_item proc_slab;
+   struct slab_class_item object_h_slab;
+   struct slab_class_item object_c_slab;
+   struct slab_class_item self_stack_slab;
 #endif
 
 #if COMPILER || DYNAMIC_COMP
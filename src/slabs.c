@@ -0,0 +1,514 @@
+/*\
+ *
+ *  % MIT License
+ *  %
+ *  % Copyright (c) 1990 W. Kirk Snyder
+ *  %
+ *  % Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  % of this software and associated documentation files (the "Software"), to deal
+ *  % in the Software without restriction, including without limitation the rights
+ *  % to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  % copies of the Software, and to permit persons to whom the Software is
+ *  % furnished to do so, subject to the following conditions:
+ *  % 
+ *  % The above copyright notice and this permission notice shall be included in all
+ *  % copies or substantial portions of the Software.
+ *  %
+ *  % THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  % IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  % FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  % AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  % LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  % OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  % SOFTWARE.
+ *  %
+ *
+ *  \package{Slabs}
+ *
+ *  This package allocates the fixed size nodes of the interpreter: set,
+ *  map and tuple nodes, long integer and string headers, objects,
+ *  processes, mailboxes, iterators and files.  Each node type has a
+ *  slab class, and the allocation and release macros take items from
+ *  and give them back to the slabs of that class.  The functions here
+ *  are the slow paths of those macros, which add a slab to a class and
+ *  release empty slabs, and the statistics we keep for each class.
+ *
+ *  \texify{slabs.h}
+ *
+ *  \packagebody{Slabs}
+\*/
+
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation and qsort       */
+#include <string.h>                    /* strcmp                            */
+
+/* SETL2 system header files */
+
+#include "system.h"                    /* SETL2 system constants            */
+#include "interp.h"                    /* SETL2 interpreter constants       */
+#include "giveup.h"                    /* severe error handler              */
+#include "messages.h"                  /* error messages                    */
+#include "form.h"                      /* form codes                        */
+#include "builtins.h"                  /* built-in symbols                  */
+#include "specs.h"                     /* specifiers                        */
+#include "x_strngs.h"                  /* strings                           */
+#include "tuples.h"                    /* tuples                            */
+#include "slabs.h"                     /* slabs                             */
+
+/* memory mapping, where the system has it */
+
+#if UNIX
+#include <sys/types.h>                 /* system types                      */
+#include <sys/mman.h>                  /* memory mapping                    */
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+/*
+ *  Items start after the slab header, and are a multiple of the size of
+ *  a real, so each is aligned well enough for any node.
+ */
+
+#define SLAB_ALIGN         sizeof(double)
+#define SLAB_HEADER_SIZE \
+   ((sizeof(struct slab_item) + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1))
+
+/* statistics for one node type */
+
+struct slab_stat_item {
+   char *ss_name;                      /* node type                         */
+   int32 ss_live;                      /* items allocated                   */
+   int32 ss_free;                      /* items free in slabs we hold       */
+   int32 ss_peak;                      /* most items ever allocated         */
+   int32 ss_slabs;                     /* slabs we hold                     */
+};
+
+/* forward declarations */
+
+static slab_ptr_type slab_map(SETL_SYSTEM_PROTO_VOID);
+                                       /* get an aligned slab               */
+static void slab_unmap(slab_ptr_type); /* give a slab back                  */
+static int32 slab_gather(SETL_SYSTEM_PROTO struct slab_stat_item **);
+                                       /* statistics by node type           */
+static int slab_compare(const void *, const void *);
+                                       /* order statistics by name          */
+static void append_stat(SETL_SYSTEM_PROTO tuple_h_ptr_type, specifier *);
+                                       /* add an element to a result tuple  */
+
+/*\
+ *  \function{slab\_grow()}
+ *
+ *  This function adds a slab to a class, and is called by the
+ *  \verb"slab_get()" macro when no slab in the class has a free item.  A
+ *  class has no storage until its first item is allocated, so the first
+ *  call also sets the item size and puts the class on the list we use
+ *  for statistics.  If freeing is deferred we release a step of it
+ *  first, which may give us an item without mapping a slab.
+\*/
+
+void slab_grow(
+   SETL_SYSTEM_PROTO
+   slab_class_ptr_type class_ptr,      /* class to be enlarged              */
+   char *name,                         /* node type                         */
+   size_t item_size)                   /* bytes in each item                */
+
+{
+slab_ptr_type slab_ptr;                /* new slab                          */
+char *item_ptr;                        /* item to be linked                 */
+int32 i;                               /* temporary looping variable        */
+
+   /* set up the class on first use */
+
+   if (class_ptr->sc_name == NULL) {
+
+      if (item_size < sizeof(void *))
+         item_size = sizeof(void *);
+      item_size = (item_size + SLAB_ALIGN - 1) & ~(SLAB_ALIGN - 1);
+
+      class_ptr->sc_name = name;
+      class_ptr->sc_item_size = item_size;
+      class_ptr->sc_per_slab =
+         (int32)((SLAB_SIZE - SLAB_HEADER_SIZE) / item_size);
+      if (class_ptr->sc_per_slab < 1)
+         giveup(SETL_SYSTEM msg_malloc_error);
+
+      class_ptr->sc_next = SLAB_CLASSES;
+      SLAB_CLASSES = class_ptr;
+
+   }
+
+   /* deferred releases may give us the room we need */
+
+   if (FREE_STACK_TOP > 0) {
+
+      free_drain(SETL_SYSTEM NO);
+      if (class_ptr->sc_partial != NULL)
+         return;
+
+   }
+
+   /* link the items of a new slab on its free list */
+
+   slab_ptr = slab_map(SETL_SYSTEM_VOID);
+   slab_ptr->sl_class = class_ptr;
+   slab_ptr->sl_in_use = 0;
+
+   item_ptr = (char *)slab_ptr + SLAB_HEADER_SIZE;
+   slab_ptr->sl_free = (void *)item_ptr;
+   for (i = 1; i < class_ptr->sc_per_slab; i++) {
+      *((void **)item_ptr) = (void *)(item_ptr + class_ptr->sc_item_size);
+      item_ptr += class_ptr->sc_item_size;
+   }
+   *((void **)item_ptr) = NULL;
+
+   /* the new slab is the only one with free items */
+
+   slab_ptr->sl_prev = NULL;
+   slab_ptr->sl_next = NULL;
+   class_ptr->sc_partial = slab_ptr;
+   class_ptr->sc_slabs++;
+   class_ptr->sc_empty++;
+
+   return;
+
+}
+
+/*\
+ *  \function{slab\_return()}
+ *
+ *  This function is called by the \verb"slab_put()" macro when an item is
+ *  released into a slab which was full or which it leaves empty.  A
+ *  slab which was full goes back on the list of slabs with free items.
+ *  An empty slab is given back to the operating system unless the class
+ *  has too few empty slabs, so that a program which repeatedly builds
+ *  and releases one node does not map and unmap a slab each time.
+\*/
+
+void slab_return(
+   SETL_SYSTEM_PROTO
+   slab_ptr_type slab_ptr)             /* slab receiving an item            */
+
+{
+slab_class_ptr_type class_ptr;         /* class of slab                     */
+
+   class_ptr = slab_ptr->sl_class;
+
+   /* if the released item is the only free one the slab was full */
+
+   if (*((void **)(slab_ptr->sl_free)) == NULL) {
+
+      slab_ptr->sl_prev = NULL;
+      slab_ptr->sl_next = class_ptr->sc_partial;
+      if (class_ptr->sc_partial != NULL)
+         class_ptr->sc_partial->sl_prev = slab_ptr;
+      class_ptr->sc_partial = slab_ptr;
+
+   }
+
+   if (slab_ptr->sl_in_use > 0)
+      return;
+
+   if (class_ptr->sc_empty < SLAB_KEEP_EMPTY) {
+      class_ptr->sc_empty++;
+      return;
+   }
+
+   /* unlink the slab and give it back */
+
+   if (slab_ptr->sl_prev != NULL)
+      slab_ptr->sl_prev->sl_next = slab_ptr->sl_next;
+   else
+      class_ptr->sc_partial = slab_ptr->sl_next;
+   if (slab_ptr->sl_next != NULL)
+      slab_ptr->sl_next->sl_prev = slab_ptr->sl_prev;
+
+   class_ptr->sc_slabs--;
+   slab_unmap(slab_ptr);
+
+   return;
+
+}
+
+/*\
+ *  \function{slab\_map()}
+ *
+ *  This function gets a slab aligned on a multiple of its size.  Where we
+ *  can we map anonymous memory, so that releasing a slab really does
+ *  give it back to the operating system.  Neither mapping nor
+ *  \verb"malloc()" promise that alignment, so we ask for twice the slab
+ *  size and use the aligned part of it.
+\*/
+
+static slab_ptr_type slab_map(
+   SETL_SYSTEM_PROTO_VOID)
+
+{
+char *block;                           /* block we get                      */
+char *slab;                            /* aligned slab within block         */
+
+#if UNIX
+
+   block = (char *)mmap(NULL,(size_t)(2 * SLAB_SIZE),PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS,-1,(off_t)0);
+   if (block == (char *)MAP_FAILED)
+      giveup(SETL_SYSTEM msg_malloc_error);
+
+   /* unmap the parts on either side of the slab */
+
+   slab = (char *)slab_of(block + SLAB_SIZE - 1);
+   if (slab > block)
+      munmap((void *)block,(size_t)(slab - block));
+   if (slab + SLAB_SIZE < block + 2 * SLAB_SIZE)
+      munmap((void *)(slab + SLAB_SIZE),
+             (size_t)(block + SLAB_SIZE - slab));
+
+   ((slab_ptr_type)slab)->sl_block = NULL;
+
+#else
+
+   block = (char *)malloc((size_t)(2 * SLAB_SIZE));
+   if (block == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+
+   slab = (char *)slab_of(block + SLAB_SIZE - 1);
+   ((slab_ptr_type)slab)->sl_block = (void *)block;
+
+#endif
+
+   return (slab_ptr_type)slab;
+
+}
+
+/*\
+ *  \function{slab\_unmap()}
+ *
+ *  This function gives a slab back to the operating system.
+\*/
+
+static void slab_unmap(
+   slab_ptr_type slab_ptr)             /* slab to be released               */
+
+{
+
+#if UNIX
+
+   munmap((void *)slab_ptr,(size_t)SLAB_SIZE);
+
+#else
+
+   free(slab_ptr->sl_block);
+
+#endif
+
+   return;
+
+}
+
+/*\
+ *  \function{slab\_gather()}
+ *
+ *  This function collects the statistics of each node type into an
+ *  array sorted by name, and returns the number of node types.  Some
+ *  node types have a class for each node size.  We add their counts,
+ *  so the peak of such a type is the sum of the peaks of its classes,
+ *  which may be more than it ever had live at once.  We finish any
+ *  deferred releases first, so nothing dead is counted as live.  The
+ *  caller must free the array.
+\*/
+
+static int32 slab_gather(
+   SETL_SYSTEM_PROTO
+   struct slab_stat_item **stats)      /* returned statistics               */
+
+{
+slab_class_ptr_type class_ptr;         /* class we are counting             */
+struct slab_stat_item *stat_ptr;       /* statistics of a node type         */
+int32 class_count;                     /* classes in use                    */
+int32 type_count;                      /* node types found                  */
+int32 i;                               /* temporary looping variable        */
+
+   free_drain(SETL_SYSTEM YES);
+
+   class_count = 0;
+   for (class_ptr = SLAB_CLASSES;
+        class_ptr != NULL;
+        class_ptr = class_ptr->sc_next)
+      class_count++;
+
+   *stats = (struct slab_stat_item *)malloc(
+         (size_t)((class_count + 1) * sizeof(struct slab_stat_item)));
+   if (*stats == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+
+   type_count = 0;
+   for (class_ptr = SLAB_CLASSES;
+        class_ptr != NULL;
+        class_ptr = class_ptr->sc_next) {
+
+      for (i = 0;
+           i < type_count && strcmp((*stats)[i].ss_name,
+                                    class_ptr->sc_name) != 0;
+           i++);
+
+      stat_ptr = *stats + i;
+      if (i == type_count) {
+         stat_ptr->ss_name = class_ptr->sc_name;
+         stat_ptr->ss_live = stat_ptr->ss_free = 0;
+         stat_ptr->ss_peak = stat_ptr->ss_slabs = 0;
+         type_count++;
+      }
+
+      stat_ptr->ss_live += class_ptr->sc_live;
+      stat_ptr->ss_free += class_ptr->sc_slabs * class_ptr->sc_per_slab -
+                           class_ptr->sc_live;
+      stat_ptr->ss_peak += class_ptr->sc_peak;
+      stat_ptr->ss_slabs += class_ptr->sc_slabs;
+
+   }
+
+   qsort((void *)*stats,(size_t)type_count,sizeof(struct slab_stat_item),
+         slab_compare);
+
+   return type_count;
+
+}
+
+/*\
+ *  \function{slab\_compare()}
+ *
+ *  This function orders node type statistics by name, for
+ *  \verb"qsort()".
+\*/
+
+static int slab_compare(
+   const void *left,                   /* left statistics                   */
+   const void *right)                  /* right statistics                  */
+
+{
+
+   return strcmp(((struct slab_stat_item *)left)->ss_name,
+                 ((struct slab_stat_item *)right)->ss_name);
+
+}
+
+/*\
+ *  \function{slab\_statistics()}
+ *
+ *  This function prints the live, free and peak item counts and the slabs
+ *  held for each node type, for \verb"stlx --alloc-stats" at the end of
+ *  a run.
+\*/
+
+void slab_statistics(
+   SETL_SYSTEM_PROTO_VOID)
+
+{
+struct slab_stat_item *stats;          /* statistics by node type           */
+int32 type_count;                      /* node types found                  */
+int32 i;                               /* temporary looping variable        */
+
+   type_count = slab_gather(SETL_SYSTEM &stats);
+
+   fprintf(DEBUG_FILE,"%-16s %10s %10s %10s %8s\n",
+           "node type","live","free","peak","slabs");
+   for (i = 0; i < type_count; i++) {
+      fprintf(DEBUG_FILE,"%-16s %10ld %10ld %10ld %8ld\n",
+              stats[i].ss_name,(long)stats[i].ss_live,
+              (long)stats[i].ss_free,(long)stats[i].ss_peak,
+              (long)stats[i].ss_slabs);
+   }
+
+   free((void *)stats);
+
+   return;
+
+}
+
+/*\
+ *  \function{setl2\_memory\_stats()}
+ *
+ *  This function is the \verb"memory_stats" built-in function.  It
+ *  returns a tuple with a tuple for each node type,
+ *  \verb"[name, live, free, peak, slabs]", ordered by name.  We take
+ *  the counts before we build the result, so they do not include the
+ *  result itself.
+\*/
+
+void setl2_memory_stats(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector                   */
+   specifier *target)                  /* return value                      */
+
+{
+struct slab_stat_item *stats;          /* statistics by node type           */
+int32 type_count;                      /* node types found                  */
+tuple_h_ptr_type tuple_root;           /* returned tuple                    */
+tuple_h_ptr_type stat_root;            /* tuple for one node type           */
+specifier spare;                       /* element being added               */
+int32 i;                               /* temporary looping variable        */
+
+   type_count = slab_gather(SETL_SYSTEM &stats);
+
+   tuple_root = new_tuple(SETL_SYSTEM_VOID);
+   for (i = 0; i < type_count; i++) {
+
+      stat_root = new_tuple(SETL_SYSTEM_VOID);
+
+      spec_set_form(&spare,ft_string);
+      spec_set_val(&spare,sp_string_ptr,
+                   new_string(SETL_SYSTEM stats[i].ss_name));
+      append_stat(SETL_SYSTEM stat_root,&spare);
+
+      spec_set_form(&spare,ft_short);
+      spec_set_val(&spare,sp_short_value,stats[i].ss_live);
+      append_stat(SETL_SYSTEM stat_root,&spare);
+      spec_set_val(&spare,sp_short_value,stats[i].ss_free);
+      append_stat(SETL_SYSTEM stat_root,&spare);
+      spec_set_val(&spare,sp_short_value,stats[i].ss_peak);
+      append_stat(SETL_SYSTEM stat_root,&spare);
+      spec_set_val(&spare,sp_short_value,stats[i].ss_slabs);
+      append_stat(SETL_SYSTEM stat_root,&spare);
+
+      spec_set_form(&spare,ft_tuple);
+      spec_set_val(&spare,sp_tuple_ptr,stat_root);
+      append_stat(SETL_SYSTEM tuple_root,&spare);
+
+   }
+
+   free((void *)stats);
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,tuple_root);
+
+   return;
+
+}
+
+/*\
+ *  \function{append\_stat()}
+ *
+ *  This function appends an element to a tuple we are building, taking
+ *  over the element's use count.
+\*/
+
+static void append_stat(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* tuple being built                 */
+   specifier *element)                 /* element to be added               */
+
+{
+tuple_c_ptr_type tuple_cell;           /* cell receiving element            */
+
+   reserve_tuple(tuple_root,tuple_root->t_length + 1);
+   tuple_cell = tuple_root->t_cells + tuple_root->t_length++;
+   tuple_cell->t_spec = *element;
+   spec_hash_code(tuple_cell->t_hash_code,element);
+   tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
+
+   return;
+
+}
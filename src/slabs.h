@@ -0,0 +1,152 @@
+/*\
+ *
+ *  % MIT License
+ *  %
+ *  % Copyright (c) 1990 W. Kirk Snyder
+ *  %
+ *  % Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  % of this software and associated documentation files (the "Software"), to deal
+ *  % in the Software without restriction, including without limitation the rights
+ *  % to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  % copies of the Software, and to permit persons to whom the Software is
+ *  % furnished to do so, subject to the following conditions:
+ *  % 
+ *  % The above copyright notice and this permission notice shall be included in all
+ *  % copies or substantial portions of the Software.
+ *  %
+ *  % THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  % IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  % FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  % AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  % LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  % OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  % SOFTWARE.
+ *  %
+ *
+ *  \packagespec{Slabs}
+\*/
+
+#ifndef SLABS_LOADED
+
+/* standard C header files */
+
+#include <stddef.h>                    /* size_t                            */
+
+/* performance tuning constants */
+
+#define SLAB_SIZE          65536       /* bytes in a slab, a power of two   */
+#define SLAB_KEEP_EMPTY        1       /* empty slabs we keep in each class */
+
+/*
+ *  Interpreter nodes of a given type come from a slab class.  A slab is
+ *  a block of \verb"SLAB_SIZE" bytes aligned on a multiple of its size,
+ *  which starts with a slab header and is carved into equal items, so
+ *  we can find the slab holding any item by masking its address.  Each
+ *  slab keeps its own free list, and a class keeps a list of the slabs
+ *  which have free items.  When a slab becomes empty we return it to
+ *  the operating system, unless the class has few empty slabs already,
+ *  so a long running program shrinks after a peak rather than holding
+ *  on to the most it ever used.
+ */
+
+struct slab_class_item;
+
+/* slab header structure */
+
+struct slab_item {
+   struct slab_class_item *sl_class;   /* class of items in slab            */
+   struct slab_item *sl_next;          /* next slab with free items         */
+   struct slab_item *sl_prev;          /* previous slab with free items     */
+   void *sl_free;                      /* list of free items                */
+   int32 sl_in_use;                    /* items allocated from slab         */
+   void *sl_block;                     /* block we allocated, if not mapped */
+};
+
+typedef struct slab_item *slab_ptr_type;
+                                       /* slab pointer                      */
+
+/* slab class structure */
+
+struct slab_class_item {
+   char *sc_name;                      /* node type, for statistics         */
+   size_t sc_item_size;                /* bytes in each item                */
+   int32 sc_per_slab;                  /* items in each slab                */
+   struct slab_item *sc_partial;       /* slabs with free items             */
+   struct slab_class_item *sc_next;    /* next class in use                 */
+   int32 sc_slabs;                     /* slabs we hold                     */
+   int32 sc_empty;                     /* slabs with no items allocated     */
+   int32 sc_live;                      /* items allocated                   */
+   int32 sc_peak;                      /* most items ever allocated         */
+};
+
+typedef struct slab_class_item *slab_class_ptr_type;
+                                       /* slab class pointer                */
+
+/* global data */
+
+#ifdef TSAFE
+#define SLAB_CLASSES plugin_instance->slab_classes
+#else
+#define SLAB_CLASSES slab_classes
+
+#ifdef SHARED
+
+slab_class_ptr_type slab_classes = NULL;
+                                       /* list of classes in use            */
+
+#else
+
+extern slab_class_ptr_type slab_classes;
+                                       /* list of classes in use            */
+
+#endif
+#endif
+
+/* the slab holding an item */
+
+#define slab_of(p) \
+   ((slab_ptr_type)((size_t)(p) & ~((size_t)SLAB_SIZE - 1)))
+
+/*
+ *  Allocate an item of type \verb"t" and size \verb"s" from class
+ *  \verb"c", naming the class \verb"n" if this is its first item.
+ */
+
+#define slab_get(c,n,t,p,s) {\
+   slab_ptr_type slab_get_slab; \
+   if ((c).sc_partial == NULL) slab_grow(SETL_SYSTEM &(c),n,(size_t)(s)); \
+   slab_get_slab = (c).sc_partial; \
+   p = (t)(slab_get_slab->sl_free); \
+   slab_get_slab->sl_free = *((void **)(slab_get_slab->sl_free)); \
+   if (slab_get_slab->sl_in_use++ == 0) (c).sc_empty--; \
+   if (slab_get_slab->sl_free == NULL) { \
+      (c).sc_partial = slab_get_slab->sl_next; \
+      if ((c).sc_partial != NULL) (c).sc_partial->sl_prev = NULL; \
+   } \
+   if (++(c).sc_live > (c).sc_peak) (c).sc_peak = (c).sc_live; \
+}
+
+/* release an item, giving back slabs which were full or are now empty */
+
+#define slab_put(p) {\
+   slab_ptr_type slab_put_slab; \
+   slab_put_slab = slab_of(p); \
+   *((void **)(p)) = slab_put_slab->sl_free; \
+   slab_put_slab->sl_free = (void *)(p); \
+   slab_put_slab->sl_class->sc_live--; \
+   if (--slab_put_slab->sl_in_use == 0 || \
+       *((void **)(slab_put_slab->sl_free)) == NULL) \
+      slab_return(SETL_SYSTEM slab_put_slab); \
+}
+
+/* public function declarations */
+
+void slab_grow(SETL_SYSTEM_PROTO slab_class_ptr_type, char *, size_t);
+                                       /* add a slab to a class             */
+void slab_return(SETL_SYSTEM_PROTO slab_ptr_type);
+                                       /* relink or release a slab          */
+void slab_statistics(SETL_SYSTEM_PROTO_VOID);
+                                       /* print allocation statistics       */
+
+#define SLABS_LOADED 1
+#endif
@@ -1,7 +1,8 @@
 /*\
  *  This macro makes a rough cut at an equality test.  If the two
  *  specifiers are short and equal we can determine equality without a
- *  procedure call.  If they are long but of different forms we also
+ *  procedure call.  Reals are kept in specifiers, so we can compare two
+ *  of them here too.  If they are long but of different forms we also
  *  avoid a procedure call.  Otherwise we resort to a more robust
  *  function.
 \*/
@@ -9,28 +10,27 @@
 #ifdef COERCE_EQUALITY
 #ifdef DIGITAL
 #define spec_equal(t,l,r) { \
-   if ((l)->sp_form == ft_omega && (r)->sp_form == ft_omega) t = 1; \
-   else if ( (l)->sp_form == (r)->sp_form && \
-           (  ( (l)->sp_form == ft_short && \
-                 (l)->sp_val.sp_short_value == (r)->sp_val.sp_short_value ) || \
-            ((l)->sp_val.sp_biggest == (r)->sp_val.sp_biggest))) t = 1; \
-   else if ((l)->sp_form == ft_real || (r)->sp_form == ft_real) \
+   if (spec_form(l) == ft_omega && spec_form(r) == ft_omega) t = 1; \
+   else if ( spec_form(l) == spec_form(r) && \
+           (  ( spec_form(l) == ft_short && \
+                 spec_val(l,sp_short_value) == spec_val(r,sp_short_value) ) || \
+            spec_same_bits(l,r))) t = 1; \
+   else if (spec_form(l) == ft_real || spec_form(r) == ft_real) \
    		t = spec_equal_test(SETL_SYSTEM l,r); \
-   else if ((l)->sp_form < ft_real || (r)->sp_form < ft_real) t = 0; \
-   else if (((l)->sp_form < ft_set || (r)->sp_form < ft_set) && \
-      (l)->sp_form != (r)->sp_form) t = 0; \
+   else if (spec_form(l) < ft_real || spec_form(r) < ft_real) t = 0; \
+   else if ((spec_form(l) < ft_set || spec_form(r) < ft_set) && \
+      spec_form(l) != spec_form(r)) t = 0; \
    else t = spec_equal_test(SETL_SYSTEM l,r); \
 }
 #else
 #define spec_equal(t,l,r) { \
-   if ((l)->sp_form == ft_omega && (r)->sp_form == ft_omega) t = 1; \
-   else if ((l)->sp_form == (r)->sp_form && \
-            (l)->sp_val.sp_biggest == (r)->sp_val.sp_biggest) t = 1; \
-   else if ((l)->sp_form == ft_real || (r)->sp_form == ft_real) \
+   if (spec_form(l) == ft_omega && spec_form(r) == ft_omega) t = 1; \
+   else if (spec_same_bits(l,r)) t = 1; \
+   else if (spec_form(l) == ft_real || spec_form(r) == ft_real) \
    		t = spec_equal_test(SETL_SYSTEM l,r); \
-   else if ((l)->sp_form < ft_real || (r)->sp_form < ft_real) t = 0; \
-   else if (((l)->sp_form < ft_set || (r)->sp_form < ft_set) && \
-      (l)->sp_form != (r)->sp_form) t = 0; \
+   else if (spec_form(l) < ft_real || spec_form(r) < ft_real) t = 0; \
+   else if ((spec_form(l) < ft_set || spec_form(r) < ft_set) && \
+      spec_form(l) != spec_form(r)) t = 0; \
    else t = spec_equal_test(SETL_SYSTEM l,r); \
 }
 #endif
@@ -39,24 +39,27 @@
 
 #ifdef DIGITAL
 #define spec_equal(t,l,r) { \
-   if ((l)->sp_form == ft_omega && (r)->sp_form == ft_omega) t = 1; \
-   else if ( (l)->sp_form == (r)->sp_form && \
-           (  ( (l)->sp_form == ft_short && \
-                 (l)->sp_val.sp_short_value == (r)->sp_val.sp_short_value ) || \
-            ((l)->sp_val.sp_biggest == (r)->sp_val.sp_biggest))) t = 1; \
-   else if ((l)->sp_form < ft_real || (r)->sp_form < ft_real) t = 0; \
-   else if (((l)->sp_form < ft_set || (r)->sp_form < ft_set) && \
-      (l)->sp_form != (r)->sp_form) t = 0; \
+   if (spec_form(l) == ft_omega && spec_form(r) == ft_omega) t = 1; \
+   else if ( spec_form(l) == spec_form(r) && \
+           (  ( spec_form(l) == ft_short && \
+                 spec_val(l,sp_short_value) == spec_val(r,sp_short_value) ) || \
+            spec_same_bits(l,r))) t = 1; \
+   else if (spec_form(l) == ft_real && spec_form(r) == ft_real) \
+      t = (spec_val(l,sp_real_value) == spec_val(r,sp_real_value)); \
+   else if (spec_form(l) < ft_real || spec_form(r) < ft_real) t = 0; \
+   else if ((spec_form(l) < ft_set || spec_form(r) < ft_set) && \
+      spec_form(l) != spec_form(r)) t = 0; \
    else t = spec_equal_test(SETL_SYSTEM l,r); \
 }
 #else
 #define spec_equal(t,l,r) { \
-   if ((l)->sp_form == ft_omega && (r)->sp_form == ft_omega) t = 1; \
-   else if ((l)->sp_form == (r)->sp_form && \
-            (l)->sp_val.sp_biggest == (r)->sp_val.sp_biggest) t = 1; \
-   else if ((l)->sp_form < ft_real || (r)->sp_form < ft_real) t = 0; \
-   else if (((l)->sp_form < ft_set || (r)->sp_form < ft_set) && \
-      (l)->sp_form != (r)->sp_form) t = 0; \
+   if (spec_form(l) == ft_omega && spec_form(r) == ft_omega) t = 1; \
+   else if (spec_same_bits(l,r)) t = 1; \
+   else if (spec_form(l) == ft_real && spec_form(r) == ft_real) \
+      t = (spec_val(l,sp_real_value) == spec_val(r,sp_real_value)); \
+   else if (spec_form(l) < ft_real || spec_form(r) < ft_real) t = 0; \
+   else if ((spec_form(l) < ft_set || spec_form(r) < ft_set) && \
+      spec_form(l) != spec_form(r)) t = 0; \
    else t = spec_equal_test(SETL_SYSTEM l,r); \
 }
 #endif
@@ -72,11 +75,11 @@
 \*/
 
 #define spec_hash_code(t,s) {\
-   if ((s)->sp_form == ft_omega) t = 0L; \
-   else if ((s)->sp_form <= ft_short) t = (s)->sp_val.sp_short_value; \
-   else if ((s)->sp_form <= ft_iter) t = (int32)((s)->sp_val.sp_biggest); \
-   else if ((s)->sp_form >= ft_tuple) t = \
-      (*((int32 *)((s)->sp_val.sp_biggest) + 1)); \
+   if (spec_form(s) == ft_omega) t = 0L; \
+   else if (spec_form(s) <= ft_short) t = spec_val(s,sp_short_value); \
+   else if (spec_form(s) <= ft_iter) t = (int32)(spec_ptr(s)); \
+   else if (spec_form(s) >= ft_tuple) t = \
+      (*((int32 *)(spec_ptr(s)) + 1)); \
    else t = spec_hash_code_calc(s); \
 }
 
@@ -35,6 +35,9 @@
 #if WATCOM
 #include <dos.h>                       /* DOS use macros                    */
 #endif
+#ifdef __SSE2__
+#include <emmintrin.h>                 /* SSE2 vector operations            */
+#endif
 
 /* SETL2 system header files */
 
@@ -57,9 +60,42 @@
 #include "objects.h"                   /* objects                           */
 #include "process.h"                   /* objects                           */
 #include "mailbox.h"                   /* objects                           */
+#include "reactor.h"                   /* blocked processes                 */
 #include "x_files.h"                   /* files                             */
 #include "iters.h"                     /* iterators                         */
 
+/* hash function constants */
+
+typedef unsigned long long hash_word;  /* 64 bit hash arithmetic            */
+
+#define HASH_LANES          8          /* words in a stripe                 */
+#define HASH_STRIPE_SIZE   64          /* bytes in a stripe                 */
+#define HASH_BLOCK_STRIPES 16          /* stripes between scrambles         */
+#define HASH_LONG_STRING  128          /* longer strings are read in        */
+                                       /* stripes                           */
+#define HASH_KEY_WORDS (HASH_BLOCK_STRIPES + HASH_LANES)
+                                       /* words of key derived from seed    */
+#define HASH_PRIME_1  0xa0761d6478bd642fULL
+#define HASH_PRIME_2  0xe7037ed1a0b428dbULL
+#define HASH_PRIME_3  0x8ebc6af09c88c6e3ULL
+#define HASH_PRIME_32 0x9e3779b1U      /* odd constants for mixing          */
+#define HASH_CODE_MASK ((int32)(~0UL >> 1))
+                                       /* clears the sign of a hash code    */
+
+static hash_word hash_key[HASH_KEY_WORDS];
+                                       /* keys derived from the seed        */
+static int hash_keys_set = NO;         /* YES once the keys are set         */
+
+/* forward function declarations */
+
+static hash_word hash_mum(hash_word, hash_word);
+                                       /* multiply and fold                 */
+static hash_word hash_mix(hash_word);  /* mix one word                      */
+static void release_object(SETL_SYSTEM_PROTO object_h_ptr_type, int32 *);
+                                       /* free an unused object             */
+static void release_mailbox(SETL_SYSTEM_PROTO mailbox_h_ptr_type, int32 *);
+                                       /* free an unused mailbox            */
+
 /*\
  *  \function{register\_type()}
  *
@@ -144,7 +180,7 @@ specifier *s;                          /* temporary looping variable        */
    /* initialize them to omega */
 
    for (s = return_ptr; s < return_ptr + count; s++)
-      s->sp_form = ft_omega;
+      spec_set_form(s,ft_omega);
 
    return return_ptr;
 
@@ -153,8 +189,10 @@ specifier *s;                          /* temporary looping variable        */
 /*\
  *  \function{free\_specifier()}
  *
- *  This function frees the memory used by a long data item.  In most
- *  cases we have to loop over cells and headers freeing each.
+ *  This function frees the memory used by a long data item.  Items
+ *  which hold other items, such as tuples, sets and objects, go on the
+ *  release stack, which loops over their cells and headers freeing
+ *  each.
 \*/
 
 void free_specifier(
@@ -164,26 +202,10 @@ void free_specifier(
 {
 iter_ptr_type iter_ptr;                /* iterator pointer                  */
 integer_h_ptr_type integer_hdr;        /* long integer root                 */
-integer_c_ptr_type integer_cell_1, integer_cell_2;
-                                       /* integer cell pointers             */
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell_1, string_cell_2;
-                                       /* string cell pointers              */
-tuple_h_ptr_type tuple_root, tuple_work_hdr, tuple_save_hdr;
-                                       /* tuple work headers                */
-set_h_ptr_type set_root, set_work_hdr, set_save_hdr;
-                                       /* set work headers                  */
-set_c_ptr_type set_cell_1, set_cell_2; /* set cell pointers                 */
-map_h_ptr_type map_root, map_work_hdr, map_save_hdr;
-                                       /* map work headers                  */
-map_c_ptr_type map_cell_1, map_cell_2; /* map cell pointers                 */
-object_h_ptr_type object_root, object_work_hdr, object_save_hdr;
-                                       /* object work headers               */
-unittab_ptr_type class_ptr;            /* object class                      */
-int height;                            /* working height of header tree     */
-int index;                             /* index within header hash table    */
+object_h_ptr_type object_root;         /* object header                     */
 
-   switch (spec->sp_form) {
+   switch (spec_form(spec)) {
 
 /*\
  *  \case{simple types}
@@ -193,13 +215,7 @@ int index;                             /* index within header hash table    */
 
 case ft_proc :
   
-   free_procedure(SETL_SYSTEM spec->sp_val.sp_proc_ptr);
-
-   return;
-
-case ft_real :
-
-   i_free_real(spec->sp_val.sp_real_ptr);
+   free_procedure(SETL_SYSTEM spec_val(spec,sp_proc_ptr));
 
    return;
 
@@ -213,7 +229,7 @@ case ft_iter :
 
 {
 
-   iter_ptr = spec->sp_val.sp_iter_ptr;
+   iter_ptr = spec_val(spec,sp_iter_ptr);
 
    /* release any specifiers locked by the iterator */
 
@@ -312,25 +328,16 @@ case ft_iter :
 /*\
  *  \case{long integers}
  *
- *  We free the linked list of cells and the header node.
+ *  We free the limb array and the header node.
 \*/
 
 case ft_long :
 
 {
 
-   integer_hdr = spec->sp_val.sp_long_ptr;
-
-   integer_cell_1 = integer_hdr->i_head;
-   while (integer_cell_1 != NULL) {
+   integer_hdr = spec_val(spec,sp_long_ptr);
 
-      integer_cell_2 = integer_cell_1;
-      integer_cell_1 = integer_cell_1->i_next;
-      free_integer_cell(integer_cell_2);
-
-   }
-
-   free_integer_header(integer_hdr);
+   free_interp_integer(SETL_SYSTEM integer_hdr);
 
    return;
 
@@ -339,53 +346,30 @@ case ft_long :
 /*\
  *  \case{mailboxes}
  *
- *  We free the linked list of cells and the header node.
+ *  The linked list of cells is released from the release stack.
 \*/
 
 case ft_mailbox :
 
-{      
-mailbox_h_ptr_type header;             /* mailbox header                    */
-mailbox_c_ptr_type t1,t2;              /* temporary looping variables       */
-
-   header = spec->sp_val.sp_mailbox_ptr;
-   t1 = header->mb_head;
-
-   while (t1 != NULL) {
-
-      t2 = t1;
-      t1 = t1->mb_next;
-      unmark_specifier(&(t2->mb_spec));
-      free_mailbox_cell(t2);
-
-   }
-
-   free_mailbox_header(header);
+   free_later(SETL_SYSTEM ft_mailbox,(void *)spec_val(spec,sp_mailbox_ptr));
 
    return;
 
-}
-
 /*\
  *  \case{strings}
  *
- *  We free the linked list of cells and the header node.
+ *  We free the character block, unless the characters are in the
+ *  header, and the header node.
 \*/
 
 case ft_string :
 
 {
 
-   string_hdr = spec->sp_val.sp_string_ptr;
-
-   string_cell_1 = string_hdr->s_head;
-   while (string_cell_1 != NULL) {
+   string_hdr = spec_val(spec,sp_string_ptr);
 
-      string_cell_2 = string_cell_1;
-      string_cell_1 = string_cell_1->s_next;
-      free_string_cell(string_cell_2);
-
-   }
+   if (string_hdr->s_chars != string_hdr->s_inline)
+      free((void *)(string_hdr->s_chars));
 
    free_string_header(string_hdr);
 
@@ -396,279 +380,244 @@ case ft_string :
 /*\
  *  \case{tuples}
  *
- *  We free cells and headers, using a normal algorithm to loop over the
- *  structure.
+ *  The tuple package knows how to release its element block.
 \*/
 
 case ft_tuple :
 
-{
-
-   tuple_root = spec->sp_val.sp_tuple_ptr;
+   free_tuple(SETL_SYSTEM spec_val(spec,sp_tuple_ptr));
 
-   /* we start iterating from the root, at the left of the header table */
+   return;
 
-   height = tuple_root->t_ntype.t_root.t_height;
-   tuple_work_hdr = tuple_root;
-   index = 0;
+/*\
+ *  \case{sets}
+ *
+ *  Sets and maps are hash tries, which the set and map packages know
+ *  how to release.
+\*/
 
-   /* delete nodes until we finish the tree */
+case ft_set :
 
-   for (;;) {
+   free_set(SETL_SYSTEM spec_val(spec,sp_set_ptr));
 
-      /* if we're at a leaf, delete all the tuple elements */
+   return;
 
-      if (!height) {
+/*\
+ *  \case{maps}
+\*/
 
-         for (index = 0; index < TUP_HEADER_SIZE; index++) {
+case ft_map :
 
-            if (tuple_work_hdr->t_child[index].t_cell != NULL) {
+   free_map(SETL_SYSTEM spec_val(spec,sp_map_ptr));
 
-               unmark_specifier(
-                  &((tuple_work_hdr->t_child[index].t_cell)->t_spec));
-               free_tuple_cell(tuple_work_hdr->t_child[index].t_cell);
+   return;
 
-            }
-         }
-      }
+/*\
+ *  \case{objects}
+ *
+ *  A process must leave the process pool at once.  The cells and
+ *  headers of objects are released from the release stack.
+\*/
 
-      /* if we've finished an internal node, move up */
+case ft_process :
 
-      if (index >= TUP_HEADER_SIZE) {
+{
+process_ptr_type process_ptr;
 
-         /* when we get back to the root we're finished */
+   object_root = spec_val(spec,sp_object_ptr);
 
-         if (tuple_work_hdr == tuple_root) {
-            break;
-         }
+   process_ptr = object_root->o_process_ptr;
+   reactor_release(SETL_SYSTEM process_ptr);
+   if (process_ptr->pc_sending) {
+      unmark_specifier(&(process_ptr->pc_wait_key));
+      unmark_specifier(&(process_ptr->pc_wait_return));
+   }
+   process_ptr->pc_prev->pc_next = process_ptr->pc_next;
+   process_ptr->pc_next->pc_prev = process_ptr->pc_prev;
+   free(process_ptr->pc_pstack);
+   free(process_ptr->pc_cstack);
 
-         height++;
-         index = tuple_work_hdr->t_ntype.t_intern.t_child_index + 1;
-         tuple_save_hdr = tuple_work_hdr;
-         tuple_work_hdr = tuple_work_hdr->t_ntype.t_intern.t_parent;
-         free_tuple_header(tuple_save_hdr);
+   free_later(SETL_SYSTEM ft_object,(void *)object_root);
 
-         continue;
+   return;
 
-      }
+}
 
-      /* if we can't move down, continue */
+case ft_object :
 
-      if (tuple_work_hdr->t_child[index].t_header == NULL) {
+   free_later(SETL_SYSTEM ft_object,(void *)spec_val(spec,sp_object_ptr));
 
-         index++;
-         continue;
+   return;
 
-      }
+case ft_opaque :
 
-      /* we can move down, so do so */
+{
+int typ;
+void *dest;
+   
+   /* Get the native type */
 
-      tuple_work_hdr = tuple_work_hdr->t_child[index].t_header;
-      index = 0;
-      height--;
+   typ = ((spec_val(spec,sp_opaque_ptr)->type) & 65535) -1;
 
-   }
+   if ((typ<0)||(typ>=NUM_REG_TYPES))
+        return;
 
-   free_tuple_header(tuple_root);
+   dest = REG_TYPES[typ].function;
+   if (dest)
+   	(*(void(*)(specifier *))dest)((specifier *)spec_val(spec,sp_opaque_ptr));
 
-   return;
+}
+   /* return to normal indentation */
 
+   }
 }
 
 /*\
- *  \case{sets}
+ *  \function{free\_later()}
  *
- *  We free cells and headers, using a normal algorithm to loop over the
- *  structure.
+ *  This function leaves an item nothing else uses on the release stack.
+ *  Unless freeing is deferred, or we are already emptying the stack
+ *  further up, we empty it before we return.
 \*/
 
-case ft_set :
+void free_later(
+   SETL_SYSTEM_PROTO
+   int kind,                           /* form code or trie type            */
+   void *item)                         /* item to be released               */
 
 {
 
-   set_root = spec->sp_val.sp_set_ptr;
+   if (FREE_STACK_TOP == FREE_STACK_MAX) {
 
-   /* we start iterating from the root, at the left of the hash table */
-
-   height = set_root->s_ntype.s_root.s_height;
-   set_work_hdr = set_root;
-   index = 0;
+      FREE_STACK = (struct free_item *)realloc((void *)FREE_STACK,
+            (size_t)(FREE_STACK_MAX + FREE_STACK_BLOCK) *
+            sizeof(struct free_item));
+      if (FREE_STACK == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
+      FREE_STACK_MAX += FREE_STACK_BLOCK;
 
-   /* delete nodes until we finish the tree */
+   }
 
-   for (;;) {
+   FREE_STACK[FREE_STACK_TOP].fi_kind = kind;
+   FREE_STACK[FREE_STACK_TOP].fi_ptr = item;
+   FREE_STACK_TOP++;
 
-      /* if we're at a leaf, delete all the set elements */
+   if (!DEFER_FREE && !FREE_DRAINING)
+      free_drain(SETL_SYSTEM YES);
 
-      if (!height) {
+}
 
-         for (index = 0; index < SET_HASH_SIZE; index++) {
+/*\
+ *  \function{free\_drain()}
+ *
+ *  This function releases items from the release stack, all of them if
+ *  \verb"all" is \verb"YES" and otherwise about \verb"FREE_QUANTUM"
+ *  elements' worth.
+ *
+ *  We always work on the top entry.  Releasing its elements may push
+ *  more entries, which we finish first, so the stack grows with the
+ *  depth of the structure rather than its size.  Only a tuple may be
+ *  left part way through; when an entry is done we move the last entry
+ *  into its place.
+\*/
 
-            set_cell_1 = set_work_hdr->s_child[index].s_cell;
-            while (set_cell_1 != NULL) {
+void free_drain(
+   SETL_SYSTEM_PROTO
+   int all)                            /* YES to empty the stack            */
 
-               set_cell_2 = set_cell_1;
-               set_cell_1 = set_cell_1->s_next;
-               unmark_specifier(&(set_cell_2->s_spec));
-               free_set_cell(set_cell_2);
+{
+int32 budget;                          /* elements left in this step        */
+int32 top;                             /* entry being released              */
+void *item;                            /* item being released               */
+int done;                              /* YES when the entry is finished    */
 
-            }
-         }
-      }
+   if (FREE_DRAINING)
+      return;
 
-      /* if we've finished a header node, move up */
+   FREE_DRAINING = YES;
+   budget = FREE_QUANTUM;
 
-      if (index >= SET_HASH_SIZE) {
+   while (FREE_STACK_TOP > 0) {
 
-         /* when we return to the root we're done */
+      if (budget <= 0) {
 
-         if (set_work_hdr == set_root)
+         if (!all)
             break;
 
-         height++;
-         index = set_work_hdr->s_ntype.s_intern.s_child_index + 1;
-         set_save_hdr = set_work_hdr;
-         set_work_hdr = set_work_hdr->s_ntype.s_intern.s_parent;
-         free_set_header(set_save_hdr);
-         continue;
-
-      }
-
-      /* if we can't move down, continue */
-
-      if (set_work_hdr->s_child[index].s_header == NULL) {
-
-         index++;
-         continue;
+         budget = FREE_QUANTUM;
 
       }
 
-      /* we can move down, so do so */
-
-      set_work_hdr = set_work_hdr->s_child[index].s_header;
-      index = 0;
-      height--;
-
-   }
-
-   free_set_header(set_root);
-
-   return;
-
-}
-
-/*\
- *  \case{maps}
- *
- *  We free cells and headers, using a normal algorithm to loop over the
- *  structure.
-\*/
+      top = FREE_STACK_TOP - 1;
+      item = FREE_STACK[top].fi_ptr;
+      done = YES;
 
-case ft_map :
-
-{
+      switch (FREE_STACK[top].fi_kind) {
 
-   map_root = spec->sp_val.sp_map_ptr;
+         case ft_tuple :
 
-   /* we start iterating from the root, at the left of the hash table */
+            done = release_tuple(SETL_SYSTEM (tuple_h_ptr_type)item,&budget);
 
-   height = map_root->m_ntype.m_root.m_height;
-   map_work_hdr = map_root;
-   index = 0;
+            break;
 
-   /* delete nodes until we finish the tree */
+         case FREE_SET_TRIE :
 
-   for (;;) {
+            release_set_trie(SETL_SYSTEM (set_n_ptr_type)item,&budget);
 
-      /* if we're at a leaf, delete all the map elements */
+            break;
 
-      if (!height) {
+         case FREE_MAP_TRIE :
 
-         for (index = 0; index < MAP_HASH_SIZE; index++) {
+            release_map_trie(SETL_SYSTEM (set_n_ptr_type)item,&budget);
 
-            map_cell_1 = map_work_hdr->m_child[index].m_cell;
-            while (map_cell_1 != NULL) {
+            break;
 
-               map_cell_2 = map_cell_1;
-               map_cell_1 = map_cell_1->m_next;
-               unmark_specifier(&(map_cell_2->m_domain_spec));
-               unmark_specifier(&(map_cell_2->m_range_spec));
-               free_map_cell(map_cell_2);
+         case ft_object :
 
-            }
-         }
-      }
+            release_object(SETL_SYSTEM (object_h_ptr_type)item,&budget);
 
-      /* if we've finished a header node, move up */
+            break;
 
-      if (index >= MAP_HASH_SIZE) {
+         case ft_mailbox :
 
-         /* when we return to the root we're done */
+            release_mailbox(SETL_SYSTEM (mailbox_h_ptr_type)item,&budget);
 
-         if (map_work_hdr == map_root)
             break;
 
-         height++;
-         index = map_work_hdr->m_ntype.m_intern.m_child_index + 1;
-         map_save_hdr = map_work_hdr;
-         map_work_hdr = map_work_hdr->m_ntype.m_intern.m_parent;
-         free_map_header(map_save_hdr);
-         continue;
-
       }
 
-      /* if we can't move down, continue */
-
-      if (map_work_hdr->m_child[index].m_header == NULL) {
+      if (done) {
 
-         index++;
-         continue;
+         FREE_STACK_TOP--;
+         if (top < FREE_STACK_TOP)
+            FREE_STACK[top] = FREE_STACK[FREE_STACK_TOP];
 
       }
-
-      /* we can move down, so do so */
-
-      map_work_hdr = map_work_hdr->m_child[index].m_header;
-      index = 0;
-      height--;
-
    }
 
-   free_map_header(map_root);
-
-   return;
+   FREE_DRAINING = NO;
 
 }
 
 /*\
- *  \case{objects}
+ *  \function{release\_object()}
  *
- *  We free cells and headers, using a normal algorithm to loop over the
- *  structure.
+ *  This function frees the cells and headers of an object, using a
+ *  normal algorithm to loop over the structure.
 \*/
 
-case ft_process :
-
-{
-process_ptr_type process_ptr;
-
-   object_root = spec->sp_val.sp_object_ptr;
-
-   process_ptr = object_root->o_process_ptr;
-   process_ptr->pc_prev->pc_next = process_ptr->pc_next;
-   process_ptr->pc_next->pc_prev = process_ptr->pc_prev;
-   free(process_ptr->pc_pstack);
-   free(process_ptr->pc_cstack);
-
-}
-
-/* NOTICE:  Deliberate fall through from previous case */
-
-case ft_object :
+static void release_object(
+   SETL_SYSTEM_PROTO
+   object_h_ptr_type object_root,      /* object to be released             */
+   int32 *budget)                      /* elements we may release           */
 
 {
+object_h_ptr_type object_work_hdr, object_save_hdr;
+                                       /* object work headers               */
+unittab_ptr_type class_ptr;            /* object class                      */
+int height;                            /* working height of header tree     */
+int index;                             /* index within header hash table    */
 
-   object_root = spec->sp_val.sp_object_ptr;
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* we start iterating from the root, at the left of the header table */
@@ -692,6 +641,7 @@ case ft_object :
                unmark_specifier(
                   &((object_work_hdr->o_child[index].o_cell)->o_spec));
                free_object_cell(object_work_hdr->o_child[index].o_cell);
+               (*budget)--;
 
             }
          }
@@ -735,31 +685,37 @@ case ft_object :
 
    free_object_header(object_root);
 
-   return;
-
 }
 
-case ft_opaque :
+/*\
+ *  \function{release\_mailbox()}
+ *
+ *  This function frees the linked list of cells of a mailbox, and the
+ *  header node.
+\*/
 
-{
-int typ;
-void *dest;
-   
-   /* Get the native type */
+static void release_mailbox(
+   SETL_SYSTEM_PROTO
+   mailbox_h_ptr_type header,          /* mailbox to be released            */
+   int32 *budget)                      /* elements we may release           */
 
-   typ = ((spec->sp_val.sp_opaque_ptr->type) & 65535) -1;
+{
+mailbox_c_ptr_type t1,t2;              /* temporary looping variables       */
 
-   if ((typ<0)||(typ>=NUM_REG_TYPES))
-        return;
+   t1 = header->mb_head;
 
-   dest = REG_TYPES[typ].function;
-   if (dest)
-   	(*(void(*)(specifier *))dest)((specifier *)spec->sp_val.sp_opaque_ptr);
+   while (t1 != NULL) {
 
-}
-   /* return to normal indentation */
+      t2 = t1;
+      t1 = t1->mb_next;
+      unmark_specifier(&(t2->mb_spec));
+      free_mailbox_cell(t2);
+      (*budget)--;
 
    }
+
+   free_mailbox_header(header);
+
 }
 
 /*\
@@ -779,15 +735,16 @@ int spec_equal_mac(
 
 {
 
-   if ((l)->sp_form == ft_omega && (r)->sp_form == ft_omega)
+   if (spec_form(l) == ft_omega && spec_form(r) == ft_omega)
       return 1;
-   else if ((l)->sp_form == (r)->sp_form &&
-            (l)->sp_val.sp_biggest == (r)->sp_val.sp_biggest) 
+   else if (spec_same_bits(l,r))
       return 1;
-   else if ((l)->sp_form < ft_real || (r)->sp_form < ft_real)
+   else if (spec_form(l) == ft_real && spec_form(r) == ft_real)
+      return (spec_val(l,sp_real_value) == spec_val(r,sp_real_value));
+   else if (spec_form(l) < ft_real || spec_form(r) < ft_real)
       return 0;
-   else if (((l)->sp_form < ft_set || (r)->sp_form < ft_set) && 
-            (l)->sp_form != (r)->sp_form)
+   else if ((spec_form(l) < ft_set || spec_form(r) < ft_set) && 
+            spec_form(l) != spec_form(r))
       return 0;
    else return spec_equal_test(SETL_SYSTEM l,r);
 
@@ -809,48 +766,24 @@ int spec_equal_test(
 {
 integer_h_ptr_type left_integer_hdr, right_integer_hdr;
                                        /* integer root pointers             */
-integer_c_ptr_type left_integer_cell, right_integer_cell;
-                                       /* integer cell pointers             */
 string_h_ptr_type left_string_hdr, right_string_hdr;
                                        /* string root pointers              */
-string_c_ptr_type left_string_cell, right_string_cell;
-                                       /* string cell pointers              */
-char *left_char_ptr, *right_char_ptr;  /* string character pointers         */
-int32 string_length;                   /* work string length                */
-int32 string_cell_length;              /* cell string length                */
-tuple_h_ptr_type left_tuple_root, left_tuple_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type left_tuple_cell;      /* current cell pointer              */
+tuple_h_ptr_type left_tuple_root, right_tuple_root;
+                                       /* tuple root pointers               */
+tuple_c_ptr_type left_tuple_cell, right_tuple_cell;
+                                       /* current cell pointers             */
+tuple_c_ptr_type tuple_end;            /* end of left element array         */
 int32 left_number;                     /* current cell number               */
 int left_height, left_index;           /* current height and index          */
-specifier *left_element;               /* set element                       */
-int left_element_needed;               /* YES if we should extract an       */
-                                       /* element                           */
-tuple_h_ptr_type right_tuple_root, right_tuple_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type right_tuple_cell;     /* current cell pointer              */
-int32 right_number;                    /* current cell number               */
-int right_height, right_index;         /* current height and index          */
-specifier *right_element;              /* set element                       */
-int right_element_needed;              /* YES if we should extract an       */
-                                       /* element                           */
-set_h_ptr_type left_set_root, left_set_work_hdr, new_set_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type left_set_list;          /* clash list                        */
+specifier *left_element;               /* object element                    */
+specifier *right_element;              /* object element                    */
+struct set_cursor_item left_cursor;    /* set or map iteration cursor       */
+set_h_ptr_type left_set_root, right_set_root;
+                                       /* set root pointers                 */
 set_c_ptr_type left_set_cell;          /* cell pointer                      */
-set_h_ptr_type right_set_root, right_set_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type right_set_list;         /* clash list                        */
-set_c_ptr_type right_set_cell, right_set_work_cell;
-                                       /* cell pointers                     */
-map_h_ptr_type left_map_root, left_map_work_hdr, new_map_hdr;
-                                       /* root and internal node pointers   */
-map_c_ptr_type left_map_list;          /* clash list                        */
-map_c_ptr_type left_map_cell;          /* cell pointer                      */
-map_h_ptr_type right_map_root, right_map_work_hdr;
-                                       /* root and internal node pointers   */
-map_c_ptr_type right_map_list;         /* clash list                        */
-map_c_ptr_type right_map_cell, right_map_work_cell, save_map_work_cell;
+map_h_ptr_type left_map_root, right_map_root;
+                                       /* map root pointers                 */
+map_c_ptr_type left_map_cell, right_map_cell;
                                        /* cell pointers                     */
 object_h_ptr_type left_object_root, left_object_work_hdr;
 object_h_ptr_type right_object_root, right_object_work_hdr;
@@ -859,7 +792,6 @@ unittab_ptr_type class_ptr;            /* class of objects                  */
 int is_equal;                          /* YES if two specifiers have the    */
                                        /* same value                        */
 specifier spare;                       /* spare specifier                   */
-int i;                                 /* temporary looping variable        */
 
    /*
     *  The short cases and those for which we demand structural
@@ -867,10 +799,10 @@ int i;                                 /* temporary looping variable        */
     *  are equal unless they are maps and sets.
     */
 
-   spare.sp_form = ft_omega;
+   spec_set_form(&spare,ft_omega);
 
 
-   switch (left->sp_form) {
+   switch (spec_form(left)) {
 
 
 /*\
@@ -883,36 +815,36 @@ case ft_real :
 
 #ifdef COERCE_EQUALITY 
    
-	if (right->sp_form == ft_short) {
+	if (spec_form(right) == ft_short) {
 	
-	   return ((left->sp_val.sp_real_ptr)->r_value ==
-					(double)(right->sp_val.sp_short_value));
+	   return (spec_val(left,sp_real_value) ==
+					(double)(spec_val(right,sp_short_value)));
 				
-	} else if (right->sp_form == ft_long) {
+	} else if (spec_form(right) == ft_long) {
 	
-			return ((left->sp_val.sp_real_ptr)->r_value ==
+			return (spec_val(left,sp_real_value) ==
 				(double)(long_to_double(SETL_SYSTEM right)));
 				
-	} else 	if (right->sp_form == ft_real) {
+	} else 	if (spec_form(right) == ft_real) {
 
-	   return ((left->sp_val.sp_real_ptr)->r_value ==
-	           (right->sp_val.sp_real_ptr)->r_value);
+	   return (spec_val(left,sp_real_value) ==
+	           spec_val(right,sp_real_value));
 	}
 	return 0;
 	
 case ft_short:
-	if (right->sp_form == ft_real) {
+	if (spec_form(right) == ft_real) {
 		
-		return ((right->sp_val.sp_real_ptr)->r_value ==
-					(double)(left->sp_val.sp_short_value));
+		return (spec_val(right,sp_real_value) ==
+					(double)(spec_val(left,sp_short_value)));
 	
 	}
 	return 0;
 	break;
 #else
 	
-	 return ((left->sp_val.sp_real_ptr)->r_value ==
-	           (right->sp_val.sp_real_ptr)->r_value);
+	 return (spec_val(left,sp_real_value) ==
+	           spec_val(right,sp_real_value));
 
 #endif
 	 
@@ -929,36 +861,31 @@ case ft_long :
 {
 
 #ifdef COERCE_EQUALITY
-	if (right->sp_form == ft_real) {
-		return ((right->sp_val.sp_real_ptr)->r_value ==
+	if (spec_form(right) == ft_real) {
+		return (spec_val(right,sp_real_value) ==
 				(double)(long_to_double(SETL_SYSTEM left)));
 	}
 
 #endif
    /* pick out the root nodes */
 
-   left_integer_hdr = left->sp_val.sp_long_ptr;
-   right_integer_hdr = right->sp_val.sp_long_ptr;
+   left_integer_hdr = spec_val(left,sp_long_ptr);
+   right_integer_hdr = spec_val(right,sp_long_ptr);
 
-   /* some easy tests -- check signs and number of cells */
+   /* some easy tests -- check signs and number of limbs */
 
    if (left_integer_hdr->i_is_negative != right_integer_hdr->i_is_negative)
       return NO;
 
-   if (left_integer_hdr->i_cell_count != right_integer_hdr->i_cell_count)
+   if (left_integer_hdr->i_limb_count != right_integer_hdr->i_limb_count)
       return NO;
 
-   /* we have to traverse the cell list */
+   /* we have to compare the limbs */
 
-   for (left_integer_cell = left_integer_hdr->i_head,
-           right_integer_cell = right_integer_hdr->i_head;
-        left_integer_cell != NULL &&
-           left_integer_cell->i_cell_value ==
-           right_integer_cell->i_cell_value;
-        left_integer_cell = left_integer_cell->i_next,
-           right_integer_cell = right_integer_cell->i_next);
-
-   if (left_integer_cell == NULL)
+   if (memcmp((void *)(left_integer_hdr->i_limbs),
+              (void *)(right_integer_hdr->i_limbs),
+              (size_t)(left_integer_hdr->i_limb_count *
+                       sizeof(integer_limb))) == 0)
       return YES;
    else
       return NO;
@@ -977,37 +904,20 @@ case ft_string :
 
    /* pick out the root nodes */
 
-   left_string_hdr = left->sp_val.sp_string_ptr;
-   right_string_hdr = right->sp_val.sp_string_ptr;
+   left_string_hdr = spec_val(left,sp_string_ptr);
+   right_string_hdr = spec_val(right,sp_string_ptr);
 
    /* an easy test -- check lengths */
 
    if (left_string_hdr->s_length != right_string_hdr->s_length)
       return NO;
 
-   /* we have to traverse the cell list */
-
-   string_length = left_string_hdr->s_length;
-   for (left_string_cell = left_string_hdr->s_head,
-           right_string_cell = right_string_hdr->s_head;
-        left_string_cell != NULL;
-        left_string_cell = left_string_cell->s_next,
-           right_string_cell = right_string_cell->s_next) {
-
-      string_cell_length = min(string_length,STR_CELL_WIDTH);
-      for (left_char_ptr = left_string_cell->s_cell_value,
-              right_char_ptr = right_string_cell->s_cell_value;
-           left_char_ptr <
-              left_string_cell->s_cell_value + string_cell_length;
-           left_char_ptr++, right_char_ptr++) {
-
-         if (*left_char_ptr != *right_char_ptr)
-            return NO;
-
-      }
-      string_length -= string_cell_length;
+   /* the characters are contiguous, so we compare them at once */
 
-   }
+   if (memcmp((void *)(left_string_hdr->s_chars),
+              (void *)(right_string_hdr->s_chars),
+              (size_t)(left_string_hdr->s_length)) != 0)
+      return NO;
 
    return YES;
 
@@ -1023,266 +933,91 @@ case ft_string :
 case ft_tuple :
 
 {
+specifier left_element, right_element; /* elements of packed tuples         */
+specifier *left_ptr, *right_ptr;       /* elements we compare               */
+int32 i;                               /* temporary looping variable        */
 
    /* pick out the root nodes */
 
-   left_tuple_root = left->sp_val.sp_tuple_ptr;
-   right_tuple_root = right->sp_val.sp_tuple_ptr;
+   left_tuple_root = spec_val(left,sp_tuple_ptr);
+   right_tuple_root = spec_val(right,sp_tuple_ptr);
 
    /* some easy tests -- length and hash code */
 
-   if (left_tuple_root->t_ntype.t_root.t_length !=
-       right_tuple_root->t_ntype.t_root.t_length)
+   if (left_tuple_root->t_length !=
+       right_tuple_root->t_length)
       return NO;
 
    if (left_tuple_root->t_hash_code != right_tuple_root->t_hash_code)
       return NO;
 
-   /* set up to iterate over the sources */
+   /*
+    *  Packed short integers are equal if their bits are.  Otherwise, if
+    *  either tuple is packed or chunked we compare the elements as
+    *  specifiers.
+    */
 
-   left_tuple_work_hdr = left_tuple_root;
-   left_number = -1;
-   left_height = left_tuple_root->t_ntype.t_root.t_height;
-   left_index = 0;
-   left_element_needed = YES;
+   if (left_tuple_root->t_packing == TUP_SHORTS &&
+       right_tuple_root->t_packing == TUP_SHORTS)
+      return (memcmp((void *)(left_tuple_root->t_packed.t_shorts),
+                     (void *)(right_tuple_root->t_packed.t_shorts),
+                     (size_t)(left_tuple_root->t_length *
+                              sizeof(int32))) == 0);
 
-   right_tuple_work_hdr = right_tuple_root;
-   right_number = -1;
-   right_height = right_tuple_root->t_ntype.t_root.t_height;
-   right_index = 0;
-   right_element_needed = YES;
+   if (left_tuple_root->t_packing != TUP_CELLS ||
+       right_tuple_root->t_packing != TUP_CELLS) {
 
-   for (;;) {
+      for (i = 0; i < left_tuple_root->t_length; i++) {
 
-      if (left_element_needed) {
+         if (is_packed(left_tuple_root)) {
+            get_packed_element(left_tuple_root,i,&left_element);
+            left_ptr = &left_element;
+         }
+         else {
+            left_ptr = &(tuple_cell_at(left_tuple_root,i)->t_spec);
+         }
 
-         /* find the next element in the tuple */
+         if (is_packed(right_tuple_root)) {
+            get_packed_element(right_tuple_root,i,&right_element);
+            right_ptr = &right_element;
+         }
+         else {
+            right_ptr = &(tuple_cell_at(right_tuple_root,i)->t_spec);
+         }
 
-         left_element = NULL;
-         for (;;) {
+         spec_equal(is_equal,left_ptr,right_ptr);
+         if (!is_equal)
+            return NO;
 
-            /* if we have an element already, return it */
+      }
 
-            if (!left_height && left_index < TUP_HEADER_SIZE) {
-
-               if (left_tuple_work_hdr->t_child[left_index].t_cell == NULL) {
-
-                  left_number++;
-                  left_index++;
-
-                  continue;
-
-               }
-
-               left_tuple_cell =
-                  left_tuple_work_hdr->t_child[left_index].t_cell;
-               left_element = &(left_tuple_cell->t_spec);
-
-               left_number++;
-               left_index++;
-
-               break;
-
-            }
-
-            /* move up if we're at the end of a node */
-
-            if (left_index >= TUP_HEADER_SIZE) {
-
-               /* break if we've exhausted the source */
-
-               if (left_tuple_work_hdr == left_tuple_root) {
-
-                  left_number++;
-                  break;
-
-               }
-
-               left_height++;
-               left_index =
-                  left_tuple_work_hdr->t_ntype.t_intern.t_child_index + 1;
-               left_tuple_work_hdr =
-                  left_tuple_work_hdr->t_ntype.t_intern.t_parent;
-
-               continue;
-
-            }
-
-            /* skip over null nodes */
-
-            if (left_tuple_work_hdr->t_child[left_index].t_header == NULL) {
-
-               left_number += 1L << (left_height * TUP_SHIFT_DIST);
-               left_index++;
-
-               continue;
-
-            }
-
-            /* otherwise drop down a level */
-
-            left_tuple_work_hdr =
-               left_tuple_work_hdr->t_child[left_index].t_header;
-            left_index = 0;
-            left_height--;
-
-         }
-      }
-
-      /* at this point we have a left element, or NULL */
-
-      /* find a right element */
-
-      if (right_element_needed) {
-
-         /* find the next element in the set */
-
-         right_element = NULL;
-         for (;;) {
-
-            /* if we have an element already, return it */
-
-            if (!right_height && right_index < TUP_HEADER_SIZE) {
-
-               if (right_tuple_work_hdr->t_child[right_index].t_cell ==
-                   NULL) {
-
-                  right_number++;
-                  right_index++;
-
-                  continue;
-
-               }
-
-               right_tuple_cell =
-                  right_tuple_work_hdr->t_child[right_index].t_cell;
-               right_element = &(right_tuple_cell->t_spec);
-
-               right_number++;
-               right_index++;
-
-               break;
-
-            }
-
-            /* move up if we're at the end of a node */
-
-            if (right_index >= TUP_HEADER_SIZE) {
-
-               /* break if we've exhausted the rsource */
-
-               if (right_tuple_work_hdr == right_tuple_root) {
-
-                  right_number++;
-                  break;
-
-               }
-
-               right_height++;
-               right_index =
-                  right_tuple_work_hdr->t_ntype.t_intern.t_child_index + 1;
-               right_tuple_work_hdr =
-                  right_tuple_work_hdr->t_ntype.t_intern.t_parent;
-
-               continue;
-
-            }
-
-            /* skip over null nodes */
-
-            if (right_tuple_work_hdr->t_child[right_index].t_header == NULL) {
-
-               right_number += 1L << (right_height * TUP_SHIFT_DIST);
-               right_index++;
-
-               continue;
-
-            }
-
-            /* otherwise drop down a level */
-
-            right_tuple_work_hdr =
-               right_tuple_work_hdr->t_child[right_index].t_header;
-            right_index = 0;
-            right_height--;
-
-         }
-      }
-
-      /* if we've exhausted both tuples they must be equal */
-
-      if (left_number >= left_tuple_root->t_ntype.t_root.t_length &&
-          right_number >= right_tuple_root->t_ntype.t_root.t_length)
-         return YES;
-
-      /* otherwise, check whether the item numbers match */
-
-      if (left_number < right_number) {
-
-         /*
-          *  If the item numbers do not match, the lower one indicates a
-          *  missing item if the item is NULL (there is nothing left in
-          *  the tuple), but the higher one indicates a missing item
-          *  otherwise.
-          */
-
-         if (left_element != NULL) {
-
-            if (left_element->sp_form != ft_omega)
-               return NO;
-
-            left_element_needed = YES;
-            right_element_needed = NO;
-
-            continue;
-
-         }
-
-         if (right_element->sp_form != ft_omega)
-            return NO;
-
-         left_element_needed = NO;
-         right_element_needed = YES;
-
-         continue;
-
-      }
-
-      if (right_number < left_number) {
-
-         if (right_element != NULL) {
-
-            if (right_element->sp_form != ft_omega)
-               return NO;
-
-            right_element_needed = YES;
-            left_element_needed = NO;
-
-            continue;
+      return YES;
 
-         }
+   }
 
-         if (left_element->sp_form != ft_omega)
-            return NO;
+   /* compare the elements pairwise */
 
-         right_element_needed = NO;
-         left_element_needed = YES;
+   left_tuple_cell = left_tuple_root->t_cells;
+   right_tuple_cell = right_tuple_root->t_cells;
+   tuple_end = left_tuple_cell + left_tuple_root->t_length;
 
-         continue;
+   for (;
+        left_tuple_cell < tuple_end;
+        left_tuple_cell++, right_tuple_cell++) {
 
-      }
-
-      /* finally, we have two elements in the same position -- compare them */
+      if (left_tuple_cell->t_hash_code != right_tuple_cell->t_hash_code)
+         return NO;
 
-      spec_equal(is_equal,left_element,right_element);
+      spec_equal(is_equal,&(left_tuple_cell->t_spec),
+                 &(right_tuple_cell->t_spec));
 
       if (!is_equal)
          return NO;
 
-      left_element_needed = YES;
-      right_element_needed = YES;
-
    }
+
+   return YES;
+
 }
 
 /*\
@@ -1298,7 +1033,7 @@ case ft_map :
 
 {
 
-   if (right->sp_form == ft_set) {
+   if (spec_form(right) == ft_set) {
 
       map_to_set(SETL_SYSTEM &spare,left);
       left = &spare;
@@ -1308,222 +1043,46 @@ case ft_map :
 
       /* pick out the root nodes */
 
-      left_map_root = left->sp_val.sp_map_ptr;
-      right_map_root = right->sp_val.sp_map_ptr;
-
-      /* we want the map with the greater height on the left */
-
-      if (left_map_root->m_ntype.m_root.m_height <
-          right_map_root->m_ntype.m_root.m_height) {
-
-         left_map_work_hdr = left_map_root;
-         left_map_root = right_map_root;
-         right_map_root = left_map_work_hdr;
-
-      }
-
-      /* set up to loop over the left and right maps in parallel */
-
-      left_map_work_hdr = left_map_root;
-      left_height = left_map_root->m_ntype.m_root.m_height;
-      left_index = 0;
-
-      right_map_work_hdr = right_map_root;
-      right_height = right_map_root->m_ntype.m_root.m_height;
-      right_map_list = NULL;
-
-      /* find successive clash lists, where right should contain left */
-
-      for (;;) {
-
-         /* find the next clash list */
-
-         left_map_list = NULL;
-         while (left_map_list == NULL) {
-
-            /* return the clash list if we're at a leaf */
-
-            if (!left_height && left_index < SET_HASH_SIZE) {
-
-               left_map_list =
-                  left_map_work_hdr->m_child[left_index].m_cell;
-
-               /* if the right is also at a leaf, we set the right list */
-
-               if (!right_height) {
-
-                  right_map_list =
-                     right_map_work_hdr->m_child[left_index].m_cell;
-
-               }
-
-               left_index++;
-
-               continue;
-
-            }
+      left_map_root = spec_val(left,sp_map_ptr);
+      right_map_root = spec_val(right,sp_map_ptr);
 
-            /* move up if we're at the end of a node */
+      /* some easy tests -- sizes and hash code */
 
-            if (left_index >= SET_HASH_SIZE) {
-
-               if (left_map_work_hdr == left_map_root)
-                  break;
-
-               left_height++;
-               left_index =
-                  left_map_work_hdr->m_ntype.m_intern.m_child_index + 1;
-               left_map_work_hdr =
-                  left_map_work_hdr->m_ntype.m_intern.m_parent;
-
-               /* move up on the right also */
-
-               if (right_height >= 0) {
-
-                  right_map_work_hdr =
-                     right_map_work_hdr->m_ntype.m_intern.m_parent;
-                  right_map_list = NULL;
-
-               }
-
-               right_height++;
-
-               continue;
-
-            }
-
-            /* skip over null nodes */
-
-            if (left_map_work_hdr->m_child[left_index].m_header == NULL) {
-
-               left_index++;
-               continue;
-
-            }
-
-            /* otherwise drop down a level */
-
-            left_map_work_hdr =
-               left_map_work_hdr->m_child[left_index].m_header;
-            left_height--;
-
-            /* drop down on the right, or return a right list */
-
-            if (right_height > 0) {
-
-               if (right_map_work_hdr->m_child[left_index].m_header == NULL) {
-
-                  get_map_header(new_map_hdr);
-                  new_map_hdr->m_ntype.m_intern.m_parent = right_map_work_hdr;
-                  new_map_hdr->m_ntype.m_intern.m_child_index = left_index;
-                  for (i = 0;
-                       i < MAP_HASH_SIZE;
-                       new_map_hdr->m_child[i++].m_cell = NULL);
-                  right_map_work_hdr->m_child[left_index].m_header =
-                     new_map_hdr;
-                  right_map_work_hdr = new_map_hdr;
-
-               }
-               else {
-
-                  right_map_work_hdr =
-                     right_map_work_hdr->m_child[left_index].m_header;
-
-               }
-            }
-            else if (!right_height) {
-
-               right_map_list =
-                  right_map_work_hdr->m_child[left_index].m_cell;
-
-            }
-
-            right_height--;
-            left_index = 0;
-
-         }
-
-         /* break if we didn't find a list */
-
-         if (left_map_list == NULL)
-            break;
-
-         /*
-          *  At this point we have a clash list from each map.  The left
-          *  lists will be unique for each iteration, but the right lists
-          *  may repeat.  The right list will always contain those
-          *  elements on the left which are in the right map, and perhaps
-          *  some others.
-          */
-
-         /* loop over the left list */
-
-         right_map_cell = right_map_list;
-         for (left_map_cell = left_map_list;
-              left_map_cell != NULL;
-              left_map_cell = left_map_cell->m_next) {
-
-            /* search for the element in the right list */
-
-            while (right_map_cell != NULL &&
-                   right_map_cell->m_hash_code < left_map_cell->m_hash_code)
-               right_map_cell = right_map_cell->m_next;
-
-            /* search through elements with identical hash codes */
-
-            is_equal = NO;
-            for (right_map_work_cell = right_map_cell;
-                 right_map_work_cell != NULL &&
-                    right_map_work_cell->m_hash_code ==
-                       left_map_cell->m_hash_code &&
-                    !is_equal;
-                 right_map_work_cell = right_map_work_cell->m_next) {
-
-               spec_equal(is_equal,
-                          &(left_map_cell->m_domain_spec),
-                          &(right_map_work_cell->m_domain_spec));
-               save_map_work_cell = right_map_work_cell;
-
-            }
-
-            /* if we didn't find the element in the right map, return NO */
-
-            if (!is_equal) {
-
-               unmark_specifier(&spare);
-               return NO;
-
-            }
-
-            if (save_map_work_cell == NULL)
-               continue;
+      if (left_map_root->m_cell_count != right_map_root->m_cell_count ||
+          left_map_root->m_cardinality != right_map_root->m_cardinality ||
+          left_map_root->m_hash_code != right_map_root->m_hash_code)
+         return NO;
 
-            if (left_map_cell->m_is_multi_val !=
-                save_map_work_cell->m_is_multi_val) {
+      /*
+       *  Now we look up each domain element of the left map in the
+       *  right, and compare the range elements.
+       */
 
-               unmark_specifier(&spare);
-               return NO;
+      set_cursor_start(&left_cursor,left_map_root->m_trie);
+      while ((left_map_cell = map_cursor_next(&left_cursor)) != NULL) {
 
-            }
+         right_map_cell = map_lookup(right_map_root->m_trie,
+                                     &(left_map_cell->m_domain_spec),
+                                     left_map_cell->m_hash_code);
 
-            /* we found equal domain elements, check the range */
+         if (right_map_cell == NULL ||
+             left_map_cell->m_is_multi_val !=
+                right_map_cell->m_is_multi_val)
+            return NO;
 
-            spec_equal(is_equal,
-                       &(left_map_cell->m_range_spec),
-                       &(save_map_work_cell->m_range_spec));
+         /* we found equal domain elements, check the range */
 
-            if (!is_equal) {
+         spec_equal(is_equal,
+                    &(left_map_cell->m_range_spec),
+                    &(right_map_cell->m_range_spec));
 
-               unmark_specifier(&spare);
-               return NO;
+         if (!is_equal)
+            return NO;
 
-            }
-         }
       }
 
-      /* if we break, left_map is a subset of right_map */
+      /* every left pair is in the right map, and they are the same size */
 
-      unmark_specifier(&spare);
       return YES;
 
    }
@@ -1545,23 +1104,22 @@ case ft_set :
 
    /* pick out the root pointers */
 
-   left_set_root = left->sp_val.sp_set_ptr;
-   if (right->sp_form == ft_map) {
+   left_set_root = spec_val(left,sp_set_ptr);
+   if (spec_form(right) == ft_map) {
 
       map_to_set(SETL_SYSTEM &spare,right);
-      right_set_root = spare.sp_val.sp_set_ptr;
+      right_set_root = spec_val(&spare,sp_set_ptr);
 
    }
    else {
 
-      right_set_root = right->sp_val.sp_set_ptr;
+      right_set_root = spec_val(right,sp_set_ptr);
 
    }
 
    /* some easy tests -- cardinality and hash code */
 
-   if (left_set_root->s_ntype.s_root.s_cardinality !=
-       right_set_root->s_ntype.s_root.s_cardinality) {
+   if (left_set_root->s_cardinality != right_set_root->s_cardinality) {
 
       unmark_specifier(&spare);
       return NO;
@@ -1575,192 +1133,22 @@ case ft_set :
 
    }
 
-   /* we want the set with the greater height on the left */
-
-   if (left_set_root->s_ntype.s_root.s_height <
-       right_set_root->s_ntype.s_root.s_height) {
-
-      left_set_work_hdr = left_set_root;
-      left_set_root = right_set_root;
-      right_set_root = left_set_work_hdr;
-
-   }
+   /* look up each left element in the right set */
 
-   /* set up to loop over the left and right sets in parallel */
+   set_cursor_start(&left_cursor,left_set_root->s_trie);
+   while ((left_set_cell = set_cursor_next(&left_cursor)) != NULL) {
 
-   left_set_work_hdr = left_set_root;
-   left_height = left_set_root->s_ntype.s_root.s_height;
-   left_index = 0;
-
-   right_set_work_hdr = right_set_root;
-   right_height = right_set_root->s_ntype.s_root.s_height;
-   right_set_list = NULL;
-
-   /* find successive clash lists, where the right should contain the left */
-
-   for (;;) {
-
-      /* find the next clash list */
-
-      left_set_list = NULL;
-      while (left_set_list == NULL) {
-
-         /* return the clash list if we're at a leaf */
-
-         if (!left_height && left_index < SET_HASH_SIZE) {
-
-            left_set_list =
-               left_set_work_hdr->s_child[left_index].s_cell;
-
-            /* if the right is also at a leaf, we set the right list */
-
-            if (!right_height) {
-
-               right_set_list =
-                  right_set_work_hdr->s_child[left_index].s_cell;
-
-            }
-
-            left_index++;
-
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (left_index >= SET_HASH_SIZE) {
-
-            if (left_set_work_hdr == left_set_root)
-               break;
-
-            left_height++;
-            left_index =
-               left_set_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            left_set_work_hdr =
-               left_set_work_hdr->s_ntype.s_intern.s_parent;
-
-            /* move up on the right also */
-
-            if (right_height >= 0) {
-
-               right_set_work_hdr =
-                  right_set_work_hdr->s_ntype.s_intern.s_parent;
-               right_set_list = NULL;
-
-            }
-
-            right_height++;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (left_set_work_hdr->s_child[left_index].s_header == NULL) {
-
-            left_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         left_set_work_hdr =
-            left_set_work_hdr->s_child[left_index].s_header;
-         left_height--;
-
-         /* drop down on the right, or return a right list */
-
-         if (right_height > 0) {
-
-            if (right_set_work_hdr->s_child[left_index].s_header == NULL) {
-
-               get_set_header(new_set_hdr);
-               new_set_hdr->s_ntype.s_intern.s_parent = right_set_work_hdr;
-               new_set_hdr->s_ntype.s_intern.s_child_index = left_index;
-               for (i = 0;
-                    i < SET_HASH_SIZE;
-                    new_set_hdr->s_child[i++].s_cell = NULL);
-               right_set_work_hdr->s_child[left_index].s_header =
-                  new_set_hdr;
-               right_set_work_hdr = new_set_hdr;
-
-            }
-            else {
-
-               right_set_work_hdr =
-                  right_set_work_hdr->s_child[left_index].s_header;
-
-            }
-         }
-         else if (!right_height) {
-
-            right_set_list =
-               right_set_work_hdr->s_child[left_index].s_cell;
-
-         }
-
-         right_height--;
-         left_index = 0;
-
-      }
-
-      /* break if we didn't find a list */
-
-      if (left_set_list == NULL)
-         break;
-
-      /*
-       *  At this point we have a clash list from each set.  The left
-       *  lists will be unique for each iteration, but the right lists
-       *  may repeat.  The right list will always contain those elements
-       *  on the left which are in the right set, and perhaps some
-       *  others.
-       */
+      if (set_lookup(SETL_SYSTEM right_set_root->s_trie,
+                     &(left_set_cell->s_spec),
+                     left_set_cell->s_hash_code) == NULL) {
 
-      /* loop over the left list */
-
-      right_set_cell = right_set_list;
-      for (left_set_cell = left_set_list;
-           left_set_cell != NULL;
-           left_set_cell = left_set_cell->s_next) {
-
-         /* search for the element in the right list */
-
-         while (right_set_cell != NULL &&
-                right_set_cell->s_hash_code < left_set_cell->s_hash_code)
-            right_set_cell = right_set_cell->s_next;
-
-         /* search through elements with identical hash codes */
-
-         is_equal = NO;
-         for (right_set_work_cell = right_set_cell;
-              right_set_work_cell != NULL &&
-                 right_set_work_cell->s_hash_code ==
-                    left_set_cell->s_hash_code &&
-                 !is_equal;
-              right_set_work_cell = right_set_work_cell->s_next) {
-
-            spec_equal(is_equal,
-                       &(left_set_cell->s_spec),
-                       &(right_set_work_cell->s_spec));
-
-         }
-
-         /* if we didn't find the element in the right set, return NO */
-
-         if (!is_equal) {
-
-            unmark_specifier(&spare);
-            return NO;
+         unmark_specifier(&spare);
+         return NO;
 
-         }
       }
    }
 
-   /* if we break, left_set is a subset of right_set */
+   /* if we finish, left_set is a subset of right_set */
 
    unmark_specifier(&spare);
    return YES;
@@ -1780,8 +1168,8 @@ case ft_object :
 
    /* pick out the root nodes */
 
-   left_object_root = left->sp_val.sp_object_ptr;
-   right_object_root = right->sp_val.sp_object_ptr;
+   left_object_root = spec_val(left,sp_object_ptr);
+   right_object_root = spec_val(right,sp_object_ptr);
 
    /* some easy tests -- class and hash code */
 
@@ -1890,14 +1278,14 @@ int32 spec_hash_code_mac(
 
 {
 
-   if ((s)->sp_form == ft_omega)
+   if (spec_form(s) == ft_omega)
       return 0L;
-   else if ((s)->sp_form <= ft_short)
-      return (s)->sp_val.sp_short_value; 
-   else if ((s)->sp_form <= ft_iter)
-      return (int32)((s)->sp_val.sp_biggest); 
-   else if ((s)->sp_form >= ft_tuple)
-      return (*((int32 *)((s)->sp_val.sp_biggest) + 1)); 
+   else if (spec_form(s) <= ft_short)
+      return spec_val(s,sp_short_value); 
+   else if (spec_form(s) <= ft_iter)
+      return (int32)spec_ptr(s); 
+   else if (spec_form(s) >= ft_tuple)
+      return (*((int32 *)spec_ptr(s) + 1)); 
    else 
       return spec_hash_code_calc(s); 
 
@@ -1915,162 +1303,643 @@ int32 spec_hash_code_calc(
 
 {
 int32 set_hash_code;                   /* hash code eventually returned     */
-integer_c_ptr_type integer_ptr;        /* integer cell pointer              */
-string_c_ptr_type string_ptr;          /* string cell pointer               */
-int32 string_length;                   /* work string length                */
-unsigned top_four;                     /* top four bits of hash code        */
-char *p;                               /* temporary looping variable        */
-#define MASK (0x0f << (sizeof(unsigned) * 8 - 4))
-                                       /* bit string with four high order   */
-                                       /* bits of integer on, others off    */
-#define SHIFT (sizeof(unsigned) * 8 - 8);
-                                       /* shift distance                    */
+integer_h_ptr_type integer_hdr;        /* long integer header               */
+string_h_ptr_type string_hdr;          /* string header                     */
+union {
+   double hb_real;                     /* real value                        */
+   hash_word hb_word;                  /* its bits                          */
+} real_bits;
 
    /* we use one of a variety of hash functions */
 
-   switch (element->sp_form) {
+   switch (spec_form(element)) {
 
       /*
-       *  The hash code of a long integer is just the low order n bits of
-       *  the integer, where n is the number of bits in an unsigned
-       *  long.  We have to visit three cells to gather up n bits.
+       *  The hash code of a long integer is the hash code of its limbs.
+       *  We leave out the sign, since negation flips it in place without
+       *  clearing the saved code.
        */
 
       case ft_long :
 
          /* if we've already calculated the hash code, just return it */
 
-         if ((element->sp_val.sp_string_ptr)->s_hash_code >= 0)
-            return (element->sp_val.sp_string_ptr)->s_hash_code;
+         integer_hdr = spec_val(element,sp_long_ptr);
+         if (integer_hdr->i_hash_code >= 0)
+            return integer_hdr->i_hash_code;
 
          /* otherwise, calculate and set the hash code */
 
-         integer_ptr = (element->sp_val.sp_long_ptr)->i_head;
-         set_hash_code = integer_ptr->i_cell_value;
-         integer_ptr = integer_ptr->i_next;
+         set_hash_code = hash_bytes((char *)integer_hdr->i_limbs,
+                                    integer_hdr->i_limb_count *
+                                       (int32)sizeof(integer_limb));
 
-         if (integer_ptr != NULL) {
+         /* save the hash code in case it's needed again */
 
-            set_hash_code |= (integer_ptr->i_cell_value << INT_CELL_WIDTH);
-            integer_ptr = integer_ptr->i_next;
+         integer_hdr->i_hash_code = set_hash_code;
 
-            if (integer_ptr != NULL)
-               set_hash_code |=
-                  integer_ptr->i_cell_value << (2 * INT_CELL_WIDTH);
+         return set_hash_code;
 
-         }
+      /*
+       *  We hash the bits of a real number.  Zero and minus zero are
+       *  equal, so they must have the same bits.
+       */
 
-         /* save the hash code in case it's needed again */
+      case ft_real :
 
-         (element->sp_val.sp_string_ptr)->s_hash_code = set_hash_code;
+         real_bits.hb_word = 0;
+         real_bits.hb_real = spec_val(element,sp_real_value);
+         if (real_bits.hb_real == 0.0)
+            real_bits.hb_real = 0.0;
 
-         return set_hash_code;
+         return (int32)(hash_mix(real_bits.hb_word) & HASH_CODE_MASK);
 
       /*
-       *  It's difficult to come up with a good machine-independent hash
-       *  code for real numbers.  We use different schemes for each
-       *  machine / compiler.
+       *  The hash code of a string is the hash code of its characters.
        */
 
-      case ft_real :
+      case ft_string :
 
-         /*
-          *  Microsoft C uses IEEE long values for doubles, but the Intel
-          *  processor puts least significant bits on the left.  We are
-          *  trying to use the mantissa, but reversed, so the most
-          *  significant bits of the mantissa are on the right.  This
-          *  isn't perfect, but it's close.
-          */
+         /* if we've already calculated the hash code, just return it */
+
+         string_hdr = spec_val(element,sp_string_ptr);
+         if (string_hdr->s_hash_code >= 0)
+            return string_hdr->s_hash_code;
+
+         /* otherwise, calculate and set the hash code */
 
-#if IEEE_LEND
+         set_hash_code = hash_bytes(string_hdr->s_chars,
+                                    string_hdr->s_length);
 
-         p = (char *)&((element->sp_val.sp_real_ptr)->r_value);
-         return ((int32)(*(p + 6)) & 0x0f) |
-                ((int32)(*(p + 5)) << 4) |
-                ((int32)(*(p + 4)) << 12) |
-                ((int32)(*(p + 3)) << 20) |
-                ((int32)((*(p + 2)) & 0x0f) << 28);
+         /* save the hash code in case it's needed again */
+
+         string_hdr->s_hash_code = set_hash_code;
+
+         return set_hash_code;
+
+   }
+
+#ifdef TRAPS
+
+   trap(__FILE__,__LINE__,msg_bad_form_hash);
 
 #endif
-#if IEEE_BEND
 
-         p = (char *)&((element->sp_val.sp_real_ptr)->r_value);
-         return ((int32)(*(p + 1)) & 0x0f) |
-                ((int32)(*(p + 2)) << 4) |
-                ((int32)(*(p + 3)) << 12) |
-                ((int32)(*(p + 4)) << 20) |
-                ((int32)((*(p + 5)) & 0x0f) << 28);
+   return 0;  /* placate semantic error checker */
+
+}
+
+/*\
+ *  \function{init\_hash\_seed()}
+ *
+ *  Hash codes of strings, long integers and reals depend on a seed,
+ *  which we choose at random when the interpreter starts, so a program
+ *  cannot be fed keys chosen to have the same hash code.  The order in
+ *  which sets and maps of those values are printed changes from run to
+ *  run as a result.  \verb"stlx -H" fixes the seed.  We expand the seed
+ *  into the keys the hash functions use, once only, since strings keep
+ *  their hash codes.
+\*/
+
+void init_hash_seed(
+   SETL_SYSTEM_PROTO_VOID)
+
+{
+FILE *random_file;                     /* system random number source       */
+hash_word seed;                        /* seed we expand                    */
+int i;                                 /* temporary looping variable        */
+
+   if (hash_keys_set)
+      return;
+
+   /* if the user gave us a seed use it, otherwise find one */
+
+   if (hash_seed_fixed) {
+
+      seed = (hash_word)hash_seed;
+
+   }
+   else {
+
+      seed = (hash_word)time(NULL) * HASH_PRIME_1 ^
+             (hash_word)clock() * HASH_PRIME_2 ^
+             (hash_word)(size_t)&seed ^
+             (hash_word)(size_t)&random_file >> 12;
+
+      random_file = fopen("/dev/urandom","rb");
+      if (random_file != NULL) {
+
+         hash_word random_bits;        /* bits read from random_file        */
+
+         if (fread((void *)&random_bits,sizeof(random_bits),1,
+                   random_file) == 1)
+            seed ^= random_bits;
+         fclose(random_file);
+
+      }
+
+      hash_seed = (unsigned long)seed;
+
+   }
+
+   /* expand the seed into the keys, with the splitmix generator */
+
+   for (i = 0; i < HASH_KEY_WORDS; i++) {
+
+      seed += 0x9e3779b97f4a7c15ULL;
+      hash_key[i] = hash_mum(seed ^ HASH_PRIME_1,seed ^ HASH_PRIME_2) |
+                    1;
+
+   }
+
+   hash_keys_set = YES;
+
+   return;
+
+}
+
+/*\
+ *  \function{hash\_mum()}
+ *
+ *  This function multiplies two 64 bit words and folds the high half
+ *  of the product into the low half.  Every bit of the result depends
+ *  on every bit of both operands, which makes it the core of our hash
+ *  functions.
+\*/
+
+static hash_word hash_mum(
+   hash_word left,                     /* left operand                      */
+   hash_word right)                    /* right operand                     */
+
+{
+#ifdef __SIZEOF_INT128__
+unsigned __int128 product;             /* full product                      */
+
+   product = (unsigned __int128)left * right;
+
+   return (hash_word)product ^ (hash_word)(product >> 64);
+
+#else
+hash_word left_high, left_low;         /* halves of left operand            */
+hash_word right_high, right_low;       /* halves of right operand           */
+hash_word cross_1, cross_2;            /* cross products                    */
+hash_word low, high;                   /* halves of the product             */
+hash_word sum;                         /* partial sum                       */
+
+   left_high = left >> 32;
+   left_low = left & 0xffffffffULL;
+   right_high = right >> 32;
+   right_low = right & 0xffffffffULL;
+
+   cross_1 = left_high * right_low;
+   cross_2 = right_high * left_low;
+   low = left_low * right_low;
+   high = left_high * right_high;
+
+   sum = low + (cross_1 << 32);
+   high += (sum < low);
+   low = sum + (cross_2 << 32);
+   high += (low < sum);
+   high += (cross_1 >> 32) + (cross_2 >> 32);
+
+   return low ^ high;
+
+#endif
+}
+
+/*\
+ *  \function{hash\_mix()}
+ *
+ *  This function mixes one word with the seed.  We use it for reals.
+\*/
+
+static hash_word hash_mix(
+   hash_word word)                     /* word to be mixed                  */
+
+{
+
+   return hash_mum(word ^ hash_key[0],hash_key[1] ^ HASH_PRIME_3);
+
+}
+
+/*\
+ *  \function{hash\_stripes()}
+ *
+ *  This function accumulates a run of stripes of a long string.  Each
+ *  of the eight words in a stripe is mixed with a key and added to one
+ *  lane of the accumulator, as the product of its two halves, and the
+ *  word itself is added to the neighbouring lane.  That needs only 32
+ *  bit multiplies, which vector units have, so where we have SSE2 we
+ *  process two lanes at once.  The key moves along one word per stripe,
+ *  so stripes may not be exchanged without changing the hash code.
+ *  The scalar version gives the same results.
+\*/
+
+static void hash_stripes(
+   hash_word *acc,                     /* accumulator lanes                 */
+   const char *p,                      /* first stripe                      */
+   int32 stripes,                      /* number of stripes                 */
+   const hash_word *key)               /* key of first stripe               */
+
+{
+#ifdef __SSE2__
+__m128i *acc_vector;                   /* lanes as vectors                  */
+__m128i data, keyed, product;          /* work vectors                      */
+int32 stripe;                          /* stripe number                     */
+int i;                                 /* temporary looping variable        */
+
+   acc_vector = (__m128i *)acc;
+   for (stripe = 0; stripe < stripes; stripe++) {
+
+      for (i = 0; i < HASH_LANES / 2; i++) {
+
+         data = _mm_loadu_si128((const __m128i *)p + i);
+         keyed = _mm_xor_si128(data,
+                    _mm_loadu_si128((const __m128i *)(key + stripe) + i));
+         product = _mm_mul_epu32(keyed,
+                      _mm_shuffle_epi32(keyed,_MM_SHUFFLE(0,3,0,1)));
+         data = _mm_shuffle_epi32(data,_MM_SHUFFLE(1,0,3,2));
+         acc_vector[i] = _mm_add_epi64(acc_vector[i],
+                                       _mm_add_epi64(product,data));
+
+      }
+
+      p += HASH_STRIPE_SIZE;
+
+   }
+
+#else
+hash_word data, keyed;                 /* work words                        */
+int32 stripe;                          /* stripe number                     */
+int i;                                 /* temporary looping variable        */
+
+   for (stripe = 0; stripe < stripes; stripe++) {
+
+      for (i = 0; i < HASH_LANES; i++) {
+
+         memcpy((void *)&data,(void *)(p + i * 8),8);
+         keyed = data ^ key[stripe + i];
+         acc[i ^ 1] += data;
+         acc[i] += (keyed & 0xffffffffULL) * (keyed >> 32);
+
+      }
+
+      p += HASH_STRIPE_SIZE;
+
+   }
 
 #endif
-#if G_FLOAT
+}
+
+/*\
+ *  \function{hash\_scramble()}
+ *
+ *  After each block of stripes we scramble the accumulator, so that
+ *  the high bits of each lane find their way into the low bits.
+\*/
+
+static void hash_scramble(
+   hash_word *acc,                     /* accumulator lanes                 */
+   const hash_word *key)               /* scramble key                      */
+
+{
+#ifdef __SSE2__
+__m128i *acc_vector;                   /* lanes as vectors                  */
+__m128i lanes, prime;                  /* work vectors                      */
+int i;                                 /* temporary looping variable        */
+
+   acc_vector = (__m128i *)acc;
+   prime = _mm_set1_epi32((int)HASH_PRIME_32);
+   for (i = 0; i < HASH_LANES / 2; i++) {
+
+      lanes = acc_vector[i];
+      lanes = _mm_xor_si128(lanes,_mm_srli_epi64(lanes,47));
+      lanes = _mm_xor_si128(lanes,
+                            _mm_loadu_si128((const __m128i *)key + i));
+      acc_vector[i] = _mm_add_epi64(_mm_mul_epu32(lanes,prime),
+                         _mm_slli_epi64(
+                            _mm_mul_epu32(_mm_srli_epi64(lanes,32),prime),
+                            32));
+
+   }
+
+#else
+int i;                                 /* temporary looping variable        */
+
+   for (i = 0; i < HASH_LANES; i++) {
 
-         p = (char *)&((element->sp_val.sp_real_ptr)->r_value);
-         return ((int32)(*(p + 1)) & 0x0f) |
-                ((int32)(*(p + 2)) << 4) |
-                ((int32)(*(p + 3)) << 12) |
-                ((int32)(*(p + 4)) << 20) |
-                ((int32)((*(p + 5)) & 0x0f) << 28);
+      acc[i] ^= acc[i] >> 47;
+      acc[i] ^= key[i];
+      acc[i] *= HASH_PRIME_32;
+
+   }
 
 #endif
-#if D_FLOAT
+}
+
+/*\
+ *  \function{hash\_long\_string()}
+ *
+ *  This function finds the hash code of a string longer than
+ *  \verb"HASH_LONG_STRING" bytes.  We accumulate blocks of stripes,
+ *  scrambling after each block, then the stripes left over and finally
+ *  the last stripe of the string, which may overlap them.  Then we
+ *  fold the lanes together.
+\*/
 
-         p = (char *)&((element->sp_val.sp_real_ptr)->r_value);
-         return ((int32)(*(p + 1)) & 0x7f) |
-                ((int32)(*(p + 2)) << 7) |
-                ((int32)(*(p + 3)) << 15) |
-                ((int32)(*(p + 4)) << 23) |
-                ((int32)((*(p + 5)) & 0x01) << 31);
+static hash_word hash_long_string(
+   const char *p,                      /* first character                   */
+   int32 length)                       /* length of string                  */
 
+{
+#ifdef __SSE2__
+__m128i acc_vector[HASH_LANES / 2];    /* aligned accumulator               */
+hash_word *acc = (hash_word *)acc_vector;
+#else
+hash_word acc[HASH_LANES];             /* accumulator lanes                 */
 #endif
+hash_word result;                      /* folded lanes                      */
+int32 stripes;                         /* number of whole stripes           */
+int i;                                 /* temporary looping variable        */
 
-      /*
-       *  The hash code of a string uses an algorithm due to P. J.
-       *  Weinstein which can be found in Compilers: Principles,
-       *  Techniques, and Tools by Aho, Sethi and Ullman.
-       */
+   for (i = 0; i < HASH_LANES; i++)
+      acc[i] = hash_key[i] ^ HASH_PRIME_2;
 
-      case ft_string :
+   stripes = (length - 1) / HASH_STRIPE_SIZE;
+   while (stripes >= HASH_BLOCK_STRIPES) {
 
-         /* if we've already calculated the hash code, just return it */
+      hash_stripes(acc,p,HASH_BLOCK_STRIPES,hash_key);
+      hash_scramble(acc,hash_key + HASH_BLOCK_STRIPES);
+      p += HASH_BLOCK_STRIPES * HASH_STRIPE_SIZE;
+      length -= HASH_BLOCK_STRIPES * HASH_STRIPE_SIZE;
+      stripes -= HASH_BLOCK_STRIPES;
 
-         if ((element->sp_val.sp_string_ptr)->s_hash_code >= 0)
-            return (element->sp_val.sp_string_ptr)->s_hash_code;
+   }
 
-         /* otherwise, calculate and set the hash code */
+   hash_stripes(acc,p,stripes,hash_key);
+   hash_stripes(acc,p + length - HASH_STRIPE_SIZE,1,
+                hash_key + HASH_BLOCK_STRIPES - 1);
+
+   result = 0;
+   for (i = 0; i < HASH_LANES; i += 2)
+      result += hash_mum(acc[i] ^ hash_key[i + 8],
+                         acc[i + 1] ^ hash_key[i + 9]);
+
+   return result;
+
+}
+
+/*\
+ *  \function{hash\_bytes()}
+ *
+ *  This function finds the hash code of a string of bytes, which we use
+ *  for strings and long integers.  Short strings are read as one or two
+ *  words, medium length strings 16 bytes at a time, and long strings
+ *  by \function{hash\_long\_string()}.  The final mix takes in the
+ *  length and the last 16 bytes.  The result is never negative.
+\*/
+
+int32 hash_bytes(
+   char *s,                            /* bytes to be hashed                */
+   int32 length)                       /* number of bytes                   */
+
+{
+const char *p;                         /* next bytes to read                */
+hash_word first, last;                 /* first and last words read         */
+hash_word result;                      /* hash code                         */
+unsigned int half;                     /* half word read                    */
+int32 left;                            /* bytes not yet read                */
+
+   p = s;
+   result = hash_key[2] ^ (hash_word)length * HASH_PRIME_1;
+
+   if (length <= 16) {
+
+      if (length >= 8) {
+         memcpy((void *)&first,(void *)p,8);
+         memcpy((void *)&last,(void *)(p + length - 8),8);
+      }
+      else if (length >= 4) {
+         memcpy((void *)&half,(void *)p,4);
+         first = half;
+         memcpy((void *)&half,(void *)(p + length - 4),4);
+         last = half;
+      }
+      else if (length > 0) {
+         first = ((hash_word)(unsigned char)p[0] << 16) |
+                 ((hash_word)(unsigned char)p[length >> 1] << 8) |
+                 (hash_word)(unsigned char)p[length - 1];
+         last = 0;
+      }
+      else {
+         first = last = 0;
+      }
+
+   }
+   else {
+
+      if (length > HASH_LONG_STRING) {
+
+         result ^= hash_long_string(p,length);
+
+      }
+      else {
+
+         for (left = length; left > 16; left -= 16, p += 16) {
+
+            memcpy((void *)&first,(void *)p,8);
+            memcpy((void *)&last,(void *)(p + 8),8);
+            result = hash_mum(first ^ hash_key[3],last ^ result);
 
-         set_hash_code = 0;
-         string_length = (element->sp_val.sp_string_ptr)->s_length;
-         for (string_ptr = (element->sp_val.sp_string_ptr)->s_head;
-              string_length > 0;
-              string_ptr = string_ptr->s_next) {
-
-            for (p = string_ptr->s_cell_value;
-                 string_length > 0 &&
-                    p < string_ptr->s_cell_value + STR_CELL_WIDTH;
-                 p++, string_length--) {
-
-               set_hash_code = (set_hash_code << 4) + *p;
-               if (top_four = set_hash_code & MASK) {
-                  set_hash_code ^= top_four >> SHIFT;
-                  set_hash_code ^= top_four;
-               }
-            }
          }
+      }
 
-         /* save the hash code in case it's needed again */
+      memcpy((void *)&first,(void *)(s + length - 16),8);
+      memcpy((void *)&last,(void *)(s + length - 8),8);
+
+   }
 
-         (element->sp_val.sp_string_ptr)->s_hash_code = set_hash_code;
+   result = hash_mum(first ^ hash_key[4],last ^ result);
+   result = hash_mum(result ^ hash_key[5],HASH_PRIME_3);
 
-         return set_hash_code;
+   return (int32)(result & HASH_CODE_MASK);
+
+}
+
+/*\
+ *  \function{hash\_statistics()}
+ *
+ *  This function prints the quality of our string hash codes on a few
+ *  families of realistic keys, for \verb"stlx --hash-stats".  For each
+ *  family we count the keys which share a full hash code with another,
+ *  which end up in the same clash list of a set, and the longest such
+ *  list.  We also give the chi-square statistic of the low ten bits,
+ *  which pick the slots in the first two levels of a trie, divided by
+ *  its degrees of freedom, so 1.0 is ideal.  Last is the avalanche: the
+ *  average fraction of hash code bits which change when we change one
+ *  bit of a key, for which 0.5 is ideal.
+\*/
+
+#define HASH_STAT_KEYS     200000      /* keys in each family               */
+#define HASH_STAT_BUCKETS  1024        /* buckets for chi-square            */
+#define HASH_STAT_SAMPLES  2000        /* keys tested for avalanche         */
+#define HASH_STAT_WIDTH    1100        /* longest key we build              */
+
+static int hash_compare(
+   const void *left,                   /* left hash code                    */
+   const void *right)                  /* right hash code                   */
+
+{
+
+   if (*(const int32 *)left < *(const int32 *)right)
+      return -1;
+   if (*(const int32 *)left > *(const int32 *)right)
+      return 1;
+
+   return 0;
+
+}
+
+static int32 hash_stat_key(
+   char *key,                          /* key buffer                        */
+   int family,                         /* key family                        */
+   int32 i)                            /* key number                        */
+
+{
+static char *words[] = {"count","index","node","value","total",
+                        "buffer","parent","offset"};
+                                       /* identifier stems                  */
+
+   switch (family) {
+
+      case 0 :
+         sprintf(key,"%s_%ld",words[i % 8],(long)(i / 8));
+         break;
+
+      case 1 :
+         sprintf(key,"http://www.example.com/catalog/item/%ld/details.html",
+                 (long)i);
+         break;
+
+      case 2 :
+         sprintf(key,"%ld",(long)i);
+         break;
+
+      case 3 :
+         sprintf(key,"/usr/local/lib/setl2/unit%06ld.stl",(long)i);
+         break;
+
+      default :
+         memset((void *)key,'x',(size_t)1000);
+         sprintf(key,"%ld",(long)i);
+         key[strlen(key)] = '-';
+         key[1000] = '\0';
+         break;
 
    }
 
-#ifdef TRAPS
+   return (int32)strlen(key);
 
-   trap(__FILE__,__LINE__,msg_bad_form_hash);
+}
 
-#endif
+void hash_statistics(
+   SETL_SYSTEM_PROTO_VOID)
 
-   return 0;  /* placate semantic error checker */
+{
+static char *families[] = {"identifiers","URLs","numbers","paths",
+                           "1000 byte keys"};
+                                       /* key family names                  */
+int32 *codes;                          /* hash codes of a family            */
+int32 *buckets;                        /* chi-square buckets                */
+char key[HASH_STAT_WIDTH];             /* one key                           */
+int32 length;                          /* key length                        */
+int32 clashes, run, longest;           /* clash list statistics             */
+double chi_square;                     /* bucket statistic                  */
+double changed;                        /* bits changed, for avalanche       */
+long trials;                           /* avalanche trials                  */
+unsigned long difference;              /* bits changed by one trial         */
+int32 code;                            /* hash code of unchanged key        */
+int family;                            /* key family                        */
+int32 i, j;                            /* temporary looping variables       */
+int bit;                               /* bit we change                     */
+
+   init_hash_seed(SETL_SYSTEM_VOID);
+
+   codes = (int32 *)malloc((size_t)(HASH_STAT_KEYS * sizeof(int32)));
+   buckets = (int32 *)malloc((size_t)(HASH_STAT_BUCKETS * sizeof(int32)));
+   if (codes == NULL || buckets == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+
+   plugin_printf("%-16s %8s %8s %8s %10s %10s\n",
+                 "keys","count","clashes","longest","chi-square","avalanche");
+
+   for (family = 0; family < 5; family++) {
+
+      /* find the hash codes and fill the buckets */
+
+      memset((void *)buckets,0,(size_t)(HASH_STAT_BUCKETS * sizeof(int32)));
+      for (i = 0; i < HASH_STAT_KEYS; i++) {
+         length = hash_stat_key(key,family,i);
+         codes[i] = hash_bytes(key,length);
+         buckets[codes[i] & (HASH_STAT_BUCKETS - 1)]++;
+      }
+
+      chi_square = 0.0;
+      for (i = 0; i < HASH_STAT_BUCKETS; i++) {
+         chi_square +=
+            ((double)buckets[i] - (double)HASH_STAT_KEYS / HASH_STAT_BUCKETS) *
+            ((double)buckets[i] - (double)HASH_STAT_KEYS / HASH_STAT_BUCKETS) /
+            ((double)HASH_STAT_KEYS / HASH_STAT_BUCKETS);
+      }
+      chi_square /= HASH_STAT_BUCKETS - 1;
+
+      /* equal codes are adjacent once sorted */
+
+      qsort((void *)codes,(size_t)HASH_STAT_KEYS,sizeof(int32),hash_compare);
+      clashes = 0;
+      longest = 1;
+      for (i = 0; i < HASH_STAT_KEYS; i = j) {
+         for (j = i + 1; j < HASH_STAT_KEYS && codes[j] == codes[i]; j++);
+         run = j - i;
+         if (run > 1)
+            clashes += run;
+         if (run > longest)
+            longest = run;
+      }
+
+      /* change each bit of the first eight bytes of some keys */
+
+      changed = 0.0;
+      trials = 0;
+      for (i = 0;
+           i < HASH_STAT_KEYS;
+           i += HASH_STAT_KEYS / HASH_STAT_SAMPLES) {
+
+         length = hash_stat_key(key,family,i);
+         code = hash_bytes(key,length);
+         for (bit = 0; bit < 64 && bit < length * 8; bit++) {
+
+            key[bit / 8] ^= (char)(1 << (bit % 8));
+            difference = (unsigned long)(code ^ hash_bytes(key,length));
+            key[bit / 8] ^= (char)(1 << (bit % 8));
+
+            for (; difference != 0; difference &= difference - 1)
+               changed += 1.0;
+            trials++;
+
+         }
+      }
+      changed /= (double)trials * (sizeof(int32) * 8 - 1);
+
+      plugin_printf("%-16s %8ld %8ld %8ld %10.3f %10.3f\n",
+                    families[family],(long)HASH_STAT_KEYS,(long)clashes,
+                    (long)longest,chi_square,changed);
+
+   }
+
+   free((void *)codes);
+   free((void *)buckets);
+
+   return;
 
 }
@@ -34,6 +34,10 @@
 #include <dos.h>                       /* DOS use macros                    */
 #endif
 
+/* SETL2 system header files */
+
+#include "form.h"                      /* form codes                        */
+
 /* opaque object structure */
  
 struct opaque_item {
@@ -43,7 +47,36 @@ struct opaque_item {
 
 typedef struct opaque_item *opaque_item_ptr_type;
 
-/* specifier structure */
+/*\
+ *  \function{Specifiers}
+ *
+ *  A specifier is a form code and a value.  Normally that is a structure
+ *  with an unsigned form code and a union of the value types, which
+ *  comes to two words on a 64-bit machine.  If \verb"TAGGED_SPECS" is
+ *  set we pack both into a single word instead, which halves the size
+ *  of every set, map, tuple and object cell.
+ *
+ *  The tagged word is laid out so that a word of zeros is omega, like a
+ *  cleared structure.  Anything but a real keeps its form in the bits
+ *  above \verb"SPEC_FORM_SHIFT" and its value in the bits below, so
+ *  pointers must fit in 47 bits, as user addresses do on current 64-bit
+ *  systems, and short integers are limited to 47 bits.  A real is kept
+ *  as its IEEE bits plus \verb"SPEC_REAL_OFFSET", which leaves every
+ *  double but a negative NaN above the other forms.  We never keep NaNs
+ *  anyway, but if one turns up we store the positive quiet NaN.
+ *
+ *  All access to specifiers goes through the macros below, so that the
+ *  rest of the system need not know which layout is in use.
+ *  \function{spec\_form()} and \function{spec\_val()} return the form
+ *  and the named value field, and \function{spec\_set\_form()} and
+ *  \function{spec\_set\_val()} store them, in either order.  The field
+ *  \verb"sp_biggest" stands for the whole value, and is only used to
+ *  copy it from one specifier to another.  \function{spec\_ptr()} is
+ *  the value of a specifier which holds a pointer, and
+ *  \function{spec\_set\_ptr()} stores one.
+\*/
+
+#if !TAGGED_SPECS
 
 struct specifier_item {
    unsigned sp_form;                   /* form code                         */
@@ -58,7 +91,7 @@ struct specifier_item {
    		struct proc_item *sp_proc_ptr;   /* procedure                         */
       struct integer_h_item *sp_long_ptr;
                                        /* header of integer                 */
-      struct i_real_item *sp_real_ptr; /* real number                       */
+      double sp_real_value;            /* real number                       */
       struct string_h_item *sp_string_ptr;
                                        /* header of string                  */
       struct set_h_item *sp_set_ptr;   /* root of set header                */
@@ -78,17 +111,206 @@ struct specifier_item {
 typedef struct specifier_item specifier;
                                        /* specifier item                    */
 
-/*\
+/* reals are kept in the value field, so it must be as large as a double */
+
+typedef char spec_real_fits[sizeof(void *) >= sizeof(double) ? 1 : -1];
+
+#define spec_form(s)          ((s)->sp_form)
+#define spec_set_form(s,f)    ((s)->sp_form = (f))
+#define spec_val(s,m)         ((s)->sp_val.m)
+#define spec_set_val(s,m,v)   ((s)->sp_val.m = (v))
+#define spec_ptr(s)           ((s)->sp_val.sp_biggest)
+#define spec_set_ptr(s,v)     ((s)->sp_val.sp_biggest = (v))
+
+/* YES if two specifiers have the same form and value bits */
+
+#define spec_same_bits(l,r) \
+   (spec_form(l) == spec_form(r) && spec_ptr(l) == spec_ptr(r))
+
+/* YES if the specifier points to an item with a use count */
+
+#define spec_is_counted(s) \
+   (spec_form(s) >= ft_opaque && spec_form(s) != ft_real)
+
+#else
+
+typedef unsigned long spec_word;       /* tagged specifier                  */
+
+struct specifier_item {
+   spec_word sp_word;                  /* form and value                    */
+};
+
+typedef struct specifier_item specifier;
+                                       /* specifier item                    */
+
+/* the tagged word must hold a pointer and a double */
+
+typedef char spec_word_fits[sizeof(spec_word) == sizeof(double) &&
+                            sizeof(spec_word) == sizeof(void *) ? 1 : -1];
+
+#define SPEC_FORM_SHIFT   47           /* form code position                */
+#define SPEC_VALUE_MASK   ((1UL << SPEC_FORM_SHIFT) - 1)
+                                       /* value bits of other than a real   */
+#define SPEC_REAL_OFFSET  ((1UL << 52) - 1)
+                                       /* added to the bits of a real       */
+#define SPEC_NEG_INFINITY 0xfff0000000000000UL
+                                       /* largest real we can store as is   */
+#define SPEC_QUIET_NAN    0x7ff8000000000000UL
+                                       /* stored in place of other NaNs     */
+
+/* tagged word of a form, without its value */
+
+#define spec_tag(f)       ((spec_word)(f) << SPEC_FORM_SHIFT)
+
+/* the tag of a specifier, or of form f if it holds a real */
+
+#define spec_tag_or(s,f) \
+   ((s)->sp_word < SPEC_REAL_OFFSET ? \
+      (s)->sp_word & ~SPEC_VALUE_MASK : spec_tag(f))
+
+union spec_real_bits {
+   double rb_real;                     /* real value                        */
+   spec_word rb_word;                  /* its IEEE bits                     */
+};
+
+static inline double spec_real_value(const specifier *s)
+{
+   union spec_real_bits bits;
+
+   bits.rb_word = s->sp_word - SPEC_REAL_OFFSET;
+   return bits.rb_real;
+}
+
+static inline void spec_set_real_value(specifier *s, double r)
+{
+   union spec_real_bits bits;
+
+   bits.rb_real = r;
+   if (bits.rb_word > SPEC_NEG_INFINITY)
+      bits.rb_word = SPEC_QUIET_NAN;
+   s->sp_word = bits.rb_word + SPEC_REAL_OFFSET;
+}
+
+static inline void spec_set_tagged_form(specifier *s, unsigned f)
+{
+   if (f == ft_real) {
+      if (s->sp_word < SPEC_REAL_OFFSET)
+         s->sp_word = SPEC_REAL_OFFSET;
+   }
+   else if (s->sp_word < SPEC_REAL_OFFSET) {
+      s->sp_word = spec_tag(f) | (s->sp_word & SPEC_VALUE_MASK);
+   }
+   else {
+      s->sp_word = spec_tag(f);
+   }
+}
+
+/*
+ *  Copying the whole value keeps the form of the target, if it has one
+ *  already, so the form and value may be set in either order.  Reals
+ *  carry their form in the value, so they are always copied whole.
+ */
+
+static inline void spec_set_biggest(specifier *s, specifier v)
+{
+   if (v.sp_word >= SPEC_REAL_OFFSET || s->sp_word >= SPEC_REAL_OFFSET)
+      s->sp_word = v.sp_word;
+   else
+      s->sp_word = (s->sp_word & ~SPEC_VALUE_MASK) |
+                   (v.sp_word & SPEC_VALUE_MASK);
+}
+
+#define spec_form(s) \
+   ((s)->sp_word >= SPEC_REAL_OFFSET ? \
+      (unsigned)ft_real : (unsigned)((s)->sp_word >> SPEC_FORM_SHIFT))
+#define spec_set_form(s,f)    spec_set_tagged_form(s,f)
+#define spec_val(s,m)         spec_get_##m(s)
+#define spec_set_val(s,m,v)   spec_put_##m(s,v)
+#define spec_ptr(s)           ((void *)((s)->sp_word & SPEC_VALUE_MASK))
+#define spec_set_ptr(s,v) \
+   ((s)->sp_word = spec_tag_or(s,ft_omega) | \
+                   ((spec_word)(v) & SPEC_VALUE_MASK))
+#define spec_same_bits(l,r)   ((l)->sp_word == (r)->sp_word)
+
+#define spec_is_counted(s) \
+   ((s)->sp_word >= spec_tag(ft_opaque) && \
+    (s)->sp_word < SPEC_REAL_OFFSET)
+
+/* integer fields are sign extended */
+
+#define spec_get_sp_atom_num(s) \
+   ((int32)((s)->sp_word << (64 - SPEC_FORM_SHIFT)) >> \
+      (64 - SPEC_FORM_SHIFT))
+#define spec_get_sp_short_value(s)    spec_get_sp_atom_num(s)
+#define spec_put_sp_atom_num(s,v) \
+   ((s)->sp_word = spec_tag_or(s,ft_atom) | \
+                   ((spec_word)(v) & SPEC_VALUE_MASK))
+#define spec_put_sp_short_value(s,v) \
+   ((s)->sp_word = spec_tag_or(s,ft_short) | \
+                   ((spec_word)(v) & SPEC_VALUE_MASK))
+
+#define spec_get_sp_real_value(s)     spec_real_value(s)
+#define spec_put_sp_real_value(s,v)   spec_set_real_value(s,v)
+#define spec_get_sp_biggest(s)        (*(s))
+#define spec_put_sp_biggest(s,v)      spec_set_biggest(s,v)
+
+/* pointer fields */
+
+#define spec_get_pointer(s,t)         ((t)spec_ptr(s))
+#define spec_put_pointer(s,f,v) \
+   ((s)->sp_word = spec_tag_or(s,f) | (spec_word)(v))
+
+#define spec_get_sp_file_ptr(s) \
+   spec_get_pointer(s,struct file_item *)
+#define spec_put_sp_file_ptr(s,v)     spec_put_pointer(s,ft_file,v)
+#define spec_get_sp_label_ptr(s) \
+   spec_get_pointer(s,struct instruction_item *)
+#define spec_put_sp_label_ptr(s,v)    spec_put_pointer(s,ft_label,v)
+#define spec_get_sp_opaque_ptr(s) \
+   spec_get_pointer(s,struct opaque_item *)
+#define spec_put_sp_opaque_ptr(s,v)   spec_put_pointer(s,ft_opaque,v)
+#define spec_get_sp_proc_ptr(s) \
+   spec_get_pointer(s,struct proc_item *)
+#define spec_put_sp_proc_ptr(s,v)     spec_put_pointer(s,ft_proc,v)
+#define spec_get_sp_long_ptr(s) \
+   spec_get_pointer(s,struct integer_h_item *)
+#define spec_put_sp_long_ptr(s,v)     spec_put_pointer(s,ft_long,v)
+#define spec_get_sp_string_ptr(s) \
+   spec_get_pointer(s,struct string_h_item *)
+#define spec_put_sp_string_ptr(s,v)   spec_put_pointer(s,ft_string,v)
+#define spec_get_sp_set_ptr(s) \
+   spec_get_pointer(s,struct set_h_item *)
+#define spec_put_sp_set_ptr(s,v)      spec_put_pointer(s,ft_set,v)
+#define spec_get_sp_map_ptr(s) \
+   spec_get_pointer(s,struct map_h_item *)
+#define spec_put_sp_map_ptr(s,v)      spec_put_pointer(s,ft_map,v)
+#define spec_get_sp_tuple_ptr(s) \
+   spec_get_pointer(s,struct tuple_h_item *)
+#define spec_put_sp_tuple_ptr(s,v)    spec_put_pointer(s,ft_tuple,v)
+#define spec_get_sp_iter_ptr(s) \
+   spec_get_pointer(s,struct iter_item *)
+#define spec_put_sp_iter_ptr(s,v)     spec_put_pointer(s,ft_iter,v)
+#define spec_get_sp_object_ptr(s) \
+   spec_get_pointer(s,struct object_h_item *)
+#define spec_put_sp_object_ptr(s,v)   spec_put_pointer(s,ft_object,v)
+#define spec_get_sp_mailbox_ptr(s) \
+   spec_get_pointer(s,struct mailbox_h_item *)
+#define spec_put_sp_mailbox_ptr(s,v)  spec_put_pointer(s,ft_mailbox,v)
+
+#endif
+
+/*\
  *  \function{mark\_specifier()}
  *
  *  This function bumps the use count of a specifier (long items only).
  *  It assumes the use count is an integer, and is the first field of the
- *  header of a long item.
+ *  header of a long item.  Reals are kept in the specifier, so they
+ *  have no use count.
 \*/
 
 #define mark_specifier(s) { \
-   if ((s)->sp_form >= ft_opaque) \
-      (*((int32 *)((s)->sp_val.sp_biggest)))++; \
+   if (spec_is_counted(s)) \
+      (*((int32 *)(spec_ptr(s))))++; \
 }
 
 /*\
@@ -101,8 +323,8 @@ typedef struct specifier_item specifier;
 \*/
 
 #define unmark_specifier(s) { \
-   if ((s)->sp_form >= ft_opaque && \
-          !(--(*((int32 *)((s)->sp_val.sp_biggest))))) \
+   if (spec_is_counted(s) && \
+          !(--(*((int32 *)(spec_ptr(s)))))) \
       free_specifier(SETL_SYSTEM s); \
 }
 
@@ -125,16 +347,105 @@ int spec_equal_mac(SETL_SYSTEM_PROTO specifier *, specifier *);
 int32 spec_hash_code_mac(specifier *); /* hash code calculation             */
 #endif
 
+/* hash code seed, random unless given by stlx -H */
+
+#ifdef SHARED
+
+unsigned long hash_seed = 0;           /* seed of hash codes                */
+int hash_seed_fixed = NO;              /* YES if the seed was given         */
+
+#else
+
+extern unsigned long hash_seed;        /* seed of hash codes                */
+extern int hash_seed_fixed;            /* YES if the seed was given         */
+
+#endif
+
+/*\
+ *  \function{free\_later()}
+ *
+ *  Releasing a tuple, set, map, object or mailbox releases its
+ *  elements, and any of those which are not used elsewhere release
+ *  theirs.  Rather than recursing we keep a stack of items whose
+ *  elements are still to be released, so deeply nested data can not
+ *  overflow the C stack.  Each entry is a long item header, or a set or
+ *  map trie node, which nothing else uses.
+ *
+ *  Normally whoever pushes the first entry empties the stack at once.
+ *  If freeing is deferred the interpreter releases
+ *  \verb"FREE_QUANTUM" elements at a time, on backward branches and
+ *  before it maps a new slab, so dropping a large structure does not
+ *  stop the program while it is freed.
+\*/
+
+#define FREE_SET_TRIE     -1           /* set trie node                     */
+#define FREE_MAP_TRIE     -2           /* map trie node                     */
+#define FREE_QUANTUM     256           /* elements released per step        */
+#define FREE_STACK_BLOCK 256           /* stack growth increment            */
+
+struct free_item {
+   int fi_kind;                        /* form code or trie type            */
+   void *fi_ptr;                       /* item to be released               */
+};
+
+#define free_step() { \
+   if (FREE_STACK_TOP > 0) \
+      free_drain(SETL_SYSTEM NO); \
+}
+
+#ifdef TSAFE
+#define FREE_STACK plugin_instance->free_stack
+#define FREE_STACK_TOP plugin_instance->free_stack_top
+#define FREE_STACK_MAX plugin_instance->free_stack_max
+#define FREE_DRAINING plugin_instance->free_draining
+#define DEFER_FREE plugin_instance->defer_free
+#else
+#define FREE_STACK free_stack
+#define FREE_STACK_TOP free_stack_top
+#define FREE_STACK_MAX free_stack_max
+#define FREE_DRAINING free_draining
+#define DEFER_FREE defer_free
+
+#ifdef SHARED
+
+struct free_item *free_stack = NULL;   /* items still to be released        */
+int32 free_stack_top = 0;              /* number of entries in use          */
+int32 free_stack_max = 0;              /* size of stack                     */
+int free_draining = NO;                /* YES while the stack is emptied    */
+int defer_free = NO;                   /* YES to release a step at a time   */
+
+#else
+
+extern struct free_item *free_stack;   /* items still to be released        */
+extern int32 free_stack_top;           /* number of entries in use          */
+extern int32 free_stack_max;           /* size of stack                     */
+extern int free_draining;              /* YES while the stack is emptied    */
+extern int defer_free;                 /* YES to release a step at a time   */
+
+#endif
+#endif
+
 /* public function declarations */
 
 struct specifier_item *get_specifiers(SETL_SYSTEM_PROTO int32);
                                        /* allocate a block of specifiers    */
 void free_specifier(SETL_SYSTEM_PROTO struct specifier_item *);
                                        /* release memory used by specifier  */
+void free_later(SETL_SYSTEM_PROTO int, void *);
+                                       /* queue an item to be released      */
+void free_drain(SETL_SYSTEM_PROTO int);
+                                       /* release queued items              */
 int spec_equal_test(SETL_SYSTEM_PROTO specifier *, specifier *);
                                        /* compare two specifiers            */
 int32 spec_hash_code_calc(specifier *);
                                        /* calculate hash code               */
+void init_hash_seed(SETL_SYSTEM_PROTO_VOID);
+                                       /* choose the hash code seed         */
+int32 hash_bytes(char *, int32);       /* hash code of a string of bytes    */
+void hash_statistics(SETL_SYSTEM_PROTO_VOID);
+                                       /* print hash code quality           */
+int32 register_type(SETL_SYSTEM_PROTO char *, void *);
+                                       /* register an opaque type           */
 
 #define SPECS_LOADED 1
 #endif
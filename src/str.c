@@ -30,6 +30,10 @@
  *  to someday move those into a library.
 \*/
 
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
+
 /* SETL2 system header files */
 
 #include "system.h"                    /* SETL2 system constants            */
@@ -107,14 +111,27 @@
 #define PRTYPE static                  /* prototype class                   */
 #endif
 
+/*
+ *  A string builder is an opaque item, so it is shared by reference
+ *  like a file.  It keeps its characters in a buffer of its own, which
+ *  doubles as it fills, and hands that buffer over when we make a
+ *  string from it.
+ */
+
+struct string_builder_item {
+   int32 sb_use_count;                 /* usage count                       */
+   int32 sb_type;                      /* registered opaque type            */
+   int32 sb_length;                    /* characters appended so far        */
+   int32 sb_capacity;                  /* size of sb_chars, less the null   */
+   char *sb_chars;                     /* character buffer, or NULL         */
+};
+
 /* package global variables */
 
+
 PCLASS string_h_ptr_type str_curr_hdr; /* str return string                 */
-PCLASS string_c_ptr_type str_curr_cell;
-                                       /* current cell in above             */
-PCLASS char *str_char_ptr, *str_char_end;
-                                       /* character pointers in above       */
 PCLASS char character_set[256];        /* character set (bit vector sortof) */
+PCLASS int32 builder_type = 0;         /* opaque type of string builders    */
 
 /* forward declarations */
 
@@ -124,6 +141,14 @@ PRTYPE void str_cat_spec(SETL_SYSTEM_PROTO specifier *);
 PRTYPE void str_cat_string(SETL_SYSTEM_PROTO char *); 
                                        /* concatenate a string on str's     */
                                        /* return value                      */
+PRTYPE void str_char_set(SETL_SYSTEM_PROTO string_h_ptr_type);
+                                       /* load the pattern character set    */
+PRTYPE void str_split(SETL_SYSTEM_PROTO specifier *, int32, int,
+                      specifier *);
+                                       /* split a string in two             */
+PRTYPE struct string_builder_item *str_get_builder(SETL_SYSTEM_PROTO
+                      specifier *, char *);
+                                       /* check a string builder argument   */
 
 #if !SHORT_TEXT | ROOT
 
@@ -142,32 +167,25 @@ void setl2_char(
 
 {
 string_h_ptr_type string_hdr;          /* string header pointer             */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 
    /* char is only valid for integers */
 
-   if (argv[0].sp_form != ft_short ||
-       argv[0].sp_val.sp_short_value < 0 ||
-       argv[0].sp_val.sp_short_value > 256)
+   if (spec_form(&argv[0]) != ft_short ||
+       spec_val(&argv[0],sp_short_value) < 0 ||
+       spec_val(&argv[0],sp_short_value) > 256)
       abend(SETL_SYSTEM msg_bad_arg,"integer",1,"char",
             abend_opnd_str(SETL_SYSTEM argv));
 
    /* create a one-character string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 1;
-   get_string_cell(string_cell);
-   string_cell->s_next = string_cell->s_prev = NULL;
-   string_hdr->s_head = string_hdr->s_tail = string_cell;
-   string_cell->s_cell_value[0] = (char)(argv[0].sp_val.sp_short_value);
+   string_hdr = new_string_buffer(SETL_SYSTEM 1);
+   string_hdr->s_chars[0] = (char)(spec_val(&argv[0],sp_short_value));
 
    /* set the target and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -189,25 +207,14 @@ void setl2_str(
 
 {
 string_h_ptr_type save_str_curr_hdr;  /* str return string                 */
-string_c_ptr_type save_str_curr_cell; /* current cell in above             */
-char *save_str_char_ptr, *save_str_char_end;
-                                       /* character pointers in above       */
 
-   /* save string variables in case we're called recursively */
+   /* save the return string in case we're called recursively */
 
    save_str_curr_hdr = str_curr_hdr;
-   save_str_curr_cell = str_curr_cell;
-   save_str_char_ptr = str_char_ptr;
-   save_str_char_end = str_char_end;
 
    /* initialize the return string */
 
-   get_string_header(str_curr_hdr);
-   str_curr_hdr->s_use_count = 1;
-   str_curr_hdr->s_hash_code = -1;
-   str_curr_hdr->s_length = 0;
-   str_curr_hdr->s_head = str_curr_hdr->s_tail = str_curr_cell = NULL;
-   str_char_ptr = str_char_end = NULL;
+   str_curr_hdr = new_string_buffer(SETL_SYSTEM 0);
 
    /* call a recursive function to make the string */
 
@@ -216,15 +223,12 @@ char *save_str_char_ptr, *save_str_char_end;
    /* set the return value and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = str_curr_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,str_curr_hdr);
 
-   /* restore string variables */
+   /* restore the return string */
 
    str_curr_hdr = save_str_curr_hdr;
-   str_curr_cell = save_str_curr_cell;
-   str_char_ptr = save_str_char_ptr;
-   str_char_end = save_str_char_end;
 
    return;
 
@@ -244,7 +248,7 @@ PRTYPE void str_cat_spec(
 {
 char tmpstring[100];                   /* work string (for sprintf)         */
 
-   switch (spec->sp_form) {
+   switch (spec_form(spec)) {
 
 /*\
  *  \case{unprintable types}
@@ -269,14 +273,14 @@ case ft_atom :
 
 {
 
-   if (spec->sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num) {
+   if (spec_val(spec,sp_atom_num) == spec_val(spec_true,sp_atom_num)) {
       strcpy(tmpstring,"TRUE");
    }
-   else if (spec->sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
+   else if (spec_val(spec,sp_atom_num) == spec_val(spec_false,sp_atom_num)) {
       strcpy(tmpstring,"FALSE");
    }
    else {
-      sprintf(tmpstring,"<atom %ld>",spec->sp_val.sp_atom_num);
+      sprintf(tmpstring,"<atom %ld>",spec_val(spec,sp_atom_num));
    }
 
    str_cat_string(SETL_SYSTEM tmpstring);
@@ -291,12 +295,12 @@ case ft_opaque :
 
 #if WATCOM
 
-   sprintf(tmpstring,"<opaque %p>",spec->sp_val.sp_opaque_ptr);
+   sprintf(tmpstring,"<opaque %p>",spec_val(spec,sp_opaque_ptr));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #else
 
-   sprintf(tmpstring,"<opaque %ld>",(int32)(spec->sp_val.sp_opaque_ptr));
+   sprintf(tmpstring,"<opaque %ld>",(int32)(spec_val(spec,sp_opaque_ptr)));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #endif
@@ -311,12 +315,12 @@ case ft_label :
 
 #if WATCOM
 
-   sprintf(tmpstring,"<label %p>",spec->sp_val.sp_label_ptr);
+   sprintf(tmpstring,"<label %p>",spec_val(spec,sp_label_ptr));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #else
 
-   sprintf(tmpstring,"<label %ld>",(int32)(spec->sp_val.sp_label_ptr));
+   sprintf(tmpstring,"<label %ld>",(int32)(spec_val(spec,sp_label_ptr)));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #endif
@@ -331,12 +335,12 @@ case ft_file :
 
 #if WATCOM
 
-   sprintf(tmpstring,"<file %p>",spec->sp_val.sp_file_ptr);
+   sprintf(tmpstring,"<file %p>",spec_val(spec,sp_file_ptr));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #else
 
-   sprintf(tmpstring,"<file %ld>",(int32)(spec->sp_val.sp_file_ptr));
+   sprintf(tmpstring,"<file %ld>",(int32)(spec_val(spec,sp_file_ptr)));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #endif
@@ -351,12 +355,12 @@ case ft_proc :
 
 #if WATCOM
 
-   sprintf(tmpstring,"<procedure %p>",spec->sp_val.sp_proc_ptr);
+   sprintf(tmpstring,"<procedure %p>",spec_val(spec,sp_proc_ptr));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #else
 
-   sprintf(tmpstring,"<procedure %ld>",(int32)(spec->sp_val.sp_proc_ptr));
+   sprintf(tmpstring,"<procedure %ld>",(int32)(spec_val(spec,sp_proc_ptr)));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #endif
@@ -373,18 +377,18 @@ int first_element;                     /* first entry switch                */
 
 #if WATCOM
 
-   sprintf(tmpstring,"<mailbox %p",spec->sp_val.sp_mailbox_ptr);
+   sprintf(tmpstring,"<mailbox %p",spec_val(spec,sp_mailbox_ptr));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #else
 
-   sprintf(tmpstring,"<mailbox %ld",(int32)(spec->sp_val.sp_mailbox_ptr));
+   sprintf(tmpstring,"<mailbox %ld",(int32)(spec_val(spec,sp_mailbox_ptr)));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #endif
 
    first_element = YES;
-   for (cell_ptr = spec->sp_val.sp_mailbox_ptr->mb_head;
+   for (cell_ptr = spec_val(spec,sp_mailbox_ptr)->mb_head;
         cell_ptr != NULL;
         cell_ptr = cell_ptr->mb_next) {
 
@@ -410,12 +414,12 @@ case ft_iter :
 
 #if WATCOM
 
-   sprintf(tmpstring,"<iterator %p>",spec->sp_val.sp_iter_ptr);
+   sprintf(tmpstring,"<iterator %p>",spec_val(spec,sp_iter_ptr));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #else
 
-   sprintf(tmpstring,"<iterator %ld>",(int32)(spec->sp_val.sp_iter_ptr));
+   sprintf(tmpstring,"<iterator %ld>",(int32)(spec_val(spec,sp_iter_ptr)));
    str_cat_string(SETL_SYSTEM tmpstring);
 
 #endif
@@ -435,7 +439,7 @@ case ft_short :
 
 {
 
-   sprintf(tmpstring,"%ld",spec->sp_val.sp_short_value);
+   sprintf(tmpstring,"%ld",spec_val(spec,sp_short_value));
    str_cat_string(SETL_SYSTEM tmpstring);
    return;
 
@@ -465,7 +469,7 @@ case ft_real :
 
 {
 
-   sprintf(tmpstring,"%#.11g",(spec->sp_val.sp_real_ptr)->r_value);
+   sprintf(tmpstring,"%#.11g",spec_val(spec,sp_real_value));
    str_cat_string(SETL_SYSTEM tmpstring);
 
    return;
@@ -475,59 +479,38 @@ case ft_real :
 /*\
  *  \case{strings}
  *
- *  Strings are complex structures, because we allow infinite length.  We
- *  have to print each cell individually, and translate nulls to blanks.
+ *  We copy the characters of a string directly onto the return string,
+ *  translating nulls to blanks.
 \*/
 
 case ft_string :
 
 {
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
-int32 chars_to_print;                  /* characters left in string         */
-char cell_string[STR_CELL_WIDTH + 1];  /* printable cell string             */
+int32 chars_to_print;                  /* characters in string              */
 char *s, *t;                           /* temporary looping variables       */
 
-   /* loop over the cells ... */
-
-   string_hdr = spec->sp_val.sp_string_ptr;
+   string_hdr = spec_val(spec,sp_string_ptr);
    chars_to_print = string_hdr->s_length;
-   for (string_cell = string_hdr->s_head;
-        chars_to_print && string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      /* translate nulls to spaces */
-
-      for (s = string_cell->s_cell_value, t = cell_string;
-           s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           s++, t++) {
-
-         if (*s == '\0')
-            *t = ' ';
-         else
-            *t = *s;
-
-      }
-
-      /* print the cell (or as much as necessary) */
-
-      if (chars_to_print < STR_CELL_WIDTH) {
-
-         cell_string[chars_to_print] = '\0';
-         chars_to_print = 0;
+   reserve_string(str_curr_hdr,str_curr_hdr->s_length + chars_to_print);
 
-      }
-      else {
+   /* translate nulls to spaces */
 
-         cell_string[STR_CELL_WIDTH] = '\0';
-         chars_to_print -= STR_CELL_WIDTH;
-
-      }
+   for (s = string_hdr->s_chars,
+           t = str_curr_hdr->s_chars + str_curr_hdr->s_length;
+        s < string_hdr->s_chars + chars_to_print;
+        s++, t++) {
 
-      str_cat_string(SETL_SYSTEM cell_string);
+      if (*s == '\0')
+         *t = ' ';
+      else
+         *t = *s;
 
    }
 
+   *t = '\0';
+   str_curr_hdr->s_length += chars_to_print;
+
    return;
 
 }
@@ -543,10 +526,9 @@ case ft_set :
 
 {
 int first_element;                     /* YES for the first element         */
-set_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+set_h_ptr_type source_root;            /* root of set                       */
+struct set_cursor_item source_cursor;  /* position in set                   */
 set_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
 specifier *source_element;             /* set element                       */
 
    /* print the opening brace, and start looping over the set */
@@ -554,83 +536,14 @@ specifier *source_element;             /* set element                       */
    str_cat_string(SETL_SYSTEM "{");
    first_element = YES;
 
-   source_root = spec->sp_val.sp_set_ptr;
-   source_work_hdr = source_root;
-   source_height = source_root->s_ntype.s_root.s_height;
-   source_cell = NULL;
-   source_index = 0;
+   source_root = spec_val(spec,sp_set_ptr);
+   set_cursor_start(&source_cursor,source_root->s_trie);
 
    /* loop over the elements of source */
 
-   for (;;) {
-
-      /* find the next element in the set */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, break */
-
-         if (source_cell != NULL) {
-
-            source_element = &(source_cell->s_spec);
-            source_cell = source_cell->s_next;
-            break;
-
-         }
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < SET_HASH_SIZE) {
-
-            source_cell = source_work_hdr->s_child[source_index].s_cell;
-            source_index++;
-            continue;
-
-         }
+   while ((source_cell = set_cursor_next(&source_cursor)) != NULL) {
 
-         /* move up if we're at the end of a node */
-
-         if (source_index >= SET_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->s_ntype.s_intern.s_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->s_ntype.s_intern.s_parent;
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->s_child[source_index].s_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->s_child[source_index].s_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if we've exhausted the set break again */
-
-      if (source_element == NULL)
-         break;
+      source_element = &(source_cell->s_spec);
 
       /*
        *  At this point we have an element in source_element which must
@@ -646,7 +559,7 @@ specifier *source_element;             /* set element                       */
 
       /* print enclosing quotes around strings */
 
-      if (source_element->sp_form == ft_string) {
+      if (spec_form(source_element) == ft_string) {
 
          str_cat_string(SETL_SYSTEM "\"");
          str_cat_spec(SETL_SYSTEM source_element);
@@ -682,14 +595,8 @@ case ft_map :
 
 {
 int first_element;                     /* YES for the first element         */
-map_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
+struct map_cursor_item source_cursor;  /* position in map                   */
 map_c_ptr_type source_cell;            /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-set_h_ptr_type valset_root, valset_work_hdr;
-                                       /* root and internal node pointers   */
-set_c_ptr_type valset_cell;            /* current cell pointer              */
-int valset_height, valset_index;       /* current height and index          */
 specifier *domain_element, *range_element;
                                        /* pair from map                     */
 
@@ -698,169 +605,14 @@ specifier *domain_element, *range_element;
    str_cat_string(SETL_SYSTEM "{");
    first_element = YES;
 
-   source_root = spec->sp_val.sp_map_ptr;
-   source_work_hdr = source_root;
-   source_height = source_root->m_ntype.m_root.m_height;
-   source_cell = NULL;
-   source_index = 0;
-   valset_root = NULL;
-
-   /* loop over the elements of source */
-
-   for (;;) {
-
-      /* find the next cell in the map */
-
-      while (source_cell == NULL) {
-
-         /* start on the next clash list, if we're at a leaf */
-
-         if (!source_height && source_index < MAP_HASH_SIZE) {
-
-            source_cell = source_work_hdr->m_child[source_index].m_cell;
-            source_index++;
-            continue;
-
-         }
-
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= MAP_HASH_SIZE) {
-
-            /* there are no more elements, so break */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            /* otherwise move up */
-
-            source_height++;
-            source_index =
-               source_work_hdr->m_ntype.m_intern.m_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->m_ntype.m_intern.m_parent;
-            continue;
+   map_pair_start(&source_cursor,spec_val(spec,sp_map_ptr));
 
-         }
+   /* loop over the pairs of source */
 
-         /* skip over null nodes */
+   while ((source_cell = map_pair_next(&source_cursor,
+                                       &range_element)) != NULL) {
 
-         if (source_work_hdr->m_child[source_index].m_header == NULL) {
-
-            source_index++;
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr =
-            source_work_hdr->m_child[source_index].m_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      /* if there are no more cells, break */
-
-      if (source_cell == NULL)
-         break;
-
-      /* if the cell is not multi-value, use the pair directly */
-
-      if (!(source_cell->m_is_multi_val)) {
-
-         domain_element = &(source_cell->m_domain_spec);
-         range_element = &(source_cell->m_range_spec);
-         source_cell = source_cell->m_next;
-
-      }
-
-      /* otherwise find the next element in the value set */
-
-      else {
-
-         domain_element = &(source_cell->m_domain_spec);
-         if (valset_root == NULL) {
-
-            valset_root = source_cell->m_range_spec.sp_val.sp_set_ptr;
-            valset_work_hdr = valset_root;
-            valset_height = valset_root->s_ntype.s_root.s_height;
-            valset_cell = NULL;
-            valset_index = 0;
-
-         }
-
-         range_element = NULL;
-         for (;;) {
-
-            /* if we have an element already, break */
-
-            if (valset_cell != NULL) {
-
-               range_element = &(valset_cell->s_spec);
-               valset_cell = valset_cell->s_next;
-               break;
-
-            }
-
-            /* start on the next clash list, if we're at a leaf */
-
-            if (!valset_height && valset_index < SET_HASH_SIZE) {
-
-               valset_cell = valset_work_hdr->s_child[valset_index].s_cell;
-               valset_index++;
-               continue;
-
-            }
-
-            /* the current header node is exhausted -- find the next one */
-
-            if (valset_index >= SET_HASH_SIZE) {
-
-               /* there are no more elements, so break */
-
-               if (valset_work_hdr == valset_root)
-                  break;
-
-               /* otherwise move up */
-
-               valset_height++;
-               valset_index =
-                  valset_work_hdr->s_ntype.s_intern.s_child_index + 1;
-               valset_work_hdr =
-                  valset_work_hdr->s_ntype.s_intern.s_parent;
-               continue;
-
-            }
-
-            /* skip over null nodes */
-
-            if (valset_work_hdr->s_child[valset_index].s_header == NULL) {
-
-               valset_index++;
-               continue;
-
-            }
-
-            /* otherwise drop down a level */
-
-            valset_work_hdr =
-               valset_work_hdr->s_child[valset_index].s_header;
-            valset_index = 0;
-            valset_height--;
-
-         }
-
-         if (range_element == NULL) {
-
-            source_cell = source_cell->m_next;
-            valset_root = NULL;
-            continue;
-
-         }
-      }
+      domain_element = &(source_cell->m_domain_spec);
 
       /*
        *  At this point we have a pair from the map which we would like to
@@ -878,7 +630,7 @@ specifier *domain_element, *range_element;
 
        str_cat_string(SETL_SYSTEM "[");
 
-      if (domain_element->sp_form == ft_string) {
+      if (spec_form(domain_element) == ft_string) {
 
          str_cat_string(SETL_SYSTEM "\"");
          str_cat_spec(SETL_SYSTEM domain_element);
@@ -898,7 +650,7 @@ specifier *domain_element, *range_element;
 
        str_cat_string(SETL_SYSTEM ", ");
 
-      if (range_element->sp_form == ft_string) {
+      if (spec_form(range_element) == ft_string) {
 
          str_cat_string(SETL_SYSTEM "\"");
          str_cat_spec(SETL_SYSTEM range_element);
@@ -936,119 +688,48 @@ specifier *domain_element, *range_element;
 case ft_tuple :
 
 {
-int32 printed_number;                  /* number of elements printed        */
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
+tuple_h_ptr_type source_root;          /* tuple to be printed               */
+specifier *source_element;             /* tuple element                     */
+specifier packed_element;              /* element of a packed tuple         */
+int32 i;                               /* temporary looping variable        */
 
    /* print the opening bracket, and start looping over the tuple */
 
    str_cat_string(SETL_SYSTEM "[");
-   printed_number = 0;
-
-   source_root = spec->sp_val.sp_tuple_ptr;
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
-
-   /* loop over the elements of source */
-
-   while (source_number < source_root->t_ntype.t_root.t_length) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
 
-         if (source_index >= TUP_HEADER_SIZE) {
+   source_root = spec_val(spec,sp_tuple_ptr);
 
-            /* break if we've exhausted the source */
+   /* packed tuples hold only numbers */
 
-            if (source_work_hdr == source_root)
-               break;
+   if (is_packed(source_root)) {
 
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
+      for (i = 0; i < source_root->t_length; i++) {
 
-            continue;
+         if (i > 0)
+            str_cat_string(SETL_SYSTEM ", ");
+         get_packed_element(source_root,i,&packed_element);
+         str_cat_spec(SETL_SYSTEM &packed_element);
 
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
+      }
 
-         /* otherwise drop down a level */
+      str_cat_string(SETL_SYSTEM "]");
 
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+      return;
 
-      }
+   }
 
-      if (source_element == NULL)
-         break;
+   for (i = 0; i < source_root->t_length; i++) {
 
-      /*
-       *  At this point we have an element in source_element which must
-       *  be printed.  We might have to print a bunch of OM's first
-       *  though.
-       */
+      source_element = &(tuple_cell_at(source_root,i)->t_spec);
 
       /* print a comma after the previous element */
 
-      if (printed_number != 0)
+      if (i > 0)
          str_cat_string(SETL_SYSTEM ", ");
 
-      while (printed_number++ < source_number) {
-
-         str_cat_string(SETL_SYSTEM "<om>, ");
-
-      }
-
       /* print enclosing quotes around strings */
 
-      if (source_element->sp_form == ft_string) {
+      if (spec_form(source_element) == ft_string) {
 
          str_cat_string(SETL_SYSTEM "\"");
          str_cat_spec(SETL_SYSTEM source_element);
@@ -1056,7 +737,7 @@ specifier *source_element;             /* set element                       */
 
       }
 
-      /* otherwise, just print the element */
+      /* otherwise, just print the element, which may be <om> */
 
       else {
 
@@ -1095,7 +776,7 @@ specifier spare;                       /* spare for user-defined method     */
 
    /* pick out the object root and class */
 
-   object_root = spec->sp_val.sp_object_ptr;
+   object_root = spec_val(spec,sp_object_ptr);
    class_ptr = object_root->o_ntype.o_root.o_class;
 
    /* get information about the str slot in the object */
@@ -1108,7 +789,7 @@ specifier spare;                       /* spare for user-defined method     */
 
       /* call the procedure */
 
-      spare.sp_form = ft_omega;
+      spec_set_form(&spare,ft_omega);
       call_procedure(SETL_SYSTEM &spare,
                      slot_info->si_spec,
                      spec,
@@ -1215,195 +896,152 @@ PRTYPE void str_cat_string(
    char *charstring)                   /* C string to be concatenated       */
 
 {
-char *p;                               /* temporary looping variable        */
-
-   p = charstring;
-   while (*p) {
-
-      if (str_char_ptr == str_char_end) {
+int32 length;                          /* length of charstring              */
 
-         get_string_cell(str_curr_cell);
-         if (str_curr_hdr->s_tail != NULL)
-            (str_curr_hdr->s_tail)->s_next = str_curr_cell;
-         str_curr_cell->s_prev = str_curr_hdr->s_tail;
-         str_curr_cell->s_next = NULL;
-         str_curr_hdr->s_tail = str_curr_cell;
-         if (str_curr_hdr->s_head == NULL)
-            str_curr_hdr->s_head = str_curr_cell;
-         str_char_ptr = str_curr_cell->s_cell_value;
-         str_char_end = str_char_ptr + STR_CELL_WIDTH;
+   length = (int32)strlen(charstring);
+   reserve_string(str_curr_hdr,str_curr_hdr->s_length + length);
+   memcpy((void *)(str_curr_hdr->s_chars + str_curr_hdr->s_length),
+          (void *)charstring,
+          (size_t)(length + 1));
+   str_curr_hdr->s_length += length;
 
-      }
-
-      *str_char_ptr++ = *p++;
-      str_curr_hdr->s_length++;
+   return;
 
-   }
 }
 
 /*\
- *  \function{setl2\_any()}
+ *  \function{str\_char\_set()}
  *
- *  This function is the \verb"any" built-in function.  We split one
- *  input string into two: the first character if it is in the span
- *  set and everything remaining.
+ *  This function loads the character set used by the pattern matching
+ *  functions with the characters of a pattern string.
 \*/
 
-void setl2_any(
+PRTYPE void str_char_set(
    SETL_SYSTEM_PROTO
-   int argc,                           /* number of arguments passed        */
-   specifier *argv,                    /* argument vector (two here)        */
-   specifier *target)                  /* return value                      */
+   string_h_ptr_type pattern_hdr)      /* pattern string                    */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length;                   /* source string length              */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
 char *p;                               /* temporary looping variable        */
 
-   /* make sure both arguments are strings */
-
-   if (argv[0].sp_form != ft_string)
-      abend(SETL_SYSTEM msg_bad_arg,"string",1,"any",
-            abend_opnd_str(SETL_SYSTEM argv));
-
-   if (argv[1].sp_form != ft_string)
-      abend(SETL_SYSTEM msg_bad_arg,"string",2,"any",
-            abend_opnd_str(SETL_SYSTEM argv+1));
-
    /* initialize the character set to empty */
 
    for (p = character_set; p < character_set + 256; *p++ = NO);
 
    /* set to true all the characters in the pattern string */
 
-   source_hdr = argv[1].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-
-   for (source_cell = source_hdr->s_head;
-        source_cell != NULL;
-        source_cell = source_cell->s_next) {
-
-      for (p = source_cell->s_cell_value;
-           p < source_cell->s_cell_value + STR_CELL_WIDTH &&
-              p < source_cell->s_cell_value + source_length;
-           character_set[(unsigned char)(*p++)] = YES);
-
-      source_length -= STR_CELL_WIDTH;
-
-   }
-
-   /* check the first character of the source string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_cell = source_hdr->s_head;
-   if (source_cell != NULL &&
-       source_hdr->s_length >= 1 &&
-       character_set[(unsigned char)(source_cell->s_cell_value[0])]) {
-
-      /* we found a match, create a one character string */
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = 1;
-      get_string_cell(target_cell);
-      target_hdr->s_head = target_hdr->s_tail = target_cell;
-      target_cell->s_next = target_cell->s_prev = NULL;
-      target_cell->s_cell_value[0] = source_cell->s_cell_value[0];
-
-      /* the first string is assigned to the target */
-
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = target_hdr;
+   for (p = pattern_hdr->s_chars;
+        p < pattern_hdr->s_chars + pattern_hdr->s_length;
+        character_set[(unsigned char)(*p++)] = YES);
 
-      /* set up to copy the tail of the string */
+   return;
 
-      source_length = source_hdr->s_length - 1;
-      source_char_ptr = source_cell->s_cell_value + 1;
-      source_char_end = source_cell->s_cell_value + STR_CELL_WIDTH;
+}
 
-      /* next create a tail string */
+/*\
+ *  \function{str\_split()}
+ *
+ *  The pattern matching functions all split their first argument in two,
+ *  return one piece and write the other back to the first argument.  This
+ *  function does that once they have found where to split.  If either
+ *  piece is the whole source string, we use the source rather than a
+ *  copy.
+\*/
 
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = source_length;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-      target_char_ptr = target_char_end = NULL;
+PRTYPE void str_split(
+   SETL_SYSTEM_PROTO
+   specifier *argv,                    /* source string is argv[0]          */
+   int32 split,                        /* length of the leading piece       */
+   int return_tail,                    /* YES to return the trailing piece  */
+   specifier *target)                  /* return value                      */
 
-      /* copy the tail of the source string */
+{
+specifier source;                      /* returned source string            */
+string_h_ptr_type source_hdr;          /* source string                     */
+string_h_ptr_type head_hdr, tail_hdr;  /* leading and trailing pieces       */
 
-      while (source_length--) {
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
 
-         if (source_char_ptr == source_char_end) {
+   if (split == source_hdr->s_length) {
+      head_hdr = source_hdr;
+      head_hdr->s_use_count++;
+   }
+   else {
+      head_hdr = new_string_chars(SETL_SYSTEM source_hdr->s_chars,split);
+   }
 
-            source_cell = source_cell->s_next;
-            source_char_ptr = source_cell->s_cell_value;
-            source_char_end = source_char_ptr + STR_CELL_WIDTH;
+   if (split == 0) {
+      tail_hdr = source_hdr;
+      tail_hdr->s_use_count++;
+   }
+   else {
+      tail_hdr = new_string_chars(SETL_SYSTEM source_hdr->s_chars + split,
+                                  source_hdr->s_length - split);
+   }
 
-         }
+   /* one piece is assigned to the target, and the other pushed */
 
-         if (target_char_ptr == target_char_end) {
+   unmark_specifier(target);
+   spec_set_form(target,ft_string);
+   spec_set_form(&source,ft_string);
 
-            get_string_cell(target_cell);
-            if (target_hdr->s_tail != NULL)
-               (target_hdr->s_tail)->s_next = target_cell;
-            target_cell->s_prev = target_hdr->s_tail;
-            target_cell->s_next = NULL;
-            target_hdr->s_tail = target_cell;
-            if (target_hdr->s_head == NULL)
-               target_hdr->s_head = target_cell;
-            target_char_ptr = target_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
+   if (return_tail) {
+      spec_set_val(target,sp_string_ptr,tail_hdr);
+      spec_set_val(&source,sp_string_ptr,head_hdr);
+   }
+   else {
+      spec_set_val(target,sp_string_ptr,head_hdr);
+      spec_set_val(&source,sp_string_ptr,tail_hdr);
+   }
 
-         }
+   push_pstack(&source);
+   (spec_val(&source,sp_string_ptr))->s_use_count--;
 
-         *target_char_ptr++ = *source_char_ptr++;
+   return;
 
-      }
+}
 
-      /* push the tail string */
+/*\
+ *  \function{setl2\_any()}
+ *
+ *  This function is the \verb"any" built-in function.  We split one
+ *  input string into two: the first character if it is in the span
+ *  set and everything remaining.
+\*/
 
-      source.sp_form = ft_string;
-      source.sp_val.sp_string_ptr = target_hdr;
-      push_pstack(&source);
-      target_hdr->s_use_count--;
+void setl2_any(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (two here)        */
+   specifier *target)                  /* return value                      */
 
-   }
+{
+string_h_ptr_type source_hdr;          /* source string                     */
+int32 split;                           /* length of the leading string      */
 
-   /*
-    *  If we didn't match, the left string is null and the right is the
-    *  source.
-    */
+   /* make sure both arguments are strings */
 
-   else {
+   if (spec_form(&argv[0]) != ft_string)
+      abend(SETL_SYSTEM msg_bad_arg,"string",1,"any",
+            abend_opnd_str(SETL_SYSTEM argv));
 
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = 0;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
+   if (spec_form(&argv[1]) != ft_string)
+      abend(SETL_SYSTEM msg_bad_arg,"string",2,"any",
+            abend_opnd_str(SETL_SYSTEM argv+1));
 
-      /* the first string is assigned to the target */
+   /* set to true all the characters in the pattern string */
 
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = target_hdr;
+   str_char_set(SETL_SYSTEM spec_val(&argv[1],sp_string_ptr));
 
-      /* push the tail string */
+   /* check the first character of the source string */
 
-      push_pstack(argv);
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   if (source_hdr->s_length >= 1 &&
+       character_set[(unsigned char)(source_hdr->s_chars[0])])
+      split = 1;
+   else
+      split = 0;
 
-   }
+   str_split(SETL_SYSTEM argv,split,NO,target);
 
    return;
 
@@ -1424,175 +1062,44 @@ void setl2_break(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length;                   /* source string length              */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+string_h_ptr_type source_hdr;          /* source string                     */
 char *p;                               /* temporary looping variable        */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"break",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"break",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* initialize the character set to empty */
-
-   for (p = character_set; p < character_set + 256; *p++ = NO);
-
    /* set to true all the characters in the pattern string */
 
-   source_hdr = argv[1].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
+   str_char_set(SETL_SYSTEM spec_val(&argv[1],sp_string_ptr));
 
-   for (source_cell = source_hdr->s_head;
-        source_cell != NULL;
-        source_cell = source_cell->s_next) {
+   /* find the first character in the break set */
 
-      for (p = source_cell->s_cell_value;
-           p < source_cell->s_cell_value + STR_CELL_WIDTH &&
-              p < source_cell->s_cell_value + source_length;
-           character_set[(unsigned char)(*p++)] = YES);
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   for (p = source_hdr->s_chars;
+        p < source_hdr->s_chars + source_hdr->s_length &&
+           !character_set[(unsigned char)(*p)];
+        p++);
 
-      source_length -= STR_CELL_WIDTH;
+   str_split(SETL_SYSTEM argv,(int32)(p - source_hdr->s_chars),NO,target);
 
-   }
-
-   /* initialize the source string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-   source_cell = source_hdr->s_head;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_char_ptr + STR_CELL_WIDTH;
-   }
+   return;
 
-   /* make a target string */
+}
 
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = 0;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the source until we find something not in the span set */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (character_set[(unsigned char)(*source_char_ptr)])
-         break;
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* we decremented the length once too often */
-
-   source_length++;
-   target_hdr->s_length = source_hdr->s_length - source_length;
-
-   /* the first string is assigned to the target */
-
-   unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-
-   /* next create a tail string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = source_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the tail of the source string */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* push the tail string */
-
-   source.sp_form = ft_string;
-   source.sp_val.sp_string_ptr = target_hdr;
-   push_pstack(&source);
-   target_hdr->s_use_count--;
-
-   return;
-
-}
-
-/*\
- *  \function{setl2\_len()}
- *
- *  This function is the \verb"len" built-in function.  We split split
- *  the source string into two: an initial string of {\em n} characters,
- *  and everything else.
-\*/
+/*\
+ *  \function{setl2\_len()}
+ *
+ *  This function is the \verb"len" built-in function.  We split split
+ *  the source string into two: an initial string of {\em n} characters,
+ *  and everything else.
+\*/
 
 void setl2_len(
    SETL_SYSTEM_PROTO
@@ -1601,40 +1108,32 @@ void setl2_len(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length, target_length;    /* source and target lengths         */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+int32 target_length;                   /* length of the leading string      */
 
    /* verify the argument types */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"len",
             abend_opnd_str(SETL_SYSTEM argv));
 
    /* we convert the length to a C long */
 
-   if (argv[1].sp_form == ft_short) {
+   if (spec_form(&argv[1]) == ft_short) {
 
-      target_length = argv[1].sp_val.sp_short_value;
+      target_length = spec_val(&argv[1],sp_short_value);
       if (target_length <= 0)
          abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"len",
                abend_opnd_str(SETL_SYSTEM argv+1));
 
    }
-   else if (argv[1].sp_form == ft_long) {
+   else if (spec_form(&argv[1]) == ft_long) {
 
-      if ((argv[1].sp_val.sp_long_ptr)->i_is_negative)
+      if ((spec_val(&argv[1],sp_long_ptr))->i_is_negative)
          abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"len",
                abend_opnd_str(SETL_SYSTEM argv+1));
 
-      target_length = long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+      target_length =
+         long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
 
    }
    else {
@@ -1644,121 +1143,12 @@ char *target_char_ptr, *target_char_end;
 
    }
 
-   /* initialize the source string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-   source_cell = source_hdr->s_head;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_char_ptr + STR_CELL_WIDTH;
-   }
-
    /* adjust the target length */
 
-   if (target_length > source_length) {
-      target_length = source_length;
-      source_length = 0;
-   }
-   else {
-      source_length -= target_length;
-   }
-
-   /* make a target string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = target_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the first n characters from the source */
+   if (target_length > spec_val(&argv[0],sp_string_ptr)->s_length)
+      target_length = spec_val(&argv[0],sp_string_ptr)->s_length;
 
-   while (target_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* the first string is assigned to the target */
-
-   unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-
-   /* next create a tail string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = source_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the tail of the source string */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* push the tail string */
-
-   source.sp_form = ft_string;
-   source.sp_val.sp_string_ptr = target_hdr;
-   push_pstack(&source);
-   target_hdr->s_use_count--;
+   str_split(SETL_SYSTEM argv,target_length,NO,target);
 
    return;
 
@@ -1778,145 +1168,32 @@ void setl2_match(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length, target_length;    /* source and target lengths         */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+string_h_ptr_type source_hdr, pattern_hdr;
+                                       /* source and pattern strings        */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"match",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"match",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* set up to scan each string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   target_hdr = argv[1].sp_val.sp_string_ptr;
-
-   if (target_hdr->s_length <= source_hdr->s_length) {
-
-      /* initialize each string */
-
-      source_length = source_hdr->s_length - target_hdr->s_length;
-      source_cell = source_hdr->s_head;
-      if (source_cell == NULL) {
-         source_char_ptr = source_char_end = NULL;
-      }
-      else {
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-      }
-
-      target_length = target_hdr->s_length;
-      target_cell = target_hdr->s_head;
-      if (target_cell == NULL) {
-         target_char_ptr = target_char_end = NULL;
-      }
-      else {
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-      }
-
-      /* compare the initial substrings */
-
-      while (target_length--) {
-
-         if (source_char_ptr == source_char_end) {
-
-            source_cell = source_cell->s_next;
-            source_char_ptr = source_cell->s_cell_value;
-            source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         if (target_char_ptr == target_char_end) {
-
-            target_cell = target_cell->s_next;
-            target_char_ptr = target_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         if (*source_char_ptr != *target_char_ptr)
-            break;
-
-         target_char_ptr++;
-         source_char_ptr++;
-
-      }
-
-      /* if the target matches the source */
-
-      if (target_length < 0) {
-
-         /* the first string is assigned to the target */
-
-         target_hdr->s_use_count++;
-         unmark_specifier(target);
-         target->sp_form = ft_string;
-         target->sp_val.sp_string_ptr = target_hdr;
-
-         /* next create a tail string */
-
-         get_string_header(target_hdr);
-         target_hdr->s_use_count = 1;
-         target_hdr->s_hash_code = -1;
-         target_hdr->s_length = source_length;
-         target_hdr->s_head = target_hdr->s_tail = NULL;
-         target_char_ptr = target_char_end = NULL;
+   /* if the source begins with the pattern we split it there */
 
-         /* copy the tail of the source string */
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   pattern_hdr = spec_val(&argv[1],sp_string_ptr);
+   if (pattern_hdr->s_length <= source_hdr->s_length &&
+       memcmp((void *)(source_hdr->s_chars),
+              (void *)(pattern_hdr->s_chars),
+              (size_t)(pattern_hdr->s_length)) == 0) {
 
-         while (source_length--) {
+      str_split(SETL_SYSTEM argv,pattern_hdr->s_length,NO,target);
 
-            if (source_char_ptr == source_char_end) {
-
-               source_cell = source_cell->s_next;
-               source_char_ptr = source_cell->s_cell_value;
-               source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_cell);
-               if (target_hdr->s_tail != NULL)
-                  (target_hdr->s_tail)->s_next = target_cell;
-               target_cell->s_prev = target_hdr->s_tail;
-               target_cell->s_next = NULL;
-               target_hdr->s_tail = target_cell;
-               if (target_hdr->s_head == NULL)
-                  target_hdr->s_head = target_cell;
-               target_char_ptr = target_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *source_char_ptr++;
-
-         }
-
-         /* push the tail string */
-
-         source.sp_form = ft_string;
-         source.sp_val.sp_string_ptr = target_hdr;
-         push_pstack(&source);
-         target_hdr->s_use_count--;
-
-         return;
+      return;
 
-      }
    }
 
    /*
@@ -1924,22 +1201,7 @@ char *target_char_ptr, *target_char_end;
     *  the initial source.
     */
 
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = 0;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* the first string is assigned to the target */
-
-   unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-
-   /* push the source string */
-
-   push_pstack(argv);
+   str_split(SETL_SYSTEM argv,0,NO,target);
 
    return;
 
@@ -1960,154 +1222,33 @@ void setl2_notany(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length;                   /* source string length              */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
-char *p;                               /* temporary looping variable        */
+string_h_ptr_type source_hdr;          /* source string                     */
+int32 split;                           /* length of the leading string      */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"notany",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"notany",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* initialize the character set to empty */
-
-   for (p = character_set; p < character_set + 256; *p++ = NO);
-
    /* set to true all the characters in the pattern string */
 
-   source_hdr = argv[1].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-
-   for (source_cell = source_hdr->s_head;
-        source_cell != NULL;
-        source_cell = source_cell->s_next) {
-
-      for (p = source_cell->s_cell_value;
-           p < source_cell->s_cell_value + STR_CELL_WIDTH &&
-              p < source_cell->s_cell_value + source_length;
-           character_set[(unsigned char)(*p++)] = YES);
-
-      source_length -= STR_CELL_WIDTH;
-
-   }
+   str_char_set(SETL_SYSTEM spec_val(&argv[1],sp_string_ptr));
 
    /* check the first character of the source string */
 
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_cell = source_hdr->s_head;
-   if (source_cell != NULL &&
-       source_hdr->s_length >= 1 &&
-       !character_set[(unsigned char)(source_cell->s_cell_value[0])]) {
-
-      /* we found a match, create a one character string */
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = 1;
-      get_string_cell(target_cell);
-      target_hdr->s_head = target_hdr->s_tail = target_cell;
-      target_cell->s_next = target_cell->s_prev = NULL;
-      target_cell->s_cell_value[0] = source_cell->s_cell_value[0];
-
-      /* the first string is assigned to the target */
-
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = target_hdr;
-
-      /* set up to copy the tail of the string */
-
-      source_length = source_hdr->s_length - 1;
-      source_char_ptr = source_cell->s_cell_value + 1;
-      source_char_end = source_cell->s_cell_value + STR_CELL_WIDTH;
-
-      /* next create a tail string */
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = source_length;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-      target_char_ptr = target_char_end = NULL;
-
-      /* copy the tail of the source string */
-
-      while (source_length--) {
-
-         if (source_char_ptr == source_char_end) {
-
-            source_cell = source_cell->s_next;
-            source_char_ptr = source_cell->s_cell_value;
-            source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         if (target_char_ptr == target_char_end) {
-
-            get_string_cell(target_cell);
-            if (target_hdr->s_tail != NULL)
-               (target_hdr->s_tail)->s_next = target_cell;
-            target_cell->s_prev = target_hdr->s_tail;
-            target_cell->s_next = NULL;
-            target_hdr->s_tail = target_cell;
-            if (target_hdr->s_head == NULL)
-               target_hdr->s_head = target_cell;
-            target_char_ptr = target_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *target_char_ptr++ = *source_char_ptr++;
-
-      }
-
-      /* push the tail string */
-
-      source.sp_form = ft_string;
-      source.sp_val.sp_string_ptr = target_hdr;
-      push_pstack(&source);
-      target_hdr->s_use_count--;
-
-   }
-
-   /*
-    *  If we didn't match, the left string is null and the right is the
-    *  source.
-    */
-
-   else {
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = 0;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-
-      /* the first string is assigned to the target */
-
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = target_hdr;
-
-      /* push the source string */
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   if (source_hdr->s_length >= 1 &&
+       !character_set[(unsigned char)(source_hdr->s_chars[0])])
+      split = 1;
+   else
+      split = 0;
 
-      push_pstack(argv);
-
-   }
+   str_split(SETL_SYSTEM argv,split,NO,target);
 
    return;
 
@@ -2131,163 +1272,32 @@ void setl2_span(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length;                   /* source string length              */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+string_h_ptr_type source_hdr;          /* source string                     */
 char *p;                               /* temporary looping variable        */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"span",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"span",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* initialize the character set to empty */
-
-   for (p = character_set; p < character_set + 256; *p++ = NO);
-
    /* set to true all the characters in the pattern string */
 
-   source_hdr = argv[1].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-
-   for (source_cell = source_hdr->s_head;
-        source_cell != NULL;
-        source_cell = source_cell->s_next) {
-
-      for (p = source_cell->s_cell_value;
-           p < source_cell->s_cell_value + STR_CELL_WIDTH &&
-              p < source_cell->s_cell_value + source_length;
-           character_set[(unsigned char)(*p++)] = YES);
-
-      source_length -= STR_CELL_WIDTH;
-
-   }
-
-   /* initialize the source string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-   source_cell = source_hdr->s_head;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_char_ptr + STR_CELL_WIDTH;
-   }
-
-   /* make a target string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = 0;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the source until we find something not in the span set */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (!character_set[(unsigned char)(*source_char_ptr)])
-         break;
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* we decremented the length once too often */
-
-   source_length++;
-   target_hdr->s_length = source_hdr->s_length - source_length;
-
-   /* the first string is assigned to the target */
-
-   unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-
-   /* next create a tail string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = source_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the tail of the source string */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
+   str_char_set(SETL_SYSTEM spec_val(&argv[1],sp_string_ptr));
 
-   }
+   /* find the first character not in the span set */
 
-   /* push the tail string */
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   for (p = source_hdr->s_chars;
+        p < source_hdr->s_chars + source_hdr->s_length &&
+           character_set[(unsigned char)(*p)];
+        p++);
 
-   source.sp_form = ft_string;
-   source.sp_val.sp_string_ptr = target_hdr;
-   push_pstack(&source);
-   target_hdr->s_use_count--;
+   str_split(SETL_SYSTEM argv,(int32)(p - source_hdr->s_chars),NO,target);
 
    return;
 
@@ -2309,38 +1319,33 @@ void setl2_lpad(
 {
 string_h_ptr_type source_hdr, target_hdr;
                                        /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length, target_length;    /* and target lengths                */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+int32 target_length;                   /* target length                     */
 
    /* verify the argument types */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"lpad",
             abend_opnd_str(SETL_SYSTEM argv));
 
    /* we convert the length to a C long */
 
-   if (argv[1].sp_form == ft_short) {
+   if (spec_form(&argv[1]) == ft_short) {
 
-      target_length = argv[1].sp_val.sp_short_value;
+      target_length = spec_val(&argv[1],sp_short_value);
       if (target_length <= 0)
          abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"lpad",
                abend_opnd_str(SETL_SYSTEM argv+1));
 
 
    }
-   else if (argv[1].sp_form == ft_long) {
+   else if (spec_form(&argv[1]) == ft_long) {
 
-      if ((argv[1].sp_val.sp_long_ptr)->i_is_negative)
+      if ((spec_val(&argv[1],sp_long_ptr))->i_is_negative)
          abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"lpad",
                abend_opnd_str(SETL_SYSTEM argv+1));
 
-      target_length = long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+      target_length =
+         long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
 
    }
    else {
@@ -2352,13 +1357,13 @@ char *target_char_ptr, *target_char_end;
 
    /* if the length is already too long return the argument */
 
-   source_hdr = argv[0].sp_val.sp_string_ptr;
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
    if (source_hdr->s_length >= target_length) {
 
       source_hdr->s_use_count++;
       unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = source_hdr;
+      spec_set_form(target,ft_string);
+      spec_set_val(target,sp_string_ptr,source_hdr);
 
       return;
 
@@ -2366,89 +1371,26 @@ char *target_char_ptr, *target_char_end;
 
    /* make a target string */
 
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = target_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
+   target_hdr = new_string_buffer(SETL_SYSTEM target_length);
 
-   /* set up the source string */
+   /* pad the target with blanks, then copy the source */
 
-   source_length = source_hdr->s_length;
-   source_cell = source_hdr->s_head;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_char_ptr + STR_CELL_WIDTH;
-   }
+   memset((void *)(target_hdr->s_chars),' ',
+          (size_t)(target_length - source_hdr->s_length));
+   memcpy((void *)(target_hdr->s_chars + target_length -
+                   source_hdr->s_length),
+          (void *)(source_hdr->s_chars),
+          (size_t)(source_hdr->s_length));
 
-   /* pad the target with blanks */
+   /* set the target and return */
 
-   target_length -= source_length;
-   while (target_length--) {
+   unmark_specifier(target);
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,target_hdr);
 
-      if (target_char_ptr == target_char_end) {
+   return;
 
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = ' ';
-
-   }
-
-   /* copy the source */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* set the target and return */
-
-   unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-
-   return;
-
-}
+}
 
 /*\
  *  \function{setl2\_rany()}
@@ -2465,162 +1407,33 @@ void setl2_rany(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length;                   /* source string length              */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
-char *p;                               /* temporary looping variable        */
+string_h_ptr_type source_hdr;          /* source string                     */
+int32 split;                           /* length of the leading string      */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"rany",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"rany",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* initialize the character set to empty */
-
-   for (p = character_set; p < character_set + 256; *p++ = NO);
-
    /* set to true all the characters in the pattern string */
 
-   source_hdr = argv[1].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-
-   for (source_cell = source_hdr->s_head;
-        source_cell != NULL;
-        source_cell = source_cell->s_next) {
-
-      for (p = source_cell->s_cell_value;
-           p < source_cell->s_cell_value + STR_CELL_WIDTH &&
-              p < source_cell->s_cell_value + source_length;
-           character_set[(unsigned char)(*p++)] = YES);
-
-      source_length -= STR_CELL_WIDTH;
-
-   }
-
-   /* check the first character of the source string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_cell = source_hdr->s_tail;
-   if (source_cell != NULL) {
-      source_char_ptr = source_cell->s_cell_value - 1 +
-                        (source_hdr->s_length % STR_CELL_WIDTH);
-      if (source_char_ptr < source_cell->s_cell_value)
-         source_char_ptr += STR_CELL_WIDTH;
-   }
-
-   if (source_cell != NULL &&
-       source_hdr->s_length >= 1 &&
-       character_set[(unsigned char)(*source_char_ptr)]) {
-
-      /* we found a match, create a one character string */
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = 1;
-      get_string_cell(target_cell);
-      target_hdr->s_head = target_hdr->s_tail = target_cell;
-      target_cell->s_next = target_cell->s_prev = NULL;
-      target_cell->s_cell_value[0] = *source_char_ptr;
-
-      /* the first string is assigned to the target */
-
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = target_hdr;
-
-      /* set up to copy the tail of the string */
-
-      source_cell = source_hdr->s_head;
-      source_length = source_hdr->s_length - 1;
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_cell->s_cell_value + STR_CELL_WIDTH;
-
-      /* next create a tail string */
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = source_length;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-      target_char_ptr = target_char_end = NULL;
-
-      /* copy the tail of the source string */
-
-      while (source_length--) {
-
-         if (source_char_ptr == source_char_end) {
-
-            source_cell = source_cell->s_next;
-            source_char_ptr = source_cell->s_cell_value;
-            source_char_end = source_char_ptr + STR_CELL_WIDTH;
+   str_char_set(SETL_SYSTEM spec_val(&argv[1],sp_string_ptr));
 
-         }
+   /* check the last character of the source string */
 
-         if (target_char_ptr == target_char_end) {
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   if (source_hdr->s_length >= 1 &&
+       character_set[(unsigned char)(source_hdr->s_chars[source_hdr->s_length - 1])])
+      split = source_hdr->s_length - 1;
+   else
+      split = source_hdr->s_length;
 
-            get_string_cell(target_cell);
-            if (target_hdr->s_tail != NULL)
-               (target_hdr->s_tail)->s_next = target_cell;
-            target_cell->s_prev = target_hdr->s_tail;
-            target_cell->s_next = NULL;
-            target_hdr->s_tail = target_cell;
-            if (target_hdr->s_head == NULL)
-               target_hdr->s_head = target_cell;
-            target_char_ptr = target_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *target_char_ptr++ = *source_char_ptr++;
-
-      }
-
-      /* push the tail string */
-
-      source.sp_form = ft_string;
-      source.sp_val.sp_string_ptr = target_hdr;
-      push_pstack(&source);
-      target_hdr->s_use_count--;
-
-   }
-
-   /*
-    *  If we didn't match, the left string is null and the right is the
-    *  source.
-    */
-
-   else {
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = 0;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-
-      /* the first string is assigned to the target */
-
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = target_hdr;
-
-      /* push the source string */
-
-      push_pstack(argv);
-
-   }
+   str_split(SETL_SYSTEM argv,split,YES,target);
 
    return;
 
@@ -2641,196 +1454,32 @@ void setl2_rbreak(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length, target_length;    /* and target lengths                */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+string_h_ptr_type source_hdr;          /* source string                     */
 char *p;                               /* temporary looping variable        */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"rbreak",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"rbreak",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* initialize the character set to empty */
-
-   for (p = character_set; p < character_set + 256; *p++ = NO);
-
    /* set to true all the characters in the pattern string */
 
-   source_hdr = argv[1].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
+   str_char_set(SETL_SYSTEM spec_val(&argv[1],sp_string_ptr));
 
-   for (source_cell = source_hdr->s_head;
-        source_cell != NULL;
-        source_cell = source_cell->s_next) {
+   /* scanning from the right, find a character in the break set */
 
-      for (p = source_cell->s_cell_value;
-           p < source_cell->s_cell_value + STR_CELL_WIDTH &&
-              p < source_cell->s_cell_value + source_length;
-           character_set[(unsigned char)(*p++)] = YES);
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   for (p = source_hdr->s_chars + source_hdr->s_length;
+        p > source_hdr->s_chars &&
+           !character_set[(unsigned char)(*(p - 1))];
+        p--);
 
-      source_length -= STR_CELL_WIDTH;
-
-   }
-
-   /* initialize the source string for scanning from right */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-   source_cell = source_hdr->s_tail;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_end = source_cell->s_cell_value - 1;
-      source_char_ptr = source_char_end +
-                        (source_hdr->s_length % STR_CELL_WIDTH);
-      if (source_char_end == source_char_ptr)
-         source_char_ptr += STR_CELL_WIDTH;
-   }
-
-   /* search for a character not in the span set */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_prev;
-         source_char_end = source_cell->s_cell_value - 1;
-         source_char_ptr = source_char_end + STR_CELL_WIDTH;
-
-      }
-
-      if (character_set[(unsigned char)(*source_char_ptr)])
-         break;
-
-      source_char_ptr--;
-
-   }
-
-   /* we decremented the length once too often */
-
-   source_length++;
-   source_char_ptr++;
-   target_length = source_hdr->s_length - source_length;
-   if (source_cell != NULL)
-      source_char_end = source_cell->s_cell_value + STR_CELL_WIDTH;
-
-   /* make a target string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = target_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the source to the end */
-
-   while (target_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* the first string is assigned to the target */
-
-   unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-
-   /* next create a tail string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = source_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* reset the source to the start */
-
-   source_cell = source_hdr->s_head;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_char_ptr + STR_CELL_WIDTH;
-   }
-
-   /* copy the tail of the source string */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* push the tail string */
-
-   source.sp_form = ft_string;
-   source.sp_val.sp_string_ptr = target_hdr;
-   push_pstack(&source);
-   target_hdr->s_use_count--;
+   str_split(SETL_SYSTEM argv,(int32)(p - source_hdr->s_chars),YES,target);
 
    return;
 
@@ -2851,39 +1500,33 @@ void setl2_rlen(
    specifier *target)                  /* return value                      */
 
 {
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length, target_length;    /* source and target lengths         */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+string_h_ptr_type source_hdr;          /* source string                     */
+int32 target_length;                   /* length of the trailing string     */
 
    /* verify the argument types */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"rlen",
             abend_opnd_str(SETL_SYSTEM argv));
 
    /* we convert the length to a C long */
 
-   if (argv[1].sp_form == ft_short) {
+   if (spec_form(&argv[1]) == ft_short) {
 
-      target_length = argv[1].sp_val.sp_short_value;
+      target_length = spec_val(&argv[1],sp_short_value);
       if (target_length <= 0)
          abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"rlen",
                abend_opnd_str(SETL_SYSTEM argv+1));
 
    }
-   else if (argv[1].sp_form == ft_long) {
+   else if (spec_form(&argv[1]) == ft_long) {
 
-      if ((argv[1].sp_val.sp_long_ptr)->i_is_negative)
+      if ((spec_val(&argv[1],sp_long_ptr))->i_is_negative)
          abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"rlen",
                abend_opnd_str(SETL_SYSTEM argv+1));
 
-      target_length = long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+      target_length =
+         long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
 
    }
    else {
@@ -2893,121 +1536,16 @@ char *target_char_ptr, *target_char_end;
 
    }
 
-   /* initialize the source string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-   source_cell = source_hdr->s_head;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_char_ptr + STR_CELL_WIDTH;
-   }
-
    /* adjust the target length */
 
-   if (target_length > source_length) {
-      target_length = source_length;
-      source_length = 0;
-   }
-   else {
-      source_length -= target_length;
-   }
-
-   /* make a target string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = source_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the first length - n characters from the source */
-
-   while (source_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   if (target_length > source_hdr->s_length)
+      target_length = source_hdr->s_length;
 
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* push the first string */
-
-   unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-   push_pstack(target);
-   target_hdr->s_use_count--;
-
-   /* next create a tail string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = target_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the tail of the source string */
-
-   while (target_length--) {
-
-      if (source_char_ptr == source_char_end) {
-
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *source_char_ptr++;
-
-   }
-
-   /* the second string is assigned to the target */
-
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
+   str_split(SETL_SYSTEM argv,
+             source_hdr->s_length - target_length,
+             YES,
+             target);
 
    return;
 
@@ -3027,163 +1565,34 @@ void setl2_rmatch(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length, target_length;    /* source and target lengths         */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+string_h_ptr_type source_hdr, pattern_hdr;
+                                       /* source and pattern strings        */
+int32 split;                           /* length of the leading string      */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"rmatch",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"rmatch",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* set up to scan each string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   target_hdr = argv[1].sp_val.sp_string_ptr;
-
-   if (target_hdr->s_length <= source_hdr->s_length) {
-
-      /* initialize each string */
-
-      source_length = source_hdr->s_length - target_hdr->s_length;
-      source_cell = source_hdr->s_head;
-      while (source_length >= STR_CELL_WIDTH) {
-
-         source_length -= STR_CELL_WIDTH;
-         source_cell = source_cell->s_next;
-
-      }
-      if (source_cell == NULL) {
-         source_char_ptr = source_char_end = NULL;
-      }
-      else {
-         source_char_ptr = source_cell->s_cell_value + source_length;
-         source_char_end = source_cell->s_cell_value + STR_CELL_WIDTH;
-      }
-      source_length = source_hdr->s_length - target_hdr->s_length;
-
-      target_length = target_hdr->s_length;
-      target_cell = target_hdr->s_head;
-      if (target_cell == NULL) {
-         target_char_ptr = target_char_end = NULL;
-      }
-      else {
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-      }
-
-      /* compare the final substrings */
-
-      while (target_length--) {
-
-         if (source_char_ptr == source_char_end) {
-
-            source_cell = source_cell->s_next;
-            source_char_ptr = source_cell->s_cell_value;
-            source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         if (target_char_ptr == target_char_end) {
-
-            target_cell = target_cell->s_next;
-            target_char_ptr = target_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         if (*source_char_ptr != *target_char_ptr)
-            break;
-
-         target_char_ptr++;
-         source_char_ptr++;
-
-      }
-
-      /* if the target matches the source */
-
-      if (target_length < 0) {
-
-         /* the first string is assigned to the target */
-
-         target_hdr->s_use_count++;
-         unmark_specifier(target);
-         target->sp_form = ft_string;
-         target->sp_val.sp_string_ptr = target_hdr;
+   /* if the source ends with the pattern we split it there */
 
-         /* next create a leading string */
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   pattern_hdr = spec_val(&argv[1],sp_string_ptr);
+   split = source_hdr->s_length - pattern_hdr->s_length;
+   if (split >= 0 &&
+       memcmp((void *)(source_hdr->s_chars + split),
+              (void *)(pattern_hdr->s_chars),
+              (size_t)(pattern_hdr->s_length)) == 0) {
 
-         get_string_header(target_hdr);
-         target_hdr->s_use_count = 1;
-         target_hdr->s_hash_code = -1;
-         target_hdr->s_length = source_length;
-         target_hdr->s_head = target_hdr->s_tail = NULL;
-         target_char_ptr = target_char_end = NULL;
+      str_split(SETL_SYSTEM argv,split,YES,target);
 
-         /* reset the source to the beginning */
-
-         source_cell = source_hdr->s_head;
-         if (source_cell == NULL) {
-            source_char_ptr = source_char_end = NULL;
-         }
-         else {
-            source_char_ptr = source_cell->s_cell_value;
-            source_char_end = source_char_ptr + STR_CELL_WIDTH;
-         }
-
-         /* copy the front of the source string */
-
-         while (source_length--) {
-
-            if (source_char_ptr == source_char_end) {
-
-               source_cell = source_cell->s_next;
-               source_char_ptr = source_cell->s_cell_value;
-               source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(target_cell);
-               if (target_hdr->s_tail != NULL)
-                  (target_hdr->s_tail)->s_next = target_cell;
-               target_cell->s_prev = target_hdr->s_tail;
-               target_cell->s_next = NULL;
-               target_hdr->s_tail = target_cell;
-               if (target_hdr->s_head == NULL)
-                  target_hdr->s_head = target_cell;
-               target_char_ptr = target_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *source_char_ptr++;
-
-         }
-
-         /* push the tail string */
-
-         source.sp_form = ft_string;
-         source.sp_val.sp_string_ptr = target_hdr;
-         push_pstack(&source);
-         target_hdr->s_use_count--;
-
-         return;
+      return;
 
-      }
    }
 
    /*
@@ -3191,22 +1600,7 @@ char *target_char_ptr, *target_char_end;
     *  the initial source.
     */
 
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = 0;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* the first string is assigned to the target */
-
-   unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-
-   /* push the source string */
-
-   push_pstack(argv);
+   str_split(SETL_SYSTEM argv,source_hdr->s_length,YES,target);
 
    return;
 
@@ -3227,162 +1621,33 @@ void setl2_rnotany(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length;                   /* source string length              */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
-char *p;                               /* temporary looping variable        */
+string_h_ptr_type source_hdr;          /* source string                     */
+int32 split;                           /* length of the leading string      */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"rnotany",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"rnotany",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* initialize the character set to empty */
-
-   for (p = character_set; p < character_set + 256; *p++ = NO);
-
    /* set to true all the characters in the pattern string */
 
-   source_hdr = argv[1].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-
-   for (source_cell = source_hdr->s_head;
-        source_cell != NULL;
-        source_cell = source_cell->s_next) {
-
-      for (p = source_cell->s_cell_value;
-           p < source_cell->s_cell_value + STR_CELL_WIDTH &&
-              p < source_cell->s_cell_value + source_length;
-           character_set[(unsigned char)(*p++)] = YES);
-
-      source_length -= STR_CELL_WIDTH;
-
-   }
-
-   /* check the first character of the source string */
-
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_cell = source_hdr->s_tail;
-   if (source_cell != NULL) {
-      source_char_ptr = source_cell->s_cell_value - 1 +
-                        (source_hdr->s_length % STR_CELL_WIDTH);
-      if (source_char_ptr < source_cell->s_cell_value)
-         source_char_ptr += STR_CELL_WIDTH;
-   }
-
-   if (source_cell != NULL &&
-       source_hdr->s_length >= 1 &&
-       !character_set[(unsigned char)(*source_char_ptr)]) {
-
-      /* we found a match, create a one character string */
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = 1;
-      get_string_cell(target_cell);
-      target_hdr->s_head = target_hdr->s_tail = target_cell;
-      target_cell->s_next = target_cell->s_prev = NULL;
-      target_cell->s_cell_value[0] = *source_char_ptr;
-
-      /* the first string is assigned to the target */
+   str_char_set(SETL_SYSTEM spec_val(&argv[1],sp_string_ptr));
 
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = target_hdr;
-
-      /* set up to copy the tail of the string */
-
-      source_cell = source_hdr->s_head;
-      source_length = source_hdr->s_length - 1;
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_cell->s_cell_value + STR_CELL_WIDTH;
-
-      /* next create a tail string */
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = source_length;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-      target_char_ptr = target_char_end = NULL;
-
-      /* copy the tail of the source string */
-
-      while (source_length--) {
+   /* check the last character of the source string */
 
-         if (source_char_ptr == source_char_end) {
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   if (source_hdr->s_length >= 1 &&
+       !character_set[(unsigned char)(source_hdr->s_chars[source_hdr->s_length - 1])])
+      split = source_hdr->s_length - 1;
+   else
+      split = source_hdr->s_length;
 
-            source_cell = source_cell->s_next;
-            source_char_ptr = source_cell->s_cell_value;
-            source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         if (target_char_ptr == target_char_end) {
-
-            get_string_cell(target_cell);
-            if (target_hdr->s_tail != NULL)
-               (target_hdr->s_tail)->s_next = target_cell;
-            target_cell->s_prev = target_hdr->s_tail;
-            target_cell->s_next = NULL;
-            target_hdr->s_tail = target_cell;
-            if (target_hdr->s_head == NULL)
-               target_hdr->s_head = target_cell;
-            target_char_ptr = target_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *target_char_ptr++ = *source_char_ptr++;
-
-      }
-
-      /* push the tail string */
-
-      source.sp_form = ft_string;
-      source.sp_val.sp_string_ptr = target_hdr;
-      push_pstack(&source);
-      target_hdr->s_use_count--;
-
-   }
-
-   /*
-    *  If we didn't match, the left string is null and the right is the
-    *  source.
-    */
-
-   else {
-
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = 0;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-
-      /* the first string is assigned to the target */
-
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = target_hdr;
-
-      /* push the source string */
-
-      push_pstack(argv);
-
-   }
+   str_split(SETL_SYSTEM argv,split,YES,target);
 
    return;
 
@@ -3403,352 +1668,344 @@ void setl2_rspan(
    specifier *target)                  /* return value                      */
 
 {
-specifier source;                      /* returned source string            */
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length, target_length;    /* and target lengths                */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+string_h_ptr_type source_hdr;          /* source string                     */
 char *p;                               /* temporary looping variable        */
 
    /* make sure both arguments are strings */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"rspan",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[1].sp_form != ft_string)
+   if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",2,"rspan",
             abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* initialize the character set to empty */
-
-   for (p = character_set; p < character_set + 256; *p++ = NO);
-
    /* set to true all the characters in the pattern string */
 
-   source_hdr = argv[1].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
+   str_char_set(SETL_SYSTEM spec_val(&argv[1],sp_string_ptr));
 
-   for (source_cell = source_hdr->s_head;
-        source_cell != NULL;
-        source_cell = source_cell->s_next) {
+   /* scanning from the right, find a character not in the span set */
 
-      for (p = source_cell->s_cell_value;
-           p < source_cell->s_cell_value + STR_CELL_WIDTH &&
-              p < source_cell->s_cell_value + source_length;
-           character_set[(unsigned char)(*p++)] = YES);
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   for (p = source_hdr->s_chars + source_hdr->s_length;
+        p > source_hdr->s_chars &&
+           character_set[(unsigned char)(*(p - 1))];
+        p--);
 
-      source_length -= STR_CELL_WIDTH;
+   str_split(SETL_SYSTEM argv,(int32)(p - source_hdr->s_chars),YES,target);
 
-   }
+   return;
 
-   /* initialize the source string for scanning from right */
+}
 
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   source_length = source_hdr->s_length;
-   source_cell = source_hdr->s_tail;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_end = source_cell->s_cell_value - 1;
-      source_char_ptr = source_char_end +
-                        (source_hdr->s_length % STR_CELL_WIDTH);
-      if (source_char_end == source_char_ptr)
-         source_char_ptr += STR_CELL_WIDTH;
-   }
+/*\
+ *  \function{setl2\_rpad()}
+ *
+ *  This function is the \verb"rpad" built-in function.  We pad the input
+ *  string with blanks on the right.
+\*/
 
-   /* search for a character not in the span set */
+void setl2_rpad(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (two here)        */
+   specifier *target)                  /* return value                      */
 
-   while (source_length--) {
+{
+string_h_ptr_type source_hdr, target_hdr;
+                                       /* source and target strings         */
+int32 target_length;                   /* target length                     */
 
-      if (source_char_ptr == source_char_end) {
+   /* verify the argument types */
 
-         source_cell = source_cell->s_prev;
-         source_char_end = source_cell->s_cell_value - 1;
-         source_char_ptr = source_char_end + STR_CELL_WIDTH;
+   if (spec_form(&argv[0]) != ft_string)
+      abend(SETL_SYSTEM msg_bad_arg,"string",1,"rpad",
+            abend_opnd_str(SETL_SYSTEM argv));
 
-      }
+   /* we convert the length to a C long */
 
-      if (!character_set[(unsigned char)(*source_char_ptr)])
-         break;
+   if (spec_form(&argv[1]) == ft_short) {
 
-      source_char_ptr--;
+      target_length = spec_val(&argv[1],sp_short_value);
+      if (target_length <= 0)
+         abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"rpad",
+               abend_opnd_str(SETL_SYSTEM argv+1));
 
    }
+   else if (spec_form(&argv[1]) == ft_long) {
 
-   /* we decremented the length once too often */
+      if ((spec_val(&argv[1],sp_long_ptr))->i_is_negative)
+         abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"rpad",
+               abend_opnd_str(SETL_SYSTEM argv+1));
 
-   source_length++;
-   source_char_ptr++;
-   target_length = source_hdr->s_length - source_length;
-   if (source_cell != NULL)
-      source_char_end = source_cell->s_cell_value + STR_CELL_WIDTH;
+      target_length =
+         long_to_short(SETL_SYSTEM spec_val(&argv[1],sp_long_ptr));
 
-   /* make a target string */
+   }
+   else {
 
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = target_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
+      abend(SETL_SYSTEM msg_bad_arg,"integer",2,"rpad",
+            abend_opnd_str(SETL_SYSTEM argv+1));
 
-   /* copy the source to the end */
+   }
 
-   while (target_length--) {
+   /* if the length is already too long return the argument */
 
-      if (source_char_ptr == source_char_end) {
+   source_hdr = spec_val(&argv[0],sp_string_ptr);
+   if (source_hdr->s_length >= target_length) {
 
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
+      source_hdr->s_use_count++;
+      unmark_specifier(target);
+      spec_set_form(target,ft_string);
+      spec_set_val(target,sp_string_ptr,source_hdr);
 
-      }
+      return;
 
-      if (target_char_ptr == target_char_end) {
+   }
 
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
+   /* make a target string */
 
-      }
+   target_hdr = new_string_buffer(SETL_SYSTEM target_length);
 
-      *target_char_ptr++ = *source_char_ptr++;
+   /* copy the source, then pad the target with blanks */
 
-   }
+   memcpy((void *)(target_hdr->s_chars),
+          (void *)(source_hdr->s_chars),
+          (size_t)(source_hdr->s_length));
+   memset((void *)(target_hdr->s_chars + source_hdr->s_length),' ',
+          (size_t)(target_length - source_hdr->s_length));
 
-   /* the first string is assigned to the target */
+   /* set the target and return */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
-
-   /* next create a tail string */
-
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = source_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,target_hdr);
 
-   /* reset the source to the start */
-
-   source_cell = source_hdr->s_head;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_char_ptr + STR_CELL_WIDTH;
-   }
+   return;
 
-   /* copy the tail of the source string */
+}
 
-   while (source_length--) {
+/*\
+ *  \function{free\_builder()}
+ *
+ *  This function is called by \verb"free_specifier()" when the last
+ *  reference to a string builder goes away.
+\*/
 
-      if (source_char_ptr == source_char_end) {
+static void free_builder(
+   struct string_builder_item *builder)/* builder to be released            */
 
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
+{
 
-      }
+   if (builder->sb_chars != NULL)
+      free((void *)(builder->sb_chars));
 
-      if (target_char_ptr == target_char_end) {
+   free((void *)builder);
 
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
+   return;
 
-      }
+}
 
-      *target_char_ptr++ = *source_char_ptr++;
+/*\
+ *  \function{str\_get\_builder()}
+ *
+ *  This function makes sure an argument is a string builder, and
+ *  returns a pointer to it.
+\*/
 
-   }
+PRTYPE struct string_builder_item *str_get_builder(
+   SETL_SYSTEM_PROTO
+   specifier *spec,                    /* argument to be checked            */
+   char *proc_name)                    /* built-in for error messages       */
 
-   /* push the tail string */
+{
 
-   source.sp_form = ft_string;
-   source.sp_val.sp_string_ptr = target_hdr;
-   push_pstack(&source);
-   target_hdr->s_use_count--;
+   if (builder_type == 0 ||
+       spec_form(spec) != ft_opaque ||
+       (spec_val(spec,sp_opaque_ptr)->type & 65535) != builder_type)
+      abend(SETL_SYSTEM msg_bad_arg,"string builder",1,proc_name,
+            abend_opnd_str(SETL_SYSTEM spec));
 
-   return;
+   return (struct string_builder_item *)(spec_val(spec,sp_opaque_ptr));
 
 }
 
-/*\
- *  \function{setl2\_rpad()}
+/*\
+ *  \function{setl2\_string\_builder()}
  *
- *  This function is the \verb"rpad" built-in function.  We pad the input
- *  string with blanks on the right.
+ *  This function is the \verb"string_builder" built-in function.  It
+ *  returns a new, empty string builder.  We register the opaque type the
+ *  first time we're called.
 \*/
 
-void setl2_rpad(
+void setl2_string_builder(
    SETL_SYSTEM_PROTO
    int argc,                           /* number of arguments passed        */
-   specifier *argv,                    /* argument vector (two here)        */
+   specifier *argv,                    /* argument vector (none here)       */
    specifier *target)                  /* return value                      */
 
 {
-string_h_ptr_type source_hdr, target_hdr;
-                                       /* source and target strings         */
-string_c_ptr_type source_cell, target_cell;
-                                       /* source and target string cells    */
-int32 source_length, target_length;    /* and target lengths                */
-char *source_char_ptr, *source_char_end;
-                                       /* source string pointers            */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+struct string_builder_item *builder;   /* new builder                       */
 
-   /* verify the argument types */
+   if (builder_type == 0) {
 
-   if (argv[0].sp_form != ft_string)
-      abend(SETL_SYSTEM msg_bad_arg,"string",1,"rpad",
-            abend_opnd_str(SETL_SYSTEM argv));
+      builder_type = register_type(SETL_SYSTEM "string builder",
+                                   (void *)free_builder);
+      if (builder_type == 0)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-   /* we convert the length to a C long */
+   }
 
-   if (argv[1].sp_form == ft_short) {
+   builder = (struct string_builder_item *)
+             malloc(sizeof(struct string_builder_item));
+   if (builder == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-      target_length = argv[1].sp_val.sp_short_value;
-      if (target_length <= 0)
-         abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"rpad",
-               abend_opnd_str(SETL_SYSTEM argv+1));
+   builder->sb_use_count = 1;
+   builder->sb_type = builder_type;
+   builder->sb_length = 0;
+   builder->sb_capacity = 0;
+   builder->sb_chars = NULL;
 
-   }
-   else if (argv[1].sp_form == ft_long) {
+   unmark_specifier(target);
+   spec_set_form(target,ft_opaque);
+   spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)builder);
 
-      if ((argv[1].sp_val.sp_long_ptr)->i_is_negative)
-         abend(SETL_SYSTEM msg_bad_arg,"non-negative integer",2,"rpad",
-               abend_opnd_str(SETL_SYSTEM argv+1));
+   return;
 
-      target_length = long_to_short(SETL_SYSTEM argv[1].sp_val.sp_long_ptr);
+}
 
-   }
-   else {
+/*\
+ *  \function{setl2\_builder\_add()}
+ *
+ *  This function is the \verb"builder_add" built-in function.  It
+ *  appends each of its remaining arguments to a string builder.
+ *  Strings are appended as they are, and anything else as \verb"str"
+ *  would print it.  The buffer at least doubles when it fills, so
+ *  building a string of length $n$ takes $O(n)$ time.
+\*/
 
-      abend(SETL_SYSTEM msg_bad_arg,"integer",2,"rpad",
-            abend_opnd_str(SETL_SYSTEM argv+1));
+void setl2_builder_add(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector                   */
+   specifier *target)                  /* return value                      */
 
-   }
+{
+struct string_builder_item *builder;   /* builder we append to              */
+specifier spare;                       /* str of a non-string argument      */
+string_h_ptr_type string_hdr;          /* string being appended             */
+int32 new_capacity;                    /* enlarged buffer size              */
+char *new_chars;                       /* enlarged buffer                   */
+int i;                                 /* temporary looping variable        */
 
-   /* if the length is already too long return the argument */
+   builder = str_get_builder(SETL_SYSTEM argv,"builder_add");
 
-   source_hdr = argv[0].sp_val.sp_string_ptr;
-   if (source_hdr->s_length >= target_length) {
+   for (i = 1; i < argc; i++) {
 
-      source_hdr->s_use_count++;
-      unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = source_hdr;
+      spec_set_form(&spare,ft_omega);
 
-      return;
+      if (spec_form(&argv[i]) == ft_string) {
 
-   }
+         string_hdr = spec_val(&argv[i],sp_string_ptr);
 
-   /* make a target string */
+      }
+      else {
 
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = target_length;
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
+         setl2_str(SETL_SYSTEM 1L,argv + i,&spare);
+         string_hdr = spec_val(&spare,sp_string_ptr);
 
-   /* set up the source string */
+      }
 
-   source_length = source_hdr->s_length;
-   source_cell = source_hdr->s_head;
-   if (source_cell == NULL) {
-      source_char_ptr = source_char_end = NULL;
-   }
-   else {
-      source_char_ptr = source_cell->s_cell_value;
-      source_char_end = source_char_ptr + STR_CELL_WIDTH;
-   }
-   target_length -= source_length;
+      /* make room for the new characters */
 
-   /* copy the source */
+      if (builder->sb_length + string_hdr->s_length >
+             builder->sb_capacity) {
 
-   while (source_length--) {
+         new_capacity = builder->sb_capacity * 2;
+         if (new_capacity < builder->sb_length + string_hdr->s_length)
+            new_capacity = builder->sb_length + string_hdr->s_length;
+         if (new_capacity < STR_INLINE_WIDTH * 4)
+            new_capacity = STR_INLINE_WIDTH * 4;
 
-      if (source_char_ptr == source_char_end) {
+         new_chars = (char *)realloc((void *)(builder->sb_chars),
+                                     (size_t)(new_capacity + 1));
+         if (new_chars == NULL)
+            giveup(SETL_SYSTEM msg_malloc_error);
 
-         source_cell = source_cell->s_next;
-         source_char_ptr = source_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
+         builder->sb_chars = new_chars;
+         builder->sb_capacity = new_capacity;
 
       }
 
-      if (target_char_ptr == target_char_end) {
+      memcpy((void *)(builder->sb_chars + builder->sb_length),
+             (void *)(string_hdr->s_chars),
+             (size_t)(string_hdr->s_length));
+      builder->sb_length += string_hdr->s_length;
 
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
+      unmark_specifier(&spare);
 
-      }
+   }
 
-      *target_char_ptr++ = *source_char_ptr++;
+   unmark_specifier(target);
+   spec_set_form(target,ft_omega);
 
-   }
+   return;
 
-   /* pad the target with blanks */
+}
 
-   while (target_length--) {
+/*\
+ *  \function{setl2\_builder\_string()}
+ *
+ *  This function is the \verb"builder_string" built-in function.  It
+ *  returns the characters in a string builder as a string, and leaves
+ *  the builder empty.  Long strings take over the builder's buffer, so
+ *  we don't copy them.  Short strings are copied into the string
+ *  header, and the builder keeps its buffer for reuse.
+\*/
 
-      if (target_char_ptr == target_char_end) {
+void setl2_builder_string(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (only 1 here)     */
+   specifier *target)                  /* return value                      */
 
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
+{
+struct string_builder_item *builder;   /* builder we take the string from   */
+string_h_ptr_type string_hdr;          /* returned string                   */
 
-      }
+   builder = str_get_builder(SETL_SYSTEM argv,"builder_string");
+
+   if (builder->sb_length < STR_INLINE_WIDTH) {
 
-      *target_char_ptr++ = ' ';
+      string_hdr = new_string_buffer(SETL_SYSTEM builder->sb_length);
+      if (builder->sb_length > 0)
+         memcpy((void *)(string_hdr->s_chars),
+                (void *)(builder->sb_chars),
+                (size_t)(builder->sb_length));
 
    }
+   else {
 
-   /* set the target and return */
+      get_string_header(string_hdr);
+      string_hdr->s_use_count = 1;
+      string_hdr->s_hash_code = -1;
+      string_hdr->s_length = builder->sb_length;
+      string_hdr->s_capacity = builder->sb_capacity;
+      string_hdr->s_chars = builder->sb_chars;
+      string_hdr->s_chars[string_hdr->s_length] = '\0';
+
+      builder->sb_capacity = 0;
+      builder->sb_chars = NULL;
+
+   }
+
+   builder->sb_length = 0;
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -97,47 +97,35 @@ void setl2_fexists(
 
 {
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 char file_name[PATH_LENGTH + 1];       /* file name                         */
-char *s, *t;                           /* temporary looping variables       */
 
    /* convert the file name to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"fexists",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    if (string_hdr->s_length > PATH_LENGTH)
       abend(SETL_SYSTEM msg_bad_file_spec,abend_opnd_str(SETL_SYSTEM argv));
 
-   t = file_name;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < file_name + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)file_name,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    /* return True or False as appropriate */
 
    unmark_specifier(target);
    if (os_access(file_name,0) == 0) {
 
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
    }
    else {
 
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
    }
 
@@ -160,34 +148,22 @@ void setl2_system(
 
 {
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 char *command;                         /* system command                    */
-char *s, *t;                           /* temporary looping variables       */
 
    /* convert the command to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"system",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    command = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (command == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = command;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < command + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)command,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    /* execute the command, and free the string */
 
@@ -198,7 +174,7 @@ char *s, *t;                           /* temporary looping variables       */
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 
 }
@@ -218,34 +194,22 @@ void setl2_abort(
 
 {
 string_h_ptr_type string_hdr;          /* string root                       */
-string_c_ptr_type string_cell;         /* string cell pointer               */
 char *message;                         /* error message                     */
-char *s, *t;                           /* temporary looping variables       */
 
    /* convert the message to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"abort",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    message = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (message == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = message;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < message + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)message,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    /* abort, with message */
 
@@ -271,13 +235,13 @@ void setl2_trace(
 #ifdef DEBUG
    /* the argument must be true or false */
 
-   if (argv[0].sp_form != ft_atom ||
-       (argv[0].sp_val.sp_atom_num != spec_true->sp_val.sp_atom_num &&
-        argv[0].sp_val.sp_atom_num != spec_false->sp_val.sp_atom_num))
+   if (spec_form(&argv[0]) != ft_atom ||
+       (spec_val(&argv[0],sp_atom_num) != spec_val(spec_true,sp_atom_num) &&
+        spec_val(&argv[0],sp_atom_num) != spec_val(spec_false,sp_atom_num)))
       abend(SETL_SYSTEM msg_bad_arg,"boolean",1,"trace",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   if (argv[0].sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num) {
+   if (spec_val(&argv[0],sp_atom_num) == spec_val(spec_true,sp_atom_num)) {
 
       fprintf(DEBUG_FILE,"\nTracing ON\n\nSETL2 source file => %s\n\n",
                          X_SOURCE_NAME);
@@ -294,7 +258,7 @@ void setl2_trace(
    /* return om */
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 
 }
@@ -316,11 +280,13 @@ int x;
 
 
 #ifdef DEBUG
-   if ((argv[0].sp_form <ft_proc)&&(argv[0].sp_form !=ft_opaque))
+   if (((spec_form(&argv[0]) <ft_proc)&&(spec_form(&argv[0]) !=ft_opaque)) ||
+       spec_form(&argv[0]) == ft_real)
       fprintf(DEBUG_FILE,"Not a set or map\n");
    else {
-      x=(int)(*((int32 *)(argv[0].sp_val.sp_biggest)))-1;;
-      fprintf(DEBUG_FILE,"Type %d:(%s) Reference count : %d\n",argv[0].sp_form,
+      x=(int)(*((int32 *)spec_ptr(&argv[0])))-1;;
+      fprintf(DEBUG_FILE,"Type %d:(%s) Reference count : %d\n",
+              spec_form(&argv[0]),
          abend_opnd_str(SETL_SYSTEM &argv[0]),x);
    }
 
@@ -328,7 +294,7 @@ int x;
 #endif
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 }
 
@@ -346,16 +312,14 @@ void setl2_opcode_count(
    specifier *target)                  /* return value                      */
 
 {
-int32 short_hi_bits;                   /* high order bits of short          */
 
    /* check whether the size is short */
 
-   if (!(short_hi_bits = OPCODE_COUNT & INT_HIGH_BITS) ||
-       short_hi_bits == INT_HIGH_BITS) {
+   if (is_short_value(OPCODE_COUNT)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = OPCODE_COUNT;
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,OPCODE_COUNT);
 
    }
    else {
@@ -384,36 +348,23 @@ void setl2_getenv(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
+char *s;                               /* temporary looping variable        */
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"getenv",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    /* check whether there is an environment string with this key */
 
@@ -422,46 +373,17 @@ char *s, *t;                           /* temporary looping variables       */
 
    if (s == NULL) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (*s) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string(SETL_SYSTEM s);
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -480,7 +402,6 @@ void setl2_user_time(
    specifier *target)                  /* return value                      */
 
 {
-i_real_ptr_type real_ptr;              /* real pointer                      */
 double real_number;                    /* real value                        */
 	real_number = 0;
 
@@ -497,14 +418,11 @@ struct timeval usage;                   /* structure to fill                 */
 #endif
 #endif
 
-   /* allocate a real */
+   /* set the target */
 
    unmark_specifier(target);
-   i_get_real(real_ptr);
-   target->sp_form = ft_real;
-   target->sp_val.sp_real_ptr = real_ptr;
-   real_ptr->r_use_count = 1;
-   real_ptr->r_value = real_number;
+   spec_set_form(target,ft_real);
+   spec_set_val(target,sp_real_value,real_number);
 
    return;
 
@@ -524,52 +442,35 @@ void setl2_library_file(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
 libunit_ptr_type libunit_ptr;          /* work library unit pointer         */
 libstr_ptr_type textstr_ptr, lenstr_ptr;
                                        /* text stream and length stream     */
 libstr_ptr_type libstr_ptr;            /* unit control stream               */
 unit_control_record unit_control;      /* unit control record               */
 int32 length;                          /* length of current record          */
-tuple_h_ptr_type tuple_root, tuple_work_hdr, new_tuple_hdr;
-                                       /* tuple header pointers             */
+tuple_h_ptr_type tuple_root;           /* tuple of lines                    */
 tuple_c_ptr_type tuple_cell;           /* tuple cell pointer                */
-int tuple_index, tuple_height;         /* used to descend header trees      */
-int32 tuple_length;                    /* current tuple length              */
-int32 expansion_trigger;               /* size which triggers header        */
-                                       /* expansion                         */
 string_h_ptr_type target_hdr;          /* target string                     */
-string_c_ptr_type target_cell;         /* target string cell                */
-int32 i, j, count;
+int32 count;
+
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"library_file",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    /*
     *  Find the unit in the library list.
@@ -579,7 +480,7 @@ int32 i, j, count;
    free(key);
    if (libunit_ptr == NULL) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -592,7 +493,7 @@ int32 i, j, count;
 
    if (unit_control.uc_type != FILE_UNIT) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -603,16 +504,8 @@ int32 i, j, count;
     *  We have to initialize a tuple to hold the lines we will read.
     */
 
-   get_tuple_header(tuple_root);
-   tuple_root->t_use_count = 1;
-   tuple_root->t_hash_code = 0;
-   tuple_root->t_ntype.t_root.t_length = 0;
-   tuple_root->t_ntype.t_root.t_height = 0;
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        tuple_root->t_child[i++].t_cell = NULL);
-   tuple_length = 0;
-   expansion_trigger = TUP_HEADER_SIZE;
+   tuple_root = new_tuple(SETL_SYSTEM_VOID);
+   reserve_tuple(tuple_root,unit_control.uc_line_count);
 
    /* loop through the lines of the file */
 
@@ -622,122 +515,22 @@ int32 i, j, count;
 
       /* make a target string */
 
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = length;
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-
-      /* copy the argument to the string */
+      target_hdr = new_string_buffer(SETL_SYSTEM length);
 
-      while (length > 0) {
+      /* copy the line to the string */
 
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
+      if (length > 0)
+         read_libstr(SETL_SYSTEM textstr_ptr, target_hdr->s_chars, length);
 
-         j = min(length, STR_CELL_WIDTH);
-         read_libstr(SETL_SYSTEM textstr_ptr, target_cell->s_cell_value, j);
-         length -= j;
+      /* append the string to the return tuple */
 
-      }
-
-      /*
-       *  Now we have to insert the string we just created into the
-       *  return tuple.
-       */
-
-      /* expand the tuple tree if necessary */
-
-      if (tuple_length >= expansion_trigger) {
-
-         tuple_work_hdr = tuple_root;
-
-         get_tuple_header(tuple_root);
-
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code =
-            tuple_work_hdr->t_hash_code;
-         tuple_root->t_ntype.t_root.t_length =
-            tuple_work_hdr->t_ntype.t_root.t_length;
-         tuple_root->t_ntype.t_root.t_height =
-            tuple_work_hdr->t_ntype.t_root.t_height + 1;
-
-         for (i = 1;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_header = NULL);
-
-         tuple_root->t_child[0].t_header = tuple_work_hdr;
-
-         tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-         tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-         expansion_trigger *= TUP_HEADER_SIZE;
-
-      }
-
-      tuple_root->t_ntype.t_root.t_length++;
-
-      /* descend the tree to a leaf */
-
-      tuple_work_hdr = tuple_root;
-      for (tuple_height = tuple_work_hdr->t_ntype.t_root.t_height;
-           tuple_height;
-           tuple_height--) {
-
-         /* extract the element's index at this level */
-
-         tuple_index = (tuple_length >>
-                              (tuple_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (tuple_work_hdr->t_child[tuple_index].t_header == NULL) {
-
-            get_tuple_header(new_tuple_hdr);
-            new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-            new_tuple_hdr->t_ntype.t_intern.t_child_index = tuple_index;
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_tuple_hdr->t_child[i++].t_cell = NULL);
-            tuple_work_hdr->t_child[tuple_index].t_header =
-                  new_tuple_hdr;
-            tuple_work_hdr = new_tuple_hdr;
-
-         }
-         else {
-
-            tuple_work_hdr =
-               tuple_work_hdr->t_child[tuple_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, tuple_work_hdr points to the lowest level header
-       *  record.  We insert the new element.
-       */
-
-      tuple_index = tuple_length & TUP_SHIFT_MASK;
-      get_tuple_cell(tuple_cell);
-      tuple_cell->t_spec.sp_form = ft_string;
-      tuple_cell->t_spec.sp_val.sp_string_ptr = target_hdr;
+      tuple_cell = tuple_root->t_cells + tuple_root->t_length++;
+      spec_set_form(&tuple_cell->t_spec,ft_string);
+      spec_set_val(&tuple_cell->t_spec,sp_string_ptr,target_hdr);
       spec_hash_code(tuple_cell->t_hash_code,&(tuple_cell->t_spec));
       tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
-      tuple_work_hdr->t_child[tuple_index].t_cell = tuple_cell;
-
-      /* increment the tuple size */
-
-      tuple_length++;
 
    }
-   tuple_root->t_ntype.t_root.t_length = tuple_length;
 
    /* we're done with the library */
 
@@ -748,8 +541,8 @@ int32 i, j, count;
    /* set the return value to the tuple we just created */
 
    unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = tuple_root;
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,tuple_root);
 
    return;
 
@@ -769,37 +562,25 @@ void setl2_library_package(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
 unittab_ptr_type unittab_ptr;          /* loaded unit                       */
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg, "string", 1, "library_package",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    unittab_ptr = load_unit(SETL_SYSTEM key, NULL, NULL);
    free(key);
@@ -812,7 +593,7 @@ unittab_ptr_type unittab_ptr;          /* loaded unit                       */
        ((unittab_ptr->ut_type != PACKAGE_UNIT)&&
        (unittab_ptr->ut_type != NATIVE_UNIT))) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -821,8 +602,8 @@ unittab_ptr_type unittab_ptr;          /* loaded unit                       */
     */
 
    unmark_specifier(target);
-   target->sp_form = ft_map;
-   target->sp_val.sp_map_ptr = unittab_ptr->ut_symbol_map;
+   spec_set_form(target,ft_map);
+   spec_set_val(target,sp_map_ptr,unittab_ptr->ut_symbol_map);
    mark_specifier(target);
 
    return;
@@ -844,11 +625,9 @@ void setl2_eval(
 {
 #ifdef DYNAMIC_COMP
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
 unittab_ptr_type unit_ptr;  
 struct instruction_item *pc_old;      
 char *fragment;                        /* fragment to compile               */
@@ -858,28 +637,18 @@ global_ptr_type temp_global_head;
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg,"string",1,"eval",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
 
    key = (char *)malloc((size_t)(string_hdr->s_length + 1));
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + string_hdr->s_length &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),
+          (size_t)(string_hdr->s_length + 1));
 
    
    fragment = (char *)malloc((size_t)(strlen(key)+200));
@@ -899,7 +668,7 @@ global_ptr_type temp_global_head;
    free(fragment);
    if (compile_result!=SUCCESS_EXIT) {
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 
@@ -928,8 +697,8 @@ global_ptr_type temp_global_head;
    /* Return 0, meaning eval() succeded ... */
 
    unmark_specifier(target);
-   target->sp_form = ft_short;
-   target->sp_val.sp_short_value = 0;
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,0);
 
 #endif 
 }
@@ -946,21 +715,18 @@ void setl2_javascript(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
+char *s;                               /* temporary looping variable        */
 unittab_ptr_type unittab_ptr;          /* loaded unit                       */
 int ljs;			       /* Total length of the command       */
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg, "string", 1, "javascript",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
  
    ljs=string_hdr->s_length +1;
 
@@ -968,19 +734,7 @@ int ljs;			       /* Total length of the command       */
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + ljs-1 &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),(size_t)ljs);
 
 #ifdef PLUGIN
    javascript_buffer=NULL;
@@ -989,7 +743,7 @@ int ljs;			       /* Total length of the command       */
    if (s==NULL) {
         free(key);
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 #else 
@@ -999,43 +753,14 @@ int ljs;			       /* Total length of the command       */
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (*s) {
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string(SETL_SYSTEM s);
 #ifdef PLUGIN
   if (javascript_buffer!=NULL) free(javascript_buffer);
 #endif 
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -1049,7 +774,6 @@ void setl2_wait(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
@@ -1059,17 +783,17 @@ int ljs;			       /* Total length of the command       */
 
 /* wait is only valid for >0 */
 
-   if (argv[0].sp_form != ft_short ||
-       argv[0].sp_val.sp_short_value < 1 ||
-       argv[0].sp_val.sp_short_value > 256)
+   if (spec_form(&argv[0]) != ft_short ||
+       spec_val(&argv[0],sp_short_value) < 1 ||
+       spec_val(&argv[0],sp_short_value) > 256)
       abend(SETL_SYSTEM msg_bad_arg,"integer",1,"wait",
             abend_opnd_str(SETL_SYSTEM argv));
 #ifdef PLUGIN
-	WAIT_FLAG=-argv[0].sp_val.sp_short_value;
+	WAIT_FLAG=-spec_val(&argv[0],sp_short_value);
 #endif
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 
 }
@@ -1082,7 +806,6 @@ void setl2_pass_symtab(
 
 {
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
@@ -1090,7 +813,7 @@ char *s, *t;                           /* temporary looping variables       */
 unittab_ptr_type unittab_ptr;          /* loaded unit                       */
 
 
-   if (argv[0].sp_form != ft_set)
+   if (spec_form(&argv[0]) != ft_set)
       abend(SETL_SYSTEM msg_bad_arg,"set",1,"pass_symtab",
             abend_opnd_str(SETL_SYSTEM argv));
 
@@ -1100,8 +823,8 @@ unittab_ptr_type unittab_ptr;          /* loaded unit                       */
 
 
    unmark_specifier(&SYMBOL_MAP);
-   SYMBOL_MAP.sp_form = ft_map;
-   SYMBOL_MAP.sp_val.sp_map_ptr = argv[0].sp_val.sp_map_ptr;
+   spec_set_form(&SYMBOL_MAP,ft_map);
+   spec_set_val(&SYMBOL_MAP,sp_map_ptr,spec_val(&argv[0],sp_map_ptr));
    mark_specifier(&SYMBOL_MAP);
 
    return;
@@ -1120,21 +843,18 @@ int javascript_buffer_len = 0;
 #endif
 
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
 char *key;                             /* system key                        */
-char *s, *t;                           /* temporary looping variables       */
+char *s;                               /* temporary looping variable        */
 unittab_ptr_type unittab_ptr;          /* loaded unit                       */
 int ljs;			       /* Total length of the command       */
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg, "string", 1, "geturl",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
  
    ljs=string_hdr->s_length +1;
 
@@ -1142,19 +862,7 @@ int ljs;			       /* Total length of the command       */
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + ljs-1 &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),(size_t)ljs);
 
 
 #ifdef PLUGIN
@@ -1164,7 +872,7 @@ int ljs;			       /* Total length of the command       */
    if (s==NULL) {
    	  free(key);
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 #else
@@ -1174,44 +882,16 @@ int ljs;			       /* Total length of the command       */
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (--javascript_buffer_len>0) {
-
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string_chars(SETL_SYSTEM s,
+                                 javascript_buffer_len > 0 ?
+                                    javascript_buffer_len - 1 : 0);
 #ifdef PLUGIN
   if (javascript_buffer!=NULL) free(javascript_buffer);
 #endif
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -1231,22 +911,19 @@ int javascript_buffer_len = 0;
 #endif
 
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
-char *string_char_ptr, *string_char_end;
-                                       /* source string pointers            */
 char *key;                             /* system key                        */
 char *postdata;
-char *s, *t;                           /* temporary looping variables       */
+char *s;                               /* temporary looping variable        */
 unittab_ptr_type unittab_ptr;          /* loaded unit                       */
 int ljs;			       /* Total length of the command       */
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg, "string", 1, "posturl",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
  
    ljs=string_hdr->s_length +1;
 
@@ -1254,25 +931,13 @@ int ljs;			       /* Total length of the command       */
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + ljs-1 &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),(size_t)ljs);
    
-    if (argv[1].sp_form != ft_string)
+    if (spec_form(&argv[1]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg, "string", 2, "posturl",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[1].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[1],sp_string_ptr);
  
    ljs=string_hdr->s_length +1;
 
@@ -1280,19 +945,8 @@ int ljs;			       /* Total length of the command       */
    if (postdata == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = postdata;
-
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
+   memcpy((void *)postdata,(void *)(string_hdr->s_chars),(size_t)ljs);
 
-      for (s = string_cell->s_cell_value;
-           t < postdata + ljs-1 &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
 
 #ifdef PLUGIN
    javascript_buffer=NULL;
@@ -1302,7 +956,7 @@ int ljs;			       /* Total length of the command       */
    	  free(key);
    	  free(postdata);
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
    }
 #else
@@ -1313,44 +967,16 @@ int ljs;			       /* Total length of the command       */
 
    /* first we make a SETL2 string out of the C string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   string_hdr->s_length = 0;
-   string_hdr->s_head = string_hdr->s_tail = NULL;
-   string_char_ptr = string_char_end = NULL;
-
-   /* copy the source string */
-
-   while (--javascript_buffer_len>0) {
-
-
-      if (string_char_ptr == string_char_end) {
-
-         get_string_cell(string_cell);
-         if (string_hdr->s_tail != NULL)
-            (string_hdr->s_tail)->s_next = string_cell;
-         string_cell->s_prev = string_hdr->s_tail;
-         string_cell->s_next = NULL;
-         string_hdr->s_tail = string_cell;
-         if (string_hdr->s_head == NULL)
-            string_hdr->s_head = string_cell;
-         string_char_ptr = string_cell->s_cell_value;
-         string_char_end = string_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *string_char_ptr++ = *s++;
-      string_hdr->s_length++;
-
-   }
+   string_hdr = new_string_chars(SETL_SYSTEM s,
+                                 javascript_buffer_len > 0 ?
+                                    javascript_buffer_len - 1 : 0);
 #ifdef PLUGIN
   if (javascript_buffer!=NULL) free(javascript_buffer);
 #endif
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -1374,7 +1000,6 @@ int cLen;
 struct setl_ax * A; 
 
 string_h_ptr_type string_hdr;          /* root of string value              */
-string_c_ptr_type string_cell;         /* string cell                       */
 char *string_char_ptr, *string_char_end;
                                        /* source string pointers            */
 char *key;                             /* system key                        */
@@ -1384,11 +1009,11 @@ int ljs;			       /* Total length of the command       */
 
    /* convert the key to a C character string */
 
-   if (argv[0].sp_form != ft_string)
+   if (spec_form(&argv[0]) != ft_string)
       abend(SETL_SYSTEM msg_bad_arg, "string", 1, "createactivexobject",
             abend_opnd_str(SETL_SYSTEM argv));
 
-   string_hdr = argv[0].sp_val.sp_string_ptr;
+   string_hdr = spec_val(&argv[0],sp_string_ptr);
  
    ljs=string_hdr->s_length +1;
 
@@ -1396,19 +1021,7 @@ int ljs;			       /* Total length of the command       */
    if (key == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   t = key;
-
-   for (string_cell = string_hdr->s_head;
-        string_cell != NULL;
-        string_cell = string_cell->s_next) {
-
-      for (s = string_cell->s_cell_value;
-           t < key + ljs-1 &&
-              s < string_cell->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-   *t = '\0';
+   memcpy((void *)key,(void *)(string_hdr->s_chars),(size_t)ljs);
 
 
 
@@ -1419,7 +1032,7 @@ int ljs;			       /* Total length of the command       */
 
     if (CLSIDFromProgID(wName,&clsid)!=S_OK)  {
 		  unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
       return;
 	}
 
@@ -1438,8 +1051,8 @@ int ljs;			       /* Total length of the command       */
 		A->lpDispatch=lpDispatch;
    
 		unmark_specifier(target);
-		target->sp_form = ft_opaque;
-		target->sp_val.sp_opaque_ptr = (opaque_item_ptr_type)A;
+		spec_set_form(target,ft_opaque);
+		spec_set_val(target,sp_opaque_ptr,(opaque_item_ptr_type)A);
 		return;
 	}
 
@@ -1447,7 +1060,7 @@ int ljs;			       /* Total length of the command       */
 
 
    unmark_specifier(target);
-   target->sp_form = ft_omega;
+   spec_set_form(target,ft_omega);
    return;
 
 
@@ -444,8 +444,9 @@ int unlink(const char *);                        /* delete file
  *  the macro for IEEE, but it should be easy to modify for others if
  *  that proves necessary.
  *
- *  Note:  The following depend on long's being 32 bits.  That's the case
- *  on most machines these days, but it's something to beware of.
+ *  Note:  The following look at the high-order half of the double as an
+ *  unsigned int, which must be 32 bits.  We can't use \verb"int32" here,
+ *  since that is a long, and longs are 64 bits on most 64-bit machines.
 \*/
 #if WORDS_BIGENDIAN
 #define IEEE_BEND 1
@@ -459,14 +460,42 @@ int unlink(const char *);                        /* delete file
 
 #if INFNAN
 #if IEEE_BEND
-#define NANorINF(X) ((*((int32 *)&X) & 0x7ff00000) == 0x7ff00000)
+#define NANorINF(X) ((*((unsigned int *)&X) & 0x7ff00000) == 0x7ff00000)
 #endif
 
 #if IEEE_LEND
-#define NANorINF(X) ((*(((int32 *)&X) + 1) & 0x7ff00000) == 0x7ff00000)
+#define NANorINF(X) \
+   ((*(((unsigned int *)&X) + 1) & 0x7ff00000) == 0x7ff00000)
 #endif
 #endif
 
+/*\
+ *  \function{Threaded Code}
+ *
+ *  With Gnu C we can use the labels-as-values extension to thread the
+ *  pseudo code:  the loader stores the address of the interpreter case
+ *  for each instruction in the instruction itself, and the interpreter
+ *  jumps there directly rather than going through the big switch.
+ *  Define \verb"NO_THREADED_CODE" to get the portable switch.
+\*/
+
+#if defined(__GNUC__) && !defined(NO_THREADED_CODE) && !defined(SHORT_FUNCS)
+#define THREADED_CODE 1
+#endif
+
+/*\
+ *  \function{Processes}
+ *
+ *  Process classes run as green threads inside the interpreter, and
+ *  processes blocked on input or timers wait in the reactor.  Define
+ *  \verb"NO_PROCESSES" to leave them out, and with them the
+ *  \verb"process" keyword.
+\*/
+
+#if !defined(NO_PROCESSES)
+#define PROCESSES 1
+#endif
+
 /*\
  *  \function{Global Declarations}
  *
@@ -39,6 +39,11 @@
  *  \packagebody{Tuples}
 \*/
 
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
+#include <string.h>                    /* memcpy and memmove                */
+
 /* SETL2 system header files */
 
 #include "system.h"                    /* SETL2 system constants            */
@@ -52,2349 +57,1464 @@
 #include "pcode.h"                     /* pseudo code                       */
 #include "execute.h"                   /* core interpreter                  */
 
-/* performance tuning constants */
-
-#define TUPLE_HEADER_BLOCK_SIZE 100    /* tuple header block size           */
-#define TUPLE_CELL_BLOCK_SIZE   400    /* tuple cell block size             */
-
 /*\
- *  \function{alloc\_tuple\_headers()}
+ *  \function{grow\_tuple()}
  *
- *  This function allocates a block of tuple headers and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste header items to pointers to header items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the header node.
- *  It will work provided a header item is larger than a pointer, which
- *  is the case.
+ *  This function makes room for at least a given number of elements in a
+ *  tuple, keeping those it has.  We at least double the capacity each
+ *  time, so building a tuple an element at a time takes linear time.
+ *  Callers should use the \verb"reserve_tuple()" macro, which only calls
+ *  us if the tuple is too small.  We keep every cell we had room for, so
+ *  callers may fill cells before they set the length.
 \*/
 
-void alloc_tuple_headers(
-   SETL_SYSTEM_PROTO_VOID)
+void grow_tuple(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* tuple to be enlarged              */
+   int32 length)                       /* elements we need room for         */
 
 {
-tuple_h_ptr_type new_block;            /* first header in allocated block   */
+tuple_c_ptr_type new_cells;            /* enlarged cell block               */
+int32 new_capacity;                    /* capacity of new_cells             */
+void *new_packed;                      /* enlarged packed block             */
 
-   /* allocate a new block */
+   new_capacity = tuple_root->t_capacity * 2;
+   if (new_capacity < length)
+      new_capacity = length;
 
-   new_block = (tuple_h_ptr_type)malloc((size_t)
-         (TUPLE_HEADER_BLOCK_SIZE * sizeof(struct tuple_h_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
+   /* packed tuples always have a separate block */
+
+   if (tuple_root->t_packing != TUP_CELLS) {
 
-   /* link items on the free list */
+      new_packed = realloc((void *)(tuple_root->t_packed.t_shorts),
+            (size_t)(new_capacity * packed_size(tuple_root)));
+      if (new_packed == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-   for (TUPLE_H_NEXT_FREE = new_block;
-        TUPLE_H_NEXT_FREE < new_block + TUPLE_HEADER_BLOCK_SIZE - 1;
-        TUPLE_H_NEXT_FREE++) {
+      tuple_root->t_packed.t_shorts = (int32 *)new_packed;
+      tuple_root->t_capacity = new_capacity;
 
-      *((tuple_h_ptr_type *)TUPLE_H_NEXT_FREE) = TUPLE_H_NEXT_FREE + 1;
+      return;
+
+   }
+
+   if (tuple_root->t_cells == tuple_root->t_inline) {
+
+      new_cells = (tuple_c_ptr_type)malloc((size_t)
+            (new_capacity * sizeof(struct tuple_c_item)));
+      if (new_cells == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
+      memcpy((void *)new_cells,(void *)(tuple_root->t_inline),
+             (size_t)(sizeof(tuple_root->t_inline)));
 
    }
+   else {
 
-   *((tuple_h_ptr_type *)TUPLE_H_NEXT_FREE) = NULL;
+      new_cells = (tuple_c_ptr_type)realloc((void *)(tuple_root->t_cells),
+            (size_t)(new_capacity * sizeof(struct tuple_c_item)));
+      if (new_cells == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-   /* set next free node to new block */
+   }
 
-   TUPLE_H_NEXT_FREE = new_block;
+   tuple_root->t_cells = new_cells;
+   tuple_root->t_capacity = new_capacity;
 
    return;
 
 }
 
 /*\
- *  \function{alloc\_tuple\_cells()}
+ *  \function{free\_tuple()}
  *
- *  This function allocates a block of tuple cells and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste cell items to pointers to cell items in order to form the free
- *  list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently, while
- *  at the same time avoiding an extra pointer on the cell node.  It
- *  will work provided a cell item is larger than a pointer, which is
- *  the case.
+ *  This function releases a tuple, along with our hold on each of its
+ *  elements.  Unless it is packed the elements are released from the
+ *  release stack, so nested tuples do not recurse.
 \*/
 
-void alloc_tuple_cells(
-   SETL_SYSTEM_PROTO_VOID)
-{
-tuple_c_ptr_type new_block;            /* first cell in allocated block     */
+void free_tuple(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root)        /* tuple to be released              */
 
-   /* allocate a new block */
+{
 
-   new_block = (tuple_c_ptr_type)malloc((size_t)
-         (TUPLE_CELL_BLOCK_SIZE * sizeof(struct tuple_c_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
+   /* packed elements hold nothing */
 
-   /* link items on the free list */
+   if (is_packed(tuple_root)) {
 
-   for (TUPLE_C_NEXT_FREE = new_block;
-        TUPLE_C_NEXT_FREE < new_block + TUPLE_CELL_BLOCK_SIZE - 1;
-        TUPLE_C_NEXT_FREE++) {
+      free((void *)(tuple_root->t_packed.t_shorts));
+      free_tuple_header(tuple_root);
 
-      *((tuple_c_ptr_type *)TUPLE_C_NEXT_FREE) = TUPLE_C_NEXT_FREE + 1;
+      return;
 
    }
 
-   *((tuple_c_ptr_type *)TUPLE_C_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   TUPLE_C_NEXT_FREE = new_block;
+   free_later(SETL_SYSTEM ft_tuple,(void *)tuple_root);
 
    return;
 
 }
 
 /*\
- *  \function{new\_tuple()}
+ *  \function{release\_tuple()}
  *
- *  This function returns a new tuple structure.
+ *  This function is called from the release stack to release the
+ *  elements of a tuple which nothing else uses, at most \verb"*budget"
+ *  of them.  We work from the end, shortening the tuple, so we can stop
+ *  anywhere.  Blocks and chunks somebody else holds are dropped whole.  It returns
+ *  \verb"YES" once the tuple itself is freed.
 \*/
 
-tuple_h_ptr_type new_tuple(
-   SETL_SYSTEM_PROTO_VOID)
+int release_tuple(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* tuple to be released              */
+   int32 *budget)                      /* elements we may release           */
+
 {
-tuple_h_ptr_type tuple_root;           /* header pointer                    */
-int i;                                 /* temporary looping variable        */
+tuple_b_ptr_type tuple_block;          /* last block of chunked tuple       */
+tuple_k_ptr_type tuple_chunk;          /* last chunk of chunked tuple       */
 
-   /* allocate a new root header node */
+   if (tuple_root->t_packing == TUP_CHUNKS) {
 
-   get_tuple_header(tuple_root);
+      while (tuple_root->t_length > 0 && *budget > 0) {
 
-   tuple_root->t_use_count = 1;
-   tuple_root->t_hash_code = 0;
-   tuple_root->t_ntype.t_root.t_length = 0;
-   tuple_root->t_ntype.t_root.t_height = 0;
+         tuple_block = tuple_root->t_packed.t_blocks[
+               (tuple_root->t_length - 1) >> TUP_BLOCK_LOG];
+         tuple_chunk = tuple_chunk_at(tuple_root,tuple_root->t_length - 1);
+         (*budget)--;
 
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        tuple_root->t_child[i++].t_header = NULL);
+         if (tuple_block->b_use_count > 1) {
 
-   return tuple_root;
-}
+            tuple_block->b_use_count--;
+            tuple_root->t_length =
+               ((tuple_root->t_length - 1) >> TUP_BLOCK_LOG) <<
+                  TUP_BLOCK_LOG;
 
+            continue;
 
-/*\
- *  \function{copy\_tuple()}
- *
- *  This function copies an entire tuple structure.
-\*/
+         }
 
-tuple_h_ptr_type copy_tuple(
-   SETL_SYSTEM_PROTO
-   tuple_h_ptr_type source_root)       /* tuple to be copied                */
+         if (tuple_chunk->k_use_count > 1) {
 
-{
-tuple_h_ptr_type source_work_hdr;      /* used to loop over source internal */
-                                       /* nodes                             */
-int source_height, source_index;       /* current height and index          */
-tuple_c_ptr_type source_cell;          /* cell pointer                      */
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* header pointers                   */
-tuple_c_ptr_type target_cell;          /* cell pointer                      */
-tuple_h_ptr_type new_hdr;              /* created header node               */
-int i;                                 /* temporary looping variable        */
-#ifdef DEBUG
-#ifdef HAVE_GETRUSAGE
-struct timeval start;                   /* structure to fill                 */
-struct timeval stop;                    /* structure to fill                 */
-struct timezone tz;
-#endif
+            tuple_chunk->k_use_count--;
+            tuple_root->t_length =
+               ((tuple_root->t_length - 1) >> TUP_CHUNK_LOG) <<
+                  TUP_CHUNK_LOG;
 
-   if (PROF_DEBUG) {
-#ifdef HAVE_GETRUSAGE
-   gettimeofday(&start,&tz);
-#endif
-      if (profi!=NULL) profi->copies++;
-      copy_operations[OPCODE_EXECUTED]++;
-   }
-   if ((TRACING_ON)&&(TRACE_COPIES))
-      fprintf(DEBUG_FILE,"*COPY_TUPLE*\n");
-#endif
+         }
+         else {
 
-   /* allocate a new root header node */
+            tuple_root->t_length--;
+            unmark_specifier(&(tuple_chunk->k_cells[
+                  tuple_root->t_length & (TUP_CHUNK_CELLS - 1)].t_spec));
+            if ((tuple_root->t_length & (TUP_CHUNK_CELLS - 1)) == 0)
+               free((void *)tuple_chunk);
 
-   get_tuple_header(target_root);
-   target_root->t_use_count = 1;
-   target_root->t_hash_code =
-         source_root->t_hash_code;
-   target_root->t_ntype.t_root.t_length =
-         source_root->t_ntype.t_root.t_length;
-   target_root->t_ntype.t_root.t_height =
-         source_root->t_ntype.t_root.t_height;
+         }
 
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        target_root->t_child[i++].t_header = NULL);
+         if ((tuple_root->t_length & (TUP_BLOCK_CELLS - 1)) == 0)
+            free((void *)tuple_block);
 
-   /* we start iterating from the root, at the left of the header table */
+      }
 
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_work_hdr = source_root;
-   target_work_hdr = target_root;
-   source_index = 0;
+      if (tuple_root->t_length > 0)
+         return NO;
 
-   /* copy nodes until we finish the tree */
+      free((void *)(tuple_root->t_packed.t_blocks));
+      free_tuple_header(tuple_root);
 
-   for (;;) {
+      return YES;
 
-      /* if we're at a leaf, copy all the tuple elements */
+   }
 
-      if (!source_height) {
+   while (tuple_root->t_length > 0 && *budget > 0) {
 
-         for (source_index = 0;
-              source_index < TUP_HEADER_SIZE;
-              source_index++) {
+      tuple_root->t_length--;
+      unmark_specifier(&(tuple_root->t_cells[tuple_root->t_length].t_spec));
+      (*budget)--;
 
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            if (source_cell != NULL) {
+   }
 
-               get_tuple_cell(target_cell);
-               target_cell->t_spec.sp_form = source_cell->t_spec.sp_form;
-               target_cell->t_spec.sp_val.sp_biggest =
-                     source_cell->t_spec.sp_val.sp_biggest;
-               target_cell->t_hash_code = source_cell->t_hash_code;
-               mark_specifier(&(target_cell->t_spec));
-               target_work_hdr->t_child[source_index].t_cell = target_cell;
+   if (tuple_root->t_length > 0)
+      return NO;
 
-            }
-            else {
+   if (tuple_root->t_cells != tuple_root->t_inline)
+      free((void *)(tuple_root->t_cells));
 
-               target_work_hdr->t_child[source_index].t_cell = NULL;
+   free_tuple_header(tuple_root);
 
-            }
-         }
-      }
+   return YES;
 
-      /* if we've finished an internal node, move up */
+}
 
-      if (source_index >= TUP_HEADER_SIZE) {
+/*\
+ *  \function{new\_tuple()}
+ *
+ *  This function returns a new tuple structure.
+\*/
 
-         /* if we've finished the root, quit */
+tuple_h_ptr_type new_tuple(
+   SETL_SYSTEM_PROTO_VOID)
+{
+tuple_h_ptr_type tuple_root;           /* header pointer                    */
 
-         if (source_work_hdr == source_root)
-            break;
+   /* allocate a new root header node */
 
-         source_height++;
-         source_index = source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-         source_work_hdr = source_work_hdr->t_ntype.t_intern.t_parent;
-         target_work_hdr = target_work_hdr->t_ntype.t_intern.t_parent;
+   get_tuple_header(tuple_root);
 
-         continue;
+   tuple_root->t_use_count = 1;
+   tuple_root->t_hash_code = 0;
+   tuple_root->t_length = 0;
+   tuple_root->t_capacity = TUP_INLINE_CELLS;
+   tuple_root->t_packing = TUP_CELLS;
+   tuple_root->t_cells = tuple_root->t_inline;
+   tuple_root->t_packed.t_shorts = NULL;
 
-      }
+   return tuple_root;
+}
 
-      /* if we can't move down, continue */
+/*\
+ *  \function{start\_packed()}
+ *
+ *  This function turns a new, empty tuple into a packed one with room
+ *  for a given number of elements.
+\*/
 
-      if (source_work_hdr->t_child[source_index].t_header == NULL) {
+void start_packed(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* new tuple                         */
+   int packing,                        /* packed element form               */
+   int32 capacity)                     /* elements we need room for         */
 
-         target_work_hdr->t_child[source_index].t_header = NULL;
-         source_index++;
+{
 
-         continue;
+   if (capacity < TUP_INLINE_CELLS)
+      capacity = TUP_INLINE_CELLS;
 
-      }
+   tuple_root->t_packing = packing;
+   tuple_root->t_cells = NULL;
+   tuple_root->t_packed.t_shorts = (int32 *)malloc((size_t)
+         (capacity * packed_size(tuple_root)));
+   if (tuple_root->t_packed.t_shorts == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   tuple_root->t_capacity = capacity;
 
-      /* we can move down, so do so */
+   return;
 
-      source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-      get_tuple_header(new_hdr);
-      target_work_hdr->t_child[source_index].t_header = new_hdr;
-      new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-      new_hdr->t_ntype.t_intern.t_child_index = source_index;
+}
 
-      for (i = 0;
-           i < TUP_HEADER_SIZE;
-           new_hdr->t_child[i++].t_header = NULL);
+/*\
+ *  \function{uniform\_packing()}
+ *
+ *  This function finds the packed form which will hold a run of
+ *  specifiers, or \verb"TUP_CELLS" if they are not all short integers or
+ *  all reals.
+\*/
 
-      target_work_hdr = new_hdr;
+int uniform_packing(
+   specifier *spec,                    /* first specifier                   */
+   int32 stride,                       /* distance between specifiers       */
+   int32 count)                        /* number of specifiers              */
 
-      source_index = 0;
-      source_height--;
+{
+int form;                              /* form of every specifier           */
 
-   }
+   if (count == 0)
+      return TUP_CELLS;
 
-   /* that's it, return the root */
+   form = spec_form(spec);
+   if (form != ft_short && form != ft_real)
+      return TUP_CELLS;
 
-#ifdef DEBUG
-#ifdef HAVE_GETRUSAGE
-   if (profi!=NULL) {
-      gettimeofday(&stop,&tz);
-      profi->timec.tv_sec +=(stop.tv_sec-start.tv_sec);
-      profi->timec.tv_usec+=(stop.tv_usec-start.tv_usec);
-      while (profi->timec.tv_usec<0) {
-         profi->timec.tv_sec--;
-         profi->timec.tv_usec+=1000000;
-      }
-      while (profi->timec.tv_usec>=1000000) {
-         profi->timec.tv_sec++;
-         profi->timec.tv_usec-=1000000;
-      }
-   } 
-#endif
-#endif
-   return target_root;
+   while (--count > 0) {
+
+      spec = (specifier *)((char *)spec + stride);
+      if (spec_form(spec) != form)
+         return TUP_CELLS;
+
+   }
+
+   return (form == ft_short ? TUP_SHORTS : TUP_REALS);
 
 }
 
 /*\
- *  \function{tuple\_concat()}
+ *  \function{pack\_tuple()}
  *
- *  This function concatenates two tuples.
+ *  This function packs a tuple of cells, if it is long enough and its
+ *  elements are all short integers or all reals.  Otherwise we leave it
+ *  alone.  The hash code is the same either way.
 \*/
 
-void tuple_concat(
+void pack_tuple(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* target operand                    */
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
+   tuple_h_ptr_type tuple_root)        /* tuple to be packed                */
 
 {
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
-int32 source_hash_code;                /* hash code of source element       */
-int32 base_number;                     /* initial target length             */
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-int target_height, target_index;       /* current height and index          */
-int32 target_number;                   /* target element number             */
-tuple_h_ptr_type new_hdr;              /* created header record pointer     */
-tuple_c_ptr_type new_cell;             /* created cell record pointer       */
-int32 work_number;                     /* working index (destroyed)         */
-int32 expansion_trigger;               /* tuple size which triggers header  */
-                                       /* expansion                         */
-int i;                                 /* temporary looping variable        */
+tuple_c_ptr_type old_cells;            /* cells we replace                  */
+int packing;                           /* packed element form               */
+int32 i;                               /* temporary looping variable        */
 
-   /*
-    *  First we set up source and target tuples.  We would like to use
-    *  the left tuple destructively if possible.
-    */
+   if (tuple_root->t_packing != TUP_CELLS ||
+       tuple_root->t_length < TUP_PACK_MIN)
+      return;
 
-   if (target == left && target != right &&
-       (target->sp_val.sp_tuple_ptr)->t_use_count == 1) {
+   packing = uniform_packing(&(tuple_root->t_cells[0].t_spec),
+                             (int32)sizeof(struct tuple_c_item),
+                             tuple_root->t_length);
+   if (packing == TUP_CELLS)
+      return;
 
-      target_root = target->sp_val.sp_tuple_ptr;
-      target->sp_form = ft_omega;
+   old_cells = tuple_root->t_cells;
+   start_packed(SETL_SYSTEM tuple_root,packing,tuple_root->t_capacity);
 
+   if (packing == TUP_SHORTS) {
+      for (i = 0; i < tuple_root->t_length; i++)
+         tuple_root->t_packed.t_shorts[i] =
+            spec_val(&old_cells[i].t_spec,sp_short_value);
    }
    else {
+      for (i = 0; i < tuple_root->t_length; i++)
+         tuple_root->t_packed.t_reals[i] =
+            spec_val(&old_cells[i].t_spec,sp_real_value);
+   }
 
-      target_root = copy_tuple(SETL_SYSTEM left->sp_val.sp_tuple_ptr);
+   if (old_cells != tuple_root->t_inline)
+      free((void *)old_cells);
 
-   }
+   return;
 
-   /* set the source root */
+}
 
-   source_root = right->sp_val.sp_tuple_ptr;
+/* elements of a chunked tuple from index s on, at most n of them */
 
-   /* set the initial target length */
+#define cells_from(h,s,n) \
+   ((h)->t_length - (s) < (n) ? (h)->t_length - (s) : (n))
 
-   base_number = target_root->t_ntype.t_root.t_length;
-   target_root->t_ntype.t_root.t_length +=
-         source_root->t_ntype.t_root.t_length;
+/*\
+ *  \function{new\_chunk()}
+ *
+ *  This function returns a new chunk of cells, with nothing in it.
+\*/
 
-   /* expand the target header if necessary */
+static tuple_k_ptr_type new_chunk(
+   SETL_SYSTEM_PROTO_VOID)
 
-   expansion_trigger = 1L << ((target_root->t_ntype.t_root.t_height + 1)
-                              * TUP_SHIFT_DIST);
+{
+tuple_k_ptr_type tuple_chunk;          /* returned chunk                    */
 
-   while (target_root->t_ntype.t_root.t_length >= expansion_trigger) {
+   tuple_chunk = (tuple_k_ptr_type)malloc(sizeof(struct tuple_k_item));
+   if (tuple_chunk == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   tuple_chunk->k_use_count = 1;
 
-      target_work_hdr = target_root;
+   return tuple_chunk;
 
-      get_tuple_header(target_root);
+}
 
-      target_root->t_use_count = 1;
-      target_root->t_hash_code =
-            target_work_hdr->t_hash_code;
-      target_root->t_ntype.t_root.t_length =
-            target_work_hdr->t_ntype.t_root.t_length;
-      target_root->t_ntype.t_root.t_height =
-            target_work_hdr->t_ntype.t_root.t_height + 1;
+/*\
+ *  \function{new\_block()}
+ *
+ *  This function returns a new block of chunks, with nothing in it.
+\*/
 
-      for (i = 1;
-           i < TUP_HEADER_SIZE;
-           target_root->t_child[i++].t_header = NULL);
+static tuple_b_ptr_type new_block(
+   SETL_SYSTEM_PROTO_VOID)
 
-      target_root->t_child[0].t_header = target_work_hdr;
+{
+tuple_b_ptr_type tuple_block;          /* returned block                    */
 
-      target_work_hdr->t_ntype.t_intern.t_parent = target_root;
-      target_work_hdr->t_ntype.t_intern.t_child_index = 0;
+   tuple_block = (tuple_b_ptr_type)malloc(sizeof(struct tuple_b_item));
+   if (tuple_block == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   tuple_block->b_use_count = 1;
 
-      expansion_trigger *= TUP_HEADER_SIZE;
+   return tuple_block;
 
-   }
+}
 
-   /* set up to iterate over the source */
+/*\
+ *  \function{chunk\_tuple()}
+ *
+ *  This function converts a tuple of cells to chunks, in place.  The
+ *  chunks take over the cells' hold on the elements, so this is a block
+ *  copy.  Like unpacking, we may do it to a tuple other people hold.
+\*/
 
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
+static void chunk_tuple(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root)        /* tuple to be chunked               */
 
-   /* loop over the elements of source */
+{
+tuple_c_ptr_type old_cells;            /* cells we replace                  */
+int32 block_count;                     /* number of blocks                  */
+int32 start;                           /* first element of each chunk       */
+
+   old_cells = tuple_root->t_cells;
+   block_count = (tuple_root->t_length + TUP_BLOCK_CELLS - 1) >>
+                    TUP_BLOCK_LOG;
+   tuple_root->t_packed.t_blocks = (tuple_b_ptr_type *)malloc((size_t)
+         (block_count * sizeof(tuple_b_ptr_type)));
+   if (tuple_root->t_packed.t_blocks == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-   while (source_number < source_root->t_ntype.t_root.t_length) {
+   for (start = 0;
+        start < tuple_root->t_length;
+        start += TUP_CHUNK_CELLS) {
 
-      /* find the next element in the tuple */
+      if ((start & (TUP_BLOCK_CELLS - 1)) == 0)
+         tuple_root->t_packed.t_blocks[start >> TUP_BLOCK_LOG] =
+            new_block(SETL_SYSTEM_VOID);
 
-      source_element = NULL;
-      for (;;) {
+      tuple_chunk_at(tuple_root,start) = new_chunk(SETL_SYSTEM_VOID);
+      memcpy((void *)(tuple_chunk_at(tuple_root,start)->k_cells),
+             (void *)(old_cells + start),
+             (size_t)(cells_from(tuple_root,start,TUP_CHUNK_CELLS) *
+                      sizeof(struct tuple_c_item)));
 
-         /* if we have an element already, return it */
+   }
 
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
+   if (old_cells != tuple_root->t_inline)
+      free((void *)old_cells);
 
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
+   tuple_root->t_packing = TUP_CHUNKS;
+   tuple_root->t_cells = NULL;
+   tuple_root->t_capacity = block_count << TUP_BLOCK_LOG;
 
-               source_number++;
-               source_index++;
+   return;
 
-               continue;
+}
 
-            }
+/*\
+ *  \function{unshare\_block()}
+ *
+ *  This function makes sure nobody else holds the block of a tuple we
+ *  are about to change, copying it if they do.  The copy shares the
+ *  chunks of the original.
+\*/
 
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-            source_hash_code = source_cell->t_hash_code;
+static void unshare_block(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* chunked tuple                     */
+   int32 index)                        /* element to be changed             */
 
-            source_number++;
-            source_index++;
+{
+tuple_b_ptr_type old_block;            /* shared block                      */
+tuple_b_ptr_type tuple_block;          /* our copy                          */
+int32 start;                           /* first element of block            */
+int32 i;                               /* temporary looping variable        */
 
-            break;
+   old_block = tuple_root->t_packed.t_blocks[index >> TUP_BLOCK_LOG];
+   if (old_block->b_use_count == 1)
+      return;
 
-         }
+   tuple_block = new_block(SETL_SYSTEM_VOID);
+   start = index & ~(TUP_BLOCK_CELLS - 1);
+   for (i = 0;
+        i << TUP_CHUNK_LOG < cells_from(tuple_root,start,TUP_BLOCK_CELLS);
+        i++) {
 
-         /* the current header node is exhausted -- find the next one */
+      tuple_block->b_chunks[i] = old_block->b_chunks[i];
+      tuple_block->b_chunks[i]->k_use_count++;
 
-         /* move up if we're at the end of a node */
+   }
 
-         if (source_index >= TUP_HEADER_SIZE) {
+   old_block->b_use_count--;
+   tuple_root->t_packed.t_blocks[index >> TUP_BLOCK_LOG] = tuple_block;
 
-            /* break if we've exhausted the source */
+   return;
 
-            if (source_work_hdr == source_root)
-               break;
+}
 
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
+/*\
+ *  \function{unshare\_chunk()}
+ *
+ *  This function makes sure nobody else holds the chunk of a tuple we
+ *  are about to change, copying it if they do.  The block must already
+ *  be ours.
+\*/
 
-            continue;
+static void unshare_chunk(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* chunked tuple                     */
+   int32 index)                        /* element to be changed             */
 
-         }
+{
+tuple_k_ptr_type old_chunk;            /* shared chunk                      */
+tuple_k_ptr_type tuple_chunk;          /* our copy                          */
+int32 start;                           /* first element of chunk            */
+int32 i;                               /* temporary looping variable        */
 
-         /* skip over null nodes */
+   old_chunk = tuple_chunk_at(tuple_root,index);
+   if (old_chunk->k_use_count == 1)
+      return;
 
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
+   tuple_chunk = new_chunk(SETL_SYSTEM_VOID);
+   start = index & ~(TUP_CHUNK_CELLS - 1);
+   for (i = 0; i < cells_from(tuple_root,start,TUP_CHUNK_CELLS); i++) {
 
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
+      tuple_chunk->k_cells[i] = old_chunk->k_cells[i];
+      mark_specifier(&(tuple_chunk->k_cells[i].t_spec));
 
-            continue;
+   }
 
-         }
+   old_chunk->k_use_count--;
+   tuple_chunk_at(tuple_root,index) = tuple_chunk;
 
-         /* otherwise drop down a level */
+   return;
 
-         source_work_hdr =
-            source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+}
 
-      }
+/*\
+ *  \function{store\_chunked()}
+ *
+ *  This function assigns an element of a chunked tuple which nobody
+ *  else holds, or appends one just past the end, unsharing only the
+ *  block and chunk we change.  Anything which would change the length
+ *  otherwise unpacks the tuple, and we return NO so the caller can store
+ *  the value in a cell.
+\*/
 
-      if (source_element == NULL)
-         break;
+static int store_chunked(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* chunked tuple                     */
+   int32 index,                        /* element index, from zero          */
+   specifier *value)                   /* value to be stored                */
 
-      /*
-       *  At this point we have an element of the source in
-       *  source_element.  We insert it into the target.
-       */
+{
+tuple_b_ptr_type *new_blocks;          /* enlarged list of blocks           */
+tuple_c_ptr_type tuple_cell;           /* cell we store into                */
+int32 work_hash_code;                  /* hash code of value                */
 
-      target_number = base_number + source_number;
+   if (spec_form(value) == ft_omega && index >= tuple_root->t_length)
+      return YES;
 
-      /* update the target hash code */
+   if (index > tuple_root->t_length ||
+       (spec_form(value) == ft_omega && index == tuple_root->t_length - 1)) {
 
-      target_root->t_hash_code ^= source_hash_code;
+      unpack_tuple_cells(SETL_SYSTEM tuple_root);
 
-      /* we don't insert omegas */
+      return NO;
 
-      if (source_element->sp_form == ft_omega)
-         continue;
+   }
 
-      /* descend the header tree until we get to a leaf */
+   /* appending may need a new block or chunk */
 
-      work_number = target_number;
-      target_work_hdr = target_root;
-      for (target_height = target_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
+   if (index == tuple_root->t_length &&
+       (index & (TUP_BLOCK_CELLS - 1)) == 0) {
 
-         /* extract the element's index at this level */
+      if (index == tuple_root->t_capacity) {
 
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
+         new_blocks = (tuple_b_ptr_type *)realloc(
+               (void *)(tuple_root->t_packed.t_blocks),
+               (size_t)(2 * (tuple_root->t_capacity >> TUP_BLOCK_LOG) *
+                        sizeof(tuple_b_ptr_type)));
+         if (new_blocks == NULL)
+            giveup(SETL_SYSTEM msg_malloc_error);
 
-         /* if we're missing a header record, allocate one */
+         tuple_root->t_packed.t_blocks = new_blocks;
+         tuple_root->t_capacity *= 2;
 
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
+      }
 
-            get_tuple_header(new_hdr);
-            new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-            new_hdr->t_ntype.t_intern.t_child_index = target_index;
+      tuple_root->t_packed.t_blocks[index >> TUP_BLOCK_LOG] =
+         new_block(SETL_SYSTEM_VOID);
+      tuple_chunk_at(tuple_root,index) = new_chunk(SETL_SYSTEM_VOID);
 
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_hdr->t_child[i++].t_cell = NULL);
+   }
+   else if (index == tuple_root->t_length &&
+            (index & (TUP_CHUNK_CELLS - 1)) == 0) {
 
-            target_work_hdr->t_child[target_index].t_header = new_hdr;
-            target_work_hdr = new_hdr;
+      unshare_block(SETL_SYSTEM tuple_root,index);
+      tuple_chunk_at(tuple_root,index) = new_chunk(SETL_SYSTEM_VOID);
 
-         }
-         else {
+   }
+   else {
 
-            target_work_hdr =
-               target_work_hdr->t_child[target_index].t_header;
+      unshare_block(SETL_SYSTEM tuple_root,index);
+      unshare_chunk(SETL_SYSTEM tuple_root,index);
 
-         }
-      }
+   }
 
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We insert the new element in the appropriate slot.
-       */
+   tuple_cell = tuple_cell_at(tuple_root,index);
+   if (index == tuple_root->t_length) {
 
-      mark_specifier(source_element);
-      get_tuple_cell(new_cell);
-      new_cell->t_spec.sp_form = source_element->sp_form;
-      new_cell->t_spec.sp_val.sp_biggest =
-         source_element->sp_val.sp_biggest;
-      new_cell->t_hash_code = source_hash_code;
-      target_index = target_number & TUP_SHIFT_MASK;
-      target_work_hdr->t_child[target_index].t_cell = new_cell;
+      tuple_root->t_length++;
+      tuple_cell->t_hash_code = 0;
+      spec_set_form(&tuple_cell->t_spec,ft_omega);
 
    }
 
-   /* finally, we set the target value */
+   /* replace the element (omega cells have a zero hash code) */
 
-   unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = target_root;
+   mark_specifier(value);
+   unmark_specifier(&(tuple_cell->t_spec));
+   tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
+   spec_set_form(&tuple_cell->t_spec,spec_form(value));
+   spec_set_val(&tuple_cell->t_spec,sp_biggest,
+                spec_val(value,sp_biggest));
+   spec_hash_code(work_hash_code,value);
+   tuple_root->t_hash_code ^= work_hash_code;
+   tuple_cell->t_hash_code = work_hash_code;
 
-   return;
+   return YES;
 
 }
 
 /*\
- *  \function{tuple\_multiply()}
+ *  \function{unpack\_tuple\_cells()}
  *
- *  This function concatenates copies of a tuple.
+ *  This function converts a packed or chunked tuple to cells, in place.
+ *  Callers should use the \verb"unpack_tuple()" macro, which only calls
+ *  us if the tuple is not already cells.  Since the values don't change,
+ *  we may unpack a tuple other people are holding.
 \*/
 
-void tuple_multiply(
+void unpack_tuple_cells(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* target operand                    */
-   specifier *left,                    /* left operand                      */
-   int32 copies)                       /* integer copies                    */
+   tuple_h_ptr_type tuple_root)        /* tuple to be unpacked              */
 
 {
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
-int32 source_hash_code;                /* hash code of source element       */
-int32 base_number;                     /* initial target length             */
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-int target_height, target_index;       /* current height and index          */
-int32 target_number;                   /* target element number             */
-tuple_h_ptr_type new_hdr;              /* created header record pointer     */
-tuple_c_ptr_type new_cell;             /* created cell record pointer       */
-int32 work_number;                     /* working index (destroyed)         */
-int32 expansion_trigger;               /* tuple size which triggers header  */
-                                       /* expansion                         */
-int i;                                 /* temporary looping variable        */
-
-   /* set the source root */
-
-   source_root = left->sp_val.sp_tuple_ptr;
-
-   /* we start with a null target tuple */
-
-   get_tuple_header(target_root);
-   target_root->t_use_count = 1;
-   target_root->t_hash_code = 0;
-   target_root->t_ntype.t_root.t_length = 0;
-   target_root->t_ntype.t_root.t_height = 0;
-
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        target_root->t_child[i++].t_cell = NULL);
+tuple_c_ptr_type new_cells;            /* cell block                        */
+tuple_c_ptr_type tuple_cell;           /* used to loop over elements        */
+tuple_b_ptr_type tuple_block;          /* block we copy from                */
+tuple_k_ptr_type tuple_chunk;          /* chunk we copy from                */
+int32 count;                           /* elements in chunk                 */
+int32 i;                               /* temporary looping variable        */
 
-   while (copies--) {
+   /* we take over the hold on chunks nobody else has */
 
-      /* set the initial target length */
+   if (tuple_root->t_packing == TUP_CHUNKS) {
 
-      base_number = target_root->t_ntype.t_root.t_length;
-      target_root->t_ntype.t_root.t_length +=
-            source_root->t_ntype.t_root.t_length;
+      new_cells = (tuple_c_ptr_type)malloc((size_t)
+            (tuple_root->t_length * sizeof(struct tuple_c_item)));
+      if (new_cells == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-      /* expand the target header if necessary */
+      for (i = 0; i < tuple_root->t_length; i += TUP_CHUNK_CELLS) {
 
-      expansion_trigger = 1L << ((target_root->t_ntype.t_root.t_height + 1)
-                                 * TUP_SHIFT_DIST);
+         tuple_block = tuple_root->t_packed.t_blocks[i >> TUP_BLOCK_LOG];
+         tuple_chunk = tuple_chunk_at(tuple_root,i);
+         count = cells_from(tuple_root,i,TUP_CHUNK_CELLS);
+         memcpy((void *)(new_cells + i),
+                (void *)(tuple_chunk->k_cells),
+                (size_t)(count * sizeof(struct tuple_c_item)));
 
-      while (target_root->t_ntype.t_root.t_length >= expansion_trigger) {
+         if (tuple_block->b_use_count == 1 &&
+             tuple_chunk->k_use_count == 1) {
 
-         target_work_hdr = target_root;
+            free((void *)tuple_chunk);
 
-         get_tuple_header(target_root);
+         }
+         else {
 
-         target_root->t_use_count = 1;
-         target_root->t_hash_code =
-               target_work_hdr->t_hash_code;
-         target_root->t_ntype.t_root.t_length =
-               target_work_hdr->t_ntype.t_root.t_length;
-         target_root->t_ntype.t_root.t_height =
-               target_work_hdr->t_ntype.t_root.t_height + 1;
+            if (tuple_block->b_use_count == 1)
+               tuple_chunk->k_use_count--;
+            for (tuple_cell = new_cells + i;
+                 tuple_cell < new_cells + i + count;
+                 tuple_cell++)
+               mark_specifier(&(tuple_cell->t_spec));
 
-         for (i = 1;
-              i < TUP_HEADER_SIZE;
-              target_root->t_child[i++].t_header = NULL);
+         }
 
-         target_root->t_child[0].t_header = target_work_hdr;
+         /* release the block after its last chunk */
 
-         target_work_hdr->t_ntype.t_intern.t_parent = target_root;
-         target_work_hdr->t_ntype.t_intern.t_child_index = 0;
+         if (i + count == tuple_root->t_length ||
+             ((i + count) & (TUP_BLOCK_CELLS - 1)) == 0) {
 
-         expansion_trigger *= TUP_HEADER_SIZE;
+            if (tuple_block->b_use_count == 1)
+               free((void *)tuple_block);
+            else
+               tuple_block->b_use_count--;
 
+         }
       }
 
-      /* set up to iterate over the source */
-
-      source_work_hdr = source_root;
-      source_number = -1;
-      source_height = source_root->t_ntype.t_root.t_height;
-      source_index = 0;
+      free((void *)(tuple_root->t_packed.t_blocks));
+      tuple_root->t_packed.t_blocks = NULL;
+      tuple_root->t_packing = TUP_CELLS;
+      tuple_root->t_cells = new_cells;
+      tuple_root->t_capacity = tuple_root->t_length;
 
-      /* loop over the elements of source */
-
-      while (source_number < source_root->t_ntype.t_root.t_length) {
+      return;
 
-         /* find the next element in the tuple */
+   }
 
-         source_element = NULL;
-         for (;;) {
+   if (tuple_root->t_capacity <= TUP_INLINE_CELLS) {
 
-            /* if we have an element already, return it */
+      new_cells = tuple_root->t_inline;
+      tuple_root->t_capacity = TUP_INLINE_CELLS;
 
-            if (!source_height && source_index < TUP_HEADER_SIZE) {
+   }
+   else {
 
-               if (source_work_hdr->t_child[source_index].t_cell == NULL) {
+      new_cells = (tuple_c_ptr_type)malloc((size_t)
+            (tuple_root->t_capacity * sizeof(struct tuple_c_item)));
+      if (new_cells == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-                  source_number++;
-                  source_index++;
+   }
 
-                  continue;
+   for (i = 0, tuple_cell = new_cells;
+        i < tuple_root->t_length;
+        i++, tuple_cell++) {
 
-               }
+      get_packed_element(tuple_root,i,&(tuple_cell->t_spec));
+      spec_hash_code(tuple_cell->t_hash_code,&(tuple_cell->t_spec));
 
-               source_cell = source_work_hdr->t_child[source_index].t_cell;
-               source_element = &(source_cell->t_spec);
-               source_hash_code = source_cell->t_hash_code;
+   }
 
-               source_number++;
-               source_index++;
+   free((void *)(tuple_root->t_packed.t_shorts));
+   tuple_root->t_packed.t_shorts = NULL;
+   tuple_root->t_packing = TUP_CELLS;
+   tuple_root->t_cells = new_cells;
 
-               break;
+   return;
 
-            }
+}
 
-            /* the current header node is exhausted -- find the next one */
+/*\
+ *  \function{packed\_hash\_code()}
+ *
+ *  This function returns the hash code of an element of a packed tuple,
+ *  the same as that of the element in a cell.
+\*/
 
-            /* move up if we're at the end of a node */
+int32 packed_hash_code(
+   tuple_h_ptr_type tuple_root,        /* packed tuple                      */
+   int32 i)                            /* element index, from zero          */
 
-            if (source_index >= TUP_HEADER_SIZE) {
+{
+specifier element;                     /* element as a specifier            */
+int32 hash_code;                       /* returned hash code                */
 
-               /* break if we've exhausted the source */
+   get_packed_element(tuple_root,i,&element);
+   spec_hash_code(hash_code,&element);
 
-               if (source_work_hdr == source_root)
-                  break;
+   return hash_code;
 
-               source_height++;
-               source_index =
-                  source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-               source_work_hdr =
-                  source_work_hdr->t_ntype.t_intern.t_parent;
+}
 
-               continue;
+/*\
+ *  \function{store\_packed()}
+ *
+ *  This function assigns an element of a packed tuple which nobody else
+ *  holds, or appends one just past the end.  Chunked tuples go to
+ *  \verb"store_chunked()".  If the value is a number of
+ *  the tuple's form we store it and return YES.  Assigning omega to the
+ *  last element shortens the tuple, and past the end does nothing.
+ *  Anything else unpacks the tuple, and we return NO so the caller can
+ *  store the value in a cell.
+\*/
 
-            }
+int store_packed(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* packed tuple                      */
+   int32 index,                        /* element index, from zero          */
+   specifier *value)                   /* value to be stored                */
 
-            /* skip over null nodes */
+{
 
-            if (source_work_hdr->t_child[source_index].t_header == NULL) {
+   if (tuple_root->t_packing == TUP_CHUNKS)
+      return store_chunked(SETL_SYSTEM tuple_root,index,value);
 
-               source_number += 1L << (source_height * TUP_SHIFT_DIST);
-               source_index++;
+   if (spec_form(value) == ft_omega) {
 
-               continue;
+      if (index >= tuple_root->t_length)
+         return YES;
 
-            }
+      if (index == tuple_root->t_length - 1) {
 
-            /* otherwise drop down a level */
+         tuple_root->t_hash_code ^= packed_hash_code(tuple_root,index);
+         tuple_root->t_length--;
 
-            source_work_hdr =
-               source_work_hdr->t_child[source_index].t_header;
-            source_index = 0;
-            source_height--;
+         return YES;
 
-         }
+      }
+   }
+   else if (packs_into(tuple_root,value) && index <= tuple_root->t_length) {
 
-         if (source_element == NULL)
-            break;
+      if (index == tuple_root->t_length) {
+         reserve_tuple(tuple_root,index + 1);
+         tuple_root->t_length++;
+      }
+      else {
+         tuple_root->t_hash_code ^= packed_hash_code(tuple_root,index);
+      }
 
-         /*
-          *  At this point we have an element of the source in
-          *  source_element.  We insert it into the target.
-          */
+      if (tuple_root->t_packing == TUP_SHORTS)
+         tuple_root->t_packed.t_shorts[index] =
+            spec_val(value,sp_short_value);
+      else
+         tuple_root->t_packed.t_reals[index] =
+            spec_val(value,sp_real_value);
+      tuple_root->t_hash_code ^= packed_hash_code(tuple_root,index);
 
-         target_number = base_number + source_number;
+      return YES;
 
-         /* update the target hash code */
+   }
 
-         target_root->t_hash_code ^= source_hash_code;
+   unpack_tuple_cells(SETL_SYSTEM tuple_root);
 
-         /* we don't insert omegas */
+   return NO;
 
-         if (source_element->sp_form == ft_omega)
-            continue;
+}
 
-         /* descend the header tree until we get to a leaf */
+/*\
+ *  \function{append\_packed()}
+ *
+ *  This function appends a range of elements from one packed tuple to
+ *  the end of another of the same form, which must have room for them.
+ *  Copying a whole tuple, we take its hash code as it stands.
+\*/
 
-         work_number = target_number;
-         target_work_hdr = target_root;
-         for (target_height = target_root->t_ntype.t_root.t_height;
-              target_height;
-              target_height--) {
+static void append_packed(
+   tuple_h_ptr_type target_root,       /* tuple to be lengthened            */
+   tuple_h_ptr_type source_root,       /* tuple we copy from                */
+   int32 start,                        /* first element, from zero          */
+   int32 count)                        /* number of elements to append      */
 
-            /* extract the element's index at this level */
+{
+int32 i;                               /* temporary looping variable        */
 
-            target_index = (target_number >>
-                                 (target_height * TUP_SHIFT_DIST)) &
-                              TUP_SHIFT_MASK;
+   memcpy((void *)((char *)(target_root->t_packed.t_shorts) +
+                   target_root->t_length * packed_size(target_root)),
+          (void *)((char *)(source_root->t_packed.t_shorts) +
+                   start * packed_size(source_root)),
+          (size_t)(count * packed_size(source_root)));
+   target_root->t_length += count;
 
-            /* if we're missing a header record, allocate one */
+   if (start == 0 && count == source_root->t_length) {
 
-            if (target_work_hdr->t_child[target_index].t_header == NULL) {
+      target_root->t_hash_code ^= source_root->t_hash_code;
 
-               get_tuple_header(new_hdr);
-               new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-               new_hdr->t_ntype.t_intern.t_child_index = target_index;
-               for (i = 0;
-                    i < TUP_HEADER_SIZE;
-                    new_hdr->t_child[i++].t_cell = NULL);
-               target_work_hdr->t_child[target_index].t_header = new_hdr;
-               target_work_hdr = new_hdr;
+   }
+   else {
 
-            }
-            else {
+      for (i = start; i < start + count; i++)
+         target_root->t_hash_code ^= packed_hash_code(source_root,i);
 
-               target_work_hdr =
-                  target_work_hdr->t_child[target_index].t_header;
+   }
 
-            }
-         }
+   return;
 
-         /*
-          *  At this point, target_work_hdr points to the lowest level
-          *  header record.  We insert the new element in the appropriate
-          *  slot.
-          */
-
-         mark_specifier(source_element);
-         get_tuple_cell(new_cell);
-         new_cell->t_spec.sp_form = source_element->sp_form;
-         new_cell->t_spec.sp_val.sp_biggest =
-            source_element->sp_val.sp_biggest;
-         new_cell->t_hash_code = source_hash_code;
-         target_index = target_number & TUP_SHIFT_MASK;
-         target_work_hdr->t_child[target_index].t_cell = new_cell;
-
-      }
-   }
-
-   /* finally, we set the target value */
-
-   unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = target_root;
-
-   return;
-
-}
+}
 
 /*\
- *  \function{tuple\_slice()}
+ *  \function{append\_cells()}
  *
- *  This function produces a {\em slice} of a tuple.  We start by
- *  creating a new tuple, then append the appropriate elements from
- *  the source tuple.
+ *  This function appends a range of cells from one tuple to the end of
+ *  another, which must have room for them.  We hold each element we
+ *  copy, and fold the elements' hash codes into the target's.
 \*/
 
-void tuple_slice(
-   SETL_SYSTEM_PROTO
-   specifier *target,                  /* target operand                    */
-   specifier *source,                  /* left operand                      */
-   int32 start_index,                  /* start index of slice              */
-   int32 end_index)                    /* end index of slice                */
+static void append_cells(
+   tuple_h_ptr_type target_root,       /* tuple to be lengthened            */
+   tuple_c_ptr_type source_cell,       /* first cell to append              */
+   int32 count)                        /* number of cells to append         */
 
 {
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
-int32 source_hash_code;                /* hash code of source element       */
-int32 base_number;                     /* initial target length             */
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-int target_height, target_index;       /* current height and index          */
-int32 target_number;                   /* target element number             */
-tuple_h_ptr_type new_hdr;              /* created header record pointer     */
-tuple_c_ptr_type new_cell;             /* created cell record pointer       */
-int32 expansion_trigger;               /* tuple size which triggers header  */
-                                       /* expansion                         */
-int i;                                 /* temporary looping variable        */
-
-   /* our indices are zero-based */
-
-   start_index--;
-   end_index--;
-
-   /* pick out the source root */
-
-   source_root = source->sp_val.sp_tuple_ptr;
-
-   /* we start with a null target tuple */
-
-   get_tuple_header(target_root);
-   target_root->t_use_count = 1;
-   target_root->t_hash_code = 0;
-   target_root->t_ntype.t_root.t_length = 0;
-   target_root->t_ntype.t_root.t_height = 0;
-
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        target_root->t_child[i++].t_cell = NULL);
-
-   /* set the initial target length */
-
-   base_number = target_root->t_ntype.t_root.t_length;
-   target_root->t_ntype.t_root.t_length += (end_index - start_index + 1);
-
-   /* expand the target header if necessary */
-
-   expansion_trigger = 1L << ((target_root->t_ntype.t_root.t_height + 1)
-                              * TUP_SHIFT_DIST);
-
-   while (target_root->t_ntype.t_root.t_length > expansion_trigger) {
-
-      target_work_hdr = target_root;
-
-      get_tuple_header(target_root);
-
-      target_root->t_use_count = 1;
-      target_root->t_hash_code =
-            target_work_hdr->t_hash_code;
-      target_root->t_ntype.t_root.t_length =
-            target_work_hdr->t_ntype.t_root.t_length;
-      target_root->t_ntype.t_root.t_height =
-            target_work_hdr->t_ntype.t_root.t_height + 1;
-
-      for (i = 1;
-           i < TUP_HEADER_SIZE;
-           target_root->t_child[i++].t_cell = NULL);
-
-      target_root->t_child[0].t_header = target_work_hdr;
-
-      target_work_hdr->t_ntype.t_intern.t_parent = target_root;
-      target_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-      expansion_trigger *= TUP_HEADER_SIZE;
-
-   }
-
-   /* try to go down to the appropriate leaf */
-
-   source_number = start_index;
-   source_work_hdr = source_root;
-   for (source_height = source_root->t_ntype.t_root.t_height;
-        source_height;
-        source_height--) {
-
-      /* extract the element's index at this level */
-
-      source_index = (source_number >>
-                           (source_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-      /* if we're missing a header record, break */
-
-      if (source_work_hdr->t_child[source_index].t_header == NULL)
-         break;
-
-      /* otherwise move down */
-
-      source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-
-   }
-
-   /* if we're not at a leaf, fix up the source number */
-
-   if (source_height > 0) {
-
-      source_number = (source_number |
-                         ((1L << (source_height * TUP_SHIFT_DIST)) - 1))
-                       ^ ((1L << (source_height * TUP_SHIFT_DIST)) - 1);
-
-   }
-   else {
-
-       source_index = source_number & TUP_SHIFT_MASK;
-
-   }
-
-   /* loop over the elements of source */
-
-   source_number--;
-   while (source_number < end_index) {
+tuple_c_ptr_type target_cell;          /* used to loop over new cells       */
+tuple_c_ptr_type target_end;           /* end of new cells                  */
 
-      /* find the next element in the tuple */
+   target_cell = target_root->t_cells + target_root->t_length;
+   memcpy((void *)target_cell,(void *)source_cell,
+          (size_t)(count * sizeof(struct tuple_c_item)));
+   target_root->t_length += count;
 
-      source_element = NULL;
-      for (;;) {
+   for (target_end = target_cell + count;
+        target_cell < target_end;
+        target_cell++) {
 
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            /* we do have an element from source */
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-            source_hash_code = source_cell->t_hash_code;
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      if (source_element == NULL || source_number > end_index)
-         break;
-
-      /*
-       *  At this point we have an element of the source in
-       *  source_element.  We insert it into the target.
-       */
-
-      target_number = base_number + source_number - start_index;
-
-      /* we don't insert omegas */
-
-      if (source_element->sp_form == ft_omega)
-         continue;
-
-      /* update the target hash code */
-
-      target_root->t_hash_code ^= source_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_work_hdr = target_root;
-      for (target_height = target_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-            get_tuple_header(new_hdr);
-            new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-            new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_hdr->t_child[i++].t_cell = NULL);
-
-            target_work_hdr->t_child[target_index].t_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->t_child[target_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We insert the new element in the appropriate slot.
-       */
-
-      mark_specifier(source_element);
-      get_tuple_cell(new_cell);
-      new_cell->t_spec.sp_form = source_element->sp_form;
-      new_cell->t_spec.sp_val.sp_biggest =
-         source_element->sp_val.sp_biggest;
-      new_cell->t_hash_code = source_hash_code;
-      target_index = target_number & TUP_SHIFT_MASK;
-      target_work_hdr->t_child[target_index].t_cell = new_cell;
+      mark_specifier(&(target_cell->t_spec));
+      target_root->t_hash_code ^= target_cell->t_hash_code;
 
    }
 
-   /*
-    *  Since we've concatenated a slice, not an entire tuple, there is no
-    *  guarantee that the rightmost cells are not omega.  We insist that
-    *  the rightmost cells of a finished tuple not be omega, so we
-    *  strip off right-most omegas.
-    */
-
-   /* if the length is zero, don't try this */
-
-   if (target_root->t_ntype.t_root.t_length == 0) {
-
-      unmark_specifier(target);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = target_root;
-
-      return;
-
-   }
-
-   /* drop to a leaf at the rightmost position */
-
-   target_number = target_root->t_ntype.t_root.t_length - 1;
-   target_work_hdr = target_root;
-   for (target_height = target_root->t_ntype.t_root.t_height;
-        target_height;
-        target_height--) {
-
-      /* extract the element's index at this level */
-
-      target_index = (target_number >>
-                           (target_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
-
-      /* if we're missing a header record, allocate one */
-
-      if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-         get_tuple_header(new_hdr);
-         new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-         new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-         for (i = 0;
-              i < TUP_HEADER_SIZE;
-              new_hdr->t_child[i++].t_cell = NULL);
-
-         target_work_hdr->t_child[target_index].t_header = new_hdr;
-         target_work_hdr = new_hdr;
-
-      }
-      else {
-
-         target_work_hdr =
-            target_work_hdr->t_child[target_index].t_header;
-
-      }
-   }
-
-   /* set the target index to the last element */
-
-   target_index = target_number & TUP_SHIFT_MASK;
-
-   /* keep stripping omegas */
-
-   for (;;) {
-
-      if (!target_height && target_index >= 0) {
-
-         if (target_work_hdr->t_child[target_index].t_cell != NULL)
-            break;
-
-         target_root->t_ntype.t_root.t_length--;
-         target_index--;
-
-         continue;
-
-      }
-
-      /* move up if we're at the end of a node */
-
-      if (target_index < 0) {
-
-         if (target_work_hdr == target_root)
-            break;
-
-         target_height++;
-         target_index = target_work_hdr->t_ntype.t_intern.t_child_index;
-         target_work_hdr = target_work_hdr->t_ntype.t_intern.t_parent;
-         free_tuple_header(target_work_hdr->t_child[target_index].t_header);
-         target_work_hdr->t_child[target_index].t_header = NULL;
-         target_index--;
-
-         continue;
-
-      }
-
-      /* skip over null nodes */
-
-      if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-         target_root->t_ntype.t_root.t_length -=
-               1L << (target_height * TUP_SHIFT_DIST);
-         target_index--;
-
-         continue;
-
-      }
-
-      /* otherwise drop down a level */
-
-      target_work_hdr =
-         target_work_hdr->t_child[target_index].t_header;
-      target_index = TUP_HEADER_SIZE - 1;
-
-      target_height--;
-
-   }
-
-   /* we've shortened the tuple -- now reduce the height */
-
-   while (target_root->t_ntype.t_root.t_height > 0 &&
-          target_root->t_ntype.t_root.t_length <=
-             (int32)(1L << (target_root->t_ntype.t_root.t_height *
-                           TUP_SHIFT_DIST))) {
-
-      target_work_hdr = target_root->t_child[0].t_header;
-
-      /* it's possible that we deleted internal headers */
-
-      if (target_work_hdr == NULL) {
-
-         target_root->t_ntype.t_root.t_height--;
-         continue;
-
-      }
-
-      /* delete the root node */
-
-      target_work_hdr->t_use_count = target_root->t_use_count;
-      target_work_hdr->t_hash_code =
-            target_root->t_hash_code;
-      target_work_hdr->t_ntype.t_root.t_length =
-            target_root->t_ntype.t_root.t_length;
-      target_work_hdr->t_ntype.t_root.t_height =
-            target_root->t_ntype.t_root.t_height - 1;
-
-      free_tuple_header(target_root);
-      target_root = target_work_hdr;
-
-   }
-
-   /* finally, we set the target value */
-
-   unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = target_root;
-
    return;
 
 }
 
 /*\
- *  \function{tuple\_sslice()}
+ *  \function{copy\_tuple()}
  *
- *  This function assignes a tuple to a slice of a tuple.  We start by
- *  creating a new tuple, then appending slices from the target and
- *  source.
+ *  This function copies an entire tuple structure.  A long tuple is
+ *  chunked first, even if it was packed, and the copy then shares its
+ *  blocks, costing a pointer and a use count for each block of
+ *  \verb"TUP_BLOCK_CELLS" elements.
 \*/
 
-void tuple_sslice(
+tuple_h_ptr_type copy_tuple(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* target operand                    */
-   specifier *source,                  /* left operand                      */
-   int32 start_index,                  /* start index of slice              */
-   int32 end_index)                    /* end index of slice                */
+   tuple_h_ptr_type source_root)       /* tuple to be copied                */
 
 {
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
-int32 source_hash_code;                /* hash code of source element       */
-int32 base_number;                     /* initial target length             */
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-int target_height, target_index;       /* current height and index          */
-int32 target_number;                   /* target element number             */
-tuple_h_ptr_type new_hdr;              /* created header record pointer     */
-tuple_c_ptr_type new_cell;             /* created cell record pointer       */
-int32 expansion_trigger;               /* tuple size which triggers header  */
-                                       /* expansion                         */
-int i;                                 /* temporary looping variable        */
-
-   /* our indices are zero-based */
-
-   start_index--;
-   end_index--;
-
-   /* we start with a null target tuple */
-
-   get_tuple_header(target_root);
-   target_root->t_use_count = 1;
-   target_root->t_hash_code = 0;
-   target_root->t_ntype.t_root.t_length = 0;
-   target_root->t_ntype.t_root.t_height = 0;
-
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        target_root->t_child[i++].t_cell = NULL);
-
-   /*
-    *  We first copy the target up to the start of the slice.
-    */
-
-   /* pick out the source root */
-
-   source_root = target->sp_val.sp_tuple_ptr;
-
-   /* set the initial target length */
-
-   base_number = target_root->t_ntype.t_root.t_length;
-   target_root->t_ntype.t_root.t_length += start_index;
-
-   /* expand the target header if necessary */
-
-   expansion_trigger = 1L << ((target_root->t_ntype.t_root.t_height + 1)
-                              * TUP_SHIFT_DIST);
-
-   while (target_root->t_ntype.t_root.t_length > expansion_trigger) {
-
-      target_work_hdr = target_root;
-
-      get_tuple_header(target_root);
-
-      target_root->t_use_count = 1;
-      target_root->t_hash_code =
-            target_work_hdr->t_hash_code;
-      target_root->t_ntype.t_root.t_length =
-            target_work_hdr->t_ntype.t_root.t_length;
-      target_root->t_ntype.t_root.t_height =
-            target_work_hdr->t_ntype.t_root.t_height + 1;
-
-      for (i = 1;
-           i < TUP_HEADER_SIZE;
-           target_root->t_child[i++].t_cell = NULL);
-
-      target_root->t_child[0].t_header = target_work_hdr;
-
-      target_work_hdr->t_ntype.t_intern.t_parent = target_root;
-      target_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-      expansion_trigger *= TUP_HEADER_SIZE;
-
-   }
-
-   /* loop over the elements of source */
-
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
-
-   while (source_number < start_index - 1) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            /* we do have an element from source */
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-            source_hash_code = source_cell->t_hash_code;
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      if (source_element == NULL || source_number >= start_index)
-         break;
-
-      /*
-       *  At this point we have an element of the source in
-       *  source_element.  We insert it into the target.
-       */
-
-      target_number = base_number + source_number;
-
-      /* we don't insert omegas */
-
-      if (source_element->sp_form == ft_omega)
-         continue;
-
-      /* update the target hash code */
-
-      target_root->t_hash_code ^= source_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_work_hdr = target_root;
-      for (target_height = target_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-            get_tuple_header(new_hdr);
-            new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-            new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_hdr->t_child[i++].t_cell = NULL);
-
-            target_work_hdr->t_child[target_index].t_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->t_child[target_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We insert the new element in the appropriate slot.
-       */
-
-      mark_specifier(source_element);
-      get_tuple_cell(new_cell);
-      new_cell->t_spec.sp_form = source_element->sp_form;
-      new_cell->t_spec.sp_val.sp_biggest =
-         source_element->sp_val.sp_biggest;
-      new_cell->t_hash_code = source_hash_code;
-      target_index = target_number & TUP_SHIFT_MASK;
-      target_work_hdr->t_child[target_index].t_cell = new_cell;
+tuple_h_ptr_type target_root;          /* created tuple                     */
+int32 block_count;                     /* number of blocks                  */
+int32 i;                               /* temporary looping variable        */
+#ifdef DEBUG
+#ifdef HAVE_GETRUSAGE
+struct timeval start;                   /* structure to fill                 */
+struct timeval stop;                    /* structure to fill                 */
+struct timezone tz;
+#endif
 
+   if (PROF_DEBUG) {
+#ifdef HAVE_GETRUSAGE
+   gettimeofday(&start,&tz);
+#endif
+      if (profi!=NULL) profi->copies++;
+      copy_operations[OPCODE_EXECUTED]++;
    }
+   if ((TRACING_ON)&&(TRACE_COPIES))
+      fprintf(DEBUG_FILE,"*COPY_TUPLE*\n");
+#endif
 
-   /*
-    *  Now we copy the entire source.
-    */
-
-   /* pick out the source root */
-
-   source_root = source->sp_val.sp_tuple_ptr;
-
-   /* set the initial target length */
-
-   base_number = target_root->t_ntype.t_root.t_length;
-   target_root->t_ntype.t_root.t_length +=
-         source_root->t_ntype.t_root.t_length;
-
-   /* expand the target header if necessary */
-
-   expansion_trigger = 1L << ((target_root->t_ntype.t_root.t_height + 1)
-                              * TUP_SHIFT_DIST);
-
-   while (target_root->t_ntype.t_root.t_length > expansion_trigger) {
-
-      target_work_hdr = target_root;
-
-      get_tuple_header(target_root);
-
-      target_root->t_use_count = 1;
-      target_root->t_hash_code =
-            target_work_hdr->t_hash_code;
-      target_root->t_ntype.t_root.t_length =
-            target_work_hdr->t_ntype.t_root.t_length;
-      target_root->t_ntype.t_root.t_height =
-            target_work_hdr->t_ntype.t_root.t_height + 1;
-
-      for (i = 1;
-           i < TUP_HEADER_SIZE;
-           target_root->t_child[i++].t_cell = NULL);
-
-      target_root->t_child[0].t_header = target_work_hdr;
+   target_root = new_tuple(SETL_SYSTEM_VOID);
 
-      target_work_hdr->t_ntype.t_intern.t_parent = target_root;
-      target_work_hdr->t_ntype.t_intern.t_child_index = 0;
+   if (source_root->t_packing != TUP_CHUNKS &&
+       source_root->t_length >= TUP_CHUNK_MIN) {
 
-      expansion_trigger *= TUP_HEADER_SIZE;
+      unpack_tuple(source_root);
+      chunk_tuple(SETL_SYSTEM source_root);
 
    }
 
-   /* loop over the elements of source */
-
-   source_work_hdr = source_root;
-   source_number = -1;
-   source_height = source_root->t_ntype.t_root.t_height;
-   source_index = 0;
-
-   for (;;) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (;;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            /* we do have an element from source */
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-            source_hash_code = source_cell->t_hash_code;
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
+   if (source_root->t_packing == TUP_CHUNKS) {
 
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
+      block_count = (source_root->t_length + TUP_BLOCK_CELLS - 1) >>
+                       TUP_BLOCK_LOG;
+      target_root->t_packed.t_blocks = (tuple_b_ptr_type *)malloc((size_t)
+            (block_count * sizeof(tuple_b_ptr_type)));
+      if (target_root->t_packed.t_blocks == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
+      for (i = 0; i < block_count; i++) {
 
-         source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+         target_root->t_packed.t_blocks[i] =
+            source_root->t_packed.t_blocks[i];
+         target_root->t_packed.t_blocks[i]->b_use_count++;
 
       }
 
-      if (source_element == NULL)
-         break;
-
-      /*
-       *  At this point we have an element of the source in
-       *  source_element.  We insert it into the target.
-       */
-
-      target_number = base_number + source_number;
-
-      /* we don't insert omegas */
-
-      if (source_element->sp_form == ft_omega)
-         continue;
-
-      /* update the target hash code */
-
-      target_root->t_hash_code ^= source_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_work_hdr = target_root;
-      for (target_height = target_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-            get_tuple_header(new_hdr);
-            new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-            new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_hdr->t_child[i++].t_cell = NULL);
-
-            target_work_hdr->t_child[target_index].t_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->t_child[target_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We insert the new element in the appropriate slot.
-       */
-
-      mark_specifier(source_element);
-      get_tuple_cell(new_cell);
-      new_cell->t_spec.sp_form = source_element->sp_form;
-      new_cell->t_spec.sp_val.sp_biggest =
-         source_element->sp_val.sp_biggest;
-      new_cell->t_hash_code = source_hash_code;
-      target_index = target_number & TUP_SHIFT_MASK;
-      target_work_hdr->t_child[target_index].t_cell = new_cell;
-
-   }
-
-   /*
-    *  Finally, we copy the tail from the target.
-    */
-
-   /* pick out the source root */
-
-   source_root = target->sp_val.sp_tuple_ptr;
-
-   /* set the initial target length */
-
-   base_number = target_root->t_ntype.t_root.t_length;
-   target_root->t_ntype.t_root.t_length +=
-         (source_root->t_ntype.t_root.t_length - end_index - 1);
-
-   /* expand the target header if necessary */
-
-   expansion_trigger = 1L << ((target_root->t_ntype.t_root.t_height + 1)
-                              * TUP_SHIFT_DIST);
-
-   while (target_root->t_ntype.t_root.t_length > expansion_trigger) {
-
-      target_work_hdr = target_root;
-
-      get_tuple_header(target_root);
-
-      target_root->t_use_count = 1;
-      target_root->t_hash_code =
-            target_work_hdr->t_hash_code;
-      target_root->t_ntype.t_root.t_length =
-            target_work_hdr->t_ntype.t_root.t_length;
-      target_root->t_ntype.t_root.t_height =
-            target_work_hdr->t_ntype.t_root.t_height + 1;
-
-      for (i = 1;
-           i < TUP_HEADER_SIZE;
-           target_root->t_child[i++].t_cell = NULL);
-
-      target_root->t_child[0].t_header = target_work_hdr;
-
-      target_work_hdr->t_ntype.t_intern.t_parent = target_root;
-      target_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-      expansion_trigger *= TUP_HEADER_SIZE;
+      target_root->t_packing = TUP_CHUNKS;
+      target_root->t_cells = NULL;
+      target_root->t_capacity = block_count << TUP_BLOCK_LOG;
+      target_root->t_length = source_root->t_length;
+      target_root->t_hash_code = source_root->t_hash_code;
 
    }
+   else if (source_root->t_packing != TUP_CELLS) {
 
-   /* try to go down to the appropriate leaf */
-
-   source_number = end_index + 1;
-   source_work_hdr = source_root;
-   for (source_height = source_root->t_ntype.t_root.t_height;
-        source_height;
-        source_height--) {
-
-      /* extract the element's index at this level */
-
-      source_index = (source_number >>
-                           (source_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-      /* if we're missing a header record, break */
-
-      if (source_work_hdr->t_child[source_index].t_header == NULL)
-         break;
-
-      /* otherwise move down */
-
-      source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-
-   }
-
-   /* if we're not at a leaf, fix up the source number */
-
-   if (source_height > 0) {
-
-      source_number = (source_number |
-                         ((1L << (source_height * TUP_SHIFT_DIST)) - 1))
-                       ^ ((1L << (source_height * TUP_SHIFT_DIST)) - 1);
+      start_packed(SETL_SYSTEM target_root,source_root->t_packing,
+                   source_root->t_length);
+      append_packed(target_root,source_root,0,source_root->t_length);
 
    }
    else {
 
-       source_index = source_number & TUP_SHIFT_MASK;
+      reserve_tuple(target_root,source_root->t_length);
+      append_cells(target_root,source_root->t_cells,source_root->t_length);
 
    }
 
-   /* loop over the elements of source */
-
-   source_number--;
-   for (;;) {
-
-      /* find the next element in the tuple */
-
-      source_element = NULL;
-      for (; source_number < source_root->t_ntype.t_root.t_length - 1;) {
-
-         /* if we have an element already, return it */
-
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
-
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
-
-               source_number++;
-               source_index++;
-
-               continue;
-
-            }
-
-            /* we do have an element from source */
-
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-            source_hash_code = source_cell->t_hash_code;
-
-            source_number++;
-            source_index++;
-
-            break;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (source_index >= TUP_HEADER_SIZE) {
-
-            /* break if we've exhausted the source */
-
-            if (source_work_hdr == source_root)
-               break;
-
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
-
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
-
-      }
-
-      if (source_element == NULL)
-         break;
-
-      /*
-       *  At this point we have an element of the source in
-       *  source_element.  We insert it into the target.
-       */
-
-      target_number = base_number + source_number - end_index - 1;
-
-      /* we don't insert omegas */
-
-      if (source_element->sp_form == ft_omega)
-         continue;
-
-      /* update the target hash code */
-
-      target_root->t_hash_code ^= source_hash_code;
-
-      /* descend the header tree until we get to a leaf */
-
-      target_work_hdr = target_root;
-      for (target_height = target_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-            get_tuple_header(new_hdr);
-            new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-            new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_hdr->t_child[i++].t_cell = NULL);
-
-            target_work_hdr->t_child[target_index].t_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->t_child[target_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We insert the new element in the appropriate slot.
-       */
-
-      mark_specifier(source_element);
-      get_tuple_cell(new_cell);
-      new_cell->t_spec.sp_form = source_element->sp_form;
-      new_cell->t_spec.sp_val.sp_biggest =
-         source_element->sp_val.sp_biggest;
-      new_cell->t_hash_code = source_hash_code;
-      target_index = target_number & TUP_SHIFT_MASK;
-      target_work_hdr->t_child[target_index].t_cell = new_cell;
-
-   }
-
-   /*
-    *  Since we've concatenated slices, not an entire tuple, there is no
-    *  guarantee that the rightmost cells are not omega.  We insist that
-    *  the rightmost cells of a finished tuple not be omega, so we
-    *  strip off right-most omegas.
-    */
-
-   /* if the length is zero, don't try this */
-
-   if (target_root->t_ntype.t_root.t_length == 0) {
-
-      unmark_specifier(target);
-      target->sp_form = ft_tuple;
-      target->sp_val.sp_tuple_ptr = target_root;
-
-      return;
-
-   }
-
-   /* drop to a leaf at the rightmost position */
-
-   target_number = target_root->t_ntype.t_root.t_length - 1;
-   target_work_hdr = target_root;
-   for (target_height = target_root->t_ntype.t_root.t_height;
-        target_height;
-        target_height--) {
-
-      /* extract the element's index at this level */
-
-      target_index = (target_number >>
-                           (target_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
-
-      /* if we're missing a header record, allocate one */
-
-      if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-         get_tuple_header(new_hdr);
-         new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-         new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-         for (i = 0;
-              i < TUP_HEADER_SIZE;
-              new_hdr->t_child[i++].t_cell = NULL);
-
-         target_work_hdr->t_child[target_index].t_header = new_hdr;
-         target_work_hdr = new_hdr;
-
+#ifdef DEBUG
+#ifdef HAVE_GETRUSAGE
+   if (profi!=NULL) {
+      gettimeofday(&stop,&tz);
+      profi->timec.tv_sec +=(stop.tv_sec-start.tv_sec);
+      profi->timec.tv_usec+=(stop.tv_usec-start.tv_usec);
+      while (profi->timec.tv_usec<0) {
+         profi->timec.tv_sec--;
+         profi->timec.tv_usec+=1000000;
       }
-      else {
-
-         target_work_hdr =
-            target_work_hdr->t_child[target_index].t_header;
-
+      while (profi->timec.tv_usec>=1000000) {
+         profi->timec.tv_sec++;
+         profi->timec.tv_usec-=1000000;
       }
    }
+#endif
+#endif
+   return target_root;
 
-   /* set the target index to the last element */
-
-   target_index = target_number & TUP_SHIFT_MASK;
-
-   /* keep stripping omegas */
-
-   for (;;) {
-
-      if (!target_height && target_index >= 0) {
-
-         if (target_work_hdr->t_child[target_index].t_cell != NULL)
-            break;
-
-         target_root->t_ntype.t_root.t_length--;
-         target_index--;
+}
 
-         continue;
+/*\
+ *  \function{append\_elements()}
+ *
+ *  This function appends a range of elements from one tuple to the end
+ *  of another, which must have room for them.  Either tuple may be
+ *  packed, but if the target is packed the source must be packed the
+ *  same way or hold only elements which fit.  A chunked source is
+ *  appended to cells a chunk at a time.
+\*/
 
-      }
+static void append_elements(
+   tuple_h_ptr_type target_root,       /* tuple to be lengthened            */
+   tuple_h_ptr_type source_root,       /* tuple we copy from                */
+   int32 start,                        /* first element, from zero          */
+   int32 count)                        /* number of elements to append      */
 
-      /* move up if we're at the end of a node */
+{
+tuple_c_ptr_type tuple_cell;           /* used to loop over cells           */
+tuple_c_ptr_type tuple_end;            /* end of cells                      */
+int32 run;                             /* elements from one chunk           */
+int32 i;                               /* temporary looping variable        */
 
-      if (target_index < 0) {
+   if (count == 0)
+      return;
 
-         if (target_work_hdr == target_root)
-            break;
+   if (source_root->t_packing == TUP_CHUNKS) {
 
-         target_height++;
-         target_index = target_work_hdr->t_ntype.t_intern.t_child_index;
-         target_work_hdr = target_work_hdr->t_ntype.t_intern.t_parent;
-         free_tuple_header(target_work_hdr->t_child[target_index].t_header);
-         target_work_hdr->t_child[target_index].t_header = NULL;
-         target_index--;
+      while (count > 0) {
 
-         continue;
+         run = TUP_CHUNK_CELLS - (start & (TUP_CHUNK_CELLS - 1));
+         if (run > count)
+            run = count;
+         append_cells(target_root,tuple_cell_at(source_root,start),run);
+         start += run;
+         count -= run;
 
       }
 
-      /* skip over null nodes */
-
-      if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-         target_root->t_ntype.t_root.t_length -=
-               1L << (target_height * TUP_SHIFT_DIST);
-         target_index--;
+      return;
 
-         continue;
+   }
 
-      }
+   /* cells to cells and packed to packed are block copies */
 
-      /* otherwise drop down a level */
+   if (source_root->t_packing == target_root->t_packing) {
 
-      target_work_hdr =
-         target_work_hdr->t_child[target_index].t_header;
-      target_index = TUP_HEADER_SIZE - 1;
+      if (source_root->t_packing == TUP_CELLS)
+         append_cells(target_root,source_root->t_cells + start,count);
+      else
+         append_packed(target_root,source_root,start,count);
 
-      target_height--;
+      return;
 
    }
 
-   /* we've shortened the tuple -- now reduce the height */
+   /* cells to a packed tuple, keeping the cell hash codes */
 
-   while (target_root->t_ntype.t_root.t_height > 0 &&
-          target_root->t_ntype.t_root.t_length <=
-             (int32)(1L << (target_root->t_ntype.t_root.t_height *
-                           TUP_SHIFT_DIST))) {
+   if (source_root->t_packing == TUP_CELLS) {
 
-      target_work_hdr = target_root->t_child[0].t_header;
+      tuple_end = source_root->t_cells + start + count;
+      for (tuple_cell = source_root->t_cells + start;
+           tuple_cell < tuple_end;
+           tuple_cell++) {
 
-      /* it's possible that we deleted internal headers */
+         if (target_root->t_packing == TUP_SHORTS)
+            target_root->t_packed.t_shorts[target_root->t_length++] =
+               spec_val(&tuple_cell->t_spec,sp_short_value);
+         else
+            target_root->t_packed.t_reals[target_root->t_length++] =
+               spec_val(&tuple_cell->t_spec,sp_real_value);
+         target_root->t_hash_code ^= tuple_cell->t_hash_code;
 
-      if (target_work_hdr == NULL) {
+      }
 
-         target_root->t_ntype.t_root.t_height--;
-         continue;
+      return;
 
-      }
+   }
 
-      /* delete the root node */
+   /* packed elements to cells */
 
-      target_work_hdr->t_use_count = target_root->t_use_count;
-      target_work_hdr->t_hash_code =
-            target_root->t_hash_code;
-      target_work_hdr->t_ntype.t_root.t_length =
-            target_root->t_ntype.t_root.t_length;
-      target_work_hdr->t_ntype.t_root.t_height =
-            target_root->t_ntype.t_root.t_height - 1;
+   tuple_cell = target_root->t_cells + target_root->t_length;
+   for (i = start; i < start + count; i++, tuple_cell++) {
 
-      free_tuple_header(target_root);
-      target_root = target_work_hdr;
+      get_packed_element(source_root,i,&(tuple_cell->t_spec));
+      spec_hash_code(tuple_cell->t_hash_code,&(tuple_cell->t_spec));
+      target_root->t_hash_code ^= tuple_cell->t_hash_code;
 
    }
 
-   /* finally, we set the target value */
-
-   unmark_specifier(target);
-   target->sp_form = ft_tuple;
-   target->sp_val.sp_tuple_ptr = target_root;
+   target_root->t_length += count;
 
    return;
 
 }
 
 /*\
- *  \function{tuple\_fromb()}
+ *  \function{tuple\_concat()}
  *
- *  This functions implements the SETL2 \verb"FROMB" operation.  Notice
- *  that all three operands may be modified.
+ *  This function concatenates two tuples.  We use the left tuple
+ *  destructively if we can, in which case appending a short tuple to a
+ *  long one only copies the short one.  The result is packed if both
+ *  operands are packed the same way, or one is packed and the other
+ *  empty.
 \*/
 
-void tuple_fromb(
+void tuple_concat(
    SETL_SYSTEM_PROTO
    specifier *target,                  /* target operand                    */
    specifier *left,                    /* left operand                      */
    specifier *right)                   /* right operand                     */
 
 {
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int32 source_number;                   /* current cell number               */
-int source_height, source_index;       /* current height and index          */
-specifier *source_element;             /* set element                       */
-int32 source_hash_code;                /* hash code of source element       */
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-int target_height, target_index;       /* current height and index          */
-int32 work_length;                     /* working copy of length            */
-                                       /* (destroyed finding height)        */
-int32 target_number;                   /* target element number             */
-tuple_h_ptr_type new_hdr;              /* created header record pointer     */
-tuple_c_ptr_type new_cell;             /* created cell record pointer       */
-int i;                                 /* temporary looping variable        */
-
-   /* if the source set is empty, return omega */
-
-   source_root = right->sp_val.sp_tuple_ptr;
-   if (source_root->t_ntype.t_root.t_length == 0) {
-
-      unmark_specifier(left);
-      left->sp_form = ft_omega;
-
-      if (target != NULL) {
+tuple_h_ptr_type left_root;            /* left tuple                        */
+tuple_h_ptr_type source_root;          /* right tuple                       */
+tuple_h_ptr_type target_root;          /* result tuple                      */
+int packing;                           /* storage form of result            */
+
+   left_root = spec_val(left,sp_tuple_ptr);
+   source_root = spec_val(right,sp_tuple_ptr);
+
+   if (source_root->t_length == 0 ||
+       source_root->t_packing == left_root->t_packing)
+      packing = left_root->t_packing;
+   else if (left_root->t_length == 0)
+      packing = source_root->t_packing;
+   else
+      packing = TUP_CELLS;
+   if (packing == TUP_CHUNKS)
+      packing = TUP_CELLS;
 
-         unmark_specifier(target);
-         target->sp_form = ft_omega;
-
-      }
+   if (target == left && target != right &&
+       left_root->t_use_count == 1 &&
+       (packing == TUP_CELLS || packing == left_root->t_packing)) {
 
-      return;
+      target_root = left_root;
+      spec_set_form(target,ft_omega);
+      unpack_tuple(target_root);
+      reserve_tuple(target_root,
+                    target_root->t_length + source_root->t_length);
 
    }
+   else {
 
-   /* we start with a null target tuple */
-
-   get_tuple_header(target_root);
-   target_root->t_use_count = 1;
-   target_root->t_hash_code =
-         source_root->t_hash_code;
-   target_root->t_ntype.t_root.t_length =
-         source_root->t_ntype.t_root.t_length - 1;
-
-   /* calculate the height of the new header tree */
+      target_root = new_tuple(SETL_SYSTEM_VOID);
+      if (packing != TUP_CELLS)
+         start_packed(SETL_SYSTEM target_root,packing,
+                      left_root->t_length + source_root->t_length);
+      else
+         reserve_tuple(target_root,
+                       left_root->t_length + source_root->t_length);
+      append_elements(target_root,left_root,0,left_root->t_length);
 
-   target_height = 0;
-   work_length = target_root->t_ntype.t_root.t_length;
-   while (work_length = work_length >> TUP_SHIFT_DIST)
-      target_height++;
+   }
 
-   target_root->t_ntype.t_root.t_height = target_height;
+   append_elements(target_root,source_root,0,source_root->t_length);
 
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        target_root->t_child[i++].t_cell = NULL);
+   /* finally, we set the target value */
 
-   /* try to go down to the appropriate leaf */
+   unmark_specifier(target);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,target_root);
 
-   source_work_hdr = source_root;
-   for (source_height = source_root->t_ntype.t_root.t_height;
-        source_height;
-        source_height--) {
+   return;
 
-      /* if we're missing a header record, break */
+}
 
-      if (source_work_hdr->t_child[0].t_header == NULL)
-         break;
+/*\
+ *  \function{tuple\_multiply()}
+ *
+ *  This function concatenates copies of a tuple.  We pack the result if
+ *  it is long enough and the elements are all short integers or all
+ *  reals, as in \verb"n * [0.0]".
+\*/
 
-      /* otherwise move down */
+void tuple_multiply(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* target operand                    */
+   specifier *left,                    /* left operand                      */
+   int32 copies)                       /* integer copies                    */
 
-      source_work_hdr = source_work_hdr->t_child[0].t_header;
+{
+tuple_h_ptr_type source_root;          /* tuple to be copied                */
+tuple_h_ptr_type target_root;          /* result tuple                      */
+int packing;                           /* storage form of result            */
+
+   source_root = spec_val(left,sp_tuple_ptr);
+
+   packing = source_root->t_packing;
+   if (packing == TUP_CHUNKS)
+      packing = TUP_CELLS;
+   else if (packing == TUP_CELLS && copies > 0 &&
+       source_root->t_length * copies >= TUP_PACK_MIN)
+      packing = uniform_packing(&(source_root->t_cells[0].t_spec),
+                                (int32)sizeof(struct tuple_c_item),
+                                source_root->t_length);
+
+   target_root = new_tuple(SETL_SYSTEM_VOID);
+   if (copies > 0) {
+
+      if (packing != TUP_CELLS)
+         start_packed(SETL_SYSTEM target_root,packing,
+                      source_root->t_length * copies);
+      else
+         reserve_tuple(target_root,source_root->t_length * copies);
 
    }
 
-   /* set the extracted element */
+   while (copies-- > 0)
+      append_elements(target_root,source_root,0,source_root->t_length);
 
-   if (!source_height) {
-      source_cell = source_work_hdr->t_child[0].t_cell;
-      source_number = 0;
-      source_index = 1;
-   }
-   else {
-      source_cell = NULL;
-      source_number = -1;
-      source_index = 0;
-   }
-
-   if (source_cell != NULL) {
+   /* finally, we set the target value */
 
-      mark_specifier(&(source_cell->t_spec));
-      unmark_specifier(left);
-      left->sp_form = source_cell->t_spec.sp_form;
-      left->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
-      target_root->t_hash_code ^= source_cell->t_hash_code;
+   unmark_specifier(target);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,target_root);
 
-   }
-   else {
+   return;
 
-      unmark_specifier(left);
-      left->sp_form = ft_omega;
+}
 
-   }
+/*\
+ *  \function{tuple\_slice()}
+ *
+ *  This function produces a {\em slice} of a tuple.  The caller has
+ *  checked the limits, so we just copy that range of cells.  Since the
+ *  slice need not end where the tuple does, we strip off trailing
+ *  omegas.  Slices of packed tuples are packed.
+\*/
 
-   /* loop over the elements of source */
+void tuple_slice(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* target operand                    */
+   specifier *source,                  /* left operand                      */
+   int32 start_index,                  /* start index of slice              */
+   int32 end_index)                    /* end index of slice                */
 
-   for (;;) {
+{
+tuple_h_ptr_type source_root;          /* tuple to be sliced                */
+tuple_h_ptr_type target_root;          /* result tuple                      */
 
-      /* find the next element in the tuple */
+   source_root = spec_val(source,sp_tuple_ptr);
 
-      source_element = NULL;
-      for (;;) {
+   target_root = new_tuple(SETL_SYSTEM_VOID);
+   if (end_index >= start_index) {
 
-         /* if we have an element already, return it */
+      if (is_packed(source_root))
+         start_packed(SETL_SYSTEM target_root,source_root->t_packing,
+                      end_index - start_index + 1);
+      else
+         reserve_tuple(target_root,end_index - start_index + 1);
+      append_elements(target_root,source_root,start_index - 1,
+                      end_index - start_index + 1);
+      trim_tuple(target_root);
 
-         if (!source_height && source_index < TUP_HEADER_SIZE) {
+   }
 
-            if (source_work_hdr->t_child[source_index].t_cell == NULL) {
+   /* finally, we set the target value */
 
-               source_number++;
-               source_index++;
+   unmark_specifier(target);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,target_root);
 
-               continue;
+   return;
 
-            }
+}
 
-            /* we do have an element from source */
+/*\
+ *  \function{tuple\_sslice()}
+ *
+ *  This function assigns a tuple to a slice of a tuple.  If nobody else
+ *  holds the target we splice the source into it, moving the tail of
+ *  the target as a block.  Otherwise we build a new tuple from the head
+ *  of the target, the source and the tail of the target.  A packed
+ *  target stays packed only if the source is packed the same way, or
+ *  empty, and a chunked target is unpacked.
+\*/
 
-            source_cell = source_work_hdr->t_child[source_index].t_cell;
-            source_element = &(source_cell->t_spec);
-            source_hash_code = source_cell->t_hash_code;
+void tuple_sslice(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* target operand                    */
+   specifier *source,                  /* left operand                      */
+   int32 start_index,                  /* start index of slice              */
+   int32 end_index)                    /* end index of slice                */
 
-            source_number++;
-            source_index++;
+{
+tuple_h_ptr_type source_root;          /* tuple to be inserted              */
+tuple_h_ptr_type target_root;          /* tuple assigned into               */
+tuple_h_ptr_type new_root;             /* result tuple, if we copy          */
+tuple_c_ptr_type tuple_cell;           /* used to loop over replaced cells  */
+int32 tail_length;                     /* elements after the slice          */
+int32 i;                               /* temporary looping variable        */
 
-            break;
+   /* our indices are zero-based */
 
-         }
+   start_index--;
 
-         /* move up if we're at the end of a node */
+   source_root = spec_val(source,sp_tuple_ptr);
+   target_root = spec_val(target,sp_tuple_ptr);
+   tail_length = target_root->t_length - end_index;
 
-         if (source_index >= TUP_HEADER_SIZE) {
+   if (target_root->t_packing == TUP_CHUNKS ||
+       (source_root->t_length > 0 &&
+        source_root->t_packing != target_root->t_packing))
+      unpack_tuple(target_root);
 
-            /* break if we've exhausted the source */
+   if (target_root->t_use_count == 1 && target_root != source_root) {
 
-            if (source_work_hdr == source_root)
-               break;
+      /* release the replaced elements */
 
-            source_height++;
-            source_index =
-               source_work_hdr->t_ntype.t_intern.t_child_index + 1;
-            source_work_hdr =
-               source_work_hdr->t_ntype.t_intern.t_parent;
+      if (target_root->t_packing != TUP_CELLS) {
 
-            continue;
+         for (i = start_index; i < end_index; i++)
+            target_root->t_hash_code ^= packed_hash_code(target_root,i);
 
-         }
+      }
+      else {
 
-         /* skip over null nodes */
+         for (tuple_cell = target_root->t_cells + start_index;
+              tuple_cell < target_root->t_cells + end_index;
+              tuple_cell++) {
 
-         if (source_work_hdr->t_child[source_index].t_header == NULL) {
+            target_root->t_hash_code ^= tuple_cell->t_hash_code;
+            unmark_specifier(&(tuple_cell->t_spec));
 
-            source_number += 1L << (source_height * TUP_SHIFT_DIST);
-            source_index++;
+         }
+      }
 
-            continue;
+      /* move the tail to its new position */
+
+      reserve_tuple(target_root,
+                    start_index + source_root->t_length + tail_length);
+      if (target_root->t_packing != TUP_CELLS)
+         memmove((void *)((char *)(target_root->t_packed.t_shorts) +
+                          (start_index + source_root->t_length) *
+                             packed_size(target_root)),
+                 (void *)((char *)(target_root->t_packed.t_shorts) +
+                          end_index * packed_size(target_root)),
+                 (size_t)(tail_length * packed_size(target_root)));
+      else
+         memmove((void *)(target_root->t_cells + start_index +
+                          source_root->t_length),
+                 (void *)(target_root->t_cells + end_index),
+                 (size_t)(tail_length * sizeof(struct tuple_c_item)));
+
+      /* copy in the source, then account for the tail */
+
+      target_root->t_length = start_index;
+      append_elements(target_root,source_root,0,source_root->t_length);
+      target_root->t_length += tail_length;
+      trim_tuple(target_root);
 
-         }
+      return;
 
-         /* otherwise drop down a level */
+   }
 
-         source_work_hdr = source_work_hdr->t_child[source_index].t_header;
-         source_index = 0;
-         source_height--;
+   new_root = new_tuple(SETL_SYSTEM_VOID);
+   if (target_root->t_packing != TUP_CELLS)
+      start_packed(SETL_SYSTEM new_root,target_root->t_packing,
+                   start_index + source_root->t_length + tail_length);
+   else
+      reserve_tuple(new_root,
+                    start_index + source_root->t_length + tail_length);
+   append_elements(new_root,target_root,0,start_index);
+   append_elements(new_root,source_root,0,source_root->t_length);
+   append_elements(new_root,target_root,end_index,tail_length);
+   trim_tuple(new_root);
 
-      }
+   /* finally, we set the target value */
 
-      if (source_element == NULL)
-         break;
+   unmark_specifier(target);
+   spec_set_form(target,ft_tuple);
+   spec_set_val(target,sp_tuple_ptr,new_root);
 
-      /*
-       *  At this point we have an element of the source in
-       *  source_element.  We insert it into the target.
-       */
+   return;
 
-      target_number = source_number - 1;
+}
 
-      /* we don't insert omegas */
+/*\
+ *  \function{tuple\_fromb()}
+ *
+ *  This functions implements the SETL2 \verb"FROMB" operation.  Notice
+ *  that all three operands may be modified.
+\*/
 
-      if (source_element->sp_form == ft_omega)
-         continue;
+void tuple_fromb(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* target operand                    */
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-      /* descend the header tree until we get to a leaf */
+{
+tuple_h_ptr_type source_root;          /* tuple we remove from              */
+tuple_h_ptr_type target_root;          /* tuple after removal               */
+struct tuple_c_item first_cell;        /* removed element                   */
 
-      target_work_hdr = target_root;
-      for (target_height = target_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
+   source_root = spec_val(right,sp_tuple_ptr);
 
-         /* extract the element's index at this level */
+   /* if the source tuple is empty, return omega */
 
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
+   if (source_root->t_length == 0) {
 
-         /* if we're missing a header record, allocate one */
+      unmark_specifier(left);
+      spec_set_form(left,ft_omega);
 
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
+      if (target != NULL) {
+         unmark_specifier(target);
+         spec_set_form(target,ft_omega);
+      }
 
-            get_tuple_header(new_hdr);
-            new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-            new_hdr->t_ntype.t_intern.t_child_index = target_index;
+      return;
 
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_hdr->t_child[i++].t_cell = NULL);
+   }
 
-            target_work_hdr->t_child[target_index].t_header = new_hdr;
-            target_work_hdr = new_hdr;
+   /*
+    *  We would like to use the right operand destructively if possible,
+    *  sliding the remaining elements down.
+    */
 
-         }
-         else {
+   if (is_packed(source_root)) {
+      get_packed_element(source_root,0,&first_cell.t_spec);
+      first_cell.t_hash_code = packed_hash_code(source_root,0);
+   }
+   else {
+      first_cell = *tuple_cell_at(source_root,0);
+   }
 
-            target_work_hdr =
-               target_work_hdr->t_child[target_index].t_header;
+   if (right == target || right == left ||
+       source_root->t_use_count != 1) {
 
-         }
-      }
+      target_root = new_tuple(SETL_SYSTEM_VOID);
+      if (is_packed(source_root))
+         start_packed(SETL_SYSTEM target_root,source_root->t_packing,
+                      source_root->t_length - 1);
+      else
+         reserve_tuple(target_root,source_root->t_length - 1);
+      append_elements(target_root,source_root,1,source_root->t_length - 1);
+      mark_specifier(&(first_cell.t_spec));
 
-      /*
-       *  At this point, target_work_hdr points to the lowest level header
-       *  record.  We insert the new element in the appropriate slot.
-       */
+   }
+   else {
 
-      mark_specifier(source_element);
-      get_tuple_cell(new_cell);
-      new_cell->t_spec.sp_form = source_element->sp_form;
-      new_cell->t_spec.sp_val.sp_biggest =
-         source_element->sp_val.sp_biggest;
-      new_cell->t_hash_code = source_hash_code;
-      target_index = target_number & TUP_SHIFT_MASK;
-      target_work_hdr->t_child[target_index].t_cell = new_cell;
+      target_root = source_root;
+      spec_set_form(right,ft_omega);
+      if (target_root->t_packing == TUP_CHUNKS)
+         unpack_tuple_cells(SETL_SYSTEM target_root);
+      target_root->t_length--;
+      if (target_root->t_packing != TUP_CELLS)
+         memmove((void *)(target_root->t_packed.t_shorts),
+                 (void *)((char *)(target_root->t_packed.t_shorts) +
+                          packed_size(target_root)),
+                 (size_t)(target_root->t_length *
+                          packed_size(target_root)));
+      else
+         memmove((void *)(target_root->t_cells),
+                 (void *)(target_root->t_cells + 1),
+                 (size_t)(target_root->t_length *
+                          sizeof(struct tuple_c_item)));
+      target_root->t_hash_code ^= first_cell.t_hash_code;
 
    }
 
-   /* set the other target values */
+   /* the removed element goes to the left operand */
+
+   unmark_specifier(left);
+   spec_set_form(left,spec_form(&first_cell.t_spec));
+   spec_set_val(left,sp_biggest,spec_val(&first_cell.t_spec,sp_biggest));
 
    unmark_specifier(right);
-   right->sp_form = ft_tuple;
-   right->sp_val.sp_tuple_ptr = target_root;
+   spec_set_form(right,ft_tuple);
+   spec_set_val(right,sp_tuple_ptr,target_root);
 
    if (target != NULL) {
-
       mark_specifier(left);
       unmark_specifier(target);
-      target->sp_form = left->sp_form;
-      target->sp_val.sp_biggest = left->sp_val.sp_biggest;
-
+      spec_set_form(target,spec_form(left));
+      spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
    }
 
    return;
@@ -2415,27 +1535,22 @@ void tuple_frome(
    specifier *right)                   /* right operand                     */
 
 {
-tuple_h_ptr_type target_root, target_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type target_cell;          /* current cell pointer              */
-int target_height, target_index;       /* current height and index          */
-int32 target_number;                   /* target element number             */
-tuple_h_ptr_type new_hdr;              /* created header record pointer     */
-int i;                                 /* temporary looping variable        */
+tuple_h_ptr_type target_root;          /* tuple we remove from              */
+tuple_c_ptr_type target_cell;          /* removed element                   */
+struct tuple_c_item last_cell;         /* removed packed element            */
 
-   /* if the source set is empty, return omega */
+   target_root = spec_val(right,sp_tuple_ptr);
 
-   target_root = right->sp_val.sp_tuple_ptr;
-   if (target_root->t_ntype.t_root.t_length == 0) {
+   /* if the source tuple is empty, return omega */
+
+   if (target_root->t_length == 0) {
 
       unmark_specifier(left);
-      left->sp_form = ft_omega;
+      spec_set_form(left,ft_omega);
 
       if (target != NULL) {
-
          unmark_specifier(target);
-         target->sp_form = ft_omega;
-
+         spec_set_form(target,ft_omega);
       }
 
       return;
@@ -2448,212 +1563,43 @@ int i;                                 /* temporary looping variable        */
 
    if (right == target || right == left ||
        target_root->t_use_count != 1) {
-
-      target_root = copy_tuple(SETL_SYSTEM right->sp_val.sp_tuple_ptr);
-
+      target_root = copy_tuple(SETL_SYSTEM spec_val(right,sp_tuple_ptr));
    }
    else {
-
-      right->sp_form = ft_omega;
-
+      spec_set_form(right,ft_omega);
    }
 
-   /* try to go down to the appropriate leaf */
-
-   target_number = target_root->t_ntype.t_root.t_length - 1;
-   target_work_hdr = target_root;
-   for (target_height = target_root->t_ntype.t_root.t_height;
-        target_height;
-        target_height--) {
-
-      /* extract the element's index at this level */
-
-      target_index = (target_number >>
-                           (target_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
-
-#ifdef TRAPS
-
-      /* we shouldn't be missing any header records */
+   /* take the last element, then strip any omegas it leaves exposed */
 
-      if (target_work_hdr->t_child[target_index].t_header == NULL)
-         trap(__FILE__,__LINE__,msg_missing_tup_header);
-
-#endif
-
-      /* move down */
-
-      target_work_hdr = target_work_hdr->t_child[target_index].t_header;
+   if (target_root->t_packing == TUP_CHUNKS)
+      unpack_tuple_cells(SETL_SYSTEM target_root);
 
+   if (target_root->t_packing != TUP_CELLS) {
+      target_cell = &last_cell;
+      get_packed_element(target_root,--target_root->t_length,
+                         &target_cell->t_spec);
+      target_cell->t_hash_code =
+         packed_hash_code(target_root,target_root->t_length);
+   }
+   else {
+      target_cell = target_root->t_cells + --target_root->t_length;
    }
-
-   /* set the left target, and remove the last cell */
-
-   target_index = target_number & TUP_SHIFT_MASK;
-   target_cell = target_work_hdr->t_child[target_index].t_cell;
-   target_work_hdr->t_child[target_index].t_cell = NULL;
    target_root->t_hash_code ^= target_cell->t_hash_code;
-   target_root->t_ntype.t_root.t_length--;
+   trim_tuple(target_root);
 
    unmark_specifier(left);
-   left->sp_form = target_cell->t_spec.sp_form;
-   left->sp_val.sp_biggest = target_cell->t_spec.sp_val.sp_biggest;
-   free_tuple_cell(target_cell);
-
-   /*
-    *  We now need to strip any trailing omegas from the tuple.
-    */
-
-   /* if the length is zero, don't try this */
-
-   if (target_root->t_ntype.t_root.t_length != 0) {
-
-      /* drop to a leaf at the rightmost position */
-
-      target_number = target_root->t_ntype.t_root.t_length - 1;
-      target_work_hdr = target_root;
-      for (target_height = target_root->t_ntype.t_root.t_height;
-           target_height;
-           target_height--) {
-
-         /* extract the element's index at this level */
-
-         target_index = (target_number >>
-                              (target_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-            get_tuple_header(new_hdr);
-            new_hdr->t_ntype.t_intern.t_parent = target_work_hdr;
-            new_hdr->t_ntype.t_intern.t_child_index = target_index;
-
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_hdr->t_child[i++].t_cell = NULL);
-
-            target_work_hdr->t_child[target_index].t_header = new_hdr;
-            target_work_hdr = new_hdr;
-
-         }
-         else {
-
-            target_work_hdr =
-               target_work_hdr->t_child[target_index].t_header;
-
-         }
-      }
-
-      /* set the target index to the last element */
-
-      target_index = target_number & TUP_SHIFT_MASK;
-
-      /* keep stripping omegas */
-
-      for (;;) {
-
-         if (!target_height && target_index >= 0) {
-
-            if (target_work_hdr->t_child[target_index].t_cell != NULL)
-               break;
-
-            target_root->t_ntype.t_root.t_length--;
-            target_index--;
-
-            continue;
-
-         }
-
-         /* move up if we're at the end of a node */
-
-         if (target_index < 0) {
-
-            if (target_work_hdr == target_root)
-               break;
-
-            target_height++;
-            target_index = target_work_hdr->t_ntype.t_intern.t_child_index;
-            target_work_hdr = target_work_hdr->t_ntype.t_intern.t_parent;
-            free_tuple_header(
-                  target_work_hdr->t_child[target_index].t_header);
-            target_work_hdr->t_child[target_index].t_header = NULL;
-            target_index--;
-
-            continue;
-
-         }
-
-         /* skip over null nodes */
-
-         if (target_work_hdr->t_child[target_index].t_header == NULL) {
-
-            target_root->t_ntype.t_root.t_length -=
-                  1L << (target_height * TUP_SHIFT_DIST);
-            target_index--;
-
-            continue;
-
-         }
-
-         /* otherwise drop down a level */
-
-         target_work_hdr =
-            target_work_hdr->t_child[target_index].t_header;
-         target_index = TUP_HEADER_SIZE - 1;
-
-         target_height--;
-
-      }
-
-      /* we've shortened the tuple -- now reduce the height */
-
-      while (target_root->t_ntype.t_root.t_height > 0 &&
-             target_root->t_ntype.t_root.t_length <=
-                (int32)(1L << (target_root->t_ntype.t_root.t_height *
-                              TUP_SHIFT_DIST))) {
-
-         target_work_hdr = target_root->t_child[0].t_header;
-
-         /* it's possible that we deleted internal headers */
-
-         if (target_work_hdr == NULL) {
-
-            target_root->t_ntype.t_root.t_height--;
-            continue;
-
-         }
-
-         /* delete the root node */
-
-         target_work_hdr->t_use_count = target_root->t_use_count;
-         target_work_hdr->t_hash_code =
-               target_root->t_hash_code;
-         target_work_hdr->t_ntype.t_root.t_length =
-               target_root->t_ntype.t_root.t_length;
-         target_work_hdr->t_ntype.t_root.t_height =
-               target_root->t_ntype.t_root.t_height - 1;
-
-         free_tuple_header(target_root);
-         target_root = target_work_hdr;
-
-      }
-   }
-
-   /* set the other target values */
+   spec_set_form(left,spec_form(&target_cell->t_spec));
+   spec_set_val(left,sp_biggest,spec_val(&target_cell->t_spec,sp_biggest));
 
    unmark_specifier(right);
-   right->sp_form = ft_tuple;
-   right->sp_val.sp_tuple_ptr = target_root;
+   spec_set_form(right,ft_tuple);
+   spec_set_val(right,sp_tuple_ptr,target_root);
 
    if (target != NULL) {
-
       mark_specifier(left);
       unmark_specifier(target);
-      target->sp_form = left->sp_form;
-      target->sp_val.sp_biggest = left->sp_val.sp_biggest;
-
+      spec_set_form(target,spec_form(left));
+      spec_set_val(target,sp_biggest,spec_val(left,sp_biggest));
    }
 
    return;
@@ -2663,7 +1609,8 @@ int i;                                 /* temporary looping variable        */
 /*\
  *  \function{tuple\_arb()}
  *
- *  This functions implements the SETL2 \verb"ARB" operation.
+ *  This functions implements the SETL2 \verb"ARB" operation.  We return
+ *  the last element, which is never omega.
 \*/
 
 void tuple_arb(
@@ -2672,62 +1619,39 @@ void tuple_arb(
    specifier *source)                  /* source tuple                      */
 
 {
-tuple_h_ptr_type source_root, source_work_hdr;
-                                       /* root and internal node pointers   */
-tuple_c_ptr_type source_cell;          /* current cell pointer              */
-int source_height, source_index;       /* current height and index          */
-int32 source_number;                   /* source element number             */
+tuple_h_ptr_type source_root;          /* source tuple                      */
+tuple_c_ptr_type source_cell;          /* returned element                  */
 
-   /* if the source set is empty, return omega */
+   /* if the source tuple is empty, return omega */
 
-   source_root = source->sp_val.sp_tuple_ptr;
-   if (source_root->t_ntype.t_root.t_length == 0) {
+   source_root = spec_val(source,sp_tuple_ptr);
+   if (source_root->t_length == 0) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
       return;
 
    }
 
-   /* go down to the appropriate leaf */
-
-   source_number = source_root->t_ntype.t_root.t_length - 1;
-   source_work_hdr = source_root;
-   for (source_height = source_root->t_ntype.t_root.t_height;
-        source_height;
-        source_height--) {
-
-      /* extract the element's index at this level */
+   /* packed elements need no hold */
 
-      source_index = (source_number >>
-                           (source_height * TUP_SHIFT_DIST)) &
-                        TUP_SHIFT_MASK;
+   if (is_packed(source_root)) {
 
-#ifdef TRAPS
-
-      /* we shouldn't be missing any header records */
-
-      if (source_work_hdr->t_child[source_index].t_header == NULL)
-         trap(__FILE__,__LINE__,msg_missing_tup_header);
-
-#endif
-
-      /* move down */
+      unmark_specifier(target);
+      get_packed_element(source_root,source_root->t_length - 1,target);
 
-      source_work_hdr = source_work_hdr->t_child[source_index].t_header;
+      return;
 
    }
 
    /* set the target and return */
 
-   source_index = source_number & TUP_SHIFT_MASK;
-   source_cell = source_work_hdr->t_child[source_index].t_cell;
-
+   source_cell = tuple_cell_at(source_root,source_root->t_length - 1);
    mark_specifier(&(source_cell->t_spec));
    unmark_specifier(target);
-   target->sp_form = source_cell->t_spec.sp_form;
-   target->sp_val.sp_biggest = source_cell->t_spec.sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&source_cell->t_spec));
+   spec_set_val(target,sp_biggest,spec_val(&source_cell->t_spec,sp_biggest));
 
    return;
 
@@ -31,70 +31,121 @@
 /* SETL2 system header files */
 
 #include "specs.h"                     /* specifiers                        */
+#include "slabs.h"                     /* slabs                             */
 
 /* performance tuning constants */
 
-#define TUP_HEADER_SIZE    4           /* tuple header size (table)         */
-#define TUP_SHIFT_DIST     2           /* log (base 2) of TUP_HEADER_SIZE   */
-#define TUP_SHIFT_MASK  0x03           /* pick out one level of header tree */
+#define TUP_INLINE_CELLS   2           /* elements held in the header       */
+#define TUP_PACK_MIN       8           /* shortest tuple we build packed    */
+#define TUP_CHUNK_LOG      8           /* log2 of cells in a chunk          */
+#define TUP_BLOCK_LOG      16          /* log2 of cells in a block          */
+#define TUP_CHUNK_MIN      1024        /* shortest tuple we copy as chunks  */
+
+#define TUP_CHUNK_CELLS    (1 << TUP_CHUNK_LOG)
+#define TUP_BLOCK_CELLS    (1 << TUP_BLOCK_LOG)
+#define TUP_BLOCK_CHUNKS   (TUP_BLOCK_CELLS / TUP_CHUNK_CELLS)
+
+/*
+ *  The elements of a tuple are contiguous.  Short tuples keep them in the
+ *  header itself, longer ones in a separately allocated block, and either
+ *  way \verb"t_cells" points to them.  An omega element is a cell with an
+ *  omega specifier and a zero hash code, and the last element of a tuple
+ *  is never omega.
+ *
+ *  A tuple whose elements are all short integers or all reals may instead
+ *  be packed, holding bare values in a block at \verb"t_packed", with
+ *  \verb"t_cells" NULL.  Packed tuples have no omegas and no cell hash
+ *  codes.  Storing anything else in one unpacks it, and code which does
+ *  not handle packed tuples must call \verb"unpack_tuple()" before it
+ *  looks at the cells.
+ *
+ *  Copying a long tuple turns both the original and the copy into
+ *  chunked tuples.  A chunked tuple keeps its cells in fixed-size
+ *  chunks, the chunks in fixed-size blocks, and a list of blocks at
+ *  \verb"t_packed".  Blocks and chunks have use counts, so a copy only
+ *  copies the list of blocks, and storing into a tuple copies just the
+ *  block and chunk it changes if anyone else holds them.  An element is
+ *  still found with shifts and masks.  Chunked tuples are never shorter
+ *  than \verb"TUP_CHUNK_MIN".  Indexing, the iterators, element
+ *  assignment and \verb"with" use them as they are, and
+ *  \verb"unpack_tuple()" turns them back into cells for anything else.
+ */
+
+/* tuple storage forms */
+
+#define TUP_CELLS          0           /* specifier cells                   */
+#define TUP_SHORTS         1           /* packed short integers             */
+#define TUP_REALS          2           /* packed reals                      */
+#define TUP_CHUNKS         3           /* cells in shared chunks            */
+
+/* tuple cell structure */
+
+struct tuple_c_item {
+   int32 t_hash_code;                  /* full hash code of element         */
+   struct specifier_item t_spec;       /* tuple element specifier           */
+};
+
+typedef struct tuple_c_item *tuple_c_ptr_type;
+                                       /* cell pointer                      */
+
+/* tuple chunk structure */
+
+struct tuple_k_item {
+   int32 k_use_count;                  /* usage count                       */
+   struct tuple_c_item k_cells[TUP_CHUNK_CELLS];
+                                       /* elements in the chunk             */
+};
+
+typedef struct tuple_k_item *tuple_k_ptr_type;
+                                       /* chunk pointer                     */
 
-/* tuple header node structure */
+/* tuple block structure */
+
+struct tuple_b_item {
+   int32 b_use_count;                  /* usage count                       */
+   tuple_k_ptr_type b_chunks[TUP_BLOCK_CHUNKS];
+                                       /* chunks in the block               */
+};
+
+typedef struct tuple_b_item *tuple_b_ptr_type;
+                                       /* block pointer                     */
+
+/* tuple header structure */
 
 struct tuple_h_item {
    int32 t_use_count;                  /* usage count                       */
    int32 t_hash_code;                  /* hash code                         */
+   int32 t_length;                     /* number of elements in tuple       */
+   int32 t_capacity;                   /* elements we have room for         */
+   int t_packing;                      /* storage form                      */
+   struct tuple_c_item *t_cells;       /* tuple elements                    */
    union {
-      struct {                         /* root header info                  */
-         int32 t_length;               /* number of elements in tuple       */
-         int t_height;                 /* height of header tree             */
-      } t_root;
-      struct {                         /* internal node info                */
-         struct tuple_h_item *t_parent;
-                                       /* parent in header tree             */
-         int t_child_index;            /* index in parent's table           */
-      } t_intern;
-   } t_ntype;
-   union {
-      struct tuple_c_item *t_cell;     /* cell child pointer                */
-      struct tuple_h_item *t_header;   /* internal header node pointer      */
-   } t_child[TUP_HEADER_SIZE];
+      int32 *t_shorts;                 /* packed short integers             */
+      double *t_reals;                 /* packed reals                      */
+      tuple_b_ptr_type *t_blocks;      /* blocks of chunked tuples          */
+   } t_packed;                         /* elements of packed tuples         */
+   struct tuple_c_item t_inline[TUP_INLINE_CELLS];
+                                       /* elements of short tuples          */
 };
 
 typedef struct tuple_h_item *tuple_h_ptr_type;
                                        /* header node pointer               */
 
-/* tuple cell node structure */
-
-struct tuple_c_item {
-   int32 t_hash_code;                  /* full hash code of element         */
-   struct specifier_item t_spec;       /* tuple element specifier           */
-};
-
-typedef struct tuple_c_item *tuple_c_ptr_type;
-                                       /* cell node pointer                 */
-
 /* global data */
 
 #ifdef TSAFE
-#define TUPLE_H_NEXT_FREE plugin_instance->tuple_h_next_free 
-#define TUPLE_C_NEXT_FREE plugin_instance->tuple_c_next_free 
+#define TUPLE_H_SLAB plugin_instance->tuple_h_slab
 #else
-#define TUPLE_H_NEXT_FREE tuple_h_next_free 
-#define TUPLE_C_NEXT_FREE tuple_c_next_free 
+#define TUPLE_H_SLAB tuple_h_slab
 
 #ifdef SHARED
 
-tuple_h_ptr_type tuple_h_next_free = NULL;
-                                       /* next free header                  */
-tuple_c_ptr_type tuple_c_next_free = NULL;
-                                       /* next free cell                    */
+struct slab_class_item tuple_h_slab;   /* header slabs                      */
 
 #else
 
-extern tuple_h_ptr_type tuple_h_next_free;
-                                       /* next free header                  */
-extern tuple_c_ptr_type tuple_c_next_free;
-                                       /* next free cell                    */
+extern struct slab_class_item tuple_h_slab;
+                                       /* header slabs                      */
 
 #endif
 #endif
@@ -111,52 +162,112 @@ extern tuple_c_ptr_type tuple_c_next_free;
 
 #define free_tuple_header(s) free(s)
 
-#define get_tuple_cell(t) {\
-   t = (tuple_c_ptr_type)malloc(sizeof(struct tuple_c_item));\
-   if (t == NULL)\
-      giveup(SETL_SYSTEM msg_malloc_error);\
-}
+#else
 
-#define free_tuple_cell(s) free(s)
+#define get_tuple_header(t) \
+   slab_get(TUPLE_H_SLAB,"tuple header",tuple_h_ptr_type,t,\
+            sizeof(struct tuple_h_item))
 
-#else
+#define free_tuple_header(s) slab_put(s)
 
-#define get_tuple_header(t) {\
-   if (TUPLE_H_NEXT_FREE == NULL) alloc_tuple_headers(SETL_SYSTEM_VOID); \
-   t = TUPLE_H_NEXT_FREE; \
-   TUPLE_H_NEXT_FREE = *((tuple_h_ptr_type *)(TUPLE_H_NEXT_FREE)); \
+#endif
+
+/* make room for a longer tuple, keeping the elements we have */
+
+#define reserve_tuple(h,n) {\
+   if ((n) > (h)->t_capacity) grow_tuple(SETL_SYSTEM h,n); \
 }
 
-#define free_tuple_header(s) {\
-   *((tuple_h_ptr_type *)(s)) = TUPLE_H_NEXT_FREE; \
-   TUPLE_H_NEXT_FREE = s; \
+/* convert a packed or chunked tuple to cells */
+
+#define unpack_tuple(h) {\
+   if ((h)->t_packing != TUP_CELLS) unpack_tuple_cells(SETL_SYSTEM h); \
 }
 
-/* allocate and free cell nodes */
+/* is a tuple packed, rather than cells or chunks? */
+
+#define is_packed(h) \
+   ((h)->t_packing == TUP_SHORTS || (h)->t_packing == TUP_REALS)
+
+/* the chunk holding element i of a chunked tuple */
 
-#define get_tuple_cell(t) {\
-   if (TUPLE_C_NEXT_FREE == NULL) alloc_tuple_cells(SETL_SYSTEM_VOID); \
-   t = TUPLE_C_NEXT_FREE; \
-   TUPLE_C_NEXT_FREE = *((tuple_c_ptr_type *)(TUPLE_C_NEXT_FREE)); \
+#define tuple_chunk_at(h,i) \
+   ((h)->t_packed.t_blocks[(i) >> TUP_BLOCK_LOG]-> \
+       b_chunks[((i) & (TUP_BLOCK_CELLS - 1)) >> TUP_CHUNK_LOG])
+
+/* the cell holding element i of a tuple of cells or chunks */
+
+#define tuple_cell_at(h,i) \
+   ((h)->t_packing == TUP_CHUNKS ? \
+    tuple_chunk_at(h,i)->k_cells + ((i) & (TUP_CHUNK_CELLS - 1)) : \
+    (h)->t_cells + (i))
+
+/* copy element i of a packed tuple to a specifier */
+
+#define get_packed_element(h,i,s) {\
+   if ((h)->t_packing == TUP_SHORTS) { \
+      spec_set_form(s,ft_short); \
+      spec_set_val(s,sp_short_value,(h)->t_packed.t_shorts[i]); \
+   } \
+   else { \
+      spec_set_form(s,ft_real); \
+      spec_set_val(s,sp_real_value,(h)->t_packed.t_reals[i]); \
+   } \
 }
 
-#define free_tuple_cell(s) {\
-   *((tuple_c_ptr_type *)(s)) = TUPLE_C_NEXT_FREE; \
-   TUPLE_C_NEXT_FREE = s; \
+/* bytes in a packed element */
+
+#define packed_size(h) \
+   ((h)->t_packing == TUP_SHORTS ? sizeof(int32) : sizeof(double))
+
+/* does a specifier fit in a packed tuple? */
+
+#define packs_into(h,s) \
+   (spec_form(s) == ((h)->t_packing == TUP_SHORTS ? ft_short : ft_real))
+
+/* lengthen a tuple to n elements, padding with omega */
+
+#define extend_tuple(h,n) {\
+   unpack_tuple(h); \
+   reserve_tuple(h,n); \
+   while ((h)->t_length < (n)) { \
+      (h)->t_cells[(h)->t_length].t_hash_code = 0; \
+      spec_set_form(&(h)->t_cells[(h)->t_length++].t_spec,ft_omega); \
+   } \
 }
 
-#endif
+/* strip omegas from the end of a tuple */
+
+#define trim_tuple(h) {\
+   while ((h)->t_packing == TUP_CELLS && (h)->t_length > 0 && \
+          spec_form(&(h)->t_cells[(h)->t_length - 1].t_spec) == ft_omega) \
+      (h)->t_length--; \
+}
 
 /* public function declarations */
 
-void alloc_tuple_headers(SETL_SYSTEM_PROTO_VOID);        
-                                       /* allocate a block of header nodes  */
-void alloc_tuple_cells(SETL_SYSTEM_PROTO_VOID);          
-                                       /* allocate a block of cell nodes    */
+void free_tuple(SETL_SYSTEM_PROTO tuple_h_ptr_type);
+                                       /* release a tuple                   */
+int release_tuple(SETL_SYSTEM_PROTO tuple_h_ptr_type, int32 *);
+                                       /* release some elements of a tuple  */
+void grow_tuple(SETL_SYSTEM_PROTO tuple_h_ptr_type, int32);
+                                       /* enlarge a tuple's cell block      */
 tuple_h_ptr_type copy_tuple(SETL_SYSTEM_PROTO tuple_h_ptr_type);
                                        /* copy a tuple structure            */
 tuple_h_ptr_type new_tuple(SETL_SYSTEM_PROTO_VOID);
                                        /* return a new tuple structure      */
+void start_packed(SETL_SYSTEM_PROTO tuple_h_ptr_type, int, int32);
+                                       /* make a new tuple packed           */
+void pack_tuple(SETL_SYSTEM_PROTO tuple_h_ptr_type);
+                                       /* pack a uniform numeric tuple      */
+void unpack_tuple_cells(SETL_SYSTEM_PROTO tuple_h_ptr_type);
+                                       /* convert a tuple to cells          */
+int uniform_packing(specifier *, int32, int32);
+                                       /* packed form for some specifiers   */
+int32 packed_hash_code(tuple_h_ptr_type, int32);
+                                       /* hash code of a packed element     */
+int store_packed(SETL_SYSTEM_PROTO tuple_h_ptr_type, int32, specifier *);
+                                       /* store into packed or chunks       */
 void tuple_concat(SETL_SYSTEM_PROTO struct specifier_item *, 
                   struct specifier_item *,
                   struct specifier_item *);
@@ -60,98 +60,78 @@ void setl2_type(
 
 {
 string_h_ptr_type string_hdr;          /* string header pointer             */
-string_c_ptr_type string_cell;         /* string cell pointer               */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
-char *p;                               /* temporary looping variable        */
+char *type_name;                       /* name of argument's type           */
 static object_h_ptr_type object_root;  /* object header pointer             */
 static unittab_ptr_type class_ptr;     /* class pointer                     */
 
    /* omega returns om */
 
-   if (argv[0].sp_form == ft_omega) {
+   if (spec_form(&argv[0]) == ft_omega) {
 
       unmark_specifier(target);
-      target->sp_form = ft_omega;
+      spec_set_form(target,ft_omega);
 
       return;
 
    }
 
-   /* create a string */
+   /* we find the text of the string */
 
-   get_string_header(string_hdr);
-   string_hdr->s_use_count = 1;
-   string_hdr->s_hash_code = -1;
-   get_string_cell(string_cell);
-   string_cell->s_next = string_cell->s_prev = NULL;
-   string_hdr->s_head = string_hdr->s_tail = string_cell;
+   type_name = "";
 
-   /*
-    *  We set the text of the string.  Note that all of these character
-    *  strings will fit in a single cell.
-    */
-
-   switch (argv[0].sp_form) {
+   switch (spec_form(&argv[0])) {
 
       case ft_atom :
 
-         if (argv[0].sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num ||
-             argv[0].sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num) {
+         if (spec_val(&argv[0],sp_atom_num) ==
+                spec_val(spec_true,sp_atom_num) ||
+             spec_val(&argv[0],sp_atom_num) ==
+                spec_val(spec_false,sp_atom_num)) {
 
-            strcpy(string_cell->s_cell_value,"BOOLEAN");
+            type_name = "BOOLEAN";
 
          }
          else {
 
-            strcpy(string_cell->s_cell_value,"ATOM");
+            type_name = "ATOM";
 
          }
 
-         string_hdr->s_length = strlen(string_cell->s_cell_value);
-
          break;
 
       case ft_short :         case ft_long :
 
-         strcpy(string_cell->s_cell_value,"INTEGER");
-         string_hdr->s_length = strlen(string_cell->s_cell_value);
+         type_name = "INTEGER";
          break;
 
       case ft_real :
 
-         strcpy(string_cell->s_cell_value,"REAL");
-         string_hdr->s_length = strlen(string_cell->s_cell_value);
+         type_name = "REAL";
          break;
 
       case ft_string :
 
-         strcpy(string_cell->s_cell_value,"STRING");
-         string_hdr->s_length = strlen(string_cell->s_cell_value);
+         type_name = "STRING";
          break;
 
       case ft_set :           case ft_map :
 
-         strcpy(string_cell->s_cell_value,"SET");
-         string_hdr->s_length = strlen(string_cell->s_cell_value);
+         type_name = "SET";
          break;
 
       case ft_tuple :
 
-         strcpy(string_cell->s_cell_value,"TUPLE");
-         string_hdr->s_length = strlen(string_cell->s_cell_value);
+         type_name = "TUPLE";
          break;
 
       case ft_proc :
 
-         strcpy(string_cell->s_cell_value,"PROCEDURE");
-         string_hdr->s_length = strlen(string_cell->s_cell_value);
+         type_name = "PROCEDURE";
          break;
 
       case ft_mailbox :
 
-         strcpy(string_cell->s_cell_value,"MAILBOX");
-         string_hdr->s_length = strlen(string_cell->s_cell_value);
+         type_name = "MAILBOX";
          break;
 
       case ft_object :
@@ -159,45 +139,21 @@ static unittab_ptr_type class_ptr;     /* class pointer                     */
 
          /* pick out the object root and class */
 
-         object_root = argv[0].sp_val.sp_object_ptr;
+         object_root = spec_val(&argv[0],sp_object_ptr);
          class_ptr = object_root->o_ntype.o_root.o_class;
 
-         /* set up the target pointers */
-
-         target_char_ptr = string_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-         string_hdr->s_length = 0;
-
-         for (p = class_ptr->ut_name; *p; p++) {
-
-            if (target_char_ptr == target_char_end) {
-
-               get_string_cell(string_cell);
-               if (string_hdr->s_tail != NULL)
-                  (string_hdr->s_tail)->s_next = string_cell;
-               string_cell->s_prev = string_hdr->s_tail;
-               string_cell->s_next = NULL;
-               string_hdr->s_tail = string_cell;
-               if (string_hdr->s_head == NULL)
-                  string_hdr->s_head = string_cell;
-               target_char_ptr = string_cell->s_cell_value;
-               target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-            }
-
-            *target_char_ptr++ = *p;
-            string_hdr->s_length++;
-
-         }
+         type_name = class_ptr->ut_name;
 
    }
 
+   string_hdr = new_string(SETL_SYSTEM type_name);
+
    /* set the target and return */
 
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,string_hdr);
 
    return;
 
@@ -218,13 +174,13 @@ void setl2_is_atom(
 
 {
 
-   if (argv[0].sp_form == ft_atom &&
-       argv[0].sp_val.sp_atom_num != spec_true->sp_val.sp_atom_num &&
-       argv[0].sp_val.sp_atom_num != spec_false->sp_val.sp_atom_num) {
+   if (spec_form(&argv[0]) == ft_atom &&
+       spec_val(&argv[0],sp_atom_num) != spec_val(spec_true,sp_atom_num) &&
+       spec_val(&argv[0],sp_atom_num) != spec_val(spec_false,sp_atom_num)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
@@ -232,8 +188,8 @@ void setl2_is_atom(
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       return;
 
@@ -255,13 +211,13 @@ void setl2_is_boolean(
 
 {
 
-   if (argv[0].sp_form == ft_atom &&
-       (argv[0].sp_val.sp_atom_num == spec_true->sp_val.sp_atom_num ||
-        argv[0].sp_val.sp_atom_num == spec_false->sp_val.sp_atom_num)) {
+   if (spec_form(&argv[0]) == ft_atom &&
+       (spec_val(&argv[0],sp_atom_num) == spec_val(spec_true,sp_atom_num) ||
+        spec_val(&argv[0],sp_atom_num) == spec_val(spec_false,sp_atom_num))) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
@@ -269,8 +225,8 @@ void setl2_is_boolean(
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       return;
 
@@ -292,11 +248,11 @@ void setl2_is_integer(
 
 {
 
-   if (argv[0].sp_form == ft_short || argv[0].sp_form == ft_long) {
+   if (spec_form(&argv[0]) == ft_short || spec_form(&argv[0]) == ft_long) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
@@ -304,8 +260,8 @@ void setl2_is_integer(
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       return;
 
@@ -327,11 +283,11 @@ void setl2_is_real(
 
 {
 
-   if (argv[0].sp_form == ft_real) {
+   if (spec_form(&argv[0]) == ft_real) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
@@ -339,8 +295,8 @@ void setl2_is_real(
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       return;
 
@@ -362,11 +318,11 @@ void setl2_is_string(
 
 {
 
-   if (argv[0].sp_form == ft_string) {
+   if (spec_form(&argv[0]) == ft_string) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
@@ -374,8 +330,8 @@ void setl2_is_string(
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       return;
 
@@ -397,11 +353,11 @@ void setl2_is_set(
 
 {
 
-   if (argv[0].sp_form == ft_set || argv[0].sp_form == ft_map) {
+   if (spec_form(&argv[0]) == ft_set || spec_form(&argv[0]) == ft_map) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
@@ -409,8 +365,8 @@ void setl2_is_set(
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       return;
 
@@ -432,29 +388,29 @@ void setl2_is_map(
 
 {
 
-   if (argv[0].sp_form == ft_map) {
+   if (spec_form(&argv[0]) == ft_map) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
    }
 
-   if (argv[0].sp_form == ft_set && set_to_map(SETL_SYSTEM argv,argv,NO)) {
+   if (spec_form(&argv[0]) == ft_set && set_to_map(SETL_SYSTEM argv,argv,NO)) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
    }
 
    unmark_specifier(target);
-   target->sp_form = ft_atom;
-   target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+   spec_set_form(target,ft_atom);
+   spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
    return;
 
@@ -475,11 +431,11 @@ void setl2_is_tuple(
 
 {
 
-   if (argv[0].sp_form == ft_tuple) {
+   if (spec_form(&argv[0]) == ft_tuple) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
@@ -487,8 +443,8 @@ void setl2_is_tuple(
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       return;
 
@@ -510,11 +466,11 @@ void setl2_is_procedure(
 
 {
 
-   if (argv[0].sp_form == ft_proc) {
+   if (spec_form(&argv[0]) == ft_proc) {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_true->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_true,sp_atom_num));
 
       return;
 
@@ -522,8 +478,8 @@ void setl2_is_procedure(
    else {
 
       unmark_specifier(target);
-      target->sp_form = ft_atom;
-      target->sp_val.sp_atom_num = spec_false->sp_val.sp_atom_num;
+      spec_set_form(target,ft_atom);
+      spec_set_val(target,sp_atom_num,spec_val(spec_false,sp_atom_num));
 
       return;
 
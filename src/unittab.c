@@ -198,22 +198,22 @@ int i;                                 /* temporary looping variable        */
 
          case ft_omega :
 
-            (unittab_ptr->ut_data_ptr + i)->sp_form = ft_omega;
+            spec_set_form((unittab_ptr->ut_data_ptr + i),ft_omega);
 
             break;
 
          case ft_atom :
 
-            (unittab_ptr->ut_data_ptr + i)->sp_form = ft_atom;
+            spec_set_form((unittab_ptr->ut_data_ptr + i),ft_atom);
             setl2_newat(SETL_SYSTEM 0,NULL,unittab_ptr->ut_data_ptr + i);
 
             break;
 
          case ft_short :
 
-            (unittab_ptr->ut_data_ptr + i)->sp_form = ft_short;
-            (unittab_ptr->ut_data_ptr + i)->sp_val.sp_short_value =
-                  i_built_in_tab[i].bi_int_value;
+            spec_set_form((unittab_ptr->ut_data_ptr + i),ft_short);
+            spec_set_val((unittab_ptr->ut_data_ptr + i),sp_short_value,
+                  i_built_in_tab[i].bi_int_value);
 
             break;
 
@@ -224,10 +224,11 @@ int i;                                 /* temporary looping variable        */
             proc_ptr->p_func_ptr = i_built_in_tab[i].bi_func_ptr;
             proc_ptr->p_formal_count = i_built_in_tab[i].bi_formal_count;
             proc_ptr->p_var_args = i_built_in_tab[i].bi_var_args;
+            proc_ptr->p_side_effects = i_built_in_tab[i].bi_side_effects;
             proc_ptr->p_self_ptr = NULL;
             proc_ptr->p_use_count = 1;
-            (unittab_ptr->ut_data_ptr + i)->sp_form = ft_proc;
-            (unittab_ptr->ut_data_ptr + i)->sp_val.sp_proc_ptr = proc_ptr;
+            spec_set_form((unittab_ptr->ut_data_ptr + i),ft_proc);
+            spec_set_val((unittab_ptr->ut_data_ptr + i),sp_proc_ptr,proc_ptr);
 
             break;
 
@@ -236,38 +237,16 @@ int i;                                 /* temporary looping variable        */
 
    /* initialize the empty set and tuple */
 
-   spec_nullset->sp_form = ft_set;
-   get_set_header(spec_nullset->sp_val.sp_set_ptr);
-   (spec_nullset->sp_val.sp_set_ptr)->s_use_count = 1;
-   (spec_nullset->sp_val.sp_set_ptr)->s_hash_code = 0;
-   (spec_nullset->sp_val.sp_set_ptr)->s_ntype.s_root.s_cardinality = 0;
-   (spec_nullset->sp_val.sp_set_ptr)->s_ntype.s_root.s_height = 0;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        (spec_nullset->sp_val.sp_set_ptr)->s_child[i++].s_cell = NULL);
-
-   spec_nulltup->sp_form = ft_tuple;
-   get_tuple_header(spec_nulltup->sp_val.sp_tuple_ptr);
-   (spec_nulltup->sp_val.sp_tuple_ptr)->t_use_count = 1;
-   (spec_nulltup->sp_val.sp_tuple_ptr)->t_hash_code = 0;
-   (spec_nulltup->sp_val.sp_tuple_ptr)->t_ntype.t_root.t_length = 0;
-   (spec_nulltup->sp_val.sp_tuple_ptr)->t_ntype.t_root.t_height = 0;
-   for (i = 0;
-        i < TUP_HEADER_SIZE;
-        (spec_nulltup->sp_val.sp_tuple_ptr)->t_child[i++].t_cell = NULL);
+   spec_set_form(spec_nullset,ft_set);
+   spec_set_val(spec_nullset,sp_set_ptr,null_set(SETL_SYSTEM_VOID));
+
+   spec_set_form(spec_nulltup,ft_tuple);
+   spec_set_val(spec_nulltup,sp_tuple_ptr,new_tuple(SETL_SYSTEM_VOID));
 
    /* initialize _memory */
 
-   spec_memory->sp_form = ft_map;
-   get_map_header(spec_memory->sp_val.sp_map_ptr);
-   (spec_memory->sp_val.sp_map_ptr)->m_use_count = 1;
-   (spec_memory->sp_val.sp_map_ptr)->m_hash_code = 0;
-   (spec_memory->sp_val.sp_map_ptr)->m_ntype.m_root.m_cardinality = 0;
-   (spec_memory->sp_val.sp_map_ptr)->m_ntype.m_root.m_cell_count = 0;
-   (spec_memory->sp_val.sp_map_ptr)->m_ntype.m_root.m_height = 0;
-   for (i = 0;
-        i < SET_HASH_SIZE;
-        (spec_memory->sp_val.sp_map_ptr)->m_child[i++].m_cell = NULL);
+   spec_set_form(spec_memory,ft_map);
+   spec_set_val(spec_memory,sp_map_ptr,null_map(SETL_SYSTEM_VOID));
 
    return;
 
@@ -0,0 +1,1157 @@
+/*\
+ *
+ *  % MIT License
+ *  %
+ *  % Copyright (c) 1990 W. Kirk Snyder
+ *  %
+ *  % Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  % of this software and associated documentation files (the "Software"), to deal
+ *  % in the Software without restriction, including without limitation the rights
+ *  % to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  % copies of the Software, and to permit persons to whom the Software is
+ *  % furnished to do so, subject to the following conditions:
+ *  % 
+ *  % The above copyright notice and this permission notice shall be included in all
+ *  % copies or substantial portions of the Software.
+ *  %
+ *  % THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  % IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  % FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  % AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  % LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  % OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  % SOFTWARE.
+ *  %
+ *
+ *  \package{Workers}
+ *
+ *  This package runs SETL2 procedures in parallel, on separate
+ *  processors.  A SETL2 process shares its heap with every other process
+ *  in the interpreter, so we can not simply run processes on several
+ *  operating system threads.  Instead, a worker is a copy of the whole
+ *  interpreter, made by \verb"fork()", which calls one procedure and
+ *  sends the result back to us through a pipe in \verb"binstr" form.
+ *  Each worker has its own heap and its own allocator free lists, and
+ *  the argument and result are copies, so workers never share a node.
+ *
+ *  \texify{workers.h}
+ *
+ *  \packagebody{Workers}
+\*/
+
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
+#include <string.h>                    /* memcpy                            */
+
+/* SETL2 system header files */
+
+#include "system.h"                    /* SETL2 system constants            */
+#include "interp.h"                    /* SETL2 interpreter constants       */
+#include "giveup.h"                    /* severe error handler              */
+#include "messages.h"                  /* error messages                    */
+#include "form.h"                      /* form codes                        */
+#include "builtins.h"                  /* built-in symbols                  */
+#include "abend.h"                     /* abnormal end handler              */
+#include "specs.h"                     /* specifiers                        */
+#include "x_strngs.h"                  /* strings                           */
+#include "sets.h"                      /* sets                              */
+#include "maps.h"                      /* maps                              */
+#include "tuples.h"                    /* tuples                            */
+#include "procs.h"                     /* procedures                        */
+#include "objects.h"                   /* objects                           */
+#include "iters.h"                     /* iterators                         */
+#include "execute.h"                   /* core interpreter                  */
+#include "workers.h"                   /* workers                           */
+
+#if UNIX
+#include <errno.h>                     /* system error codes                */
+#include <unistd.h>                    /* fork, pipe and sysconf            */
+#include <sys/types.h>                 /* system types                      */
+#include <sys/wait.h>                  /* waitpid                           */
+#include <sys/mman.h>                  /* shared memory                     */
+#include <poll.h>                      /* waiting on several pipes          */
+#endif
+
+/* performance tuning constants */
+
+#define RESULT_BLOCK      65536        /* result buffer growth              */
+#define FORALL_PARTS          8        /* forall parts for each worker      */
+#define FORALL_MAX_PARTS   4096        /* most parts in one forall          */
+
+/*
+ *  The parts of a \verb"worker_forall" are shared out among its workers
+ *  in deques, one for each worker, kept in memory all the workers share.
+ *  A deque is one word holding the first part left in it and one past
+ *  the last, sixteen bits each.  A worker takes parts from the front of
+ *  its own deque, and when that is empty steals from the back of the
+ *  others, changing the whole word with a compare and swap, so no locks
+ *  are needed.  Without a compare and swap there is no stealing, and
+ *  each worker just runs the parts it was first given.
+ */
+
+#if (defined(__GNUC__) && __GNUC__ >= 4) || defined(__clang__)
+#define FORALL_STEAL 1
+#define deque_swap(d,o,n) __sync_bool_compare_and_swap(d,o,n)
+#endif
+
+#define deque_word(h,t)   (((unsigned int)(h) << 16) | (unsigned int)(t))
+#define deque_head(w)     ((int32)((w) >> 16))
+#define deque_tail(w)     ((int32)((w) & 0xffff))
+
+#if UNIX && !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#if UNIX
+
+/*\
+ *  \function{read\_worker()}
+ *
+ *  This function reads whatever a worker has written to its pipe so
+ *  far.  It returns \verb"NO" once the worker has closed its end.
+\*/
+
+static int read_worker(
+   SETL_SYSTEM_PROTO
+   worker_ptr_type worker_ptr)         /* worker to be read                 */
+
+{
+ssize_t count;                         /* characters read                   */
+
+   for (;;) {
+
+      if (worker_ptr->w_length == worker_ptr->w_size) {
+
+         worker_ptr->w_size += RESULT_BLOCK;
+         worker_ptr->w_result = (char *)realloc(worker_ptr->w_result,
+                                                (size_t)worker_ptr->w_size);
+         if (worker_ptr->w_result == NULL)
+            giveup(SETL_SYSTEM msg_malloc_error);
+
+      }
+
+      count = read(worker_ptr->w_fd,
+                   worker_ptr->w_result + worker_ptr->w_length,
+                   (size_t)(worker_ptr->w_size - worker_ptr->w_length));
+
+      if (count > 0) {
+         worker_ptr->w_length += (int32)count;
+         return YES;
+      }
+
+      if (count == 0 || errno != EINTR)
+         return NO;
+
+   }
+}
+
+/*\
+ *  \function{collect\_worker()}
+ *
+ *  This function reads a worker's result until the worker closes its
+ *  end of the pipe, then waits for it to exit and saves its status.
+\*/
+
+static void collect_worker(
+   SETL_SYSTEM_PROTO
+   worker_ptr_type worker_ptr)         /* worker to be collected            */
+
+{
+int status;                            /* exit status                       */
+
+   while (read_worker(SETL_SYSTEM worker_ptr));
+
+   close(worker_ptr->w_fd);
+   worker_ptr->w_fd = -1;
+   WORKER_RUNNING--;
+
+   while (waitpid((pid_t)worker_ptr->w_pid,&status,0) < 0) {
+
+      if (errno != EINTR) {
+         status = -1;
+         break;
+      }
+   }
+
+   worker_ptr->w_status = status;
+
+}
+
+/*\
+ *  \function{processor\_limit()}
+ *
+ *  This function returns the number of workers we may run at once: one
+ *  for each processor, unless the limit was set with \verb"stlx -w".
+\*/
+
+static long processor_limit(
+   SETL_SYSTEM_PROTO_VOID)
+
+{
+long limit;                            /* workers we may run at once        */
+
+   limit = WORKER_LIMIT;
+   if (limit <= 0)
+      limit = sysconf(_SC_NPROCESSORS_ONLN);
+   if (limit <= 0)
+      limit = 1;
+
+   return limit;
+
+}
+
+/*\
+ *  \function{disown\_workers()}
+ *
+ *  This function is called in a new worker, just after the fork.  The
+ *  parent's workers are not ours, so we close their pipes and forget
+ *  them.
+\*/
+
+static void disown_workers(
+   SETL_SYSTEM_PROTO_VOID)
+
+{
+worker_ptr_type worker_ptr;            /* inherited worker                  */
+
+   for (worker_ptr = WORKER_HEAD;
+        worker_ptr != NULL;
+        worker_ptr = worker_ptr->w_next) {
+
+      if (worker_ptr->w_fd >= 0)
+         close(worker_ptr->w_fd);
+
+   }
+
+   WORKER_HEAD = NULL;
+   WORKER_RUNNING = 0;
+
+}
+
+/*\
+ *  \function{write\_pipe()}
+ *
+ *  This function writes a block of characters to the pipe back to the
+ *  parent.  If the pipe breaks the parent is gone, so we just exit.
+\*/
+
+static void write_pipe(
+   int fd,                             /* write end of the result pipe      */
+   char *p,                            /* next character to write           */
+   int32 left)                         /* characters left to write          */
+
+{
+ssize_t count;                         /* characters written                */
+
+   while (left > 0) {
+
+      count = write(fd,p,(size_t)left);
+      if (count < 0) {
+         if (errno == EINTR)
+            continue;
+         _exit(1);
+      }
+
+      p += count;
+      left -= (int32)count;
+
+   }
+}
+
+/*\
+ *  \function{run\_worker()}
+ *
+ *  This function is the body of a worker, just after the fork.  We call
+ *  the procedure, write its result to the pipe and exit, without
+ *  returning to the interpreter loop.  If the procedure abends the
+ *  worker exits with an error status, which is all the parent sees.
+\*/
+
+static void run_worker(
+   SETL_SYSTEM_PROTO
+   specifier *proc,                    /* procedure to be called            */
+   specifier *arg,                     /* its argument                      */
+   int fd)                             /* write end of the result pipe      */
+
+{
+specifier result;                      /* procedure result                  */
+specifier image;                       /* result as a string                */
+string_h_ptr_type string_hdr;          /* image string header               */
+
+   disown_workers(SETL_SYSTEM_VOID);
+
+   /* call the procedure */
+
+   push_pstack(arg);
+   spec_set_form(&result,ft_omega);
+   call_procedure(SETL_SYSTEM &result,proc,NULL,1L,YES,NO,0);
+
+   /* write the result */
+
+   spec_set_form(&image,ft_omega);
+   setl2_binstr(SETL_SYSTEM 1,&result,&image);
+   string_hdr = spec_val(&image,sp_string_ptr);
+   write_pipe(fd,string_hdr->s_chars,string_hdr->s_length);
+
+   fflush(NULL);
+   _exit(0);
+
+}
+
+#endif
+
+/*\
+ *  \function{forall\_append()}
+ *
+ *  This function adds a value to the end of a tuple.  We take over the
+ *  caller's hold on the value.
+\*/
+
+static void forall_append(
+   SETL_SYSTEM_PROTO
+   tuple_h_ptr_type tuple_root,        /* tuple to be lengthened            */
+   specifier *value)                   /* value to be added                 */
+
+{
+tuple_c_ptr_type tuple_cell;           /* new cell                          */
+
+   reserve_tuple(tuple_root,tuple_root->t_length + 1);
+   tuple_cell = tuple_root->t_cells + tuple_root->t_length++;
+   spec_set_form(&tuple_cell->t_spec,spec_form(value));
+   spec_set_val(&tuple_cell->t_spec,sp_biggest,spec_val(value,sp_biggest));
+   spec_hash_code(tuple_cell->t_hash_code,value);
+   tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
+
+}
+
+/*\
+ *  \function{forall\_reduce()}
+ *
+ *  This function folds a value into a running reduction, calling the
+ *  reduction procedure on the two.  The first value is just kept.  We
+ *  take over the caller's hold on the value and set it to omega.
+\*/
+
+static void forall_reduce(
+   SETL_SYSTEM_PROTO
+   specifier *reduce,                  /* reduction procedure               */
+   specifier *accumulator,             /* reduction so far                  */
+   specifier *value)                   /* value to be folded in             */
+
+{
+specifier result;                      /* reduction procedure result        */
+
+   if (spec_form(accumulator) != ft_omega) {
+
+      push_pstack(accumulator);
+      push_pstack(value);
+      spec_set_form(&result,ft_omega);
+      call_procedure(SETL_SYSTEM &result,reduce,NULL,2L,YES,NO,0);
+      unmark_specifier(accumulator);
+      unmark_specifier(value);
+
+   }
+   else {
+
+      spec_set_form(&result,spec_form(value));
+      spec_set_val(&result,sp_biggest,spec_val(value,sp_biggest));
+
+   }
+
+   spec_set_form(accumulator,spec_form(&result));
+   spec_set_val(accumulator,sp_biggest,spec_val(&result,sp_biggest));
+   spec_set_form(value,ft_omega);
+
+}
+
+/*\
+ *  \function{forall\_part()}
+ *
+ *  This function runs one part of a \verb"worker_forall", calling the
+ *  procedure on each item in the part.  Without a reduction the part's
+ *  value is a tuple of the results, and with one it is their reduction.
+ *  Omega results are skipped either way.
+\*/
+
+static void forall_part(
+   SETL_SYSTEM_PROTO
+   specifier *proc,                    /* procedure to be called            */
+   specifier *reduce,                  /* reduction procedure, or NULL      */
+   specifier *source,                  /* set, map or tuple                 */
+   struct iter_part_item *part,        /* part to be run                    */
+   specifier *target)                  /* part value                        */
+
+{
+tuple_h_ptr_type tuple_root;           /* collected results                 */
+specifier item;                        /* source item                       */
+specifier result;                      /* procedure result                  */
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_omega);
+   tuple_root = NULL;
+   if (reduce == NULL)
+      tuple_root = new_tuple(SETL_SYSTEM_VOID);
+
+   spec_set_form(&item,ft_omega);
+   while (part_iterator_next(SETL_SYSTEM &item,source,part)) {
+
+      push_pstack(&item);
+      spec_set_form(&result,ft_omega);
+      call_procedure(SETL_SYSTEM &result,proc,NULL,1L,YES,NO,0);
+
+      if (spec_form(&result) == ft_omega)
+         continue;
+
+      if (reduce == NULL)
+         forall_append(SETL_SYSTEM tuple_root,&result);
+      else
+         forall_reduce(SETL_SYSTEM reduce,target,&result);
+
+   }
+
+   unmark_specifier(&item);
+
+   if (reduce == NULL) {
+      spec_set_form(target,ft_tuple);
+      spec_set_val(target,sp_tuple_ptr,tuple_root);
+   }
+}
+
+/*\
+ *  \function{forall\_finish()}
+ *
+ *  This function combines the part values of a \verb"worker_forall",
+ *  in part order, releasing them.  A reduction folds them together.
+ *  Otherwise the parts of a tuple are concatenated, and those of a set
+ *  or map are gathered into a set.
+\*/
+
+static void forall_finish(
+   SETL_SYSTEM_PROTO
+   specifier *reduce,                  /* reduction procedure, or NULL      */
+   specifier *source,                  /* set, map or tuple                 */
+   specifier *values,                  /* part values                       */
+   int32 count,                        /* number of parts                   */
+   specifier *target)                  /* return value                      */
+
+{
+specifier result;                      /* combined value                    */
+tuple_h_ptr_type tuple_root;           /* collected tuple                   */
+tuple_h_ptr_type part_root;            /* one part's tuple                  */
+tuple_c_ptr_type tuple_cell;           /* part element                      */
+set_h_ptr_type set_root;               /* collected set                     */
+int32 hash_code;                       /* element hash code                 */
+int32 i;                               /* temporary looping variable        */
+
+   spec_set_form(&result,ft_omega);
+   tuple_root = NULL;
+   set_root = NULL;
+
+   if (reduce == NULL && spec_form(source) == ft_tuple)
+      tuple_root = new_tuple(SETL_SYSTEM_VOID);
+   else if (reduce == NULL)
+      set_root = null_set(SETL_SYSTEM_VOID);
+
+   for (i = 0; i < count; i++) {
+
+      if (spec_form(values + i) == ft_omega)
+         continue;
+
+      if (reduce != NULL) {
+         forall_reduce(SETL_SYSTEM reduce,&result,values + i);
+         continue;
+      }
+
+      part_root = spec_val(values + i,sp_tuple_ptr);
+      unpack_tuple(part_root);
+
+      for (tuple_cell = part_root->t_cells;
+           tuple_cell < part_root->t_cells + part_root->t_length;
+           tuple_cell++) {
+
+         if (spec_form(&tuple_cell->t_spec) == ft_omega)
+            continue;
+
+         if (tuple_root != NULL) {
+            mark_specifier(&tuple_cell->t_spec);
+            forall_append(SETL_SYSTEM tuple_root,&tuple_cell->t_spec);
+         }
+         else {
+            spec_hash_code(hash_code,&tuple_cell->t_spec);
+            set_insert(SETL_SYSTEM set_root,&tuple_cell->t_spec,hash_code);
+         }
+      }
+
+      unmark_specifier(values + i);
+      spec_set_form(values + i,ft_omega);
+
+   }
+
+   if (tuple_root != NULL) {
+      spec_set_form(&result,ft_tuple);
+      spec_set_val(&result,sp_tuple_ptr,tuple_root);
+   }
+   else if (set_root != NULL) {
+      spec_set_form(&result,ft_set);
+      spec_set_val(&result,sp_set_ptr,set_root);
+   }
+
+   unmark_specifier(target);
+   spec_set_form(target,spec_form(&result));
+   spec_set_val(target,sp_biggest,spec_val(&result,sp_biggest));
+
+}
+
+/*\
+ *  \function{forall\_serial()}
+ *
+ *  This function decides whether a procedure must be run here rather
+ *  than in workers: if the compiler found it might change something it
+ *  does not own, or if it belongs to a process, since the changes would
+ *  be lost in a worker's copy of the heap.  The built-in table marks
+ *  the built-ins with effects, such as I/O or changing a builder.
+\*/
+
+static int forall_serial(
+   specifier *proc)                    /* procedure to be checked           */
+
+{
+proc_ptr_type proc_ptr;                /* procedure record                  */
+
+   proc_ptr = spec_val(proc,sp_proc_ptr);
+   if (proc_ptr->p_type == NATIVE_PROC || proc_ptr->p_side_effects)
+      return YES;
+
+   return (proc_ptr->p_self_ptr != NULL &&
+           proc_ptr->p_self_ptr->o_process_ptr != NULL);
+
+}
+
+#if UNIX
+
+/*\
+ *  \function{take\_part()}
+ *
+ *  This function takes the next part for a \verb"worker_forall" worker,
+ *  from the front of its own deque, or else from the back of another's.
+ *  It returns -1 when no parts are left anywhere.
+\*/
+
+static int32 take_part(
+   volatile unsigned int *deques,      /* one deque for each worker         */
+   int worker_count,                   /* number of workers                 */
+   int self)                           /* this worker's deque               */
+
+{
+unsigned int word;                     /* deque before we change it         */
+int32 head, tail;                      /* parts left in the deque           */
+#ifdef FORALL_STEAL
+int i, victim;                         /* deque we take from                */
+
+   for (i = 0; i < worker_count; i++) {
+
+      victim = (self + i) % worker_count;
+
+      for (;;) {
+
+         word = deques[victim];
+         head = deque_head(word);
+         tail = deque_tail(word);
+         if (head >= tail)
+            break;
+
+         if (victim == self) {
+            if (deque_swap(deques + victim,word,deque_word(head + 1,tail)))
+               return head;
+         }
+         else {
+            if (deque_swap(deques + victim,word,deque_word(head,tail - 1)))
+               return tail - 1;
+         }
+      }
+   }
+
+   return -1;
+
+#else
+
+   word = deques[self];
+   head = deque_head(word);
+   tail = deque_tail(word);
+   if (head >= tail)
+      return -1;
+
+   deques[self] = deque_word(head + 1,tail);
+   return head;
+
+#endif
+}
+
+/*\
+ *  \function{run\_forall()}
+ *
+ *  This function is the body of a \verb"worker_forall" worker, just
+ *  after the fork.  We run parts until none are left, writing each
+ *  part's number, length and value in \verb"binstr" form to the pipe.
+\*/
+
+static void run_forall(
+   SETL_SYSTEM_PROTO
+   specifier *proc,                    /* procedure to be called            */
+   specifier *reduce,                  /* reduction procedure, or NULL      */
+   specifier *source,                  /* set, map or tuple                 */
+   struct iter_part_item *parts,       /* parts of the source               */
+   volatile unsigned int *deques,      /* one deque for each worker         */
+   int worker_count,                   /* number of workers                 */
+   int self,                           /* this worker's deque               */
+   int fd)                             /* write end of the result pipe      */
+
+{
+specifier value;                       /* part value                        */
+specifier image;                       /* value as a string                 */
+string_h_ptr_type string_hdr;          /* image string header               */
+int32 header[2];                       /* part number and image length      */
+int32 part;                            /* part being run                    */
+
+   disown_workers(SETL_SYSTEM_VOID);
+
+   spec_set_form(&value,ft_omega);
+   spec_set_form(&image,ft_omega);
+
+   while ((part = take_part(deques,worker_count,self)) >= 0) {
+
+      forall_part(SETL_SYSTEM proc,reduce,source,parts + part,&value);
+      setl2_binstr(SETL_SYSTEM 1,&value,&image);
+      string_hdr = spec_val(&image,sp_string_ptr);
+
+      header[0] = part;
+      header[1] = string_hdr->s_length;
+      write_pipe(fd,(char *)header,(int32)sizeof(header));
+      write_pipe(fd,string_hdr->s_chars,string_hdr->s_length);
+
+   }
+
+   fflush(NULL);
+   _exit(0);
+
+}
+
+/*\
+ *  \function{unpack\_forall()}
+ *
+ *  This function converts the part values a \verb"worker_forall" worker
+ *  sent us back from \verb"binstr" form.  It returns the number of
+ *  parts found, or -1 if the worker's records are damaged.
+\*/
+
+static int32 unpack_forall(
+   SETL_SYSTEM_PROTO
+   worker_ptr_type worker_ptr,         /* collected worker                  */
+   specifier *values,                  /* part values                       */
+   int32 count)                        /* number of parts                   */
+
+{
+string_h_ptr_type string_hdr;          /* image string header               */
+specifier image;                       /* value as a string                 */
+int32 header[2];                       /* part number and image length      */
+int32 found;                           /* parts found                       */
+char *p, *end;                         /* records left to unpack            */
+
+   found = 0;
+   p = worker_ptr->w_result;
+   end = p + worker_ptr->w_length;
+
+   while (p < end) {
+
+      if (end - p < (long)sizeof(header))
+         return -1;
+      memcpy((void *)header,(void *)p,sizeof(header));
+      p += sizeof(header);
+
+      if (header[0] < 0 || header[0] >= count ||
+          spec_form(values + header[0]) != ft_omega ||
+          header[1] <= 0 || header[1] > end - p)
+         return -1;
+
+      string_hdr = new_string_buffer(SETL_SYSTEM header[1]);
+      memcpy((void *)string_hdr->s_chars,(void *)p,(size_t)header[1]);
+      p += header[1];
+
+      spec_set_form(&image,ft_string);
+      spec_set_val(&image,sp_string_ptr,string_hdr);
+      setl2_unbinstr(SETL_SYSTEM 1,&image,values + header[0]);
+      unmark_specifier(&image);
+      found++;
+
+   }
+
+   return found;
+
+}
+
+#endif
+
+/*\
+ *  \function{setl2\_worker\_start()}
+ *
+ *  This function is the \verb"worker_start" built-in function.  It
+ *  starts a worker calling a procedure of one argument, and returns a
+ *  handle for \verb"worker_result".  We run no more workers at once than
+ *  there are processors, unless the limit was set with \verb"stlx -w",
+ *  so if we are at the limit we first collect the oldest running worker.
+\*/
+
+void setl2_worker_start(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (two here)        */
+   specifier *target)                  /* return value                      */
+
+{
+#if UNIX
+specifier proc, arg;                   /* copies of the arguments           */
+worker_ptr_type worker_ptr;            /* new worker                        */
+worker_ptr_type *tail;                 /* end of worker list                */
+long limit;                            /* workers we may run at once        */
+int fds[2];                            /* result pipe                       */
+pid_t pid;                             /* worker process identifier         */
+
+   if (spec_form(&argv[0]) != ft_proc)
+      abend(SETL_SYSTEM msg_bad_arg,"procedure",1,"worker_start",
+            abend_opnd_str(SETL_SYSTEM argv));
+
+   /* wait for a free processor */
+
+   limit = processor_limit(SETL_SYSTEM_VOID);
+   while (WORKER_RUNNING >= limit) {
+
+      for (worker_ptr = WORKER_HEAD;
+           worker_ptr->w_fd < 0;
+           worker_ptr = worker_ptr->w_next);
+
+      collect_worker(SETL_SYSTEM worker_ptr);
+
+   }
+
+   /*
+    *  The arguments are on the program stack, which the worker may
+    *  move when it pushes its argument, so we take copies first.  We
+    *  flush our output so that the worker does not write it again.
+    */
+
+   spec_set_form(&proc,spec_form(&argv[0]));
+   spec_set_val(&proc,sp_biggest,spec_val(&argv[0],sp_biggest));
+   spec_set_form(&arg,spec_form(&argv[1]));
+   spec_set_val(&arg,sp_biggest,spec_val(&argv[1],sp_biggest));
+
+   if (pipe(fds) < 0)
+      abend(SETL_SYSTEM "Unable to start a worker");
+
+   fflush(NULL);
+   pid = fork();
+
+   if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      abend(SETL_SYSTEM "Unable to start a worker");
+   }
+
+   if (pid == 0) {
+      close(fds[0]);
+      run_worker(SETL_SYSTEM &proc,&arg,fds[1]);
+   }
+
+   /* this is the parent, which keeps the read end */
+
+   close(fds[1]);
+
+   worker_ptr = (worker_ptr_type)malloc(sizeof(struct worker_item));
+   if (worker_ptr == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+
+   worker_ptr->w_next = NULL;
+   worker_ptr->w_pid = (long)pid;
+   worker_ptr->w_fd = fds[0];
+   worker_ptr->w_status = 0;
+   worker_ptr->w_result = NULL;
+   worker_ptr->w_length = worker_ptr->w_size = 0;
+
+   for (tail = &WORKER_HEAD; *tail != NULL; tail = &((*tail)->w_next));
+   *tail = worker_ptr;
+   WORKER_RUNNING++;
+
+   unmark_specifier(target);
+   spec_set_form(target,ft_short);
+   spec_set_val(target,sp_short_value,(int32)pid);
+
+   return;
+
+#else
+
+   abend(SETL_SYSTEM "Workers are not available on this system");
+
+#endif
+}
+
+/*\
+ *  \function{setl2\_worker\_result()}
+ *
+ *  This function is the \verb"worker_result" built-in function.  It
+ *  waits for a worker to finish, if it hasn't yet, and returns the value
+ *  its procedure returned.  Each worker's result can be fetched once.
+\*/
+
+void setl2_worker_result(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector (one here)        */
+   specifier *target)                  /* return value                      */
+
+{
+#if UNIX
+worker_ptr_type worker_ptr;            /* worker to be collected            */
+worker_ptr_type *prev;                 /* link to worker                    */
+string_h_ptr_type string_hdr;          /* result string header              */
+specifier image;                       /* result as a string                */
+specifier result;                      /* result value                      */
+int status;                            /* worker exit status                */
+
+   /* find the worker */
+
+   worker_ptr = NULL;
+   if (spec_form(&argv[0]) == ft_short) {
+
+      for (prev = &WORKER_HEAD;
+           *prev != NULL &&
+              (*prev)->w_pid != (long)spec_val(&argv[0],sp_short_value);
+           prev = &((*prev)->w_next));
+
+      worker_ptr = *prev;
+
+   }
+
+   if (worker_ptr == NULL)
+      abend(SETL_SYSTEM "Invalid worker handle in worker_result:\n %s",
+            abend_opnd_str(SETL_SYSTEM argv));
+
+   if (worker_ptr->w_fd >= 0)
+      collect_worker(SETL_SYSTEM worker_ptr);
+
+   *prev = worker_ptr->w_next;
+   status = worker_ptr->w_status;
+
+   if (status < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+       worker_ptr->w_length == 0) {
+
+      free(worker_ptr->w_result);
+      free(worker_ptr);
+      abend(SETL_SYSTEM "Worker %ld failed without returning a result",
+            (long)spec_val(&argv[0],sp_short_value));
+
+   }
+
+   /* convert the result back from binstr form */
+
+   string_hdr = new_string_buffer(SETL_SYSTEM worker_ptr->w_length);
+   memcpy((void *)string_hdr->s_chars,(void *)worker_ptr->w_result,
+          (size_t)worker_ptr->w_length);
+   free(worker_ptr->w_result);
+   free(worker_ptr);
+
+   spec_set_form(&image,ft_string);
+   spec_set_val(&image,sp_string_ptr,string_hdr);
+   spec_set_form(&result,ft_omega);
+   setl2_unbinstr(SETL_SYSTEM 1,&image,&result);
+   unmark_specifier(&image);
+
+   unmark_specifier(target);
+   spec_set_form(target,spec_form(&result));
+   spec_set_val(target,sp_biggest,spec_val(&result,sp_biggest));
+
+   return;
+
+#else
+
+   abend(SETL_SYSTEM "Workers are not available on this system");
+
+#endif
+}
+
+/*\
+ *  \function{setl2\_worker\_forall()}
+ *
+ *  This function is the \verb"worker_forall" built-in function.  It
+ *  calls a procedure on each item of a set, map or tuple, in workers,
+ *  and returns the results which are not omega: a tuple in source order
+ *  for a tuple, or a set otherwise.  With a reduction procedure of two
+ *  arguments as well, it returns the reduction of those results instead,
+ *  or omega if there are none, so the reduction should be associative.
+ *
+ *  We split the source into several parts for each worker and share
+ *  them out in deques, so a worker which finishes early steals parts
+ *  from the others.  Each worker sends back one value for each part it
+ *  ran, which we combine here in part order.  If the compiler found the
+ *  procedure or the reduction might change anything it does not own,
+ *  the changes would be lost in the workers' copies of the heap, so we
+ *  run the whole loop here instead, as does a source too small to split.
+\*/
+
+void setl2_worker_forall(
+   SETL_SYSTEM_PROTO
+   int argc,                           /* number of arguments passed        */
+   specifier *argv,                    /* argument vector                   */
+   specifier *target)                  /* return value                      */
+
+{
+specifier proc, source, reduction;     /* copies of the arguments           */
+specifier *reduce;                     /* reduction procedure, or NULL      */
+struct iter_part_item *parts;          /* parts of the source               */
+specifier *values;                     /* part values                       */
+int32 want;                            /* parts we would like               */
+int32 count;                           /* parts we have                     */
+int32 i;                               /* temporary looping variable        */
+#if UNIX
+volatile unsigned int *deques;         /* one deque for each worker         */
+struct worker_item *workers;           /* forall workers                    */
+struct pollfd *pollfds;                /* pipes we are waiting on           */
+int *polled;                           /* worker for each polled pipe       */
+int worker_count;                      /* number of workers                 */
+int open_count;                        /* workers still writing             */
+int32 found;                           /* parts sent back                   */
+int failed;                            /* YES if a worker failed            */
+int fds[2];                            /* result pipe                       */
+pid_t pid;                             /* worker process identifier         */
+int j, k, n;                           /* temporary looping variables       */
+#endif
+
+   if (argc > 3)
+      abend(SETL_SYSTEM "Too many arguments to worker_forall");
+
+   if (spec_form(&argv[0]) != ft_proc)
+      abend(SETL_SYSTEM msg_bad_arg,"procedure",1,"worker_forall",
+            abend_opnd_str(SETL_SYSTEM argv));
+
+   if (spec_form(&argv[1]) != ft_set &&
+       spec_form(&argv[1]) != ft_map &&
+       spec_form(&argv[1]) != ft_tuple)
+      abend(SETL_SYSTEM msg_bad_arg,"set, map or tuple",2,"worker_forall",
+            abend_opnd_str(SETL_SYSTEM argv + 1));
+
+   if (argc > 2 && spec_form(&argv[2]) != ft_omega &&
+       spec_form(&argv[2]) != ft_proc)
+      abend(SETL_SYSTEM msg_bad_arg,"procedure",3,"worker_forall",
+            abend_opnd_str(SETL_SYSTEM argv + 2));
+
+   /*
+    *  The arguments are on the program stack, which moves when we push
+    *  arguments for the procedures, so we take copies first.
+    */
+
+   spec_set_form(&proc,spec_form(&argv[0]));
+   spec_set_val(&proc,sp_biggest,spec_val(&argv[0],sp_biggest));
+   spec_set_form(&source,spec_form(&argv[1]));
+   spec_set_val(&source,sp_biggest,spec_val(&argv[1],sp_biggest));
+
+   reduce = NULL;
+   if (argc > 2 && spec_form(&argv[2]) == ft_proc) {
+      spec_set_form(&reduction,spec_form(&argv[2]));
+      spec_set_val(&reduction,sp_biggest,spec_val(&argv[2],sp_biggest));
+      reduce = &reduction;
+   }
+
+   /* split the source */
+
+#if UNIX
+   want = (int32)processor_limit(SETL_SYSTEM_VOID) * FORALL_PARTS;
+   if (want > FORALL_MAX_PARTS - SET_HASH_SIZE)
+      want = FORALL_MAX_PARTS - SET_HASH_SIZE;
+#else
+   want = 1;
+#endif
+
+   if (forall_serial(&proc) || (reduce != NULL && forall_serial(reduce)))
+      want = 1;
+
+   parts = (struct iter_part_item *)malloc((size_t)
+         ((want + SET_HASH_SIZE) * sizeof(struct iter_part_item)));
+   if (parts == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+
+   count = split_iteration(SETL_SYSTEM &source,parts,want);
+
+   values = (specifier *)malloc((size_t)
+         ((count > 0 ? count : 1) * sizeof(specifier)));
+   if (values == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   for (i = 0; i < count; i++)
+      spec_set_form(values + i,ft_omega);
+
+   /* a loop we can not or need not share out runs here */
+
+   if (count <= 1) {
+
+      for (i = 0; i < count; i++)
+         forall_part(SETL_SYSTEM &proc,reduce,&source,parts + i,values + i);
+
+      forall_finish(SETL_SYSTEM reduce,&source,values,count,target);
+      free(values);
+      free(parts);
+
+      return;
+
+   }
+
+#if UNIX
+
+   /* give each worker an even share of the parts to start */
+
+   worker_count = (int)want / FORALL_PARTS;
+   if (worker_count < 1)
+      worker_count = 1;
+   if (worker_count > count)
+      worker_count = (int)count;
+
+   deques = (volatile unsigned int *)mmap(NULL,
+         (size_t)worker_count * sizeof(unsigned int),
+         PROT_READ | PROT_WRITE,MAP_SHARED | MAP_ANONYMOUS,-1,0);
+   if ((void *)deques == MAP_FAILED)
+      abend(SETL_SYSTEM "Unable to start a worker");
+
+   for (k = 0; k < worker_count; k++) {
+      deques[k] = deque_word(count * k / worker_count,
+                             count * (k + 1) / worker_count);
+   }
+
+   workers = (struct worker_item *)malloc((size_t)worker_count *
+         (sizeof(struct worker_item) + sizeof(struct pollfd) + sizeof(int)));
+   if (workers == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   pollfds = (struct pollfd *)(workers + worker_count);
+   polled = (int *)(pollfds + worker_count);
+
+   /* start the workers, flushing our output first as worker_start does */
+
+   fflush(NULL);
+
+   for (k = 0; k < worker_count; k++) {
+
+      if (pipe(fds) < 0)
+         abend(SETL_SYSTEM "Unable to start a worker");
+
+      pid = fork();
+
+      if (pid < 0) {
+         close(fds[0]);
+         close(fds[1]);
+         abend(SETL_SYSTEM "Unable to start a worker");
+      }
+
+      if (pid == 0) {
+         close(fds[0]);
+         for (j = 0; j < k; j++)
+            close(workers[j].w_fd);
+         run_forall(SETL_SYSTEM &proc,reduce,&source,parts,deques,
+                    worker_count,k,fds[1]);
+      }
+
+      close(fds[1]);
+
+      workers[k].w_next = NULL;
+      workers[k].w_pid = (long)pid;
+      workers[k].w_fd = fds[0];
+      workers[k].w_status = 0;
+      workers[k].w_result = NULL;
+      workers[k].w_length = workers[k].w_size = 0;
+      WORKER_RUNNING++;
+
+   }
+
+   /* read every pipe as it fills, until all the workers are done */
+
+   open_count = worker_count;
+   while (open_count > 0) {
+
+      n = 0;
+      for (k = 0; k < worker_count; k++) {
+
+         if (workers[k].w_fd < 0)
+            continue;
+
+         pollfds[n].fd = workers[k].w_fd;
+         pollfds[n].events = POLLIN;
+         pollfds[n].revents = 0;
+         polled[n++] = k;
+
+      }
+
+      if (poll(pollfds,(nfds_t)n,-1) < 0) {
+         if (errno == EINTR)
+            continue;
+         abend(SETL_SYSTEM "Unable to wait for a worker");
+      }
+
+      for (j = 0; j < n; j++) {
+
+         if (pollfds[j].revents == 0)
+            continue;
+
+         if (!read_worker(SETL_SYSTEM workers + polled[j])) {
+            collect_worker(SETL_SYSTEM workers + polled[j]);
+            open_count--;
+         }
+      }
+   }
+
+   munmap((void *)deques,(size_t)worker_count * sizeof(unsigned int));
+
+   /* convert the part values back, checking every part came back */
+
+   failed = -1;
+   found = 0;
+   for (k = 0; k < worker_count; k++) {
+
+      n = workers[k].w_status;
+      if (failed < 0 &&
+          (n < 0 || !WIFEXITED(n) || WEXITSTATUS(n) != 0))
+         failed = k;
+
+      i = (failed < 0) ? unpack_forall(SETL_SYSTEM workers + k,values,count)
+                       : 0;
+      if (failed < 0 && i < 0)
+         failed = k;
+      else
+         found += i;
+
+   }
+
+   if (failed < 0 && found != count)
+      failed = 0;
+
+   if (failed >= 0) {
+
+      pid = (pid_t)workers[failed].w_pid;
+      for (k = 0; k < worker_count; k++)
+         free(workers[k].w_result);
+      free(workers);
+      for (i = 0; i < count; i++)
+         unmark_specifier(values + i);
+      free(values);
+      free(parts);
+      abend(SETL_SYSTEM "Worker %ld failed without returning a result",
+            (long)pid);
+
+   }
+
+   for (k = 0; k < worker_count; k++)
+      free(workers[k].w_result);
+   free(workers);
+
+   forall_finish(SETL_SYSTEM reduce,&source,values,count,target);
+   free(values);
+   free(parts);
+
+   return;
+
+#endif
+}
@@ -0,0 +1,74 @@
+/*\
+ *
+ *  % MIT License
+ *  %
+ *  % Copyright (c) 1990 W. Kirk Snyder
+ *  %
+ *  % Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  % of this software and associated documentation files (the "Software"), to deal
+ *  % in the Software without restriction, including without limitation the rights
+ *  % to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  % copies of the Software, and to permit persons to whom the Software is
+ *  % furnished to do so, subject to the following conditions:
+ *  % 
+ *  % The above copyright notice and this permission notice shall be included in all
+ *  % copies or substantial portions of the Software.
+ *  %
+ *  % THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  % IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  % FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  % AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  % LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  % OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  % SOFTWARE.
+ *  %
+ *
+ *  \packagespec{Workers}
+\*/
+
+#ifndef WORKERS_LOADED
+
+/* worker node structure */
+
+struct worker_item {
+   struct worker_item *w_next;         /* next worker in list               */
+   long w_pid;                         /* worker process identifier         */
+   int w_fd;                           /* result pipe, -1 once collected    */
+   int w_status;                       /* exit status once collected        */
+   char *w_result;                     /* result, as a binstr string        */
+   int32 w_length;                     /* characters in result              */
+   int32 w_size;                       /* allocated size of result          */
+};
+
+typedef struct worker_item *worker_ptr_type;
+                                       /* worker node pointer               */
+
+/* global data */
+
+#ifdef TSAFE
+#define WORKER_HEAD plugin_instance->worker_head
+#define WORKER_RUNNING plugin_instance->worker_running
+#define WORKER_LIMIT plugin_instance->worker_limit
+#else
+#define WORKER_HEAD worker_head
+#define WORKER_RUNNING worker_running
+#define WORKER_LIMIT worker_limit
+
+#ifdef SHARED
+
+worker_ptr_type worker_head = NULL;    /* workers not yet collected         */
+int worker_running = 0;                /* workers whose pipe is open        */
+int worker_limit = 0;                  /* workers at once, 0 for one per    */
+                                       /* processor                         */
+
+#else
+
+extern worker_ptr_type worker_head;    /* workers not yet collected         */
+extern int worker_running;             /* workers whose pipe is open        */
+extern int worker_limit;               /* workers at once                   */
+
+#endif
+#endif
+
+#define WORKERS_LOADED 1
+#endif
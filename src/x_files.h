@@ -28,6 +28,10 @@
 
 #ifndef FILES_LOADED
 
+/* SETL2 system header files */
+
+#include "slabs.h"                     /* slabs                             */
+
 /* constants */
 
 #define FILE_BUFF_SIZE  256            /* buffer size for text input files  */
@@ -57,16 +61,17 @@ typedef struct file_item *file_ptr_type;
 /* global data */
 
 #ifdef TSAFE
-#define FILE_NEXT_FREE plugin_instance->file_next_free
+#define FILE_SLAB plugin_instance->file_slab
 #else
-#define FILE_NEXT_FREE file_next_free
+#define FILE_SLAB file_slab
 #ifdef SHARED
 
-file_ptr_type file_next_free = NULL;   /* next free file                    */
+struct slab_class_item file_slab;      /* file slabs                        */
 
 #else
 
-extern file_ptr_type file_next_free;   /* next free file                    */
+extern struct slab_class_item file_slab;
+                                       /* file slabs                        */
 
 #endif
 #endif
@@ -85,24 +90,14 @@ extern file_ptr_type file_next_free;   /* next free file                    */
 
 #else
 
-#define get_file(t) {\
-   if (FILE_NEXT_FREE == NULL) alloc_files(SETL_SYSTEM_VOID); \
-   t = FILE_NEXT_FREE; \
-   FILE_NEXT_FREE = *((file_ptr_type *)(FILE_NEXT_FREE)); \
-}
+#define get_file(t) \
+   slab_get(FILE_SLAB,"file",file_ptr_type,t,\
+            sizeof(struct file_item))
 
-#define free_file(s) {\
-   *((file_ptr_type *)(s)) = FILE_NEXT_FREE; \
-   FILE_NEXT_FREE = s; \
-}
+#define free_file(s) slab_put(s)
 
 #endif
 
-/* public function declarations */
-
-void alloc_files(SETL_SYSTEM_PROTO_VOID);                
-                                       /* allocate a block of file nodes    */
-
 #define FILES_LOADED 1
 #endif
 
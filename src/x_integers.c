@@ -39,11 +39,20 @@
  *  slow, so we try to use short arithmetic before resorting to these
  *  algorithms.
  *
+ *  Long integers are kept as a sign and a magnitude, where the magnitude
+ *  is a contiguous array of machine word limbs.  The low level routines
+ *  with names beginning \verb"limbs_" work on magnitudes alone, and know
+ *  nothing about specifiers or signs.
+ *
  *  \texify{x_integers.h}
  *
  *  \packagebody{Integers}
 \*/
 
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
+
 /* SETL2 system header files */
 
 #include "system.h"                    /* SETL2 system constants            */
@@ -57,135 +66,141 @@
 
 /* performance tuning constants */
 
-#define INT_HEADER_BLOCK_SIZE   50     /* integer header block size         */
-#define INT_CELL_BLOCK_SIZE    200     /* integer cell block size           */
+#define MIN_SPLIT_LIMBS         4      /* shortest operand we split, so     */
+                                       /* the pieces are always shorter     */
 
-/*\
- *  \function{alloc\_integer\_headers()}
- *
- *  This function allocates a block of integer headers and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste header items to pointers to header items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the header node.
- *  It will work provided a header item is larger than a pointer, which
- *  is the case.
-\*/
+/* number of limbs needed to hold a C long */
 
-void alloc_integer_headers(
-   SETL_SYSTEM_PROTO_VOID)
+#define SHORT_LIMBS ((int32)((sizeof(int32) + sizeof(integer_limb) - 1) / \
+                             sizeof(integer_limb)))
 
-{
-integer_h_ptr_type new_block;          /* first header in allocated block   */
+/* remove high order zero limbs */
 
-   /* allocate a new block */
+#define trim_limbs(l,n) {while ((n) > 0 && !(l)[(n) - 1]) (n)--;}
 
-   new_block = (integer_h_ptr_type)malloc((size_t)
-         (INT_HEADER_BLOCK_SIZE * sizeof(struct integer_h_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
+/*
+ *  We use this structure to look at short and long operands the same
+ *  way, as a sign and a magnitude.  Short operands are unpacked into
+ *  o_short.
+ */
 
-   /* link items on the free list */
+struct integer_operand {
+   integer_limb *o_limbs;              /* magnitude, low order first        */
+   int32 o_limb_count;                 /* number of limbs in magnitude      */
+   int o_is_negative;                  /* YES if operand is negative        */
+   integer_limb o_short[INT_INLINE_LIMBS];
+                                       /* limbs of a short operand          */
+};
 
-   for (INTEGER_H_NEXT_FREE = new_block;
-        INTEGER_H_NEXT_FREE < new_block + INT_HEADER_BLOCK_SIZE - 1;
-        INTEGER_H_NEXT_FREE++) {
+/* forward declarations */
 
-      *((integer_h_ptr_type *)INTEGER_H_NEXT_FREE) = INTEGER_H_NEXT_FREE + 1;
+static void limbs_multiply(SETL_SYSTEM_PROTO integer_limb *,
+                           integer_limb *, int32, integer_limb *, int32);
+                                       /* multiply two magnitudes           */
 
-   }
+/*\
+ *  \function{free\_integer()}
+ *
+ *  This function releases an entire integer structure.
+\*/
 
-   *((integer_h_ptr_type *)INTEGER_H_NEXT_FREE) = NULL;
+void free_interp_integer(
+   SETL_SYSTEM_PROTO
+   integer_h_ptr_type header)          /* integer to be freed               */
 
-   /* set next free node to new block */
+{
 
-   INTEGER_H_NEXT_FREE = new_block;
+   if (header->i_limbs != header->i_inline)
+      free((void *)(header->i_limbs));
 
-   return;
+   free_integer_header(header);
 
 }
 
 /*\
- *  \function{alloc\_integer\_cells()}
+ *  \function{new\_integer()}
  *
- *  This function allocates a block of integer cells and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste cell items to pointers to cell items in order to form the free
- *  list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently, while
- *  at the same time avoiding an extra pointer on the cell node.  It
- *  will work provided a cell item is larger than a pointer, which is
- *  the case.
+ *  This function allocates a long integer with a value of zero, and
+ *  room for at least the given number of limbs.  Small integers use the
+ *  limbs in the header, larger ones get an array from \verb"malloc()".
 \*/
 
-void alloc_integer_cells(
-   SETL_SYSTEM_PROTO_VOID)
+integer_h_ptr_type new_integer(
+   SETL_SYSTEM_PROTO
+   int32 limb_count)                   /* number of limbs needed            */
 
 {
-integer_c_ptr_type new_block;          /* first cell in allocated block     */
-
-   /* allocate a new block */
+integer_h_ptr_type target;             /* new integer structure             */
 
-   new_block = (integer_c_ptr_type)malloc((size_t)
-         (INT_CELL_BLOCK_SIZE * sizeof(struct integer_c_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
+   get_integer_header(target);
+   target->i_use_count = 1;
+   target->i_hash_code = -1;
+   target->i_limb_count = 0;
+   target->i_is_negative = NO;
 
-   /* link items on the free list */
+   if (limb_count <= INT_INLINE_LIMBS) {
 
-   for (INTEGER_C_NEXT_FREE = new_block;
-        INTEGER_C_NEXT_FREE < new_block + INT_CELL_BLOCK_SIZE - 1;
-        INTEGER_C_NEXT_FREE++) {
+      target->i_limbs = target->i_inline;
+      target->i_limb_alloc = INT_INLINE_LIMBS;
 
-      *((integer_c_ptr_type *)INTEGER_C_NEXT_FREE) = INTEGER_C_NEXT_FREE + 1;
+      return target;
 
    }
 
-   *((integer_c_ptr_type *)INTEGER_C_NEXT_FREE) = NULL;
-
-   /* set next free node to new block */
-
-   INTEGER_C_NEXT_FREE = new_block;
+   target->i_limbs = (integer_limb *)malloc((size_t)
+         (limb_count * sizeof(integer_limb)));
+   if (target->i_limbs == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   target->i_limb_alloc = limb_count;
 
-   return;
+   return target;
 
 }
 
 /*\
- *  \function{free\_integer()}
+ *  \function{reserve\_limbs()}
  *
- *  This function releases an entire integer structure.
+ *  This function makes sure an integer has room for at least the given
+ *  number of limbs.  We at least double the allocation when we grow, so
+ *  that building an integer a limb at a time takes linear time.
 \*/
 
-void free_interp_integer(
+static void reserve_limbs(
    SETL_SYSTEM_PROTO
-   integer_h_ptr_type header)          /* integer to be freed               */
+   integer_h_ptr_type header,          /* integer to be extended            */
+   int32 limb_count)                   /* number of limbs needed            */
 
 {
-integer_c_ptr_type t1,t2;              /* temporary looping variables       */
+integer_limb *new_limbs;               /* new limb array                    */
 
-   t1 = header->i_head;
+   if (limb_count <= header->i_limb_alloc)
+      return;
 
-   while (t1 != NULL) {
+   if (limb_count < header->i_limb_alloc * 2)
+      limb_count = header->i_limb_alloc * 2;
 
-      t2 = t1;
-      t1 = t1->i_next;
-      free_integer_cell(t2);
+   new_limbs = (integer_limb *)malloc((size_t)
+         (limb_count * sizeof(integer_limb)));
+   if (new_limbs == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-   }
+   memcpy((void *)new_limbs,(void *)(header->i_limbs),
+          (size_t)(header->i_limb_count * sizeof(integer_limb)));
 
-   free_integer_header(header);
+   if (header->i_limbs != header->i_inline)
+      free((void *)(header->i_limbs));
+
+   header->i_limbs = new_limbs;
+   header->i_limb_alloc = limb_count;
+
+   return;
 
 }
 
 /*\
  *  \function{copy\_integer()}
  *
- *  This function copies an integer structure with all associated integer
- *  cells.
+ *  This function copies an integer structure with its limbs.
 \*/
 
 integer_h_ptr_type copy_integer(
@@ -194,2063 +209,2645 @@ integer_h_ptr_type copy_integer(
 
 {
 integer_h_ptr_type target;             /* new integer structure             */
-integer_c_ptr_type s1,t1,t2;           /* used to traverse source and       */
-                                       /* target lists                      */
 
-   /* allocate a new header */
-
-   get_integer_header(target);
-
-   target->i_use_count = 1;
+   target = new_integer(SETL_SYSTEM source->i_limb_count);
    target->i_hash_code = source->i_hash_code;
-   target->i_cell_count = source->i_cell_count;
+   target->i_limb_count = source->i_limb_count;
    target->i_is_negative = source->i_is_negative;
 
-   /* copy each cell node */
-
-   t2 = NULL;
-   for (s1 = source->i_head;
-        s1 != NULL;
-        s1 = s1->i_next) {
-
-      /* allocate a new cell node */
-
-      get_integer_cell(t1);
-      if (t2 != NULL)
-         t2->i_next = t1;
-      else
-         target->i_head = t1;
-
-      t1->i_cell_value = s1->i_cell_value;
-      t1->i_prev = t2;
-      t2 = t1;
-
-   }
-   t1->i_next = NULL;
-   target->i_tail = t1;
+   memcpy((void *)(target->i_limbs),(void *)(source->i_limbs),
+          (size_t)(source->i_limb_count * sizeof(integer_limb)));
 
    return target;
 
 }
 
 /*\
- *  \function{short\_to\_long()}
+ *  \function{limbs\_compare()}
  *
- *  This function converts a C long value into a SETL2 integer. It is used
- *  primarily when we try to perform short arithmetic and find an
- *  overflow.
+ *  This function compares two magnitudes.  It returns a negative value
+ *  if the left is smaller, zero if they are equal, and a positive value
+ *  if the left is larger.  Magnitudes must not have high order zero
+ *  limbs.
 \*/
 
-void short_to_long(
-   SETL_SYSTEM_PROTO
-   specifier *target,                  /* SETL2 integer result              */
-   int32 source)                       /* C long value                      */
+static int limbs_compare(
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
 {
-integer_c_ptr_type t1,t2;              /* work integer cell pointers        */
-integer_h_ptr_type target_hdr;         /* work integer header pointer       */
-int32 hi_bits;                         /* high order bits of short integer  */
-
-   /* if we can use a short integer do so */
+int32 i;                               /* temporary looping variable        */
 
-   if (!(hi_bits = source & INT_HIGH_BITS) ||
-       hi_bits == INT_HIGH_BITS) {
+   if (left_count != right_count)
+      return (left_count < right_count) ? -1 : 1;
 
-      unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = source;
+   for (i = left_count - 1; i >= 0; i--) {
 
-      return;
+      if (left[i] != right[i])
+         return (left[i] < right[i]) ? -1 : 1;
 
    }
 
-   /* create a long integer */
+   return 0;
+
+}
 
-   get_integer_header(target_hdr);
-   target_hdr->i_use_count = 1;
-   target_hdr->i_cell_count = 0;
-   target_hdr->i_hash_code = -1;
+/*\
+ *  \function{limbs\_add()}
+ *
+ *  This function adds two magnitudes, where the left is at least as long
+ *  as the right.  The target must have room for one more limb than the
+ *  left, and may be the same array as either operand.  We return the
+ *  number of limbs in the sum.
+\*/
 
-   /* set the sign of the integer */
+static int32 limbs_add(
+   integer_limb *target,               /* sum                               */
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
-   if (source < 0L) {
-      target_hdr->i_is_negative = YES;
-      source = -source;
-   }
-   else {
-      target_hdr->i_is_negative = NO;
-   }
+{
+integer_limb sum;                      /* sum of one limb                   */
+integer_limb carry;                    /* carry to the next limb            */
+int32 i;                               /* temporary looping variable        */
 
-   /* keep adding cells until we use up the source */
+   carry = 0;
 
-   t2 = NULL;
-   while (source) {
+   for (i = 0; i < right_count; i++) {
 
-      /* allocate a new cell node */
+      sum = left[i] + carry;
+      carry = (sum < carry);
+      sum += right[i];
+      carry += (sum < right[i]);
+      target[i] = sum;
 
-      get_integer_cell(t1);
-      if (t2 != NULL)
-         t2->i_next = t1;
-      else
-         target_hdr->i_head = t1;
+   }
 
-      t1->i_cell_value = source & MAX_INT_CELL;
-      source >>= INT_CELL_WIDTH;
-      t1->i_prev = t2;
-      t2 = t1;
+   for (; i < left_count; i++) {
 
-      target_hdr->i_cell_count++;
+      sum = left[i] + carry;
+      carry = (sum < carry);
+      target[i] = sum;
 
    }
 
-   t1->i_next = NULL;
-   target_hdr->i_tail = t1;
-
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = target_hdr;
+   target[left_count] = carry;
 
-   return;
+   return left_count + (int32)carry;
 
 }
 
 /*\
- *  \function{long\_to\_short()}
+ *  \function{limbs\_subtract()}
  *
- *  This function converts a SETL2 long value into a C long.  We assume
- *  that the long integer will fit into a C long.
+ *  This function subtracts the right magnitude from the left, where the
+ *  left is at least as large as the right.  The target may be the same
+ *  array as either operand.  We return the number of limbs in the
+ *  difference, after removing high order zeros.
 \*/
 
-int32 long_to_short(
-   SETL_SYSTEM_PROTO
-   integer_h_ptr_type source)          /* SETL2 integer source              */
+static int32 limbs_subtract(
+   integer_limb *target,               /* difference                        */
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
 {
-int32 return_value;                    /* returned C long                   */
-integer_c_ptr_type t1;                 /* work integer cell pointer         */
+integer_limb difference;               /* difference of one limb            */
+integer_limb borrow;                   /* borrow from the next limb         */
+integer_limb next_borrow;              /* borrow for the following limb     */
+int32 i;                               /* temporary looping variable        */
 
-   t1 = source->i_head;
-   return_value = t1->i_cell_value;
-   t1 = t1->i_next;
+   borrow = 0;
 
-   if (t1 != NULL) {
+   for (i = 0; i < right_count; i++) {
 
-      return_value |= (t1->i_cell_value << INT_CELL_WIDTH);
-      t1 = t1->i_next;
+      difference = left[i] - right[i];
+      next_borrow = (left[i] < right[i]);
+      next_borrow |= (difference < borrow);
+      target[i] = difference - borrow;
+      borrow = next_borrow;
 
    }
 
-   if (t1 != NULL) {
+   for (; i < left_count; i++) {
 
-      return_value |= ((t1->i_cell_value & 0x01) << (INT_CELL_WIDTH * 2));
+      next_borrow = (left[i] < borrow);
+      target[i] = left[i] - borrow;
+      borrow = next_borrow;
 
    }
 
-   if (source->i_is_negative)
-      return_value = -return_value;
+   trim_limbs(target,left_count);
 
-   return return_value;
+   return left_count;
 
 }
 
 /*\
- *  \function{long\_to\_double()}
+ *  \function{limbs\_multiply\_classical()}
  *
- *  This function converts a SETL2 long integer into a C double. We use it
- *  for explicit type conversions.
+ *  This function multiplies two magnitudes with the classical method.
+ *  The target must have room for the sum of the operand lengths, and
+ *  must not overlap either operand.  The high order limb of the product
+ *  may be zero.
 \*/
 
-double long_to_double(
-   SETL_SYSTEM_PROTO
-   specifier *source)                  /* SETL2 long integer                */
+static void limbs_multiply_classical(
+   integer_limb *target,               /* product                           */
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
 {
-double return_value;                   /* returned value                    */
-integer_c_ptr_type t1;                 /* work cell pointer                 */
+integer_dlimb product;                 /* product of two limbs, plus carry  */
+integer_limb carry;                    /* carry to the next limb            */
+int32 i,j;                             /* temporary looping variables       */
 
-   return_value = 0.0;
+   for (i = 0; i < left_count; i++)
+      target[i] = 0;
 
-   /* loop over the cells from high to low order, adding them to the result */
+   for (j = 0; j < right_count; j++) {
 
-   for (t1 = (source->sp_val.sp_long_ptr)->i_tail;
-        t1 != NULL;
-        t1 = t1->i_prev) {
+      carry = 0;
+      for (i = 0; i < left_count; i++) {
 
-      return_value = return_value * (double)(MAX_INT_CELL + 1) +
-                     (double)t1->i_cell_value;
+         product = (integer_dlimb)left[i] * right[j] + target[i + j] + carry;
+         target[i + j] = (integer_limb)product;
+         carry = (integer_limb)(product >> INT_LIMB_WIDTH);
 
-   }
+      }
 
-   /* set the sign of the result */
+      target[j + left_count] = carry;
 
-   if ((source->sp_val.sp_long_ptr)->i_is_negative)
-      return_value = -return_value;
+   }
 
-   return return_value;
+   return;
 
 }
 
 /*\
- *  \function{integer\_string()}
- *
- *  This function returns a character string representation of a SETL2
- *  integer in a given base.  Since we have chosen a binary
- *  representation of integers for computation efficiency, we are stuck
- *  with an inefficient algorithm here.  We accept this since we presume
- *  we will perform arithmetic operations much more frequently.
- *
- *  The general idea is to keep traversing the list, each time dividing
- *  the integer by the base, and taking the remainder as the next digit,
- *  building the string from right to left.  To improve the efficiency a
- *  little, we extract several digits on each pass over the list.
+ *  \function{limbs\_accumulate()}
  *
- *  We should note that this function uses \verb"malloc()" to allocate a
- *  return buffer.  The caller should free this buffer after it uses the
- *  string.
+ *  This function adds a magnitude into a longer one in place, carrying
+ *  as far as necessary.  The caller must be sure the sum fits in the
+ *  target.
 \*/
 
-char *integer_string(
-   SETL_SYSTEM_PROTO
-   specifier *spec,                    /* specifier                         */
-   int base)                           /* number base of string             */
+static void limbs_accumulate(
+   integer_limb *target,               /* magnitude we add to               */
+   int32 target_count,                 /* limbs in target                   */
+   integer_limb *source,               /* magnitude we add                  */
+   int32 source_count)                 /* limbs in source                   */
 
 {
-char *return_ptr;                      /* returned string pointer           */
-integer_c_ptr_type cell;               /* used to loop over cell list       */
-int digits_per_cell;                   /* number of digits per cell         */
-integer_h_ptr_type header;             /* header of work integer list       */
-int32 divisor;                         /* largest power of base less than   */
-                                       /* the maximum cell value            */
-int32 remainder;                       /* remainder of cell / divisor       */
-static char digit[] = {                /* digit character table             */
-   '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
-   'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
-   'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't',
-   'u', 'v', 'w', 'x', 'y', 'z'};
-char *s,*t;                            /* temporary looping variables       */
+integer_limb sum;                      /* sum of one limb                   */
+integer_limb carry;                    /* carry to the next limb            */
 int32 i;                               /* temporary looping variable        */
 
-   /* first we calculate the maximum number of digits in each cell */
+   carry = 0;
 
-   i = MAX_INT_CELL;
-   digits_per_cell = 0;
+   for (i = 0; i < source_count; i++) {
+
+      sum = target[i] + carry;
+      carry = (sum < carry);
+      sum += source[i];
+      carry += (sum < source[i]);
+      target[i] = sum;
 
-   while (i) {
-      digits_per_cell++;
-      i /= base;
    }
 
-   /* copy the integer, for destructive use */
+   for (; carry && i < target_count; i++) {
 
-   header = copy_integer(SETL_SYSTEM spec->sp_val.sp_long_ptr);
+      target[i]++;
+      carry = (target[i] == 0);
 
-   /* allocate a buffer for the string */
+   }
 
-   return_ptr = (char *)malloc((size_t)
-      (header->i_cell_count * digits_per_cell + 2));
-   if (return_ptr == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
+   return;
 
-   /* set the target pointer to the end of the string */
+}
 
-   t = return_ptr + (header->i_cell_count * digits_per_cell) + 1;
-   *t-- = '\0';
+/*\
+ *  \function{operand\_add()}
+ *
+ *  Toom-3 needs a few signed intermediate values, which we keep in
+ *  operand structures with scratch limbs.  This function adds or
+ *  subtracts two of them.  The target must have room for one more limb
+ *  than the longer operand, and may be either operand.
+\*/
 
-   /* calculate an optimal divisor for each pass */
+static void operand_add(
+   struct integer_operand *target,     /* result operand                    */
+   struct integer_operand *left,       /* left operand                      */
+   struct integer_operand *right,      /* right operand                     */
+   int subtract)                       /* YES to subtract right from left   */
 
-   divisor = 1;
-   digits_per_cell = 0;
-   i = MAX_INT_CELL;
-   while (i > base) {
-      divisor *= base;
-      digits_per_cell++;
-      i /= base;
+{
+struct integer_operand *larger, *smaller;
+                                       /* operands ordered by magnitude     */
+int larger_negative;                   /* sign of larger operand            */
+int smaller_negative;                  /* sign of smaller operand           */
+
+   if (limbs_compare(left->o_limbs,left->o_limb_count,
+                     right->o_limbs,right->o_limb_count) >= 0) {
+      larger = left;
+      smaller = right;
+      larger_negative = left->o_is_negative;
+      smaller_negative = right->o_is_negative ^ subtract;
+   }
+   else {
+      larger = right;
+      smaller = left;
+      larger_negative = right->o_is_negative ^ subtract;
+      smaller_negative = left->o_is_negative;
    }
 
-   /* make passes over the list, each time extracting digits_per_cell */
-
-   while (t > return_ptr) {
+   if (larger_negative == smaller_negative) {
 
-      /* traverse the list, gathering digits_per_cell in remainder */
+      target->o_limb_count =
+         limbs_add(target->o_limbs,
+                   larger->o_limbs,larger->o_limb_count,
+                   smaller->o_limbs,smaller->o_limb_count);
 
-      remainder = 0;
-      for (cell = header->i_tail;
-           cell != NULL;
-           cell = cell->i_prev) {
+   }
+   else {
 
-         cell->i_cell_value |= remainder << INT_CELL_WIDTH;
+      target->o_limb_count =
+         limbs_subtract(target->o_limbs,
+                        larger->o_limbs,larger->o_limb_count,
+                        smaller->o_limbs,smaller->o_limb_count);
 
-#if GCC & MC68020
+   }
 
-         __asm__ volatile("divsll %3,%1:%0" :
-                          "=d" (cell->i_cell_value), "=d" (remainder) :
-                          "0" (cell->i_cell_value), "d" (divisor));
-                          
-#else
+   target->o_is_negative = target->o_limb_count > 0 && larger_negative;
 
-         remainder = cell->i_cell_value % divisor;
-         cell->i_cell_value /= divisor;
+   return;
 
-#endif
+}
 
-      }
+/*\
+ *  \function{operand\_shift()}
+ *
+ *  This function doubles or halves a signed operand.  We only halve
+ *  even values, and when doubling the operand must have room for
+ *  another limb.
+\*/
 
-      /* append the digits to the return string */
+static void operand_shift(
+   struct integer_operand *operand,    /* operand to shift                  */
+   int halve)                          /* YES to halve, NO to double        */
 
-      for (i = 0; t > return_ptr && i < digits_per_cell; i++) {
+{
+integer_limb *limbs;                   /* operand magnitude                 */
+integer_limb carry;                    /* bit shifted into the next limb    */
+integer_limb next_carry;               /* bit shifted out of this limb      */
+int32 i;                               /* temporary looping variable        */
 
-#if GCC & MC68020
-{int tmp;
+   limbs = operand->o_limbs;
+   carry = 0;
 
-         __asm__ volatile("divsll %3,%1:%0" :
-                          "=d" (remainder), "=d" (tmp) :
-                          "0" (remainder), "d" (base));
-         *t-- = digit[tmp];
+   if (halve) {
 
-}                          
-#else
+      for (i = operand->o_limb_count - 1; i >= 0; i--) {
+         next_carry = limbs[i] << (INT_LIMB_WIDTH - 1);
+         limbs[i] = (limbs[i] >> 1) | carry;
+         carry = next_carry;
+      }
 
-         *t-- = digit[remainder % base];
-         remainder /= base;
+      trim_limbs(limbs,operand->o_limb_count);
 
-#endif
+   }
+   else {
 
+      for (i = 0; i < operand->o_limb_count; i++) {
+         next_carry = limbs[i] >> (INT_LIMB_WIDTH - 1);
+         limbs[i] = (limbs[i] << 1) | carry;
+         carry = next_carry;
       }
+
+      if (carry)
+         limbs[operand->o_limb_count++] = carry;
+
    }
 
-   /*
-    *  At this point we have a right-justified, zero-filled string.
-    *  Left-justify it.
-    */
+   return;
 
-   for (s = return_ptr + 1; *s == '0'; s++);
-   if (!*s)
-      s--;
+}
 
-   t = return_ptr;
-   if (header->i_is_negative)
-      *t++ = '-';
+/*\
+ *  \function{operand\_divide\_3()}
+ *
+ *  This function divides a signed operand by three, where we know the
+ *  division is exact.  Rather than dividing, we multiply each limb by
+ *  the inverse of three modulo the limb base, as in Jebelean's exact
+ *  division.
+\*/
 
-   while (*s)
-      *t++ = *s++;
-   *t = '\0';
+static void operand_divide_3(
+   struct integer_operand *operand)    /* operand to divide                 */
+
+{
+integer_limb *limbs;                   /* operand magnitude                 */
+integer_limb inverse;                  /* inverse of 3 modulo limb base     */
+integer_limb borrow;                   /* borrow from the next limb         */
+integer_limb next_borrow;              /* borrow for the following limb     */
+integer_limb quotient;                 /* one limb of the quotient          */
+int32 i;                               /* temporary looping variable        */
 
-   /* free the temporary integer (it's zero now) */
+   limbs = operand->o_limbs;
+   inverse = (integer_limb)~(integer_limb)0 / 3 * 2 + 1;
+   borrow = 0;
 
-   free_interp_integer(SETL_SYSTEM header);
+   for (i = 0; i < operand->o_limb_count; i++) {
 
-   return return_ptr;
+      next_borrow = (limbs[i] < borrow);
+      quotient = (limbs[i] - borrow) * inverse;
+      limbs[i] = quotient;
+      borrow = next_borrow +
+               (integer_limb)(((integer_dlimb)quotient * 3) >> INT_LIMB_WIDTH);
+
+   }
+
+   trim_limbs(limbs,operand->o_limb_count);
+
+   return;
 
 }
 
 /*\
- *  \function{integer\_add()}
+ *  \function{operand\_multiply()}
  *
- *  This function adds two integers, where the integers may be either
- *  short or long.  It is meant to be called from the core interpreter
- *  for long integers, or from built-in functions for either type
- *  integer.
+ *  This function multiplies two signed operands.  The target must have
+ *  room for the sum of the operand lengths, and must not overlap either
+ *  operand.
 \*/
 
-void integer_add(
+static void operand_multiply(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* result operand                    */
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
+   struct integer_operand *target,     /* product                           */
+   struct integer_operand *left,       /* left operand                      */
+   struct integer_operand *right)      /* right operand                     */
 
 {
-integer_h_ptr_type target_hdr, source_hdr;
-                                       /* header pointers for result and    */
-                                       /* operand                           */
-integer_c_ptr_type target_cell, source_cell;
-                                       /* cell pointers for result and      */
-                                       /* operand                           */
-int32 short_result;                    /* result of short arithmetic        */
-int32 carry;                           /* amount carried to higher order    */
-                                       /* cell                              */
-int32 hi_bits;                         /* high order bits of short integer  */
-specifier *swap;                       /* used to swap operands             */
 
-   /* if at least one of the operands is short, we can use a fast method */
+   limbs_multiply(SETL_SYSTEM target->o_limbs,
+                  left->o_limbs,left->o_limb_count,
+                  right->o_limbs,right->o_limb_count);
+   target->o_limb_count = left->o_limb_count + right->o_limb_count;
+   trim_limbs(target->o_limbs,target->o_limb_count);
+   target->o_is_negative = target->o_limb_count > 0 &&
+                           (left->o_is_negative ^ right->o_is_negative);
+
+   return;
+
+}
+
+/*\
+ *  \function{limbs\_multiply\_unbalanced()}
+ *
+ *  This function multiplies a long magnitude by one less than half as
+ *  long.  Karatsuba's and Toom's methods both want operands of about
+ *  the same length, so we cut the left operand into pieces as long as
+ *  the right, and add up the products of the pieces.
+\*/
 
-   if (left->sp_form == ft_short) {
+static void limbs_multiply_unbalanced(
+   SETL_SYSTEM_PROTO
+   integer_limb *target,               /* product                           */
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
-      if (right->sp_form == ft_short) {
+{
+integer_limb *work;                    /* product of one piece              */
+int32 piece_count;                     /* limbs in current piece            */
+int32 i;                               /* temporary looping variable        */
 
-         /*
-          *  Both operands are short.  We try adding the short values,
-          *  and if the result is short we return.  Otherwise we convert
-          *  the result to a long.
-          */
+   work = (integer_limb *)malloc((size_t)
+         (2 * right_count * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-         short_result = left->sp_val.sp_short_value +
-                        right->sp_val.sp_short_value;
+   for (i = 0; i < left_count + right_count; i++)
+      target[i] = 0;
 
-         /* check whether the result remains short */
+   for (i = 0; i < left_count; i += right_count) {
 
-         if (!(hi_bits = short_result & INT_HIGH_BITS) ||
-             hi_bits == INT_HIGH_BITS) {
+      piece_count = left_count - i;
+      if (piece_count > right_count)
+         piece_count = right_count;
 
-            unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_result;
+      limbs_multiply(SETL_SYSTEM work,left + i,piece_count,right,right_count);
+      limbs_accumulate(target + i,left_count + right_count - i,
+                       work,piece_count + right_count);
 
-            return;
+   }
 
-         }
+   free((void *)work);
 
-         /* if we exceed the maximum short, convert to long */
+   return;
 
-         short_to_long(SETL_SYSTEM target,short_result);
+}
 
-         return;
+/*\
+ *  \function{limbs\_multiply\_karatsuba()}
+ *
+ *  This function multiplies two magnitudes with Karatsuba's method.  We
+ *  split each operand at $h$ limbs, into $x_1 B^h + x_0$ and
+ *  $y_1 B^h + y_0$.  The product is then
+ *  $x_1 y_1 B^{2h} + ((x_0 + x_1)(y_0 + y_1) - x_0 y_0 - x_1 y_1) B^h
+ *  + x_0 y_0$, which needs three half length products rather than
+ *  four.  The right operand must be longer than $h$.
+\*/
 
-      }
+static void limbs_multiply_karatsuba(
+   SETL_SYSTEM_PROTO
+   integer_limb *target,               /* product                           */
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
-      /*
-       *  The left operand is short but the right is long.  We switch the
-       *  two operands.
-       */
+{
+integer_limb *work;                    /* scratch area                      */
+integer_limb *left_sum, *right_sum;    /* sums of operand halves            */
+integer_limb *middle;                  /* product of the sums               */
+int32 half;                            /* limbs in low order halves         */
+int32 left_sum_count, right_sum_count; /* limbs in sums                     */
+int32 middle_count;                    /* limbs in middle product           */
+int32 low_count, high_count;           /* limbs in low and high products    */
+
+   half = (left_count + 1) / 2;
+
+   work = (integer_limb *)malloc((size_t)
+         ((4 * half + 4) * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   left_sum = work;
+   right_sum = work + half + 1;
+   middle = work + 2 * half + 2;
 
-      swap = left;
-      left = right;
-      right = swap;
+   /* the low and high products go straight into the target */
 
-   }
+   limbs_multiply(SETL_SYSTEM target,left,half,right,half);
+   limbs_multiply(SETL_SYSTEM target + 2 * half,
+                  left + half,left_count - half,
+                  right + half,right_count - half);
 
-   /*
-    *  At this point we know that the left operand is long.  The right
-    *  operand can be either short or long.
-    */
+   /* multiply the sums of the halves */
 
-   /*
-    *  If the right operand is short, we need only add the short value to
-    *  the low order cell, and carry forward any carry value.
-    */
+   left_sum_count = limbs_add(left_sum,left,half,
+                              left + half,left_count - half);
+   right_sum_count = limbs_add(right_sum,right,half,
+                               right + half,right_count - half);
+   limbs_multiply(SETL_SYSTEM middle,left_sum,left_sum_count,
+                  right_sum,right_sum_count);
+   middle_count = left_sum_count + right_sum_count;
 
-   if (right->sp_form == ft_short) {
+   /* subtract the low and high products, and add in the difference */
 
-      /* we would like to use the left operand destructively */
+   low_count = 2 * half;
+   trim_limbs(target,low_count);
+   high_count = left_count + right_count - 2 * half;
+   trim_limbs(target + 2 * half,high_count);
 
-      if (target == left &&
-          target != right &&
-          (target->sp_val.sp_long_ptr)->i_use_count == 1) {
+   middle_count = limbs_subtract(middle,middle,middle_count,
+                                 target,low_count);
+   middle_count = limbs_subtract(middle,middle,middle_count,
+                                 target + 2 * half,high_count);
+   limbs_accumulate(target + half,left_count + right_count - half,
+                    middle,middle_count);
 
-         target_hdr = target->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
+   free((void *)work);
 
-      }
-      else {
+   return;
 
-         target_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
+}
 
-      }
+/*\
+ *  \function{limbs\_multiply\_toom3()}
+ *
+ *  This function multiplies two magnitudes with Toom's three way method.
+ *  We split each operand into three pieces of $k$ limbs, and think of
+ *  them as polynomials of degree two in $B^k$.  Their product is a
+ *  polynomial of degree four, which we find from its values at $0$,
+ *  $1$, $-1$, $-2$ and $\infty$, using Bodrato's interpolation
+ *  sequence.  That takes five products of length $k$ rather than nine.
+ *  The right operand must be longer than $2k$.
+\*/
 
-      /* we get the sign of the carry from the sign of the long */
+static void limbs_multiply_toom3(
+   SETL_SYSTEM_PROTO
+   integer_limb *target,               /* product                           */
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
-      if (target_hdr->i_is_negative)
-         carry = -(right->sp_val.sp_short_value);
-      else
-         carry = right->sp_val.sp_short_value;
+{
+integer_limb *work;                    /* scratch area                      */
+struct integer_operand x0, x1, x2;     /* pieces of the left operand        */
+struct integer_operand y0, y1, y2;     /* pieces of the right operand       */
+struct integer_operand x_1, x_m1, x_m2;
+                                       /* left operand at 1, -1 and -2      */
+struct integer_operand y_1, y_m1, y_m2;
+                                       /* right operand at 1, -1 and -2     */
+struct integer_operand r0, r1, r2, r3, r4;
+                                       /* product values, then its          */
+                                       /* coefficients                      */
+struct integer_operand sum;            /* sum of outer pieces               */
+int32 k;                               /* limbs in each piece               */
+int32 value_size, product_size;        /* scratch limbs for each value      */
+int32 product_count;                   /* limbs in whole product            */
+int32 i;                               /* temporary looping variable        */
 
-      target_cell = target_hdr->i_head;
+   k = (left_count + 2) / 3;
+   product_count = left_count + right_count;
+   value_size = k + 2;
+   product_size = 2 * k + 6;
 
-      /* traverse the list of cells until we have no carry value */
+   work = (integer_limb *)malloc((size_t)
+         ((7 * value_size + 3 * product_size) * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-      while (carry) {
+   x_1.o_limbs = work;
+   x_m1.o_limbs = x_1.o_limbs + value_size;
+   x_m2.o_limbs = x_m1.o_limbs + value_size;
+   y_1.o_limbs = x_m2.o_limbs + value_size;
+   y_m1.o_limbs = y_1.o_limbs + value_size;
+   y_m2.o_limbs = y_m1.o_limbs + value_size;
+   sum.o_limbs = y_m2.o_limbs + value_size;
+   r1.o_limbs = sum.o_limbs + value_size;
+   r2.o_limbs = r1.o_limbs + product_size;
+   r3.o_limbs = r2.o_limbs + product_size;
+
+   /* split the operands */
+
+   x0.o_limbs = left;
+   x0.o_limb_count = k;
+   x1.o_limbs = left + k;
+   x1.o_limb_count = k;
+   x2.o_limbs = left + 2 * k;
+   x2.o_limb_count = left_count - 2 * k;
+
+   y0.o_limbs = right;
+   y0.o_limb_count = k;
+   y1.o_limbs = right + k;
+   y1.o_limb_count = k;
+   y2.o_limbs = right + 2 * k;
+   y2.o_limb_count = right_count - 2 * k;
+
+   x0.o_is_negative = x1.o_is_negative = x2.o_is_negative = NO;
+   y0.o_is_negative = y1.o_is_negative = y2.o_is_negative = NO;
+
+   /* the products at 0 and infinity go straight into the target */
+
+   limbs_multiply(SETL_SYSTEM target,left,k,right,k);
+   limbs_multiply(SETL_SYSTEM target + 4 * k,
+                  x2.o_limbs,x2.o_limb_count,
+                  y2.o_limbs,y2.o_limb_count);
+   for (i = 2 * k; i < 4 * k; i++)
+      target[i] = 0;
+
+   r0.o_limbs = target;
+   r0.o_limb_count = 2 * k;
+   r0.o_is_negative = NO;
+   trim_limbs(r0.o_limbs,r0.o_limb_count);
+   r4.o_limbs = target + 4 * k;
+   r4.o_limb_count = product_count - 4 * k;
+   r4.o_is_negative = NO;
+   trim_limbs(r4.o_limbs,r4.o_limb_count);
+
+   trim_limbs(x0.o_limbs,x0.o_limb_count);
+   trim_limbs(x1.o_limbs,x1.o_limb_count);
+   trim_limbs(y0.o_limbs,y0.o_limb_count);
+   trim_limbs(y1.o_limbs,y1.o_limb_count);
+
+   /* evaluate each operand at 1, -1 and -2 */
+
+   operand_add(&sum,&x0,&x2,NO);
+   operand_add(&x_1,&sum,&x1,NO);
+   operand_add(&x_m1,&sum,&x1,YES);
+   operand_add(&x_m2,&x_m1,&x2,NO);
+   operand_shift(&x_m2,NO);
+   operand_add(&x_m2,&x_m2,&x0,YES);
+
+   operand_add(&sum,&y0,&y2,NO);
+   operand_add(&y_1,&sum,&y1,NO);
+   operand_add(&y_m1,&sum,&y1,YES);
+   operand_add(&y_m2,&y_m1,&y2,NO);
+   operand_shift(&y_m2,NO);
+   operand_add(&y_m2,&y_m2,&y0,YES);
+
+   /* find the product at those points */
+
+   operand_multiply(SETL_SYSTEM &r1,&x_1,&y_1);
+   operand_multiply(SETL_SYSTEM &r2,&x_m1,&y_m1);
+   operand_multiply(SETL_SYSTEM &r3,&x_m2,&y_m2);
+
+   /* interpolate, leaving the coefficients in r1, r2 and r3 */
+
+   operand_add(&r3,&r3,&r1,YES);
+   operand_divide_3(&r3);
+   operand_add(&r1,&r1,&r2,YES);
+   operand_shift(&r1,YES);
+   operand_add(&r2,&r2,&r0,YES);
+   operand_add(&r3,&r2,&r3,YES);
+   operand_shift(&r3,YES);
+   operand_add(&r3,&r3,&r4,NO);
+   operand_add(&r3,&r3,&r4,NO);
+   operand_add(&r2,&r2,&r1,NO);
+   operand_add(&r2,&r2,&r4,YES);
+   operand_add(&r1,&r1,&r3,YES);
+
+   /* add the middle coefficients into the target */
+
+   limbs_accumulate(target + k,product_count - k,
+                    r1.o_limbs,r1.o_limb_count);
+   limbs_accumulate(target + 2 * k,product_count - 2 * k,
+                    r2.o_limbs,r2.o_limb_count);
+   limbs_accumulate(target + 3 * k,product_count - 3 * k,
+                    r3.o_limbs,r3.o_limb_count);
+
+   free((void *)work);
 
-         /* check whether we must extend the target */
+   return;
 
-         if (target_cell == NULL) {
+}
 
-            get_integer_cell(target_cell);
-            (target_hdr->i_tail)->i_next = target_cell;
-            target_cell->i_prev = target_hdr->i_tail;
-            target_cell->i_next = NULL;
-            target_hdr->i_tail = target_cell;
-            target_hdr->i_cell_count++;
-            target_cell->i_cell_value = 0;
+/*
+ *  For the largest operands we multiply with number theoretic
+ *  transforms.  We cut the operands into 32 bit pieces and find their
+ *  convolution modulo three primes below $2^{30}$, each of the form
+ *  $c 2^m + 1$ so that it has roots of unity of order $2^m$.  Each
+ *  coefficient of the convolution is less than the product of the
+ *  primes, so we can recover it by the Chinese remainder theorem.
+ */
+
+#define NTT_PIECE_WIDTH   32           /* bits in a transform input piece   */
+#define NTT_PIECE_MASK    0xffffffffUL /* mask for one piece                */
+#define NTT_PIECES        (INT_LIMB_WIDTH / NTT_PIECE_WIDTH)
+                                       /* pieces in one limb                */
+#define NTT_MAX_LENGTH    (1L << 23)   /* longest transform all primes      */
+                                       /* support                           */
+#define NTT_MAX_PIECES    (1L << 21)   /* longest shorter operand, so the   */
+                                       /* coefficients fit                  */
+
+typedef unsigned int ntt_value;        /* residue modulo a transform prime  */
+typedef unsigned long long ntt_product;
+                                       /* product of two residues           */
+
+static ntt_value ntt_primes[3] = {998244353, 469762049, 167772161};
+                                       /* transform primes                  */
+static ntt_value ntt_generator = 3;    /* primitive root of all three       */
 
-         }
+/*\
+ *  \function{ntt\_power()}
+ *
+ *  This function raises a residue to a power, modulo a prime.
+\*/
 
-         /* add in the carry, which could create another */
+static ntt_value ntt_power(
+   ntt_value base,                     /* base residue                      */
+   ntt_value exponent,                 /* power                             */
+   ntt_value prime)                    /* modulus                           */
 
-         target_cell->i_cell_value += carry;
-         if (target_cell->i_cell_value < 0) {
-            carry = -1;
-            target_cell->i_cell_value += (MAX_INT_CELL + 1);
-         }
-         else {
-            carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-            target_cell->i_cell_value &= MAX_INT_CELL;
-         }
+{
+ntt_value result;                      /* accumulated power                 */
 
-         /* set up for the next cell */
+   result = 1;
+   while (exponent > 0) {
 
-         target_cell = target_cell->i_next;
+      if (exponent & 1)
+         result = (ntt_value)((ntt_product)result * base % prime);
+      base = (ntt_value)((ntt_product)base * base % prime);
+      exponent >>= 1;
 
-      }
    }
 
-   /*
-    *  At this point we know we have two long values.
-    */
+   return result;
 
-   else {
+}
+
+/*\
+ *  \function{ntt\_transform()}
+ *
+ *  This function performs a forward transform in place, with an
+ *  iterative radix two algorithm.  The caller gives us a table of the
+ *  first half of the powers of a root of unity of the transform's
+ *  order, each with Shoup's precomputed quotient
+ *  $\lfloor w 2^{32} / p \rfloor$, which lets us multiply by a fixed
+ *  residue without dividing.
+\*/
 
-      /* we would like to use an operand destructively */
+static void ntt_transform(
+   ntt_value *data,                    /* values to transform               */
+   int32 length,                       /* transform length                  */
+   ntt_value prime,                    /* modulus                           */
+   ntt_value *roots,                   /* powers of root of unity           */
+   ntt_value *quotients)               /* Shoup quotients of roots          */
 
-      if (target == left && target != right &&
-          (target->sp_val.sp_long_ptr)->i_use_count == 1) {
+{
+ntt_value u, v;                        /* butterfly inputs                  */
+ntt_value swap;                        /* temporary for bit reversal        */
+ntt_value estimate;                    /* estimated quotient                */
+int32 half;                            /* half a butterfly span             */
+int32 stride;                          /* root table stride                 */
+int32 bit;                             /* bit of reversed index             */
+int32 i,j;                             /* temporary looping variables       */
 
-         target_hdr = left->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
-         source_hdr = right->sp_val.sp_long_ptr;
+   /* permute the data to bit reversed order */
 
-      }
-      else if (target == right && target != left &&
-               (target->sp_val.sp_long_ptr)->i_use_count == 1) {
+   for (i = 1, j = 0; i < length; i++) {
 
-         target_hdr = right->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
-         source_hdr = left->sp_val.sp_long_ptr;
+      for (bit = length >> 1; j & bit; bit >>= 1)
+         j ^= bit;
+      j ^= bit;
 
+      if (i < j) {
+         swap = data[i];
+         data[i] = data[j];
+         data[j] = swap;
       }
-      else {
 
-         target_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
-         source_hdr = right->sp_val.sp_long_ptr;
+   }
 
-      }
+   /* combine transforms of doubling length */
 
-      /* if the two signs are the same, we add the structures */
+   for (half = 1; half < length; half <<= 1) {
 
-      if (target_hdr->i_is_negative == source_hdr->i_is_negative) {
+      stride = length / (2 * half);
 
-         source_cell = source_hdr->i_head;
-         target_cell = target_hdr->i_head;
-         carry = 0;
+      for (i = 0; i < length; i += 2 * half) {
 
-         /* add the source into the target */
+         for (j = 0; j < half; j++) {
 
-         while (source_cell != NULL) {
+            u = data[i + j];
+            v = data[i + j + half];
+            estimate = (ntt_value)(((ntt_product)v *
+                                    quotients[j * stride]) >> 32);
+            v = (ntt_value)((ntt_product)v * roots[j * stride] -
+                            (ntt_product)estimate * prime);
+            if (v >= prime)
+               v -= prime;
 
-            /* check whether we must extend the target */
+            data[i + j] = (u + v >= prime) ? u + v - prime : u + v;
+            data[i + j + half] = (u >= v) ? u - v : u + prime - v;
 
-            if (target_cell == NULL) {
+         }
 
-               get_integer_cell(target_cell);
-               (target_hdr->i_tail)->i_next = target_cell;
-               target_cell->i_prev = target_hdr->i_tail;
-               target_cell->i_next = NULL;
-               target_hdr->i_tail = target_cell;
-               target_hdr->i_cell_count++;
-               target_cell->i_cell_value = 0;
+      }
 
-            }
+   }
 
-            /* add in the source cell */
+   return;
 
-            target_cell->i_cell_value +=
-                  source_cell->i_cell_value + carry;
-            carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-            target_cell->i_cell_value &= MAX_INT_CELL;
+}
 
-            /* set up for the next cell */
+/*\
+ *  \function{limbs\_multiply\_ntt()}
+ *
+ *  This function multiplies two magnitudes with number theoretic
+ *  transforms.  For each prime we transform both operands, multiply
+ *  pointwise, and transform back.  An inverse transform is a forward
+ *  transform with the results after the first in reverse order, divided
+ *  by the length.  Then we combine the three residues of each
+ *  coefficient with Garner's algorithm and add up the coefficients.
+ *  If the operands are too long for the primes we return \verb"NO",
+ *  and the caller uses another method.
+\*/
 
-            target_cell = target_cell->i_next;
-            source_cell = source_cell->i_next;
+static int limbs_multiply_ntt(
+   SETL_SYSTEM_PROTO
+   integer_limb *target,               /* product                           */
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
-         }
+{
+ntt_value *work;                       /* scratch area                      */
+ntt_value *residues[3];                /* convolution modulo each prime     */
+ntt_value *other;                      /* transform of right operand        */
+ntt_value *roots, *quotients;          /* root table and Shoup quotients    */
+ntt_value prime;                       /* current prime                     */
+ntt_value root;                        /* root of unity of transform order  */
+ntt_value scale, scale_quotient;       /* inverse of length, and quotient   */
+ntt_value estimate;                    /* estimated quotient                */
+ntt_value inverse_1, inverse_12;       /* constants for Garner's algorithm  */
+ntt_value digit_2, digit_3;            /* mixed radix digits                */
+ntt_product value;                     /* coefficient modulo first two      */
+ntt_product modulus_12;                /* product of first two primes       */
+ntt_product low, high;                 /* partial products of third digit   */
+ntt_product sum;                       /* one word of running sum           */
+ntt_product carry_1, carry_2, carry_3; /* words of carry                    */
+int32 left_pieces, right_pieces;       /* pieces in each operand            */
+int32 length;                          /* transform length                  */
+int32 product_pieces;                  /* pieces in product                 */
+int square;                            /* YES if operands are the same      */
+int32 i,p;                             /* temporary looping variables       */
+
+   left_pieces = left_count * NTT_PIECES;
+   right_pieces = right_count * NTT_PIECES;
+   product_pieces = left_pieces + right_pieces;
+   if (right_pieces > NTT_MAX_PIECES || product_pieces > NTT_MAX_LENGTH)
+      return NO;
 
-         /* we might have a carry left */
+   length = 1;
+   while (length < product_pieces)
+      length <<= 1;
 
-         while (carry) {
+   square = (left == right && left_count == right_count);
 
-            /* check whether we must extend the target */
+   work = (ntt_value *)malloc((size_t)(5 * length * sizeof(ntt_value)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   residues[0] = work;
+   residues[1] = work + length;
+   residues[2] = work + 2 * length;
+   other = work + 3 * length;
+   roots = work + 4 * length;
+   quotients = roots + length / 2;
 
-            if (target_cell == NULL) {
+   /* find the convolution modulo each prime */
 
-               get_integer_cell(target_cell);
-               (target_hdr->i_tail)->i_next = target_cell;
-               target_cell->i_prev = target_hdr->i_tail;
-               target_cell->i_next = NULL;
-               target_hdr->i_tail = target_cell;
-               target_hdr->i_cell_count++;
-               target_cell->i_cell_value = 0;
+   for (p = 0; p < 3; p++) {
 
-            }
+      prime = ntt_primes[p];
 
-            /* add in the carry, which could create another */
+      root = ntt_power(ntt_generator,(prime - 1) / (ntt_value)length,prime);
+      roots[0] = 1;
+      for (i = 1; i < length / 2; i++)
+         roots[i] = (ntt_value)((ntt_product)roots[i - 1] * root % prime);
+      for (i = 0; i < length / 2; i++)
+         quotients[i] = (ntt_value)(((ntt_product)roots[i] << 32) / prime);
 
-            target_cell->i_cell_value += carry;
-            carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-            target_cell->i_cell_value &= MAX_INT_CELL;
+      for (i = 0; i < left_pieces; i++) {
+         residues[p][i] = (ntt_value)((left[i / NTT_PIECES] >>
+                             (NTT_PIECE_WIDTH * (i % NTT_PIECES))) &
+                             NTT_PIECE_MASK) % prime;
+      }
+      for (; i < length; i++)
+         residues[p][i] = 0;
+      ntt_transform(residues[p],length,prime,roots,quotients);
 
-            /* set up for the next cell */
+      if (square) {
 
-            target_cell = target_cell->i_next;
+         other = residues[p];
 
-         }
       }
-
-      /*
-       *  The problem is harder when the integers have opposite signs,
-       *  since we need to find the absolute value of the difference,
-       *  along with the sign of the difference.
-       */
-
       else {
 
-         source_cell = source_hdr->i_head;
-         target_cell = target_hdr->i_head;
-         carry = 0;
-
-         /* subtract the source from the target */
-
-         while (source_cell != NULL) {
-
-            /* check whether we must extend the target */
-
-            if (target_cell == NULL) {
-
-               get_integer_cell(target_cell);
-               (target_hdr->i_tail)->i_next = target_cell;
-               target_cell->i_prev = target_hdr->i_tail;
-               target_cell->i_next = NULL;
-               target_hdr->i_tail = target_cell;
-               target_hdr->i_cell_count++;
-               target_cell->i_cell_value = 0;
-
-            }
-
-            /* subtract the source cell */
-
-            target_cell->i_cell_value -=
-                  (source_cell->i_cell_value + carry);
-            if (target_cell->i_cell_value < 0) {
-               target_cell->i_cell_value += MAX_INT_CELL + 1;
-               carry = 1;
-            }
-            else {
-               carry = 0;
-            }
-
-            /* set up for the next cell */
-
-            target_cell = target_cell->i_next;
-            source_cell = source_cell->i_next;
-
+         other = work + 3 * length;
+         for (i = 0; i < right_pieces; i++) {
+            other[i] = (ntt_value)((right[i / NTT_PIECES] >>
+                          (NTT_PIECE_WIDTH * (i % NTT_PIECES))) &
+                          NTT_PIECE_MASK) % prime;
          }
+         for (; i < length; i++)
+            other[i] = 0;
+         ntt_transform(other,length,prime,roots,quotients);
 
-         /* if we have a carry, we extend it to the end of the integer */
-
-         while (target_cell != NULL && carry) {
-
-            /* add in the source cell */
+      }
 
-            target_cell->i_cell_value -= carry;
-            if (target_cell->i_cell_value < 0) {
-               target_cell->i_cell_value += MAX_INT_CELL + 1;
-               carry = 1;
-            }
-            else {
-               carry = 0;
-            }
+      /* multiply pointwise, dividing by the length as we go */
 
-            /* set up for the next cell */
+      scale = ntt_power((ntt_value)length,prime - 2,prime);
+      scale_quotient = (ntt_value)(((ntt_product)scale << 32) / prime);
 
-            target_cell = target_cell->i_next;
+      for (i = 0; i < length; i++) {
 
-         }
+         residues[p][i] = (ntt_value)((ntt_product)residues[p][i] *
+                                      other[i] % prime);
+         estimate = (ntt_value)(((ntt_product)residues[p][i] *
+                                 scale_quotient) >> 32);
+         residues[p][i] = (ntt_value)((ntt_product)residues[p][i] * scale -
+                                      (ntt_product)estimate * prime);
+         if (residues[p][i] >= prime)
+            residues[p][i] -= prime;
 
-         /* if we finished with a carry, flip the sign */
+      }
 
-         if (carry) {
+      ntt_transform(residues[p],length,prime,roots,quotients);
 
-            /* we subtract the carry, a high order 1 */
+   }
 
-            carry = 1;
-            for (target_cell = target_hdr->i_head;
-                 target_cell != NULL;
-                 target_cell = target_cell->i_next) {
+   /*
+    *  Garner's algorithm gives each coefficient as
+    *  $r_1 + p_1 d_2 + p_1 p_2 d_3$, which may be up to 87 bits.  We
+    *  add those into the product 32 bits at a time, with a three word
+    *  carry.  The inverse transforms left their results in reverse
+    *  order, after the first.
+    */
 
-               target_cell->i_cell_value =
-                  MAX_INT_CELL - target_cell->i_cell_value + carry;
-               carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-               target_cell->i_cell_value &= MAX_INT_CELL;
+   inverse_1 = ntt_power(ntt_primes[0] % ntt_primes[1],
+                         ntt_primes[1] - 2,ntt_primes[1]);
+   modulus_12 = (ntt_product)ntt_primes[0] * ntt_primes[1];
+   inverse_12 = ntt_power((ntt_value)(modulus_12 % ntt_primes[2]),
+                          ntt_primes[2] - 2,ntt_primes[2]);
 
-            }
+   for (i = 0; i < right_count + left_count; i++)
+      target[i] = 0;
 
-            /* we might have a carry left */
+   carry_1 = carry_2 = carry_3 = 0;
+   for (i = 0; i < product_pieces; i++) {
 
-            while (carry) {
+      if (i < length) {
 
-               /* check whether we must extend the target */
+         p = (i == 0) ? 0 : length - i;
 
-               if (target_cell == NULL) {
+         digit_2 = (ntt_value)((ntt_product)(residues[1][p] + ntt_primes[1] -
+                                  residues[0][p] % ntt_primes[1]) *
+                               inverse_1 % ntt_primes[1]);
+         value = residues[0][p] + (ntt_product)ntt_primes[0] * digit_2;
+         digit_3 = (ntt_value)((ntt_product)(residues[2][p] + ntt_primes[2] -
+                                  (ntt_value)(value % ntt_primes[2])) *
+                               inverse_12 % ntt_primes[2]);
 
-                  get_integer_cell(target_cell);
-                  (target_hdr->i_tail)->i_next = target_cell;
-                  target_cell->i_prev = target_hdr->i_tail;
-                  target_cell->i_next = NULL;
-                  target_hdr->i_tail = target_cell;
-                  target_hdr->i_cell_count++;
-                  target_cell->i_cell_value = 0;
+      }
+      else {
 
-               }
+         value = 0;
+         digit_3 = 0;
 
-               /* add in the carry, which could create another */
+      }
 
-               target_cell->i_cell_value += carry;
-               carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-               target_cell->i_cell_value &= MAX_INT_CELL;
+      low = (modulus_12 & NTT_PIECE_MASK) * digit_3;
+      high = (modulus_12 >> 32) * digit_3;
 
-               /* set up for the next cell */
+      sum = (value & NTT_PIECE_MASK) + (low & NTT_PIECE_MASK) + carry_1;
+      target[i / NTT_PIECES] |= (integer_limb)(sum & NTT_PIECE_MASK) <<
+                                (NTT_PIECE_WIDTH * (i % NTT_PIECES));
+      sum = (sum >> 32) + (value >> 32) + (low >> 32) +
+            (high & NTT_PIECE_MASK) + carry_2;
+      carry_1 = sum & NTT_PIECE_MASK;
+      sum = (sum >> 32) + (high >> 32) + carry_3;
+      carry_2 = sum & NTT_PIECE_MASK;
+      carry_3 = sum >> 32;
 
-               target_cell = target_cell->i_next;
+   }
 
-            }
+   free((void *)work);
 
-            /* finally, flip the sign flag */
+   return YES;
 
-            target_hdr->i_is_negative = !(target_hdr->i_is_negative);
+}
 
-         }
+/*\
+ *  \function{limbs\_multiply()}
+ *
+ *  This function multiplies two magnitudes, choosing a method by the
+ *  length of the shorter operand.  We use the classical method for
+ *  short operands, then Karatsuba's, Toom-3 and finally number
+ *  theoretic transforms, switching at the cutoffs in
+ *  \verb"karatsuba_cutoff", \verb"toom3_cutoff" and \verb"fft_cutoff".
+ *  The target must have room for the sum of the operand lengths, and
+ *  must not overlap either operand.  The high order limb of the product
+ *  may be zero.
+\*/
 
-         /* we eliminate high-order zero cells */
+static void limbs_multiply(
+   SETL_SYSTEM_PROTO
+   integer_limb *target,               /* product                           */
+   integer_limb *left,                 /* left magnitude                    */
+   int32 left_count,                   /* limbs in left magnitude           */
+   integer_limb *right,                /* right magnitude                   */
+   int32 right_count)                  /* limbs in right magnitude          */
 
-         target_cell = target_hdr->i_tail;
-         while (target_cell->i_prev != NULL &&
-                !(target_cell->i_cell_value)) {
+{
+integer_limb *swap_limbs;              /* temporary for swapping operands   */
+int32 swap_count;                      /* temporary for swapping operands   */
+int32 product_count;                   /* limbs in product                  */
+int32 i;                               /* temporary looping variable        */
 
-            target_hdr->i_tail = target_cell->i_prev;
-            free_integer_cell(target_cell);
-            target_cell = target_hdr->i_tail;
-            target_hdr->i_cell_count--;
+   /* drop high order zeros, which the subdivision methods produce */
 
-         }
+   product_count = left_count + right_count;
+   trim_limbs(left,left_count);
+   trim_limbs(right,right_count);
+   for (i = left_count + right_count; i < product_count; i++)
+      target[i] = 0;
 
-         target_cell->i_next = NULL;
+   /* make the left operand the longer */
 
-      }
+   if (left_count < right_count) {
+      swap_limbs = left;
+      left = right;
+      right = swap_limbs;
+      swap_count = left_count;
+      left_count = right_count;
+      right_count = swap_count;
    }
 
-   /* we eliminate high-order zero cells */
-
-   target_cell = target_hdr->i_tail;
-   while (target_cell->i_prev != NULL &&
-          !(target_cell->i_cell_value)) {
-
-      target_hdr->i_tail = target_cell->i_prev;
-      free_integer_cell(target_cell);
-      target_cell = target_hdr->i_tail;
-      target_hdr->i_cell_count--;
-
+   if (right_count < karatsuba_cutoff || right_count < MIN_SPLIT_LIMBS) {
+      limbs_multiply_classical(target,left,left_count,right,right_count);
+      return;
    }
 
-   target_cell->i_next = NULL;
-
-   /* the target hash code is now invalid */
-
-   target_hdr->i_hash_code = -1;
+   if (right_count >= fft_cutoff &&
+       limbs_multiply_ntt(SETL_SYSTEM target,left,left_count,
+                          right,right_count))
+      return;
 
-   /*
-    *  Now we have a long value in the target.  We would like to use
-    *  short values whenever possible, so we check whether it will fit in
-    *  a short.  If so, we convert it.
-    */
+   if (right_count <= (left_count + 1) / 2) {
+      limbs_multiply_unbalanced(SETL_SYSTEM target,left,left_count,
+                                right,right_count);
+      return;
+   }
 
-   if (target_hdr->i_cell_count < 3) {
+   if (right_count >= toom3_cutoff &&
+       right_count > 2 * ((left_count + 2) / 3)) {
+      limbs_multiply_toom3(SETL_SYSTEM target,left,left_count,
+                           right,right_count);
+      return;
+   }
 
-      /* build up a long value */
+   limbs_multiply_karatsuba(SETL_SYSTEM target,left,left_count,
+                            right,right_count);
 
-      carry = (target_hdr->i_head)->i_cell_value;
-      if (target_hdr->i_cell_count == 2) {
+   return;
 
-         carry += (((target_hdr->i_head)->i_next)->i_cell_value) <<
-                    INT_CELL_WIDTH;
+}
 
-      }
+/*\
+ *  \function{limbs\_divide\_1()}
+ *
+ *  This function divides a magnitude by a single limb, returning the
+ *  remainder.  The quotient may be the same array as the dividend.
+\*/
 
-      if (target_hdr->i_is_negative)
-         carry = -carry;
+static integer_limb limbs_divide_1(
+   integer_limb *quotient,             /* quotient                          */
+   integer_limb *left,                 /* dividend magnitude                */
+   int32 left_count,                   /* limbs in dividend                 */
+   integer_limb divisor)               /* single limb divisor               */
 
-      /* check whether it will fit in a short */
+{
+integer_dlimb dividend;                /* two limb partial dividend         */
+integer_limb remainder;                /* running remainder                 */
+int32 i;                               /* temporary looping variable        */
 
-      if (!(hi_bits = carry & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
+   remainder = 0;
 
-         free_interp_integer(SETL_SYSTEM target_hdr);
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = carry;
+   for (i = left_count - 1; i >= 0; i--) {
 
-         return;
+      dividend = ((integer_dlimb)remainder << INT_LIMB_WIDTH) | left[i];
+      quotient[i] = (integer_limb)(dividend / divisor);
+      remainder = (integer_limb)(dividend % divisor);
 
-      }
    }
 
-   /*
-    *  We're stuck with a long.  Set the target and return.
-    */
-
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = target_hdr;
-
-   return;
+   return remainder;
 
 }
 
 /*\
- *  \function{integer\_subtract()}
+ *  \function{limbs\_divide()}
  *
- *  This function subtracts two integers, where the integers may be
- *  either short or long.  It is meant to be called from the core
- *  interpreter for long integers, or from built-in functions for either
- *  type integer.
+ *  This function divides one magnitude by another, using Knuth's
+ *  Algorithm D.  The divisor must have at least two limbs, and the
+ *  dividend must be at least as long as the divisor.  The quotient gets
+ *  one more limb than the difference in lengths and the remainder as
+ *  many limbs as the divisor, either of which may have high order
+ *  zeros.
+ *
+ *  We shift both operands left so that the divisor's high order bit is
+ *  set.  Then our estimate of each quotient limb from the two high order
+ *  limbs of the partial remainder is at most two too large.
 \*/
 
-void integer_subtract(
+static void limbs_divide(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* result operand                    */
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
+   integer_limb *quotient,             /* quotient                          */
+   integer_limb *remainder,            /* remainder                         */
+   integer_limb *left,                 /* dividend magnitude                */
+   int32 left_count,                   /* limbs in dividend                 */
+   integer_limb *right,                /* divisor magnitude                 */
+   int32 right_count)                  /* limbs in divisor                  */
 
 {
-integer_h_ptr_type target_hdr, source_hdr;
-                                       /* header pointers for result and    */
-                                       /* operand                           */
-integer_c_ptr_type target_cell, source_cell;
-                                       /* cell pointers for result and      */
-                                       /* operand                           */
-int32 short_result;                    /* result of short arithmetic        */
-int32 carry;                           /* amount carried to higher order    */
-                                       /* cell                              */
-int32 hi_bits;                         /* high order bits of short integer  */
-specifier *swap;                       /* used to swap operands             */
-int reverse_sign;                      /* YES if we should reverse the      */
-                                       /* sign of the result                */
+integer_limb *work;                    /* shifted dividend, then divisor    */
+integer_limb *u, *v;                   /* shifted dividend and divisor      */
+integer_dlimb dividend;                /* high order of partial remainder   */
+integer_dlimb estimate;                /* estimated quotient limb           */
+integer_dlimb estimate_remainder;      /* remainder of estimate             */
+integer_dlimb product;                 /* estimate times one divisor limb   */
+integer_limb carry;                    /* carry to the next limb            */
+integer_limb borrow, next_borrow;      /* borrow from the next limb         */
+integer_limb difference;               /* difference of one limb            */
+int shift;                             /* normalization shift               */
+int32 i,j;                             /* temporary looping variables       */
+
+   work = (integer_limb *)malloc((size_t)
+         ((left_count + 1 + right_count) * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   u = work;
+   v = work + left_count + 1;
 
-   reverse_sign = NO;
+   /* normalize, so the divisor's high order bit is set */
 
-   /* if at least one of the operands is short, we can use a fast method */
+   shift = 0;
+   while (!(right[right_count - 1] &
+            ((integer_limb)1 << (INT_LIMB_WIDTH - shift - 1))))
+      shift++;
 
-   if (left->sp_form == ft_short) {
+   if (shift == 0) {
 
-      if (right->sp_form == ft_short) {
+      memcpy((void *)v,(void *)right,
+             (size_t)(right_count * sizeof(integer_limb)));
+      memcpy((void *)u,(void *)left,
+             (size_t)(left_count * sizeof(integer_limb)));
+      u[left_count] = 0;
 
-         /*
-          *  Both operands are short.  We try subtracting the short
-          *  values, and if the result is short we return.  Otherwise we
-          *  convert the result to a long.
-          */
+   }
+   else {
 
-         short_result = left->sp_val.sp_short_value -
-                        right->sp_val.sp_short_value;
+      for (i = right_count - 1; i > 0; i--)
+         v[i] = (right[i] << shift) |
+                (right[i - 1] >> (INT_LIMB_WIDTH - shift));
+      v[0] = right[0] << shift;
 
-         /* check whether the result remains short */
+      u[left_count] = left[left_count - 1] >> (INT_LIMB_WIDTH - shift);
+      for (i = left_count - 1; i > 0; i--)
+         u[i] = (left[i] << shift) |
+                (left[i - 1] >> (INT_LIMB_WIDTH - shift));
+      u[0] = left[0] << shift;
 
-         if (!(hi_bits = short_result & INT_HIGH_BITS) ||
-             hi_bits == INT_HIGH_BITS) {
+   }
 
-            unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_result;
+   /* find each quotient limb, from high order to low */
 
-            return;
+   for (j = left_count - right_count; j >= 0; j--) {
 
-         }
+      /* estimate the quotient limb, and correct it if it's too large */
 
-         /* if we exceed the maximum short, convert to long */
+      dividend = ((integer_dlimb)u[j + right_count] << INT_LIMB_WIDTH) |
+                 u[j + right_count - 1];
+      estimate = dividend / v[right_count - 1];
+      estimate_remainder = dividend % v[right_count - 1];
 
-         short_to_long(SETL_SYSTEM target,short_result);
+      while ((estimate >> INT_LIMB_WIDTH) != 0 ||
+             estimate * v[right_count - 2] >
+                ((estimate_remainder << INT_LIMB_WIDTH) |
+                 u[j + right_count - 2])) {
 
-         return;
+         estimate--;
+         estimate_remainder += v[right_count - 1];
+         if ((estimate_remainder >> INT_LIMB_WIDTH) != 0)
+            break;
 
       }
 
-      /*
-       *  The left operand is short but the right is long.  We switch the
-       *  two operands.
-       */
+      /* subtract the estimate times the divisor */
 
-      swap = left;
-      left = right;
-      right = swap;
+      carry = 0;
+      borrow = 0;
+      for (i = 0; i < right_count; i++) {
 
-      /* since we swapped operands we must reverse the sign of the result */
+         product = estimate * v[i] + carry;
+         carry = (integer_limb)(product >> INT_LIMB_WIDTH);
+         difference = u[i + j] - (integer_limb)product;
+         next_borrow = (u[i + j] < (integer_limb)product);
+         next_borrow |= (difference < borrow);
+         u[i + j] = difference - borrow;
+         borrow = next_borrow;
 
-      reverse_sign = YES;
+      }
 
-   }
+      difference = u[j + right_count] - carry;
+      next_borrow = (u[j + right_count] < carry);
+      next_borrow |= (difference < borrow);
+      u[j + right_count] = difference - borrow;
 
-   /*
-    *  At this point we know that the left operand is long.  The right
-    *  operand can be either short or long.
-    */
+      /* if we went negative, the estimate was one too large */
 
-   /*
-    *  If the right operand is short, we need only add the short value to
-    *  the low order cell, and carry forward any carry value.
-    */
+      if (next_borrow) {
 
-   if (right->sp_form == ft_short) {
+         estimate--;
+         carry = 0;
+         for (i = 0; i < right_count; i++) {
 
-      /* we would like to use the left operand destructively */
+            product = (integer_dlimb)u[i + j] + v[i] + carry;
+            u[i + j] = (integer_limb)product;
+            carry = (integer_limb)(product >> INT_LIMB_WIDTH);
 
-      if (target == left &&
-          target != right &&
-          (target->sp_val.sp_long_ptr)->i_use_count == 1) {
+         }
 
-         target_hdr = target->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
+         u[j + right_count] += carry;
 
       }
-      else {
-
-         target_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
 
-      }
+      quotient[j] = (integer_limb)estimate;
 
-      /* we get the sign of the carry from the sign of the long */
+   }
 
-      if (target_hdr->i_is_negative)
-         carry = right->sp_val.sp_short_value;
-      else
-         carry = -(right->sp_val.sp_short_value);
+   /* unnormalize the remainder */
 
-      target_cell = target_hdr->i_head;
+   if (shift == 0) {
 
-      /* traverse the list of cells until we have no carry value */
+      memcpy((void *)remainder,(void *)u,
+             (size_t)(right_count * sizeof(integer_limb)));
 
-      while (carry) {
+   }
+   else {
 
-         /* check whether we must extend the target */
+      for (i = 0; i < right_count - 1; i++)
+         remainder[i] = (u[i] >> shift) |
+                        (u[i + 1] << (INT_LIMB_WIDTH - shift));
+      remainder[right_count - 1] = u[right_count - 1] >> shift;
 
-         if (target_cell == NULL) {
+   }
 
-            get_integer_cell(target_cell);
-            (target_hdr->i_tail)->i_next = target_cell;
-            target_cell->i_prev = target_hdr->i_tail;
-            target_cell->i_next = NULL;
-            target_hdr->i_tail = target_cell;
-            target_hdr->i_cell_count++;
-            target_cell->i_cell_value = 0;
+   free((void *)work);
 
-         }
+   return;
 
-         /* add in the carry, which could create another */
+}
 
-         target_cell->i_cell_value += carry;
-         if (target_cell->i_cell_value < 0) {
-            carry = -1;
-            target_cell->i_cell_value += (MAX_INT_CELL + 1);
-         }
-         else {
-            carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-            target_cell->i_cell_value &= MAX_INT_CELL;
-         }
+/*\
+ *  \function{get\_operand()}
+ *
+ *  This function unpacks a short or long integer specifier into a sign
+ *  and magnitude.  The magnitude of a long operand is not copied, so the
+ *  operand is only valid until the specifier changes.
+\*/
 
-         /* set up for the next cell */
+static void get_operand(
+   specifier *source,                  /* integer specifier                 */
+   struct integer_operand *operand)    /* unpacked operand                  */
 
-         target_cell = target_cell->i_next;
+{
+integer_h_ptr_type source_hdr;         /* long integer header               */
+unsigned long magnitude;               /* absolute value of short           */
 
-      }
-   }
+   if (spec_form(source) == ft_short) {
 
-   /*
-    *  At this point we know we have two long values.
-    */
+      /*
+       *  We negate as unsigned, since the most negative long has no
+       *  positive counterpart.
+       */
 
-   else {
+      if (spec_val(source,sp_short_value) < 0) {
+         operand->o_is_negative = YES;
+         magnitude = -(unsigned long)(spec_val(source,sp_short_value));
+      }
+      else {
+         operand->o_is_negative = NO;
+         magnitude = spec_val(source,sp_short_value);
+      }
 
-      /* we would like to use an operand destructively */
+      /* we shift in two steps, in case a limb is as wide as a long */
 
-      if (target == left && target != right &&
-          (target->sp_val.sp_long_ptr)->i_use_count == 1) {
+      operand->o_limbs = operand->o_short;
+      operand->o_limb_count = 0;
+      while (magnitude) {
 
-         target_hdr = left->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
-         source_hdr = right->sp_val.sp_long_ptr;
+         operand->o_short[operand->o_limb_count++] = (integer_limb)magnitude;
+         magnitude >>= INT_LIMB_WIDTH / 2;
+         magnitude >>= INT_LIMB_WIDTH / 2;
 
       }
-      else if (target == right && target != left &&
-               (target->sp_val.sp_long_ptr)->i_use_count == 1) {
 
-         target_hdr = right->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
-         source_hdr = left->sp_val.sp_long_ptr;
+      return;
 
-         /* since we swapped operands we must reverse the sign */
+   }
 
-         reverse_sign = YES;
+   source_hdr = spec_val(source,sp_long_ptr);
+   operand->o_limbs = source_hdr->i_limbs;
+   operand->o_limb_count = source_hdr->i_limb_count;
+   operand->o_is_negative = source_hdr->i_is_negative;
 
-      }
-      else {
+   return;
 
-         target_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
-         source_hdr = right->sp_val.sp_long_ptr;
+}
 
-      }
+/*\
+ *  \function{short\_to\_long()}
+ *
+ *  This function converts a C long value into a SETL2 integer. It is used
+ *  primarily when we try to perform short arithmetic and find an
+ *  overflow.
+\*/
 
-      /* if the two signs are different, we add the structures */
+void short_to_long(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* SETL2 integer result              */
+   int32 source)                       /* C long value                      */
 
-      if (target_hdr->i_is_negative != source_hdr->i_is_negative) {
+{
+integer_h_ptr_type target_hdr;         /* work integer header pointer       */
+specifier work_spec;                   /* source as a specifier             */
+struct integer_operand operand;        /* source as sign and magnitude      */
 
-         source_cell = source_hdr->i_head;
-         target_cell = target_hdr->i_head;
-         carry = 0;
+   /* if we can use a short integer do so */
 
-         /* add the source into the target */
+   if (is_short_value(source)) {
 
-         while (source_cell != NULL) {
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,source);
 
-            /* check whether we must extend the target */
+      return;
 
-            if (target_cell == NULL) {
+   }
 
-               get_integer_cell(target_cell);
-               (target_hdr->i_tail)->i_next = target_cell;
-               target_cell->i_prev = target_hdr->i_tail;
-               target_cell->i_next = NULL;
-               target_hdr->i_tail = target_cell;
-               target_hdr->i_cell_count++;
-               target_cell->i_cell_value = 0;
+   /* otherwise create a long integer */
 
-            }
+   spec_set_form(&work_spec,ft_short);
+   spec_set_val(&work_spec,sp_short_value,source);
+   get_operand(&work_spec,&operand);
 
-            /* add in the source cell */
+   target_hdr = new_integer(SETL_SYSTEM operand.o_limb_count);
+   memcpy((void *)(target_hdr->i_limbs),(void *)(operand.o_limbs),
+          (size_t)(operand.o_limb_count * sizeof(integer_limb)));
+   target_hdr->i_limb_count = operand.o_limb_count;
+   target_hdr->i_is_negative = operand.o_is_negative;
 
-            target_cell->i_cell_value +=
-                  source_cell->i_cell_value + carry;
-            carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-            target_cell->i_cell_value &= MAX_INT_CELL;
+   unmark_specifier(target);
+   spec_set_form(target,ft_long);
+   spec_set_val(target,sp_long_ptr,target_hdr);
 
-            /* set up for the next cell */
+   return;
 
-            target_cell = target_cell->i_next;
-            source_cell = source_cell->i_next;
+}
 
-         }
+/*\
+ *  \function{long\_to\_short()}
+ *
+ *  This function converts a SETL2 long value into a C long.  We assume
+ *  that the long integer will fit into a C long.
+\*/
 
-         /* we might have a carry left */
+int32 long_to_short(
+   SETL_SYSTEM_PROTO
+   integer_h_ptr_type source)          /* SETL2 integer source              */
 
-         while (carry) {
+{
+unsigned long magnitude;               /* absolute value of integer         */
+int32 i;                               /* temporary looping variable        */
 
-            /* check whether we must extend the target */
+   magnitude = 0;
+   for (i = min(source->i_limb_count,SHORT_LIMBS) - 1; i >= 0; i--) {
 
-            if (target_cell == NULL) {
+      magnitude <<= INT_LIMB_WIDTH / 2;
+      magnitude <<= INT_LIMB_WIDTH / 2;
+      magnitude |= source->i_limbs[i];
 
-               get_integer_cell(target_cell);
-               (target_hdr->i_tail)->i_next = target_cell;
-               target_cell->i_prev = target_hdr->i_tail;
-               target_cell->i_next = NULL;
-               target_hdr->i_tail = target_cell;
-               target_hdr->i_cell_count++;
-               target_cell->i_cell_value = 0;
+   }
 
-            }
+   if (source->i_is_negative)
+      return -(int32)magnitude;
 
-            /* add in the carry, which could create another */
+   return (int32)magnitude;
 
-            target_cell->i_cell_value += carry;
-            carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-            target_cell->i_cell_value &= MAX_INT_CELL;
+}
 
-            /* set up for the next cell */
+/*\
+ *  \function{normalize\_long()}
+ *
+ *  This function stores a long integer we have just built in a target
+ *  specifier.  We would like to use short values whenever possible, so
+ *  if the integer will fit in a short we release the limbs and store a
+ *  short instead.
+\*/
 
-            target_cell = target_cell->i_next;
+void normalize_long(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* SETL2 integer result              */
+   integer_h_ptr_type source)          /* long integer to be stored         */
 
-         }
-      }
+{
+unsigned long magnitude;               /* absolute value of integer         */
+int32 i;                               /* temporary looping variable        */
 
-      /*
-       *  The problem is harder when the integers have the same signs,
-       *  since we need to find the absolute value of the difference,
-       *  along with the sign of the difference.
-       */
+   trim_limbs(source->i_limbs,source->i_limb_count);
 
-      else {
+   /* if the integer fits in a short, store that */
 
-         source_cell = source_hdr->i_head;
-         target_cell = target_hdr->i_head;
-         carry = 0;
+   if (source->i_limb_count <= SHORT_LIMBS) {
 
-         /* subtract the source from the target */
+      magnitude = 0;
+      for (i = source->i_limb_count - 1; i >= 0; i--) {
 
-         while (source_cell != NULL) {
+         magnitude <<= INT_LIMB_WIDTH / 2;
+         magnitude <<= INT_LIMB_WIDTH / 2;
+         magnitude |= source->i_limbs[i];
 
-            /* check whether we must extend the target */
+      }
 
-            if (target_cell == NULL) {
+      if (magnitude <= (unsigned long)SHORT_INT_MAX) {
 
-               get_integer_cell(target_cell);
-               (target_hdr->i_tail)->i_next = target_cell;
-               target_cell->i_prev = target_hdr->i_tail;
-               target_cell->i_next = NULL;
-               target_hdr->i_tail = target_cell;
-               target_hdr->i_cell_count++;
-               target_cell->i_cell_value = 0;
+         unmark_specifier(target);
+         spec_set_form(target,ft_short);
+         if (source->i_is_negative)
+            spec_set_val(target,sp_short_value,-(int32)magnitude);
+         else
+            spec_set_val(target,sp_short_value,(int32)magnitude);
+         free_interp_integer(SETL_SYSTEM source);
 
-            }
+         return;
 
-            /* subtract the source cell */
+      }
+   }
 
-            target_cell->i_cell_value -=
-                  (source_cell->i_cell_value + carry);
-            if (target_cell->i_cell_value < 0) {
-               target_cell->i_cell_value += MAX_INT_CELL + 1;
-               carry = 1;
-            }
-            else {
-               carry = 0;
-            }
+   /* we're stuck with a long */
 
-            /* set up for the next cell */
+   source->i_hash_code = -1;
 
-            target_cell = target_cell->i_next;
-            source_cell = source_cell->i_next;
+   unmark_specifier(target);
+   spec_set_form(target,ft_long);
+   spec_set_val(target,sp_long_ptr,source);
 
-         }
+   return;
 
-         /* if we have a carry, we extend it to the end of the integer */
+}
 
-         while (target_cell != NULL && carry) {
+/*\
+ *  \function{long\_to\_double()}
+ *
+ *  This function converts a SETL2 long integer into a C double. We use it
+ *  for explicit type conversions.
+\*/
 
-            /* add in the source cell */
+double long_to_double(
+   SETL_SYSTEM_PROTO
+   specifier *source)                  /* SETL2 long integer                */
 
-            target_cell->i_cell_value -= carry;
-            if (target_cell->i_cell_value < 0) {
-               target_cell->i_cell_value += MAX_INT_CELL + 1;
-               carry = 1;
-            }
-            else {
-               carry = 0;
-            }
+{
+double return_value;                   /* returned value                    */
+double limb_base;                      /* value of one in the next limb     */
+integer_h_ptr_type source_hdr;         /* long integer header               */
+int32 i;                               /* temporary looping variable        */
 
-            /* set up for the next cell */
+   source_hdr = spec_val(source,sp_long_ptr);
+   limb_base = (double)((integer_limb)1 << (INT_LIMB_WIDTH - 1)) * 2.0;
+   return_value = 0.0;
 
-            target_cell = target_cell->i_next;
+   /* loop over the limbs from high to low order, adding them to the result */
 
-         }
+   for (i = source_hdr->i_limb_count - 1; i >= 0; i--)
+      return_value = return_value * limb_base + (double)source_hdr->i_limbs[i];
 
-         /* if we finished with a carry, flip the sign */
+   /* set the sign of the result */
 
-         if (carry) {
+   if (source_hdr->i_is_negative)
+      return_value = -return_value;
 
-            /* we subtract the carry, a high order 1 */
+   return return_value;
 
-            carry = 1;
-            for (target_cell = target_hdr->i_head;
-                 target_cell != NULL;
-                 target_cell = target_cell->i_next) {
+}
 
-               target_cell->i_cell_value =
-                  MAX_INT_CELL - target_cell->i_cell_value + carry;
-               carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-               target_cell->i_cell_value &= MAX_INT_CELL;
+/*
+ *  Radix conversion of long integers divides and multiplies by the
+ *  powers $P_i = c^{2^i}$ of the base, where $c$ is the largest power
+ *  of the base which fits in a limb.  We keep those powers, and the
+ *  reciprocals we use to divide by them, from one conversion to the
+ *  next, for the most recently used base.
+ */
+
+#define RADIX_LEVELS      40           /* most powers we keep               */
+
+struct radix_power {
+   integer_limb *rp_limbs;             /* power of the base                 */
+   int32 rp_limb_count;                /* limbs in power                    */
+   integer_limb *rp_reciprocal;        /* $\lfloor B^{2n} / P_i \rfloor$,   */
+                                       /* or NULL until we need it          */
+   int32 rp_reciprocal_count;          /* limbs in reciprocal               */
+};
+
+static int radix_base = 0;             /* base of cached powers             */
+static integer_limb radix_chunk;       /* largest power in a limb           */
+static int radix_chunk_digits;         /* digits in that power              */
+static int radix_level_count = 0;      /* number of powers computed         */
+static struct radix_power radix_powers[RADIX_LEVELS];
+                                       /* powers of the base                */
 
-            }
+static char digit[] = {                /* digit character table             */
+   '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+   'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j',
+   'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't',
+   'u', 'v', 'w', 'x', 'y', 'z'};
 
-            /* we might have a carry left */
+/*\
+ *  \function{radix\_setup()}
+ *
+ *  This function prepares the power cache for a base.  If the cache
+ *  holds powers of some other base, we discard them.
+\*/
 
-            while (carry) {
+static void radix_setup(
+   SETL_SYSTEM_PROTO
+   int base)                           /* number base                       */
 
-               /* check whether we must extend the target */
+{
+int i;                                 /* temporary looping variable        */
 
-               if (target_cell == NULL) {
+   if (base == radix_base)
+      return;
 
-                  get_integer_cell(target_cell);
-                  (target_hdr->i_tail)->i_next = target_cell;
-                  target_cell->i_prev = target_hdr->i_tail;
-                  target_cell->i_next = NULL;
-                  target_hdr->i_tail = target_cell;
-                  target_hdr->i_cell_count++;
-                  target_cell->i_cell_value = 0;
+   for (i = 0; i < radix_level_count; i++) {
 
-               }
+      free((void *)(radix_powers[i].rp_limbs));
+      if (radix_powers[i].rp_reciprocal != NULL)
+         free((void *)(radix_powers[i].rp_reciprocal));
 
-               /* add in the carry, which could create another */
+   }
 
-               target_cell->i_cell_value += carry;
-               carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-               target_cell->i_cell_value &= MAX_INT_CELL;
+   radix_base = base;
+   radix_chunk = base;
+   radix_chunk_digits = 1;
+   while (radix_chunk <= ~(integer_limb)0 / base) {
+      radix_chunk *= base;
+      radix_chunk_digits++;
+   }
 
-               /* set up for the next cell */
+   radix_powers[0].rp_limbs = (integer_limb *)malloc(sizeof(integer_limb));
+   if (radix_powers[0].rp_limbs == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   radix_powers[0].rp_limbs[0] = radix_chunk;
+   radix_powers[0].rp_limb_count = 1;
+   radix_powers[0].rp_reciprocal = NULL;
+   radix_level_count = 1;
 
-               target_cell = target_cell->i_next;
+   return;
 
-            }
+}
 
-            /* finally, flip the sign flag */
+/*\
+ *  \function{limbs\_reciprocal()}
+ *
+ *  This function finds $\lfloor B^{2n} / d \rfloor$ for an $n$ limb
+ *  divisor $d$, where $B$ is the limb base.  The target needs $n + 2$
+ *  limbs.  Short divisors we divide directly.
+ *
+ *  For longer divisors we use one step of Newton's iteration.  We find
+ *  the reciprocal $r$ of the high order $h$ limbs of $d$, plus one, a
+ *  little more than half as many limbs as $d$.  Shifted left
+ *  $n - h$ limbs that is a little smaller than the reciprocal of $d$,
+ *  with about $h$ limbs of precision.  Then
+ *  $x + \lfloor x (B^{2n} - d x) / B^{2n} \rfloor$ doubles the precision
+ *  and is still no larger than the reciprocal, so we correct it by
+ *  adding one a few times.
+\*/
 
-            target_hdr->i_is_negative = !(target_hdr->i_is_negative);
+#define RECIPROCAL_CUTOFF 16           /* divide directly below this        */
 
-         }
+static int32 limbs_reciprocal(
+   SETL_SYSTEM_PROTO
+   integer_limb *target,               /* reciprocal                        */
+   integer_limb *divisor,              /* divisor magnitude                 */
+   int32 count)                        /* limbs in divisor                  */
 
-         /* we eliminate high-order zero cells */
+{
+integer_limb *work;                    /* scratch area                      */
+integer_limb *top;                     /* high order limbs of divisor       */
+integer_limb *top_reciprocal;          /* reciprocal of those limbs         */
+integer_limb *product;                 /* divisor times estimate            */
+integer_limb *correction;              /* Newton correction                 */
+integer_limb borrow;                   /* borrow from the next limb         */
+int32 top_count;                       /* limbs in top                      */
+int32 top_reciprocal_count;            /* limbs in top_reciprocal           */
+int32 product_count;                   /* limbs in product                  */
+int32 correction_count;                /* limbs in correction               */
+int32 target_count;                    /* limbs in target                   */
+int32 i;                               /* temporary looping variable        */
 
-         target_cell = target_hdr->i_tail;
-         while (target_cell->i_prev != NULL &&
-                !(target_cell->i_cell_value)) {
+   /* divide short divisors directly */
 
-            target_hdr->i_tail = target_cell->i_prev;
-            free_integer_cell(target_cell);
-            target_cell = target_hdr->i_tail;
-            target_hdr->i_cell_count--;
+   if (count <= RECIPROCAL_CUTOFF) {
 
-         }
+      work = (integer_limb *)malloc((size_t)
+            ((4 * count + 2) * sizeof(integer_limb)));
+      if (work == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-         target_cell->i_next = NULL;
+      for (i = 0; i < 2 * count; i++)
+         work[i] = 0;
+      work[2 * count] = 1;
 
+      if (count == 1) {
+         limbs_divide_1(target,work,2 * count + 1,divisor[0]);
+      }
+      else {
+         limbs_divide(SETL_SYSTEM target,work + 2 * count + 1,
+                      work,2 * count + 1,divisor,count);
       }
-   }
-
-   /* flip the sign if necessary */
-
-   target_hdr->i_is_negative ^= reverse_sign;
 
-   /* we eliminate high-order zero cells */
+      free((void *)work);
 
-   target_cell = target_hdr->i_tail;
-   while (target_cell->i_prev != NULL &&
-          !(target_cell->i_cell_value)) {
+      target_count = count + 2;
+      trim_limbs(target,target_count);
 
-      target_hdr->i_tail = target_cell->i_prev;
-      free_integer_cell(target_cell);
-      target_cell = target_hdr->i_tail;
-      target_hdr->i_cell_count--;
+      return target_count;
 
    }
 
-   target_cell->i_next = NULL;
+   top_count = (count + 1) / 2 + 2;
 
-   /* the target hash code is now invalid */
+   work = (integer_limb *)malloc((size_t)
+         ((8 * count + 8) * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   top = work;
+   top_reciprocal = top + top_count + 1;
+   product = top_reciprocal + top_count + 2;
+   correction = product + 2 * count + 2;
 
-   target_hdr->i_hash_code = -1;
+   /* find the reciprocal of the high order limbs, plus one */
 
-   /*
-    *  Now we have a long value in the target.  We would like to use
-    *  short values whenever possible, so we check whether it will fit in
-    *  a short.  If so, we convert it.
-    */
+   for (i = 0; i < top_count; i++)
+      top[i] = divisor[count - top_count + i];
+   for (i = 0; i < top_count && ++top[i] == 0; i++);
 
-   if (target_hdr->i_cell_count < 3) {
+   if (i == top_count) {
 
-      /* build up a long value */
+      for (i = 0; i < top_count; i++)
+         top_reciprocal[i] = 0;
+      top_reciprocal[top_count] = 1;
+      top_reciprocal_count = top_count + 1;
 
-      carry = (target_hdr->i_head)->i_cell_value;
-      if (target_hdr->i_cell_count == 2) {
+   }
+   else {
 
-         carry += (((target_hdr->i_head)->i_next)->i_cell_value) <<
-                    INT_CELL_WIDTH;
+      top_reciprocal_count = limbs_reciprocal(SETL_SYSTEM top_reciprocal,
+                                              top,top_count);
 
-      }
+   }
+
+   /*
+    *  Our estimate is the top reciprocal shifted left, so the error
+    *  $B^{2n} - d x$ is $B^{n-h}$ times $B^{n+h}$ less the divisor times
+    *  the top reciprocal.
+    */
 
-      if (target_hdr->i_is_negative)
-         carry = -carry;
+   limbs_multiply(SETL_SYSTEM product,divisor,count,
+                  top_reciprocal,top_reciprocal_count);
 
-      /* check whether it will fit in a short */
+   borrow = 0;
+   for (i = 0; i < count + top_count; i++) {
+      product[i] = (integer_limb)0 - product[i] - borrow;
+      borrow = borrow | (product[i] != 0);
+   }
+   product_count = count + top_count;
+   trim_limbs(product,product_count);
+
+   /* the correction is the top reciprocal times the error, over B^{2h} */
+
+   limbs_multiply(SETL_SYSTEM correction,top_reciprocal,top_reciprocal_count,
+                  product,product_count);
+   correction_count = top_reciprocal_count + product_count - 2 * top_count;
+
+   for (i = 0; i < count - top_count; i++)
+      target[i] = 0;
+   for (i = 0; i < top_reciprocal_count; i++)
+      target[count - top_count + i] = top_reciprocal[i];
+   target_count = count - top_count + top_reciprocal_count;
+   for (i = target_count; i < count + 2; i++)
+      target[i] = 0;
+
+   if (correction_count > 0) {
+      trim_limbs(correction + 2 * top_count,correction_count);
+      limbs_accumulate(target,count + 2,
+                       correction + 2 * top_count,correction_count);
+   }
 
-      if (!(hi_bits = carry & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
+   target_count = count + 2;
+   trim_limbs(target,target_count);
 
-         free_interp_integer(SETL_SYSTEM target_hdr);
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = carry;
+   /* now add one while the error is at least the divisor */
 
-         return;
+   limbs_multiply(SETL_SYSTEM product,divisor,count,target,target_count);
 
-      }
+   borrow = 0;
+   for (i = 0; i < 2 * count; i++) {
+      product[i] = (integer_limb)0 - product[i] - borrow;
+      borrow = borrow | (product[i] != 0);
    }
+   product_count = 2 * count;
+   trim_limbs(product,product_count);
 
-   /*
-    *  We're stuck with a long.  Set the target and return.
-    */
+   while (limbs_compare(product,product_count,divisor,count) >= 0) {
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = target_hdr;
+      product_count = limbs_subtract(product,product,product_count,
+                                     divisor,count);
+      for (i = 0; ++target[i] == 0; i++);
+      if (i >= target_count)
+         target_count = i + 1;
 
-   return;
+   }
+
+   free((void *)work);
+
+   return target_count;
 
 }
 
 /*\
- *  \function{integer\_multiply()}
+ *  \function{radix\_power()}
  *
- *  This function multiplies two integers, where the integers may be either
- *  short or long.  It is meant to be called from the core interpreter
- *  for long integers, or for built-in functions for either type integer.
+ *  This function returns the power $P_i$ of the current base, computing
+ *  it by squaring if it isn't already in the cache.  If we want to
+ *  divide by it we compute its reciprocal too.
 \*/
 
-void integer_multiply(
+static struct radix_power *radix_power(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* result location                   */
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
+   int level,                          /* which power we want               */
+   int need_reciprocal)                /* YES if we will divide by it       */
 
 {
-integer_h_ptr_type target_hdr, left_hdr, right_hdr;
-                                       /* header pointers for result and    */
-                                       /* operands                          */
-integer_c_ptr_type target_cell, last_target_cell, left_cell, right_cell;
-                                       /* cell pointers for result and      */
-                                       /* operands                          */
-int32 short_result;                    /* result of short arithmetic        */
-int32 hi_bits;                         /* high order bits of short integer  */
-int32 carry;                           /* amount carried to higher order    */
-                                       /* cell                              */
-specifier *swap;                       /* used to swap operands             */
+struct radix_power *power;             /* power we return                   */
+struct radix_power *root;              /* power we square                   */
 
-   /* if at least one of the operands is short, we can use a fast method */
+   if (level >= RADIX_LEVELS)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-   if (left->sp_form == ft_short) {
+   while (radix_level_count <= level) {
 
-      if (right->sp_form == ft_short) {
+      root = radix_powers + radix_level_count - 1;
+      power = radix_powers + radix_level_count;
 
-         /*
-          *  Both operands are short.  We try multiplying the short values,
-          *  and if the result is short we return.  Otherwise we convert
-          *  the result to a long.
-          */
+      power->rp_limbs = (integer_limb *)malloc((size_t)
+            (2 * root->rp_limb_count * sizeof(integer_limb)));
+      if (power->rp_limbs == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-         short_result = left->sp_val.sp_short_value *
-                        right->sp_val.sp_short_value;
+      limbs_multiply(SETL_SYSTEM power->rp_limbs,
+                     root->rp_limbs,root->rp_limb_count,
+                     root->rp_limbs,root->rp_limb_count);
+      power->rp_limb_count = 2 * root->rp_limb_count;
+      trim_limbs(power->rp_limbs,power->rp_limb_count);
+      power->rp_reciprocal = NULL;
 
-         /* check whether the result remains short */
+      radix_level_count++;
 
-         if (!(hi_bits = short_result & INT_HIGH_BITS) ||
-             hi_bits == INT_HIGH_BITS) {
+   }
 
-            unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_result;
+   power = radix_powers + level;
 
-            return;
+   if (need_reciprocal && power->rp_reciprocal == NULL) {
 
-         }
+      power->rp_reciprocal = (integer_limb *)malloc((size_t)
+            ((power->rp_limb_count + 2) * sizeof(integer_limb)));
+      if (power->rp_reciprocal == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-         /* if we exceed the maximum short, convert to long */
+      power->rp_reciprocal_count =
+         limbs_reciprocal(SETL_SYSTEM power->rp_reciprocal,
+                          power->rp_limbs,power->rp_limb_count);
 
-         short_to_long(SETL_SYSTEM target,short_result);
+   }
 
-         return;
+   return power;
 
-      }
+}
 
-      /*
-       *  The left operand is short but the right is long.  We switch the
-       *  two operands.
-       */
+/*\
+ *  \function{radix\_divide()}
+ *
+ *  This function divides a magnitude by a power of the base, where the
+ *  magnitude is less than the square of the power.  We multiply by the
+ *  reciprocal to estimate the quotient, which can only be a little too
+ *  small, and then correct it.  The quotient needs as many limbs as the
+ *  dividend, and the remainder as many as the power.
+\*/
 
-      swap = left;
-      left = right;
-      right = swap;
+static void radix_divide(
+   SETL_SYSTEM_PROTO
+   integer_limb *quotient,             /* quotient                          */
+   int32 *quotient_count,              /* limbs in quotient                 */
+   integer_limb *remainder,            /* remainder                         */
+   int32 *remainder_count,             /* limbs in remainder                */
+   integer_limb *left,                 /* dividend magnitude                */
+   int32 left_count,                   /* limbs in dividend                 */
+   struct radix_power *power)          /* divisor                           */
 
-   }
+{
+integer_limb *work;                    /* scratch area                      */
+int32 count;                           /* limbs in power                    */
+int32 work_count;                      /* limbs in work                     */
+int32 i;                               /* temporary looping variable        */
 
-   /*
-    *  At this point we know that the left operand is long.  The right
-    *  operand can be either short or long.
-    */
+   count = power->rp_limb_count;
 
-   /*
-    *  If the right operand is short, we need only multiply the short
-    *  value from the low order cell, and carry forward any carry value.
-    */
+   work = (integer_limb *)malloc((size_t)
+         ((left_count + power->rp_reciprocal_count + 1) *
+          sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-   if (right->sp_form == ft_short) {
+   /* estimate the quotient */
 
-      /* we would like to use the left operand destructively */
+   limbs_multiply(SETL_SYSTEM work,left,left_count,
+                  power->rp_reciprocal,power->rp_reciprocal_count);
 
-      if (target == left &&
-          target != right &&
-          (target->sp_val.sp_long_ptr)->i_use_count == 1) {
+   *quotient_count = left_count + power->rp_reciprocal_count - 2 * count;
+   if (*quotient_count < 0)
+      *quotient_count = 0;
+   for (i = 0; i < *quotient_count; i++)
+      quotient[i] = work[2 * count + i];
+   trim_limbs(quotient,*quotient_count);
 
-         target_hdr = target->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
+   /* find the remainder */
 
-      }
-      else {
+   if (*quotient_count > 0) {
 
-         target_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
+      limbs_multiply(SETL_SYSTEM work,quotient,*quotient_count,
+                     power->rp_limbs,count);
+      work_count = *quotient_count + count;
+      trim_limbs(work,work_count);
+      *remainder_count = limbs_subtract(remainder,left,left_count,
+                                        work,work_count);
 
-      }
+   }
+   else {
 
-      /* extract the short value and find the sign of the result */
+      for (i = 0; i < left_count; i++)
+         remainder[i] = left[i];
+      *remainder_count = left_count;
 
-      short_result = right->sp_val.sp_short_value;
-      if (short_result < 0) {
-         target_hdr->i_is_negative = !(target_hdr->i_is_negative);
-         short_result = -short_result;
-      }
+   }
 
-      target_hdr->i_hash_code = -1;
-      target_cell = target_hdr->i_head;
-      carry = 0;
+   /* the estimate may be a little small */
 
-      /* traverse the list of cells */
+   while (limbs_compare(remainder,*remainder_count,
+                        power->rp_limbs,count) >= 0) {
 
-      while (target_cell != NULL) {
+      *remainder_count = limbs_subtract(remainder,
+                                        remainder,*remainder_count,
+                                        power->rp_limbs,count);
+      for (i = 0; i < *quotient_count && ++quotient[i] == 0; i++);
+      if (i == *quotient_count)
+         quotient[(*quotient_count)++] = 1;
 
-         /* multiply one cell */
+   }
 
-         target_cell->i_cell_value = target_cell->i_cell_value *
-                                     short_result + carry;
+   free((void *)work);
 
-         /* carry forward the high order bits */
+   return;
 
-         carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-         target_cell->i_cell_value &= MAX_INT_CELL;
+}
 
-         /* set up for the next cell */
+/*\
+ *  \function{radix\_to\_digits()}
+ *
+ *  This function writes the digits of a magnitude less than $P_i$, as
+ *  exactly as many characters as $P_i$ has zeros, with leading zeros.
+ *  Short magnitudes we convert with repeated division by $c$, taking
+ *  several digits from each remainder.  Longer ones we divide by
+ *  $P_{i-1}$ and convert the quotient and remainder separately, so
+ *  the conversion takes a logarithmic number of multiplications.  The
+ *  magnitude is destroyed.
+\*/
 
-         target_cell = target_cell->i_next;
+#define RADIX_CUTOFF      30           /* limbs we convert directly         */
 
-      }
+static void radix_to_digits(
+   SETL_SYSTEM_PROTO
+   char *target,                       /* digit characters                  */
+   integer_limb *limbs,                /* magnitude                         */
+   int32 count,                        /* limbs in magnitude                */
+   int level)                          /* magnitude is below this power     */
 
-      /* we might have a carry left */
+{
+struct radix_power *power;             /* divisor power                     */
+integer_limb *work;                    /* quotient and remainder            */
+integer_limb remainder;                /* remainder of one division by c    */
+int32 width;                           /* number of digits we write         */
+int32 quotient_count;                  /* limbs in quotient                 */
+int32 remainder_count;                 /* limbs in remainder                */
+char *t;                               /* temporary looping variable        */
+int i;                                 /* temporary looping variable        */
 
-      if (carry) {
+   width = (int32)radix_chunk_digits << level;
+   trim_limbs(limbs,count);
 
-         get_integer_cell(target_cell);
-         (target_hdr->i_tail)->i_next = target_cell;
-         target_cell->i_prev = target_hdr->i_tail;
-         target_cell->i_next = NULL;
-         target_hdr->i_tail = target_cell;
-         target_hdr->i_cell_count++;
-         target_cell->i_cell_value = carry;
+   if (level == 0 || count <= RADIX_CUTOFF) {
 
-      }
-   }
+      t = target + width;
+      while (count > 0) {
 
-   /*
-    *  At this point we know we have two long values.
-    */
+         remainder = limbs_divide_1(limbs,limbs,count,radix_chunk);
+         trim_limbs(limbs,count);
 
-   else {
+         for (i = 0; i < radix_chunk_digits && t > target; i++) {
+            *--t = digit[remainder % radix_base];
+            remainder /= radix_base;
+         }
 
-      /* create a brand new target with a value 0 */
+      }
 
-      get_integer_header(target_hdr);
-      target_hdr->i_cell_count = 1;
-      target_hdr->i_use_count = 1;
-      target_hdr->i_hash_code = -1;
-      target_hdr->i_is_negative = (left->sp_val.sp_long_ptr)->i_is_negative ^
-                                  (right->sp_val.sp_long_ptr)->i_is_negative;
+      while (t > target)
+         *--t = '0';
 
-      get_integer_cell(target_cell);
-      target_cell->i_cell_value = 0;
-      target_cell->i_next = target_cell->i_prev = NULL;
-      target_hdr->i_head = target_hdr->i_tail = target_cell;
-      last_target_cell = target_cell;
+      return;
 
-      left_hdr = left->sp_val.sp_long_ptr;
-      right_hdr = right->sp_val.sp_long_ptr;
+   }
 
-      /* multiply the left by each cell on the right */
+   power = radix_power(SETL_SYSTEM level - 1,YES);
 
-      for (right_cell = right_hdr->i_head;
-           right_cell != NULL;
-           right_cell = right_cell->i_next) {
+   if (count < power->rp_limb_count) {
 
-         short_result = right_cell->i_cell_value;
-         left_cell = (left_hdr)->i_head;
-         target_cell = last_target_cell;
-         carry = 0;
+      memset((void *)target,'0',(size_t)(width / 2));
+      radix_to_digits(SETL_SYSTEM target + width / 2,limbs,count,level - 1);
 
-         /* multiply the target by the source */
+      return;
 
-         while (left_cell != NULL) {
+   }
 
-            /* check whether we must extend the target */
+   work = (integer_limb *)malloc((size_t)
+         ((2 * count + 1) * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-            if (target_cell == NULL) {
+   radix_divide(SETL_SYSTEM work,&quotient_count,
+                work + count + 1,&remainder_count,
+                limbs,count,power);
 
-               get_integer_cell(target_cell);
-               (target_hdr->i_tail)->i_next = target_cell;
-               target_cell->i_prev = target_hdr->i_tail;
-               target_cell->i_next = NULL;
-               target_hdr->i_tail = target_cell;
-               target_hdr->i_cell_count++;
-               target_cell->i_cell_value = 0;
-               if (last_target_cell == NULL)
-                  last_target_cell = target_cell;
+   radix_to_digits(SETL_SYSTEM target,work,quotient_count,level - 1);
+   radix_to_digits(SETL_SYSTEM target + width / 2,
+                   work + count + 1,remainder_count,level - 1);
 
-            }
+   free((void *)work);
 
-            /* multiply one cell */
+   return;
 
-            target_cell->i_cell_value += short_result *
-                                      left_cell->i_cell_value +
-                                      carry;
+}
 
-            carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-            target_cell->i_cell_value &= MAX_INT_CELL;
+/*\
+ *  \function{integer\_string()}
+ *
+ *  This function returns a character string representation of a SETL2
+ *  integer in a given base.  We find the smallest cached power of the
+ *  base larger than the magnitude, write the digits with
+ *  \verb"radix_to_digits()", and drop the leading zeros.
+ *
+ *  We should note that this function uses \verb"malloc()" to allocate a
+ *  return buffer.  The caller should free this buffer after it uses the
+ *  string.
+\*/
 
-            /* set up for the next cell */
+char *integer_string(
+   SETL_SYSTEM_PROTO
+   specifier *spec,                    /* specifier                         */
+   int base)                           /* number base of string             */
 
-            target_cell = target_cell->i_next;
-            left_cell = left_cell->i_next;
+{
+char *return_ptr;                      /* returned string pointer           */
+integer_h_ptr_type header;             /* integer to be printed             */
+integer_limb *work;                    /* work copy of magnitude            */
+int32 work_count;                      /* limbs in work copy                */
+struct radix_power *power;             /* power larger than magnitude       */
+int32 width;                           /* digits including leading zeros    */
+int level;                             /* level of that power               */
+char *s,*t;                            /* temporary looping variables       */
 
-         }
+   header = spec_val(spec,sp_long_ptr);
+   radix_setup(SETL_SYSTEM base);
 
-         /* we might have a carry left */
+   /* find a power of the base larger than the magnitude */
 
-         while (carry) {
+   level = 0;
+   for (;;) {
 
-            /* check whether we must extend the target */
+      power = radix_power(SETL_SYSTEM level,NO);
+      if (limbs_compare(power->rp_limbs,power->rp_limb_count,
+                        header->i_limbs,header->i_limb_count) > 0)
+         break;
+      level++;
 
-            if (target_cell == NULL) {
+   }
 
-               get_integer_cell(target_cell);
-               (target_hdr->i_tail)->i_next = target_cell;
-               target_cell->i_prev = target_hdr->i_tail;
-               target_cell->i_next = NULL;
-               target_hdr->i_tail = target_cell;
-               target_hdr->i_cell_count++;
-               target_cell->i_cell_value = 0;
-               if (last_target_cell == NULL)
-                  last_target_cell = target_cell;
+   width = (int32)radix_chunk_digits << level;
 
-            }
+   /* copy the magnitude, for destructive use */
 
-            /* add in the carry, which could create another */
+   work_count = header->i_limb_count;
+   work = (integer_limb *)malloc((size_t)
+         ((work_count + 1) * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
+   memcpy((void *)work,(void *)(header->i_limbs),
+          (size_t)(work_count * sizeof(integer_limb)));
 
-            target_cell->i_cell_value += carry;
-            carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-            target_cell->i_cell_value &= MAX_INT_CELL;
+   /* write the digits after room for a sign, and drop leading zeros */
 
-            /* set up for the next cell */
+   return_ptr = (char *)malloc((size_t)(width + 2));
+   if (return_ptr == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-            target_cell = target_cell->i_next;
+   radix_to_digits(SETL_SYSTEM return_ptr + 1,work,work_count,level);
+   return_ptr[width + 1] = '\0';
 
-         }
+   for (s = return_ptr + 1; *s == '0' && *(s + 1); s++);
 
-         last_target_cell = last_target_cell->i_next;
+   t = return_ptr;
+   if (header->i_is_negative)
+      *t++ = '-';
 
-      }
-   }
+   while (*s)
+      *t++ = *s++;
+   *t = '\0';
 
-   /* we eliminate high-order zero cells */
+   free((void *)work);
 
-   target_cell = target_hdr->i_tail;
-   while (target_cell->i_prev != NULL &&
-          !(target_cell->i_cell_value)) {
+   return return_ptr;
 
-      target_hdr->i_tail = target_cell->i_prev;
-      free_integer_cell(target_cell);
-      target_cell = target_hdr->i_tail;
-      target_hdr->i_cell_count--;
+}
 
-   }
+/*\
+ *  \function{radix\_from\_digits()}
+ *
+ *  This function converts a string of digit values, high order first,
+ *  to a magnitude, and returns the number of limbs.  The target needs a
+ *  limb for each digit in $c$, rounded up, plus one.  Short strings we
+ *  convert by multiplying by $c$ and adding the next several digits.
+ *  For longer strings we split off the low order digits as the largest
+ *  $P_i$ with fewer digits than the string, and convert the high order
+ *  part times $P_i$ plus the low order part.
+\*/
 
-   target_cell->i_next = NULL;
+static int32 radix_from_digits(
+   SETL_SYSTEM_PROTO
+   integer_limb *target,               /* magnitude                         */
+   char *digits,                       /* digit values                      */
+   int32 digit_count)                  /* number of digits                  */
 
-   /*
-    *  Now we have a long value in the target.  We would like to use
-    *  short values whenever possible, so we check whether it will fit in
-    *  a short.  If so, we convert it.
-    */
+{
+struct radix_power *power;             /* power for low order digits        */
+integer_limb *work;                    /* high and low order parts          */
+integer_limb *low;                     /* low order part                    */
+integer_limb multiplier;               /* power of base for next digits     */
+integer_limb addend;                   /* value of next digits              */
+integer_limb carry;                    /* carry to the next limb            */
+integer_dlimb product;                 /* product of limb, plus carry       */
+int32 low_width;                       /* number of low order digits        */
+int32 count, high_count, low_count;    /* limbs in result and parts         */
+int32 i,j;                             /* temporary looping variables       */
+int level;                             /* level of low order power          */
+
+   if (digit_count <= RADIX_CUTOFF * radix_chunk_digits) {
+
+      count = 0;
+      i = 0;
+      while (i < digit_count) {
+
+         /* the first group is short, so the rest are whole */
+
+         j = (i == 0 && digit_count % radix_chunk_digits != 0) ?
+             digit_count % radix_chunk_digits : radix_chunk_digits;
+
+         multiplier = 1;
+         addend = 0;
+         for (; j > 0; j--, i++) {
+            multiplier *= radix_base;
+            addend = addend * radix_base + digits[i];
+         }
 
-   if (target_hdr->i_cell_count < 3) {
+         carry = addend;
+         for (j = 0; j < count; j++) {
+            product = (integer_dlimb)target[j] * multiplier + carry;
+            target[j] = (integer_limb)product;
+            carry = (integer_limb)(product >> INT_LIMB_WIDTH);
+         }
+         if (carry)
+            target[count++] = carry;
 
-      /* build up a long value */
+      }
 
-      carry = (target_hdr->i_head)->i_cell_value;
-      if (target_hdr->i_cell_count == 2) {
+      return count;
 
-         carry += (((target_hdr->i_head)->i_next)->i_cell_value) <<
-                    INT_CELL_WIDTH;
+   }
 
-      }
+   /* find the largest power with fewer digits than the string */
 
-      if (target_hdr->i_is_negative)
-         carry = -carry;
+   level = 0;
+   while (((int32)radix_chunk_digits << (level + 1)) < digit_count)
+      level++;
+   low_width = (int32)radix_chunk_digits << level;
+   power = radix_power(SETL_SYSTEM level,NO);
 
-      /* check whether it will fit in a short */
+   work = (integer_limb *)malloc((size_t)
+         ((digit_count / radix_chunk_digits + 4) * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-      if (!(hi_bits = carry & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
+   high_count = radix_from_digits(SETL_SYSTEM work,digits,
+                                  digit_count - low_width);
+   low = work + high_count;
+   low_count = radix_from_digits(SETL_SYSTEM low,
+                                 digits + digit_count - low_width,low_width);
 
-         free_interp_integer(SETL_SYSTEM target_hdr);
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = carry;
+   if (high_count == 0) {
 
-         return;
+      for (i = 0; i < low_count; i++)
+         target[i] = low[i];
+      count = low_count;
 
-      }
    }
+   else {
 
-   /*
-    *  We're stuck with a long.  Set the target and return.
-    */
+      limbs_multiply(SETL_SYSTEM target,work,high_count,
+                     power->rp_limbs,power->rp_limb_count);
+      count = high_count + power->rp_limb_count;
+      limbs_accumulate(target,count,low,low_count);
+      trim_limbs(target,count);
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = target_hdr;
+   }
 
-   return;
+   free((void *)work);
+
+   return count;
 
 }
 
 /*\
- *  \function{integer\_divide()}
+ *  \function{integer\_from\_digits()}
  *
- *  This function divides two integers, where the integers may be either
- *  short or long.  It is meant to be called from the core interpreter
- *  for long integers, or for built-in functions for either type integer.
+ *  This function converts a string of digit values in a given base,
+ *  high order first, to a new long integer.  The result is positive
+ *  and not normalized, so the caller may set the sign and then call
+ *  \verb"normalize_long()".
 \*/
 
-void integer_divide(
+integer_h_ptr_type integer_from_digits(
    SETL_SYSTEM_PROTO
-   specifier *target,                  /* result operand                    */
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
+   char *digits,                       /* digit values                      */
+   int32 digit_count,                  /* number of digits                  */
+   int base)                           /* number base                       */
 
 {
-integer_h_ptr_type target_hdr, left_hdr, right_hdr;
-                                       /* header pointers for result and    */
-                                       /* operands                          */
-integer_c_ptr_type target_cell, left_cell, left_cell_head, right_cell;
-                                       /* cell pointers for result and      */
-                                       /* operands                          */
-int32 carry;                           /* amount carried to higher order    */
-                                       /* cell                              */
-int32 hi_bits;                         /* high order bits of short integer  */
-int32 save_carry;                      /* saved carry                       */
-int32 short_result;                    /* amount to divide by               */
-unsigned int32 cell_multiplier;        /* multiplied by divisor during      */
-                                       /* division operation                */
-int passes;                            /* number of passes through          */
-                                       /* algorithm                         */
-int i;                                 /* temporary looping variable        */
+integer_h_ptr_type target_hdr;         /* result header                     */
 
-   /* if at least one of the operands is short, we can use a fast method */
+   radix_setup(SETL_SYSTEM base);
 
-   if (left->sp_form == ft_short) {
+   target_hdr = new_integer(SETL_SYSTEM
+                            digit_count / radix_chunk_digits + 2);
+   target_hdr->i_limb_count =
+      radix_from_digits(SETL_SYSTEM target_hdr->i_limbs,digits,digit_count);
 
-      if (right->sp_form == ft_short) {
+   return target_hdr;
 
-         /*
-          *  Both operands are short.  We try dividing the short values,
-          *  and if the result is short we return.  Otherwise we convert
-          *  the result to a long.
-          */
-
-         if (right->sp_val.sp_short_value == 0)
-            abend(SETL_SYSTEM msg_zero_divide);
-
-         short_result = left->sp_val.sp_short_value /
-                        right->sp_val.sp_short_value;
-
-         /* check whether the result remains short */
-
-         if (!(hi_bits = short_result & INT_HIGH_BITS) ||
-             hi_bits == INT_HIGH_BITS) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_result;
-
-            return;
-
-         }
-
-         /* if we exceed the maximum short, convert to long */
-
-         short_to_long(SETL_SYSTEM target,short_result);
-
-         return;
-
-      }
-
-      /*
-       *  The left operand is short but the right is long.  If the long
-       *  is two cells long we can divide.  Otherwise we return zero.
-       */
+}
 
-      right_hdr = right->sp_val.sp_long_ptr;
-      if (right_hdr->i_cell_count > 2) {
+/*\
+ *  \function{set\_integer\_cell()}
+ *
+ *  Library and binary files hold long integers as cells of
+ *  \verb"INT_CELL_WIDTH" bits, low order first.  This function stores
+ *  one such cell in an integer.  We expect to start with a zero integer
+ *  from \verb"new_integer()", and the caller should store the result
+ *  with \verb"normalize_long()" once all the cells are in.
+\*/
 
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = 0;
+void set_integer_cell(
+   SETL_SYSTEM_PROTO
+   integer_h_ptr_type target,          /* integer being built               */
+   int32 index,                        /* cell number, low order first      */
+   int32 value)                        /* cell value                        */
 
-         return;
+{
+int32 bit;                             /* position of cell's low order bit  */
+int32 limb;                            /* limb holding that bit             */
+int shift;                             /* position of bit within limb       */
+int32 limb_count;                      /* limbs needed for cell             */
 
-      }
+   bit = index * INT_CELL_WIDTH;
+   limb = bit / INT_LIMB_WIDTH;
+   shift = (int)(bit % INT_LIMB_WIDTH);
 
-      short_result = left->sp_val.sp_short_value /
-         ((((right_hdr->i_head)->i_next)->i_cell_value << INT_CELL_WIDTH) +
-         (right_hdr->i_head)->i_cell_value);
-      if (right_hdr->i_is_negative)
-         short_result = -short_result;
+   /* extend the integer with zero limbs */
 
-      unmark_specifier(target);
-      target->sp_form = ft_short;
-      target->sp_val.sp_short_value = short_result;
+   limb_count = (bit + INT_CELL_WIDTH + INT_LIMB_WIDTH - 1) / INT_LIMB_WIDTH;
+   if (limb_count > target->i_limb_count) {
 
-      return;
+      reserve_limbs(SETL_SYSTEM target,limb_count);
+      while (target->i_limb_count < limb_count)
+         target->i_limbs[target->i_limb_count++] = 0;
 
    }
 
-   /*
-    *  At this point we know that the left operand is long.  The right
-    *  operand can be either short or long.
-    */
+   /* the cell may straddle two limbs */
 
-   /*
-    *  If the right operand is short, we need only divide the long by
-    *  the short value.
-    */
+   target->i_limbs[limb] |= (integer_limb)value << shift;
+   if (shift + (int)INT_CELL_WIDTH > INT_LIMB_WIDTH)
+      target->i_limbs[limb + 1] |=
+         (integer_limb)value >> (INT_LIMB_WIDTH - shift);
 
-   if (right->sp_form == ft_short) {
+   return;
 
-      /* check for divide by zero */
+}
 
-      if (right->sp_val.sp_short_value == 0)
-         abend(SETL_SYSTEM msg_zero_divide);
+/*\
+ *  \function{integer\_cell\_count()}
+ *
+ *  This function returns the number of \verb"INT_CELL_WIDTH" bit cells
+ *  we need to write a long integer to a file.
+\*/
 
-      /* we would like to use the left operand destructively */
+int32 integer_cell_count(
+   integer_h_ptr_type source)          /* integer to be written             */
 
-      if (target == left &&
-          target != right &&
-          (target->sp_val.sp_long_ptr)->i_use_count == 1) {
+{
+int32 bits;                            /* significant bits in integer       */
+integer_limb high_limb;                /* high order limb                   */
 
-         target_hdr = target->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
+   if (source->i_limb_count == 0)
+      return 0;
 
-      }
-      else {
+   bits = (source->i_limb_count - 1) * INT_LIMB_WIDTH;
+   for (high_limb = source->i_limbs[source->i_limb_count - 1];
+        high_limb != 0;
+        high_limb >>= 1)
+      bits++;
 
-         target_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
+   return (bits + INT_CELL_WIDTH - 1) / INT_CELL_WIDTH;
 
-      }
+}
 
-      /* extract the short value and find the sign of the result */
+/*\
+ *  \function{integer\_cell\_value()}
+ *
+ *  This function returns one \verb"INT_CELL_WIDTH" bit cell of a long
+ *  integer, for writing to a file.
+\*/
 
-      short_result = right->sp_val.sp_short_value;
-      if (short_result < 0) {
-         target_hdr->i_is_negative = !(target_hdr->i_is_negative);
-         short_result = -short_result;
-      }
+int32 integer_cell_value(
+   integer_h_ptr_type source,          /* integer to be written             */
+   int32 index)                        /* cell number, low order first      */
 
-      target_cell = target_hdr->i_tail;
-      carry = 0;
+{
+int32 bit;                             /* position of cell's low order bit  */
+int32 limb;                            /* limb holding that bit             */
+int shift;                             /* position of bit within limb       */
+integer_limb value;                    /* cell value                        */
 
-      /* traverse the list of cells */
+   bit = index * INT_CELL_WIDTH;
+   limb = bit / INT_LIMB_WIDTH;
+   shift = (int)(bit % INT_LIMB_WIDTH);
 
-      while (target_cell != NULL) {
+   if (limb >= source->i_limb_count)
+      return 0;
 
-         /* divide one cell */
+   value = source->i_limbs[limb] >> shift;
+   if (shift + (int)INT_CELL_WIDTH > INT_LIMB_WIDTH &&
+       limb + 1 < source->i_limb_count)
+      value |= source->i_limbs[limb + 1] << (INT_LIMB_WIDTH - shift);
 
-         save_carry = carry;
-         carry =
-            (target_cell->i_cell_value + (save_carry << INT_CELL_WIDTH)) %
-                  short_result;
+   return (int32)(value & MAX_INT_CELL);
 
-         target_cell->i_cell_value =
-            (target_cell->i_cell_value + (save_carry << INT_CELL_WIDTH)) /
-                  short_result;
+}
 
-         /* set up for the next cell */
+/*\
+ *  \function{add\_operands()}
+ *
+ *  This function adds or subtracts two integers of either type, after
+ *  the caller has found that short arithmetic won't do.  We work on
+ *  signs and magnitudes: if the signs agree we add magnitudes, otherwise
+ *  we subtract the smaller magnitude from the larger.
+ *
+ *  If the target holds a long integer nobody else is using, with enough
+ *  room for the result, we build the result in place.  This is the
+ *  common case of accumulating into a variable.
+\*/
 
-         target_cell = target_cell->i_prev;
+static void add_operands(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* result operand                    */
+   specifier *left,                    /* left operand                      */
+   specifier *right,                   /* right operand                     */
+   int subtract)                       /* YES to subtract right from left   */
 
-      }
+{
+struct integer_operand left_opnd, right_opnd;
+                                       /* operands as sign and magnitude    */
+struct integer_operand *larger, *smaller;
+                                       /* operands ordered by magnitude     */
+integer_h_ptr_type target_hdr;         /* result header                     */
+int32 limb_count;                      /* maximum limbs in result           */
+
+   get_operand(left,&left_opnd);
+   get_operand(right,&right_opnd);
+   if (subtract)
+      right_opnd.o_is_negative = !right_opnd.o_is_negative;
+
+   /* order the operands by magnitude */
+
+   if (limbs_compare(left_opnd.o_limbs,left_opnd.o_limb_count,
+                     right_opnd.o_limbs,right_opnd.o_limb_count) >= 0) {
+      larger = &left_opnd;
+      smaller = &right_opnd;
    }
-
-   /*
-    *  At this point we know we have two long values.
-    */
-
    else {
+      larger = &right_opnd;
+      smaller = &left_opnd;
+   }
 
-      /* create a brand new target with a value 0 */
+   /* find a header for the result, reusing the target if we can */
 
-      get_integer_header(target_hdr);
-      target_hdr->i_cell_count = 1;
-      target_hdr->i_use_count = 1;
-      target_hdr->i_hash_code = -1;
-      target_hdr->i_is_negative = (left->sp_val.sp_long_ptr)->i_is_negative ^
-                                  (right->sp_val.sp_long_ptr)->i_is_negative;
+   limb_count = larger->o_limb_count + 1;
+   if (spec_form(target) == ft_long &&
+       spec_val(target,sp_long_ptr)->i_use_count == 1 &&
+       spec_val(target,sp_long_ptr)->i_limb_alloc >= limb_count) {
 
-      get_integer_cell(target_cell);
-      target_cell->i_cell_value = 0;
-      target_cell->i_next = target_cell->i_prev = NULL;
-      target_hdr->i_head = target_hdr->i_tail = target_cell;
+      target_hdr = spec_val(target,sp_long_ptr);
+      spec_set_form(target,ft_omega);
 
-      left_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
-      right_hdr = right->sp_val.sp_long_ptr;
+   }
+   else {
 
-      /* first, find the number of passes we have to make */
+      target_hdr = new_integer(SETL_SYSTEM limb_count);
 
-      passes = left_hdr->i_cell_count - right_hdr->i_cell_count + 1;
-      while (passes-- > 0) {
+   }
 
-         /*
-          *  we will work on a chain the length of the divisor, but
-          *  at the high order end
-          */
+   if (larger->o_is_negative == smaller->o_is_negative) {
 
-         left_cell_head = left_hdr->i_tail;
-         for (i = 1; i < right_hdr->i_cell_count; i++)
-            left_cell_head = left_cell_head->i_prev;
+      target_hdr->i_limb_count =
+         limbs_add(target_hdr->i_limbs,
+                   larger->o_limbs,larger->o_limb_count,
+                   smaller->o_limbs,smaller->o_limb_count);
 
-         /* keep working on this frame until we can not continue */
+   }
+   else {
 
-         for (;;) {
+      target_hdr->i_limb_count =
+         limbs_subtract(target_hdr->i_limbs,
+                        larger->o_limbs,larger->o_limb_count,
+                        smaller->o_limbs,smaller->o_limb_count);
 
-            /*
-             *  The following truly horrible expression makes a
-             *  fairly good estimate of the largest multiple of the
-             *  right_hdr we can subtract from this frame.
-             */
+   }
 
-            left_cell = left_hdr->i_tail;
-            right_cell = right_hdr->i_tail;
+   target_hdr->i_is_negative = larger->o_is_negative;
 
-            cell_multiplier = (unsigned int32)(left_cell->i_cell_value << 2);
-            cell_multiplier += (left_cell->i_prev)->i_cell_value >>
-                                    (INT_CELL_WIDTH - 2);
-            cell_multiplier /= ((right_cell->i_cell_value << 2) +
-                  ((right_cell->i_prev)->i_cell_value >>
-                     (INT_CELL_WIDTH - 2)) + 1);
+   /*
+    *  Now we have a long value in the target.  We would like to use
+    *  short values whenever possible, so we check whether it will fit in
+    *  a short.  If so, we convert it.
+    */
 
-            /*
-             *  we sometimes make one extra pass over the frame,
-             *  but it's tough to anticipate those situations
-             */
+   normalize_long(SETL_SYSTEM target,target_hdr);
 
-            if (cell_multiplier == 0) {
-               if ((right_hdr->i_tail)->i_cell_value <=
-                   (left_hdr->i_tail)->i_cell_value)
-                  cell_multiplier = 1;
-               else
-                  break;
-            }
+   return;
 
-            /*
-             *  Now we're ready to process the current frame.  We
-             *  subtract cell_multiplier times the divisor from the
-             *  frame.
-             */
+}
 
-            carry = 0;
-            left_cell = left_cell_head;
-            right_cell = right_hdr->i_head;
+/*\
+ *  \function{integer\_add()}
+ *
+ *  This function adds two integers, where the integers may be either
+ *  short or long.  It is meant to be called from the core interpreter
+ *  for long integers, or from built-in functions for either type
+ *  integer.
+\*/
 
-            while (right_cell != NULL) {
+void integer_add(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* result operand                    */
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-               /* subtract the divisor cell */
+{
+int32 short_result;                    /* result of short addition          */
 
-               left_cell->i_cell_value -= (carry +
-                     right_cell->i_cell_value * cell_multiplier);
+   /* if both operands are short, try short arithmetic first */
 
-               /* check for a carry */
+   if (spec_form(left) == ft_short && spec_form(right) == ft_short &&
+       short_add(short_result,spec_val(left,sp_short_value),
+                              spec_val(right,sp_short_value))) {
 
-               if (left_cell->i_cell_value < 0) {
-                  if (left_cell->i_cell_value % (MAX_INT_CELL + 1) != 0)
-                     carry =
-                        (left_cell->i_cell_value / -(MAX_INT_CELL + 1)) + 1;
-                  else
-                     carry =
-                        left_cell->i_cell_value / -(MAX_INT_CELL + 1);
-                  left_cell->i_cell_value += (MAX_INT_CELL + 1) * carry;
-               }
-               else {
-                  carry = 0;
-               }
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,short_result);
 
-               /* set up for the next cell */
+      return;
 
-               right_cell = right_cell->i_next;
-               left_cell = left_cell->i_next;
+   }
 
-            }
+   add_operands(SETL_SYSTEM target,left,right,NO);
 
-            if (carry) {
+   return;
 
-#ifdef TRAPS
+}
 
-               /*
-                *  We should only have reduced the dividend by one
-                *  extra multiple of the divisor.
-                */
-
-               if (cell_multiplier != 1)
-                  trap(__FILE__,__LINE__,msg_divide_error);
+/*\
+ *  \function{integer\_subtract()}
+ *
+ *  This function subtracts two integers, where the integers may be
+ *  either short or long.  It is meant to be called from the core
+ *  interpreter for long integers, or from built-in functions for either
+ *  type integer.
+\*/
 
-#endif
+void integer_subtract(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* result operand                    */
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-               /* back out one multiple of the divisor */
+{
+int32 short_result;                    /* result of short subtraction       */
 
-               cell_multiplier = 0;
-               carry = 0;
-               left_cell = left_cell_head;
-               right_cell = right_hdr->i_head;
+   /* if both operands are short, try short arithmetic first */
 
-               while (right_cell != NULL) {
+   if (spec_form(left) == ft_short && spec_form(right) == ft_short &&
+       short_subtract(short_result,spec_val(left,sp_short_value),
+                                   spec_val(right,sp_short_value))) {
 
-                  /* subtract the divisor cell */
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,short_result);
 
-                  left_cell->i_cell_value +=
-                        (carry + right_cell->i_cell_value);
+      return;
 
-                  carry = left_cell->i_cell_value >> INT_CELL_WIDTH;
-                  left_cell->i_cell_value &= MAX_INT_CELL;
+   }
 
-                  /* set up for the next cell */
+   add_operands(SETL_SYSTEM target,left,right,YES);
 
-                  right_cell = right_cell->i_next;
-                  left_cell = left_cell->i_next;
+   return;
 
-               }
+}
 
-               break;
+/*\
+ *  \function{integer\_multiply()}
+ *
+ *  This function multiplies two integers, where the integers may be
+ *  either short or long.  It is meant to be called from the core
+ *  interpreter for long integers, or from built-in functions for either
+ *  type integer.
+\*/
 
-            }
+void integer_multiply(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* result operand                    */
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-            /*
-             *  At this point, we've subtracted some multiple of
-             *  the divisor from the remainder.  We have to update
-             *  the quotient by adding in that multiple.
-             */
+{
+struct integer_operand left_opnd, right_opnd;
+                                       /* operands as sign and magnitude    */
+integer_h_ptr_type target_hdr;         /* result header                     */
+int32 short_result;                    /* result of short multiplication    */
 
-            target_cell = target_hdr->i_head;
-            carry = cell_multiplier;
+   /* if both operands are short, try short arithmetic first */
 
-            while (carry) {
+   if (spec_form(left) == ft_short && spec_form(right) == ft_short &&
+       short_multiply(short_result,spec_val(left,sp_short_value),
+                                   spec_val(right,sp_short_value))) {
 
-               /* check whether we must extend the quotient */
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,short_result);
 
-               if (target_cell == NULL) {
+      return;
 
-                  get_integer_cell(target_cell);
-                  (target_hdr->i_tail)->i_next = target_cell;
-                  target_cell->i_prev = target_hdr->i_tail;
-                  target_cell->i_next = NULL;
-                  target_hdr->i_tail = target_cell;
-                  target_hdr->i_cell_count++;
-                  target_cell->i_cell_value = 0;
+   }
 
-               }
+   get_operand(left,&left_opnd);
+   get_operand(right,&right_opnd);
 
-               /* add in the carry, which could create another */
+   /* the product is built in a new header, since it can't overlap */
 
-               target_cell->i_cell_value += carry;
-               carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-               target_cell->i_cell_value &= MAX_INT_CELL;
+   target_hdr = new_integer(SETL_SYSTEM
+                            left_opnd.o_limb_count + right_opnd.o_limb_count);
+   limbs_multiply(SETL_SYSTEM target_hdr->i_limbs,
+                  left_opnd.o_limbs,left_opnd.o_limb_count,
+                  right_opnd.o_limbs,right_opnd.o_limb_count);
+   target_hdr->i_limb_count = left_opnd.o_limb_count +
+                              right_opnd.o_limb_count;
+   target_hdr->i_is_negative = left_opnd.o_is_negative ^
+                               right_opnd.o_is_negative;
 
-               /* set up for the next cell */
+   normalize_long(SETL_SYSTEM target,target_hdr);
 
-               target_cell = target_cell->i_next;
+   return;
 
-            }
-         }
+}
 
-         /*
-          *  Finally, we've finished one pass.  If there are more
-          *  passes, we shift the quotient by adding a low-order
-          *  cell.
-          */
+/*\
+ *  \function{divide\_operands()}
+ *
+ *  This function divides the magnitudes of two integers, producing new
+ *  long integers for the quotient and remainder.  The results are not
+ *  normalized, and have no sign.
+\*/
 
-         if (passes) {
+static void divide_operands(
+   SETL_SYSTEM_PROTO
+   struct integer_operand *left,       /* dividend                          */
+   struct integer_operand *right,      /* divisor                           */
+   integer_h_ptr_type *quotient,       /* returned quotient                 */
+   integer_h_ptr_type *remainder)      /* returned remainder                */
 
-            get_integer_cell(target_cell);
-            (target_hdr->i_head)->i_prev = target_cell;
-            target_cell->i_next = target_hdr->i_head;
-            target_cell->i_prev = NULL;
-            target_hdr->i_head = target_cell;
-            target_hdr->i_cell_count++;
-            target_cell->i_cell_value = 0;
+{
 
-            /* shorten the left_hdr by one cell */
+   if (right->o_limb_count == 0)
+      abend(SETL_SYSTEM msg_zero_divide);
 
-            left_cell = left_hdr->i_tail;
-            (left_cell->i_prev)->i_cell_value +=
-                  left_cell->i_cell_value << INT_CELL_WIDTH;
+   /* if the divisor is larger the quotient is zero */
 
-            left_hdr->i_tail = left_cell->i_prev;
-            free_integer_cell(left_cell);
-            (left_hdr->i_tail)->i_next = NULL;
-            left_hdr->i_cell_count--;
+   if (left->o_limb_count < right->o_limb_count) {
 
-         }
-      }
+      *quotient = new_integer(SETL_SYSTEM 0);
+      *remainder = new_integer(SETL_SYSTEM left->o_limb_count);
+      memcpy((void *)((*remainder)->i_limbs),(void *)(left->o_limbs),
+             (size_t)(left->o_limb_count * sizeof(integer_limb)));
+      (*remainder)->i_limb_count = left->o_limb_count;
 
-      free_interp_integer(SETL_SYSTEM left_hdr);
+      return;
 
    }
 
-   /* we eliminate high-order zero cells */
+   *quotient = new_integer(SETL_SYSTEM
+                           left->o_limb_count - right->o_limb_count + 1);
+   *remainder = new_integer(SETL_SYSTEM right->o_limb_count);
 
-   target_cell = target_hdr->i_tail;
-   while (target_cell->i_prev != NULL &&
-          !(target_cell->i_cell_value)) {
+   /* single limb divisors are easy */
 
-      target_hdr->i_tail = target_cell->i_prev;
-      free_integer_cell(target_cell);
-      target_cell = target_hdr->i_tail;
-      target_hdr->i_cell_count--;
+   if (right->o_limb_count == 1) {
 
-   }
+      (*remainder)->i_limbs[0] =
+         limbs_divide_1((*quotient)->i_limbs,
+                        left->o_limbs,left->o_limb_count,
+                        right->o_limbs[0]);
 
-   target_cell->i_next = NULL;
+   }
+   else {
 
-   /* the target hash code is now invalid */
+      limbs_divide(SETL_SYSTEM (*quotient)->i_limbs,(*remainder)->i_limbs,
+                   left->o_limbs,left->o_limb_count,
+                   right->o_limbs,right->o_limb_count);
 
-   target_hdr->i_hash_code = -1;
+   }
 
-   /*
-    *  Now we have a long value in the target.  We would like to use
-    *  short values whenever possible, so we check whether it will fit in
-    *  a short.  If so, we convert it.
-    */
+   (*quotient)->i_limb_count = left->o_limb_count - right->o_limb_count + 1;
+   trim_limbs((*quotient)->i_limbs,(*quotient)->i_limb_count);
+   (*remainder)->i_limb_count = right->o_limb_count;
+   trim_limbs((*remainder)->i_limbs,(*remainder)->i_limb_count);
 
-   if (target_hdr->i_cell_count < 3) {
+   return;
 
-      /* build up a long value */
+}
 
-      carry = (target_hdr->i_head)->i_cell_value;
-      if (target_hdr->i_cell_count == 2) {
+/*\
+ *  \function{integer\_divide()}
+ *
+ *  This function divides two integers, where the integers may be either
+ *  short or long.  It is meant to be called from the core interpreter
+ *  for long integers, or for built-in functions for either type integer.
+ *  The quotient is truncated toward zero.
+\*/
 
-         carry += (((target_hdr->i_head)->i_next)->i_cell_value) <<
-                    INT_CELL_WIDTH;
+void integer_divide(
+   SETL_SYSTEM_PROTO
+   specifier *target,                  /* result operand                    */
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-      }
+{
+struct integer_operand left_opnd, right_opnd;
+                                       /* operands as sign and magnitude    */
+integer_h_ptr_type quotient_hdr, remainder_hdr;
+                                       /* quotient and remainder            */
 
-      if (target_hdr->i_is_negative)
-         carry = -carry;
+   /*
+    *  Both operands are short.  Shorts range as far below zero as above,
+    *  so the quotient is always short.
+    */
 
-      /* check whether it will fit in a short */
+   if (spec_form(left) == ft_short && spec_form(right) == ft_short) {
 
-      if (!(hi_bits = carry & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
+      if (spec_val(right,sp_short_value) == 0)
+         abend(SETL_SYSTEM msg_zero_divide);
 
-         free_interp_integer(SETL_SYSTEM target_hdr);
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = carry;
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,spec_val(left,sp_short_value) /
+                                      spec_val(right,sp_short_value));
 
-         return;
+      return;
 
-      }
    }
 
-   /*
-    *  We're stuck with a long.  Set the target and return.
-    */
+   get_operand(left,&left_opnd);
+   get_operand(right,&right_opnd);
+   divide_operands(SETL_SYSTEM &left_opnd,&right_opnd,
+                   &quotient_hdr,&remainder_hdr);
 
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = target_hdr;
+   quotient_hdr->i_is_negative = left_opnd.o_is_negative ^
+                                 right_opnd.o_is_negative;
+   free_interp_integer(SETL_SYSTEM remainder_hdr);
+
+   normalize_long(SETL_SYSTEM target,quotient_hdr);
 
    return;
 
@@ -2272,95 +2869,70 @@ void integer_power(
 {
 specifier result;                      /* working result                    */
 specifier multiplier;                  /* working multiplier                */
-integer_c_ptr_type next_cell;          /* next cell in exponent             */
-int32 current_cell_value;              /* current long in exponent          */
-int current_bit;                       /* current bit in exponent           */
-
-   /* we initialize the exponent work areas from the right operand */
-
-   if (right->sp_form == ft_short) {
-
-      current_cell_value = right->sp_val.sp_short_value;
-      next_cell = NULL;
-
-      if (current_cell_value < 0) {
+specifier exponent;                    /* copy of right operand             */
+struct integer_operand exponent_opnd;  /* exponent as sign and magnitude    */
+integer_limb current_limb;             /* current limb in exponent          */
+int32 next_limb;                       /* index of next limb in exponent    */
+int bits_left;                         /* bits left in current limb         */
 
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = 0;
+   /* hold on to the exponent, in case the target is the right operand */
 
-         return;
+   spec_set_form(&exponent,spec_form(right));
+   spec_set_val(&exponent,sp_biggest,spec_val(right,sp_biggest));
+   mark_specifier(&exponent);
+   get_operand(&exponent,&exponent_opnd);
 
-      }
-   }
-   else {
-
-      if ((right->sp_val.sp_long_ptr)->i_is_negative) {
+   /* negative exponents yield zero */
 
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = 0;
+   if (exponent_opnd.o_is_negative) {
 
-         return;
-
-      }
+      unmark_specifier(&exponent);
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,0);
 
-      next_cell = (right->sp_val.sp_long_ptr)->i_head;
-      current_cell_value = next_cell->i_cell_value;
-      next_cell = next_cell->i_next;
+      return;
 
    }
-   current_bit = 0;
 
    /* we start with a result of 1 */
 
-   result.sp_form = ft_short;
-   result.sp_val.sp_short_value = 1;
+   spec_set_form(&result,ft_short);
+   spec_set_val(&result,sp_short_value,1);
 
    /* the multiplier is initially the left operand */
 
-   multiplier.sp_form = left->sp_form;
-   multiplier.sp_val.sp_biggest = left->sp_val.sp_biggest;
+   spec_set_form(&multiplier,spec_form(left));
+   spec_set_val(&multiplier,sp_biggest,spec_val(left,sp_biggest));
    mark_specifier(&multiplier);
 
-   /* keep processing bits in the exponent */
+   /* keep processing bits in the exponent, from low order to high */
 
+   current_limb = 0;
+   bits_left = 0;
+   next_limb = 0;
    for (;;) {
 
-      /* if the current bit is one, multiply result by multiplier */
+      if (bits_left == 0) {
 
-      if (current_cell_value & 0x01)
-         integer_multiply(SETL_SYSTEM &result,&result,&multiplier);
-
-      /* set up for the next bit */
-
-      current_bit++;
-      if (current_bit < INT_CELL_WIDTH) {
+         if (next_limb >= exponent_opnd.o_limb_count)
+            break;
 
-         current_cell_value >>= 1;
+         current_limb = exponent_opnd.o_limbs[next_limb++];
+         bits_left = INT_LIMB_WIDTH;
 
       }
-      else {
-
-         if (next_cell != NULL) {
-
-            current_cell_value = next_cell->i_cell_value;
-            next_cell = next_cell->i_next;
 
-         }
-         else {
-
-            current_cell_value = 0;
-
-         }
-
-         current_bit = 0;
+      /* if the current bit is one, multiply result by multiplier */
 
-      }
+      if (current_limb & 0x01)
+         integer_multiply(SETL_SYSTEM &result,&result,&multiplier);
 
       /* break if the exponent is exhausted */
 
-      if (!current_cell_value && next_cell == NULL)
+      current_limb >>= 1;
+      bits_left--;
+      if (current_limb == 0 && next_limb >= exponent_opnd.o_limb_count)
          break;
 
       /* square the multiplier */
@@ -2372,9 +2944,10 @@ int current_bit;                       /* current bit in exponent           */
    /* we set the target to our result */
 
    unmark_specifier(target);
-   target->sp_form = result.sp_form;
-   target->sp_val.sp_biggest = result.sp_val.sp_biggest;
+   spec_set_form(target,spec_form(&result));
+   spec_set_val(target,sp_biggest,spec_val(&result,sp_biggest));
    unmark_specifier(&multiplier);
+   unmark_specifier(&exponent);
 
    return;
 
@@ -2385,7 +2958,9 @@ int current_bit;                       /* current bit in exponent           */
  *
  *  This function divides two integers, returning the remainder.  It is
  *  meant to be called from the core interpreter for long integers, or
- *  for built-in functions for either type integer.
+ *  for built-in functions for either type integer.  The result is never
+ *  negative: when the operands' signs differ, we return the magnitude
+ *  of the divisor less the remainder of the magnitudes.
 \*/
 
 void integer_mod(
@@ -2395,554 +2970,98 @@ void integer_mod(
    specifier *right)                   /* right operand                     */
 
 {
-integer_h_ptr_type target_hdr, right_hdr;
-                                       /* header pointers for result and    */
-                                       /* operands                          */
-integer_c_ptr_type target_cell, target_cell_head, right_cell;
-                                       /* cell pointers for result and      */
-                                       /* operands                          */
-int32 carry;                           /* amount carried to higher order    */
-                                       /* cell                              */
-int32 hi_bits;                         /* high order bits of short integer  */
-int32 save_carry;                      /* saved carry                       */
-int32 short_result;                    /* amount to divide by               */
-unsigned int32 cell_multiplier;        /* multiplied by divisor during      */
-                                       /* division operation                */
-int passes;                            /* number of passes through          */
-                                       /* algorithm                         */
-int i;                                 /* temporary looping variable        */
-specifier spare1;                      /* spare specifier for sign          */
-                                       /* adjustment                        */
-
-   /* if at least one of the operands is short, we can use a fast method */
-
-   if (left->sp_form == ft_short) {
-
-      if (right->sp_form == ft_short) {
-
-         /*
-          *  Both operands are short.  We try dividing the short values,
-          *  and if the result is short we return.  Otherwise we convert
-          *  the result to a long.
-          */
-
-         if (right->sp_val.sp_short_value == 0)
-            abend(SETL_SYSTEM msg_zero_divide);
-
-         short_result = labs(left->sp_val.sp_short_value) %
-                        labs(right->sp_val.sp_short_value);
-
-         /* make sure mod is positive */
-
-         if (short_result != 0) {
-
-            if (left->sp_val.sp_short_value < 0 &&
-                right->sp_val.sp_short_value > 0)
-               short_result = right->sp_val.sp_short_value - short_result;
-
-            if (left->sp_val.sp_short_value >= 0 &&
-                right->sp_val.sp_short_value < 0)
-               short_result = -right->sp_val.sp_short_value - short_result;
-
-         }
-
-         /* check whether the result remains short */
-
-         if (!(hi_bits = short_result & INT_HIGH_BITS) ||
-             hi_bits == INT_HIGH_BITS) {
-
-            unmark_specifier(target);
-            target->sp_form = ft_short;
-            target->sp_val.sp_short_value = short_result;
-
-            return;
-
-         }
+struct integer_operand left_opnd, right_opnd;
+                                       /* operands as sign and magnitude    */
+integer_h_ptr_type quotient_hdr, remainder_hdr;
+                                       /* quotient and remainder            */
+int32 short_result;                    /* result of short operation         */
 
-         /* if we exceed the maximum short, convert to long */
-
-         short_to_long(SETL_SYSTEM target,short_result);
-
-         return;
-
-      }
-
-      /*
-       *  The left operand is short but the right is long.  If the long
-       *  is two cells long we can divide.  Otherwise we return the left.
-       */
-
-      right_hdr = right->sp_val.sp_long_ptr;
-
-      if (right_hdr->i_cell_count > 2) {
-
-         /* notice that right > left */
-
-         if ((left->sp_val.sp_short_value < 0 &&
-             !(right_hdr->i_is_negative)) ||
-             (left->sp_val.sp_short_value > 0 &&
-              right_hdr->i_is_negative)) {
-
-            integer_add(SETL_SYSTEM target,right,left);
-            if (target->sp_form == ft_short) {
-
-               target->sp_val.sp_short_value =
-                  labs(target->sp_val.sp_short_value);
-
-            }
-            else {
-
-               (target->sp_val.sp_long_ptr)->i_is_negative = NO;
-
-            }
-
-            return;
-
-         }
-
-         short_result = labs(left->sp_val.sp_short_value);
-
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_result;
-
-         return;
-
-      }
+   /* if both operands are short, we can use the C operator */
 
-      /* if there are only two cells in right, find mod normally */
+   if (spec_form(left) == ft_short && spec_form(right) == ft_short) {
 
-      short_result = labs(left->sp_val.sp_short_value) %
-         ((((right_hdr->i_head)->i_next)->i_cell_value << INT_CELL_WIDTH) +
-         (right_hdr->i_head)->i_cell_value);
-
-      /* make sure mod is positive */
-
-      if (short_result != 0) {
-
-         if (left->sp_val.sp_short_value < 0 &&
-             !(right_hdr->i_is_negative)) {
-
-            short_result =
-                  ((((right_hdr->i_head)->i_next)->i_cell_value <<
-                     INT_CELL_WIDTH) +
-                  (right_hdr->i_head)->i_cell_value) -
-                  short_result;
-
-         }
-
-         if (left->sp_val.sp_short_value > 0 &&
-             right_hdr->i_is_negative) {
-
-            short_result =
-                  ((((right_hdr->i_head)->i_next)->i_cell_value <<
-                     INT_CELL_WIDTH) +
-                  (right_hdr->i_head)->i_cell_value) -
-                  short_result;
-
-         }
-      }
-
-      /* check whether the result remains short */
-
-      if (!(hi_bits = short_result & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
-
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_result;
-
-         return;
-
-      }
-
-      /* if we exceed the maximum short, convert to long */
-
-      short_to_long(SETL_SYSTEM target,short_result);
-
-      return;
-
-   }
-
-   /*
-    *  At this point we know that the left operand is long.  The right
-    *  operand can be either short or long.
-    */
-
-   /*
-    *  If the right operand is short, we need only divide the long by
-    *  the short value.
-    */
-
-   if (right->sp_form == ft_short) {
-
-      /* check for divide by zero */
-
-      if (right->sp_val.sp_short_value == 0)
+      if (spec_val(right,sp_short_value) == 0)
          abend(SETL_SYSTEM msg_zero_divide);
 
-      /* we would like to use the left operand destructively */
-
-      if (target == left &&
-          target != right &&
-          (target->sp_val.sp_long_ptr)->i_use_count == 1) {
-
-         target_hdr = target->sp_val.sp_long_ptr;
-         target->sp_form = ft_omega;
-
-      }
-      else {
-
-         target_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
-
-      }
-
-      /* extract the short value and find the sign of the result */
-
-      short_result = right->sp_val.sp_short_value;
-      if (short_result < 0) {
-         short_result = -short_result;
-      }
-
-      target_cell = target_hdr->i_tail;
-      carry = 0;
-
-      /* traverse the list of cells */
-
-      while (target_cell != NULL) {
-
-         /* divide one cell */
-
-         save_carry = carry;
-         carry =
-            (target_cell->i_cell_value + (save_carry << INT_CELL_WIDTH)) %
-                  short_result;
-
-         target_cell->i_cell_value =
-            (target_cell->i_cell_value + (save_carry << INT_CELL_WIDTH)) /
-                  short_result;
-
-         /* set up for the next cell */
-
-         target_cell = target_cell->i_prev;
-
-      }
-
-      /* the carry contains the remainder */
-
-      short_result = carry;
-
-      free_interp_integer(SETL_SYSTEM target_hdr);
+      short_result = labs(spec_val(left,sp_short_value)) %
+                     labs(spec_val(right,sp_short_value));
 
       /* make sure mod is positive */
 
       if (short_result != 0) {
 
-         if ((left->sp_val.sp_long_ptr)->i_is_negative &&
-             right->sp_val.sp_short_value > 0)
-            short_result = right->sp_val.sp_short_value - short_result;
+         if (spec_val(left,sp_short_value) < 0 &&
+             spec_val(right,sp_short_value) > 0)
+            short_result = spec_val(right,sp_short_value) - short_result;
 
-         if (!((left->sp_val.sp_long_ptr)->i_is_negative) &&
-             right->sp_val.sp_short_value < 0)
-            short_result = -right->sp_val.sp_short_value - short_result;
+         if (spec_val(left,sp_short_value) >= 0 &&
+             spec_val(right,sp_short_value) < 0)
+            short_result = -spec_val(right,sp_short_value) - short_result;
 
       }
 
-      if (!(hi_bits = short_result & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
-
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = short_result;
-
-         return;
-
-      }
-
-      /* if we exceed the maximum short, convert to long */
-
-      short_to_long(SETL_SYSTEM target,short_result);
+      unmark_specifier(target);
+      spec_set_form(target,ft_short);
+      spec_set_val(target,sp_short_value,short_result);
 
       return;
 
    }
 
-   /*
-    *  At this point we know we have two long values.
-    */
-
-   /* we would like to use the left operand destructively */
-
-   if (target == left &&
-       target != right &&
-       (target->sp_val.sp_long_ptr)->i_use_count == 1) {
-
-      target_hdr = target->sp_val.sp_long_ptr;
-      target->sp_form = ft_omega;
-
-   }
-   else {
-
-      target_hdr = copy_integer(SETL_SYSTEM left->sp_val.sp_long_ptr);
-
-   }
-
-   right_hdr = right->sp_val.sp_long_ptr;
-
-   /* find the number of passes we have to make */
-
-   passes = target_hdr->i_cell_count - right_hdr->i_cell_count + 1;
-   while (passes-- > 0) {
-
-      /*
-       *  we will work on a chain the length of the divisor, but
-       *  at the high order end
-       */
-
-      target_cell_head = target_hdr->i_tail;
-      for (i = 1; i < right_hdr->i_cell_count; i++)
-         target_cell_head = target_cell_head->i_prev;
-
-      /* keep working on this frame until we can not continue */
-
-      for (;;) {
-
-         /*
-          *  The following truly horrible expression makes a
-          *  fairly good estimate of the largest multiple of the
-          *  right_hdr we can subtract from this frame.
-          */
-
-         target_cell = target_hdr->i_tail;
-         right_cell = right_hdr->i_tail;
-
-         cell_multiplier = (unsigned int32)(target_cell->i_cell_value << 2);
-         cell_multiplier += (target_cell->i_prev)->i_cell_value >>
-                                 (INT_CELL_WIDTH - 2);
-         cell_multiplier /= ((right_cell->i_cell_value << 2) +
-               ((right_cell->i_prev)->i_cell_value >>
-                  (INT_CELL_WIDTH - 2)) + 1);
-
-         /*
-          *  we sometimes make one extra pass over the frame,
-          *  but it's tough to anticipate those situations
-          */
-
-         if (cell_multiplier == 0) {
-            if ((right_hdr->i_tail)->i_cell_value <=
-                (target_hdr->i_tail)->i_cell_value)
-               cell_multiplier = 1;
-            else
-               break;
-         }
-
-         /*
-          *  Now we're ready to process the current frame.  We
-          *  subtract cell_multiplier times the divisor from the
-          *  frame.
-          */
-
-         carry = 0;
-         target_cell = target_cell_head;
-         right_cell = right_hdr->i_head;
-
-         while (right_cell != NULL) {
-
-            /* subtract the divisor cell */
-
-            target_cell->i_cell_value -= (carry +
-                  right_cell->i_cell_value * cell_multiplier);
-
-            /* check for a carry */
-
-            if (target_cell->i_cell_value < 0) {
-               if (target_cell->i_cell_value % (MAX_INT_CELL + 1) != 0)
-                  carry =
-                     (target_cell->i_cell_value / -(MAX_INT_CELL + 1)) + 1;
-               else
-                  carry =
-                     target_cell->i_cell_value / -(MAX_INT_CELL + 1);
-               target_cell->i_cell_value += (MAX_INT_CELL + 1) * carry;
-            }
-            else {
-               carry = 0;
-            }
-
-            /* set up for the next cell */
-
-            right_cell = right_cell->i_next;
-            target_cell = target_cell->i_next;
-
-         }
-
-         if (carry) {
-
-#ifdef TRAPS
-
-            /*
-             *  We should only have reduced the dividend by one
-             *  extra multiple of the divisor.
-             */
-
-            if (cell_multiplier != 1)
-               trap(__FILE__,__LINE__,msg_divide_error);
-
-#endif
-
-            /* back out one multiple of the divisor */
-
-            cell_multiplier = 0;
-            carry = 0;
-            target_cell = target_cell_head;
-            right_cell = right_hdr->i_head;
-
-            while (right_cell != NULL) {
-
-               /* subtract the divisor cell */
-
-               target_cell->i_cell_value +=
-                     (carry + right_cell->i_cell_value);
-
-               carry = target_cell->i_cell_value >> INT_CELL_WIDTH;
-               target_cell->i_cell_value &= MAX_INT_CELL;
-
-               /* set up for the next cell */
-
-               right_cell = right_cell->i_next;
-               target_cell = target_cell->i_next;
-
-            }
-
-            break;
-
-         }
-      }
-
-      /*
-       *  Finally, we've finished one pass.  We need to eliminate the
-       *  high-order cell of the target.
-       */
-
-      if (passes) {
-
-         target_cell = target_hdr->i_tail;
-         (target_cell->i_prev)->i_cell_value +=
-               target_cell->i_cell_value << INT_CELL_WIDTH;
-
-         target_hdr->i_tail = target_cell->i_prev;
-         free_integer_cell(target_cell);
-         (target_hdr->i_tail)->i_next = NULL;
-         target_hdr->i_cell_count--;
-
-      }
-   }
-
-   /* adjust the sign of the result */
-
-   target_hdr->i_is_negative ^= right_hdr->i_is_negative;
-
-   /* the target hash code is now invalid */
-
-   target_hdr->i_hash_code = -1;
-
-   /* we eliminate high-order zero cells */
-
-   target_cell = target_hdr->i_tail;
-   while (target_cell->i_prev != NULL &&
-          !(target_cell->i_cell_value)) {
-
-      target_hdr->i_tail = target_cell->i_prev;
-      free_integer_cell(target_cell);
-      target_cell = target_hdr->i_tail;
-      target_hdr->i_cell_count--;
-
-   }
-
-   target_cell->i_next = NULL;
-
-   /*
-    *  If the left and right had different signs the result will be
-    *  negative.  Now we have to add or subtract the divisor to make the
-    *  result positive.
-    */
-
-   if (target_hdr->i_is_negative &&
-       (target_hdr->i_cell_count > 1 ||
-          (target_hdr->i_head)->i_cell_value != 0)) {
+   get_operand(left,&left_opnd);
+   get_operand(right,&right_opnd);
+   divide_operands(SETL_SYSTEM &left_opnd,&right_opnd,
+                   &quotient_hdr,&remainder_hdr);
+   free_interp_integer(SETL_SYSTEM quotient_hdr);
 
-      spare1.sp_form = ft_long;
-      spare1.sp_val.sp_long_ptr = target_hdr;
-
-      if (right_hdr->i_is_negative)
-         integer_subtract(SETL_SYSTEM target,right,&spare1);
-      else
-         integer_add(SETL_SYSTEM target,right,&spare1);
+   /* if the signs differ, subtract the remainder from the divisor */
 
-      /* reverse the sign */
+   if (left_opnd.o_is_negative != right_opnd.o_is_negative &&
+       remainder_hdr->i_limb_count > 0) {
 
-      if (target->sp_form == ft_short) {
-
-         target->sp_val.sp_short_value =
-            labs(target->sp_val.sp_short_value);
-
-      }
-      else {
-
-         (target->sp_val.sp_long_ptr)->i_is_negative = NO;
-
-      }
-
-      unmark_specifier(&spare1);
-
-      return;
+      reserve_limbs(SETL_SYSTEM remainder_hdr,right_opnd.o_limb_count);
+      remainder_hdr->i_limb_count =
+         limbs_subtract(remainder_hdr->i_limbs,
+                        right_opnd.o_limbs,right_opnd.o_limb_count,
+                        remainder_hdr->i_limbs,remainder_hdr->i_limb_count);
 
    }
 
-   /*
-    *  Now we have a long value in the target.  We would like to use
-    *  short values whenever possible, so we check whether it will fit in
-    *  a short.  If so, we convert it.
-    */
-
-   if (target_hdr->i_cell_count < 3) {
+   normalize_long(SETL_SYSTEM target,remainder_hdr);
 
-      /* build up a long value */
+   return;
 
-      carry = (target_hdr->i_head)->i_cell_value;
-      if (target_hdr->i_cell_count == 2) {
+}
 
-         carry += (((target_hdr->i_head)->i_next)->i_cell_value) <<
-                    INT_CELL_WIDTH;
+/*\
+ *  \function{compare\_operands()}
+ *
+ *  This function compares two integers of either type.  It returns a
+ *  negative value if the left is smaller, zero if they are equal, and a
+ *  positive value if the left is larger.
+\*/
 
-      }
+static int compare_operands(
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-      if (target_hdr->i_is_negative)
-         carry = -carry;
+{
+struct integer_operand left_opnd, right_opnd;
+                                       /* operands as sign and magnitude    */
+int magnitude_order;                   /* comparison of magnitudes          */
 
-      /* check whether it will fit in a short */
+   get_operand(left,&left_opnd);
+   get_operand(right,&right_opnd);
 
-      if (!(hi_bits = carry & INT_HIGH_BITS) ||
-          hi_bits == INT_HIGH_BITS) {
+   /* if the signs differ, we needn't look at the magnitudes */
 
-         free_interp_integer(SETL_SYSTEM target_hdr);
-         unmark_specifier(target);
-         target->sp_form = ft_short;
-         target->sp_val.sp_short_value = carry;
+   if (left_opnd.o_is_negative != right_opnd.o_is_negative)
+      return left_opnd.o_is_negative ? -1 : 1;
 
-         return;
+   magnitude_order = limbs_compare(left_opnd.o_limbs,left_opnd.o_limb_count,
+                                   right_opnd.o_limbs,right_opnd.o_limb_count);
 
-      }
-   }
-
-   /*
-    *  We're stuck with a long.  Set the target and return.
-    */
-
-   unmark_specifier(target);
-   target->sp_form = ft_long;
-   target->sp_val.sp_long_ptr = target_hdr;
-
-   return;
+   return left_opnd.o_is_negative ? -magnitude_order : magnitude_order;
 
 }
 
@@ -2961,217 +3080,193 @@ int integer_lt(
    specifier *right)                   /* right operand                     */
 
 {
-integer_h_ptr_type left_hdr, right_hdr;
-                                       /* header pointers for left and      */
-                                       /* right operands                    */
-integer_c_ptr_type left_cell, right_cell;
-                                       /* cell pointers for left and right  */
-                                       /* operands                          */
-
-   if (left->sp_form == ft_short) {
 
-      if (right->sp_form == ft_short) {
+   /* if both operands are short, we just compare the values */
 
-         /*
-          *  Since both operands are short, we just compare the values.
-          */
+   if (spec_form(left) == ft_short && spec_form(right) == ft_short)
+      return spec_val(left,sp_short_value) < spec_val(right,sp_short_value);
 
-         return left->sp_val.sp_short_value < right->sp_val.sp_short_value;
+   return compare_operands(left,right) < 0;
 
-      }
+}
 
-      /*
-       *  The left operand is short but the right is long.  The long
-       *  must have a greater magnitude, we only need check the signs.
-       */
+/*\
+ *  \function{integer\_le()}
+ *
+ *  This function compares two integers for less than, where the integers
+ *  may be either short or long.  It is meant to be called from the core
+ *  interpreter for long integers, or for built-in functions for either
+ *  type integer.  It returns YES if left is less than or equal right.
+\*/
 
-      if ((right->sp_val.sp_long_ptr)->i_is_negative)
-         return NO;
+int integer_le(
+   SETL_SYSTEM_PROTO
+   specifier *left,                    /* left operand                      */
+   specifier *right)                   /* right operand                     */
 
-      return YES;
+{
 
-   }
+   /* if both operands are short, we just compare the values */
 
-   if (right->sp_form == ft_short) {
+   if (spec_form(left) == ft_short && spec_form(right) == ft_short)
+      return spec_val(left,sp_short_value) <= spec_val(right,sp_short_value);
 
-      /*
-       *  The right operand is short but the left is long.  The long
-       *  must have a greater magnitude, we only need check the signs.
-       */
+   return compare_operands(left,right) <= 0;
 
-      if ((left->sp_val.sp_long_ptr)->i_is_negative)
-         return YES;
+}
 
-      return NO;
+/*\
+ *  \function{time\_multiply()}
+ *
+ *  This function returns the time, in clock ticks, to multiply two
+ *  operands of a given length with the current cutoffs.  We time
+ *  several runs of at least a fiftieth of a second each, and take the
+ *  fastest, since other work on the machine only slows us down.
+\*/
 
-   }
+#define CALIBRATE_TRIALS        3      /* timing runs at each length        */
 
-   /*
-    *  Both operands are long.  We use the signs if they are different,
-    *  otherwise we compare the cells.
-    */
+static double time_multiply(
+   SETL_SYSTEM_PROTO
+   integer_limb *work,                 /* operands followed by product      */
+   int32 length)                       /* limbs in each operand             */
 
-   left_hdr = left->sp_val.sp_long_ptr;
-   right_hdr = right->sp_val.sp_long_ptr;
+{
+clock_t start, elapsed;                /* clock at start, and elapsed time  */
+double fastest;                        /* fastest time per multiplication   */
+int32 count;                           /* number of multiplications         */
+int trial;                             /* timing run number                 */
 
-   if (left_hdr->i_is_negative) {
+   fastest = 0.0;
 
-      if (!(right_hdr->i_is_negative))
-         return YES;
+   for (trial = 0; trial < CALIBRATE_TRIALS; trial++) {
 
-      if (left_hdr->i_cell_count < right_hdr->i_cell_count)
-         return NO;
+      count = 0;
+      start = clock();
 
-      if (left_hdr->i_cell_count > right_hdr->i_cell_count)
-         return YES;
+      do {
 
-      for (left_cell = left_hdr->i_tail, right_cell = right_hdr->i_tail;
-           left_cell != NULL &&
-              left_cell->i_cell_value == right_cell->i_cell_value;
-           left_cell = left_cell->i_prev, right_cell = right_cell->i_prev);
+         limbs_multiply(SETL_SYSTEM work + 2 * length,
+                        work,length,work + length,length);
+         count++;
+         elapsed = clock() - start;
 
-      if (left_cell == NULL ||
-          left_cell->i_cell_value < right_cell->i_cell_value)
-         return NO;
+      } while (elapsed < CLOCKS_PER_SEC / 50);
 
-      return YES;
+      if (trial == 0 || (double)elapsed / count < fastest)
+         fastest = (double)elapsed / count;
 
    }
 
-   if (right_hdr->i_is_negative)
-      return NO;
-
-   if (left_hdr->i_cell_count > right_hdr->i_cell_count)
-      return NO;
-
-   if (left_hdr->i_cell_count < right_hdr->i_cell_count)
-      return YES;
-
-   for (left_cell = left_hdr->i_tail, right_cell = right_hdr->i_tail;
-        left_cell != NULL &&
-           left_cell->i_cell_value == right_cell->i_cell_value;
-        left_cell = left_cell->i_prev, right_cell = right_cell->i_prev);
-
-   if (left_cell == NULL ||
-       left_cell->i_cell_value > right_cell->i_cell_value)
-      return NO;
-
-   return YES;
+   return fastest;
 
 }
 
 /*\
- *  \function{integer\_le()}
+ *  \function{calibrate\_cutoff()}
  *
- *  This function compares two integers for less than, where the integers
- *  may be either short or long.  It is meant to be called from the core
- *  interpreter for long integers, or for built-in functions for either
- *  type integer.  It returns YES if left is less than or equal right.
+ *  This function finds one multiplication cutoff.  At each length we
+ *  time a multiplication with the cutoff just above the length and
+ *  again with the cutoff at the length, so the faster method is used
+ *  at the top level only.  Timings are noisy, so the faster method must
+ *  win at two lengths in a row.  If it never wins we disable it.
 \*/
 
-int integer_le(
+static int32 calibrate_cutoff(
    SETL_SYSTEM_PROTO
-   specifier *left,                    /* left operand                      */
-   specifier *right)                   /* right operand                     */
+   int32 *cutoff,                      /* cutoff we calibrate               */
+   int32 first_length,                 /* shortest length to try            */
+   int32 last_length,                  /* longest length to try             */
+   integer_limb *work)                 /* operands and product              */
 
 {
-integer_h_ptr_type left_hdr, right_hdr;
-                                       /* header pointers for left and      */
-                                       /* right operands                    */
-integer_c_ptr_type left_cell, right_cell;
-                                       /* cell pointers for left and right  */
-                                       /* operands                          */
-
-   if (left->sp_form == ft_short) {
-
-      if (right->sp_form == ft_short) {
-
-         /*
-          *  Since both operands are short, we just compare the values.
-          */
-
-         return left->sp_val.sp_short_value <= right->sp_val.sp_short_value;
-
-      }
-
-      /*
-       *  The left operand is short but the right is long.  The long
-       *  must have a greater magnitude, we only need check the signs.
-       */
-
-      if ((right->sp_val.sp_long_ptr)->i_is_negative)
-         return NO;
-
-      return YES;
+double slower, faster;                 /* times below and above cutoff      */
+int32 found;                           /* first length faster method won    */
+int32 length;                          /* operand length                    */
+
+   found = 0;
+   for (length = first_length;
+        length <= last_length;
+        length += length / 4 + 1) {
+
+      *cutoff = length + 1;
+      slower = time_multiply(SETL_SYSTEM work,length);
+      *cutoff = length;
+      faster = time_multiply(SETL_SYSTEM work,length);
+
+      if (faster >= slower)
+         found = 0;
+      else if (found == 0)
+         found = length;
+      else
+         break;
 
    }
 
-   if (right->sp_form == ft_short) {
+   *cutoff = (length <= last_length) ? found : SHORT_INT_MAX;
 
-      /*
-       *  The right operand is short but the left is long.  The long
-       *  must have a greater magnitude, we only need check the signs.
-       */
-
-      if ((left->sp_val.sp_long_ptr)->i_is_negative)
-         return YES;
-
-      return NO;
-
-   }
+   return *cutoff;
 
-   /*
-    *  Both operands are long.  We use the signs if they are different,
-    *  otherwise we compare the cells.
-    */
-
-   left_hdr = left->sp_val.sp_long_ptr;
-   right_hdr = right->sp_val.sp_long_ptr;
+}
 
-   if (left_hdr->i_is_negative) {
+/*\
+ *  \function{calibrate\_multiply()}
+ *
+ *  This function sets the multiplication cutoffs for the current
+ *  machine.  We calibrate them in order, each with the cutoffs below it
+ *  already set and the ones above it disabled.  Operands are pseudo
+ *  random, so they have no long runs of zero or one bits.
+\*/
 
-      if (!(right_hdr->i_is_negative))
-         return YES;
+#define CALIBRATE_KARATSUBA_MAX 1024   /* longest length for Karatsuba      */
+#define CALIBRATE_TOOM3_MAX     4096   /* longest length for Toom-3         */
+#define CALIBRATE_FFT_MAX       65536  /* longest length for transforms     */
 
-      if (left_hdr->i_cell_count < right_hdr->i_cell_count)
-         return NO;
+void calibrate_multiply(
+   SETL_SYSTEM_PROTO_VOID)
 
-      if (left_hdr->i_cell_count > right_hdr->i_cell_count)
-         return YES;
+{
+integer_limb *work;                    /* operands and product              */
+integer_limb limb;                     /* one pseudo random limb            */
+unsigned long long seed;               /* random number seed                */
+int32 first_length;                    /* shortest length to try            */
+int32 i;                               /* temporary looping variable        */
+size_t j;                              /* temporary looping variable        */
 
-      for (left_cell = left_hdr->i_tail, right_cell = right_hdr->i_tail;
-           left_cell != NULL &&
-              left_cell->i_cell_value == right_cell->i_cell_value;
-           left_cell = left_cell->i_prev, right_cell = right_cell->i_prev);
+   work = (integer_limb *)malloc((size_t)
+         (4 * CALIBRATE_FFT_MAX * sizeof(integer_limb)));
+   if (work == NULL)
+      giveup(SETL_SYSTEM msg_malloc_error);
 
-      if (left_cell != NULL &&
-          left_cell->i_cell_value < right_cell->i_cell_value)
-         return NO;
+   seed = 1;
+   for (i = 0; i < 4 * CALIBRATE_FFT_MAX; i++) {
 
-      return YES;
+      limb = 0;
+      for (j = 0; j < sizeof(integer_limb); j++) {
+         seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+         limb = (limb << 8) | (integer_limb)(seed >> 56);
+      }
+      work[i] = limb;
 
    }
 
-   if (right_hdr->i_is_negative)
-      return NO;
+   karatsuba_cutoff = toom3_cutoff = fft_cutoff = SHORT_INT_MAX;
 
-   if (left_hdr->i_cell_count > right_hdr->i_cell_count)
-      return NO;
+   calibrate_cutoff(SETL_SYSTEM &karatsuba_cutoff,
+                    MIN_SPLIT_LIMBS,CALIBRATE_KARATSUBA_MAX,work);
 
-   if (left_hdr->i_cell_count < right_hdr->i_cell_count)
-      return YES;
+   first_length = (karatsuba_cutoff < CALIBRATE_KARATSUBA_MAX) ?
+                  2 * karatsuba_cutoff : CALIBRATE_KARATSUBA_MAX;
+   calibrate_cutoff(SETL_SYSTEM &toom3_cutoff,
+                    first_length,CALIBRATE_TOOM3_MAX,work);
 
-   for (left_cell = left_hdr->i_tail, right_cell = right_hdr->i_tail;
-        left_cell != NULL &&
-           left_cell->i_cell_value == right_cell->i_cell_value;
-        left_cell = left_cell->i_prev, right_cell = right_cell->i_prev);
+   if (toom3_cutoff < CALIBRATE_TOOM3_MAX)
+      first_length = toom3_cutoff;
+   calibrate_cutoff(SETL_SYSTEM &fft_cutoff,
+                    first_length,CALIBRATE_FFT_MAX,work);
 
-   if (left_cell != NULL &&
-       left_cell->i_cell_value > right_cell->i_cell_value)
-      return NO;
+   free((void *)work);
 
-   return YES;
+   return;
 
 }
-
-
@@ -28,59 +28,164 @@
 
 #ifndef INTEGERS_LOADED
 
+/* SETL2 system header files */
+
+#include "slabs.h"                     /* slabs                             */
+
+/*
+ *  Library and binary files store long integers as a list of cells, each
+ *  holding INT_CELL_WIDTH bits.  We no longer compute with cells, but we
+ *  keep their width to read and write those files.
+ */
+
 #define INT_CELL_WIDTH    (sizeof(int32) * 4 - 1)
                                        /* width of integer cell in bits     */
 #define MAX_INT_CELL      ((1L << INT_CELL_WIDTH) - 1)
                                        /* maximum value of a cell           */
-#define INT_HIGH_BITS     (((1L << INT_CELL_WIDTH + 2) - 1) << INT_CELL_WIDTH)
 
-/* integer header node structure */
+/*
+ *  Long integers are a contiguous array of limbs, low order first.  We
+ *  use the widest limb for which the compiler gives us a type twice as
+ *  wide, to hold products and dividends.
+ */
+
+#ifdef __SIZEOF_INT128__
+typedef unsigned long long integer_limb;
+                                       /* one digit of a long integer       */
+typedef unsigned __int128 integer_dlimb;
+                                       /* holds the product of two limbs    */
+#else
+typedef unsigned int integer_limb;     /* one digit of a long integer       */
+typedef unsigned long long integer_dlimb;
+                                       /* holds the product of two limbs    */
+#endif
+
+#define INT_LIMB_WIDTH    ((int)(sizeof(integer_limb) * 8))
+                                       /* width of integer limb in bits     */
+#define INT_INLINE_LIMBS  2            /* limbs kept in the header          */
+
+/*
+ *  Short integers may hold any C long except the most negative, so we
+ *  can always negate them.  Tagged specifiers only have room for the
+ *  value bits, so there we have to check both ends.  The arithmetic
+ *  macros yield YES and set the result if an operation on two shorts
+ *  gives a short, and NO if we must fall back on the long integer
+ *  functions.
+ */
+
+#if !TAGGED_SPECS
+
+#define SHORT_INT_MAX     ((int32)(~0UL >> 1))
+                                       /* largest short integer             */
+#define SHORT_INT_MIN     (-SHORT_INT_MAX)
+                                       /* smallest short integer            */
+#define is_short_value(v) ((v) >= SHORT_INT_MIN)
+                                       /* YES if a C long fits in a short   */
+
+#else
+
+#define SHORT_INT_MAX     ((int32)(SPEC_VALUE_MASK >> 1))
+                                       /* largest short integer             */
+#define SHORT_INT_MIN     (-SHORT_INT_MAX)
+                                       /* smallest short integer            */
+#define is_short_value(v) \
+   ((v) >= SHORT_INT_MIN && (v) <= SHORT_INT_MAX)
+                                       /* YES if a C long fits in a short   */
+
+#endif
+
+#if (defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__)
+
+#define short_add(r,a,b) \
+   (!__builtin_add_overflow((a),(b),&(r)) && is_short_value(r))
+#define short_subtract(r,a,b) \
+   (!__builtin_sub_overflow((a),(b),&(r)) && is_short_value(r))
+#define short_multiply(r,a,b) \
+   (!__builtin_mul_overflow((a),(b),&(r)) && is_short_value(r))
+
+#else
+
+#define short_add(r,a,b) \
+   (((b) >= 0 ? (a) <= SHORT_INT_MAX - (b) : (a) >= SHORT_INT_MIN - (b)) && \
+    ((r) = (a) + (b), YES))
+#define short_subtract(r,a,b) \
+   (((b) <= 0 ? (a) <= SHORT_INT_MAX + (b) : (a) >= SHORT_INT_MIN + (b)) && \
+    ((r) = (a) - (b), YES))
+#define short_multiply(r,a,b) \
+   (((a) == 0 || labs(b) <= SHORT_INT_MAX / labs(a)) && \
+    ((r) = (a) * (b), YES))
+
+#endif
+
+/*
+ *  Integer header node structure.  The use count and hash code must
+ *  come first, in the same order as other headers.  Integers which fit
+ *  in INT_INLINE_LIMBS limbs keep them in the header, so we only call
+ *  malloc() for large integers.
+ */
 
 struct integer_h_item {
    int32 i_use_count;                  /* usage count                       */
    int32 i_hash_code;                  /* hash code                         */
-   int32 i_cell_count;                 /* number of cells in list           */
+   int32 i_limb_count;                 /* number of limbs in use            */
+   int32 i_limb_alloc;                 /* number of limbs allocated         */
    int i_is_negative;                  /* YES if integer is negative        */
-   struct integer_c_item *i_head;      /* first cell in list                */
-   struct integer_c_item *i_tail;      /* last cell in list                 */
+   integer_limb *i_limbs;              /* limb array, low order first       */
+   integer_limb i_inline[INT_INLINE_LIMBS];
+                                       /* limbs of small integers           */
 };
 
 typedef struct integer_h_item *integer_h_ptr_type;
                                        /* header node pointer               */
 
-/* integer cell node structure */
+/*
+ *  Multiplication switches from the classical method to Karatsuba's,
+ *  then Toom-3 and then number theoretic transforms as the shorter
+ *  operand grows.  The cutoffs are in limbs.  These defaults may be
+ *  overridden when building, or at run time with stlx -k, and stlx
+ *  --calibrate measures them for the current machine.
+ */
 
-struct integer_c_item {
-   struct integer_c_item *i_next;      /* next cell in list                 */
-   struct integer_c_item *i_prev;      /* previous cell in list             */
-   int32 i_cell_value;                 /* cell value                        */
-};
+#ifndef KARATSUBA_CUTOFF
+#define KARATSUBA_CUTOFF  24           /* Karatsuba from here on            */
+#endif
+#ifndef TOOM3_CUTOFF
+#define TOOM3_CUTOFF      96           /* Toom-3 from here on               */
+#endif
+#ifndef FFT_CUTOFF
+#define FFT_CUTOFF        24576        /* transforms from here on           */
+#endif
+
+#ifdef SHARED
+
+int32 karatsuba_cutoff = KARATSUBA_CUTOFF;
+                                       /* Karatsuba cutoff in limbs         */
+int32 toom3_cutoff = TOOM3_CUTOFF;     /* Toom-3 cutoff in limbs            */
+int32 fft_cutoff = FFT_CUTOFF;         /* transform cutoff in limbs         */
 
-typedef struct integer_c_item *integer_c_ptr_type;
-                                       /* cell node pointer                 */
+#else
+
+extern int32 karatsuba_cutoff;         /* Karatsuba cutoff in limbs         */
+extern int32 toom3_cutoff;             /* Toom-3 cutoff in limbs            */
+extern int32 fft_cutoff;               /* transform cutoff in limbs         */
+
+#endif
 
 /* global data */
 
 #ifdef TSAFE
-#define INTEGER_H_NEXT_FREE plugin_instance->integer_h_next_free 
-#define INTEGER_C_NEXT_FREE plugin_instance->integer_c_next_free 
+#define INTEGER_H_SLAB plugin_instance->integer_h_slab
 #else
-#define INTEGER_H_NEXT_FREE integer_h_next_free 
-#define INTEGER_C_NEXT_FREE integer_c_next_free 
+#define INTEGER_H_SLAB integer_h_slab
 
 #ifdef SHARED
 
-integer_h_ptr_type integer_h_next_free = NULL;
-                                       /* next free header                  */
-integer_c_ptr_type integer_c_next_free = NULL;
-                                       /* next free cell                    */
+struct slab_class_item integer_h_slab; /* header slabs                      */
 
 #else
 
-extern integer_h_ptr_type integer_h_next_free;
-                                       /* next free header                  */
-extern integer_c_ptr_type integer_c_next_free;
-                                       /* next free cell                    */
+extern struct slab_class_item integer_h_slab;
+                                       /* header slabs                      */
 
 #endif
 #endif
@@ -97,65 +202,53 @@ extern integer_c_ptr_type integer_c_next_free;
 
 #define free_integer_header(s) free(s)
 
-#define get_integer_cell(t) {\
-   t = (integer_c_ptr_type)malloc(sizeof(struct integer_c_item));\
-   if (t == NULL)\
-      giveup(SETL_SYSTEM msg_malloc_error);\
-}
-
-#define free_integer_cell(s) free(s)
-
 #else
 
-#define get_integer_header(t) {\
-   if (INTEGER_H_NEXT_FREE == NULL) alloc_integer_headers(SETL_SYSTEM_VOID); \
-   (t) = INTEGER_H_NEXT_FREE; \
-   INTEGER_H_NEXT_FREE = *((integer_h_ptr_type *)(INTEGER_H_NEXT_FREE)); \
-}
+#define get_integer_header(t) \
+   slab_get(INTEGER_H_SLAB,"integer header",integer_h_ptr_type,t,\
+            sizeof(struct integer_h_item))
 
-#define free_integer_header(s) {\
-   *((integer_h_ptr_type *)(s)) = INTEGER_H_NEXT_FREE; \
-   INTEGER_H_NEXT_FREE = s; \
-}
-
-/* allocate and free cell nodes */
-
-#define get_integer_cell(t) {\
-   if (INTEGER_C_NEXT_FREE == NULL) alloc_integer_cells(SETL_SYSTEM_VOID); \
-   (t) = INTEGER_C_NEXT_FREE; \
-   INTEGER_C_NEXT_FREE = *((integer_c_ptr_type *)(INTEGER_C_NEXT_FREE)); \
-}
-
-#define free_integer_cell(s) {\
-   *((integer_c_ptr_type *)(s)) = INTEGER_C_NEXT_FREE; \
-   INTEGER_C_NEXT_FREE = s; \
-}
+#define free_integer_header(s) slab_put(s)
 
 #endif
 
 /* public function declarations */
 
-void alloc_integer_headers(SETL_SYSTEM_PROTO_VOID);      
-                                       /* allocate a block of header nodes  */
-void alloc_integer_cells(SETL_SYSTEM_PROTO_VOID);        
-                                       /* allocate a block of cell nodes    */
 void free_interp_integer(SETL_SYSTEM_PROTO integer_h_ptr_type);
                                        /* release memory used by integer    */
 integer_h_ptr_type copy_integer(SETL_SYSTEM_PROTO integer_h_ptr_type);
                                        /* copy an integer structure         */
+integer_h_ptr_type new_integer(SETL_SYSTEM_PROTO int32);
+                                       /* allocate a zero long integer      */
+void set_integer_cell(SETL_SYSTEM_PROTO
+                      integer_h_ptr_type, int32, int32);
+                                       /* store a file cell in an integer   */
+int32 integer_cell_count(integer_h_ptr_type);
+                                       /* number of file cells needed       */
+int32 integer_cell_value(integer_h_ptr_type, int32);
+                                       /* fetch a file cell from integer    */
 void short_to_long(SETL_SYSTEM_PROTO
                    struct specifier_item *, int32);
                                        /* convert a C long to SETL2 integer */
 int32 long_to_short(SETL_SYSTEM_PROTO
                     integer_h_ptr_type);
                                        /* convert a SETL2 integer to C long */
+void normalize_long(SETL_SYSTEM_PROTO
+                    struct specifier_item *, integer_h_ptr_type);
+                                       /* store a long, as a short if it    */
+                                       /* will fit                          */
 double long_to_double(SETL_SYSTEM_PROTO
                       struct specifier_item *);
                                        /* convert a SETL2 long to double    */
+void calibrate_multiply(SETL_SYSTEM_PROTO_VOID);
+                                       /* measure multiplication cutoffs    */
 char *integer_string(SETL_SYSTEM_PROTO
                      struct specifier_item *, int);
                                        /* generate character string from    */
                                        /* integer structure                 */
+integer_h_ptr_type integer_from_digits(SETL_SYSTEM_PROTO
+                                       char *, int32, int);
+                                       /* build integer from digit values   */
 void integer_add(SETL_SYSTEM_PROTO
                  struct specifier_item *, struct specifier_item *,
                  struct specifier_item *);
@@ -129,17 +129,11 @@ void main(
 {
 char *arg;                             /* current argument pointer          */
 char program[MAX_UNIT_NAME + 1];       /* program to be executed            */
-tuple_h_ptr_type tuple_root, tuple_work_hdr, new_tuple_hdr;
-                                       /* tuple header pointers             */
+tuple_h_ptr_type tuple_root;           /* command line tuple                */
 tuple_c_ptr_type tuple_cell;           /* tuple cell pointer                */
-int tuple_index, tuple_height;         /* used to descend header trees      */
 int32 tuple_length;                    /* current tuple length              */
-int32 expansion_trigger;               /* size which triggers header        */
-                                       /* expansion                         */
 string_h_ptr_type target_hdr;          /* target string                     */
-string_c_ptr_type target_cell;         /* target string cell                */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
+
 unittab_ptr_type unit_ptr;             /* program unit pointer              */
 char *p,*q,*s;                         /* temporary looping variable        */
 int i;                                 /* temporary looping variable        */
@@ -256,8 +250,6 @@ argc == ccommand(&argv);
 
    tuple_root=new_tuple(SETL_SYSTEM_VOID);
 
-   expansion_trigger = TUP_HEADER_SIZE;
-
    /* loop through remaining arguments */
 
    tuple_length = 0;
@@ -268,120 +260,19 @@ argc == ccommand(&argv);
 
       /* make a target string */
 
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = strlen(arg);
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-      target_char_ptr = target_char_end = NULL;
-
-      /* copy the argument to the string */
-
-      for (p = arg; *p; p++) {
-
-         if (target_char_ptr == target_char_end) {
-
-            get_string_cell(target_cell);
-            if (target_hdr->s_tail != NULL)
-               (target_hdr->s_tail)->s_next = target_cell;
-            target_cell->s_prev = target_hdr->s_tail;
-            target_cell->s_next = NULL;
-            target_hdr->s_tail = target_cell;
-            if (target_hdr->s_head == NULL)
-               target_hdr->s_head = target_cell;
-            target_char_ptr = target_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *target_char_ptr++ = *p;
-
-      }
+      target_hdr = new_string(SETL_SYSTEM arg);
 
       /*
        *  Now we have to insert the string we just created into the
        *  command line tuple.
        */
 
-      /* expand the tuple tree if necessary */
-
-      if (tuple_length >= expansion_trigger) {
-
-         tuple_work_hdr = tuple_root;
-
-         get_tuple_header(tuple_root);
-
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code =
-            tuple_work_hdr->t_hash_code;
-         tuple_root->t_ntype.t_root.t_length =
-            tuple_work_hdr->t_ntype.t_root.t_length;
-         tuple_root->t_ntype.t_root.t_height =
-            tuple_work_hdr->t_ntype.t_root.t_height + 1;
-
-         for (i = 1;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_header = NULL);
-
-         tuple_root->t_child[0].t_header = tuple_work_hdr;
-
-         tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-         tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-         expansion_trigger *= TUP_HEADER_SIZE;
-
-      }
-
-      tuple_root->t_ntype.t_root.t_length++;
-
-      /* descend the tree to a leaf */
-
-      tuple_work_hdr = tuple_root;
-      for (tuple_height = tuple_work_hdr->t_ntype.t_root.t_height;
-           tuple_height;
-           tuple_height--) {
-
-         /* extract the element's index at this level */
-
-         tuple_index = (tuple_length >>
-                              (tuple_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (tuple_work_hdr->t_child[tuple_index].t_header == NULL) {
-
-            get_tuple_header(new_tuple_hdr);
-            new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-            new_tuple_hdr->t_ntype.t_intern.t_child_index = tuple_index;
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_tuple_hdr->t_child[i++].t_cell = NULL);
-            tuple_work_hdr->t_child[tuple_index].t_header =
-                  new_tuple_hdr;
-            tuple_work_hdr = new_tuple_hdr;
-
-         }
-         else {
-
-            tuple_work_hdr =
-               tuple_work_hdr->t_child[tuple_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, tuple_work_hdr points to the lowest level header
-       *  record.  We insert the new element.
-       */
-
-      tuple_index = tuple_length & TUP_SHIFT_MASK;
-      get_tuple_cell(tuple_cell);
-      tuple_cell->t_spec.sp_form = ft_string;
-      tuple_cell->t_spec.sp_val.sp_string_ptr = target_hdr;
+      reserve_tuple(tuple_root,tuple_length + 1);
+      tuple_cell = tuple_root->t_cells + tuple_length;
+      spec_set_form(&tuple_cell->t_spec,ft_string);
+      spec_set_val(&tuple_cell->t_spec,sp_string_ptr,target_hdr);
       spec_hash_code(tuple_cell->t_hash_code,&(tuple_cell->t_spec));
       tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
-      tuple_work_hdr->t_child[tuple_index].t_cell = tuple_cell;
 
       /* increment the tuple size */
 
@@ -394,9 +285,9 @@ argc == ccommand(&argv);
 
    /* set the command line tuple to the tuple we just created */
 
-   tuple_root->t_ntype.t_root.t_length = tuple_length;
-   spec_cline->sp_form = ft_tuple;
-   spec_cline->sp_val.sp_tuple_ptr = tuple_root;
+   tuple_root->t_length = tuple_length;
+   spec_set_form(spec_cline,ft_tuple);
+   spec_set_val(spec_cline,sp_tuple_ptr,tuple_root);
 
    /* now that the command line tuple is built, we can load the program */
 
@@ -449,19 +340,12 @@ argc == ccommand(&argv);
 
 void Setl_SetCommandLine(SETL_SYSTEM_PROTO int argc,int optind,char **argv)
 {
-tuple_h_ptr_type tuple_root, tuple_work_hdr, new_tuple_hdr;
-                                       /* tuple header pointers             */
+tuple_h_ptr_type tuple_root;           /* command line tuple                */
 tuple_c_ptr_type tuple_cell;           /* tuple cell pointer                */
-int tuple_index, tuple_height;         /* used to descend header trees      */
 int32 tuple_length;                    /* current tuple length              */
-int32 expansion_trigger;               /* size which triggers header        */
-                                       /* expansion                         */
 string_h_ptr_type target_hdr;          /* target string                     */
-string_c_ptr_type target_cell;         /* target string cell                */
-char *target_char_ptr, *target_char_end;
-                                       /* target string pointers            */
-char *arg,*p;
-int i;
+
+char *arg;
 
    /*
     *  We build up the command line tuple before loading the program, in
@@ -472,8 +356,6 @@ int i;
 
    tuple_root=new_tuple(SETL_SYSTEM_VOID);
 
-   expansion_trigger = TUP_HEADER_SIZE;
-
    /* loop through remaining arguments */
 
    tuple_length = 0;
@@ -485,120 +367,19 @@ int i;
 
       /* make a target string */
 
-      get_string_header(target_hdr);
-      target_hdr->s_use_count = 1;
-      target_hdr->s_hash_code = -1;
-      target_hdr->s_length = strlen(arg);
-      target_hdr->s_head = target_hdr->s_tail = NULL;
-      target_char_ptr = target_char_end = NULL;
-
-      /* copy the argument to the string */
-
-      for (p = arg; *p; p++) {
-
-         if (target_char_ptr == target_char_end) {
-
-            get_string_cell(target_cell);
-            if (target_hdr->s_tail != NULL)
-               (target_hdr->s_tail)->s_next = target_cell;
-            target_cell->s_prev = target_hdr->s_tail;
-            target_cell->s_next = NULL;
-            target_hdr->s_tail = target_cell;
-            if (target_hdr->s_head == NULL)
-               target_hdr->s_head = target_cell;
-            target_char_ptr = target_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-         }
-
-         *target_char_ptr++ = *p;
-
-      }
+      target_hdr = new_string(SETL_SYSTEM arg);
 
       /*
        *  Now we have to insert the string we just created into the
        *  command line tuple.
        */
 
-      /* expand the tuple tree if necessary */
-
-      if (tuple_length >= expansion_trigger) {
-
-         tuple_work_hdr = tuple_root;
-
-         get_tuple_header(tuple_root);
-
-         tuple_root->t_use_count = 1;
-         tuple_root->t_hash_code =
-            tuple_work_hdr->t_hash_code;
-         tuple_root->t_ntype.t_root.t_length =
-            tuple_work_hdr->t_ntype.t_root.t_length;
-         tuple_root->t_ntype.t_root.t_height =
-            tuple_work_hdr->t_ntype.t_root.t_height + 1;
-
-         for (i = 1;
-              i < TUP_HEADER_SIZE;
-              tuple_root->t_child[i++].t_header = NULL);
-
-         tuple_root->t_child[0].t_header = tuple_work_hdr;
-
-         tuple_work_hdr->t_ntype.t_intern.t_parent = tuple_root;
-         tuple_work_hdr->t_ntype.t_intern.t_child_index = 0;
-
-         expansion_trigger *= TUP_HEADER_SIZE;
-
-      }
-
-      tuple_root->t_ntype.t_root.t_length++;
-
-      /* descend the tree to a leaf */
-
-      tuple_work_hdr = tuple_root;
-      for (tuple_height = tuple_work_hdr->t_ntype.t_root.t_height;
-           tuple_height;
-           tuple_height--) {
-
-         /* extract the element's index at this level */
-
-         tuple_index = (tuple_length >>
-                              (tuple_height * TUP_SHIFT_DIST)) &
-                           TUP_SHIFT_MASK;
-
-         /* if we're missing a header record, allocate one */
-
-         if (tuple_work_hdr->t_child[tuple_index].t_header == NULL) {
-
-            get_tuple_header(new_tuple_hdr);
-            new_tuple_hdr->t_ntype.t_intern.t_parent = tuple_work_hdr;
-            new_tuple_hdr->t_ntype.t_intern.t_child_index = tuple_index;
-            for (i = 0;
-                 i < TUP_HEADER_SIZE;
-                 new_tuple_hdr->t_child[i++].t_cell = NULL);
-            tuple_work_hdr->t_child[tuple_index].t_header =
-                  new_tuple_hdr;
-            tuple_work_hdr = new_tuple_hdr;
-
-         }
-         else {
-
-            tuple_work_hdr =
-               tuple_work_hdr->t_child[tuple_index].t_header;
-
-         }
-      }
-
-      /*
-       *  At this point, tuple_work_hdr points to the lowest level header
-       *  record.  We insert the new element.
-       */
-
-      tuple_index = tuple_length & TUP_SHIFT_MASK;
-      get_tuple_cell(tuple_cell);
-      tuple_cell->t_spec.sp_form = ft_string;
-      tuple_cell->t_spec.sp_val.sp_string_ptr = target_hdr;
+      reserve_tuple(tuple_root,tuple_length + 1);
+      tuple_cell = tuple_root->t_cells + tuple_length;
+      spec_set_form(&tuple_cell->t_spec,ft_string);
+      spec_set_val(&tuple_cell->t_spec,sp_string_ptr,target_hdr);
       spec_hash_code(tuple_cell->t_hash_code,&(tuple_cell->t_spec));
       tuple_root->t_hash_code ^= tuple_cell->t_hash_code;
-      tuple_work_hdr->t_child[tuple_index].t_cell = tuple_cell;
 
       /* increment the tuple size */
 
@@ -609,9 +390,9 @@ int i;
 
    /* set the command line tuple to the tuple we just created */
 
-   tuple_root->t_ntype.t_root.t_length = tuple_length;
-   spec_cline->sp_form = ft_tuple;
-   spec_cline->sp_val.sp_tuple_ptr = tuple_root;
+   tuple_root->t_length = tuple_length;
+   spec_set_form(spec_cline,ft_tuple);
+   spec_set_val(spec_cline,sp_tuple_ptr,tuple_root);
 
 }
 
@@ -707,7 +488,10 @@ char key[1024];
 void profiler_dump(SETL_SYSTEM_PROTO_VOID)
 {
 long l;                                /* temporary looping variable        */
-int i;                                 /* temporary looping variable        */
+int i,j,k;                             /* temporary looping variables       */
+long total;                            /* instructions executed             */
+long threshold;                        /* least interesting n-gram count    */
+long count;                            /* n-gram count                      */
 
 
 #ifdef DEBUG
@@ -758,6 +542,41 @@ int i;                                 /* temporary looping variable        */
 
       }
 
+      /*
+       *  List the straight-line opcode sequences which account for at
+       *  least one in a thousand instructions.  The ngrams script in
+       *  the benchmark directory collects these over many runs.
+       */
+
+      fprintf(DEBUG_FILE,"\n=================== OPCODE SEQUENCES ===================\n");
+
+      total = 0;
+      for (i=0;i<=pcode_length;i++) {
+         if (i != p_filepos)
+            total += pcode_operations[i];
+      }
+      threshold = total / 1000;
+
+      fprintf(DEBUG_FILE,"TOTAL => Operations: %9ld\n",total);
+
+      for (i=0;i<=pcode_length;i++) {
+         for (j=0;j<=pcode_length;j++) {
+            if (pcode_pairs[i][j] > threshold) {
+               fprintf(DEBUG_FILE,"NGRAM => %s %s Count: %9ld\n",
+                       pcode_desc[i],pcode_desc[j],pcode_pairs[i][j]);
+            }
+            for (k=0;pcode_triples!=NULL && k<=pcode_length;k++) {
+               count = pcode_triples[(i * PCODE_NGRAM_SIZE + j) *
+                                     PCODE_NGRAM_SIZE + k];
+               if (count > threshold) {
+                  fprintf(DEBUG_FILE,"NGRAM => %s %s %s Count: %9ld\n",
+                          pcode_desc[i],pcode_desc[j],pcode_desc[k],count);
+               }
+            }
+         }
+      }
+      fflush(DEBUG_FILE);
+
    }
    if (DEBUG_FILE!=stdout) fclose(DEBUG_FILE);
   
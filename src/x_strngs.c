@@ -40,6 +40,10 @@
 \*/
 
 
+/* standard C header files */
+
+#include <stdlib.h>                    /* memory allocation                 */
+
 /* SETL2 system header files */
 
 #include "system.h"                    /* SETL2 system constants            */
@@ -51,100 +55,90 @@
 #include "specs.h"                     /* specifiers                        */
 #include "x_strngs.h"                  /* strings                           */
 
-/* performance tuning constants */
-
-#define STR_HEADER_BLOCK_SIZE  100     /* string header block size          */
-#define STR_CELL_BLOCK_SIZE    100     /* string cell block size            */
-
 /*\
- *  \function{alloc\_string\_headers()}
+ *  \function{new\_string\_buffer()}
  *
- *  This function allocates a block of string headers and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste header items to pointers to header items in order to form the
- *  free list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently,
- *  while at the same time avoiding an extra pointer on the header node.
- *  It will work provided a header item is larger than a pointer, which
- *  is the case.
+ *  This function allocates a string of a given length.  The caller
+ *  fills in the characters; we only store the terminating null.  Short
+ *  strings fit in the header, so they need no further allocation.
 \*/
 
-void alloc_string_headers(
-   SETL_SYSTEM_PROTO_VOID)
+string_h_ptr_type new_string_buffer(
+   SETL_SYSTEM_PROTO
+   int32 length)                       /* length of string                  */
 
 {
-string_h_ptr_type new_block;           /* first header in allocated block   */
-
-   /* allocate a new block */
-
-   new_block = (string_h_ptr_type)malloc((size_t)
-         (STR_HEADER_BLOCK_SIZE * sizeof(struct string_h_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
+string_h_ptr_type target_hdr;          /* new structure                     */
 
-   /* link items on the free list */
+   get_string_header(target_hdr);
+   target_hdr->s_use_count = 1;
+   target_hdr->s_hash_code = -1;
+   target_hdr->s_length = length;
 
-   for (STRING_H_NEXT_FREE = new_block;
-        STRING_H_NEXT_FREE < new_block + STR_HEADER_BLOCK_SIZE - 1;
-        STRING_H_NEXT_FREE++) {
+   if (length < STR_INLINE_WIDTH) {
 
-      *((string_h_ptr_type *)STRING_H_NEXT_FREE) = STRING_H_NEXT_FREE + 1;
+      target_hdr->s_chars = target_hdr->s_inline;
+      target_hdr->s_capacity = STR_INLINE_WIDTH - 1;
 
    }
+   else {
 
-   *((string_h_ptr_type *)STRING_H_NEXT_FREE) = NULL;
+      target_hdr->s_chars = (char *)malloc((size_t)(length + 1));
+      if (target_hdr->s_chars == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
+      target_hdr->s_capacity = length;
 
-   /* set next free node to new block */
+   }
 
-   STRING_H_NEXT_FREE = new_block;
+   target_hdr->s_chars[length] = '\0';
 
-   return;
+   return target_hdr;
 
 }
 
 /*\
- *  \function{alloc\_string\_cells()}
+ *  \function{grow\_string()}
  *
- *  This function allocates a block of string cells and links them
- *  together into a free list.  Note carefully the castes used here: we
- *  caste cell items to pointers to cell items in order to form the free
- *  list.  This is extremely ugly, and we are not proud of the
- *  implementation, but it seems to be the only reasonable way to allow
- *  the allocation and release macros to be implemented efficiently, while
- *  at the same time avoiding an extra pointer on the cell node.  It
- *  will work provided a cell item is larger than a pointer, which is
- *  the case.
+ *  This function makes room for at least a given number of characters
+ *  in a string, keeping those it has.  We at least double the capacity
+ *  each time, so building a string a character at a time takes linear
+ *  time.  Callers should use the \verb"reserve_string()" macro, which
+ *  only calls us if the string is too small.
 \*/
 
-void alloc_string_cells(
-   SETL_SYSTEM_PROTO_VOID)
+void grow_string(
+   SETL_SYSTEM_PROTO
+   string_h_ptr_type string_hdr,       /* string to be enlarged             */
+   int32 length)                       /* characters we need room for       */
 
 {
-string_c_ptr_type new_block;           /* first cell in allocated block     */
+char *new_chars;                       /* enlarged character buffer         */
+int32 new_capacity;                    /* capacity of new_chars             */
 
-   /* allocate a new block */
-
-   new_block = (string_c_ptr_type)malloc((size_t)
-         (STR_CELL_BLOCK_SIZE * sizeof(struct string_c_item)));
-   if (new_block == NULL)
-      giveup(SETL_SYSTEM msg_malloc_error);
+   new_capacity = string_hdr->s_capacity * 2;
+   if (new_capacity < length)
+      new_capacity = length;
 
-   /* link items on the free list */
+   if (string_hdr->s_chars == string_hdr->s_inline) {
 
-   for (STRING_C_NEXT_FREE = new_block;
-        STRING_C_NEXT_FREE < new_block + STR_CELL_BLOCK_SIZE - 1;
-        STRING_C_NEXT_FREE++) {
-
-      *((string_c_ptr_type *)STRING_C_NEXT_FREE) = STRING_C_NEXT_FREE + 1;
+      new_chars = (char *)malloc((size_t)(new_capacity + 1));
+      if (new_chars == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
+      memcpy((void *)new_chars,(void *)(string_hdr->s_inline),
+             (size_t)(string_hdr->s_length + 1));
 
    }
+   else {
 
-   *((string_c_ptr_type *)STRING_C_NEXT_FREE) = NULL;
+      new_chars = (char *)realloc((void *)(string_hdr->s_chars),
+                                  (size_t)(new_capacity + 1));
+      if (new_chars == NULL)
+         giveup(SETL_SYSTEM msg_malloc_error);
 
-   /* set next free node to new block */
+   }
 
-   STRING_C_NEXT_FREE = new_block;
+   string_hdr->s_chars = new_chars;
+   string_hdr->s_capacity = new_capacity;
 
    return;
 
@@ -161,17 +155,9 @@ void free_string(
    string_h_ptr_type string_hdr)       /* string root                       */
 
 {
-string_c_ptr_type string_cell_1, string_cell_2;
-                                       /* string cell pointers              */
 
-   string_cell_1 = string_hdr->s_head;
-   while (string_cell_1 != NULL) {
-
-      string_cell_2 = string_cell_1;
-      string_cell_1 = string_cell_1->s_next;
-      free_string_cell(string_cell_2);
-
-   }
+   if (string_hdr->s_chars != string_hdr->s_inline)
+      free((void *)(string_hdr->s_chars));
 
    free_string_header(string_hdr);
 
@@ -182,6 +168,7 @@ string_c_ptr_type string_cell_1, string_cell_2;
 /*\
  *  \function{new\_string()}
  *
+ *  This function converts a null terminated C string to a SETL2 string.
 \*/
 
 string_h_ptr_type new_string(
@@ -189,52 +176,37 @@ string_h_ptr_type new_string(
    char *source)                       /* string to be converted            */
 
 {
-string_h_ptr_type target_hdr;          /* new structure                     */
-string_c_ptr_type target_cell; 
-
-char *target_char_ptr,*target_char_end;
-char *p;
-
-   /* allocate a new header */
 
-   get_string_header(target_hdr);
-   target_hdr->s_use_count = 1;
-   target_hdr->s_hash_code = -1;
-   target_hdr->s_length = strlen(source);
-   target_hdr->s_head = target_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   /* copy the argument to the string */
-
-   for (p = source; *p; p++) {
+   return new_string_chars(SETL_SYSTEM source,(int32)strlen(source));
 
-      if (target_char_ptr == target_char_end) {
+}
 
-         get_string_cell(target_cell);
-         if (target_hdr->s_tail != NULL)
-            (target_hdr->s_tail)->s_next = target_cell;
-         target_cell->s_prev = target_hdr->s_tail;
-         target_cell->s_next = NULL;
-         target_hdr->s_tail = target_cell;
-         if (target_hdr->s_head == NULL)
-            target_hdr->s_head = target_cell;
-         target_char_ptr = target_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
+/*\
+ *  \function{new\_string\_chars()}
+ *
+ *  This function converts a C character array of a given length, which
+ *  may contain nulls, to a SETL2 string.
+\*/
 
-      }
+string_h_ptr_type new_string_chars(
+   SETL_SYSTEM_PROTO
+   char *source,                       /* characters to be converted        */
+   int32 length)                       /* number of characters              */
 
-      *target_char_ptr++ = *p;
+{
+string_h_ptr_type target_hdr;          /* new structure                     */
 
-   }
+   target_hdr = new_string_buffer(SETL_SYSTEM length);
+   memcpy((void *)(target_hdr->s_chars),(void *)source,(size_t)length);
 
    return target_hdr;
 
 }
+
 /*\
  *  \function{copy\_string()}
  *
- *  This function copies a string structure, and all associated string
- *  cells.
+ *  This function copies a string structure, and its characters.
 \*/
 
 string_h_ptr_type copy_string(
@@ -243,49 +215,9 @@ string_h_ptr_type copy_string(
 
 {
 string_h_ptr_type target;              /* new structure                     */
-string_c_ptr_type s1,t1,t2;            /* used to traverse source and       */
-                                       /* target lists                      */
-char *s,*t;                            /* temporary looping variables       */
 
-   /* allocate a new header */
-
-   get_string_header(target);
-
-   target->s_use_count = 1;
+   target = new_string_chars(SETL_SYSTEM source->s_chars,source->s_length);
    target->s_hash_code = source->s_hash_code;
-   target->s_length = source->s_length;
-   target->s_head = target->s_tail = NULL;
-
-   /* copy each cell node */
-
-   t1 = t2 = NULL;
-   for (s1 = source->s_head;
-        s1 != NULL;
-        s1 = s1->s_next) {
-
-      /* allocate a new cell node */
-
-      get_string_cell(t1);
-      if (t2 != NULL)
-         t2->s_next = t1;
-      else
-         target->s_head = t1;
-
-      t1->s_prev = t2;
-      t2 = t1;
-
-      for (s = s1->s_cell_value, t = t1->s_cell_value;
-           s < s1->s_cell_value + STR_CELL_WIDTH;
-           *t++ = *s++);
-
-   }
-
-   if (t1 != NULL) {
-
-      t1->s_next = NULL;
-      target->s_tail = t1;
-
-   }
 
    return target;
 
@@ -305,7 +237,7 @@ int32 string_length(
 
 {
 
-   return (spec->sp_val.sp_string_ptr)->s_length;
+   return spec_val(spec,sp_string_ptr)->s_length;
 
 }
 
@@ -313,7 +245,7 @@ int32 string_length(
  *  \function{string\_value()}
  *
  *  This function returns a character string representation of a SETL2
- *  string.  Essentially, it just concatenates the strings in the cells.
+ *  string.  Essentially, it just copies the characters.
  *
  *  We should note that this function uses \verb"malloc()" to allocate a
  *  return buffer.  The caller should free this buffer after it uses the
@@ -327,34 +259,19 @@ char *string_value(
 {
 char *return_ptr;                      /* returned string pointer           */
 string_h_ptr_type h_ptr;               /* string header                     */
-string_c_ptr_type s_ptr;               /* string cell pointer               */
-char *s,*t;                            /* temporary looping variables       */
 
    /* extract the header pointer */
 
-   h_ptr = spec->sp_val.sp_string_ptr;
+   h_ptr = spec_val(spec,sp_string_ptr);
 
-   /* allocate a buffer for the string */
+   /* allocate a buffer for the string, and copy it with its null */
 
    return_ptr = (char *)malloc((size_t)(h_ptr->s_length + 1));
    if (return_ptr == NULL)
       giveup(SETL_SYSTEM msg_malloc_error);
 
-   /* copy each cell */
-
-   t = return_ptr;
-   for (s_ptr = h_ptr->s_head;
-        s_ptr != NULL;
-        s_ptr = s_ptr->s_next) {
-
-      for (s = s_ptr->s_cell_value;
-           s < s_ptr->s_cell_value + STR_CELL_WIDTH &&
-              t < return_ptr + h_ptr->s_length;
-           *t++ = *s++);
-
-   }
-
-   *t = '\0';
+   memcpy((void *)return_ptr,(void *)(h_ptr->s_chars),
+          (size_t)(h_ptr->s_length + 1));
 
    return return_ptr;
 
@@ -375,87 +292,35 @@ void string_multiply(
 
 {
 string_h_ptr_type target_string_hdr, source_string_hdr;
-                                      /* string header pointers            */
-string_c_ptr_type target_string_cell, source_string_cell;
-                                       /* string cell pointers              */
-char *target_char_ptr, *source_char_ptr;
-                                       /* character pointers                */
-char *target_char_end, *source_char_end;
-                                       /* character pointers                */
-int32 source_string_length;     /* string lengths                    */
-
-   /* we start with a null string */
-
-   get_string_header(target_string_hdr);
-   target_string_hdr->s_use_count = 1;
-   target_string_hdr->s_hash_code = -1;
-   target_string_hdr->s_length = 0;
-   target_string_hdr->s_head = target_string_hdr->s_tail = NULL;
-   target_string_cell = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   source_string_hdr = source->sp_val.sp_string_ptr;
-
-   /* concatenate copies of the string */
-
-   while (copies--) {
-
-      source_string_cell = source_string_hdr->s_head;
-
-      if (source_string_cell == NULL) {
-
-         source_char_ptr = source_char_end = NULL;
-
-      }
-      else {
-
-         source_char_ptr = source_string_cell->s_cell_value;
-         source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      /* loop over the source string attaching it to the target */
-
-      source_string_length = source_string_hdr->s_length;
-
-      while (source_string_length--) {
-
-         if (source_char_ptr == source_char_end) {
-
-            source_string_cell = source_string_cell->s_next;
-            source_char_ptr = source_string_cell->s_cell_value;
-            source_char_end = source_char_ptr + STR_CELL_WIDTH;
-
-         }
+                                       /* string header pointers            */
+char *target_char_ptr;                 /* next copy in target               */
+int32 source_string_length;            /* string length                     */
 
-         if (target_char_ptr == target_char_end) {
+   source_string_hdr = spec_val(source,sp_string_ptr);
+   source_string_length = source_string_hdr->s_length;
 
-            get_string_cell(target_string_cell);
-            if (target_string_hdr->s_tail != NULL)
-               (target_string_hdr->s_tail)->s_next = target_string_cell;
-            target_string_cell->s_prev = target_string_hdr->s_tail;
-            target_string_cell->s_next = NULL;
-            target_string_hdr->s_tail = target_string_cell;
-            if (target_string_hdr->s_head == NULL)
-               target_string_hdr->s_head = target_string_cell;
-            target_char_ptr = target_string_cell->s_cell_value;
-            target_char_end = target_char_ptr + STR_CELL_WIDTH;
+   if (copies < 0)
+      copies = 0;
 
-         }
+   target_string_hdr = new_string_buffer(SETL_SYSTEM
+                                         source_string_length * copies);
 
-         *target_char_ptr++ = *source_char_ptr++;
+   /* concatenate copies of the string */
 
-      }
+   target_char_ptr = target_string_hdr->s_chars;
+   while (copies--) {
 
-      target_string_hdr->s_length += source_string_hdr->s_length;
+      memcpy((void *)target_char_ptr,(void *)(source_string_hdr->s_chars),
+             (size_t)source_string_length);
+      target_char_ptr += source_string_length;
 
    }
 
    /* assign our result to the target */
 
    unmark_specifier(target);
-   target->sp_form = ft_string;
-   target->sp_val.sp_string_ptr = target_string_hdr;
+   spec_set_form(target,ft_string);
+   spec_set_val(target,sp_string_ptr,target_string_hdr);
 
    return;
 
@@ -477,136 +342,45 @@ void string_fromb(
 {
 string_h_ptr_type target_string_hdr, left_string_hdr, right_string_hdr;
                                        /* string header pointers            */
-string_c_ptr_type target_string_cell, left_string_cell, right_string_cell;
-                                       /* string cell pointers              */
-char *target_char_ptr, *left_char_ptr, *right_char_ptr;
-                                       /* character pointers                */
-char *target_char_end, *left_char_end, *right_char_end;
-                                       /* character pointers                */
 int32 target_string_length, left_string_length;
                                        /* string lengths                    */
 
    /* the right operand is the source */
 
-   right_string_hdr = right->sp_val.sp_string_ptr;
-
-   /* we start with null strings */
-
-   get_string_header(left_string_hdr);
-   left_string_hdr->s_use_count = 1;
-   left_string_hdr->s_hash_code = -1;
-   left_string_hdr->s_head = left_string_hdr->s_tail = NULL;
-   left_char_ptr = left_char_end = NULL;
+   right_string_hdr = spec_val(right,sp_string_ptr);
 
    if (right_string_hdr->s_length == 0)
       left_string_length = 0;
    else
       left_string_length = 1;
-   left_string_hdr->s_length = left_string_length;
-
-   get_string_header(target_string_hdr);
-   target_string_hdr->s_use_count = 1;
-   target_string_hdr->s_hash_code = -1;
-   target_string_hdr->s_head = target_string_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   target_string_length = right_string_hdr->s_length - 1;
-   if (target_string_length < 0)
-      target_string_length = 0;
-   target_string_hdr->s_length = target_string_length;
-
-   right_string_cell = right_string_hdr->s_head;
-
-   if (right_string_cell == NULL) {
-
-      right_char_ptr = right_char_end = NULL;
-
-   }
-   else {
-
-      right_char_ptr = right_string_cell->s_cell_value;
-      right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-   }
-
-   /* copy one character from the source */
-
-   while (left_string_length--) {
-
-      if (right_char_ptr == right_char_end) {
-
-         right_string_cell = right_string_cell->s_next;
-         right_char_ptr = right_string_cell->s_cell_value;
-         right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (left_char_ptr == left_char_end) {
-
-         get_string_cell(left_string_cell);
-         if (left_string_hdr->s_tail != NULL)
-            (left_string_hdr->s_tail)->s_next = left_string_cell;
-         left_string_cell->s_prev = left_string_hdr->s_tail;
-         left_string_cell->s_next = NULL;
-         left_string_hdr->s_tail = left_string_cell;
-         if (left_string_hdr->s_head == NULL)
-            left_string_hdr->s_head = left_string_cell;
-         left_char_ptr = left_string_cell->s_cell_value;
-         left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *left_char_ptr++ = *right_char_ptr++;
-
-   }
-
-   /* copy all but one character of the source */
-
-   while (target_string_length--) {
-
-      if (right_char_ptr == right_char_end) {
-
-         right_string_cell = right_string_cell->s_next;
-         right_char_ptr = right_string_cell->s_cell_value;
-         right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_string_cell);
-         if (target_string_hdr->s_tail != NULL)
-            (target_string_hdr->s_tail)->s_next = target_string_cell;
-         target_string_cell->s_prev = target_string_hdr->s_tail;
-         target_string_cell->s_next = NULL;
-         target_string_hdr->s_tail = target_string_cell;
-         if (target_string_hdr->s_head == NULL)
-            target_string_hdr->s_head = target_string_cell;
-         target_char_ptr = target_string_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
+   target_string_length = right_string_hdr->s_length - left_string_length;
 
-      }
+   /* the first character goes to the left, the rest stay on the right */
 
-      *target_char_ptr++ = *right_char_ptr++;
-
-   }
+   left_string_hdr = new_string_chars(SETL_SYSTEM
+                                      right_string_hdr->s_chars,
+                                      left_string_length);
+   target_string_hdr = new_string_chars(SETL_SYSTEM
+                                        right_string_hdr->s_chars +
+                                           left_string_length,
+                                        target_string_length);
 
    /* assign our results */
 
    unmark_specifier(left);
-   left->sp_form = ft_string;
-   left->sp_val.sp_string_ptr = left_string_hdr;
+   spec_set_form(left,ft_string);
+   spec_set_val(left,sp_string_ptr,left_string_hdr);
 
    unmark_specifier(right);
-   right->sp_form = ft_string;
-   right->sp_val.sp_string_ptr = target_string_hdr;
+   spec_set_form(right,ft_string);
+   spec_set_val(right,sp_string_ptr,target_string_hdr);
 
    if (target != NULL) {
 
       left_string_hdr->s_use_count++;
       unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = left_string_hdr;
+      spec_set_form(target,ft_string);
+      spec_set_val(target,sp_string_ptr,left_string_hdr);
 
    }
 
@@ -630,140 +404,48 @@ void string_frome(
 {
 string_h_ptr_type target_string_hdr, left_string_hdr, right_string_hdr;
                                        /* string header pointers            */
-string_c_ptr_type target_string_cell, left_string_cell, right_string_cell;
-                                       /* string cell pointers              */
-char *target_char_ptr, *left_char_ptr, *right_char_ptr;
-                                       /* character pointers                */
-char *target_char_end, *left_char_end, *right_char_end;
-                                       /* character pointers                */
 int32 target_string_length, left_string_length;
                                        /* string lengths                    */
 
    /* the right operand is the source */
 
-   right_string_hdr = right->sp_val.sp_string_ptr;
-
-   /* we start with null strings */
-
-   get_string_header(left_string_hdr);
-   left_string_hdr->s_use_count = 1;
-   left_string_hdr->s_hash_code = -1;
-   left_string_hdr->s_head = left_string_hdr->s_tail = NULL;
-   left_char_ptr = left_char_end = NULL;
+   right_string_hdr = spec_val(right,sp_string_ptr);
 
    if (right_string_hdr->s_length == 0)
       left_string_length = 0;
    else
       left_string_length = 1;
-   left_string_hdr->s_length = left_string_length;
-
-   get_string_header(target_string_hdr);
-   target_string_hdr->s_use_count = 1;
-   target_string_hdr->s_hash_code = -1;
-   target_string_hdr->s_head = target_string_hdr->s_tail = NULL;
-   target_char_ptr = target_char_end = NULL;
-
-   target_string_length = right_string_hdr->s_length - 1;
-   if (target_string_length < 0)
-      target_string_length = 0;
-   target_string_hdr->s_length = target_string_length;
-
-   right_string_cell = right_string_hdr->s_head;
-
-   if (right_string_cell == NULL) {
-
-      right_char_ptr = right_char_end = NULL;
-
-   }
-   else {
-
-      right_char_ptr = right_string_cell->s_cell_value;
-      right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-   }
-
-   /* copy all but one character of the source */
-
-   while (target_string_length--) {
-
-      if (right_char_ptr == right_char_end) {
+   target_string_length = right_string_hdr->s_length - left_string_length;
 
-         right_string_cell = right_string_cell->s_next;
-         right_char_ptr = right_string_cell->s_cell_value;
-         right_char_end = right_char_ptr + STR_CELL_WIDTH;
+   /* the last character goes to the left, the rest stay on the right */
 
-      }
-
-      if (target_char_ptr == target_char_end) {
-
-         get_string_cell(target_string_cell);
-         if (target_string_hdr->s_tail != NULL)
-            (target_string_hdr->s_tail)->s_next = target_string_cell;
-         target_string_cell->s_prev = target_string_hdr->s_tail;
-         target_string_cell->s_next = NULL;
-         target_string_hdr->s_tail = target_string_cell;
-         if (target_string_hdr->s_head == NULL)
-            target_string_hdr->s_head = target_string_cell;
-         target_char_ptr = target_string_cell->s_cell_value;
-         target_char_end = target_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *target_char_ptr++ = *right_char_ptr++;
-
-   }
-
-   /* copy one character from the source */
-
-   while (left_string_length--) {
-
-      if (right_char_ptr == right_char_end) {
-
-         right_string_cell = right_string_cell->s_next;
-         right_char_ptr = right_string_cell->s_cell_value;
-         right_char_end = right_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      if (left_char_ptr == left_char_end) {
-
-         get_string_cell(left_string_cell);
-         if (left_string_hdr->s_tail != NULL)
-            (left_string_hdr->s_tail)->s_next = left_string_cell;
-         left_string_cell->s_prev = left_string_hdr->s_tail;
-         left_string_cell->s_next = NULL;
-         left_string_hdr->s_tail = left_string_cell;
-         if (left_string_hdr->s_head == NULL)
-            left_string_hdr->s_head = left_string_cell;
-         left_char_ptr = left_string_cell->s_cell_value;
-         left_char_end = left_char_ptr + STR_CELL_WIDTH;
-
-      }
-
-      *left_char_ptr++ = *right_char_ptr++;
-
-   }
+   left_string_hdr = new_string_chars(SETL_SYSTEM
+                                      right_string_hdr->s_chars +
+                                         target_string_length,
+                                      left_string_length);
+   target_string_hdr = new_string_chars(SETL_SYSTEM
+                                        right_string_hdr->s_chars,
+                                        target_string_length);
 
    /* assign our results */
 
    unmark_specifier(left);
-   left->sp_form = ft_string;
-   left->sp_val.sp_string_ptr = left_string_hdr;
+   spec_set_form(left,ft_string);
+   spec_set_val(left,sp_string_ptr,left_string_hdr);
 
    unmark_specifier(right);
-   right->sp_form = ft_string;
-   right->sp_val.sp_string_ptr = target_string_hdr;
+   spec_set_form(right,ft_string);
+   spec_set_val(right,sp_string_ptr,target_string_hdr);
 
    if (target != NULL) {
 
       left_string_hdr->s_use_count++;
       unmark_specifier(target);
-      target->sp_form = ft_string;
-      target->sp_val.sp_string_ptr = left_string_hdr;
+      spec_set_form(target,ft_string);
+      spec_set_val(target,sp_string_ptr,left_string_hdr);
 
    }
 
    return;
 
 }
-
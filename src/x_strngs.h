@@ -28,53 +28,54 @@
 
 #ifndef STRINGS_LOADED
 
-#define STR_CELL_WIDTH    32           /* characters in string cell         */
+/* SETL2 system header files */
 
-/* string header node structure */
+#include "slabs.h"                     /* slabs                             */
+
+#define STR_INLINE_WIDTH  24           /* characters held in the header,    */
+                                       /* with the terminating null         */
+
+/*
+ *  The characters of a string are contiguous and null terminated.  Short
+ *  strings keep them in the header itself, longer ones in a separately
+ *  allocated block.  Either way \verb"s_chars" points to them.
+ */
 
 struct string_h_item {
    int32 s_use_count;                  /* usage count                       */
    int32 s_hash_code;                  /* hash code                         */
    int32 s_length;                     /* length of string in bytes         */
-   struct string_c_item *s_head;       /* first cell in list                */
-   struct string_c_item *s_tail;       /* last cell in list                 */
+   int32 s_capacity;                   /* characters we have room for, not  */
+                                       /* counting the null                 */
+   char *s_chars;                      /* string characters                 */
+   char s_inline[STR_INLINE_WIDTH];    /* characters of short strings       */
 };
 
 typedef struct string_h_item *string_h_ptr_type;
                                        /* header node pointer               */
 
-/* string cell node structure */
-
-struct string_c_item {
-   struct string_c_item *s_next;       /* next cell in list                 */
-   struct string_c_item *s_prev;       /* previous cell in list             */
-   char s_cell_value[STR_CELL_WIDTH];  /* cell value                        */
-};
+/*
+ *  Strings used to be lists of cells, and native packages may still save
+ *  and restore positions as `cells' through the iterator macros.  Now a
+ *  position is just a character pointer.
+ */
 
-typedef struct string_c_item *string_c_ptr_type;
-                                       /* cell node pointer                 */
+typedef char *string_c_ptr_type;       /* position in a string              */
 
 /* global data */
 
 #ifdef TSAFE
-#define STRING_H_NEXT_FREE plugin_instance->string_h_next_free 
-#define STRING_C_NEXT_FREE plugin_instance->string_c_next_free 
+#define STRING_H_SLAB plugin_instance->string_h_slab
 #else
-#define STRING_H_NEXT_FREE string_h_next_free 
-#define STRING_C_NEXT_FREE string_c_next_free 
+#define STRING_H_SLAB string_h_slab
 #ifdef SHARED
 
-string_h_ptr_type string_h_next_free = NULL;
-                                       /* next free header                  */
-string_c_ptr_type string_c_next_free = NULL;
-                                       /* next free cell                    */
+struct slab_class_item string_h_slab;  /* header slabs                      */
 
 #else
 
-extern string_h_ptr_type string_h_next_free;
-                                       /* next free header                  */
-extern string_c_ptr_type string_c_next_free;
-                                       /* next free cell                    */
+extern struct slab_class_item string_h_slab;
+                                       /* header slabs                      */
 
 #endif
 #endif
@@ -91,49 +92,37 @@ extern string_c_ptr_type string_c_next_free;
 
 #define free_string_header(s) free(s)
 
-#define get_string_cell(t) {\
-   t = (string_c_ptr_type)malloc(sizeof(struct string_c_item));\
-   if (t == NULL)\
-      giveup(SETL_SYSTEM msg_malloc_error);\
-}
-
-#define free_string_cell(s) free(s)
-
 #else
 
-#define get_string_header(t) {\
-   if (STRING_H_NEXT_FREE == NULL) alloc_string_headers(SETL_SYSTEM_VOID); \
-   t = STRING_H_NEXT_FREE; \
-   STRING_H_NEXT_FREE = *((string_h_ptr_type *)(STRING_H_NEXT_FREE)); \
-}
+#define get_string_header(t) \
+   slab_get(STRING_H_SLAB,"string header",string_h_ptr_type,t,\
+            sizeof(struct string_h_item))
 
-#define free_string_header(s) {\
-   *((string_h_ptr_type *)(s)) = STRING_H_NEXT_FREE; \
-   STRING_H_NEXT_FREE = s; \
-}
+#define free_string_header(s) slab_put(s)
+#endif
 
-/* allocate and free cell nodes */
+/* make room for a longer string, keeping the characters we have */
 
-#define get_string_cell(t) {\
-   if (STRING_C_NEXT_FREE == NULL) alloc_string_cells(SETL_SYSTEM_VOID); \
-   t = STRING_C_NEXT_FREE; \
-   STRING_C_NEXT_FREE = *((string_c_ptr_type *)(STRING_C_NEXT_FREE)); \
+#define reserve_string(h,n) {\
+   if ((n) > (h)->s_capacity) grow_string(SETL_SYSTEM h,n); \
 }
 
-#define free_string_cell(s) {\
-   *((string_c_ptr_type *)(s)) = STRING_C_NEXT_FREE; \
-   STRING_C_NEXT_FREE = s; \
+/* append one character to a string */
+
+#define append_string_char(h,c) {\
+   reserve_string(h,(h)->s_length + 1); \
+   (h)->s_chars[(h)->s_length++] = (c); \
+   (h)->s_chars[(h)->s_length] = '\0'; \
 }
-#endif
 
 /* public function declarations */
 
-void alloc_string_headers(SETL_SYSTEM_PROTO_VOID);       
-                                       /* allocate a block of header nodes  */
-void alloc_string_cells(SETL_SYSTEM_PROTO_VOID);         
-                                       /* allocate a block of cell nodes    */
 void free_string(SETL_SYSTEM_PROTO string_h_ptr_type);   
                                         /* release string                    */
+string_h_ptr_type new_string_buffer(SETL_SYSTEM_PROTO int32);
+                                       /* allocate a string of a length     */
+void grow_string(SETL_SYSTEM_PROTO string_h_ptr_type, int32);
+                                       /* enlarge a string's buffer         */
 string_h_ptr_type copy_string(SETL_SYSTEM_PROTO string_h_ptr_type);
                                        /* copy a string structure           */
 void string_multiply(SETL_SYSTEM_PROTO 
@@ -149,6 +138,8 @@ void string_frome(SETL_SYSTEM_PROTO
                                        /* remove character from end         */
 string_h_ptr_type new_string(SETL_SYSTEM_PROTO 
                              char *s); /* convert string from C to SETL     */
+string_h_ptr_type new_string_chars(SETL_SYSTEM_PROTO char *, int32);
+                                       /* copy characters to a SETL string  */
 
 #define STRINGS_LOADED 1
 #endif
@@ -56,6 +56,10 @@ static void stlx_exit(int err_code);
 
 
 static  int help = 0;
+static  int calibrate = 0;
+static  int hash_stats = 0;
+static  int alloc_stats = 0;
+static  int defer_free = 0;
 static  FILE *debug_file;
 
 #ifdef TSAFE
@@ -95,6 +99,7 @@ int main(
 char program[MAX_PROGRAM_NAME_LEN + 1];       /* program to be executed            */
 char *p;
 int c;                                /* opt_var used by getopt_long()     */
+int n;                                /* cutoff number for -k              */
 
 #ifdef TSAFE
    setl_instance=Setl_Initialize();
@@ -140,6 +145,10 @@ int c;                                /* opt_var used by getopt_long()     */
           /* These options don't set a flag.
              We distinguish them by their indices. */
           {"help", 0, &help, 1},
+          {"calibrate", 0, &calibrate, 1},
+          {"hash-stats", 0, &hash_stats, 1},
+          {"alloc-stats", 0, &alloc_stats, 1},
+          {"defer-free", 0, &defer_free, 1},
           {"version", 0, 0, 0},
           {0, 0, 0, 0}
         };
@@ -147,7 +156,7 @@ int c;                                /* opt_var used by getopt_long()     */
       /* getopt_long stores the option index here. */
       int option_index = 0;
 
-      c = getopt_long (argc, argv,"vl:p:ms:a:d:",long_options, &option_index);
+      c = getopt_long (argc, argv,"vl:p:ms:t:w:a:d:k:H:",long_options, &option_index);
       
       /* Detect the end of the options. */
       if (c == -1)
@@ -200,6 +209,41 @@ int c;                                /* opt_var used by getopt_long()     */
 	    set_compiler_options(SETL_SYSTEM "process_slice",(void*)atol(optarg));
 	    break;
 
+	  case 't':
+	    /* set slice time */
+	    
+	    set_compiler_options(SETL_SYSTEM "slice_msecs",(void*)atol(optarg));
+	    break;
+
+	  case 'w':
+	    /* set the number of workers running at once */
+
+	    set_compiler_options(SETL_SYSTEM "workers",(void*)atol(optarg));
+	    break;
+
+	  case 'k':
+	    /* set multiplication cutoffs: karatsuba,toom3,fft */
+
+	    for (p = optarg, n = 0; *p && n < 3; n++)
+	      {
+		static char *cutoff_names[] =
+		  {"karatsuba_cutoff", "toom3_cutoff", "fft_cutoff"};
+
+		if (*p != ',')
+		  set_compiler_options(SETL_SYSTEM cutoff_names[n],
+				       (void*)strtol(p,&p,10));
+		if (*p == ',')
+		  p++;
+	      }
+	    break;
+
+	  case 'H':
+	    /* fix the hash code seed */
+
+	    set_compiler_options(SETL_SYSTEM "hash_seed",
+				 (void*)strtoul(optarg,NULL,0));
+	    break;
+
 	  case 'a':
 	    /* set assert flags */
 	    	    
@@ -290,6 +334,10 @@ int c;                                /* opt_var used by getopt_long()     */
 "   -v         %s\n   -l         %s\n"
 "   -p         %s\n   -m         %s\n"
 "   -s         %s\n"
+"   -t  ms     %s\n"
+"   -w  n      %s\n"
+"   -k  k,t,f  %s\n"
+"   -H  seed   %s\n"
 "   -a  f      %s\n"
 "       l      %s\n"
 "   -d  x      %s\n"
@@ -297,33 +345,55 @@ int c;                                /* opt_var used by getopt_long()     */
 "       p      %s\n"
 "       d      %s\n"
 "       c      %s\n"
+"  --calibrate %s\n"
+"  --hash-stats %s\n"
+"  --alloc-stats %s\n"
+"  --defer-free %s\n"
 "  --help      %s\n",
-		"print out the version number","change default library","change library path","toggle source markup switch","set slice size","set assert flag: fail","set assert flag: log","set debugging flags: dump","set debugging flags: step debug","set debugging flags: profiler","set debugging flags: create a debug file","set debugging flags: trace copies","show this informations and then exit");
+		"print out the version number","change default library","change library path","toggle source markup switch","set slice size","set slice time in milliseconds, 0 to count opcodes","set the number of workers running at once, 0 for one per processor","set multiplication cutoffs in limbs, 0 to disable","fix the hash code seed, so sets print in the same order every run","set assert flag: fail","set assert flag: log","set debugging flags: dump","set debugging flags: step debug","set debugging flags: profiler","set debugging flags: create a debug file","set debugging flags: trace copies","measure multiplication cutoffs and print them as -k","print the quality of string hash codes","print live, free and peak nodes of each type at exit","free large data a step at a time, to keep pauses short","show this informations and then exit");
 	 exit(1);
 }
+
+   if(calibrate)
+       {
+	 set_compiler_options(SETL_SYSTEM "calibrate_multiply",NULL);
+	 exit(0);
+       }
+
+   if(hash_stats)
+       {
+	 set_compiler_options(SETL_SYSTEM "hash_stats",NULL);
+	 exit(0);
+       }
+
    /*
     *  At this point, we expect to have a program name.
     */
 
    if (optind < argc)
 	{
-	   strcpy(program,argv[optind++]);	   
-	      /* program names are upper case */
-
-	      for (p = program; *p; p++) 
-		{
-		  if (islower(*p))
-		    *p = toupper(*p);
-		}
-		  
+	   strcpy(program,argv[optind++]);	   
+	      /* program names are upper case */
+
+	      for (p = program; *p; p++) 
+		{
+		  if (islower(*p))
+		    *p = toupper(*p);
+		}
+		  
 
 	      /* initialize tables */
-	      runtime_cleanup(SETL_SYSTEM_VOID);
+	      runtime_cleanup(SETL_SYSTEM_VOID);
 		
-	      plugin_main(SETL_SYSTEM program);
+	      plugin_main(SETL_SYSTEM program);
 		  Setl_SetCommandLine(SETL_SYSTEM argc,optind,argv);
+	      if (defer_free)
+		 set_compiler_options(SETL_SYSTEM "defer_free",(void*)1);
 	      execute_go(SETL_SYSTEM 1);
 
+	      if (alloc_stats)
+		 set_compiler_options(SETL_SYSTEM "alloc_stats",NULL);
+
 	      runtime_cleanup(SETL_SYSTEM_VOID);
 	      profiler_dump(SETL_SYSTEM_VOID);
    